@@ -93,11 +93,11 @@ void Agent::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNo
             // pull out the piggybacked packet and create a new QSharedPointer<NLPacket> for it
             int piggyBackedSizeWithHeader = message->getSize() - statsMessageLength;
             
-            auto buffer = std::unique_ptr<char[]>(new char[piggyBackedSizeWithHeader]);
+            auto buffer = udt::PacketBufferPool::allocate(piggyBackedSizeWithHeader);
             memcpy(buffer.get(), message->getRawMessage() + statsMessageLength, piggyBackedSizeWithHeader);
 
             auto newPacket = NLPacket::fromReceivedPacket(std::move(buffer), piggyBackedSizeWithHeader, message->getSenderSockAddr());
-            message = QSharedPointer<ReceivedMessage>::create(*newPacket);
+            message = QSharedPointer<ReceivedMessage>::create(std::move(newPacket));
         } else {
             return; // bail since no piggyback data
         }
@@ -123,6 +123,14 @@ void Agent::handleJurisdictionPacket(QSharedPointer<ReceivedMessage> message, Sh
     }
 }
 
+void Agent::handleBulkAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    if (_isListeningToAvatars) {
+        QMetaObject::invokeMethod(DependencyManager::get<AvatarHashMap>().data(), "processAvatarDataPacket",
+                                  Qt::DirectConnection,
+                                  Q_ARG(QSharedPointer<ReceivedMessage>, message), Q_ARG(SharedNodePointer, senderNode));
+    }
+}
+
 void Agent::handleAudioPacket(QSharedPointer<ReceivedMessage> message) {
     _receivedAudioStream.parseData(*message);
 
@@ -257,7 +265,7 @@ void Agent::executeScript() {
     _scriptEngine->registerGlobalObject("AvatarList", avatarHashMap.data());
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::BulkAvatarData, avatarHashMap.data(), "processAvatarDataPacket");
+    packetReceiver.registerListener(PacketType::BulkAvatarData, this, "handleBulkAvatarDataPacket");
     packetReceiver.registerListener(PacketType::KillAvatar, avatarHashMap.data(), "processKillAvatar");
     packetReceiver.registerListener(PacketType::AvatarIdentity, avatarHashMap.data(), "processAvatarIdentityPacket");
     packetReceiver.registerListener(PacketType::AvatarBillboard, avatarHashMap.data(), "processAvatarBillboardPacket");
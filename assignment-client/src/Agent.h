@@ -35,6 +35,7 @@ class Agent : public ThreadedAssignment {
     Q_PROPERTY(bool isAvatar READ isAvatar WRITE setIsAvatar)
     Q_PROPERTY(bool isPlayingAvatarSound READ isPlayingAvatarSound)
     Q_PROPERTY(bool isListeningToAudioStream READ isListeningToAudioStream WRITE setIsListeningToAudioStream)
+    Q_PROPERTY(bool isListeningToAvatars READ isListeningToAvatars WRITE setIsListeningToAvatars)
     Q_PROPERTY(float lastReceivedAudioLoudness READ getLastReceivedAudioLoudness)
     Q_PROPERTY(QUuid sessionUUID READ getSessionUUID)
 
@@ -49,6 +50,10 @@ public:
     bool isListeningToAudioStream() const { return _isListeningToAudioStream; }
     void setIsListeningToAudioStream(bool isListeningToAudioStream) { _isListeningToAudioStream = isListeningToAudioStream; }
 
+    // an agent that doesn't look at the other avatars (like the bots of a load test) can skip decoding their data
+    bool isListeningToAvatars() const { return _isListeningToAvatars; }
+    void setIsListeningToAvatars(bool isListeningToAvatars) { _isListeningToAvatars = isListeningToAvatars; }
+
     float getLastReceivedAudioLoudness() const { return _lastReceivedAudioLoudness; }
     QUuid getSessionUUID() const;
 
@@ -66,6 +71,7 @@ private slots:
     void handleAudioPacket(QSharedPointer<ReceivedMessage> message);
     void handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleJurisdictionPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleBulkAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
     void processAgentAvatarAndAudio(float deltaTime);
 
@@ -85,6 +91,7 @@ private:
     QString _scriptContents;
     QTimer* _scriptRequestTimeout { nullptr };
     bool _isListeningToAudioStream = false;
+    bool _isListeningToAvatars = true;
     Sound* _avatarSound = nullptr;
     int _numAvatarSoundSentBytes = 0;
     bool _isAvatar = false;
@@ -77,6 +77,9 @@ AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QStri
     // put the NodeList on the node thread
     nodeList->moveToThread(nodeThread);
 
+    // the assignments handle their packets on their own threads, let them take what came in a batch at a time
+    nodeList->getPacketReceiver().setShouldDeliverInBatches(true);
+
     // set the logging target to the the CHILD_TARGET_NAME
     LogHandler::getInstance().setTargetName(ASSIGNMENT_CLIENT_TARGET_NAME);
 
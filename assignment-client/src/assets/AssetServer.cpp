@@ -19,7 +19,9 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QString>
+#include <QThreadPool>
 
+#include "AssetUtils.h"
 #include "NetworkLogging.h"
 #include "NodeType.h"
 #include "SendAssetTask.h"
@@ -28,6 +30,35 @@
 
 const QString ASSET_SERVER_LOGGING_TARGET_NAME = "asset-server";
 
+// names a file that was put in the asset directory by hand after its hash
+class RenameToHashTask : public QRunnable {
+public:
+    RenameToHashTask(const QFileInfo& fileInfo, const QDir& resourcesDirectory) :
+        _fileInfo(fileInfo),
+        _resourcesDirectory(resourcesDirectory)
+    {
+    }
+
+    void run() override {
+        QFile file { _fileInfo.absoluteFilePath() };
+        auto hexHash = hashFile(file).toHex();
+        file.close();
+
+        if (hexHash.isEmpty()) {
+            qDebug() << "\tCan't read " << _fileInfo.fileName();
+            return;
+        }
+
+        qDebug() << "\tMoving " << _fileInfo.fileName() << " to " << hexHash;
+
+        file.rename(_resourcesDirectory.absoluteFilePath(hexHash) + "." + _fileInfo.suffix());
+    }
+
+private:
+    QFileInfo _fileInfo;
+    QDir _resourcesDirectory;
+};
+
 AssetServer::AssetServer(ReceivedMessage& message) :
     ThreadedAssignment(message),
     _taskPool(this)
@@ -91,30 +122,27 @@ void AssetServer::run() {
 
     // Scan for new files
     qDebug() << "Looking for new files in asset directory";
-    auto files = _resourcesDirectory.entryInfoList(QDir::Files);
+    auto files = _resourcesDirectory.entryInfoList(QDir::Files | QDir::Hidden);
     QRegExp filenameRegex { "^[a-f0-9]{" + QString::number(SHA256_HASH_HEX_LENGTH) + "}(\\..+)?$" };
+
+    // the files are hashed in place, a few at a time, so a big library of them doesn't hold up the start for long
+    QThreadPool hashPool;
     for (const auto& fileInfo : files) {
         auto filename = fileInfo.fileName();
-        if (!filenameRegex.exactMatch(filename)) {
+        if (filename.startsWith(UPLOAD_TEMP_FILE_PREFIX)) {
+            qDebug() << "Removing unfinished upload: " << filename;
+            QFile::remove(fileInfo.absoluteFilePath());
+        } else if (!filenameRegex.exactMatch(filename) && !fileInfo.isHidden()) {
             qDebug() << "Found file: " << filename;
             if (!fileInfo.isReadable()) {
                 qDebug() << "\tCan't open file for reading: " << filename;
                 continue;
             }
 
-            // Read file
-            QFile file { fileInfo.absoluteFilePath() };
-            file.open(QFile::ReadOnly);
-            QByteArray data = file.readAll();
-
-            auto hash = hashData(data);
-            auto hexHash = hash.toHex();
-
-            qDebug() << "\tMoving " << filename << " to " << hexHash;
-
-            file.rename(_resourcesDirectory.absoluteFilePath(hexHash) + "." + fileInfo.suffix());
+            hashPool.start(new RenameToHashTask(fileInfo, _resourcesDirectory));
         }
     }
+    hashPool.waitForDone();
 }
 
 void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -165,7 +193,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _resourcesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _resourcesDirectory, &_hotAssets);
     _taskPool.start(task);
 }
 
@@ -18,6 +18,7 @@
 #include <QThreadPool>
 
 #include "AssetUtils.h"
+#include "HotAssetCache.h"
 #include "ReceivedMessage.h"
 
 class AssetServer : public ThreadedAssignment {
@@ -38,6 +39,7 @@ private slots:
 private:
     static void writeError(NLPacketList* packetList, AssetServerError error);
     QDir _resourcesDirectory;
+    HotAssetCache _hotAssets; // shared by all the send tasks, so it goes after the pool that waits for them
     QThreadPool _taskPool;
 };
 
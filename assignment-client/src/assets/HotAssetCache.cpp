@@ -0,0 +1,38 @@
+//
+//  HotAssetCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HotAssetCache.h"
+
+#include <QtCore/QMutexLocker>
+
+static const int MAX_CACHE_KILOBYTES = 256 * 1024;
+static const int BYTES_PER_KILOBYTE = 1024;
+
+HotAssetCache::HotAssetCache() :
+    _contents(MAX_CACHE_KILOBYTES)
+{
+}
+
+QByteArray HotAssetCache::find(const QString& fileName) {
+    QMutexLocker locker(&_mutex);
+    QByteArray* contents = _contents.object(fileName);
+    // the copy shares the bytes, so they stay valid for the caller even if the cache lets go of them
+    return contents ? *contents : QByteArray();
+}
+
+void HotAssetCache::insert(const QString& fileName, const QByteArray& contents) {
+    if (contents.size() > MAX_ASSET_SIZE) {
+        return;
+    }
+    int cost = 1 + contents.size() / BYTES_PER_KILOBYTE;
+
+    QMutexLocker locker(&_mutex);
+    _contents.insert(fileName, new QByteArray(contents), cost);
+}
@@ -0,0 +1,39 @@
+//
+//  HotAssetCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HotAssetCache_h
+#define hifi_HotAssetCache_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+/// Keeps the contents of recently requested asset files in memory, so when many nodes ask for the same files
+/// at once (everyone arriving in a domain needs the same avatars and textures) only the first request reads the disk.
+/// Assets are named by the hash of their contents and never change, so nothing in here goes stale.
+/// The send tasks all share one, from the asset server's task pool.
+class HotAssetCache {
+public:
+    HotAssetCache();
+
+    /// files bigger than this are always streamed from disk
+    static const qint64 MAX_ASSET_SIZE = 16 * 1024 * 1024;
+
+    /// \return the contents of the file, or a null array if they aren't in memory
+    QByteArray find(const QString& fileName);
+    void insert(const QString& fileName, const QByteArray& contents);
+
+private:
+    QMutex _mutex;
+    QCache<QString, QByteArray> _contents; // cost in kilobytes
+};
+
+#endif // hifi_HotAssetCache_h
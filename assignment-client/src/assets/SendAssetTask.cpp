@@ -11,6 +11,10 @@
 
 #include "SendAssetTask.h"
 
+#include <algorithm>
+#include <memory>
+
+#include <QBuffer>
 #include <QFile>
 
 #include <DependencyManager.h>
@@ -21,16 +25,27 @@
 #include <udt/Packet.h>
 
 #include "AssetUtils.h"
+#include "HotAssetCache.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             HotAssetCache* hotAssets) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _hotAssets(hotAssets)
 {
     
 }
 
+static std::unique_ptr<QIODevice> openBuffer(const QByteArray& contents) {
+    // the buffer shares the bytes rather than copying them
+    std::unique_ptr<QBuffer> buffer { new QBuffer() };
+    buffer->setData(contents);
+    buffer->open(QIODevice::ReadOnly);
+    return std::move(buffer);
+}
+
 void SendAssetTask::run() {
     MessageID messageID;
     uint8_t extensionLength;
@@ -54,6 +69,9 @@ void SendAssetTask::run() {
     qDebug() << "Starting task to send asset: " << hexHash << " for messageID " << messageID;
     auto replyPacketList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
 
+    // assets can be big, they shouldn't hold up the other reliable messages to this node
+    replyPacketList->setPriority(udt::PacketList::Priority::Bulk);
+
     replyPacketList->write(assetHash);
 
     replyPacketList->writePrimitive(messageID);
@@ -61,23 +79,46 @@ void SendAssetTask::run() {
     if (end <= start) {
         writeError(replyPacketList.get(), AssetServerError::InvalidByteRange);
     } else {
-        QString filePath = _resourcesDir.filePath(QString(hexHash) + "." + QString(extension));
-        
-        QFile file { filePath };
+        QString fileName = QString(hexHash) + "." + QString(extension);
+        QString filePath = _resourcesDir.filePath(fileName);
 
-        if (file.open(QIODevice::ReadOnly)) {
-            if (file.size() < end) {
+        // the data comes from memory if the asset is hot, otherwise the open file, which may make it hot
+        std::unique_ptr<QIODevice> device;
+        QByteArray contents = _hotAssets->find(fileName);
+        if (!contents.isNull()) {
+            device = openBuffer(contents);
+        } else {
+            std::unique_ptr<QFile> file { new QFile(filePath) };
+            if (file->open(QIODevice::ReadOnly)) {
+                if (file->size() <= HotAssetCache::MAX_ASSET_SIZE) {
+                    // what's small enough to keep is read whole, and sent from memory like the requests after it
+                    contents = file->readAll();
+                    _hotAssets->insert(fileName, contents);
+                    device = openBuffer(contents);
+                } else {
+                    device = std::move(file);
+                }
+            }
+        }
+
+        if (device) {
+            if (device->size() <= start) {
                 writeError(replyPacketList.get(), AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " " << start << ":" << end;
             } else {
+                // a range that runs past the end of the asset gets what there is, so a client can ask for the start of
+                // an asset before it knows its size
+                end = std::min(end, (DataOffset)device->size());
                 auto size = end - start;
-                file.seek(start);
+                device->seek(start);
                 replyPacketList->writePrimitive(AssetServerError::NoError);
                 replyPacketList->writePrimitive(size);
-                replyPacketList->write(file.read(size));
+
+                // the send queue reads the data as the connection takes it, so a big asset is never all in memory
+                // and its first packets go out without waiting for the rest to be read
+                replyPacketList->streamFrom(std::move(device), size);
                 qCDebug(networking) << "Sending asset: " << hexHash;
             }
-            file.close();
         } else {
             qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
             writeError(replyPacketList.get(), AssetServerError::AssetNotFound);
@@ -21,11 +21,13 @@
 #include "AssetServer.h"
 #include "Node.h"
 
+class HotAssetCache;
 class NLPacket;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                  HotAssetCache* hotAssets);
 
     void run();
 
@@ -33,6 +35,7 @@ private:
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    HotAssetCache* _hotAssets;
 };
 
 #endif
@@ -11,8 +11,11 @@
 
 #include "UploadAssetTask.h"
 
-#include <QtCore/QBuffer>
+#include <algorithm>
+
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QFile>
+#include <QtCore/QTemporaryFile>
 
 #include <AssetUtils.h>
 #include <NodeList.h>
@@ -29,52 +32,61 @@ UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage
 }
 
 void UploadAssetTask::run() {
-    auto data = _receivedMessage->getMessage();
-    
-    QBuffer buffer { &data };
-    buffer.open(QIODevice::ReadOnly);
-    
+    // the upload is read where its packets left it, a chunk at a time, so it is never copied into one more buffer
     MessageID messageID;
-    buffer.read(reinterpret_cast<char*>(&messageID), sizeof(messageID));
-    
+    _receivedMessage->readPrimitive(&messageID);
+
     uint8_t extensionLength;
-    buffer.read(reinterpret_cast<char*>(&extensionLength), sizeof(extensionLength));
-    
-    QByteArray extension = buffer.read(extensionLength);
-    
+    _receivedMessage->readPrimitive(&extensionLength);
+
+    QByteArray extension = _receivedMessage->read(extensionLength);
+
     uint64_t fileSize;
-    buffer.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
-    
+    _receivedMessage->readPrimitive(&fileSize);
+
     qDebug() << "UploadAssetTask reading a file of " << fileSize << "bytes and extension" << extension << "from"
         << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
-    
+
     auto replyPacket = NLPacket::create(PacketType::AssetUploadReply);
     replyPacket->writePrimitive(messageID);
-    
+
     if (fileSize > MAX_UPLOAD_SIZE) {
         replyPacket->writePrimitive(AssetServerError::AssetTooLarge);
     } else {
-        QByteArray fileData = buffer.read(fileSize);
-        
-        auto hash = hashData(fileData);
+        // the data goes to a temporary file as it is hashed, which is renamed once the hash says what to call it
+        QTemporaryFile file { _resourcesDir.filePath(UPLOAD_TEMP_FILE_PREFIX + "XXXXXX") };
+        bool isWritten = file.open();
+
+        QCryptographicHash hasher { QCryptographicHash::Sha256 };
+        qint64 bytesLeft = std::min((qint64)fileSize, _receivedMessage->getBytesLeftToRead());
+
+        while (bytesLeft > 0) {
+            QByteArray chunk = _receivedMessage->readChunkWithoutCopy(bytesLeft);
+            hasher.addData(chunk);
+            isWritten = isWritten && file.write(chunk) == chunk.size();
+            bytesLeft -= chunk.size();
+        }
+
+        auto hash = hasher.result();
         auto hexHash = hash.toHex();
-        
+
         qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
             << "is: (" << hexHash << ") ";
-        
-        QFile file { _resourcesDir.filePath(QString(hexHash)) + "." + QString(extension) };
-        
-        if (file.exists()) {
+
+        QString filePath = _resourcesDir.filePath(QString(hexHash)) + "." + QString(extension);
+
+        if (QFile::exists(filePath)) {
             qDebug() << "[WARNING] This file already exists: " << hexHash;
         } else {
-            file.open(QIODevice::WriteOnly);
-            file.write(fileData);
             file.close();
+            if (!isWritten || !QFile::rename(file.fileName(), filePath)) {
+                qDebug() << "[WARNING] Could not write the uploaded file: " << hexHash;
+            }
         }
         replyPacket->writePrimitive(AssetServerError::NoError);
         replyPacket->write(hash);
     }
-    
+
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->sendPacket(std::move(replyPacket), *_senderNode);
 }
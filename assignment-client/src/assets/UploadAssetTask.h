@@ -18,12 +18,16 @@
 #include <QtCore/QObject>
 #include <QtCore/QRunnable>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QString>
 
 #include "ReceivedMessage.h"
 
 class NLPacketList;
 class Node;
 
+// an upload is written to a file named with this prefix until it has been hashed
+const QString UPLOAD_TEMP_FILE_PREFIX = ".upload-";
+
 class UploadAssetTask : public QRunnable {
 public:
     UploadAssetTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode, const QDir& resourcesDir);
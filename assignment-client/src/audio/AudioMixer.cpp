@@ -12,6 +12,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <math.h>
 #include <memory>
@@ -37,6 +38,7 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonValue>
+#include <QtCore/QRunnable>
 #include <QtCore/QThread>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
@@ -50,7 +52,10 @@
 #include <SharedUtil.h>
 #include <StDev.h>
 #include <UUID.h>
+#include <shared/Trace.h>
 
+#include "AudioCodec.h"
+#include "AudioMixKernels.h"
 #include "AudioRingBuffer.h"
 #include "AudioMixerClientData.h"
 #include "AvatarAudioStream.h"
@@ -59,12 +64,21 @@
 #include "AudioMixer.h"
 
 const float LOUDNESS_TO_DISTANCE_RATIO = 0.00001f;
-const float DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE = 0.18f;
 const float DEFAULT_NOISE_MUTING_THRESHOLD = 0.003f;
 const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
 
+// runs one worker's share of the listeners for a frame on the mixing pool
+class MixListenersTask : public QRunnable {
+public:
+    MixListenersTask(std::function<void()> mixFunction) : _mixFunction(mixFunction) { setAutoDelete(true); }
+    void run() override { _mixFunction(); }
+
+private:
+    std::function<void()> _mixFunction;
+};
+
 InboundAudioStream::Settings AudioMixer::_streamSettings;
 
 bool AudioMixer::_printStreamStats = false;
@@ -80,13 +94,16 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
     _trailingSleepRatio(1.0f),
     _minAudibilityThreshold(LOUDNESS_TO_DISTANCE_RATIO / 2.0f),
     _performanceThrottlingRatio(0.0f),
-    _attenuationPerDoublingInDistance(DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE),
+    _attenuationPerDoublingInDistance(AudioSpatialization::DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE),
     _noiseMutingThreshold(DEFAULT_NOISE_MUTING_THRESHOLD),
     _numStatFrames(0),
     _sumListeners(0),
     _sumMixes(0),
+    _numMixingThreads(0),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
+    _enableCodecs(true),
+    _mixZoneReverb(false),
     _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _timeSpentPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _timeSpentPerHashMatchCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
@@ -103,14 +120,19 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
                                               PacketType::AudioStreamStats },
                                             this, "handleNodeAudioPacket");
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
+    packetReceiver.registerListener(PacketType::NegotiateAudioFormat, this, "handleNegotiateAudioFormat");
 }
 
-const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
-const float RADIUS_OF_HEAD = 0.076f;
+const float INT16_TO_MIX_BUS_SCALE = 1.0f / 32768.0f;
+
+static_assert(AudioSourceFrameCache::MAX_DELAY_SAMPLES >= SAMPLE_PHASE_DELAY_AT_90,
+              "the source frame cache needs to keep enough history for the phase delay");
 
-int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
+int AudioMixer::addStreamToMixForListeningNodeWithStream(MixBuffers& buffers,
+                                                         AudioMixerClientData* listenerNodeData,
                                                          const QUuid& streamUUID,
                                                          PositionalAudioStream* streamToAdd,
+                                                         AudioSourceFrameCache* sourceFrameCache,
                                                          AvatarAudioStream* listeningNodeStream) {
     // If repetition with fade is enabled:
     // If streamToAdd could not provide a frame (it was starved), then we'll mix its previously-mixed frame
@@ -165,7 +187,7 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         return 0;
     }
 
-    ++_sumMixes;
+    ++buffers.sumMixes;
 
     if (streamToAdd->getType() == PositionalAudioStream::Injector) {
         attenuationCoefficient *= reinterpret_cast<InjectedAudioStream*>(streamToAdd)->getAttenuationRatio();
@@ -178,8 +200,6 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         qDebug() << "distance: " << distanceBetween;
     }
 
-    glm::quat inverseOrientation = glm::inverse(listeningNodeStream->getOrientation());
-
     if (!sourceIsSelf && (streamToAdd->getType() == PositionalAudioStream::Microphone)) {
         //  source is another avatar, apply fixed off-axis attenuation to make them quieter as they turn away from listener
         glm::vec3 rotatedListenerPosition = glm::inverse(streamToAdd->getOrientation()) * relativePosition;
@@ -204,54 +224,28 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
 
     float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
     for (int i = 0; i < _zonesSettings.length(); ++i) {
-        if (_audioZones[_zonesSettings[i].source].contains(streamToAdd->getPosition()) &&
-            _audioZones[_zonesSettings[i].listener].contains(listeningNodeStream->getPosition())) {
+        // use the const lookups here, this can run on several mixing workers at once
+        if (_audioZones.value(_zonesSettings[i].source).contains(streamToAdd->getPosition()) &&
+            _audioZones.value(_zonesSettings[i].listener).contains(listeningNodeStream->getPosition())) {
             attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
             break;
         }
     }
 
-    if (distanceBetween >= ATTENUATION_BEGINS_AT_DISTANCE) {
-        // calculate the distance coefficient using the distance to this node
-        float distanceCoefficient = 1 - (logf(distanceBetween / ATTENUATION_BEGINS_AT_DISTANCE) / logf(2.0f)
-                                         * attenuationPerDoublingInDistance);
-
-        if (distanceCoefficient < 0) {
-            distanceCoefficient = 0;
-        }
-
-        // multiply the current attenuation coefficient by the distance coefficient
-        attenuationCoefficient *= distanceCoefficient;
-        if (showDebug) {
-            qDebug() << "distanceCoefficient: " << distanceCoefficient;
-        }
+    // calculate the distance coefficient using the distance to this node
+    float distanceCoefficient = AudioSpatialization::computeDistanceAttenuation(distanceBetween,
+                                                                               attenuationPerDoublingInDistance);
+    attenuationCoefficient *= distanceCoefficient;
+    if (showDebug) {
+        qDebug() << "distanceCoefficient: " << distanceCoefficient;
     }
 
     if (!sourceIsSelf) {
         //  Compute sample delay for the two ears to create phase panning
-        glm::vec3 rotatedSourcePosition = inverseOrientation * relativePosition;
-
-        // project the rotated source position vector onto the XZ plane
-        rotatedSourcePosition.y = 0.0f;
-
-        // produce an oriented angle about the y-axis
-        bearingRelativeAngleToSource = glm::orientedAngle(glm::vec3(0.0f, 0.0f, -1.0f),
-                                                          glm::normalize(rotatedSourcePosition),
-                                                          glm::vec3(0.0f, 1.0f, 0.0f));
-
-        const float PHASE_AMPLITUDE_RATIO_AT_90 = 0.5;
-
-        // figure out the number of samples of delay and the ratio of the amplitude
-        // in the weak channel for audio spatialization
-        float sinRatio = fabsf(sinf(bearingRelativeAngleToSource));
-        numSamplesDelay = SAMPLE_PHASE_DELAY_AT_90 * sinRatio;
-        weakChannelAmplitudeRatio = 1 - (PHASE_AMPLITUDE_RATIO_AT_90 * sinRatio);
-
-        if (distanceBetween < RADIUS_OF_HEAD) {
-            // Diminish phase panning if source would be inside head
-            numSamplesDelay *= distanceBetween / RADIUS_OF_HEAD;
-            weakChannelAmplitudeRatio += (PHASE_AMPLITUDE_RATIO_AT_90 * sinRatio) * distanceBetween / RADIUS_OF_HEAD;
-        }
+        bearingRelativeAngleToSource = AudioSpatialization::computeBearing(relativePosition,
+                                                                           listeningNodeStream->getOrientation());
+        AudioSpatialization::computePhasePanning(bearingRelativeAngleToSource, distanceBetween,
+                                                 numSamplesDelay, weakChannelAmplitudeRatio);
     }
 
     if (showDebug) {
@@ -261,12 +255,31 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
 
     AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd->getLastPopOutput();
 
+    // the penumbra filter gain for each ear depends on where the source is relative to the listener
+    bool applyPenumbraFilter = !sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter();
+    float penumbraFilterGains[AUDIO_MIX_BUS_CHANNELS];
+    if (applyPenumbraFilter) {
+        AudioSpatialization::computePenumbraFilterGains(bearingRelativeAngleToSource, distanceBetween,
+                                                        penumbraFilterGains[0], penumbraFilterGains[1]);
+    }
+
+    // mono sources are filtered once per frame for everyone through their frame cache, any other filtered source is
+    // built up on its own first so that the filter only sees it, everything else goes straight onto the mix bus
+    bool useFrameCache = applyPenumbraFilter && sourceFrameCache;
+    bool usePreMix = applyPenumbraFilter && !useFrameCache;
+    if (usePreMix) {
+        buffers.preMix.zeroFrames();
+    }
+    float32_t** destination = usePreMix ? buffers.preMix.getFrameData() : buffers.mix.getFrameData();
+
+    // attenuation and fade applied to all samples
+    float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+
     if (!streamToAdd->isStereo()) {
         // this is a mono stream, which means it gets full attenuation and spatialization
 
         // we need to do several things in this process:
         //    1) convert from mono to stereo by copying each input sample into the left and right output samples
-        //    2)
         //    2) apply an attenuation AND fade to all samples (left and right)
         //    3) based on the bearing relative angle to the source we will weaken and delay either the left or
         //       right channel of the input into the output
@@ -274,233 +287,300 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         //       the input stream for that delayed channel
 
         // Mono input to stereo output (item 1 above)
-        int OUTPUT_SAMPLES_PER_INPUT_SAMPLE = 2;
-        int inputSampleCount = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        int maxOutputIndex = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+        int inputSampleCount = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
 
-        // attenuation and fade applied to all samples (item 2 above)
-        float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+        // The weak/delayed channel will be attenuated by this additional amount (item 2 above)
+        float attenuationAndWeakChannelRatioAndFade = attenuationAndFade * weakChannelAmplitudeRatio;
 
         // determine which side is weak and delayed (item 3 above)
         bool rightSideWeakAndDelayed = (bearingRelativeAngleToSource > 0.0f);
+        int delayedChannel = rightSideWeakAndDelayed ? 1 : 0;
+        int normalChannel = 1 - delayedChannel;
+
+        if (useFrameCache) {
+            // the cached frames are already filtered and normalized, and carry the history the delay needs (item 4 above)
+            const float* normalSamples = sourceFrameCache->getFilteredSamples(penumbraFilterGains[normalChannel]);
+            const float* delayedSamples = sourceFrameCache->getFilteredSamples(penumbraFilterGains[delayedChannel]);
+
+            const int FRAME_START = AudioSourceFrameCache::MAX_DELAY_SAMPLES;
+            AudioMixKernels::accumulateWithGain(destination[normalChannel], &normalSamples[FRAME_START],
+                                                attenuationAndFade, inputSampleCount);
+            AudioMixKernels::accumulateWithGain(destination[delayedChannel], &delayedSamples[FRAME_START - numSamplesDelay],
+                                                attenuationAndWeakChannelRatioAndFade, inputSampleCount);
+        } else {
+            // Copy the historical samples the delayed channel needs followed by this frame out of the ring buffer,
+            // so the mix kernels can run over contiguous memory (item 4 above).
+            // TODO: the historical samples may be inside the last frame written if the ringbuffer is completely full
+            // maybe make AudioRingBuffer have 1 extra frame in its buffer
+            (streamPopOutput - numSamplesDelay).readSamples(buffers.sourceSamples, numSamplesDelay + inputSampleCount);
+
+            // the normal channel starts at this frame, the delayed channel starts numSamplesDelay samples before it,
+            // the mix bus is normalized to [-1.0, 1.0]
+            AudioMixKernels::accumulateMono(destination[normalChannel], &buffers.sourceSamples[numSamplesDelay],
+                                            attenuationAndFade * INT16_TO_MIX_BUS_SCALE, inputSampleCount);
+            AudioMixKernels::accumulateMono(destination[delayedChannel], buffers.sourceSamples,
+                                            attenuationAndWeakChannelRatioAndFade * INT16_TO_MIX_BUS_SCALE,
+                                            inputSampleCount);
+        }
 
-        // since we're converting from mono to stereo, we'll use these two indices to step through
-        // the output samples. we'll increment each index independently in the loop
-        int leftDestinationIndex = 0;
-        int rightDestinationIndex = 1;
+    } else {
+        streamPopOutput.readSamples(buffers.sourceSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
-        // One of our two channels will be delayed (determined below). We'll use this index to step
-        // through filling in our output with the historical samples for the delayed channel.  (item 4 above)
-        int delayedChannelHistoricalAudioOutputIndex;
+        AudioMixKernels::accumulateStereo(destination[0], destination[1], buffers.sourceSamples,
+                                          attenuationAndFade * INT16_TO_MIX_BUS_SCALE,
+                                          AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
 
-        // All samples will be attenuated by at least this much
-        float leftSideAttenuation = attenuationAndFade;
-        float rightSideAttenuation = attenuationAndFade;
+    if (usePreMix) {
+        // Get our per listener/source data so we can get our filter
+        AudioFilterHSF1s& penumbraFilter = listenerNodeData->getListenerSourcePairData(streamUUID)->getPenumbraFilter();
 
-        // The weak/delayed channel will be attenuated by this additional amount
-        float attenuationAndWeakChannelRatioAndFade = attenuationAndFade * weakChannelAmplitudeRatio;
+        // set the gain on both filter channels
+        penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, AudioSpatialization::PENUMBRA_FILTER_FREQUENCY_HZ,
+                                     penumbraFilterGains[0], AudioSpatialization::PENUMBRA_FILTER_SLOPE);
+        penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, AudioSpatialization::PENUMBRA_FILTER_FREQUENCY_HZ,
+                                     penumbraFilterGains[1], AudioSpatialization::PENUMBRA_FILTER_SLOPE);
+        penumbraFilter.render(buffers.preMix);
+
+        // Actually mix the filtered source onto the mix bus here.
+        float32_t** preMix = buffers.preMix.getFrameData();
+        float32_t** mix = buffers.mix.getFrameData();
+        AudioMixKernels::accumulate(mix[0], preMix[0], AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        AudioMixKernels::accumulate(mix[1], preMix[1], AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
 
-        // Now, based on the determination of which side is weak and delayed, set up our true starting point
-        // for our indexes, as well as the appropriate attenuation for each channel
-        if (rightSideWeakAndDelayed) {
-            delayedChannelHistoricalAudioOutputIndex = rightDestinationIndex;
-            rightSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            rightDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
-        } else {
-            delayedChannelHistoricalAudioOutputIndex = leftDestinationIndex;
-            leftSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            leftDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
-        }
+    return 1;
+}
 
-        // If there was a sample delay for this stream, we need to pull samples prior to the official start of the input
-        // and stick those samples at the beginning of the output. We only need to loop through this for the weak/delayed
-        // side, since the normal side is fully handled below. (item 4 above)
-        if (numSamplesDelay > 0) {
+int AudioMixer::prepareMixForListeningNode(MixBuffers& buffers, Node* node, const AudioSourceGrid& sources) {
+    AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
+    AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
 
-            // TODO: delayStreamSourceSamples may be inside the last frame written if the ringbuffer is completely full
-            // maybe make AudioRingBuffer have 1 extra frame in its buffer
-            AudioRingBuffer::ConstIterator delayStreamSourceSamples = streamPopOutput - numSamplesDelay;
+    // zero out the client mix bus for this node
+    buffers.mix.zeroFrames();
 
-            for (int i = 0; i < numSamplesDelay; i++) {
-                int16_t originalHistoricalSample = *delayStreamSourceSamples;
+    // loop through the sources that could be heard from here and add all that should be added to mix
+    int streamsMixed = 0;
 
-                _preMixSamples[delayedChannelHistoricalAudioOutputIndex] += originalHistoricalSample
-                                                                                 * attenuationAndWeakChannelRatioAndFade;
-                ++delayStreamSourceSamples; // move our input pointer
-                delayedChannelHistoricalAudioOutputIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE; // move our output sample
-            }
+    sources.forEachAudibleSource(nodeAudioStream->getPosition(), [&](const AudioSourceGrid::Source& source) {
+        if (*source.node != *node || source.stream->shouldLoopbackForNode()) {
+            streamsMixed += addStreamToMixForListeningNodeWithStream(buffers, listenerNodeData, source.streamUUID,
+                                                                     source.stream, source.frameCache, nodeAudioStream);
         }
+    });
 
-        // Here's where we copy the MONO input to the STEREO output, and account for delay and weak side attenuation
-        for (int inputSample = 0; inputSample < inputSampleCount; inputSample++) {
-            int16_t originalSample = streamPopOutput[inputSample];
-            int16_t leftSideSample = originalSample * leftSideAttenuation;
-            int16_t rightSideSample = originalSample * rightSideAttenuation;
+    // everyone in a reverb zone shares the zone's wet tail, which keeps ringing after the zone has gone quiet
+    if (_mixZoneReverb) {
+        float wetLevel;
+        int zone = findReverbZone(nodeAudioStream->getPosition(), wetLevel);
+        if (zone != -1 && _zoneReverbs[zone]->hasWetTail()) {
+            float wetGain = powf(10.0f, wetLevel / 20.0f);
+            float32_t** mix = buffers.mix.getFrameData();
+            float32_t** wetTail = _zoneReverbs[zone]->getWetTail();
+            AudioMixKernels::accumulateWithGain(mix[0], wetTail[0], wetGain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            AudioMixKernels::accumulateWithGain(mix[1], wetTail[1], wetGain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            ++streamsMixed;
+        }
+    }
 
-            // since we might be delayed, don't write beyond our maxOutputIndex
-            if (leftDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[leftDestinationIndex] += leftSideSample;
-            }
-            if (rightDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[rightDestinationIndex] += rightSideSample;
-            }
+    // the mix bus is only clamped once, on its way out to the listener
+    if (streamsMixed > 0) {
+        float32_t** mix = buffers.mix.getFrameData();
+        AudioMixKernels::convertToInt16(mix[0], mix[1], buffers.mixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
 
-            leftDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-            rightDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        }
+    return streamsMixed;
+}
+
+std::unique_ptr<NLPacket> AudioMixer::createMixPacketForListeningNode(MixBuffers& buffers, Node* node,
+                                                                      const AudioSourceGrid& sources) {
+    AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+
+    int streamsMixed = prepareMixForListeningNode(buffers, node, sources);
+
+    std::unique_ptr<NLPacket> mixPacket;
+
+    if (streamsMixed > 0) {
+        // encode the mix with the listener's codec, this happens on the mixing worker along with the mix itself
+        QByteArray decodedBuffer = QByteArray::fromRawData(reinterpret_cast<char*>(buffers.mixSamples),
+                                                           AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+        QByteArray encodedBuffer;
+        nodeData->encode(decodedBuffer, encodedBuffer);
+
+        const QString& codecName = nodeData->getSelectedCodecName();
+        int mixPacketBytes = sizeof(quint16) + sizeof(quint8) + codecName.toUtf8().size() + encodedBuffer.size();
+        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
 
+        // pack sequence number
+        quint16 sequence = nodeData->getOutgoingSequenceNumber();
+        mixPacket->writePrimitive(sequence);
+
+        // pack the codec the mix is encoded with and the encoded mix
+        AudioCodecs::writeCodecName(*mixPacket, codecName);
+        mixPacket->write(encodedBuffer);
     } else {
-        int stereoDivider = streamToAdd->isStereo() ? 1 : 2;
+        int silentPacketBytes = sizeof(quint16) + sizeof(quint16);
+        mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
 
-       float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+        // pack sequence number
+        quint16 sequence = nodeData->getOutgoingSequenceNumber();
+        mixPacket->writePrimitive(sequence);
 
-        for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-            _preMixSamples[s] = glm::clamp(_preMixSamples[s] + (int)(streamPopOutput[s / stereoDivider] * attenuationAndFade),
-                                            AudioConstants::MIN_SAMPLE_VALUE,
-                                           AudioConstants::MAX_SAMPLE_VALUE);
-        }
+        // pack number of silent audio samples
+        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+        mixPacket->writePrimitive(numSilentSamples);
     }
 
-    if (!sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter()) {
-
-        const float TWO_OVER_PI = 2.0f / PI;
-
-        const float ZERO_DB = 1.0f;
-        const float NEGATIVE_ONE_DB = 0.891f;
-        const float NEGATIVE_THREE_DB = 0.708f;
-
-        const float FILTER_GAIN_AT_0 = ZERO_DB; // source is in front
-        const float FILTER_GAIN_AT_90 = NEGATIVE_ONE_DB; // source is incident to left or right ear
-        const float FILTER_GAIN_AT_180 = NEGATIVE_THREE_DB; // source is behind
-
-        const float FILTER_CUTOFF_FREQUENCY_HZ = 1000.0f;
-
-        const float penumbraFilterFrequency = FILTER_CUTOFF_FREQUENCY_HZ; // constant frequency
-        const float penumbraFilterSlope = NEGATIVE_THREE_DB; // constant slope
-
-        float penumbraFilterGainL;
-        float penumbraFilterGainR;
-
-        // variable gain calculation broken down by quadrant
-        if (-bearingRelativeAngleToSource < -PI_OVER_TWO && -bearingRelativeAngleToSource > -PI) {
-            penumbraFilterGainL = TWO_OVER_PI *
-                (FILTER_GAIN_AT_0 - FILTER_GAIN_AT_180) * (-bearingRelativeAngleToSource + PI_OVER_TWO) + FILTER_GAIN_AT_0;
-            penumbraFilterGainR = TWO_OVER_PI *
-                (FILTER_GAIN_AT_90 - FILTER_GAIN_AT_180) * (-bearingRelativeAngleToSource + PI_OVER_TWO) + FILTER_GAIN_AT_90;
-        } else if (-bearingRelativeAngleToSource <= PI && -bearingRelativeAngleToSource > PI_OVER_TWO) {
-            penumbraFilterGainL = TWO_OVER_PI *
-                (FILTER_GAIN_AT_180 - FILTER_GAIN_AT_90) * (-bearingRelativeAngleToSource - PI) + FILTER_GAIN_AT_180;
-            penumbraFilterGainR = TWO_OVER_PI *
-                (FILTER_GAIN_AT_180 - FILTER_GAIN_AT_0) * (-bearingRelativeAngleToSource - PI) + FILTER_GAIN_AT_180;
-        } else if (-bearingRelativeAngleToSource <= PI_OVER_TWO && -bearingRelativeAngleToSource > 0) {
-            penumbraFilterGainL = TWO_OVER_PI *
-                (FILTER_GAIN_AT_90 - FILTER_GAIN_AT_0) * (-bearingRelativeAngleToSource - PI_OVER_TWO) + FILTER_GAIN_AT_90;
-            penumbraFilterGainR = FILTER_GAIN_AT_0;
-        } else {
-            penumbraFilterGainL = FILTER_GAIN_AT_0;
-            penumbraFilterGainR =  TWO_OVER_PI *
-                (FILTER_GAIN_AT_0 - FILTER_GAIN_AT_90) * (-bearingRelativeAngleToSource) + FILTER_GAIN_AT_0;
-        }
+    return mixPacket;
+}
 
-        if (distanceBetween < RADIUS_OF_HEAD) {
-            // Diminish effect if source would be inside head
-            penumbraFilterGainL += (1.0f - penumbraFilterGainL) * (1.0f - distanceBetween / RADIUS_OF_HEAD);
-            penumbraFilterGainR += (1.0f - penumbraFilterGainR) * (1.0f - distanceBetween / RADIUS_OF_HEAD);
-        }
+AudioMixer::MixBuffers::MixBuffers() :
+    preMix(AUDIO_MIX_BUS_CHANNELS, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL),
+    mix(AUDIO_MIX_BUS_CHANNELS, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL)
+{
+}
 
-        bool wantDebug = false;
-        if (wantDebug) {
-            qDebug() << "gainL=" << penumbraFilterGainL
-                     << "gainR=" << penumbraFilterGainR
-                     << "angle=" << -bearingRelativeAngleToSource;
-        }
+void AudioMixer::buildSourceGrid(const QVector<SharedNodePointer>& nodes) {
+    _sourceGrid.clear();
 
-        // Get our per listener/source data so we can get our filter
-        AudioFilterHSF1s& penumbraFilter = listenerNodeData->getListenerSourcePairData(streamUUID)->getPenumbraFilter();
+    foreach (const SharedNodePointer& node, nodes) {
+        AudioMixerClientData* nodeData = (AudioMixerClientData*) node->getLinkedData();
 
-        // set the gain on both filter channels
-        penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainL, penumbraFilterSlope);
-        penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainR, penumbraFilterSlope);
-        penumbraFilter.render(_preMixSamples, _preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
+        const QHash<QUuid, PositionalAudioStream*>& audioStreams = nodeData->getAudioStreams();
+        QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
+        for (i = audioStreams.constBegin(); i != audioStreams.constEnd(); i++) {
+            PositionalAudioStream* stream = i.value();
+
+            // a source is mixed in while its trailing loudness over the distance to the listener is above the
+            // audibility threshold, which bounds how far away it can be heard from
+            float trailingLoudness = stream->getLastPopOutputTrailingLoudness();
+            if (trailingLoudness <= 0.0f) {
+                continue;
+            }
+
+            // keep the bound a little loose, the exact check is still made when the stream is mixed
+            const float AUDIBLE_RADIUS_SLACK = 1.01f;
+            float audibleRadius = AUDIBLE_RADIUS_SLACK * trailingLoudness / _minAudibilityThreshold;
+
+            QUuid streamUUID = i.key();
+            if (stream->getType() == PositionalAudioStream::Microphone) {
+                streamUUID = node->getUUID();
+            }
+
+            // mono sources that get the penumbra filter share their filtered frames between all of their listeners
+            AudioSourceFrameCache* frameCache = nullptr;
+            if (_enableFilter && !stream->isStereo() && !stream->ignorePenumbraFilter()) {
+                frameCache = nodeData->getSourceFrameCache(i.key());
+                frameCache->beginFrame(stream);
+            }
+
+            _sourceGrid.addSource({ node.data(), streamUUID, stream, frameCache }, stream->getPosition(), audibleRadius);
+        }
     }
+}
 
-    // Actually mix the _preMixSamples into the _mixSamples here.
-    for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-        _mixSamples[s] = glm::clamp(_mixSamples[s] + _preMixSamples[s], AudioConstants::MIN_SAMPLE_VALUE,
-                                    AudioConstants::MAX_SAMPLE_VALUE);
+void AudioMixer::renderZoneReverbs(const QVector<SharedNodePointer>& nodes) {
+    for (auto& zoneReverb : _zoneReverbs) {
+        zoneReverb->beginFrame();
     }
 
-    return 1;
-}
+    foreach (const SharedNodePointer& node, nodes) {
+        AudioMixerClientData* nodeData = (AudioMixerClientData*) node->getLinkedData();
 
-int AudioMixer::prepareMixForListeningNode(Node* node) {
-    AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
-    AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        foreach (PositionalAudioStream* stream, nodeData->getAudioStreams()) {
+            if (stream->getLastPopOutputTrailingLoudness() <= 0.0f) {
+                continue;
+            }
 
-    // zero out the client mix for this node
-    memset(_mixSamples, 0, sizeof(_mixSamples));
+            float wetLevel;
+            int zone = findReverbZone(stream->getPosition(), wetLevel);
+            if (zone != -1) {
+                _zoneReverbs[zone]->addSource(stream);
+            }
+        }
+    }
 
-    // loop through all other nodes that have sufficient audio to mix
-    int streamsMixed = 0;
+    for (auto& zoneReverb : _zoneReverbs) {
+        zoneReverb->render();
+    }
+}
 
-    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
-        if (otherNode->getLinkedData()) {
-            AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
+void AudioMixer::mixForListeningNodes(const QVector<SharedNodePointer>& listeners, const AudioSourceGrid& sources,
+                                      std::vector<std::unique_ptr<NLPacket>>& mixPackets) {
+    mixPackets.resize(listeners.size());
 
-            // enumerate the ARBs attached to the otherNode and add all that should be added to mix
+    int numWorkers = std::min((int) _mixBuffers.size(), listeners.size());
 
-            const QHash<QUuid, PositionalAudioStream*>& otherNodeAudioStreams = otherNodeClientData->getAudioStreams();
-            QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
-            for (i = otherNodeAudioStreams.constBegin(); i != otherNodeAudioStreams.constEnd(); i++) {
-                PositionalAudioStream* otherNodeStream = i.value();
-                QUuid streamUUID = i.key();
+    auto mixListeners = [&](int worker) {
+        MixBuffers& buffers = *_mixBuffers[worker];
 
-                if (otherNodeStream->getType() == PositionalAudioStream::Microphone) {
-                    streamUUID = otherNode->getUUID();
-                }
-                
-                // clear out the pre-mix samples before filling it up with this source
-                memset(_preMixSamples, 0, sizeof(_preMixSamples));
+        // each worker takes every numWorkers-th listener so that busy and quiet listeners spread evenly
+        QElapsedTimer listenerTimer;
+        for (int i = worker; i < listeners.size(); i += numWorkers) {
+            listenerTimer.start();
+            mixPackets[i] = createMixPacketForListeningNode(buffers, listeners[i].data(), sources);
+            buffers.listenerMixTimes.record(listenerTimer.nsecsElapsed() / NSECS_PER_USEC);
+            buffers.listenerMixBytes.record(mixPackets[i] ? mixPackets[i]->getDataSize() : 0);
+        }
+    };
 
-                if (*otherNode != *node || otherNodeStream->shouldLoopbackForNode()) {
-                    streamsMixed += addStreamToMixForListeningNodeWithStream(listenerNodeData, streamUUID,
-                                                                             otherNodeStream, nodeAudioStream);
-                }
-            }
+    if (numWorkers <= 1) {
+        // a single worker mixes right here, no need to hop over to the pool
+        if (numWorkers == 1) {
+            mixListeners(0);
+        }
+    } else {
+        for (int worker = 0; worker < numWorkers; ++worker) {
+            _mixingPool.start(new MixListenersTask([=, &mixListeners] { mixListeners(worker); }));
         }
-    });
 
-    return streamsMixed;
+        _mixingPool.waitForDone();
+    }
+
+    for (auto& buffers : _mixBuffers) {
+        _sumMixes += buffers->sumMixes;
+        buffers->sumMixes = 0;
+
+        _listenerMixTimes.merge(buffers->listenerMixTimes);
+        buffers->listenerMixTimes.reset();
+        _listenerMixBytes.merge(buffers->listenerMixBytes);
+        buffers->listenerMixBytes.reset();
+    }
 }
 
-void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
-    // Send stream properties
-    bool hasReverb = false;
-    float reverbTime, wetLevel;
-    // find reverb properties
+int AudioMixer::findReverbZone(const glm::vec3& position, float& wetLevel) const {
     for (int i = 0; i < _zoneReverbSettings.size(); ++i) {
-        AudioMixerClientData* data = static_cast<AudioMixerClientData*>(node->getLinkedData());
-        glm::vec3 streamPosition = data->getAvatarAudioStream()->getPosition();
-        AABox box = _audioZones[_zoneReverbSettings[i].zone];
-        if (box.contains(streamPosition)) {
-            hasReverb = true;
-            reverbTime = _zoneReverbSettings[i].reverbTime;
+        AABox box = _audioZones.value(_zoneReverbSettings[i].zone);
+        if (box.contains(position)) {
             wetLevel = _zoneReverbSettings[i].wetLevel;
 
             // Modulate wet level with distance to wall
             float MIN_ATTENUATION_DISTANCE = 2.0f;
             float MAX_ATTENUATION = -12; // dB
-            glm::vec3 distanceToWalls = (box.getDimensions() / 2.0f) - glm::abs(streamPosition - box.calcCenter());
+            glm::vec3 distanceToWalls = (box.getDimensions() / 2.0f) - glm::abs(position - box.calcCenter());
             float distanceToClosestWall = glm::min(distanceToWalls.x, distanceToWalls.z);
             if (distanceToClosestWall < MIN_ATTENUATION_DISTANCE) {
                 wetLevel += MAX_ATTENUATION * (1.0f - distanceToClosestWall / MIN_ATTENUATION_DISTANCE);
             }
-            break;
+            return i;
         }
     }
-    
+    return -1;
+}
+
+void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
     AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
     AvatarAudioStream* stream = nodeData->getAvatarAudioStream();
+
+    // Send stream properties
+    float reverbTime = 0.0f, wetLevel = 0.0f;
+    // find reverb properties
+    int zone = findReverbZone(stream->getPosition(), wetLevel);
+    bool hasReverb = zone != -1;
+    if (hasReverb) {
+        reverbTime = _zoneReverbSettings[zone].reverbTime;
+    }
+
     bool dataChanged = (stream->hasReverb() != hasReverb) ||
     (stream->hasReverb() && (stream->getRevebTime() != reverbTime ||
                              stream->getWetLevel() != wetLevel));
@@ -532,6 +612,11 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
 
         if (hasReverb) {
             setAtBit(bitset, HAS_REVERB_BIT);
+
+            // the reverb is already in the mix, the client only needs to know about the zone
+            if (_mixZoneReverb) {
+                setAtBit(bitset, HAS_MIXED_REVERB_BIT);
+            }
         }
 
         envPacket->writePrimitive(bitset);
@@ -545,7 +630,44 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
 }
 
 void AudioMixer::handleNodeAudioPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    QElapsedTimer decodeTimer;
+    decodeTimer.start();
     DependencyManager::get<NodeList>()->updateNodeWithDataFromPacket(message, sendingNode);
+    _decodeTimes.record(decodeTimer.nsecsElapsed() / NSECS_PER_USEC);
+}
+
+void AudioMixer::handleNegotiateAudioFormat(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    quint8 numberOfCodecs = 0;
+    message->readPrimitive(&numberOfCodecs);
+
+    // the client lists its codecs in order of preference, use the first one we have as well
+    QString selectedCodecName;
+    const AudioCodec* selectedCodec = nullptr;
+    for (int i = 0; i < numberOfCodecs; ++i) {
+        QString codecName = AudioCodecs::readCodecName(*message);
+        if (_enableCodecs && !selectedCodec) {
+            selectedCodec = AudioCodecs::getCodec(codecName);
+            if (selectedCodec) {
+                selectedCodecName = codecName;
+            }
+        }
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // the client may negotiate before it has sent us any audio
+    if (!sendingNode->getLinkedData() && nodeList->linkedDataCreateCallback) {
+        nodeList->linkedDataCreateCallback(sendingNode.data());
+    }
+
+    AudioMixerClientData* clientData = static_cast<AudioMixerClientData*>(sendingNode->getLinkedData());
+    if (clientData) {
+        clientData->setupCodec(selectedCodec, selectedCodecName);
+    }
+
+    auto replyPacket = NLPacket::create(PacketType::SelectedAudioFormat);
+    AudioCodecs::writeCodecName(*replyPacket, selectedCodecName);
+    nodeList->sendPacket(std::move(replyPacket), *sendingNode);
 }
 
 void AudioMixer::handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -584,6 +706,23 @@ void AudioMixer::sendStatsPacket() {
     _sumMixes = 0;
     _numStatFrames = 0;
 
+    // where the time of the frames went, in usecs, and the bytes of the mixes
+    QJsonObject frameTimingStats;
+    auto addHistogram = [&](const QString& name, LatencyHistogram& histogram) {
+        frameTimingStats[name] = histogram.toJson();
+        histogram.reset();
+    };
+    addHistogram("decode", _decodeTimes);
+    addHistogram("pop", _popTimes);
+    addHistogram("grid", _gridTimes);
+    addHistogram("mix", _mixTimes);
+    addHistogram("send", _sendTimes);
+    addHistogram("events", _eventTimes);
+    addHistogram("frame", _frameTimes);
+    addHistogram("listener_mix", _listenerMixTimes);
+    addHistogram("listener_mix_bytes", _listenerMixBytes);
+    statsObject["frame_timing"] = frameTimingStats;
+
     QJsonObject readPendingDatagramStats;
 
     QJsonObject rpdCallsStats;
@@ -662,6 +801,9 @@ void AudioMixer::domainSettingsRequestComplete() {
     auto nodeList = DependencyManager::get<NodeList>();
     
     nodeList->addNodeTypeToInterestSet(NodeType::Agent);
+
+    // the environment, mix and stats of a listener go out in one datagram when they fit
+    nodeList->getNodeSocket().setBundlingEnabled(true);
     
     nodeList->linkedDataCreateCallback = [](Node* node) {
         node->setLinkedData(std::unique_ptr<AudioMixerClientData> { new AudioMixerClientData });
@@ -672,6 +814,16 @@ void AudioMixer::domainSettingsRequestComplete() {
     
     // check the settings object to see if we have anything we can parse out
     parseSettingsObject(settingsObject);
+
+    // one mixing worker per core unless the domain settings ask for a specific number of mixing threads
+    int numMixingThreads = _numMixingThreads > 0 ? _numMixingThreads : std::max(QThread::idealThreadCount(), 1);
+    qDebug() << "Mixing with" << numMixingThreads << "mixing threads";
+
+    _mixBuffers.clear();
+    for (int i = 0; i < numMixingThreads; ++i) {
+        _mixBuffers.emplace_back(new MixBuffers);
+    }
+    _mixingPool.setMaxThreadCount(numMixingThreads);
     
     // queue up a connection to start broadcasting mixes now that we're ready to go
     QMetaObject::invokeMethod(this, "broadcastMixes", Qt::QueuedConnection);
@@ -683,6 +835,7 @@ void AudioMixer::broadcastMixes() {
     int64_t nextFrame = 0;
     QElapsedTimer timer;
     timer.start();
+    auto usecsElapsed = [&timer] { return (quint64)timer.nsecsElapsed() / NSECS_PER_USEC; };
     
     int64_t usecToSleep = AudioConstants::NETWORK_FRAME_USECS;
     
@@ -690,6 +843,9 @@ void AudioMixer::broadcastMixes() {
     int framesSinceCutoffEvent = TRAILING_AVERAGE_FRAMES;
     
     while (!_isFinished) {
+        auto traceFrameStart = trace::Clock::now();
+        quint64 frameStart = usecsElapsed();
+
         const float STRUGGLE_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.10f;
         const float BACK_OFF_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.20f;
         
@@ -748,6 +904,10 @@ void AudioMixer::broadcastMixes() {
             _lastPerSecondCallbackTime = now;
         }
         
+        QVector<SharedNodePointer> nodes;
+        QVector<SharedNodePointer> listeners;
+
+        quint64 stageStart = usecsElapsed();
         nodeList->eachNode([&](const SharedNodePointer& node) {
             
             if (node->getLinkedData()) {
@@ -764,60 +924,83 @@ void AudioMixer::broadcastMixes() {
                     auto mutePacket = NLPacket::create(PacketType::NoisyMute, 0);
                     nodeList->sendPacket(std::move(mutePacket), *node);
                 }
+
+                nodes.push_back(node);
                 
                 if (node->getType() == NodeType::Agent && node->getActiveSocket()
                     && nodeData->getAvatarAudioStream()) {
-                    
-                    int streamsMixed = prepareMixForListeningNode(node.data());
-                    
-                    std::unique_ptr<NLPacket> mixPacket;
-                    
-                    if (streamsMixed > 0) {
-                        int mixPacketBytes = sizeof(quint16) + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
-                        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
-                        
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
-                        
-                        // pack mixed audio samples
-                        mixPacket->write(reinterpret_cast<char*>(_mixSamples),
-                                         AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                    } else {
-                        int silentPacketBytes = sizeof(quint16) + sizeof(quint16);
-                        mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
-                        
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
-                        
-                        // pack number of silent audio samples
-                        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-                        mixPacket->writePrimitive(numSilentSamples);
-                    }
-                    
-                    // Send audio environment
-                    sendAudioEnvironmentPacket(node);
-                    
-                    // send mixed audio packet
-                    nodeList->sendPacket(std::move(mixPacket), *node);
-                    nodeData->incrementOutgoingMixedAudioSequenceNumber();
-                    
-                    // send an audio stream stats packet if it's time
-                    if (_sendAudioStreamStats) {
-                        nodeData->sendAudioStreamStatsPackets(node);
-                        _sendAudioStreamStats = false;
-                    }
-                    
-                    ++_sumListeners;
+                    listeners.push_back(node);
                 }
             }
         });
+
+        quint64 stageEnd = usecsElapsed();
+        _popTimes.record(stageEnd - stageStart);
+        stageStart = stageEnd;
+
+        // index the streams that popped something audible for this round so that each listener
+        // only visits the sources it could hear
+        buildSourceGrid(nodes);
+
+        // the zone reverbs only depend on the sources, so they are run once here for all of their listeners
+        if (_mixZoneReverb) {
+            renderZoneReverbs(nodes);
+        }
+
+        // mix for every listener now that all of the streams have popped their frame for this round,
+        // the node list lock is not held while the workers are mixing
+        stageEnd = usecsElapsed();
+        _gridTimes.record(stageEnd - stageStart);
+        stageStart = stageEnd;
+
+        std::vector<std::unique_ptr<NLPacket>> mixPackets;
+        mixForListeningNodes(listeners, _sourceGrid, mixPackets);
+
+        stageEnd = usecsElapsed();
+        _mixTimes.record(stageEnd - stageStart);
+        stageStart = stageEnd;
+
+        {
+            // send the mixes out together from this thread once all of them are ready, a batch of datagrams at a time
+            udt::Socket::BatchedSends batchedSends(nodeList->getNodeSocket());
+            for (int i = 0; i < listeners.size(); ++i) {
+                const SharedNodePointer& node = listeners[i];
+                AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
+
+                // Send audio environment
+                sendAudioEnvironmentPacket(node);
+
+                // send mixed audio packet
+                nodeList->sendPacket(std::move(mixPackets[i]), *node);
+                nodeData->incrementOutgoingMixedAudioSequenceNumber();
+
+                // send an audio stream stats packet if it's time
+                if (_sendAudioStreamStats) {
+                    nodeData->sendAudioStreamStatsPackets(node);
+                    _sendAudioStreamStats = false;
+                }
+
+                ++_sumListeners;
+            }
+        }
         
         ++_numStatFrames;
+
+        stageEnd = usecsElapsed();
+        _sendTimes.record(stageEnd - stageStart);
+        _frameTimes.record(stageEnd - frameStart);
+        stageStart = stageEnd;
+
+        // the frame is traced up to the events and the sleep that follow it
+        if (trace::isActive()) {
+            trace::record("AudioMixer::mixFrame", traceFrameStart, trace::Clock::now());
+        }
         
         // since we're a while loop we need to help Qt's event processing
         QCoreApplication::processEvents();
+
+        // the packets are read and decoded while the events are processed, so the decode time is in here as well
+        _eventTimes.record(usecsElapsed() - stageStart);
         
         if (_isFinished) {
             // at this point the audio-mixer is done
@@ -957,6 +1140,19 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             qDebug() << "Repetition with fade disabled";
         }
 
+        const QString TIME_STRETCH_JSON_KEY = "time_stretch";
+        _streamSettings._timeStretch = audioBufferGroupObject[TIME_STRETCH_JSON_KEY].toBool();
+        if (_streamSettings._timeStretch) {
+            qDebug() << "Time stretch enabled";
+        }
+
+        const QString TIME_STRETCH_PERCENTILE_JSON_KEY = "time_stretch_percentile";
+        _streamSettings._timeStretchPercentile = audioBufferGroupObject[TIME_STRETCH_PERCENTILE_JSON_KEY].toString().toFloat(&ok);
+        if (!ok) {
+            _streamSettings._timeStretchPercentile = DEFAULT_TIME_STRETCH_PERCENTILE;
+        }
+        qDebug() << "Time stretch percentile:" << _streamSettings._timeStretchPercentile;
+
         const QString PRINT_STREAM_STATS_JSON_KEY = "print_stream_stats";
         _printStreamStats = audioBufferGroupObject[PRINT_STREAM_STATS_JSON_KEY].toBool();
         if (_printStreamStats) {
@@ -987,6 +1183,15 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
 
+        const QString MIXING_THREADS_KEY = "mixing_threads";
+        if (audioEnvGroupObject[MIXING_THREADS_KEY].isString()) {
+            bool ok = false;
+            int numMixingThreads = audioEnvGroupObject[MIXING_THREADS_KEY].toString().toInt(&ok);
+            if (ok && numMixingThreads >= 0) {
+                _numMixingThreads = numMixingThreads;
+            }
+        }
+
         const QString FILTER_KEY = "enable_filter";
         if (audioEnvGroupObject[FILTER_KEY].isBool()) {
             _enableFilter = audioEnvGroupObject[FILTER_KEY].toBool();
@@ -995,6 +1200,22 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             qDebug() << "Filter enabled";
         }
 
+        const QString CODECS_KEY = "enable_codecs";
+        if (audioEnvGroupObject[CODECS_KEY].isBool()) {
+            _enableCodecs = audioEnvGroupObject[CODECS_KEY].toBool();
+        }
+        if (_enableCodecs) {
+            qDebug() << "Codecs enabled:" << AudioCodecs::getCodecNames();
+        }
+
+        const QString MIX_ZONE_REVERB_KEY = "mix_zone_reverb";
+        if (audioEnvGroupObject[MIX_ZONE_REVERB_KEY].isBool()) {
+            _mixZoneReverb = audioEnvGroupObject[MIX_ZONE_REVERB_KEY].toBool();
+        }
+        if (_mixZoneReverb) {
+            qDebug() << "Zone reverb is mixed by the audio mixer";
+        }
+
         const QString AUDIO_ZONES = "zones";
         if (audioEnvGroupObject[AUDIO_ZONES].isObject()) {
             const QJsonObject& zones = audioEnvGroupObject[AUDIO_ZONES].toObject();
@@ -1097,6 +1318,10 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
 
                         _zoneReverbSettings.push_back(settings);
                         qDebug() << "Added Reverb:" << zone << reverbTime << wetLevel;
+
+                        if (_mixZoneReverb) {
+                            _zoneReverbs.emplace_back(new AudioZoneReverb(reverbTime));
+                        }
                     }
                 }
             }
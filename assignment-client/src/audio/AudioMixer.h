@@ -12,15 +12,28 @@
 #ifndef hifi_AudioMixer_h
 #define hifi_AudioMixer_h
 
+#include <QtCore/QThreadPool>
+
 #include <AABox.h>
+#include <AudioBuffer.h>
 #include <AudioRingBuffer.h>
+#include <AudioSpatialization.h>
+#include <LatencyHistogram.h>
+#include <NLPacket.h>
+#include <Node.h>
 #include <ThreadedAssignment.h>
 
+#include "AudioSourceGrid.h"
+#include "AudioZoneReverb.h"
+
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioMixerClientData;
+class AudioSourceFrameCache;
+
+const int SAMPLE_PHASE_DELAY_AT_90 = AudioSpatialization::SAMPLE_PHASE_DELAY_AT_90;
 
-const int SAMPLE_PHASE_DELAY_AT_90 = 20;
+const int AUDIO_MIX_BUS_CHANNELS = 2;
 
 const int READ_DATAGRAMS_STATS_WINDOW_SECONDS = 30;
 
@@ -43,29 +56,66 @@ private slots:
     void broadcastMixes();
     void handleNodeAudioPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
     void handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
+    void handleNegotiateAudioFormat(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
 
 private:    
     void domainSettingsRequestComplete();
-    
+
+    /// scratch space for one mixing worker, each worker mixes a single listener at a time into these buffers
+    struct MixBuffers {
+        MixBuffers();
+
+        // used on a per stream basis to run the filter on before mixing
+        AudioBufferFloat32 preMix;
+
+        // the listener's mix bus, sources are accumulated here in float and only clamped once into mixSamples
+        AudioBufferFloat32 mix;
+
+        // the popped frame of the source being mixed, copied out of its ring buffer along with any historical
+        // samples needed for the phase delay
+        int16_t sourceSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + SAMPLE_PHASE_DELAY_AT_90];
+
+        // the finished mix that is sent to the listener
+        int16_t mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+        // number of streams this worker has mixed since its stats were last collected
+        int sumMixes { 0 };
+
+        // the usecs and bytes of the mixes of this worker's listeners this frame
+        LatencyHistogram listenerMixTimes;
+        LatencyHistogram listenerMixBytes;
+    };
+
     /// adds one stream to the mix for a listening node
-    int addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
+    int addStreamToMixForListeningNodeWithStream(MixBuffers& buffers,
+                                                    AudioMixerClientData* listenerNodeData,
                                                     const QUuid& streamUUID,
                                                     PositionalAudioStream* streamToAdd,
+                                                    AudioSourceFrameCache* sourceFrameCache,
                                                     AvatarAudioStream* listeningNodeStream);
 
-    /// prepares and sends a mix to one Node
-    int prepareMixForListeningNode(Node* node);
+    /// prepares a mix for one Node from the sources audible to it, returns the number of streams mixed
+    int prepareMixForListeningNode(MixBuffers& buffers, Node* node, const AudioSourceGrid& sources);
 
-    /// Send Audio Environment packet for a single node
-    void sendAudioEnvironmentPacket(SharedNodePointer node);
+    /// mixes for one Node and packs the result into a MixedAudio or SilentAudioFrame packet
+    std::unique_ptr<NLPacket> createMixPacketForListeningNode(MixBuffers& buffers, Node* node,
+                                                              const AudioSourceGrid& sources);
 
-    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
-    // data from a phase delay as well as an entire network buffer
-    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    /// mixes for every listener, spreading the listeners across the mixing workers
+    void mixForListeningNodes(const QVector<SharedNodePointer>& listeners, const AudioSourceGrid& sources,
+                              std::vector<std::unique_ptr<NLPacket>>& mixPackets);
 
-    // client samples capacity is larger than what will be sent to optimize mixing
-    // we are MMX adding 4 samples at a time so we need client samples to have an extra 4
-    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    /// fills the source grid with every stream of the given nodes that has something audible this frame
+    void buildSourceGrid(const QVector<SharedNodePointer>& nodes);
+
+    /// runs the reverb of every zone over the sources inside it, when the mixer applies zone reverb itself
+    void renderZoneReverbs(const QVector<SharedNodePointer>& nodes);
+
+    /// returns the index of the reverb zone containing position and its wet level there, or -1 if there is none
+    int findReverbZone(const glm::vec3& position, float& wetLevel) const;
+
+    /// Send Audio Environment packet for a single node
+    void sendAudioEnvironmentPacket(SharedNodePointer node);
 
     void perSecondActions();
 
@@ -82,6 +132,25 @@ private:
     int _sumListeners;
     int _sumMixes;
 
+    // the usecs each stage of the frames took since the stats were last sent, and those and the bytes of each mix
+    LatencyHistogram _decodeTimes;
+    LatencyHistogram _popTimes;
+    LatencyHistogram _gridTimes;
+    LatencyHistogram _mixTimes;
+    LatencyHistogram _sendTimes;
+    LatencyHistogram _eventTimes;
+    LatencyHistogram _frameTimes;
+    LatencyHistogram _listenerMixTimes;
+    LatencyHistogram _listenerMixBytes;
+
+    // one set of mix buffers per mixing worker, the mixing pool runs one job per worker each frame
+    int _numMixingThreads;
+    std::vector<std::unique_ptr<MixBuffers>> _mixBuffers;
+    QThreadPool _mixingPool;
+
+    // rebuilt every frame from the popped streams, shared read-only by the mixing workers
+    AudioSourceGrid _sourceGrid;
+
     QHash<QString, AABox> _audioZones;
     struct ZonesSettings {
         QString source;
@@ -96,6 +165,11 @@ private:
     };
     QVector<ReverbSettings> _zoneReverbSettings;
 
+    // when true the mixer adds zone reverb to the mixes itself, with one reverb per entry of _zoneReverbSettings
+    // whose wet tail is shared by all of the listeners in that zone
+    bool _mixZoneReverb;
+    std::vector<std::unique_ptr<AudioZoneReverb>> _zoneReverbs;
+
     static InboundAudioStream::Settings _streamSettings;
 
     static bool _printStreamStats;
@@ -105,6 +179,9 @@ private:
 
     bool _sendAudioStreamStats;
 
+    // when false every listener gets raw PCM, whatever codecs it offers
+    bool _enableCodecs;
+
     // stats
     MovingMinMaxAvg<int> _datagramsReadPerCallStats;     // update with # of datagrams read for each readPendingDatagrams call
     MovingMinMaxAvg<quint64> _timeSpentPerCallStats;     // update with usecs spent inside each readPendingDatagrams call
@@ -39,6 +39,10 @@ AudioMixerClientData::~AudioMixerClientData() {
     foreach(PerListenerSourcePairData* pairData, _listenerSourcePairData) {
         delete pairData;
     }
+
+    foreach(AudioSourceFrameCache* frameCache, _sourceFrameCaches) {
+        delete frameCache;
+    }
 }
 
 AvatarAudioStream* AudioMixerClientData::getAvatarAudioStream() const {
@@ -151,6 +155,7 @@ void AudioMixerClientData::removeDeadInjectedStreams() {
             int notMixedThreshold = audioStream->hasStarted() ? INJECTOR_CONSECUTIVE_NOT_MIXED_AFTER_STARTED_THRESHOLD
                                                               : INJECTOR_CONSECUTIVE_NOT_MIXED_THRESHOLD;
             if (audioStream->getConsecutiveNotMixedCount() >= notMixedThreshold) {
+                delete _sourceFrameCaches.take(i.key());
                 delete audioStream;
                 i = _audioStreams.erase(i);
                 continue;
@@ -342,3 +347,28 @@ PerListenerSourcePairData* AudioMixerClientData::getListenerSourcePairData(const
     }
     return _listenerSourcePairData[sourceUUID];
 }
+
+AudioSourceFrameCache* AudioMixerClientData::getSourceFrameCache(const QUuid& streamKey) {
+    if (!_sourceFrameCaches.contains(streamKey)) {
+        _sourceFrameCaches[streamKey] = new AudioSourceFrameCache();
+    }
+    return _sourceFrameCaches[streamKey];
+}
+
+void AudioMixerClientData::setupCodec(const AudioCodec* codec, const QString& codecName) {
+    _encoder.reset();
+    _selectedCodecName.clear();
+
+    if (codec) {
+        _selectedCodecName = codecName;
+        _encoder = codec->createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    }
+}
+
+void AudioMixerClientData::encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
+    if (_encoder) {
+        _encoder->encode(decodedBuffer, encodedBuffer);
+    } else {
+        encodedBuffer = decodedBuffer;
+    }
+}
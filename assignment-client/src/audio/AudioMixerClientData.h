@@ -19,9 +19,11 @@
 #include <AudioBuffer.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioFilter.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioFilterBank.h> // For AudioFilterHSF1s and _penumbraFilter
+#include <AudioCodec.h>
 
 #include "PositionalAudioStream.h"
 #include "AvatarAudioStream.h"
+#include "AudioSourceFrameCache.h"
 
 class PerListenerSourcePairData {
 public:
@@ -58,6 +60,16 @@ public:
     void printUpstreamDownstreamStats() const;
 
     PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID);
+
+    /// filtered frames of one of our own streams, shared by every listener that hears it
+    AudioSourceFrameCache* getSourceFrameCache(const QUuid& streamKey);
+
+    /// encodes the mixes sent to this listener with the given codec from here on, a null codec sends raw PCM
+    void setupCodec(const AudioCodec* codec, const QString& codecName);
+    const QString& getSelectedCodecName() const { return _selectedCodecName; }
+
+    /// encodes one mix for this listener, or copies it as is when there is no codec
+    void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer);
 private:
     void printAudioStreamStats(const AudioStreamStats& streamStats) const;
 
@@ -67,8 +79,15 @@ private:
     // TODO: how can we prune this hash when a stream is no longer present?
     QHash<QUuid, PerListenerSourcePairData*> _listenerSourcePairData;
 
+    // keyed the same way as _audioStreams, removed along with dead injected streams
+    QHash<QUuid, AudioSourceFrameCache*> _sourceFrameCaches;
+
     quint16 _outgoingMixedAudioSequenceNumber;
 
+    // only the mixing worker that owns this listener for the frame encodes with this
+    QString _selectedCodecName;
+    std::unique_ptr<AudioEncoder> _encoder;
+
     AudioStreamStats _downstreamAudioStreamStats;
 };
 
@@ -0,0 +1,78 @@
+//
+//  AudioSourceFrameCache.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#include <AudioFilter.h>
+
+#include "PositionalAudioStream.h"
+
+#include "AudioSourceFrameCache.h"
+
+const float INT16_TO_FLOAT_SCALE = 1.0f / 32768.0f;
+
+AudioSourceFrameCache::AudioSourceFrameCache() {
+    for (int i = 0; i < NUM_GAIN_BUCKETS; ++i) {
+        _buckets[i].isRendered = false;
+    }
+}
+
+void AudioSourceFrameCache::beginFrame(PositionalAudioStream* stream) {
+    _stream = stream;
+
+    for (int i = 0; i < NUM_GAIN_BUCKETS; ++i) {
+        _buckets[i].isRendered.store(false, std::memory_order_relaxed);
+    }
+}
+
+const float* AudioSourceFrameCache::getFilteredSamples(float filterGain) {
+    float bucketPosition = (filterGain - PENUMBRA_FILTER_MIN_GAIN) / (PENUMBRA_FILTER_MAX_GAIN - PENUMBRA_FILTER_MIN_GAIN);
+    int bucketIndex = (int)(bucketPosition * (NUM_GAIN_BUCKETS - 1) + 0.5f);
+    bucketIndex = std::max(0, std::min(bucketIndex, NUM_GAIN_BUCKETS - 1));
+
+    Bucket& bucket = _buckets[bucketIndex];
+
+    // the first worker to need this bucket renders it, everyone after that just reads it
+    if (!bucket.isRendered.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(_renderMutex);
+        if (!bucket.isRendered.load(std::memory_order_relaxed)) {
+            renderBucket(bucketIndex);
+            bucket.isRendered.store(true, std::memory_order_release);
+        }
+    }
+
+    return bucket.samples;
+}
+
+void AudioSourceFrameCache::renderBucket(int bucketIndex) {
+    const int NUM_SOURCE_SAMPLES = FILTER_WARMUP_SAMPLES + FILTERED_SAMPLES;
+
+    float bucketGain = PENUMBRA_FILTER_MIN_GAIN +
+        (PENUMBRA_FILTER_MAX_GAIN - PENUMBRA_FILTER_MIN_GAIN) * bucketIndex / (NUM_GAIN_BUCKETS - 1);
+
+    // TODO: like the phase delay in the mixer, this assumes the samples before the popped frame are still intact
+    int16_t sourceSamples[NUM_SOURCE_SAMPLES];
+    (_stream->getLastPopOutput() - (FILTER_WARMUP_SAMPLES + MAX_DELAY_SAMPLES)).readSamples(sourceSamples,
+                                                                                           NUM_SOURCE_SAMPLES);
+
+    float filterSamples[NUM_SOURCE_SAMPLES];
+    for (int i = 0; i < NUM_SOURCE_SAMPLES; ++i) {
+        filterSamples[i] = sourceSamples[i] * INT16_TO_FLOAT_SCALE;
+    }
+
+    AudioFilterHSF filter;
+    filter.setParameters(AudioConstants::SAMPLE_RATE, AudioSpatialization::PENUMBRA_FILTER_FREQUENCY_HZ, bucketGain,
+                         AudioSpatialization::PENUMBRA_FILTER_SLOPE);
+    filter.render(filterSamples, filterSamples, NUM_SOURCE_SAMPLES);
+
+    memcpy(_buckets[bucketIndex].samples, &filterSamples[FILTER_WARMUP_SAMPLES], sizeof(_buckets[bucketIndex].samples));
+}
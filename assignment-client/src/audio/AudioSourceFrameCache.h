@@ -0,0 +1,64 @@
+//
+//  AudioSourceFrameCache.h
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSourceFrameCache_h
+#define hifi_AudioSourceFrameCache_h
+
+#include <atomic>
+#include <mutex>
+
+#include <AudioConstants.h>
+#include <AudioSpatialization.h>
+
+class PositionalAudioStream;
+
+// the range of the penumbra filter gains, from behind to in front
+const float PENUMBRA_FILTER_MIN_GAIN = 0.708f;
+const float PENUMBRA_FILTER_MAX_GAIN = 1.0f;
+
+/// Per-frame cache of a mono source's popped frame run through the penumbra filter at a set of quantized gains.
+/// The filter is linear and time invariant within a frame, so every listener that hears the source through the
+/// same shelf gain can share one filtered frame and only apply its own attenuation and phase delay to it.
+class AudioSourceFrameCache {
+public:
+    static const int NUM_GAIN_BUCKETS = 16;
+
+    // filtered samples kept ahead of the frame for the phase delay of the weak channel
+    static const int MAX_DELAY_SAMPLES = 20;
+
+    // samples from before the frame the filter is run over so that it settles without keeping state across frames
+    static const int FILTER_WARMUP_SAMPLES = 64;
+
+    static const int FILTERED_SAMPLES = MAX_DELAY_SAMPLES + AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+    AudioSourceFrameCache();
+
+    /// invalidates the filtered frames, must be called for every frame before any mixing worker uses the cache
+    void beginFrame(PositionalAudioStream* stream);
+
+    /// returns the popped frame filtered at the bucket closest to filterGain and normalized to [-1.0, 1.0],
+    /// preceded by MAX_DELAY_SAMPLES filtered history samples. Safe to call from several mixing workers at once.
+    const float* getFilteredSamples(float filterGain);
+
+private:
+    struct Bucket {
+        std::atomic<bool> isRendered;
+        float samples[FILTERED_SAMPLES];
+    };
+
+    void renderBucket(int bucketIndex);
+
+    PositionalAudioStream* _stream { nullptr };
+
+    std::mutex _renderMutex;
+    Bucket _buckets[NUM_GAIN_BUCKETS];
+};
+
+#endif // hifi_AudioSourceFrameCache_h
@@ -0,0 +1,63 @@
+//
+//  AudioSourceGrid.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <math.h>
+
+#include "AudioSourceGrid.h"
+
+const float AudioSourceGrid::DEFAULT_CELL_SIZE = 16.0f;
+
+// each cell coordinate is packed into 21 bits of the key
+const int CELL_KEY_BITS = 21;
+const quint64 CELL_KEY_MASK = (1ULL << CELL_KEY_BITS) - 1;
+
+AudioSourceGrid::AudioSourceGrid(float cellSize) :
+    _cellSize(cellSize)
+{
+}
+
+void AudioSourceGrid::clear() {
+    _cellIndices.clear();
+    _cells.clear();
+    _sourceCount = 0;
+}
+
+quint64 AudioSourceGrid::cellKeyForPosition(const glm::vec3& position) const {
+    quint64 x = (quint64)(qint64)floorf(position.x / _cellSize) & CELL_KEY_MASK;
+    quint64 y = (quint64)(qint64)floorf(position.y / _cellSize) & CELL_KEY_MASK;
+    quint64 z = (quint64)(qint64)floorf(position.z / _cellSize) & CELL_KEY_MASK;
+    return (x << (2 * CELL_KEY_BITS)) | (y << CELL_KEY_BITS) | z;
+}
+
+void AudioSourceGrid::addSource(const Source& source, const glm::vec3& position, float audibleRadius) {
+    quint64 key = cellKeyForPosition(position);
+
+    int cellIndex = _cellIndices.value(key, -1);
+    if (cellIndex == -1) {
+        cellIndex = _cells.size();
+        _cellIndices.insert(key, cellIndex);
+
+        Cell cell;
+        cell.minimum = cell.maximum = position;
+        cell.maxAudibleRadius = 0.0f;
+        _cells.push_back(cell);
+    }
+
+    // cells keep the bounds of what was added to them rather than their grid bounds,
+    // so that positions far enough out to wrap the key still end up with correct bounds
+    Cell& cell = _cells[cellIndex];
+    cell.minimum = glm::min(cell.minimum, position);
+    cell.maximum = glm::max(cell.maximum, position);
+    cell.maxAudibleRadius = std::max(cell.maxAudibleRadius, audibleRadius);
+    cell.entries.push_back({ source, position, audibleRadius * audibleRadius });
+
+    ++_sourceCount;
+}
@@ -0,0 +1,92 @@
+//
+//  AudioSourceGrid.h
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSourceGrid_h
+#define hifi_AudioSourceGrid_h
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+class AudioSourceFrameCache;
+class Node;
+class PositionalAudioStream;
+
+/// Per-frame spatial hash of the audio streams that have something to mix, each with the distance it can be heard at.
+/// Lets every listener visit only the sources that could be audible to it instead of every stream on the mixer.
+class AudioSourceGrid {
+public:
+    struct Source {
+        Node* node;
+        QUuid streamUUID;
+        PositionalAudioStream* stream;
+        AudioSourceFrameCache* frameCache;
+    };
+
+    AudioSourceGrid(float cellSize = DEFAULT_CELL_SIZE);
+
+    void clear();
+
+    /// adds a source that can be heard by listeners closer than audibleRadius to position
+    void addSource(const Source& source, const glm::vec3& position, float audibleRadius);
+
+    int getSourceCount() const { return _sourceCount; }
+
+    /// calls function(const Source&) for every source that is within its audible radius of position
+    template <typename F>
+    void forEachAudibleSource(const glm::vec3& position, F function) const;
+
+    static const float DEFAULT_CELL_SIZE;
+
+private:
+    struct Entry {
+        Source source;
+        glm::vec3 position;
+        float audibleRadiusSquared;
+    };
+
+    struct Cell {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        float maxAudibleRadius;
+        QVector<Entry> entries;
+    };
+
+    quint64 cellKeyForPosition(const glm::vec3& position) const;
+
+    float _cellSize;
+    int _sourceCount { 0 };
+
+    QHash<quint64, int> _cellIndices;
+    QVector<Cell> _cells;
+};
+
+template <typename F>
+void AudioSourceGrid::forEachAudibleSource(const glm::vec3& position, F function) const {
+    // there are far fewer occupied cells than sources in a crowd, so reject whole cells first
+    foreach (const Cell& cell, _cells) {
+        glm::vec3 closestPoint = glm::clamp(position, cell.minimum, cell.maximum);
+        glm::vec3 offset = closestPoint - position;
+        if (glm::dot(offset, offset) > cell.maxAudibleRadius * cell.maxAudibleRadius) {
+            continue;
+        }
+
+        foreach (const Entry& entry, cell.entries) {
+            glm::vec3 relativePosition = entry.position - position;
+            if (glm::dot(relativePosition, relativePosition) <= entry.audibleRadiusSquared) {
+                function(entry.source);
+            }
+        }
+    }
+}
+
+#endif // hifi_AudioSourceGrid_h
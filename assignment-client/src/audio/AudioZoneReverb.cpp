@@ -0,0 +1,81 @@
+//
+//  AudioZoneReverb.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include <AudioMixKernels.h>
+
+#include "PositionalAudioStream.h"
+
+#include "AudioZoneReverb.h"
+
+const float INT16_TO_FLOAT_SCALE = 1.0f / 32768.0f;
+
+AudioZoneReverb::AudioZoneReverb(float reverbTime) :
+    _reverb(AudioConstants::SAMPLE_RATE),
+    _input(AudioConstants::STEREO, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL),
+    _wet(AudioConstants::STEREO, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL)
+{
+    // the reverb defaults to a fully wet output, which is what gets shared between the listeners
+    ReverbParameters parameters;
+    _reverb.getParameters(&parameters);
+    parameters.reverbTime = reverbTime;
+    _reverb.setParameters(&parameters);
+
+    // reverbTime is the time to decay by 60dB, keep the tail going until it has decayed by 96dB
+    const float TAIL_DECAY_RATIO = 96.0f / 60.0f;
+    float tailSeconds = TAIL_DECAY_RATIO * parameters.reverbTime + parameters.preDelay / 1000.0f;
+    _tailFrames = (int)ceilf(tailSeconds * AudioConstants::SAMPLE_RATE / AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+}
+
+void AudioZoneReverb::beginFrame() {
+    if (_hasInput) {
+        _input.zeroFrames();
+        _hasInput = false;
+    }
+}
+
+void AudioZoneReverb::addSource(const PositionalAudioStream* stream) {
+    if (!stream->lastPopSucceeded()) {
+        return;
+    }
+
+    AudioRingBuffer::ConstIterator popOutput = stream->getLastPopOutput();
+    float32_t** input = _input.getFrameData();
+
+    if (stream->isStereo()) {
+        popOutput.readSamples(_sourceSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+        AudioMixKernels::accumulateStereo(input[0], input[1], _sourceSamples, INT16_TO_FLOAT_SCALE,
+                                          AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    } else {
+        popOutput.readSamples(_sourceSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        AudioMixKernels::accumulateMono(input[0], _sourceSamples, INT16_TO_FLOAT_SCALE,
+                                        AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        AudioMixKernels::accumulateMono(input[1], _sourceSamples, INT16_TO_FLOAT_SCALE,
+                                        AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+
+    _hasInput = true;
+}
+
+void AudioZoneReverb::render() {
+    if (_hasInput) {
+        _tailFramesLeft = _tailFrames;
+    } else if (_tailFramesLeft > 0) {
+        --_tailFramesLeft;
+    }
+
+    if (_tailFramesLeft > 0) {
+        _reverb.render(_input.getFrameData(), _wet.getFrameData(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    } else {
+        // the tail has died out, start the next sound in the zone from silence
+        _reverb.reset();
+    }
+}
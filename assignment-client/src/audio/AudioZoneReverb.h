@@ -0,0 +1,57 @@
+//
+//  AudioZoneReverb.h
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioZoneReverb_h
+#define hifi_AudioZoneReverb_h
+
+#include <AudioBuffer.h>
+#include <AudioConstants.h>
+#include <AudioReverb.h>
+
+class PositionalAudioStream;
+
+/// The reverb of one audio zone, run by the mixer on everything audible inside the zone.
+/// Every listener in the zone mixes in the same wet tail, so the reverb is computed once per zone and frame
+/// instead of once per client.
+class AudioZoneReverb {
+public:
+    AudioZoneReverb(float reverbTime);
+
+    /// clears the reverb input, must be called for every frame before any source is added
+    void beginFrame();
+
+    /// adds the popped frame of a source inside the zone to the reverb input
+    void addSource(const PositionalAudioStream* stream);
+
+    /// runs the reverb over this frame's input, the tail keeps being rendered for a while after the zone goes quiet
+    void render();
+
+    /// true when this frame has a wet tail to mix in
+    bool hasWetTail() const { return _tailFramesLeft > 0; }
+
+    /// the wet tail of this frame, planar stereo normalized to [-1.0, 1.0]. Safe to read from several mixing
+    /// workers at once once render has returned.
+    float32_t** getWetTail() { return _wet.getFrameData(); }
+
+private:
+    AudioReverb _reverb;
+
+    AudioBufferFloat32 _input;
+    AudioBufferFloat32 _wet;
+    int16_t _sourceSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    bool _hasInput { false };
+
+    // frames until the tail has decayed below audibility after the last input
+    int _tailFrames;
+    int _tailFramesLeft { 0 };
+};
+
+#endif // hifi_AudioZoneReverb_h
@@ -9,28 +9,51 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <atomic>
 #include <cfloat>
-#include <random>
+#include <climits>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <queue>
+#include <random>
+#include <unordered_set>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QJsonObject>
+#include <QtCore/QRunnable>
 #include <QtCore/QTimer>
 #include <QtCore/QThread>
+#include <QtCore/QVector>
 
+#include <GLMHelpers.h>
 #include <LogHandler.h>
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 #include <UUID.h>
 #include <TryLocker.h>
+#include <shared/Trace.h>
 
 #include "AvatarMixerClientData.h"
 #include "AvatarMixer.h"
 
 const QString AVATAR_MIXER_LOGGING_NAME = "avatar-mixer";
 
+// runs one worker's share of the listeners for a frame on the broadcast pool
+class BroadcastListenersTask : public QRunnable {
+public:
+    BroadcastListenersTask(std::function<void()> broadcastFunction) : _broadcastFunction(broadcastFunction) {
+        setAutoDelete(true);
+    }
+    void run() override { _broadcastFunction(); }
+
+private:
+    std::function<void()> _broadcastFunction;
+};
+
 const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 60;
 const unsigned int AVATAR_DATA_SEND_INTERVAL_MSECS = (1.0f / (float) AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) * 1000;
 
@@ -53,6 +76,8 @@ AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "handleAvatarIdentityPacket");
     packetReceiver.registerListener(PacketType::AvatarBillboard, this, "handleAvatarBillboardPacket");
     packetReceiver.registerListener(PacketType::KillAvatar, this, "handleKillAvatarPacket");
+    packetReceiver.registerListener(PacketType::AvatarQuery, this, "handleAvatarQueryPacket");
+    packetReceiver.registerListener(PacketType::ReplicatedBulkAvatarData, this, "handleReplicatedBulkAvatarDataPacket");
 }
 
 AvatarMixer::~AvatarMixer() {
@@ -64,17 +89,33 @@ AvatarMixer::~AvatarMixer() {
     _broadcastThread.wait();
 }
 
-// An 80% chance of sending a identity packet within a 5 second interval.
-// assuming 60 htz update rate.
-const float BILLBOARD_AND_IDENTITY_SEND_PROBABILITY = 1.0f / 187.0f;
+// avatars outside of a node's view frustum are sent to it less often, nodes that haven't sent their camera yet
+// get the avatars in a forward cone of their body first instead
+const float IN_VIEW_MIN_COSINE = 0.5f;
+const float OUT_OF_VIEW_PRIORITY_SCALE = 0.25f;
+
+// the radius of the sphere around an avatar's position that is checked against the view frustum
+const float AVATAR_VIEW_BOUNDING_RADIUS = 1.0f;
+
+// how often the other avatar-mixers are sent all of the joints of our avatars, and how long a replicated avatar that
+// isn't heard from any more is kept around in case its kill was lost
+const quint64 REPLICATED_FULL_UPDATE_INTERVAL_FRAMES = 60;
+const quint64 REPLICATED_AVATAR_TIMEOUT_USECS = 5 * USECS_PER_SECOND;
+
+// avatars closer than this all get the priority of an avatar at this distance
+const float MIN_PRIORITY_DISTANCE = 1.0f;
+
+// the most identity and billboard bytes sent to a node in one frame, the rest of a burst of joins or changes waits
+// for the next frames so it doesn't hold up the avatar data behind it
+const int MAX_IDENTITY_AND_BILLBOARD_BYTES_PER_FRAME = 2048;
 
-// NOTE: some additional optimizations to consider.
-//    1) use the view frustum to cull those avatars that are out of view. Since avatar data doesn't need to be present
-//       if the avatar is not in view or in the keyhole.
 void AvatarMixer::broadcastAvatarData() {
+    TRACE_SCOPE("AvatarMixer::broadcastAvatarData");
+
     int idleTime = QDateTime::currentMSecsSinceEpoch() - _lastFrameTimestamp;
 
     ++_numStatFrames;
+    ++_numBroadcastFrames;
 
     const float STRUGGLE_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.10f;
     const float BACK_OFF_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.20f;
@@ -88,9 +129,9 @@ void AvatarMixer::broadcastAvatarData() {
     const float PREVIOUS_FRAMES_RATIO = 1.0f - CURRENT_FRAME_RATIO;
 
     // NOTE: The following code calculates the _performanceThrottlingRatio based on how much the avatar-mixer was
-    // able to sleep. This will eventually be used to ask for an additional avatar-mixer to help out. Currently the value
-    // is unused as it is assumed this should not be hit before the avatar-mixer hits the desired bandwidth limit per client.
-    // It is reported in the domain-server stats for the avatar-mixer.
+    // able to sleep. Currently the value is unused as it is assumed this should not be hit before the avatar-mixer hits
+    // the desired bandwidth limit per client. It is reported in the domain-server stats for the avatar-mixer, so a domain
+    // that runs out of room can split its agents across more avatar-mixers (avatar_mixer.num_avatar_mixers).
 
     _trailingSleepRatio = (PREVIOUS_FRAMES_RATIO * _trailingSleepRatio)
         + (idleTime * CURRENT_FRAME_RATIO / (float) AVATAR_DATA_SEND_INTERVAL_MSECS);
@@ -130,307 +171,631 @@ void AvatarMixer::broadcastAvatarData() {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
-    // setup for distributed random floating point values
-    std::random_device randomDevice;
-    std::mt19937 generator(randomDevice());
-    std::uniform_real_distribution<float> distribution;
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    auto usecsElapsed = [&frameTimer] { return (quint64)frameTimer.nsecsElapsed() / NSECS_PER_USEC; };
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-            if (!node->getLinkedData()) {
-                return false;
+    // copy what the listeners need out of every avatar while its data is locked, the broadcast workers only read
+    // these snapshots so the packet handlers never wait on an avatar for more than this
+    _avatarSnapshots.clear();
+    QVector<SharedNodePointer> listeners;
+    QVector<SharedNodePointer> peers;
+    std::unordered_set<QUuid> localAvatars;
+
+    nodeList->eachNode([&](const SharedNodePointer& node) {
+        AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+        if (!nodeData) {
+            return;
+        }
+
+        if (node->getType() == NodeType::AvatarMixer) {
+            if (node->getActiveSocket()) {
+                peers << node;
             }
-            if (node->getType() != NodeType::Agent) {
-                return false;
+            return;
+        }
+
+        MutexTryLocker lock(nodeData->getMutex());
+        if (!lock.isLocked()) {
+            return;
+        }
+
+        if (node->getType() == NodeType::Agent && node->getActiveSocket()) {
+            listeners << node;
+        }
+
+        AvatarSnapshot snapshot;
+        snapshot.node = node;
+        snapshot.isReplicated = false;
+        snapshotAvatar(node->getUUID(), nodeData, snapshot);
+        _avatarSnapshots.push_back(snapshot);
+        localAvatars.insert(node->getUUID());
+    });
+
+    // then the avatars the other avatar-mixers have the agents for, which our listeners see like any other
+    QVector<QUuid> timedOutAvatars;
+    {
+        QMutexLocker replicatedAvatarsLocker(&_replicatedAvatarsMutex);
+        quint64 now = usecTimestampNow();
+
+        for (auto& replicatedAvatar : _replicatedAvatars) {
+            if (now - replicatedAvatar.second.lastHeardUsecs > REPLICATED_AVATAR_TIMEOUT_USECS) {
+                timedOutAvatars << replicatedAvatar.first;
+                continue;
             }
-            if (!node->getActiveSocket()) {
-                return false;
+
+            // an agent that just moved over to us is still replicated to us for a moment, our own data wins
+            if (localAvatars.find(replicatedAvatar.first) != localAvatars.end()) {
+                continue;
             }
-            return true;
-        },
-        [&](const SharedNodePointer& node) {
-            AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+
+            AvatarMixerClientData* nodeData = replicatedAvatar.second.data.get();
             MutexTryLocker lock(nodeData->getMutex());
             if (!lock.isLocked()) {
-                return;
+                continue;
             }
-            ++_sumListeners;
 
-            AvatarData& avatar = nodeData->getAvatar();
-            glm::vec3 myPosition = avatar.getClientGlobalPosition();
+            AvatarSnapshot snapshot;
+            snapshot.replicatedData = replicatedAvatar.second.data;
+            snapshot.isReplicated = true;
+            snapshotAvatar(replicatedAvatar.first, nodeData, snapshot);
+            _avatarSnapshots.push_back(snapshot);
+        }
+    }
 
-            // reset the internal state for correct random number distribution
-            distribution.reset();
+    if (!timedOutAvatars.isEmpty()) {
+        removeReplicatedAvatars(timedOutAvatars);
+    }
 
-            // reset the max distance for this frame
-            float maxAvatarDistanceThisFrame = 0.0f;
+    // build the packets for every listener, the listeners are independent so the workers pull them from a shared
+    // counter until they run out - a worker that finishes its listeners early takes some of the others
+    quint64 snapshotEnd = usecsElapsed();
 
-            // reset the number of sent avatars
-            nodeData->resetNumAvatarsSentLastFrame();
+    std::vector<ListenerPackets> listenerPackets(listeners.size());
+    std::atomic<int> nextListener { 0 };
 
-            // keep a counter of the number of considered avatars
-            int numOtherAvatars = 0;
+    std::random_device randomDevice;
+    unsigned int frameSeed = randomDevice();
 
-            // keep track of outbound data rate specifically for avatar data
-            int numAvatarDataBytes = 0;
+    // each worker times its own listeners, they are added up once all of them are done
+    std::vector<LatencyHistogram> workerListenerTimes;
 
-            // keep track of the number of other avatars held back in this frame
-            int numAvatarsHeldBack = 0;
+    auto broadcastListeners = [&](int worker) {
+        // setup for distributed random floating point values
+        std::mt19937 generator(frameSeed + worker);
 
-            // keep track of the number of other avatar frames skipped
-            int numAvatarsWithSkippedFrames = 0;
+        QElapsedTimer listenerTimer;
+        int listener;
+        while ((listener = nextListener++) < listeners.size()) {
+            listenerTimer.start();
+            broadcastToListener(listeners[listener], generator, listenerPackets[listener]);
+            workerListenerTimes[worker].record(listenerTimer.nsecsElapsed() / NSECS_PER_USEC);
+        }
+    };
 
-            // use the data rate specifically for avatar data for FRD adjustment checks
-            float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
+    int numWorkers = std::min(_broadcastPool.maxThreadCount(), listeners.size());
+    workerListenerTimes.resize(std::max(numWorkers, 1));
+    if (numWorkers <= 1) {
+        // a single worker runs right here, no need to hop over to the pool
+        if (numWorkers == 1) {
+            broadcastListeners(0);
+        }
+    } else {
+        for (int worker = 0; worker < numWorkers; ++worker) {
+            _broadcastPool.start(new BroadcastListenersTask([=, &broadcastListeners] { broadcastListeners(worker); }));
+        }
 
-            // Check if it is time to adjust what we send this client based on the observed
-            // bandwidth to this node. We do this once a second, which is also the window for
-            // the bandwidth reported by node->getOutboundBandwidth();
-            if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
+        _broadcastPool.waitForDone();
+    }
 
-                const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
-                const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
-                const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
+    quint64 broadcastEnd = usecsElapsed();
+    LatencyHistogram listenerBytes;
 
-                // get the current full rate distance so we can work with it
-                float currentFullRateDistance = nodeData->getFullRateDistance();
+    // our own avatars go out to the other avatar-mixers so their listeners can see them
+    // the unreliable packets below are queued and handed to the OS a batch at a time
+    udt::Socket::BatchedSends batchedSends(nodeList->getNodeSocket());
 
-                if (avatarDataRateLastSecond > _maxKbpsPerNode) {
+    for (const SharedNodePointer& peer : peers) {
+        replicateToPeer(peer);
+    }
 
-                    // is the FRD greater than the farthest avatar?
-                    // if so, before we calculate anything, set it to that distance
-                    currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
+    // send everything out from this thread once all of the listeners are done
+    for (int i = 0; i < listeners.size(); ++i) {
+        ListenerPackets& packets = listenerPackets[i];
+        if (!packets.avatarPacketList) {
+            continue;
+        }
+        ++_sumListeners;
 
-                    // we're adjusting the full rate distance to target a bandwidth in the middle
-                    // of the hysterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+        listenerBytes.record(packets.avatarPacketList->getDataSize() +
+                             (packets.identityPacketList ? packets.identityPacketList->getDataSize() : 0) +
+                             (packets.billboardPacketList ? packets.billboardPacketList->getDataSize() : 0));
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
-                           && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
-                    // we are constrained AND we've recovered to below the acceptable ratio
-                    // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+        // the identities and billboards that changed go out reliably, all of them together in one message of each type
+        if (packets.numIdentityPackets > 0) {
+            nodeList->sendPacketList(std::move(packets.identityPacketList), *listeners[i]);
+        }
+        if (packets.numBillboardPackets > 0) {
+            nodeList->sendPacketList(std::move(packets.billboardPacketList), *listeners[i]);
+        }
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                }
-            } else {
-                nodeData->incrementNumFramesSinceFRDAdjustment();
-            }
+        // send the avatar data PacketList
+        nodeList->sendPacketList(std::move(packets.avatarPacketList), *listeners[i]);
+
+        _sumBillboardPackets += packets.numBillboardPackets;
+        _sumIdentityPackets += packets.numIdentityPackets;
+    }
+
+    quint64 sendEnd = usecsElapsed();
+    {
+        QMutexLocker frameTimingLocker(&_frameTimingMutex);
+        _snapshotTimes.record(snapshotEnd);
+        _broadcastTimes.record(broadcastEnd - snapshotEnd);
+        _sendTimes.record(sendEnd - broadcastEnd);
+        _frameTimes.record(sendEnd);
+        for (const auto& listenerTimes : workerListenerTimes) {
+            _listenerTimes.merge(listenerTimes);
+        }
+        _listenerBytes.merge(listenerBytes);
+    }
+
+    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
+
+void AvatarMixer::snapshotAvatar(const QUuid& uuid, AvatarMixerClientData* nodeData, AvatarSnapshot& snapshot) {
+    AvatarData& avatar = nodeData->getAvatar();
+
+    snapshot.uuid = uuid;
+    snapshot.nodeData = nodeData;
+    snapshot.position = avatar.getClientGlobalPosition();
+    for (int detail = 0; detail < AvatarMixerClientData::NumAvatarDataDetails; ++detail) {
+        auto avatarDataDetail = (AvatarMixerClientData::AvatarDataDetail)detail;
+        snapshot.encodedAvatarData[detail] = nodeData->getEncodedAvatarData(avatarDataDetail, uuid, _numBroadcastFrames);
+        snapshot.encodedSequenceNumbers[detail] = nodeData->getEncodedSequenceNumber(avatarDataDetail);
+    }
+    snapshot.lastReceivedSequenceNumber = nodeData->getLastReceivedSequenceNumber();
+    snapshot.billboardChangeTimestamp = nodeData->getBillboardChangeTimestamp();
+    if (snapshot.billboardChangeTimestamp > 0) {
+        snapshot.billboard = avatar.getBillboard();
+    }
+    snapshot.identityChangeTimestamp = nodeData->getIdentityChangeTimestamp();
+    if (snapshot.identityChangeTimestamp > 0) {
+        snapshot.identity = avatar.identityByteArray();
+        snapshot.identity.replace(0, NUM_BYTES_RFC4122_UUID, uuid.toRfc4122());
+    }
+
+    // We're done encoding this version of the avatar.  Update its "lastSent" joint-states so
+    // that we can notice differences, next time around.
+    avatar.doneEncoding(false);
+}
+
+void AvatarMixer::replicateToPeer(const SharedNodePointer& peer) {
+    AvatarMixerClientData* peerData = reinterpret_cast<AvatarMixerClientData*>(peer->getLinkedData());
+    QMutexLocker peerDataLocker(&peerData->getMutex());
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // the peer gets the changed joints of every one of our avatars every frame, like a listener with no budget
+    // would, and all of them now and then to repair what was lost
+    auto avatarDataDetail = _numBroadcastFrames % REPLICATED_FULL_UPDATE_INTERVAL_FRAMES == 0
+        ? AvatarMixerClientData::AllJoints : AvatarMixerClientData::ChangedJoints;
+
+    auto avatarPacketList = NLPacketList::create(PacketType::ReplicatedBulkAvatarData);
+    auto identityPacketList = NLPacketList::create(PacketType::AvatarIdentity, QByteArray(), true, true);
+    auto billboardPacketList = NLPacketList::create(PacketType::AvatarBillboard, QByteArray(), true, true);
+    identityPacketList->setPriority(udt::PacketList::Priority::High);
+    billboardPacketList->setPriority(udt::PacketList::Priority::High);
+    int numAvatars = 0;
+    int numIdentities = 0;
+    int numBillboards = 0;
+
+    for (const AvatarSnapshot& avatar : _avatarSnapshots) {
+        // each mixer only replicates the avatars of its own agents, so nothing goes round in circles
+        if (avatar.isReplicated) {
+            continue;
+        }
+
+        const QByteArray& encodedAvatarData = avatar.encodedAvatarData[avatarDataDetail];
+        if (encodedAvatarData.size() > std::numeric_limits<quint16>::max()) {
+            continue;
+        }
+
+        avatarPacketList->startSegment();
+        avatarPacketList->writePrimitive(avatar.encodedSequenceNumbers[avatarDataDetail]);
+        avatarPacketList->writePrimitive((quint16)encodedAvatarData.size());
+        avatarPacketList->write(encodedAvatarData);
+        avatarPacketList->endSegment();
+        ++numAvatars;
+
+        if (avatar.identityChangeTimestamp > peerData->getLastIdentitySentTimestamp(avatar.uuid)) {
+            identityPacketList->writePrimitive((quint32)avatar.identity.size());
+            identityPacketList->write(avatar.identity);
+            peerData->setLastIdentitySentTimestamp(avatar.uuid, avatar.identityChangeTimestamp);
+            ++numIdentities;
+        }
+
+        if (avatar.billboardChangeTimestamp > peerData->getLastBillboardSentTimestamp(avatar.uuid)) {
+            billboardPacketList->write(avatar.uuid.toRfc4122());
+            billboardPacketList->writePrimitive((quint32)avatar.billboard.size());
+            billboardPacketList->write(avatar.billboard);
+            peerData->setLastBillboardSentTimestamp(avatar.uuid, avatar.billboardChangeTimestamp);
+            ++numBillboards;
+        }
+    }
 
-            // setup a PacketList for the avatarPackets
-            auto avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
+    if (numAvatars > 0) {
+        nodeList->sendPacketList(std::move(avatarPacketList), *peer);
+    }
+    if (numIdentities > 0) {
+        nodeList->sendPacketList(std::move(identityPacketList), *peer);
+    }
+    if (numBillboards > 0) {
+        nodeList->sendPacketList(std::move(billboardPacketList), *peer);
+    }
+}
+
+void AvatarMixer::broadcastToListener(const SharedNodePointer& node, std::mt19937& generator, ListenerPackets& packets) {
+    AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+    MutexTryLocker lock(nodeData->getMutex());
+    if (!lock.isLocked()) {
+        return;
+    }
 
-            // this is an AGENT we have received head data from
-            // send back a packet with other active node data to this node
-            nodeList->eachMatchingNode(
-                [&](const SharedNodePointer& otherNode)->bool {
-                    if (!otherNode->getLinkedData()) {
-                        return false;
-                    }
-                    if (otherNode->getUUID() == node->getUUID()) {
-                        return false;
-                    }
+    AvatarData& avatar = nodeData->getAvatar();
+    glm::vec3 myPosition = avatar.getClientGlobalPosition();
 
-                    return true;
-                },
-                [&](const SharedNodePointer& otherNode) {
-                    ++numOtherAvatars;
+    std::uniform_real_distribution<float> distribution;
 
-                    AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-                    MutexTryLocker lock(otherNodeData->getMutex());
-                    if (!lock.isLocked()) {
-                        return;
-                    }
+    // reset the max distance for this frame
+    float maxAvatarDistanceThisFrame = 0.0f;
 
-                    // make sure we send out identity and billboard packets to and from new arrivals.
-                    bool forceSend = !otherNodeData->checkAndSetHasReceivedFirstPacketsFrom(node->getUUID());
+    // reset the number of sent avatars
+    nodeData->resetNumAvatarsSentLastFrame();
 
-                    // we will also force a send of billboard or identity packet
-                    // if either has changed in the last frame
-                    if (otherNodeData->getBillboardChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
-                            || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+    // keep a counter of the number of considered avatars
+    int numOtherAvatars = 0;
 
-                        QByteArray rfcUUID = otherNode->getUUID().toRfc4122();
-                        QByteArray billboard = otherNodeData->getAvatar().getBillboard();
+    // keep track of outbound data rate specifically for avatar data
+    int numAvatarDataBytes = 0;
 
-                        auto billboardPacket = NLPacket::create(PacketType::AvatarBillboard, rfcUUID.size() + billboard.size());
-                        billboardPacket->write(rfcUUID);
-                        billboardPacket->write(billboard);
+    // keep track of the number of other avatars held back in this frame
+    int numAvatarsHeldBack = 0;
 
-                        nodeList->sendPacket(std::move(billboardPacket), *node);
+    // keep track of the number of other avatar frames skipped
+    int numAvatarsWithSkippedFrames = 0;
 
-                        ++_sumBillboardPackets;
-                    }
+    // this frame's byte budget for other avatar data - budget left unused isn't saved up for later frames,
+    // but going over it is paid back in the next frames
+    const float maxBytesPerFrame = _maxKbpsPerNode * BYTES_PER_KILOBIT / AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND;
+    float byteBudget = nodeData->addAvatarDataByteCredit(maxBytesPerFrame);
 
-                    if (otherNodeData->getIdentityChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
-                            || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+    glm::vec3 myFront = avatar.getLocalOrientation() * Vectors::FRONT;
 
-                        QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
+    struct AvatarPriority {
+        float priority;
+        bool isInView;
+        const AvatarSnapshot* avatar;
 
-                        auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size());
+        bool operator<(const AvatarPriority& other) const { return priority < other.priority; }
+    };
 
-                        individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
+    // the other avatars with data this node hasn't been sent yet, most important first
+    std::priority_queue<AvatarPriority> sortedAvatars;
+
+    // setup a PacketList for the avatarPackets
+    packets.avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
+
+    // and reliable ones for the identities and billboards, so a change is only sent once to each node - ahead of
+    // any bulk transfer to it
+    packets.identityPacketList = NLPacketList::create(PacketType::AvatarIdentity, QByteArray(), true, true);
+    packets.billboardPacketList = NLPacketList::create(PacketType::AvatarBillboard, QByteArray(), true, true);
+    packets.identityPacketList->setPriority(udt::PacketList::Priority::High);
+    packets.billboardPacketList->setPriority(udt::PacketList::Priority::High);
+    int identityAndBillboardBytes = 0;
+
+    // this is an AGENT we have received head data from
+    // send back a packet with other active node data to this node
+    for (const AvatarSnapshot& other : _avatarSnapshots) {
+        const QUuid& otherUUID = other.uuid;
+        if (otherUUID == node->getUUID()) {
+            continue;
+        }
 
-                        identityPacket->write(individualData);
+        ++numOtherAvatars;
 
-                        nodeList->sendPacket(std::move(identityPacket), *node);
+        // send the identity and billboard of new arrivals, and again whenever either changes, as long as this frame's
+        // bytes for them aren't used up - whatever doesn't fit goes out in the next frames
+        if (other.identityChangeTimestamp > nodeData->getLastIdentitySentTimestamp(otherUUID)
+            && identityAndBillboardBytes < MAX_IDENTITY_AND_BILLBOARD_BYTES_PER_FRAME) {
 
-                        ++_sumIdentityPackets;
-                    }
+            identityAndBillboardBytes += packets.identityPacketList->write(other.identity);
+            nodeData->setLastIdentitySentTimestamp(otherUUID, other.identityChangeTimestamp);
 
-                    AvatarData& otherAvatar = otherNodeData->getAvatar();
-                    //  Decide whether to send this avatar's data based on it's distance from us
+            ++packets.numIdentityPackets;
+        }
 
-                    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
-                    //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
-                    glm::vec3 otherPosition = otherAvatar.getClientGlobalPosition();
-                    float distanceToAvatar = glm::length(myPosition - otherPosition);
+        if (other.billboardChangeTimestamp > nodeData->getLastBillboardSentTimestamp(otherUUID)
+            && identityAndBillboardBytes < MAX_IDENTITY_AND_BILLBOARD_BYTES_PER_FRAME) {
 
-                    // potentially update the max full rate distance for this frame
-                    maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+            identityAndBillboardBytes += packets.billboardPacketList->write(otherUUID.toRfc4122());
+            identityAndBillboardBytes += packets.billboardPacketList->writePrimitive((quint32)other.billboard.size());
+            identityAndBillboardBytes += packets.billboardPacketList->write(other.billboard);
+            nodeData->setLastBillboardSentTimestamp(otherUUID, other.billboardChangeTimestamp);
 
-                    if (distanceToAvatar != 0.0f
-                        && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
-                        return;
-                    }
+            ++packets.numBillboardPackets;
+        }
 
-                    AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
-                    AvatarDataSequenceNumber lastSeqFromSender = otherNodeData->getLastReceivedSequenceNumber();
+        float distanceToAvatar = glm::length(myPosition - other.position);
 
-                    if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
-                        // we got out out of order packets from the sender, track it
-                        otherNodeData->incrementNumOutOfOrderSends();
-                    }
+        // potentially update the max full rate distance for this frame
+        maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
 
-                    // make sure we haven't already sent this data from this sender to this receiver
-                    // or that somehow we haven't sent
-                    if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
-                        ++numAvatarsHeldBack;
-                        return;
-                    } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
-                        // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
-                        ++numAvatarsWithSkippedFrames;
-                    }
+        AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherUUID);
+        AvatarDataSequenceNumber lastSeqFromSender = other.lastReceivedSequenceNumber;
 
-                    // we're going to send this avatar
+        if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
+            // we got out out of order packets from the sender, track it
+            other.nodeData->incrementNumOutOfOrderSends();
+        }
 
-                    // increment the number of avatars sent to this reciever
-                    nodeData->incrementNumAvatarsSentLastFrame();
+        // make sure we haven't already sent this data from this sender to this receiver
+        // or that somehow we haven't sent
+        if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
+            ++numAvatarsHeldBack;
+            continue;
+        }
 
-                    // set the last sent sequence number for this sender on the receiver
-                    nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(),
-                                                             otherNodeData->getLastReceivedSequenceNumber());
+        // closer avatars, avatars this node can see and avatars that haven't been sent for a while go first
+        quint64 framesSinceSent = _numBroadcastFrames - nodeData->getLastOtherAvatarSentFrame(otherUUID);
+        bool isInView;
+        if (nodeData->hasViewFrustum()) {
+            isInView = nodeData->getViewFrustum().sphereInFrustum(other.position, AVATAR_VIEW_BOUNDING_RADIUS)
+                != ViewFrustum::OUTSIDE;
+        } else {
+            isInView = distanceToAvatar == 0.0f
+                || glm::dot(myFront, (other.position - myPosition) / distanceToAvatar) >= IN_VIEW_MIN_COSINE;
+        }
+        float viewScale = isInView ? 1.0f : OUT_OF_VIEW_PRIORITY_SCALE;
 
-                    // start a new segment in the PacketList for this avatar
-                    avatarPacketList->startSegment();
+        AvatarPriority avatarPriority;
+        avatarPriority.priority = (float)framesSinceSent * viewScale / std::max(distanceToAvatar, MIN_PRIORITY_DISTANCE);
+        avatarPriority.isInView = isInView;
+        avatarPriority.avatar = &other;
+        sortedAvatars.push(avatarPriority);
+    }
 
-                    numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
-                    numAvatarDataBytes +=
-                        avatarPacketList->write(otherAvatar.toByteArray(false, distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO));
+    // send the other avatars in priority order until the budget is spent, the first always goes out so a
+    // tight budget still moves every avatar forward eventually
+    while (!sortedAvatars.empty() && (numAvatarDataBytes == 0 || numAvatarDataBytes < byteBudget)) {
+        const AvatarSnapshot& other = *sortedAvatars.top().avatar;
+        bool isInView = sortedAvatars.top().isInView;
+        sortedAvatars.pop();
+
+        const QUuid& otherUUID = other.uuid;
+        AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherUUID);
+
+        // every receiver of the other avatar gets the same data, encoded once when the frame started - avatars out
+        // of view skip frames, so they always get every joint to be whole once they come into view
+        int detail = !isInView || distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO
+            ? AvatarMixerClientData::AllJoints : AvatarMixerClientData::ChangedJoints;
+        AvatarDataSequenceNumber encodedSequenceNumber = other.encodedSequenceNumbers[detail];
+
+        if (encodedSequenceNumber - lastSeqToReceiver > 1) {
+            // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
+            ++numAvatarsWithSkippedFrames;
+        }
 
-                    avatarPacketList->endSegment();
-            });
+        // increment the number of avatars sent to this reciever
+        nodeData->incrementNumAvatarsSentLastFrame();
 
-            // close the current packet so that we're always sending something
-            avatarPacketList->closeCurrentPacket(true);
+        // set the last sent sequence number for this sender on the receiver
+        nodeData->setLastBroadcastSequenceNumber(otherUUID, encodedSequenceNumber);
+        nodeData->setLastOtherAvatarSentFrame(otherUUID, _numBroadcastFrames);
 
-            // send the avatar data PacketList
-            nodeList->sendPacketList(std::move(avatarPacketList), *node);
+        // start a new segment in the PacketList for this avatar
+        packets.avatarPacketList->startSegment();
 
-            // record the bytes sent for other avatar data in the AvatarMixerClientData
-            nodeData->recordSentAvatarData(numAvatarDataBytes);
+        numAvatarDataBytes += packets.avatarPacketList->write(other.encodedAvatarData[detail]);
 
-            // record the number of avatars held back this frame
-            nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
-            nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+        packets.avatarPacketList->endSegment();
+    }
 
-            if (numOtherAvatars == 0) {
-                // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
-                nodeData->setMaxAvatarDistance(FLT_MAX);
-            } else {
-                nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
+    // what's left in the queue waits for a later frame, the oldest of it is this node's worst staleness
+    quint64 maxFramesSinceSent = 0;
+    while (!sortedAvatars.empty()) {
+        const QUuid& otherUUID = sortedAvatars.top().avatar->uuid;
+        maxFramesSinceSent = std::max(maxFramesSinceSent,
+                                      _numBroadcastFrames - nodeData->getLastOtherAvatarSentFrame(otherUUID));
+        sortedAvatars.pop();
+    }
+    nodeData->setMaxOtherAvatarStaleness((int)std::min(maxFramesSinceSent, (quint64)INT_MAX));
+
+    nodeData->spendAvatarDataByteCredit(numAvatarDataBytes);
+
+    // close the current packet so that we're always sending something
+    packets.avatarPacketList->closeCurrentPacket(true);
+
+    // record the bytes sent for other avatar data in the AvatarMixerClientData
+    nodeData->recordSentAvatarData(numAvatarDataBytes);
+
+    // record the number of avatars held back this frame
+    nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
+    nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+
+    if (numOtherAvatars == 0) {
+        // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
+        nodeData->setMaxAvatarDistance(FLT_MAX);
+    } else {
+        nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
+    }
+}
+
+void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
+    if (killedNode->getType() == NodeType::Agent
+        && killedNode->getLinkedData()) {
+        // this was an avatar we were sending to other people, and replicating to the other avatar-mixers
+        broadcastKillAvatar(killedNode->getUUID(), true);
+    } else if (killedNode->getType() == NodeType::AvatarMixer) {
+        // the avatars that mixer had the agents for are gone with it, their agents will be moved over to a mixer
+        // that's still around and come back
+        QVector<QUuid> peerAvatars;
+        {
+            QMutexLocker replicatedAvatarsLocker(&_replicatedAvatarsMutex);
+            for (auto& replicatedAvatar : _replicatedAvatars) {
+                if (replicatedAvatar.second.peerUUID == killedNode->getUUID()) {
+                    peerAvatars << replicatedAvatar.first;
+                }
             }
         }
-    );
+        removeReplicatedAvatars(peerAvatars);
+    }
+}
 
-    // We're done encoding this version of the otherAvatars.  Update their "lastSent" joint-states so
-    // that we can notice differences, next time around.
+void AvatarMixer::broadcastKillAvatar(const QUuid& avatarUUID, bool toPeers) {
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // send a kill packet for it to our other nodes
+    auto killPacket = NLPacket::create(PacketType::KillAvatar, NUM_BYTES_RFC4122_UUID);
+    killPacket->write(avatarUUID.toRfc4122());
+
+    NodeSet killedNodeTypes = NodeSet() << NodeType::Agent;
+    if (toPeers) {
+        killedNodeTypes << NodeType::AvatarMixer;
+    }
+    nodeList->broadcastToNodes(std::move(killPacket), killedNodeTypes);
+
+    // we also want to remove sequence number data for this avatar on our other avatars
+    // so invoke the appropriate method on the AvatarMixerClientData for other avatars
     nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& otherNode)->bool {
-            if (!otherNode->getLinkedData()) {
-                return false;
-            }
-            if (otherNode->getType() != NodeType::Agent) {
+        [&](const SharedNodePointer& node)->bool {
+            if (!node->getLinkedData()) {
                 return false;
             }
-            if (!otherNode->getActiveSocket()) {
+
+            if (node->getUUID() == avatarUUID) {
                 return false;
             }
+
             return true;
         },
-        [&](const SharedNodePointer& otherNode) {
-            AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-            MutexTryLocker lock(otherNodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
-            }
-            AvatarData& otherAvatar = otherNodeData->getAvatar();
-            otherAvatar.doneEncoding(false);
-        });
+        [&](const SharedNodePointer& node) {
+            QMetaObject::invokeMethod(node->getLinkedData(),
+                                      "removeLastBroadcastSequenceNumber",
+                                      Qt::AutoConnection,
+                                      Q_ARG(const QUuid&, avatarUUID));
+        }
+    );
+}
 
-    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+void AvatarMixer::removeReplicatedAvatars(const QVector<QUuid>& avatarUUIDs) {
+    {
+        QMutexLocker replicatedAvatarsLocker(&_replicatedAvatarsMutex);
+        for (const QUuid& avatarUUID : avatarUUIDs) {
+            _replicatedAvatars.erase(avatarUUID);
+        }
+    }
+
+    // the snapshots of this frame hold on to the data of the removed avatars until the listeners are done with it
+    for (const QUuid& avatarUUID : avatarUUIDs) {
+        broadcastKillAvatar(avatarUUID, false);
+    }
 }
 
-void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
-    if (killedNode->getType() == NodeType::Agent
-        && killedNode->getLinkedData()) {
-        auto nodeList = DependencyManager::get<NodeList>();
+void AvatarMixer::handleAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->updateNodeWithDataFromPacket(message, senderNode);
+}
+
+AvatarMixer::ReplicatedAvatar& AvatarMixer::replicatedAvatarForPeer(const QUuid& avatarUUID, const QUuid& peerUUID) {
+    ReplicatedAvatar& replicatedAvatar = _replicatedAvatars[avatarUUID];
+    if (!replicatedAvatar.data) {
+        replicatedAvatar.data = std::make_shared<AvatarMixerClientData>();
+        replicatedAvatar.data->getAvatar().setJointRotationCompressionBits(_jointRotationCompressionBits);
+    }
+    replicatedAvatar.peerUUID = peerUUID;
+    replicatedAvatar.lastHeardUsecs = usecTimestampNow();
+    return replicatedAvatar;
+}
 
-        // this was an avatar we were sending to other people
-        // send a kill packet for it to our other nodes
-        auto killPacket = NLPacket::create(PacketType::KillAvatar, NUM_BYTES_RFC4122_UUID);
-        killPacket->write(killedNode->getUUID().toRfc4122());
+void AvatarMixer::handleReplicatedBulkAvatarDataPacket(QSharedPointer<ReceivedMessage> message,
+                                                        SharedNodePointer senderNode) {
+    if (senderNode->getType() != NodeType::AvatarMixer) {
+        return;
+    }
 
-        nodeList->broadcastToNodes(std::move(killPacket), NodeSet() << NodeType::Agent);
+    QMutexLocker replicatedAvatarsLocker(&_replicatedAvatarsMutex);
 
-        // we also want to remove sequence number data for this avatar on our other avatars
-        // so invoke the appropriate method on the AvatarMixerClientData for other avatars
-        nodeList->eachMatchingNode(
-            [&](const SharedNodePointer& node)->bool {
-                if (!node->getLinkedData()) {
-                    return false;
-                }
+    // each of the avatars in the feed is its sequence number, its size and then its UUID and data
+    const qint64 REPLICATED_AVATAR_HEADER_BYTES = sizeof(AvatarDataSequenceNumber) + sizeof(quint16);
+    while (message->getBytesLeftToRead() >= REPLICATED_AVATAR_HEADER_BYTES) {
+        AvatarDataSequenceNumber sequenceNumber;
+        message->readPrimitive(&sequenceNumber);
+        quint16 avatarSize;
+        message->readPrimitive(&avatarSize);
 
-                if (node->getUUID() == killedNode->getUUID()) {
-                    return false;
-                }
+        if (avatarSize < NUM_BYTES_RFC4122_UUID || avatarSize > message->getBytesLeftToRead()) {
+            break;
+        }
 
-                return true;
-            },
-            [&](const SharedNodePointer& node) {
-                QMetaObject::invokeMethod(node->getLinkedData(),
-                                          "removeLastBroadcastSequenceNumber",
-                                          Qt::AutoConnection,
-                                          Q_ARG(const QUuid&, QUuid(killedNode->getUUID())));
-            }
-        );
+        QUuid avatarUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        QByteArray avatarData = message->readWithoutCopy(avatarSize - NUM_BYTES_RFC4122_UUID);
+
+        ReplicatedAvatar& replicatedAvatar = replicatedAvatarForPeer(avatarUUID, senderNode->getUUID());
+
+        QMutexLocker nodeDataLocker(&replicatedAvatar.data->getMutex());
+        replicatedAvatar.data->parseReplicatedData(sequenceNumber, avatarData);
     }
 }
 
-void AvatarMixer::handleAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
-    auto nodeList = DependencyManager::get<NodeList>();
-    nodeList->updateNodeWithDataFromPacket(message, senderNode);
+void AvatarMixer::handleReplicatedAvatarIdentities(ReceivedMessage& message, const QUuid& peerUUID) {
+    QMutexLocker replicatedAvatarsLocker(&_replicatedAvatarsMutex);
+
+    // each identity is sized, and starts with the UUID of its avatar
+    while (message.getBytesLeftToRead() >= (qint64)sizeof(quint32)) {
+        quint32 identitySize;
+        message.readPrimitive(&identitySize);
+        if (identitySize < NUM_BYTES_RFC4122_UUID || (qint64)identitySize > message.getBytesLeftToRead()) {
+            break;
+        }
+
+        QByteArray identity = message.read(identitySize);
+        QUuid avatarUUID = QUuid::fromRfc4122(identity.left(NUM_BYTES_RFC4122_UUID));
+
+        // the identity can get here before the avatar's first data does
+        AvatarMixerClientData* nodeData = replicatedAvatarForPeer(avatarUUID, peerUUID).data.get();
+        QMutexLocker nodeDataLocker(&nodeData->getMutex());
+        if (nodeData->getAvatar().hasIdentityChangedAfterParsing(identity)) {
+            nodeData->setIdentityChangeTimestamp(QDateTime::currentMSecsSinceEpoch());
+        }
+    }
+}
+
+void AvatarMixer::handleReplicatedAvatarBillboards(ReceivedMessage& message, const QUuid& peerUUID) {
+    QMutexLocker replicatedAvatarsLocker(&_replicatedAvatarsMutex);
+
+    // each billboard is the UUID of its avatar, then the sized billboard
+    while (message.getBytesLeftToRead() >= (qint64)(NUM_BYTES_RFC4122_UUID + sizeof(quint32))) {
+        QUuid avatarUUID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        quint32 billboardSize;
+        message.readPrimitive(&billboardSize);
+        if ((qint64)billboardSize > message.getBytesLeftToRead()) {
+            break;
+        }
+
+        QByteArray billboard = message.read(billboardSize);
+
+        AvatarMixerClientData* nodeData = replicatedAvatarForPeer(avatarUUID, peerUUID).data.get();
+        QMutexLocker nodeDataLocker(&nodeData->getMutex());
+        if (nodeData->getAvatar().hasBillboardChangedAfterParsing(billboard)) {
+            nodeData->setBillboardChangeTimestamp(QDateTime::currentMSecsSinceEpoch());
+        }
+    }
 }
 
 void AvatarMixer::handleAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
-    if (senderNode->getLinkedData()) {
+    if (senderNode->getType() == NodeType::AvatarMixer) {
+        // the identities of the avatars another avatar-mixer replicates to us
+        handleReplicatedAvatarIdentities(*message, senderNode->getUUID());
+    } else if (senderNode->getLinkedData()) {
         AvatarMixerClientData* nodeData = dynamic_cast<AvatarMixerClientData*>(senderNode->getLinkedData());
         if (nodeData != nullptr) {
             AvatarData& avatar = nodeData->getAvatar();
@@ -445,6 +810,11 @@ void AvatarMixer::handleAvatarIdentityPacket(QSharedPointer<ReceivedMessage> mes
 }
 
 void AvatarMixer::handleAvatarBillboardPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    if (senderNode->getType() == NodeType::AvatarMixer) {
+        handleReplicatedAvatarBillboards(*message, senderNode->getUUID());
+        return;
+    }
+
     AvatarMixerClientData* nodeData = dynamic_cast<AvatarMixerClientData*>(senderNode->getLinkedData());
     if (nodeData) {
         AvatarData& avatar = nodeData->getAvatar();
@@ -458,8 +828,23 @@ void AvatarMixer::handleAvatarBillboardPacket(QSharedPointer<ReceivedMessage> me
     }
 }
 
-void AvatarMixer::handleKillAvatarPacket(QSharedPointer<ReceivedMessage> message) {
-    DependencyManager::get<NodeList>()->processKillNode(*message);
+void AvatarMixer::handleAvatarQueryPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    AvatarMixerClientData* nodeData = dynamic_cast<AvatarMixerClientData*>(senderNode->getLinkedData());
+    if (nodeData) {
+        QMutexLocker nodeDataLocker(&nodeData->getMutex());
+        nodeData->readViewFrustumPacket(*message);
+    }
+}
+
+void AvatarMixer::handleKillAvatarPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    if (senderNode->getType() == NodeType::AvatarMixer) {
+        // an agent of another avatar-mixer left, its avatar goes away here too
+        QVector<QUuid> killedAvatars;
+        killedAvatars << QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        removeReplicatedAvatars(killedAvatars);
+    } else {
+        DependencyManager::get<NodeList>()->processKillNode(*message);
+    }
 }
 
 void AvatarMixer::sendStatsPacket() {
@@ -469,9 +854,31 @@ void AvatarMixer::sendStatsPacket() {
     statsObject["average_billboard_packets_per_frame"] = (float) _sumBillboardPackets / (float) _numStatFrames;
     statsObject["average_identity_packets_per_frame"] = (float) _sumIdentityPackets / (float) _numStatFrames;
 
+    {
+        QMutexLocker replicatedAvatarsLocker(&_replicatedAvatarsMutex);
+        statsObject["replicated_avatars"] = (int) _replicatedAvatars.size();
+    }
+
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
 
+    {
+        // where the time of the broadcasts went, in usecs, and the bytes sent to each listener
+        QMutexLocker frameTimingLocker(&_frameTimingMutex);
+        QJsonObject frameTimingStats;
+        auto addHistogram = [&](const QString& name, LatencyHistogram& histogram) {
+            frameTimingStats[name] = histogram.toJson();
+            histogram.reset();
+        };
+        addHistogram("snapshot", _snapshotTimes);
+        addHistogram("broadcast", _broadcastTimes);
+        addHistogram("send", _sendTimes);
+        addHistogram("frame", _frameTimes);
+        addHistogram("listener", _listenerTimes);
+        addHistogram("listener_bytes", _listenerBytes);
+        statsObject["frame_timing"] = frameTimingStats;
+    }
+
     QJsonObject avatarsObject;
 
     auto nodeList = DependencyManager::get<NodeList>();
@@ -535,13 +942,26 @@ void AvatarMixer::run() {
 void AvatarMixer::domainSettingsRequestComplete() {
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->addNodeTypeToInterestSet(NodeType::Agent);
-    
-    nodeList->linkedDataCreateCallback = [] (Node* node) {
-        node->setLinkedData(std::unique_ptr<AvatarMixerClientData> { new AvatarMixerClientData });
-    };
+
+    // the other avatar-mixers of the domain, if it splits its agents between several, to share our avatars with
+    nodeList->addNodeTypeToInterestSet(NodeType::AvatarMixer);
+
+    // the small identity and billboard packets share datagrams with the avatar data
+    nodeList->getNodeSocket().setBundlingEnabled(true);
     
     // parse the settings to pull out the values we need
     parseDomainServerSettings(nodeList->getDomainHandler().getSettingsObject());
+
+    // one broadcast worker per core unless the domain settings ask for a specific number of broadcast threads
+    int numBroadcastThreads = _numBroadcastThreads > 0 ? _numBroadcastThreads : std::max(QThread::idealThreadCount(), 1);
+    qDebug() << "Broadcasting avatar data with" << numBroadcastThreads << "broadcast threads";
+    _broadcastPool.setMaxThreadCount(numBroadcastThreads);
+
+    nodeList->linkedDataCreateCallback = [this] (Node* node) {
+        auto clientData = std::unique_ptr<AvatarMixerClientData> { new AvatarMixerClientData };
+        clientData->getAvatar().setJointRotationCompressionBits(_jointRotationCompressionBits);
+        node->setLinkedData(std::move(clientData));
+    };
     
     // start the broadcastThread
     _broadcastThread.start();
@@ -560,4 +980,20 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
 
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qDebug() << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps.";
+
+    const QString JOINT_ROTATION_BITS_KEY = "joint_rotation_bits";
+    QJsonValue jointRotationBitsValue = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[JOINT_ROTATION_BITS_KEY];
+    bool ok = false;
+    int jointRotationBits = jointRotationBitsValue.toString().toInt(&ok);
+    if (ok) {
+        _jointRotationCompressionBits = glm::clamp(jointRotationBits, MIN_SMALLEST_THREE_QUAT_BITS,
+                                                   MAX_SMALLEST_THREE_QUAT_BITS);
+    }
+    qDebug() << "Joint rotations are sent with" << _jointRotationCompressionBits << "bits per component.";
+
+    const QString BROADCAST_THREADS_KEY = "broadcast_threads";
+    int numBroadcastThreads = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[BROADCAST_THREADS_KEY].toString().toInt(&ok);
+    if (ok) {
+        _numBroadcastThreads = std::max(numBroadcastThreads, 0);
+    }
 }
@@ -15,8 +15,23 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+
+#include <AvatarData.h>
+#include <LatencyHistogram.h>
+#include <NLPacket.h>
+#include <NLPacketList.h>
+#include <Node.h>
 #include <ThreadedAssignment.h>
 
+#include "AvatarMixerClientData.h"
+
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
     Q_OBJECT
@@ -35,11 +50,59 @@ private slots:
     void handleAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAvatarBillboardPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
-    void handleKillAvatarPacket(QSharedPointer<ReceivedMessage> message);
+    void handleKillAvatarPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAvatarQueryPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleReplicatedBulkAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void domainSettingsRequestComplete();
     
 private:
+    /// what every listener needs from one avatar this frame, copied while its data was locked when the frame started
+    struct AvatarSnapshot {
+        QUuid uuid;
+        SharedNodePointer node; // keeps nodeData alive for an avatar of one of our own agents
+        std::shared_ptr<AvatarMixerClientData> replicatedData; // or for an avatar replicated from another mixer
+        AvatarMixerClientData* nodeData;
+        bool isReplicated;
+        glm::vec3 position;
+        QByteArray encodedAvatarData[AvatarMixerClientData::NumAvatarDataDetails];
+        AvatarDataSequenceNumber encodedSequenceNumbers[AvatarMixerClientData::NumAvatarDataDetails];
+        AvatarDataSequenceNumber lastReceivedSequenceNumber;
+        quint64 billboardChangeTimestamp;
+        QByteArray billboard;
+        quint64 identityChangeTimestamp;
+        QByteArray identity;
+    };
+
+    /// the packets for one listener, built by a broadcast worker and sent from the broadcast thread
+    struct ListenerPackets {
+        std::unique_ptr<NLPacketList> identityPacketList;
+        std::unique_ptr<NLPacketList> billboardPacketList;
+        std::unique_ptr<NLPacketList> avatarPacketList;
+        int numBillboardPackets = 0;
+        int numIdentityPackets = 0;
+    };
+
+    /// an avatar one of the other avatar-mixers in the domain has the agent for, kept up to date by that mixer's feed
+    struct ReplicatedAvatar {
+        QUuid peerUUID;
+        std::shared_ptr<AvatarMixerClientData> data;
+        quint64 lastHeardUsecs;
+    };
+
     void broadcastAvatarData();
+    /// copies what the listeners need out of an avatar (local or replicated), its data has to be locked
+    void snapshotAvatar(const QUuid& uuid, AvatarMixerClientData* nodeData, AvatarSnapshot& snapshot);
+    /// sends the avatars of our own agents to the other avatar-mixers, from the snapshots of this frame
+    void replicateToPeer(const SharedNodePointer& peer);
+    /// tells our agents an avatar is gone, and the other avatar-mixers too if it was one of our own
+    void broadcastKillAvatar(const QUuid& avatarUUID, bool toPeers);
+    void removeReplicatedAvatars(const QVector<QUuid>& avatarUUIDs);
+    /// finds or adds the replicated avatar and marks it as just heard from that peer, _replicatedAvatarsMutex is held
+    ReplicatedAvatar& replicatedAvatarForPeer(const QUuid& avatarUUID, const QUuid& peerUUID);
+    void handleReplicatedAvatarIdentities(ReceivedMessage& message, const QUuid& peerUUID);
+    void handleReplicatedAvatarBillboards(ReceivedMessage& message, const QUuid& peerUUID);
+    /// builds this frame's packets for one listener from the avatar snapshots, runs on the broadcast workers
+    void broadcastToListener(const SharedNodePointer& node, std::mt19937& generator, ListenerPackets& packets);
     void parseDomainServerSettings(const QJsonObject& domainSettings);
     
     QThread _broadcastThread;
@@ -54,7 +117,27 @@ private:
     int _sumBillboardPackets;
     int _sumIdentityPackets;
 
+    // the usecs each stage of the broadcasts took since the stats were last sent, and those and the bytes of each
+    // listener's packets, the broadcast thread adds each frame to them and the main thread reads them for the stats
+    QMutex _frameTimingMutex;
+    LatencyHistogram _snapshotTimes;
+    LatencyHistogram _broadcastTimes;
+    LatencyHistogram _sendTimes;
+    LatencyHistogram _frameTimes;
+    LatencyHistogram _listenerTimes;
+    LatencyHistogram _listenerBytes;
+
+    quint64 _numBroadcastFrames { 0 }; // identifies the frame the avatar data cached on each AvatarMixerClientData was encoded for
+
     float _maxKbpsPerNode = 0.0f;
+    int _jointRotationCompressionBits = DEFAULT_JOINT_ROTATION_COMPRESSION_BITS;
+
+    int _numBroadcastThreads = 0; // 0 means one per core
+    QThreadPool _broadcastPool;
+    std::vector<AvatarSnapshot> _avatarSnapshots; // rebuilt every frame, shared read-only by the broadcast workers
+
+    QMutex _replicatedAvatarsMutex; // the peer feed is read on the main thread, the broadcast thread snapshots from it
+    std::unordered_map<QUuid, ReplicatedAvatar> _replicatedAvatars;
 
     QTimer* _broadcastTimer = nullptr;
 };
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <glm/gtc/matrix_transform.hpp>
+
 #include <udt/PacketHeaders.h>
 
 #include "AvatarMixerClientData.h"
@@ -21,12 +23,72 @@ int AvatarMixerClientData::parseData(ReceivedMessage& message) {
     return _avatar->parseDataFromBuffer(message.readWithoutCopy(message.getBytesLeftToRead()));
 }
 
-bool AvatarMixerClientData::checkAndSetHasReceivedFirstPacketsFrom(const QUuid& uuid) {
-    if (_hasReceivedFirstPacketsFrom.find(uuid) == _hasReceivedFirstPacketsFrom.end()) {
-        _hasReceivedFirstPacketsFrom.insert(uuid);
-        return false;
+int AvatarMixerClientData::parseReplicatedData(uint16_t sequenceNumber, const QByteArray& avatarData) {
+    _lastReceivedSequenceNumber = sequenceNumber;
+    return _avatar->parseDataFromBuffer(avatarData);
+}
+
+const QByteArray& AvatarMixerClientData::getEncodedAvatarData(AvatarDataDetail detail, const QUuid& nodeUUID, quint64 frame) {
+    EncodedAvatarData& encoded = _encodedAvatarData[detail];
+    if (!encoded.isValid || encoded.frame != frame) {
+        // QByteArray is implicitly shared, so the blob is never copied again until it is written into a packet
+        encoded.data = nodeUUID.toRfc4122();
+        encoded.data.append(_avatar->toByteArray(false, detail == AllJoints));
+        encoded.sequenceNumber = _lastReceivedSequenceNumber;
+        encoded.frame = frame;
+        encoded.isValid = true;
+    }
+    return encoded.data;
+}
+
+// other avatars this close to the camera count as in view whichever way it faces
+const float AVATAR_VIEW_KEYHOLE_RADIUS = 1.0f;
+
+void AvatarMixerClientData::readViewFrustumPacket(ReceivedMessage& message) {
+    glm::vec3 position;
+    glm::quat orientation;
+    float fieldOfView, aspectRatio, nearClip, farClip;
+
+    const qint64 VIEW_FRUSTUM_PACKET_SIZE = sizeof(position) + sizeof(orientation) + 4 * sizeof(float);
+    if (message.getBytesLeftToRead() < VIEW_FRUSTUM_PACKET_SIZE) {
+        return;
+    }
+
+    message.readPrimitive(&position);
+    message.readPrimitive(&orientation);
+    message.readPrimitive(&fieldOfView);
+    message.readPrimitive(&aspectRatio);
+    message.readPrimitive(&nearClip);
+    message.readPrimitive(&farClip);
+
+    if (fieldOfView <= 0.0f || aspectRatio <= 0.0f || nearClip <= 0.0f || farClip <= nearClip) {
+        return;
+    }
+
+    _viewFrustum.setPosition(position);
+    _viewFrustum.setOrientation(orientation);
+    _viewFrustum.setKeyholeRadius(AVATAR_VIEW_KEYHOLE_RADIUS);
+    _viewFrustum.setProjection(glm::perspective(glm::radians(fieldOfView), aspectRatio, nearClip, farClip));
+    _viewFrustum.calculate();
+    _hasViewFrustum = true;
+}
+
+quint64 AvatarMixerClientData::getLastIdentitySentTimestamp(const QUuid& nodeUUID) const {
+    auto nodeMatch = _lastIdentitySentTimestamps.find(nodeUUID);
+    if (nodeMatch != _lastIdentitySentTimestamps.end()) {
+        return nodeMatch->second;
+    } else {
+        return 0;
+    }
+}
+
+quint64 AvatarMixerClientData::getLastBillboardSentTimestamp(const QUuid& nodeUUID) const {
+    auto nodeMatch = _lastBillboardSentTimestamps.find(nodeUUID);
+    if (nodeMatch != _lastBillboardSentTimestamps.end()) {
+        return nodeMatch->second;
+    } else {
+        return 0;
     }
-    return true;
 }
 
 uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const {
@@ -39,14 +101,38 @@ uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& node
     }
 }
 
+void AvatarMixerClientData::removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) {
+    // this comes in from the main thread, and a broadcast worker could be using these for this node right now
+    QMutexLocker locker(&getMutex());
+    _lastBroadcastSequenceNumbers.erase(nodeUUID);
+    _lastOtherAvatarSentFrames.erase(nodeUUID);
+    _lastIdentitySentTimestamps.erase(nodeUUID);
+    _lastBillboardSentTimestamps.erase(nodeUUID);
+}
+
+quint64 AvatarMixerClientData::getLastOtherAvatarSentFrame(const QUuid& nodeUUID) const {
+    auto nodeMatch = _lastOtherAvatarSentFrames.find(nodeUUID);
+    if (nodeMatch != _lastOtherAvatarSentFrames.end()) {
+        return nodeMatch->second;
+    } else {
+        return 0;
+    }
+}
+
+float AvatarMixerClientData::addAvatarDataByteCredit(float bytesPerFrame) {
+    // unused credit from earlier frames is dropped, and going over is only paid back for up to a frame
+    _avatarDataByteCredit = std::min(std::max(_avatarDataByteCredit, -bytesPerFrame) + bytesPerFrame, bytesPerFrame);
+    return _avatarDataByteCredit;
+}
+
 void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["display_name"] = _avatar->getDisplayName();
-    jsonObject["full_rate_distance"] = _fullRateDistance;
+    jsonObject["max_other_av_staleness_frames"] = _maxOtherAvatarStaleness;
     jsonObject["max_av_distance"] = _maxAvatarDistance;
     jsonObject["num_avs_sent_last_frame"] = _numAvatarsSentLastFrame;
     jsonObject["avg_other_av_starves_per_second"] = getAvgNumOtherAvatarStarvesPerSecond();
     jsonObject["avg_other_av_skips_per_second"] = getAvgNumOtherAvatarSkipsPerSecond();
-    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends;
+    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends.load();
 
     jsonObject[OUTBOUND_AVATAR_DATA_STATS_KEY] = getOutboundAvatarDataKbps();
     jsonObject[INBOUND_AVATAR_DATA_STATS_KEY] = _avatar->getAverageBytesReceivedPerSecond() / (float) BYTES_PER_KILOBIT;
@@ -13,9 +13,9 @@
 #define hifi_AvatarMixerClientData_h
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <unordered_map>
-#include <unordered_set>
 
 #include <QtCore/QJsonObject>
 #include <QtCore/QUrl>
@@ -26,6 +26,7 @@
 #include <udt/PacketHeaders.h>
 #include <SimpleMovingAverage.h>
 #include <UUIDHasher.h>
+#include <ViewFrustum.h>
 
 const QString OUTBOUND_AVATAR_DATA_STATS_KEY = "outbound_av_data_kbps";
 const QString INBOUND_AVATAR_DATA_STATS_KEY = "inbound_av_data_kbps";
@@ -33,15 +34,39 @@ const QString INBOUND_AVATAR_DATA_STATS_KEY = "inbound_av_data_kbps";
 class AvatarMixerClientData : public NodeData {
     Q_OBJECT
 public:
+    /// the levels of detail the avatar data is encoded at for other nodes
+    enum AvatarDataDetail {
+        ChangedJoints = 0,  /// only the joints that changed since the last frame the mixer sent
+        AllJoints,          /// every joint, sent now and then so lost updates are eventually repaired
+        NumAvatarDataDetails
+    };
+
     int parseData(ReceivedMessage& message) override;
+    /// parses avatar data another avatar-mixer replicated to us, for an avatar that isn't one of our nodes
+    int parseReplicatedData(uint16_t sequenceNumber, const QByteArray& avatarData);
     AvatarData& getAvatar() { return *_avatar; }
 
-    bool checkAndSetHasReceivedFirstPacketsFrom(const QUuid& uuid);
+    /// returns this avatar's UUID and data, encoded once per broadcast frame and shared by every node that is sent it
+    const QByteArray& getEncodedAvatarData(AvatarDataDetail detail, const QUuid& nodeUUID, quint64 frame);
+    /// the sequence number of the data returned by the most recent getEncodedAvatarData for that detail
+    uint16_t getEncodedSequenceNumber(AvatarDataDetail detail) const { return _encodedAvatarData[detail].sequenceNumber; }
+
+    /// the change timestamp of the other avatar's identity or billboard this node was last sent, 0 if it never was
+    quint64 getLastIdentitySentTimestamp(const QUuid& nodeUUID) const;
+    void setLastIdentitySentTimestamp(const QUuid& nodeUUID, quint64 timestamp)
+        { _lastIdentitySentTimestamps[nodeUUID] = timestamp; }
+    quint64 getLastBillboardSentTimestamp(const QUuid& nodeUUID) const;
+    void setLastBillboardSentTimestamp(const QUuid& nodeUUID, quint64 timestamp)
+        { _lastBillboardSentTimestamps[nodeUUID] = timestamp; }
 
     uint16_t getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const;
     void setLastBroadcastSequenceNumber(const QUuid& nodeUUID, uint16_t sequenceNumber)
         { _lastBroadcastSequenceNumbers[nodeUUID] = sequenceNumber; }
-    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) { _lastBroadcastSequenceNumbers.erase(nodeUUID); }
+    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID);
+
+    /// the broadcast frame the other avatar was last sent to this node in, 0 if it never was
+    quint64 getLastOtherAvatarSentFrame(const QUuid& nodeUUID) const;
+    void setLastOtherAvatarSentFrame(const QUuid& nodeUUID, quint64 frame) { _lastOtherAvatarSentFrames[nodeUUID] = frame; }
 
     uint16_t getLastReceivedSequenceNumber() const { return _lastReceivedSequenceNumber; }
 
@@ -51,8 +76,17 @@ public:
     quint64 getIdentityChangeTimestamp() const { return _identityChangeTimestamp; }
     void setIdentityChangeTimestamp(quint64 identityChangeTimestamp) { _identityChangeTimestamp = identityChangeTimestamp; }
 
-    void setFullRateDistance(float fullRateDistance) { _fullRateDistance = fullRateDistance; }
-    float getFullRateDistance() const { return _fullRateDistance; }
+    /// adds a frame's worth of bytes to send other avatar data with, returns the bytes that can be spent this frame
+    float addAvatarDataByteCredit(float bytesPerFrame);
+    void spendAvatarDataByteCredit(int numBytes) { _avatarDataByteCredit -= numBytes; }
+
+    void setMaxOtherAvatarStaleness(int numFrames) { _maxOtherAvatarStaleness = numFrames; }
+    int getMaxOtherAvatarStaleness() const { return _maxOtherAvatarStaleness; }
+
+    /// reads the camera sent in an AvatarQuery packet, until the first one arrives hasViewFrustum is false
+    void readViewFrustumPacket(ReceivedMessage& message);
+    bool hasViewFrustum() const { return _hasViewFrustum; }
+    const ViewFrustum& getViewFrustum() const { return _viewFrustum; }
 
     void setMaxAvatarDistance(float maxAvatarDistance) { _maxAvatarDistance = maxAvatarDistance; }
     float getMaxAvatarDistance() const { return _maxAvatarDistance; }
@@ -69,10 +103,6 @@ public:
 
     void incrementNumOutOfOrderSends() { ++_numOutOfOrderSends; }
 
-    int getNumFramesSinceFRDAdjustment() const { return _numFramesSinceAdjustment; }
-    void incrementNumFramesSinceFRDAdjustment() { ++_numFramesSinceAdjustment; }
-    void resetNumFramesSinceFRDAdjustment() { _numFramesSinceAdjustment = 0; }
-
     void recordSentAvatarData(int numBytes) { _avgOtherAvatarDataRate.updateAverage((float) numBytes); }
 
     float getOutboundAvatarDataKbps() const
@@ -80,24 +110,37 @@ public:
 
     void loadJSONStats(QJsonObject& jsonObject) const;
 private:
+    struct EncodedAvatarData {
+        QByteArray data;
+        uint16_t sequenceNumber { 0 };
+        quint64 frame { 0 };
+        bool isValid { false };
+    };
+
     AvatarSharedPointer _avatar { new AvatarData() };
+    EncodedAvatarData _encodedAvatarData[NumAvatarDataDetails];
 
     uint16_t _lastReceivedSequenceNumber { 0 };
     std::unordered_map<QUuid, uint16_t> _lastBroadcastSequenceNumbers;
-    std::unordered_set<QUuid> _hasReceivedFirstPacketsFrom;
+    std::unordered_map<QUuid, quint64> _lastOtherAvatarSentFrames;
+    std::unordered_map<QUuid, quint64> _lastIdentitySentTimestamps;
+    std::unordered_map<QUuid, quint64> _lastBillboardSentTimestamps;
 
     quint64 _billboardChangeTimestamp = 0;
     quint64 _identityChangeTimestamp = 0;
 
-    float _fullRateDistance = FLT_MAX;
+    ViewFrustum _viewFrustum;
+    bool _hasViewFrustum = false;
+
+    float _avatarDataByteCredit = 0.0f;
     float _maxAvatarDistance = FLT_MAX;
+    int _maxOtherAvatarStaleness = 0;
 
     int _numAvatarsSentLastFrame = 0;
-    int _numFramesSinceAdjustment = 0;
 
     SimpleMovingAverage _otherAvatarStarves;
     SimpleMovingAverage _otherAvatarSkips;
-    int _numOutOfOrderSends = 0;
+    std::atomic<int> _numOutOfOrderSends { 0 }; // counted by the broadcast workers of every node this one is sent to
 
     SimpleMovingAverage _avgOtherAvatarDataRate;
 };
@@ -0,0 +1,89 @@
+//
+//  AuthoritativeEntitySimulation.cpp
+//  assignment-client/src/entities
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AuthoritativeEntitySimulation.h"
+
+#include <EntityTreeElement.h>
+#include <GLMHelpers.h>
+#include <PhysicsHelpers.h>
+#include <SimulationOwner.h>
+
+AuthoritativeEntitySimulation::AuthoritativeEntitySimulation() :
+    _engine(new PhysicsEngine(Vectors::ZERO))
+{
+}
+
+void AuthoritativeEntitySimulation::init(EntityTreePointer tree) {
+    ObjectMotionState::setShapeManager(&_shapeManager);
+    _engine->init();
+
+    // results are written into the tree directly, so there is nobody to send edits to
+    PhysicalEntitySimulation::init(tree, _engine, nullptr);
+}
+
+void AuthoritativeEntitySimulation::setSessionUUID(const QUuid& sessionID) {
+    QMutexLocker lock(&_mutex);
+    Physics::setSessionUUID(sessionID);
+    _engine->setSessionUUID(sessionID);
+}
+
+void AuthoritativeEntitySimulation::updateEntitiesInternal(const quint64& now) {
+    // EntityTree::update() holds the write lock on the tree for the whole step, which covers
+    // everything Application does under its separate read and write locks
+    getObjectsToRemoveFromPhysics(_motionStates);
+    _engine->removeObjects(_motionStates);
+    deleteObjectsRemovedFromPhysics();
+
+    getObjectsToAddToPhysics(_motionStates);
+    _engine->addObjects(_motionStates);
+
+    getObjectsToChange(_motionStates);
+    VectorOfMotionStates stillNeedChange = _engine->changeObjects(_motionStates);
+    setObjectsToChange(stillNeedChange);
+
+    applyActionChanges();
+    _engine->forEachAction([&](EntityActionPointer action) {
+        action->prepareForPhysicsSimulation();
+    });
+
+    _engine->stepSimulation();
+
+    if (_engine->hasOutgoingChanges()) {
+        harvestResults(_engine->getOutgoingChanges(), now);
+        _engine->dumpStatsIfNecessary();
+    }
+}
+
+void AuthoritativeEntitySimulation::harvestResults(const VectorOfMotionStates& motionStates, const quint64& now) {
+    const QUuid& sessionID = Physics::getSessionUUID();
+    for (auto state : motionStates) {
+        if (!state || state->getType() != MOTIONSTATE_TYPE_ENTITY) {
+            continue;
+        }
+        EntityItemPointer entity = static_cast<EntityMotionState*>(state)->getEntity();
+        if (!entity) {
+            continue;
+        }
+
+        // anything physics moves is ours, which stops observers from bidding for it
+        if (entity->getSimulatorID() != sessionID || entity->getSimulationPriority() < AUTHORITATIVE_SIMULATION_PRIORITY) {
+            entity->setSimulationOwner(sessionID, AUTHORITATIVE_SIMULATION_PRIORITY);
+        }
+
+        // stamp the new transform as an edit so viewers take it over their own extrapolation
+        entity->setLastEdited(now);
+        entity->invalidateEncodingCache();
+        EntityTreeElementPointer element = entity->getElement();
+        if (element) {
+            element->markWithChangedTime();
+        }
+        _entitiesToSort.insert(entity);
+    }
+}
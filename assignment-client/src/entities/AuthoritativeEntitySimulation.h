@@ -0,0 +1,38 @@
+//
+//  AuthoritativeEntitySimulation.h
+//  assignment-client/src/entities
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AuthoritativeEntitySimulation_h
+#define hifi_AuthoritativeEntitySimulation_h
+
+#include <PhysicalEntitySimulation.h>
+#include <ShapeManager.h>
+
+/// Steps a PhysicsEngine inside the entity-server. The server owns every entity that physics moves at
+/// AUTHORITATIVE priority and writes the results straight into the tree, where they go out to viewers like
+/// any other change instead of arriving as edits from competing clients.
+class AuthoritativeEntitySimulation : public PhysicalEntitySimulation {
+public:
+    AuthoritativeEntitySimulation();
+
+    void init(EntityTreePointer tree);
+    void setSessionUUID(const QUuid& sessionID);
+
+protected:
+    virtual void updateEntitiesInternal(const quint64& now) override;
+
+private:
+    void harvestResults(const VectorOfMotionStates& motionStates, const quint64& now);
+
+    ShapeManager _shapeManager;
+    PhysicsEnginePointer _engine;
+    VectorOfMotionStates _motionStates;
+};
+
+#endif // hifi_AuthoritativeEntitySimulation_h
@@ -17,6 +17,7 @@
 #include "EntityServerConsts.h"
 #include "EntityNodeData.h"
 #include "AssignmentParentFinder.h"
+#include "AuthoritativeEntitySimulation.h"
 
 const char* MODEL_SERVER_NAME = "Entity";
 const char* MODEL_SERVER_LOGGING_TARGET_NAME = "entity-server";
@@ -116,7 +117,8 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
 
         quint64 deletePacketSentAt = usecTimestampNow();
         EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
-        auto recentlyDeleted = tree->getRecentlyDeletedEntityIDs();
+        // only the entities deleted since we last sent to this node, with a little history to be safe
+        auto recentlyDeleted = tree->getEntitiesDeletedSince(considerEntitiesSince);
 
         packetsSent = 0;
 
@@ -140,76 +142,59 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
         qint64 numberOfIDsPos = deletesPacket->pos();
         deletesPacket->writePrimitive(numberOfIDs);
 
-        // we keep a multi map of entity IDs to timestamps, we only want to include the entity IDs that have been
-        // deleted since we last sent to this node
-        auto it = recentlyDeleted.constBegin();
-        while (it != recentlyDeleted.constEnd()) {
+        for (const auto& entityID : recentlyDeleted) {
 
-            // if the timestamp is more recent then out last sent time, include it
-            if (it.key() > considerEntitiesSince) {
+            // check to make sure we have room for one more ID, if we don't have more
+            // room, then send out this packet and create another one
+            if (NUM_BYTES_RFC4122_UUID > deletesPacket->bytesAvailableForWrite()) {
 
-                // get all the IDs for this timestamp
-                const auto& entityIDsFromTime = recentlyDeleted.values(it.key());
+                // replace the count for the number of included IDs
+                deletesPacket->seek(numberOfIDsPos);
+                deletesPacket->writePrimitive(numberOfIDs);
 
-                for (const auto& entityID : entityIDsFromTime) {
+                // Send the current packet
+                queryNode->packetSent(*deletesPacket);
+                auto thisPacketSize = deletesPacket->getDataSize();
+                totalBytes += thisPacketSize;
+                packetsSent++;
+                DependencyManager::get<NodeList>()->sendPacket(std::move(deletesPacket), *node);
 
-                    // check to make sure we have room for one more ID, if we don't have more
-                    // room, then send out this packet and create another one
-                    if (NUM_BYTES_RFC4122_UUID > deletesPacket->bytesAvailableForWrite()) {
+                #ifdef EXTRA_ERASE_DEBUGGING
+                    qDebug() << "EntityServer::sendSpecialPackets() sending packet packetsSent[" << packetsSent << "] size:" << thisPacketSize;
+                #endif
 
-                        // replace the count for the number of included IDs
-                        deletesPacket->seek(numberOfIDsPos);
-                        deletesPacket->writePrimitive(numberOfIDs);
 
-                        // Send the current packet
-                        queryNode->packetSent(*deletesPacket);
-                        auto thisPacketSize = deletesPacket->getDataSize();
-                        totalBytes += thisPacketSize;
-                        packetsSent++;
-                        DependencyManager::get<NodeList>()->sendPacket(std::move(deletesPacket), *node);
+                // create another packet
+                deletesPacket = NLPacket::create(PacketType::EntityErase);
 
-                        #ifdef EXTRA_ERASE_DEBUGGING
-                            qDebug() << "EntityServer::sendSpecialPackets() sending packet packetsSent[" << packetsSent << "] size:" << thisPacketSize;
-                        #endif
+                // pack in flags
+                deletesPacket->writePrimitive(flags);
 
+                // pack in sequence number
+                sequenceNumber = queryNode->getSequenceNumber();
+                deletesPacket->writePrimitive(sequenceNumber);
 
-                        // create another packet
-                        deletesPacket = NLPacket::create(PacketType::EntityErase);
-
-                        // pack in flags
-                        deletesPacket->writePrimitive(flags);
-
-                        // pack in sequence number
-                        sequenceNumber = queryNode->getSequenceNumber();
-                        deletesPacket->writePrimitive(sequenceNumber);
-
-                        // pack in timestamp
-                        deletesPacket->writePrimitive(now);
-
-                        // figure out where we are now and pack a temporary number of IDs
-                        numberOfIDs = 0;
-                        numberOfIDsPos = deletesPacket->pos();
-                        deletesPacket->writePrimitive(numberOfIDs);
-                    }
-
-                    // FIXME - we still seem to see cases where incorrect EntityIDs get sent from the server
-                    // to the client. These were causing "lost" entities like flashlights and laser pointers
-                    // now that we keep around some additional history of the erased entities and resend that
-                    // history for a longer time window, these entities are not "lost". But we haven't yet
-                    // found/fixed the underlying issue that caused bad UUIDs to be sent to some users.
-                    deletesPacket->write(entityID.toRfc4122());
-                    ++numberOfIDs;
-
-                    #ifdef EXTRA_ERASE_DEBUGGING
-                        qDebug() << "EntityTree::encodeEntitiesDeletedSince() including:" << entityID;
-                    #endif
-                } // end for (ids)
-
-            } // end if (it.val > sinceLast)
+                // pack in timestamp
+                deletesPacket->writePrimitive(now);
 
+                // figure out where we are now and pack a temporary number of IDs
+                numberOfIDs = 0;
+                numberOfIDsPos = deletesPacket->pos();
+                deletesPacket->writePrimitive(numberOfIDs);
+            }
 
-            ++it;
-        } // end while
+            // FIXME - we still seem to see cases where incorrect EntityIDs get sent from the server
+            // to the client. These were causing "lost" entities like flashlights and laser pointers
+            // now that we keep around some additional history of the erased entities and resend that
+            // history for a longer time window, these entities are not "lost". But we haven't yet
+            // found/fixed the underlying issue that caused bad UUIDs to be sent to some users.
+            deletesPacket->write(entityID.toRfc4122());
+            ++numberOfIDs;
+
+            #ifdef EXTRA_ERASE_DEBUGGING
+                qDebug() << "EntityTree::encodeEntitiesDeletedSince() including:" << entityID;
+            #endif
+        }
 
         // replace the count for the number of included IDs
         deletesPacket->seek(numberOfIDsPos);
@@ -267,9 +252,30 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
     readOptionBool(QString("wantTerseEditLogging"), settingsSectionObject, wantTerseEditLogging);
     qDebug("wantTerseEditLogging=%s", debug::valueOf(wantTerseEditLogging));
 
+    bool wantServerPhysics = false;
+    readOptionBool(QString("wantServerPhysics"), settingsSectionObject, wantServerPhysics);
+    qDebug("wantServerPhysics=%s", debug::valueOf(wantServerPhysics));
+
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     tree->setWantEditLogging(wantEditLogging);
     tree->setWantTerseEditLogging(wantTerseEditLogging);
+
+    if (wantServerPhysics && !_physicsSimulation) {
+        // the tree is still empty here, the persist thread loads it later
+        _physicsSimulation = new AuthoritativeEntitySimulation();
+        _physicsSimulation->init(tree);
+
+        auto nodeList = DependencyManager::get<NodeList>();
+        _physicsSimulation->setSessionUUID(nodeList->getSessionUUID());
+        connect(nodeList.data(), &NodeList::uuidChanged, this, [this](const QUuid& sessionUUID) {
+            _physicsSimulation->setSessionUUID(sessionUUID);
+        });
+
+        tree->setSimulation(_physicsSimulation);
+        tree->setServerSimulatesPhysics(true);
+        delete _entitySimulation;
+        _entitySimulation = _physicsSimulation;
+    }
 }
 
 
@@ -20,6 +20,8 @@
 #include "EntityServerConsts.h"
 #include "EntityTree.h"
 
+class AuthoritativeEntitySimulation;
+
 /// Handles assignments of type EntityServer - sending entities to various clients.
 
 struct ViewerSendingStats {
@@ -66,6 +68,7 @@ private slots:
 
 private:
     EntitySimulation* _entitySimulation;
+    AuthoritativeEntitySimulation* _physicsSimulation { nullptr };
     QTimer* _pruneDeletedEntitiesTimer = nullptr;
 
     QReadWriteLock _viewerSendingStatsLock;
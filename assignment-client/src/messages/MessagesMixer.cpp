@@ -30,8 +30,13 @@ MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(mess
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    for (auto channel = _channelSubscribers.begin(); channel != _channelSubscribers.end();) {
+        channel->remove(killedNode->getUUID());
+        if (channel->isEmpty()) {
+            channel = _channelSubscribers.erase(channel);
+        } else {
+            ++channel;
+        }
     }
 }
 
@@ -40,17 +45,23 @@ void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessa
     QUuid senderID;
     MessagesClient::decodeMessagesPacket(receivedMessage, channel, message, senderID);
 
-    auto nodeList = DependencyManager::get<NodeList>();
+    auto subscribers = _channelSubscribers.constFind(channel);
+    if (subscribers == _channelSubscribers.cend()) {
+        return;
+    }
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getType() == NodeType::Agent && node->getActiveSocket() &&
-                _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = MessagesClient::encodeMessagesPacket(channel, message, senderID);
-        nodeList->sendPacketList(std::move(packetList), *node);
-    });
+    // The message goes to the subscribers as it came, the packets sent only differ by the connection they go on
+    QByteArray payload = receivedMessage->getMessage();
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    for (const auto& subscriberID : *subscribers) {
+        auto node = nodeList->nodeWithUUID(subscriberID);
+        if (node && node->getType() == NodeType::Agent && node->getActiveSocket()) {
+            auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+            packetList->write(payload);
+            nodeList->sendPacketList(std::move(packetList), *node);
+        }
+    }
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -60,8 +71,12 @@ void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> mess
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
+    auto subscribers = _channelSubscribers.find(channel);
+    if (subscribers != _channelSubscribers.end()) {
+        subscribers->remove(senderNode->getUUID());
+        if (subscribers->isEmpty()) {
+            _channelSubscribers.erase(subscribers);
+        }
     }
 }
 
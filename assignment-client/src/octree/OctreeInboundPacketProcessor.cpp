@@ -22,6 +22,9 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+// a burst of edits is applied this many at a time, so it doesn't hold the tree's write lock for too long a stretch
+const int MAX_BATCHED_EDITS = 1000;
+
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
     _receivedPacketCount(0),
@@ -67,6 +70,10 @@ void OctreeInboundPacketProcessor::preProcess() {
 }
 
 void OctreeInboundPacketProcessor::midProcess() {
+    if (_editBatch && _editBatch->getNumEdits() >= MAX_BATCHED_EDITS) {
+        processEditBatch();
+    }
+
     // check if it's time to send a nack. If yes, do so
     quint64 now = usecTimestampNow();
     if (now - _lastNackTime >= TOO_LONG_SINCE_LAST_NACK) {
@@ -75,6 +82,28 @@ void OctreeInboundPacketProcessor::midProcess() {
     }
 }
 
+void OctreeInboundPacketProcessor::postProcess() {
+    // everything that came in together is applied under one write lock
+    processEditBatch();
+}
+
+void OctreeInboundPacketProcessor::processEditBatch() {
+    if (!_editBatch || _editBatch->getNumEdits() == 0) {
+        return;
+    }
+
+    quint64 startProcess, startLock = usecTimestampNow();
+    _myServer->getOctree()->withWriteLock([&] {
+        startProcess = usecTimestampNow();
+        _myServer->getOctree()->processEditBatch(*_editBatch);
+    });
+    quint64 endProcess = usecTimestampNow();
+
+    // the batch mixes the edits of all the senders, so this only goes to the totals
+    _totalProcessTime += endProcess - startProcess;
+    _totalLockWaitTime += startProcess - startLock;
+}
+
 void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     if (_shuttingDown) {
         qDebug() << "OctreeInboundPacketProcessor::processPacket() while shutting down... ignoring incoming packet";
@@ -141,6 +170,12 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
         }
         
         const unsigned char* editData = nullptr;
+
+        // trees that can decode their edits without the lock get them batched
+        if (!_hasCheckedEditBatching) {
+            _editBatch = _myServer->getOctree()->createEditBatch();
+            _hasCheckedEditBatching = true;
+        }
         
         while (message->getBytesLeftToRead() > 0) {
 
@@ -159,11 +194,17 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
 
             quint64 startProcess, startLock = usecTimestampNow();
             int editDataBytesRead;
-            _myServer->getOctree()->withWriteLock([&] {
-                startProcess = usecTimestampNow();
-                editDataBytesRead =
-                    _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
-            });
+            if (_editBatch) {
+                startProcess = startLock;
+                editDataBytesRead = _myServer->getOctree()->decodeEditPacketData(*message, editData, maxSize,
+                                                                                  sendingNode, *_editBatch);
+            } else {
+                _myServer->getOctree()->withWriteLock([&] {
+                    startProcess = usecTimestampNow();
+                    editDataBytesRead =
+                        _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
+                });
+            }
             quint64 endProcess = usecTimestampNow();
 
             if (debugProcessPacket) {
@@ -14,6 +14,7 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <Octree.h>
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
@@ -83,9 +84,11 @@ protected:
     virtual unsigned long getMaxWait() const;
     virtual void preProcess();
     virtual void midProcess();
+    virtual void postProcess();
 
 private:
     int sendNackPackets();
+    void processEditBatch();
 
 private:
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
@@ -105,5 +108,8 @@ private:
 
     std::atomic<uint64_t> _lastNackTime;
     bool _shuttingDown;
+
+    bool _hasCheckedEditBatching { false };
+    OctreeEditBatchPointer _editBatch; // the edits decoded since the last time the batch was applied
 };
 #endif // hifi_OctreeInboundPacketProcessor_h
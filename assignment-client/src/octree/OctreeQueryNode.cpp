@@ -11,14 +11,26 @@
 
 #include "OctreeQueryNode.h"
 
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 
 #include <udt/PacketHeaders.h>
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <UUID.h>
 
 #include "OctreeSendThread.h"
+#include "OctreeServerConsts.h"
+
+// up close a changing item goes to the viewer every send interval, further away its interval grows with the distance
+const float FULL_SEND_RATE_DISTANCE = 10.0f; // meters
+const quint64 MAX_COALESCED_SEND_INTERVAL_USECS = USECS_PER_SECOND / 2;
+
+static quint64 sendIntervalForDistance(float distance) {
+    float intervalScale = std::max(1.0f, distance / FULL_SEND_RATE_DISTANCE);
+    return std::min((quint64)(intervalScale * OCTREE_SEND_INTERVAL_USECS), MAX_COALESCED_SEND_INTERVAL_USECS);
+}
 
 void OctreeQueryNode::nodeKilled() {
     _isShuttingDown = true;
@@ -109,6 +121,12 @@ void OctreeQueryNode::resetOctreePacket() {
     setAtBit(flags, PACKET_IS_COLOR_BIT); // always color
     setAtBit(flags, PACKET_IS_COMPRESSED_BIT); // always compressed
 
+    // the sections of the packet are compressed with the shared dictionary if the client can read them
+    _octreePacketIsDictionaryCompressed = getWantsCompressionDictionary();
+    if (_octreePacketIsDictionaryCompressed) {
+        setAtBit(flags, PACKET_IS_DICTIONARY_COMPRESSED_BIT);
+    }
+
     _octreePacket->reset();
 
     // pack in flags
@@ -230,6 +248,55 @@ void OctreeQueryNode::updateLastKnownViewFrustum() {
     setLastTimeBagEmpty();
 }
 
+void OctreeQueryNode::setLastTimeBagEmpty() {
+    _lastTimeBagEmpty = _sceneSendStartTime;
+
+    // hold the next scene's change threshold back far enough that it looks at the deferred items again
+    _hasDeferredSends = (_earliestDeferredChange != 0);
+    if (_hasDeferredSends) {
+        _lastTimeBagEmpty = std::min(_lastTimeBagEmpty, _earliestDeferredChange);
+        _earliestDeferredChange = 0;
+    }
+
+    // items that changed before the threshold aren't looked at again until they change, and once they're also past the
+    // longest send interval there's nothing left to hold them back with
+    quint64 now = usecTimestampNow();
+    auto itr = _sentData.begin();
+    while (itr != _sentData.end()) {
+        if (itr->lastChanged < _lastTimeBagEmpty && now - itr->sentAt > MAX_COALESCED_SEND_INTERVAL_USECS) {
+            itr = _sentData.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
+
+bool OctreeQueryNode::shouldSendData(const QUuid& dataID, quint64 dataLastChanged, float distance, bool isFullScene) {
+    quint64 now = usecTimestampNow();
+    auto itr = _sentData.find(dataID);
+    if (itr == _sentData.end()) {
+        _sentData.insert(dataID, { dataLastChanged, now });
+        return true;
+    }
+
+    if (!isFullScene) {
+        if (dataLastChanged <= itr->lastChanged) {
+            return false; // the viewer has the latest already
+        }
+        if (now - itr->sentAt < sendIntervalForDistance(distance)) {
+            // sent too recently, it goes in a later scene with whatever it has become by then
+            if (_earliestDeferredChange == 0 || dataLastChanged < _earliestDeferredChange) {
+                _earliestDeferredChange = dataLastChanged;
+            }
+            return false;
+        }
+    }
+
+    itr->lastChanged = dataLastChanged;
+    itr->sentAt = now;
+    return true;
+}
+
 
 bool OctreeQueryNode::moveShouldDump() const {
     // if shutting down, return immediately
@@ -274,6 +341,20 @@ void OctreeQueryNode::dumpOutOfView() {
     }
 }
 
+void OctreeQueryNode::initialSceneSent(quint64 sceneTime, quint64 changeSequence) {
+    _isWaitingForInitialScene = false;
+
+    // it went with a sequence number of its own, but reliably, so there's nothing to keep for the nacks
+    _sequenceNumber++;
+
+    // as if a scene of the current view had just been sent, the viewer has that and everything else
+    _lastKnownViewFrustum = _currentViewFrustum;
+    _sceneSendStartTime = sceneTime;
+    _sceneChangeSequence = changeSequence;
+    setLastTimeBagEmpty();
+    setViewSent(true);
+}
+
 void OctreeQueryNode::packetSent(const NLPacket& packet) {
     _sentPacketHistory.packetSent(_sequenceNumber, packet);
     _sequenceNumber++;
@@ -22,6 +22,8 @@
 #include <OctreeSceneStats.h>
 #include "SentPacketHistory.h"
 #include <qqueue.h>
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
 
 class OctreeSendThread;
 class OctreeServer;
@@ -41,6 +43,7 @@ public:
 
     NLPacket& getPacket() const { return *_octreePacket; }
     bool isPacketWaiting() const { return _octreePacketWaiting; }
+    bool isPacketDictionaryCompressed() const { return _octreePacketIsDictionaryCompressed; }
 
     bool packetIsDuplicate() const;
     bool shouldSuppressDuplicatePacket();
@@ -73,10 +76,31 @@ public:
     bool moveShouldDump() const;
 
     quint64 getLastTimeBagEmpty() const { return _lastTimeBagEmpty; }
-    void setLastTimeBagEmpty() { _lastTimeBagEmpty = _sceneSendStartTime; }
+    void setLastTimeBagEmpty();
+
+    /// Latest value wins: an item that changes many times between sends only goes to this viewer at its latest, and no
+    /// more often than the send interval for its distance. Returns false for an item the viewer already has or that will
+    /// go in a later scene, and records the send otherwise. Full scenes send everything in view.
+    bool shouldSendData(const QUuid& dataID, quint64 dataLastChanged, float distance, bool isFullScene);
+
+    /// true while items held back by shouldSendData() are waiting for a later scene
+    bool hasDeferredSends() const { return _hasDeferredSends; }
+
+    /// the element change sequence when the last scene was started, everything changed before then has been sent
+    quint64 getSceneChangeSequence() const { return _sceneChangeSequence; }
+    void setSceneChangeSequence(quint64 changeSequence) { _sceneChangeSequence = changeSequence; }
 
     bool hasLodChanged() const { return _lodChanged; }
 
+    /// whether the viewer is still to get the whole scene at once, ahead of the regular scenes
+    bool isWaitingForInitialScene() const { return _isWaitingForInitialScene; }
+
+    /// the whole scene as of sceneTime went to the viewer, the regular scenes carry on with what changed since
+    void initialSceneSent(quint64 sceneTime, quint64 changeSequence);
+
+    /// the viewer gets the scene from the regular scenes instead
+    void skipInitialScene() { _isWaitingForInitialScene = false; }
+
     OctreeSceneStats stats;
 
     void dumpOutOfView();
@@ -107,6 +131,7 @@ private:
     bool _viewSent { false };
     std::unique_ptr<NLPacket> _octreePacket;
     bool _octreePacketWaiting;
+    bool _octreePacketIsDictionaryCompressed { false };
 
     unsigned int _lastOctreePacketLength { 0 };
     int _duplicatePacketCount { 0 };
@@ -117,6 +142,7 @@ private:
     ViewFrustum _currentViewFrustum;
     ViewFrustum _lastKnownViewFrustum;
     quint64 _lastTimeBagEmpty { 0 };
+    quint64 _sceneChangeSequence { 0 };
     bool _viewFrustumChanging { false };
     bool _viewFrustumJustStoppedChanging { true };
 
@@ -139,6 +165,16 @@ private:
     QQueue<OCTREE_PACKET_SEQUENCE> _nackedSequenceNumbers;
 
     quint64 _sceneSendStartTime = 0;
+
+    struct SentData {
+        quint64 lastChanged;
+        quint64 sentAt;
+    };
+    QHash<QUuid, SentData> _sentData;
+    quint64 _earliestDeferredChange { 0 }; // of the items deferred in the current scene, 0 when there are none
+    bool _hasDeferredSends { false };
+
+    bool _isWaitingForInitialScene { true };
     
     std::array<char, udt::MAX_PACKET_SIZE> _lastOctreePayload;
 };
@@ -0,0 +1,169 @@
+//
+//  OctreeSendStats.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeSendStats.h"
+
+#include <algorithm>
+
+const float OctreeSendStats::SKIP_TIME = -1.0f;
+
+QMutex OctreeSendStats::_allStatsMutex;
+std::vector<OctreeSendStats*> OctreeSendStats::_allStats;
+OctreeSendStats::Totals OctreeSendStats::_finishedTotals;
+OctreeSendStats::Totals OctreeSendStats::_resetTotals;
+
+quint64 OctreeSendStats::Totals::getCount(Time time) const {
+    quint64 count = 0;
+    for (int length = 0; length < NUM_LENGTHS; length++) {
+        count += counts[time][length];
+    }
+    return count;
+}
+
+float OctreeSendStats::Totals::getAverage(Time time) const {
+    quint64 count = 0;
+    double sum = 0.0;
+    for (int length = 0; length < NUM_LENGTHS; length++) {
+        count += counts[time][length];
+        sum += sums[time][length];
+    }
+    return count > 0 ? (float)(sum / count) : 0.0f;
+}
+
+float OctreeSendStats::Totals::getAverage(Time time, Length length) const {
+    return counts[time][length] > 0 ? (float)(sums[time][length] / counts[time][length]) : 0.0f;
+}
+
+OctreeSendStats::Totals& OctreeSendStats::Totals::operator+=(const Totals& other) {
+    for (int time = 0; time < NUM_TIMES; time++) {
+        for (int length = 0; length < NUM_LENGTHS; length++) {
+            counts[time][length] += other.counts[time][length];
+            sums[time][length] += other.sums[time][length];
+        }
+    }
+    return *this;
+}
+
+OctreeSendStats::Totals& OctreeSendStats::Totals::operator-=(const Totals& other) {
+    for (int time = 0; time < NUM_TIMES; time++) {
+        for (int length = 0; length < NUM_LENGTHS; length++) {
+            counts[time][length] -= other.counts[time][length];
+            sums[time][length] -= other.sums[time][length];
+        }
+    }
+    return *this;
+}
+
+OctreeSendStats::OctreeSendStats() {
+    for (int time = 0; time < NUM_TIMES; time++) {
+        for (int length = 0; length < NUM_LENGTHS; length++) {
+            _counts[time][length].store(0, std::memory_order_relaxed);
+            _sums[time][length].store(0.0, std::memory_order_relaxed);
+        }
+    }
+
+    QMutexLocker locker(&_allStatsMutex);
+    _allStats.push_back(this);
+}
+
+OctreeSendStats::~OctreeSendStats() {
+    QMutexLocker locker(&_allStatsMutex);
+    _allStats.erase(std::remove(_allStats.begin(), _allStats.end(), this), _allStats.end());
+
+    // what this send thread counted stays in the totals
+    addTo(_finishedTotals);
+}
+
+void OctreeSendStats::track(Time time, float value) {
+    const float MAX_SHORT_TIME = 10.0f;
+    const float MAX_LONG_TIME = 100.0f;
+
+    Length length;
+    if (value == SKIP_TIME) {
+        length = NO_TIME;
+        value = 0.0f;
+    } else if (value <= MAX_SHORT_TIME) {
+        length = SHORT_TIME;
+    } else if (value <= MAX_LONG_TIME) {
+        length = LONG_TIME;
+    } else {
+        length = EXTRA_LONG_TIME;
+    }
+
+    // this thread is the only one writing these, the readers only need to see whole values
+    auto& count = _counts[time][length];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    auto& sum = _sums[time][length];
+    sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void OctreeSendStats::addTo(Totals& totals) const {
+    for (int time = 0; time < NUM_TIMES; time++) {
+        for (int length = 0; length < NUM_LENGTHS; length++) {
+            totals.counts[time][length] += _counts[time][length].load(std::memory_order_relaxed);
+            totals.sums[time][length] += _sums[time][length].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+OctreeSendStats::Totals OctreeSendStats::getTotals() {
+    QMutexLocker locker(&_allStatsMutex);
+    Totals totals = _finishedTotals;
+    for (auto stats : _allStats) {
+        stats->addTo(totals);
+    }
+    totals -= _resetTotals;
+    return totals;
+}
+
+void OctreeSendStats::reset() {
+    Totals totals = getTotals();
+
+    QMutexLocker locker(&_allStatsMutex);
+    _resetTotals += totals;
+}
+
+QString OctreeSendStats::getTimeName(Time time) {
+    switch (time) {
+        case LOOP_TIME:
+            return "loop";
+        case INSIDE_TIME:
+            return "inside";
+        case TREE_WAIT_TIME:
+            return "tree_wait";
+        case ENCODE_TIME:
+            return "encode";
+        case COMPRESS_AND_WRITE_TIME:
+            return "compress_and_write";
+        case PACKET_SENDING_TIME:
+            return "packet_sending";
+        case NODE_WAIT_TIME:
+            return "node_wait";
+        case PROCESS_WAIT_TIME:
+            return "process_wait";
+        default:
+            return QString();
+    }
+}
+
+QString OctreeSendStats::getLengthName(Length length) {
+    switch (length) {
+        case NO_TIME:
+            return "none";
+        case SHORT_TIME:
+            return "short";
+        case LONG_TIME:
+            return "long";
+        case EXTRA_LONG_TIME:
+            return "extra_long";
+        default:
+            return QString();
+    }
+}
@@ -0,0 +1,90 @@
+//
+//  OctreeSendStats.h
+//  assignment-client/src/octree
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  The times the octree send threads take, counted by each client's send thread and summed when they are read
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendStats_h
+#define hifi_OctreeSendStats_h
+
+#include <atomic>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+/// Counts the times the sends to a client take: how many of each were tracked and their sum, split between the
+/// skipped ones and the short, long and extra long ones.  Only the send thread of the client writes its counters, so
+/// the send threads don't contend for them, and the counters of all of the send threads are only summed when the
+/// stats page asks for them.
+class OctreeSendStats {
+public:
+    enum Time {
+        LOOP_TIME = 0, // msecs, the others are usecs
+        INSIDE_TIME,
+        TREE_WAIT_TIME,
+        ENCODE_TIME,
+        COMPRESS_AND_WRITE_TIME,
+        PACKET_SENDING_TIME,
+        NODE_WAIT_TIME,
+        PROCESS_WAIT_TIME,
+        NUM_TIMES
+    };
+
+    enum Length {
+        NO_TIME = 0, // tracked as SKIP_TIME
+        SHORT_TIME,
+        LONG_TIME,
+        EXTRA_LONG_TIME,
+        NUM_LENGTHS
+    };
+
+    static const float SKIP_TIME; // use this for track() calls for non-times
+
+    /// the counters of all the send threads added up
+    class Totals {
+    public:
+        quint64 getCount(Time time) const;
+        quint64 getCount(Time time, Length length) const { return counts[time][length]; }
+        float getAverage(Time time) const;
+        float getAverage(Time time, Length length) const;
+
+        Totals& operator+=(const Totals& other);
+        Totals& operator-=(const Totals& other);
+
+        quint64 counts[NUM_TIMES][NUM_LENGTHS] {};
+        double sums[NUM_TIMES][NUM_LENGTHS] {};
+    };
+
+    OctreeSendStats();
+    ~OctreeSendStats();
+
+    /// only to be called from the thread sending to the client
+    void track(Time time, float value);
+
+    /// the times of all of the send threads since the last reset
+    static Totals getTotals();
+    static void reset();
+
+    static QString getTimeName(Time time);
+    static QString getLengthName(Length length);
+
+private:
+    void addTo(Totals& totals) const;
+
+    std::atomic<quint64> _counts[NUM_TIMES][NUM_LENGTHS];
+    std::atomic<double> _sums[NUM_TIMES][NUM_LENGTHS];
+
+    static QMutex _allStatsMutex;
+    static std::vector<OctreeSendStats*> _allStats;
+    static Totals _finishedTotals; // of the send threads that are gone
+    static Totals _resetTotals; // all of the totals when they were last reset
+};
+
+#endif // hifi_OctreeSendStats_h
@@ -70,8 +70,6 @@ bool OctreeSendThread::process() {
 
     OctreeServer::didProcess(this);
 
-    quint64  start = usecTimestampNow();
-
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
 
@@ -87,30 +85,13 @@ bool OctreeSendThread::process() {
                 packetDistributor(node, nodeData, viewFrustumChanged);
             }
         } else {
+            setIsShuttingDown();
             return false; // exit early if we're shutting down
         }
     }
 
-    if (_isShuttingDown) {
-        return false; // exit early if we're shutting down
-    }
-
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
-
-        if (usecToSleep > 0) {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            usleep(usecToSleep);
-        } else {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usleep(MIN_USEC_TO_SLEEP);
-        }
-    }
-
-    return isStillRunning();  // keep running till they terminate us
+    // the send worker pool brings us back around when our next interval is due
+    return !_isShuttingDown;
 }
 
 AtomicUIntStat OctreeSendThread::_usleepTime { 0 };
@@ -293,6 +274,49 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
     return packetsSent;
 }
 
+int OctreeSendThread::sendInitialScene(SharedNodePointer node, OctreeQueryNode* nodeData) {
+    OctreeSceneSnapshotPointer snapshot;
+    if (_myServer->wantsBulkInitialLoad()) {
+        snapshot = _myServer->getSceneSnapshot();
+    }
+
+    if (!snapshot) {
+        nodeData->skipInitialScene();
+        return 0;
+    }
+
+    // one octree packet header and then the sections of the snapshot, the client reads the message like any other
+    auto packetList = NLPacketList::create(nodeData->getMyPacketType(), QByteArray(), true, true);
+
+    OCTREE_PACKET_FLAGS flags = 0;
+    setAtBit(flags, PACKET_IS_COLOR_BIT);
+    setAtBit(flags, PACKET_IS_COMPRESSED_BIT);
+    packetList->writePrimitive(flags);
+    packetList->writePrimitive(nodeData->getSequenceNumber());
+    OCTREE_PACKET_SENT_TIME now = usecTimestampNow();
+    packetList->writePrimitive(now);
+    packetList->write(snapshot->sections);
+
+    int packetsSent = (int)packetList->getNumPackets();
+    int bytesSent = (int)packetList->getDataSize();
+
+    OctreeServer::didCallWriteDatagram(this);
+    DependencyManager::get<NodeList>()->sendPacketList(std::move(packetList), *node);
+
+    _totalBytes += bytesSent;
+    _totalPackets += packetsSent;
+
+    nodeData->initialSceneSent(snapshot->sceneTime, snapshot->changeSequence);
+    nodeData->resetOctreePacket(); // because nodeData's _sequenceNumber has changed
+
+    if (_myServer->wantsDebugSending()) {
+        qDebug() << "Sent the initial scene to" << node->getUUID() << "in" << packetsSent << "packets," << bytesSent
+                 << "bytes";
+    }
+
+    return packetsSent;
+}
+
 /// Version of octree element distributor that sends the deepest LOD level at once
 int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged) {
 
@@ -303,6 +327,12 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         return 0;
     }
 
+    // a client that just joined gets all of the scene in one reliable message, as fast as its connection takes it
+    // instead of an interval's worth of packets at a time, and the scenes after only send what changed since
+    if (nodeData->isWaitingForInitialScene()) {
+        return sendInitialScene(node, nodeData);
+    }
+
     // calculate max number of packets that can be sent during this interval
     int clientMaxPacketsPerInterval = std::max(1, (nodeData->getMaxQueryPacketsPerSecond() / INTERVALS_PER_SECOND));
     int maxPacketsPerInterval = std::min(clientMaxPacketsPerInterval, _myServer->getPacketsPerClientPerInterval());
@@ -334,6 +364,15 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
 
     const ViewFrustum* lastViewFrustum = viewFrustumChanged ? &nodeData->getLastKnownViewFrustum() : NULL;
 
+    // When the client has the whole scene for a view that hasn't changed, the next scene only sends what changed
+    // since. If no element has been marked as changed since the last scene started there's nothing, and no reason
+    // to walk the tree to find that out.
+    // Items held back to coalesce their updates still need a scene to go out in, though.
+    quint64 changeSequence = OctreeElement::getChangeSequence();
+    bool nothingChanged = !viewFrustumChanged && !isFullScene && nodeData->getViewSent()
+                          && nodeData->elementBag.isEmpty() && changeSequence == nodeData->getSceneChangeSequence()
+                          && !nodeData->hasDeferredSends();
+
     // If the current view frustum has changed OR we have nothing to send, then search against
     // the current view frustum for things to send.
     if (viewFrustumChanged || nodeData->elementBag.isEmpty()) {
@@ -367,19 +406,29 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         // TODO: add these to stats page
         //::startSceneSleepTime = _usleepTime;
 
-        nodeData->sceneStart(usecTimestampNow() - CHANGE_FUDGE);
-        // start tracking our stats
-        nodeData->stats.sceneStarted(isFullScene, viewFrustumChanged,
-                                     _myServer->getOctree()->getRoot(), _myServer->getJurisdiction());
-
-        // This is the start of "resending" the scene.
-        bool dontRestartSceneOnMove = false; // this is experimental
-        if (dontRestartSceneOnMove) {
-            if (nodeData->elementBag.isEmpty()) {
+        // the stats of the last scene have gone out with the packet above, there's no new scene to start
+        if (!nothingChanged) {
+            nodeData->sceneStart(usecTimestampNow() - CHANGE_FUDGE);
+            nodeData->setSceneChangeSequence(changeSequence);
+            // start tracking our stats
+            nodeData->stats.sceneStarted(isFullScene, viewFrustumChanged,
+                                         _myServer->getOctree()->getRoot(), _myServer->getJurisdiction());
+
+            // send what covers the most of the client's screen first, with the LOD the scene is encoded at
+            int sceneBoundaryLevelAdjust = nodeData->getBoundaryLevelAdjust() +
+                                           (viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
+            nodeData->elementBag.setView(nodeData->getCurrentViewFrustum(), nodeData->getOctreeSizeScale(),
+                                         sceneBoundaryLevelAdjust);
+
+            // This is the start of "resending" the scene.
+            bool dontRestartSceneOnMove = false; // this is experimental
+            if (dontRestartSceneOnMove) {
+                if (nodeData->elementBag.isEmpty()) {
+                    nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
+                }
+            } else {
                 nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
             }
-        } else {
-            nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
         }
     }
 
@@ -396,10 +445,10 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         bool completedScene = false;
 
         while (somethingToSend && packetsSentThisInterval < maxPacketsPerInterval && !nodeData->isShuttingDown()) {
-            float lockWaitElapsedUsec = OctreeServer::SKIP_TIME;
-            float encodeElapsedUsec = OctreeServer::SKIP_TIME;
-            float compressAndWriteElapsedUsec = OctreeServer::SKIP_TIME;
-            float packetSendingElapsedUsec = OctreeServer::SKIP_TIME;
+            float lockWaitElapsedUsec = OctreeSendStats::SKIP_TIME;
+            float encodeElapsedUsec = OctreeSendStats::SKIP_TIME;
+            float compressAndWriteElapsedUsec = OctreeSendStats::SKIP_TIME;
+            float packetSendingElapsedUsec = OctreeSendStats::SKIP_TIME;
 
             quint64 startInside = usecTimestampNow();
 
@@ -429,6 +478,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                                                  nodeData->getLastTimeBagEmpty(),
                                                  isFullScene, &nodeData->stats, _myServer->getJurisdiction(),
                                                  &nodeData->extraEncodeData);
+                    params.allowLossyEncoding = true;
 
                     // Our trackSend() function is implemented by the server subclass, and will be called back
                     // during the encodeTreeBitstream() as new entities/data elements are sent 
@@ -436,6 +486,12 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                         _myServer->trackSend(dataID, dataEdited, node->getUUID());
                     };
 
+                    // each changing item goes to this viewer at its latest, at a rate that falls off with its distance
+                    params.shouldSendData = [nodeData, isFullScene](const QUuid& dataID, quint64 dataLastChanged,
+                                                                    float distance) {
+                        return nodeData->shouldSendData(dataID, dataLastChanged, distance, isFullScene);
+                    };
+
                     // TODO: should this include the lock time or not? This stat is sent down to the client,
                     // it seems like it may be a good idea to include the lock time as part of the encode time
                     // are reported to client. Since you can encode without the lock
@@ -479,10 +535,14 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                     // if for some reason the finalized size is greater than our available size, then probably the "compressed"
                     // form actually inflated beyond our padding, and in this case we will send the current packet, then
                     // write to out new packet...
+                    _packetData.setUseCompressionDictionary(nodeData->isPacketDictionaryCompressed());
                     unsigned int writtenSize = _packetData.getFinalizedSize() + sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
 
                     if (writtenSize > nodeData->getAvailable()) {
                         packetsSentThisInterval += handlePacketSend(node, nodeData, trueBytesSent, truePacketsSent);
+
+                        // the section has to be in the form the new packet says it is in
+                        _packetData.setUseCompressionDictionary(nodeData->isPacketDictionaryCompressed());
                     }
 
                     nodeData->writeToPacket(_packetData.getFinalizedData(), _packetData.getFinalizedSize());
@@ -520,14 +580,14 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                 _packetData.changeSettings(true, targetSize); // will do reset - NOTE: Always compressed
 
             }
-            OctreeServer::trackTreeWaitTime(lockWaitElapsedUsec);
-            OctreeServer::trackEncodeTime(encodeElapsedUsec);
-            OctreeServer::trackCompressAndWriteTime(compressAndWriteElapsedUsec);
-            OctreeServer::trackPacketSendingTime(packetSendingElapsedUsec);
+            _sendStats.track(OctreeSendStats::TREE_WAIT_TIME, lockWaitElapsedUsec);
+            _sendStats.track(OctreeSendStats::ENCODE_TIME, encodeElapsedUsec);
+            _sendStats.track(OctreeSendStats::COMPRESS_AND_WRITE_TIME, compressAndWriteElapsedUsec);
+            _sendStats.track(OctreeSendStats::PACKET_SENDING_TIME, packetSendingElapsedUsec);
 
             quint64 endInside = usecTimestampNow();
             quint64 elapsedInsideUsecs = endInside - startInside;
-            OctreeServer::trackInsideTime((float)elapsedInsideUsecs);
+            _sendStats.track(OctreeSendStats::INSIDE_TIME, (float)elapsedInsideUsecs);
         }
 
         if (somethingToSend && _myServer->wantsVerboseDebug()) {
@@ -536,40 +596,9 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                             << "  clientMaxPacketsPerInterval = " << clientMaxPacketsPerInterval;
         }
 
-        // Here's where we can/should allow the server to send other data...
-        // send the environment packet
-        // TODO: should we turn this into a while loop to better handle sending multiple special packets
-        if (_myServer->hasSpecialPacketsToSend(node) && !nodeData->isShuttingDown()) {
-            int specialPacketsSent = 0;
-            trueBytesSent += _myServer->sendSpecialPackets(node, nodeData, specialPacketsSent);
-            nodeData->resetOctreePacket();   // because nodeData's _sequenceNumber has changed
-            truePacketsSent += specialPacketsSent;
-            packetsSentThisInterval += specialPacketsSent;
-
-            _totalPackets += specialPacketsSent;
-            _totalBytes += trueBytesSent;
-
-            _totalSpecialPackets += specialPacketsSent;
-            _totalSpecialBytes += trueBytesSent;
-        }
-
-        // Re-send packets that were nacked by the client
-        while (nodeData->hasNextNackedPacket() && packetsSentThisInterval < maxPacketsPerInterval) {
-            const NLPacket* packet = nodeData->getNextNackedPacket();
-            if (packet) {
-                DependencyManager::get<NodeList>()->sendUnreliablePacket(*packet, *node);
-                truePacketsSent++;
-                packetsSentThisInterval++;
-
-                _totalBytes += packet->getDataSize();
-                _totalPackets++;
-                _totalWastedBytes += udt::MAX_PACKET_SIZE - packet->getDataSize();
-            }
-        }
-
         quint64 end = usecTimestampNow();
         int elapsedmsec = (end - start) / USECS_PER_MSEC;
-        OctreeServer::trackLoopTime(elapsedmsec);
+        _sendStats.track(OctreeSendStats::LOOP_TIME, (float)elapsedmsec);
 
         // TODO: add these to stats page
         //quint64 endCompressCalls = OctreePacketData::getCompressContentCalls();
@@ -586,5 +615,36 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
 
     } // end if bag wasn't empty, and so we sent stuff...
 
+    // Here's where we can/should allow the server to send other data...
+    // send the environment packet
+    // TODO: should we turn this into a while loop to better handle sending multiple special packets
+    if (_myServer->hasSpecialPacketsToSend(node) && !nodeData->isShuttingDown()) {
+        int specialPacketsSent = 0;
+        trueBytesSent += _myServer->sendSpecialPackets(node, nodeData, specialPacketsSent);
+        nodeData->resetOctreePacket();   // because nodeData's _sequenceNumber has changed
+        truePacketsSent += specialPacketsSent;
+        packetsSentThisInterval += specialPacketsSent;
+
+        _totalPackets += specialPacketsSent;
+        _totalBytes += trueBytesSent;
+
+        _totalSpecialPackets += specialPacketsSent;
+        _totalSpecialBytes += trueBytesSent;
+    }
+
+    // Re-send packets that were nacked by the client
+    while (nodeData->hasNextNackedPacket() && packetsSentThisInterval < maxPacketsPerInterval) {
+        const NLPacket* packet = nodeData->getNextNackedPacket();
+        if (packet) {
+            DependencyManager::get<NodeList>()->sendUnreliablePacket(*packet, *node);
+            truePacketsSent++;
+            packetsSentThisInterval++;
+
+            _totalBytes += packet->getDataSize();
+            _totalPackets++;
+            _totalWastedBytes += udt::MAX_PACKET_SIZE - packet->getDataSize();
+        }
+    }
+
     return truePacketsSent;
 }
@@ -5,7 +5,7 @@
 //  Created by Brad Hefta-Gaub on 8/21/13.
 //  Copyright 2013 High Fidelity, Inc.
 //
-//  Threaded or non-threaded object for sending octree data packets to a client
+//  Object for sending octree data packets to a client, run by the server's OctreeSendWorkerPool
 //
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
@@ -16,15 +16,20 @@
 
 #include <atomic>
 
-#include <GenericThread.h>
+#include <QtCore/QObject>
+
+#include <OctreePacketData.h>
+#include <Node.h>
+
+#include "OctreeSendStats.h"
 
 class OctreeQueryNode;
 class OctreeServer;
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
-/// Threaded processor for sending octree packets to a single client
-class OctreeSendThread : public GenericThread {
+/// Sends octree packets to a single client, one interval's worth each time the send worker pool processes it
+class OctreeSendThread : public QObject {
     Q_OBJECT
 public:
     OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node);
@@ -45,13 +50,13 @@ public:
     static AtomicUIntStat _usleepTime;
     static AtomicUIntStat _usleepCalls;
 
-protected:
-    /// Implements generic processing behavior for this thread.
-    virtual bool process();
+    /// sends this interval's packets, returns false once the client is gone and this should be deleted
+    bool process();
 
 private:
     int handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, int& trueBytesSent, int& truePacketsSent);
     int packetDistributor(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged);
+    int sendInitialScene(SharedNodePointer node, OctreeQueryNode* nodeData);
     
     
     OctreeServer* _myServer { nullptr };
@@ -59,9 +64,10 @@ private:
     QUuid _nodeUuid;
 
     OctreePacketData _packetData;
+    OctreeSendStats _sendStats;
 
     int _nodeMissingCount { 0 };
-    bool _isShuttingDown { false };
+    std::atomic<bool> _isShuttingDown { false };
 };
 
 #endif // hifi_OctreeSendThread_h
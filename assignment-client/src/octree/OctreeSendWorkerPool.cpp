@@ -0,0 +1,122 @@
+//
+//  OctreeSendWorkerPool.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeSendWorkerPool.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+
+#include <SharedUtil.h>
+
+#include "OctreeSendThread.h"
+#include "OctreeServerConsts.h"
+
+OctreeSendWorkerPool::OctreeSendWorkerPool(const QString& name, int numWorkers) {
+    numWorkers = std::max(numWorkers, 1);
+
+    for (int i = 0; i < numWorkers; i++) {
+        std::unique_ptr<Worker> worker { new Worker(this) };
+        worker->setObjectName(QString("%1 Send Worker %2").arg(name).arg(i));
+        worker->start();
+        _workers.push_back(std::move(worker));
+    }
+
+    qDebug() << qPrintable(name) << "server sending with" << numWorkers << "worker threads";
+}
+
+OctreeSendWorkerPool::~OctreeSendWorkerPool() {
+    stop();
+}
+
+void OctreeSendWorkerPool::addJob(OctreeSendThread* job) {
+    QMutexLocker locker(&_mutex);
+
+    _schedule.push_back({ usecTimestampNow(), job });
+    std::push_heap(_schedule.begin(), _schedule.end());
+
+    _scheduleChanged.wakeOne();
+}
+
+void OctreeSendWorkerPool::removeJob(OctreeSendThread* job) {
+    QMutexLocker locker(&_mutex);
+
+    // a worker that has it puts it back in the schedule when it is done, so wait for that before taking it out
+    while (_runningJobs.find(job) != _runningJobs.end()) {
+        _jobDone.wait(&_mutex);
+    }
+
+    auto it = std::find_if(_schedule.begin(), _schedule.end(), [job](const ScheduledJob& scheduled) {
+        return scheduled.job == job;
+    });
+
+    if (it != _schedule.end()) {
+        _schedule.erase(it);
+        std::make_heap(_schedule.begin(), _schedule.end());
+    }
+}
+
+void OctreeSendWorkerPool::stop() {
+    {
+        QMutexLocker locker(&_mutex);
+        _isStopped = true;
+        _scheduleChanged.wakeAll();
+    }
+
+    for (auto& worker : _workers) {
+        worker->wait();
+    }
+    _workers.clear();
+}
+
+void OctreeSendWorkerPool::processJobs() {
+    QMutexLocker locker(&_mutex);
+
+    while (!_isStopped) {
+        if (_schedule.empty()) {
+            _scheduleChanged.wait(&_mutex);
+            continue;
+        }
+
+        quint64 now = usecTimestampNow();
+        quint64 deadline = _schedule.front().deadline;
+
+        if (deadline > now) {
+            // sleep until the next job is due, or until an earlier one is added
+            const quint64 USECS_PER_MSEC = 1000;
+            _scheduleChanged.wait(&_mutex, (unsigned long)((deadline - now + USECS_PER_MSEC - 1) / USECS_PER_MSEC));
+            continue;
+        }
+
+        std::pop_heap(_schedule.begin(), _schedule.end());
+        OctreeSendThread* job = _schedule.back().job;
+        _schedule.pop_back();
+        _runningJobs.insert(job);
+
+        locker.unlock();
+        bool keepRunning = job->process();
+        locker.relock();
+
+        _runningJobs.erase(job);
+
+        if (keepRunning) {
+            // it is due again one interval after this turn started, however long the turn took
+            _schedule.push_back({ now + OCTREE_SEND_INTERVAL_USECS, job });
+            std::push_heap(_schedule.begin(), _schedule.end());
+        }
+
+        _jobDone.wakeAll();
+
+        if (!keepRunning) {
+            // the server deletes the job in response, on its own thread
+            emit jobFinished(job);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+//
+//  OctreeSendWorkerPool.h
+//  assignment-client/src/octree
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  A fixed number of threads that take turns sending octree packets to all of the clients
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendWorkerPool_h
+#define hifi_OctreeSendWorkerPool_h
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+class OctreeSendThread;
+
+/// Runs the OctreeSendThread of every client on a fixed number of worker threads.
+/// Each client is due once every OCTREE_SEND_INTERVAL_USECS, and the workers always pick up the client whose
+/// turn is the oldest, so a slow client delays the others by at most one interval instead of starving them.
+/// A client is only ever processed by one worker at a time.
+class OctreeSendWorkerPool : public QObject {
+    Q_OBJECT
+public:
+    OctreeSendWorkerPool(const QString& name, int numWorkers);
+    virtual ~OctreeSendWorkerPool();
+
+    int getNumWorkers() const { return (int)_workers.size(); }
+
+    /// schedules a client for sending, right away
+    void addJob(OctreeSendThread* job);
+
+    /// unschedules a client, waiting for a worker that is processing it to finish, after this it can be deleted
+    void removeJob(OctreeSendThread* job);
+
+    /// finishes the jobs being processed and stops the workers, the jobs that are left aren't processed again
+    void stop();
+
+signals:
+    /// the job's process() returned false, it has been unscheduled
+    void jobFinished(OctreeSendThread* job);
+
+private:
+    class Worker : public QThread {
+    public:
+        Worker(OctreeSendWorkerPool* pool) : _pool(pool) {}
+
+    protected:
+        virtual void run() override { _pool->processJobs(); }
+
+    private:
+        OctreeSendWorkerPool* _pool;
+    };
+
+    struct ScheduledJob {
+        quint64 deadline;
+        OctreeSendThread* job;
+
+        // for a min-heap on the deadline
+        bool operator<(const ScheduledJob& other) const { return deadline > other.deadline; }
+    };
+
+    void processJobs();
+
+    QMutex _mutex;
+    QWaitCondition _scheduleChanged;
+    QWaitCondition _jobDone;
+    std::vector<ScheduledJob> _schedule; // heap, the next job due is at the front
+    std::unordered_set<OctreeSendThread*> _runningJobs;
+    bool _isStopped { false };
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+};
+
+#endif // hifi_OctreeSendWorkerPool_h
@@ -11,9 +11,12 @@
 
 #include "OctreeServer.h"
 
+#include <QJsonArray>
 #include <QJsonObject>
+#include <QTextStream>
 #include <QTimer>
 
+#include <algorithm>
 #include <time.h>
 
 #include <AccountManager.h>
@@ -32,186 +35,6 @@
 #include <QtCore/QDir>
 
 int OctreeServer::_clientCount = 0;
-const int MOVING_AVERAGE_SAMPLE_COUNTS = 1000000;
-
-float OctreeServer::SKIP_TIME = -1.0f; // use this for trackXXXTime() calls for non-times
-
-SimpleMovingAverage OctreeServer::_averageLoopTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageInsideTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-
-SimpleMovingAverage OctreeServer::_averageEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageShortEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageLongEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageExtraLongEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongEncode = 0;
-int OctreeServer::_longEncode = 0;
-int OctreeServer::_shortEncode = 0;
-int OctreeServer::_noEncode = 0;
-
-SimpleMovingAverage OctreeServer::_averageTreeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeShortWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeExtraLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongTreeWait = 0;
-int OctreeServer::_longTreeWait = 0;
-int OctreeServer::_shortTreeWait = 0;
-int OctreeServer::_noTreeWait = 0;
-
-SimpleMovingAverage OctreeServer::_averageNodeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-
-SimpleMovingAverage OctreeServer::_averageCompressAndWriteTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageShortCompressTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageLongCompressTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageExtraLongCompressTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongCompress = 0;
-int OctreeServer::_longCompress = 0;
-int OctreeServer::_shortCompress = 0;
-int OctreeServer::_noCompress = 0;
-
-SimpleMovingAverage OctreeServer::_averagePacketSendingTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_noSend = 0;
-
-SimpleMovingAverage OctreeServer::_averageProcessWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageProcessShortWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageProcessLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageProcessExtraLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongProcessWait = 0;
-int OctreeServer::_longProcessWait = 0;
-int OctreeServer::_shortProcessWait = 0;
-int OctreeServer::_noProcessWait = 0;
-
-
-void OctreeServer::resetSendingStats() {
-    _averageLoopTime.reset();
-
-    _averageEncodeTime.reset();
-    _averageShortEncodeTime.reset();
-    _averageLongEncodeTime.reset();
-    _averageExtraLongEncodeTime.reset();
-    _extraLongEncode = 0;
-    _longEncode = 0;
-    _shortEncode = 0;
-    _noEncode = 0;
-
-    _averageInsideTime.reset();
-    _averageTreeWaitTime.reset();
-    _averageTreeShortWaitTime.reset();
-    _averageTreeLongWaitTime.reset();
-    _averageTreeExtraLongWaitTime.reset();
-    _extraLongTreeWait = 0;
-    _longTreeWait = 0;
-    _shortTreeWait = 0;
-    _noTreeWait = 0;
-
-    _averageNodeWaitTime.reset();
-
-    _averageCompressAndWriteTime.reset();
-    _averageShortCompressTime.reset();
-    _averageLongCompressTime.reset();
-    _averageExtraLongCompressTime.reset();
-    _extraLongCompress = 0;
-    _longCompress = 0;
-    _shortCompress = 0;
-    _noCompress = 0;
-
-    _averagePacketSendingTime.reset();
-    _noSend = 0;
-
-    _averageProcessWaitTime.reset();
-    _averageProcessShortWaitTime.reset();
-    _averageProcessLongWaitTime.reset();
-    _averageProcessExtraLongWaitTime.reset();
-    _extraLongProcessWait = 0;
-    _longProcessWait = 0;
-    _shortProcessWait = 0;
-    _noProcessWait = 0;
-}
-
-void OctreeServer::trackEncodeTime(float time) {
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-
-    if (time == SKIP_TIME) {
-        _noEncode++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortEncode++;
-        _averageShortEncodeTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longEncode++;
-        _averageLongEncodeTime.updateAverage(time);
-    } else {
-        _extraLongEncode++;
-        _averageExtraLongEncodeTime.updateAverage(time);
-    }
-    _averageEncodeTime.updateAverage(time);
-}
-
-void OctreeServer::trackTreeWaitTime(float time) {
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-    if (time == SKIP_TIME) {
-        _noTreeWait++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortTreeWait++;
-        _averageTreeShortWaitTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longTreeWait++;
-        _averageTreeLongWaitTime.updateAverage(time);
-    } else {
-        _extraLongTreeWait++;
-        _averageTreeExtraLongWaitTime.updateAverage(time);
-    }
-    _averageTreeWaitTime.updateAverage(time);
-}
-
-void OctreeServer::trackCompressAndWriteTime(float time) {
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-    if (time == SKIP_TIME) {
-        _noCompress++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortCompress++;
-        _averageShortCompressTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longCompress++;
-        _averageLongCompressTime.updateAverage(time);
-    } else {
-        _extraLongCompress++;
-        _averageExtraLongCompressTime.updateAverage(time);
-    }
-    _averageCompressAndWriteTime.updateAverage(time);
-}
-
-void OctreeServer::trackPacketSendingTime(float time) {
-    if (time == SKIP_TIME) {
-        _noSend++;
-        time = 0.0f;
-    }
-    _averagePacketSendingTime.updateAverage(time);
-}
-
-
-void OctreeServer::trackProcessWaitTime(float time) {
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-    if (time == SKIP_TIME) {
-        _noProcessWait++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortProcessWait++;
-        _averageProcessShortWaitTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longProcessWait++;
-        _averageProcessLongWaitTime.updateAverage(time);
-    } else {
-        _extraLongProcessWait++;
-        _averageProcessExtraLongWaitTime.updateAverage(time);
-    }
-    _averageProcessWaitTime.updateAverage(time);
-}
 
 OctreeServer::OctreeServer(ReceivedMessage& message) :
     ThreadedAssignment(message),
@@ -231,10 +54,10 @@ OctreeServer::OctreeServer(ReceivedMessage& message) :
     _jurisdictionSender(NULL),
     _octreeInboundPacketProcessor(NULL),
     _persistThread(NULL),
+    _numSendWorkers(1),
     _started(time(0)),
     _startedUSecs(usecTimestampNow())
 {
-    _averageLoopTime.updateAverage(0);
     qDebug() << "Octree server starting... [" << this << "]";
 
     // make sure the AccountManager has an Auth URL for payment redemptions
@@ -315,10 +138,13 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
     if (connection->requestOperation() == QNetworkAccessManager::GetOperation) {
         if (url.path() == "/") {
             showStats = true;
+        } else if (url.path() == "/metrics") {
+            connection->respond(HTTPConnection::StatusCode200, getMetrics(), "text/plain; version=0.0.4");
+            return true;
         } else if (url.path() == "/resetStats") {
             _octreeInboundPacketProcessor->resetStats();
             _tree->resetEditStats();
-            resetSendingStats();
+            OctreeSendStats::reset();
             showStats = true;
         } else if ((url.path() == persistFile) || (url.path() == persistFile + "/")) {
             if (_persistFileDownload) {
@@ -444,151 +270,93 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("      writeDatagram() last second: %1 clients\r\n\r\n")
             .arg(locale.toString((uint)howManyThreadsDidCallWriteDatagram(oneSecondAgo)).rightJustified(COLUMN_WIDTH, ' '));
 
-        float averageLoopTime = getAverageLoopTime();
+        // added up from the send threads once for the whole page
+        const OctreeSendStats::Totals sendTotals = OctreeSendStats::getTotals();
+
+        float averageLoopTime = sendTotals.getAverage(OctreeSendStats::LOOP_TIME);
         statsString += QString().sprintf("           Average packetLoop() time:      %7.2f msecs"
-                                         "                 samples: %12d \r\n",
-                                         (double)averageLoopTime, _averageLoopTime.getSampleCount());
+                                         "                 samples: %12llu \r\n",
+                                         (double)averageLoopTime, sendTotals.getCount(OctreeSendStats::LOOP_TIME));
 
-        float averageInsideTime = getAverageInsideTime();
+        float averageInsideTime = sendTotals.getAverage(OctreeSendStats::INSIDE_TIME);
         statsString += QString().sprintf("               Average 'inside' time:    %9.2f usecs"
-                                         "                 samples: %12d \r\n\r\n",
-                                         (double)averageInsideTime, _averageInsideTime.getSampleCount());
-
+                                         "                 samples: %12llu \r\n\r\n",
+                                         (double)averageInsideTime, sendTotals.getCount(OctreeSendStats::INSIDE_TIME));
+
+        // the lines for a time tracked by its length, below the line of its average
+        auto addTimeLengthStats = [&](OctreeSendStats::Time time, const char* noTimeLabel, const char* shortLabel,
+                                      const char* longLabel, const char* extraLongLabel) {
+            quint64 allTimes = sendTotals.getCount(time);
+
+            quint64 noTimes = sendTotals.getCount(time, OctreeSendStats::NO_TIME);
+            float zeroVsTotal = (allTimes > 0) ? ((float)noTimes / (float)allTimes) : 0.0f;
+            statsString += QString().sprintf("%s                          (%6.2f%%) samples: %12llu \r\n",
+                                             noTimeLabel, (double)(zeroVsTotal * AS_PERCENT), noTimes);
+
+            const char* labels[] = { shortLabel, longLabel, extraLongLabel };
+            for (int length = OctreeSendStats::SHORT_TIME; length <= OctreeSendStats::EXTRA_LONG_TIME; length++) {
+                quint64 lengthTimes = sendTotals.getCount(time, (OctreeSendStats::Length)length);
+                float lengthVsTotal = (allTimes > 0) ? ((float)lengthTimes / (float)allTimes) : 0.0f;
+                statsString += QString().sprintf("%s          %9.2f usecs (%6.2f%%) samples: %12llu \r\n",
+                                                 labels[length - OctreeSendStats::SHORT_TIME],
+                                                 (double)sendTotals.getAverage(time, (OctreeSendStats::Length)length),
+                                                 (double)(lengthVsTotal * AS_PERCENT), lengthTimes);
+            }
+            statsString += "\r\n";
+        };
 
         // Process Wait
-        {
-            int allWaitTimes = _extraLongProcessWait +_longProcessWait + _shortProcessWait + _noProcessWait;
-
-            float averageProcessWaitTime = getAverageProcessWaitTime();
-            statsString += QString().sprintf("      Average process lock wait time:"
-                                             "    %9.2f usecs                 samples: %12d \r\n",
-                                             (double)averageProcessWaitTime, allWaitTimes);
-
-            float zeroVsTotal = (allWaitTimes > 0) ? ((float)_noProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("                        No Lock Wait:"
-                                             "                          (%6.2f%%) samples: %12d \r\n",
-                                             (double)(zeroVsTotal * AS_PERCENT), _noProcessWait);
-
-            float shortVsTotal = (allWaitTimes > 0) ? ((float)_shortProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("    Avg process lock short wait time:"
-                                             "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                             (double)_averageProcessShortWaitTime.getAverage(),
-                                             (double)(shortVsTotal * AS_PERCENT), _shortProcessWait);
-
-            float longVsTotal = (allWaitTimes > 0) ? ((float)_longProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("     Avg process lock long wait time:"
-                                             "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                             (double)_averageProcessLongWaitTime.getAverage(),
-                                             (double)(longVsTotal * AS_PERCENT), _longProcessWait);
-
-            float extraLongVsTotal = (allWaitTimes > 0) ? ((float)_extraLongProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("Avg process lock extralong wait time:"
-                                             "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                             (double)_averageProcessExtraLongWaitTime.getAverage(),
-                                             (double)(extraLongVsTotal * AS_PERCENT), _extraLongProcessWait);
-        }
+        statsString += QString().sprintf("      Average process lock wait time:"
+                                         "    %9.2f usecs                 samples: %12llu \r\n",
+                                         (double)sendTotals.getAverage(OctreeSendStats::PROCESS_WAIT_TIME),
+                                         sendTotals.getCount(OctreeSendStats::PROCESS_WAIT_TIME));
+        addTimeLengthStats(OctreeSendStats::PROCESS_WAIT_TIME,
+                           "                        No Lock Wait:",
+                           "    Avg process lock short wait time:",
+                           "     Avg process lock long wait time:",
+                           "Avg process lock extralong wait time:");
 
         // Tree Wait
-        int allWaitTimes = _extraLongTreeWait +_longTreeWait + _shortTreeWait + _noTreeWait;
-
-        float averageTreeWaitTime = getAverageTreeWaitTime();
+        float averageTreeWaitTime = sendTotals.getAverage(OctreeSendStats::TREE_WAIT_TIME);
         statsString += QString().sprintf("         Average tree lock wait time:"
-                                         "    %9.2f usecs                 samples: %12d \r\n",
-                                         (double)averageTreeWaitTime, allWaitTimes);
-
-        float zeroVsTotal = (allWaitTimes > 0) ? ((float)_noTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("                        No Lock Wait:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         (double)(zeroVsTotal * AS_PERCENT), _noTreeWait);
-
-        float shortVsTotal = (allWaitTimes > 0) ? ((float)_shortTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("       Avg tree lock short wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         (double)_averageTreeShortWaitTime.getAverage(),
-                                         (double)(shortVsTotal * AS_PERCENT), _shortTreeWait);
-
-        float longVsTotal = (allWaitTimes > 0) ? ((float)_longTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("        Avg tree lock long wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         (double)_averageTreeLongWaitTime.getAverage(),
-                                         (double)(longVsTotal * AS_PERCENT), _longTreeWait);
-
-        float extraLongVsTotal = (allWaitTimes > 0) ? ((float)_extraLongTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("  Avg tree lock extra long wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         (double)_averageTreeExtraLongWaitTime.getAverage(),
-                                         (double)(extraLongVsTotal * AS_PERCENT), _extraLongTreeWait);
+                                         "    %9.2f usecs                 samples: %12llu \r\n",
+                                         (double)averageTreeWaitTime, sendTotals.getCount(OctreeSendStats::TREE_WAIT_TIME));
+        addTimeLengthStats(OctreeSendStats::TREE_WAIT_TIME,
+                           "                        No Lock Wait:",
+                           "       Avg tree lock short wait time:",
+                           "        Avg tree lock long wait time:",
+                           "  Avg tree lock extra long wait time:");
 
         // encode
-        float averageEncodeTime = getAverageEncodeTime();
+        float averageEncodeTime = sendTotals.getAverage(OctreeSendStats::ENCODE_TIME);
         statsString += QString().sprintf("                 Average encode time:    %9.2f usecs\r\n", (double)averageEncodeTime);
+        addTimeLengthStats(OctreeSendStats::ENCODE_TIME,
+                           "                           No Encode:",
+                           "               Avg short encode time:",
+                           "                Avg long encode time:",
+                           "          Avg extra long encode time:");
 
-        int allEncodeTimes = _noEncode + _shortEncode + _longEncode + _extraLongEncode;
-
-        float zeroVsTotalEncode = (allEncodeTimes > 0) ? ((float)_noEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("                           No Encode:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         (double)(zeroVsTotalEncode * AS_PERCENT), _noEncode);
-
-        float shortVsTotalEncode = (allEncodeTimes > 0) ? ((float)_shortEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("               Avg short encode time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         (double)_averageShortEncodeTime.getAverage(),
-                                         (double)(shortVsTotalEncode * AS_PERCENT), _shortEncode);
-
-        float longVsTotalEncode = (allEncodeTimes > 0) ? ((float)_longEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("                Avg long encode time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         (double)_averageLongEncodeTime.getAverage(),
-                                         (double)(longVsTotalEncode * AS_PERCENT), _longEncode);
-
-        float extraLongVsTotalEncode = (allEncodeTimes > 0) ? ((float)_extraLongEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("          Avg extra long encode time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         (double)_averageExtraLongEncodeTime.getAverage(),
-                                         (double)(extraLongVsTotalEncode * AS_PERCENT), _extraLongEncode);
-
-
-        float averageCompressAndWriteTime = getAverageCompressAndWriteTime();
+        float averageCompressAndWriteTime = sendTotals.getAverage(OctreeSendStats::COMPRESS_AND_WRITE_TIME);
         statsString += QString().sprintf("     Average compress and write time:    %9.2f usecs\r\n",
                                          (double)averageCompressAndWriteTime);
+        addTimeLengthStats(OctreeSendStats::COMPRESS_AND_WRITE_TIME,
+                           "                      No compression:",
+                           "             Avg short compress time:",
+                           "              Avg long compress time:",
+                           "        Avg extra long compress time:");
 
-        int allCompressTimes = _noCompress + _shortCompress + _longCompress + _extraLongCompress;
-
-        float zeroVsTotalCompress = (allCompressTimes > 0) ? ((float)_noCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("                      No compression:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         (double)(zeroVsTotalCompress * AS_PERCENT), _noCompress);
-
-        float shortVsTotalCompress = (allCompressTimes > 0) ? ((float)_shortCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("             Avg short compress time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         (double)_averageShortCompressTime.getAverage(),
-                                         (double)(shortVsTotalCompress * AS_PERCENT), _shortCompress);
-
-        float longVsTotalCompress = (allCompressTimes > 0) ? ((float)_longCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("              Avg long compress time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         (double)_averageLongCompressTime.getAverage(),
-                                         (double)(longVsTotalCompress * AS_PERCENT), _longCompress);
-
-        float extraLongVsTotalCompress = (allCompressTimes > 0) ? ((float)_extraLongCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("        Avg extra long compress time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         (double)_averageExtraLongCompressTime.getAverage(),
-                                         (double)(extraLongVsTotalCompress * AS_PERCENT), _extraLongCompress);
-
-        float averagePacketSendingTime = getAveragePacketSendingTime();
+        float averagePacketSendingTime = sendTotals.getAverage(OctreeSendStats::PACKET_SENDING_TIME);
         statsString += QString().sprintf("         Average packet sending time:    %9.2f usecs (includes node lock)\r\n",
                                          (double)averagePacketSendingTime);
 
-        float noVsTotalSend = (_averagePacketSendingTime.getSampleCount() > 0) ?
-                                        ((float)_noSend / (float)_averagePacketSendingTime.getSampleCount()) : 0.0f;
+        quint64 allSends = sendTotals.getCount(OctreeSendStats::PACKET_SENDING_TIME);
+        quint64 noSends = sendTotals.getCount(OctreeSendStats::PACKET_SENDING_TIME, OctreeSendStats::NO_TIME);
+        float noVsTotalSend = (allSends > 0) ? ((float)noSends / (float)allSends) : 0.0f;
         statsString += QString().sprintf("                         Not sending:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         (double)(noVsTotalSend * AS_PERCENT), _noSend);
+                                         "                          (%6.2f%%) samples: %12llu \r\n",
+                                         (double)(noVsTotalSend * AS_PERCENT), noSends);
 
-        float averageNodeWaitTime = getAverageNodeWaitTime();
+        float averageNodeWaitTime = sendTotals.getAverage(OctreeSendStats::NODE_WAIT_TIME);
         statsString += QString().sprintf("         Average node lock wait time:    %9.2f usecs\r\n",
                                          (double)averageNodeWaitTime);
 
@@ -873,20 +641,93 @@ void OctreeServer::parsePayload() {
 
 OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePointer& node) {
     auto sendThread = std::unique_ptr<OctreeSendThread>(new OctreeSendThread(this, node));
-    
-    // we want to be notified when the thread finishes
-    connect(sendThread.get(), &GenericThread::finished, this, &OctreeServer::removeSendThread);
-    sendThread->initialize(true);
+    _sendWorkerPool->addJob(sendThread.get());
 
     return sendThread;
 }
 
-void OctreeServer::removeSendThread() {
-    // If the object has been deleted since the event was queued, sender() will return nullptr
-    if (auto sendThread = qobject_cast<OctreeSendThread*>(sender())) {
-        // This deletes the unique_ptr, so sendThread is destructed after that line
-        _sendThreads.erase(sendThread->getNodeUuid());
+void OctreeServer::eraseSendThread(SendThreads::iterator it) {
+    // make sure no worker is still sending with it before it is destructed
+    _sendWorkerPool->removeJob(it->second.get());
+    _sendThreads.erase(it);
+}
+
+void OctreeServer::removeSendThread(OctreeSendThread* sendThread) {
+    // the send thread may already have been replaced, so only go by the pointer
+    auto it = std::find_if(_sendThreads.begin(), _sendThreads.end(), [sendThread](const SendThreads::value_type& entry) {
+        return entry.second.get() == sendThread && entry.second->isShuttingDown();
+    });
+
+    if (it != _sendThreads.end()) {
+        eraseSendThread(it);
+    }
+}
+
+OctreeSceneSnapshotPointer OctreeServer::getSceneSnapshot() {
+    // the clients that join while it's being encoded wait for it instead of encoding their own
+    QMutexLocker locker(&_sceneSnapshotLock);
+
+    quint64 changeSequence = OctreeElement::getChangeSequence();
+    if (_sceneSnapshot && _sceneSnapshot->changeSequence == changeSequence) {
+        return _sceneSnapshot;
+    }
+
+    auto snapshot = std::make_shared<OctreeSceneSnapshot>();
+    snapshot->sceneTime = usecTimestampNow() - CHANGE_FUDGE;
+    snapshot->changeSequence = changeSequence;
+
+    OctreeElementBag bag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    OctreePacketData packetData(true);
+
+    // the sections are the size they are in the regular packets, and aren't compressed with the dictionary
+    // since not every client reads those
+    auto appendSection = [&] {
+        if (packetData.hasContent()) {
+            OCTREE_PACKET_INTERNAL_SECTION_SIZE sectionSize = packetData.getFinalizedSize();
+            snapshot->sections.append(reinterpret_cast<const char*>(&sectionSize), sizeof(sectionSize));
+            snapshot->sections.append(reinterpret_cast<const char*>(packetData.getFinalizedData()), sectionSize);
+        }
+        packetData.changeSettings(true);
+    };
+
+    bag.insert(_tree->getRoot());
+    while (!bag.isEmpty()) {
+        // the tree is only locked a subtree at a time, what changes in between is sent after the snapshot
+        bool lastElementDidntFit = false;
+        _tree->withReadLock([&] {
+            OctreeElementPointer subTree = bag.extract();
+            if (!subTree) {
+                return;
+            }
+
+            EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, WANT_EXISTS_BITS, DONT_CHOP);
+            params.jurisdictionMap = _jurisdiction;
+            params.extraEncodeData = &extraEncodeData;
+
+            _tree->encodeTreeBitstream(subTree, &packetData, bag, params);
+            lastElementDidntFit = (params.stopReason == EncodeBitstreamParams::DIDNT_FIT);
+        });
+
+        if (lastElementDidntFit) {
+            if (!packetData.hasContent()) {
+                // it won't fit in an empty section either, the joining clients get the regular scenes instead
+                qWarning() << qPrintable(_safeServerName) << "server could not fit an element in a scene snapshot";
+                _tree->releaseSceneEncodeData(&extraEncodeData);
+                return OctreeSceneSnapshotPointer();
+            }
+            appendSection();
+        }
     }
+    appendSection();
+
+    _tree->releaseSceneEncodeData(&extraEncodeData);
+
+    qDebug() << qPrintable(_safeServerName) << "server encoded a scene snapshot of" << snapshot->sections.size()
+             << "bytes for the joining clients";
+
+    _sceneSnapshot = snapshot;
+    return _sceneSnapshot;
 }
 
 void OctreeServer::handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -900,8 +741,8 @@ void OctreeServer::handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> messa
         if (it == _sendThreads.end()) {
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
         } else if (it->second->isShuttingDown()) {
-            _sendThreads.erase(it); // Remove right away and wait on thread to be
-            
+            eraseSendThread(it); // Remove right away and wait on its worker to be done with it
+
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
         }
     }
@@ -1039,6 +880,12 @@ void OctreeServer::readConfiguration() {
         qDebug("persistFilename=%s", _persistFilename);
 
         _persistAsFileType = "json.gz";
+        QString persistFileType;
+        if (readOptionString(QString("persistFileType"), settingsSectionObject, persistFileType)
+            && persistFileType == "ents" && _tree->supportsSnapshot()) {
+            _persistAsFileType = persistFileType;
+        }
+        qDebug() << "persistFileType=" << _persistAsFileType;
 
         _persistInterval = OctreePersistThread::DEFAULT_PERSIST_INTERVAL;
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
@@ -1087,6 +934,16 @@ void OctreeServer::readConfiguration() {
     qDebug("packetsPerSecondTotalMax=%d _packetsTotalPerInterval=%d",
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
 
+    // the number of threads sending to all of the clients
+    _numSendWorkers = QThread::idealThreadCount();
+    readOptionInt(QString("sendWorkers"), settingsSectionObject, _numSendWorkers);
+    qDebug("sendWorkers=%d", _numSendWorkers);
+
+    bool noBulkInitialLoad = false;
+    readOptionBool(QString("NoBulkInitialLoad"), settingsSectionObject, noBulkInitialLoad);
+    _wantBulkInitialLoad = !noBulkInitialLoad;
+    qDebug("wantBulkInitialLoad=%s", debug::valueOf(_wantBulkInitialLoad));
+
 
     readAdditionalConfiguration(settingsSectionObject);
 }
@@ -1123,6 +980,9 @@ void OctreeServer::domainSettingsRequestComplete() {
     packetReceiver.registerListener(PacketType::JurisdictionRequest, this, "handleJurisdictionRequestPacket");
     
     readConfiguration();
+
+    _sendWorkerPool.reset(new OctreeSendWorkerPool(_safeServerName, _numSendWorkers));
+    connect(_sendWorkerPool.get(), &OctreeSendWorkerPool::jobFinished, this, &OctreeServer::removeSendThread);
     
     beforeRun(); // after payload has been processed
     
@@ -1279,8 +1139,10 @@ void OctreeServer::aboutToFinish() {
         sendThread.setIsShuttingDown();
     }
     
-    // Clear will destruct all the unique_ptr to OctreeSendThreads which will call the GenericThread's dtor
-    // which waits on the thread to be done before returning
+    // the workers finish what they are sending, after which the send threads can be destructed
+    if (_sendWorkerPool) {
+        _sendWorkerPool->stop();
+    }
     _sendThreads.clear(); // Cleans up all the send threads.
 
     if (_persistThread) {
@@ -1291,6 +1153,44 @@ void OctreeServer::aboutToFinish() {
     qDebug() << qPrintable(_safeServerName) << "server ENDING about to finish...";
 }
 
+QByteArray OctreeServer::getMetrics() {
+    // the stats in the Prometheus text format, for a scraper rather than a person
+    QByteArray metrics;
+    QTextStream stream(&metrics);
+
+    stream << "# TYPE octree_server_clients gauge\n";
+    stream << "octree_server_clients " << getCurrentClientCount() << "\n";
+
+    stream << "# TYPE octree_server_outbound_packets_total counter\n";
+    stream << "octree_server_outbound_packets_total " << (quint64)OctreeSendThread::_totalPackets << "\n";
+    stream << "# TYPE octree_server_outbound_bytes_total counter\n";
+    stream << "octree_server_outbound_bytes_total " << (quint64)OctreeSendThread::_totalBytes << "\n";
+    stream << "# TYPE octree_server_outbound_wasted_bytes_total counter\n";
+    stream << "octree_server_outbound_wasted_bytes_total " << (quint64)OctreeSendThread::_totalWastedBytes << "\n";
+
+    // the loop time is in msecs, the other send times in usecs
+    const OctreeSendStats::Totals sendTotals = OctreeSendStats::getTotals();
+    stream << "# TYPE octree_server_send_time_sum counter\n";
+    for (int time = 0; time < OctreeSendStats::NUM_TIMES; time++) {
+        for (int length = 0; length < OctreeSendStats::NUM_LENGTHS; length++) {
+            stream << "octree_server_send_time_sum{time=\"" << OctreeSendStats::getTimeName((OctreeSendStats::Time)time)
+                << "\",length=\"" << OctreeSendStats::getLengthName((OctreeSendStats::Length)length) << "\"} "
+                << sendTotals.sums[time][length] << "\n";
+        }
+    }
+    stream << "# TYPE octree_server_send_time_count counter\n";
+    for (int time = 0; time < OctreeSendStats::NUM_TIMES; time++) {
+        for (int length = 0; length < OctreeSendStats::NUM_LENGTHS; length++) {
+            stream << "octree_server_send_time_count{time=\"" << OctreeSendStats::getTimeName((OctreeSendStats::Time)time)
+                << "\",length=\"" << OctreeSendStats::getLengthName((OctreeSendStats::Length)length) << "\"} "
+                << sendTotals.counts[time][length] << "\n";
+        }
+    }
+
+    stream.flush();
+    return metrics;
+}
+
 QString OctreeServer::getUptime() {
     QString formattedUptime;
     quint64 now  = usecTimestampNow();
@@ -1406,6 +1306,12 @@ void OctreeServer::sendStatsPacket() {
     statsArray1["4. persistFileLoadTime"] = getFileLoadTime();
     statsArray1["5. clients"] = getCurrentClientCount();
     statsArray1["6. threads"] = threadsStats;
+
+    // with the load above this lets the domain-server suggest when to split or merge jurisdictions, no jurisdiction
+    // means the whole tree
+    statsArray1["7. jurisdictionRoot"] = _jurisdiction ? _jurisdiction->getRootHexString() : QString("00");
+    statsArray1["8. jurisdictionEndNodes"] = QJsonArray::fromStringList(_jurisdiction ? _jurisdiction->getEndNodeHexStrings()
+                                                                                      : QStringList());
     
     // Octree Stats
     QJsonObject octreeStats;
@@ -1422,14 +1328,15 @@ void OctreeServer::sendStatsPacket() {
     dataObject1["5. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfBitMasks();
     dataObject1["6. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfColor();
 
+    const OctreeSendStats::Totals sendTotals = OctreeSendStats::getTotals();
     QJsonObject timingArray1;
-    timingArray1["1. avgLoopTime"] = getAverageLoopTime();
-    timingArray1["2. avgInsideTime"] = getAverageInsideTime();
-    timingArray1["3. avgTreeLockTime"] = getAverageTreeWaitTime();
-    timingArray1["4. avgEncodeTime"] = getAverageEncodeTime();
-    timingArray1["5. avgCompressAndWriteTime"] = getAverageCompressAndWriteTime();
-    timingArray1["6. avgSendTime"] = getAveragePacketSendingTime();
-    timingArray1["7. nodeWaitTime"] = getAverageNodeWaitTime();
+    timingArray1["1. avgLoopTime"] = sendTotals.getAverage(OctreeSendStats::LOOP_TIME);
+    timingArray1["2. avgInsideTime"] = sendTotals.getAverage(OctreeSendStats::INSIDE_TIME);
+    timingArray1["3. avgTreeLockTime"] = sendTotals.getAverage(OctreeSendStats::TREE_WAIT_TIME);
+    timingArray1["4. avgEncodeTime"] = sendTotals.getAverage(OctreeSendStats::ENCODE_TIME);
+    timingArray1["5. avgCompressAndWriteTime"] = sendTotals.getAverage(OctreeSendStats::COMPRESS_AND_WRITE_TIME);
+    timingArray1["6. avgSendTime"] = sendTotals.getAverage(OctreeSendStats::PACKET_SENDING_TIME);
+    timingArray1["7. nodeWaitTime"] = sendTotals.getAverage(OctreeSendStats::NODE_WAIT_TIME);
     
     QJsonObject statsObject2;
     statsObject2["data"] = dataObject1;
@@ -24,11 +24,20 @@
 
 #include "OctreePersistThread.h"
 #include "OctreeSendThread.h"
+#include "OctreeSendWorkerPool.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
 
 const int DEFAULT_PACKETS_PER_INTERVAL = 2000; // some 120,000 packets per second total
 
+/// The whole scene encoded once for the clients that are joining, see OctreeServer::getSceneSnapshot()
+struct OctreeSceneSnapshot {
+    QByteArray sections; // the compressed sections of an octree packet, each after its size
+    quint64 sceneTime { 0 }; // everything that changed before this is in the sections
+    quint64 changeSequence { 0 }; // OctreeElement::getChangeSequence() when it was encoded
+};
+using OctreeSceneSnapshotPointer = std::shared_ptr<const OctreeSceneSnapshot>;
+
 /// Handles assignments of type OctreeServer - sending octrees to various clients.
 class OctreeServer : public ThreadedAssignment, public HTTPRequestHandler {
     Q_OBJECT
@@ -53,6 +62,12 @@ public:
     int getPacketsTotalPerInterval() const { return _packetsTotalPerInterval; }
     int getPacketsTotalPerSecond() const { return getPacketsTotalPerInterval() * INTERVALS_PER_SECOND; }
 
+    /// the clients that join get the whole scene in one reliable message before the regular scenes
+    bool wantsBulkInitialLoad() const { return _wantBulkInitialLoad; }
+
+    /// the scene as it is now, shared by the clients that join until it changes, null if it couldn't be encoded
+    OctreeSceneSnapshotPointer getSceneSnapshot();
+
     static int getCurrentClientCount() { return _clientCount; }
     static void clientConnected() { _clientCount++; }
     static void clientDisconnected() { _clientCount--; }
@@ -82,32 +97,6 @@ public:
     virtual void trackSend(const QUuid& dataID, quint64 dataLastEdited, const QUuid& viewerNode) { }
     virtual void trackViewerGone(const QUuid& viewerNode) { }
 
-    static float SKIP_TIME; // use this for trackXXXTime() calls for non-times
-
-    static void trackLoopTime(float time) { _averageLoopTime.updateAverage(time); }
-    static float getAverageLoopTime() { return _averageLoopTime.getAverage(); }
-
-    static void trackEncodeTime(float time);
-    static float getAverageEncodeTime() { return _averageEncodeTime.getAverage(); }
-
-    static void trackInsideTime(float time) { _averageInsideTime.updateAverage(time); }
-    static float getAverageInsideTime() { return _averageInsideTime.getAverage(); }
-
-    static void trackTreeWaitTime(float time);
-    static float getAverageTreeWaitTime() { return _averageTreeWaitTime.getAverage(); }
-
-    static void trackNodeWaitTime(float time) { _averageNodeWaitTime.updateAverage(time); }
-    static float getAverageNodeWaitTime() { return _averageNodeWaitTime.getAverage(); }
-
-    static void trackCompressAndWriteTime(float time);
-    static float getAverageCompressAndWriteTime() { return _averageCompressAndWriteTime.getAverage(); }
-
-    static void trackPacketSendingTime(float time);
-    static float getAveragePacketSendingTime() { return _averagePacketSendingTime.getAverage(); }
-
-    static void trackProcessWaitTime(float time);
-    static float getAverageProcessWaitTime() { return _averageProcessWaitTime.getAverage(); }
-
     // these methods allow us to track which threads got to various states
     static void didProcess(OctreeSendThread* thread);
     static void didPacketDistributor(OctreeSendThread* thread);
@@ -136,7 +125,7 @@ private slots:
     void handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleOctreeDataNackPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleJurisdictionRequestPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
-    void removeSendThread();
+    void removeSendThread(OctreeSendThread* sendThread);
 
 protected:
     using UniqueSendThread = std::unique_ptr<OctreeSendThread>;
@@ -150,13 +139,14 @@ protected:
     virtual void readAdditionalConfiguration(const QJsonObject& settingsSectionObject) { };
     void parsePayload();
     void initHTTPManager(int port);
-    void resetSendingStats();
+    QByteArray getMetrics();
     QString getUptime();
     QString getFileLoadTime();
     QString getConfiguration();
     QString getStatusLink();
     
     UniqueSendThread createSendThread(const SharedNodePointer& node);
+    void eraseSendThread(SendThreads::iterator it);
 
     int _argc;
     const char** _argv;
@@ -173,6 +163,7 @@ protected:
     QString _persistAsFileType;
     int _packetsPerClientPerInterval;
     int _packetsTotalPerInterval;
+    bool _wantBulkInitialLoad { true };
     OctreePointer _tree; // this IS a reaveraging tree
     bool _wantPersist;
     bool _debugSending;
@@ -196,53 +187,13 @@ protected:
     QString _safeServerName;
     
     SendThreads _sendThreads;
+    int _numSendWorkers;
+    std::unique_ptr<OctreeSendWorkerPool> _sendWorkerPool;
 
-    static int _clientCount;
-    static SimpleMovingAverage _averageLoopTime;
-
-    static SimpleMovingAverage _averageEncodeTime;
-    static SimpleMovingAverage _averageShortEncodeTime;
-    static SimpleMovingAverage _averageLongEncodeTime;
-    static SimpleMovingAverage _averageExtraLongEncodeTime;
-    static int _extraLongEncode;
-    static int _longEncode;
-    static int _shortEncode;
-    static int _noEncode;
-
-    static SimpleMovingAverage _averageInsideTime;
-
-    static SimpleMovingAverage _averageTreeWaitTime;
-    static SimpleMovingAverage _averageTreeShortWaitTime;
-    static SimpleMovingAverage _averageTreeLongWaitTime;
-    static SimpleMovingAverage _averageTreeExtraLongWaitTime;
-    static int _extraLongTreeWait;
-    static int _longTreeWait;
-    static int _shortTreeWait;
-    static int _noTreeWait;
-
-    static SimpleMovingAverage _averageNodeWaitTime;
-
-    static SimpleMovingAverage _averageCompressAndWriteTime;
-    static SimpleMovingAverage _averageShortCompressTime;
-    static SimpleMovingAverage _averageLongCompressTime;
-    static SimpleMovingAverage _averageExtraLongCompressTime;
-    static int _extraLongCompress;
-    static int _longCompress;
-    static int _shortCompress;
-    static int _noCompress;
-
-    static SimpleMovingAverage _averagePacketSendingTime;
-    static int _noSend;
-
-    static SimpleMovingAverage _averageProcessWaitTime;
-    static SimpleMovingAverage _averageProcessShortWaitTime;
-    static SimpleMovingAverage _averageProcessLongWaitTime;
-    static SimpleMovingAverage _averageProcessExtraLongWaitTime;
-    static int _extraLongProcessWait;
-    static int _longProcessWait;
-    static int _shortProcessWait;
-    static int _noProcessWait;
+    QMutex _sceneSnapshotLock;
+    OctreeSceneSnapshotPointer _sceneSnapshot;
 
+    static int _clientCount;
     static QMap<OctreeSendThread*, quint64> _threadsDidProcess;
     static QMap<OctreeSendThread*, quint64> _threadsDidPacketDistributor;
     static QMap<OctreeSendThread*, quint64> _threadsDidHandlePacketSend;
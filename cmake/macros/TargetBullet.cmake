@@ -15,4 +15,6 @@ macro(TARGET_BULLET)
       target_include_directories(${TARGET_NAME} SYSTEM PRIVATE ${BULLET_INCLUDE_DIRS})
     endif()
     target_link_libraries(${TARGET_NAME} ${BULLET_LIBRARIES})
+    # our Bullet is built without its global profiler, which isn't safe to use from several threads
+    target_compile_definitions(${TARGET_NAME} PRIVATE BT_NO_PROFILE)
 endmacro()
@@ -17,6 +17,8 @@
 
 #include <AccountManager.h>
 #include <Assignment.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 #include "DomainServer.h"
 #include "DomainServerNodeData.h"
@@ -458,11 +460,33 @@ void DomainGatekeeper::preloadAllowedUserPublicKeys() {
     }
 }
 
+// the most public key requests in flight, and how long one is waited on before another goes for the same user
+const int MAX_PUBLIC_KEY_REQUESTS = 100;
+const quint64 PUBLIC_KEY_REQUEST_TIMEOUT_USECS = 10 * USECS_PER_SECOND;
+
 void DomainGatekeeper::requestUserPublicKey(const QString& username) {
+    // A user's client sends connect requests again and again until it is let in, each failing to verify without a key.
+    // Only one request for a user's key is in flight at a time, and only so many go at once, so that a surge of logins
+    // doesn't flood the API with them; a user whose request didn't go gets another at their next connect request.
+    quint64 now = usecTimestampNow();
+    for (auto request = _publicKeyRequestTimes.begin(); request != _publicKeyRequestTimes.end();) {
+        if (now - request.value() > PUBLIC_KEY_REQUEST_TIMEOUT_USECS) {
+            request = _publicKeyRequestTimes.erase(request);
+        } else {
+            ++request;
+        }
+    }
+    if (_publicKeyRequestTimes.contains(username) || _publicKeyRequestTimes.size() >= MAX_PUBLIC_KEY_REQUESTS) {
+        return;
+    }
+    _publicKeyRequestTimes.insert(username, now);
+
     // even if we have a public key for them right now, request a new one in case it has just changed
     JSONCallbackParameters callbackParams;
     callbackParams.jsonCallbackReceiver = this;
     callbackParams.jsonCallbackMethod = "publicKeyJSONCallback";
+    callbackParams.errorCallbackReceiver = this;
+    callbackParams.errorCallbackMethod = "publicKeyJSONErrorCallback";
     
     const QString USER_PUBLIC_KEY_PATH = "api/v1/users/%1/public_key";
     
@@ -473,13 +497,28 @@ void DomainGatekeeper::requestUserPublicKey(const QString& username) {
                                               QNetworkAccessManager::GetOperation, callbackParams);
 }
 
+const QString PUBLIC_KEY_URL_REGEX_STRING = "api\\/v1\\/users\\/([A-Za-z0-9_\\.]+)\\/public_key";
+
+void DomainGatekeeper::finishPublicKeyRequest(QNetworkReply& requestReply) {
+    // a request for a user whose name doesn't match is left to time out
+    QRegExp usernameRegex(PUBLIC_KEY_URL_REGEX_STRING);
+    if (usernameRegex.indexIn(requestReply.url().toString()) != -1) {
+        _publicKeyRequestTimes.remove(usernameRegex.cap(1));
+    }
+}
+
+void DomainGatekeeper::publicKeyJSONErrorCallback(QNetworkReply& requestReply) {
+    finishPublicKeyRequest(requestReply);
+}
+
 void DomainGatekeeper::publicKeyJSONCallback(QNetworkReply& requestReply) {
+    finishPublicKeyRequest(requestReply);
+
     QJsonObject jsonObject = QJsonDocument::fromJson(requestReply.readAll()).object();
     
     if (jsonObject["status"].toString() == "success") {
         // figure out which user this is for
         
-        const QString PUBLIC_KEY_URL_REGEX_STRING = "api\\/v1\\/users\\/([A-Za-z0-9_\\.]+)\\/public_key";
         QRegExp usernameRegex(PUBLIC_KEY_URL_REGEX_STRING);
         
         if (usernameRegex.indexIn(requestReply.url().toString()) != -1) {
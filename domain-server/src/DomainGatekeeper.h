@@ -47,6 +47,7 @@ public slots:
     void processICEPeerInformationPacket(QSharedPointer<ReceivedMessage> message);
 
     void publicKeyJSONCallback(QNetworkReply& requestReply);
+    void publicKeyJSONErrorCallback(QNetworkReply& requestReply);
     
 signals:
     void connectedNode(SharedNodePointer node);
@@ -78,6 +79,7 @@ private:
     void pingPunchForConnectingPeer(const SharedNetworkPeer& peer);
     
     void requestUserPublicKey(const QString& username);
+    void finishPublicKeyRequest(QNetworkReply& requestReply);
     
     DomainServer* _server;
     
@@ -87,6 +89,7 @@ private:
     
     QHash<QString, QUuid> _connectionTokenHash;
     QHash<QString, QByteArray> _userPublicKeys;
+    QHash<QString, quint64> _publicKeyRequestTimes; // the requests in flight, by user
 };
 
 
@@ -11,6 +11,8 @@
 
 #include "DomainServer.h"
 
+#include <algorithm>
+#include <climits>
 #include <memory>
 
 #include <QDir>
@@ -20,8 +22,10 @@
 #include <QProcess>
 #include <QSharedMemory>
 #include <QStandardPaths>
+#include <QTextStream>
 #include <QTimer>
 #include <QUrlQuery>
+#include <QVector>
 
 #include <AccountManager.h>
 #include <BuildInfo.h>
@@ -38,6 +42,7 @@
 #include <ServerPathUtils.h>
 
 #include "DomainServerNodeData.h"
+#include "JurisdictionPlanner.h"
 #include "NodeConnectionData.h"
 
 int const DomainServer::EXIT_CODE_REBOOT = 234923;
@@ -339,6 +344,14 @@ void DomainServer::setupNodeListAndAssignments(const QUuid& sessionUUID) {
         nodeList->setSessionUUID(idValueVariant->toString());
     }
 
+    // pick how the nodes verify the packets they exchange, they are told with their domain list
+    const QString PACKET_VERIFICATION_KEY_PATH = "security.packet_verification";
+    const QString MD5_PACKET_VERIFICATION_VALUE = "md5";
+
+    QString packetVerification = _settingsManager.valueOrDefaultValueForKeyPath(PACKET_VERIFICATION_KEY_PATH).toString();
+    nodeList->setPacketVerificationMode(packetVerification == MD5_PACKET_VERIFICATION_VALUE
+                                        ? NLPacket::VerificationMode::MD5 : NLPacket::VerificationMode::SipHash);
+
     connect(nodeList.data(), &LimitedNodeList::nodeAdded, this, &DomainServer::nodeAdded);
     connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &DomainServer::nodeKilled);
 
@@ -361,6 +374,8 @@ void DomainServer::setupNodeListAndAssignments(const QUuid& sessionUUID) {
     
     // add whatever static assignments that have been parsed to the queue
     addStaticAssignmentsToQueue();
+
+    setupAvatarMixerScaling();
 }
 
 bool DomainServer::didSetupAccountManagerWithAccessToken() {
@@ -652,10 +667,20 @@ void DomainServer::populateDefaultStaticAssignmentsExcludingTypes(const QSet<Ass
                 }
             }
             
+            // the agents can be split between several avatar-mixers, which share their avatars with each other
+            int numAssignments = 1;
+            if (defaultedType == Assignment::AvatarMixerType) {
+                static const QString NUM_AVATAR_MIXERS_KEYPATH = "avatar_mixer.num_avatar_mixers";
+                numAssignments = std::max(_settingsManager.valueOrDefaultValueForKeyPath(NUM_AVATAR_MIXERS_KEYPATH).toInt(), 1);
+                _numAvatarMixerAssignments = numAssignments;
+            }
+
             // type has not been set from a command line or config file config, use the default
-            // by clearing whatever exists and writing a single default assignment with no payload
-            Assignment* newAssignment = new Assignment(Assignment::CreateCommand, (Assignment::Type) defaultedType);
-            addStaticAssignmentToAssignmentHash(newAssignment);
+            // by clearing whatever exists and writing default assignments with no payload
+            for (int i = 0; i < numAssignments; ++i) {
+                Assignment* newAssignment = new Assignment(Assignment::CreateCommand, (Assignment::Type) defaultedType);
+                addStaticAssignmentToAssignmentHash(newAssignment);
+            }
         }
     }
 }
@@ -733,7 +758,7 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
 }
 
 void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
-    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2;
+    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 3;
     
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
@@ -746,12 +771,10 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     extendedHeaderStream << node->getUUID();
     extendedHeaderStream << (quint8) node->getCanAdjustLocks();
     extendedHeaderStream << (quint8) node->getCanRez();
+    extendedHeaderStream << (quint8) limitedNodeList->getPacketVerificationMode();
 
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
-    // always send the node their own UUID back
-    QDataStream domainListStream(domainListPackets.get());
-
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
 
     // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
@@ -759,26 +782,48 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
 
     if (nodeInterestSet.size() > 0) {
 
+        // an agent only hears about the one avatar-mixer it is assigned to
+        QUuid avatarMixerUUID;
+        if (node->getType() == NodeType::Agent && nodeInterestSet.contains(NodeType::AvatarMixer)) {
+            avatarMixerUUID = avatarMixerForAgent(node);
+        }
+
+        // The nodes keep the nodes of the lists they got, and only hear of node removals on their own, so a list only
+        // has the nodes that are new to the node or changed since the list before.  Every so often a list has them all,
+        // for the nodes of lists and added node packets dropped on the way.
+        bool fullList = nodeData->isDomainListFull();
+        QHash<QUuid, QByteArray>& sentEntries = nodeData->getDomainListEntries();
+        QHash<QUuid, QByteArray> entries;
+
         // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
         if (nodeData->isAuthenticated()) {
             // if this authenticated node has any interest types, send back those nodes as well
             limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
-                if (otherNode->getUUID() != node->getUUID() && nodeInterestSet.contains(otherNode->getType())) {
-                    
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+                if (otherNode->getUUID() != node->getUUID() && nodeInterestSet.contains(otherNode->getType())
+                    && (otherNode->getType() != NodeType::AvatarMixer || avatarMixerUUID.isNull()
+                        || otherNode->getUUID() == avatarMixerUUID)) {
+
+                    QByteArray entry;
+                    QDataStream entryStream(&entry, QIODevice::WriteOnly);
 
                     // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+                    entryStream << *otherNode.data();
 
                     // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
-
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
+                    entryStream << connectionSecretForNodes(node, otherNode);
+
+                    if (fullList || sentEntries.value(otherNode->getUUID()) != entry) {
+                        // since we're about to add a node to the packet we start a segment
+                        domainListPackets->startSegment();
+                        domainListPackets->write(entry);
+                        // we've added the node we wanted so end the segment now
+                        domainListPackets->endSegment();
+                    }
+                    entries.insert(otherNode->getUUID(), entry);
                 }
             });
         }
+        sentEntries.swap(entries);
     }
     
     // send an empty list to the node, in case there were no other nodes
@@ -822,9 +867,31 @@ void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
 
     int connectionSecretIndex = addNodePacket->pos();
 
+    // a new avatar-mixer is only sent to the agents that get assigned to it, the others stay with their own
+    QSet<QUuid> agentsForAvatarMixer;
+    if (addedNode->getType() == NodeType::AvatarMixer) {
+        QVector<SharedNodePointer> agents;
+        limitedNodeList->eachNode([&](const SharedNodePointer& node){
+            if (node->getType() == NodeType::Agent && node->getLinkedData()) {
+                agents << node;
+            }
+        });
+
+        for (const SharedNodePointer& agent : agents) {
+            if (avatarMixerForAgent(agent) == addedNode->getUUID()) {
+                agentsForAvatarMixer.insert(agent->getUUID());
+            }
+        }
+    }
+
     limitedNodeList->eachMatchingNode(
         [&](const SharedNodePointer& node)->bool {
             if (node->getLinkedData() && node->getActiveSocket() && node != addedNode) {
+                if (addedNode->getType() == NodeType::AvatarMixer && node->getType() == NodeType::Agent
+                    && !agentsForAvatarMixer.contains(node->getUUID())) {
+                    return false;
+                }
+
                 // is the added Node in this node's interest list?
                 DomainServerNodeData* nodeData = dynamic_cast<DomainServerNodeData*>(node->getLinkedData());
                 return nodeData->getNodeInterestSet().contains(addedNode->getType());
@@ -846,6 +913,48 @@ void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
     );
 }
 
+QUuid DomainServer::avatarMixerForAgent(const SharedNodePointer& agent) {
+    DomainServerNodeData* agentData = reinterpret_cast<DomainServerNodeData*>(agent->getLinkedData());
+
+    // count the agents each avatar-mixer already has
+    QHash<QUuid, int> numAgentsForAvatarMixers;
+    QVector<QUuid> assignedAvatarMixers;
+
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+    limitedNodeList->eachNode([&](const SharedNodePointer& node){
+        if (node->getType() == NodeType::AvatarMixer) {
+            numAgentsForAvatarMixers.insert(node->getUUID(), 0);
+        } else if (node->getType() == NodeType::Agent && node != agent && node->getLinkedData()) {
+            assignedAvatarMixers << reinterpret_cast<DomainServerNodeData*>(node->getLinkedData())->getAvatarMixerUUID();
+        }
+    });
+
+    // an agent stays with its avatar-mixer for as long as that mixer is around
+    if (numAgentsForAvatarMixers.contains(agentData->getAvatarMixerUUID())) {
+        return agentData->getAvatarMixerUUID();
+    }
+
+    for (const QUuid& avatarMixerUUID : assignedAvatarMixers) {
+        auto it = numAgentsForAvatarMixers.find(avatarMixerUUID);
+        if (it != numAgentsForAvatarMixers.end()) {
+            ++it.value();
+        }
+    }
+
+    // otherwise it goes to the one with the fewest agents
+    QUuid leastLoadedAvatarMixer;
+    int leastNumAgents = INT_MAX;
+    for (auto it = numAgentsForAvatarMixers.begin(); it != numAgentsForAvatarMixers.end(); ++it) {
+        if (it.value() < leastNumAgents) {
+            leastLoadedAvatarMixer = it.key();
+            leastNumAgents = it.value();
+        }
+    }
+
+    agentData->setAvatarMixerUUID(leastLoadedAvatarMixer);
+    return leastLoadedAvatarMixer;
+}
+
 void DomainServer::processRequestAssignmentPacket(QSharedPointer<ReceivedMessage> message) {
     // construct the requested assignment from the packet data
     Assignment requestAssignment(*message);
@@ -1326,6 +1435,24 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             // send the response
             connection->respond(HTTPConnection::StatusCode200, nodesDocument.toJson(), qPrintable(JSON_MIME_TYPE));
 
+            return true;
+        } else if (url.path() == "/metrics") {
+            connection->respond(HTTPConnection::StatusCode200, getMixerFrameTimingMetrics(), "text/plain; version=0.0.4");
+            return true;
+        } else if (url.path() == "/jurisdictions.json") {
+            // the entity-server jurisdictions that their last stats say should be split or merged
+            QVector<JurisdictionPlanner::ServerLoad> loads;
+            nodeList->eachNode([&loads](const SharedNodePointer& node) {
+                auto nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+                JurisdictionPlanner::ServerLoad load;
+                if (node->getType() == NodeType::EntityServer && nodeData
+                    && JurisdictionPlanner::loadFromStats(node->getUUID(), nodeData->getStatsJSONObject(), load)) {
+                    loads.append(load);
+                }
+            });
+
+            QJsonDocument planDocument(JurisdictionPlanner::plan(loads));
+            connection->respond(HTTPConnection::StatusCode200, planDocument.toJson(), qPrintable(JSON_MIME_TYPE));
             return true;
         } else {
             // check if this is for json stats for a node
@@ -1531,6 +1658,42 @@ bool DomainServer::handleHTTPSRequest(HTTPSConnection* connection, const QUrl &u
     }
 }
 
+QByteArray DomainServer::getMixerFrameTimingMetrics() {
+    QByteArray metrics;
+    QTextStream stream(&metrics);
+
+    // the mixers send a histogram of each stage of their frames with their stats, these are from the last stats they sent
+    stream << "# TYPE hifi_mixer_frame_timing gauge\n";
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    nodeList->eachNode([&stream](const SharedNodePointer& node) {
+        auto nodeData = dynamic_cast<DomainServerNodeData*>(node->getLinkedData());
+        if (!nodeData) {
+            return;
+        }
+
+        QJsonObject frameTiming = nodeData->getStatsJSONObject()["frame_timing"].toObject();
+        if (frameTiming.isEmpty()) {
+            return;
+        }
+
+        QString nodeType = NodeType::getNodeTypeName(node->getType()).toLower().replace(' ', '-');
+        QString nodeUUID = uuidStringWithoutCurlyBraces(node->getUUID());
+
+        for (auto stage = frameTiming.constBegin(); stage != frameTiming.constEnd(); ++stage) {
+            QJsonObject histogram = stage.value().toObject();
+            for (auto stat = histogram.constBegin(); stat != histogram.constEnd(); ++stat) {
+                stream << "hifi_mixer_frame_timing{node_type=\"" << nodeType << "\",node=\"" << nodeUUID
+                    << "\",stage=\"" << stage.key() << "\",stat=\"" << stat.key() << "\"} "
+                    << stat.value().toDouble() << "\n";
+            }
+        }
+    });
+
+    stream.flush();
+    return metrics;
+}
+
 bool DomainServer::isAuthenticatedRequest(HTTPConnection* connection, const QUrl& url) {
 
     const QByteArray HTTP_COOKIE_HEADER_KEY = "Cookie";
@@ -1858,6 +2021,52 @@ void DomainServer::addStaticAssignmentsToQueue() {
     }
 }
 
+void DomainServer::setupAvatarMixerScaling() {
+    static const QString MAX_AVATAR_MIXERS_KEYPATH = "avatar_mixer.max_avatar_mixers";
+    _maxAvatarMixers = _settingsManager.valueOrDefaultValueForKeyPath(MAX_AVATAR_MIXERS_KEYPATH).toInt();
+
+    // only the default avatar-mixer assignments grow, a configured set is left as it is
+    if (_numAvatarMixerAssignments > 0 && _numAvatarMixerAssignments < _maxAvatarMixers) {
+        QTimer* avatarMixerLoadTimer = new QTimer(this);
+        connect(avatarMixerLoadTimer, &QTimer::timeout, this, &DomainServer::checkAvatarMixerLoad);
+
+        const int AVATAR_MIXER_LOAD_CHECK_INTERVAL_MSECS = 10 * 1000;
+        avatarMixerLoadTimer->start(AVATAR_MIXER_LOAD_CHECK_INTERVAL_MSECS);
+    }
+}
+
+void DomainServer::checkAvatarMixerLoad() {
+    if (_numAvatarMixerAssignments >= _maxAvatarMixers) {
+        sender()->deleteLater();
+        return;
+    }
+
+    // the mixers start throttling what they send when they sleep too little of their frames
+    const QString PERFORMANCE_THROTTLING_RATIO_KEY = "performance_throttling_ratio";
+
+    int numConnectedAvatarMixers = 0;
+    int numThrottlingAvatarMixers = 0;
+    DependencyManager::get<LimitedNodeList>()->eachNode([&](const SharedNodePointer& node){
+        auto nodeData = dynamic_cast<DomainServerNodeData*>(node->getLinkedData());
+        if (node->getType() == NodeType::AvatarMixer && nodeData) {
+            ++numConnectedAvatarMixers;
+            if (nodeData->getStatsJSONObject()[PERFORMANCE_THROTTLING_RATIO_KEY].toDouble() > 0.0) {
+                ++numThrottlingAvatarMixers;
+            }
+        }
+    });
+
+    // one more mixer at a time, once those there are all running and all struggling
+    if (numConnectedAvatarMixers == _numAvatarMixerAssignments && numThrottlingAvatarMixers == numConnectedAvatarMixers) {
+        qDebug() << "All" << _numAvatarMixerAssignments << "avatar-mixers are throttling, adding an avatar-mixer assignment";
+
+        Assignment* newAssignment = new Assignment(Assignment::CreateCommand, Assignment::AvatarMixerType);
+        addStaticAssignmentToAssignmentHash(newAssignment);
+        _unfulfilledAssignments.enqueue(_allAssignments.value(newAssignment->getUUID()));
+        ++_numAvatarMixerAssignments;
+    }
+}
+
 void DomainServer::processPathQueryPacket(QSharedPointer<ReceivedMessage> message) {
     // this is a query for the viewpoint resulting from a path
     // first pull the query path from the packet
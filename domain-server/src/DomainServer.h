@@ -75,6 +75,8 @@ private slots:
     
     void handleConnectedNode(SharedNodePointer newNode);
 
+    void checkAvatarMixerLoad();
+
     void handleTempDomainSuccess(QNetworkReply& requestReply);
     void handleTempDomainError(QNetworkReply& requestReply);
     
@@ -99,6 +101,7 @@ private:
 
     QUuid connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
     void broadcastNewNode(const SharedNodePointer& node);
+    QUuid avatarMixerForAgent(const SharedNodePointer& agent);
 
     void parseAssignmentConfigs(QSet<Assignment::Type>& excludedTypes);
     void addStaticAssignmentToAssignmentHash(Assignment* newAssignment);
@@ -110,6 +113,7 @@ private:
     SharedAssignmentPointer deployableAssignmentForRequest(const Assignment& requestAssignment);
     void refreshStaticAssignmentAndAddToQueue(SharedAssignmentPointer& assignment);
     void addStaticAssignmentsToQueue();
+    void setupAvatarMixerScaling();
     
     QUrl oauthRedirectURL();
     QUrl oauthAuthorizationURL(const QUuid& stateUUID = QUuid::createUuid());
@@ -125,6 +129,7 @@ private:
 
     QJsonObject jsonForSocket(const HifiSockAddr& socket);
     QJsonObject jsonObjectForNode(const SharedNodePointer& node);
+    QByteArray getMixerFrameTimingMetrics();
     
     DomainGatekeeper _gatekeeper;
 
@@ -151,6 +156,9 @@ private:
 
     HifiSockAddr _iceServerSocket;
 
+    int _numAvatarMixerAssignments { 0 }; // the avatar-mixers of the default assignments, which grow under load
+    int _maxAvatarMixers { 1 };
+
     QTimer* _iceHeartbeatTimer { nullptr }; // this looks like it dangles when created but it's parented to the DomainServer
     
     friend class DomainGatekeeper;
@@ -26,9 +26,18 @@ DomainServerNodeData::DomainServerNodeData() {
 }
 
 void DomainServerNodeData::updateJSONStats(QByteArray statsByteArray) {
-    auto document = QJsonDocument::fromBinaryData(statsByteArray);
-    Q_ASSERT(document.isObject());
-    _statsJSONObject = overrideValuesIfNeeded(document.object());
+    // the stats come every second from every node, and are only looked at when the status page asks for them
+    _statsByteArray = statsByteArray;
+}
+
+const QJsonObject& DomainServerNodeData::getStatsJSONObject() {
+    if (!_statsByteArray.isEmpty()) {
+        auto document = QJsonDocument::fromBinaryData(_statsByteArray);
+        Q_ASSERT(document.isObject());
+        _statsJSONObject = overrideValuesIfNeeded(document.object());
+        _statsByteArray.clear();
+    }
+    return _statsJSONObject;
 }
 
 QJsonObject DomainServerNodeData::overrideValuesIfNeeded(const QJsonObject& newStats) {
@@ -25,7 +25,8 @@ class DomainServerNodeData : public NodeData {
 public:
     DomainServerNodeData();
 
-    const QJsonObject& getStatsJSONObject() const { return _statsJSONObject; }
+    /// the stats last received from the node, parsed when they are first asked for after they came
+    const QJsonObject& getStatsJSONObject();
 
     void updateJSONStats(QByteArray statsByteArray);
 
@@ -50,7 +51,16 @@ public:
 
     const NodeSet& getNodeInterestSet() const { return _nodeInterestSet; }
     void setNodeInterestSet(const NodeSet& nodeInterestSet) { _nodeInterestSet = nodeInterestSet; }
+
+    /// the avatar-mixer this agent is told about, when the domain runs more than one
+    void setAvatarMixerUUID(const QUuid& avatarMixerUUID) { _avatarMixerUUID = avatarMixerUUID; }
+    const QUuid& getAvatarMixerUUID() const { return _avatarMixerUUID; }
     
+    /// the nodes last sent to this node in domain lists, as they were written to the list
+    QHash<QUuid, QByteArray>& getDomainListEntries() { return _domainListEntries; }
+    /// true every so many domain lists, when the next is to have all the nodes again
+    bool isDomainListFull() { return _domainListsSinceFull++ % FULL_DOMAIN_LIST_INTERVAL == 0; }
+
     void setNodeVersion(const QString& nodeVersion) { _nodeVersion = nodeVersion; }
     const QString& getNodeVersion() { return _nodeVersion; }
     
@@ -69,12 +79,18 @@ private:
     
     using StringPairHash = QHash<QPair<QString, QString>, QString>;
     QJsonObject _statsJSONObject;
+    QByteArray _statsByteArray; // the binary JSON of the stats received since they were last parsed
     static StringPairHash _overrideHash;
     
     HifiSockAddr _sendingSockAddr;
     bool _isAuthenticated = true;
     NodeSet _nodeInterestSet;
+    QUuid _avatarMixerUUID;
     QString _nodeVersion;
+
+    static const int FULL_DOMAIN_LIST_INTERVAL = 10;
+    QHash<QUuid, QByteArray> _domainListEntries;
+    int _domainListsSinceFull { 0 };
 };
 
 #endif // hifi_DomainServerNodeData_h
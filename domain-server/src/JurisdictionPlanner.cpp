@@ -0,0 +1,118 @@
+//
+//  JurisdictionPlanner.cpp
+//  domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JurisdictionPlanner.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QMap>
+
+#include <OctalCode.h>
+#include <OctreeConstants.h>
+#include <UUID.h>
+
+// the octree servers run a send loop for each client at this interval
+const float SEND_INTERVAL_USECS = 1000.0f * 1000.0f / 90.0f;
+
+// split past most of a core or this many clients, merge well below that so that a merge doesn't call for a split
+const float SPLIT_SEND_LOAD = 0.75f;
+const int SPLIT_CLIENTS = 60;
+const float MERGE_SEND_LOAD = 0.1f;
+const int MERGE_CLIENTS = 10;
+
+bool JurisdictionPlanner::loadFromStats(const QUuid& nodeID, const QJsonObject& stats, ServerLoad& load) {
+    QJsonObject serverStats = stats["EntityServer"].toObject();
+    QJsonObject misc = serverStats["1. misc"].toObject();
+    if (!misc.contains("7. jurisdictionRoot")) {
+        return false;
+    }
+
+    unsigned char* root = hexStringToOctalCode(misc["7. jurisdictionRoot"].toString());
+    std::vector<unsigned char*> endNodes;
+    for (const auto& endNode : misc["8. jurisdictionEndNodes"].toArray()) {
+        endNodes.push_back(hexStringToOctalCode(endNode.toString()));
+    }
+    load.nodeID = nodeID;
+    load.jurisdiction.setNodeType(NodeType::EntityServer);
+    load.jurisdiction.copyContents(root, endNodes);
+    delete[] root;
+    for (auto endNode : endNodes) {
+        delete[] endNode;
+    }
+    load.clients = misc["5. clients"].toInt();
+
+    QJsonObject outboundTiming = serverStats["3. outbound"].toObject()["timing"].toObject();
+    float loopUsecs = (float)outboundTiming["1. avgLoopTime"].toDouble();
+    load.sendLoad = load.clients * loopUsecs / SEND_INTERVAL_USECS;
+    return true;
+}
+
+static QJsonObject jsonForJurisdiction(const JurisdictionMap& jurisdiction) {
+    QJsonObject json;
+    json["root"] = jurisdiction.getRootHexString();
+    json["end_nodes"] = QJsonArray::fromStringList(jurisdiction.getEndNodeHexStrings());
+    return json;
+}
+
+QJsonObject JurisdictionPlanner::plan(const QVector<ServerLoad>& servers) {
+    QJsonArray serversJSON;
+    QJsonArray splitsJSON;
+
+    // the quiet whole children of a root, by the root, which can go back to one server once all eight are quiet
+    QMap<QString, QJsonArray> quietSiblings;
+    QMap<QString, int> quietSiblingClients;
+
+    for (const auto& server : servers) {
+        QJsonObject serverJSON = jsonForJurisdiction(server.jurisdiction);
+        serverJSON["node"] = uuidStringWithoutCurlyBraces(server.nodeID);
+        serverJSON["clients"] = server.clients;
+        serverJSON["send_load"] = server.sendLoad;
+        serversJSON.append(serverJSON);
+
+        if (server.sendLoad > SPLIT_SEND_LOAD || server.clients > SPLIT_CLIENTS) {
+            QJsonArray into;
+            for (const auto& child : server.jurisdiction.split()) {
+                into.append(jsonForJurisdiction(child));
+            }
+            if (into.size() > 1) {
+                QJsonObject split;
+                split["node"] = uuidStringWithoutCurlyBraces(server.nodeID);
+                split["into"] = into;
+                splitsJSON.append(split);
+            }
+        } else if (server.sendLoad < MERGE_SEND_LOAD && server.clients < MERGE_CLIENTS
+                   && server.jurisdiction.getEndNodeCount() == 0) {
+            unsigned char* root = server.jurisdiction.getRootOctalCode();
+            if (root && numberOfThreeBitSectionsInCode(root) > 0) {
+                unsigned char* parentRoot = parentOctalCode(root);
+                QString parentHex = octalCodeToHexString(parentRoot);
+                delete[] parentRoot;
+                quietSiblings[parentHex].append(uuidStringWithoutCurlyBraces(server.nodeID));
+                quietSiblingClients[parentHex] += server.clients;
+            }
+        }
+    }
+
+    QJsonArray mergesJSON;
+    for (auto siblings = quietSiblings.constBegin(); siblings != quietSiblings.constEnd(); ++siblings) {
+        if (siblings.value().size() == NUMBER_OF_CHILDREN && quietSiblingClients[siblings.key()] < MERGE_CLIENTS) {
+            QJsonObject merge;
+            merge["nodes"] = siblings.value();
+            merge["root"] = siblings.key();
+            merge["end_nodes"] = QJsonArray();
+            mergesJSON.append(merge);
+        }
+    }
+
+    QJsonObject planJSON;
+    planJSON["servers"] = serversJSON;
+    planJSON["splits"] = splitsJSON;
+    planJSON["merges"] = mergesJSON;
+    return planJSON;
+}
@@ -0,0 +1,38 @@
+//
+//  JurisdictionPlanner.h
+//  domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JurisdictionPlanner_h
+#define hifi_JurisdictionPlanner_h
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+#include <JurisdictionMap.h>
+
+/// Suggests how the entity-server jurisdictions should change with their load. A busy jurisdiction is split between
+/// the children of its root, and the eight quiet children of a root are merged back into it. The servers can't yet
+/// hand their entities and clients to one another, so the plan is advice for whoever sets up the jurisdictions.
+class JurisdictionPlanner {
+public:
+    struct ServerLoad {
+        QUuid nodeID;
+        JurisdictionMap jurisdiction;
+        int clients { 0 };
+        float sendLoad { 0.0f }; // the cores its send threads keep busy
+    };
+
+    /// reads the load from the stats an entity-server last sent, false when they don't have it
+    static bool loadFromStats(const QUuid& nodeID, const QJsonObject& stats, ServerLoad& load);
+
+    static QJsonObject plan(const QVector<ServerLoad>& servers);
+};
+
+#endif // hifi_JurisdictionPlanner_h
@@ -38,7 +38,8 @@ function CounterWidget(parentPanel, name, counter) {
         var numMax = Math.max(numDrawn, 1);
         var title = [
             ' ' + name,
-            numDrawn + ' / ' + counter.numFeed
+            numDrawn + ' / ' + counter.numFeed,
+            counter.cpuTime.toFixed(2) + ' / ' + counter.gpuTime.toFixed(2) + ' ms'
         ].join('\t');
 
         widget.editTitle({ text: title });
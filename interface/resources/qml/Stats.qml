@@ -72,6 +72,13 @@ Item {
                         font.pixelSize: root.fontSize
                         text: "Mbps In/Out: " + root.mbpsIn.toFixed(2) + "/" + root.mbpsOut.toFixed(2)
                     }
+                    Text {
+                        color: root.fontColor;
+                        font.pixelSize: root.fontSize
+                        visible: root.expanded
+                        text: "Scripts: " + root.scriptLoad.toFixed(1) + "%" +
+                            (root.busiestScript ? " (most: " + root.busiestScript + ")" : "")
+                    }
                 }
             }
 
@@ -19,6 +19,8 @@
 #include <glm/gtx/vector_angle.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <QtConcurrent/QtConcurrentRun>
+
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -107,6 +109,7 @@
 #include <ScriptCache.h>
 #include <SoundCache.h>
 #include <ScriptEngines.h>
+#include <ShapeFactory.h>
 #include <TextureCache.h>
 #include <Tooltip.h>
 #include <udt/PacketHeaders.h>
@@ -219,6 +222,8 @@ static const QString DESKTOP_LOCATION = QStandardPaths::writableLocation(QStanda
 
 const QString DEFAULT_SCRIPTS_JS_URL = "http://s3.amazonaws.com/hifi-public/scripts/defaultScripts.js";
 Setting::Handle<int> maxOctreePacketsPerSecond("maxOctreePPS", DEFAULT_MAX_OCTREE_PPS);
+static const int DEFAULT_MAX_UI_FPS = 60;
+Setting::Handle<int> maxUiFps("maxUiFps", DEFAULT_MAX_UI_FPS);
 
 const QHash<QString, Application::AcceptURLMethod> Application::_acceptedExtensions {
     { SNAPSHOT_EXTENSION, &Application::acceptSnapshot },
@@ -406,6 +411,7 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer) :
     _mirrorViewRect(QRect(MIRROR_VIEW_LEFT_PADDING, MIRROR_VIEW_TOP_PADDING, MIRROR_VIEW_WIDTH, MIRROR_VIEW_HEIGHT)),
     _previousScriptLocation("LastScriptLocation", DESKTOP_LOCATION),
     _fieldOfView("fieldOfView", DEFAULT_FIELD_OF_VIEW_DEGREES),
+    _physicsInterestRadius("physicsInterestRadius", DEFAULT_PHYSICS_INTEREST_RADIUS),
     _scaleMirror(1.0f),
     _rotateMirror(0.0f),
     _raiseMirror(0.0f),
@@ -1064,6 +1070,8 @@ void Application::emptyLocalCache() {
 }
 
 Application::~Application() {
+    finishPhysicsStep();
+
     EntityTreePointer tree = getEntities()->getTree();
     tree->setSimulation(NULL);
 
@@ -1124,6 +1132,17 @@ Application::~Application() {
     qInstallMessageHandler(NULL); // NOTE: Do this as late as possible so we continue to get our log messages
 }
 
+// The render scale keeps the GPU time of the frames within the frame time of the display
+static void updateRenderScaleTarget(const render::EnginePointer& renderEngine, const DisplayPluginPointer& displayPlugin) {
+    auto renderScaleConfig = renderEngine->getConfiguration()->getConfig<RenderScale>();
+    if (renderScaleConfig && displayPlugin) {
+        static const float DEFAULT_TARGET_FRAME_RATE = 60.0f;
+        float targetFrameRate = displayPlugin->getTargetFrameRate();
+        renderScaleConfig->targetFrameRate = (targetFrameRate > 0.0f) ? targetFrameRate : DEFAULT_TARGET_FRAME_RATE;
+        emit renderScaleConfig->dirty();
+    }
+}
+
 void Application::initializeGL() {
     qCDebug(interfaceapp) << "Created Display Window.";
 
@@ -1146,6 +1165,7 @@ void Application::initializeGL() {
     _renderEngine->addJob<RenderShadowTask>("RenderShadowTask", cullFunctor);
     _renderEngine->addJob<RenderDeferredTask>("RenderDeferredTask", cullFunctor);
     _renderEngine->registerScene(_main3DScene);
+    updateRenderScaleTarget(_renderEngine, _displayPlugin);
     // TODO: Load a cached config file
 
     // The UI can't be created until the primary OpenGL
@@ -1187,6 +1207,7 @@ void Application::initializeUi() {
 
     auto offscreenUi = DependencyManager::get<OffscreenUi>();
     offscreenUi->create(_offscreenContext->getContext());
+    offscreenUi->setMaxFps(maxUiFps.get());
     offscreenUi->setProxyWindow(_window->windowHandle());
     offscreenUi->setBaseUrl(QUrl::fromLocalFile(PathUtils::resourcesPath() + "/qml/"));
     // OffscreenUi is a subclass of OffscreenQmlSurface specifically designed to
@@ -1291,6 +1312,7 @@ void Application::paintGL() {
         return;
     }
     _frameCount++;
+    DependencyManager::get<GeometryCache>()->beginFrame();
 
     // update fps moving average
     uint64_t now = usecTimestampNow();
@@ -1310,6 +1332,11 @@ void Application::paintGL() {
         _lastFramesPerSecondUpdate = now;
     }
 
+    // FIXME the simulation of a frame (idle) and its render run one after the other on this thread. Only the physics
+    // step overlaps the render, on its own thread (see startPhysicsStep), and the present is on the display plugin's
+    // thread. Rendering on a thread of its own needs the gpu backend's framebuffers and vertex arrays, which aren't
+    // shared between GL contexts, moved off the offscreen context of this thread, and the render items to read
+    // snapshots of the entities and avatars in place of the live objects the simulation writes to.
     if (_isGLInitialized) {
         idle(now);
     }
@@ -2733,10 +2760,19 @@ void Application::init() {
     getEntities()->setViewFrustum(getViewFrustum());
 
     ObjectMotionState::setShapeManager(&_shapeManager);
+    // reduced collision hulls are kept next to the network cache
+    QString hullCachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+    _hullCache.setCacheDirectory((!hullCachePath.isEmpty() ? hullCachePath : "interfaceCache") + "/hulls");
+    ShapeFactory::setHullCache(&_hullCache);
     _physicsEngine->init();
 
+    // one thread that is kept around, so each step doesn't pay to start it
+    _physicsThread.setMaxThreadCount(1);
+    _physicsThread.setExpiryTimeout(-1);
+
     EntityTreePointer tree = getEntities()->getTree();
     _entitySimulation.init(tree, _physicsEngine, &_entityEditSender);
+    _entitySimulation.setInterestRadius(_physicsInterestRadius.get());
     tree->setSimulation(&_entitySimulation);
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
@@ -2793,7 +2829,13 @@ void Application::updateLOD() {
     PerformanceTimer perfTimer("LOD");
     // adjust it unless we were asked to disable this feature, or if we're currently in throttleRendering mode
     if (!isThrottleRendering()) {
-        DependencyManager::get<LODManager>()->autoAdjustLOD(_fps);
+        // the frame is as slow as the slower of the CPU and the GPU on the deferred jobs
+        float renderTime = 0.0f;
+        auto deferredConfig = _renderEngine->getConfiguration()->getConfig<RenderDeferredTask>("RenderDeferredTask");
+        if (deferredConfig) {
+            renderTime = (float)glm::max(deferredConfig->getCpuTime(), deferredConfig->getGpuTime());
+        }
+        DependencyManager::get<LODManager>()->autoAdjustLOD(renderTime);
     } else {
         DependencyManager::get<LODManager>()->resetLODAdjust();
     }
@@ -3095,13 +3137,50 @@ void Application::update(float deltaTime) {
 
     _avatarUpdate->synchronousProcess();
 
+    // physics was stepped on its own thread while the last frame was rendered
+    finishPhysicsStep();
+    if (!_physicsEnabled) {
+        // physics was switched off since the step, and the objects it moved may be gone by the time it is back on
+        _physicsHasOutgoingChanges = false;
+    }
+
     if (_physicsEnabled) {
         PerformanceTimer perfTimer("physics");
         AvatarManager* avatarManager = DependencyManager::get<AvatarManager>().data();
 
+        {
+            PerformanceTimer perfTimer("havestChanges");
+            if (_physicsHasOutgoingChanges) {
+                _physicsHasOutgoingChanges = false;
+                getEntities()->getTree()->withWriteLock([&] {
+                    _entitySimulation.handleOutgoingChanges(_physicsOutgoingChanges, Physics::getSessionUUID());
+                    avatarManager->handleOutgoingChanges(_physicsOutgoingChanges);
+                });
+
+                avatarManager->handleCollisionEvents(_physicsCollisionEvents);
+
+                _physicsEngine->dumpStatsIfNecessary();
+
+                if (!_aboutToQuit) {
+                    PerformanceTimer perfTimer("entities");
+                    // Collision events (and their scripts) must not be handled when we're locked, above. (That would risk
+                    // deadlock.)
+                    _entitySimulation.handleCollisionEvents(_physicsCollisionEvents);
+                    // NOTE: the getEntities()->update() call below will wait for lock
+                    // and will simulate entity motion (the EntityTree has been given an EntitySimulation).
+                    getEntities()->update(); // update the models...
+                }
+
+                myAvatar->harvestResultsFromPhysicsSimulation(deltaTime);
+            }
+        }
+
         {
             PerformanceTimer perfTimer("updateStates)");
             static VectorOfMotionStates motionStates;
+            getEntities()->getTree()->withReadLock([&] {
+                _entitySimulation.updateInterest(myAvatar->getPosition());
+            });
             _entitySimulation.getObjectsToRemoveFromPhysics(motionStates);
             _physicsEngine->removeObjects(motionStates);
             _entitySimulation.deleteObjectsRemovedFromPhysics();
@@ -3131,38 +3210,8 @@ void Application::update(float deltaTime) {
                 action->prepareForPhysicsSimulation();
             });
         }
-        {
-            PerformanceTimer perfTimer("stepSimulation");
-            getEntities()->getTree()->withWriteLock([&] {
-                _physicsEngine->stepSimulation();
-            });
-        }
-        {
-            PerformanceTimer perfTimer("havestChanges");
-            if (_physicsEngine->hasOutgoingChanges()) {
-                getEntities()->getTree()->withWriteLock([&] {
-                    _entitySimulation.handleOutgoingChanges(_physicsEngine->getOutgoingChanges(), Physics::getSessionUUID());
-                    avatarManager->handleOutgoingChanges(_physicsEngine->getOutgoingChanges());
-                });
-
-                auto collisionEvents = _physicsEngine->getCollisionEvents();
-                avatarManager->handleCollisionEvents(collisionEvents);
-
-                _physicsEngine->dumpStatsIfNecessary();
-
-                if (!_aboutToQuit) {
-                    PerformanceTimer perfTimer("entities");
-                    // Collision events (and their scripts) must not be handled when we're locked, above. (That would risk
-                    // deadlock.)
-                    _entitySimulation.handleCollisionEvents(collisionEvents);
-                    // NOTE: the getEntities()->update() call below will wait for lock
-                    // and will simulate entity motion (the EntityTree has been given an EntitySimulation).
-                    getEntities()->update(); // update the models...
-                }
 
-                myAvatar->harvestResultsFromPhysicsSimulation(deltaTime);
-            }
-        }
+        startPhysicsStep();
     }
 
     {
@@ -3198,6 +3247,7 @@ void Application::update(float deltaTime) {
             if (DependencyManager::get<SceneScriptingInterface>()->shouldRenderEntities()) {
                 queryOctree(NodeType::EntityServer, PacketType::EntityQuery, _entityServerJurisdictions);
             }
+            queryAvatars();
             _lastQueriedViewFrustum = _viewFrustum;
         }
     }
@@ -3227,6 +3277,29 @@ void Application::update(float deltaTime) {
 }
 
 
+void Application::startPhysicsStep() {
+    // The step and the copy of its results into the motion states' entities happen under the tree's write lock,
+    // as they did on the main thread. The outgoing changes and collision events are only handed back to the
+    // main thread, which sends and dispatches them at the start of the next update().
+    _physicsStep = QtConcurrent::run(&_physicsThread, [this] {
+        getEntities()->getTree()->withWriteLock([&] {
+            _physicsEngine->stepSimulation();
+            if (_physicsEngine->hasOutgoingChanges()) {
+                _physicsOutgoingChanges = _physicsEngine->getOutgoingChanges();
+                _physicsCollisionEvents = _physicsEngine->getCollisionEvents();
+                _physicsHasOutgoingChanges = true;
+            }
+        });
+    });
+}
+
+void Application::finishPhysicsStep() {
+    if (!_physicsStep.isFinished()) {
+        PerformanceTimer perfTimer("waitForPhysics");
+        _physicsStep.waitForFinished();
+    }
+}
+
 int Application::sendNackPackets() {
 
     if (Menu::getInstance()->isOptionChecked(MenuOption::DisableNackPackets)) {
@@ -3455,6 +3528,26 @@ void Application::queryOctree(NodeType_t serverType, PacketType packetType, Node
     });
 }
 
+void Application::queryAvatars() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer avatarMixer = nodeList->soloNodeOfType(NodeType::AvatarMixer);
+    if (!avatarMixer || !avatarMixer->getActiveSocket()) {
+        return;
+    }
+
+    // tell the avatar mixer where our camera is looking so it can send us the avatars we can see first
+    const int AVATAR_QUERY_PACKET_SIZE = sizeof(glm::vec3) + sizeof(glm::quat) + 4 * sizeof(float);
+    auto avatarQueryPacket = NLPacket::create(PacketType::AvatarQuery, AVATAR_QUERY_PACKET_SIZE);
+    avatarQueryPacket->writePrimitive(_viewFrustum.getPosition());
+    avatarQueryPacket->writePrimitive(_viewFrustum.getOrientation());
+    avatarQueryPacket->writePrimitive(_viewFrustum.getFieldOfView());
+    avatarQueryPacket->writePrimitive(_viewFrustum.getAspectRatio());
+    avatarQueryPacket->writePrimitive(_viewFrustum.getNearClip());
+    avatarQueryPacket->writePrimitive(_viewFrustum.getFarClip());
+
+    nodeList->sendPacket(std::move(avatarQueryPacket), *avatarMixer);
+}
+
 
 bool Application::isHMDMode() const {
     return getActiveDisplayPlugin()->isHmd();
@@ -4203,6 +4296,7 @@ bool Application::acceptURL(const QString& urlString, bool defaultUpload) {
 void Application::setSessionUUID(const QUuid& sessionUUID) {
     // HACK: until we swap the library dependency order between physics and entities
     // we cache the sessionID in two distinct places for physics.
+    finishPhysicsStep();
     Physics::setSessionUUID(sessionUUID); // TODO: remove this one
     _physicsEngine->setSessionUUID(sessionUUID);
 }
@@ -4594,6 +4688,7 @@ void Application::checkSkeleton() {
 
         getMyAvatar()->useFullAvatarURL(AvatarData::defaultFullAvatarModelUrl(), DEFAULT_FULL_AVATAR_MODEL_NAME);
     } else {
+        finishPhysicsStep();
         _physicsEngine->setCharacterController(getMyAvatar()->getCharacterController());
     }
 }
@@ -4686,6 +4781,17 @@ int Application::getMaxOctreePacketsPerSecond() {
     return _maxOctreePPS;
 }
 
+void Application::setMaxUiFps(int maxFps) {
+    if (maxFps != maxUiFps.get()) {
+        maxUiFps.set(maxFps);
+        DependencyManager::get<OffscreenUi>()->setMaxFps(maxFps);
+    }
+}
+
+int Application::getMaxUiFps() {
+    return maxUiFps.get();
+}
+
 qreal Application::getDevicePixelRatio() {
     return (_window && _window->windowHandle()) ? _window->windowHandle()->devicePixelRatio() : 1.0;
 }
@@ -4842,6 +4948,8 @@ void Application::updateDisplayMode() {
     oldDisplayPlugin = _displayPlugin;
     _displayPlugin = newDisplayPlugin;
 
+    updateRenderScaleTarget(_renderEngine, _displayPlugin);
+
     // If the displayPlugin is a screen based HMD, then it will want the HMDTools displayed
     // Direct Mode HMDs (like windows Oculus) will be isHmd() but will have a screen of -1
     bool newPluginWantsHMDTools = newDisplayPlugin ?
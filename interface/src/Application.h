@@ -14,10 +14,12 @@
 
 #include <functional>
 
+#include <QtCore/QFuture>
 #include <QtCore/QHash>
 #include <QtCore/QPointer>
 #include <QtCore/QSet>
 #include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
 
 #include <QtGui/QImage>
 
@@ -28,6 +30,7 @@
 #include <AbstractViewStateInterface.h>
 #include <EntityEditPacketSender.h>
 #include <EntityTreeRenderer.h>
+#include <HullCache.h>
 #include <input-plugins/KeyboardMouseDevice.h>
 #include <OctreeQuery.h>
 #include <PhysicalEntitySimulation.h>
@@ -205,6 +208,9 @@ public:
     void setMaxOctreePacketsPerSecond(int maxOctreePPS);
     int getMaxOctreePacketsPerSecond();
 
+    void setMaxUiFps(int maxUiFps);
+    int getMaxUiFps();
+
     render::ScenePointer getMain3DScene() override { return _main3DScene; }
     render::ScenePointer getMain3DScene() const { return _main3DScene; }
     render::EnginePointer getRenderEngine() override { return _renderEngine; }
@@ -334,9 +340,12 @@ private:
     // Various helper functions called during update()
     void updateLOD();
     void updateThreads(float deltaTime);
+    void startPhysicsStep();
+    void finishPhysicsStep();
     void updateDialogs(float deltaTime);
 
     void queryOctree(NodeType_t serverType, PacketType packetType, NodeToJurisdictionMap& jurisdictions);
+    void queryAvatars();
     void loadViewFrustum(Camera& camera, ViewFrustum& viewFrustum);
 
     glm::vec3 getSunDirection();
@@ -407,9 +416,17 @@ private:
     float _lastUnsynchronizedFps { 0.0f };
 
     ShapeManager _shapeManager;
+    HullCache _hullCache;
     PhysicalEntitySimulation _entitySimulation;
     PhysicsEnginePointer _physicsEngine;
 
+    // physics steps on its own thread, from the end of one update() to the start of the next
+    QThreadPool _physicsThread;
+    QFuture<void> _physicsStep;
+    VectorOfMotionStates _physicsOutgoingChanges;
+    CollisionEvents _physicsCollisionEvents;
+    bool _physicsHasOutgoingChanges { false };
+
     EntityTreeRenderer _entityClipboardRenderer;
     EntityTreePointer _entityClipboard;
 
@@ -433,6 +450,7 @@ private:
 
     Setting::Handle<QString> _previousScriptLocation;
     Setting::Handle<float> _fieldOfView;
+    Setting::Handle<float> _physicsInterestRadius;
 
     float _scaleMirror;
     float _rotateMirror;
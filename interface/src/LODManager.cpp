@@ -32,6 +32,11 @@ void LODManager::setRenderDistanceInverseHighLimit(float newValue) {
     _renderDistanceController.setControlledValueHighLimit(newValue);
 }
 
+// the items rendered in the main pass since the controllers last looked, and the distance the PID renders them within
+static float renderDistance = (float)TREE_SCALE;
+static int renderedCount = 0;
+static int lastRenderedCount = 0;
+
 LODManager::LODManager() {
 
     setRenderDistanceInverseHighLimit(renderDistanceInverseHighLimit.get());
@@ -59,141 +64,92 @@ float LODManager::getLODIncreaseFPS() {
     return getDesktopLODIncreaseFPS();
 }
 
-void LODManager::autoAdjustLOD(float currentFPS) {
-    
-    // NOTE: our first ~100 samples at app startup are completely all over the place, and we don't
-    // really want to count them in our average, so we will ignore the real frame rates and stuff
-    // our moving average with simulated good data
-    const int IGNORE_THESE_SAMPLES = 100;
-    if (_fpsAverageUpWindow.getSampleCount() < IGNORE_THESE_SAMPLES) {
-        currentFPS = ASSUMED_FPS;
-        _lastStable = _lastUpShift = _lastDownShift = usecTimestampNow();
-    }
-    
-    _fpsAverageStartWindow.updateAverage(currentFPS);
-    _fpsAverageDownWindow.updateAverage(currentFPS);
-    _fpsAverageUpWindow.updateAverage(currentFPS);
-    
+void LODManager::autoAdjustLOD(float renderTime) {
     quint64 now = usecTimestampNow();
+    int frameItems = renderedCount;
+    renderedCount = 0;
 
-    bool changed = false;
-    quint64 elapsedSinceDownShift = now - _lastDownShift;
-    quint64 elapsedSinceUpShift = now - _lastUpShift;
+    // NOTE: our first frames at app startup or after a reset are completely all over the place, so we don't
+    // adjust anything until they are over
+    if (_lastReset == 0) {
+        _lastReset = now;
+    }
+    if (now - _lastReset < START_SHIFT_ELPASED) {
+        _lastAdjust = now;
+        return;
+    }
 
-    quint64 lastStableOrUpshift = glm::max(_lastUpShift, _lastStable);
-    quint64 elapsedSinceStableOrUpShift = now - lastStableOrUpshift;
-    
-    if (_automaticLODAdjust) {
-    
-        // LOD Downward adjustment 
-        // If we've been downshifting, we watch a shorter downshift window so that we will quickly move toward our
-        // target frame rate. But if we haven't just done a downshift (either because our last shift was an upshift,
-        // or because we've just started out) then we look at a much longer window to consider whether or not to start
-        // downshifting.
-        bool doDownShift = false; 
-
-        if (_isDownshifting) {
-            // only consider things if our DOWN_SHIFT time has elapsed...
-            if (elapsedSinceDownShift > DOWN_SHIFT_ELPASED) {
-                doDownShift = _fpsAverageDownWindow.getAverage() < getLODDecreaseFPS();
-                
-                if (!doDownShift) {
-                    qCDebug(interfaceapp) << "---- WE APPEAR TO BE DONE DOWN SHIFTING -----";
-                    _isDownshifting = false;
-                    _lastStable = now;
-                }
-            }
-        } else {
-            doDownShift = (elapsedSinceStableOrUpShift > START_SHIFT_ELPASED 
-                                && _fpsAverageStartWindow.getAverage() < getLODDecreaseFPS());
-        }
-        
-        if (doDownShift) {
-
-            // Octree items... stepwise adjustment
-            if (_octreeSizeScale > ADJUST_LOD_MIN_SIZE_SCALE) {
-                _octreeSizeScale *= ADJUST_LOD_DOWN_BY;
-                if (_octreeSizeScale < ADJUST_LOD_MIN_SIZE_SCALE) {
-                    _octreeSizeScale = ADJUST_LOD_MIN_SIZE_SCALE;
-                }
-                changed = true;
-            }
-
-            if (changed) {
-                if (_isDownshifting) {
-                    // subsequent downshift
-                    qCDebug(interfaceapp) << "adjusting LOD DOWN..."
-                                << "average fps for last "<< DOWN_SHIFT_WINDOW_IN_SECS <<"seconds was " 
-                                << _fpsAverageDownWindow.getAverage() 
-                                << "minimum is:" << getLODDecreaseFPS() 
-                                << "elapsedSinceDownShift:" << elapsedSinceDownShift
-                                << " NEW _octreeSizeScale=" << _octreeSizeScale;
-                } else {
-                    // first downshift
-                    qCDebug(interfaceapp) << "adjusting LOD DOWN after initial delay..."
-                                << "average fps for last "<< START_DELAY_WINDOW_IN_SECS <<"seconds was " 
-                                << _fpsAverageStartWindow.getAverage() 
-                                << "minimum is:" << getLODDecreaseFPS() 
-                                << "elapsedSinceUpShift:" << elapsedSinceUpShift
-                                << " NEW _octreeSizeScale=" << _octreeSizeScale;
-                }
-
-                _lastDownShift = now;
-                _isDownshifting = true;
-
-                emit LODDecreased();
-            }
-        } else {
-    
-            // LOD Upward adjustment
-            if (elapsedSinceUpShift > UP_SHIFT_ELPASED) {
-            
-                if (_fpsAverageUpWindow.getAverage() > getLODIncreaseFPS()) {
-
-                    // Octee items... stepwise adjustment
-                    if (_octreeSizeScale < ADJUST_LOD_MAX_SIZE_SCALE) {
-                        if (_octreeSizeScale < ADJUST_LOD_MIN_SIZE_SCALE) {
-                            _octreeSizeScale = ADJUST_LOD_MIN_SIZE_SCALE;
-                        } else {
-                            _octreeSizeScale *= ADJUST_LOD_UP_BY;
-                        }
-                        if (_octreeSizeScale > ADJUST_LOD_MAX_SIZE_SCALE) {
-                            _octreeSizeScale = ADJUST_LOD_MAX_SIZE_SCALE;
-                        }
-                        changed = true;
-                    }
-                }
-        
-                if (changed) {
-                    qCDebug(interfaceapp) << "adjusting LOD UP... average fps for last "<< UP_SHIFT_WINDOW_IN_SECS <<"seconds was " 
-                                << _fpsAverageUpWindow.getAverage()
-                                << "upshift point is:" << getLODIncreaseFPS() 
-                                << "elapsedSinceUpShift:" << elapsedSinceUpShift
-                                << " NEW _octreeSizeScale=" << _octreeSizeScale;
-
-                    _lastUpShift = now;
-                    _isDownshifting = false;
-
-                    emit LODIncreased();
-                }
-            }
-        }
-    
-        if (changed) {
-            auto lodToolsDialog = DependencyManager::get<DialogsManager>()->getLodToolsDialog();
-            if (lodToolsDialog) {
-                lodToolsDialog->reloadSliders();
-            }
-        }
+    _adjustFrames++;
+    _renderTimeSum += renderTime;
+    _renderedItemsSum += frameItems;
+    if (now - _lastAdjust < ADJUST_ELPASED) {
+        return;
+    }
+
+    float averageRenderTime = _renderTimeSum / _adjustFrames;
+    float averageRenderedItems = (float)_renderedItemsSum / _adjustFrames;
+    _lastAdjust = now;
+    _adjustFrames = 0;
+    _renderTimeSum = 0.0f;
+    _renderedItemsSum = 0;
+
+    if (!_automaticLODAdjust || averageRenderTime <= 0.0f) {
+        return;
+    }
+
+    // Rather than stepping the LOD while the frame rate is off and waiting to see what that did, predict the LOD that
+    // renders in the target time: the items rendered are estimated to take the same time each, and their number to
+    // grow with the square of the octree size scale, since that scales the distance they are seen from.
+    const float ITEM_RENDER_TIME_SMOOTHING = 0.25f;
+    float targetRenderTime = (float)MSECS_PER_SECOND / getLODIncreaseFPS();
+    float predictedRenderTime;
+    float adjustBy;
+    if (averageRenderedItems > 0.0f) {
+        float itemRenderTime = averageRenderTime / averageRenderedItems;
+        _itemRenderTime = (_itemRenderTime > 0.0f) ?
+            glm::mix(_itemRenderTime, itemRenderTime, ITEM_RENDER_TIME_SMOOTHING) : itemRenderTime;
+        predictedRenderTime = _itemRenderTime * averageRenderedItems;
+        adjustBy = sqrtf(targetRenderTime / predictedRenderTime);
+    } else {
+        // nothing seen to estimate the time of the items by
+        predictedRenderTime = averageRenderTime;
+        adjustBy = (averageRenderTime < targetRenderTime) ? MAX_ADJUST_LOD_UP_BY : 1.0f;
+    }
+
+    if (fabsf(predictedRenderTime - targetRenderTime) < ADJUST_LOD_TOLERANCE * targetRenderTime) {
+        return;
+    }
+
+    adjustBy = glm::clamp(adjustBy, MAX_ADJUST_LOD_DOWN_BY, MAX_ADJUST_LOD_UP_BY);
+    float oldOctreeSizeScale = _octreeSizeScale;
+    _octreeSizeScale = glm::clamp(_octreeSizeScale * adjustBy, ADJUST_LOD_MIN_SIZE_SCALE, ADJUST_LOD_MAX_SIZE_SCALE);
+    if (_octreeSizeScale == oldOctreeSizeScale) {
+        return;
+    }
+
+    qCDebug(interfaceapp) << "adjusting LOD" << (_octreeSizeScale < oldOctreeSizeScale ? "DOWN..." : "UP...")
+                          << "average render time for last" << ADJUST_WINDOW_IN_SECS << "seconds was" << averageRenderTime
+                          << "predicted:" << predictedRenderTime << "target:" << targetRenderTime
+                          << "rendered items:" << averageRenderedItems
+                          << " NEW _octreeSizeScale=" << _octreeSizeScale;
+
+    if (_octreeSizeScale < oldOctreeSizeScale) {
+        emit LODDecreased();
+    } else {
+        emit LODIncreased();
+    }
+
+    auto lodToolsDialog = DependencyManager::get<DialogsManager>()->getLodToolsDialog();
+    if (lodToolsDialog) {
+        lodToolsDialog->reloadSliders();
     }
 }
 
 void LODManager::resetLODAdjust() {
-    _fpsAverageStartWindow.reset();
-    _fpsAverageDownWindow.reset();
-    _fpsAverageUpWindow.reset();
-    _lastUpShift = _lastDownShift = usecTimestampNow();
-    _isDownshifting = false;
+    _lastReset = _lastAdjust = usecTimestampNow();
+    _adjustFrames = 0;
+    _renderTimeSum = 0.0f;
+    _renderedItemsSum = 0;
 }
 
 QString LODManager::getLODFeedbackText() {
@@ -234,9 +190,6 @@ QString LODManager::getLODFeedbackText() {
     return result;
 }
 
-static float renderDistance = (float)TREE_SCALE;
-static int renderedCount = 0;
-static int lastRenderedCount = 0;
 bool LODManager::getUseAcuity() { return lodPreference.get() == (int)LODManager::LODPreference::acuity; }
 void LODManager::setUseAcuity(bool newValue) { lodPreference.set(newValue ? (int)LODManager::LODPreference::acuity : (int)LODManager::LODPreference::pid); }
 float LODManager::getRenderDistance() {
@@ -284,7 +237,11 @@ bool LODManager::shouldRender(const RenderArgs* args, const AABox& bounds) {
     // FIXME - eventually we want to use the render accuracy as an indicator for the level of detail
     // to use in rendering.
     float renderAccuracy = args->_viewFrustum->calculateRenderAccuracy(bounds, args->_sizeScale, args->_boundaryLevelAdjust);
-    return (renderAccuracy > 0.0f);
+    bool isRendered = (renderAccuracy > 0.0f);
+    if (isRendered && args->_renderMode == RenderArgs::DEFAULT_RENDER_MODE) {
+        renderedCount++;
+    }
+    return isRendered;
 };
 
 void LODManager::setOctreeSizeScale(float sizeScale) {
@@ -24,21 +24,17 @@ const float MAX_LIKELY_DESKTOP_FPS = 59.0; // this is essentially, V-synch - 1 f
 const float MAX_LIKELY_HMD_FPS = 74.0; // this is essentially, V-synch - 1 fps
 const float INCREASE_LOD_GAP = 15.0f;
 
-const float START_DELAY_WINDOW_IN_SECS = 3.0f; // wait at least this long after steady state/last upshift to consider downshifts
-const float DOWN_SHIFT_WINDOW_IN_SECS = 0.5f;
-const float UP_SHIFT_WINDOW_IN_SECS = 2.5f;
+const float START_DELAY_WINDOW_IN_SECS = 3.0f; // wait at least this long after starting or a reset to adjust the LOD
+const float ADJUST_WINDOW_IN_SECS = 0.5f; // the render times are averaged over this long between adjustments
 
-const int ASSUMED_FPS = 60;
 const quint64 START_SHIFT_ELPASED = USECS_PER_SECOND * START_DELAY_WINDOW_IN_SECS;
-const quint64 DOWN_SHIFT_ELPASED = USECS_PER_SECOND * DOWN_SHIFT_WINDOW_IN_SECS; // Consider adjusting LOD down after half a second
-const quint64 UP_SHIFT_ELPASED = USECS_PER_SECOND * UP_SHIFT_WINDOW_IN_SECS;
+const quint64 ADJUST_ELPASED = USECS_PER_SECOND * ADJUST_WINDOW_IN_SECS;
 
-const int START_DELAY_SAMPLES_OF_FRAMES = ASSUMED_FPS * START_DELAY_WINDOW_IN_SECS;
-const int DOWN_SHIFT_SAMPLES_OF_FRAMES = ASSUMED_FPS * DOWN_SHIFT_WINDOW_IN_SECS;
-const int UP_SHIFT_SAMPLES_OF_FRAMES = ASSUMED_FPS * UP_SHIFT_WINDOW_IN_SECS;
-
-const float ADJUST_LOD_DOWN_BY = 0.9f;
-const float ADJUST_LOD_UP_BY = 1.1f;
+// The LOD is only adjusted once the predicted render time is off its target by more than this share of it, and then
+// by no more than these factors at a time
+const float ADJUST_LOD_TOLERANCE = 0.1f;
+const float MAX_ADJUST_LOD_DOWN_BY = 0.5f;
+const float MAX_ADJUST_LOD_UP_BY = 1.25f;
 
 // This controls how low the auto-adjust LOD will go a value of 1 means it will adjust to a point where you must be 0.25
 // meters away from an object of TREE_SCALE before you can see it (which is effectively completely blind). The default value
@@ -98,7 +94,9 @@ public:
     QString getLODStatsRenderText();
 
     static bool shouldRender(const RenderArgs* args, const AABox& bounds);
-    void autoAdjustLOD(float currentFPS);
+
+    // renderTime is the longer of the CPU and GPU times of the last frame, in msecs
+    void autoAdjustLOD(float renderTime);
     
     void loadSettings();
     void saveSettings();
@@ -118,14 +116,15 @@ private:
     float _octreeSizeScale = DEFAULT_OCTREE_SIZE_SCALE;
     int _boundaryLevelAdjust = 0;
     
-    quint64 _lastDownShift = 0;
-    quint64 _lastUpShift = 0;
-    quint64 _lastStable = 0;
-    bool _isDownshifting = false; // start out as if we're not downshifting
-    
-    SimpleMovingAverage _fpsAverageStartWindow = START_DELAY_SAMPLES_OF_FRAMES;
-    SimpleMovingAverage _fpsAverageDownWindow = DOWN_SHIFT_SAMPLES_OF_FRAMES;
-    SimpleMovingAverage _fpsAverageUpWindow = UP_SHIFT_SAMPLES_OF_FRAMES;
+    quint64 _lastReset = 0;
+    quint64 _lastAdjust = 0;
+
+    // the frames since the last adjustment
+    int _adjustFrames = 0;
+    float _renderTimeSum = 0.0f;
+    quint64 _renderedItemsSum = 0;
+
+    float _itemRenderTime = 0.0f; // the estimated msecs each rendered item takes
     
     PIDController _renderDistanceController{};
     SimpleMovingAverage _renderDistanceAverage{ 10 };
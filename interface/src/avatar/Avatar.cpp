@@ -167,6 +167,13 @@ void Avatar::animateScaleChanges(float deltaTime) {
 }
 
 void Avatar::simulate(float deltaTime) {
+    if (startSimulate(deltaTime)) {
+        animateSkeleton();
+    }
+    finishSimulate(deltaTime);
+}
+
+bool Avatar::startSimulate(float deltaTime) {
     PerformanceTimer perfTimer("simulate");
 
     if (!isDead() && !_motionState) {
@@ -177,7 +184,10 @@ void Avatar::simulate(float deltaTime) {
     // update the shouldAnimate flag to match whether or not we will render the avatar.
     const float MINIMUM_VISIBILITY_FOR_ON = 0.4f;
     const float MAXIMUM_VISIBILITY_FOR_OFF = 0.6f;
-    float visibility = qApp->getViewFrustum()->calculateRenderAccuracy(getBounds(), DependencyManager::get<LODManager>()->getOctreeSizeScale());
+    ViewFrustum* viewFrustum = qApp->getViewFrustum();
+    AABox bounds = getBounds();
+    float octreeSizeScale = DependencyManager::get<LODManager>()->getOctreeSizeScale();
+    float visibility = viewFrustum->calculateRenderAccuracy(bounds, octreeSizeScale);
     if (!_shouldAnimate) {
         if (visibility > MINIMUM_VISIBILITY_FOR_ON) {
             _shouldAnimate = true;
@@ -198,15 +208,48 @@ void Avatar::simulate(float deltaTime) {
         getHand()->simulate(deltaTime, false);
     }
 
-    if (_shouldAnimate && !_shouldSkipRender && inViewFrustum) {
-        {
-            PerformanceTimer perfTimer("skeleton");
-            _skeletonModel.getRig()->copyJointsFromJointData(_jointData);
-            _skeletonModel.simulate(deltaTime, _hasNewJointRotations || _hasNewJointTranslations);
-            locationChanged(); // joints changed, so if there are any children, update them.
-            _hasNewJointRotations = false;
-            _hasNewJointTranslations = false;
+    // The farther out within the distance the LOD draws it at, the fewer the frames the skeleton is animated in,
+    // over the time of the frames since
+    _isAnimatingSkeleton = _shouldAnimate && !_shouldSkipRender && inViewFrustum;
+    if (_isAnimatingSkeleton) {
+        int framesPerAnimation = 1;
+        if (!isMyAvatar()) {
+            const float HALF_RATE_DISTANCE_RATIO = 0.125f;
+            const float QUARTER_RATE_DISTANCE_RATIO = 0.25f;
+            float distanceRatio = glm::length(bounds.calcCenter() - viewFrustum->getPosition()) /
+                viewFrustum->calculateRenderDistance(bounds, octreeSizeScale);
+            if (distanceRatio > QUARTER_RATE_DISTANCE_RATIO) {
+                framesPerAnimation = 4;
+            } else if (distanceRatio > HALF_RATE_DISTANCE_RATIO) {
+                framesPerAnimation = 2;
+            }
+        }
+        _skeletonDeltaTime += deltaTime;
+        if (--_framesUntilAnimateSkeleton > 0) {
+            _isAnimatingSkeleton = false;
+        } else {
+            _framesUntilAnimateSkeleton = framesPerAnimation;
         }
+    } else {
+        _skeletonDeltaTime = 0.0f;
+        _framesUntilAnimateSkeleton = 0;
+    }
+    return _isAnimatingSkeleton;
+}
+
+void Avatar::animateSkeleton() {
+    PerformanceTimer perfTimer("skeleton");
+    _skeletonModel.getRig()->copyJointsFromJointData(_jointData);
+    _skeletonModel.simulate(_skeletonDeltaTime, _hasNewJointRotations || _hasNewJointTranslations);
+    _hasNewJointRotations = false;
+    _hasNewJointTranslations = false;
+}
+
+void Avatar::finishSimulate(float deltaTime) {
+    PerformanceTimer perfTimer("simulate");
+
+    if (_isAnimatingSkeleton) {
+        locationChanged(); // joints changed, so if there are any children, update them.
         {
             PerformanceTimer perfTimer("head");
             glm::vec3 headPosition = getPosition();
@@ -214,8 +257,9 @@ void Avatar::simulate(float deltaTime) {
             Head* head = getHead();
             head->setPosition(headPosition);
             head->setScale(getUniformScale());
-            head->simulate(deltaTime, false, _shouldAnimate);
+            head->simulate(_skeletonDeltaTime, false, _shouldAnimate);
         }
+        _skeletonDeltaTime = 0.0f;
     }
 
     // update animation for display name fade in/out
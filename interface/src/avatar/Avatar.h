@@ -66,6 +66,13 @@ public:
 
     void init();
     void simulate(float deltaTime);
+
+    // The steps of simulate, so that the skeletons of the avatars can be animated all at once on the worker threads.
+    // The first and the last steps are on the main thread, the animation of a skeleton only reads its avatar and
+    // only writes its rig and skeleton model, and is only there when the first step returns true
+    bool startSimulate(float deltaTime);
+    void animateSkeleton();
+    void finishSimulate(float deltaTime);
     virtual void simulateAttachments(float deltaTime);
 
     virtual void render(RenderArgs* renderArgs, const glm::vec3& cameraPosition);
@@ -251,6 +258,9 @@ protected:
 private:
     bool _initialized;
     bool _shouldAnimate { true };
+    bool _isAnimatingSkeleton { false };
+    int _framesUntilAnimateSkeleton { 0 };
+    float _skeletonDeltaTime { 0.0f };
     bool _shouldSkipRender { false };
     bool _isLookAtTarget;
 
@@ -12,6 +12,7 @@
 #include <string>
 
 #include <QScriptEngine>
+#include <QtConcurrent/QtConcurrentMap>
 
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic push
@@ -129,8 +130,11 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
 
     PerformanceTimer perfTimer("otherAvatars");
 
-    // simulate avatars
+    // simulate avatars, all on the main thread but for the animation of their skeletons: each skeleton only reads
+    // its own avatar, so they are animated all at once on the worker threads
     auto hashCopy = getHashCopy();
+    QVector<std::shared_ptr<Avatar>> simulatedAvatars;
+    QVector<std::shared_ptr<Avatar>> animatedAvatars;
 
     AvatarHash::iterator avatarIterator = hashCopy.begin();
     while (avatarIterator != hashCopy.end()) {
@@ -145,12 +149,26 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             ++avatarIterator;
         } else {
             avatar->startUpdate();
-            avatar->simulate(deltaTime);
-            avatar->endUpdate();
+            if (avatar->startSimulate(deltaTime)) {
+                animatedAvatars.push_back(avatar);
+            }
+            simulatedAvatars.push_back(avatar);
             ++avatarIterator;
         }
     }
 
+    {
+        PerformanceTimer perfTimer("animate");
+        QtConcurrent::blockingMap(animatedAvatars, [](std::shared_ptr<Avatar>& avatar) {
+            avatar->animateSkeleton();
+        });
+    }
+
+    for (auto& avatar : simulatedAvatars) {
+        avatar->finishSimulate(deltaTime);
+        avatar->endUpdate();
+    }
+
     // simulate avatar fades
     simulateAvatarFades(deltaTime);
 }
@@ -392,8 +392,8 @@ void MyAvatar::simulate(float deltaTime) {
         });
         // also update the position of children in our local octree
         if (moveOperator.hasMovingEntities()) {
-            PerformanceTimer perfTimer("recurseTreeWithOperator");
-            entityTree->recurseTreeWithOperator(&moveOperator);
+            PerformanceTimer perfTimer("moveEntities");
+            moveOperator.moveEntities();
         }
     }
 }
@@ -26,6 +26,7 @@
 
 #include "AmbientOcclusionEffect.h"
 #include "AntialiasingEffect.h"
+#include "RenderScale.h"
 #include "RenderShadowTask.h"
 
 void setupPreferences() {
@@ -267,6 +268,20 @@ void setupPreferences() {
         auto setter = [](bool value) { DependencyManager::get<AudioClient>()->getReceivedAudioStream().setRepetitionWithFade(value); };
         preferences->addPreference(new CheckPreference(AUDIO, "Repetition with Fade", getter, setter));
     }
+    {
+        auto getter = []()->bool {return DependencyManager::get<AudioClient>()->getReceivedAudioStream().getTimeStretch(); };
+        auto setter = [](bool value) { DependencyManager::get<AudioClient>()->getReceivedAudioStream().setTimeStretch(value); };
+        preferences->addPreference(new CheckPreference(AUDIO, "Time-Stretch Playout", getter, setter));
+    }
+    {
+        auto getter = []()->float { return DependencyManager::get<AudioClient>()->getReceivedAudioStream().getTimeStretchPercentile(); };
+        auto setter = [](float value) { DependencyManager::get<AudioClient>()->getReceivedAudioStream().setTimeStretchPercentile(value); };
+        auto preference = new SpinnerPreference(AUDIO, "Time Stretch Percentile", getter, setter);
+        preference->setMin(0.5f);
+        preference->setMax(1.0f);
+        preference->setStep(0.01f);
+        preferences->addPreference(preference);
+    }
     {
         auto getter = []()->float { return DependencyManager::get<AudioClient>()->getOutputBufferSize(); };
         auto setter = [](float value) { DependencyManager::get<AudioClient>()->setOutputBufferSize(value); };
@@ -322,6 +337,16 @@ void setupPreferences() {
         preferences->addPreference(preference);
     }
 
+    {
+        auto getter = []()->float { return qApp->getMaxUiFps(); };
+        auto setter = [](float value) { qApp->setMaxUiFps(value); };
+        auto preference = new SpinnerPreference("HMD", "User Interface Max Refresh Rate (fps)", getter, setter);
+        preference->setMin(10);
+        preference->setMax(90);
+        preference->setStep(5);
+        preferences->addPreference(preference);
+    }
+
 
     {
         auto getter = []()->float { return controller::InputDevice::getReticleMoveSpeed(); };
@@ -356,5 +381,12 @@ void setupPreferences() {
             auto preference = new CheckPreference(RENDER, "Shadows", getter, setter);
             preferences->addPreference(preference);
         }
+
+        {
+            auto getter = [renderConfig]()->bool { return renderConfig->isJobEnabled<RenderScale>(); };
+            auto setter = [renderConfig](bool enable) { renderConfig->setJobEnabled<RenderScale>(enable); };
+            auto preference = new CheckPreference(RENDER, "Dynamic Resolution", getter, setter);
+            preferences->addPreference(preference);
+        }
     }
 }
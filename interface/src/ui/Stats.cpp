@@ -24,6 +24,7 @@
 #include <OffscreenUi.h>
 #include <PerfStat.h>
 #include <plugins/DisplayPlugin.h>
+#include <ScriptEngines.h>
 
 #include "BandwidthRecorder.h"
 #include "Menu.h"
@@ -132,6 +133,25 @@ void Stats::updateStats(bool force) {
     STAT_UPDATE_FLOAT(mbpsIn, (float)bandwidthRecorder->getCachedTotalAverageInputKilobitsPerSecond() / 1000.0f, 0.01f);
     STAT_UPDATE_FLOAT(mbpsOut, (float)bandwidthRecorder->getCachedTotalAverageOutputKilobitsPerSecond() / 1000.0f, 0.01f);
 
+    // the share of their frames all the scripts take, and the script taking the most
+    if (_expanded || force) {
+        float scriptLoad = 0.0f;
+        float busiestLoad = 0.0f;
+        QString busiestScript;
+        foreach(const QVariant& scriptTime, DependencyManager::get<ScriptEngines>()->getScriptTimes()) {
+            QVariantMap scriptTimeMap = scriptTime.toMap();
+            float load = scriptTimeMap["load"].toFloat();
+            scriptLoad += load;
+            if (load > busiestLoad) {
+                busiestLoad = load;
+                busiestScript = scriptTimeMap["name"].toString();
+            }
+        }
+        STAT_UPDATE_FLOAT(scriptLoad, scriptLoad * 100.0f, 0.1f);
+        STAT_UPDATE(busiestScript, busiestScript.isEmpty() ? QString() :
+            QString("%1 %2%").arg(busiestScript).arg(busiestLoad * 100.0f, 0, 'f', 1));
+    }
+
     // Second column: ping
     SharedNodePointer audioMixerNode = nodeList->soloNodeOfType(NodeType::AudioMixer);
     SharedNodePointer avatarMixerNode = nodeList->soloNodeOfType(NodeType::AvatarMixer);
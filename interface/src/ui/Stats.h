@@ -42,6 +42,8 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, packetOutCount, 0)
     STATS_PROPERTY(float, mbpsIn, 0)
     STATS_PROPERTY(float, mbpsOut, 0)
+    STATS_PROPERTY(float, scriptLoad, 0)
+    STATS_PROPERTY(QString, busiestScript, QString())
     STATS_PROPERTY(int, audioPing, 0)
     STATS_PROPERTY(int, avatarPing, 0)
     STATS_PROPERTY(int, entitiesPing, 0)
@@ -42,13 +42,13 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, float dt,
     _frame = ::accumulateTime(_startFrame, _endFrame, _timeScale, frame, dt, _loopFlag, _id, triggersOut);
 
     // poll network anim to see if it's finished loading yet.
-    if (_networkAnim && _networkAnim->isLoaded() && _skeleton) {
-        // loading is complete, copy animation frames from network animation, then throw it away.
+    if (!_curves && _networkAnim && _networkAnim->isLoaded() && _skeleton) {
+        // loading is complete, map the joints of the animation to the skeleton.  The network animation is kept, so
+        // the cache hands the same curves to the other clips playing it.
         copyFromNetworkAnim();
-        _networkAnim.reset();
     }
 
-    if (_anim.size()) {
+    if (_curves && _curves->getNumFrames() > 0) {
         int prevIndex = (int)glm::floor(_frame);
         int nextIndex;
         if (_loopFlag && _frame >= _endFrame) {
@@ -59,15 +59,15 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, float dt,
 
         // It can be quite possible for the user to set _startFrame and _endFrame to
         // values before or past valid ranges.  We clamp the frames here.
-        int frameCount = (int)_anim.size();
+        int frameCount = _curves->getNumFrames();
         prevIndex = std::min(std::max(0, prevIndex), frameCount - 1);
         nextIndex = std::min(std::max(0, nextIndex), frameCount - 1);
 
-        const AnimPoseVec& prevFrame = _anim[prevIndex];
-        const AnimPoseVec& nextFrame = _anim[nextIndex];
+        evaluateFrame(prevIndex, _prevFrame);
+        evaluateFrame(nextIndex, _nextFrame);
         float alpha = glm::fract(_frame);
 
-        ::blend(_poses.size(), &prevFrame[0], &nextFrame[0], alpha, &_poses[0]);
+        ::blend(_poses.size(), &_prevFrame[0], &_nextFrame[0], alpha, &_poses[0]);
     }
 
     return _poses;
@@ -88,7 +88,8 @@ void AnimClip::setCurrentFrameInternal(float frame) {
 
 void AnimClip::copyFromNetworkAnim() {
     assert(_networkAnim && _networkAnim->isLoaded() && _skeleton);
-    _anim.clear();
+    _curves = _networkAnim->getCurves();
+    _retarget.clear();
 
     // build a mapping from animation joint indices to skeleton joint indices.
     // by matching joints with the same name.
@@ -96,73 +97,65 @@ void AnimClip::copyFromNetworkAnim() {
     AnimSkeleton animSkeleton(geom);
     const auto animJointCount = animSkeleton.getNumJoints();
     const auto skeletonJointCount = _skeleton->getNumJoints();
-    std::vector<int> jointMap;
-    jointMap.reserve(animJointCount);
-    for (int i = 0; i < animJointCount; i++) {
-        int skeletonJoint = _skeleton->nameToJointIndex(animSkeleton.getJointName(i));
-        if (skeletonJoint == -1) {
-            qCWarning(animation) << "animation contains joint =" << animSkeleton.getJointName(i) << " which is not in the skeleton, url =" << _url;
-        }
-        jointMap.push_back(skeletonJoint);
-    }
-
-    const int frameCount = geom.animationFrames.size();
-    _anim.resize(frameCount);
-
-    for (int frame = 0; frame < frameCount; frame++) {
 
-        const FBXAnimationFrame& fbxAnimFrame = geom.animationFrames[frame];
+    // init all joints in animation to default pose
+    // this will give us a resonable result for bones in the model skeleton but not in the animation.
+    _retarget.resize(skeletonJointCount);
+    for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
+        _retarget[skeletonJoint].defaultPose = _skeleton->getRelativeDefaultPose(skeletonJoint);
+    }
 
-        // init all joints in animation to default pose
-        // this will give us a resonable result for bones in the model skeleton but not in the animation.
-        _anim[frame].reserve(skeletonJointCount);
-        for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
-            _anim[frame].push_back(_skeleton->getRelativeDefaultPose(skeletonJoint));
+    for (int animJoint = 0; animJoint < animJointCount && animJoint < _curves->getNumJoints(); animJoint++) {
+        int skeletonJoint = _skeleton->nameToJointIndex(animSkeleton.getJointName(animJoint));
+        if (skeletonJoint == -1) {
+            qCWarning(animation) << "animation contains joint =" << animSkeleton.getJointName(animJoint) << " which is not in the skeleton, url =" << _url;
         }
 
-        for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
-            int skeletonJoint = jointMap[animJoint];
-
-            const glm::vec3& fbxAnimTrans = fbxAnimFrame.translations[animJoint];
-            const glm::quat& fbxAnimRot = fbxAnimFrame.rotations[animJoint];
-
-            // skip joints that are in the animation but not in the skeleton.
-            if (skeletonJoint >= 0 && skeletonJoint < skeletonJointCount) {
-
-                AnimPose preRot, postRot;
-                if (usePreAndPostPoseFromAnim) {
-                    preRot = animSkeleton.getPreRotationPose(animJoint);
-                    postRot = animSkeleton.getPostRotationPose(animJoint);
-                } else {
-                    // In order to support Blender, which does not have preRotation FBX support, we use the models defaultPose as the reference frame for the animations.
-                    preRot = AnimPose(glm::vec3(1.0f), _skeleton->getRelativeBindPose(skeletonJoint).rot, glm::vec3());
-                    postRot = AnimPose::identity;
-                }
-
-                // cancel out scale
-                preRot.scale = glm::vec3(1.0f);
-                postRot.scale = glm::vec3(1.0f);
-
-                AnimPose rot(glm::vec3(1.0f), fbxAnimRot, glm::vec3());
-
-                // adjust translation offsets, so large translation animatons on the reference skeleton
-                // will be adjusted when played on a skeleton with short limbs.
-                const glm::vec3& fbxZeroTrans = geom.animationFrames[0].translations[animJoint];
-                const AnimPose& relDefaultPose = _skeleton->getRelativeDefaultPose(skeletonJoint);
-                float boneLengthScale = 1.0f;
-                const float EPSILON = 0.0001f;
-                if (fabsf(glm::length(fbxZeroTrans)) > EPSILON) {
-                    boneLengthScale = glm::length(relDefaultPose.trans) / glm::length(fbxZeroTrans);
-                }
+        // skip joints that are in the animation but not in the skeleton.
+        if (skeletonJoint >= 0 && skeletonJoint < skeletonJointCount) {
+            RetargetJoint& joint = _retarget[skeletonJoint];
+            joint.animJoint = animJoint;
+
+            if (usePreAndPostPoseFromAnim) {
+                joint.preRot = animSkeleton.getPreRotationPose(animJoint);
+                joint.postRot = animSkeleton.getPostRotationPose(animJoint);
+            } else {
+                // In order to support Blender, which does not have preRotation FBX support, we use the models defaultPose as the reference frame for the animations.
+                joint.preRot = AnimPose(glm::vec3(1.0f), _skeleton->getRelativeBindPose(skeletonJoint).rot, glm::vec3());
+                joint.postRot = AnimPose::identity;
+            }
 
-                AnimPose trans = AnimPose(glm::vec3(1.0f), glm::quat(), relDefaultPose.trans + boneLengthScale * (fbxAnimTrans - fbxZeroTrans));
+            // cancel out scale
+            joint.preRot.scale = glm::vec3(1.0f);
+            joint.postRot.scale = glm::vec3(1.0f);
 
-                _anim[frame][skeletonJoint] = trans * preRot * rot * postRot;
+            // adjust translation offsets, so large translation animatons on the reference skeleton
+            // will be adjusted when played on a skeleton with short limbs.
+            joint.zeroTrans = _curves->getTranslation(animJoint, 0);
+            const float EPSILON = 0.0001f;
+            if (fabsf(glm::length(joint.zeroTrans)) > EPSILON) {
+                joint.boneLengthScale = glm::length(joint.defaultPose.trans) / glm::length(joint.zeroTrans);
             }
         }
     }
 
     _poses.resize(skeletonJointCount);
+    _prevFrame.resize(skeletonJointCount);
+    _nextFrame.resize(skeletonJointCount);
+}
+
+void AnimClip::evaluateFrame(int frame, AnimPoseVec& poses) const {
+    for (size_t i = 0; i < _retarget.size(); i++) {
+        const RetargetJoint& joint = _retarget[i];
+        if (joint.animJoint < 0) {
+            poses[i] = joint.defaultPose;
+            continue;
+        }
+        AnimPose rot(glm::vec3(1.0f), _curves->getRotation(joint.animJoint, frame), glm::vec3());
+        glm::vec3 fbxAnimTrans = _curves->getTranslation(joint.animJoint, frame);
+        AnimPose trans = AnimPose(glm::vec3(1.0f), glm::quat(), joint.defaultPose.trans + joint.boneLengthScale * (fbxAnimTrans - joint.zeroTrans));
+        poses[i] = trans * joint.preRot * rot * joint.postRot;
+    }
 }
 
 
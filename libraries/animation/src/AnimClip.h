@@ -55,15 +55,33 @@ protected:
     virtual void setCurrentFrameInternal(float frame) override;
 
     void copyFromNetworkAnim();
+    void evaluateFrame(int frame, AnimPoseVec& poses) const;
 
     // for AnimDebugDraw rendering
     virtual const AnimPoseVec& getPosesInternal() const override;
 
+    // How a joint of the skeleton is posed from the curves of its joint in the animation: the pose is
+    // trans * preRot * rot * postRot, with rot from the curve and trans from the curve scaled to the bones of the
+    // skeleton.  The joints not in the animation stay in their default pose.
+    class RetargetJoint {
+    public:
+        int animJoint { -1 };
+        AnimPose preRot;
+        AnimPose postRot;
+        AnimPose defaultPose;
+        glm::vec3 zeroTrans;
+        float boneLengthScale { 1.0f };
+    };
+
     AnimationPointer _networkAnim;
     AnimPoseVec _poses;
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
+    // the curves are shared by all the clips playing the animation, only the way to the skeleton is kept per clip
+    // _retarget[joint]
+    AnimCurvesPointer _curves;
+    std::vector<RetargetJoint> _retarget;
+    AnimPoseVec _prevFrame;
+    AnimPoseVec _nextFrame;
 
     QString _url;
     float _startFrame;
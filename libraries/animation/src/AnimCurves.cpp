@@ -0,0 +1,192 @@
+//
+//  AnimCurves.cpp
+//  libraries/animation/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimCurves.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include <FBXReader.h>
+
+// a frame is dropped when the curve between the keys around it comes within these of it: an angle in radians for the
+// rotations, and a share of the extent of the curve for the translations
+static const float ROTATION_TOLERANCE = 0.002f;
+static const float MIN_ROTATION_DOT = cosf(ROTATION_TOLERANCE * 0.5f);
+static const float TRANSLATION_TOLERANCE = 0.001f;
+
+// the most frames between two keys, which also bounds the work of dropping the frames
+static const int MAX_KEY_SPAN = 32;
+
+static const float ROTATION_UNIT = 32767.0f;
+static const float TRANSLATION_UNITS = 65535.0f;
+
+static const int MAX_FRAMES = 65536;
+
+static glm::quat interpolateRotation(const glm::quat& a, const glm::quat& b, float alpha) {
+    return glm::normalize(a * (1.0f - alpha) + b * alpha);
+}
+
+static glm::vec3 interpolateTranslation(const glm::vec3& a, const glm::vec3& b, float alpha) {
+    return a + (b - a) * alpha;
+}
+
+// The frames to keep as keys, from the decoded value of each frame and the test of a value interpolated at a frame
+// against the value the frame had before it was quantized
+template <typename T, typename Interpolate, typename Fits>
+static std::vector<uint16_t> findKeyFrames(const std::vector<T>& values, Interpolate interpolate, Fits fits) {
+    int numFrames = (int)values.size();
+    std::vector<uint16_t> keyFrames { 0 };
+    int key = 0;
+    for (int end = key + 2; end < numFrames; end++) {
+        bool isFitting = (end - key) <= MAX_KEY_SPAN;
+        for (int i = key + 1; isFitting && i < end; i++) {
+            isFitting = fits(i, interpolate(values[key], values[end], (float)(i - key) / (float)(end - key)));
+        }
+        if (!isFitting) {
+            key = end - 1;
+            keyFrames.push_back((uint16_t)key);
+        }
+    }
+    if (numFrames > 1) {
+        keyFrames.push_back((uint16_t)(numFrames - 1));
+    }
+    return keyFrames;
+}
+
+// The pair of keys around a frame and how far the frame is between them, the same key twice past the last one
+static void findKeys(const std::vector<uint16_t>& keyFrames, int frame, size_t& key, size_t& nextKey, float& alpha) {
+    auto next = std::upper_bound(keyFrames.begin(), keyFrames.end(), (uint16_t)std::max(frame, 0));
+    if (next == keyFrames.begin()) {
+        key = nextKey = 0;
+        alpha = 0.0f;
+    } else if (next == keyFrames.end()) {
+        key = nextKey = keyFrames.size() - 1;
+        alpha = 0.0f;
+    } else {
+        nextKey = next - keyFrames.begin();
+        key = nextKey - 1;
+        alpha = (float)(frame - keyFrames[key]) / (float)(keyFrames[nextKey] - keyFrames[key]);
+    }
+}
+
+AnimCurves::AnimCurves(const FBXGeometry& geometry) {
+    _numFrames = std::min(geometry.animationFrames.size(), MAX_FRAMES);
+    int numJoints = geometry.joints.size();
+    _rotations.resize(numJoints);
+    _translations.resize(numJoints);
+
+    std::vector<glm::quat> rotations(_numFrames);
+    std::vector<glm::quat> decodedRotations(_numFrames);
+    std::vector<int16_t> quantizedRotations(_numFrames * 4);
+    std::vector<glm::vec3> translations(_numFrames);
+    std::vector<glm::vec3> decodedTranslations(_numFrames);
+    std::vector<uint16_t> quantizedTranslations(_numFrames * 3);
+
+    for (int joint = 0; joint < numJoints; joint++) {
+        glm::vec3 minTranslation(FLT_MAX);
+        glm::vec3 maxTranslation(-FLT_MAX);
+        for (int frame = 0; frame < _numFrames; frame++) {
+            const FBXAnimationFrame& fbxFrame = geometry.animationFrames[frame];
+            glm::quat rotation = (joint < fbxFrame.rotations.size()) ? glm::normalize(fbxFrame.rotations[joint]) : glm::quat();
+
+            // q and -q are the same rotation, keep to the side of the frame before so the keys interpolate the short way
+            if (frame > 0 && glm::dot(rotation, rotations[frame - 1]) < 0.0f) {
+                rotation = -rotation;
+            }
+            rotations[frame] = rotation;
+            translations[frame] = (joint < fbxFrame.translations.size()) ? fbxFrame.translations[joint] : glm::vec3();
+            minTranslation = glm::min(minTranslation, translations[frame]);
+            maxTranslation = glm::max(maxTranslation, translations[frame]);
+        }
+        if (_numFrames == 0) {
+            continue;
+        }
+
+        RotationCurve& rotationCurve = _rotations[joint];
+        for (int frame = 0; frame < _numFrames; frame++) {
+            for (int i = 0; i < 4; i++) {
+                quantizedRotations[frame * 4 + i] = (int16_t)glm::round(glm::clamp(rotations[frame][i], -1.0f, 1.0f) * ROTATION_UNIT);
+            }
+            const int16_t* values = &quantizedRotations[frame * 4];
+            decodedRotations[frame] = glm::normalize(glm::quat((float)values[3], (float)values[0], (float)values[1], (float)values[2]));
+        }
+        rotationCurve.frames = findKeyFrames(decodedRotations, interpolateRotation, [&](int frame, const glm::quat& rotation) {
+            return fabsf(glm::dot(rotation, rotations[frame])) >= MIN_ROTATION_DOT;
+        });
+        rotationCurve.keys.reserve(rotationCurve.frames.size() * 4);
+        for (auto frame : rotationCurve.frames) {
+            auto values = quantizedRotations.begin() + frame * 4;
+            rotationCurve.keys.insert(rotationCurve.keys.end(), values, values + 4);
+        }
+
+        TranslationCurve& translationCurve = _translations[joint];
+        glm::vec3 extent = maxTranslation - minTranslation;
+        translationCurve.offset = minTranslation;
+        translationCurve.scale = extent / TRANSLATION_UNITS;
+        for (int frame = 0; frame < _numFrames; frame++) {
+            for (int i = 0; i < 3; i++) {
+                uint16_t key = (extent[i] > 0.0f) ?
+                    (uint16_t)glm::round((translations[frame][i] - minTranslation[i]) / translationCurve.scale[i]) : 0;
+                quantizedTranslations[frame * 3 + i] = key;
+                decodedTranslations[frame][i] = translationCurve.offset[i] + translationCurve.scale[i] * (float)key;
+            }
+        }
+        float tolerance = TRANSLATION_TOLERANCE * std::max(extent.x, std::max(extent.y, extent.z));
+        translationCurve.frames = findKeyFrames(decodedTranslations, interpolateTranslation, [&](int frame, const glm::vec3& translation) {
+            return glm::length(translation - translations[frame]) <= tolerance;
+        });
+        translationCurve.keys.reserve(translationCurve.frames.size() * 3);
+        for (auto frame : translationCurve.frames) {
+            auto values = quantizedTranslations.begin() + frame * 3;
+            translationCurve.keys.insert(translationCurve.keys.end(), values, values + 3);
+        }
+    }
+}
+
+int AnimCurves::getNumKeys() const {
+    size_t numKeys = 0;
+    for (size_t i = 0; i < _rotations.size(); i++) {
+        numKeys += _rotations[i].frames.size() + _translations[i].frames.size();
+    }
+    return (int)numKeys;
+}
+
+glm::quat AnimCurves::getRotation(int joint, int frame) const {
+    const RotationCurve& curve = _rotations[joint];
+    if (curve.frames.empty()) {
+        return glm::quat();
+    }
+    size_t key, nextKey;
+    float alpha;
+    findKeys(curve.frames, frame, key, nextKey, alpha);
+    auto decode = [&](size_t key) {
+        const int16_t* values = &curve.keys[key * 4];
+        return glm::quat((float)values[3], (float)values[0], (float)values[1], (float)values[2]);
+    };
+
+    // the keys are scaled the same, so they only need normalizing once interpolated
+    return interpolateRotation(decode(key), decode(nextKey), alpha);
+}
+
+glm::vec3 AnimCurves::getTranslation(int joint, int frame) const {
+    const TranslationCurve& curve = _translations[joint];
+    if (curve.frames.empty()) {
+        return glm::vec3();
+    }
+    size_t key, nextKey;
+    float alpha;
+    findKeys(curve.frames, frame, key, nextKey, alpha);
+    auto decode = [&](size_t key) {
+        const uint16_t* values = &curve.keys[key * 3];
+        return curve.offset + curve.scale * glm::vec3((float)values[0], (float)values[1], (float)values[2]);
+    };
+    return interpolateTranslation(decode(key), decode(nextKey), alpha);
+}
@@ -0,0 +1,63 @@
+//
+//  AnimCurves.h
+//  libraries/animation/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimCurves_h
+#define hifi_AnimCurves_h
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class FBXGeometry;
+
+// The rotations and the translations of the joints of an animation, kept once for all the clips playing it.
+// Each component is quantized to 16 bits, and a frame is only kept as a key where the curve can't be
+// interpolated through it from the keys around it.  The curves are in the frame of the animation's own joints,
+// the clips bring them to their skeletons as they sample them.
+class AnimCurves {
+public:
+    AnimCurves(const FBXGeometry& geometry);
+
+    int getNumFrames() const { return _numFrames; }
+    int getNumJoints() const { return (int)_rotations.size(); }
+
+    // the number of keys over all the curves, as many as the frames times the joints times two at most
+    int getNumKeys() const;
+
+    // the rotation and the translation of a joint of the animation at a frame, between 0 and getNumFrames() - 1
+    glm::quat getRotation(int joint, int frame) const;
+    glm::vec3 getTranslation(int joint, int frame) const;
+
+protected:
+    class RotationCurve {
+    public:
+        std::vector<uint16_t> frames;
+        std::vector<int16_t> keys; // x, y, z and w of each key, in units of 1 / 32767
+    };
+
+    class TranslationCurve {
+    public:
+        glm::vec3 offset;
+        glm::vec3 scale; // from the units of the keys
+        std::vector<uint16_t> frames;
+        std::vector<uint16_t> keys; // x, y and z of each key
+    };
+
+    int _numFrames { 0 };
+    std::vector<RotationCurve> _rotations;
+    std::vector<TranslationCurve> _translations;
+};
+
+using AnimCurvesPointer = std::shared_ptr<const AnimCurves>;
+
+#endif // hifi_AnimCurves_h
@@ -131,7 +131,7 @@ void AnimInverseKinematics::computeTargets(const AnimVariantMap& animVars, std::
     }
 }
 
-void AnimInverseKinematics::solveWithCyclicCoordinateDescent(const std::vector<IKTarget>& targets) {
+void AnimInverseKinematics::solve(const std::vector<IKTarget>& targets) {
     // compute absolute poses that correspond to relative target poses
     AnimPoseVec absolutePoses;
     absolutePoses.resize(_relativePoses.size());
@@ -150,7 +150,8 @@ void AnimInverseKinematics::solveWithCyclicCoordinateDescent(const std::vector<I
         // solve all targets
         int lowestMovedIndex = (int)_relativePoses.size();
         for (auto& target: targets) {
-            int lowIndex = solveTargetWithCCD(target, absolutePoses);
+            int lowIndex = (_solver == Solver::Fabrik) ? solveTargetWithFABRIK(target, absolutePoses) :
+                solveTargetWithCCD(target, absolutePoses);
             if (lowIndex < lowestMovedIndex) {
                 lowestMovedIndex = lowIndex;
             }
@@ -171,6 +172,11 @@ void AnimInverseKinematics::solveWithCyclicCoordinateDescent(const std::vector<I
                 absolutePoses[i] = absolutePoses[parentIndex] * _relativePoses[i];
             }
         }
+
+        // no more loops once every target is met
+        if (isSolved(targets, absolutePoses)) {
+            break;
+        }
     }
 
     // finally set the relative rotation of each tip to agree with absolute target rotation
@@ -358,6 +364,145 @@ int AnimInverseKinematics::solveTargetWithCCD(const IKTarget& target, AnimPoseVe
     return lowestMovedIndex;
 }
 
+int AnimInverseKinematics::solveTargetWithFABRIK(const IKTarget& target, AnimPoseVec& absolutePoses) {
+    IKTarget::Type targetType = target.getType();
+    if (targetType != IKTarget::Type::RotationAndPosition && targetType != IKTarget::Type::HipsRelativeRotationAndPosition) {
+        // FABRIK reaches for positions, the head still hands its rotation down the spine the CCD way
+        return solveTargetWithCCD(target, absolutePoses);
+    }
+
+    // the chain is the tip and the same pivots as for CCD, the last of which stays where it is
+    int lowestMovedIndex = (int)_relativePoses.size();
+    int tipIndex = target.getIndex();
+    int pivotIndex = _skeleton->getParentIndex(tipIndex);
+    if (pivotIndex == -1 || pivotIndex == _hipsIndex) {
+        return lowestMovedIndex;
+    }
+    int pivotsParentIndex = _skeleton->getParentIndex(pivotIndex);
+    if (pivotsParentIndex == -1) {
+        return lowestMovedIndex;
+    }
+    _chain.clear();
+    _chain.push_back(tipIndex);
+    while (pivotIndex != _hipsIndex && pivotsParentIndex != -1) {
+        _chain.push_back(pivotIndex);
+        pivotIndex = pivotsParentIndex;
+        pivotsParentIndex = _skeleton->getParentIndex(pivotIndex);
+    }
+    int numJoints = (int)_chain.size();
+    _chainPositions.resize(numJoints);
+    _chainLengths.resize(numJoints - 1);
+    for (int i = 0; i < numJoints; ++i) {
+        _chainPositions[i] = absolutePoses[_chain[i]].trans;
+        if (i > 0) {
+            _chainLengths[i - 1] = glm::length(_chainPositions[i - 1] - _chainPositions[i]);
+        }
+    }
+
+    // move the joints along the chain, from the tip onto the target back to the base and from the base back out
+    // to the tip, keeping the lengths of the bones between them
+    const float MIN_DIRECTION_LENGTH = 1.0e-4f;
+    auto follow = [&](int i, int j) {
+        glm::vec3 direction = _chainPositions[j] - _chainPositions[i];
+        float length = glm::length(direction);
+        if (length > MIN_DIRECTION_LENGTH) {
+            _chainPositions[j] = _chainPositions[i] + direction * (_chainLengths[std::min(i, j)] / length);
+        }
+    };
+    const int MAX_FABRIK_ITERATIONS = 8;
+    const float FABRIK_ERROR_FRACTION = 0.01f; // of the bone of the tip
+    glm::vec3 basePosition = _chainPositions[numJoints - 1];
+    float maxError = FABRIK_ERROR_FRACTION * _chainLengths[0];
+    for (int iteration = 0; iteration < MAX_FABRIK_ITERATIONS; ++iteration) {
+        if (glm::length(_chainPositions[0] - target.getTranslation()) < maxError) {
+            break;
+        }
+        _chainPositions[0] = target.getTranslation();
+        for (int i = 1; i < numJoints; ++i) {
+            follow(i - 1, i);
+        }
+        _chainPositions[numJoints - 1] = basePosition;
+        for (int i = numJoints - 1; i > 0; --i) {
+            follow(i, i - 1);
+        }
+    }
+
+    // turn the pivots from the base out so each bone points at the position found for the joint at its end,
+    // the pose of each pivot is built on the turned pose of its parent
+    AnimPose parentPose = absolutePoses[_skeleton->getParentIndex(_chain[numJoints - 1])];
+    for (int i = numJoints - 1; i > 0; --i) {
+        int index = _chain[i];
+        AnimPose pose = parentPose * _relativePoses[index];
+        glm::vec3 leverArm = pose * _relativePoses[_chain[i - 1]].trans - pose.trans;
+        glm::vec3 targetLine = _chainPositions[i - 1] - pose.trans;
+
+        const float MIN_AXIS_LENGTH = 1.0e-4f;
+        RotationConstraint* constraint = getConstraint(index);
+        if (constraint && constraint->isLowerSpine()) {
+            // for these types of targets we only allow twist at the lower-spine, as with CCD
+            glm::vec3 twistAxis = pose.trans - parentPose.trans;
+            float twistAxisLength = glm::length(twistAxis);
+            if (twistAxisLength > MIN_AXIS_LENGTH) {
+                twistAxis /= twistAxisLength;
+                leverArm -= glm::dot(leverArm, twistAxis) * twistAxis;
+                targetLine -= glm::dot(targetLine, twistAxis) * twistAxis;
+            } else {
+                leverArm = Vectors::ZERO;
+                targetLine = Vectors::ZERO;
+            }
+        }
+
+        glm::quat deltaRotation;
+        if (glm::length(leverArm) > MIN_AXIS_LENGTH && glm::length(targetLine) > MIN_AXIS_LENGTH) {
+            deltaRotation = rotationBetween(leverArm, targetLine);
+        }
+
+        // Q' = dQ * Q   and   Q = Qp * q   -->   q' = Qp^ * dQ * Q
+        glm::quat newRot = glm::normalize(glm::inverse(parentPose.rot) * deltaRotation * pose.rot);
+        if (constraint) {
+            constraint->apply(newRot);
+        }
+        _accumulators[index].add(newRot, target.getWeight());
+        if (index < lowestMovedIndex) {
+            lowestMovedIndex = index;
+        }
+
+        parentPose = parentPose * AnimPose(_relativePoses[index].scale, newRot, _relativePoses[index].trans);
+    }
+    return lowestMovedIndex;
+}
+
+bool AnimInverseKinematics::isSolved(const std::vector<IKTarget>& targets, const AnimPoseVec& absolutePoses) const {
+    const float POSITION_ERROR_FRACTION = 0.01f; // of the bone of the tip
+    const float MIN_ROTATION_DOT = 0.99995f; // within 0.01 radians
+    for (auto& target: targets) {
+        int tipIndex = target.getIndex();
+        int parentIndex = _skeleton->getParentIndex(tipIndex);
+        if (parentIndex == -1) {
+            continue;
+        }
+        switch (target.getType()) {
+        case IKTarget::Type::RotationAndPosition:
+        case IKTarget::Type::HipsRelativeRotationAndPosition: {
+            float maxError = POSITION_ERROR_FRACTION * glm::length(absolutePoses[tipIndex].trans - absolutePoses[parentIndex].trans);
+            if (glm::length(absolutePoses[tipIndex].trans - target.getTranslation()) > maxError) {
+                return false;
+            }
+            break;
+        }
+        case IKTarget::Type::HmdHead:
+            if (fabsf(glm::dot(absolutePoses[tipIndex].rot, target.getRotation())) < MIN_ROTATION_DOT) {
+                return false;
+            }
+            break;
+        default:
+            // the rotations are enforced after the loops
+            break;
+        }
+    }
+    return true;
+}
+
 //virtual
 const AnimPoseVec& AnimInverseKinematics::evaluate(const AnimVariantMap& animVars, float dt, AnimNode::Triggers& triggersOut) {
     // don't call this function, call overlay() instead
@@ -429,7 +574,7 @@ const AnimPoseVec& AnimInverseKinematics::overlay(const AnimVariantMap& animVars
                 }
             }
 
-            solveWithCyclicCoordinateDescent(targets);
+            solve(targets);
 
             // measure new _hipsOffset for next frame
             // by looking for discrepancies between where a targeted endEffector is
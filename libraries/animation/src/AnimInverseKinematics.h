@@ -25,6 +25,13 @@ class RotationConstraint;
 class AnimInverseKinematics : public AnimNode {
 public:
 
+    // CCD turns the joints of a chain one after the other towards the target, FABRIK reaches the target with the
+    // positions of the joints first and turns the joints to them after.  Both go through the same constraints.
+    enum class Solver {
+        CyclicCoordinateDescent = 0,
+        Fabrik
+    };
+
     AnimInverseKinematics(const QString& id);
     virtual ~AnimInverseKinematics() override;
 
@@ -34,13 +41,18 @@ public:
 
     void setTargetVars(const QString& jointName, const QString& positionVar, const QString& rotationVar, const QString& typeVar);
 
+    void setSolver(Solver solver) { _solver = solver; }
+    Solver getSolver() const { return _solver; }
+
     virtual const AnimPoseVec& evaluate(const AnimVariantMap& animVars, float dt, AnimNode::Triggers& triggersOut) override;
     virtual const AnimPoseVec& overlay(const AnimVariantMap& animVars, float dt, Triggers& triggersOut, const AnimPoseVec& underPoses) override;
 
 protected:
     void computeTargets(const AnimVariantMap& animVars, std::vector<IKTarget>& targets, const AnimPoseVec& underPoses);
-    void solveWithCyclicCoordinateDescent(const std::vector<IKTarget>& targets);
+    void solve(const std::vector<IKTarget>& targets);
     int solveTargetWithCCD(const IKTarget& target, AnimPoseVec& absolutePoses);
+    int solveTargetWithFABRIK(const IKTarget& target, AnimPoseVec& absolutePoses);
+    bool isSolved(const std::vector<IKTarget>& targets, const AnimPoseVec& absolutePoses) const;
     virtual void setSkeletonInternal(AnimSkeleton::ConstPointer skeleton) override;
 
     // for AnimDebugDraw rendering
@@ -88,6 +100,14 @@ protected:
     // _maxTargetIndex is tracked to help optimize the recalculation of absolute poses
     // during the the cyclic coordinate descent algorithm
     int _maxTargetIndex { 0 };
+
+    Solver _solver { Solver::CyclicCoordinateDescent };
+
+    // the joints of the chain being solved by FABRIK from the tip down, with their positions and the lengths of
+    // the bones between them, kept to not allocate them for each target
+    std::vector<int> _chain;
+    std::vector<glm::vec3> _chainPositions;
+    std::vector<float> _chainLengths;
 };
 
 #endif // hifi_AnimInverseKinematics_h
@@ -8,13 +8,18 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cstddef>
+
 #include "AnimUtil.h"
+#include "CPUDetect.h"
 #include "GLMHelpers.h"
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
+// the kernels read and write a pose as the ten floats of its scale, rotation and translation
+static_assert(sizeof(AnimPose) == 10 * sizeof(float), "AnimPose is not packed");
+static_assert(offsetof(AnimPose, rot) == 3 * sizeof(float) && offsetof(AnimPose, trans) == 7 * sizeof(float),
+    "AnimPose is not laid out as scale, rot and trans");
 
-void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+void blendScalar(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
     for (size_t i = 0; i < numPoses; i++) {
         const AnimPose& aPose = a[i];
         const AnimPose& bPose = b[i];
@@ -33,6 +38,94 @@ void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, A
     }
 }
 
+// Each pose is blended in three registers: its scale and the first float of its rotation, its rotation, and the last
+// float of its rotation and its translation. The rotation is stored last, over the floats the others share with it,
+// so the loads stay within the pose and the result can be one of the inputs
+
+#if defined(ARCH_X86)
+
+#include <emmintrin.h>
+
+static inline __m128 sumLanes(__m128 v) {
+    __m128 sums = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(sums, _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    const __m128 alphas = _mm_set1_ps(alpha);
+    const __m128 signBits = _mm_set1_ps(-0.0f);
+    for (size_t i = 0; i < numPoses; i++) {
+        const float* aFloats = &a[i].scale.x;
+        const float* bFloats = &b[i].scale.x;
+        float* resultFloats = &result[i].scale.x;
+
+        __m128 aScale = _mm_loadu_ps(aFloats);
+        __m128 aRot = _mm_loadu_ps(aFloats + 3);
+        __m128 aTrans = _mm_loadu_ps(aFloats + 6);
+        __m128 bScale = _mm_loadu_ps(bFloats);
+        __m128 bRot = _mm_loadu_ps(bFloats + 3);
+        __m128 bTrans = _mm_loadu_ps(bFloats + 6);
+
+        // adjust signs if necessary, then nlerp
+        __m128 flip = _mm_and_ps(_mm_cmplt_ps(sumLanes(_mm_mul_ps(aRot, bRot)), _mm_setzero_ps()), signBits);
+        bRot = _mm_xor_ps(bRot, flip);
+        __m128 rot = _mm_add_ps(aRot, _mm_mul_ps(_mm_sub_ps(bRot, aRot), alphas));
+        rot = _mm_div_ps(rot, _mm_sqrt_ps(sumLanes(_mm_mul_ps(rot, rot))));
+
+        _mm_storeu_ps(resultFloats, _mm_add_ps(aScale, _mm_mul_ps(_mm_sub_ps(bScale, aScale), alphas)));
+        _mm_storeu_ps(resultFloats + 6, _mm_add_ps(aTrans, _mm_mul_ps(_mm_sub_ps(bTrans, aTrans), alphas)));
+        _mm_storeu_ps(resultFloats + 3, rot);
+    }
+}
+
+#elif defined(ARCH_NEON)
+
+#include <arm_neon.h>
+
+static inline float32x4_t sumLanes(float32x4_t v) {
+    float32x2_t sums = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    sums = vpadd_f32(sums, sums);
+    return vcombine_f32(sums, sums);
+}
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    const uint32x4_t signBits = vdupq_n_u32(0x80000000);
+    for (size_t i = 0; i < numPoses; i++) {
+        const float* aFloats = &a[i].scale.x;
+        const float* bFloats = &b[i].scale.x;
+        float* resultFloats = &result[i].scale.x;
+
+        float32x4_t aScale = vld1q_f32(aFloats);
+        float32x4_t aRot = vld1q_f32(aFloats + 3);
+        float32x4_t aTrans = vld1q_f32(aFloats + 6);
+        float32x4_t bScale = vld1q_f32(bFloats);
+        float32x4_t bRot = vld1q_f32(bFloats + 3);
+        float32x4_t bTrans = vld1q_f32(bFloats + 6);
+
+        // adjust signs if necessary, then nlerp, the reciprocal square root refined twice
+        uint32x4_t flip = vandq_u32(vcltq_f32(sumLanes(vmulq_f32(aRot, bRot)), vdupq_n_f32(0.0f)), signBits);
+        bRot = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(bRot), flip));
+        float32x4_t rot = vmlaq_n_f32(aRot, vsubq_f32(bRot, aRot), alpha);
+        float32x4_t lengthSquared = sumLanes(vmulq_f32(rot, rot));
+        float32x4_t inverseLength = vrsqrteq_f32(lengthSquared);
+        inverseLength = vmulq_f32(inverseLength, vrsqrtsq_f32(vmulq_f32(lengthSquared, inverseLength), inverseLength));
+        inverseLength = vmulq_f32(inverseLength, vrsqrtsq_f32(vmulq_f32(lengthSquared, inverseLength), inverseLength));
+        rot = vmulq_f32(rot, inverseLength);
+
+        vst1q_f32(resultFloats, vmlaq_n_f32(aScale, vsubq_f32(bScale, aScale), alpha));
+        vst1q_f32(resultFloats + 6, vmlaq_n_f32(aTrans, vsubq_f32(bTrans, aTrans), alpha));
+        vst1q_f32(resultFloats + 3, rot);
+    }
+}
+
+#else
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    blendScalar(numPoses, a, b, alpha, result);
+}
+
+#endif
+
 float accumulateTime(float startFrame, float endFrame, float timeScale, float currentFrame, float dt, bool loopFlag,
                      const QString& id, AnimNode::Triggers& triggersOut) {
 
@@ -13,9 +13,13 @@
 
 #include "AnimNode.h"
 
-// this is where the magic happens
+// this is where the magic happens: nlerp of the rotations, lerp of the scales and translations.
+// SSE2 on x86 and NEON on ARM like the MatrixKernels, result can be a or b
 void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result);
 
+// portable version, also used to check the vectorized one
+void blendScalar(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result);
+
 float accumulateTime(float startFrame, float endFrame, float timeScale, float currentFrame, float dt, bool loopFlag,
                      const QString& id, AnimNode::Triggers& triggersOut);
 
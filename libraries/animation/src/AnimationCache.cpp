@@ -16,6 +16,7 @@
 #include "AnimationLogging.h"
 
 static int animationPointerMetaTypeId = qRegisterMetaType<AnimationPointer>();
+static int animCurvesPointerMetaTypeId = qRegisterMetaType<AnimCurvesPointer>();
 
 AnimationCache::AnimationCache(QObject* parent) :
     ResourceCache(parent)
@@ -26,6 +27,12 @@ AnimationCache::AnimationCache(QObject* parent) :
 
 AnimationPointer AnimationCache::getAnimation(const QUrl& url) {
     if (QThread::currentThread() != thread()) {
+        // one that is already cached comes straight back, only a new one has to be made on the cache's thread
+        auto cached = getCachedResource(url);
+        if (cached) {
+            return cached.staticCast<Animation>();
+        }
+
         AnimationPointer result;
         QMetaObject::invokeMethod(this, "getAnimation", Qt::BlockingQueuedConnection,
             Q_RETURN_ARG(AnimationPointer, result), Q_ARG(const QUrl&, url));
@@ -59,13 +66,19 @@ void AnimationReader::run() {
         if (urlValid) {
             // Parse the FBX directly from the QNetworkReply
             FBXGeometry* fbxgeo = nullptr;
+            AnimCurvesPointer curves;
             if (_url.path().toLower().endsWith(".fbx")) {
                 fbxgeo = readFBX(_data, QVariantHash(), _url.path());
+
+                // quantize and reduce the curves here too, rather than in the first clip to play them
+                if (fbxgeo) {
+                    curves = std::make_shared<AnimCurves>(*fbxgeo);
+                }
             } else {
                 QString errorStr("usupported format");
                 emit onError(299, errorStr);
             }
-            emit onSuccess(fbxgeo);
+            emit onSuccess(fbxgeo, curves);
         } else {
             throw QString("url is invalid");
         }
@@ -110,16 +123,18 @@ const QVector<FBXAnimationFrame>& Animation::getFramesReference() const {
 void Animation::downloadFinished(const QByteArray& data) {
     // parse the animation/fbx file on a background thread.
     AnimationReader* animationReader = new AnimationReader(_url, data);
-    connect(animationReader, SIGNAL(onSuccess(FBXGeometry*)), SLOT(animationParseSuccess(FBXGeometry*)));
+    connect(animationReader, SIGNAL(onSuccess(FBXGeometry*, AnimCurvesPointer)),
+            SLOT(animationParseSuccess(FBXGeometry*, AnimCurvesPointer)));
     connect(animationReader, SIGNAL(onError(int, QString)), SLOT(animationParseError(int, QString)));
     QThreadPool::globalInstance()->start(animationReader);
 }
 
-void Animation::animationParseSuccess(FBXGeometry* geometry) {
+void Animation::animationParseSuccess(FBXGeometry* geometry, AnimCurvesPointer curves) {
 
     qCDebug(animation) << "Animation parse success" << _url.toDisplayString();
 
     _geometry.reset(geometry);
+    _curves = curves;
     finishedLoading(true);
 }
 
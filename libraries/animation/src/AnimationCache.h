@@ -20,6 +20,8 @@
 #include <FBXReader.h>
 #include <ResourceCache.h>
 
+#include "AnimCurves.h"
+
 class Animation;
 
 typedef QSharedPointer<Animation> AnimationPointer;
@@ -44,6 +46,7 @@ private:
 };
 
 Q_DECLARE_METATYPE(AnimationPointer)
+Q_DECLARE_METATYPE(AnimCurvesPointer)
 
 /// An animation loaded from the network.
 class Animation : public Resource {
@@ -55,6 +58,9 @@ public:
 
     const FBXGeometry& getGeometry() const { return *_geometry; }
 
+    /// the curves of the joints, shared by all the clips playing the animation
+    const AnimCurvesPointer& getCurves() const { return _curves; }
+
     virtual bool isLoaded() const override;
 
     
@@ -68,12 +74,13 @@ protected:
     virtual void downloadFinished(const QByteArray& data) override;
 
 protected slots:
-    void animationParseSuccess(FBXGeometry* geometry);
+    void animationParseSuccess(FBXGeometry* geometry, AnimCurvesPointer curves);
     void animationParseError(int error, QString str);
 
 private:
     
     std::unique_ptr<FBXGeometry> _geometry;
+    AnimCurvesPointer _curves;
 };
 
 /// Reads geometry in a worker thread.
@@ -85,7 +92,7 @@ public:
     virtual void run();
 
 signals:
-    void onSuccess(FBXGeometry* geometry);
+    void onSuccess(FBXGeometry* geometry, AnimCurvesPointer curves);
     void onError(int error, QString str);
 
 private:
@@ -41,6 +41,7 @@
 #include <UUID.h>
 #include <Transform.h>
 
+#include "AudioCodec.h"
 #include "AudioInjector.h"
 #include "AudioConstants.h"
 #include "PositionalAudioStream.h"
@@ -61,6 +62,8 @@ Setting::Handle<int> windowSecondsForDesiredCalcOnTooManyStarves("windowSecondsF
 Setting::Handle<int> windowSecondsForDesiredReduction("windowSecondsForDesiredReduction",
                                                       DEFAULT_WINDOW_SECONDS_FOR_DESIRED_REDUCTION);
 Setting::Handle<bool> repetitionWithFade("repetitionWithFade", DEFAULT_REPETITION_WITH_FADE);
+Setting::Handle<bool> timeStretch("timeStretch", DEFAULT_TIME_STRETCH);
+Setting::Handle<float> timeStretchPercentile("timeStretchPercentile", DEFAULT_TIME_STRETCH_PERCENTILE);
 
 AudioClient::AudioClient() :
     AbstractAudioInterface(),
@@ -123,13 +126,23 @@ AudioClient::AudioClient() :
 
     configureReverb();
 
-    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // offer our codecs to the audio mixer as soon as we can talk to it
+    connect(nodeList.data(), &LimitedNodeList::nodeActivated, this, [this](SharedNodePointer node) {
+        if (node->getType() == NodeType::AudioMixer) {
+            negotiateAudioFormat();
+        }
+    });
+
+    auto& packetReceiver = nodeList->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AudioStreamStats, &_stats, "processStreamStatsPacket");
     packetReceiver.registerListener(PacketType::AudioEnvironment, this, "handleAudioEnvironmentDataPacket");
     packetReceiver.registerListener(PacketType::SilentAudioFrame, this, "handleAudioDataPacket");
     packetReceiver.registerListener(PacketType::MixedAudio, this, "handleAudioDataPacket");
     packetReceiver.registerListener(PacketType::NoisyMute, this, "handleNoisyMutePacket");
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
+    packetReceiver.registerListener(PacketType::SelectedAudioFormat, this, "handleSelectedAudioFormat");
 }
 
 AudioClient::~AudioClient() {
@@ -151,9 +164,39 @@ void AudioClient::audioMixerKilled() {
     _hasReceivedFirstPacket = false;
     _outgoingAvatarAudioSequenceNumber = 0;
     _stats.reset();
+    _receivedAudioStream.cleanupCodec();
     emit disconnected();
 }
 
+void AudioClient::negotiateAudioFormat() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+
+    if (audioMixer) {
+        // list our codecs in order of preference, the mixer picks the first one it also has
+        QStringList codecNames = AudioCodecs::getCodecNames();
+
+        auto negotiateFormatPacket = NLPacket::create(PacketType::NegotiateAudioFormat);
+        quint8 numberOfCodecs = (quint8)codecNames.size();
+        negotiateFormatPacket->writePrimitive(numberOfCodecs);
+        foreach (const QString& codecName, codecNames) {
+            AudioCodecs::writeCodecName(*negotiateFormatPacket, codecName);
+        }
+
+        nodeList->sendPacket(std::move(negotiateFormatPacket), *audioMixer);
+    }
+}
+
+void AudioClient::handleSelectedAudioFormat(QSharedPointer<ReceivedMessage> message) {
+    QString selectedCodecName = AudioCodecs::readCodecName(*message);
+
+    // an empty selection means the mixer will keep sending raw PCM
+    const AudioCodec* selectedCodec = AudioCodecs::getCodec(selectedCodecName);
+    _receivedAudioStream.setupCodec(selectedCodec, selectedCodecName, AudioConstants::STEREO);
+
+    qDebug() << "Audio mixer selected codec" << (selectedCodec ? selectedCodecName : QString("none"));
+}
+
 
 QAudioDeviceInfo getNamedAudioDeviceForMode(QAudio::Mode mode, const QString& deviceName) {
     QAudioDeviceInfo result;
@@ -468,13 +511,16 @@ void AudioClient::handleAudioEnvironmentDataPacket(QSharedPointer<ReceivedMessag
     message->readPrimitive(&bitset);
 
     bool hasReverb = oneAtBit(bitset, HAS_REVERB_BIT);
+    bool hasMixedReverb = oneAtBit(bitset, HAS_MIXED_REVERB_BIT);
     
-    if (hasReverb) {
+    if (hasReverb && !hasMixedReverb) {
         float reverbTime, wetLevel;
         message->readPrimitive(&reverbTime);
         message->readPrimitive(&wetLevel);
         _receivedAudioStream.setReverb(reverbTime, wetLevel);
     } else {
+        // either there is no zone reverb here or it is already in the mix
+
         _receivedAudioStream.clearReverb();
    }
 }
@@ -488,6 +534,11 @@ void AudioClient::handleAudioDataPacket(QSharedPointer<ReceivedMessage> message)
         if (!_hasReceivedFirstPacket) {
             _hasReceivedFirstPacket = true;
 
+            // in case our codecs went out before the mixer was ready for them
+            if (_receivedAudioStream.getSelectedCodecName().isEmpty()) {
+                negotiateAudioFormat();
+            }
+
             // have the audio scripting interface emit a signal to say we just connected to mixer
             emit receivedFirstPacket();
         }
@@ -905,6 +956,18 @@ bool AudioClient::outputLocalInjector(bool isStereo, AudioInjector* injector) {
         QAudioFormat localFormat = _desiredOutputFormat;
         localFormat.setChannelCount(isStereo ? 2 : 1);
 
+        if (!isStereo && _positionGetter && _orientationGetter) {
+            // a mono sound is placed around the listener here, as the audio-mixer would if it were sent there
+            auto positionGetter = _positionGetter;
+            auto orientationGetter = _orientationGetter;
+            injector->getLocalBuffer()->setSpatialized(injector->getOptions().position,
+                                                       [=](glm::vec3& position, glm::quat& orientation) {
+                position = positionGetter();
+                orientation = orientationGetter();
+            });
+            localFormat.setChannelCount(2);
+        }
+
         QAudioOutput* localOutput = new QAudioOutput(getNamedAudioDeviceForMode(QAudio::AudioOutput, _outputAudioDeviceName),
                                                      localFormat,
                                                      injector->getLocalBuffer());
@@ -1035,6 +1098,18 @@ void AudioClient::outputNotify() {
                     }
                 }
             }
+            _lastOutputStarveTimeMsec = now;
+        }
+    } else if (_outputStarveDetectionEnabled.get() && _outputBufferSizeFrames.get() > DEFAULT_AUDIO_OUTPUT_BUFFER_SIZE_FRAMES) {
+        // the frames a rough patch added to the buffer are latency once it is over, they are taken back a frame at a time
+        quint64 now = usecTimestampNow() / 1000;
+        if (now - _lastOutputStarveTimeMsec > AUDIO_OUTPUT_BUFFER_SHRINK_PERIOD) {
+            _lastOutputStarveTimeMsec = now;
+
+            int newOutputBufferSizeFrames = _outputBufferSizeFrames.get() - 1;
+            qCDebug(audioclient) << "No starves for" << AUDIO_OUTPUT_BUFFER_SHRINK_PERIOD / 1000 << "seconds, decreasing buffer size to"
+                << newOutputBufferSizeFrames;
+            setOutputBufferSize(newOutputBufferSizeFrames);
         }
     }
 }
@@ -1101,6 +1176,7 @@ bool AudioClient::switchOutputToAudioDevice(const QAudioDeviceInfo& outputDevice
 
             _audioOutputIODevice.start();
             _audioOutput->start(&_audioOutputIODevice);
+            _lastOutputStarveTimeMsec = usecTimestampNow() / 1000;
 
             // setup a loopback audio output device
             _loopbackAudioOutput = new QAudioOutput(outputDeviceInfo, _outputFormat, this);
@@ -1123,8 +1199,11 @@ void AudioClient::setOutputBufferSize(int numFrames) {
 
         if (_audioOutput) {
             // The buffer size can't be adjusted after QAudioOutput::start() has been called, so
-            // recreate the device by switching to the default.
-            QAudioDeviceInfo outputDeviceInfo = defaultAudioDeviceForMode(QAudio::AudioOutput);
+            // recreate the device, the one in use if it is still there or else the default.
+            QAudioDeviceInfo outputDeviceInfo = getNamedAudioDeviceForMode(QAudio::AudioOutput, _outputAudioDeviceName);
+            if (outputDeviceInfo.isNull()) {
+                outputDeviceInfo = defaultAudioDeviceForMode(QAudio::AudioOutput);
+            }
             switchOutputToAudioDevice(outputDeviceInfo);
         }
     }
@@ -1231,6 +1310,8 @@ void AudioClient::loadSettings() {
                                                                         windowSecondsForDesiredCalcOnTooManyStarves.get());
     _receivedAudioStream.setWindowSecondsForDesiredReduction(windowSecondsForDesiredReduction.get());
     _receivedAudioStream.setRepetitionWithFade(repetitionWithFade.get());
+    _receivedAudioStream.setTimeStretch(timeStretch.get());
+    _receivedAudioStream.setTimeStretchPercentile(timeStretchPercentile.get());
 }
 
 void AudioClient::saveSettings() {
@@ -1242,4 +1323,6 @@ void AudioClient::saveSettings() {
                                                     getWindowSecondsForDesiredCalcOnTooManyStarves());
     windowSecondsForDesiredReduction.set(_receivedAudioStream.getWindowSecondsForDesiredReduction());
     repetitionWithFade.set(_receivedAudioStream.getRepetitionWithFade());
+    timeStretch.set(_receivedAudioStream.getTimeStretch());
+    timeStretchPercentile.set(_receivedAudioStream.getTimeStretchPercentile());
 }
@@ -70,6 +70,7 @@ static const int MAX_AUDIO_OUTPUT_BUFFER_SIZE_FRAMES = 20;
 #endif
 static const int DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_THRESHOLD = 3;
 static const quint64 DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_PERIOD = 10 * 1000; // 10 Seconds
+static const quint64 AUDIO_OUTPUT_BUFFER_SHRINK_PERIOD = 5 * 60 * 1000; // 5 Minutes without starves
 
 class QAudioInput;
 class QAudioOutput;
@@ -144,12 +145,14 @@ public slots:
     void handleAudioDataPacket(QSharedPointer<ReceivedMessage> message);
     void handleNoisyMutePacket(QSharedPointer<ReceivedMessage> message);
     void handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> message);
+    void handleSelectedAudioFormat(QSharedPointer<ReceivedMessage> message);
 
     void sendDownstreamAudioStatsPacket() { _stats.sendDownstreamAudioStatsPacket(); }
     void handleAudioInput();
     void handleRecordedAudioInput(const QByteArray& audio);
     void reset();
     void audioMixerKilled();
+    void negotiateAudioFormat();
     void toggleMute();
 
     virtual void enableAudioSourceInject(bool enable);
@@ -238,6 +241,7 @@ private:
 
     quint64 _outputStarveDetectionStartTimeMsec;
     int _outputStarveDetectionCount;
+    quint64 _lastOutputStarveTimeMsec { 0 };
 
     Setting::Handle<int> _outputBufferSizeFrames;
     Setting::Handle<bool> _outputStarveDetectionEnabled;
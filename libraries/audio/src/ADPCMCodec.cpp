@@ -0,0 +1,177 @@
+//
+//  ADPCMCodec.cpp
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#include "ADPCMCodec.h"
+
+const QString ADPCMCodec::NAME = "adpcm";
+
+static const int MAX_STEP_INDEX = 88;
+
+static const int STEP_TABLE[MAX_STEP_INDEX + 1] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+namespace {
+
+    struct ChannelState {
+        int predictor { 0 };
+        int stepIndex { 0 };
+
+        // applies one nibble, this is all the decoder does and the encoder has to track it exactly
+        void update(int nibble) {
+            int step = STEP_TABLE[stepIndex];
+
+            int delta = step >> 3;
+            if (nibble & 4) {
+                delta += step;
+            }
+            if (nibble & 2) {
+                delta += step >> 1;
+            }
+            if (nibble & 1) {
+                delta += step >> 2;
+            }
+
+            predictor += (nibble & 8) ? -delta : delta;
+            predictor = std::max(-32768, std::min(predictor, 32767));
+
+            stepIndex += INDEX_TABLE[nibble];
+            stepIndex = std::max(0, std::min(stepIndex, MAX_STEP_INDEX));
+        }
+
+        int encode(int sample) {
+            int step = STEP_TABLE[stepIndex];
+            int difference = sample - predictor;
+
+            int nibble = 0;
+            if (difference < 0) {
+                nibble = 8;
+                difference = -difference;
+            }
+            if (difference >= step) {
+                nibble |= 4;
+                difference -= step;
+            }
+            if (difference >= (step >> 1)) {
+                nibble |= 2;
+                difference -= step >> 1;
+            }
+            if (difference >= (step >> 2)) {
+                nibble |= 1;
+            }
+
+            update(nibble);
+            return nibble;
+        }
+    };
+
+    void writeHeader(char* header, const ChannelState& state) {
+        int16_t predictor = (int16_t)state.predictor;
+        memcpy(header, &predictor, sizeof(predictor));
+        header[2] = (char)state.stepIndex;
+        header[3] = 0;
+    }
+
+    void readHeader(const char* header, ChannelState& state) {
+        int16_t predictor;
+        memcpy(&predictor, header, sizeof(predictor));
+        state.predictor = predictor;
+        state.stepIndex = std::max(0, std::min((int)(uint8_t)header[2], MAX_STEP_INDEX));
+    }
+
+    class ADPCMEncoder : public AudioEncoder {
+    public:
+        ADPCMEncoder(int numChannels) : _channels(numChannels) {}
+
+        void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
+            int numChannels = (int)_channels.size();
+            int numSamples = decodedBuffer.size() / sizeof(int16_t);
+            const int16_t* samples = reinterpret_cast<const int16_t*>(decodedBuffer.constData());
+
+            encodedBuffer.resize(ADPCMCodec::getEncodedSize(numSamples, numChannels));
+            char* output = encodedBuffer.data();
+
+            // the state carries on from the last frame, the header lets the decoder pick it up from here
+            for (int c = 0; c < numChannels; ++c) {
+                writeHeader(&output[c * ADPCMCodec::HEADER_BYTES_PER_CHANNEL], _channels[c]);
+            }
+            uint8_t* nibbles = reinterpret_cast<uint8_t*>(&output[numChannels * ADPCMCodec::HEADER_BYTES_PER_CHANNEL]);
+            memset(nibbles, 0, (numSamples + 1) / 2);
+
+            for (int i = 0; i < numSamples; ++i) {
+                int nibble = _channels[i % numChannels].encode(samples[i]);
+                nibbles[i / 2] |= (i & 1) ? (nibble << 4) : nibble;
+            }
+        }
+
+    private:
+        std::vector<ChannelState> _channels;
+    };
+
+    class ADPCMDecoder : public AudioDecoder {
+    public:
+        ADPCMDecoder(int numChannels) : _numChannels(numChannels) {}
+
+        void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) {
+            int headerBytes = _numChannels * ADPCMCodec::HEADER_BYTES_PER_CHANNEL;
+            if (encodedBuffer.size() < headerBytes) {
+                decodedBuffer.clear();
+                return;
+            }
+
+            std::vector<ChannelState> channels(_numChannels);
+            for (int c = 0; c < _numChannels; ++c) {
+                readHeader(&encodedBuffer.constData()[c * ADPCMCodec::HEADER_BYTES_PER_CHANNEL], channels[c]);
+            }
+
+            int numSamples = (encodedBuffer.size() - headerBytes) * 2;
+            numSamples -= numSamples % _numChannels;
+            const uint8_t* nibbles = reinterpret_cast<const uint8_t*>(&encodedBuffer.constData()[headerBytes]);
+
+            decodedBuffer.resize(numSamples * sizeof(int16_t));
+            int16_t* samples = reinterpret_cast<int16_t*>(decodedBuffer.data());
+
+            for (int i = 0; i < numSamples; ++i) {
+                int nibble = (i & 1) ? (nibbles[i / 2] >> 4) : (nibbles[i / 2] & 0xf);
+                ChannelState& state = channels[i % _numChannels];
+                state.update(nibble);
+                samples[i] = (int16_t)state.predictor;
+            }
+        }
+
+    private:
+        int _numChannels;
+    };
+}
+
+std::unique_ptr<AudioEncoder> ADPCMCodec::createEncoder(int sampleRate, int numChannels) const {
+    return std::unique_ptr<AudioEncoder>(new ADPCMEncoder(numChannels));
+}
+
+std::unique_ptr<AudioDecoder> ADPCMCodec::createDecoder(int sampleRate, int numChannels) const {
+    return std::unique_ptr<AudioDecoder>(new ADPCMDecoder(numChannels));
+}
+
+int ADPCMCodec::getEncodedSize(int numSamples, int numChannels) {
+    return numChannels * HEADER_BYTES_PER_CHANNEL + (numSamples + 1) / 2;
+}
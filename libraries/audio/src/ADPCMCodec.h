@@ -0,0 +1,36 @@
+//
+//  ADPCMCodec.h
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ADPCMCodec_h
+#define hifi_ADPCMCodec_h
+
+#include <stdint.h>
+
+#include "AudioCodec.h"
+
+/// IMA ADPCM, 4 bits per sample. Every encoded frame starts with the predictor state of each channel,
+/// so frames can be decoded on their own and a lost packet does not throw the decoder off.
+class ADPCMCodec : public AudioCodec {
+public:
+    static const QString NAME;
+
+    // per channel frame header: int16 predictor, uint8 step index, one byte of padding
+    static const int HEADER_BYTES_PER_CHANNEL = 4;
+
+    QString getName() const { return NAME; }
+
+    std::unique_ptr<AudioEncoder> createEncoder(int sampleRate, int numChannels) const;
+    std::unique_ptr<AudioDecoder> createDecoder(int sampleRate, int numChannels) const;
+
+    /// size of an encoded frame holding numSamples interleaved samples
+    static int getEncodedSize(int numSamples, int numChannels);
+};
+
+#endif // hifi_ADPCMCodec_h
@@ -0,0 +1,70 @@
+//
+//  AudioCodec.cpp
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <vector>
+
+#include <NLPacket.h>
+#include <ReceivedMessage.h>
+
+#include "ADPCMCodec.h"
+
+#include "AudioCodec.h"
+
+static const int MAX_CODEC_NAME_BYTES = 255;
+
+namespace {
+    std::vector<std::unique_ptr<AudioCodec>>& getRegisteredCodecs() {
+        static std::vector<std::unique_ptr<AudioCodec>> codecs;
+
+        // the built-in codecs are always available
+        static bool builtInsRegistered = false;
+        if (!builtInsRegistered) {
+            builtInsRegistered = true;
+            codecs.push_back(std::unique_ptr<AudioCodec>(new ADPCMCodec()));
+        }
+        return codecs;
+    }
+}
+
+void AudioCodecs::registerCodec(std::unique_ptr<AudioCodec> codec) {
+    auto& codecs = getRegisteredCodecs();
+
+    // codecs registered by plugins take precedence over the built-in ADPCM codec
+    codecs.insert(codecs.end() - 1, std::move(codec));
+}
+
+QStringList AudioCodecs::getCodecNames() {
+    QStringList names;
+    for (auto& codec : getRegisteredCodecs()) {
+        names << codec->getName();
+    }
+    return names;
+}
+
+const AudioCodec* AudioCodecs::getCodec(const QString& name) {
+    for (auto& codec : getRegisteredCodecs()) {
+        if (codec->getName() == name) {
+            return codec.get();
+        }
+    }
+    return nullptr;
+}
+
+void AudioCodecs::writeCodecName(NLPacket& packet, const QString& name) {
+    QByteArray utf8Name = name.toUtf8().left(MAX_CODEC_NAME_BYTES);
+    packet.writePrimitive((quint8)utf8Name.size());
+    packet.write(utf8Name);
+}
+
+QString AudioCodecs::readCodecName(ReceivedMessage& message) {
+    quint8 nameSize = 0;
+    message.readPrimitive(&nameSize);
+    return QString::fromUtf8(message.read(nameSize));
+}
@@ -0,0 +1,63 @@
+//
+//  AudioCodec.h
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodec_h
+#define hifi_AudioCodec_h
+
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+class NLPacket;
+class ReceivedMessage;
+
+/// Encodes network frames of interleaved int16 audio. Encoders may keep state from one frame to the next.
+class AudioEncoder {
+public:
+    virtual ~AudioEncoder() {}
+    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) = 0;
+};
+
+/// Decodes frames produced by the matching AudioEncoder back to interleaved int16 audio.
+class AudioDecoder {
+public:
+    virtual ~AudioDecoder() {}
+    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) = 0;
+};
+
+/// A codec the audio mixer and its clients can negotiate by name.
+class AudioCodec {
+public:
+    virtual ~AudioCodec() {}
+
+    virtual QString getName() const = 0;
+
+    virtual std::unique_ptr<AudioEncoder> createEncoder(int sampleRate, int numChannels) const = 0;
+    virtual std::unique_ptr<AudioDecoder> createDecoder(int sampleRate, int numChannels) const = 0;
+};
+
+namespace AudioCodecs {
+    /// adds a codec that can be negotiated, codecs registered first are preferred
+    void registerCodec(std::unique_ptr<AudioCodec> codec);
+
+    /// names of the registered codecs, in order of preference
+    QStringList getCodecNames();
+
+    /// returns the registered codec with this name, or nullptr if there is none
+    const AudioCodec* getCodec(const QString& name);
+
+    /// codec names go out on the wire as a length byte followed by UTF-8, an empty name means raw PCM
+    void writeCodecName(NLPacket& packet, const QString& name);
+    QString readCodecName(ReceivedMessage& message);
+}
+
+#endif // hifi_AudioCodec_h
@@ -21,6 +21,9 @@ namespace AudioConstants {
 
     typedef int16_t AudioSample;
 
+    const int MONO = 1;
+    const int STEREO = 2;
+
     inline const char* getAudioFrameName() { return "com.highfidelity.recording.Audio"; }
 
     const int NETWORK_FRAME_BYTES_STEREO = 1024;
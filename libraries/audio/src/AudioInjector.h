@@ -70,7 +70,7 @@ public slots:
     void stopAndDeleteLater();
     
     const AudioInjectorOptions& getOptions() const { return _options; }
-    void setOptions(const AudioInjectorOptions& options) { _options = options;  }
+    void setOptions(const AudioInjectorOptions& options);
     
     float getLoudness() const { return _loudness; }
     bool isPlaying() const { return _state == State::NotFinished || _state == State::NotFinishedWithPendingDelete; }
@@ -87,6 +87,7 @@ private:
     int64_t injectNextFrame();
     bool injectLocally();
     
+    // shares the samples of the sound, which are only read so that an injection doesn't copy them
     QByteArray _audioData;
     AudioInjectorOptions _options;
     State _state { State::NotFinished };
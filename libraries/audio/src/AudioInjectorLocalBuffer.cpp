@@ -11,6 +11,10 @@
 
 #include "AudioInjectorLocalBuffer.h"
 
+#include <NumericalConstants.h>
+
+#include "AudioConstants.h"
+
 AudioInjectorLocalBuffer::AudioInjectorLocalBuffer(const QByteArray& rawAudioArray, QObject* parent) :
     QIODevice(parent),
     _rawAudioArray(rawAudioArray),
@@ -36,9 +40,9 @@ bool AudioInjectorLocalBuffer::seek(qint64 pos) {
     }
 }
 
-void copy(char* to, char* from, int size, qreal factor) {
+void copy(char* to, const char* from, int size, qreal factor) {
     int16_t* toArray = (int16_t*) to;
-    int16_t* fromArray = (int16_t*) from;
+    const int16_t* fromArray = (const int16_t*) from;
     int sampleSize = size / sizeof(int16_t);
     
     for (int i = 0; i < sampleSize; i++) {
@@ -48,7 +52,92 @@ void copy(char* to, char* from, int size, qreal factor) {
     }
 }
 
+void AudioInjectorLocalBuffer::setSpatialized(const glm::vec3& sourcePosition, ListenerPoseGetter listenerPoseGetter) {
+    setSourcePosition(sourcePosition);
+    _listenerPoseGetter = listenerPoseGetter;
+}
+
+void AudioInjectorLocalBuffer::setSourcePosition(const glm::vec3& sourcePosition) {
+    QMutexLocker locker(&_sourcePositionMutex);
+    _sourcePosition = sourcePosition;
+}
+
 qint64 AudioInjectorLocalBuffer::readData(char* data, qint64 maxSize) {
+    return _listenerPoseGetter ? readSpatialized(data, maxSize) : readMono(data, maxSize);
+}
+
+qint64 AudioInjectorLocalBuffer::readSpatialized(char* data, qint64 maxSize) {
+    const int NUM_CHANNELS = 2;
+    const int NUM_HISTORY_SAMPLES = AudioSpatialization::SAMPLE_PHASE_DELAY_AT_90;
+
+    int numFrames = (int)(maxSize / (NUM_CHANNELS * sizeof(int16_t)));
+    if (numFrames == 0) {
+        return 0;
+    }
+
+    // the samples read this time go after the last ones read before, which the delayed channel starts with
+    _monoSamples.resize((NUM_HISTORY_SAMPLES + numFrames) * sizeof(int16_t));
+    int16_t* monoSamples = reinterpret_cast<int16_t*>(_monoSamples.data());
+    memcpy(monoSamples, _delayHistory, sizeof(_delayHistory));
+
+    int framesRead = (int)(readMono(reinterpret_cast<char*>(monoSamples + NUM_HISTORY_SAMPLES),
+                                    numFrames * sizeof(int16_t)) / sizeof(int16_t));
+    if (framesRead == 0) {
+        return 0;
+    }
+    memcpy(_delayHistory, monoSamples + framesRead, sizeof(_delayHistory));
+
+    glm::vec3 listenerPosition;
+    glm::quat listenerOrientation;
+    _listenerPoseGetter(listenerPosition, listenerOrientation);
+
+    glm::vec3 relativePosition;
+    {
+        QMutexLocker locker(&_sourcePositionMutex);
+        relativePosition = _sourcePosition - listenerPosition;
+    }
+    float distance = glm::max(glm::length(relativePosition), EPSILON);
+
+    float attenuation = AudioSpatialization::computeDistanceAttenuation(distance);
+    float bearing = AudioSpatialization::computeBearing(relativePosition, listenerOrientation);
+    int numSamplesDelay;
+    float weakChannelAmplitudeRatio;
+    AudioSpatialization::computePhasePanning(bearing, distance, numSamplesDelay, weakChannelAmplitudeRatio);
+
+    // the channel away from the source is weaker and later
+    int delayedChannel = (bearing > 0.0f) ? 1 : 0;
+    int normalChannel = 1 - delayedChannel;
+    float gains[NUM_CHANNELS];
+    gains[normalChannel] = attenuation;
+    gains[delayedChannel] = attenuation * weakChannelAmplitudeRatio;
+    const int16_t* channelSamples[NUM_CHANNELS];
+    channelSamples[normalChannel] = monoSamples + NUM_HISTORY_SAMPLES;
+    channelSamples[delayedChannel] = monoSamples + NUM_HISTORY_SAMPLES - numSamplesDelay;
+
+    int16_t* output = reinterpret_cast<int16_t*>(data);
+    for (int i = 0; i < framesRead; i++) {
+        output[NUM_CHANNELS * i] = (int16_t)(channelSamples[0][i] * gains[0]);
+        output[NUM_CHANNELS * i + 1] = (int16_t)(channelSamples[1][i] * gains[1]);
+    }
+
+    // and duller the further behind the listener
+    if (_penumbraFilterFrames < (uint32_t)framesRead) {
+        _penumbraFilterFrames = framesRead;
+        _penumbraFilter.initialize(AudioConstants::SAMPLE_RATE, _penumbraFilterFrames);
+    }
+    float penumbraFilterGains[NUM_CHANNELS];
+    AudioSpatialization::computePenumbraFilterGains(bearing, distance, penumbraFilterGains[0], penumbraFilterGains[1]);
+    for (int channel = 0; channel < NUM_CHANNELS; channel++) {
+        _penumbraFilter.setParameters(0, channel, AudioConstants::SAMPLE_RATE,
+                                      AudioSpatialization::PENUMBRA_FILTER_FREQUENCY_HZ, penumbraFilterGains[channel],
+                                      AudioSpatialization::PENUMBRA_FILTER_SLOPE);
+    }
+    _penumbraFilter.render(output, output, framesRead);
+
+    return framesRead * NUM_CHANNELS * sizeof(int16_t);
+}
+
+qint64 AudioInjectorLocalBuffer::readMono(char* data, qint64 maxSize) {
     if (!_isStopped) {
         
         // first copy to the end of the raw audio
@@ -60,7 +149,7 @@ qint64 AudioInjectorLocalBuffer::readData(char* data, qint64 maxSize) {
             bytesRead = bytesToEnd;
         }
         
-        copy(data, _rawAudioArray.data() + _currentOffset, bytesRead, _volume);
+        copy(data, _rawAudioArray.constData() + _currentOffset, bytesRead, _volume);
         
         // now check if we are supposed to loop and if we can copy more from the beginning
         if (_shouldLoop && maxSize != bytesRead) {
@@ -88,7 +177,7 @@ qint64 AudioInjectorLocalBuffer::recursiveReadFromFront(char* data, qint64 maxSi
     }
     
     // copy that amount
-    copy(data, _rawAudioArray.data(), bytesRead, _volume);
+    copy(data, _rawAudioArray.constData(), bytesRead, _volume);
     
     // check if we need to call ourselves again and pull from the front again
     if (bytesRead < maxSize) {
@@ -12,13 +12,23 @@
 #ifndef hifi_AudioInjectorLocalBuffer_h
 #define hifi_AudioInjectorLocalBuffer_h
 
+#include <functional>
+
 #include <QtCore/qiodevice.h>
+#include <QtCore/QMutex>
 
 #include <glm/detail/func_common.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "AudioFilterBank.h"
+#include "AudioSpatialization.h"
 
 class AudioInjectorLocalBuffer : public QIODevice {
     Q_OBJECT
 public:
+    using ListenerPoseGetter = std::function<void(glm::vec3& position, glm::quat& orientation)>;
+
     AudioInjectorLocalBuffer(const QByteArray& rawAudioArray, QObject* parent);
     
     void stop();
@@ -31,8 +41,16 @@ public:
     void setShouldLoop(bool shouldLoop) { _shouldLoop = shouldLoop; }
     void setCurrentOffset(int currentOffset) { _currentOffset = currentOffset; }
     void setVolume(float volume) { _volume = glm::clamp(volume, 0.0f, 1.0f); }
+
+    /// reads the mono audio out as stereo, placed around the listener the way the audio-mixer would place it,
+    /// so a local sound is heard where it is without going through the mixer
+    void setSpatialized(const glm::vec3& sourcePosition, ListenerPoseGetter listenerPoseGetter);
+    bool isSpatialized() const { return (bool)_listenerPoseGetter; }
+    void setSourcePosition(const glm::vec3& sourcePosition);
     
 private:
+    qint64 readMono(char* data, qint64 maxSize);
+    qint64 readSpatialized(char* data, qint64 maxSize);
     qint64 recursiveReadFromFront(char* data, qint64 maxSize);
     
     QByteArray _rawAudioArray;
@@ -41,6 +59,16 @@ private:
     
     int _currentOffset;
     float _volume;
+
+    ListenerPoseGetter _listenerPoseGetter;
+    QMutex _sourcePositionMutex;
+    glm::vec3 _sourcePosition;
+
+    // the mono samples read last, the delayed channel starts in them
+    int16_t _delayHistory[AudioSpatialization::SAMPLE_PHASE_DELAY_AT_90] {};
+    QByteArray _monoSamples;
+    AudioFilterHSF1s _penumbraFilter;
+    uint32_t _penumbraFilterFrames { 0 };
 };
 
 #endif // hifi_AudioInjectorLocalBuffer_h
\ No newline at end of file
@@ -0,0 +1,300 @@
+//
+//  AudioMixKernels.cpp
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include <CPUDetect.h>
+
+#include "AudioMixKernels.h"
+
+static const float INT16_TO_FLOAT_SCALE = 32768.0f;
+static const float MIN_SAMPLE = -32768.0f;
+static const float MAX_SAMPLE = 32767.0f;
+
+static inline int16_t saturate16(float value) {
+    value = value < MIN_SAMPLE ? MIN_SAMPLE : (value > MAX_SAMPLE ? MAX_SAMPLE : value);
+    return (int16_t)lrintf(value);
+}
+
+void AudioMixKernels::accumulateMonoScalar(float* mix, const int16_t* input, float gain, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        mix[i] += input[i] * gain;
+    }
+}
+
+void AudioMixKernels::accumulateStereoScalar(float* mixLeft, float* mixRight, const int16_t* input, float gain,
+                                             int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        mixLeft[i] += input[2*i + 0] * gain;
+        mixRight[i] += input[2*i + 1] * gain;
+    }
+}
+
+void AudioMixKernels::accumulateScalar(float* mix, const float* input, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        mix[i] += input[i];
+    }
+}
+
+void AudioMixKernels::accumulateWithGainScalar(float* mix, const float* input, float gain, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        mix[i] += input[i] * gain;
+    }
+}
+
+void AudioMixKernels::convertToInt16Scalar(const float* left, const float* right, int16_t* output, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        output[2*i + 0] = saturate16(left[i] * INT16_TO_FLOAT_SCALE);
+        output[2*i + 1] = saturate16(right[i] * INT16_TO_FLOAT_SCALE);
+    }
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(ARCH_X86)
+
+#include <emmintrin.h>
+
+static void accumulateMonoSSE2(float* mix, const int16_t* input, float gain, int numFrames) {
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m128i a0 = _mm_loadu_si128((__m128i*)&input[i]);
+
+        // sign-extend
+        __m128i a1 = _mm_srai_epi32(_mm_unpackhi_epi16(a0, a0), 16);
+        a0 = _mm_srai_epi32(_mm_unpacklo_epi16(a0, a0), 16);
+
+        __m128 f0 = _mm_mul_ps(_mm_cvtepi32_ps(a0), g);
+        __m128 f1 = _mm_mul_ps(_mm_cvtepi32_ps(a1), g);
+
+        _mm_storeu_ps(&mix[i + 0], _mm_add_ps(_mm_loadu_ps(&mix[i + 0]), f0));
+        _mm_storeu_ps(&mix[i + 4], _mm_add_ps(_mm_loadu_ps(&mix[i + 4]), f1));
+    }
+
+    AudioMixKernels::accumulateMonoScalar(&mix[i], &input[i], gain, numFrames - i);
+}
+
+static void accumulateStereoSSE2(float* mixLeft, float* mixRight, const int16_t* input, float gain, int numFrames) {
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        __m128i a0 = _mm_loadu_si128((__m128i*)&input[2*i]);
+        __m128i a1 = a0;
+
+        // deinterleave and sign-extend
+        a0 = _mm_madd_epi16(a0, _mm_set1_epi32(0x00000001));
+        a1 = _mm_madd_epi16(a1, _mm_set1_epi32(0x00010000));
+
+        __m128 f0 = _mm_mul_ps(_mm_cvtepi32_ps(a0), g);
+        __m128 f1 = _mm_mul_ps(_mm_cvtepi32_ps(a1), g);
+
+        _mm_storeu_ps(&mixLeft[i], _mm_add_ps(_mm_loadu_ps(&mixLeft[i]), f0));
+        _mm_storeu_ps(&mixRight[i], _mm_add_ps(_mm_loadu_ps(&mixRight[i]), f1));
+    }
+
+    AudioMixKernels::accumulateStereoScalar(&mixLeft[i], &mixRight[i], &input[2*i], gain, numFrames - i);
+}
+
+static void accumulateSSE2(float* mix, const float* input, int numFrames) {
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        _mm_storeu_ps(&mix[i], _mm_add_ps(_mm_loadu_ps(&mix[i]), _mm_loadu_ps(&input[i])));
+    }
+
+    AudioMixKernels::accumulateScalar(&mix[i], &input[i], numFrames - i);
+}
+
+static void accumulateWithGainSSE2(float* mix, const float* input, float gain, int numFrames) {
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        __m128 f0 = _mm_mul_ps(_mm_loadu_ps(&input[i]), g);
+        _mm_storeu_ps(&mix[i], _mm_add_ps(_mm_loadu_ps(&mix[i]), f0));
+    }
+
+    AudioMixKernels::accumulateWithGainScalar(&mix[i], &input[i], gain, numFrames - i);
+}
+
+static void convertToInt16SSE2(const float* left, const float* right, int16_t* output, int numFrames) {
+    __m128 scale = _mm_set1_ps(INT16_TO_FLOAT_SCALE);
+    __m128 minSample = _mm_set1_ps(MIN_SAMPLE);
+    __m128 maxSample = _mm_set1_ps(MAX_SAMPLE);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        __m128 f0 = _mm_mul_ps(_mm_loadu_ps(&left[i]), scale);
+        __m128 f1 = _mm_mul_ps(_mm_loadu_ps(&right[i]), scale);
+
+        // saturate, then round
+        f0 = _mm_min_ps(_mm_max_ps(f0, minSample), maxSample);
+        f1 = _mm_min_ps(_mm_max_ps(f1, minSample), maxSample);
+        __m128i a0 = _mm_cvtps_epi32(f0);
+        __m128i a1 = _mm_cvtps_epi32(f1);
+        a0 = _mm_packs_epi32(a0, a0);
+        a1 = _mm_packs_epi32(a1, a1);
+
+        // interleave
+        a0 = _mm_unpacklo_epi16(a0, a1);
+        _mm_storeu_si128((__m128i*)&output[2*i], a0);
+    }
+
+    AudioMixKernels::convertToInt16Scalar(&left[i], &right[i], &output[2*i], numFrames - i);
+}
+
+// defined in avx2/AudioMixKernels_avx2.cpp, which is the only code built with AVX2 enabled
+void accumulateMonoAVX2(float* mix, const int16_t* input, float gain, int numFrames);
+void accumulateStereoAVX2(float* mixLeft, float* mixRight, const int16_t* input, float gain, int numFrames);
+void accumulateAVX2(float* mix, const float* input, int numFrames);
+void accumulateWithGainAVX2(float* mix, const float* input, float gain, int numFrames);
+void convertToInt16AVX2(const float* left, const float* right, int16_t* output, int numFrames);
+
+#elif defined(ARCH_NEON)
+
+#include <arm_neon.h>
+
+static void accumulateMonoNEON(float* mix, const int16_t* input, float gain, int numFrames) {
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        float32x4_t f0 = vcvtq_f32_s32(vmovl_s16(vld1_s16(&input[i])));
+
+        vst1q_f32(&mix[i], vaddq_f32(vld1q_f32(&mix[i]), vmulq_n_f32(f0, gain)));
+    }
+
+    AudioMixKernels::accumulateMonoScalar(&mix[i], &input[i], gain, numFrames - i);
+}
+
+static void accumulateStereoNEON(float* mixLeft, float* mixRight, const int16_t* input, float gain, int numFrames) {
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        // deinterleave
+        int16x4x2_t a = vld2_s16(&input[2*i]);
+
+        float32x4_t f0 = vcvtq_f32_s32(vmovl_s16(a.val[0]));
+        float32x4_t f1 = vcvtq_f32_s32(vmovl_s16(a.val[1]));
+
+        vst1q_f32(&mixLeft[i], vaddq_f32(vld1q_f32(&mixLeft[i]), vmulq_n_f32(f0, gain)));
+        vst1q_f32(&mixRight[i], vaddq_f32(vld1q_f32(&mixRight[i]), vmulq_n_f32(f1, gain)));
+    }
+
+    AudioMixKernels::accumulateStereoScalar(&mixLeft[i], &mixRight[i], &input[2*i], gain, numFrames - i);
+}
+
+static void accumulateNEON(float* mix, const float* input, int numFrames) {
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        vst1q_f32(&mix[i], vaddq_f32(vld1q_f32(&mix[i]), vld1q_f32(&input[i])));
+    }
+
+    AudioMixKernels::accumulateScalar(&mix[i], &input[i], numFrames - i);
+}
+
+static void accumulateWithGainNEON(float* mix, const float* input, float gain, int numFrames) {
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        vst1q_f32(&mix[i], vaddq_f32(vld1q_f32(&mix[i]), vmulq_n_f32(vld1q_f32(&input[i]), gain)));
+    }
+
+    AudioMixKernels::accumulateWithGainScalar(&mix[i], &input[i], gain, numFrames - i);
+}
+
+// vcvtq_s32_f32 truncates, so offset by half towards the sign before converting
+static inline int32x4_t roundToInt32(float32x4_t f) {
+    float32x4_t half = vbslq_f32(vcltq_f32(f, vdupq_n_f32(0.0f)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+    return vcvtq_s32_f32(vaddq_f32(f, half));
+}
+
+static void convertToInt16NEON(const float* left, const float* right, int16_t* output, int numFrames) {
+    float32x4_t minSample = vdupq_n_f32(MIN_SAMPLE);
+    float32x4_t maxSample = vdupq_n_f32(MAX_SAMPLE);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        float32x4_t f0 = vmulq_n_f32(vld1q_f32(&left[i]), INT16_TO_FLOAT_SCALE);
+        float32x4_t f1 = vmulq_n_f32(vld1q_f32(&right[i]), INT16_TO_FLOAT_SCALE);
+
+        // saturate, then round
+        f0 = vminq_f32(vmaxq_f32(f0, minSample), maxSample);
+        f1 = vminq_f32(vmaxq_f32(f1, minSample), maxSample);
+
+        // interleave
+        int16x4x2_t a;
+        a.val[0] = vqmovn_s32(roundToInt32(f0));
+        a.val[1] = vqmovn_s32(roundToInt32(f1));
+        vst2_s16(&output[2*i], a);
+    }
+
+    AudioMixKernels::convertToInt16Scalar(&left[i], &right[i], &output[2*i], numFrames - i);
+}
+
+#endif
+
+namespace {
+
+    struct MixKernels {
+        void (*accumulateMono)(float* mix, const int16_t* input, float gain, int numFrames);
+        void (*accumulateStereo)(float* mixLeft, float* mixRight, const int16_t* input, float gain, int numFrames);
+        void (*accumulate)(float* mix, const float* input, int numFrames);
+        void (*accumulateWithGain)(float* mix, const float* input, float gain, int numFrames);
+        void (*convertToInt16)(const float* left, const float* right, int16_t* output, int numFrames);
+        const char* name;
+    };
+
+    MixKernels selectKernels() {
+#if defined(ARCH_X86)
+        if (cpuSupportsAVX2()) {
+            return { accumulateMonoAVX2, accumulateStereoAVX2, accumulateAVX2, accumulateWithGainAVX2,
+                     convertToInt16AVX2, "avx2" };
+        }
+        return { accumulateMonoSSE2, accumulateStereoSSE2, accumulateSSE2, accumulateWithGainSSE2,
+                 convertToInt16SSE2, "sse2" };
+#elif defined(ARCH_NEON)
+        return { accumulateMonoNEON, accumulateStereoNEON, accumulateNEON, accumulateWithGainNEON,
+                 convertToInt16NEON, "neon" };
+#else
+        return { AudioMixKernels::accumulateMonoScalar, AudioMixKernels::accumulateStereoScalar,
+                 AudioMixKernels::accumulateScalar, AudioMixKernels::accumulateWithGainScalar,
+                 AudioMixKernels::convertToInt16Scalar, "scalar" };
+#endif
+    }
+
+    const MixKernels& getKernels() {
+        static const MixKernels kernels = selectKernels();
+        return kernels;
+    }
+}
+
+void AudioMixKernels::accumulateMono(float* mix, const int16_t* input, float gain, int numFrames) {
+    getKernels().accumulateMono(mix, input, gain, numFrames);
+}
+
+void AudioMixKernels::accumulateStereo(float* mixLeft, float* mixRight, const int16_t* input, float gain, int numFrames) {
+    getKernels().accumulateStereo(mixLeft, mixRight, input, gain, numFrames);
+}
+
+void AudioMixKernels::accumulate(float* mix, const float* input, int numFrames) {
+    getKernels().accumulate(mix, input, numFrames);
+}
+
+void AudioMixKernels::accumulateWithGain(float* mix, const float* input, float gain, int numFrames) {
+    getKernels().accumulateWithGain(mix, input, gain, numFrames);
+}
+
+void AudioMixKernels::convertToInt16(const float* left, const float* right, int16_t* output, int numFrames) {
+    getKernels().convertToInt16(left, right, output, numFrames);
+}
+
+const char* AudioMixKernels::getKernelName() {
+    return getKernels().name;
+}
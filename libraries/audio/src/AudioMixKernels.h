@@ -0,0 +1,51 @@
+//
+//  AudioMixKernels.h
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernels_h
+#define hifi_AudioMixKernels_h
+
+#include <stdint.h>
+
+//
+// Kernels used to build a mix out of many int16 sources on a float32 mix bus.
+// The bus is planar (one buffer per channel) and normalized to [-1.0f, 1.0f], like AudioBufferFloat32,
+// and is only clamped once on its way back out to int16.
+// The best implementation for the running CPU (AVX2, SSE2, NEON or portable) is picked the first time
+// the kernels are used.
+//
+namespace AudioMixKernels {
+
+    // mix[i] += input[i] * gain
+    void accumulateMono(float* mix, const int16_t* input, float gain, int numFrames);
+
+    // mixLeft[i] += input[2 * i] * gain, mixRight[i] += input[2 * i + 1] * gain
+    void accumulateStereo(float* mixLeft, float* mixRight, const int16_t* input, float gain, int numFrames);
+
+    // mix[i] += input[i]
+    void accumulate(float* mix, const float* input, int numFrames);
+
+    // mix[i] += input[i] * gain
+    void accumulateWithGain(float* mix, const float* input, float gain, int numFrames);
+
+    // output[2 * i] = saturate(left[i]), output[2 * i + 1] = saturate(right[i]), rounding to nearest
+    void convertToInt16(const float* left, const float* right, int16_t* output, int numFrames);
+
+    // name of the instruction set the dispatched kernels use
+    const char* getKernelName();
+
+    // portable versions, also used to check and benchmark the vectorized kernels
+    void accumulateMonoScalar(float* mix, const int16_t* input, float gain, int numFrames);
+    void accumulateStereoScalar(float* mixLeft, float* mixRight, const int16_t* input, float gain, int numFrames);
+    void accumulateScalar(float* mix, const float* input, int numFrames);
+    void accumulateWithGainScalar(float* mix, const float* input, float gain, int numFrames);
+    void convertToInt16Scalar(const float* left, const float* right, int16_t* output, int numFrames);
+}
+
+#endif // hifi_AudioMixKernels_h
@@ -28,17 +28,17 @@ _sampleCapacity(numFrameSamples * numFramesCapacity),
 _bufferLength(numFrameSamples * (numFramesCapacity + 1)),
 _numFrameSamples(numFrameSamples),
 _randomAccessMode(randomAccessMode),
-_overflowCount(0)
+_overflowCount(0),
+_nextOutput(nullptr),
+_endOfLastWrite(nullptr)
 {
     if (numFrameSamples) {
         _buffer = new int16_t[_bufferLength];
         memset(_buffer, 0, _bufferLength * sizeof(int16_t));
-        _nextOutput = _buffer;
-        _endOfLastWrite = _buffer;
+        _nextOutput.store(_buffer);
+        _endOfLastWrite.store(_buffer);
     } else {
         _buffer = NULL;
-        _nextOutput = NULL;
-        _endOfLastWrite = NULL;
     }
 };
 
@@ -65,8 +65,8 @@ void AudioRingBuffer::resizeForFrameSize(int numFrameSamples) {
 }
 
 void AudioRingBuffer::clear() {
-    _endOfLastWrite = _buffer;
-    _nextOutput = _buffer;
+    _endOfLastWrite.store(_buffer);
+    _nextOutput.store(_buffer);
 }
 
 int AudioRingBuffer::readSamples(int16_t* destination, int maxSamples) {
@@ -74,42 +74,49 @@ int AudioRingBuffer::readSamples(int16_t* destination, int maxSamples) {
 }
 
 int AudioRingBuffer::readData(char *data, int maxSize) {
+    int16_t* nextOutput = _nextOutput.load(std::memory_order_acquire);
+    int numReadSamples;
 
-    // only copy up to the number of samples we have available
-    int numReadSamples = std::min((int)(maxSize / sizeof(int16_t)), samplesAvailable());
+    do {
+        int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_acquire);
 
-    // If we're in random access mode, then we consider our number of available read samples slightly
-    // differently. Namely, if anything has been written, we say we have as many samples as they ask for
-    // otherwise we say we have nothing available
-    if (_randomAccessMode) {
-        numReadSamples = _endOfLastWrite ? (maxSize / sizeof(int16_t)) : 0;
-    }
-
-    if (_nextOutput + numReadSamples > _buffer + _bufferLength) {
-        // we're going to need to do two reads to get this data, it wraps around the edge
+        // only copy up to the number of samples we have available
+        numReadSamples = std::min((int)(maxSize / sizeof(int16_t)), samplesAvailable(nextOutput, endOfLastWrite));
 
-        // read to the end of the buffer
-        int numSamplesToEnd = (_buffer + _bufferLength) - _nextOutput;
-        memcpy(data, _nextOutput, numSamplesToEnd * sizeof(int16_t));
+        // If we're in random access mode, then we consider our number of available read samples slightly
+        // differently. Namely, if anything has been written, we say we have as many samples as they ask for
+        // otherwise we say we have nothing available
         if (_randomAccessMode) {
-            memset(_nextOutput, 0, numSamplesToEnd * sizeof(int16_t)); // clear it
+            numReadSamples = endOfLastWrite ? (maxSize / sizeof(int16_t)) : 0;
         }
 
-        // read the rest from the beginning of the buffer
-        memcpy(data + (numSamplesToEnd * sizeof(int16_t)), _buffer, (numReadSamples - numSamplesToEnd) * sizeof(int16_t));
-        if (_randomAccessMode) {
-            memset(_buffer, 0, (numReadSamples - numSamplesToEnd) * sizeof(int16_t)); // clear it
+        if (nextOutput + numReadSamples > _buffer + _bufferLength) {
+            // we're going to need to do two reads to get this data, it wraps around the edge
+
+            // read to the end of the buffer
+            int numSamplesToEnd = (_buffer + _bufferLength) - nextOutput;
+            memcpy(data, nextOutput, numSamplesToEnd * sizeof(int16_t));
+            if (_randomAccessMode) {
+                memset(nextOutput, 0, numSamplesToEnd * sizeof(int16_t)); // clear it
+            }
+
+            // read the rest from the beginning of the buffer
+            memcpy(data + (numSamplesToEnd * sizeof(int16_t)), _buffer, (numReadSamples - numSamplesToEnd) * sizeof(int16_t));
+            if (_randomAccessMode) {
+                memset(_buffer, 0, (numReadSamples - numSamplesToEnd) * sizeof(int16_t)); // clear it
+            }
+        } else {
+            // read the data
+            memcpy(data, nextOutput, numReadSamples * sizeof(int16_t));
+            if (_randomAccessMode) {
+                memset(nextOutput, 0, numReadSamples * sizeof(int16_t)); // clear it
+            }
         }
-    } else {
-        // read the data
-        memcpy(data, _nextOutput, numReadSamples * sizeof(int16_t));
-        if (_randomAccessMode) {
-            memset(_nextOutput, 0, numReadSamples * sizeof(int16_t)); // clear it
-        }
-    }
 
-    // push the position of _nextOutput by the number of samples read
-    _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, numReadSamples);
+        // push the position of _nextOutput by the number of samples read,
+        // unless the writer overflowed and dropped the oldest samples while we were reading them - then read again
+    } while (!_nextOutput.compare_exchange_strong(nextOutput, shiftedPositionAccomodatingWrap(nextOutput, numReadSamples),
+                                                  std::memory_order_acq_rel, std::memory_order_acquire));
 
     return numReadSamples * sizeof(int16_t);
 }
@@ -123,52 +130,106 @@ int AudioRingBuffer::writeData(const char* data, int maxSize) {
     // otherwise we should not copy that data, and leave the buffer pointers where they are
     int samplesToCopy = std::min((int)(maxSize / sizeof(int16_t)), _sampleCapacity);
 
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
-    }
+    makeRoomFor(samplesToCopy);
 
-    if (_endOfLastWrite + samplesToCopy <= _buffer + _bufferLength) {
-        memcpy(_endOfLastWrite, data, samplesToCopy * sizeof(int16_t));
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
+    if (endOfLastWrite + samplesToCopy <= _buffer + _bufferLength) {
+        memcpy(endOfLastWrite, data, samplesToCopy * sizeof(int16_t));
     } else {
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
-        memcpy(_endOfLastWrite, data, numSamplesToEnd * sizeof(int16_t));
+        int numSamplesToEnd = (_buffer + _bufferLength) - endOfLastWrite;
+        memcpy(endOfLastWrite, data, numSamplesToEnd * sizeof(int16_t));
         memcpy(_buffer, data + (numSamplesToEnd * sizeof(int16_t)), (samplesToCopy - numSamplesToEnd) * sizeof(int16_t));
     }
 
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, samplesToCopy);
+    // publish the new samples to the reader
+    _endOfLastWrite.store(shiftedPositionAccomodatingWrap(endOfLastWrite, samplesToCopy), std::memory_order_release);
 
     return samplesToCopy * sizeof(int16_t);
 }
 
 int16_t& AudioRingBuffer::operator[](const int index) {
-    return *shiftedPositionAccomodatingWrap(_nextOutput, index);
+    return *shiftedPositionAccomodatingWrap(_nextOutput.load(std::memory_order_acquire), index);
 }
 
 const int16_t& AudioRingBuffer::operator[] (const int index) const {
-    return *shiftedPositionAccomodatingWrap(_nextOutput, index);
+    return *shiftedPositionAccomodatingWrap(_nextOutput.load(std::memory_order_acquire), index);
 }
 
-void AudioRingBuffer::shiftReadPosition(unsigned int numSamples) {
-    _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, numSamples);
+AudioRingBuffer::ConstIterator AudioRingBuffer::shiftReadPosition(unsigned int numSamples) {
+    int16_t* nextOutput = _nextOutput.load(std::memory_order_acquire);
+    int16_t* shiftedOutput;
+    do {
+        int samplesToShift = std::min((int)numSamples,
+                                      samplesAvailable(nextOutput, _endOfLastWrite.load(std::memory_order_acquire)));
+        shiftedOutput = shiftedPositionAccomodatingWrap(nextOutput, samplesToShift);
+    } while (!_nextOutput.compare_exchange_strong(nextOutput, shiftedOutput,
+                                                  std::memory_order_acq_rel, std::memory_order_acquire));
+
+    return ConstIterator(_buffer, _bufferLength, nextOutput);
 }
 
 int AudioRingBuffer::samplesAvailable() const {
-    if (!_endOfLastWrite) {
+    return samplesAvailable(_nextOutput.load(std::memory_order_acquire), _endOfLastWrite.load(std::memory_order_acquire));
+}
+
+int AudioRingBuffer::samplesAvailable(const int16_t* nextOutput, const int16_t* endOfLastWrite) const {
+    if (!endOfLastWrite) {
         return 0;
     }
 
-    int sampleDifference = _endOfLastWrite - _nextOutput;
+    int sampleDifference = endOfLastWrite - nextOutput;
     if (sampleDifference < 0) {
         sampleDifference += _bufferLength;
     }
     return sampleDifference;
 }
 
+void AudioRingBuffer::makeRoomFor(int numSamples) {
+    int16_t* nextOutput = _nextOutput.load(std::memory_order_acquire);
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
+    int samplesRoomFor;
+    do {
+        samplesRoomFor = _sampleCapacity - samplesAvailable(nextOutput, endOfLastWrite);
+        if (numSamples <= samplesRoomFor) {
+            return;
+        }
+        // there's not enough room for this write.  erase old data to make room for this new data
+    } while (!_nextOutput.compare_exchange_strong(nextOutput,
+                                                  shiftedPositionAccomodatingWrap(nextOutput, numSamples - samplesRoomFor),
+                                                  std::memory_order_acq_rel, std::memory_order_acquire));
+
+    _overflowCount++;
+    qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
+}
+
+int AudioRingBuffer::getWriteOffset() const {
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
+    return endOfLastWrite ? (int)(endOfLastWrite - _buffer) : 0;
+}
+
+bool AudioRingBuffer::replaceUnreadSamples(int offset, const int16_t* source, int numSamples) {
+    int16_t* nextOutput = _nextOutput.load(std::memory_order_acquire);
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
+    if (!endOfLastWrite || numSamples <= 0) {
+        return false;
+    }
+
+    // the unread samples are the last ones written, so if these are among them they are still the ones written there
+    int16_t* position = _buffer + (offset % _bufferLength);
+    if (samplesAvailable(nextOutput, position) + numSamples > samplesAvailable(nextOutput, endOfLastWrite)) {
+        return false;
+    }
+
+    int numSamplesToEnd = (int)((_buffer + _bufferLength) - position);
+    if (numSamples <= numSamplesToEnd) {
+        memcpy(position, source, numSamples * sizeof(int16_t));
+    } else {
+        memcpy(position, source, numSamplesToEnd * sizeof(int16_t));
+        memcpy(_buffer, source + numSamplesToEnd, (numSamples - numSamplesToEnd) * sizeof(int16_t));
+    }
+    return true;
+}
+
 int AudioRingBuffer::addSilentSamples(int silentSamples) {
 
     int samplesRoomFor = _sampleCapacity - samplesAvailable();
@@ -180,14 +241,15 @@ int AudioRingBuffer::addSilentSamples(int silentSamples) {
 
     // memset zeroes into the buffer, accomodate a wrap around the end
     // push the _endOfLastWrite to the correct spot
-    if (_endOfLastWrite + silentSamples <= _buffer + _bufferLength) {
-        memset(_endOfLastWrite, 0, silentSamples * sizeof(int16_t));
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
+    if (endOfLastWrite + silentSamples <= _buffer + _bufferLength) {
+        memset(endOfLastWrite, 0, silentSamples * sizeof(int16_t));
     } else {
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
-        memset(_endOfLastWrite, 0, numSamplesToEnd * sizeof(int16_t));
+        int numSamplesToEnd = (_buffer + _bufferLength) - endOfLastWrite;
+        memset(endOfLastWrite, 0, numSamplesToEnd * sizeof(int16_t));
         memset(_buffer, 0, (silentSamples - numSamplesToEnd) * sizeof(int16_t));
     }
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, silentSamples);
+    _endOfLastWrite.store(shiftedPositionAccomodatingWrap(endOfLastWrite, silentSamples), std::memory_order_release);
 
     return silentSamples;
 }
@@ -228,47 +290,37 @@ float AudioRingBuffer::getFrameLoudness(ConstIterator frameStart) const {
 }
 
 float AudioRingBuffer::getNextOutputFrameLoudness() const {
-    return getFrameLoudness(_nextOutput);
+    return getFrameLoudness(_nextOutput.load(std::memory_order_acquire));
 }
 
 int AudioRingBuffer::writeSamples(ConstIterator source, int maxSamples) {
     int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
-    }
+    makeRoomFor(samplesToCopy);
 
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
     int16_t* bufferLast = _buffer + _bufferLength - 1;
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = *source;
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        *endOfLastWrite = *source;
+        endOfLastWrite = (endOfLastWrite == bufferLast) ? _buffer : endOfLastWrite + 1;
         ++source;
     }
+    _endOfLastWrite.store(endOfLastWrite, std::memory_order_release);
 
     return samplesToCopy;
 }
 
 int AudioRingBuffer::writeSamplesWithFade(ConstIterator source, int maxSamples, float fade) {
     int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
-    }
+    makeRoomFor(samplesToCopy);
 
+    int16_t* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
     int16_t* bufferLast = _buffer + _bufferLength - 1;
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = (int16_t)((float)(*source) * fade);
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        *endOfLastWrite = (int16_t)((float)(*source) * fade);
+        endOfLastWrite = (endOfLastWrite == bufferLast) ? _buffer : endOfLastWrite + 1;
         ++source;
     }
+    _endOfLastWrite.store(endOfLastWrite, std::memory_order_release);
 
     return samplesToCopy;
 }
@@ -14,6 +14,8 @@
 
 #include "AudioConstants.h"
 
+#include <atomic>
+
 #include <QtCore/QIODevice>
 
 #include <SharedUtil.h>
@@ -21,6 +23,10 @@
 
 const int DEFAULT_RING_BUFFER_FRAME_CAPACITY = 10;
 
+// The ring buffer is safe for one writer thread and one reader thread without a lock.
+// The writer owns _endOfLastWrite and only publishes it once the samples behind it have been written.
+// The reader owns _nextOutput; the writer only moves it (with a compare-and-swap) to drop the oldest audio on overflow.
+// reset(), clear() and resizeForFrameSize() must not run while the other side is using the buffer.
 class AudioRingBuffer {
 public:
     AudioRingBuffer(int numFrameSamples, bool randomAccessMode = false, int numFramesCapacity = DEFAULT_RING_BUFFER_FRAME_CAPACITY);
@@ -43,8 +49,6 @@ public:
     int16_t& operator[](const int index);
     const int16_t& operator[] (const int index) const;
 
-    void shiftReadPosition(unsigned int numSamples);
-
     float getNextOutputFrameLoudness() const;
 
     int samplesAvailable() const;
@@ -56,6 +60,13 @@ public:
 
     int addSilentSamples(int samples);
 
+    /// where the next write goes, for replaceUnreadSamples
+    int getWriteOffset() const;
+
+    /// replaces numSamples samples written at offset, as long as none of them have been read yet
+    /// returns false (and leaves the buffer alone) if the reader got to them first
+    bool replaceUnreadSamples(int offset, const int16_t* source, int numSamples);
+
 private:
     float getFrameLoudness(const int16_t* frameStart) const;
 
@@ -65,17 +76,25 @@ protected:
     AudioRingBuffer& operator= (const AudioRingBuffer&);
 
     int16_t* shiftedPositionAccomodatingWrap(int16_t* position, int numSamplesShift) const;
+    int samplesAvailable(const int16_t* nextOutput, const int16_t* endOfLastWrite) const;
+    void makeRoomFor(int numSamples);
 
     int _frameCapacity;
     int _sampleCapacity;
     int _bufferLength;      // actual length of _buffer: will be one frame larger than _sampleCapacity
     int _numFrameSamples;
-    int16_t* _nextOutput;
-    int16_t* _endOfLastWrite;
     int16_t* _buffer;
     bool _randomAccessMode; /// will this ringbuffer be used for random access? if so, do some special processing
 
-    int _overflowCount; /// how many times has the ring buffer has overwritten old data
+    std::atomic<int> _overflowCount; /// how many times has the ring buffer has overwritten old data
+
+    // the read and write positions live on their own cache lines so the reader and writer don't contend
+    static const int CACHE_LINE_SIZE = 64;
+    char _readPadding[CACHE_LINE_SIZE];
+    std::atomic<int16_t*> _nextOutput;
+    char _writePadding[CACHE_LINE_SIZE - sizeof(std::atomic<int16_t*>)];
+    std::atomic<int16_t*> _endOfLastWrite;
+    char _endPadding[CACHE_LINE_SIZE - sizeof(std::atomic<int16_t*>)];
 
 public:
     class ConstIterator { //public std::iterator < std::forward_iterator_tag, int16_t > {
@@ -174,13 +193,20 @@ public:
         int16_t* _at;
     };
 
-    ConstIterator nextOutput() const { return ConstIterator(_buffer, _bufferLength, _nextOutput); }
-    ConstIterator lastFrameWritten() const { return ConstIterator(_buffer, _bufferLength, _endOfLastWrite) - _numFrameSamples; }
+    ConstIterator nextOutput() const {
+        return ConstIterator(_buffer, _bufferLength, _nextOutput.load(std::memory_order_acquire));
+    }
+    ConstIterator lastFrameWritten() const {
+        return ConstIterator(_buffer, _bufferLength, _endOfLastWrite.load(std::memory_order_relaxed)) - _numFrameSamples;
+    }
 
     float getFrameLoudness(ConstIterator frameStart) const;
 
     int writeSamples(ConstIterator source, int maxSamples);
     int writeSamplesWithFade(ConstIterator source, int maxSamples, float fade);
+
+    /// moves the read position forward by up to the number of samples available, returns where the shift started
+    ConstIterator shiftReadPosition(unsigned int numSamples);
 };
 
 #endif // hifi_AudioRingBuffer_h
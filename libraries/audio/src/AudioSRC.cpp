@@ -13,6 +13,8 @@
 #include <string.h>
 #include <algorithm>
 
+#include <CPUDetect.h>
+
 #include "AudioSRC.h"
 
 //
@@ -737,11 +739,18 @@ int AudioSRC::createIrrationalFilter(int upFactor, int downFactor, float gain) {
 //
 // on x86 architecture, assume that SSE2 is present
 //
-#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#if defined(ARCH_X86)
 
 #include <emmintrin.h>
 
+// the AVX2 kernels double the FIR width, and are used whenever the CPU and OS support them
+static const bool SRC_USE_AVX2 = cpuSupportsAVX2();
+
 int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFrames) {
+    if (SRC_USE_AVX2) {
+        return multirateFilter1_AVX2(input0, output0, inputFrames);
+    }
+
     int outputFrames = 0;
 
     assert((_numTaps & 0x3) == 0);  // SIMD4
@@ -822,6 +831,10 @@ int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFra
 }
 
 int AudioSRC::multirateFilter2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames) {
+    if (SRC_USE_AVX2) {
+        return multirateFilter2_AVX2(input0, input1, output0, output1, inputFrames);
+    }
+
     int outputFrames = 0;
 
     assert((_numTaps & 0x3) == 0);  // SIMD4
@@ -913,6 +926,11 @@ int AudioSRC::multirateFilter2(const float* input0, const float* input1, float*
 
 // convert int16_t to float, deinterleave stereo
 void AudioSRC::convertInputFromInt16(const int16_t* input, float** outputs, int numFrames) {
+    if (SRC_USE_AVX2) {
+        convertInputFromInt16_AVX2(input, outputs, numFrames);
+        return;
+    }
+
     __m128 scale = _mm_set1_ps(1/32768.0f);
 
     if (_numChannels == 1) {
@@ -1062,6 +1080,277 @@ void AudioSRC::convertOutputToInt16(float** inputs, int16_t* output, int numFram
     }
 }
 
+#elif defined(ARCH_NEON)
+
+#include <arm_neon.h>
+
+static inline float horizontalSum(float32x4_t acc) {
+    float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(sum, sum), 0);
+}
+
+int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFrames) {
+    int outputFrames = 0;
+
+    assert((_numTaps & 0x3) == 0);  // SIMD4
+
+    if (_step == 0) {   // rational
+
+        int32_t i = hi32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            float32x4_t acc0 = vdupq_n_f32(0.0f);
+
+            for (int j = 0; j < _numTaps; j += 4) {
+
+                //float coef = c0[j];
+                float32x4_t coef0 = vld1q_f32(&c0[j]);
+
+                //acc0 += input0[i + j] * coef;
+                acc0 = vmlaq_f32(acc0, vld1q_f32(&input0[i + j]), coef0);
+            }
+
+            output0[outputFrames] = horizontalSum(acc0);
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (hi32(_offset) < inputFrames) {
+
+            int32_t i = hi32(_offset);
+            uint32_t f = lo32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            float32x4_t frac = vdupq_n_f32((f & SRC_FRACMASK) * QFRAC_TO_FLOAT);
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            float32x4_t acc0 = vdupq_n_f32(0.0f);
+
+            for (int j = 0; j < _numTaps; j += 4) {
+
+                //float coef = c0[j] + frac * (c1[j] - c0[j]);
+                float32x4_t coef0 = vld1q_f32(&c0[j]);
+                float32x4_t coef1 = vld1q_f32(&c1[j]);
+                coef0 = vmlaq_f32(coef0, vsubq_f32(coef1, coef0), frac);
+
+                //acc0 += input0[i + j] * coef;
+                acc0 = vmlaq_f32(acc0, vld1q_f32(&input0[i + j]), coef0);
+            }
+
+            output0[outputFrames] = horizontalSum(acc0);
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+
+    return outputFrames;
+}
+
+int AudioSRC::multirateFilter2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames) {
+    int outputFrames = 0;
+
+    assert((_numTaps & 0x3) == 0);  // SIMD4
+
+    if (_step == 0) {   // rational
+
+        int32_t i = hi32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            float32x4_t acc0 = vdupq_n_f32(0.0f);
+            float32x4_t acc1 = vdupq_n_f32(0.0f);
+
+            for (int j = 0; j < _numTaps; j += 4) {
+
+                //float coef = c0[j];
+                float32x4_t coef0 = vld1q_f32(&c0[j]);
+
+                //acc0 += input0[i + j] * coef;
+                acc0 = vmlaq_f32(acc0, vld1q_f32(&input0[i + j]), coef0);
+                acc1 = vmlaq_f32(acc1, vld1q_f32(&input1[i + j]), coef0);
+            }
+
+            output0[outputFrames] = horizontalSum(acc0);
+            output1[outputFrames] = horizontalSum(acc1);
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (hi32(_offset) < inputFrames) {
+
+            int32_t i = hi32(_offset);
+            uint32_t f = lo32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            float32x4_t frac = vdupq_n_f32((f & SRC_FRACMASK) * QFRAC_TO_FLOAT);
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            float32x4_t acc0 = vdupq_n_f32(0.0f);
+            float32x4_t acc1 = vdupq_n_f32(0.0f);
+
+            for (int j = 0; j < _numTaps; j += 4) {
+
+                //float coef = c0[j] + frac * (c1[j] - c0[j]);
+                float32x4_t coef0 = vld1q_f32(&c0[j]);
+                float32x4_t coef1 = vld1q_f32(&c1[j]);
+                coef0 = vmlaq_f32(coef0, vsubq_f32(coef1, coef0), frac);
+
+                //acc0 += input0[i + j] * coef;
+                acc0 = vmlaq_f32(acc0, vld1q_f32(&input0[i + j]), coef0);
+                acc1 = vmlaq_f32(acc1, vld1q_f32(&input1[i + j]), coef0);
+            }
+
+            output0[outputFrames] = horizontalSum(acc0);
+            output1[outputFrames] = horizontalSum(acc1);
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+
+    return outputFrames;
+}
+
+// convert int16_t to float, deinterleave stereo
+void AudioSRC::convertInputFromInt16(const int16_t* input, float** outputs, int numFrames) {
+    const float scale = 1/32768.0f;
+
+    if (_numChannels == 1) {
+
+        int i = 0;
+        for (; i < numFrames - 3; i += 4) {
+            // sign-extend
+            int32x4_t a0 = vmovl_s16(vld1_s16(&input[i]));
+
+            vst1q_f32(&outputs[0][i], vmulq_n_f32(vcvtq_f32_s32(a0), scale));
+        }
+        for (; i < numFrames; i++) {
+            outputs[0][i] = (float)input[i] * scale;
+        }
+
+    } else if (_numChannels == 2) {
+
+        int i = 0;
+        for (; i < numFrames - 3; i += 4) {
+            // deinterleave and sign-extend
+            int16x4x2_t a = vld2_s16(&input[2*i]);
+            int32x4_t a0 = vmovl_s16(a.val[0]);
+            int32x4_t a1 = vmovl_s16(a.val[1]);
+
+            vst1q_f32(&outputs[0][i], vmulq_n_f32(vcvtq_f32_s32(a0), scale));
+            vst1q_f32(&outputs[1][i], vmulq_n_f32(vcvtq_f32_s32(a1), scale));
+        }
+        for (; i < numFrames; i++) {
+            outputs[0][i] = (float)input[2*i + 0] * scale;
+            outputs[1][i] = (float)input[2*i + 1] * scale;
+        }
+    }
+}
+
+// fast TPDF dither in [-1.0f, 1.0f]
+static inline float32x4_t dither4() {
+    static const int16_t multipliers[8] = { -3495, 30185, -27591, 19445, -23279, -5975, -25511, 25173 };
+    static const int16_t increments[8] = { 28013, -13225, -32679, -7701, -19675, 105, -32767, 13849 };
+    static int16x8_t rz;
+
+    // update the 8 different maximum-length LCGs
+    rz = vmlaq_s16(vld1q_s16(increments), rz, vld1q_s16(multipliers));
+
+    // promote to 32-bit
+    uint16x8_t r = vreinterpretq_u16_s16(rz);
+    int32x4_t r0 = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(r)));
+    int32x4_t r1 = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(r)));
+
+    // return (r0 - r1) * (1/65536.0f);
+    return vmulq_n_f32(vcvtq_f32_s32(vsubq_s32(r0, r1)), 1/65536.0f);
+}
+
+// round to nearest, then saturate to int16_t
+static inline int16x4_t roundAndSaturate(float32x4_t f) {
+    uint32x4_t negative = vcltq_f32(f, vdupq_n_f32(0.0f));
+    f = vaddq_f32(f, vbslq_f32(negative, vdupq_n_f32(-0.5f), vdupq_n_f32(+0.5f)));
+    return vqmovn_s32(vcvtq_s32_f32(f));
+}
+
+// convert float to int16_t, interleave stereo
+void AudioSRC::convertOutputToInt16(float** inputs, int16_t* output, int numFrames) {
+    const float scale = 32768.0f;
+
+    if (_numChannels == 1) {
+
+        int i = 0;
+        for (; i < numFrames - 3; i += 4) {
+            float32x4_t f0 = vmulq_n_f32(vld1q_f32(&inputs[0][i]), scale);
+
+            f0 = vaddq_f32(f0, dither4());
+
+            vst1_s16(&output[i], roundAndSaturate(f0));
+        }
+        for (; i < numFrames; i++) {
+            float32x4_t f0 = vmulq_n_f32(vdupq_n_f32(inputs[0][i]), scale);
+
+            f0 = vaddq_f32(f0, dither4());
+
+            output[i] = vget_lane_s16(roundAndSaturate(f0), 0);
+        }
+
+    } else if (_numChannels == 2) {
+
+        int i = 0;
+        for (; i < numFrames - 3; i += 4) {
+            float32x4_t f0 = vmulq_n_f32(vld1q_f32(&inputs[0][i]), scale);
+            float32x4_t f1 = vmulq_n_f32(vld1q_f32(&inputs[1][i]), scale);
+
+            float32x4_t d0 = dither4();
+            f0 = vaddq_f32(f0, d0);
+            f1 = vaddq_f32(f1, d0);
+
+            // interleave
+            int16x4x2_t a;
+            a.val[0] = roundAndSaturate(f0);
+            a.val[1] = roundAndSaturate(f1);
+            vst2_s16(&output[2*i], a);
+        }
+        for (; i < numFrames; i++) {
+            float32x4_t f0 = vmulq_n_f32(vdupq_n_f32(inputs[0][i]), scale);
+            float32x4_t f1 = vmulq_n_f32(vdupq_n_f32(inputs[1][i]), scale);
+
+            float32x4_t d0 = dither4();
+            f0 = vaddq_f32(f0, d0);
+            f1 = vaddq_f32(f1, d0);
+
+            output[2*i + 0] = vget_lane_s16(roundAndSaturate(f0), 0);
+            output[2*i + 1] = vget_lane_s16(roundAndSaturate(f1), 0);
+        }
+    }
+}
+
 #else
 
 int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFrames) {
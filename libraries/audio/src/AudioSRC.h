@@ -60,6 +60,11 @@ private:
     void convertInputFromInt16(const int16_t* input, float** outputs, int numFrames);
     void convertOutputToInt16(float** inputs, int16_t* output, int numFrames);
 
+    // AVX2 versions, defined in avx2/AudioSRC_avx2.cpp and only called once cpuSupportsAVX2() has passed
+    int multirateFilter1_AVX2(const float* input0, float* output0, int inputFrames);
+    int multirateFilter2_AVX2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames);
+    void convertInputFromInt16_AVX2(const int16_t* input, float** outputs, int numFrames);
+
     int processFloat(float** inputs, float** outputs, int inputFrames);
 };
 
@@ -0,0 +1,97 @@
+//
+//  AudioSpatialization.cpp
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSpatialization.h"
+
+#include <glm/gtx/vector_angle.hpp>
+
+#include <NumericalConstants.h>
+
+float AudioSpatialization::computeDistanceAttenuation(float distance, float attenuationPerDoublingInDistance) {
+    if (distance < ATTENUATION_BEGINS_AT_DISTANCE) {
+        return 1.0f;
+    }
+
+    float distanceCoefficient = 1.0f - (logf(distance / ATTENUATION_BEGINS_AT_DISTANCE) / logf(2.0f)
+                                        * attenuationPerDoublingInDistance);
+    return distanceCoefficient < 0.0f ? 0.0f : distanceCoefficient;
+}
+
+float AudioSpatialization::computeBearing(const glm::vec3& relativePosition, const glm::quat& listenerOrientation) {
+    glm::vec3 rotatedSourcePosition = glm::inverse(listenerOrientation) * relativePosition;
+
+    // project the rotated source position vector onto the XZ plane
+    rotatedSourcePosition.y = 0.0f;
+    if (glm::length(rotatedSourcePosition) < EPSILON) {
+        // right above or below the listener
+        return 0.0f;
+    }
+
+    // produce an oriented angle about the y-axis
+    return glm::orientedAngle(glm::vec3(0.0f, 0.0f, -1.0f), glm::normalize(rotatedSourcePosition),
+                              glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+void AudioSpatialization::computePhasePanning(float bearing, float distance,
+                                              int& numSamplesDelay, float& weakChannelAmplitudeRatio) {
+    const float PHASE_AMPLITUDE_RATIO_AT_90 = 0.5;
+
+    // figure out the number of samples of delay and the ratio of the amplitude
+    // in the weak channel for audio spatialization
+    float sinRatio = fabsf(sinf(bearing));
+    numSamplesDelay = SAMPLE_PHASE_DELAY_AT_90 * sinRatio;
+    weakChannelAmplitudeRatio = 1 - (PHASE_AMPLITUDE_RATIO_AT_90 * sinRatio);
+
+    if (distance < RADIUS_OF_HEAD) {
+        // Diminish phase panning if source would be inside head
+        numSamplesDelay *= distance / RADIUS_OF_HEAD;
+        weakChannelAmplitudeRatio += (PHASE_AMPLITUDE_RATIO_AT_90 * sinRatio) * distance / RADIUS_OF_HEAD;
+    }
+}
+
+void AudioSpatialization::computePenumbraFilterGains(float bearing, float distance,
+                                                     float& penumbraFilterGainL, float& penumbraFilterGainR) {
+    const float TWO_OVER_PI = 2.0f / PI;
+
+    const float ZERO_DB = 1.0f;
+    const float NEGATIVE_ONE_DB = 0.891f;
+    const float NEGATIVE_THREE_DB = 0.708f;
+
+    const float FILTER_GAIN_AT_0 = ZERO_DB; // source is in front
+    const float FILTER_GAIN_AT_90 = NEGATIVE_ONE_DB; // source is incident to left or right ear
+    const float FILTER_GAIN_AT_180 = NEGATIVE_THREE_DB; // source is behind
+
+    // variable gain calculation broken down by quadrant
+    if (-bearing < -PI_OVER_TWO && -bearing > -PI) {
+        penumbraFilterGainL = TWO_OVER_PI *
+            (FILTER_GAIN_AT_0 - FILTER_GAIN_AT_180) * (-bearing + PI_OVER_TWO) + FILTER_GAIN_AT_0;
+        penumbraFilterGainR = TWO_OVER_PI *
+            (FILTER_GAIN_AT_90 - FILTER_GAIN_AT_180) * (-bearing + PI_OVER_TWO) + FILTER_GAIN_AT_90;
+    } else if (-bearing <= PI && -bearing > PI_OVER_TWO) {
+        penumbraFilterGainL = TWO_OVER_PI *
+            (FILTER_GAIN_AT_180 - FILTER_GAIN_AT_90) * (-bearing - PI) + FILTER_GAIN_AT_180;
+        penumbraFilterGainR = TWO_OVER_PI *
+            (FILTER_GAIN_AT_180 - FILTER_GAIN_AT_0) * (-bearing - PI) + FILTER_GAIN_AT_180;
+    } else if (-bearing <= PI_OVER_TWO && -bearing > 0) {
+        penumbraFilterGainL = TWO_OVER_PI *
+            (FILTER_GAIN_AT_90 - FILTER_GAIN_AT_0) * (-bearing - PI_OVER_TWO) + FILTER_GAIN_AT_90;
+        penumbraFilterGainR = FILTER_GAIN_AT_0;
+    } else {
+        penumbraFilterGainL = FILTER_GAIN_AT_0;
+        penumbraFilterGainR =  TWO_OVER_PI *
+            (FILTER_GAIN_AT_0 - FILTER_GAIN_AT_90) * (-bearing) + FILTER_GAIN_AT_0;
+    }
+
+    if (distance < RADIUS_OF_HEAD) {
+        // Diminish effect if source would be inside head
+        penumbraFilterGainL += (1.0f - penumbraFilterGainL) * (1.0f - distance / RADIUS_OF_HEAD);
+        penumbraFilterGainR += (1.0f - penumbraFilterGainR) * (1.0f - distance / RADIUS_OF_HEAD);
+    }
+}
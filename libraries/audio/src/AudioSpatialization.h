@@ -0,0 +1,49 @@
+//
+//  AudioSpatialization.h
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSpatialization_h
+#define hifi_AudioSpatialization_h
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// How a mono source is placed around a listener: quieter the further it is, and for each ear weaker, later and
+// duller the more it is off to the other side.  The audio-mixer places the sources it mixes this way, and the client
+// the local sounds it plays without sending them through the mixer.
+namespace AudioSpatialization {
+
+    const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
+    const float DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE = 0.18f;
+
+    const float RADIUS_OF_HEAD = 0.076f;
+
+    // delay of the weak channel when the source is right beside the listener, in samples at the network sample rate
+    const int SAMPLE_PHASE_DELAY_AT_90 = 20;
+
+    // the penumbra filter is a high shelf whose gain depends on the source bearing, from 0dB in front to -3dB behind
+    const float PENUMBRA_FILTER_FREQUENCY_HZ = 1000.0f;
+    const float PENUMBRA_FILTER_SLOPE = 0.708f;
+
+    // gain from the distance between the source and the listener
+    float computeDistanceAttenuation(float distance,
+                                     float attenuationPerDoublingInDistance = DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE);
+
+    // angle about the up axis of the listener from straight ahead to the source, positive to the left
+    float computeBearing(const glm::vec3& relativePosition, const glm::quat& listenerOrientation);
+
+    // delay in samples and amplitude ratio of the channel away from the source
+    void computePhasePanning(float bearing, float distance, int& numSamplesDelay, float& weakChannelAmplitudeRatio);
+
+    // gain of the penumbra filter for each ear
+    void computePenumbraFilterGains(float bearing, float distance, float& penumbraFilterGainL, float& penumbraFilterGainR);
+
+}
+
+#endif // hifi_AudioSpatialization_h
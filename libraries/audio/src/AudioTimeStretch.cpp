@@ -0,0 +1,108 @@
+//
+//  AudioTimeStretch.cpp
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+#include <string.h>
+
+#include "AudioTimeStretch.h"
+
+namespace AudioTimeStretch {
+
+// the lag at which the start of the block best matches the block further on, by normalized cross-correlation
+static int findBestLag(const int16_t* input, int numChannels) {
+    // the channels are summed so that stereo is matched as a whole
+    float reference[OVERLAP_FRAMES + MAX_LAG_FRAMES];
+    for (int i = 0; i < OVERLAP_FRAMES + MAX_LAG_FRAMES; i++) {
+        float sum = 0.0f;
+        for (int c = 0; c < numChannels; c++) {
+            sum += input[numChannels * i + c];
+        }
+        reference[i] = sum;
+    }
+
+    float referenceEnergy = 0.0f;
+    for (int i = 0; i < OVERLAP_FRAMES; i++) {
+        referenceEnergy += reference[i] * reference[i];
+    }
+
+    // a periodic signal matches at every multiple of its period, so a longer lag has to match clearly better
+    const float LONGER_LAG_MARGIN = 0.01f;
+
+    int bestLag = MIN_LAG_FRAMES;
+    float bestScore = -INFINITY;
+
+    for (int lag = MIN_LAG_FRAMES; lag <= MAX_LAG_FRAMES; lag++) {
+        float correlation = 0.0f;
+        float energy = 0.0f;
+        for (int i = 0; i < OVERLAP_FRAMES; i++) {
+            correlation += reference[i] * reference[lag + i];
+            energy += reference[lag + i] * reference[lag + i];
+        }
+
+        // energy is added to so that silence does not divide by zero
+        float score = correlation / sqrtf(referenceEnergy * energy + 1.0f);
+        if (score > bestScore + LONGER_LAG_MARGIN) {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+
+    return bestLag;
+}
+
+// output[i] = from[i] faded out while to[i] is faded in, over OVERLAP_FRAMES frames
+static void crossfade(const int16_t* from, const int16_t* to, int16_t* output, int numChannels) {
+    for (int i = 0; i < OVERLAP_FRAMES; i++) {
+        float fadeIn = (float)i / OVERLAP_FRAMES;
+        for (int c = 0; c < numChannels; c++) {
+            int j = numChannels * i + c;
+            output[j] = (int16_t)lrintf(from[j] + fadeIn * (to[j] - from[j]));
+        }
+    }
+}
+
+int compress(const int16_t* input, int16_t* output, int numFrames, int numChannels) {
+    if (numFrames < MIN_BLOCK_FRAMES) {
+        memcpy(output, input, numFrames * numChannels * sizeof(int16_t));
+        return numFrames;
+    }
+
+    int lag = findBestLag(input, numChannels);
+
+    // fade from the start of the block into the same spot one lag further on, which skips lag frames
+    crossfade(&input[0], &input[numChannels * lag], &output[0], numChannels);
+
+    int remaining = numFrames - (lag + OVERLAP_FRAMES);
+    memcpy(&output[numChannels * OVERLAP_FRAMES], &input[numChannels * (lag + OVERLAP_FRAMES)],
+           remaining * numChannels * sizeof(int16_t));
+
+    return numFrames - lag;
+}
+
+int expand(const int16_t* input, int16_t* output, int numFrames, int numChannels) {
+    if (numFrames < MIN_BLOCK_FRAMES) {
+        memcpy(output, input, numFrames * numChannels * sizeof(int16_t));
+        return numFrames;
+    }
+
+    int lag = findBestLag(input, numChannels);
+
+    // play up to one lag in, then fade back to the start of the block, which repeats lag frames
+    memcpy(&output[0], &input[0], lag * numChannels * sizeof(int16_t));
+    crossfade(&input[numChannels * lag], &input[0], &output[numChannels * lag], numChannels);
+
+    int remaining = numFrames - OVERLAP_FRAMES;
+    memcpy(&output[numChannels * (lag + OVERLAP_FRAMES)], &input[numChannels * OVERLAP_FRAMES],
+           remaining * numChannels * sizeof(int16_t));
+
+    return numFrames + lag;
+}
+
+}
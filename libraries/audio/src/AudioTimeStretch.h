@@ -0,0 +1,40 @@
+//
+//  AudioTimeStretch.h
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioTimeStretch_h
+#define hifi_AudioTimeStretch_h
+
+#include <stdint.h>
+
+//
+// Shortens or lengthens a block of audio by about one pitch period without changing its pitch (WSOLA).
+// The block is spliced onto a copy of itself shifted by the lag at which the two look most alike, with a short
+// crossfade over the splice, so the first and last samples of the block are kept and it joins up seamlessly with
+// the audio around it.
+//
+namespace AudioTimeStretch {
+
+    // the lags that are searched, covering the pitch of most voices at 24kHz
+    const int MIN_LAG_FRAMES = 48;
+    const int MAX_LAG_FRAMES = 160;
+
+    // length of the crossfade over the splice
+    const int OVERLAP_FRAMES = 64;
+
+    // blocks shorter than this are left alone
+    const int MIN_BLOCK_FRAMES = MAX_LAG_FRAMES + OVERLAP_FRAMES;
+
+    // interleaved input and output, output needs room for numFrames + MAX_LAG_FRAMES frames.
+    // Return the number of frames written to output, which is numFrames if the block is too short to stretch.
+    int compress(const int16_t* input, int16_t* output, int numFrames, int numChannels);
+    int expand(const int16_t* input, int16_t* output, int numFrames, int numChannels);
+}
+
+#endif // hifi_AudioTimeStretch_h
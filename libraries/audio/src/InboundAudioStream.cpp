@@ -9,11 +9,14 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <glm/glm.hpp>
 
 #include <NLPacket.h>
 #include <Node.h>
 
+#include "AudioTimeStretch.h"
 #include "InboundAudioStream.h"
 
 const int STARVE_HISTORY_CAPACITY = 50;
@@ -47,8 +50,17 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
     _currentJitterBufferFrames(0),
     _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _repetitionWithFade(settings._repetitionWithFade),
+    _timeStretch(settings._timeStretch),
+    _timeStretchPercentile(settings._timeStretchPercentile),
+    _nextTimeGapForTimeStretch(0),
+    _calculatedJitterBufferFramesUsingPercentile(0),
+    _framesAvailableOnArrivalAverage(0.0f),
+    _framesSinceTimeStretch(0),
+    _nextDroppedPacket(0),
+    _lastPlayoutSequence(0),
     _hasReverb(false)
 {
+    memset(_droppedPackets, 0, sizeof(_droppedPackets));
 }
 
 void InboundAudioStream::reset() {
@@ -77,6 +89,13 @@ void InboundAudioStream::resetStats() {
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
     _timeGapStatsForStatsPacket.reset();
+    _timeGapsForTimeStretch.clear();
+    _nextTimeGapForTimeStretch = 0;
+    _calculatedJitterBufferFramesUsingPercentile = 0;
+    _framesAvailableOnArrivalAverage = 0.0f;
+    _framesSinceTimeStretch = 0;
+    memset(_droppedPackets, 0, sizeof(_droppedPackets));
+    _nextDroppedPacket = 0;
 }
 
 void InboundAudioStream::clearBuffer() {
@@ -96,6 +115,7 @@ void InboundAudioStream::perSecondCallbackForUpdatingStats() {
     _timeGapStatsForDesiredCalcOnTooManyStarves.currentIntervalComplete();
     _timeGapStatsForDesiredReduction.currentIntervalComplete();
     _timeGapStatsForStatsPacket.currentIntervalComplete();
+    updateTimeStretchTarget();
 }
 
 int InboundAudioStream::parseData(ReceivedMessage& message) {
@@ -108,12 +128,31 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
 
     packetReceivedUpdateTimingStats();
 
+    // mixed audio names the codec it was encoded with right after the sequence number
+    QString codecInPacket;
+    if (message.getType() == PacketType::MixedAudio) {
+        codecInPacket = AudioCodecs::readCodecName(message);
+    }
+
     int networkSamples;
     
     // parse the info after the seq number and before the audio data (the stream properties)
     int prePropertyPosition = message.getPosition();
     int propertyBytes = parseStreamProperties(message.getType(), message.readWithoutCopy(message.getBytesLeftToRead()), networkSamples);
     message.seek(prePropertyPosition + propertyBytes);
+
+    // encoded audio is decoded up front, since only the decoded audio tells us how many samples the packet holds
+    bool isEncoded = !codecInPacket.isEmpty();
+    QByteArray decodedBuffer;
+    if (isEncoded) {
+        if (_decoder && codecInPacket == _selectedCodecName) {
+            _decoder->decode(message.readWithoutCopy(message.getBytesLeftToRead()), decodedBuffer);
+        }
+
+        // audio we can't decode is treated like a dropped packet, and mixed audio is always one stereo network frame
+        networkSamples = decodedBuffer.isEmpty() ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
+                                                 : decodedBuffer.size() / sizeof(int16_t);
+    }
     
     // handle this packet based on its arrival status.
     switch (arrivalInfo._status) {
@@ -122,22 +161,50 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
             // NOTE: we assume that each dropped packet contains the same number of samples
             // as the packet we just received.
             int packetsDropped = arrivalInfo._seqDiffFromExpected;
-            writeSamplesForDroppedPackets(packetsDropped * networkSamples);
+            int droppedOffset = _ringBuffer.getWriteOffset();
+            int droppedSamplesWritten = writeSamplesForDroppedPackets(packetsDropped * networkSamples);
+
+            // remember where each dropped packet went, unless some of its silence was dropped to cut latency
+            if (canReplaceDroppedPackets() && droppedSamplesWritten == packetsDropped * networkSamples) {
+                int firstTracked = std::max(0, packetsDropped - MAX_DROPPED_PACKETS_TRACKED);
+                for (int i = firstTracked; i < packetsDropped; i++) {
+                    DroppedPacket& dropped = _droppedPackets[_nextDroppedPacket];
+                    dropped.sequence = (quint16)(sequence - packetsDropped + i);
+                    dropped.ringBufferOffset = droppedOffset + i * networkSamples;
+                    dropped.numSamples = networkSamples;
+                    _nextDroppedPacket = (_nextDroppedPacket + 1) % MAX_DROPPED_PACKETS_TRACKED;
+                }
+            }
 
             // fall through to OnTime case
         }
         case SequenceNumberStats::OnTime: {
             // Packet is on time; parse its data to the ringbuffer
+            _lastPlayoutSequence = sequence;
             if (message.getType() == PacketType::SilentAudioFrame) {
                 writeDroppableSilentSamples(networkSamples);
+            } else if (isEncoded) {
+                if (decodedBuffer.isEmpty()) {
+                    writeSamplesForDroppedPackets(networkSamples);
+                } else {
+                    parseAudioDataForPlayout(message.getType(), decodedBuffer, networkSamples);
+                }
             } else {
-                parseAudioData(message.getType(), message.readWithoutCopy(message.getBytesLeftToRead()), networkSamples);
+                parseAudioDataForPlayout(message.getType(), message.readWithoutCopy(message.getBytesLeftToRead()),
+                                         networkSamples);
+            }
+            break;
+        }
+        case SequenceNumberStats::Recovered: {
+            // a packet we wrote samples in place of has turned up, fill in its frame if it hasn't been mixed yet.
+            // encoded audio can't go over the placeholder: the decoder would be fed frames out of order
+            if (!isEncoded && message.getType() != PacketType::SilentAudioFrame && canReplaceDroppedPackets()) {
+                replaceDroppedPacket(sequence, message.readWithoutCopy(message.getBytesLeftToRead()), networkSamples);
             }
             break;
         }
         default: {
-            // For now, late packets are ignored.  It may be good in the future to insert the late audio packet data
-            // into the ring buffer to fill in the missing frame if it hasn't been mixed yet.
+            // other late packets (duplicates and packets from too far back) are ignored
             break;
         }
     }
@@ -147,23 +214,49 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
     if (_isStarved && framesAvailable >= _desiredJitterBufferFrames) {
         _isStarved = false;
     }
-    // if the ringbuffer exceeds the desired size by more than the threshold specified,
-    // drop the oldest frames so the ringbuffer is down to the desired size.
-    if (framesAvailable > _desiredJitterBufferFrames + _maxFramesOverDesired) {
-        int framesToDrop = framesAvailable - (_desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING);
-        _ringBuffer.shiftReadPosition(framesToDrop * _ringBuffer.getNumFrameSamples());
-        
-        _framesAvailableStat.reset();
-        _currentJitterBufferFrames = 0;
-
-        _oldFramesDropped += framesToDrop;
-    }
+    // frames over the desired size are dropped by the reader in dropOldFramesIfNeeded,
+    // so the writer never moves the read position of the ring buffer except on overflow
 
     framesAvailableChanged();
 
     return message.getPosition();
 }
 
+void InboundAudioStream::replaceDroppedPacket(quint16 sequence, const QByteArray& audio, int networkSamples) {
+    if (audio.size() != (int)(networkSamples * sizeof(int16_t))) {
+        return;
+    }
+
+    // the ring buffer offsets are only good while the ring buffer hasn't gone all the way round since
+    quint16 packetsSince = _lastPlayoutSequence - sequence;
+    if (packetsSince * networkSamples >= _ringBuffer.getSampleCapacity()) {
+        return;
+    }
+
+    for (DroppedPacket& dropped : _droppedPackets) {
+        if (dropped.numSamples == networkSamples && dropped.sequence == sequence) {
+            _ringBuffer.replaceUnreadSamples(dropped.ringBufferOffset, reinterpret_cast<const int16_t*>(audio.constData()),
+                                             networkSamples);
+            dropped.numSamples = 0;
+            return;
+        }
+    }
+}
+
+void InboundAudioStream::setupCodec(const AudioCodec* codec, const QString& codecName, int numChannels) {
+    cleanupCodec();
+
+    if (codec) {
+        _selectedCodecName = codecName;
+        _decoder = codec->createDecoder(AudioConstants::SAMPLE_RATE, numChannels);
+    }
+}
+
+void InboundAudioStream::cleanupCodec() {
+    _selectedCodecName.clear();
+    _decoder.reset();
+}
+
 int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) {
     if (type == PacketType::SilentAudioFrame) {
         quint16 numSilentSamples = 0;
@@ -181,6 +274,67 @@ int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packet
     return _ringBuffer.writeData(packetAfterStreamProperties.data(), numAudioSamples * sizeof(int16_t));
 }
 
+int InboundAudioStream::parseAudioDataForPlayout(PacketType type, const QByteArray& packetAfterStreamProperties,
+                                                 int networkSamples) {
+    // a network frame is mono or stereo, anything else is written as is
+    int numChannels = 0;
+    if (networkSamples == AudioConstants::NETWORK_FRAME_SAMPLES_STEREO) {
+        numChannels = AudioConstants::STEREO;
+    } else if (networkSamples == AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL) {
+        numChannels = AudioConstants::MONO;
+    }
+
+    bool canStretch = _timeStretch && numChannels > 0 && _calculatedJitterBufferFramesUsingPercentile > 0
+        && _hasStarted && !_isStarved && packetAfterStreamProperties.size() >= (int)(networkSamples * sizeof(int16_t));
+
+    if (canStretch) {
+        // the frames buffered as a packet arrives have to cover the gap until the next one, follow a smoothed
+        // value so that a single late or early packet does not cause a stretch
+        const float FRAMES_AVAILABLE_ON_ARRIVAL_SMOOTHING = 0.1f;
+        float framesAvailable = (float)_ringBuffer.samplesAvailable() / _ringBuffer.getNumFrameSamples() + 1.0f;
+        _framesAvailableOnArrivalAverage += FRAMES_AVAILABLE_ON_ARRIVAL_SMOOTHING
+            * (framesAvailable - _framesAvailableOnArrivalAverage);
+
+        // each stretch moves the buffer by a fraction of a frame, leave the average time to catch up in between
+        const int MIN_FRAMES_BETWEEN_TIME_STRETCHES = 4;
+        const float TIME_STRETCH_HYSTERESIS_FRAMES = 0.5f;
+
+        float target = _calculatedJitterBufferFramesUsingPercentile;
+        bool shouldCompress = _framesAvailableOnArrivalAverage > target + TIME_STRETCH_HYSTERESIS_FRAMES;
+        bool shouldExpand = _framesAvailableOnArrivalAverage < target - TIME_STRETCH_HYSTERESIS_FRAMES;
+
+        if (++_framesSinceTimeStretch >= MIN_FRAMES_BETWEEN_TIME_STRETCHES && (shouldCompress || shouldExpand)) {
+            const int16_t* input = reinterpret_cast<const int16_t*>(packetAfterStreamProperties.constData());
+            int numFrames = networkSamples / numChannels;
+
+            QByteArray stretched((numFrames + AudioTimeStretch::MAX_LAG_FRAMES) * numChannels * sizeof(int16_t), 0);
+            int16_t* output = reinterpret_cast<int16_t*>(stretched.data());
+
+            int stretchedFrames = shouldCompress ? AudioTimeStretch::compress(input, output, numFrames, numChannels)
+                                                 : AudioTimeStretch::expand(input, output, numFrames, numChannels);
+            stretched.resize(stretchedFrames * numChannels * sizeof(int16_t));
+
+            _framesSinceTimeStretch = 0;
+            return parseAudioData(type, stretched, stretchedFrames * numChannels);
+        }
+    }
+
+    return parseAudioData(type, packetAfterStreamProperties, networkSamples);
+}
+
+void InboundAudioStream::updateTimeStretchTarget() {
+    if (!_timeStretch || _timeGapsForTimeStretch.isEmpty()) {
+        return;
+    }
+
+    QVector<quint64> timeGaps = _timeGapsForTimeStretch;
+    int percentileIndex = std::min((int)(_timeStretchPercentile * timeGaps.size()), timeGaps.size() - 1);
+    std::nth_element(timeGaps.begin(), timeGaps.begin() + percentileIndex, timeGaps.end());
+
+    int frames = ceilf((float)timeGaps[percentileIndex] / (float)AudioConstants::NETWORK_FRAME_USECS);
+    _calculatedJitterBufferFramesUsingPercentile = clampDesiredJitterBufferFramesValue(std::max(frames, 1));
+}
+
 int InboundAudioStream::writeDroppableSilentSamples(int silentSamples) {
     // calculate how many silent frames we should drop.
     int samplesPerFrame = _ringBuffer.getNumFrameSamples();
@@ -209,6 +363,8 @@ int InboundAudioStream::writeDroppableSilentSamples(int silentSamples) {
 }
 
 int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing, bool starveIfNoSamplesPopped) {
+    dropOldFramesIfNeeded();
+
     int samplesPopped = 0;
     int samplesAvailable = _ringBuffer.samplesAvailable();
     if (_isStarved) {
@@ -238,6 +394,8 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing, bool starv
 }
 
 int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing, bool starveIfNoFramesPopped) {
+    dropOldFramesIfNeeded();
+
     int framesPopped = 0;
     int framesAvailable = _ringBuffer.framesAvailable();
     if (_isStarved) {
@@ -266,9 +424,23 @@ int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing, bool starveI
     return framesPopped;
 }
 
+void InboundAudioStream::dropOldFramesIfNeeded() {
+    // if the ringbuffer exceeds the desired size by more than the threshold specified,
+    // drop the oldest frames so the ringbuffer is down to the desired size.
+    int framesAvailable = _ringBuffer.framesAvailable();
+    if (framesAvailable > _desiredJitterBufferFrames + _maxFramesOverDesired) {
+        int framesToDrop = framesAvailable - (_desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING);
+        _ringBuffer.shiftReadPosition(framesToDrop * _ringBuffer.getNumFrameSamples());
+
+        _framesAvailableStat.reset();
+        _currentJitterBufferFrames = 0;
+
+        _oldFramesDropped += framesToDrop;
+    }
+}
+
 void InboundAudioStream::popSamplesNoCheck(int samples) {
-    _lastPopOutput = _ringBuffer.nextOutput();
-    _ringBuffer.shiftReadPosition(samples);
+    _lastPopOutput = _ringBuffer.shiftReadPosition(samples);
     framesAvailableChanged();
 
     _hasStarted = true;
@@ -341,6 +513,8 @@ void InboundAudioStream::setSettings(const Settings& settings) {
     setWindowSecondsForDesiredCalcOnTooManyStarves(settings._windowSecondsForDesiredCalcOnTooManyStarves);
     setWindowSecondsForDesiredReduction(settings._windowSecondsForDesiredReduction);
     setRepetitionWithFade(settings._repetitionWithFade);
+    setTimeStretch(settings._timeStretch);
+    setTimeStretchPercentile(settings._timeStretchPercentile);
 }
 
 void InboundAudioStream::setDynamicJitterBuffers(bool dynamicJitterBuffers) {
@@ -371,6 +545,10 @@ void InboundAudioStream::setWindowSecondsForDesiredReduction(int windowSecondsFo
     _timeGapStatsForDesiredReduction.setWindowIntervals(windowSecondsForDesiredReduction);
 }
 
+void InboundAudioStream::setTimeStretchPercentile(float timeStretchPercentile) {
+    _timeStretchPercentile = glm::clamp(timeStretchPercentile, 0.0f, 1.0f);
+}
+
 
 int InboundAudioStream::clampDesiredJitterBufferFramesValue(int desired) const {
     const int MIN_FRAMES_DESIRED = 0;
@@ -393,6 +571,13 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
         _stdevStatsForDesiredCalcOnTooManyStarves.addValue(gap);
         _timeGapStatsForDesiredReduction.update(gap);
 
+        if (_timeGapsForTimeStretch.size() < TIME_STRETCH_TIME_GAP_HISTORY) {
+            _timeGapsForTimeStretch.push_back(gap);
+        } else {
+            _timeGapsForTimeStretch[_nextTimeGapForTimeStretch] = gap;
+            _nextTimeGapForTimeStretch = (_nextTimeGapForTimeStretch + 1) % TIME_STRETCH_TIME_GAP_HISTORY;
+        }
+
         if (_timeGapStatsForDesiredCalcOnTooManyStarves.getNewStatsAvailableFlag()) {
             _calculatedJitterBufferFramesUsingMaxGap = ceilf((float)_timeGapStatsForDesiredCalcOnTooManyStarves.getWindowMax()
                                                              / (float) AudioConstants::NETWORK_FRAME_USECS);
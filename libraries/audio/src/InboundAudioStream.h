@@ -18,6 +18,7 @@
 #include <ReceivedMessage.h>
 #include <StDev.h>
 
+#include "AudioCodec.h"
 #include "AudioRingBuffer.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
@@ -47,9 +48,15 @@ const int DEFAULT_WINDOW_STARVE_THRESHOLD = 3;
 const int DEFAULT_WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES = 50;
 const int DEFAULT_WINDOW_SECONDS_FOR_DESIRED_REDUCTION = 10;
 const bool DEFAULT_REPETITION_WITH_FADE = true;
+const bool DEFAULT_TIME_STRETCH = false;
+const float DEFAULT_TIME_STRETCH_PERCENTILE = 0.95f;
+
+// the number of most recent packet time gaps the time-stretch percentile is taken over
+const int TIME_STRETCH_TIME_GAP_HISTORY = 1000;
 
 // Audio Env bitset
 const int HAS_REVERB_BIT = 0; // 1st bit
+const int HAS_MIXED_REVERB_BIT = 1; // 2nd bit, the mixer has already added the zone reverb to the mix
 
 class InboundAudioStream : public NodeData {
     Q_OBJECT
@@ -64,7 +71,9 @@ public:
             _windowStarveThreshold(DEFAULT_WINDOW_STARVE_THRESHOLD),
             _windowSecondsForDesiredCalcOnTooManyStarves(DEFAULT_WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES),
             _windowSecondsForDesiredReduction(DEFAULT_WINDOW_SECONDS_FOR_DESIRED_REDUCTION),
-            _repetitionWithFade(DEFAULT_REPETITION_WITH_FADE)
+            _repetitionWithFade(DEFAULT_REPETITION_WITH_FADE),
+            _timeStretch(DEFAULT_TIME_STRETCH),
+            _timeStretchPercentile(DEFAULT_TIME_STRETCH_PERCENTILE)
         {}
 
         Settings(int maxFramesOverDesired, bool dynamicJitterBuffers, int staticDesiredJitterBufferFrames,
@@ -77,7 +86,9 @@ public:
             _windowStarveThreshold(windowStarveThreshold),
             _windowSecondsForDesiredCalcOnTooManyStarves(windowSecondsForDesiredCalcOnTooManyStarves),
             _windowSecondsForDesiredReduction(windowSecondsForDesiredCalcOnTooManyStarves),
-            _repetitionWithFade(repetitionWithFade)
+            _repetitionWithFade(repetitionWithFade),
+            _timeStretch(DEFAULT_TIME_STRETCH),
+            _timeStretchPercentile(DEFAULT_TIME_STRETCH_PERCENTILE)
         {}
 
         // max number of frames over desired in the ringbuffer.
@@ -99,6 +110,11 @@ public:
         // if true, the prev frame will be repeated (fading to silence) for dropped frames.
         // otherwise, silence will be inserted.
         bool _repetitionWithFade;
+
+        // if true, incoming audio is shortened or lengthened by about a pitch period at a time to keep the buffer
+        // at the number of frames that covers _timeStretchPercentile of the recent packet time gaps
+        bool _timeStretch;
+        float _timeStretchPercentile;
     };
 
 public:
@@ -128,6 +144,8 @@ public:
     void setWindowSecondsForDesiredCalcOnTooManyStarves(int windowSecondsForDesiredCalcOnTooManyStarves);
     void setWindowSecondsForDesiredReduction(int windowSecondsForDesiredReduction);
     void setRepetitionWithFade(bool repetitionWithFade) { _repetitionWithFade = repetitionWithFade; }
+    void setTimeStretch(bool timeStretch) { _timeStretch = timeStretch; }
+    void setTimeStretchPercentile(float timeStretchPercentile);
 
     virtual AudioStreamStats getAudioStreamStats() const;
 
@@ -140,6 +158,9 @@ public:
 
     /// returns the desired number of jitter buffer frames using Freddy's method
     int getCalculatedJitterBufferFramesUsingMaxGap() const { return _calculatedJitterBufferFramesUsingMaxGap; }
+
+    /// returns the number of frames the time stretch aims to have buffered when a packet arrives
+    int getCalculatedJitterBufferFramesUsingPercentile() const { return _calculatedJitterBufferFramesUsingPercentile; }
     
     int getWindowSecondsForDesiredReduction() const {
         return _timeGapStatsForDesiredReduction.getWindowIntervals(); }
@@ -147,6 +168,8 @@ public:
         return _timeGapStatsForDesiredCalcOnTooManyStarves.getWindowIntervals(); }
     bool getDynamicJitterBuffers() const { return _dynamicJitterBuffers; }
     bool getRepetitionWithFade() const { return _repetitionWithFade;}
+    bool getTimeStretch() const { return _timeStretch; }
+    float getTimeStretchPercentile() const { return _timeStretchPercentile; }
     int getWindowStarveThreshold() const { return _starveThreshold;}
     bool getUseStDevForJitterCalc() const { return _useStDevForJitterCalc; }
     int getDesiredJitterBufferFrames() const { return _desiredJitterBufferFrames; }
@@ -171,6 +194,11 @@ public:
     float getWetLevel() const { return _wetLevel; }
     void setReverb(float reverbTime, float wetLevel);
     void clearReverb() { _hasReverb = false; }
+
+    /// decodes mixed audio that was encoded with the named codec from here on, a null codec goes back to raw PCM
+    void setupCodec(const AudioCodec* codec, const QString& codecName, int numChannels);
+    void cleanupCodec();
+    const QString& getSelectedCodecName() const { return _selectedCodecName; }
     
 public slots:
     /// This function should be called every second for all the stats to function properly. If dynamic jitter buffers
@@ -184,7 +212,15 @@ private:
 
     int writeSamplesForDroppedPackets(int networkSamples);
 
+    /// fills in the samples written for a dropped packet with its audio, if it arrives before they are played
+    void replaceDroppedPacket(quint16 sequence, const QByteArray& audio, int networkSamples);
+
+    /// parses the audio of a packet, time-stretching it first if the buffer has drifted away from its target
+    int parseAudioDataForPlayout(PacketType type, const QByteArray& packetAfterStreamProperties, int networkSamples);
+    void updateTimeStretchTarget();
+
     void popSamplesNoCheck(int samples);
+    void dropOldFramesIfNeeded(); /// trims the ring buffer from the reader side, so only overflows move its read position
     void framesAvailableChanged();
 
 protected:
@@ -207,6 +243,10 @@ protected:
     /// writes the last written frame repeatedly, gradually fading to silence.
     /// used for writing samples for dropped packets.
     virtual int writeLastFrameRepeatedWithFade(int samples);
+
+    /// can late packets be written over the samples written in their place?
+    /// streams that process what they write, so the samples in the ring buffer no longer line up with packets, can't
+    virtual bool canReplaceDroppedPackets() const { return true; }
     
 protected:
 
@@ -260,11 +300,35 @@ protected:
     MovingMinMaxAvg<quint64> _timeGapStatsForStatsPacket;
 
     bool _repetitionWithFade;
+
+    // time stretch, the target is updated every second from the percentile of the recent time gaps
+    bool _timeStretch;
+    float _timeStretchPercentile;
+    QVector<quint64> _timeGapsForTimeStretch;
+    int _nextTimeGapForTimeStretch;
+    int _calculatedJitterBufferFramesUsingPercentile;
+    float _framesAvailableOnArrivalAverage;
+    int _framesSinceTimeStretch;
+
+    // where the samples for the most recently dropped packets were written, so they can be replaced if the packets
+    // turn up late (e.g. recovered by forward error correction)
+    struct DroppedPacket {
+        quint16 sequence;
+        int ringBufferOffset;
+        int numSamples;
+    };
+    static const int MAX_DROPPED_PACKETS_TRACKED = 16;
+    DroppedPacket _droppedPackets[MAX_DROPPED_PACKETS_TRACKED];
+    int _nextDroppedPacket;
+    quint16 _lastPlayoutSequence;
     
     // Reverb properties
     bool _hasReverb;
     float _reverbTime;
     float _wetLevel;
+
+    QString _selectedCodecName;
+    std::unique_ptr<AudioDecoder> _decoder;
 };
 
 float calculateRepeatedFrameFadeFactor(int indexOfRepeat);
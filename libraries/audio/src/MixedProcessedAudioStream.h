@@ -37,6 +37,9 @@ protected:
     int writeLastFrameRepeatedWithFade(int samples);
     int parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int networkSamples);
 
+    // the device samples are resampled and processed as a stream, they can't be swapped out after the fact
+    bool canReplaceDroppedPackets() const { return false; }
+
 private:
     int networkToDeviceSamples(int networkSamples);
     int deviceToNetworkSamples(int deviceSamples);
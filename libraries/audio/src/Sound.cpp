@@ -14,6 +14,7 @@
 #include <glm/glm.hpp>
 
 #include <QDataStream>
+#include <QThreadPool>
 #include <QtCore/QDebug>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
@@ -56,37 +57,56 @@ Sound::Sound(const QUrl& url, bool isStereo) :
 }
 
 void Sound::downloadFinished(const QByteArray& data) {
-    // replace our byte array with the downloaded data
-    QByteArray rawAudioByteArray = QByteArray(data);
-    QString fileName = getURL().fileName().toLower();
+    // decode the sound in a worker thread, many sounds load at once when a domain does
+    SoundProcessor* soundProcessor = new SoundProcessor(_url, data, _isStereo);
+    connect(soundProcessor, &SoundProcessor::onSuccess, this, &Sound::soundProcessSuccess);
+    QThreadPool::globalInstance()->start(soundProcessor);
+}
+
+void Sound::soundProcessSuccess(QByteArray data, bool stereo) {
+    _byteArray = data;
+    _isStereo = stereo;
+    _isReady = true;
+    emit ready();
+}
+
+SoundProcessor::SoundProcessor(const QUrl& url, const QByteArray& data, bool stereo) :
+    _url(url),
+    _data(data),
+    _isStereo(stereo)
+{
+}
+
+void SoundProcessor::run() {
+    QByteArray outputAudioByteArray;
+    QString fileName = _url.fileName().toLower();
 
     static const QString WAV_EXTENSION = ".wav";
     static const QString RAW_EXTENSION = ".raw";
     if (fileName.endsWith(WAV_EXTENSION)) {
 
-        QByteArray outputAudioByteArray;
+        QByteArray wavAudioByteArray;
 
-        interpretAsWav(rawAudioByteArray, outputAudioByteArray);
-        downSample(outputAudioByteArray);
+        interpretAsWav(_data, wavAudioByteArray);
+        downSample(wavAudioByteArray, outputAudioByteArray);
     } else if (fileName.endsWith(RAW_EXTENSION)) {
         // check if this was a stereo raw file
         // since it's raw the only way for us to know that is if the file was called .stereo.raw
         if (fileName.toLower().endsWith("stereo.raw")) {
             _isStereo = true;
-            qCDebug(audio) << "Processing sound of" << rawAudioByteArray.size() << "bytes from" << getURL() << "as stereo audio file.";
+            qCDebug(audio) << "Processing sound of" << _data.size() << "bytes from" << _url << "as stereo audio file.";
         }
 
         // Process as RAW file
-        downSample(rawAudioByteArray);
+        downSample(_data, outputAudioByteArray);
     } else {
         qCDebug(audio) << "Unknown sound file type";
     }
 
-    _isReady = true;
-    emit ready();
+    emit onSuccess(outputAudioByteArray, _isStereo);
 }
 
-void Sound::downSample(const QByteArray& rawAudioByteArray) {
+void SoundProcessor::downSample(const QByteArray& rawAudioByteArray, QByteArray& outputAudioByteArray) {
     // assume that this was a RAW file and is now an array of samples that are
     // signed, 16-bit, 48Khz
 
@@ -112,10 +132,10 @@ void Sound::downSample(const QByteArray& rawAudioByteArray) {
 
     int numDestinationBytes = numDestinationSamples * sizeof(AudioConstants::AudioSample);
 
-    _byteArray.resize(numDestinationBytes);
+    outputAudioByteArray.resize(numDestinationBytes);
 
-    int16_t* sourceSamples = (int16_t*) rawAudioByteArray.data();
-    int16_t* destinationSamples = (int16_t*) _byteArray.data();
+    const int16_t* sourceSamples = (const int16_t*) rawAudioByteArray.constData();
+    int16_t* destinationSamples = (int16_t*) outputAudioByteArray.data();
 
     if (_isStereo) {
         for (int i = 0; i < numSourceSamples; i += 4) {
@@ -189,7 +209,7 @@ struct CombinedHeader {
     WAVEHeader  wave;
 };
 
-void Sound::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray) {
+void SoundProcessor::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray) {
 
     CombinedHeader fileHeader;
 
@@ -13,6 +13,7 @@
 #define hifi_Sound_h
 
 #include <QtCore/QObject>
+#include <QtCore/QRunnable>
 #include <QtNetwork/QNetworkReply>
 #include <QtScript/qscriptengine.h>
 
@@ -28,22 +29,44 @@ public:
     bool isStereo() const { return _isStereo; }    
     bool isReady() const { return _isReady; }
      
-    const QByteArray& getByteArray() { return _byteArray; }
+    /// The samples in the network format. They are shared by every injection of the sound, which only read them.
+    const QByteArray& getByteArray() const { return _byteArray; }
 
 signals:
     void ready();
-    
+
+protected slots:
+    void soundProcessSuccess(QByteArray data, bool stereo);
+
 private:
     QByteArray _byteArray;
     bool _isStereo;
     bool _isReady;
     
-    void downSample(const QByteArray& rawAudioByteArray);
-    void interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray);
-    
     virtual void downloadFinished(const QByteArray& data) override;
 };
 
+/// Decodes a sound and converts it to the network format in a worker thread.
+class SoundProcessor : public QObject, public QRunnable {
+    Q_OBJECT
+
+public:
+    SoundProcessor(const QUrl& url, const QByteArray& data, bool stereo);
+
+    virtual void run() override;
+
+    void downSample(const QByteArray& rawAudioByteArray, QByteArray& outputAudioByteArray);
+    void interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray);
+
+signals:
+    void onSuccess(QByteArray data, bool stereo);
+
+private:
+    QUrl _url;
+    QByteArray _data;
+    bool _isStereo;
+};
+
 typedef QSharedPointer<Sound> SharedSoundPointer;
 
 Q_DECLARE_METATYPE(SharedSoundPointer)
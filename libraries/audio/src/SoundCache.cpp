@@ -25,6 +25,12 @@ SoundCache::SoundCache(QObject* parent) :
 
 SharedSoundPointer SoundCache::getSound(const QUrl& url) {
     if (QThread::currentThread() != thread()) {
+        // one that is already cached comes straight back, only a new one has to be made on the cache's thread
+        auto cached = getCachedResource(url);
+        if (cached) {
+            return cached.staticCast<Sound>();
+        }
+
         SharedSoundPointer result;
         QMetaObject::invokeMethod(this, "getSound", Qt::BlockingQueuedConnection,
                                   Q_RETURN_ARG(SharedSoundPointer, result), Q_ARG(const QUrl&, url));
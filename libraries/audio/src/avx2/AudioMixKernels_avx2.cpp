@@ -0,0 +1,110 @@
+//
+//  AudioMixKernels_avx2.cpp
+//  libraries/audio/src/avx2
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#include "../AudioMixKernels.h"
+
+void accumulateMonoAVX2(float* mix, const int16_t* input, float gain, int numFrames) {
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 15; i += 16) {
+        // sign-extend
+        __m256i a0 = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)&input[i + 0]));
+        __m256i a1 = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)&input[i + 8]));
+
+        __m256 f0 = _mm256_mul_ps(_mm256_cvtepi32_ps(a0), g);
+        __m256 f1 = _mm256_mul_ps(_mm256_cvtepi32_ps(a1), g);
+
+        _mm256_storeu_ps(&mix[i + 0], _mm256_add_ps(_mm256_loadu_ps(&mix[i + 0]), f0));
+        _mm256_storeu_ps(&mix[i + 8], _mm256_add_ps(_mm256_loadu_ps(&mix[i + 8]), f1));
+    }
+
+    AudioMixKernels::accumulateMonoScalar(&mix[i], &input[i], gain, numFrames - i);
+    _mm256_zeroupper();
+}
+
+void accumulateStereoAVX2(float* mixLeft, float* mixRight, const int16_t* input, float gain, int numFrames) {
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256i a0 = _mm256_loadu_si256((__m256i*)&input[2*i]);
+        __m256i a1 = a0;
+
+        // deinterleave and sign-extend
+        a0 = _mm256_madd_epi16(a0, _mm256_set1_epi32(0x00000001));
+        a1 = _mm256_madd_epi16(a1, _mm256_set1_epi32(0x00010000));
+
+        __m256 f0 = _mm256_mul_ps(_mm256_cvtepi32_ps(a0), g);
+        __m256 f1 = _mm256_mul_ps(_mm256_cvtepi32_ps(a1), g);
+
+        _mm256_storeu_ps(&mixLeft[i], _mm256_add_ps(_mm256_loadu_ps(&mixLeft[i]), f0));
+        _mm256_storeu_ps(&mixRight[i], _mm256_add_ps(_mm256_loadu_ps(&mixRight[i]), f1));
+    }
+
+    AudioMixKernels::accumulateStereoScalar(&mixLeft[i], &mixRight[i], &input[2*i], gain, numFrames - i);
+    _mm256_zeroupper();
+}
+
+void accumulateAVX2(float* mix, const float* input, int numFrames) {
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        _mm256_storeu_ps(&mix[i], _mm256_add_ps(_mm256_loadu_ps(&mix[i]), _mm256_loadu_ps(&input[i])));
+    }
+
+    AudioMixKernels::accumulateScalar(&mix[i], &input[i], numFrames - i);
+    _mm256_zeroupper();
+}
+
+void accumulateWithGainAVX2(float* mix, const float* input, float gain, int numFrames) {
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256 f0 = _mm256_mul_ps(_mm256_loadu_ps(&input[i]), g);
+        _mm256_storeu_ps(&mix[i], _mm256_add_ps(_mm256_loadu_ps(&mix[i]), f0));
+    }
+
+    AudioMixKernels::accumulateWithGainScalar(&mix[i], &input[i], gain, numFrames - i);
+    _mm256_zeroupper();
+}
+
+void convertToInt16AVX2(const float* left, const float* right, int16_t* output, int numFrames) {
+    __m256 scale = _mm256_set1_ps(32768.0f);
+    __m256 minSample = _mm256_set1_ps(-32768.0f);
+    __m256 maxSample = _mm256_set1_ps(32767.0f);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256 f0 = _mm256_mul_ps(_mm256_loadu_ps(&left[i]), scale);
+        __m256 f1 = _mm256_mul_ps(_mm256_loadu_ps(&right[i]), scale);
+
+        // saturate, then round
+        f0 = _mm256_min_ps(_mm256_max_ps(f0, minSample), maxSample);
+        f1 = _mm256_min_ps(_mm256_max_ps(f1, minSample), maxSample);
+        __m256i a0 = _mm256_cvtps_epi32(f0);
+        __m256i a1 = _mm256_cvtps_epi32(f1);
+        a0 = _mm256_packs_epi32(a0, a0);
+        a1 = _mm256_packs_epi32(a1, a1);
+
+        // interleave, packs and unpack both work within each 128-bit lane so the frames come out in order
+        a0 = _mm256_unpacklo_epi16(a0, a1);
+        _mm256_storeu_si256((__m256i*)&output[2*i], a0);
+    }
+
+    AudioMixKernels::convertToInt16Scalar(&left[i], &right[i], &output[2*i], numFrames - i);
+    _mm256_zeroupper();
+}
+
+#endif
@@ -0,0 +1,276 @@
+//
+//  AudioSRC_avx2.cpp
+//  libraries/audio/src/avx2
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(__AVX2__)
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "../AudioSRC.h"
+
+// must match AudioSRC.cpp
+static const int SRC_PHASEBITS = 8;
+static const int SRC_FRACBITS = 32 - SRC_PHASEBITS;
+static const uint32_t SRC_FRACMASK = (1 << SRC_FRACBITS) - 1;
+
+static const float QFRAC_TO_FLOAT = 1.0f / (1 << SRC_FRACBITS);
+
+#define lo32(a)   ((uint32_t)(a))
+#define hi32(a)   ((int32_t)((a) >> 32))
+
+// horizontal sum of 8 lanes, plus the 4-lane accumulator of an odd SIMD4 tail
+static inline float horizontalSum(__m256 acc, __m128 tail) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, tail);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(0,0,0,1)));
+    return _mm_cvtss_f32(sum);
+}
+
+int AudioSRC::multirateFilter1_AVX2(const float* input0, float* output0, int inputFrames) {
+    int outputFrames = 0;
+
+    assert((_numTaps & 0x3) == 0);  // SIMD4
+
+    // taps are padded to SIMD4, so there can be one 4-tap block left over after the SIMD8 loop
+    int numTaps8 = _numTaps & ~0x7;
+
+    if (_step == 0) {   // rational
+
+        int32_t i = hi32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m128 tail0 = _mm_setzero_ps();
+
+            int j = 0;
+            for (; j < numTaps8; j += 8) {
+
+                //float coef = c0[j];
+                __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+
+                //acc0 += input0[i + j] * coef;
+                acc0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input0[i + j]), coef0), acc0);
+            }
+            if (j < _numTaps) {
+                __m128 coef0 = _mm_loadu_ps(&c0[j]);
+                tail0 = _mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0);
+            }
+
+            output0[outputFrames] = horizontalSum(acc0, tail0);
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (hi32(_offset) < inputFrames) {
+
+            int32_t i = hi32(_offset);
+            uint32_t f = lo32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            __m256 frac = _mm256_set1_ps((f & SRC_FRACMASK) * QFRAC_TO_FLOAT);
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m128 tail0 = _mm_setzero_ps();
+
+            int j = 0;
+            for (; j < numTaps8; j += 8) {
+
+                //float coef = c0[j] + frac * (c1[j] - c0[j]);
+                __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+                __m256 coef1 = _mm256_loadu_ps(&c1[j]);
+                coef1 = _mm256_sub_ps(coef1, coef0);
+                coef0 = _mm256_add_ps(_mm256_mul_ps(coef1, frac), coef0);
+
+                //acc0 += input0[i + j] * coef;
+                acc0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input0[i + j]), coef0), acc0);
+            }
+            if (j < _numTaps) {
+                __m128 coef0 = _mm_loadu_ps(&c0[j]);
+                __m128 coef1 = _mm_loadu_ps(&c1[j]);
+                coef1 = _mm_sub_ps(coef1, coef0);
+                coef0 = _mm_add_ps(_mm_mul_ps(coef1, _mm256_castps256_ps128(frac)), coef0);
+
+                tail0 = _mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0);
+            }
+
+            output0[outputFrames] = horizontalSum(acc0, tail0);
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+
+    _mm256_zeroupper();
+    return outputFrames;
+}
+
+int AudioSRC::multirateFilter2_AVX2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames) {
+    int outputFrames = 0;
+
+    assert((_numTaps & 0x3) == 0);  // SIMD4
+
+    // taps are padded to SIMD4, so there can be one 4-tap block left over after the SIMD8 loop
+    int numTaps8 = _numTaps & ~0x7;
+
+    if (_step == 0) {   // rational
+
+        int32_t i = hi32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            __m128 tail0 = _mm_setzero_ps();
+            __m128 tail1 = _mm_setzero_ps();
+
+            int j = 0;
+            for (; j < numTaps8; j += 8) {
+
+                //float coef = c0[j];
+                __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+
+                //acc0 += input0[i + j] * coef;
+                acc0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input0[i + j]), coef0), acc0);
+                acc1 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input1[i + j]), coef0), acc1);
+            }
+            if (j < _numTaps) {
+                __m128 coef0 = _mm_loadu_ps(&c0[j]);
+                tail0 = _mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0);
+                tail1 = _mm_mul_ps(_mm_loadu_ps(&input1[i + j]), coef0);
+            }
+
+            output0[outputFrames] = horizontalSum(acc0, tail0);
+            output1[outputFrames] = horizontalSum(acc1, tail1);
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (hi32(_offset) < inputFrames) {
+
+            int32_t i = hi32(_offset);
+            uint32_t f = lo32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            __m256 frac = _mm256_set1_ps((f & SRC_FRACMASK) * QFRAC_TO_FLOAT);
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            __m128 tail0 = _mm_setzero_ps();
+            __m128 tail1 = _mm_setzero_ps();
+
+            int j = 0;
+            for (; j < numTaps8; j += 8) {
+
+                //float coef = c0[j] + frac * (c1[j] - c0[j]);
+                __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+                __m256 coef1 = _mm256_loadu_ps(&c1[j]);
+                coef1 = _mm256_sub_ps(coef1, coef0);
+                coef0 = _mm256_add_ps(_mm256_mul_ps(coef1, frac), coef0);
+
+                //acc0 += input0[i + j] * coef;
+                acc0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input0[i + j]), coef0), acc0);
+                acc1 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input1[i + j]), coef0), acc1);
+            }
+            if (j < _numTaps) {
+                __m128 coef0 = _mm_loadu_ps(&c0[j]);
+                __m128 coef1 = _mm_loadu_ps(&c1[j]);
+                coef1 = _mm_sub_ps(coef1, coef0);
+                coef0 = _mm_add_ps(_mm_mul_ps(coef1, _mm256_castps256_ps128(frac)), coef0);
+
+                tail0 = _mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0);
+                tail1 = _mm_mul_ps(_mm_loadu_ps(&input1[i + j]), coef0);
+            }
+
+            output0[outputFrames] = horizontalSum(acc0, tail0);
+            output1[outputFrames] = horizontalSum(acc1, tail1);
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+
+    _mm256_zeroupper();
+    return outputFrames;
+}
+
+// convert int16_t to float, deinterleave stereo
+void AudioSRC::convertInputFromInt16_AVX2(const int16_t* input, float** outputs, int numFrames) {
+    __m256 scale = _mm256_set1_ps(1/32768.0f);
+
+    if (_numChannels == 1) {
+
+        int i = 0;
+        for (; i < numFrames - 7; i += 8) {
+            // sign-extend
+            __m256i a0 = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)&input[i]));
+
+            __m256 f0 = _mm256_mul_ps(_mm256_cvtepi32_ps(a0), scale);
+
+            _mm256_storeu_ps(&outputs[0][i], f0);
+        }
+        for (; i < numFrames; i++) {
+            outputs[0][i] = (float)input[i] * (1/32768.0f);
+        }
+
+    } else if (_numChannels == 2) {
+
+        int i = 0;
+        for (; i < numFrames - 7; i += 8) {
+            __m256i a0 = _mm256_loadu_si256((__m256i*)&input[2*i]);
+            __m256i a1 = a0;
+
+            // deinterleave and sign-extend
+            a0 = _mm256_madd_epi16(a0, _mm256_set1_epi32(0x00000001));
+            a1 = _mm256_madd_epi16(a1, _mm256_set1_epi32(0x00010000));
+
+            __m256 f0 = _mm256_mul_ps(_mm256_cvtepi32_ps(a0), scale);
+            __m256 f1 = _mm256_mul_ps(_mm256_cvtepi32_ps(a1), scale);
+
+            _mm256_storeu_ps(&outputs[0][i], f0);
+            _mm256_storeu_ps(&outputs[1][i], f1);
+        }
+        for (; i < numFrames; i++) {
+            outputs[0][i] = (float)input[2*i + 0] * (1/32768.0f);
+            outputs[1][i] = (float)input[2*i + 1] * (1/32768.0f);
+        }
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
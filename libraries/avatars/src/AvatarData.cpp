@@ -290,12 +290,16 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
         *destinationBuffer++ = validity;
     }
 
+    // the rotations are packed as the smallest three components of each quat, at this many bits each
+    *destinationBuffer++ = _jointRotationCompressionBits;
+
     validityBit = 0;
     validity = *validityPosition++;
     for (int i = 0; i < _jointData.size(); i ++) {
         const JointData& data = _jointData[ i ];
         if (validity & (1 << validityBit)) {
-            destinationBuffer += packOrientationQuatToBytes(destinationBuffer, data.rotation);
+            destinationBuffer += packOrientationQuatToSmallestThree(destinationBuffer, data.rotation,
+                                                                    _jointRotationCompressionBits);
         }
         if (++validityBit == BITS_IN_BYTE) {
             validityBit = 0;
@@ -379,6 +383,10 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
     return avatarDataByteArray.left(destinationBuffer - startPosition);
 }
 
+void AvatarData::setJointRotationCompressionBits(int bits) {
+    _jointRotationCompressionBits = glm::clamp(bits, MIN_SMALLEST_THREE_QUAT_BITS, MAX_SMALLEST_THREE_QUAT_BITS);
+}
+
 void AvatarData::doneEncoding(bool cullSmallChanges) {
     // The server has finished sending this version of the joint-data to other nodes.  Update _lastSentJointData.
     _lastSentJointData.resize(_jointData.size());
@@ -668,9 +676,30 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         }
     } // 1 + bytesOfValidity bytes
 
-    // each joint rotation component is stored in two bytes (sizeof(uint16_t))
-    int COMPONENTS_PER_QUATERNION = 4;
-    minPossibleSize += numValidJointRotations * COMPONENTS_PER_QUATERNION * sizeof(uint16_t);
+    // one byte for the rotation compression bits
+    minPossibleSize++;
+    if (minPossibleSize > maxAvailableSize) {
+        if (shouldLogError(now)) {
+            qCDebug(avatars) << "Malformed AvatarData packet after JointData rotation validity;"
+                << " displayName = '" << _displayName << "'"
+                << " minPossibleSize = " << minPossibleSize
+                << " maxAvailableSize = " << maxAvailableSize;
+        }
+        return maxAvailableSize;
+    }
+
+    int rotationCompressionBits = *sourceBuffer++;
+    if (rotationCompressionBits < MIN_SMALLEST_THREE_QUAT_BITS || rotationCompressionBits > MAX_SMALLEST_THREE_QUAT_BITS) {
+        if (shouldLogError(now)) {
+            qCDebug(avatars) << "Malformed AvatarData packet with invalid rotation compression;"
+                << " displayName = '" << _displayName << "'"
+                << " rotationCompressionBits = " << rotationCompressionBits;
+        }
+        return maxAvailableSize;
+    }
+
+    // each joint rotation is stored as its smallest three components
+    minPossibleSize += numValidJointRotations * smallestThreeQuatPackedSize(rotationCompressionBits);
     if (minPossibleSize > maxAvailableSize) {
         if (shouldLogError(now)) {
             qCDebug(avatars) << "Malformed AvatarData packet after JointData rotation validity;"
@@ -687,10 +716,10 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
             if (validRotations[i]) {
                 _hasNewJointRotations = true;
                 data.rotationSet = true;
-                sourceBuffer += unpackOrientationQuatFromBytes(sourceBuffer, data.rotation);
+                sourceBuffer += unpackOrientationQuatFromSmallestThree(sourceBuffer, data.rotation, rotationCompressionBits);
             }
         }
-    } // numJoints * 8 bytes
+    } // numValidJointRotations * smallestThreeQuatPackedSize bytes
 
     // joint translations
     // get translation validity bits -- these indicate which translations were packed
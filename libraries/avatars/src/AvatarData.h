@@ -117,6 +117,8 @@ const float AVATAR_SEND_FULL_UPDATE_RATIO = 0.02f;
 // this controls how large a change in joint-rotation must be before the interface sends it to the avatar mixer
 const float AVATAR_MIN_ROTATION_DOT = 0.9999999f;
 const float AVATAR_MIN_TRANSLATION = 0.0001f;
+// bits per component of the joint rotations sent on the wire, see packOrientationQuatToSmallestThree
+const int DEFAULT_JOINT_ROTATION_COMPRESSION_BITS = 12;
 
 
 // Where one's own Avatar begins in the world (will be overwritten if avatar data file is found).
@@ -282,6 +284,9 @@ public:
 
     void setForceFaceTrackerConnected(bool connected) { _forceFaceTrackerConnected = connected; }
 
+    void setJointRotationCompressionBits(int bits);
+    int getJointRotationCompressionBits() const { return _jointRotationCompressionBits; }
+
     // key state
     void setKeyState(KeyState s) { _keyState = s; }
     KeyState keyState() const { return _keyState; }
@@ -380,6 +385,7 @@ protected:
     bool _forceFaceTrackerConnected;
     bool _hasNewJointRotations; // set in AvatarData, cleared in Avatar
     bool _hasNewJointTranslations; // set in AvatarData, cleared in Avatar
+    int _jointRotationCompressionBits { DEFAULT_JOINT_ROTATION_COMPRESSION_BITS };
 
     HeadData* _headData;
     HandData* _handData;
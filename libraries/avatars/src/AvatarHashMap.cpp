@@ -72,6 +72,10 @@ AvatarSharedPointer AvatarHashMap::findAvatar(const QUuid& sessionUUID) {
 }
 
 void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    // look the avatars up in a copy of the hash taken once for the whole packet, rather than locking the hash
+    // for every avatar in it - the copy is implicitly shared so this only costs a reference until an avatar is added
+    AvatarHash avatarHash = getHashCopy();
+
     // enumerate over all of the avatars in this packet
     // only add them if mixerWeakPointer points to something (meaning that mixer is still around)
     while (message->getBytesLeftToRead()) {
@@ -82,15 +86,19 @@ void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> mess
         QByteArray byteArray = message->readWithoutCopy(message->getBytesLeftToRead());
         
         if (sessionUUID != _lastOwnerSessionUUID) {
-            auto avatar = newOrExistingAvatar(sessionUUID, sendingNode);
+            auto avatar = avatarHash.value(sessionUUID);
+            if (!avatar) {
+                // only an avatar we haven't heard of yet takes the write lock, to add it
+                avatar = newOrExistingAvatar(sessionUUID, sendingNode);
+                avatarHash.insert(sessionUUID, avatar);
+            }
             
             // have the matching (or new) avatar parse the data from the packet
             int bytesRead = avatar->parseDataFromBuffer(byteArray);
             message->seek(positionBeforeRead + bytesRead);
         } else {
-            // create a dummy AvatarData class to throw this data on the ground
-            AvatarData dummyData;
-            int bytesRead = dummyData.parseDataFromBuffer(byteArray);
+            // throw this data on the ground, parsed by a dummy AvatarData kept around so it isn't rebuilt every packet
+            int bytesRead = _discardedAvatarData.parseDataFromBuffer(byteArray);
             message->seek(positionBeforeRead + bytesRead);
         }
     }
@@ -131,13 +139,22 @@ void AvatarHashMap::processAvatarIdentityPacket(QSharedPointer<ReceivedMessage>
 }
 
 void AvatarHashMap::processAvatarBillboardPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
-    QUuid sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+    // the mixer batches the billboards it sends us, each one is a session UUID and a sized billboard
+    while (message->getBytesLeftToRead() >= (qint64)(NUM_BYTES_RFC4122_UUID + sizeof(quint32))) {
+        QUuid sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
 
-    auto avatar = newOrExistingAvatar(sessionUUID, sendingNode);
+        quint32 billboardSize;
+        message->readPrimitive(&billboardSize);
+        if ((qint64)billboardSize > message->getBytesLeftToRead()) {
+            break;
+        }
 
-    QByteArray billboard = message->read(message->getBytesLeftToRead());
-    if (avatar->getBillboard() != billboard) {
-        avatar->setBillboard(billboard);
+        auto avatar = newOrExistingAvatar(sessionUUID, sendingNode);
+
+        QByteArray billboard = message->read(billboardSize);
+        if (avatar->getBillboard() != billboard) {
+            avatar->setBillboard(billboard);
+        }
     }
 }
 
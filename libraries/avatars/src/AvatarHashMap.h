@@ -68,6 +68,7 @@ protected:
 
 private:
     QUuid _lastOwnerSessionUUID;
+    AvatarData _discardedAvatarData; // parses the data the mixer sends back about our own avatar
 };
 
 #endif // hifi_AvatarHashMap_h
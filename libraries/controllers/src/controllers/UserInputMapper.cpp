@@ -409,7 +409,7 @@ void UserInputMapper::runMappings() {
     if (debugRoutes) {
         qCDebug(controllers) << "Beginning mapping frame";
     }
-    for (auto endpointEntry : this->_endpointsByInput) {
+    for (const auto& endpointEntry : this->_endpointsByInput) {
         endpointEntry.second->reset();
     }
 
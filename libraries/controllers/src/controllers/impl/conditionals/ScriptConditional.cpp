@@ -19,9 +19,13 @@ bool ScriptConditional::satisfied() {
 
 void ScriptConditional::updateValue() {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "updateValue", Qt::QueuedConnection);
+        // The value is the one the script gave last, only one call for a new one is queued at a time
+        if (!_updatePending.exchange(true)) {
+            QMetaObject::invokeMethod(this, "updateValue", Qt::QueuedConnection);
+        }
         return;
     }
+    _updatePending = false;
 
     _lastValue = _callable.call().toBool();
 }
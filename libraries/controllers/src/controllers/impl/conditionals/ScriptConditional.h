@@ -10,6 +10,8 @@
 #ifndef hifi_Controllers_ScriptConditional_h
 #define hifi_Controllers_ScriptConditional_h
 
+#include <atomic>
+
 #include <QtCore/QObject>
 
 #include <QtScript/QScriptValue>
@@ -27,7 +29,8 @@ protected:
     Q_INVOKABLE void updateValue();
 private:
     QScriptValue _callable;
-    bool _lastValue { false };
+    std::atomic<bool> _lastValue { false };
+    std::atomic<bool> _updatePending { false };
 };
 
 }
@@ -21,16 +21,20 @@ float ScriptEndpoint::peek() const {
 
 void ScriptEndpoint::updateValue() {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "updateValue", Qt::QueuedConnection);
+        // The value read is the one the script gave last, only one call for a new one is queued at a time
+        if (!_valueUpdatePending.exchange(true)) {
+            QMetaObject::invokeMethod(this, "updateValue", Qt::QueuedConnection);
+        }
         return;
     }
+    _valueUpdatePending = false;
 
     QScriptValue result = _callable.call();
 
     // If the callable ever returns a non-number, we assume it's a pose
     // and start reporting ourselves as a pose.
     if (result.isNumber()) {
-        _lastValueRead = (float)_callable.call().toNumber();
+        _lastValueRead = (float)result.toNumber();
     } else {
         Pose::fromScriptValue(result, _lastPoseRead);
         _returnPose = true;
@@ -63,9 +67,12 @@ Pose ScriptEndpoint::peekPose() const {
 
 void ScriptEndpoint::updatePose() {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "updatePose", Qt::QueuedConnection);
+        if (!_poseUpdatePending.exchange(true)) {
+            QMetaObject::invokeMethod(this, "updatePose", Qt::QueuedConnection);
+        }
         return;
     }
+    _poseUpdatePending = false;
     QScriptValue result = _callable.call();
     Pose::fromScriptValue(result, _lastPoseRead);
 }
@@ -10,6 +10,8 @@
 #ifndef hifi_Controllers_ScriptEndpoint_h
 #define hifi_Controllers_ScriptEndpoint_h
 
+#include <atomic>
+
 #include <QtScript/QScriptValue>
 
 #include "../Endpoint.h"
@@ -41,10 +43,13 @@ protected:
     Q_INVOKABLE virtual void internalApply(const Pose& newValue, int sourceID);
 private:
     QScriptValue _callable;
-    float _lastValueRead { 0.0f };
+    // read by the mapping thread and written by the script thread
+    std::atomic<float> _lastValueRead { 0.0f };
+    std::atomic<bool> _valueUpdatePending { false };
+    std::atomic<bool> _poseUpdatePending { false };
     float _lastValueWritten { 0.0f };
 
-    bool _returnPose { false };
+    std::atomic<bool> _returnPose { false };
     Pose _lastPoseRead;
     Pose _lastPoseWritten;
 };
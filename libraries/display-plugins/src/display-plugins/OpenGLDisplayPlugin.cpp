@@ -305,7 +305,9 @@ void OpenGLDisplayPlugin::submitOverlayTexture(GLuint sceneTexture, const glm::u
 }
 
 void OpenGLDisplayPlugin::updateTextures() {
+    GLuint previousSceneTexture = _currentSceneTexture;
     _currentSceneTexture = _sceneTextureEscrow.fetchAndRelease(_currentSceneTexture);
+    _newSceneTexture = _currentSceneTexture != previousSceneTexture;
     _currentOverlayTexture = _overlayTextureEscrow.fetchAndRelease(_currentOverlayTexture);
 }
 
@@ -80,6 +80,8 @@ protected:
 
     GLuint _currentSceneTexture { 0 };
     GLuint _currentOverlayTexture { 0 };
+    // false when the present shows the scene texture it showed before, the main thread not having a new one yet
+    bool _newSceneTexture { false };
 
     GLTextureEscrow _overlayTextureEscrow;
     GLTextureEscrow _sceneTextureEscrow;
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <glm/gtx/quaternion.hpp>
 
 #include <QEventLoop>
@@ -19,6 +21,7 @@
 #include <AbstractViewStateInterface.h>
 #include <Model.h>
 #include <NetworkAccessManager.h>
+#include <NumericalConstants.h>
 #include <PerfStat.h>
 #include <SceneScriptingInterface.h>
 #include <ScriptEngine.h>
@@ -86,6 +89,7 @@ void EntityTreeRenderer::clear() {
     }
     scene->enqueuePendingChanges(pendingChanges);
     _entitiesInScene.clear();
+    _entitiesToAddToScene.clear();
 
     OctreeRenderer::clear();
 }
@@ -134,6 +138,8 @@ void EntityTreeRenderer::update() {
         EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
         tree->update();
 
+        addPendingEntitiesToScene();
+
         // check to see if the avatar has moved and if we need to handle enter/leave entity logic
         checkEnterLeaveEntities();
 
@@ -162,21 +168,40 @@ void EntityTreeRenderer::checkEnterLeaveEntities() {
 
         if (avatarPosition != _lastAvatarPosition) {
             float radius = 1.0f; // for now, assume 1 meter radius
-            QVector<EntityItemPointer> foundEntities;
             QVector<EntityItemID> entitiesContainingAvatar;
-            
-            // find the entities near us
+
+            // the tree is only searched again once the avatar has moved away from where the entities near it were
+            // found, or they may have changed, in between only those entities are tested for containing it
+            const float CANDIDATE_MARGIN = 2.0f;
+            const quint64 CANDIDATE_REFRESH_PERIOD = USECS_PER_SECOND;
+            quint64 now = usecTimestampNow();
+            bool refreshCandidates = now - _enterLeaveCandidatesTime > CANDIDATE_REFRESH_PERIOD ||
+                glm::distance(avatarPosition, _enterLeaveCandidatesCenter) > CANDIDATE_MARGIN;
+
             // don't let someone else change our tree while we search
             _tree->withReadLock([&] {
-                std::static_pointer_cast<EntityTree>(_tree)->findEntities(avatarPosition, radius, foundEntities);
+                if (refreshCandidates) {
+                    QVector<EntityItemPointer> foundEntities;
+                    std::static_pointer_cast<EntityTree>(_tree)->findEntities(avatarPosition, radius + CANDIDATE_MARGIN,
+                                                                              foundEntities);
+                    _enterLeaveCandidates.clear();
+                    _enterLeaveCandidates.reserve(foundEntities.size());
+                    for (const auto& entity : foundEntities) {
+                        _enterLeaveCandidates.push_back(entity);
+                    }
+                    _enterLeaveCandidatesCenter = avatarPosition;
+                    _enterLeaveCandidatesTime = now;
+                }
 
                 // Whenever you're in an intersection between zones, we will always choose the smallest zone.
+                auto previousBestZone = _bestZone;
                 _bestZone = NULL; // NOTE: Is this what we want?
                 _bestZoneVolume = std::numeric_limits<float>::max();
 
                 // create a list of entities that actually contain the avatar's position
-                foreach(EntityItemPointer entity, foundEntities) {
-                    if (entity->contains(avatarPosition)) {
+                for (const auto& candidate : _enterLeaveCandidates) {
+                    EntityItemPointer entity = candidate.lock();
+                    if (entity && entity->contains(avatarPosition)) {
                         entitiesContainingAvatar << entity->getEntityItemID();
 
                         // if this entity is a zone, use this time to determine the bestZone
@@ -203,8 +228,10 @@ void EntityTreeRenderer::checkEnterLeaveEntities() {
                     }
                 }
 
-                applyZonePropertiesToScene(_bestZone);
-
+                // the zone is applied again when the candidates are, to pick up the changes to its properties
+                if (_bestZone != previousBestZone || refreshCandidates) {
+                    applyZonePropertiesToScene(_bestZone);
+                }
             });
             
             // Note: at this point we don't need to worry about the tree being locked, because we only deal with
@@ -249,6 +276,7 @@ void EntityTreeRenderer::forceRecheckEntities() {
     // make sure our "last avatar position" is something other than our current position, 
     // so that on our next chance, we'll check for enter/leave entity events.
     _lastAvatarPosition = _viewState->getAvatarPosition() + glm::vec3((float)TREE_SCALE);
+    _enterLeaveCandidatesTime = 0;
 }
 
 
@@ -651,6 +679,7 @@ void EntityTreeRenderer::deletingEntity(const EntityItemID& entityID) {
     forceRecheckEntities(); // reset our state to force checking our inside/outsideness of entities
 
     // here's where we remove the entity payload from the scene
+    _entitiesToAddToScene.remove(entityID);
     if (_entitiesInScene.contains(entityID)) {
         auto entity = _entitiesInScene.take(entityID);
         render::PendingChanges pendingChanges;
@@ -665,18 +694,60 @@ void EntityTreeRenderer::addingEntity(const EntityItemID& entityID) {
     checkAndCallPreload(entityID);
     auto entity = std::static_pointer_cast<EntityTree>(_tree)->findEntityByID(entityID);
     if (entity) {
-        addEntityToScene(entity);
+        // the entity is added to the scene on one of the next updates, see addPendingEntitiesToScene
+        _entitiesToAddToScene.insert(entityID, entity);
     }
 }
 
-void EntityTreeRenderer::addEntityToScene(EntityItemPointer entity) {
-    // here's where we add the entity payload to the scene
+void EntityTreeRenderer::addPendingEntitiesToScene() {
+    if (_entitiesToAddToScene.isEmpty()) {
+        return;
+    }
+
+    // add the entities that look biggest from the avatar first, and only as many as fit in the budget so that
+    // entering a domain with many entities doesn't stall
+    const quint64 ADD_ENTITIES_TO_SCENE_BUDGET_USECS = 2 * USECS_PER_MSEC;
+    const float MIN_PRIORITY_DISTANCE = 0.1f;
+
+    glm::vec3 avatarPosition = _viewState->getAvatarPosition();
+    std::vector<std::pair<float, EntityItemPointer>> sortedEntities;
+    sortedEntities.reserve(_entitiesToAddToScene.size());
+    for (auto itr = _entitiesToAddToScene.begin(); itr != _entitiesToAddToScene.end(); ) {
+        EntityItemPointer entity = itr.value().lock();
+        if (!entity) {
+            itr = _entitiesToAddToScene.erase(itr);
+            continue;
+        }
+        float distance = std::max(glm::distance(avatarPosition, entity->getPosition()), MIN_PRIORITY_DISTANCE);
+        sortedEntities.emplace_back(entity->getRadius() / distance, entity);
+        ++itr;
+    }
+    std::sort(sortedEntities.begin(), sortedEntities.end(),
+              [](const std::pair<float, EntityItemPointer>& a, const std::pair<float, EntityItemPointer>& b) {
+        return a.first > b.first;
+    });
+
     render::PendingChanges pendingChanges;
     auto scene = _viewState->getMain3DScene();
+    quint64 start = usecTimestampNow();
+    for (const auto& sortedEntity : sortedEntities) {
+        auto entity = sortedEntity.second;
+        _entitiesToAddToScene.remove(entity->getEntityItemID());
+        addEntityToScene(entity, scene, pendingChanges);
+
+        if (usecTimestampNow() - start > ADD_ENTITIES_TO_SCENE_BUDGET_USECS) {
+            break;
+        }
+    }
+    scene->enqueuePendingChanges(pendingChanges);
+}
+
+void EntityTreeRenderer::addEntityToScene(EntityItemPointer entity, std::shared_ptr<render::Scene> scene,
+                                          render::PendingChanges& pendingChanges) {
+    // here's where we add the entity payload to the scene
     if (entity->addToScene(entity, scene, pendingChanges)) {
         _entitiesInScene.insert(entity->getEntityItemID(), entity);
     }
-    scene->enqueuePendingChanges(pendingChanges);
 }
 
 
@@ -811,7 +882,7 @@ void EntityTreeRenderer::updateEntityRenderStatus(bool shouldRenderEntities) {
         }
         _entityIDsLastInScene.clear();
     } else {
-        _entityIDsLastInScene = _entitiesInScene.keys();
+        _entityIDsLastInScene = _entitiesInScene.keys() + _entitiesToAddToScene.keys();
         for (auto entityID : _entityIDsLastInScene) {
             // FIXME - is this really right? do we want to do the deletingEntity() code or just remove from the scene.
             deletingEntity(entityID);
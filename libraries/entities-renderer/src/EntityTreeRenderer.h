@@ -122,7 +122,9 @@ protected:
     }
 
 private:
-    void addEntityToScene(EntityItemPointer entity);
+    void addEntityToScene(EntityItemPointer entity, std::shared_ptr<render::Scene> scene,
+                          render::PendingChanges& pendingChanges);
+    void addPendingEntitiesToScene();
 
     void applyZonePropertiesToScene(std::shared_ptr<ZoneEntityItem> zone);
     void checkAndCallPreload(const EntityItemID& entityID, const bool reload = false);
@@ -143,6 +145,11 @@ private:
     glm::vec3 _lastAvatarPosition;
     QVector<EntityItemID> _currentEntitiesInside;
 
+    // the entities found near the avatar, tested for containing it as it moves until they are found again
+    QVector<EntityItemWeakPointer> _enterLeaveCandidates;
+    glm::vec3 _enterLeaveCandidatesCenter;
+    quint64 _enterLeaveCandidatesTime { 0 };
+
     bool _pendingSkyboxTexture { false };
     NetworkTexturePointer _skyboxTexture;
 
@@ -182,6 +189,7 @@ private:
     int _previousStageDay;
     
     QHash<EntityItemID, EntityItemPointer> _entitiesInScene;
+    QHash<EntityItemID, EntityItemWeakPointer> _entitiesToAddToScene; // added a few at a time on update
     // For Scene.shouldRenderEntities
     QList<EntityItemID> _entityIDsLastInScene;
 };
@@ -66,10 +66,10 @@ void RenderableBoxEntityItem::render(RenderArgs* args) {
         _procedural->prepare(batch, getPosition(), getDimensions());
         auto color = _procedural->getColor(cubeColor);
         batch._glColor4f(color.r, color.g, color.b, color.a);
-        DependencyManager::get<GeometryCache>()->renderCube(batch);
+        DependencyManager::borrow<GeometryCache>()->renderCube(batch);
     } else {
-        DependencyManager::get<GeometryCache>()->renderSolidCubeInstance(batch, cubeColor);
+        DependencyManager::borrow<GeometryCache>()->renderSolidCubeInstance(batch, cubeColor);
     }
-    static const auto triCount = DependencyManager::get<GeometryCache>()->getCubeTriangleCount();
+    static const auto triCount = DependencyManager::borrow<GeometryCache>()->getCubeTriangleCount();
     args->_details._trianglesRendered += (int)triCount;
 }
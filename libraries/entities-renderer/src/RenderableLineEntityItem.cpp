@@ -52,7 +52,7 @@ void RenderableLineEntityItem::render(RenderArgs* args) {
     batch.setModelTransform(transform);
 
     if (getLinePoints().size() > 1) {
-        DependencyManager::get<GeometryCache>()->bindSimpleProgram(batch);
-        DependencyManager::get<GeometryCache>()->renderVertices(batch, gpu::LINE_STRIP, _lineVerticesID);
+        DependencyManager::borrow<GeometryCache>()->bindSimpleProgram(batch);
+        DependencyManager::borrow<GeometryCache>()->renderVertices(batch, gpu::LINE_STRIP, _lineVerticesID);
     }
 };
@@ -11,13 +11,17 @@
 
 #include <glm/gtx/quaternion.hpp>
 
+#include <algorithm>
+
 #include <QJsonDocument>
 #include <QtCore/QThread>
 #include <glm/gtx/transform.hpp>
 
 #include <AbstractViewStateInterface.h>
 #include <Model.h>
+#include <NumericalConstants.h>
 #include <PerfStat.h>
+#include <ViewFrustum.h>
 #include <render/Scene.h>
 #include <DependencyManager.h>
 
@@ -370,6 +374,14 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
             //        the renderable item. As it stands now the model checks it's visible/invisible state
             //        so most of the time we don't do anything in this function.
             _model->setVisibleInScene(getVisible(), scene);
+
+            if (!_model->isLoadedWithTextures() && args->_viewFrustum) {
+                // a model that fills more of the view loads ahead of one that fills less, and one that is no longer
+                // rendered stops renewing its priority and falls behind
+                float radius = 0.5f * glm::length(getDimensions());
+                float distance = glm::distance(args->_viewFrustum->getPosition(), getPosition());
+                _model->setLoadPriority(radius / std::max(distance, radius + EPSILON));
+            }
         }
 
 
@@ -441,7 +453,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
         auto shapeTransform = getTransformToCenter(success);
         if (success) {
             batch.setModelTransform(shapeTransform); // we want to include the scale as well
-            DependencyManager::get<GeometryCache>()->renderWireCubeInstance(batch, greenColor);
+            DependencyManager::borrow<GeometryCache>()->renderWireCubeInstance(batch, greenColor);
         }
     }
 }
@@ -8,6 +8,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <glm/gtx/quaternion.hpp>
 
 #include <DependencyManager.h>
@@ -27,6 +29,8 @@
 class ParticlePayloadData {
 public:
     static const size_t VERTEX_PER_PARTICLE = 4;
+    // long before any particle, so a free slot is never alive
+    static const float FREE_SLOT_BIRTH_TIME;
 
     template<typename T>
     struct InterpolationData {
@@ -39,12 +43,14 @@ public:
         InterpolationData<float> radius;
         InterpolationData<glm::vec4> color; // rgba
         float lifespan;
+        float time;
     };
     
+    // A particle as it was at its birth, the vertex shader moves it on to the time of the uniforms
     struct ParticlePrimitive {
-        ParticlePrimitive(glm::vec3 xyzIn, glm::vec2 uvIn) : xyz(xyzIn), uv(uvIn) {}
-        glm::vec3 xyz; // Position
-        glm::vec2 uv; // Lifetime + seed
+        glm::vec4 position; // Position + birth time
+        glm::vec4 velocity; // Velocity + seed
+        glm::vec4 acceleration;
     };
     
     using Payload = render::Payload<ParticlePayloadData>;
@@ -62,10 +68,12 @@ public:
         ParticleUniforms uniforms;
         _uniformBuffer = std::make_shared<Buffer>(sizeof(ParticleUniforms), (const gpu::Byte*) &uniforms);
         
-        _vertexFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element::VEC3F_XYZ,
-                                    offsetof(ParticlePrimitive, xyz), gpu::Stream::PER_INSTANCE);
-        _vertexFormat->setAttribute(gpu::Stream::COLOR, 0, gpu::Element::VEC2F_UV,
-                                    offsetof(ParticlePrimitive, uv), gpu::Stream::PER_INSTANCE);
+        _vertexFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element::VEC4F_XYZW,
+                                    offsetof(ParticlePrimitive, position), gpu::Stream::PER_INSTANCE);
+        _vertexFormat->setAttribute(gpu::Stream::NORMAL, 0, gpu::Element::VEC4F_XYZW,
+                                    offsetof(ParticlePrimitive, velocity), gpu::Stream::PER_INSTANCE);
+        _vertexFormat->setAttribute(gpu::Stream::TEXCOORD, 0, gpu::Element::VEC4F_XYZW,
+                                    offsetof(ParticlePrimitive, acceleration), gpu::Stream::PER_INSTANCE);
     }
 
     void setPipeline(PipelinePointer pipeline) { _pipeline = pipeline; }
@@ -77,8 +85,34 @@ public:
     const AABox& getBound() const { return _bound; }
     void setBound(const AABox& bound) { _bound = bound; }
 
-    BufferPointer getParticleBuffer() { return _particleBuffer; }
     const BufferPointer& getParticleBuffer() const { return _particleBuffer; }
+
+    // The particles are in a ring of slots, the particle emitted n-th in the slot n modulo the count of slots.
+    // Resetting them leaves all the slots free
+    void resetParticles(size_t numSlots) {
+        ParticlePrimitive freeSlot;
+        freeSlot.position = glm::vec4(0.0f, 0.0f, 0.0f, FREE_SLOT_BIRTH_TIME);
+        ParticlePrimitives freeSlots(numSlots, freeSlot);
+        _particleBuffer->setData(numSlots * sizeof(ParticlePrimitive), (const gpu::Byte*)freeSlots.data());
+        _numSlots = numSlots;
+        _numUsedSlots = 0;
+    }
+
+    // Only the slots of the new particles go to the GPU, in at most two runs when they go round the ring
+    void setParticles(size_t firstSlot, const ParticlePrimitives& particles) {
+        size_t numParticles = std::min(particles.size(), _numSlots);
+        size_t offset = particles.size() - numParticles;
+        firstSlot = (firstSlot + offset) % std::max(_numSlots, (size_t)1);
+        while (numParticles > 0) {
+            size_t numInRun = std::min(numParticles, _numSlots - firstSlot);
+            _particleBuffer->setSubData(firstSlot * sizeof(ParticlePrimitive), numInRun * sizeof(ParticlePrimitive),
+                (const gpu::Byte*)(particles.data() + offset));
+            _numUsedSlots = std::max(_numUsedSlots, firstSlot + numInRun);
+            offset += numInRun;
+            numParticles -= numInRun;
+            firstSlot = 0;
+        }
+    }
     
     const ParticleUniforms& getParticleUniforms() const { return _uniformBuffer.get<ParticleUniforms>(); }
     ParticleUniforms& editParticleUniforms() { return _uniformBuffer.edit<ParticleUniforms>(); }
@@ -91,6 +125,9 @@ public:
     
     void render(RenderArgs* args) const {
         assert(_pipeline);
+        if (_numUsedSlots == 0) {
+            return;
+        }
 
         gpu::Batch& batch = *args->_batch;
         batch.setPipeline(_pipeline);
@@ -104,8 +141,8 @@ public:
         batch.setInputFormat(_vertexFormat);
         batch.setInputBuffer(0, _particleBuffer, 0, sizeof(ParticlePrimitive));
 
-        auto numParticles = _particleBuffer->getSize() / sizeof(ParticlePrimitive);
-        batch.drawInstanced((gpu::uint32)numParticles, gpu::TRIANGLE_STRIP, (gpu::uint32)VERTEX_PER_PARTICLE);
+        // the dead particles left in the used slots are collapsed by the vertex shader
+        batch.drawInstanced((gpu::uint32)_numUsedSlots, gpu::TRIANGLE_STRIP, (gpu::uint32)VERTEX_PER_PARTICLE);
     }
 
 protected:
@@ -114,11 +151,18 @@ protected:
     PipelinePointer _pipeline;
     FormatPointer _vertexFormat { std::make_shared<Format>() };
     BufferPointer _particleBuffer { std::make_shared<Buffer>() };
+    size_t _numSlots { 0 };
+    size_t _numUsedSlots { 0 };
     BufferView _uniformBuffer;
     TexturePointer _texture;
     bool _visibleFlag = true;
 };
 
+const float ParticlePayloadData::FREE_SLOT_BIRTH_TIME = -1.0e6f;
+
+// the time in seconds past which the times of the particles are sent from a new origin
+static const double MAX_PARTICLE_TIME = 1000.0;
+
 namespace render {
     template <>
     const ItemKey payloadGetKey(const ParticlePayloadData::Pointer& payload) {
@@ -171,6 +215,9 @@ bool RenderableParticleEffectEntityItem::addToScene(EntityItemPointer self,
     makeEntityItemStatusGetters(getThisPointer(), statusGetters);
     renderPayload->addStatusGetters(statusGetters);
     pendingChanges.resetItem(_renderItemId, renderPayload);
+
+    // the new item has no slots yet
+    _numParticleSlots = 0;
     return true;
 }
 
@@ -216,6 +263,15 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
     using ParticlePrimitive = ParticlePayloadData::ParticlePrimitive;
     using ParticlePrimitives = ParticlePayloadData::ParticlePrimitives;
 
+    bool successb, successp, successr;
+    auto bounds = getAABox(successb);
+    auto position = getPosition(successp);
+    auto rotation = getOrientation(successr);
+    bool success = successb && successp && successr;
+    if (!success) {
+        return;
+    }
+
     // Fill in Uniforms structure
     ParticleUniforms particleUniforms;
     particleUniforms.radius.start = getRadiusStart();
@@ -227,22 +283,34 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
     particleUniforms.color.finish = glm::vec4(getColorFinishRGB(), getAlphaFinish());
     particleUniforms.color.spread = glm::vec4(getColorSpreadRGB(), getAlphaSpread());
     particleUniforms.lifespan = getLifespan();
-    
-    // Build particle primitives
-    auto particlePrimitives = std::make_shared<ParticlePrimitives>();
-    particlePrimitives->reserve(_particles.size()); // Reserve space
-    for (auto& particle : _particles) {
-        particlePrimitives->emplace_back(particle.position, glm::vec2(particle.lifetime, particle.seed));
+
+    // All the slots are filled again when they change in count, when particles dead on the CPU could come back to life
+    // in them, and now and then to keep the times small enough for the float precision of the GPU
+    bool resetSlots = (_numParticleSlots != _maxParticles) || (_uploadedLifespan != _lifespan) ||
+        (_simulationTime - _particleTimeOrigin > MAX_PARTICLE_TIME);
+    if (resetSlots) {
+        _numParticleSlots = _maxParticles;
+        _uploadedLifespan = _lifespan;
+        _particleTimeOrigin = _simulationTime;
     }
+    particleUniforms.time = (float)(_simulationTime - _particleTimeOrigin);
 
-    bool successb, successp, successr;
-    auto bounds = getAABox(successb);
-    auto position = getPosition(successp);
-    auto rotation = getOrientation(successr);
-    bool success = successb && successp && successr;
-    if (!success) {
-        return;
+    // Build the primitives of the particles emitted since the last update
+    quint64 firstParticle = _numEmittedParticles - _particles.size();
+    quint64 firstNewParticle = resetSlots ? firstParticle : std::max(firstParticle, _numUploadedParticles);
+    auto particlePrimitives = std::make_shared<ParticlePrimitives>();
+    particlePrimitives->reserve((size_t)(_numEmittedParticles - firstNewParticle)); // Reserve space
+    for (auto it = _particles.begin() + (size_t)(firstNewParticle - firstParticle); it != _particles.end(); ++it) {
+        ParticlePrimitive primitive;
+        primitive.position = glm::vec4(it->position, (float)(it->birthTime - _particleTimeOrigin));
+        primitive.velocity = glm::vec4(it->velocity, it->seed);
+        primitive.acceleration = glm::vec4(it->acceleration, 0.0f);
+        particlePrimitives->push_back(primitive);
     }
+    size_t firstSlot = (size_t)(firstNewParticle % _numParticleSlots);
+    size_t numSlots = _numParticleSlots;
+    _numUploadedParticles = _numEmittedParticles;
+
     Transform transform;
     if (!getEmitterShouldTrail()) {
         transform.setTranslation(position);
@@ -258,13 +326,10 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
         memcpy(&payload.editParticleUniforms(), &particleUniforms, sizeof(ParticleUniforms));
         
         // Update particle buffer
-        auto particleBuffer = payload.getParticleBuffer();
-        size_t numBytes = sizeof(ParticlePrimitive) * particlePrimitives->size();
-        particleBuffer->resize(numBytes);
-        if (numBytes == 0) {
-            return;
+        if (resetSlots) {
+            payload.resetParticles(numSlots);
         }
-        memcpy(particleBuffer->editData(), particlePrimitives->data(), numBytes);
+        payload.setParticles(firstSlot, *particlePrimitives);
 
         // Update transform and bounds
         payload.setModelTransform(transform);
@@ -37,6 +37,13 @@ protected:
     NetworkTexturePointer _texture;
     gpu::PipelinePointer _untexturedPipeline;
     gpu::PipelinePointer _texturedPipeline;
+
+    // the particles the render item has been given so far, the slots they are in, and the lifespan they were given
+    // for; their times are sent from an origin moved on every so often
+    quint64 _numUploadedParticles { 0 };
+    quint32 _numParticleSlots { 0 };
+    float _uploadedLifespan { 0.0f };
+    double _particleTimeOrigin { 0.0 };
 };
 
 
@@ -69,7 +69,6 @@ RenderablePolyVoxEntityItem::RenderablePolyVoxEntityItem(const EntityItemID& ent
     _yTexture(nullptr),
     _zTexture(nullptr) {
     setVoxelVolumeSize(_voxelVolumeSize);
-    getMeshAsync();
 }
 
 RenderablePolyVoxEntityItem::~RenderablePolyVoxEntityItem() {
@@ -124,8 +123,10 @@ void RenderablePolyVoxEntityItem::setVoxelSurfaceStyle(PolyVoxSurfaceStyle voxel
         setVoxelVolumeSize(_voxelVolumeSize);
         decompressVolumeData();
     } else {
+        _volDataLock.lockForWrite();
+        _volDataDirty = true;
         _voxelSurfaceStyle = voxelSurfaceStyle;
-        getMesh();
+        _volDataLock.unlock();
     }
 }
 
@@ -176,9 +177,6 @@ bool RenderablePolyVoxEntityItem::setVoxel(int x, int y, int z, uint8_t toValue)
 
     _volDataLock.lockForWrite();
     bool result = setVoxelInternal(x, y, z, toValue);
-    if (result) {
-        _volDataDirty = true;
-    }
     _volDataLock.unlock();
     if (result) {
         compressVolumeDataAndSendEditPacket();
@@ -195,7 +193,6 @@ bool RenderablePolyVoxEntityItem::setAll(uint8_t toValue) {
     }
 
     _volDataLock.lockForWrite();
-    _volDataDirty = true;
     for (int z = 0; z < _voxelVolumeSize.z; z++) {
         for (int y = 0; y < _voxelVolumeSize.y; y++) {
             for (int x = 0; x < _voxelVolumeSize.x; x++) {
@@ -225,7 +222,6 @@ bool RenderablePolyVoxEntityItem::setCuboid(const glm::vec3& lowPosition, const
     int zHigh = std::max(std::min(zLow + (int)roundf(cuboidSize.z), (int)roundf(_voxelVolumeSize.z)), zLow);
 
     _volDataLock.lockForWrite();
-    _volDataDirty = true;
 
     for (int x = xLow; x < xHigh; x++) {
         for (int y = yLow; y < yHigh; y++) {
@@ -275,12 +271,9 @@ bool RenderablePolyVoxEntityItem::setSphereInVolume(glm::vec3 center, float radi
         }
     }
 
+    _volDataLock.unlock();
     if (result) {
-        _volDataDirty = true;
-        _volDataLock.unlock();
         compressVolumeDataAndSendEditPacket();
-    } else {
-        _volDataLock.unlock();
     }
     return result;
 }
@@ -312,12 +305,9 @@ bool RenderablePolyVoxEntityItem::setSphere(glm::vec3 centerWorldCoords, float r
         }
     }
 
+    _volDataLock.unlock();
     if (result) {
-        _volDataDirty = true;
-        _volDataLock.unlock();
         compressVolumeDataAndSendEditPacket();
-    } else {
-        _volDataLock.unlock();
     }
     return result;
 }
@@ -473,7 +463,7 @@ void RenderablePolyVoxEntityItem::render(RenderArgs* args) {
     Q_ASSERT(args->_batch);
 
     _volDataLock.lockForRead();
-    if (_volDataDirty) {
+    if (_volDataDirty || !_dirtyMeshBlocks.isEmpty()) {
         _volDataLock.unlock();
         getMesh();
     } else {
@@ -663,6 +653,11 @@ void RenderablePolyVoxEntityItem::setVoxelVolumeSize(glm::vec3 voxelVolumeSize)
 
     // having the "outside of voxel-space" value be 255 has helped me notice some problems.
     _volData->setBorderValue(255);
+
+    PolyVox::Vector3DInt32 upperCorner = _volData->getEnclosingRegion().getUpperCorner();
+    glm::ivec3 numCells(upperCorner.getX(), upperCorner.getY(), upperCorner.getZ());
+    _numMeshBlocks = glm::max((numCells + MESH_BLOCK_SIZE - 1) / MESH_BLOCK_SIZE, glm::ivec3(1));
+    _dirtyMeshBlocks.clear();
     _volDataLock.unlock();
     decompressVolumeData();
 }
@@ -717,16 +712,36 @@ bool RenderablePolyVoxEntityItem::setVoxelInternal(int x, int y, int z, uint8_t
     }
 
     result = updateOnCount(x, y, z, toValue);
+    if (getVoxelInternal(x, y, z) == toValue) {
+        return result;
+    }
 
     if (isEdged(_voxelSurfaceStyle)) {
         _volData->setVoxelAt(x + 1, y + 1, z + 1, toValue);
+        markMeshBlocksDirty(x + 1, y + 1, z + 1);
     } else {
         _volData->setVoxelAt(x, y, z, toValue);
+        markMeshBlocksDirty(x, y, z);
     }
 
     return result;
 }
 
+void RenderablePolyVoxEntityItem::markMeshBlocksDirty(int x, int y, int z) {
+    // x, y, z are in polyvox volume coords.  The surface of a cell goes from its voxel to the next, and its normals
+    // look one voxel further each way, so the voxel reaches the cells two below it and one above it
+    glm::ivec3 voxel(x, y, z);
+    glm::ivec3 low = glm::clamp((voxel - 2) / MESH_BLOCK_SIZE, glm::ivec3(0), _numMeshBlocks - 1);
+    glm::ivec3 high = glm::clamp((voxel + 1) / MESH_BLOCK_SIZE, glm::ivec3(0), _numMeshBlocks - 1);
+    for (int blockZ = low.z; blockZ <= high.z; blockZ++) {
+        for (int blockY = low.y; blockY <= high.y; blockY++) {
+            for (int blockX = low.x; blockX <= high.x; blockX++) {
+                _dirtyMeshBlocks.insert((blockZ * _numMeshBlocks.y + blockY) * _numMeshBlocks.x + blockX);
+            }
+        }
+    }
+}
+
 
 bool RenderablePolyVoxEntityItem::updateOnCount(int x, int y, int z, uint8_t toValue) {
     // keep _onCount up to date
@@ -798,7 +813,6 @@ void RenderablePolyVoxEntityItem::decompressVolumeDataAsync() {
         _threadRunning.release();
         return;
     }
-    _volDataDirty = true;
     for (int z = 0; z < voxelZSize; z++) {
         for (int y = 0; y < voxelYSize; y++) {
             for (int x = 0; x < voxelXSize; x++) {
@@ -884,7 +898,11 @@ void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacketAsync() {
 }
 
 void RenderablePolyVoxEntityItem::getMesh() {
-    _threadRunning.acquire();
+    // getMesh is called from the render and it keeps being called while the mesh is dirty, so rather than wait for
+    // a job to finish it tries again on a later frame
+    if (!_threadRunning.tryAcquire()) {
+        return;
+    }
     QtConcurrent::run(this, &RenderablePolyVoxEntityItem::getMeshAsync);
 }
 
@@ -1005,57 +1023,106 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
     }
 }
 
+static void extractSurface(PolyVox::SimpleVolume<uint8_t>* volData, PolyVoxEntityItem::PolyVoxSurfaceStyle surfaceStyle,
+                           const PolyVox::Region& region, PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal>* polyVoxMesh) {
+    polyVoxMesh->clear();
+    switch (surfaceStyle) {
+        case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES:
+        case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
+            PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                (volData, region, polyVoxMesh);
+            surfaceExtractor.execute();
+            break;
+        }
+        case PolyVoxEntityItem::SURFACE_EDGED_CUBIC:
+        case PolyVoxEntityItem::SURFACE_CUBIC: {
+            PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                (volData, region, polyVoxMesh);
+            surfaceExtractor.execute();
+            break;
+        }
+    }
+}
+
 void RenderablePolyVoxEntityItem::getMeshAsync() {
     model::MeshPointer mesh(new model::Mesh());
 
     cacheNeighbors();
 
-    // A mesh object to hold the result of surface extraction
-    PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
-
-    _volDataLock.lockForRead();
+    // take the blocks to extract again, the voxels can be edited while they are
+    _volDataLock.lockForWrite();
     if (!_volData) {
         _volDataLock.unlock();
+        _threadRunning.release();
         return;
     }
     copyUpperEdgesFromNeighbors();
+    int numBlocks = _numMeshBlocks.x * _numMeshBlocks.y * _numMeshBlocks.z;
+    bool extractAll = _volDataDirty || (_blockMeshes.size() != (size_t)numBlocks) ||
+        (_blockMeshesStyle != _voxelSurfaceStyle);
+    QSet<int> dirtyBlocks = _dirtyMeshBlocks;
+    glm::ivec3 numMeshBlocks = _numMeshBlocks;
+    _volDataDirty = false;
+    _dirtyMeshBlocks.clear();
+    _volDataLock.unlock();
 
-    switch (_voxelSurfaceStyle) {
-        case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES: {
-            PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                (_volData, _volData->getEnclosingRegion(), &polyVoxMesh);
-            surfaceExtractor.execute();
-            break;
-        }
-        case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
-            PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                (_volData, _volData->getEnclosingRegion(), &polyVoxMesh);
-            surfaceExtractor.execute();
-            break;
+    // an edit from here on marks its blocks again for the next extraction
+    _volDataLock.lockForRead();
+    if (!_volData || _numMeshBlocks != numMeshBlocks) {
+        // the volume was made again, and all of it is to be extracted next time
+        _volDataLock.unlock();
+        _threadRunning.release();
+        return;
+    }
+    PolyVox::Region enclosingRegion = _volData->getEnclosingRegion();
+
+    // the blocks are extracted on their own, sharing the voxels along their sides
+    if (extractAll) {
+        _blockMeshes.resize(numBlocks);
+        _blockMeshesStyle = _voxelSurfaceStyle;
+    }
+    std::vector<PolyVox::Vector3DFloat> blockOffsets(numBlocks);
+    for (int block = 0; block < numBlocks; block++) {
+        glm::ivec3 blockIndex(block % numMeshBlocks.x, (block / numMeshBlocks.x) % numMeshBlocks.y,
+            block / (numMeshBlocks.x * numMeshBlocks.y));
+        PolyVox::Vector3DInt32 lowCorner(blockIndex.x * MESH_BLOCK_SIZE, blockIndex.y * MESH_BLOCK_SIZE,
+            blockIndex.z * MESH_BLOCK_SIZE);
+        blockOffsets[block] = PolyVox::Vector3DFloat((float)lowCorner.getX(), (float)lowCorner.getY(),
+            (float)lowCorner.getZ());
+        if (!extractAll && !dirtyBlocks.contains(block)) {
+            continue;
         }
-        case PolyVoxEntityItem::SURFACE_EDGED_CUBIC: {
-            PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                (_volData, _volData->getEnclosingRegion(), &polyVoxMesh);
-            surfaceExtractor.execute();
-            break;
+
+        PolyVox::Vector3DInt32 highCorner(
+            std::min(lowCorner.getX() + MESH_BLOCK_SIZE, enclosingRegion.getUpperCorner().getX()),
+            std::min(lowCorner.getY() + MESH_BLOCK_SIZE, enclosingRegion.getUpperCorner().getY()),
+            std::min(lowCorner.getZ() + MESH_BLOCK_SIZE, enclosingRegion.getUpperCorner().getZ()));
+        extractSurface(_volData, _blockMeshesStyle, PolyVox::Region(lowCorner, highCorner), &_blockMeshes[block]);
+    }
+    _volDataLock.unlock();
+
+    // join the blocks, their vertices are relative to the low corners of their regions
+    std::vector<PolyVox::PositionMaterialNormal> vecVertices;
+    std::vector<uint32_t> vecIndices;
+    for (int block = 0; block < numBlocks; block++) {
+        const auto& blockMesh = _blockMeshes[block];
+        uint32_t firstVertex = (uint32_t)vecVertices.size();
+        for (auto vertex : blockMesh.getVertices()) {
+            vertex.setPosition(vertex.getPosition() + blockOffsets[block]);
+            vecVertices.push_back(vertex);
         }
-        case PolyVoxEntityItem::SURFACE_CUBIC: {
-            PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                (_volData, _volData->getEnclosingRegion(), &polyVoxMesh);
-            surfaceExtractor.execute();
-            break;
+        for (auto index : blockMesh.getIndices()) {
+            vecIndices.push_back(firstVertex + index);
         }
     }
 
     // convert PolyVox mesh to a Sam mesh
-    const std::vector<uint32_t>& vecIndices = polyVoxMesh.getIndices();
     auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
                                                      (gpu::Byte*)vecIndices.data());
     auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
     auto indexBufferView = new gpu::BufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::RAW));
     mesh->setIndexBuffer(*indexBufferView);
 
-    const std::vector<PolyVox::PositionMaterialNormal>& vecVertices = polyVoxMesh.getVertices();
     auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
                                                       (gpu::Byte*)vecVertices.data());
     auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
@@ -1078,14 +1145,15 @@ void RenderablePolyVoxEntityItem::getMeshAsync() {
     _mesh = mesh;
     _meshDirty = true;
     _meshLock.unlock();
-    _volDataDirty = false;
-    _volDataLock.unlock();
     bonkNeighbors();
     _threadRunning.release();
 }
 
 void RenderablePolyVoxEntityItem::computeShapeInfoWorker() {
-    _threadRunning.acquire();
+    // the physics keeps asking while the shape isn't ready, so it doesn't wait for a job to finish either
+    if (!_threadRunning.tryAcquire()) {
+        return;
+    }
     QtConcurrent::run(this, &RenderablePolyVoxEntityItem::computeShapeInfoWorkerAsync);
 }
 
@@ -1300,8 +1368,17 @@ void RenderablePolyVoxEntityItem::setZPNeighborID(const EntityItemID& zPNeighbor
 
 
 void RenderablePolyVoxEntityItem::rebakeMesh() {
-    QReadLocker(&this->_volDataLock);
-    _volDataDirty = true;
+    // only the upper edges copied from the neighbors change, so only the blocks along them are extracted again
+    QWriteLocker locker(&_volDataLock);
+    for (int blockZ = 0; blockZ < _numMeshBlocks.z; blockZ++) {
+        for (int blockY = 0; blockY < _numMeshBlocks.y; blockY++) {
+            for (int blockX = 0; blockX < _numMeshBlocks.x; blockX++) {
+                if (blockX == _numMeshBlocks.x - 1 || blockY == _numMeshBlocks.y - 1 || blockZ == _numMeshBlocks.z - 1) {
+                    _dirtyMeshBlocks.insert((blockZ * _numMeshBlocks.y + blockY) * _numMeshBlocks.x + blockX);
+                }
+            }
+        }
+    }
 }
 
 void RenderablePolyVoxEntityItem::bonkNeighbors() {
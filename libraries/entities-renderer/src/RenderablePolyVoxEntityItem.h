@@ -13,9 +13,12 @@
 #define hifi_RenderablePolyVoxEntityItem_h
 
 #include <QSemaphore>
+#include <QSet>
 #include <atomic>
+#include <vector>
 
 #include <PolyVoxCore/SimpleVolume.h>
+#include <PolyVoxCore/SurfaceMesh.h>
 #include <PolyVoxCore/Raycast.h>
 
 #include <TextureCache.h>
@@ -137,9 +140,18 @@ private:
 
     PolyVox::SimpleVolume<uint8_t>* _volData = nullptr;
     mutable QReadWriteLock _volDataLock{QReadWriteLock::Recursive}; // lock for _volData
-    bool _volDataDirty = false; // does getMesh need to be called?
+    bool _volDataDirty = false; // does all of the mesh need to be extracted again?
     int _onCount; // how many non-zero voxels are in _volData
 
+    // The mesh is extracted in blocks of cells, so that an edit only has the blocks around it extracted again.
+    // The blocks to extract are kept with _volData, the surfaces of the blocks by the mesh jobs
+    static const int MESH_BLOCK_SIZE = 16;
+    glm::ivec3 _numMeshBlocks { 1 };
+    QSet<int> _dirtyMeshBlocks;
+    std::vector<PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal>> _blockMeshes;
+    PolyVoxSurfaceStyle _blockMeshesStyle { SURFACE_MARCHING_CUBES };
+    void markMeshBlocksDirty(int x, int y, int z);
+
     bool inUserBounds(const PolyVox::SimpleVolume<uint8_t>* vol, PolyVoxEntityItem::PolyVoxSurfaceStyle surfaceStyle,
                       int x, int y, int z) const;
     uint8_t getVoxelInternal(int x, int y, int z);
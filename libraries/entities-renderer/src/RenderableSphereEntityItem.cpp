@@ -69,10 +69,10 @@ void RenderableSphereEntityItem::render(RenderArgs* args) {
         _procedural->prepare(batch, getPosition(), getDimensions());
         auto color = _procedural->getColor(sphereColor);
         batch._glColor4f(color.r, color.g, color.b, color.a);
-        DependencyManager::get<GeometryCache>()->renderSphere(batch);
+        DependencyManager::borrow<GeometryCache>()->renderSphere(batch);
     } else {
-        DependencyManager::get<GeometryCache>()->renderSolidSphereInstance(batch, sphereColor);
+        DependencyManager::borrow<GeometryCache>()->renderSolidSphereInstance(batch, sphereColor);
     }
-    static const auto triCount = DependencyManager::get<GeometryCache>()->getSphereTriangleCount();
+    static const auto triCount = DependencyManager::borrow<GeometryCache>()->getSphereTriangleCount();
     args->_details._trianglesRendered += (int)triCount;
 }
@@ -62,8 +62,8 @@ void RenderableTextEntityItem::render(RenderArgs* args) {
     
     batch.setModelTransform(transformToTopLeft);
     
-    DependencyManager::get<GeometryCache>()->bindSimpleProgram(batch, false, false, false, true);
-    DependencyManager::get<GeometryCache>()->renderQuad(batch, minCorner, maxCorner, backgroundColor);
+    DependencyManager::borrow<GeometryCache>()->bindSimpleProgram(batch, false, false, false, true);
+    DependencyManager::borrow<GeometryCache>()->renderQuad(batch, minCorner, maxCorner, backgroundColor);
     
     float scale = _lineHeight / _textRenderer->getFontSize();
     transformToTopLeft.setScale(scale); // Scale to have the correct line height
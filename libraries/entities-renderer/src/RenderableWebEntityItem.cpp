@@ -12,6 +12,7 @@
 #include <QQuickItem>
 #include <QQuickWindow>
 #include <QOpenGLContext>
+#include <QTimer>
 
 #include <glm/gtx/quaternion.hpp>
 
@@ -20,7 +21,9 @@
 #include <gl/OffscreenQmlSurface.h>
 #include <AbstractViewStateInterface.h>
 #include <GLMHelpers.h>
+#include <NumericalConstants.h>
 #include <PathUtils.h>
+#include <SharedUtil.h>
 #include <TextureCache.h>
 #include <gpu/Context.h>
 
@@ -29,6 +32,19 @@
 const float DPI = 30.47f;
 const float METERS_TO_INCHES = 39.3701f;
 
+// Each web surface is a QML window with a GL context and a render thread of its own, so only so many are kept: those of
+// the web entities drawn last, the others giving theirs up.  A surface is paused once its entity isn't being drawn, and
+// renders its page less often the farther its entity is.
+static const size_t MAX_WEB_SURFACES = 8;
+static const quint64 UNDRAWN_SURFACE_PAUSE_USECS = USECS_PER_SECOND / 2;
+static const int PAUSE_CHECK_INTERVAL_MSECS = 250;
+static const float FULL_RATE_DISTANCE = 5.0f; // meters
+static const uint8_t MAX_WEB_SURFACE_FPS = 60;
+static const uint8_t MIN_WEB_SURFACE_FPS = 5;
+
+std::mutex RenderableWebEntityItem::_surfacesMutex;
+std::list<RenderableWebEntityItem*> RenderableWebEntityItem::_entitiesWithSurfaces;
+
 EntityItemPointer RenderableWebEntityItem::factory(const EntityItemID& entityID, const EntityItemProperties& properties) {
     EntityItemPointer entity{ new RenderableWebEntityItem(entityID) };
     entity->setProperties(properties);
@@ -41,6 +57,15 @@ RenderableWebEntityItem::RenderableWebEntityItem(const EntityItemID& entityItemI
 }
 
 RenderableWebEntityItem::~RenderableWebEntityItem() {
+    {
+        std::lock_guard<std::mutex> lock(_surfacesMutex);
+        _entitiesWithSurfaces.remove(this);
+        destroyWebSurface();
+    }
+    qDebug() << "Destroyed web entity " << getID();
+}
+
+void RenderableWebEntityItem::destroyWebSurface() {
     if (_webSurface) {
         _webSurface->pause();
         _webSurface->disconnect(_connection);
@@ -52,13 +77,64 @@ RenderableWebEntityItem::~RenderableWebEntityItem() {
         AbstractViewStateInterface::instance()->postLambdaEvent([webSurface] {
             webSurface->deleteLater();
         });
+        _webSurface = nullptr;
+        _texture = 0;
     }
 
     QObject::disconnect(_mousePressConnection);
     QObject::disconnect(_mouseReleaseConnection);
     QObject::disconnect(_mouseMoveConnection);
     QObject::disconnect(_hoverLeaveConnection);
-    qDebug() << "Destroyed web entity " << getID();
+}
+
+void RenderableWebEntityItem::pauseUndrawnSurfaces() {
+    std::lock_guard<std::mutex> lock(_surfacesMutex);
+    quint64 now = usecTimestampNow();
+    for (auto entity : _entitiesWithSurfaces) {
+        if (now - entity->_lastDrawn > UNDRAWN_SURFACE_PAUSE_USECS && !entity->_webSurface->isPaused()) {
+            entity->_webSurface->pause();
+        }
+    }
+}
+
+bool RenderableWebEntityItem::acquireWebSurfaceSlot() {
+    std::lock_guard<std::mutex> lock(_surfacesMutex);
+    if (_entitiesWithSurfaces.empty()) {
+        static QTimer* pauseTimer = [] {
+            auto timer = new QTimer();
+            QObject::connect(timer, &QTimer::timeout, &RenderableWebEntityItem::pauseUndrawnSurfaces);
+            timer->start(PAUSE_CHECK_INTERVAL_MSECS);
+            return timer;
+        }();
+        Q_UNUSED(pauseTimer);
+    }
+
+    // The surface of the entity drawn least recently goes, unless it is still being drawn
+    if (_entitiesWithSurfaces.size() >= MAX_WEB_SURFACES) {
+        auto leastRecentlyDrawn = _entitiesWithSurfaces.front();
+        if (usecTimestampNow() - leastRecentlyDrawn->_lastDrawn <= UNDRAWN_SURFACE_PAUSE_USECS) {
+            return false;
+        }
+        _entitiesWithSurfaces.pop_front();
+        leastRecentlyDrawn->destroyWebSurface();
+    }
+    _entitiesWithSurfaces.push_back(this);
+    return true;
+}
+
+void RenderableWebEntityItem::markDrawn(float distance) {
+    _lastDrawn = usecTimestampNow();
+    {
+        std::lock_guard<std::mutex> lock(_surfacesMutex);
+        _entitiesWithSurfaces.remove(this);
+        _entitiesWithSurfaces.push_back(this);
+    }
+
+    float fps = (float)MAX_WEB_SURFACE_FPS * FULL_RATE_DISTANCE / std::max(distance, FULL_RATE_DISTANCE);
+    _webSurface->setMaxFps((uint8_t)glm::clamp(fps, (float)MIN_WEB_SURFACE_FPS, (float)MAX_WEB_SURFACE_FPS));
+    if (_webSurface->isPaused()) {
+        _webSurface->resume();
+    }
 }
 
 void RenderableWebEntityItem::render(RenderArgs* args) {
@@ -68,13 +144,13 @@ void RenderableWebEntityItem::render(RenderArgs* args) {
         gpu::Batch& batch = *args->_batch;
         batch.setModelTransform(getTransformToCenter()); // we want to include the scale as well
         glm::vec4 cubeColor{ 1.0f, 0.0f, 0.0f, 1.0f};
-        DependencyManager::get<GeometryCache>()->renderWireCube(batch, 1.0f, cubeColor);
+        DependencyManager::borrow<GeometryCache>()->renderWireCube(batch, 1.0f, cubeColor);
     }
     #endif
 
     QOpenGLContext * currentContext = QOpenGLContext::currentContext();
     QSurface * currentSurface = currentContext->surface();
-    if (!_webSurface) {
+    if (!_webSurface && acquireWebSurfaceSlot()) {
         _webSurface = new OffscreenQmlSurface();
         _webSurface->create(currentContext);
         _webSurface->setBaseUrl(QUrl::fromLocalFile(PathUtils::resourcesPath() + "/qml/"));
@@ -175,13 +251,17 @@ void RenderableWebEntityItem::render(RenderArgs* args) {
         });
     }
 
-    glm::vec2 dims = glm::vec2(getDimensions());
-    dims *= METERS_TO_INCHES * DPI;
-    // The offscreen surface is idempotent for resizes (bails early
-    // if it's a no-op), so it's safe to just call resize every frame 
-    // without worrying about excessive overhead.
-    _webSurface->resize(QSize(dims.x, dims.y));
-    currentContext->makeCurrent(currentSurface);
+    if (_webSurface) {
+        markDrawn(glm::distance(args->_viewFrustum->getPosition(), getPosition()));
+
+        glm::vec2 dims = glm::vec2(getDimensions());
+        dims *= METERS_TO_INCHES * DPI;
+        // The offscreen surface is idempotent for resizes (bails early
+        // if it's a no-op), so it's safe to just call resize every frame 
+        // without worrying about excessive overhead.
+        _webSurface->resize(QSize(dims.x, dims.y));
+        currentContext->makeCurrent(currentSurface);
+    }
 
     PerformanceTimer perfTimer("RenderableWebEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::Web);
@@ -200,8 +280,8 @@ void RenderableWebEntityItem::render(RenderArgs* args) {
         textured = emissive = true;
     }
     
-    DependencyManager::get<GeometryCache>()->bindSimpleProgram(batch, textured, culled, emissive);
-    DependencyManager::get<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, texMin, texMax, glm::vec4(1.0f));
+    DependencyManager::borrow<GeometryCache>()->bindSimpleProgram(batch, textured, culled, emissive);
+    DependencyManager::borrow<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, texMin, texMax, glm::vec4(1.0f));
 }
 
 void RenderableWebEntityItem::setSourceUrl(const QString& value) {
@@ -217,9 +297,11 @@ void RenderableWebEntityItem::setSourceUrl(const QString& value) {
 }
 
 void RenderableWebEntityItem::setProxyWindow(QWindow* proxyWindow) {
-    _webSurface->setProxyWindow(proxyWindow);
+    if (_webSurface) {
+        _webSurface->setProxyWindow(proxyWindow);
+    }
 }
 
 QObject* RenderableWebEntityItem::getEventHandler() {
-    return _webSurface->getEventHandler();
+    return _webSurface ? _webSurface->getEventHandler() : nullptr;
 }
@@ -9,6 +9,9 @@
 #ifndef hifi_RenderableWebEntityItem_h
 #define hifi_RenderableWebEntityItem_h
 
+#include <list>
+#include <mutex>
+
 #include <QSharedPointer>
 
 #include <WebEntityItem.h>
@@ -34,7 +37,17 @@ public:
     SIMPLE_RENDERABLE();
 
 private:
+    // takes a place among the entities with surfaces, false if all of them are still being drawn
+    bool acquireWebSurfaceSlot();
+    void destroyWebSurface();
+    void markDrawn(float distance);
+    static void pauseUndrawnSurfaces();
+
+    static std::mutex _surfacesMutex;
+    static std::list<RenderableWebEntityItem*> _entitiesWithSurfaces; // the least recently drawn first
+
     OffscreenQmlSurface* _webSurface{ nullptr };
+    quint64 _lastDrawn{ 0 };
     QMetaObject::Connection _connection;
     uint32_t _texture{ 0 };
     ivec2  _lastPress{ INT_MIN };
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <assert.h>
 #include <PerfStat.h>
 #include <OctalCode.h>
@@ -35,21 +36,37 @@ void EntityEditPacketSender::adjustEditPacketForClockSkew(PacketType type, QByte
     }
 }
 
+// for callers that release seldom, the held edits go into the packets once there are this many
+const size_t MAX_HELD_EDITS = 100;
+
 void EntityEditPacketSender::queueEditEntityMessage(PacketType type, EntityItemID modelID,
                                                                 const EntityItemProperties& properties) {
     if (!_shouldSend) {
         return; // bail early
     }
 
-    QByteArray bufferOut(NLPacket::maxPayloadSize(type), 0);
+    if (type != PacketType::EntityEdit) {
+        queueEntityMessage(type, modelID, properties);
+        return;
+    }
 
-    if (EntityItemProperties::encodeEntityEditPacket(type, modelID, properties, bufferOut)) {
-        #ifdef WANT_DEBUG
-            qCDebug(entities) << "calling queueOctreeEditMessage()...";
-            qCDebug(entities) << "    id:" << modelID;
-            qCDebug(entities) << "    properties:" << properties;
-        #endif
-        queueOctreeEditMessage(type, bufferOut);
+    // the server only needs the last of several edits of the same properties, an edit of others goes after them
+    bool shouldFlush = false;
+    {
+        QMutexLocker locker(&_heldEditsLock);
+        EntityPropertyFlags changedProperties = properties.getChangedProperties();
+        auto latest = _latestHeldEdits.find(modelID);
+        if (latest != _latestHeldEdits.end() && _heldEdits[latest->second].changedProperties == changedProperties) {
+            _heldEdits[latest->second].properties = properties;
+        } else {
+            _latestHeldEdits[modelID] = _heldEdits.size();
+            _heldEdits.push_back({ modelID, changedProperties, properties });
+            shouldFlush = _heldEdits.size() >= MAX_HELD_EDITS;
+        }
+    }
+
+    if (shouldFlush) {
+        flushHeldEdits();
     }
 }
 
@@ -58,9 +75,58 @@ void EntityEditPacketSender::queueEraseEntityMessage(const EntityItemID& entityI
         return; // bail early
     }
 
+    QMutexLocker flushLocker(&_flushLock);
+
+    // the held edits of an erased entity would only be ignored by the server
+    {
+        QMutexLocker locker(&_heldEditsLock);
+        if (_latestHeldEdits.erase(entityItemID) > 0) {
+            _heldEdits.erase(std::remove_if(_heldEdits.begin(), _heldEdits.end(), [&](const HeldEdit& edit) {
+                return edit.entityID == entityItemID;
+            }), _heldEdits.end());
+            for (size_t i = 0; i < _heldEdits.size(); i++) {
+                _latestHeldEdits[_heldEdits[i].entityID] = i;
+            }
+        }
+    }
+
     QByteArray bufferOut(NLPacket::maxPayloadSize(PacketType::EntityErase), 0);
 
     if (EntityItemProperties::encodeEraseEntityMessage(entityItemID, bufferOut)) {
         queueOctreeEditMessage(PacketType::EntityErase, bufferOut);
     }
 }
+
+void EntityEditPacketSender::releaseQueuedMessages() {
+    flushHeldEdits();
+    OctreeEditPacketSender::releaseQueuedMessages();
+}
+
+void EntityEditPacketSender::queueEntityMessage(PacketType type, const EntityItemID& entityID,
+                                                const EntityItemProperties& properties) {
+    QByteArray bufferOut(NLPacket::maxPayloadSize(type), 0);
+
+    if (EntityItemProperties::encodeEntityEditPacket(type, entityID, properties, bufferOut)) {
+        #ifdef WANT_DEBUG
+            qCDebug(entities) << "calling queueOctreeEditMessage()...";
+            qCDebug(entities) << "    id:" << entityID;
+            qCDebug(entities) << "    properties:" << properties;
+        #endif
+        queueOctreeEditMessage(type, bufferOut);
+    }
+}
+
+void EntityEditPacketSender::flushHeldEdits() {
+    QMutexLocker flushLocker(&_flushLock);
+
+    std::vector<HeldEdit> heldEdits;
+    {
+        QMutexLocker locker(&_heldEditsLock);
+        heldEdits.swap(_heldEdits);
+        _latestHeldEdits.clear();
+    }
+
+    for (const auto& edit : heldEdits) {
+        queueEntityMessage(PacketType::EntityEdit, edit.entityID, edit.properties);
+    }
+}
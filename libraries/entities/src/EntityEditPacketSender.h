@@ -12,6 +12,11 @@
 #ifndef hifi_EntityEditPacketSender_h
 #define hifi_EntityEditPacketSender_h
 
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QMutex>
+
 #include <OctreeEditPacketSender.h>
 
 #include "EntityItem.h"
@@ -26,10 +31,15 @@ public:
     /// which voxel-server node or nodes the packet should be sent to. Can be called even before voxel servers are known, in
     /// which case up to MaxPendingMessages will be buffered and processed when voxel servers are known.
     /// NOTE: EntityItemProperties assumes that all distances are in meter units
+    /// NOTE: the edits are held until the next release, and a later edit of the same properties of an entity replaces
+    /// the one held for it, so that an entity moved many times between releases is sent once
     void queueEditEntityMessage(PacketType type, EntityItemID modelID, const EntityItemProperties& properties);
 
     void queueEraseEntityMessage(const EntityItemID& entityItemID);
 
+    /// packs the held edits then releases the packets
+    virtual void releaseQueuedMessages() override;
+
     // My server type is the model server
     virtual char getMyNodeType() const { return NodeType::EntityServer; }
     virtual void adjustEditPacketForClockSkew(PacketType type, QByteArray& buffer, int clockSkew);
@@ -39,6 +49,23 @@ public slots:
     void toggleNackPackets() { _shouldProcessNack = !_shouldProcessNack; }
 
 private:
+    struct HeldEdit {
+        EntityItemID entityID;
+        EntityPropertyFlags changedProperties;
+        EntityItemProperties properties;
+    };
+
+    void queueEntityMessage(PacketType type, const EntityItemID& entityID, const EntityItemProperties& properties);
+    void flushHeldEdits();
+
     bool _shouldProcessNack = true;
+
+    // the edits in the order they came, and which of them is the latest for each entity
+    QMutex _heldEditsLock;
+    std::vector<HeldEdit> _heldEdits;
+    std::unordered_map<QUuid, size_t> _latestHeldEdits;
+
+    // so that the edits from one flush can't go out after those of a later flush or an erase
+    QMutex _flushLock;
 };
 #endif // hifi_EntityEditPacketSender_h
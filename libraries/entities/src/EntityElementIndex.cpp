@@ -0,0 +1,132 @@
+//
+//  EntityElementIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityElementIndex.h"
+
+#include <algorithm>
+
+#include <string.h>
+
+static const size_t MIN_BUCKETS = 64;
+static const quint32 EMPTY_BUCKET = 0xffffffff;
+static const size_t NOT_FOUND = (size_t)-1;
+
+size_t EntityElementIndex::hash(const EntityItemID& entityID) {
+    quint64 halves[2];
+    memcpy(halves, &entityID.data1, sizeof(halves));
+
+    // the version and variant bits are the same in every id, mixing the halves spreads the rest over the whole hash
+    quint64 mixed = halves[0] ^ (halves[1] * 0x9e3779b97f4a7c15ULL);
+    return (size_t)(mixed ^ (mixed >> 32));
+}
+
+size_t EntityElementIndex::findBucket(const EntityItemID& entityID) const {
+    if (_buckets.empty()) {
+        return NOT_FOUND;
+    }
+
+    size_t mask = _buckets.size() - 1;
+    for (size_t bucket = hash(entityID) & mask; ; bucket = (bucket + 1) & mask) {
+        quint32 slot = _buckets[bucket];
+        if (slot == EMPTY_BUCKET) {
+            return NOT_FOUND;
+        }
+        if (_entityIDs[slot] == entityID) {
+            return bucket;
+        }
+    }
+}
+
+EntityTreeElementPointer EntityElementIndex::value(const EntityItemID& entityID) const {
+    size_t bucket = findBucket(entityID);
+    if (bucket == NOT_FOUND) {
+        return EntityTreeElementPointer();
+    }
+    return _elements[_buckets[bucket]];
+}
+
+bool EntityElementIndex::contains(const EntityItemID& entityID) const {
+    return findBucket(entityID) != NOT_FOUND;
+}
+
+void EntityElementIndex::insert(const EntityItemID& entityID, const EntityTreeElementPointer& element) {
+    size_t bucket = findBucket(entityID);
+    if (bucket != NOT_FOUND) {
+        _elements[_buckets[bucket]] = element;
+        return;
+    }
+
+    if ((_entityIDs.size() + 1) * 2 > _buckets.size()) {
+        rehash(std::max(MIN_BUCKETS, _buckets.size() * 2));
+    }
+
+    size_t mask = _buckets.size() - 1;
+    bucket = hash(entityID) & mask;
+    while (_buckets[bucket] != EMPTY_BUCKET) {
+        bucket = (bucket + 1) & mask;
+    }
+
+    _buckets[bucket] = (quint32)_entityIDs.size();
+    _entityIDs.push_back(entityID);
+    _elements.push_back(element);
+}
+
+void EntityElementIndex::remove(const EntityItemID& entityID) {
+    size_t bucket = findBucket(entityID);
+    if (bucket == NOT_FOUND) {
+        return;
+    }
+
+    // keep the arrays dense by moving the last entry into the hole
+    quint32 slot = _buckets[bucket];
+    quint32 lastSlot = (quint32)_entityIDs.size() - 1;
+    if (slot != lastSlot) {
+        size_t lastBucket = findBucket(_entityIDs[lastSlot]);
+        _entityIDs[slot] = _entityIDs[lastSlot];
+        _elements[slot] = std::move(_elements[lastSlot]);
+        _buckets[lastBucket] = slot;
+    }
+    _entityIDs.pop_back();
+    _elements.pop_back();
+
+    // shift the entries after the hole back into it where they can go, so the probes don't stop early on it
+    size_t mask = _buckets.size() - 1;
+    size_t hole = bucket;
+    for (size_t next = (hole + 1) & mask; _buckets[next] != EMPTY_BUCKET; next = (next + 1) & mask) {
+        size_t home = hash(_entityIDs[_buckets[next]]) & mask;
+
+        // the entry can move to the hole if its home isn't cyclically in (hole, next]
+        bool homeIsAfterHole = (next > hole) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!homeIsAfterHole) {
+            _buckets[hole] = _buckets[next];
+            hole = next;
+        }
+    }
+    _buckets[hole] = EMPTY_BUCKET;
+}
+
+void EntityElementIndex::clear() {
+    _entityIDs.clear();
+    _elements.clear();
+    _buckets.clear();
+}
+
+void EntityElementIndex::rehash(size_t numBuckets) {
+    _buckets.assign(numBuckets, EMPTY_BUCKET);
+
+    size_t mask = numBuckets - 1;
+    for (size_t slot = 0; slot < _entityIDs.size(); slot++) {
+        size_t bucket = hash(_entityIDs[slot]) & mask;
+        while (_buckets[bucket] != EMPTY_BUCKET) {
+            bucket = (bucket + 1) & mask;
+        }
+        _buckets[bucket] = (quint32)slot;
+    }
+}
@@ -0,0 +1,53 @@
+//
+//  EntityElementIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityElementIndex_h
+#define hifi_EntityElementIndex_h
+
+#include <memory>
+#include <vector>
+
+#include "EntityItemID.h"
+
+class EntityTreeElement;
+typedef std::shared_ptr<EntityTreeElement> EntityTreeElementPointer;
+
+/// The element each entity of a tree is in, by entity id.
+/// The ids and elements are kept in two dense arrays, so going over all of the entities doesn't chase pointers through
+/// hash nodes, and they are found through a flat open addressing table of indexes into those arrays. Entity ids are
+/// random, so a few of their bits make a good enough hash.
+/// Like the rest of the tree it isn't thread safe on its own, concurrent lookups are fine but changes need the tree lock.
+class EntityElementIndex {
+public:
+    EntityTreeElementPointer value(const EntityItemID& entityID) const;
+    bool contains(const EntityItemID& entityID) const;
+
+    void insert(const EntityItemID& entityID, const EntityTreeElementPointer& element); // replaces the element if known
+    void remove(const EntityItemID& entityID);
+    void clear();
+
+    int size() const { return (int)_entityIDs.size(); }
+    bool isEmpty() const { return _entityIDs.empty(); }
+
+    // in no particular order, entries move when others are removed
+    const std::vector<EntityItemID>& getEntityIDs() const { return _entityIDs; }
+    const std::vector<EntityTreeElementPointer>& getElements() const { return _elements; }
+
+private:
+    static size_t hash(const EntityItemID& entityID);
+    size_t findBucket(const EntityItemID& entityID) const;
+    void rehash(size_t numBuckets);
+
+    std::vector<EntityItemID> _entityIDs;
+    std::vector<EntityTreeElementPointer> _elements;
+    std::vector<quint32> _buckets; // power of two sized and at most half full, indexes into the arrays or all ones
+};
+
+#endif // hifi_EntityElementIndex_h
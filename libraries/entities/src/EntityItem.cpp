@@ -14,6 +14,7 @@
 #include <QtCore/QObject>
 #include <QtEndian>
 
+#include <glm/gtc/packing.hpp>
 #include <glm/gtx/transform.hpp>
 
 #include <BufferParser.h>
@@ -31,6 +32,141 @@
 #include "EntitySimulation.h"
 #include "EntityActionFactoryInterface.h"
 
+// Since VERSION_ENTITIES_COMPACT_KINEMATICS the position, rotation and velocities start with a byte that says
+// how the rest of them is encoded. Viewers are sent the compact encodings, files and snapshots the full ones.
+enum KinematicEncoding : uint8_t {
+    FULL_KINEMATIC_ENCODING = 0,
+    COMPACT_KINEMATIC_ENCODING = 1
+};
+
+// compact positions are 16 bits per axis inside the containing element, they are only used when that is 1mm or better
+const float MAX_COMPACT_POSITION_STEP = 0.001f; // meters
+const float MAX_COMPACT_POSITION_VALUE = (float)UINT16_MAX;
+const int COMPACT_ROTATION_BITS_PER_COMPONENT = 15;
+const float MAX_HALF_FLOAT = 65504.0f;
+
+// enough for the entity property flags with every property set
+const int MAX_ENCODED_PROPERTY_FLAGS_BYTES = PROP_AFTER_LAST_ITEM / (BITS_PER_BYTE - 1) + 1;
+
+// the property encodings that are built before they go in a packet, on the stack so that encoding doesn't allocate
+class EncodedProperty {
+public:
+    const unsigned char* data() const { return _data; }
+    int length() const { return _length; }
+
+    void append(const void* bytes, int length) {
+        assert(_length + length <= MAX_LENGTH);
+        memcpy(_data + _length, bytes, length);
+        _length += length;
+    }
+    void append(uint8_t byte) { append(&byte, sizeof(byte)); }
+
+private:
+    static const int MAX_LENGTH = 32;
+    unsigned char _data[MAX_LENGTH];
+    int _length { 0 };
+};
+
+static EncodedProperty encodeKinematicPosition(const glm::vec3& position, const AACube* elementCube) {
+    uint8_t encoding = FULL_KINEMATIC_ENCODING;
+    if (elementCube && elementCube->getScale() / MAX_COMPACT_POSITION_VALUE <= MAX_COMPACT_POSITION_STEP
+            && elementCube->contains(position)) {
+        encoding = COMPACT_KINEMATIC_ENCODING;
+    }
+
+    EncodedProperty encoded;
+    encoded.append(encoding);
+    if (encoding == COMPACT_KINEMATIC_ENCODING) {
+        glm::vec3 ratio = (position - elementCube->getCorner()) / elementCube->getScale();
+        for (int i = 0; i < 3; i++) {
+            uint16_t value = (uint16_t)(glm::clamp(ratio[i], 0.0f, 1.0f) * MAX_COMPACT_POSITION_VALUE + 0.5f);
+            encoded.append(&value, sizeof(value));
+        }
+    } else {
+        encoded.append(&position, sizeof(position));
+    }
+    return encoded;
+}
+
+static int decodeKinematicPosition(const unsigned char* data, const AACube& elementCube, glm::vec3& position) {
+    if (data[0] == COMPACT_KINEMATIC_ENCODING) {
+        uint16_t values[3];
+        memcpy(values, data + 1, sizeof(values));
+        for (int i = 0; i < 3; i++) {
+            position[i] = elementCube.getCorner()[i] + (values[i] / MAX_COMPACT_POSITION_VALUE) * elementCube.getScale();
+        }
+        return 1 + sizeof(values);
+    }
+    memcpy(&position, data + 1, sizeof(position));
+    return 1 + sizeof(position);
+}
+
+static EncodedProperty encodeKinematicRotation(const glm::quat& rotation, bool compact) {
+    EncodedProperty encoded;
+    if (compact) {
+        unsigned char packed[sizeof(uint64_t)];
+        int packedSize = packOrientationQuatToSmallestThree(packed, rotation, COMPACT_ROTATION_BITS_PER_COMPONENT);
+        encoded.append(COMPACT_KINEMATIC_ENCODING);
+        encoded.append(packed, packedSize);
+    } else {
+        encoded.append(FULL_KINEMATIC_ENCODING);
+        encoded.append(&rotation, sizeof(rotation));
+    }
+    return encoded;
+}
+
+static int decodeKinematicRotation(const unsigned char* data, glm::quat& rotation) {
+    if (data[0] == COMPACT_KINEMATIC_ENCODING) {
+        return 1 + unpackOrientationQuatFromSmallestThree(data + 1, rotation, COMPACT_ROTATION_BITS_PER_COMPONENT);
+    }
+    memcpy(&rotation, data + 1, sizeof(rotation));
+    return 1 + sizeof(rotation);
+}
+
+// velocities go out as half floats, which keeps them to about a part in a thousand
+static EncodedProperty encodeKinematicVelocity(const glm::vec3& velocity, bool compact) {
+    if (compact && glm::any(glm::greaterThan(glm::abs(velocity), glm::vec3(MAX_HALF_FLOAT)))) {
+        compact = false;
+    }
+
+    EncodedProperty encoded;
+    if (compact) {
+        encoded.append(COMPACT_KINEMATIC_ENCODING);
+        for (int i = 0; i < 3; i++) {
+            uint16_t value = glm::packHalf1x16(velocity[i]);
+            encoded.append(&value, sizeof(value));
+        }
+    } else {
+        encoded.append(FULL_KINEMATIC_ENCODING);
+        encoded.append(&velocity, sizeof(velocity));
+    }
+    return encoded;
+}
+
+static int decodeKinematicVelocity(const unsigned char* data, glm::vec3& velocity) {
+    if (data[0] == COMPACT_KINEMATIC_ENCODING) {
+        uint16_t values[3];
+        memcpy(values, data + 1, sizeof(values));
+        for (int i = 0; i < 3; i++) {
+            velocity[i] = glm::unpackHalf1x16(values[i]);
+        }
+        return 1 + sizeof(values);
+    }
+    memcpy(&velocity, data + 1, sizeof(velocity));
+    return 1 + sizeof(velocity);
+}
+
+// the same bytes as appendValue(owner.toByteArray()), the length and then the owner
+static EncodedProperty encodeSimulationOwner(const SimulationOwner& owner) {
+    EncodedProperty encoded;
+    uint16_t length = SimulationOwner::NUM_BYTES_ENCODED;
+    encoded.append(&length, sizeof(length));
+    unsigned char id[NUM_BYTES_RFC4122_UUID];
+    uuidToRfc4122(owner.getID(), id);
+    encoded.append(id, sizeof(id));
+    encoded.append(owner.getPriority());
+    return encoded;
+}
 
 int EntityItem::_maxActionsDataSize = 800;
 quint64 EntityItem::_rememberDeletedActionTime = 20 * USECS_PER_SECOND;
@@ -152,26 +288,74 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
 
     OctreeElement::AppendState appendState = OctreeElement::COMPLETED; // assume the best
 
+    EntityPropertyFlags allProperties = getEntityProperties(params);
+    bool isCompleteEncoding = !(entityTreeElementExtraEncodeData
+                                && entityTreeElementExtraEncodeData->entities.contains(getEntityItemID())
+                                && entityTreeElementExtraEncodeData->entities.value(getEntityItemID()) != allProperties);
+
+    // unparented entities are always inside the element they are in, so their positions can be sent relative to it
+    AACube compactElementCube;
+    bool compactPosition = false;
+    if (params.allowLossyEncoding && getParentID().isNull()) {
+        EntityTreeElementPointer element = getElement();
+        if (element) {
+            compactElementCube = element->getAACube();
+            compactPosition = true;
+        }
+    }
+
+    EncodingCacheKey encodingCacheKey = getEncodingCacheKey();
+    encodingCacheKey.allowLossyEncoding = params.allowLossyEncoding;
+    encodingCacheKey.compactElementCube = compactElementCube;
+
+    // the encoding of all of our properties doesn't depend on who it is for, so if another send thread
+    // has already encoded this version of us we can copy that in one go
+    if (isCompleteEncoding) {
+        QByteArray cachedEncoding;
+        {
+            QMutexLocker locker(&_encodingCacheMutex);
+            if (_cachedEncodingKey == encodingCacheKey) {
+                cachedEncoding = _cachedEncoding;
+            }
+        }
+
+        // if it doesn't fit whole, encode it properly so whatever fits still goes in this packet
+        if (!cachedEncoding.isEmpty()
+            && packetData->appendRawData((const unsigned char*)cachedEncoding.constData(), cachedEncoding.size())) {
+            params.trackSend(getID(), getLastEdited());
+            return appendState;
+        }
+    }
+
+    int startOfEntity = packetData->getUncompressedByteOffset();
+
+    // the header is encoded on the stack, the send threads encode many entities a second and shouldn't be
+    // allocating for each of them
+
     // encode our ID as a byte count coded byte stream
-    QByteArray encodedID = getID().toRfc4122();
+    unsigned char encodedID[NUM_BYTES_RFC4122_UUID];
+    uuidToRfc4122(getID(), encodedID);
 
     // encode our type as a byte count coded byte stream
     ByteCountCoded<quint32> typeCoder = getType();
-    QByteArray encodedType = typeCoder;
+    unsigned char encodedType[ByteCountCoded<quint32>::MAX_ENCODED_BYTES];
+    int encodedTypeLength = typeCoder.encode(encodedType);
 
     // last updated (animations, non-physics changes)
     quint64 updateDelta = getLastUpdated() <= getLastEdited() ? 0 : getLastUpdated() - getLastEdited();
     ByteCountCoded<quint64> updateDeltaCoder = updateDelta;
-    QByteArray encodedUpdateDelta = updateDeltaCoder;
+    unsigned char encodedUpdateDelta[ByteCountCoded<quint64>::MAX_ENCODED_BYTES];
+    int encodedUpdateDeltaLength = updateDeltaCoder.encode(encodedUpdateDelta);
 
     // last simulated (velocity, angular velocity, physics changes)
     quint64 simulatedDelta = getLastSimulated() <= getLastEdited() ? 0 : getLastSimulated() - getLastEdited();
     ByteCountCoded<quint64> simulatedDeltaCoder = simulatedDelta;
-    QByteArray encodedSimulatedDelta = simulatedDeltaCoder;
+    unsigned char encodedSimulatedDelta[ByteCountCoded<quint64>::MAX_ENCODED_BYTES];
+    int encodedSimulatedDeltaLength = simulatedDeltaCoder.encode(encodedSimulatedDelta);
 
 
     EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
-    EntityPropertyFlags requestedProperties = getEntityProperties(params);
+    EntityPropertyFlags requestedProperties = allProperties;
     EntityPropertyFlags propertiesDidntFit = requestedProperties;
 
     // If we are being called for a subsequent pass at appendEntityData() that failed to completely encode this item,
@@ -200,12 +384,12 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     bool successPropertyFlagsFits = false;
     int propertyFlagsOffset = 0;
     int oldPropertyFlagsLength = 0;
-    QByteArray encodedPropertyFlags;
+    unsigned char encodedPropertyFlags[MAX_ENCODED_PROPERTY_FLAGS_BYTES];
     int propertyCount = 0;
 
-    successIDFits = packetData->appendRawData(encodedID);
+    successIDFits = packetData->appendRawData(encodedID, sizeof(encodedID));
     if (successIDFits) {
-        successTypeFits = packetData->appendRawData(encodedType);
+        successTypeFits = packetData->appendRawData(encodedType, encodedTypeLength);
     }
     if (successTypeFits) {
         successCreatedFits = packetData->appendValue(_created);
@@ -214,17 +398,16 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         successLastEditedFits = packetData->appendValue(lastEdited);
     }
     if (successLastEditedFits) {
-        successLastUpdatedFits = packetData->appendRawData(encodedUpdateDelta);
+        successLastUpdatedFits = packetData->appendRawData(encodedUpdateDelta, encodedUpdateDeltaLength);
     }
     if (successLastUpdatedFits) {
-        successLastSimulatedFits = packetData->appendRawData(encodedSimulatedDelta);
+        successLastSimulatedFits = packetData->appendRawData(encodedSimulatedDelta, encodedSimulatedDeltaLength);
     }
 
     if (successLastSimulatedFits) {
         propertyFlagsOffset = packetData->getUncompressedByteOffset();
-        encodedPropertyFlags = propertyFlags;
-        oldPropertyFlagsLength = encodedPropertyFlags.length();
-        successPropertyFlagsFits = packetData->appendRawData(encodedPropertyFlags);
+        oldPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags, sizeof(encodedPropertyFlags));
+        successPropertyFlagsFits = packetData->appendRawData(encodedPropertyFlags, oldPropertyFlagsLength);
     }
 
     bool headerFits = successIDFits && successTypeFits && successCreatedFits && successLastEditedFits
@@ -241,11 +424,15 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         //      PROP_PAGED_PROPERTY,
         //      PROP_CUSTOM_PROPERTIES_INCLUDED,
 
-        APPEND_ENTITY_PROPERTY(PROP_SIMULATION_OWNER, _simulationOwner.toByteArray());
-        APPEND_ENTITY_PROPERTY(PROP_POSITION, getLocalPosition());
-        APPEND_ENTITY_PROPERTY(PROP_ROTATION, getLocalOrientation());
-        APPEND_ENTITY_PROPERTY(PROP_VELOCITY, getVelocity());
-        APPEND_ENTITY_PROPERTY(PROP_ANGULAR_VELOCITY, getAngularVelocity());
+        APPEND_ENTITY_PROPERTY_ENCODED(PROP_SIMULATION_OWNER, encodeSimulationOwner(_simulationOwner));
+        APPEND_ENTITY_PROPERTY_ENCODED(PROP_POSITION,
+            encodeKinematicPosition(getLocalPosition(), compactPosition ? &compactElementCube : nullptr));
+        APPEND_ENTITY_PROPERTY_ENCODED(PROP_ROTATION,
+            encodeKinematicRotation(getLocalOrientation(), params.allowLossyEncoding));
+        APPEND_ENTITY_PROPERTY_ENCODED(PROP_VELOCITY,
+            encodeKinematicVelocity(getVelocity(), params.allowLossyEncoding));
+        APPEND_ENTITY_PROPERTY_ENCODED(PROP_ANGULAR_VELOCITY,
+            encodeKinematicVelocity(getAngularVelocity(), params.allowLossyEncoding));
         APPEND_ENTITY_PROPERTY(PROP_ACCELERATION, getAcceleration());
 
         APPEND_ENTITY_PROPERTY(PROP_DIMENSIONS, getDimensions()); // NOTE: PROP_RADIUS obsolete
@@ -285,10 +472,8 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
 
     if (propertyCount > 0) {
         int endOfEntityItemData = packetData->getUncompressedByteOffset();
-        encodedPropertyFlags = propertyFlags;
-        int newPropertyFlagsLength = encodedPropertyFlags.length();
-        packetData->updatePriorBytes(propertyFlagsOffset,
-                (const unsigned char*)encodedPropertyFlags.constData(), encodedPropertyFlags.length());
+        int newPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags, sizeof(encodedPropertyFlags));
+        packetData->updatePriorBytes(propertyFlagsOffset, encodedPropertyFlags, newPropertyFlagsLength);
 
         // if the size of the PropertyFlags shrunk, we need to shift everything down to front of packet.
         if (newPropertyFlagsLength < oldPropertyFlagsLength) {
@@ -305,6 +490,16 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         }
 
         packetData->endLevel(entityLevel);
+
+        if (isCompleteEncoding && appendState == OctreeElement::COMPLETED) {
+            int endOfEntity = packetData->getUncompressedByteOffset();
+
+            // copied into the cache's own buffer, which only reallocates when it grows or a reader still has it
+            QMutexLocker locker(&_encodingCacheMutex);
+            _cachedEncoding.resize(endOfEntity - startOfEntity);
+            memcpy(_cachedEncoding.data(), packetData->getUncompressedData(startOfEntity), endOfEntity - startOfEntity);
+            _cachedEncodingKey = encodingCacheKey;
+        }
     } else {
         packetData->discardLevel(entityLevel);
         appendState = OctreeElement::NONE; // if we got here, then we didn't include the item
@@ -324,6 +519,21 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     return appendState;
 }
 
+EntityItem::EncodingCacheKey EntityItem::getEncodingCacheKey() const {
+    EncodingCacheKey key;
+    key.changedOnServer = _changedOnServer;
+    key.lastEdited = _lastEdited;
+    key.lastUpdated = _lastUpdated;
+    key.lastSimulated = _lastSimulated;
+    return key;
+}
+
+void EntityItem::invalidateEncodingCache() {
+    QMutexLocker locker(&_encodingCacheMutex);
+    _cachedEncoding.resize(0); // keeping its buffer for the next encoding
+    _cachedEncodingKey = EncodingCacheKey();
+}
+
 // TODO: My goal is to get rid of this concept completely. The old code (and some of the current code) used this
 // result to calculate if a packet being sent to it was potentially bad or corrupt. I've adjusted this to now
 // only consider the minimum header bytes as being required. But it would be preferable to completely eliminate
@@ -658,10 +868,21 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
         // but since we're using macros below we have to temporarily modify overwriteLocalData.
         bool oldOverwrite = overwriteLocalData;
         overwriteLocalData = overwriteLocalData && !weOwnSimulation;
-        READ_ENTITY_PROPERTY(PROP_POSITION, glm::vec3, updatePosition);
-        READ_ENTITY_PROPERTY(PROP_ROTATION, glm::quat, updateRotation);
-        READ_ENTITY_PROPERTY(PROP_VELOCITY, glm::vec3, updateVelocity);
-        READ_ENTITY_PROPERTY(PROP_ANGULAR_VELOCITY, glm::vec3, updateAngularVelocity);
+        if (args.bitstreamVersion >= VERSION_ENTITIES_COMPACT_KINEMATICS) {
+            auto decodePosition = [&](const unsigned char* data, glm::vec3& position) {
+                return decodeKinematicPosition(data, args.elementCube, position);
+            };
+            READ_ENCODED_ENTITY_PROPERTY(PROP_POSITION, glm::vec3, decodePosition, updatePosition);
+            READ_ENCODED_ENTITY_PROPERTY(PROP_ROTATION, glm::quat, decodeKinematicRotation, updateRotation);
+            READ_ENCODED_ENTITY_PROPERTY(PROP_VELOCITY, glm::vec3, decodeKinematicVelocity, updateVelocity);
+            READ_ENCODED_ENTITY_PROPERTY(PROP_ANGULAR_VELOCITY, glm::vec3, decodeKinematicVelocity,
+                                         updateAngularVelocity);
+        } else {
+            READ_ENTITY_PROPERTY(PROP_POSITION, glm::vec3, updatePosition);
+            READ_ENTITY_PROPERTY(PROP_ROTATION, glm::quat, updateRotation);
+            READ_ENTITY_PROPERTY(PROP_VELOCITY, glm::vec3, updateVelocity);
+            READ_ENTITY_PROPERTY(PROP_ANGULAR_VELOCITY, glm::vec3, updateAngularVelocity);
+        }
         READ_ENTITY_PROPERTY(PROP_ACCELERATION, glm::vec3, setAcceleration);
         overwriteLocalData = oldOverwrite;
     }
@@ -1030,43 +1251,43 @@ EntityItemProperties EntityItem::getProperties(EntityPropertyFlags desiredProper
 
     properties._type = getType();
 
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(simulationOwner, getSimulationOwner);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(position, getLocalPosition);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(dimensions, getDimensions); // NOTE: radius is obsolete
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(rotation, getLocalOrientation);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(density, getDensity);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(velocity, getVelocity);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(gravity, getGravity);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(acceleration, getAcceleration);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(damping, getDamping);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(restitution, getRestitution);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(friction, getFriction);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(created, getCreated);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(lifetime, getLifetime);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(script, getScript);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(scriptTimestamp, getScriptTimestamp);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(collisionSoundURL, getCollisionSoundURL);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(registrationPoint, getRegistrationPoint);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(angularVelocity, getAngularVelocity);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(angularDamping, getAngularDamping);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(glowLevel, getGlowLevel);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(localRenderAlpha, getLocalRenderAlpha);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(visible, getVisible);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(collisionless, getCollisionless);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(collisionMask, getCollisionMask);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(dynamic, getDynamic);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(locked, getLocked);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(userData, getUserData);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(marketplaceID, getMarketplaceID);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(name, getName);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(href, getHref);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(description, getDescription);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(actionData, getActionData);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(parentID, getParentID);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(parentJointIndex, getParentJointIndex);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(queryAACube, getQueryAACube);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(localPosition, getLocalPosition);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(localRotation, getLocalOrientation);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_SIMULATION_OWNER, simulationOwner, getSimulationOwner);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_POSITION, position, getLocalPosition);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_DIMENSIONS, dimensions, getDimensions); // NOTE: radius is obsolete
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ROTATION, rotation, getLocalOrientation);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_DENSITY, density, getDensity);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_VELOCITY, velocity, getVelocity);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_GRAVITY, gravity, getGravity);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ACCELERATION, acceleration, getAcceleration);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_DAMPING, damping, getDamping);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_RESTITUTION, restitution, getRestitution);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_FRICTION, friction, getFriction);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES_ALWAYS(created, getCreated);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LIFETIME, lifetime, getLifetime);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_SCRIPT, script, getScript);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_SCRIPT_TIMESTAMP, scriptTimestamp, getScriptTimestamp);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COLLISION_SOUND_URL, collisionSoundURL, getCollisionSoundURL);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_REGISTRATION_POINT, registrationPoint, getRegistrationPoint);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ANGULAR_VELOCITY, angularVelocity, getAngularVelocity);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ANGULAR_DAMPING, angularDamping, getAngularDamping);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES_ALWAYS(glowLevel, getGlowLevel);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES_ALWAYS(localRenderAlpha, getLocalRenderAlpha);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_VISIBLE, visible, getVisible);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COLLISIONLESS, collisionless, getCollisionless);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COLLISION_MASK, collisionMask, getCollisionMask);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_DYNAMIC, dynamic, getDynamic);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LOCKED, locked, getLocked);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_USER_DATA, userData, getUserData);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_MARKETPLACE_ID, marketplaceID, getMarketplaceID);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_NAME, name, getName);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_HREF, href, getHref);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_DESCRIPTION, description, getDescription);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ACTION_DATA, actionData, getActionData);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_PARENT_ID, parentID, getParentID);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_PARENT_JOINT_INDEX, parentJointIndex, getParentJointIndex);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_QUERY_AA_CUBE, queryAACube, getQueryAACube);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LOCAL_POSITION, localPosition, getLocalPosition);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LOCAL_ROTATION, localRotation, getLocalOrientation);
 
     properties._defaultSettings = false;
 
@@ -1573,6 +1794,7 @@ void EntityItem::clearSimulationOwnership() {
     }
 
     _simulationOwner.clear();
+    invalidateEncodingCache();
     // don't bother setting the DIRTY_SIMULATOR_ID flag because clearSimulationOwnership()
     // is only ever called entity-server-side and the flags are only used client-side
     //_dirtyFlags |= Simulation::DIRTY_SIMULATOR_ID;
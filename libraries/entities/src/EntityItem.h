@@ -17,6 +17,8 @@
 
 #include <glm/glm.hpp>
 
+#include <QtCore/QMutex>
+
 #include <AnimationCache.h> // for Animation, AnimationCache, and AnimationPointer classes
 #include <Octree.h> // for EncodeBitstreamParams class
 #include <OctreeElement.h> // for OctreeElement::AppendState
@@ -107,6 +109,9 @@ public:
     void markAsChangedOnServer() {  _changedOnServer = usecTimestampNow();  }
     quint64 getLastChangedOnServer() const { return _changedOnServer; }
 
+    /// drops the cached encoding of this entity, for changes that don't move any of its edit or simulation times
+    void invalidateEncodingCache();
+
     // TODO: eventually only include properties changed since the params.lastViewFrustumSent time
     virtual EntityPropertyFlags getEntityProperties(EncodeBitstreamParams& params) const;
 
@@ -421,6 +426,28 @@ protected:
     quint64 _created;
     quint64 _changedOnServer;
 
+    // the last complete encoding of this entity, it is the same for every viewer so the octree send threads
+    // share it until one of the times it was encoded at moves
+    struct EncodingCacheKey {
+        quint64 changedOnServer { 0 };
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+        bool allowLossyEncoding { false };
+        AACube compactElementCube; // the cube the position is relative to, when it is
+
+        bool operator==(const EncodingCacheKey& other) const {
+            return changedOnServer == other.changedOnServer && lastEdited == other.lastEdited
+                && lastUpdated == other.lastUpdated && lastSimulated == other.lastSimulated
+                && allowLossyEncoding == other.allowLossyEncoding && compactElementCube == other.compactElementCube;
+        }
+    };
+    EncodingCacheKey getEncodingCacheKey() const;
+
+    mutable QMutex _encodingCacheMutex;
+    mutable QByteArray _cachedEncoding;
+    mutable EncodingCacheKey _cachedEncodingKey;
+
     mutable AABox _cachedAABox;
     mutable AACube _maxAACube;
     mutable AACube _minAACube;
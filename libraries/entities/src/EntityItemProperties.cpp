@@ -319,7 +319,8 @@ EntityPropertyFlags EntityItemProperties::getChangedProperties() const {
 
 QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine, bool skipDefaults) const {
     QScriptValue properties = engine->newObject();
-    EntityItemProperties defaultEntityProperties;
+    // only read from, so one shared instance does instead of building all of the properties again on every call
+    static const EntityItemProperties defaultEntityProperties;
 
     if (_created == UNKNOWN_CREATED_TIME) {
         // No entity properties can have been set so return without setting any default, zero property values.
@@ -513,7 +514,11 @@ QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine, bool
         COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_ALWAYS(sittingPoints, sittingPoints); // gettable, but not settable
     }
 
-    if (!skipDefaults) {
+    // the bounding box is made from the position, dimensions, rotation and registration point, so it's only there with
+    // the first two
+    bool wantsBoundingBox = _desiredProperties.isEmpty() ||
+        (_desiredProperties.getHasProperty(PROP_POSITION) && _desiredProperties.getHasProperty(PROP_DIMENSIONS));
+    if (!skipDefaults && wantsBoundingBox) {
         AABox aaBox = getAABox();
         QScriptValue boundingBox = engine->newObject();
         QScriptValue bottomRightNear = vec3toScriptValue(engine, aaBox.getCorner());
@@ -527,8 +532,8 @@ QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine, bool
         COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_NO_SKIP(boundingBox, boundingBox); // gettable, but not settable
     }
 
-    QString textureNamesList = _textureNames.join(",\n");
-    if (!skipDefaults) {
+    if (!skipDefaults && (_desiredProperties.isEmpty() || _desiredProperties.getHasProperty(PROP_TEXTURES))) {
+        QString textureNamesList = _textureNames.join(",\n");
         COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER_NO_SKIP(originalTextures, textureNamesList); // gettable, but not settable
     }
 
@@ -823,6 +828,7 @@ void EntityItemProperties::entityPropertyFlagsFromScriptValue(const QScriptValue
 
         ADD_PROPERTY_TO_MAP(PROP_PARENT_ID, ParentID, parentID, QUuid);
         ADD_PROPERTY_TO_MAP(PROP_PARENT_JOINT_INDEX, ParentJointIndex, parentJointIndex, uint16_t);
+        ADD_PROPERTY_TO_MAP(PROP_QUERY_AA_CUBE, QueryAACube, queryAACube, AACube);
 
         ADD_PROPERTY_TO_MAP(PROP_LOCAL_POSITION, LocalPosition, localPosition, glm::vec3);
         ADD_PROPERTY_TO_MAP(PROP_LOCAL_ROTATION, LocalRotation, localRotation, glm::quat);
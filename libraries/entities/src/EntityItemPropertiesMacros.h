@@ -35,6 +35,25 @@
             propertiesDidntFit -= P;                                \
         }
 
+// for values that are already encoded, and carry their own length, V has the data() and length() of its bytes
+#define APPEND_ENTITY_PROPERTY_ENCODED(P,V) \
+        if (requestedProperties.getHasProperty(P)) {                \
+            LevelDetails propertyLevel = packetData->startLevel();  \
+            const auto& encoded = V;                                \
+            successPropertyFits = packetData->appendRawData(encoded.data(), encoded.length()); \
+            if (successPropertyFits) {                              \
+                propertyFlags |= P;                                 \
+                propertiesDidntFit -= P;                            \
+                propertyCount++;                                    \
+                packetData->endLevel(propertyLevel);                \
+            } else {                                                \
+                packetData->discardLevel(propertyLevel);            \
+                appendState = OctreeElement::PARTIAL;               \
+            }                                                       \
+        } else {                                                    \
+            propertiesDidntFit -= P;                                \
+        }
+
 #define READ_ENTITY_PROPERTY(P,T,S)                                                \
         if (propertyFlags.getHasProperty(P)) {                                     \
             T fromBuffer;                                                          \
@@ -47,6 +66,19 @@
             somethingChanged = true;                                               \
         }
 
+// D is the decoder for values appended with APPEND_ENTITY_PROPERTY_ENCODED, it returns the bytes it read
+#define READ_ENCODED_ENTITY_PROPERTY(P,T,D,S)                                      \
+        if (propertyFlags.getHasProperty(P)) {                                     \
+            T fromBuffer;                                                          \
+            int bytes = D(dataAt, fromBuffer);                                     \
+            dataAt += bytes;                                                       \
+            bytesRead += bytes;                                                    \
+            if (overwriteLocalData) {                                              \
+                S(fromBuffer);                                                     \
+            }                                                                      \
+            somethingChanged = true;                                               \
+        }
+
 #define SKIP_ENTITY_PROPERTY(P,T)                                                  \
         if (propertyFlags.getHasProperty(P)) {                                     \
             T fromBuffer;                                                          \
@@ -88,8 +120,15 @@
         somethingChanged = true;                    \
     }
 
-#define COPY_ENTITY_PROPERTY_TO_PROPERTIES(P,M) \
-    properties._##P = M();                      \
+// only copies the properties in desiredProperties, all of them when it is empty
+#define COPY_ENTITY_PROPERTY_TO_PROPERTIES(p,P,M)                               \
+    if (desiredProperties.isEmpty() || desiredProperties.getHasProperty(p)) {   \
+        properties._##P = M();                                                  \
+        properties._##P##Changed = false;                                       \
+    }
+
+#define COPY_ENTITY_PROPERTY_TO_PROPERTIES_ALWAYS(P,M) \
+    properties._##P = M();                             \
     properties._##P##Changed = false;
 
 #define COPY_ENTITY_GROUP_PROPERTY_TO_PROPERTIES(G,P,M)  \
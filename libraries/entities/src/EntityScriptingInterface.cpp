@@ -11,6 +11,10 @@
 
 #include "EntityScriptingInterface.h"
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QFutureWatcher>
+#include <QtScript/QScriptEngine>
+
 #include "EntityItemID.h"
 #include <VariantMapToScriptValue.h>
 
@@ -165,6 +169,7 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
 
 EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identity, EntityPropertyFlags desiredProperties) {
     EntityItemProperties results;
+    bool wantsLocation = false;
     if (_entityTree) {
         _entityTree->withReadLock([&] {
             EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(identity));
@@ -176,6 +181,11 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
                     // if we are explicitly getting position or rotation, we need parent information to make sense of them.
                     desiredProperties.setHasProperty(PROP_PARENT_ID);
                     desiredProperties.setHasProperty(PROP_PARENT_JOINT_INDEX);
+                    // and the script side ones are made from the entity side ones, so get them all
+                    desiredProperties.setHasProperty(PROP_POSITION);
+                    desiredProperties.setHasProperty(PROP_ROTATION);
+                    desiredProperties.setHasProperty(PROP_LOCAL_POSITION);
+                    desiredProperties.setHasProperty(PROP_LOCAL_ROTATION);
                 }
 
                 if (desiredProperties.isEmpty()) {
@@ -186,13 +196,17 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
                     desiredProperties.setHasProperty(PROP_LOCAL_POSITION);
                     desiredProperties.setHasProperty(PROP_LOCAL_ROTATION);
                  }
+                wantsLocation = desiredProperties.getHasProperty(PROP_POSITION);
 
+                // only the desired properties are copied out of the entity and converted for the script
                 results = entity->getProperties(desiredProperties);
 
                 // TODO: improve sitting points and naturalDimensions in the future,
                 //       for now we've included the old sitting points model behavior for entity types that are models
                 //        we've also added this hack for setting natural dimensions of models
-                if (entity->getType() == EntityTypes::Model) {
+                bool wantsNaturalExtents = desiredProperties.getHasProperty(PROP_DIMENSIONS) ||
+                                           desiredProperties.getHasProperty(PROP_POSITION);
+                if (entity->getType() == EntityTypes::Model && wantsNaturalExtents) {
                     const FBXGeometry* geometry = _entityTree->getGeometryForEntity(entity);
                     if (geometry) {
                         results.setSittingPoints(geometry->sittingPoints);
@@ -206,7 +220,8 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
         });
     }
 
-    return convertLocationToScriptSemantics(results);
+    // converting to world space looks up the parent, scripts polling other properties don't need it
+    return wantsLocation ? convertLocationToScriptSemantics(results) : results;
 }
 
 QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties& scriptSideProperties) {
@@ -220,28 +235,7 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties&
 
     bool updatedEntity = false;
     _entityTree->withWriteLock([&] {
-        if (scriptSideProperties.parentRelatedPropertyChanged()) {
-            // All of parentID, parentJointIndex, position, rotation are needed to make sense of any of them.
-            // If any of these changed, pull any missing properties from the entity.
-            EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
-            if (!entity) {
-                return;
-            }
-            if (!scriptSideProperties.parentIDChanged()) {
-                properties.setParentID(entity->getParentID());
-            }
-            if (!scriptSideProperties.parentJointIndexChanged()) {
-                properties.setParentJointIndex(entity->getParentJointIndex());
-            }
-            if (!scriptSideProperties.localPositionChanged() && !scriptSideProperties.positionChanged()) {
-                properties.setPosition(entity->getPosition());
-            }
-            if (!scriptSideProperties.localRotationChanged() && !scriptSideProperties.rotationChanged()) {
-                properties.setRotation(entity->getOrientation());
-            }
-        }
-        properties = convertLocationFromScriptSemantics(properties);
-        updatedEntity = _entityTree->updateEntity(entityID, properties);
+        updatedEntity = updateEntityInTree(entityID, properties);
     });
 
     if (!updatedEntity) {
@@ -249,62 +243,136 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties&
     }
 
     _entityTree->withReadLock([&] {
+        prepareEditMessage(entityID, properties);
+    });
+    queueEntityMessage(PacketType::EntityEdit, entityID, properties);
+    return id;
+}
+
+void EntityScriptingInterface::queueEditEntity(QUuid id, const EntityItemProperties& properties) {
+    QueuedEdit edit;
+    edit.entityID = EntityItemID(id);
+    edit.properties = properties;
+
+    QMutexLocker locker(&_editBatchesMutex);
+    _editBatches[QThread::currentThread()] << edit;
+}
+
+void EntityScriptingInterface::flushEditBatch() {
+    QVector<QueuedEdit> edits;
+    {
+        QMutexLocker locker(&_editBatchesMutex);
+        auto batch = _editBatches.find(QThread::currentThread());
+        if (batch == _editBatches.end()) {
+            return;
+        }
+        edits.swap(batch.value());
+        _editBatches.erase(batch);
+    }
+
+    if (!_entityTree) {
+        for (const QueuedEdit& edit : edits) {
+            queueEntityMessage(PacketType::EntityEdit, edit.entityID, edit.properties);
+        }
+        return;
+    }
+
+    // the edits are applied in the order they were queued, so a later edit of an entity wins over an earlier one
+    _entityTree->withWriteLock([&] {
+        for (QueuedEdit& edit : edits) {
+            edit.updated = updateEntityInTree(edit.entityID, edit.properties);
+            if (edit.updated) {
+                prepareEditMessage(edit.entityID, edit.properties);
+            }
+        }
+    });
+
+    for (const QueuedEdit& edit : edits) {
+        if (edit.updated) {
+            queueEntityMessage(PacketType::EntityEdit, edit.entityID, edit.properties);
+        }
+    }
+}
+
+bool EntityScriptingInterface::updateEntityInTree(const EntityItemID& entityID, EntityItemProperties& properties) {
+    if (properties.parentRelatedPropertyChanged()) {
+        // All of parentID, parentJointIndex, position, rotation are needed to make sense of any of them.
+        // If any of these changed, pull any missing properties from the entity.
         EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
-        if (entity) {
-            // make sure the properties has a type, so that the encode can know which properties to include
-            properties.setType(entity->getType());
-            bool hasTerseUpdateChanges = properties.hasTerseUpdateChanges();
-            bool hasPhysicsChanges = properties.hasMiscPhysicsChanges() || hasTerseUpdateChanges;
-            if (hasPhysicsChanges) {
-                auto nodeList = DependencyManager::get<NodeList>();
-                const QUuid myNodeID = nodeList->getSessionUUID();
+        if (!entity) {
+            return false;
+        }
+        if (!properties.parentIDChanged()) {
+            properties.setParentID(entity->getParentID());
+        }
+        if (!properties.parentJointIndexChanged()) {
+            properties.setParentJointIndex(entity->getParentJointIndex());
+        }
+        if (!properties.localPositionChanged() && !properties.positionChanged()) {
+            properties.setPosition(entity->getPosition());
+        }
+        if (!properties.localRotationChanged() && !properties.rotationChanged()) {
+            properties.setRotation(entity->getOrientation());
+        }
+    }
+    properties = convertLocationFromScriptSemantics(properties);
+    return _entityTree->updateEntity(entityID, properties);
+}
 
-                if (entity->getSimulatorID() == myNodeID) {
-                    // we think we already own the simulation, so make sure to send ALL TerseUpdate properties
-                    if (hasTerseUpdateChanges) {
-                        entity->getAllTerseUpdateProperties(properties);
-                    }
-                    // TODO: if we knew that ONLY TerseUpdate properties have changed in properties AND the object
-                    // is dynamic AND it is active in the physics simulation then we could chose to NOT queue an update
-                    // and instead let the physics simulation decide when to send a terse update.  This would remove
-                    // the "slide-no-rotate" glitch (and typical a double-update) that we see during the "poke rolling
-                    // balls" test.  However, even if we solve this problem we still need to provide a "slerp the visible
-                    // proxy toward the true physical position" feature to hide the final glitches in the remote watcher's
-                    // simulation.
-
-                    if (entity->getSimulationPriority() < SCRIPT_EDIT_SIMULATION_PRIORITY) {
-                        // we re-assert our simulation ownership at a higher priority
-                        properties.setSimulationOwner(myNodeID,
-                            glm::max(entity->getSimulationPriority(), SCRIPT_EDIT_SIMULATION_PRIORITY));
-                    }
-                } else {
-                    // we make a bid for simulation ownership
-                    properties.setSimulationOwner(myNodeID, SCRIPT_EDIT_SIMULATION_PRIORITY);
-                    entity->flagForOwnership();
+void EntityScriptingInterface::prepareEditMessage(const EntityItemID& entityID, EntityItemProperties& properties) {
+    EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
+    if (entity) {
+        // make sure the properties has a type, so that the encode can know which properties to include
+        properties.setType(entity->getType());
+        bool hasTerseUpdateChanges = properties.hasTerseUpdateChanges();
+        bool hasPhysicsChanges = properties.hasMiscPhysicsChanges() || hasTerseUpdateChanges;
+        if (hasPhysicsChanges) {
+            auto nodeList = DependencyManager::get<NodeList>();
+            const QUuid myNodeID = nodeList->getSessionUUID();
+
+            if (entity->getSimulatorID() == myNodeID) {
+                // we think we already own the simulation, so make sure to send ALL TerseUpdate properties
+                if (hasTerseUpdateChanges) {
+                    entity->getAllTerseUpdateProperties(properties);
                 }
-            }
-            if (properties.parentRelatedPropertyChanged() && entity->computePuffedQueryAACube()) {
-                properties.setQueryAACube(entity->getQueryAACube());
-            }
-            entity->setLastBroadcast(usecTimestampNow());
-
-            // if we've moved an entity with children, check/update the queryAACube of all descendents and tell the server
-            // if they've changed.
-            entity->forEachDescendant([&](SpatiallyNestablePointer descendant) {
-                if (descendant->getNestableType() == NestableType::Entity) {
-                    if (descendant->computePuffedQueryAACube()) {
-                        EntityItemPointer entityDescendant = std::static_pointer_cast<EntityItem>(descendant);
-                        EntityItemProperties newQueryCubeProperties;
-                        newQueryCubeProperties.setQueryAACube(descendant->getQueryAACube());
-                        queueEntityMessage(PacketType::EntityEdit, descendant->getID(), newQueryCubeProperties);
-                        entityDescendant->setLastBroadcast(usecTimestampNow());
-                    }
+                // TODO: if we knew that ONLY TerseUpdate properties have changed in properties AND the object
+                // is dynamic AND it is active in the physics simulation then we could chose to NOT queue an update
+                // and instead let the physics simulation decide when to send a terse update.  This would remove
+                // the "slide-no-rotate" glitch (and typical a double-update) that we see during the "poke rolling
+                // balls" test.  However, even if we solve this problem we still need to provide a "slerp the visible
+                // proxy toward the true physical position" feature to hide the final glitches in the remote watcher's
+                // simulation.
+
+                if (entity->getSimulationPriority() < SCRIPT_EDIT_SIMULATION_PRIORITY) {
+                    // we re-assert our simulation ownership at a higher priority
+                    properties.setSimulationOwner(myNodeID,
+                        glm::max(entity->getSimulationPriority(), SCRIPT_EDIT_SIMULATION_PRIORITY));
                 }
-            });
+            } else {
+                // we make a bid for simulation ownership
+                properties.setSimulationOwner(myNodeID, SCRIPT_EDIT_SIMULATION_PRIORITY);
+                entity->flagForOwnership();
+            }
         }
-    });
-    queueEntityMessage(PacketType::EntityEdit, entityID, properties);
-    return id;
+        if (properties.parentRelatedPropertyChanged() && entity->computePuffedQueryAACube()) {
+            properties.setQueryAACube(entity->getQueryAACube());
+        }
+        entity->setLastBroadcast(usecTimestampNow());
+
+        // if we've moved an entity with children, check/update the queryAACube of all descendents and tell the server
+        // if they've changed.
+        entity->forEachDescendant([&](SpatiallyNestablePointer descendant) {
+            if (descendant->getNestableType() == NestableType::Entity) {
+                if (descendant->computePuffedQueryAACube()) {
+                    EntityItemPointer entityDescendant = std::static_pointer_cast<EntityItem>(descendant);
+                    EntityItemProperties newQueryCubeProperties;
+                    newQueryCubeProperties.setQueryAACube(descendant->getQueryAACube());
+                    queueEntityMessage(PacketType::EntityEdit, descendant->getID(), newQueryCubeProperties);
+                    entityDescendant->setLastBroadcast(usecTimestampNow());
+                }
+            }
+        });
+    }
 }
 
 void EntityScriptingInterface::deleteEntity(QUuid id) {
@@ -338,6 +406,21 @@ void EntityScriptingInterface::callEntityMethod(QUuid id, const QString& method,
     }
 }
 
+QVector<glm::vec3> EntityScriptingInterface::getEntityPositions(const QVector<QUuid>& entityIDs) {
+    QVector<glm::vec3> positions(entityIDs.size(), glm::vec3(NAN));
+    if (_entityTree) {
+        _entityTree->withReadLock([&] {
+            for (int i = 0; i < entityIDs.size(); i++) {
+                EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(entityIDs[i]));
+                if (entity) {
+                    positions[i] = entity->getPosition();
+                }
+            }
+        });
+    }
+    return positions;
+}
+
 QUuid EntityScriptingInterface::findClosestEntity(const glm::vec3& center, float radius) const {
     EntityItemID result;
     if (_entityTree) {
@@ -392,6 +475,57 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesInBox(const glm::vec3& corn
     return result;
 }
 
+QVector<QVector<QUuid>> EntityScriptingInterface::findEntitiesInSpheres(const QVector<glm::vec3>& centers,
+                                                                        const QVector<float>& radii) const {
+    QVector<QVector<QUuid>> result;
+    if (_entityTree) {
+        QVector<QVector<EntityItemPointer>> entities;
+        _entityTree->withReadLock([&] {
+            _entityTree->findEntities(centers, radii, entities);
+        });
+
+        result.reserve(entities.size());
+        foreach (const QVector<EntityItemPointer>& sphereEntities, entities) {
+            QVector<QUuid> sphereResult;
+            sphereResult.reserve(sphereEntities.size());
+            foreach (EntityItemPointer entity, sphereEntities) {
+                sphereResult << entity->getEntityItemID();
+            }
+            result << sphereResult;
+        }
+    }
+    return result;
+}
+
+QVector<QVector<QUuid>> EntityScriptingInterface::findEntitiesInBoxes(const QVector<glm::vec3>& corners,
+                                                                      const QVector<glm::vec3>& dimensions) const {
+    QVector<QVector<QUuid>> result;
+    if (_entityTree) {
+        QVector<AABox> boxes;
+        int numBoxes = std::min(corners.size(), dimensions.size());
+        boxes.reserve(numBoxes);
+        for (int i = 0; i < numBoxes; i++) {
+            boxes << AABox(corners[i], dimensions[i]);
+        }
+
+        QVector<QVector<EntityItemPointer>> entities;
+        _entityTree->withReadLock([&] {
+            _entityTree->findEntities(boxes, entities);
+        });
+
+        result.reserve(entities.size());
+        foreach (const QVector<EntityItemPointer>& boxEntities, entities) {
+            QVector<QUuid> boxResult;
+            boxResult.reserve(boxEntities.size());
+            foreach (EntityItemPointer entity, boxEntities) {
+                boxResult << entity->getEntityItemID();
+            }
+            result << boxResult;
+        }
+    }
+    return result;
+}
+
 RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersection(const PickRay& ray, bool precisionPicking, const QScriptValue& entityIdsToInclude, const QScriptValue& entityIdsToDiscard) {
     QVector<EntityItemID> entitiesToInclude = qVectorEntityItemIDFromScriptValue(entityIdsToInclude);
     QVector<EntityItemID> entitiesToDiscard = qVectorEntityItemIDFromScriptValue(entityIdsToDiscard);
@@ -404,6 +538,26 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionBlock
     return findRayIntersectionWorker(ray, Octree::Lock, precisionPicking, entitiesToInclude, entitiesToDiscard);
 }
 
+void EntityScriptingInterface::findRayIntersectionAsync(const PickRay& ray, QScriptValue callback, bool precisionPicking, const QScriptValue& entityIdsToInclude, const QScriptValue& entityIdsToDiscard) {
+    if (!callback.isFunction()) {
+        return;
+    }
+    QVector<EntityItemID> entitiesToInclude = qVectorEntityItemIDFromScriptValue(entityIdsToInclude);
+    QVector<EntityItemID> entitiesToDiscard = qVectorEntityItemIDFromScriptValue(entityIdsToDiscard);
+
+    // the watcher lives on the script's thread and goes with its engine, so the callback comes on that thread, if at all
+    QScriptEngine* engine = callback.engine();
+    auto watcher = new QFutureWatcher<RayToEntityIntersectionResult>(engine);
+    connect(watcher, &QFutureWatcher<RayToEntityIntersectionResult>::finished, engine, [watcher, engine, callback]() mutable {
+        QScriptValueList args { RayToEntityIntersectionResultToScriptValue(engine, watcher->result()) };
+        callback.call(QScriptValue(), args);
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run([this, ray, precisionPicking, entitiesToInclude, entitiesToDiscard] {
+        return findRayIntersectionWorker(ray, Octree::Lock, precisionPicking, entitiesToInclude, entitiesToDiscard);
+    }));
+}
+
 RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorker(const PickRay& ray,
                                                                                     Octree::lockType lockType,
                                                                                     bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard) {
@@ -425,6 +579,51 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorke
     return result;
 }
 
+QVector<RayToEntityIntersectionResult> EntityScriptingInterface::findRayIntersections(const QScriptValue& rays, bool precisionPicking, const QScriptValue& entityIdsToInclude, const QScriptValue& entityIdsToDiscard) {
+    QVector<EntityItemID> entitiesToInclude = qVectorEntityItemIDFromScriptValue(entityIdsToInclude);
+    QVector<EntityItemID> entitiesToDiscard = qVectorEntityItemIDFromScriptValue(entityIdsToDiscard);
+    return findRayIntersectionsWorker(rays, Octree::TryLock, precisionPicking, entitiesToInclude, entitiesToDiscard);
+}
+
+QVector<RayToEntityIntersectionResult> EntityScriptingInterface::findRayIntersectionsBlocking(const QScriptValue& rays, bool precisionPicking, const QScriptValue& entityIdsToInclude, const QScriptValue& entityIdsToDiscard) {
+    QVector<EntityItemID> entitiesToInclude = qVectorEntityItemIDFromScriptValue(entityIdsToInclude);
+    QVector<EntityItemID> entitiesToDiscard = qVectorEntityItemIDFromScriptValue(entityIdsToDiscard);
+    return findRayIntersectionsWorker(rays, Octree::Lock, precisionPicking, entitiesToInclude, entitiesToDiscard);
+}
+
+QVector<RayToEntityIntersectionResult> EntityScriptingInterface::findRayIntersectionsWorker(const QScriptValue& rays,
+                                                                                         Octree::lockType lockType,
+                                                                                         bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard) {
+    QVector<PickRay> pickRays;
+    if (rays.isArray()) {
+        int length = rays.property("length").toInteger();
+        pickRays.resize(length);
+        for (int i = 0; i < length; i++) {
+            pickRayFromScriptValue(rays.property(i), pickRays[i]);
+        }
+    }
+
+    // without the tree every ray misses, and if the tree couldn't be locked every result is inaccurate
+    QVector<RayToEntityIntersectionResult> results(pickRays.size());
+    if (_entityTree) {
+        bool requireLock = lockType == Octree::Lock;
+        bool lockResult = _entityTree->withReadLock([&] {
+            // the lock is recursive, so each ray can take it again without waiting
+            for (int i = 0; i < pickRays.size(); i++) {
+                results[i] = findRayIntersectionWorker(pickRays[i], Octree::Lock, precisionPicking,
+                                                       entityIdsToInclude, entityIdsToDiscard);
+            }
+        }, requireLock);
+
+        if (!lockResult) {
+            for (RayToEntityIntersectionResult& result : results) {
+                result.accurate = false;
+            }
+        }
+    }
+    return results;
+}
+
 void EntityScriptingInterface::setLightsArePickable(bool value) {
     LightEntityItem::setLightsArePickable(value);
 }
@@ -14,8 +14,11 @@
 #ifndef hifi_EntityScriptingInterface_h
 #define hifi_EntityScriptingInterface_h
 
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QStringList>
+#include <QtCore/QThread>
 
 #include <DependencyManager.h>
 #include <Octree.h>
@@ -49,6 +52,8 @@ public:
 };
 
 Q_DECLARE_METATYPE(RayToEntityIntersectionResult)
+Q_DECLARE_METATYPE(QVector<RayToEntityIntersectionResult>)
+Q_DECLARE_METATYPE(QVector<QVector<QUuid>>)
 
 QScriptValue RayToEntityIntersectionResultToScriptValue(QScriptEngine* engine, const RayToEntityIntersectionResult& results);
 void RayToEntityIntersectionResultFromScriptValue(const QScriptValue& object, RayToEntityIntersectionResult& results);
@@ -68,6 +73,13 @@ public:
     EntityTreePointer getEntityTree() { return _entityTree; }
     void setEntitiesScriptEngine(EntitiesScriptEngineProvider* engine) { _entitiesScriptEngine = engine; }
 
+    /// the world positions of the entities, all found under one lock of the tree, NaN for the entities that aren't in it
+    QVector<glm::vec3> getEntityPositions(const QVector<QUuid>& entityIDs);
+
+    /// applies the edits queued from this thread with queueEditEntity, all under one lock of the tree.  The script
+    /// engines call it once a frame.
+    void flushEditBatch();
+
 public slots:
 
     // returns true if the DomainServer will allow this Node/Avatar to make changes
@@ -88,6 +100,10 @@ public slots:
     /// successful edit, if the input entityID is for an unknown model this function will have no effect
     Q_INVOKABLE QUuid editEntity(QUuid entityID, const EntityItemProperties& properties);
 
+    /// queues an edit of an entity, as editEntity would make it, to be applied with the other edits queued from the
+    /// script's thread at the next frame of the script, so that the script takes the tree lock once a frame
+    Q_INVOKABLE void queueEditEntity(QUuid entityID, const EntityItemProperties& properties);
+
     /// deletes a model
     Q_INVOKABLE void deleteEntity(QUuid entityID);
 
@@ -118,6 +134,27 @@ public slots:
     /// order to return an accurate result
     Q_INVOKABLE RayToEntityIntersectionResult findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue());
 
+    /// finds the intersection as findRayIntersectionBlocking does, but waits for the lock away from the script's thread
+    /// and calls back with the result on it instead of returning it
+    Q_INVOKABLE void findRayIntersectionAsync(const PickRay& ray, QScriptValue callback, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue());
+
+    /// finds models within each of many search spheres, specified by their center points and radii, with a single
+    /// walk of the entities, the result has the models for each sphere in the same order as the spheres
+    Q_INVOKABLE QVector<QVector<QUuid>> findEntitiesInSpheres(const QVector<glm::vec3>& centers,
+                                                              const QVector<float>& radii) const;
+
+    /// finds models within each of many search boxes, specified by their corners and dimensions, with a single
+    /// walk of the entities, the result has the models for each box in the same order as the boxes
+    Q_INVOKABLE QVector<QVector<QUuid>> findEntitiesInBoxes(const QVector<glm::vec3>& corners,
+                                                            const QVector<glm::vec3>& dimensions) const;
+
+    /// Like findRayIntersection, for an array of rays, the entities are only locked once for all of them.
+    /// The result has one intersection result for each ray, in the same order as the rays
+    Q_INVOKABLE QVector<RayToEntityIntersectionResult> findRayIntersections(const QScriptValue& rays, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue());
+
+    /// Like findRayIntersectionBlocking, for an array of rays, the entities are only locked once for all of them.
+    Q_INVOKABLE QVector<RayToEntityIntersectionResult> findRayIntersectionsBlocking(const QScriptValue& rays, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue());
+
     Q_INVOKABLE void setLightsArePickable(bool value);
     Q_INVOKABLE bool getLightsArePickable() const;
 
@@ -195,6 +232,14 @@ private:
     bool setPoints(QUuid entityID, std::function<bool(LineEntityItem&)> actor);
     void queueEntityMessage(PacketType packetType, EntityItemID entityID, const EntityItemProperties& properties);
     
+    /// updates the entity in the tree from the script side properties, which are made entity side.  Must be called
+    /// with the tree write locked.
+    bool updateEntityInTree(const EntityItemID& entityID, EntityItemProperties& properties);
+
+    /// completes the properties of an edit with what the entity server needs to know about the updated entity, and
+    /// sends the edits its descendants need.  Must be called with the tree locked.
+    void prepareEditMessage(const EntityItemID& entityID, EntityItemProperties& properties);
+
     EntityItemPointer checkForTreeEntityAndTypeMatch(const QUuid& entityID,
                                                      EntityTypes::EntityType entityType = EntityTypes::Unknown);
 
@@ -203,8 +248,23 @@ private:
     RayToEntityIntersectionResult findRayIntersectionWorker(const PickRay& ray, Octree::lockType lockType,
         bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard);
 
+    /// finds the intersection of each ray, with only one lock of the tree for all of them
+    QVector<RayToEntityIntersectionResult> findRayIntersectionsWorker(const QScriptValue& rays, Octree::lockType lockType,
+        bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard);
+
     EntityTreePointer _entityTree;
     EntitiesScriptEngineProvider* _entitiesScriptEngine = nullptr;
+
+    class QueuedEdit {
+    public:
+        EntityItemID entityID;
+        EntityItemProperties properties;
+        bool updated { false };
+    };
+
+    // the edits queued from each script thread, until its engines' next frame
+    QMutex _editBatchesMutex;
+    QHash<QThread*, QVector<QueuedEdit>> _editBatches;
 };
 
 #endif // hifi_EntityScriptingInterface_h
@@ -9,12 +9,17 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QtConcurrent/QtConcurrentMap>
+
 #include <AACube.h>
 
 #include "EntitySimulation.h"
 #include "EntitiesLogging.h"
 #include "MovingEntitiesOperator.h"
 
+// below this many, starting the threads costs more than moving the entities
+static const int MIN_PARALLEL_SIMPLE_KINEMATIC_ENTITIES = 256;
+
 void EntitySimulation::setEntityTree(EntityTreePointer tree) {
     if (_entityTree && _entityTree != tree) {
         _mortalEntities.clear();
@@ -91,21 +96,22 @@ void EntitySimulation::expireMortalEntities(const quint64& now) {
         // only search for expired entities if we expect to find one
         _nextExpiry = quint64(-1);
         QMutexLocker lock(&_mutex);
-        SetOfEntities::iterator itemItr = _mortalEntities.begin();
-        while (itemItr != _mortalEntities.end()) {
-            EntityItemPointer entity = *itemItr;
+        VectorOfEntities expiredEntities;
+        _mortalEntities.removeIf([&](const EntityItemPointer& entity) {
             quint64 expiry = entity->getExpiry();
             if (expiry < now) {
-                itemItr = _mortalEntities.erase(itemItr);
-                entity->die();
-                prepareEntityForDelete(entity);
-            } else {
-                if (expiry < _nextExpiry) {
-                    // remeber the smallest _nextExpiry so we know when to start the next search
-                    _nextExpiry = expiry;
-                }
-                ++itemItr;
+                expiredEntities.push_back(entity);
+                return true;
             }
+            if (expiry < _nextExpiry) {
+                // remeber the smallest _nextExpiry so we know when to start the next search
+                _nextExpiry = expiry;
+            }
+            return false;
+        });
+        for (auto& entity : expiredEntities) {
+            entity->die();
+            prepareEntityForDelete(entity);
         }
     }
 }
@@ -114,17 +120,13 @@ void EntitySimulation::expireMortalEntities(const quint64& now) {
 void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
     PerformanceTimer perfTimer("updatingEntities");
     QMutexLocker lock(&_mutex);
-    SetOfEntities::iterator itemItr = _entitiesToUpdate.begin();
-    while (itemItr != _entitiesToUpdate.end()) {
-        EntityItemPointer entity = *itemItr;
-        // TODO: catch transition from needing update to not as a "change"
-        // so we don't have to scan for it here.
-        if (!entity->needsToCallUpdate()) {
-            itemItr = _entitiesToUpdate.erase(itemItr);
-        } else {
-            entity->update(now);
-            ++itemItr;
-        }
+    // TODO: catch transition from needing update to not as a "change"
+    // so we don't have to scan for it here.
+    _entitiesToUpdate.removeIf([](const EntityItemPointer& entity) {
+        return !entity->needsToCallUpdate();
+    });
+    for (auto& entity : _entitiesToUpdate) {
+        entity->update(now);
     }
 }
 
@@ -153,8 +155,8 @@ void EntitySimulation::sortEntitiesThatMoved() {
         }
     }
     if (moveOperator.hasMovingEntities()) {
-        PerformanceTimer perfTimer("recurseTreeWithOperator");
-        _entityTree->recurseTreeWithOperator(&moveOperator);
+        PerformanceTimer perfTimer("moveEntities");
+        moveOperator.moveEntities();
     }
 
     _entitiesToSort.clear();
@@ -251,17 +253,30 @@ void EntitySimulation::clearEntities() {
 }
 
 void EntitySimulation::moveSimpleKinematics(const quint64& now) {
-    SetOfEntities::iterator itemItr = _simpleKinematicEntities.begin();
-    while (itemItr != _simpleKinematicEntities.end()) {
-        EntityItemPointer entity = *itemItr;
-        if (entity->isMoving() && !entity->getPhysicsInfo()) {
-            entity->simulate(now);
-            _entitiesToSort.insert(entity);
-            ++itemItr;
+    PerformanceTimer perfTimer("moveSimpleKinematics");
+
+    // drop the entities that are no longer non-physical-kinematic
+    _simpleKinematicEntities.removeIf([](const EntityItemPointer& entity) {
+        return !entity->isMoving() || entity->getPhysicsInfo();
+    });
+
+    // An entity with no parent and no children only reads and writes its own state as it moves, so those are moved
+    // in parallel. The others change or depend on the location of another entity, so they are moved here in order.
+    bool moveInParallel = _simpleKinematicEntities.size() >= MIN_PARALLEL_SIMPLE_KINEMATIC_ENTITIES;
+    VectorOfEntities independentEntities;
+    for (auto& entity : _simpleKinematicEntities) {
+        if (moveInParallel && entity->getParentID().isNull() && !entity->hasChildren()) {
+            independentEntities.push_back(entity);
         } else {
-            // the entity is no longer non-physical-kinematic
-            itemItr = _simpleKinematicEntities.erase(itemItr);
+            entity->simulate(now);
         }
+        _entitiesToSort.insert(entity);
+    }
+
+    if (!independentEntities.isEmpty()) {
+        QtConcurrent::blockingMap(independentEntities, [now](EntityItemPointer& entity) {
+            entity->simulate(now);
+        });
     }
 }
 
@@ -21,6 +21,7 @@
 #include "EntityActionInterface.h"
 #include "EntityItem.h"
 #include "EntityTree.h"
+#include "FlatSetOfEntities.h"
 
 typedef QSet<EntityItemPointer> SetOfEntities;
 typedef QVector<EntityItemPointer> VectorOfEntities;
@@ -97,7 +98,7 @@ protected:
     QMutex _mutex{ QMutex::Recursive };
 
     SetOfEntities _entitiesToSort; // entities moved by simulation (and might need resort in EntityTree)
-    SetOfEntities _simpleKinematicEntities; // entities undergoing non-colliding kinematic motion
+    FlatSetOfEntities _simpleKinematicEntities; // entities undergoing non-colliding kinematic motion
     QList<EntityActionPointer> _actionsToAdd;
     QSet<QUuid> _actionsToRemove;
 
@@ -113,11 +114,11 @@ private:
     // We maintain multiple lists, each for its distinct purpose.
     // An entity may be in more than one list.
     SetOfEntities _allEntities; // tracks all entities added the simulation
-    SetOfEntities _mortalEntities; // entities that have an expiry
+    FlatSetOfEntities _mortalEntities; // entities that have an expiry
     quint64 _nextExpiry;
 
 
-    SetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
+    FlatSetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
 
 };
 
@@ -9,8 +9,15 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <PerfStat.h>
+#include <QDataStream>
 #include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QtEndian>
 #include <QtScript/QScriptEngine>
 
 #include "EntityTree.h"
@@ -27,6 +34,11 @@
 #include "RemapIDOperator.h"
 
 static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC * 50;
+static const int ENTITY_MAP_BATCH_SIZE = 256;
+
+// the persist file is written this many entities at a time, so neither the lock nor the memory it takes grows with
+// the size of the tree
+static const int ENTITY_JSON_CHUNK_SIZE = 16 * ENTITY_MAP_BATCH_SIZE;
 
 EntityTree::EntityTree(bool shouldReaverage) :
     Octree(shouldReaverage),
@@ -57,7 +69,7 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     if (_simulation) {
         _simulation->clearEntities();
     }
-    foreach (EntityTreeElementPointer element, _entityToElementMap) {
+    for (auto& element : _entityToElementMap.getElements()) {
         element->cleanupEntities();
     }
     _entityToElementMap.clear();
@@ -157,7 +169,11 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
             }
         }
     } else {
-        if (getIsServer()) {
+        if (getIsServer() && _serverSimulatesPhysics) {
+            // the server is the only simulator: bids and releases are moot, but physical edits
+            // (a script push, a grab) still go through and the server's simulation picks them up
+            properties.setSimulationOwnerChanged(false);
+        } else if (getIsServer()) {
             bool simulationBlocked = !entity->getSimulatorID().isNull();
             if (properties.simulationOwnerChanged()) {
                 QUuid submittedID = properties.getSimulationOwner().getID();
@@ -330,20 +346,24 @@ EntityItemPointer EntityTree::addEntity(const EntityItemID& entityID, const Enti
         if (recordCreationTime) {
             result->recordCreationTime();
         }
-        // Recurse the tree and store the entity in the correct tree element
-        AddEntityOperator theOperator(getThisPointer(), result);
-        recurseTreeWithOperator(&theOperator);
-        if (result->getAncestorMissing()) {
-            // we added the entity, but didn't know about all its ancestors, so it went into the wrong place.
-            // add it to a list of entities needing to be fixed once their parents are known.
-            _missingParent.append(result);
-        }
-
-        postAddEntity(result);
+        insertEntity(result);
     }
     return result;
 }
 
+void EntityTree::insertEntity(EntityItemPointer entity) {
+    // Recurse the tree and store the entity in the correct tree element
+    AddEntityOperator theOperator(getThisPointer(), entity);
+    recurseTreeWithOperator(&theOperator);
+    if (entity->getAncestorMissing()) {
+        // we added the entity, but didn't know about all its ancestors, so it went into the wrong place.
+        // add it to a list of entities needing to be fixed once their parents are known.
+        _missingParent.append(entity);
+    }
+
+    postAddEntity(entity);
+}
+
 void EntityTree::emitEntityScriptChanging(const EntityItemID& entityItemID, const bool reload) {
     emit entityScriptChanging(entityItemID, reload);
 }
@@ -443,7 +463,7 @@ void EntityTree::deleteEntities(QSet<EntityItemID> entityIDs, bool force, bool i
     }
 }
 
-void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator) {
+void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator, bool rememberDeletes) {
     quint64 deletedAt = usecTimestampNow();
     const RemovedEntities& entities = theOperator.getEntities();
     foreach(const EntityToDeleteDetails& details, entities) {
@@ -452,9 +472,18 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
 
         if (getIsServer()) {
             // set up the deleted entities ID
-            QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-            _recentlyDeletedEntityItemIDs.insert(deletedAt, theEntity->getEntityItemID());
-        } else {
+            {
+                QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                // keep the log in order even if the clock steps back
+                if (!_recentlyDeletedEntityItemIDs.empty()) {
+                    deletedAt = std::max(deletedAt, _recentlyDeletedEntityItemIDs.back().deletedAt);
+                }
+                _recentlyDeletedEntityItemIDs.push_back({ deletedAt, theEntity->getEntityItemID() });
+            }
+
+            QMutexLocker locker(&_journalLock);
+            _journalDeletedEntities << theEntity->getEntityItemID();
+        } else if (rememberDeletes) {
             // on the client side, we also remember that we deleted this entity, we don't care about the time
             trackDeletedEntity(theEntity->getEntityItemID());
         }
@@ -465,6 +494,70 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
     }
 }
 
+static bool isOutsideSphere(const EntityItemPointer& entity, const glm::vec3& center, float radius) {
+    bool success;
+    AACube queryCube = entity->getQueryAACube(success);
+    if (!success) {
+        return false; // we can't tell where it is, keep it
+    }
+    glm::vec3 penetration;
+    return !queryCube.findSpherePenetration(center, radius, penetration);
+}
+
+bool EntityTree::isOutsideInterest(const EntityItemPointer& entity) const {
+    return _interestRadius > 0.0f && isOutsideSphere(entity, _interestCenter, _interestRadius);
+}
+
+class FindEntitiesOutsideSphereArgs {
+public:
+    glm::vec3 center;
+    float radius;
+    QSet<EntityItemID> entities;
+};
+
+bool EntityTree::findOutsideSphereOperation(OctreeElementPointer element, void* extraData) {
+    FindEntitiesOutsideSphereArgs* args = static_cast<FindEntitiesOutsideSphereArgs*>(extraData);
+
+    // the entities of an element fit in its cube, so there's nothing to find in an element, or any of its children, that
+    // is entirely inside the sphere
+    const AACube& cube = element->getAACube();
+    glm::vec3 furthestCorner = glm::max(glm::abs(cube.getCorner() - args->center),
+                                        glm::abs(cube.calcTopFarLeft() - args->center));
+    if (glm::length(furthestCorner) <= args->radius) {
+        return false;
+    }
+
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+    entityTreeElement->forEachEntity([&](EntityItemPointer entity) {
+        if (isOutsideSphere(entity, args->center, args->radius)) {
+            args->entities << entity->getEntityItemID();
+        }
+    });
+    return true;
+}
+
+void EntityTree::evictEntitiesOutsideInterest() {
+    // NOTE: callers must lock the tree before using this method
+    if (_interestRadius <= 0.0f) {
+        return;
+    }
+
+    FindEntitiesOutsideSphereArgs args { _interestCenter, _interestRadius, QSet<EntityItemID>() };
+    recurseTreeWithOperation(findOutsideSphereOperation, &args);
+    if (args.entities.isEmpty()) {
+        return;
+    }
+
+    DeleteEntityOperator theOperator(getThisPointer());
+    foreach(const EntityItemID& entityID, args.entities) {
+        theOperator.addEntityIDToDeleteList(entityID);
+        emit deletingEntity(entityID);
+    }
+    recurseTreeWithOperator(&theOperator);
+    processRemovedEntities(theOperator, false);
+    _isDirty = true;
+}
+
 
 class FindNearPointArgs {
 public:
@@ -548,7 +641,9 @@ bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& d
 
     bool requireLock = lockType == Octree::Lock;
     bool lockResult = withReadLock([&]{
-        recurseTreeWithOperation(findRayIntersectionOp, &args);
+        // visit the elements nearest to the origin first, so that a close hit is found early and lets
+        // EntityTreeElement::findRayIntersection skip the subtrees that are further away than it
+        recurseTreeWithOperationDistanceSorted(findRayIntersectionOp, origin, &args);
     }, requireLock);
 
     if (accurateResult) {
@@ -660,6 +755,104 @@ void EntityTree::findEntities(const AABox& box, QVector<EntityItemPointer>& foun
     foundEntities.swap(args._foundEntities);
 }
 
+// Runs many queries in one walk of the tree. Each element is only tested against the queries that touched its
+// parent, and the walk only goes below an element while at least one query still touches it.
+template <typename Query>
+class FindEntitiesForQueriesOperator : public RecurseOctreeOperator {
+public:
+    FindEntitiesForQueriesOperator(const QVector<Query>& queries, QVector<QVector<EntityItemPointer>>& foundEntities) :
+        _queries(queries),
+        _foundEntities(foundEntities)
+    {
+        _foundEntities.clear();
+        _foundEntities.resize(_queries.size());
+    }
+
+    virtual bool preRecursion(OctreeElementPointer element) override {
+        std::vector<int> touching;
+        const AACube& cube = element->getAACube();
+        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+
+        auto check = [&](int i) {
+            if (_queries[i].touches(cube)) {
+                _queries[i].getEntities(entityTreeElement, _foundEntities[i]);
+                touching.push_back(i);
+            }
+        };
+        if (_touchingByDepth.empty()) {
+            for (int i = 0; i < _queries.size(); i++) {
+                check(i);
+            }
+        } else {
+            for (int i : _touchingByDepth.back()) {
+                check(i);
+            }
+        }
+
+        bool keepSearching = !touching.empty();
+        _touchingByDepth.push_back(std::move(touching));
+        return keepSearching;
+    }
+
+    virtual bool postRecursion(OctreeElementPointer element) override {
+        _touchingByDepth.pop_back();
+        return true;
+    }
+
+private:
+    const QVector<Query>& _queries;
+    QVector<QVector<EntityItemPointer>>& _foundEntities;
+    std::vector<std::vector<int>> _touchingByDepth;
+};
+
+class SphereQuery {
+public:
+    bool touches(const AACube& cube) const {
+        glm::vec3 penetration;
+        return cube.findSpherePenetration(center, radius, penetration);
+    }
+    void getEntities(EntityTreeElementPointer element, QVector<EntityItemPointer>& foundEntities) const {
+        element->getEntities(center, radius, foundEntities);
+    }
+
+    glm::vec3 center;
+    float radius;
+};
+
+class BoxQuery {
+public:
+    bool touches(const AACube& cube) const { return cube.touches(box); }
+    void getEntities(EntityTreeElementPointer element, QVector<EntityItemPointer>& foundEntities) const {
+        element->getEntities(box, foundEntities);
+    }
+
+    AABox box;
+};
+
+// NOTE: assumes caller has handled locking
+void EntityTree::findEntities(const QVector<glm::vec3>& centers, const QVector<float>& radii,
+                              QVector<QVector<EntityItemPointer>>& foundEntities) {
+    QVector<SphereQuery> queries;
+    int numQueries = std::min(centers.size(), radii.size());
+    queries.reserve(numQueries);
+    for (int i = 0; i < numQueries; i++) {
+        queries.push_back({ centers[i], radii[i] });
+    }
+    FindEntitiesForQueriesOperator<SphereQuery> theOperator(queries, foundEntities);
+    recurseTreeWithOperator(&theOperator);
+}
+
+// NOTE: assumes caller has handled locking
+void EntityTree::findEntities(const QVector<AABox>& boxes, QVector<QVector<EntityItemPointer>>& foundEntities) {
+    QVector<BoxQuery> queries;
+    queries.reserve(boxes.size());
+    for (const AABox& box : boxes) {
+        queries.push_back({ box });
+    }
+    FindEntitiesForQueriesOperator<BoxQuery> theOperator(queries, foundEntities);
+    recurseTreeWithOperator(&theOperator);
+}
+
 EntityItemPointer EntityTree::findEntityByID(const QUuid& id) {
     EntityItemID entityID(id);
     return findEntityByEntityItemID(entityID);
@@ -837,10 +1030,6 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
         case PacketType::EntityAdd:
         case PacketType::EntityEdit: {
             quint64 startDecode = 0, endDecode = 0;
-            quint64 startLookup = 0, endLookup = 0;
-            quint64 startUpdate = 0, endUpdate = 0;
-            quint64 startCreate = 0, endCreate = 0;
-            quint64 startLogging = 0, endLogging = 0;
 
             _totalEditMessages++;
 
@@ -855,86 +1044,234 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
             // If we got a valid edit packet, then it could be a new entity or it could be an update to
             // an existing entity... handle appropriately
             if (validEditPacket) {
-                // search for the entity by EntityItemID
-                startLookup = usecTimestampNow();
-                EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
-                endLookup = usecTimestampNow();
-                if (existingEntity && message.getType() == PacketType::EntityEdit) {
-                    // if the EntityItem exists, then update it
-                    startLogging = usecTimestampNow();
-                    if (wantEditLogging()) {
-                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
-                        qCDebug(entities) << "   properties:" << properties;
-                    }
-                    if (wantTerseEditLogging()) {
-                        QList<QString> changedProperties = properties.listChangedProperties();
-                        fixupTerseEditLogging(properties, changedProperties);
-                        qCDebug(entities) << senderNode->getUUID() << "edit" <<
-                            existingEntity->getDebugName() << changedProperties;
-                    }
-                    endLogging = usecTimestampNow();
-
-                    startUpdate = usecTimestampNow();
-                    updateEntity(entityItemID, properties, senderNode);
-                    existingEntity->markAsChangedOnServer();
-                    endUpdate = usecTimestampNow();
-                    _totalUpdates++;
-                } else if (message.getType() == PacketType::EntityAdd) {
-                    if (senderNode->getCanRez()) {
-                        // this is a new entity... assign a new entityID
-                        properties.setCreated(properties.getLastEdited());
-                        startCreate = usecTimestampNow();
-                        EntityItemPointer newEntity = addEntity(entityItemID, properties);
-                        endCreate = usecTimestampNow();
-                        _totalCreates++;
-                        if (newEntity) {
-                            newEntity->markAsChangedOnServer();
-                            notifyNewlyCreatedEntity(*newEntity, senderNode);
-
-                            startLogging = usecTimestampNow();
-                            if (wantEditLogging()) {
-                                qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
-                                                << newEntity->getEntityItemID();
-                                qCDebug(entities) << "   properties:" << properties;
-                            }
-                            if (wantTerseEditLogging()) {
-                                QList<QString> changedProperties = properties.listChangedProperties();
-                                fixupTerseEditLogging(properties, changedProperties);
-                                qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
-                            }
-                            endLogging = usecTimestampNow();
+                processEntityEdit(message.getType(), entityItemID, properties, senderNode);
+            }
 
-                        }
-                    } else {
-                        qCDebug(entities) << "User without 'rez rights' [" << senderNode->getUUID()
-                                          << "] attempted to add an entity.";
-                    }
-                } else {
-                    static QString repeatedMessage =
-                        LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
-                    qCDebug(entities) << "Edit failed. [" << message.getType() <<"] " <<
-                            "entity id:" << entityItemID << 
-                            "existingEntity pointer:" << existingEntity.get();
+            _totalDecodeTime += endDecode - startDecode;
+            break;
+        }
+
+        default:
+            processedBytes = 0;
+            break;
+    }
+    return processedBytes;
+}
+
+void EntityTree::processEntityEdit(PacketType packetType, const EntityItemID& entityItemID,
+                                   EntityItemProperties& properties, const SharedNodePointer& senderNode) {
+    quint64 startLookup = 0, endLookup = 0;
+    quint64 startUpdate = 0, endUpdate = 0;
+    quint64 startCreate = 0, endCreate = 0;
+    quint64 startLogging = 0, endLogging = 0;
+
+    // search for the entity by EntityItemID
+    startLookup = usecTimestampNow();
+    EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
+    endLookup = usecTimestampNow();
+    if (existingEntity && packetType == PacketType::EntityEdit) {
+        // if the EntityItem exists, then update it
+        startLogging = usecTimestampNow();
+        if (wantEditLogging()) {
+            qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+            qCDebug(entities) << "   properties:" << properties;
+        }
+        if (wantTerseEditLogging()) {
+            QList<QString> changedProperties = properties.listChangedProperties();
+            fixupTerseEditLogging(properties, changedProperties);
+            qCDebug(entities) << senderNode->getUUID() << "edit" <<
+                existingEntity->getDebugName() << changedProperties;
+        }
+        endLogging = usecTimestampNow();
+
+        startUpdate = usecTimestampNow();
+        updateEntity(entityItemID, properties, senderNode);
+        existingEntity->markAsChangedOnServer();
+        trackJournalChange(entityItemID);
+        endUpdate = usecTimestampNow();
+        _totalUpdates++;
+    } else if (packetType == PacketType::EntityAdd) {
+        if (senderNode->getCanRez()) {
+            // this is a new entity... assign a new entityID
+            properties.setCreated(properties.getLastEdited());
+            startCreate = usecTimestampNow();
+            EntityItemPointer newEntity = addEntity(entityItemID, properties);
+            endCreate = usecTimestampNow();
+            _totalCreates++;
+            if (newEntity) {
+                newEntity->markAsChangedOnServer();
+                trackJournalChange(entityItemID);
+                notifyNewlyCreatedEntity(*newEntity, senderNode);
+
+                startLogging = usecTimestampNow();
+                if (wantEditLogging()) {
+                    qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
+                                    << newEntity->getEntityItemID();
+                    qCDebug(entities) << "   properties:" << properties;
+                }
+                if (wantTerseEditLogging()) {
+                    QList<QString> changedProperties = properties.listChangedProperties();
+                    fixupTerseEditLogging(properties, changedProperties);
+                    qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
                 }
+                endLogging = usecTimestampNow();
+
             }
+        } else {
+            qCDebug(entities) << "User without 'rez rights' [" << senderNode->getUUID()
+                              << "] attempted to add an entity.";
+        }
+    } else {
+        static QString repeatedMessage =
+            LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
+        qCDebug(entities) << "Edit failed. [" << packetType <<"] " <<
+                "entity id:" << entityItemID << 
+                "existingEntity pointer:" << existingEntity.get();
+    }
 
+    _totalLookupTime += endLookup - startLookup;
+    _totalUpdateTime += endUpdate - startUpdate;
+    _totalCreateTime += endCreate - startCreate;
+    _totalLoggingTime += endLogging - startLogging;
+}
 
-            _totalDecodeTime += endDecode - startDecode;
-            _totalLookupTime += endLookup - startLookup;
-            _totalUpdateTime += endUpdate - startUpdate;
-            _totalCreateTime += endCreate - startCreate;
-            _totalLoggingTime += endLogging - startLogging;
+namespace {
+
+class EntityEditBatch : public OctreeEditBatch {
+public:
+    struct Edit {
+        PacketType packetType;
+        EntityItemID entityItemID;
+        EntityItemProperties properties;
+        QSet<EntityItemID> erasedEntityItemIDs;
+        SharedNodePointer senderNode;
+        quint64 decodeTime;
+        bool isSuperseded;
+    };
+
+    virtual int getNumEdits() const override { return (int)edits.size() - numSuperseded; }
+
+    void clear() {
+        edits.clear();
+        lastEditOfEntity.clear();
+        numSuperseded = 0;
+    }
+
+    std::vector<Edit> edits;
+    QHash<EntityItemID, size_t> lastEditOfEntity; // the index of the last pending EntityEdit of each entity
+    int numSuperseded { 0 };
+};
+
+// an edit is superseded by a later one from the same sender that sets every property it sets
+bool supersedes(const EntityEditBatch::Edit& later, const EntityEditBatch::Edit& earlier) {
+    if (later.senderNode != earlier.senderNode) {
+        return false;
+    }
+
+    EntityPropertyFlags laterProperties = later.properties.getChangedProperties();
+    EntityPropertyFlags earlierProperties = earlier.properties.getChangedProperties();
+    for (int flag = (int)earlierProperties.firstFlag(); flag <= (int)earlierProperties.lastFlag(); flag++) {
+        if (earlierProperties.getHasProperty((EntityPropertyList)flag) &&
+            !laterProperties.getHasProperty((EntityPropertyList)flag)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+OctreeEditBatchPointer EntityTree::createEditBatch() const {
+    return OctreeEditBatchPointer(new EntityEditBatch);
+}
+
+int EntityTree::decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& senderNode, OctreeEditBatch& batch) {
+    EntityEditBatch& entityBatch = static_cast<EntityEditBatch&>(batch);
+
+    EntityEditBatch::Edit edit;
+    edit.packetType = message.getType();
+    edit.senderNode = senderNode;
+    edit.isSuperseded = false;
 
+    quint64 startDecode = usecTimestampNow();
+    int processedBytes = 0;
+    bool isValid = false;
+    switch (edit.packetType) {
+        case PacketType::EntityErase: {
+            QByteArray dataByteArray = QByteArray::fromRawData(reinterpret_cast<const char*>(editData), maxLength);
+            processedBytes = decodeEraseMessageDetails(dataByteArray, edit.erasedEntityItemIDs);
+            isValid = !edit.erasedEntityItemIDs.isEmpty();
             break;
         }
 
-        default:
-            processedBytes = 0;
+        case PacketType::EntityAdd:
+        case PacketType::EntityEdit:
+            isValid = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
+                                                                   edit.entityItemID, edit.properties);
             break;
+
+        default:
+            return 0;
     }
+    edit.decodeTime = usecTimestampNow() - startDecode;
+
+    if (!isValid && edit.packetType == PacketType::EntityErase) {
+        return processedBytes;
+    }
+
+    if (isValid && edit.packetType == PacketType::EntityEdit) {
+        auto lastEdit = entityBatch.lastEditOfEntity.find(edit.entityItemID);
+        if (lastEdit != entityBatch.lastEditOfEntity.end()) {
+            EntityEditBatch::Edit& earlierEdit = entityBatch.edits[lastEdit.value()];
+            if (supersedes(edit, earlierEdit)) {
+                earlierEdit.isSuperseded = true;
+                entityBatch.numSuperseded++;
+            }
+        }
+        entityBatch.lastEditOfEntity[edit.entityItemID] = entityBatch.edits.size();
+    } else if (isValid && edit.packetType == PacketType::EntityAdd) {
+        // what came before an add can't be dropped for what comes after it
+        entityBatch.lastEditOfEntity.remove(edit.entityItemID);
+    } else if (isValid) {
+        for (auto& entityItemID : edit.erasedEntityItemIDs) {
+            entityBatch.lastEditOfEntity.remove(entityItemID);
+        }
+    }
+
+    // an invalid edit is still counted and timed when the batch is processed, like the ones processed right away
+    if (!isValid) {
+        edit.packetType = PacketType::Unknown;
+    }
+    entityBatch.edits.push_back(std::move(edit));
+
     return processedBytes;
 }
 
+void EntityTree::processEditBatch(OctreeEditBatch& batch) {
+    EntityEditBatch& entityBatch = static_cast<EntityEditBatch&>(batch);
+
+    for (auto& edit : entityBatch.edits) {
+        if (edit.packetType == PacketType::EntityErase) {
+            if (wantEditLogging() || wantTerseEditLogging()) {
+                for (auto& entityItemID : edit.erasedEntityItemIDs) {
+                    qCDebug(entities) << "User [" << edit.senderNode->getUUID() << "] deleting entity. ID:" << entityItemID;
+                }
+            }
+            deleteEntities(edit.erasedEntityItemIDs, true, true);
+            continue;
+        }
+
+        _totalEditMessages++;
+        _totalDecodeTime += edit.decodeTime;
+
+        if (edit.packetType != PacketType::Unknown && !edit.isSuperseded) {
+            processEntityEdit(edit.packetType, edit.entityItemID, edit.properties, edit.senderNode);
+        }
+    }
+
+    entityBatch.clear();
+}
 
 void EntityTree::notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
     _newlyCreatedHooksLock.lockForRead();
@@ -1000,8 +1337,8 @@ void EntityTree::fixupMissingParents() {
     }
 
     if (moveOperator.hasMovingEntities()) {
-        PerformanceTimer perfTimer("recurseTreeWithOperator");
-        recurseTreeWithOperator(&moveOperator);
+        PerformanceTimer perfTimer("moveEntities");
+        moveOperator.moveEntities();
     }
 
 }
@@ -1037,18 +1374,10 @@ quint64 EntityTree::getAdjustedConsiderSince(quint64 sinceTime) {
 bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime) {
     quint64 considerEntitiesSince = getAdjustedConsiderSince(sinceTime);
 
-    // we can probably leverage the ordered nature of QMultiMap to do this quickly...
-    bool hasSomethingNewer = false;
-
+    // the log is in the order of the deletes, so only the latest needs a look
     QReadLocker locker(&_recentlyDeletedEntitiesLock);
-    QMultiMap<quint64, QUuid>::const_iterator iterator = _recentlyDeletedEntityItemIDs.constBegin();
-    while (iterator != _recentlyDeletedEntityItemIDs.constEnd()) {
-        if (iterator.key() > considerEntitiesSince) {
-            hasSomethingNewer = true;
-            break; // if we have at least one item, we don't need to keep searching
-        }
-        ++iterator;
-    }
+    bool hasSomethingNewer = !_recentlyDeletedEntityItemIDs.empty() &&
+                             _recentlyDeletedEntityItemIDs.back().deletedAt > considerEntitiesSince;
 
 #ifdef EXTRA_ERASE_DEBUGGING
     if (hasSomethingNewer) {
@@ -1062,24 +1391,27 @@ bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime) {
     return hasSomethingNewer;
 }
 
+QVector<QUuid> EntityTree::getEntitiesDeletedSince(quint64 considerSince) const {
+    QVector<QUuid> entityIDs;
+
+    QReadLocker locker(&_recentlyDeletedEntitiesLock);
+    auto firstNewer = std::upper_bound(_recentlyDeletedEntityItemIDs.begin(), _recentlyDeletedEntityItemIDs.end(),
+                                       considerSince, [](quint64 time, const DeletedEntity& deleted) {
+        return time < deleted.deletedAt;
+    });
+    entityIDs.reserve((int)std::distance(firstNewer, _recentlyDeletedEntityItemIDs.end()));
+    for (auto itr = firstNewer; itr != _recentlyDeletedEntityItemIDs.end(); ++itr) {
+        entityIDs << itr->entityID;
+    }
+    return entityIDs;
+}
+
 // called by the server when it knows all nodes have been sent deleted packets
 void EntityTree::forgetEntitiesDeletedBefore(quint64 sinceTime) {
     quint64 considerSinceTime = sinceTime - DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER;
-    QSet<quint64> keysToRemove;
     QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-    QMultiMap<quint64, QUuid>::iterator iterator = _recentlyDeletedEntityItemIDs.begin();
-
-    // First find all the keys in the map that are older and need to be deleted
-    while (iterator != _recentlyDeletedEntityItemIDs.end()) {
-        if (iterator.key() <= considerSinceTime) {
-            keysToRemove << iterator.key();
-        }
-        ++iterator;
-    }
-
-    // Now run through the keysToRemove and remove them
-    foreach (quint64 value, keysToRemove) {
-        _recentlyDeletedEntityItemIDs.remove(value);
+    while (!_recentlyDeletedEntityItemIDs.empty() && _recentlyDeletedEntityItemIDs.front().deletedAt <= considerSinceTime) {
+        _recentlyDeletedEntityItemIDs.pop_front();
     }
 }
 
@@ -1131,45 +1463,44 @@ int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, cons
     #ifdef EXTRA_ERASE_DEBUGGING
         qDebug() << "EntityTree::processEraseMessageDetails()";
     #endif
-    const unsigned char* packetData = (const unsigned char*)dataByteArray.constData();
-    const unsigned char* dataAt = packetData;
+    QSet<EntityItemID> entityItemIDsToDelete;
+    int processedBytes = decodeEraseMessageDetails(dataByteArray, entityItemIDsToDelete);
+
+    if (!entityItemIDsToDelete.isEmpty()) {
+        if (wantEditLogging() || wantTerseEditLogging()) {
+            for (auto& entityItemID : entityItemIDsToDelete) {
+                qCDebug(entities) << "User [" << sourceNode->getUUID() << "] deleting entity. ID:" << entityItemID;
+            }
+        }
+        deleteEntities(entityItemIDsToDelete, true, true);
+    }
+    return processedBytes;
+}
+
+int EntityTree::decodeEraseMessageDetails(const QByteArray& dataByteArray, QSet<EntityItemID>& entityItemIDs) {
     size_t packetLength = dataByteArray.size();
     size_t processedBytes = 0;
 
     uint16_t numberOfIds = 0; // placeholder for now
-    memcpy(&numberOfIds, dataAt, sizeof(numberOfIds));
-    dataAt += sizeof(numberOfIds);
+    memcpy(&numberOfIds, dataByteArray.constData(), sizeof(numberOfIds));
     processedBytes += sizeof(numberOfIds);
 
-    if (numberOfIds > 0) {
-        QSet<EntityItemID> entityItemIDsToDelete;
-
-        for (size_t i = 0; i < numberOfIds; i++) {
-
-
-            if (processedBytes + NUM_BYTES_RFC4122_UUID > packetLength) {
-                qCDebug(entities) << "EntityTree::processEraseMessageDetails().... bailing because not enough bytes in buffer";
-                break; // bail to prevent buffer overflow
-            }
-
-            QByteArray encodedID = dataByteArray.mid((int)processedBytes, NUM_BYTES_RFC4122_UUID);
-            QUuid entityID = QUuid::fromRfc4122(encodedID);
-            dataAt += encodedID.size();
-            processedBytes += encodedID.size();
+    for (size_t i = 0; i < numberOfIds; i++) {
 
-            #ifdef EXTRA_ERASE_DEBUGGING
-                qDebug() << "    ---- EntityTree::processEraseMessageDetails() contains id:" << entityID;
-            #endif
+        if (processedBytes + NUM_BYTES_RFC4122_UUID > packetLength) {
+            qCDebug(entities) << "EntityTree::processEraseMessageDetails().... bailing because not enough bytes in buffer";
+            break; // bail to prevent buffer overflow
+        }
 
-            EntityItemID entityItemID(entityID);
-            entityItemIDsToDelete << entityItemID;
+        QByteArray encodedID = dataByteArray.mid((int)processedBytes, NUM_BYTES_RFC4122_UUID);
+        QUuid entityID = QUuid::fromRfc4122(encodedID);
+        processedBytes += encodedID.size();
 
-            if (wantEditLogging() || wantTerseEditLogging()) {
-                qCDebug(entities) << "User [" << sourceNode->getUUID() << "] deleting entity. ID:" << entityItemID;
-            }
+        #ifdef EXTRA_ERASE_DEBUGGING
+            qDebug() << "    ---- EntityTree::processEraseMessageDetails() contains id:" << entityID;
+        #endif
 
-        }
-        deleteEntities(entityItemIDsToDelete, true, true);
+        entityItemIDs << EntityItemID(entityID);
     }
     return (int)processedBytes;
 }
@@ -1183,7 +1514,7 @@ EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& en
 void EntityTree::setContainingElement(const EntityItemID& entityItemID, EntityTreeElementPointer element) {
     // TODO: do we need to make this thread safe? Or is it acceptable as is
     if (element) {
-        _entityToElementMap[entityItemID] = element;
+        _entityToElementMap.insert(entityItemID, element);
     } else {
         _entityToElementMap.remove(entityItemID);
     }
@@ -1191,10 +1522,10 @@ void EntityTree::setContainingElement(const EntityItemID& entityItemID, EntityTr
 
 void EntityTree::debugDumpMap() {
     qCDebug(entities) << "EntityTree::debugDumpMap() --------------------------";
-    QHashIterator<EntityItemID, EntityTreeElementPointer> i(_entityToElementMap);
-    while (i.hasNext()) {
-        i.next();
-        qCDebug(entities) << i.key() << ": " << i.value().get();
+    const std::vector<EntityItemID>& entityIDs = _entityToElementMap.getEntityIDs();
+    const std::vector<EntityTreeElementPointer>& elements = _entityToElementMap.getElements();
+    for (size_t i = 0; i < entityIDs.size(); i++) {
+        qCDebug(entities) << entityIDs[i] << ": " << elements[i].get();
     }
     qCDebug(entities) << "-----------------------------------------------------";
 }
@@ -1297,45 +1628,515 @@ void EntityTree::remapIDs() {
     recurseTreeWithOperator(&theOperator);
 }
 
+// the conversion is done in batches on the thread pool, each with its own script engine
+static QVariantList entityPropertiesToVariants(const QVector<EntityItemProperties>& entityProperties,
+                                               bool skipDefaultValues) {
+    QVector<QFuture<QVariantList>> batches;
+    for (int batchStart = 0; batchStart < entityProperties.size(); batchStart += ENTITY_MAP_BATCH_SIZE) {
+        batches << QtConcurrent::run([&entityProperties, batchStart, skipDefaultValues] {
+            QScriptEngine scriptEngine;
+            QVariantList batch;
+            int batchEnd = std::min(batchStart + ENTITY_MAP_BATCH_SIZE, entityProperties.size());
+            for (int i = batchStart; i < batchEnd; i++) {
+                QScriptValue qScriptValues;
+                if (skipDefaultValues) {
+                    qScriptValues = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, entityProperties.at(i));
+                } else {
+                    qScriptValues = EntityItemPropertiesToScriptValue(&scriptEngine, entityProperties.at(i));
+                }
+                batch << qScriptValues.toVariant();
+            }
+            return batch;
+        });
+    }
+
+    QVariantList variants;
+    variants.reserve(entityProperties.size());
+    for (QFuture<QVariantList>& batch : batches) {
+        variants << batch.result();
+    }
+    return variants;
+}
+
 bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) {
     if (! entityDescription.contains("Entities")) {
         entityDescription["Entities"] = QVariantList();
     }
-    QScriptEngine scriptEngine;
-    RecurseOctreeToMapOperator theOperator(entityDescription, element, &scriptEngine, skipDefaultValues, skipThoseWithBadParents);
-    recurseTreeWithOperator(&theOperator);
+
+    // only copying the properties holds up edits, converting them (the slow part of saving) is done without the lock
+    QVector<EntityItemProperties> entityProperties;
+    withReadLock([&] {
+        RecurseOctreeToMapOperator theOperator(entityProperties, element, skipThoseWithBadParents);
+        recurseTreeWithOperator(&theOperator);
+    });
+
+    QVariantList entitiesQList = entityDescription["Entities"].toList();
+    entitiesQList << entityPropertiesToVariants(entityProperties, skipDefaultValues);
+
+    entityDescription["Entities"] = entitiesQList;
     return true;
 }
 
+bool EntityTree::writeToJSON(QIODevice& json, OctreeElementPointer element) {
+    // The same document writeToMap would make, written out a chunk of entities at a time. The tree is only locked
+    // to copy a chunk, the elements still to visit are the cursor the next chunk resumes from.
+    std::vector<OctreeElementPointer> elementsToVisit { element ? element : _rootElement };
+
+    // edits between chunks can move an entity to an element that is still to be visited, it goes in once all the same
+    // and the saves of a tree with a journal have the edits made during them in the journal's next batch
+    QSet<EntityItemID> writtenEntities;
+
+    QByteArray start = "{\n    \"Entities\": [";
+    bool success = json.write(start) == start.size();
+    bool isFirstEntity = true;
+
+    while (success && !elementsToVisit.empty()) {
+        QVector<EntityItemProperties> entityProperties;
+        withReadLock([&] {
+            while (!elementsToVisit.empty() && entityProperties.size() < ENTITY_JSON_CHUNK_SIZE) {
+                EntityTreeElementPointer entityTreeElement =
+                    std::static_pointer_cast<EntityTreeElement>(elementsToVisit.back());
+                elementsToVisit.pop_back();
+
+                entityTreeElement->forEachEntity([&](EntityItemPointer entityItem) {
+                    // we weren't able to resolve a parent from _parentID, so don't save this entity
+                    if (entityItem->isParentIDValid() && !writtenEntities.contains(entityItem->getEntityItemID())) {
+                        writtenEntities << entityItem->getEntityItemID();
+                        entityProperties << entityItem->getProperties();
+                    }
+                });
+
+                for (int i = NUMBER_OF_CHILDREN - 1; i >= 0; i--) {
+                    OctreeElementPointer child = entityTreeElement->getChildAtIndex(i);
+                    if (child) {
+                        elementsToVisit.push_back(child);
+                    }
+                }
+            }
+        });
+
+        QByteArray chunk;
+        for (const QVariant& entity : entityPropertiesToVariants(entityProperties, true)) {
+            chunk += isFirstEntity ? "\n        " : ",\n        ";
+            chunk += QJsonDocument(QJsonObject::fromVariantMap(entity.toMap())).toJson(QJsonDocument::Compact);
+            isFirstEntity = false;
+        }
+        success = json.write(chunk) == chunk.size();
+    }
+
+    // include the "bitstream" version
+    PacketVersion expectedVersion = versionForPacketType(expectedDataPacketType());
+    QByteArray end = QString("\n    ],\n    \"Version\": %1\n}\n").arg((int)expectedVersion).toUtf8();
+    return success && json.write(end) == end.size();
+}
+
 bool EntityTree::readFromMap(QVariantMap& map) {
     // map will have a top-level list keyed as "Entities".  This will be extracted
     // and iterated over.  Each member of this list is converted to a QVariantMap, then
     // to a QScriptValue, and then to EntityItemProperties.  These properties are used
     // to add the new entity to the EnitytTree.
-    QVariantList entitiesQList = map["Entities"].toList();
+    const QVariantList entitiesQList = map["Entities"].toList();
+
+    // the conversions are done in batches on the thread pool, only adding the entities has to be done here
+    using EntityBatch = QVector<QPair<EntityItemID, EntityItemProperties>>;
+    QVector<QFuture<EntityBatch>> batches;
+    for (int batchStart = 0; batchStart < entitiesQList.size(); batchStart += ENTITY_MAP_BATCH_SIZE) {
+        batches << QtConcurrent::run([&entitiesQList, batchStart] {
+            QScriptEngine scriptEngine;
+            EntityBatch batch;
+            int batchEnd = std::min(batchStart + ENTITY_MAP_BATCH_SIZE, entitiesQList.size());
+            for (int i = batchStart; i < batchEnd; i++) {
+                QVariantMap entityMap = entitiesQList.at(i).toMap();
+                EntityItemProperties properties;
+                EntityItemID entityItemID = entityPropertiesFromMap(entityMap, scriptEngine, properties);
+                batch << qMakePair(entityItemID, properties);
+            }
+            return batch;
+        });
+    }
+
+    for (QFuture<EntityBatch>& batch : batches) {
+        for (const auto& entity : batch.result()) {
+            if (!addEntity(entity.first, entity.second)) {
+                qCDebug(entities) << "adding Entity failed:" << entity.first << entity.second.getType();
+            }
+        }
+    }
+
+    return true;
+}
+
+EntityItemID EntityTree::entityPropertiesFromMap(QVariantMap& entityMap, QScriptEngine& scriptEngine,
+                                                 EntityItemProperties& properties) {
+    // QVariantMap --> QScriptValue --> EntityItemProperties
+    QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+    EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+
+    if (entityMap.contains("id")) {
+        return EntityItemID(QUuid(entityMap["id"].toString()));
+    }
+    return EntityItemID(QUuid::createUuid());
+}
+
+EntityItemPointer EntityTree::addEntityFromMap(QVariantMap& entityMap, QScriptEngine& scriptEngine) {
+    EntityItemProperties properties;
+    EntityItemID entityItemID = entityPropertiesFromMap(entityMap, scriptEngine, properties);
+
+    EntityItemPointer entity = addEntity(entityItemID, properties);
+    if (!entity) {
+        qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+    }
+    return entity;
+}
+
+// The journal is a series of batches, each a header (JOURNAL_BATCH_SIGNATURE, payload size) and then its records.
+// A record is an entity's properties as a map, the same as in the persist file, or the ID of a deleted entity.
+// A batch cut short by a crash while it was being appended is ignored along with anything after it.
+static const quint32 JOURNAL_BATCH_SIGNATURE = 0x4a524e4c; // "JRNL"
+static const QDataStream::Version JOURNAL_STREAM_VERSION = QDataStream::Qt_5_5;
+
+enum class JournalRecord : quint8 {
+    Entity,
+    Deleted
+};
+
+bool EntityTree::writeToJournal(QIODevice& journal) {
+    QSet<EntityItemID> deletedEntities;
+    QVector<EntityItemProperties> changedEntityProperties;
+
+    // like writeToMap, only copy what changed under the tree lock
+    withReadLock([&] {
+        QSet<EntityItemID> changedEntities;
+        {
+            QMutexLocker locker(&_journalLock);
+            changedEntities.swap(_journalChangedEntities);
+            deletedEntities.swap(_journalDeletedEntities);
+        }
+
+        foreach (const EntityItemID& entityID, changedEntities) {
+            EntityItemPointer entity = findEntityByEntityItemID(entityID);
+            if (entity && entity->isParentIDValid()) {
+                changedEntityProperties << entity->getProperties();
+            }
+        }
+    });
+
+    if (deletedEntities.isEmpty() && changedEntityProperties.isEmpty()) {
+        return true;
+    }
+
+    QByteArray records;
+    QDataStream recordStream(&records, QIODevice::WriteOnly);
+    recordStream.setVersion(JOURNAL_STREAM_VERSION);
+
+    // deletes go first, an entity deleted and then added again with the same ID ends up added
+    foreach (const EntityItemID& entityID, deletedEntities) {
+        recordStream << (quint8)JournalRecord::Deleted << (QUuid)entityID;
+    }
+
     QScriptEngine scriptEngine;
+    for (const EntityItemProperties& properties : changedEntityProperties) {
+        QScriptValue entityScriptValue = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, properties);
+        recordStream << (quint8)JournalRecord::Entity << entityScriptValue.toVariant();
+    }
 
-    foreach (QVariant entityVariant, entitiesQList) {
-        // QVariantMap --> QScriptValue --> EntityItemProperties --> Entity
-        QVariantMap entityMap = entityVariant.toMap();
-        QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
-        EntityItemProperties properties;
-        EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+    QByteArray batch;
+    QDataStream batchStream(&batch, QIODevice::WriteOnly);
+    batchStream << JOURNAL_BATCH_SIGNATURE << (quint32)records.size();
+    batch.append(records);
 
-        EntityItemID entityItemID;
-        if (entityMap.contains("id")) {
-            entityItemID = EntityItemID(QUuid(entityMap["id"].toString()));
-        } else {
-            entityItemID = EntityItemID(QUuid::createUuid());
+    // one write per batch, so a crash can only ever leave the last batch incomplete
+    return journal.write(batch) == batch.size();
+}
+
+bool EntityTree::readFromJournal(QIODevice& journal) {
+    QDataStream batchStream(&journal);
+    QScriptEngine scriptEngine;
+    int numBatches = 0;
+    int numRecords = 0;
+
+    while (!journal.atEnd()) {
+        quint32 signature = 0;
+        quint32 size = 0;
+        batchStream >> signature >> size;
+
+        if (batchStream.status() != QDataStream::Ok || signature != JOURNAL_BATCH_SIGNATURE) {
+            qCDebug(entities) << "Entity journal is corrupt after" << numBatches << "batches, ignoring the rest of it";
+            break;
         }
 
-        EntityItemPointer entity = addEntity(entityItemID, properties);
+        QByteArray records = journal.read(size);
+        if ((quint32)records.size() != size) {
+            qCDebug(entities) << "Entity journal ends in an incomplete batch, ignoring it";
+            break;
+        }
+
+        QDataStream recordStream(records);
+        recordStream.setVersion(JOURNAL_STREAM_VERSION);
+
+        while (!recordStream.atEnd() && recordStream.status() == QDataStream::Ok) {
+            quint8 recordType;
+            recordStream >> recordType;
+
+            if (recordType == (quint8)JournalRecord::Deleted) {
+                QUuid entityID;
+                recordStream >> entityID;
+                deleteEntity(entityID, true, true);
+            } else if (recordType == (quint8)JournalRecord::Entity) {
+                QVariant entityVariant;
+                recordStream >> entityVariant;
+
+                // the record is the whole entity, so replace whatever we have for it
+                QVariantMap entityMap = entityVariant.toMap();
+                deleteEntity(EntityItemID(QUuid(entityMap["id"].toString())), true, true);
+                addEntityFromMap(entityMap, scriptEngine);
+            } else {
+                qCDebug(entities) << "Entity journal has an unknown record type" << recordType;
+                break;
+            }
+
+            numRecords++;
+        }
+
+        numBatches++;
+    }
+
+    qCDebug(entities) << "Replayed" << numRecords << "records in" << numBatches << "batches from the entity journal";
+
+    // what was just replayed is in the journal already
+    QMutexLocker locker(&_journalLock);
+    _journalChangedEntities.clear();
+    _journalDeletedEntities.clear();
+
+    return true;
+}
+
+// The snapshot is the entities encoded the way they are sent to clients, so loading one skips the JSON and script
+// value conversions and can be decoded on several threads. It is a header (SNAPSHOT_SIGNATURE, SNAPSHOT_VERSION,
+// the entity data packet version of the encodings, the number of chunks), a table with the offset, size and number
+// of records of every chunk, and then the chunks. A record is the size of an encoding followed by the encoding. An
+// entity too big for one packet is encoded in several records, the same as it is sent, always within one chunk.
+// Everything is little endian, like the encodings themselves.
+static const quint32 SNAPSHOT_SIGNATURE = 0x53454648; // "HFES"
+static const quint32 SNAPSHOT_VERSION = 1;
+static const qint64 SNAPSHOT_HEADER_BYTES = 4 * sizeof(quint32);
+static const qint64 SNAPSHOT_CHUNK_ENTRY_BYTES = sizeof(quint64) + 2 * sizeof(quint32);
+static const int SNAPSHOT_ENTITIES_PER_CHUNK = 256;
+
+struct SnapshotChunk {
+    const unsigned char* data;
+    quint32 size;
+    quint32 numRecords;
+};
+
+bool EntityTree::snapshotEntitiesOperation(OctreeElementPointer element, void* extraData) {
+    QVector<EntityItemPointer>* snapshotEntities = static_cast<QVector<EntityItemPointer>*>(extraData);
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+    entityTreeElement->forEachEntity([&](EntityItemPointer entityItem) {
+        // like the JSON, leave out entities whose parents are gone
+        if (entityItem->isParentIDValid()) {
+            snapshotEntities->append(entityItem);
+        }
+    });
+    return true;
+}
+
+static bool appendSnapshotRecords(const EntityItemPointer& entity, QDataStream& chunkStream, quint32& numRecords) {
+    OctreePacketData packetData;
+    EncodeBitstreamParams params;
+    EntityTreeElementExtraEncodeData extraEncodeData;
+
+    OctreeElement::AppendState appendState;
+    do {
+        packetData.reset();
+        appendState = entity->appendEntityData(&packetData, params, &extraEncodeData);
+        if (appendState == OctreeElement::NONE) {
+            // a property doesn't fit even on its own, clients never get this entity whole either
+            return false;
+        }
+
+        int size = packetData.getUncompressedSize();
+        chunkStream << (quint32)size;
+        chunkStream.writeRawData((const char*)packetData.getUncompressedData(), size);
+        numRecords++;
+    } while (appendState != OctreeElement::COMPLETED);
+
+    return true;
+}
+
+bool EntityTree::writeToSnapshot(QIODevice& snapshot, OctreeElementPointer element) {
+    QVector<QByteArray> chunks;
+    QVector<quint32> chunkRecords;
+    bool success = true;
+
+    // the encodings are short lived and mostly come out of the cache the send threads fill, so this is quick
+    withReadLock([&] {
+        QVector<EntityItemPointer> snapshotEntities;
+        recurseElementWithOperation(element, snapshotEntitiesOperation, &snapshotEntities);
+
+        for (int i = 0; i < snapshotEntities.size() && success; i += SNAPSHOT_ENTITIES_PER_CHUNK) {
+            QByteArray chunk;
+            QDataStream chunkStream(&chunk, QIODevice::WriteOnly);
+            chunkStream.setByteOrder(QDataStream::LittleEndian);
+            quint32 numRecords = 0;
+
+            int chunkEnd = std::min(i + SNAPSHOT_ENTITIES_PER_CHUNK, snapshotEntities.size());
+            for (int j = i; j < chunkEnd; j++) {
+                const EntityItemPointer& entity = snapshotEntities[j];
+                if (!appendSnapshotRecords(entity, chunkStream, numRecords)) {
+                    qCDebug(entities) << "Entity" << entity->getEntityItemID() << "is too big for a snapshot";
+                    success = false;
+                    break;
+                }
+            }
+
+            chunks << chunk;
+            chunkRecords << numRecords;
+        }
+    });
+
+    if (!success) {
+        return false;
+    }
+
+    QDataStream snapshotStream(&snapshot);
+    snapshotStream.setByteOrder(QDataStream::LittleEndian);
+
+    snapshotStream << SNAPSHOT_SIGNATURE << SNAPSHOT_VERSION
+        << (quint32)versionForPacketType(expectedDataPacketType()) << (quint32)chunks.size();
+
+    quint64 chunkOffset = SNAPSHOT_HEADER_BYTES + chunks.size() * SNAPSHOT_CHUNK_ENTRY_BYTES;
+    for (int i = 0; i < chunks.size(); i++) {
+        snapshotStream << chunkOffset << (quint32)chunks[i].size() << chunkRecords[i];
+        chunkOffset += chunks[i].size();
+    }
+
+    foreach (const QByteArray& chunk, chunks) {
+        snapshotStream.writeRawData(chunk.constData(), chunk.size());
+    }
+
+    return snapshotStream.status() == QDataStream::Ok;
+}
+
+static QVector<EntityItemPointer> decodeSnapshotChunk(const SnapshotChunk& chunk, PacketVersion bitstreamVersion) {
+    QVector<EntityItemPointer> decodedEntities;
+    QHash<QUuid, EntityItemPointer> entitiesByID; // for the records after the first of an entity split up
+
+    ReadBitstreamToTreeParams args;
+    args.bitstreamVersion = bitstreamVersion;
+
+    const unsigned char* dataAt = chunk.data;
+    const unsigned char* dataEnd = chunk.data + chunk.size;
+
+    for (quint32 i = 0; i < chunk.numRecords; i++) {
+        if (dataEnd - dataAt < (qint64)sizeof(quint32)) {
+            qCDebug(entities) << "Entity snapshot chunk ends early, ignoring the rest of it";
+            break;
+        }
+
+        quint32 recordSize = qFromLittleEndian<quint32>(dataAt);
+        dataAt += sizeof(quint32);
+        if ((qint64)recordSize > dataEnd - dataAt || recordSize < (quint32)NUM_BYTES_RFC4122_UUID) {
+            qCDebug(entities) << "Entity snapshot chunk is corrupt, ignoring the rest of it";
+            break;
+        }
+
+        QUuid entityID = QUuid::fromRfc4122(QByteArray::fromRawData((const char*)dataAt, NUM_BYTES_RFC4122_UUID));
+        EntityItemPointer entity = entitiesByID.value(entityID);
         if (!entity) {
-            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+            entity = EntityTypes::constructEntityItem(dataAt, recordSize, args);
+            if (entity) {
+                decodedEntities << entity;
+                entitiesByID[entityID] = entity;
+            } else {
+                qCDebug(entities) << "Entity snapshot has an entity of unknown type" << entityID;
+            }
+        }
+
+        if (entity) {
+            entity->readEntityDataFromBuffer(dataAt, recordSize, args);
+        }
+
+        dataAt += recordSize;
+    }
+
+    return decodedEntities;
+}
+
+bool EntityTree::readFromSnapshot(const unsigned char* data, qint64 size) {
+    if (size < SNAPSHOT_HEADER_BYTES) {
+        qCDebug(entities) << "Entity snapshot is too short";
+        return false;
+    }
+
+    quint32 signature = qFromLittleEndian<quint32>(data);
+    quint32 snapshotVersion = qFromLittleEndian<quint32>(data + sizeof(quint32));
+    quint32 bitstreamVersion = qFromLittleEndian<quint32>(data + 2 * sizeof(quint32));
+    quint32 numChunks = qFromLittleEndian<quint32>(data + 3 * sizeof(quint32));
+
+    if (signature != SNAPSHOT_SIGNATURE || snapshotVersion != SNAPSHOT_VERSION) {
+        qCDebug(entities) << "Not an entity snapshot, or one of an unknown version" << snapshotVersion;
+        return false;
+    }
+    if (bitstreamVersion > versionForPacketType(expectedDataPacketType()) || !canProcessVersion(bitstreamVersion)) {
+        qCDebug(entities) << "Entity snapshot has entities of a version this server can't read" << bitstreamVersion;
+        return false;
+    }
+    if (size < SNAPSHOT_HEADER_BYTES + numChunks * SNAPSHOT_CHUNK_ENTRY_BYTES) {
+        qCDebug(entities) << "Entity snapshot ends in its chunk table";
+        return false;
+    }
+
+    QVector<SnapshotChunk> chunks;
+    chunks.reserve(numChunks);
+    const unsigned char* chunkEntry = data + SNAPSHOT_HEADER_BYTES;
+    for (quint32 i = 0; i < numChunks; i++, chunkEntry += SNAPSHOT_CHUNK_ENTRY_BYTES) {
+        quint64 chunkOffset = qFromLittleEndian<quint64>(chunkEntry);
+        quint32 chunkSize = qFromLittleEndian<quint32>(chunkEntry + sizeof(quint64));
+        quint32 chunkRecords = qFromLittleEndian<quint32>(chunkEntry + sizeof(quint64) + sizeof(quint32));
+
+        if (chunkOffset > (quint64)size || chunkSize > (quint64)size - chunkOffset) {
+            qCDebug(entities) << "Entity snapshot is cut short, ignoring chunks" << i << "and on";
+            break;
+        }
+        chunks << SnapshotChunk { data + chunkOffset, chunkSize, chunkRecords };
+    }
+
+    // decoding the chunks touches nothing but the new entities, the tree is only changed once they are all done.
+    // Only on the server though, client entity types set up rendering state when they're constructed.
+    std::vector<QVector<EntityItemPointer>> decodedChunks(chunks.size());
+    if (getIsServer()) {
+        QVector<QFuture<void>> decoding;
+        for (int i = 0; i < chunks.size(); i++) {
+            SnapshotChunk chunk = chunks[i];
+            QVector<EntityItemPointer>* decodedEntities = &decodedChunks[i];
+            decoding << QtConcurrent::run([chunk, decodedEntities, bitstreamVersion] {
+                *decodedEntities = decodeSnapshotChunk(chunk, bitstreamVersion);
+            });
+        }
+        for (QFuture<void>& chunkDecoding : decoding) {
+            chunkDecoding.waitForFinished();
+        }
+    } else {
+        for (int i = 0; i < chunks.size(); i++) {
+            decodedChunks[i] = decodeSnapshotChunk(chunks[i], bitstreamVersion);
+        }
+    }
+
+    int numEntities = 0;
+    for (const QVector<EntityItemPointer>& decodedEntities : decodedChunks) {
+        for (const EntityItemPointer& entity : decodedEntities) {
+            if (getContainingElement(entity->getEntityItemID())) {
+                qCDebug(entities) << "Entity snapshot has entity" << entity->getEntityItemID() << "more than once";
+                continue;
+            }
+            insertEntity(entity);
+            numEntities++;
         }
     }
 
+    qCDebug(entities) << "Read" << numEntities << "entities in" << chunks.size() << "chunks from the entity snapshot";
     return true;
 }
 
@@ -12,6 +12,9 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <deque>
+
+#include <QMutex>
 #include <QSet>
 #include <QVector>
 
@@ -23,8 +26,10 @@ typedef std::shared_ptr<EntityTree> EntityTreePointer;
 
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
+#include "EntityElementIndex.h"
 
 class Model;
+class QScriptEngine;
 class EntitySimulation;
 
 class NewlyCreatedEntityHook {
@@ -81,6 +86,11 @@ public:
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode) override;
 
+    virtual OctreeEditBatchPointer createEditBatch() const override;
+    virtual int decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& senderNode, OctreeEditBatch& batch) override;
+    virtual void processEditBatch(OctreeEditBatch& batch) override;
+
     virtual bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
         OctreeElementPointer& node, float& distance, BoxFace& face, glm::vec3& surfaceNormal,
         const QVector<EntityItemID>& entityIdsToInclude = QVector<EntityItemID>(),
@@ -117,6 +127,15 @@ public:
     void deleteEntity(const EntityItemID& entityID, bool force = false, bool ignoreWarnings = false);
     void deleteEntities(QSet<EntityItemID> entityIDs, bool force = false, bool ignoreWarnings = false);
 
+    /// A client side replica that only keeps the content around a point sets the sphere here, new entities that come in
+    /// entirely outside of it aren't added. A radius of 0 keeps everything.
+    void setInterestSphere(const glm::vec3& center, float radius) { _interestCenter = center; _interestRadius = radius; }
+    bool isOutsideInterest(const EntityItemPointer& entity) const;
+
+    /// Removes the entities entirely outside of the interest sphere. Unlike deleted ones they aren't remembered, so the
+    /// server can send them again. Callers must lock the tree for writing.
+    void evictEntitiesOutsideInterest();
+
     /// \param position point of query in world-frame (meters)
     /// \param targetRadius radius of query (meters)
     EntityItemPointer findClosestEntity(glm::vec3 position, float targetRadius);
@@ -145,6 +164,20 @@ public:
     /// \remark Side effect: any initial contents in entities will be lost
     void findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities);
 
+    /// finds all entities that touch each of many spheres, in a single walk of the tree
+    /// \param centers the centers of the spheres in world-frame (meters)
+    /// \param radii the radii of the spheres in world-frame (meters), one for each center
+    /// \param foundEntities[out] for each sphere, the vector of EntityItemPointer that touch it
+    /// \remark Side effect: any initial contents in foundEntities will be lost
+    void findEntities(const QVector<glm::vec3>& centers, const QVector<float>& radii,
+                      QVector<QVector<EntityItemPointer>>& foundEntities);
+
+    /// finds all entities that touch each of many boxes, in a single walk of the tree
+    /// \param boxes the query boxes in world-frame (meters)
+    /// \param foundEntities[out] for each box, the vector of EntityItemPointer that touch it
+    /// \remark Side effect: any initial contents in foundEntities will be lost
+    void findEntities(const QVector<AABox>& boxes, QVector<QVector<EntityItemPointer>>& foundEntities);
+
     void addNewlyCreatedHook(NewlyCreatedEntityHook* hook);
     void removeNewlyCreatedHook(NewlyCreatedEntityHook* hook);
 
@@ -156,10 +189,8 @@ public:
     bool hasEntitiesDeletedSince(quint64 sinceTime);
     static quint64 getAdjustedConsiderSince(quint64 sinceTime);
 
-    QMultiMap<quint64, QUuid> getRecentlyDeletedEntityIDs() const { 
-        QReadLocker locker(&_recentlyDeletedEntitiesLock);
-        return _recentlyDeletedEntityItemIDs;
-    }
+    /// the IDs of the entities deleted after considerSince, oldest first
+    QVector<QUuid> getEntitiesDeletedSince(quint64 considerSince) const;
 
     void forgetEntitiesDeletedBefore(quint64 sinceTime);
 
@@ -197,12 +228,25 @@ public:
     bool wantTerseEditLogging() const { return _wantTerseEditLogging; }
     void setWantTerseEditLogging(bool value) { _wantTerseEditLogging = value; }
 
+    /// when the server runs physics itself it takes physical edits from anyone but never hands out ownership
+    bool getServerSimulatesPhysics() const { return _serverSimulatesPhysics; }
+    void setServerSimulatesPhysics(bool value) { _serverSimulatesPhysics = value; }
+
     void remapIDs();
 
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) override;
+    virtual bool writeToJSON(QIODevice& json, OctreeElementPointer element) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
 
+    virtual bool supportsJournal() const override { return true; }
+    virtual bool writeToJournal(QIODevice& journal) override;
+    virtual bool readFromJournal(QIODevice& journal) override;
+
+    virtual bool supportsSnapshot() const override { return true; }
+    virtual bool writeToSnapshot(QIODevice& snapshot, OctreeElementPointer element) override;
+    virtual bool readFromSnapshot(const unsigned char* data, qint64 size) override;
+
     float getContentsLargestDimension();
 
     virtual void resetEditStats() override {
@@ -253,7 +297,14 @@ signals:
 
 protected:
 
-    void processRemovedEntities(const DeleteEntityOperator& theOperator);
+    void processRemovedEntities(const DeleteEntityOperator& theOperator, bool rememberDeletes = true);
+    void processEntityEdit(PacketType packetType, const EntityItemID& entityItemID, EntityItemProperties& properties,
+                           const SharedNodePointer& senderNode);
+    static int decodeEraseMessageDetails(const QByteArray& buffer, QSet<EntityItemID>& entityItemIDs);
+    EntityItemPointer addEntityFromMap(QVariantMap& entityMap, QScriptEngine& scriptEngine);
+    static EntityItemID entityPropertiesFromMap(QVariantMap& entityMap, QScriptEngine& scriptEngine,
+                                                EntityItemProperties& properties);
+    void insertEntity(EntityItemPointer entity);
     bool updateEntityWithElement(EntityItemPointer entity, const EntityItemProperties& properties,
                                  EntityTreeElementPointer containingElement,
                                  const SharedNodePointer& senderNode = SharedNodePointer(nullptr));
@@ -261,15 +312,35 @@ protected:
     static bool findInSphereOperation(OctreeElementPointer element, void* extraData);
     static bool findInCubeOperation(OctreeElementPointer element, void* extraData);
     static bool findInBoxOperation(OctreeElementPointer element, void* extraData);
+    static bool findOutsideSphereOperation(OctreeElementPointer element, void* extraData);
     static bool sendEntitiesOperation(OctreeElementPointer element, void* extraData);
+    static bool snapshotEntitiesOperation(OctreeElementPointer element, void* extraData);
 
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
     QReadWriteLock _newlyCreatedHooksLock;
     QVector<NewlyCreatedEntityHook*> _newlyCreatedHooks;
 
+    struct DeletedEntity {
+        quint64 deletedAt;
+        QUuid entityID;
+    };
+
+    // Server side recent deletes, a log in the order of the deletes that is appended to at the back and forgotten from
+    // the front. What each viewer needs is found with a binary search for the time it was last sent deletes, so the
+    // cost of sending them is in the number of new ones, however long the log is.
     mutable QReadWriteLock _recentlyDeletedEntitiesLock; /// lock of server side recent deletes
-    QMultiMap<quint64, QUuid> _recentlyDeletedEntityItemIDs; /// server side recent deletes
+    std::deque<DeletedEntity> _recentlyDeletedEntityItemIDs; /// server side recent deletes
+
+    // what has changed since the last batch written to the journal, tracked on the server
+    QMutex _journalLock;
+    QSet<EntityItemID> _journalChangedEntities;
+    QSet<EntityItemID> _journalDeletedEntities;
+
+    void trackJournalChange(const EntityItemID& entityID) {
+        QMutexLocker locker(&_journalLock);
+        _journalChangedEntities << entityID;
+    }
 
     mutable QReadWriteLock _deletedEntitiesLock; /// lock of client side recent deletes
     QSet<QUuid> _deletedEntityItemIDs; /// client side recent deletes
@@ -286,12 +357,16 @@ protected:
 
     EntityItemFBXService* _fbxService;
 
-    QHash<EntityItemID, EntityTreeElementPointer> _entityToElementMap;
+    EntityElementIndex _entityToElementMap;
 
     EntitySimulation* _simulation;
 
+    glm::vec3 _interestCenter;
+    float _interestRadius { 0.0f };
+
     bool _wantEditLogging = false;
     bool _wantTerseEditLogging = false;
+    bool _serverSimulatesPhysics = false;
     void maybeNotifyNewCollisionSoundURL(const QString& oldCollisionSoundURL, const QString& newCollisionSoundURL);
 
 
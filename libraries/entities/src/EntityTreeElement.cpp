@@ -296,6 +296,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                         entityTreeElementExtraEncodeData->entities.contains(entity->getEntityItemID());
                 }
 
+                float distanceToViewer = 0.0f;
                 if (includeThisEntity && params.viewFrustum) {
 
                     // we want to use the maximum possible box for this, so that we don't have to worry about the nuance of
@@ -307,6 +308,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                     if (!success || params.viewFrustum->cubeInFrustum(entityCube) == ViewFrustum::OUTSIDE) {
                         includeThisEntity = false; // out of view, don't include it
                     }
+                    distanceToViewer = glm::distance(params.viewFrustum->getPosition(), entityCube.calcCenter());
 
                     // Now check the size of the entity, it's possible that a "too small to see" entity is included in a
                     // larger octree cell because of its position (for example if it crosses the boundary of a cell it
@@ -336,6 +338,14 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                     }
                 }
 
+                // The viewer may already have the latest of this entity, or get it later once it is due for its distance.
+                // Only asked the first time the element is encoded in a scene, after that the extra encode data remembers.
+                if (includeThisEntity && !hadElementExtraData &&
+                    !params.shouldSendData(entity->getID(), entity->getLastChangedOnServer(), distanceToViewer)) {
+                    includeThisEntity = false;
+                    entityTreeElementExtraEncodeData->entities.remove(entity->getEntityItemID());
+                }
+
                 if (includeThisEntity) {
                     #ifdef WANT_LOD_DEBUGGING
                     qDebug() << "including entity - \n"
@@ -535,24 +545,26 @@ bool EntityTreeElement::findRayIntersection(const glm::vec3& origin, const glm::
         return false; // we did not intersect
     }
 
+    // if the distance to the element cube is not less than the current best distance, then it's not possible
+    // for any details inside the cube, or inside any of our children, to be closer so we don't need to consider them.
+    if (!_cube.contains(origin) && distanceToElementCube >= distance) {
+        keepSearching = false;
+        return false;
+    }
+
     // by default, we only allow intersections with leaves with content
     if (!canRayIntersect()) {
         return false; // we don't intersect with non-leaves, and we keep searching
     }
 
-    // if the distance to the element cube is not less than the current best distance, then it's not possible
-    // for any details inside the cube to be closer so we don't need to consider them.
-    if (_cube.contains(origin) || distanceToElementCube < distance) {
-
-        if (findDetailedRayIntersection(origin, direction, keepSearching, element, distanceToElementDetails,
-            face, localSurfaceNormal, entityIdsToInclude, entityIdsToDiscard, intersectedObject, precisionPicking, distanceToElementCube)) {
+    if (findDetailedRayIntersection(origin, direction, keepSearching, element, distanceToElementDetails,
+        face, localSurfaceNormal, entityIdsToInclude, entityIdsToDiscard, intersectedObject, precisionPicking, distanceToElementCube)) {
 
-            if (distanceToElementDetails < distance) {
-                distance = distanceToElementDetails;
-                face = localFace;
-                surfaceNormal = localSurfaceNormal;
-                return true;
-            }
+        if (distanceToElementDetails < distance) {
+            distance = distanceToElementDetails;
+            face = localFace;
+            surfaceNormal = localSurfaceNormal;
+            return true;
         }
     }
     return false;
@@ -585,6 +597,12 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
             return;
         }
 
+        // the entity is inside its AABox, so if that is no closer than the best hit so far neither is the entity,
+        // and we can skip the matrix math and the detailed intersection
+        if (localDistance >= distance) {
+            return;
+        }
+
         // extents is the entity relative, scaled, centered extents of the entity
         glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
         glm::mat4 translation = glm::translate(entity->getPosition());
@@ -929,8 +947,10 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
                     if (entityItem) {
                         bytesForThisEntity = entityItem->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
 
-                        // don't add if we've recently deleted....
-                        if (!_myTree->isDeletedEntity(entityItem->getID())) {
+                        // don't add if it's outside of what this replica keeps, or if we've recently deleted....
+                        if (_myTree->isOutsideInterest(entityItem)) {
+                            // only read to get past it, the replica has no use for it
+                        } else if (!_myTree->isDeletedEntity(entityItem->getID())) {
                             addEntityItem(entityItem); // add this new entity to this elements entities
                             entityItemID = entityItem->getEntityItemID();
                             _myTree->setContainingElement(entityItemID, getThisPointer());
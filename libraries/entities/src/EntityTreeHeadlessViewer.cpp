@@ -39,6 +39,18 @@ void EntityTreeHeadlessViewer::update() {
     }
 }
 
+void EntityTreeHeadlessViewer::updateInterest(const glm::vec3& center, float radius, bool evict) {
+    if (_tree) {
+        EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+        tree->withWriteLock([&] {
+            tree->setInterestSphere(center, radius);
+            if (evict) {
+                tree->evictEntitiesOutsideInterest();
+            }
+        });
+    }
+}
+
 void EntityTreeHeadlessViewer::processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
     std::static_pointer_cast<EntityTree>(_tree)->processEraseMessage(message, sourceNode);
 }
@@ -43,6 +43,8 @@ public:
     virtual void init();
 
 protected:
+    virtual void updateInterest(const glm::vec3& center, float radius, bool evict) override;
+
     virtual OctreePointer createTree() {
         EntityTreePointer newTree = EntityTreePointer(new EntityTree(true));
         newTree->createRootElement();
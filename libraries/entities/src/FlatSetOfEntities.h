@@ -0,0 +1,82 @@
+//
+//  FlatSetOfEntities.h
+//  libraries/entities/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FlatSetOfEntities_h
+#define hifi_FlatSetOfEntities_h
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "EntityTypes.h"
+
+/// A set of entities kept as a vector sorted by address.
+/// The simulation walks its sets every tick, and a dense vector is much cheaper to walk than the hash nodes of a QSet.
+/// Lookups are binary searches, inserting and removing single entities moves the tail of the vector, which is cheap
+/// next to a tick for the thousands of entities a simulation has. Use removeIf() to take out many in one pass.
+class FlatSetOfEntities {
+public:
+    using iterator = std::vector<EntityItemPointer>::iterator;
+    using const_iterator = std::vector<EntityItemPointer>::const_iterator;
+
+    /// returns false if the entity was already in the set
+    bool insert(const EntityItemPointer& entity) {
+        auto itr = lowerBound(entity);
+        if (itr != _entities.end() && itr->get() == entity.get()) {
+            return false;
+        }
+        _entities.insert(itr, entity);
+        return true;
+    }
+
+    /// returns false if the entity wasn't in the set
+    bool remove(const EntityItemPointer& entity) {
+        auto itr = lowerBound(entity);
+        if (itr == _entities.end() || itr->get() != entity.get()) {
+            return false;
+        }
+        _entities.erase(itr);
+        return true;
+    }
+
+    bool contains(const EntityItemPointer& entity) const {
+        auto itr = std::lower_bound(_entities.begin(), _entities.end(), entity, lessThan);
+        return itr != _entities.end() && itr->get() == entity.get();
+    }
+
+    iterator erase(iterator itr) { return _entities.erase(itr); }
+
+    /// removes every entity the predicate is true for, keeping the rest in order
+    template <typename Predicate>
+    void removeIf(Predicate predicate) {
+        _entities.erase(std::remove_if(_entities.begin(), _entities.end(), predicate), _entities.end());
+    }
+
+    void clear() { _entities.clear(); }
+    int size() const { return (int)_entities.size(); }
+    bool isEmpty() const { return _entities.empty(); }
+
+    iterator begin() { return _entities.begin(); }
+    iterator end() { return _entities.end(); }
+    const_iterator begin() const { return _entities.begin(); }
+    const_iterator end() const { return _entities.end(); }
+
+private:
+    static bool lessThan(const EntityItemPointer& a, const EntityItemPointer& b) {
+        return std::less<EntityItem*>()(a.get(), b.get());
+    }
+    iterator lowerBound(const EntityItemPointer& entity) {
+        return std::lower_bound(_entities.begin(), _entities.end(), entity, lessThan);
+    }
+
+    std::vector<EntityItemPointer> _entities;
+};
+
+#endif // hifi_FlatSetOfEntities_h
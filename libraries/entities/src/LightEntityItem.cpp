@@ -57,11 +57,11 @@ void LightEntityItem::setDimensions(const glm::vec3& value) {
 EntityItemProperties LightEntityItem::getProperties(EntityPropertyFlags desiredProperties) const {
     EntityItemProperties properties = EntityItem::getProperties(desiredProperties); // get the properties from our base class
 
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(isSpotlight, getIsSpotlight);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(color, getXColor);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(intensity, getIntensity);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(exponent, getExponent);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(cutoff, getCutoff);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_IS_SPOTLIGHT, isSpotlight, getIsSpotlight);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COLOR, color, getXColor);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_INTENSITY, intensity, getIntensity);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_EXPONENT, exponent, getExponent);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_CUTOFF, cutoff, getCutoff);
 
     return properties;
 }
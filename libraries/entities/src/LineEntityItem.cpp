@@ -49,9 +49,9 @@ EntityItemProperties LineEntityItem::getProperties(EntityPropertyFlags desiredPr
     properties._colorChanged = false;
     
     
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(lineWidth, getLineWidth);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LINE_WIDTH, lineWidth, getLineWidth);
     
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(linePoints, getLinePoints);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LINE_POINTS, linePoints, getLinePoints);
 
 
     properties._glowLevel = getGlowLevel();
@@ -44,16 +44,16 @@ ModelEntityItem::ModelEntityItem(const EntityItemID& entityItemID) : EntityItem(
 
 EntityItemProperties ModelEntityItem::getProperties(EntityPropertyFlags desiredProperties) const {
     EntityItemProperties properties = EntityItem::getProperties(desiredProperties); // get the properties from our base class
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(color, getXColor);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(modelURL, getModelURL);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(compoundShapeURL, getCompoundShapeURL);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(glowLevel, getGlowLevel);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(textures, getTextures);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(shapeType, getShapeType);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(jointRotationsSet, getJointRotationsSet);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(jointRotations, getJointRotations);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(jointTranslationsSet, getJointTranslationsSet);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(jointTranslations, getJointTranslations);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COLOR, color, getXColor);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_MODEL_URL, modelURL, getModelURL);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COMPOUND_SHAPE_URL, compoundShapeURL, getCompoundShapeURL);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES_ALWAYS(glowLevel, getGlowLevel);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_TEXTURES, textures, getTextures);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_SHAPE_TYPE, shapeType, getShapeType);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_JOINT_ROTATIONS_SET, jointRotationsSet, getJointRotationsSet);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_JOINT_ROTATIONS, jointRotations, getJointRotations);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_JOINT_TRANSLATIONS_SET, jointTranslationsSet, getJointTranslationsSet);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_JOINT_TRANSLATIONS, jointTranslations, getJointTranslations);
 
     _animationProperties.getProperties(properties);
     return properties;
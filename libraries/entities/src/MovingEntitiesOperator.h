@@ -32,25 +32,35 @@ inline bool operator==(const EntityToMoveDetails& a, const EntityToMoveDetails&
     return a.entity->getEntityItemID() == b.entity->getEntityItemID();
 }
 
-class MovingEntitiesOperator : public RecurseOctreeOperator {
+/// Moves entities to the elements that best fit their new cubes.
+/// Each entity goes straight down the tree to its old element and to its new one, so the cost of a move only depends
+/// on the depth of the tree, not on how many other entities are moving at the same time.
+/// Changing the tree needs the tree's write lock, the caller takes it.
+class MovingEntitiesOperator {
 public:
     MovingEntitiesOperator(EntityTreePointer tree);
     ~MovingEntitiesOperator();
 
     void addEntityToMoveList(EntityItemPointer entity, const AACube& newCube);
-    virtual bool preRecursion(OctreeElementPointer element);
-    virtual bool postRecursion(OctreeElementPointer element);
-    virtual OctreeElementPointer possiblyCreateChildAt(OctreeElementPointer element, int childIndex);
     bool hasMovingEntities() const { return _entitiesToMove.size() > 0; }
+
+    /// moves all of the entities on the list, marks the elements on their old and new paths as changed and prunes
+    /// the leaves they leave empty
+    void moveEntities();
+
 private:
+    // the elements from the root down to the old containing element, ending early if that element is already gone
+    void findPathToElement(const EntityToMoveDetails& details, QVector<EntityTreeElementPointer>& path);
+    // the element that best fits the new cube, creating the elements needed to reach it
+    EntityTreeElementPointer findOrCreateBestFitElement(const EntityToMoveDetails& details);
+
     EntityTreePointer _tree;
     QSet<EntityToMoveDetails> _entitiesToMove;
     quint64 _changeTime;
     int _foundOldCount;
     int _foundNewCount;
     int _lookingCount;
-    bool shouldRecurseSubTree(OctreeElementPointer element);
-    
+
     bool _wantDebug;
 };
 
@@ -301,37 +301,37 @@ void ParticleEffectEntityItem::computeAndUpdateDimensions() {
 EntityItemProperties ParticleEffectEntityItem::getProperties(EntityPropertyFlags desiredProperties) const {
     EntityItemProperties properties = EntityItem::getProperties(desiredProperties); // get the properties from our base class
 
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(color, getXColor);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(alpha, getAlpha);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(glowLevel, getGlowLevel);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(shapeType, getShapeType); // FIXME - this doesn't appear to get used
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(maxParticles, getMaxParticles);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(lifespan, getLifespan);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(isEmitting, getIsEmitting);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(emitRate, getEmitRate);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(emitSpeed, getEmitSpeed);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(speedSpread, getSpeedSpread);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(emitOrientation, getEmitOrientation);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(emitDimensions, getEmitDimensions);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(emitRadiusStart, getEmitRadiusStart);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(polarStart, getPolarStart);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(polarFinish, getPolarFinish);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(azimuthStart, getAzimuthStart);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(azimuthFinish, getAzimuthFinish);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(emitAcceleration, getEmitAcceleration);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(accelerationSpread, getAccelerationSpread);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(particleRadius, getParticleRadius);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(radiusSpread, getRadiusSpread);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(radiusStart, getRadiusStart);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(radiusFinish, getRadiusFinish);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(colorSpread, getColorSpread);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(colorStart, getColorStart);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(colorFinish, getColorFinish);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(alphaSpread, getAlphaSpread);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(alphaStart, getAlphaStart);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(alphaFinish, getAlphaFinish);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(textures, getTextures);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(emitterShouldTrail, getEmitterShouldTrail);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COLOR, color, getXColor);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ALPHA, alpha, getAlpha);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES_ALWAYS(glowLevel, getGlowLevel);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_SHAPE_TYPE, shapeType, getShapeType); // FIXME - this doesn't appear to get used
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_MAX_PARTICLES, maxParticles, getMaxParticles);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LIFESPAN, lifespan, getLifespan);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_EMITTING_PARTICLES, isEmitting, getIsEmitting);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_EMIT_RATE, emitRate, getEmitRate);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_EMIT_SPEED, emitSpeed, getEmitSpeed);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_SPEED_SPREAD, speedSpread, getSpeedSpread);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_EMIT_ORIENTATION, emitOrientation, getEmitOrientation);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_EMIT_DIMENSIONS, emitDimensions, getEmitDimensions);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_EMIT_RADIUS_START, emitRadiusStart, getEmitRadiusStart);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_POLAR_START, polarStart, getPolarStart);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_POLAR_FINISH, polarFinish, getPolarFinish);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_AZIMUTH_START, azimuthStart, getAzimuthStart);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_AZIMUTH_FINISH, azimuthFinish, getAzimuthFinish);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_EMIT_ACCELERATION, emitAcceleration, getEmitAcceleration);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ACCELERATION_SPREAD, accelerationSpread, getAccelerationSpread);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_PARTICLE_RADIUS, particleRadius, getParticleRadius);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_RADIUS_SPREAD, radiusSpread, getRadiusSpread);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_RADIUS_START, radiusStart, getRadiusStart);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_RADIUS_FINISH, radiusFinish, getRadiusFinish);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COLOR_SPREAD, colorSpread, getColorSpread);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COLOR_START, colorStart, getColorStart);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COLOR_FINISH, colorFinish, getColorFinish);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ALPHA_SPREAD, alphaSpread, getAlphaSpread);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ALPHA_START, alphaStart, getAlphaStart);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_ALPHA_FINISH, alphaFinish, getAlphaFinish);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_TEXTURES, textures, getTextures);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_EMITTER_SHOULD_TRAIL, emitterShouldTrail, getEmitterShouldTrail);
 
 
     return properties;
@@ -586,29 +586,13 @@ void ParticleEffectEntityItem::updateShapeType(ShapeType type) {
     }
 }
 
-void ParticleEffectEntityItem::integrateParticle(Particle& particle, float deltaTime) {
-    glm::vec3 atSquared = (0.5f * deltaTime * deltaTime) * particle.acceleration;
-    glm::vec3 at = particle.acceleration * deltaTime;
-    particle.position += particle.velocity * deltaTime + atSquared;
-    particle.velocity += at;
-}
-
 void ParticleEffectEntityItem::stepSimulation(float deltaTime) {
-    // update particles between head and tail
-    int popCount = 0;
-    for (Particle& particle : _particles) {
-        particle.lifetime += deltaTime;
-
-        // if particle has died.
-        if (particle.lifetime >= _lifespan) {
-            // move head forward
-            popCount++;
-        } else {
-            // Otherwise update it
-            integrateParticle(particle, deltaTime);
-        }
+    _simulationTime += deltaTime;
+
+    // the particles all live as long, so they die in the order they were born
+    while (!_particles.empty() && (_simulationTime - _particles.front().birthTime) >= _lifespan) {
+        _particles.pop_front();
     }
-    _particles.erase(_particles.begin(), _particles.begin() + popCount);
 
     // emit new particles, but only if we are emmitting
     if (getIsEmitting() && _emitRate > 0.0f && _lifespan > 0.0f && _polarStart <= _polarFinish) {
@@ -622,13 +606,10 @@ void ParticleEffectEntityItem::stepSimulation(float deltaTime) {
                 _particles.pop_front();
             }
             
-            // emit a new particle at tail index.
+            // emit a new particle at tail index, born at its time in the frame
             _particles.push_back(createParticle());
-            auto particle = _particles.back();
-            particle.lifetime += timeLeftInFrame;
-            
-            // Initialize it
-            integrateParticle(particle, deltaTime);
+            _particles.back().birthTime = _simulationTime - (timeLeftInFrame - _timeUntilNextEmit);
+            _numEmittedParticles++;
             
             // Advance in frame
             timeLeftInFrame -= _timeUntilNextEmit;
@@ -229,18 +229,23 @@ protected:
     
     Particle createParticle();
     void stepSimulation(float deltaTime);
-    void integrateParticle(Particle& particle, float deltaTime);
     
+    // A particle moves with a constant acceleration from where it was emitted, so it is kept as it was at its birth
+    // and the renderer evaluates where it is now
     struct Particle {
         float seed { 0.0f };
-        float lifetime { 0.0f };
+        double birthTime { 0.0 };
         glm::vec3 position { Vectors::ZERO };
         glm::vec3 velocity { Vectors::ZERO };
         glm::vec3 acceleration { Vectors::ZERO };
     };
     
-    // Particles container
+    // Particles container, from the oldest to the newest
     Particles _particles;
+    // the time the particles have been simulated for, and the count of the particles emitted since the start,
+    // the newest particle being the last of them
+    double _simulationTime { 0.0 };
+    quint64 _numEmittedParticles { 0 };
     
     // Particles properties
     rgbColor _color;
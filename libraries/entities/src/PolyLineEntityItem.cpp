@@ -53,11 +53,11 @@ EntityItemProperties PolyLineEntityItem::getProperties(EntityPropertyFlags desir
     properties._color = getXColor();
     properties._colorChanged = false;
 
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(lineWidth, getLineWidth);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(linePoints, getLinePoints);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(normals, getNormals);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(strokeWidths, getStrokeWidths);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(textures, getTextures);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LINE_WIDTH, lineWidth, getLineWidth);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LINE_POINTS, linePoints, getLinePoints);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_NORMALS, normals, getNormals);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_STROKE_WIDTHS, strokeWidths, getStrokeWidths);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_TEXTURES, textures, getTextures);
 
     properties._glowLevel = getGlowLevel();
     properties._glowLevelChanged = false;
@@ -9,19 +9,21 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QtCore/QVector>
+
+#include "EntityItemProperties.h"
 #include "EntityTree.h"
 
+/// copies the properties of the entities in the tree, so they can be converted to a map without holding the tree lock
 class RecurseOctreeToMapOperator : public RecurseOctreeOperator {
 public:
-    RecurseOctreeToMapOperator(QVariantMap& map, OctreeElementPointer top, QScriptEngine* engine, bool skipDefaultValues,
+    RecurseOctreeToMapOperator(QVector<EntityItemProperties>& entityProperties, OctreeElementPointer top,
                                bool skipThoseWithBadParents);
     bool preRecursion(OctreeElementPointer element);
     bool postRecursion(OctreeElementPointer element);
  private:
-    QVariantMap& _map;
+    QVector<EntityItemProperties>& _entityProperties;
     OctreeElementPointer _top;
-    QScriptEngine* _engine;
     bool _withinTop;
-    bool _skipDefaultValues;
     bool _skipThoseWithBadParents;
 };
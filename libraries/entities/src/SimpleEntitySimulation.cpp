@@ -37,6 +37,7 @@ void SimpleEntitySimulation::updateEntitiesInternal(const quint64& now) {
                 itemItr = _entitiesWithSimulator.erase(itemItr);
                 // zero the velocity on this entity so that it doesn't drift far away
                 entity->setVelocity(glm::vec3(0.0f));
+                entity->invalidateEncodingCache();
             } else {
                 ++itemItr;
             }
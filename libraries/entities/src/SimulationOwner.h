@@ -33,6 +33,10 @@ const quint8 SCRIPT_EDIT_SIMULATION_PRIORITY = 0x80;
 // objects that collide its MyAvatar.
 const quint8 PERSONAL_SIMULATION_PRIORITY = SCRIPT_EDIT_SIMULATION_PRIORITY - 1;
 
+// An entity-server that runs physics itself holds the entities it simulates at AUTHORITATIVE priority,
+// which no observer bid can beat.
+const quint8 AUTHORITATIVE_SIMULATION_PRIORITY = 0xff;
+
 
 class SimulationOwner {
 public:
@@ -49,11 +49,11 @@ void TextEntityItem::setDimensions(const glm::vec3& value) {
 EntityItemProperties TextEntityItem::getProperties(EntityPropertyFlags desiredProperties) const {
     EntityItemProperties properties = EntityItem::getProperties(desiredProperties); // get the properties from our base class
 
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(text, getText);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(lineHeight, getLineHeight);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(textColor, getTextColorX);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(backgroundColor, getBackgroundColorX);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(faceCamera, getFaceCamera);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_TEXT, text, getText);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_LINE_HEIGHT, lineHeight, getLineHeight);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_TEXT_COLOR, textColor, getTextColorX);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_BACKGROUND_COLOR, backgroundColor, getBackgroundColorX);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_FACE_CAMERA, faceCamera, getFaceCamera);
     return properties;
 }
 
@@ -41,7 +41,7 @@ void WebEntityItem::setDimensions(const glm::vec3& value) {
 
 EntityItemProperties WebEntityItem::getProperties(EntityPropertyFlags desiredProperties) const {
     EntityItemProperties properties = EntityItem::getProperties(desiredProperties); // get the properties from our base class
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(sourceUrl, getSourceUrl);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_SOURCE_URL, sourceUrl, getSourceUrl);
     return properties;
 }
 
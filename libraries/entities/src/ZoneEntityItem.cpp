@@ -49,9 +49,9 @@ EntityItemProperties ZoneEntityItem::getProperties(EntityPropertyFlags desiredPr
     
     _stageProperties.getProperties(properties);
 
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(shapeType, getShapeType);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(compoundShapeURL, getCompoundShapeURL);
-    COPY_ENTITY_PROPERTY_TO_PROPERTIES(backgroundMode, getBackgroundMode);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_SHAPE_TYPE, shapeType, getShapeType);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_COMPOUND_SHAPE_URL, compoundShapeURL, getCompoundShapeURL);
+    COPY_ENTITY_PROPERTY_TO_PROPERTIES(PROP_BACKGROUND_MODE, backgroundMode, getBackgroundMode);
 
     _skyboxProperties.getProperties(properties);
 
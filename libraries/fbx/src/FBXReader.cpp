@@ -10,6 +10,7 @@
 //
 
 #include <iostream>
+#include <numeric>
 #include <QBuffer>
 #include <QDataStream>
 #include <QIODevice>
@@ -224,6 +225,14 @@ public:
     FBXBlendshape blendshape;
 };
 
+class PendingMesh {
+public:
+    QString id;
+    const FBXNode* object;
+    unsigned int meshIndex;
+    ExtractedMesh extracted;
+};
+
 void printNode(const FBXNode& node, int indentLevel) {
     int indentLength = 2;
     QByteArray spaces(indentLevel * indentLength, ' ');
@@ -293,6 +302,29 @@ void setTangents(FBXMesh& mesh, int firstIndex, int secondIndex) {
         glm::normalize(bitangent), normalizedNormal);
 }
 
+// a normal map needs tangents, which take the texture coordinates
+static void computeTangents(FBXMesh& mesh) {
+    mesh.tangents.resize(mesh.vertices.size());
+    foreach (const FBXMeshPart& part, mesh.parts) {
+        for (int i = 0; i < part.quadIndices.size(); i += 4) {
+            setTangents(mesh, part.quadIndices.at(i), part.quadIndices.at(i + 1));
+            setTangents(mesh, part.quadIndices.at(i + 1), part.quadIndices.at(i + 2));
+            setTangents(mesh, part.quadIndices.at(i + 2), part.quadIndices.at(i + 3));
+            setTangents(mesh, part.quadIndices.at(i + 3), part.quadIndices.at(i));
+        }
+        // <= size - 3 in order to prevent overflowing triangleIndices when (i % 3) != 0
+        // This is most likely evidence of a further problem in extractMesh()
+        for (int i = 0; i <= part.triangleIndices.size() - 3; i += 3) {
+            setTangents(mesh, part.triangleIndices.at(i), part.triangleIndices.at(i + 1));
+            setTangents(mesh, part.triangleIndices.at(i + 1), part.triangleIndices.at(i + 2));
+            setTangents(mesh, part.triangleIndices.at(i + 2), part.triangleIndices.at(i));
+        }
+        if ((part.triangleIndices.size() % 3) != 0){
+            qCDebug(modelformat) << "Error in extractFBXGeometry part.triangleIndices.size() is not divisible by three ";
+        }
+    }
+}
+
 QVector<int> getIndices(const QVector<QString> ids, QVector<QString> modelIDs) {
     QVector<int> indices;
     foreach (const QString& id, ids) {
@@ -445,6 +477,7 @@ QByteArray fileOnUrl(const QByteArray& filenameString, const QString& url) {
 FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QString& url) {
     const FBXNode& node = _fbxNode;
     QMap<QString, ExtractedMesh> meshes;
+    QVector<PendingMesh> pendingMeshes;
     QHash<QString, QString> modelIDsToNames;
     QHash<QString, int> meshIDsToMeshIndices;
     QHash<QString, QString> ooChildToParent;
@@ -570,7 +603,8 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
             foreach (const FBXNode& object, child.children) {
                 if (object.name == "Geometry") {
                     if (object.properties.at(2) == "Mesh") {
-                        meshes.insert(getID(object.properties), extractMesh(object, meshIndex));
+                        // extracted all together once the objects are read
+                        pendingMeshes.append({ getID(object.properties), &object, meshIndex++ });
                     } else { // object.properties.at(2) == "Shape"
                         ExtractedBlendshape extracted = { getID(object.properties), extractBlendshape(object) };
                         blendshapes.append(extracted);
@@ -1102,6 +1136,16 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
         }
     }
 
+    // the meshes don't depend on each other, or on anything else than their own node
+    QtConcurrent::blockingMap(pendingMeshes, [this](PendingMesh& pending) {
+        unsigned int meshIndex = pending.meshIndex;
+        pending.extracted = extractMesh(*pending.object, meshIndex);
+    });
+    for (auto& pending : pendingMeshes) {
+        meshes.insert(pending.id, pending.extracted);
+    }
+    pendingMeshes.clear();
+
     // assign the blendshapes to their corresponding meshes
     foreach (const ExtractedBlendshape& extracted, blendshapes) {
         QString blendshapeChannelID = _connectionParentMap.value(extracted.id);
@@ -1286,6 +1330,7 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
     // see if any materials have texture children
     bool materialsHaveTextures = checkMaterialsHaveTextures(_fbxMaterials, _textureFilenames, _connectionChildMap);
 
+    QVector<bool> meshesNeedTangents;
     for (QMap<QString, ExtractedMesh>::iterator it = meshes.begin(); it != meshes.end(); it++) {
         ExtractedMesh& extracted = it.value();
 
@@ -1343,29 +1388,6 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
             }
         }
 
-        // if we have a normal map (and texture coordinates), we must compute tangents
-        if (generateTangents && !extracted.mesh.texCoords.isEmpty()) {
-            extracted.mesh.tangents.resize(extracted.mesh.vertices.size());
-            foreach (const FBXMeshPart& part, extracted.mesh.parts) {
-                for (int i = 0; i < part.quadIndices.size(); i += 4) {
-                    setTangents(extracted.mesh, part.quadIndices.at(i), part.quadIndices.at(i + 1));
-                    setTangents(extracted.mesh, part.quadIndices.at(i + 1), part.quadIndices.at(i + 2));
-                    setTangents(extracted.mesh, part.quadIndices.at(i + 2), part.quadIndices.at(i + 3));
-                    setTangents(extracted.mesh, part.quadIndices.at(i + 3), part.quadIndices.at(i));
-                }
-                // <= size - 3 in order to prevent overflowing triangleIndices when (i % 3) != 0
-                // This is most likely evidence of a further problem in extractMesh()
-                for (int i = 0; i <= part.triangleIndices.size() - 3; i += 3) {
-                    setTangents(extracted.mesh, part.triangleIndices.at(i), part.triangleIndices.at(i + 1));
-                    setTangents(extracted.mesh, part.triangleIndices.at(i + 1), part.triangleIndices.at(i + 2));
-                    setTangents(extracted.mesh, part.triangleIndices.at(i + 2), part.triangleIndices.at(i));
-                }
-                if ((part.triangleIndices.size() % 3) != 0){
-                    qCDebug(modelformat) << "Error in extractFBXGeometry part.triangleIndices.size() is not divisible by three ";
-                }
-            }
-        }
-
         // find the clusters with which the mesh is associated
         QVector<QString> clusterIDs;
         foreach (const QString& childID, _connectionChildMap.values(it.key())) {
@@ -1513,8 +1535,6 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
         }
         extracted.mesh.isEye = (maxJointIndex == geometry.leftEyeJointIndex || maxJointIndex == geometry.rightEyeJointIndex);
 
-        buildModelMesh(extracted.mesh, url);
-
         if (extracted.mesh.isEye) {
             if (maxJointIndex == geometry.leftEyeJointIndex) {
                 geometry.leftEyeSize = extracted.mesh.meshExtents.largestDimension() * offsetScale;
@@ -1526,8 +1546,23 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
         geometry.meshes.append(extracted.mesh);
         int meshIndex = geometry.meshes.size() - 1;
         meshIDsToMeshIndices.insert(it.key(), meshIndex);
+
+        // if we have a normal map (and texture coordinates), we must compute tangents
+        meshesNeedTangents.append(generateTangents && !extracted.mesh.texCoords.isEmpty());
     }
 
+    // the tangents and buffers of a mesh only need the mesh
+    FBXMesh* geometryMeshes = geometry.meshes.data();
+    QVector<int> geometryMeshIndices(geometry.meshes.size());
+    std::iota(geometryMeshIndices.begin(), geometryMeshIndices.end(), 0);
+    QtConcurrent::blockingMap(geometryMeshIndices, [&](int meshIndex) {
+        FBXMesh& mesh = geometryMeshes[meshIndex];
+        if (meshesNeedTangents.at(meshIndex)) {
+            computeTangents(mesh);
+        }
+        buildModelMesh(mesh, url);
+    });
+
     const float INV_SQRT_3 = 0.57735026918f;
     ShapeVertices cardinalDirections = {
         Vectors::UNIT_X,
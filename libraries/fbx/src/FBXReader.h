@@ -123,6 +123,8 @@ public:
     QVector<int> quadTrianglesIndices; // original indices from the FBX mesh of the quad converted as triangles
     QVector<int> triangleIndices; // original indices from the FBX mesh
 
+    QVector<QVector<int>> lodTriangleIndices; // triangles of the coarser levels of detail, from the same vertices
+
     QString materialID;
 };
 
@@ -186,6 +188,8 @@ public:
 
     unsigned int meshIndex; // the order the meshes appeared in the object file
 
+    QVector<float> lodErrors; // how far each level of detail of the parts is from the full mesh at most
+
     model::MeshPointer _mesh;
 };
 
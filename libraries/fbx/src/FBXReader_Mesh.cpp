@@ -24,7 +24,9 @@
 
 #include "FBXReader.h"
 
+#include <algorithm>
 #include <memory>
+#include <string.h>
 
 
 class Vertex {
@@ -34,13 +36,28 @@ public:
     glm::vec2 texCoord1;
 };
 
-uint qHash(const Vertex& vertex, uint seed = 0) {
-    return qHash(vertex.originalIndex, seed);
-}
+// orders the vertices by their bits, which keeps the order strict for any float
+class VertexKey {
+public:
+    VertexKey(const Vertex& vertex) : originalIndex(vertex.originalIndex) {
+        memcpy(texCoordBits, &vertex.texCoord, sizeof(vertex.texCoord));
+        memcpy(texCoordBits + 2, &vertex.texCoord1, sizeof(vertex.texCoord1));
+    }
 
-bool operator==(const Vertex& v1, const Vertex& v2) {
-    return v1.originalIndex == v2.originalIndex && v1.texCoord == v2.texCoord && v1.texCoord1 == v2.texCoord1;
-}
+    bool operator<(const VertexKey& other) const {
+        if (originalIndex != other.originalIndex) {
+            return originalIndex < other.originalIndex;
+        }
+        return memcmp(texCoordBits, other.texCoordBits, sizeof(texCoordBits)) < 0;
+    }
+    bool operator==(const VertexKey& other) const {
+        return originalIndex == other.originalIndex && memcmp(texCoordBits, other.texCoordBits, sizeof(texCoordBits)) == 0;
+    }
+
+private:
+    int originalIndex;
+    quint32 texCoordBits[4];
+};
 
 class AttributeData {
 public:
@@ -67,57 +84,33 @@ public:
     QVector<glm::vec2> texCoords;
     QVector<int> texCoordIndices;
 
-    QHash<Vertex, int> indices;
-
     std::vector<AttributeData> attributes;
+
+    // how many times each polygon corner is used by the quads and triangles
+    std::vector<int> cornerUses;
 };
 
 
+// the quads and triangles are made of polygon corners first, the corners become vertices once they're all known
 void appendIndex(MeshData& data, QVector<int>& indices, int index) {
     if (index >= data.polygonIndices.size()) {
         return;
     }
+    indices.append(index);
+    data.cornerUses[index]++;
+}
+
+int getCornerVertexIndex(const MeshData& data, int index) {
     int vertexIndex = data.polygonIndices.at(index);
     if (vertexIndex < 0) {
         vertexIndex = -vertexIndex - 1;
     }
-    Vertex vertex;
-    vertex.originalIndex = vertexIndex;
-    
-    glm::vec3 position;
-    if (vertexIndex < data.vertices.size()) {
-        position = data.vertices.at(vertexIndex);
-    }
-
-    glm::vec3 normal;
-    int normalIndex = data.normalsByVertex ? vertexIndex : index;
-    if (data.normalIndices.isEmpty()) {    
-        if (normalIndex < data.normals.size()) {
-            normal = data.normals.at(normalIndex);
-        }
-    } else if (normalIndex < data.normalIndices.size()) {
-        normalIndex = data.normalIndices.at(normalIndex);
-        if (normalIndex >= 0 && normalIndex < data.normals.size()) {
-            normal = data.normals.at(normalIndex);
-        }
-    }
-
+    return vertexIndex;
+}
 
-    glm::vec4 color;
-    bool hasColors = (data.colors.size() > 1);
-    if (hasColors) {
-        int colorIndex = data.colorsByVertex ? vertexIndex : index;
-        if (data.colorIndices.isEmpty()) {    
-            if (colorIndex < data.colors.size()) {
-                color = data.colors.at(colorIndex);
-            }
-        } else if (colorIndex < data.colorIndices.size()) {
-            colorIndex = data.colorIndices.at(colorIndex);
-            if (colorIndex >= 0 && colorIndex < data.colors.size()) {
-                color = data.colors.at(colorIndex);
-            }
-        }
-    }
+Vertex getCornerVertex(const MeshData& data, int index) {
+    Vertex vertex;
+    vertex.originalIndex = getCornerVertexIndex(data, index);
 
     if (data.texCoordIndices.isEmpty()) {
         if (index < data.texCoords.size()) {
@@ -129,7 +122,7 @@ void appendIndex(MeshData& data, QVector<int>& indices, int index) {
             vertex.texCoord = data.texCoords.at(texCoordIndex);
         }
     }
-    
+
     bool hasMoreTexcoords = (data.attributes.size() > 1);
     if (hasMoreTexcoords) {
         if (data.attributes[1].texCoordIndices.empty()) {
@@ -143,25 +136,108 @@ void appendIndex(MeshData& data, QVector<int>& indices, int index) {
             }
         }
     }
+    return vertex;
+}
+
+glm::vec3 getCornerNormal(const MeshData& data, int index) {
+    glm::vec3 normal;
+    int normalIndex = data.normalsByVertex ? getCornerVertexIndex(data, index) : index;
+    if (data.normalIndices.isEmpty()) {
+        if (normalIndex < data.normals.size()) {
+            normal = data.normals.at(normalIndex);
+        }
+    } else if (normalIndex < data.normalIndices.size()) {
+        normalIndex = data.normalIndices.at(normalIndex);
+        if (normalIndex >= 0 && normalIndex < data.normals.size()) {
+            normal = data.normals.at(normalIndex);
+        }
+    }
+    return normal;
+}
+
+glm::vec4 getCornerColor(const MeshData& data, int index) {
+    glm::vec4 color;
+    int colorIndex = data.colorsByVertex ? getCornerVertexIndex(data, index) : index;
+    if (data.colorIndices.isEmpty()) {
+        if (colorIndex < data.colors.size()) {
+            color = data.colors.at(colorIndex);
+        }
+    } else if (colorIndex < data.colorIndices.size()) {
+        colorIndex = data.colorIndices.at(colorIndex);
+        if (colorIndex >= 0 && colorIndex < data.colors.size()) {
+            color = data.colors.at(colorIndex);
+        }
+    }
+    return color;
+}
 
-    QHash<Vertex, int>::const_iterator it = data.indices.find(vertex);
-    if (it == data.indices.constEnd()) {
+// Corners with the same original vertex and texture coordinates share a vertex. Sorting the corners puts those
+// next to each other, and the vertices come out in the order of their first corner, as the polygons have them.
+void extractVertices(MeshData& data) {
+    std::vector<int> corners;
+    std::vector<VertexKey> keys;
+    std::vector<Vertex> vertices;
+    int numCorners = (int)data.cornerUses.size();
+    keys.reserve(numCorners);
+    vertices.reserve(numCorners);
+    for (int index = 0; index < numCorners; index++) {
+        vertices.push_back(getCornerVertex(data, index));
+        keys.push_back(VertexKey(vertices.back()));
+        if (data.cornerUses[index] > 0) {
+            corners.push_back(index);
+        }
+    }
+    std::stable_sort(corners.begin(), corners.end(), [&keys](int first, int second) {
+        return keys[first] < keys[second];
+    });
+
+    // each corner points to the first one with the same vertex
+    std::vector<int> firstCorners(numCorners, -1);
+    for (size_t i = 0; i < corners.size(); i++) {
+        int corner = corners[i];
+        bool isFirst = (i == 0 || !(keys[corners[i - 1]] == keys[corner]));
+        firstCorners[corner] = isFirst ? corner : firstCorners[corners[i - 1]];
+    }
+
+    bool hasColors = (data.colors.size() > 1);
+    bool hasMoreTexcoords = (data.attributes.size() > 1);
+    std::vector<int> cornerVertices(numCorners, -1);
+    for (int index = 0; index < numCorners; index++) {
+        int firstCorner = firstCorners[index];
+        if (firstCorner == -1) {
+            continue;
+        }
+        // every use of a corner adds its normal to the vertex
+        glm::vec3 normal = getCornerNormal(data, index) * (float)data.cornerUses[index];
+        if (firstCorner != index) {
+            int newIndex = cornerVertices[firstCorner];
+            cornerVertices[index] = newIndex;
+            data.extracted.mesh.normals[newIndex] += normal;
+            continue;
+        }
+
+        const Vertex& vertex = vertices[index];
         int newIndex = data.extracted.mesh.vertices.size();
-        indices.append(newIndex);
-        data.indices.insert(vertex, newIndex);
-        data.extracted.newIndices.insert(vertexIndex, newIndex);
-        data.extracted.mesh.vertices.append(position);
+        cornerVertices[index] = newIndex;
+        data.extracted.newIndices.insert(vertex.originalIndex, newIndex);
+        data.extracted.mesh.vertices.append(vertex.originalIndex < data.vertices.size() ?
+            data.vertices.at(vertex.originalIndex) : glm::vec3());
         data.extracted.mesh.normals.append(normal);
         data.extracted.mesh.texCoords.append(vertex.texCoord);
         if (hasColors) {
-            data.extracted.mesh.colors.append(glm::vec3(color));
+            data.extracted.mesh.colors.append(glm::vec3(getCornerColor(data, index)));
         }
         if (hasMoreTexcoords) {
             data.extracted.mesh.texCoords1.append(vertex.texCoord1);
         }
-    } else {
-        indices.append(*it);
-        data.extracted.mesh.normals[*it] += normal;
+    }
+
+    for (auto& part : data.extracted.mesh.parts) {
+        for (auto indices : { &part.quadIndices, &part.quadTrianglesIndices, &part.triangleIndices }) {
+            for (auto& index : *indices) {
+                index = cornerVertices[index];
+            }
+        }
     }
 }
 
@@ -327,6 +403,7 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
     Q_UNUSED(isMultiMaterial);
 
     // convert the polygons to quads and triangles
+    data.cornerUses.resize(data.polygonIndices.size(), 0);
     int polygonIndex = 0;
     QHash<QPair<int, int>, int> materialTextureParts;
     for (int beginIndex = 0; beginIndex < data.polygonIndices.size(); polygonIndex++) {
@@ -382,7 +459,9 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
             beginIndex = endIndex;
         }
     }
-    
+
+    extractVertices(data);
+
     return data.extracted;
 }
 
@@ -488,6 +567,9 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
     unsigned int totalIndices = 0;
     foreach(const FBXMeshPart& part, extractedMesh.parts) {
         totalIndices += (part.quadTrianglesIndices.size() + part.triangleIndices.size());
+        foreach(const QVector<int>& lodIndices, part.lodTriangleIndices) {
+            totalIndices += lodIndices.size();
+        }
     }
 
     if (! totalIndices) {
@@ -529,6 +611,27 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
         parts.push_back(modelPart);
     }
 
+    // the levels of detail go after the full parts, a part with fewer levels draws its coarsest one in the others
+    std::vector<model::Mesh::Part> lodParts;
+    std::vector<float> lodErrors;
+    for (int lod = 1; lod <= extractedMesh.lodErrors.size(); lod++) {
+        for (int i = 0; i < extractedMesh.parts.size(); i++) {
+            const FBXMeshPart& part = extractedMesh.parts.at(i);
+            if (part.lodTriangleIndices.size() < lod) {
+                int partLOD = part.lodTriangleIndices.size();
+                lodParts.push_back(partLOD == 0 ? parts[i] : lodParts[(partLOD - 1) * parts.size() + i]);
+                continue;
+            }
+
+            const QVector<int>& lodIndices = part.lodTriangleIndices.at(lod - 1);
+            indexBuffer->setSubData(offset, lodIndices.size() * sizeof(int), (gpu::Byte*) lodIndices.constData());
+            offset += lodIndices.size() * sizeof(int);
+            lodParts.push_back(model::Mesh::Part(indexNum, lodIndices.size(), 0, model::Mesh::TRIANGLES));
+            indexNum += lodIndices.size();
+        }
+        lodErrors.push_back(extractedMesh.lodErrors.at(lod - 1));
+    }
+
     gpu::BufferView indexBufferView(indexBuffer, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::XYZ));
     mesh->setIndexBuffer(indexBufferView);
 
@@ -537,6 +640,7 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
         pb->setData(parts.size() * sizeof(model::Mesh::Part), (const gpu::Byte*) parts.data());
         gpu::BufferView pbv(pb, gpu::Element(gpu::VEC4, gpu::UINT32, gpu::XYZW));
         mesh->setPartBuffer(pbv);
+        mesh->setLODs(lodParts, lodErrors);
     } else {
         qCDebug(modelformat) << "buildModelMesh failed -- no parts, url = " << url;
         return;
@@ -0,0 +1,439 @@
+//
+//  GeometryContainer.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "GeometryContainer.h"
+
+#include <memory>
+#include <type_traits>
+
+#include <QtCore/QDataStream>
+
+#include "FBXReader.h"
+
+static const quint32 GEOMETRY_CONTAINER_MAGIC = 0x48464758; // "HFGX"
+static const quint32 GEOMETRY_CONTAINER_VERSION = 2;
+
+// plain values and arrays of plain values go in as their bytes
+
+template <typename T>
+static void write(QDataStream& stream, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values are written as bytes");
+    stream.writeRawData(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static void read(QDataStream& stream, T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values are read as bytes");
+    if (stream.readRawData(reinterpret_cast<char*>(&value), sizeof(T)) != sizeof(T)) {
+        stream.setStatus(QDataStream::ReadPastEnd);
+    }
+}
+
+template <typename T>
+static void writeArray(QDataStream& stream, const QVector<T>& array) {
+    stream << (quint32)array.size();
+    stream.writeRawData(reinterpret_cast<const char*>(array.constData()), array.size() * sizeof(T));
+}
+
+template <typename T>
+static void readArray(QDataStream& stream, QVector<T>& array) {
+    quint32 size = 0;
+    stream >> size;
+    if (stream.status() != QDataStream::Ok || size > stream.device()->bytesAvailable() / sizeof(T)) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+    array.resize(size);
+    stream.readRawData(reinterpret_cast<char*>(array.data()), size * sizeof(T));
+}
+
+// everything else goes in one member at a time
+
+template <typename T, typename Write>
+static void writeList(QDataStream& stream, const QVector<T>& list, Write writeItem) {
+    stream << (quint32)list.size();
+    for (const auto& item : list) {
+        writeItem(stream, item);
+    }
+}
+
+template <typename T, typename Read>
+static void readList(QDataStream& stream, QVector<T>& list, Read readItem) {
+    quint32 size = 0;
+    stream >> size;
+    if (stream.status() != QDataStream::Ok || size > stream.device()->bytesAvailable()) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+    list.resize(size);
+    for (auto& item : list) {
+        readItem(stream, item);
+    }
+}
+
+static void write(QDataStream& stream, const QString& value) {
+    stream << value;
+}
+
+static void read(QDataStream& stream, QString& value) {
+    stream >> value;
+}
+
+static void write(QDataStream& stream, const QByteArray& value) {
+    stream << value;
+}
+
+static void read(QDataStream& stream, QByteArray& value) {
+    stream >> value;
+}
+
+static void write(QDataStream& stream, const Transform& transform) {
+    write(stream, transform.getTranslation());
+    write(stream, transform.getRotation());
+    write(stream, transform.getScale());
+}
+
+static void read(QDataStream& stream, Transform& transform) {
+    Transform::Vec3 translation, scale;
+    Transform::Quat rotation;
+    read(stream, translation);
+    read(stream, rotation);
+    read(stream, scale);
+    transform.setTranslation(translation);
+    transform.setRotation(rotation);
+    transform.setScale(scale);
+}
+
+static void write(QDataStream& stream, const Extents& extents) {
+    write(stream, extents.minimum);
+    write(stream, extents.maximum);
+}
+
+static void read(QDataStream& stream, Extents& extents) {
+    read(stream, extents.minimum);
+    read(stream, extents.maximum);
+}
+
+static void writeJoint(QDataStream& stream, const FBXJoint& joint) {
+    writeArray(stream, joint.shapeInfo.points);
+    writeArray(stream, joint.freeLineage);
+    write(stream, joint.isFree);
+    write(stream, joint.parentIndex);
+    write(stream, joint.distanceToParent);
+    write(stream, joint.translation);
+    write(stream, joint.preTransform);
+    write(stream, joint.preRotation);
+    write(stream, joint.rotation);
+    write(stream, joint.postRotation);
+    write(stream, joint.postTransform);
+    write(stream, joint.transform);
+    write(stream, joint.rotationMin);
+    write(stream, joint.rotationMax);
+    write(stream, joint.inverseDefaultRotation);
+    write(stream, joint.inverseBindRotation);
+    write(stream, joint.bindTransform);
+    write(stream, joint.name);
+    write(stream, joint.isSkeletonJoint);
+    write(stream, joint.bindTransformFoundInCluster);
+}
+
+static void readJoint(QDataStream& stream, FBXJoint& joint) {
+    readArray(stream, joint.shapeInfo.points);
+    readArray(stream, joint.freeLineage);
+    read(stream, joint.isFree);
+    read(stream, joint.parentIndex);
+    read(stream, joint.distanceToParent);
+    read(stream, joint.translation);
+    read(stream, joint.preTransform);
+    read(stream, joint.preRotation);
+    read(stream, joint.rotation);
+    read(stream, joint.postRotation);
+    read(stream, joint.postTransform);
+    read(stream, joint.transform);
+    read(stream, joint.rotationMin);
+    read(stream, joint.rotationMax);
+    read(stream, joint.inverseDefaultRotation);
+    read(stream, joint.inverseBindRotation);
+    read(stream, joint.bindTransform);
+    read(stream, joint.name);
+    read(stream, joint.isSkeletonJoint);
+    read(stream, joint.bindTransformFoundInCluster);
+}
+
+static void writeTexture(QDataStream& stream, const FBXTexture& texture) {
+    write(stream, texture.name);
+    write(stream, texture.filename);
+    write(stream, texture.content);
+    write(stream, texture.transform);
+    write(stream, texture.texcoordSet);
+    write(stream, texture.texcoordSetName);
+    write(stream, texture.isBumpmap);
+}
+
+static void readTexture(QDataStream& stream, FBXTexture& texture) {
+    read(stream, texture.name);
+    read(stream, texture.filename);
+    read(stream, texture.content);
+    read(stream, texture.transform);
+    read(stream, texture.texcoordSet);
+    read(stream, texture.texcoordSetName);
+    read(stream, texture.isBumpmap);
+}
+
+// the model material is kept as it was made, the readers don't all make it the same way from the FBX material
+static void writeMaterial(QDataStream& stream, const FBXMaterial& material) {
+    write(stream, material.diffuseColor);
+    write(stream, material.diffuseFactor);
+    write(stream, material.specularColor);
+    write(stream, material.specularFactor);
+    write(stream, material.emissiveColor);
+    write(stream, material.emissiveParams);
+    write(stream, material.shininess);
+    write(stream, material.opacity);
+    write(stream, material.materialID);
+    writeTexture(stream, material.diffuseTexture);
+    writeTexture(stream, material.opacityTexture);
+    writeTexture(stream, material.normalTexture);
+    writeTexture(stream, material.specularTexture);
+    writeTexture(stream, material.emissiveTexture);
+
+    bool hasModelMaterial = (bool)material._material;
+    write(stream, hasModelMaterial);
+    if (hasModelMaterial) {
+        const bool IS_SRGB = false;
+        write(stream, material._material->getEmissive(IS_SRGB));
+        write(stream, material._material->getDiffuse(IS_SRGB));
+        write(stream, material._material->getMetallic());
+        write(stream, material._material->getGloss());
+        write(stream, material._material->getOpacity());
+    }
+}
+
+static void readMaterial(QDataStream& stream, FBXMaterial& material) {
+    read(stream, material.diffuseColor);
+    read(stream, material.diffuseFactor);
+    read(stream, material.specularColor);
+    read(stream, material.specularFactor);
+    read(stream, material.emissiveColor);
+    read(stream, material.emissiveParams);
+    read(stream, material.shininess);
+    read(stream, material.opacity);
+    read(stream, material.materialID);
+    readTexture(stream, material.diffuseTexture);
+    readTexture(stream, material.opacityTexture);
+    readTexture(stream, material.normalTexture);
+    readTexture(stream, material.specularTexture);
+    readTexture(stream, material.emissiveTexture);
+
+    bool hasModelMaterial = false;
+    read(stream, hasModelMaterial);
+    if (hasModelMaterial) {
+        const bool IS_SRGB = false;
+        model::Material::Color emissive, diffuse;
+        float metallic, gloss, opacity;
+        read(stream, emissive);
+        read(stream, diffuse);
+        read(stream, metallic);
+        read(stream, gloss);
+        read(stream, opacity);
+
+        material._material = std::make_shared<model::Material>();
+        material._material->setEmissive(emissive, IS_SRGB);
+        material._material->setDiffuse(diffuse, IS_SRGB);
+        material._material->setMetallic(metallic);
+        material._material->setGloss(gloss);
+        material._material->setOpacity(opacity);
+    }
+}
+
+static void writeMesh(QDataStream& stream, const FBXMesh& mesh) {
+    writeList(stream, mesh.parts, [](QDataStream& stream, const FBXMeshPart& part) {
+        writeArray(stream, part.quadIndices);
+        writeArray(stream, part.quadTrianglesIndices);
+        writeArray(stream, part.triangleIndices);
+        writeList(stream, part.lodTriangleIndices, writeArray<int>);
+        write(stream, part.materialID);
+    });
+    writeArray(stream, mesh.vertices);
+    writeArray(stream, mesh.normals);
+    writeArray(stream, mesh.tangents);
+    writeArray(stream, mesh.colors);
+    writeArray(stream, mesh.texCoords);
+    writeArray(stream, mesh.texCoords1);
+    writeArray(stream, mesh.clusterIndices);
+    writeArray(stream, mesh.clusterWeights);
+    writeArray(stream, mesh.clusters);
+    write(stream, mesh.meshExtents);
+    write(stream, mesh.modelTransform);
+    write(stream, mesh.isEye);
+    writeList(stream, mesh.blendshapes, [](QDataStream& stream, const FBXBlendshape& blendshape) {
+        writeArray(stream, blendshape.indices);
+        writeArray(stream, blendshape.vertices);
+        writeArray(stream, blendshape.normals);
+    });
+    write(stream, mesh.meshIndex);
+    writeArray(stream, mesh.lodErrors);
+}
+
+static void readMesh(QDataStream& stream, FBXMesh& mesh) {
+    readList(stream, mesh.parts, [](QDataStream& stream, FBXMeshPart& part) {
+        readArray(stream, part.quadIndices);
+        readArray(stream, part.quadTrianglesIndices);
+        readArray(stream, part.triangleIndices);
+        readList(stream, part.lodTriangleIndices, readArray<int>);
+        read(stream, part.materialID);
+    });
+    readArray(stream, mesh.vertices);
+    readArray(stream, mesh.normals);
+    readArray(stream, mesh.tangents);
+    readArray(stream, mesh.colors);
+    readArray(stream, mesh.texCoords);
+    readArray(stream, mesh.texCoords1);
+    readArray(stream, mesh.clusterIndices);
+    readArray(stream, mesh.clusterWeights);
+    readArray(stream, mesh.clusters);
+    read(stream, mesh.meshExtents);
+    read(stream, mesh.modelTransform);
+    read(stream, mesh.isEye);
+    readList(stream, mesh.blendshapes, [](QDataStream& stream, FBXBlendshape& blendshape) {
+        readArray(stream, blendshape.indices);
+        readArray(stream, blendshape.vertices);
+        readArray(stream, blendshape.normals);
+    });
+    read(stream, mesh.meshIndex);
+    readArray(stream, mesh.lodErrors);
+}
+
+bool isGeometryContainer(const QByteArray& data) {
+    QDataStream stream(data);
+    quint32 magic = 0;
+    stream >> magic;
+    return magic == GEOMETRY_CONTAINER_MAGIC;
+}
+
+FBXGeometry* readGeometryContainer(const QByteArray& data, const QString& url) {
+    QDataStream stream(data);
+
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic != GEOMETRY_CONTAINER_MAGIC || version != GEOMETRY_CONTAINER_VERSION) {
+        return nullptr;
+    }
+
+    std::unique_ptr<FBXGeometry> geometry { new FBXGeometry() };
+
+    read(stream, geometry->author);
+    read(stream, geometry->applicationName);
+    readList(stream, geometry->joints, readJoint);
+    stream >> geometry->jointIndices;
+    read(stream, geometry->hasSkeletonJoints);
+    readList(stream, geometry->meshes, readMesh);
+
+    quint32 numMaterials = 0;
+    stream >> numMaterials;
+    for (quint32 i = 0; i < numMaterials && stream.status() == QDataStream::Ok; i++) {
+        QString materialID;
+        read(stream, materialID);
+        readMaterial(stream, geometry->materials[materialID]);
+    }
+
+    read(stream, geometry->offset);
+    read(stream, geometry->leftEyeJointIndex);
+    read(stream, geometry->rightEyeJointIndex);
+    read(stream, geometry->neckJointIndex);
+    read(stream, geometry->rootJointIndex);
+    read(stream, geometry->leanJointIndex);
+    read(stream, geometry->headJointIndex);
+    read(stream, geometry->leftHandJointIndex);
+    read(stream, geometry->rightHandJointIndex);
+    read(stream, geometry->leftToeJointIndex);
+    read(stream, geometry->rightToeJointIndex);
+    read(stream, geometry->leftEyeSize);
+    read(stream, geometry->rightEyeSize);
+    readArray(stream, geometry->humanIKJointIndices);
+    read(stream, geometry->palmDirection);
+    readList(stream, geometry->sittingPoints, [](QDataStream& stream, SittingPoint& sittingPoint) {
+        read(stream, sittingPoint.name);
+        read(stream, sittingPoint.position);
+        read(stream, sittingPoint.rotation);
+    });
+    read(stream, geometry->neckPivot);
+    read(stream, geometry->bindExtents);
+    read(stream, geometry->meshExtents);
+    readList(stream, geometry->animationFrames, [](QDataStream& stream, FBXAnimationFrame& frame) {
+        readArray(stream, frame.rotations);
+        readArray(stream, frame.translations);
+    });
+    stream >> geometry->meshIndicesToModelNames;
+    stream >> geometry->blendshapeChannelNames;
+
+    if (stream.status() != QDataStream::Ok) {
+        return nullptr;
+    }
+
+    // the only work left is putting the arrays in buffers
+    for (auto& mesh : geometry->meshes) {
+        FBXReader::buildModelMesh(mesh, url);
+    }
+
+    return geometry.release();
+}
+
+QByteArray writeGeometryContainer(const FBXGeometry& geometry) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+
+    stream << GEOMETRY_CONTAINER_MAGIC << GEOMETRY_CONTAINER_VERSION;
+
+    write(stream, geometry.author);
+    write(stream, geometry.applicationName);
+    writeList(stream, geometry.joints, writeJoint);
+    stream << geometry.jointIndices;
+    write(stream, geometry.hasSkeletonJoints);
+    writeList(stream, geometry.meshes, writeMesh);
+
+    stream << (quint32)geometry.materials.size();
+    for (auto itr = geometry.materials.constBegin(); itr != geometry.materials.constEnd(); itr++) {
+        write(stream, itr.key());
+        writeMaterial(stream, itr.value());
+    }
+
+    write(stream, geometry.offset);
+    write(stream, geometry.leftEyeJointIndex);
+    write(stream, geometry.rightEyeJointIndex);
+    write(stream, geometry.neckJointIndex);
+    write(stream, geometry.rootJointIndex);
+    write(stream, geometry.leanJointIndex);
+    write(stream, geometry.headJointIndex);
+    write(stream, geometry.leftHandJointIndex);
+    write(stream, geometry.rightHandJointIndex);
+    write(stream, geometry.leftToeJointIndex);
+    write(stream, geometry.rightToeJointIndex);
+    write(stream, geometry.leftEyeSize);
+    write(stream, geometry.rightEyeSize);
+    writeArray(stream, geometry.humanIKJointIndices);
+    write(stream, geometry.palmDirection);
+    writeList(stream, geometry.sittingPoints, [](QDataStream& stream, const SittingPoint& sittingPoint) {
+        write(stream, sittingPoint.name);
+        write(stream, sittingPoint.position);
+        write(stream, sittingPoint.rotation);
+    });
+    write(stream, geometry.neckPivot);
+    write(stream, geometry.bindExtents);
+    write(stream, geometry.meshExtents);
+    writeList(stream, geometry.animationFrames, [](QDataStream& stream, const FBXAnimationFrame& frame) {
+        writeArray(stream, frame.rotations);
+        writeArray(stream, frame.translations);
+    });
+    stream << geometry.meshIndicesToModelNames;
+    stream << geometry.blendshapeChannelNames;
+
+    return data;
+}
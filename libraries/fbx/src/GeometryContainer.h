@@ -0,0 +1,31 @@
+//
+//  GeometryContainer.h
+//  libraries/fbx/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_GeometryContainer_h
+#define hifi_GeometryContainer_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+class FBXGeometry;
+
+// A geometry container holds an FBXGeometry the way the readers left it: the joints, the vertex, index and cluster
+// arrays of each mesh as they go into their gpu::Buffers, the materials and the animation. Reading one is copying those
+// arrays out and building the model meshes from them, with none of the parsing or extracting of the readers.
+// The arrays are in native byte order, containers are made and read on the same machine.
+
+bool isGeometryContainer(const QByteArray& data);
+
+/// Returns nullptr if the data isn't a container that can be read.
+FBXGeometry* readGeometryContainer(const QByteArray& data, const QString& url);
+
+QByteArray writeGeometryContainer(const FBXGeometry& geometry);
+
+#endif // hifi_GeometryContainer_h
@@ -0,0 +1,358 @@
+//
+//  MeshOptimizer.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "FBXReader.h"
+
+// the size the cache is scored at, GPUs have caches about that size or larger
+static const int MAX_CACHE_SIZE = 32;
+
+// the size of the FIFO cache the clusters are split at, small enough that most GPUs would miss there too
+static const int CLUSTER_CACHE_SIZE = 16;
+
+// from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+static float getVertexScore(int cachePosition, int remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // the vertices of the last triangle score lower, so the next one doesn't just go along its edge
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            const float cacheScale = 1.0f / (MAX_CACHE_SIZE - 3);
+            score = powf(1.0f - (cachePosition - 3) * cacheScale, CACHE_DECAY_POWER);
+        }
+    }
+
+    // vertices with few triangles left are best done with, before they leave the cache
+    score += VALENCE_BOOST_SCALE * powf((float)remainingTriangles, -VALENCE_BOOST_POWER);
+    return score;
+}
+
+// orders the triangles greedily, each one the best scored of those using the vertices in the cache
+static std::vector<int> optimizeVertexCache(const int* indices, int numTriangles, int numVertices) {
+    // the triangles of each vertex that are left, the first remainingTriangles of its range
+    std::vector<int> adjacencyOffsets(numVertices + 1, 0);
+    for (int i = 0; i < numTriangles * 3; i++) {
+        adjacencyOffsets[indices[i] + 1]++;
+    }
+    std::vector<int> remainingTriangles(numVertices);
+    for (int vertex = 0; vertex < numVertices; vertex++) {
+        remainingTriangles[vertex] = adjacencyOffsets[vertex + 1];
+        adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+    }
+    std::vector<int> adjacency(numTriangles * 3);
+    std::vector<int> adjacencyEnds(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (int triangle = 0; triangle < numTriangles; triangle++) {
+        for (int i = 0; i < 3; i++) {
+            adjacency[adjacencyEnds[indices[triangle * 3 + i]]++] = triangle;
+        }
+    }
+
+    std::vector<int> cachePositions(numVertices, -1);
+    std::vector<float> vertexScores(numVertices);
+    for (int vertex = 0; vertex < numVertices; vertex++) {
+        vertexScores[vertex] = getVertexScore(-1, remainingTriangles[vertex]);
+    }
+    std::vector<float> triangleScores(numTriangles);
+    for (int triangle = 0; triangle < numTriangles; triangle++) {
+        const int* triangleIndices = indices + triangle * 3;
+        triangleScores[triangle] = vertexScores[triangleIndices[0]] + vertexScores[triangleIndices[1]] +
+            vertexScores[triangleIndices[2]];
+    }
+    std::vector<bool> isEmitted(numTriangles, false);
+
+    std::vector<int> order;
+    order.reserve(numTriangles);
+    std::vector<int> cache;
+    std::vector<int> nextCache;
+    cache.reserve(MAX_CACHE_SIZE + 3);
+    nextCache.reserve(MAX_CACHE_SIZE + 3);
+    int bestTriangle = -1;
+    int nextTriangle = 0;
+    while ((int)order.size() < numTriangles) {
+        if (bestTriangle == -1) {
+            // none of the cached vertices have triangles left, go on with the next one as the file has it
+            while (isEmitted[nextTriangle]) {
+                nextTriangle++;
+            }
+            bestTriangle = nextTriangle;
+        }
+
+        int triangle = bestTriangle;
+        const int* triangleIndices = indices + triangle * 3;
+        isEmitted[triangle] = true;
+        order.push_back(triangle);
+
+        // the vertices of the triangle are done with it, and go to the front of the cache
+        nextCache.clear();
+        for (int i = 0; i < 3; i++) {
+            int vertex = triangleIndices[i];
+            int* begin = adjacency.data() + adjacencyOffsets[vertex];
+            int* end = begin + remainingTriangles[vertex];
+            std::iter_swap(std::find(begin, end, triangle), end - 1);
+            remainingTriangles[vertex]--;
+
+            if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end()) {
+                nextCache.push_back(vertex);
+            }
+        }
+        for (int vertex : cache) {
+            if (vertex != triangleIndices[0] && vertex != triangleIndices[1] && vertex != triangleIndices[2]) {
+                nextCache.push_back(vertex);
+            }
+        }
+
+        // rescore the vertices that moved in the cache, and those that left it
+        for (int i = 0; i < (int)nextCache.size(); i++) {
+            int vertex = nextCache[i];
+            cachePositions[vertex] = (i < MAX_CACHE_SIZE) ? i : -1;
+            float score = getVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+            float scoreChange = score - vertexScores[vertex];
+            vertexScores[vertex] = score;
+
+            const int* begin = adjacency.data() + adjacencyOffsets[vertex];
+            for (const int* adjacent = begin; adjacent != begin + remainingTriangles[vertex]; adjacent++) {
+                triangleScores[*adjacent] += scoreChange;
+            }
+        }
+        nextCache.resize(std::min((int)nextCache.size(), MAX_CACHE_SIZE));
+        std::swap(cache, nextCache);
+
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (int vertex : cache) {
+            const int* begin = adjacency.data() + adjacencyOffsets[vertex];
+            for (const int* adjacent = begin; adjacent != begin + remainingTriangles[vertex]; adjacent++) {
+                if (triangleScores[*adjacent] > bestScore) {
+                    bestScore = triangleScores[*adjacent];
+                    bestTriangle = *adjacent;
+                }
+            }
+        }
+    }
+
+    return order;
+}
+
+// from Sander, Nehab and Barczak's "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw": the cache
+// optimized order is split into clusters where the cache starts over, and the clusters facing out of the mesh go first,
+// so that they cover the ones facing in
+static std::vector<int> orderClusters(const int* indices, const std::vector<int>& order,
+                                      const QVector<glm::vec3>& vertices) {
+    std::vector<int> clusterStarts;
+    std::vector<int> cacheTimes(vertices.size(), -CLUSTER_CACHE_SIZE);
+    int cacheTime = 0;
+    for (int i = 0; i < (int)order.size(); i++) {
+        const int* triangleIndices = indices + order[i] * 3;
+        int misses = 0;
+        for (int j = 0; j < 3; j++) {
+            int& vertexTime = cacheTimes[triangleIndices[j]];
+            if (cacheTime - vertexTime >= CLUSTER_CACHE_SIZE) {
+                vertexTime = cacheTime++;
+                misses++;
+            }
+        }
+        if (i == 0 || misses == 3) {
+            clusterStarts.push_back(i);
+        }
+    }
+    if (clusterStarts.size() < 2) {
+        return order;
+    }
+    clusterStarts.push_back((int)order.size());
+
+    // the clusters are sorted by how far their area weighted center is, along their normal, from the mesh center
+    int numClusters = (int)clusterStarts.size() - 1;
+    std::vector<glm::vec3> clusterCenters(numClusters);
+    std::vector<glm::vec3> clusterNormals(numClusters);
+    glm::vec3 meshCenter;
+    float meshArea = 0.0f;
+    for (int cluster = 0; cluster < numClusters; cluster++) {
+        glm::vec3 center;
+        glm::vec3 normal;
+        float area = 0.0f;
+        for (int i = clusterStarts[cluster]; i < clusterStarts[cluster + 1]; i++) {
+            const int* triangleIndices = indices + order[i] * 3;
+            const glm::vec3& a = vertices.at(triangleIndices[0]);
+            const glm::vec3& b = vertices.at(triangleIndices[1]);
+            const glm::vec3& c = vertices.at(triangleIndices[2]);
+            glm::vec3 triangleNormal = glm::cross(b - a, c - a);
+            float triangleArea = glm::length(triangleNormal);
+            center += (a + b + c) * (triangleArea / 3.0f);
+            normal += triangleNormal;
+            area += triangleArea;
+        }
+        meshCenter += center;
+        meshArea += area;
+        clusterCenters[cluster] = (area > 0.0f) ? center / area : center;
+        clusterNormals[cluster] = normal;
+    }
+    if (meshArea <= 0.0f) {
+        return order;
+    }
+    meshCenter /= meshArea;
+
+    std::vector<float> clusterSortKeys(numClusters, 0.0f);
+    for (int cluster = 0; cluster < numClusters; cluster++) {
+        float normalLength = glm::length(clusterNormals[cluster]);
+        if (normalLength > 0.0f) {
+            clusterSortKeys[cluster] = glm::dot(clusterCenters[cluster] - meshCenter, clusterNormals[cluster] / normalLength);
+        }
+    }
+
+    std::vector<int> clusters(numClusters);
+    for (int cluster = 0; cluster < numClusters; cluster++) {
+        clusters[cluster] = cluster;
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [&clusterSortKeys](int first, int second) {
+        return clusterSortKeys[first] > clusterSortKeys[second];
+    });
+
+    std::vector<int> clusterOrder;
+    clusterOrder.reserve(order.size());
+    for (int cluster : clusters) {
+        clusterOrder.insert(clusterOrder.end(), order.begin() + clusterStarts[cluster],
+                            order.begin() + clusterStarts[cluster + 1]);
+    }
+    return clusterOrder;
+}
+
+static bool areIndicesInRange(const QVector<int>& indices, int numVertices) {
+    for (int index : indices) {
+        if (index < 0 || index >= numVertices) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void optimizeTriangles(QVector<int>& indices, const QVector<glm::vec3>& vertices) {
+    const int MIN_TRIANGLES = 2;
+    int numTriangles = indices.size() / 3;
+    if (numTriangles < MIN_TRIANGLES) {
+        return;
+    }
+
+    std::vector<int> order = optimizeVertexCache(indices.constData(), numTriangles, vertices.size());
+    order = orderClusters(indices.constData(), order, vertices);
+
+    // whatever is left over that doesn't make a triangle stays at the end
+    QVector<int> reordered;
+    reordered.reserve(indices.size());
+    for (int triangle : order) {
+        reordered.append(indices.at(triangle * 3));
+        reordered.append(indices.at(triangle * 3 + 1));
+        reordered.append(indices.at(triangle * 3 + 2));
+    }
+    for (int i = numTriangles * 3; i < indices.size(); i++) {
+        reordered.append(indices.at(i));
+    }
+    indices.swap(reordered);
+}
+
+template <typename T>
+static void reorderVertices(QVector<T>& array, const std::vector<int>& newIndices) {
+    if (array.size() != (int)newIndices.size()) {
+        return;
+    }
+    QVector<T> reordered(array.size());
+    for (int i = 0; i < array.size(); i++) {
+        reordered[newIndices[i]] = array.at(i);
+    }
+    array.swap(reordered);
+}
+
+static void renumberVertices(QVector<int>& indices, const std::vector<int>& newIndices) {
+    for (int& index : indices) {
+        index = newIndices[index];
+    }
+}
+
+void optimizeMesh(FBXMesh& mesh) {
+    int numVertices = mesh.vertices.size();
+    for (const auto& part : mesh.parts) {
+        if (!areIndicesInRange(part.quadIndices, numVertices) ||
+                !areIndicesInRange(part.quadTrianglesIndices, numVertices) ||
+                !areIndicesInRange(part.triangleIndices, numVertices)) {
+            return;
+        }
+        for (const auto& lodIndices : part.lodTriangleIndices) {
+            if (!areIndicesInRange(lodIndices, numVertices)) {
+                return;
+            }
+        }
+    }
+    for (const auto& blendshape : mesh.blendshapes) {
+        if (!areIndicesInRange(blendshape.indices, numVertices)) {
+            return;
+        }
+    }
+
+    // the quads keep their order, only the triangles the GPU draws are reordered
+    for (auto& part : mesh.parts) {
+        optimizeTriangles(part.quadTrianglesIndices, mesh.vertices);
+        optimizeTriangles(part.triangleIndices, mesh.vertices);
+        for (auto& lodIndices : part.lodTriangleIndices) {
+            optimizeTriangles(lodIndices, mesh.vertices);
+        }
+    }
+
+    // the vertices are numbered in the order the GPU fetches them for the full parts, the unused ones go last
+    std::vector<int> newIndices(numVertices, -1);
+    int nextIndex = 0;
+    for (const auto& part : mesh.parts) {
+        for (auto indices : { &part.quadTrianglesIndices, &part.triangleIndices }) {
+            for (int index : *indices) {
+                if (newIndices[index] == -1) {
+                    newIndices[index] = nextIndex++;
+                }
+            }
+        }
+    }
+    for (int& newIndex : newIndices) {
+        if (newIndex == -1) {
+            newIndex = nextIndex++;
+        }
+    }
+
+    reorderVertices(mesh.vertices, newIndices);
+    reorderVertices(mesh.normals, newIndices);
+    reorderVertices(mesh.tangents, newIndices);
+    reorderVertices(mesh.colors, newIndices);
+    reorderVertices(mesh.texCoords, newIndices);
+    reorderVertices(mesh.texCoords1, newIndices);
+    reorderVertices(mesh.clusterIndices, newIndices);
+    reorderVertices(mesh.clusterWeights, newIndices);
+    for (auto& part : mesh.parts) {
+        renumberVertices(part.quadIndices, newIndices);
+        renumberVertices(part.quadTrianglesIndices, newIndices);
+        renumberVertices(part.triangleIndices, newIndices);
+        for (auto& lodIndices : part.lodTriangleIndices) {
+            renumberVertices(lodIndices, newIndices);
+        }
+    }
+    for (auto& blendshape : mesh.blendshapes) {
+        renumberVertices(blendshape.indices, newIndices);
+    }
+}
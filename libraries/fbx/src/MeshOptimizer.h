@@ -0,0 +1,21 @@
+//
+//  MeshOptimizer.h
+//  libraries/fbx/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MeshOptimizer_h
+#define hifi_MeshOptimizer_h
+
+class FBXMesh;
+
+/// Reorders the triangles of each part so that the post-transform vertex cache of the GPU reuses their vertices and the
+/// triangles facing out of the mesh draw first, then renumbers the vertices in the order the triangles use them.
+/// The model mesh isn't touched, it has to be built again from the reordered arrays.
+void optimizeMesh(FBXMesh& mesh);
+
+#endif // hifi_MeshOptimizer_h
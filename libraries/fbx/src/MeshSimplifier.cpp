@@ -0,0 +1,299 @@
+//
+//  MeshSimplifier.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "FBXReader.h"
+
+static const int MAX_MESH_LODS = 3;
+
+// parts with fewer triangles aren't worth a level of detail
+static const int MIN_LOD_TRIANGLES = 128;
+
+// a level is made with half the triangles of the one before, and only kept if it got to three quarters of them
+static const float LOD_TRIANGLE_RATIO = 0.5f;
+static const float MAX_LOD_TRIANGLE_RATIO = 0.75f;
+
+// how far each level can move the surface, relative to the size of the mesh
+static const float LOD_ERROR_LIMITS[MAX_MESH_LODS] = { 0.005f, 0.015f, 0.04f };
+
+// the sum of the squared distances to a set of planes
+class Quadric {
+public:
+    Quadric() {}
+    Quadric(const glm::dvec3& normal, const glm::dvec3& point) {
+        double d = -glm::dot(normal, point);
+        _xx = normal.x * normal.x; _xy = normal.x * normal.y; _xz = normal.x * normal.z; _xw = normal.x * d;
+        _yy = normal.y * normal.y; _yz = normal.y * normal.z; _yw = normal.y * d;
+        _zz = normal.z * normal.z; _zw = normal.z * d;
+        _ww = d * d;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        _xx += other._xx; _xy += other._xy; _xz += other._xz; _xw += other._xw;
+        _yy += other._yy; _yz += other._yz; _yw += other._yw;
+        _zz += other._zz; _zw += other._zw;
+        _ww += other._ww;
+        return *this;
+    }
+
+    Quadric operator+(const Quadric& other) const {
+        Quadric sum = *this;
+        return sum += other;
+    }
+
+    double evaluate(const glm::dvec3& p) const {
+        return p.x * (p.x * _xx + 2.0 * (p.y * _xy + p.z * _xz + _xw)) +
+            p.y * (p.y * _yy + 2.0 * (p.z * _yz + _yw)) +
+            p.z * (p.z * _zz + 2.0 * _zw) + _ww;
+    }
+
+private:
+    double _xx { 0.0 }, _xy { 0.0 }, _xz { 0.0 }, _xw { 0.0 };
+    double _yy { 0.0 }, _yz { 0.0 }, _yw { 0.0 };
+    double _zz { 0.0 }, _zw { 0.0 };
+    double _ww { 0.0 };
+};
+
+class Collapse {
+public:
+    int from;
+    int to;
+    double cost;
+};
+
+// true if moving the vertex onto the other turns any of its triangles over
+static bool doesCollapseFlip(const QVector<glm::vec3>& vertices, const std::vector<int>& triangles,
+                             const int* adjacent, int numAdjacent, int from, int to) {
+    for (int i = 0; i < numAdjacent; i++) {
+        const int* triangle = triangles.data() + adjacent[i] * 3;
+        if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+            continue; // goes away with the collapse
+        }
+        glm::vec3 corners[3];
+        glm::vec3 movedCorners[3];
+        for (int j = 0; j < 3; j++) {
+            corners[j] = vertices.at(triangle[j]);
+            movedCorners[j] = vertices.at(triangle[j] == from ? to : triangle[j]);
+        }
+        glm::vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+        glm::vec3 movedNormal = glm::cross(movedCorners[1] - movedCorners[0], movedCorners[2] - movedCorners[0]);
+        if (glm::dot(normal, movedNormal) <= 0.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// collapses edges of the triangles, cheapest first, until there are targetTriangles left or the next would move the
+// surface further than maxError; returns how far the surface got moved
+static float simplifyTriangles(const QVector<glm::vec3>& vertices, std::vector<int>& triangles,
+                               std::vector<Quadric>& quadrics, const std::vector<bool>& isLocked,
+                               int targetTriangles, float maxError) {
+    int numVertices = vertices.size();
+    double maxCost = (double)maxError * maxError;
+    double reachedCost = 0.0;
+
+    std::vector<int> adjacencyOffsets(numVertices + 1);
+    std::vector<int> adjacency;
+    std::vector<int> collapsedTo(numVertices);
+    std::vector<bool> isTouched(numVertices);
+    std::vector<Collapse> collapses;
+
+    while ((int)triangles.size() / 3 > targetTriangles) {
+        int numTriangles = (int)triangles.size() / 3;
+
+        // the triangles of each vertex
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (int index : triangles) {
+            adjacencyOffsets[index + 1]++;
+        }
+        for (int vertex = 0; vertex < numVertices; vertex++) {
+            adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+        }
+        adjacency.resize(triangles.size());
+        std::vector<int> adjacencyEnds(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (int i = 0; i < (int)triangles.size(); i++) {
+            adjacency[adjacencyEnds[triangles[i]]++] = i / 3;
+        }
+
+        // each edge can collapse either way, the cost is the error of the two quadrics at where it ends
+        collapses.clear();
+        for (int i = 0; i < (int)triangles.size(); i++) {
+            int from = triangles[i];
+            int to = triangles[i - i % 3 + (i + 1) % 3];
+            if (!isLocked[from]) {
+                double cost = (quadrics[from] + quadrics[to]).evaluate(glm::dvec3(vertices.at(to)));
+                collapses.push_back({ from, to, std::max(cost, 0.0) });
+            }
+            if (!isLocked[to]) {
+                double cost = (quadrics[from] + quadrics[to]).evaluate(glm::dvec3(vertices.at(from)));
+                collapses.push_back({ to, from, std::max(cost, 0.0) });
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& first, const Collapse& second) {
+            return first.cost < second.cost;
+        });
+
+        // the collapses of a pass don't touch each other's triangles, so the adjacency holds for all of them
+        for (int vertex = 0; vertex < numVertices; vertex++) {
+            collapsedTo[vertex] = vertex;
+        }
+        std::fill(isTouched.begin(), isTouched.end(), false);
+        int remainingTriangles = numTriangles;
+        int numCollapses = 0;
+        for (const auto& collapse : collapses) {
+            if (collapse.cost > maxCost || remainingTriangles <= targetTriangles) {
+                break;
+            }
+            if (isTouched[collapse.from] || isTouched[collapse.to]) {
+                continue;
+            }
+            const int* adjacent = adjacency.data() + adjacencyOffsets[collapse.from];
+            int numAdjacent = adjacencyOffsets[collapse.from + 1] - adjacencyOffsets[collapse.from];
+            if (doesCollapseFlip(vertices, triangles, adjacent, numAdjacent, collapse.from, collapse.to)) {
+                continue;
+            }
+
+            collapsedTo[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            reachedCost = std::max(reachedCost, collapse.cost);
+            for (int i = 0; i < numAdjacent; i++) {
+                const int* triangle = triangles.data() + adjacent[i] * 3;
+                isTouched[triangle[0]] = isTouched[triangle[1]] = isTouched[triangle[2]] = true;
+            }
+            // an edge inside the surface has a triangle on either side
+            const int TRIANGLES_PER_COLLAPSE = 2;
+            remainingTriangles -= TRIANGLES_PER_COLLAPSE;
+            numCollapses++;
+        }
+        if (numCollapses == 0) {
+            break;
+        }
+
+        // the triangles along the collapsed edges are left with two corners on the same vertex
+        int kept = 0;
+        for (int i = 0; i < (int)triangles.size(); i += 3) {
+            int a = collapsedTo[triangles[i]];
+            int b = collapsedTo[triangles[i + 1]];
+            int c = collapsedTo[triangles[i + 2]];
+            if (a != b && b != c && c != a) {
+                triangles[kept++] = a;
+                triangles[kept++] = b;
+                triangles[kept++] = c;
+            }
+        }
+        triangles.resize(kept);
+    }
+
+    return (float)sqrt(reachedCost);
+}
+
+static void appendTriangles(std::vector<int>& triangles, const QVector<int>& indices) {
+    int numIndices = indices.size() - indices.size() % 3;
+    triangles.insert(triangles.end(), indices.constBegin(), indices.constBegin() + numIndices);
+}
+
+void generateMeshLODs(FBXMesh& mesh) {
+    mesh.lodErrors.clear();
+    for (auto& part : mesh.parts) {
+        part.lodTriangleIndices.clear();
+    }
+
+    int numVertices = mesh.vertices.size();
+    if (numVertices == 0) {
+        return;
+    }
+    Extents extents;
+    extents.reset();
+    for (const auto& vertex : mesh.vertices) {
+        extents.addPoint(vertex);
+    }
+    float meshSize = glm::length(extents.maximum - extents.minimum);
+
+    for (auto& part : mesh.parts) {
+        std::vector<int> triangles;
+        appendTriangles(triangles, part.quadTrianglesIndices);
+        appendTriangles(triangles, part.triangleIndices);
+        int numTriangles = (int)triangles.size() / 3;
+        if (numTriangles < MIN_LOD_TRIANGLES ||
+                std::any_of(triangles.begin(), triangles.end(), [&](int index) { return index < 0 || index >= numVertices; })) {
+            continue;
+        }
+
+        // each vertex starts with the planes of its triangles
+        std::vector<Quadric> quadrics(numVertices);
+        for (int i = 0; i < (int)triangles.size(); i += 3) {
+            glm::dvec3 a = glm::dvec3(mesh.vertices.at(triangles[i]));
+            glm::dvec3 b = glm::dvec3(mesh.vertices.at(triangles[i + 1]));
+            glm::dvec3 c = glm::dvec3(mesh.vertices.at(triangles[i + 2]));
+            glm::dvec3 normal = glm::cross(b - a, c - a);
+            double length = glm::length(normal);
+            if (length > 0.0) {
+                Quadric plane(normal / length, a);
+                quadrics[triangles[i]] += plane;
+                quadrics[triangles[i + 1]] += plane;
+                quadrics[triangles[i + 2]] += plane;
+            }
+        }
+
+        // the vertices on edges that don't have a triangle on either side are on a seam or a border, they stay
+        std::vector<std::pair<int, int>> edges;
+        edges.reserve(triangles.size());
+        for (int i = 0; i < (int)triangles.size(); i++) {
+            int from = triangles[i];
+            int to = triangles[i - i % 3 + (i + 1) % 3];
+            edges.push_back({ std::min(from, to), std::max(from, to) });
+        }
+        std::sort(edges.begin(), edges.end());
+        std::vector<bool> isLocked(numVertices, false);
+        for (size_t i = 0; i < edges.size(); ) {
+            size_t end = i;
+            while (end < edges.size() && edges[end] == edges[i]) {
+                end++;
+            }
+            const size_t TRIANGLES_PER_EDGE = 2;
+            if (end - i != TRIANGLES_PER_EDGE) {
+                isLocked[edges[i].first] = isLocked[edges[i].second] = true;
+            }
+            i = end;
+        }
+
+        // each level is simplified from the one before it
+        float error = 0.0f;
+        for (int lod = 0; lod < MAX_MESH_LODS; lod++) {
+            int targetTriangles = (int)(numTriangles * LOD_TRIANGLE_RATIO);
+            float maxError = LOD_ERROR_LIMITS[lod] * meshSize;
+            error = std::max(error, simplifyTriangles(mesh.vertices, triangles, quadrics, isLocked, targetTriangles, maxError));
+
+            int lodTriangles = (int)triangles.size() / 3;
+            if (lodTriangles > numTriangles * MAX_LOD_TRIANGLE_RATIO) {
+                break;
+            }
+
+            QVector<int> lodIndices;
+            lodIndices.reserve((int)triangles.size());
+            for (int index : triangles) {
+                lodIndices.append(index);
+            }
+            part.lodTriangleIndices.append(lodIndices);
+            if (mesh.lodErrors.size() <= lod) {
+                mesh.lodErrors.append(error);
+            } else {
+                mesh.lodErrors[lod] = std::max(mesh.lodErrors[lod], error);
+            }
+            numTriangles = lodTriangles;
+        }
+    }
+}
@@ -0,0 +1,22 @@
+//
+//  MeshSimplifier.h
+//  libraries/fbx/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MeshSimplifier_h
+#define hifi_MeshSimplifier_h
+
+class FBXMesh;
+
+/// Makes coarser levels of detail of the parts of the mesh, each with about half the triangles of the one before, by
+/// collapsing the edges that move the surface least (Garland and Heckbert's quadric error metric). Vertices are only
+/// ever collapsed into one another, so the levels are drawn from the same vertices, skinned and blended the same way.
+/// The edges at texture seams and open borders stay where they are. The model mesh has to be built again.
+void generateMeshLODs(FBXMesh& mesh);
+
+#endif // hifi_MeshSimplifier_h
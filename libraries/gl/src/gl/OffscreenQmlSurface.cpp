@@ -198,6 +198,7 @@ private:
             return;
         }
         _size = newOffscreenSize;
+        _rendered = false;
 
         // Clear out any fbos with the old size
         if (!makeCurrent()) {
@@ -212,6 +213,7 @@ private:
 
     void render(QMutexLocker *lock) {
         if (_surface->_paused) {
+            _cond.wakeOne();
             return;
         }
 
@@ -220,9 +222,16 @@ private:
             return;
         }
 
-        _renderControl->sync();
+        // The scene graph renders to the whole texture every time, so a frame is only rendered when the sync changed
+        // it: a scene change signalled by Qt Quick doesn't always change what is drawn.  A render asked for, or a
+        // texture with no frame in it yet, is rendered regardless.
+        bool changed = _renderControl->sync();
+        bool needed = changed || _renderRequested || !_rendered;
         _cond.wakeOne();
         lock->unlock();
+        if (!needed) {
+            return;
+        }
 
         using namespace oglplus;
 
@@ -246,6 +255,7 @@ private:
             _quickWindow->resetOpenGLState();
             _escrow.submit(GetName(*texture));
         }
+        _rendered = true;
         _lastRenderTime = usecTimestampNow();
     }
 
@@ -304,6 +314,8 @@ private:
     RenderbufferPtr _depthStencil;
     uvec2 _size{ 1920, 1080 };
     uint64_t _lastRenderTime{ 0 };
+    bool _renderRequested{ false };
+    bool _rendered{ false };
     TextureRecycler _textures;
     GLTextureEscrow _escrow;
 };
@@ -408,6 +420,7 @@ void OffscreenQmlSurface::requestUpdate() {
 
 void OffscreenQmlSurface::requestRender() {
     _render = true;
+    _renderRequested = true;
 }
 
 QObject* OffscreenQmlSurface::finishQmlLoad(std::function<void(QQmlContext*, QObject*)> f) {
@@ -467,7 +480,8 @@ QObject* OffscreenQmlSurface::finishQmlLoad(std::function<void(QQmlContext*, QOb
 }
 
 void OffscreenQmlSurface::updateQuick() {
-    if (!_renderer || !_renderer->allowNewFrame(_maxFps)) {
+    // A paused renderer doesn't render, it mustn't be waited on
+    if (!_renderer || _paused || !_renderer->allowNewFrame(_maxFps)) {
         return;
     }
 
@@ -478,9 +492,11 @@ void OffscreenQmlSurface::updateQuick() {
 
     if (_render) {
         QMutexLocker lock(&(_renderer->_mutex));
+        _renderer->_renderRequested = _renderRequested;
         _renderer->post(RENDER);
         _renderer->_cond.wait(&(_renderer->_mutex));
         _render = false;
+        _renderRequested = false;
     }
 
     GLuint newTexture = _renderer->_escrow.fetch();
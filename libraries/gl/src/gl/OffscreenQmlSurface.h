@@ -11,6 +11,7 @@
 
 #include <QTimer>
 #include <QUrl>
+#include <algorithm>
 #include <atomic>
 #include <functional>
 
@@ -48,7 +49,9 @@ public:
     Q_INVOKABLE void executeOnUiThread(std::function<void()> function, bool blocking = false);
     Q_INVOKABLE QVariant returnFromUiThread(std::function<QVariant()> function);
 
-    void setMaxFps(uint8_t maxFps) { _maxFps = maxFps; }
+    // the most frames the surface renders each second, whatever the frame rate of the rest of the application
+    void setMaxFps(uint8_t maxFps) { _maxFps = std::max<uint8_t>(maxFps, 1); }
+    uint8_t getMaxFps() const { return _maxFps; }
     // Optional values for event handling
     void setProxyWindow(QWindow* window);
     void setMouseTranslator(MouseTranslator mouseTranslator) {
@@ -91,6 +94,7 @@ private:
     QTimer _updateTimer;
     uint32_t _currentTexture{ 0 };
     bool _render{ false };
+    bool _renderRequested{ false }; // a render asked for, rather than a change of the scene
     bool _polish{ true };
     bool _paused{ true };
     uint8_t _maxFps{ 60 };
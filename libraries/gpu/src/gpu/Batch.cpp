@@ -15,15 +15,15 @@
 
 #if defined(NSIGHT_FOUND)
 #include "nvToolsExt.h"
+#endif
 
-ProfileRangeBatch::ProfileRangeBatch(gpu::Batch& batch, const char *name) : _batch(batch) {
+ProfileRangeBatch::ProfileRangeBatch(gpu::Batch& batch, const char *name) : _batch(batch), _traceScope(name) {
     _batch.pushProfileRange(name);
 }
 
 ProfileRangeBatch::~ProfileRangeBatch() {
     _batch.popProfileRange();
 }
-#endif
 
 #define ADD_COMMAND(call) _commands.push_back(COMMAND_##call); _commandOffsets.push_back(_params.size());
 
@@ -16,6 +16,7 @@
 #include <functional>
 
 #include <shared/NsightHelpers.h>
+#include <shared/Trace.h>
 
 #include "Framebuffer.h"
 #include "Pipeline.h"
@@ -486,8 +487,7 @@ protected:
 
 }
 
-#if defined(NSIGHT_FOUND)
-
+// Names a range of the commands of a batch for Nsight, and traces the time taken to record them
 class ProfileRangeBatch {
 public:
     ProfileRangeBatch(gpu::Batch& batch, const char *name);
@@ -495,16 +495,11 @@ public:
 
 private:
     gpu::Batch& _batch;
+    trace::Scope _traceScope;
 };
 
 #define PROFILE_RANGE_BATCH(batch, name) ProfileRangeBatch profileRangeThis(batch, name);
 
-#else
-
-#define PROFILE_RANGE_BATCH(batch, name) 
-
-#endif
-
 QDebug& operator<<(QDebug& debug, const gpu::Batch::CacheState& cacheState);
 
 #endif
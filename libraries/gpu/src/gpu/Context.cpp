@@ -94,6 +94,10 @@ Backend::TransformCamera Backend::TransformCamera::getEyeCamera(int eye, const S
         result._view = skyboxView * result._view;
     }
     result._projection = _stereo._eyeProjections[eye];
+    // each eye sees its half of the viewport, 0 for the left eye and 1 for the right eye
+    float halfWidth = floorf(result._viewport.z * 0.5f);
+    result._viewport.x += eye * halfWidth;
+    result._viewport.z = halfWidth;
     result.recomputeDerived();
     return result;
 }
@@ -30,8 +30,6 @@ namespace gpu {
 struct StereoState {
     bool _enable{ false };
     bool _skybox{ false };
-    // 0 for left eye, 1 for right eye
-    uint8_t _pass{ 0 };
     mat4 _eyeViews[2];
     mat4 _eyeProjections[2];
 };
@@ -199,8 +199,13 @@ enum Semantic {
     SAMPLER,
     SAMPLER_MULTISAMPLE,
     SAMPLER_SHADOW,
-  
- 
+
+    // block compressed color for textures, encoded from the pixels of the stored mip when it is uploaded
+    COMPRESSED_RGB,
+    COMPRESSED_SRGB,
+    COMPRESSED_RGBA,
+    COMPRESSED_SRGBA,
+
     NUM_SEMANTICS,
 };
 
@@ -221,6 +226,7 @@ public:
     {}
  
     Semantic getSemantic() const { return (Semantic)_semantic; }
+    bool isCompressed() const { return (getSemantic() >= COMPRESSED_RGB) && (getSemantic() <= COMPRESSED_SRGBA); }
 
     Dimension getDimension() const { return (Dimension)_dimension; }
     
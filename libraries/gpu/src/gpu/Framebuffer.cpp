@@ -48,10 +48,14 @@ Framebuffer* Framebuffer::create( const Format& colorBufferFormat, const Format&
 }
 
 Framebuffer* Framebuffer::createShadowmap(uint16 width) {
+    return createShadowmap(width, width);
+}
+
+Framebuffer* Framebuffer::createShadowmap(uint16 width, uint16 height) {
     auto framebuffer = Framebuffer::create();
 
     auto depthFormat = Element(gpu::SCALAR, gpu::FLOAT, gpu::DEPTH); // Depth32 texel format
-    auto depthTexture = TexturePointer(Texture::create2D(depthFormat, width, width));
+    auto depthTexture = TexturePointer(Texture::create2D(depthFormat, width, height));
         
     Sampler::Desc samplerDesc;
     samplerDesc._borderColor = glm::vec4(1.0f);
@@ -90,6 +90,7 @@ public:
     static Framebuffer* create(const Format& colorBufferFormat, uint16 width, uint16 height);
     static Framebuffer* create(const Format& colorBufferFormat, const Format& depthStencilBufferFormat, uint16 width, uint16 height);
     static Framebuffer* createShadowmap(uint16 width);
+    static Framebuffer* createShadowmap(uint16 width, uint16 height);
 
     bool isSwapchain() const;
     SwapchainPointer getSwapchain() const { return _swapchain; }
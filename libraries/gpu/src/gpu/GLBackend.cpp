@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 #include "GLBackendShared.h"
+#include "GLTextureTransfer.h"
 
 #include <mutex>
 #include <queue>
@@ -128,6 +129,13 @@ GLBackend::GLBackend() {
     glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &_uboAlignment);
     initInput();
     initTransform();
+
+    if (!_textureTransferHelper) {
+        auto textureTransferHelper = std::make_shared<GLTextureTransferHelper>();
+        if (textureTransferHelper->isValid()) {
+            _textureTransferHelper = textureTransferHelper;
+        }
+    }
 }
 
 GLBackend::~GLBackend() {
@@ -135,6 +143,134 @@ GLBackend::~GLBackend() {
 
     killInput();
     killTransform();
+
+    _textureTransferHelper.reset();
+}
+
+namespace {
+    // what a state command last set, the object from the batch caches and up to two of its params
+    class CommandState {
+    public:
+        bool isSet { false };
+        const void* object { nullptr };
+        uint32 first { 0 };
+        uint32 second { 0 };
+
+        // true if the command sets what is already set, otherwise remembers what it sets
+        bool setAgain(const void* newObject, uint32 newFirst = 0, uint32 newSecond = 0) {
+            if (isSet && object == newObject && first == newFirst && second == newSecond) {
+                return true;
+            }
+            isSet = true;
+            object = newObject;
+            first = newFirst;
+            second = newSecond;
+            return false;
+        }
+    };
+
+    template <typename T>
+    const void* getCached(const typename Batch::Cache<T>::Vector& caches, uint32 index) {
+        return (index < caches._items.size()) ? caches._items[index]._data.get() : nullptr;
+    }
+
+    void resetCommandStates(std::vector<CommandState>& states) {
+        for (auto& state : states) {
+            state.isSet = false;
+        }
+    }
+}
+
+void GLBackend::stripRedundantCommands(Batch& batch) {
+    CommandState pipeline;
+    CommandState inputFormat;
+    CommandState indexBuffer;
+    std::vector<CommandState> inputBuffers(MAX_NUM_INPUT_BUFFERS);
+    std::vector<CommandState> uniformBuffers(MAX_NUM_UNIFORM_BUFFERS);
+    std::vector<CommandState> resourceTextures(MAX_NUM_RESOURCE_TEXTURES);
+
+    auto& commands = batch._commands;
+    auto& offsets = batch._commandOffsets;
+    const auto& params = batch._params;
+    size_t kept = 0;
+    for (size_t i = 0; i < commands.size(); i++) {
+        size_t offset = offsets[i];
+        bool isRedundant = false;
+        switch (commands[i]) {
+            case Batch::COMMAND_setPipeline:
+                if (!pipeline.setAgain(getCached<PipelinePointer>(batch._pipelines, params[offset]._uint))) {
+#if (GPU_FEATURE_PROFILE != GPU_CORE)
+                    // the uniform buffers are uniforms of the program, a new one needs them again
+                    resetCommandStates(uniformBuffers);
+#endif
+                } else {
+                    isRedundant = true;
+                }
+                break;
+
+            case Batch::COMMAND_setInputFormat:
+                isRedundant = inputFormat.setAgain(getCached<Stream::FormatPointer>(batch._streamFormats, params[offset]._uint));
+                break;
+
+            case Batch::COMMAND_setInputBuffer: {
+                uint32 channel = params[offset + 3]._uint;
+                if (channel < inputBuffers.size()) {
+                    isRedundant = inputBuffers[channel].setAgain(getCached<BufferPointer>(batch._buffers, params[offset + 2]._uint),
+                        params[offset + 1]._uint, params[offset + 0]._uint);
+                }
+                break;
+            }
+
+            case Batch::COMMAND_setIndexBuffer:
+                isRedundant = indexBuffer.setAgain(getCached<BufferPointer>(batch._buffers, params[offset + 1]._uint),
+                    params[offset + 0]._uint, params[offset + 2]._uint);
+                break;
+
+            case Batch::COMMAND_setUniformBuffer: {
+                uint32 slot = params[offset + 3]._uint;
+                if (slot < uniformBuffers.size()) {
+                    isRedundant = uniformBuffers[slot].setAgain(getCached<BufferPointer>(batch._buffers, params[offset + 2]._uint),
+                        params[offset + 1]._uint, params[offset + 0]._uint);
+                }
+                break;
+            }
+
+            case Batch::COMMAND_setResourceTexture: {
+                uint32 slot = params[offset + 1]._uint;
+                if (slot < resourceTextures.size()) {
+                    isRedundant = resourceTextures[slot].setAgain(getCached<TexturePointer>(batch._textures, params[offset + 0]._uint));
+                }
+                break;
+            }
+
+            // these bind textures behind the back of the resource stage
+            case Batch::COMMAND_glActiveBindTexture:
+                resetCommandStates(resourceTextures);
+                break;
+
+            // anything can have happened after these
+            case Batch::COMMAND_resetStages:
+            case Batch::COMMAND_runLambda:
+                pipeline.isSet = false;
+                inputFormat.isSet = false;
+                indexBuffer.isSet = false;
+                resetCommandStates(inputBuffers);
+                resetCommandStates(uniformBuffers);
+                resetCommandStates(resourceTextures);
+                break;
+
+            default:
+                break;
+        }
+
+        if (!isRedundant) {
+            commands[kept] = commands[i];
+            offsets[kept] = offset;
+            kept++;
+        }
+    }
+    commands.resize(kept);
+    offsets.resize(kept);
 }
 
 void GLBackend::renderPassTransfer(Batch& batch) {
@@ -217,12 +353,23 @@ void GLBackend::renderPassDraw(Batch& batch) {
             case Batch::COMMAND_multiDrawIndexedIndirect: {
                 // updates for draw calls
                 ++_currentDraw;
+                bool stereoInstanced = isStereoInstanced(*command);
+                updateStereoTransform(stereoInstanced);
                 updateInput();
                 updateTransform(batch);
                 updatePipeline();
+                updateResource();
                 
                 CommandCall call = _commandCalls[(*command)];
-                (this->*(call))(batch, *offset);
+                if (_stereo._enable && !stereoInstanced) {
+                    for (int eye = 0; eye < 2; ++eye) {
+                        updateStereoEye(eye);
+                        (this->*(call))(batch, *offset);
+                    }
+                    updateStereoEye(-1);
+                } else {
+                    (this->*(call))(batch, *offset);
+                }
                 break;
             }
             default: {
@@ -240,6 +387,7 @@ void GLBackend::renderPassDraw(Batch& batch) {
 void GLBackend::render(Batch& batch) {
     // Finalize the batch by moving all the instanced rendering into the command buffer
     batch.preExecute();
+    stripRedundantCommands(batch);
 
     _stereo._skybox = batch.isSkyboxEnabled();
     // Allow the batch to override the rendering stereo settings
@@ -255,15 +403,9 @@ void GLBackend::render(Batch& batch) {
     }
 
     {
-        PROFILE_RANGE(_stereo._enable ? "LeftRender" : "Render");
-        renderPassDraw(batch);
-    }
-
-    if (_stereo._enable) {
-        PROFILE_RANGE("RightRender");
-        _stereo._pass = 1;
+        // Both eyes are rendered in the one pass
+        PROFILE_RANGE(_stereo._enable ? "StereoRender" : "Render");
         renderPassDraw(batch);
-        _stereo._pass = 0;
     }
 
     // Restore the saved stereo state for the next batch
@@ -303,6 +445,10 @@ bool GLBackend::checkGLError(const char* name) {
     }
 }
 
+bool GLBackend::isDirectStateAccessSupported() {
+    return GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access;
+}
+
 bool GLBackend::checkGLErrorDebug(const char* name) {
 #ifdef DEBUG
     return checkGLError(name);
@@ -326,7 +472,11 @@ void GLBackend::do_draw(Batch& batch, size_t paramOffset) {
     GLenum mode = _primitiveToGLmode[primitiveType];
     uint32 numVertices = batch._params[paramOffset + 1]._uint;
     uint32 startVertex = batch._params[paramOffset + 0]._uint;
-    glDrawArrays(mode, startVertex, numVertices);
+    if (_transform._stereoInstanced) {
+        glDrawArraysInstancedARB(mode, startVertex, numVertices, 2);
+    } else {
+        glDrawArrays(mode, startVertex, numVertices);
+    }
     (void) CHECK_GL_ERROR();
 }
 
@@ -341,12 +491,16 @@ void GLBackend::do_drawIndexed(Batch& batch, size_t paramOffset) {
     auto typeByteSize = TYPE_SIZE[_input._indexBufferType];
     GLvoid* indexBufferByteOffset = reinterpret_cast<GLvoid*>(startIndex * typeByteSize + _input._indexBufferOffset);
 
-    glDrawElements(mode, numIndices, glType, indexBufferByteOffset);
+    if (_transform._stereoInstanced) {
+        glDrawElementsInstanced(mode, numIndices, glType, indexBufferByteOffset, 2);
+    } else {
+        glDrawElements(mode, numIndices, glType, indexBufferByteOffset);
+    }
     (void) CHECK_GL_ERROR();
 }
 
 void GLBackend::do_drawInstanced(Batch& batch, size_t paramOffset) {
-    GLint numInstances = batch._params[paramOffset + 4]._uint;
+    GLint numInstances = batch._params[paramOffset + 4]._uint * (_transform._stereoInstanced ? 2 : 1);
     Primitive primitiveType = (Primitive)batch._params[paramOffset + 3]._uint;
     GLenum mode = _primitiveToGLmode[primitiveType];
     uint32 numVertices = batch._params[paramOffset + 2]._uint;
@@ -357,7 +511,7 @@ void GLBackend::do_drawInstanced(Batch& batch, size_t paramOffset) {
 }
 
 void GLBackend::do_drawIndexedInstanced(Batch& batch, size_t paramOffset) {
-    GLint numInstances = batch._params[paramOffset + 4]._uint;
+    GLint numInstances = batch._params[paramOffset + 4]._uint * (_transform._stereoInstanced ? 2 : 1);
     GLenum mode = _primitiveToGLmode[(Primitive)batch._params[paramOffset + 3]._uint];
     uint32 numIndices = batch._params[paramOffset + 2]._uint;
     uint32 startIndex = batch._params[paramOffset + 1]._uint;
@@ -458,6 +612,9 @@ void Batch::_glActiveBindTexture(GLenum unit, GLenum target, GLuint texture) {
     DO_IT_NOW(_glActiveBindTexture, 3);
 }
 void GLBackend::do_glActiveBindTexture(Batch& batch, size_t paramOffset) {
+    // the unit was released just before, that has to happen first
+    updateResource();
+
     glActiveTexture(batch._params[paramOffset + 2]._uint);
     glBindTexture(
         batch._params[paramOffset + 1]._uint,
@@ -12,18 +12,25 @@
 #define hifi_gpu_GLBackend_h
 
 #include <assert.h>
+#include <algorithm>
 #include <functional>
 #include <bitset>
 #include <queue>
 #include <utility>
 #include <list>
+#include <memory>
+#include <vector>
 
 #include <gl/Config.h>
 
 #include "Context.h"
+#include "GLStreamBuffer.h"
 
 namespace gpu {
 
+class GLTextureTransferState;
+class GLTextureTransferHelper;
+
 class GLBackend : public Backend {
 
     // Context Backend static interface required
@@ -57,6 +64,9 @@ public:
 
     static void checkGLStackStable(std::function<void()> f);
 
+    // GL 4.5 or ARB_direct_state_access, objects get edited by name instead of being bound to edit them
+    static bool isDirectStateAccessSupported();
+
     
 
     class GLBuffer : public GPUObject {
@@ -79,6 +89,19 @@ public:
         GLenum _target;
         GLuint _size;
 
+        // set while the pixels are uploaded on the transfer thread
+        std::shared_ptr<GLTextureTransferState> _transferState;
+
+        // mip streaming, see Texture::isStreamable()
+        bool _isStreamed { false };
+        uint16 _minResidentMip { 0 }; // the finest mip on the GPU
+        uint16 _initialResidentMip { 0 }; // the finest mip of the first upload, which never leaves
+        uint16 _requestedMip { 0 };
+        uint64_t _lastMipRequest { 0 };
+        uint16 _samplerMipOffset { 0 };
+        std::vector<GLuint> _mipSizes; // what each mip takes on the GPU, or is expected to while it uploads
+        std::shared_ptr<GLTextureTransferState> _streamState; // set while the next finer mip uploads
+
         GLTexture();
         ~GLTexture();
     };
@@ -96,6 +119,12 @@ public:
         GLint _transformCameraSlot = -1;
         GLint _transformObjectSlot = -1;
 
+        // the eye and the instanced stereo switch of Transform.slh, with their current values in the program
+        GLint _transformCameraEyeLocation = -1;
+        GLint _transformStereoInstancedLocation = -1;
+        GLint _transformCameraEye = 0;
+        GLint _transformStereoInstanced = 0;
+
         GLShader();
         ~GLShader();
     };
@@ -242,9 +271,15 @@ public:
     void getStats(Stats& stats) const { stats = _stats; }
 
 protected:
+    // uploads the pixels of new textures away from the rendering context, unset when there is no context to do it on
+    static std::shared_ptr<GLTextureTransferHelper> _textureTransferHelper;
+
     void renderPassTransfer(Batch& batch);
     void renderPassDraw(Batch& batch);
 
+    // removes the state commands that set what the commands before them already set
+    void stripRedundantCommands(Batch& batch);
+
     Stats _stats;
 
     // Draw Stage
@@ -283,6 +318,9 @@ protected:
 
         glm::vec4 _colorAttribute{ 0.0f };
 
+        // the instanced attributes step every other instance when the draws are instanced in stereo
+        GLuint _divisorScale { 1 };
+
         BufferPointer _indexBuffer;
         Offset _indexBufferOffset;
         Type _indexBufferType;
@@ -323,6 +361,12 @@ protected:
     void updateTransform(const Batch& batch);
     void resetTransformStage();
 
+    // In stereo the draws of the programs placing their vertices with the clip macros of Transform.slh are instanced
+    // twice, the parity of the instance picking the eye, the other draws are made once per eye
+    bool isStereoInstanced(Batch::Command command) const;
+    void updateStereoTransform(bool instanced);
+    void updateStereoEye(int eye);
+
     struct TransformStageState {
         using TransformCameras = std::vector<TransformCamera>;
 
@@ -331,11 +375,16 @@ protected:
 
         mutable std::map<std::string, GLvoid*> _drawCallInfoOffsets;
 
-        GLuint _objectBuffer { 0 };
-        GLuint _cameraBuffer { 0 };
-        GLuint _drawCallInfoBuffer { 0 };
+        // rewritten for every batch, each batch's data is where the last write to the stream put it
+        mutable GLStreamBuffer _objectBuffer;
+        mutable GLStreamBuffer _cameraBuffer;
+        mutable GLStreamBuffer _drawCallInfoBuffer;
+        mutable size_t _objectBufferOffset { 0 };
+        mutable size_t _objectBufferSize { 0 };
+        mutable size_t _cameraBufferOffset { 0 };
         GLuint _objectBufferTexture { 0 };
         size_t _cameraUboSize { 0 };
+        size_t _objectBufferAlignment { 1 };
         Transform _view;
         Mat4 _projection;
         Vec4i _viewport { 0, 0, 1, 1 };
@@ -343,6 +392,7 @@ protected:
         bool _invalidView { false };
         bool _invalidProj { false };
         bool _invalidViewport { false };
+        bool _stereoInstanced { false };
 
         using Pair = std::pair<size_t, size_t>;
         using List = std::list<Pair>;
@@ -364,9 +414,14 @@ protected:
     void resetUniformStage();
     struct UniformStageState {
         Buffers _buffers;
+        // the ranges bound, several slots of one buffer can be bound at different offsets
+        std::vector<GLintptr> _offsets;
+        std::vector<GLsizeiptr> _sizes;
 
         UniformStageState():
-            _buffers(MAX_NUM_UNIFORM_BUFFERS, nullptr)
+            _buffers(MAX_NUM_UNIFORM_BUFFERS, nullptr),
+            _offsets(MAX_NUM_UNIFORM_BUFFERS, 0),
+            _sizes(MAX_NUM_UNIFORM_BUFFERS, 0)
         {}
     } _uniform;
     
@@ -377,13 +432,36 @@ protected:
     void releaseResourceTexture(uint32_t slot);
 
     void resetResourceStage();
+
+    // binds the textures set since the last draw, all at once where a run of units changed
+    void updateResource();
+
     struct ResourceStageState {
         Textures _textures;
 
+        // the texture of each unit as set and as bound
+        std::vector<GLuint> _names;
+        std::vector<GLenum> _targets;
+        std::vector<GLuint> _boundNames;
+        std::vector<GLenum> _boundTargets;
+        uint32_t _dirtyBegin { MAX_NUM_RESOURCE_TEXTURES };
+        uint32_t _dirtyEnd { 0 };
+
         int findEmptyTextureSlot() const;
 
+        void set(uint32_t slot, GLuint name, GLenum target) {
+            _names[slot] = name;
+            _targets[slot] = target;
+            _dirtyBegin = std::min(_dirtyBegin, slot);
+            _dirtyEnd = std::max(_dirtyEnd, slot + 1);
+        }
+
         ResourceStageState():
-            _textures(MAX_NUM_RESOURCE_TEXTURES, nullptr)
+            _textures(MAX_NUM_RESOURCE_TEXTURES, nullptr),
+            _names(MAX_NUM_RESOURCE_TEXTURES, 0),
+            _targets(MAX_NUM_RESOURCE_TEXTURES, 0),
+            _boundNames(MAX_NUM_RESOURCE_TEXTURES, 0),
+            _boundTargets(MAX_NUM_RESOURCE_TEXTURES, 0)
         {}
 
     } _resource;
@@ -409,8 +487,12 @@ protected:
         PipelinePointer _pipeline;
 
         GLuint _program;
+        GLShader* _programShader { nullptr };
         bool _invalidProgram;
 
+        // the scissor of the whole stereo viewport, halved for the draws made once per eye
+        Vec4i _scissorRect { 0, 0, 1, 1 };
+
         State::Data _stateCache;
         State::Signature _stateSignatureCache;
 
@@ -32,22 +32,40 @@ GLBackend::GLBuffer* GLBackend::syncGPUObject(const Buffer& buffer) {
     }
 
     // need to have a gpu object?
-    if (!object) {
+    bool isNew = !object;
+    bool directStateAccess = isDirectStateAccessSupported();
+    if (isNew) {
         object = new GLBuffer();
-        glGenBuffers(1, &object->_buffer);
+        if (directStateAccess) {
+            glCreateBuffers(1, &object->_buffer);
+        } else {
+            glGenBuffers(1, &object->_buffer);
+        }
         (void) CHECK_GL_ERROR();
         Backend::setGPUObject(buffer, object);
     }
 
-    // Now let's update the content of the bo with the sysmem version
-    // TODO: in the future, be smarter about when to actually upload the glBO version based on the data that did change
-    //if () {
-    glBindBuffer(GL_ARRAY_BUFFER, object->_buffer);
-    glBufferData(GL_ARRAY_BUFFER, buffer.getSysmem().getSize(), buffer.getSysmem().readData(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // Only the bytes set since the last sync go up, unless the size changed and the storage has to be specified again
+    GLuint size = (GLuint)buffer.getSysmem().getSize();
+    Buffer::Size dirtyOffset, dirtySize;
+    bool isDirty = buffer.takeDirtyRange(dirtyOffset, dirtySize);
+    if (directStateAccess) {
+        if (isNew || object->_size != size) {
+            glNamedBufferData(object->_buffer, size, buffer.getSysmem().readData(), GL_DYNAMIC_DRAW);
+        } else if (isDirty) {
+            glNamedBufferSubData(object->_buffer, dirtyOffset, dirtySize, buffer.getSysmem().readData() + dirtyOffset);
+        }
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, object->_buffer);
+        if (isNew || object->_size != size) {
+            glBufferData(GL_ARRAY_BUFFER, size, buffer.getSysmem().readData(), GL_DYNAMIC_DRAW);
+        } else if (isDirty) {
+            glBufferSubData(GL_ARRAY_BUFFER, dirtyOffset, dirtySize, buffer.getSysmem().readData() + dirtyOffset);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
     object->_stamp = buffer.getSysmem().getStamp();
-    object->_size = (GLuint)buffer.getSysmem().getSize();
-    //}
+    object->_size = size;
     (void) CHECK_GL_ERROR();
 
     return object;
@@ -69,6 +69,7 @@ void GLBackend::do_setPipeline(Batch& batch, size_t paramOffset) {
         _pipeline._pipeline.reset();
 
         _pipeline._program = 0;
+        _pipeline._programShader = nullptr;
         _pipeline._invalidProgram = true;
 
         _pipeline._state = nullptr;
@@ -82,6 +83,7 @@ void GLBackend::do_setPipeline(Batch& batch, size_t paramOffset) {
         // check the program cache
         if (_pipeline._program != pipelineObject->_program->_program) {
             _pipeline._program = pipelineObject->_program->_program;
+            _pipeline._programShader = pipelineObject->_program;
             _pipeline._invalidProgram = true;
         }
 
@@ -142,6 +144,7 @@ void GLBackend::resetPipelineStage() {
     // Second the shader side
     _pipeline._invalidProgram = false;
     _pipeline._program = 0;
+    _pipeline._programShader = nullptr;
     _pipeline._pipeline.reset();
     glUseProgram(0);
 }
@@ -184,7 +187,7 @@ void GLBackend::do_setUniformBuffer(Batch& batch, size_t paramOffset) {
     }
     
     // check cache before thinking
-    if (_uniform._buffers[slot] == uniformBuffer) {
+    if (_uniform._buffers[slot] == uniformBuffer && _uniform._offsets[slot] == rangeStart && _uniform._sizes[slot] == rangeSize) {
         return;
     }
 
@@ -194,6 +197,8 @@ void GLBackend::do_setUniformBuffer(Batch& batch, size_t paramOffset) {
         glBindBufferRange(GL_UNIFORM_BUFFER, slot, object->_buffer, rangeStart, rangeSize);
 
         _uniform._buffers[slot] = uniformBuffer;
+        _uniform._offsets[slot] = rangeStart;
+        _uniform._sizes[slot] = rangeSize;
         (void) CHECK_GL_ERROR();
     } else {
         releaseResourceTexture(slot);
@@ -219,14 +224,7 @@ void GLBackend::do_setUniformBuffer(Batch& batch, size_t paramOffset) {
 void GLBackend::releaseResourceTexture(uint32_t slot) {
     auto& tex = _resource._textures[slot];
     if (tex) {
-        auto* object = Backend::getGPUObject<GLBackend::GLTexture>(*tex);
-        if (object) {
-            GLuint target = object->_target;
-            glActiveTexture(GL_TEXTURE0 + slot);
-            glBindTexture(target, 0); // RELEASE
-
-            (void) CHECK_GL_ERROR();
-        }
+        _resource.set(slot, 0, _resource._targets[slot]); // RELEASE
         tex.reset();
     }
 }
@@ -236,6 +234,50 @@ void GLBackend::resetResourceStage() {
     for (uint32_t i = 0; i < _resource._textures.size(); i++) {
         releaseResourceTexture(i);
     }
+    updateResource();
+}
+
+void GLBackend::updateResource() {
+    if (_resource._dirtyBegin >= _resource._dirtyEnd) {
+        return;
+    }
+
+    // only the units that changed get bound, the ones in between can hold textures bound behind the back of the stage
+    static const bool multiBind = GLEW_VERSION_4_4 || GLEW_ARB_multi_bind;
+    uint32_t slot = _resource._dirtyBegin;
+    while (slot < _resource._dirtyEnd) {
+        if (_resource._names[slot] == _resource._boundNames[slot] && _resource._targets[slot] == _resource._boundTargets[slot]) {
+            slot++;
+            continue;
+        }
+        uint32_t end = slot + 1;
+        while (end < _resource._dirtyEnd && (_resource._names[end] != _resource._boundNames[end] ||
+                _resource._targets[end] != _resource._boundTargets[end])) {
+            end++;
+        }
+
+        if (multiBind) {
+            // binding a name replaces the texture of its target, binding 0 releases all of them
+            glBindTextures(slot, end - slot, _resource._names.data() + slot);
+        } else {
+            for (uint32_t i = slot; i < end; i++) {
+                glActiveTexture(GL_TEXTURE0 + i);
+                if (_resource._boundNames[i] && _resource._boundTargets[i] != _resource._targets[i]) {
+                    glBindTexture(_resource._boundTargets[i], 0);
+                }
+                glBindTexture(_resource._targets[i], _resource._names[i]);
+            }
+        }
+        for (uint32_t i = slot; i < end; i++) {
+            _resource._boundNames[i] = _resource._names[i];
+            _resource._boundTargets[i] = _resource._targets[i];
+        }
+        slot = end;
+    }
+    _resource._dirtyBegin = MAX_NUM_RESOURCE_TEXTURES;
+    _resource._dirtyEnd = 0;
+
+    (void) CHECK_GL_ERROR();
 }
 
 void GLBackend::do_setResourceTexture(Batch& batch, size_t paramOffset) {
@@ -254,13 +296,8 @@ void GLBackend::do_setResourceTexture(Batch& batch, size_t paramOffset) {
     // Always make sure the GLObject is in sync
     GLTexture* object = GLBackend::syncGPUObject(*resourceTexture);
     if (object) {
-        GLuint to = object->_texture;
-        GLuint target = object->_target;
-        glActiveTexture(GL_TEXTURE0 + slot);
-        glBindTexture(target, to);
-
-        (void) CHECK_GL_ERROR();
-
+        // bound with the other textures of the draw
+        _resource.set(slot, object->_texture, object->_target);
         _resource._textures[slot] = resourceTexture;
 
     } else {
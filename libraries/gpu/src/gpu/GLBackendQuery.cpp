@@ -60,16 +60,27 @@ GLuint GLBackend::getQueryID(const QueryPointer& query) {
     }
 }
 
+static GLenum getQueryTarget(const Query& query) {
+    if (query.getType() == Query::ANY_SAMPLES_PASSED) {
+        #if (GPU_FEATURE_PROFILE == GPU_LEGACY)
+            return GL_SAMPLES_PASSED;
+        #else
+            return GL_ANY_SAMPLES_PASSED;
+        #endif
+    }
+    #if (GPU_FEATURE_PROFILE == GPU_LEGACY)
+        // (EXT_TIMER_QUERY)
+        return GL_TIME_ELAPSED_EXT;
+    #else
+        return GL_TIME_ELAPSED;
+    #endif
+}
+
 void GLBackend::do_beginQuery(Batch& batch, size_t paramOffset) {
     auto query = batch._queries.get(batch._params[paramOffset]._uint);
     GLQuery* glquery = syncGPUObject(*query);
     if (glquery) {
-        #if (GPU_FEATURE_PROFILE == GPU_LEGACY)
-            // (EXT_TIMER_QUERY)
-            glBeginQuery(GL_TIME_ELAPSED_EXT, glquery->_qo);
-        #else
-            glBeginQuery(GL_TIME_ELAPSED, glquery->_qo);
-        #endif
+        glBeginQuery(getQueryTarget(*query), glquery->_qo);
         (void)CHECK_GL_ERROR();
     }
 }
@@ -78,12 +89,7 @@ void GLBackend::do_endQuery(Batch& batch, size_t paramOffset) {
     auto query = batch._queries.get(batch._params[paramOffset]._uint);
     GLQuery* glquery = syncGPUObject(*query);
     if (glquery) {
-        #if (GPU_FEATURE_PROFILE == GPU_LEGACY)
-            // (EXT_TIMER_QUERY)
-            glEndQuery(GL_TIME_ELAPSED_EXT);
-        #else
-            glEndQuery(GL_TIME_ELAPSED);
-        #endif
+        glEndQuery(getQueryTarget(*query));
         (void)CHECK_GL_ERROR();
     }
 }
@@ -11,8 +11,26 @@
 #include "GLBackendShared.h"
 #include "Format.h"
 
+#include <cstring>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
 using namespace gpu;
 
+// linked programs are kept here by the sources of their shaders and the driver, so that the next run skips compiling them
+static const QString PROGRAM_BINARY_EXTENSION = ".glprogram";
+
+// goes up when the bindings made after linking change, which the sources don't show
+static const QByteArray PROGRAM_BINARY_VERSION = "1";
+
+static QString getProgramBinariesDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/shaders";
+}
+
 GLBackend::GLShader::GLShader() :
     _shader(0),
     _program(0)
@@ -27,6 +45,8 @@ GLBackend::GLShader::~GLShader() {
     }
 }
 
+void makeBlockBindings(GLBackend::GLShader* shader);
+
 void makeBindings(GLBackend::GLShader* shader) {
     if(!shader || !shader->_program) {
         return;
@@ -90,6 +110,13 @@ void makeBindings(GLBackend::GLShader* shader) {
     }
 
     // now assign the ubo binding, then DON't relink!
+    makeBlockBindings(shader);
+}
+
+// the bindings that aren't part of the linked program, a program loaded from its binary needs them again
+void makeBlockBindings(GLBackend::GLShader* shader) {
+    GLuint glprogram = shader->_program;
+    GLint loc = -1;
 
     //Check for gpu specific uniform slotBindings
 #ifdef GPU_SSBO_DRAW_CALL_INFO
@@ -112,6 +139,9 @@ void makeBindings(GLBackend::GLShader* shader) {
         shader->_transformCameraSlot = gpu::TRANSFORM_CAMERA_SLOT;
     }
 
+    shader->_transformCameraEyeLocation = glGetUniformLocation(glprogram, "transformCameraEye");
+    shader->_transformStereoInstancedLocation = glGetUniformLocation(glprogram, "transformStereoInstanced");
+
     (void)CHECK_GL_ERROR();
 }
 
@@ -239,11 +269,106 @@ GLBackend::GLShader* compileShader(const Shader& shader) {
     return object;
 }
 
+static bool isProgramBinarySupported() {
+    static const bool supported = [] {
+        if (!(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)) {
+            return false;
+        }
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        return numFormats > 0;
+    }();
+    return supported;
+}
+
+static QString getProgramBinaryPath(const Shader& program) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(PROGRAM_BINARY_VERSION);
+    hash.addData(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    hash.addData(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    hash.addData(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    for (auto subShader : program.getShaders()) {
+        const std::string& source = subShader->getSource().getCode();
+        hash.addData(QByteArray::number((int)subShader->getType()) + " " + QByteArray::number((qulonglong)source.size()) + " ");
+        hash.addData(source.data(), (int)source.size());
+    }
+    return getProgramBinariesDirectory() + "/" + hash.result().toHex() + PROGRAM_BINARY_EXTENSION;
+}
+
+// the file is the binary format followed by the binary, returns 0 if there is none the driver takes
+static GLuint loadProgramBinary(const QString& binaryPath) {
+    QFile binaryFile { binaryPath };
+    if (!binaryFile.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    QByteArray binary = binaryFile.readAll();
+    if (binary.size() <= (int)sizeof(GLenum)) {
+        return 0;
+    }
+    GLenum format;
+    memcpy(&format, binary.constData(), sizeof(GLenum));
+
+    GLuint glprogram = glCreateProgram();
+    if (!glprogram) {
+        return 0;
+    }
+    glProgramBinary(glprogram, format, binary.constData() + sizeof(GLenum), binary.size() - (GLsizei)sizeof(GLenum));
+
+    // a driver update can turn down the binaries of the one before
+    GLint linked = 0;
+    glGetProgramiv(glprogram, GL_LINK_STATUS, &linked);
+    glGetError();
+    if (!linked) {
+        glDeleteProgram(glprogram);
+        binaryFile.close();
+        binaryFile.remove();
+        return 0;
+    }
+    return glprogram;
+}
+
+static void saveProgramBinary(GLuint glprogram, const QString& binaryPath) {
+    GLint length = 0;
+    glGetProgramiv(glprogram, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    QByteArray binary(length + (int)sizeof(GLenum), 0);
+    GLenum format = 0;
+    glGetProgramBinary(glprogram, length, nullptr, &format, binary.data() + sizeof(GLenum));
+    if (glGetError() != GL_NO_ERROR) {
+        return;
+    }
+    memcpy(binary.data(), &format, sizeof(GLenum));
+
+    QSaveFile binaryFile { binaryPath };
+    if (QDir().mkpath(getProgramBinariesDirectory()) && binaryFile.open(QIODevice::WriteOnly)) {
+        binaryFile.write(binary);
+        binaryFile.commit();
+    }
+}
+
 GLBackend::GLShader* compileProgram(const Shader& program) {
     if(!program.isProgram()) {
         return nullptr;
     }
 
+    // a program linked in a run before needs none of its shaders compiled
+    QString binaryPath;
+    if (isProgramBinarySupported()) {
+        binaryPath = getProgramBinaryPath(program);
+        GLuint glprogram = loadProgramBinary(binaryPath);
+        if (glprogram) {
+            GLBackend::GLShader* object = new GLBackend::GLShader();
+            object->_shader = 0;
+            object->_program = glprogram;
+
+            makeBlockBindings(object);
+
+            return object;
+        }
+    }
+
     // Let's go through every shaders and make sure they are ready to go
     std::vector< GLuint > shaderObjects;
     for (auto subShader : program.getShaders()) {
@@ -262,7 +387,10 @@ GLBackend::GLShader* compileProgram(const Shader& program) {
         return nullptr;
     }
 
-    // glProgramParameteri(glprogram, GL_PROGRAM_, GL_TRUE);
+    if (!binaryPath.isEmpty()) {
+        glProgramParameteri(glprogram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     // Create the program from the sub shaders
     for (auto so : shaderObjects) {
         glAttachShader(glprogram, so);
@@ -314,6 +442,10 @@ GLBackend::GLShader* compileProgram(const Shader& program) {
 
     makeBindings(object);
 
+    if (!binaryPath.isEmpty()) {
+        saveProgramBinary(glprogram, binaryPath);
+    }
+
     return object;
 }
 
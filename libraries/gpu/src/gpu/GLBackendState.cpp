@@ -497,6 +497,8 @@ void GLBackend::syncPipelineStateCache() {
 
     _pipeline._stateCache = state;
     _pipeline._stateSignatureCache = signature;
+
+    glGetIntegerv(GL_SCISSOR_BOX, (GLint*) &_pipeline._scissorRect);
 }
 
 static GLenum GL_COMPARISON_FUNCTIONS[] = {
@@ -778,12 +780,7 @@ void GLBackend::do_setStateScissorRect(Batch& batch, size_t paramOffset) {
     Vec4i rect;
     memcpy(&rect, batch.editData(batch._params[paramOffset]._uint), sizeof(Vec4i));
 
-    if (_stereo._enable) {
-        rect.z /= 2;
-        if (_stereo._pass) {
-            rect.x += rect.z;
-        }
-    }
+    _pipeline._scissorRect = rect;
     glScissor(rect.x, rect.y, rect.z, rect.w);
     (void) CHECK_GL_ERROR();
 }
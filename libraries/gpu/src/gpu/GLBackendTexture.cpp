@@ -10,9 +10,35 @@
 //
 #include "GPULogging.h"
 #include "GLBackendShared.h"
+#include "GLTextureTransfer.h"
+
+#include <mutex>
+#include <unordered_set>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 using namespace gpu;
 
+std::shared_ptr<GLTextureTransferHelper> GLBackend::_textureTransferHelper;
+
+// the streamed textures, and what their mips take on the GPU all together
+static std::mutex streamedTexturesMutex;
+static std::unordered_set<GLBackend::GLTexture*> streamedTextures;
+static uint64_t streamedTexturesSize = 0;
+
+static void registerStreamedTexture(GLBackend::GLTexture* object) {
+    std::lock_guard<std::mutex> lock(streamedTexturesMutex);
+    streamedTextures.insert(object);
+}
+
+static void unregisterStreamedTexture(GLBackend::GLTexture* object) {
+    std::lock_guard<std::mutex> lock(streamedTexturesMutex);
+    if (streamedTextures.erase(object)) {
+        streamedTexturesSize -= object->_size;
+    }
+}
+
 GLBackend::GLTexture::GLTexture() :
     _storageStamp(0),
     _contentStamp(0),
@@ -22,11 +48,48 @@ GLBackend::GLTexture::GLTexture() :
 {}
 
 GLBackend::GLTexture::~GLTexture() {
+    if (_isStreamed) {
+        unregisterStreamedTexture(this);
+    }
+
+    auto& pendingState = _transferState ? _transferState : _streamState;
+    if (pendingState) {
+        int pending = GLTextureTransferState::PENDING;
+        if (pendingState->_state.compare_exchange_strong(pending, GLTextureTransferState::ABANDONED)) {
+            // the transfer thread deletes the texture once it is done with it
+            return;
+        }
+        if (pendingState->_fence) {
+            glDeleteSync(pendingState->_fence);
+        }
+    }
     if (_texture != 0) {
         glDeleteTextures(1, &_texture);
     }
 }
 
+// the driver encodes the block compressed formats as the pixels are uploaded, BC1 for RGB and BC3 for RGBA
+static bool isS3TCSupported() {
+    static const bool supported = GLEW_EXT_texture_compression_s3tc && GLEW_EXT_texture_sRGB;
+    return supported;
+}
+
+// what the texture takes in GPU memory, which is less than its texel format says when the driver compressed it
+static GLuint evalGLTextureSize(const Texture& texture, GLenum target) {
+    GLint isCompressed = GL_FALSE;
+    glGetTexLevelParameteriv(target, 0, GL_TEXTURE_COMPRESSED, &isCompressed);
+    if (!isCompressed) {
+        return (GLuint)texture.getSize();
+    }
+
+    GLint compressedSize = 0;
+    glGetTexLevelParameteriv(target, 0, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+
+    // the smaller mips add up to a third of the first one
+    const int MIPS_SIZE_DIVISOR = 3;
+    return (GLuint)(texture.maxMip() > 0 ? compressedSize + compressedSize / MIPS_SIZE_DIVISOR : compressedSize);
+}
+
 class GLTexelFormat {
 public:
     GLenum internalFormat;
@@ -291,6 +354,12 @@ public:
                     texel.internalFormat = GL_R11F_G11F_B10F;
                     break;
                 }
+                case gpu::COMPRESSED_RGB:
+                    texel.internalFormat = isS3TCSupported() ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_RGB;
+                    break;
+                case gpu::COMPRESSED_SRGB:
+                    texel.internalFormat = isS3TCSupported() ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_SRGB;
+                    break;
                 default:
                     qCDebug(gpulogging) << "Unknown combination of texel format";
                 }
@@ -367,6 +436,12 @@ public:
                 case gpu::SRGBA:
                     texel.internalFormat = GL_SRGB_ALPHA; // standard 2.2 gamma correction color
                     break;
+                case gpu::COMPRESSED_RGBA:
+                    texel.internalFormat = isS3TCSupported() ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_RGBA;
+                    break;
+                case gpu::COMPRESSED_SRGBA:
+                    texel.internalFormat = isS3TCSupported() ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_SRGB_ALPHA;
+                    break;
                 default:
                     qCDebug(gpulogging) << "Unknown combination of texel format";
                 }
@@ -382,15 +457,203 @@ public:
 };
 
 
+static GLTextureTransferPackage::Mip evalTransferMip(const Texture& texture, uint16 level) {
+    Texture::PixelsPointer mip = texture.accessStoredMipFace(level);
+    GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(texture.getTexelFormat(), mip->_format);
+    return { level, (GLsizei)texture.evalMipWidth(level), (GLsizei)texture.evalMipHeight(level),
+        texelFormat.internalFormat, texelFormat.format, texelFormat.type, mip };
+}
+
+static void uploadMip(const GLTextureTransferPackage::Mip& mip) {
+    glTexImage2D(GL_TEXTURE_2D, mip._level, mip._internalFormat, mip._width, mip._height, 0,
+        mip._format, mip._type, mip._pixels->_sysmem.read<Byte>());
+}
+
+// what a mip of the bound 2D texture takes in GPU memory
+static GLuint evalGLMipSize(const Texture& texture, uint16 level) {
+    GLint isCompressed = GL_FALSE;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &isCompressed);
+    if (!isCompressed) {
+        return (GLuint)texture.evalMipSize(level);
+    }
+
+    GLint compressedSize = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+    return (GLuint)compressedSize;
+}
+
+// Mip streaming
+
+// the longest side of the finest mip a streamed texture starts with
+static const uint16 INITIAL_STREAMED_MIP_SIZE = 128;
+// how long the renderers can go without asking for the mips of a texture before it gives them up to others
+static const uint64_t MIP_REQUEST_TIMEOUT_USECS = USECS_PER_SECOND;
+
+static GLint evalBaseLevel(const GLBackend::GLTexture* object) {
+    return std::max(object->_samplerMipOffset, object->_minResidentMip);
+}
+
+// the mips of the bound texture from fromLevel to toLevel are on the GPU, they can be sampled from now on
+static void finishStreamedMips(const Texture& texture, GLBackend::GLTexture* object, uint16 fromLevel, uint16 toLevel) {
+    std::lock_guard<std::mutex> lock(streamedTexturesMutex);
+    for (uint16 level = fromLevel; level <= toLevel; level++) {
+        GLuint size = evalGLMipSize(texture, level);
+        int64_t sizeChange = (int64_t)size - (int64_t)object->_mipSizes[level];
+        streamedTexturesSize += sizeChange;
+        object->_size += (GLint)sizeChange;
+        object->_mipSizes[level] = size;
+    }
+    object->_minResidentMip = std::min(object->_minResidentMip, fromLevel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, evalBaseLevel(object));
+}
+
+// needs streamedTexturesMutex locked
+static void dropStreamedMip(GLBackend::GLTexture* object) {
+    uint16 level = object->_minResidentMip++;
+
+    glBindTexture(GL_TEXTURE_2D, object->_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, evalBaseLevel(object));
+    // an empty image gives the memory of the mip back
+    glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    streamedTexturesSize -= object->_mipSizes[level];
+    object->_size -= object->_mipSizes[level];
+    object->_mipSizes[level] = 0;
+}
+
+// Makes room in the budget for a mip of the texture, taking the finest mips of the textures the renderers asked nothing of
+// for the longest. Returns false if there is no room to be made.
+static bool reserveStreamedMip(GLBackend::GLTexture* object, uint16 level, GLuint size, uint64_t now) {
+    std::lock_guard<std::mutex> lock(streamedTexturesMutex);
+
+    uint64_t budget = Texture::getMipStreamingBudget();
+    while (streamedTexturesSize + size > budget) {
+        GLBackend::GLTexture* victim = nullptr;
+        for (auto texture : streamedTextures) {
+            if (texture == object || texture->_streamState || texture->_minResidentMip >= texture->_initialResidentMip) {
+                continue;
+            }
+            bool hasUnusedMips = (now - texture->_lastMipRequest) >= MIP_REQUEST_TIMEOUT_USECS ||
+                texture->_requestedMip > texture->_minResidentMip;
+            if (hasUnusedMips && (!victim || texture->_lastMipRequest < victim->_lastMipRequest)) {
+                victim = texture;
+            }
+        }
+        if (!victim) {
+            return false;
+        }
+        dropStreamedMip(victim);
+    }
+
+    streamedTexturesSize += size;
+    object->_size += size;
+    object->_mipSizes[level] = size;
+    return true;
+}
+
+// Takes the mip the renderers asked for, and brings the next finer mip to the GPU when one is needed and fits.
+static void streamTextureMips(const Texture& texture, GLBackend::GLTexture* object, GLTextureTransferHelper* transferHelper) {
+    uint64_t now = usecTimestampNow();
+    uint16 requestedMip = texture.takeRequestedMip();
+    if (requestedMip != Texture::NO_MIP_REQUEST) {
+        object->_requestedMip = requestedMip;
+        object->_lastMipRequest = now;
+    }
+
+    GLint boundTex = -1;
+    if (object->_streamState) {
+        if (!GLTextureTransferHelper::isTransferComplete(*object->_streamState)) {
+            return;
+        }
+        object->_streamState.reset();
+
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTex);
+        glBindTexture(GL_TEXTURE_2D, object->_texture);
+        finishStreamedMips(texture, object, object->_minResidentMip - 1, object->_minResidentMip - 1);
+        glBindTexture(GL_TEXTURE_2D, boundTex);
+    }
+
+    bool isRequested = (now - object->_lastMipRequest) < MIP_REQUEST_TIMEOUT_USECS;
+    if (!isRequested || object->_requestedMip >= object->_minResidentMip ||
+            !texture.isStoredMipFaceAvailable(object->_minResidentMip - 1)) {
+        return;
+    }
+
+    // one mip at a time, each takes about four times the next coarser one
+    const GLuint NEXT_MIP_SIZE_RATIO = 4;
+    uint16 level = object->_minResidentMip - 1;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTex);
+    bool isReserved = reserveStreamedMip(object, level, object->_mipSizes[level + 1] * NEXT_MIP_SIZE_RATIO, now);
+    if (isReserved) {
+        if (transferHelper) {
+            GLTextureTransferPackage package;
+            package._texture = object->_texture;
+            package._mips.push_back(evalTransferMip(texture, level));
+            package._state = std::make_shared<GLTextureTransferState>();
+            object->_streamState = package._state;
+            transferHelper->transferTexture(package);
+        } else {
+            glBindTexture(GL_TEXTURE_2D, object->_texture);
+            uploadMip(evalTransferMip(texture, level));
+            finishStreamedMips(texture, object, level, level);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, boundTex);
+}
+
+// the pixels of the texture are on the GPU, what is left to set up is cheap and done on the rendering context
+static void finishTextureTransfer(const Texture& texture, GLBackend::GLTexture* object) {
+    GLint boundTex = -1;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTex);
+    glBindTexture(GL_TEXTURE_2D, object->_texture);
+
+    if (texture.isAutogenerateMips()) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    } else if (texture.maxMip() > 0) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.maxMip());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    }
+    GLBackend::syncSampler(texture.getSampler(), texture.getType(), object);
+
+    if (object->_isStreamed) {
+        // the stored mips stay, to stream again
+        finishStreamedMips(texture, object, object->_initialResidentMip, texture.maxMip());
+        glBindTexture(GL_TEXTURE_2D, boundTex);
+        return;
+    }
+
+    // pixels given to the texture since the transfer started are still to be uploaded, don't drop them
+    if (object->_storageStamp == texture.getStamp() && object->_contentStamp >= texture.getDataStamp()) {
+        for (uint16 level = 0; level <= texture.maxMip(); level++) {
+            texture.notifyMipFaceGPULoaded(level, 0);
+        }
+    }
+    object->_size = evalGLTextureSize(texture, GL_TEXTURE_2D);
+
+    glBindTexture(GL_TEXTURE_2D, boundTex);
+}
+
 GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
     GLTexture* object = Backend::getGPUObject<GLBackend::GLTexture>(texture);
 
+    // a texture with its pixels still on their way to the GPU can't be sampled yet
+    if (object && object->_transferState) {
+        if (!GLTextureTransferHelper::isTransferComplete(*object->_transferState)) {
+            return nullptr;
+        }
+        object->_transferState.reset();
+        finishTextureTransfer(texture, object);
+    }
+
     // If GPU object already created and in sync
     bool needUpdate = false;
     if (object && (object->_storageStamp == texture.getStamp())) {
         // If gpu object info is in sync with sysmem version
         if (object->_contentStamp >= texture.getDataStamp()) {
             // Then all good, GPU object is ready to be used
+            if (object->_isStreamed) {
+                streamTextureMips(texture, object, _textureTransferHelper.get());
+            }
             return object;
         } else {
             // Need to update the content of the GPU object from the source sysmem of the texture
@@ -459,6 +722,69 @@ GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
 
                 GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(texture.getTexelFormat(), srcFormat);
 
+                // a streamed texture starts with its coarsest mips only
+                uint16 minLevel = 0;
+                if (object->_isStreamed) {
+                    unregisterStreamedTexture(object);
+                    object->_isStreamed = false;
+                }
+                if (bytes && texture.isStreamable()) {
+                    while (minLevel < texture.maxMip() &&
+                           std::max(texture.evalMipWidth(minLevel), texture.evalMipHeight(minLevel)) > INITIAL_STREAMED_MIP_SIZE) {
+                        minLevel++;
+                    }
+                    object->_isStreamed = true;
+                    object->_minResidentMip = object->_initialResidentMip = object->_requestedMip = minLevel;
+                    object->_mipSizes.assign(texture.maxMip() + 1, 0);
+                    object->_size = 0;
+                    registerStreamedTexture(object);
+                }
+
+                if (bytes && _textureTransferHelper) {
+                    // hand the pixels over to the transfer thread, the texture gets used once they are uploaded
+                    GLTextureTransferPackage package;
+                    package._texture = object->_texture;
+                    package._generateMips = texture.isAutogenerateMips();
+
+                    uint16 maxLevel = package._generateMips ? 0 : texture.maxMip();
+                    for (uint16 level = minLevel; level <= maxLevel; level++) {
+                        if (texture.isStoredMipFaceAvailable(level)) {
+                            package._mips.push_back(evalTransferMip(texture, level));
+                        }
+                    }
+
+                    package._state = std::make_shared<GLTextureTransferState>();
+                    object->_transferState = package._state;
+                    _textureTransferHelper->transferTexture(package);
+
+                    object->_target = GL_TEXTURE_2D;
+                    object->_storageStamp = texture.getStamp();
+                    object->_contentStamp = texture.getDataStamp();
+
+                    glBindTexture(GL_TEXTURE_2D, boundTex);
+                    return nullptr;
+                }
+
+                if (object->_isStreamed) {
+                    for (uint16 level = minLevel; level <= texture.maxMip(); level++) {
+                        if (texture.isStoredMipFaceAvailable(level)) {
+                            uploadMip(evalTransferMip(texture, level));
+                        }
+                    }
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.maxMip());
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+                    object->_target = GL_TEXTURE_2D;
+                    syncSampler(texture.getSampler(), texture.getType(), object);
+                    finishStreamedMips(texture, object, minLevel, texture.maxMip());
+
+                    object->_storageStamp = texture.getStamp();
+                    object->_contentStamp = texture.getDataStamp();
+
+                    glBindTexture(GL_TEXTURE_2D, boundTex);
+                    return object;
+                }
+
                 glTexImage2D(GL_TEXTURE_2D, 0,
                     texelFormat.internalFormat, texture.getWidth(), texture.getHeight(), 0,
                     texelFormat.format, texelFormat.type, bytes);
@@ -466,6 +792,16 @@ GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
                 if (bytes && texture.isAutogenerateMips()) {
                     glGenerateMipmap(GL_TEXTURE_2D);
                     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+                } else if (bytes && texture.maxMip() > 0) {
+                    // the texture came with its mips made already
+                    for (uint16 level = 1; level <= texture.maxMip(); level++) {
+                        if (texture.isStoredMipFaceAvailable(level)) {
+                            uploadMip(evalTransferMip(texture, level));
+                            texture.notifyMipFaceGPULoaded(level, 0);
+                        }
+                    }
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.maxMip());
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
                 }
                 object->_target = GL_TEXTURE_2D;
 
@@ -476,7 +812,7 @@ GLBackend::GLTexture* GLBackend::syncGPUObject(const Texture& texture) {
 
                 object->_storageStamp = texture.getStamp();
                 object->_contentStamp = texture.getDataStamp();
-                object->_size = (GLuint)texture.getSize();
+                object->_size = evalGLTextureSize(texture, GL_TEXTURE_2D);
             }
 
             glBindTexture(GL_TEXTURE_2D, boundTex);
@@ -643,7 +979,8 @@ void GLBackend::syncSampler(const Sampler& sampler, Texture::Type type, GLTextur
     glTexParameteri(object->_target, GL_TEXTURE_WRAP_R, wrapModes[sampler.getWrapModeW()]);
 
     glTexParameterfv(object->_target, GL_TEXTURE_BORDER_COLOR, (const float*) &sampler.getBorderColor());
-    glTexParameteri(object->_target, GL_TEXTURE_BASE_LEVEL, sampler.getMipOffset());
+    object->_samplerMipOffset = sampler.getMipOffset();
+    glTexParameteri(object->_target, GL_TEXTURE_BASE_LEVEL, evalBaseLevel(object));
     glTexParameterf(object->_target, GL_TEXTURE_MIN_LOD, (float) sampler.getMinMip());
     glTexParameterf(object->_target, GL_TEXTURE_MAX_LOD, (sampler.getMaxMip() == Sampler::MAX_MIP_LEVEL ? 1000.f : sampler.getMaxMip()));
     glTexParameterf(object->_target, GL_TEXTURE_MAX_ANISOTROPY_EXT, sampler.getMaxAnisotropy());
@@ -663,6 +1000,12 @@ void GLBackend::do_generateTextureMips(Batch& batch, size_t paramOffset) {
         return;
     }
 
+    if (isDirectStateAccessSupported()) {
+        glGenerateTextureMipmap(object->_texture);
+        (void)CHECK_GL_ERROR();
+        return;
+    }
+
     // IN 4.1 we still need to find an available slot
     auto freeSlot = _resource.findEmptyTextureSlot();
     auto bindingSlot = (freeSlot < 0 ? 0 : freeSlot);
@@ -31,16 +31,8 @@ void GLBackend::do_setProjectionTransform(Batch& batch, size_t paramOffset) {
 void GLBackend::do_setViewportTransform(Batch& batch, size_t paramOffset) {
     memcpy(&_transform._viewport, batch.editData(batch._params[paramOffset]._uint), sizeof(Vec4i));
 
+    // Where we assign the GL viewport, in stereo the eyes each take their half of it
     ivec4& vp = _transform._viewport;
-
-    // Where we assign the GL viewport
-    if (_stereo._enable) {
-        vp.z /= 2;
-        if (_stereo._pass) {
-            vp.x += vp.z;
-        }
-    } 
-
     glViewport(vp.x, vp.y, vp.z, vp.w);
 
     // The Viewport is tagged invalid because the CameraTransformUBO is not up to date and will need update on next drawcall
@@ -58,23 +50,39 @@ void GLBackend::do_setDepthRangeTransform(Batch& batch, size_t paramOffset) {
     }
 }
 
+// a frame's worth of cameras and objects for most scenes, the streams grow if a frame needs more
+static const size_t CAMERA_STREAM_SIZE = 64 * 1024;
+static const size_t OBJECT_STREAM_SIZE = 1024 * 1024;
+static const size_t DRAW_CALL_INFO_STREAM_SIZE = 256 * 1024;
+
 void GLBackend::initTransform() {
-    glGenBuffers(1, &_transform._objectBuffer);
-    glGenBuffers(1, &_transform._cameraBuffer);
-    glGenBuffers(1, &_transform._drawCallInfoBuffer);
-#ifndef GPU_SSBO_DRAW_CALL_INFO
+    _transform._cameraBuffer.create(CAMERA_STREAM_SIZE);
+    _transform._drawCallInfoBuffer.create(DRAW_CALL_INFO_STREAM_SIZE);
+#ifdef GPU_SSBO_DRAW_CALL_INFO
+    _transform._objectBuffer.create(OBJECT_STREAM_SIZE);
+    GLint objectBufferAlignment = 1;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &objectBufferAlignment);
+#else
+    // the objects can only be read from anywhere in the ring through a texture buffer range
+    _transform._objectBuffer.create(OBJECT_STREAM_SIZE, GLEW_VERSION_4_3 || GLEW_ARB_texture_buffer_range);
+    GLint objectBufferAlignment = 1;
+    if (_transform._objectBuffer.isPersistent()) {
+        glGetIntegerv(GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT, &objectBufferAlignment);
+    }
     glGenTextures(1, &_transform._objectBufferTexture);
 #endif
-    size_t cameraSize = sizeof(TransformCamera);
+    _transform._objectBufferAlignment = objectBufferAlignment;
+    // the cameras of the two eyes are side by side in the buffer
+    size_t cameraSize = 2 * sizeof(TransformCamera);
     while (_transform._cameraUboSize < cameraSize) {
         _transform._cameraUboSize += _uboAlignment;
     }
 }
 
 void GLBackend::killTransform() {
-    glDeleteBuffers(1, &_transform._objectBuffer);
-    glDeleteBuffers(1, &_transform._cameraBuffer);
-    glDeleteBuffers(1, &_transform._drawCallInfoBuffer);
+    _transform._objectBuffer.destroy();
+    _transform._cameraBuffer.destroy();
+    _transform._drawCallInfoBuffer.destroy();
 #ifndef GPU_SSBO_DRAW_CALL_INFO
     glDeleteTextures(1, &_transform._objectBufferTexture);
 #endif
@@ -109,15 +117,16 @@ void GLBackend::TransformStageState::preUpdate(size_t commandIndex, const Stereo
     }
 
     if (_invalidView || _invalidProj || _invalidViewport) {
-        size_t offset = _cameraUboSize * _cameras.size();
+        size_t offset = _cameraUboSize * (_cameras.size() / 2);
+        _cameraOffsets.push_back(TransformStageState::Pair(commandIndex, offset));
         if (stereo._enable) {
-            _cameraOffsets.push_back(TransformStageState::Pair(commandIndex, offset));
             for (int i = 0; i < 2; ++i) {
                 _cameras.push_back(_camera.getEyeCamera(i, stereo));
             }
         } else {
-            _cameraOffsets.push_back(TransformStageState::Pair(commandIndex, offset));
-            _cameras.push_back(_camera.recomputeDerived());
+            _camera.recomputeDerived();
+            _cameras.push_back(_camera);
+            _cameras.push_back(_camera);
         }
     }
 
@@ -129,29 +138,17 @@ void GLBackend::TransformStageState::transfer(const Batch& batch) const {
     // FIXME not thread safe
     static std::vector<uint8_t> bufferData;
     if (!_cameras.empty()) {
-        bufferData.resize(_cameraUboSize * _cameras.size());
-        for (size_t i = 0; i < _cameras.size(); ++i) {
-            memcpy(bufferData.data() + (_cameraUboSize * i), &_cameras[i], sizeof(TransformCamera));
+        size_t numCameraPairs = _cameras.size() / 2;
+        bufferData.resize(_cameraUboSize * numCameraPairs);
+        for (size_t i = 0; i < numCameraPairs; ++i) {
+            memcpy(bufferData.data() + (_cameraUboSize * i), &_cameras[2 * i], 2 * sizeof(TransformCamera));
         }
-        glBindBuffer(GL_UNIFORM_BUFFER, _cameraBuffer);
-        glBufferData(GL_UNIFORM_BUFFER, bufferData.size(), bufferData.data(), GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        _cameraBufferOffset = _cameraBuffer.write(bufferData.data(), bufferData.size(), _cameraUboSize);
     }
 
     if (!batch._objects.empty()) {
-        auto byteSize = batch._objects.size() * sizeof(Batch::TransformObject);
-        bufferData.resize(byteSize);
-        memcpy(bufferData.data(), batch._objects.data(), byteSize);
-
-#ifdef GPU_SSBO_DRAW_CALL_INFO
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, _objectBuffer);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, bufferData.size(), bufferData.data(), GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-#else
-        glBindBuffer(GL_TEXTURE_BUFFER, _objectBuffer);
-        glBufferData(GL_TEXTURE_BUFFER, bufferData.size(), bufferData.data(), GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_TEXTURE_BUFFER, 0);
-#endif
+        _objectBufferSize = batch._objects.size() * sizeof(Batch::TransformObject);
+        _objectBufferOffset = _objectBuffer.write(batch._objects.data(), _objectBufferSize, _objectBufferAlignment);
     }
 
     if (!batch._namedData.empty()) {
@@ -164,18 +161,27 @@ void GLBackend::TransformStageState::transfer(const Batch& batch) const {
             _drawCallInfoOffsets[data.first] = (GLvoid*)currentSize;
         }
 
-        glBindBuffer(GL_ARRAY_BUFFER, _drawCallInfoBuffer);
-        glBufferData(GL_ARRAY_BUFFER, bufferData.size(), bufferData.data(), GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        size_t offset = _drawCallInfoBuffer.write(bufferData.data(), bufferData.size(), sizeof(Batch::DrawCallInfo));
+        for (auto& data : batch._namedData) {
+            auto& drawCallInfoOffset = _drawCallInfoOffsets[data.first];
+            drawCallInfoOffset = (GLvoid*)((size_t)drawCallInfoOffset + offset);
+        }
     }
 
+    if (_objectBufferSize > 0) {
 #ifdef GPU_SSBO_DRAW_CALL_INFO
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TRANSFORM_OBJECT_SLOT, _objectBuffer);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, TRANSFORM_OBJECT_SLOT, _objectBuffer.getBuffer(),
+                          _objectBufferOffset, _objectBufferSize);
 #else
-    glActiveTexture(GL_TEXTURE0 + TRANSFORM_OBJECT_SLOT);
-    glBindTexture(GL_TEXTURE_BUFFER, _objectBufferTexture);
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, _objectBuffer);
+        glActiveTexture(GL_TEXTURE0 + TRANSFORM_OBJECT_SLOT);
+        glBindTexture(GL_TEXTURE_BUFFER, _objectBufferTexture);
+        if (_objectBuffer.isPersistent()) {
+            glTexBufferRange(GL_TEXTURE_BUFFER, GL_RGBA32F, _objectBuffer.getBuffer(), _objectBufferOffset, _objectBufferSize);
+        } else {
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, _objectBuffer.getBuffer());
+        }
 #endif
+    }
 
     CHECK_GL_ERROR();
 }
@@ -188,12 +194,9 @@ void GLBackend::TransformStageState::update(size_t commandIndex, const StereoSta
         ++_camerasItr;
     }
     if (offset != INVALID_OFFSET) {
-        // We include both camera offsets for stereo
-        if (stereo._enable && stereo._pass) {
-            offset += _cameraUboSize;
-        }
+        // Both eyes are bound, the shaders pick theirs
         glBindBufferRange(GL_UNIFORM_BUFFER, TRANSFORM_CAMERA_SLOT,
-                          _cameraBuffer, offset, sizeof(Backend::TransformCamera));
+                          _cameraBuffer.getBuffer(), _cameraBufferOffset + offset, 2 * sizeof(Backend::TransformCamera));
     }
 
     (void)CHECK_GL_ERROR();
@@ -209,15 +212,72 @@ void GLBackend::updateTransform(const Batch& batch) {
         glVertexAttribI2i(gpu::Stream::DRAW_CALL_INFO, drawCallInfo.index, drawCallInfo.unused);
     } else {
         glEnableVertexAttribArray(gpu::Stream::DRAW_CALL_INFO); // Make sure attrib array is enabled
-        glBindBuffer(GL_ARRAY_BUFFER, _transform._drawCallInfoBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, _transform._drawCallInfoBuffer.getBuffer());
         glVertexAttribIPointer(gpu::Stream::DRAW_CALL_INFO, 2, GL_UNSIGNED_SHORT, 0,
                                _transform._drawCallInfoOffsets[batch._currentNamedCall]);
-        glVertexAttribDivisor(gpu::Stream::DRAW_CALL_INFO, 1);
+        glVertexAttribDivisor(gpu::Stream::DRAW_CALL_INFO, _input._divisorScale);
     }
     
     (void)CHECK_GL_ERROR();
 }
 
+bool GLBackend::isStereoInstanced(Batch::Command command) const {
+    // the indirect draws take their instance counts from the indirect buffer, they can't be doubled here
+    if (!_stereo._enable || (command == Batch::COMMAND_multiDrawIndirect) ||
+        (command == Batch::COMMAND_multiDrawIndexedIndirect)) {
+        return false;
+    }
+    return _pipeline._programShader && (_pipeline._programShader->_transformStereoInstancedLocation >= 0);
+}
+
+void GLBackend::updateStereoTransform(bool instanced) {
+    GLShader* program = _pipeline._programShader;
+    if (program) {
+        GLint eye = (instanced ? -1 : 0);
+        if ((program->_transformCameraEyeLocation >= 0) && (program->_transformCameraEye != eye)) {
+            glUniform1i(program->_transformCameraEyeLocation, eye);
+            program->_transformCameraEye = eye;
+        }
+        GLint stereoInstanced = (instanced ? 1 : 0);
+        if ((program->_transformStereoInstancedLocation >= 0) && (program->_transformStereoInstanced != stereoInstanced)) {
+            glUniform1i(program->_transformStereoInstancedLocation, stereoInstanced);
+            program->_transformStereoInstanced = stereoInstanced;
+        }
+    }
+
+    // The clip distance keeps the primitives of each eye in its half of the viewport
+    if (_transform._stereoInstanced != instanced) {
+        if (instanced) {
+            glEnable(GL_CLIP_DISTANCE0);
+        } else {
+            glDisable(GL_CLIP_DISTANCE0);
+        }
+        _transform._stereoInstanced = instanced;
+    }
+    (void)CHECK_GL_ERROR();
+}
+
+void GLBackend::updateStereoEye(int eye) {
+    // -1 restores the whole viewport after the eyes
+    ivec4 vp = _transform._viewport;
+    ivec4 scissor = _pipeline._scissorRect;
+    if (eye >= 0) {
+        vp.z /= 2;
+        vp.x += eye * vp.z;
+        scissor.z /= 2;
+        scissor.x += eye * scissor.z;
+
+        GLShader* program = _pipeline._programShader;
+        if (program && (program->_transformCameraEyeLocation >= 0) && (program->_transformCameraEye != eye)) {
+            glUniform1i(program->_transformCameraEyeLocation, eye);
+            program->_transformCameraEye = eye;
+        }
+    }
+    glViewport(vp.x, vp.y, vp.z, vp.w);
+    glScissor(scissor.x, scissor.y, scissor.z, scissor.w);
+    (void)CHECK_GL_ERROR();
+}
+
 void GLBackend::resetTransformStage() {
     
 }
@@ -0,0 +1,148 @@
+//
+//  GLStreamBuffer.cpp
+//  libraries/gpu/src/gpu
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "GLStreamBuffer.h"
+
+#include <string.h>
+
+#include "GLBackendShared.h"
+
+using namespace gpu;
+
+// segments start on the largest offset alignment any binding has in practice
+static const size_t SEGMENT_ALIGNMENT = 256;
+
+// past this, a frame that outruns the ring waits for the GPU rather than growing it any further
+static const size_t MAX_SEGMENT_SIZE = 64 * 1024 * 1024;
+
+static const GLbitfield PERSISTENT_MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+// how long to wait for the GPU at a time once the ring can't grow, in nanoseconds
+static const GLuint64 FENCE_WAIT_TIMEOUT = 1000000;
+
+static size_t alignUp(size_t offset, size_t alignment) {
+    return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+GLStreamBuffer::~GLStreamBuffer() {
+    destroy();
+}
+
+bool GLStreamBuffer::isPersistentMappingSupported() {
+    return (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) && (GLEW_VERSION_3_2 || GLEW_ARB_sync);
+}
+
+void GLStreamBuffer::create(size_t segmentSize, bool allowPersistent) {
+    destroy();
+    if (allowPersistent && isPersistentMappingSupported()) {
+        allocate(segmentSize);
+        if (_mapped) {
+            return;
+        }
+        qCWarning(gpulogging) << "Could not map a stream buffer persistently, it will be specified on every write";
+        destroy();
+    }
+    if (GLBackend::isDirectStateAccessSupported()) {
+        glCreateBuffers(1, &_buffer);
+    } else {
+        glGenBuffers(1, &_buffer);
+    }
+}
+
+void GLStreamBuffer::destroy() {
+    for (auto& fence : _fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = 0;
+        }
+    }
+    if (_buffer) {
+        // deleting the buffer unmaps it, and the GL keeps its storage for as long as the GPU reads it
+        glDeleteBuffers(1, &_buffer);
+        _buffer = 0;
+    }
+    _mapped = nullptr;
+    _segmentSize = 0;
+    _segment = 0;
+    _segmentOffset = 0;
+}
+
+void GLStreamBuffer::allocate(size_t segmentSize) {
+    destroy();
+    _segmentSize = alignUp(segmentSize, SEGMENT_ALIGNMENT);
+    GLsizeiptr size = (GLsizeiptr)(_segmentSize * NUM_SEGMENTS);
+
+    if (GLBackend::isDirectStateAccessSupported()) {
+        glCreateBuffers(1, &_buffer);
+        glNamedBufferStorage(_buffer, size, nullptr, PERSISTENT_MAP_FLAGS);
+        _mapped = (uint8_t*)glMapNamedBufferRange(_buffer, 0, size, PERSISTENT_MAP_FLAGS);
+    } else {
+        glGenBuffers(1, &_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _buffer);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, PERSISTENT_MAP_FLAGS);
+        _mapped = (uint8_t*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, PERSISTENT_MAP_FLAGS);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    (void)CHECK_GL_ERROR();
+}
+
+void GLStreamBuffer::nextSegment() {
+    _fences[_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _segment = (_segment + 1) % NUM_SEGMENTS;
+    _segmentOffset = 0;
+
+    GLsync& fence = _fences[_segment];
+    if (!fence) {
+        return;
+    }
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED && _segmentSize < MAX_SEGMENT_SIZE) {
+        allocate(_segmentSize * 2);
+        return;
+    }
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_TIMEOUT);
+    }
+    glDeleteSync(fence);
+    fence = 0;
+}
+
+size_t GLStreamBuffer::write(const void* data, size_t size, size_t alignment) {
+    if (!_mapped) {
+        if (GLBackend::isDirectStateAccessSupported()) {
+            glNamedBufferData(_buffer, size, data, GL_DYNAMIC_DRAW);
+        } else {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, _buffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, size, data, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        return 0;
+    }
+
+    if (size > _segmentSize) {
+        size_t segmentSize = _segmentSize;
+        while (segmentSize < size) {
+            segmentSize *= 2;
+        }
+        allocate(segmentSize);
+    }
+
+    size_t segmentStart = _segment * _segmentSize;
+    size_t offset = alignUp(segmentStart + _segmentOffset, alignment);
+    if (offset + size > segmentStart + _segmentSize) {
+        nextSegment();
+        segmentStart = _segment * _segmentSize;
+        offset = alignUp(segmentStart, alignment);
+    }
+
+    // the mapping is coherent, the bytes are visible to the commands issued after this
+    memcpy(_mapped + offset, data, size);
+    _segmentOffset = offset + size - segmentStart;
+    return offset;
+}
@@ -0,0 +1,64 @@
+//
+//  GLStreamBuffer.h
+//  libraries/gpu/src/gpu
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#ifndef hifi_gpu_GLStreamBuffer_h
+#define hifi_gpu_GLStreamBuffer_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <gl/Config.h>
+
+namespace gpu {
+
+// A buffer for the data the backend makes anew for every batch, like the cameras and the objects of the transform stage.
+// Where buffer storage is available the buffer stays mapped and is a ring of segments, each written while the GPU reads
+// the ones before. A fence marks a segment as it is left, and it is only written again once that fence signaled,
+// so neither the writes nor the draws wait on each other. If the GPU is still reading a segment the ring gets to, the
+// ring is too small for what a frame uses and grows instead of waiting.
+// Without buffer storage every write specifies the buffer anew, which lets the driver orphan the previous storage.
+class GLStreamBuffer {
+public:
+    GLStreamBuffer() {}
+    ~GLStreamBuffer();
+
+    GLStreamBuffer(const GLStreamBuffer&) = delete;
+    GLStreamBuffer& operator=(const GLStreamBuffer&) = delete;
+
+    // needs the context current; the ring can be turned down if its buffer is bound in a way that needs more
+    void create(size_t segmentSize, bool allowPersistent = true);
+    void destroy();
+
+    // copies the bytes behind the data the GPU may still be reading, returns where they start in the buffer
+    // alignment is that of the binding the bytes are read through
+    size_t write(const void* data, size_t size, size_t alignment = 1);
+
+    GLuint getBuffer() const { return _buffer; }
+    bool isPersistent() const { return _mapped != nullptr; }
+
+    // true if the GL has what persistently mapped rings need
+    static bool isPersistentMappingSupported();
+
+private:
+    static const int NUM_SEGMENTS = 3;
+
+    void allocate(size_t segmentSize);
+    void nextSegment();
+
+    GLuint _buffer { 0 };
+    uint8_t* _mapped { nullptr };
+    size_t _segmentSize { 0 };
+    int _segment { 0 };
+    size_t _segmentOffset { 0 };
+    GLsync _fences[NUM_SEGMENTS] {};
+};
+
+}
+
+#endif // hifi_gpu_GLStreamBuffer_h
@@ -0,0 +1,141 @@
+//
+//  GLTextureTransfer.cpp
+//  libraries/gpu/src/gpu
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "GLTextureTransfer.h"
+
+#include <string.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtGui/QOpenGLContext>
+
+#include <gl/OffscreenGLCanvas.h>
+
+#include "GPULogging.h"
+
+using namespace gpu;
+
+GLTextureTransferHelper::GLTextureTransferHelper() {
+    QOpenGLContext* renderContext = QOpenGLContext::currentContext();
+    if (!renderContext || !(GLEW_VERSION_3_2 || GLEW_ARB_sync)) {
+        qCDebug(gpulogging) << "Textures will be uploaded on the rendering context, fences aren't available";
+        return;
+    }
+
+    QSurface* renderSurface = renderContext->surface();
+    _canvas = new OffscreenGLCanvas();
+    _canvas->create(renderContext);
+    // creating a context shared with the rendering one releases that one
+    renderContext->makeCurrent(renderSurface);
+
+    setObjectName("Texture Transfer");
+    initialize(true, QThread::LowPriority);
+    _canvas->getContextObject()->moveToThread(_thread);
+
+    // let go of the context on the thread it is current on, so it can be deleted from this one
+    connect(_thread, &QThread::finished, this, [this] {
+        if (_isCurrent) {
+            glDeleteBuffers(1, &_pixelBuffer);
+            _canvas->doneCurrent();
+            _isCurrent = false;
+        }
+        _canvas->getContextObject()->moveToThread(QCoreApplication::instance()->thread());
+    }, Qt::DirectConnection);
+
+    _isValid = true;
+}
+
+GLTextureTransferHelper::~GLTextureTransferHelper() {
+    terminate();
+    delete _canvas;
+}
+
+void GLTextureTransferHelper::transferTexture(const GLTextureTransferPackage& package) {
+    queueItem(package);
+}
+
+bool GLTextureTransferHelper::isTransferComplete(GLTextureTransferState& state) {
+    if (state._state.load() != GLTextureTransferState::TRANSFERRED) {
+        return false;
+    }
+
+    if (state._fence) {
+        if (glClientWaitSync(state._fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(state._fence);
+        state._fence = 0;
+    }
+    return true;
+}
+
+bool GLTextureTransferHelper::processQueueItems(const Queue& items) {
+    if (!_isCurrent) {
+        _isCurrent = _canvas->makeCurrent();
+        if (!_isCurrent) {
+            qCWarning(gpulogging) << "Could not make the texture transfer context current";
+            return false;
+        }
+        glGenBuffers(1, &_pixelBuffer);
+    }
+
+    for (auto& package : items) {
+        auto& state = *package._state;
+        if (state._state.load() == GLTextureTransferState::ABANDONED) {
+            glDeleteTextures(1, &package._texture);
+            continue;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, package._texture);
+        for (auto& mip : package._mips) {
+            transferMip(mip);
+        }
+        if (package._generateMips) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        state._fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        // the fence has to reach the GPU for the rendering context to ever see it signal
+        glFlush();
+
+        int pending = GLTextureTransferState::PENDING;
+        if (!state._state.compare_exchange_strong(pending, GLTextureTransferState::TRANSFERRED)) {
+            // the texture went away while its pixels were uploading
+            glDeleteSync(state._fence);
+            state._fence = 0;
+            glDeleteTextures(1, &package._texture);
+        }
+    }
+
+    return isStillRunning();
+}
+
+void GLTextureTransferHelper::transferMip(const GLTextureTransferPackage::Mip& mip) {
+    GLsizeiptr size = (GLsizeiptr)mip._pixels->_sysmem.getSize();
+    const Byte* bytes = mip._pixels->_sysmem.read<Byte>();
+
+    // orphaning the storage of the previous upload lets the driver keep copying it while this one gets written
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped) {
+        memcpy(mapped, bytes, size);
+        if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+            glTexImage2D(GL_TEXTURE_2D, mip._level, mip._internalFormat, mip._width, mip._height, 0,
+                mip._format, mip._type, nullptr);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return;
+        }
+    }
+
+    // the buffer couldn't take the pixels, upload them straight from memory
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glTexImage2D(GL_TEXTURE_2D, mip._level, mip._internalFormat, mip._width, mip._height, 0,
+        mip._format, mip._type, bytes);
+}
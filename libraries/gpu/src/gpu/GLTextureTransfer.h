@@ -0,0 +1,91 @@
+//
+//  GLTextureTransfer.h
+//  libraries/gpu/src/gpu
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#ifndef hifi_gpu_GLTextureTransfer_h
+#define hifi_gpu_GLTextureTransfer_h
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <gl/Config.h>
+
+#include <GenericQueueThread.h>
+
+#include "Texture.h"
+
+class OffscreenGLCanvas;
+
+namespace gpu {
+
+// Where the upload of a texture's pixels stands, shared by the GL texture and the transfer thread.
+// The GL texture gives up its name to the transfer thread if it goes away before the upload is done.
+class GLTextureTransferState {
+public:
+    enum State {
+        PENDING = 0,
+        TRANSFERRED,
+        ABANDONED,
+    };
+
+    std::atomic<int> _state { PENDING };
+    GLsync _fence { 0 }; // set by the transfer thread before the state becomes TRANSFERRED
+};
+using GLTextureTransferStatePointer = std::shared_ptr<GLTextureTransferState>;
+
+class GLTextureTransferPackage {
+public:
+    class Mip {
+    public:
+        uint16 _level;
+        GLsizei _width;
+        GLsizei _height;
+        GLenum _internalFormat;
+        GLenum _format;
+        GLenum _type;
+        // the texture's own pixels, read as they upload: textures get their mips once, as they are made, and must not
+        // be given new ones for a mip until the GPU got the first
+        Texture::PixelsPointer _pixels;
+    };
+
+    GLuint _texture { 0 };
+    std::vector<Mip> _mips;
+    bool _generateMips { false };
+    GLTextureTransferStatePointer _state;
+};
+
+// Uploads the pixels of textures on a GL context of its own, shared with the rendering one, through pixel unpack buffers.
+// A fence marks each texture once its pixels are on the GPU, the render thread waits for it without blocking.
+class GLTextureTransferHelper : public GenericQueueThread<GLTextureTransferPackage> {
+public:
+    // needs the rendering context current, on the thread that owns the window
+    GLTextureTransferHelper();
+    virtual ~GLTextureTransferHelper();
+
+    bool isValid() const { return _isValid; }
+    void transferTexture(const GLTextureTransferPackage& package);
+
+    // true once the fence of the transfer signaled, which makes the pixels safe to sample on the rendering context
+    static bool isTransferComplete(GLTextureTransferState& state);
+
+protected:
+    virtual bool processQueueItems(const Queue& items) override;
+
+private:
+    void transferMip(const GLTextureTransferPackage::Mip& mip);
+
+    OffscreenGLCanvas* _canvas { nullptr };
+    bool _isValid { false };
+    bool _isCurrent { false };
+    GLuint _pixelBuffer { 0 };
+};
+
+}
+
+#endif // hifi_gpu_GLTextureTransfer_h
@@ -27,15 +27,24 @@ namespace gpu {
     public:
         using Handler = std::function<void(const Query&)>;
 
-        Query(const Handler& returnHandler);
+        enum Type {
+            TIME_ELAPSED = 0,
+            ANY_SAMPLES_PASSED, // the result is 0 if none of the samples drawn within the query passed the tests
+        };
+
+        Query(const Handler& returnHandler, Type type = TIME_ELAPSED);
         ~Query();
 
+        Type getType() const { return _type; }
+
         double getElapsedTime() const;
+        uint64_t getResult() const { return _queryResult; }
 
         const GPUObjectPointer gpuObject {};
         void triggerReturnHandler(uint64_t queryResult);
     protected:
         Handler _returnHandler;
+        Type _type;
 
         uint64_t _queryResult = 0;
     };
@@ -10,6 +10,8 @@
 //
 #include "Resource.h"
 
+#include <algorithm>
+
 #include <QDebug>
 
 using namespace gpu;
@@ -176,15 +178,18 @@ Buffer::Buffer() :
 Buffer::Buffer(Size size, const Byte* bytes) :
     Resource(),
     _sysmem(new Sysmem(size, bytes)) {
+    markDirty(0, NOT_ALLOCATED);
 }
 
 Buffer::Buffer(const Buffer& buf) :
     Resource(),
     _sysmem(new Sysmem(buf.getSysmem())) {
+    markDirty(0, NOT_ALLOCATED);
 }
 
 Buffer& Buffer::operator=(const Buffer& buf) {
     (*_sysmem) = buf.getSysmem();
+    markDirty(0, NOT_ALLOCATED);
     return (*this);
 }
 
@@ -204,10 +209,30 @@ Buffer::Size Buffer::setData(Size size, const Byte* data) {
 }
 
 Buffer::Size Buffer::setSubData(Size offset, Size size, const Byte* data) {
-    return editSysmem().setSubData( offset, size, data);
+    markDirty(offset, size);
+    return _sysmem->setSubData( offset, size, data);
 }
 
 Buffer::Size Buffer::append(Size size, const Byte* data) {
     return editSysmem().append( size, data);
 }
 
+void Buffer::markDirty(Size offset, Size size) {
+    Size end = (size == NOT_ALLOCATED) ? NOT_ALLOCATED : offset + size;
+    if (_dirtyBegin == _dirtyEnd) {
+        _dirtyBegin = offset;
+        _dirtyEnd = end;
+    } else {
+        _dirtyBegin = std::min(_dirtyBegin, offset);
+        _dirtyEnd = std::max(_dirtyEnd, end);
+    }
+}
+
+bool Buffer::takeDirtyRange(Size& offset, Size& size) const {
+    Size end = std::min(_dirtyEnd, getSize());
+    offset = _dirtyBegin;
+    size = (end > offset) ? end - offset : 0;
+    _dirtyBegin = _dirtyEnd = 0;
+    return size > 0;
+}
+
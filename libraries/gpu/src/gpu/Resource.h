@@ -120,7 +120,7 @@ public:
     // The size in bytes of data stored in the buffer
     Size getSize() const { return getSysmem().getSize(); }
     const Byte* getData() const { return getSysmem().readData(); }
-    Byte* editData() { return editSysmem().editData(); }
+    Byte* editData() { markDirty(0, NOT_ALLOCATED); return editSysmem().editData(); }
 
     // Resize the buffer
     // Keep previous data [0 to min(pSize, mSize)]
@@ -150,14 +150,24 @@ public:
     }
 
     // Access the sysmem object.
+    // Editing it directly leaves the backend to upload the whole buffer again
     const Sysmem& getSysmem() const { assert(_sysmem); return (*_sysmem); }
-    Sysmem& editSysmem() { assert(_sysmem); return (*_sysmem); }
+    Sysmem& editSysmem() { markDirty(0, NOT_ALLOCATED); assert(_sysmem); return (*_sysmem); }
+
+    // The bytes changed since the last call, which are all the backend needs to upload, and forgets them
+    // \return false if nothing changed
+    bool takeDirtyRange(Size& offset, Size& size) const;
 
     const GPUObjectPointer gpuObject {};
     
 protected:
+    void markDirty(Size offset, Size size);
 
     Sysmem* _sysmem = NULL;
+
+    // taken by the backend as it uploads, which it does through a const buffer
+    mutable Size _dirtyBegin { 0 };
+    mutable Size _dirtyEnd { 0 };
 };
 
 typedef std::shared_ptr<Buffer> BufferPointer;
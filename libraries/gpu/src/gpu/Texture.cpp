@@ -281,6 +281,14 @@ uint16 Texture::maxMip() const {
     return _maxMip;
 }
 
+std::atomic<Texture::Size> Texture::_mipStreamingBudget { 1024 * 1024 * 1024 };
+
+void Texture::requestMip(uint16 level) const {
+    uint16 requested = _requestedMip.load();
+    while (level < requested && !_requestedMip.compare_exchange_weak(requested, level)) {
+    }
+}
+
 bool Texture::assignStoredMip(uint16 level, const Element& format, Size size, const Byte* bytes) {
     // Check that level accessed make sense
     if (level != 0) {
@@ -297,7 +305,6 @@ bool Texture::assignStoredMip(uint16 level, const Element& format, Size size, co
     if (size == expectedSize) {
         _storage->assignMipData(level, format, size, bytes);
         _stamp++;
-        return true;
     } else if (size > expectedSize) {
         // NOTE: We are facing this case sometime because apparently QImage (from where we get the bits) is generating images
         // and alligning the line of pixels to 32 bits.
@@ -305,10 +312,15 @@ bool Texture::assignStoredMip(uint16 level, const Element& format, Size size, co
         // it seems to work...
         _storage->assignMipData(level, format, size, bytes);
         _stamp++;
-        return true;
+    } else {
+        return false;
     }
 
-    return false;
+    // without auto generation, the deepest mip assigned is the last one
+    if (!_autoGenerateMips && level > _maxMip) {
+        _maxMip = level;
+    }
+    return true;
 }
 
 
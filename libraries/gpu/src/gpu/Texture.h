@@ -14,6 +14,7 @@
 #include "Resource.h"
 
 #include <algorithm> //min max and more
+#include <atomic>
 
 #include <QUrl>
 
@@ -356,6 +357,19 @@ public:
     // Only callable by the Backend
     void notifyMipFaceGPULoaded(uint16 level, uint8 face) const { return _storage->notifyMipFaceGPULoaded(level, face); }
 
+    // Mip streaming
+    // A 2D texture that comes with its mips goes on the GPU coarsest mips first, the finer ones follow as the renderers
+    // ask for them, within a budget shared by all the streamed textures. Its stored mips stay in sysmem to stream again.
+    static const uint16 NO_MIP_REQUEST = 0xFFFF;
+    bool isStreamable() const { return _type == TEX_2D && !_autoGenerateMips && _maxMip > 0; }
+
+    // Keeps the finest of the mips asked for until the backend takes it
+    void requestMip(uint16 level) const;
+    uint16 takeRequestedMip() const { return _requestedMip.exchange(NO_MIP_REQUEST); }
+
+    static void setMipStreamingBudget(Size budget) { _mipStreamingBudget = budget; }
+    static Size getMipStreamingBudget() { return _mipStreamingBudget; }
+
     const GPUObjectPointer gpuObject {};
 
 protected:
@@ -384,6 +398,9 @@ protected:
     bool _autoGenerateMips = false;
     bool _isIrradianceValid = false;
     bool _defined = false;
+
+    mutable std::atomic<uint16> _requestedMip { NO_MIP_REQUEST };
+    static std::atomic<Size> _mipStreamingBudget;
    
     static Texture* create(Type type, const Element& texelFormat, uint16 width, uint16 height, uint16 depth, uint16 numSamples, uint16 numSlices, const Sampler& sampler);
 
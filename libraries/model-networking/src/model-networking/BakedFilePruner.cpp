@@ -0,0 +1,42 @@
+//
+//  BakedFilePruner.cpp
+//  libraries/model-networking/src/model-networking
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakedFilePruner.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+BakedFilePruner::BakedFilePruner(const QString& directory, const QString& extension, qint64 maxSize) :
+    _directory(directory),
+    _extension(extension),
+    _maxSize(maxSize) {
+}
+
+void BakedFilePruner::run() {
+    QDir directory { _directory };
+    auto files = directory.entryInfoList({ "*" + _extension }, QDir::Files, QDir::Time | QDir::Reversed);
+
+    qint64 totalSize = 0;
+    for (const auto& file : files) {
+        totalSize += file.size();
+    }
+
+    const qint64 prunedSize = _maxSize * 9 / 10;
+    if (totalSize > _maxSize) {
+        for (const auto& file : files) {
+            if (totalSize <= prunedSize) {
+                break;
+            }
+            if (QFile::remove(file.absoluteFilePath())) {
+                totalSize -= file.size();
+            }
+        }
+    }
+}
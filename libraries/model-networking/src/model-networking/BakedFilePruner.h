@@ -0,0 +1,30 @@
+//
+//  BakedFilePruner.h
+//  libraries/model-networking/src/model-networking
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakedFilePruner_h
+#define hifi_BakedFilePruner_h
+
+#include <QtCore/QRunnable>
+#include <QtCore/QString>
+
+// Takes out the least recently baked files of a directory once there are more than fit.
+class BakedFilePruner : public QRunnable {
+public:
+    BakedFilePruner(const QString& directory, const QString& extension, qint64 maxSize);
+
+    virtual void run() override;
+
+private:
+    QString _directory;
+    QString _extension;
+    qint64 _maxSize;
+};
+
+#endif // hifi_BakedFilePruner_h
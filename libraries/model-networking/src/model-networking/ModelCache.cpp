@@ -13,12 +13,23 @@
 
 #include <cmath>
 
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QNetworkReply>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QThreadPool>
 
 #include <FSTReader.h>
+#include <GeometryContainer.h>
+#include <MeshOptimizer.h>
+#include <MeshSimplifier.h>
 #include <NumericalConstants.h>
 
+#include "BakedFilePruner.h"
 #include "TextureCache.h"
 #include "ModelNetworkingLogging.h"
 
@@ -26,10 +37,24 @@
 
 //#define WANT_DEBUG
 
+// models parsed from FBX and OBJ files are kept here in containers, so that the next load of the same file skips the parsing
+static const qint64 MAX_BAKED_MODELS_SIZE = 1024LL * 1024 * 1024;
+static const QString BAKED_MODEL_EXTENSION = ".hfgx";
+
+static QString getBakedModelsDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/models";
+}
+
+bool ModelCache::_meshOptimizationEnabled = true;
+bool ModelCache::_meshLODsEnabled = true;
+
 ModelCache::ModelCache()
 {
     const qint64 GEOMETRY_DEFAULT_UNUSED_MAX_SIZE = DEFAULT_UNUSED_MAX_SIZE;
     setUnusedResourceCacheSize(GEOMETRY_DEFAULT_UNUSED_MAX_SIZE);
+
+    QThreadPool::globalInstance()->start(new BakedFilePruner(getBakedModelsDirectory(), BAKED_MODEL_EXTENSION,
+                                                           MAX_BAKED_MODELS_SIZE));
 }
 
 ModelCache::~ModelCache() {
@@ -49,6 +74,50 @@ GeometryReader::GeometryReader(const QUrl& url, const QByteArray& data, const QV
     _mapping(mapping) {
 }
 
+// the parsed model depends on the file, where it came from (OBJ files fetch their materials next to it) and the mapping,
+// so all of them go in its name
+static QString getBakedModelPath(const QUrl& url, const QByteArray& data, const QVariantHash& mapping,
+                                 bool grabLightmaps, float lightmapLevel) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(data);
+    hash.addData(url.toEncoded());
+    hash.addData(QJsonDocument(QJsonObject::fromVariantHash(mapping)).toJson(QJsonDocument::Compact));
+    hash.addData(QByteArray::number(grabLightmaps) + " " + QByteArray::number(lightmapLevel));
+    hash.addData(ModelCache::isMeshOptimizationEnabled() ? "optimized" : "");
+    hash.addData(ModelCache::isMeshLODsEnabled() ? "lods" : "");
+    return getBakedModelsDirectory() + "/" + hash.result().toHex() + BAKED_MODEL_EXTENSION;
+}
+
+// the container is read where it lies in the file, the geometry copies its arrays
+static FBXGeometry* readBakedModel(const QString& bakedPath, const QString& url) {
+    QFile bakedFile { bakedPath };
+    if (!bakedFile.open(QIODevice::ReadOnly) || bakedFile.size() == 0) {
+        return nullptr;
+    }
+
+    uchar* mapped = bakedFile.map(0, bakedFile.size());
+    if (!mapped) {
+        return readGeometryContainer(bakedFile.readAll(), url);
+    }
+
+    FBXGeometry* geometry = nullptr;
+    {
+        QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), (int)bakedFile.size());
+        geometry = readGeometryContainer(data, url);
+    }
+    bakedFile.unmap(mapped);
+    return geometry;
+}
+
+static void writeBakedModel(const QString& bakedPath, const FBXGeometry& geometry) {
+    QByteArray baked = writeGeometryContainer(geometry);
+    QSaveFile bakedFile { bakedPath };
+    if (QDir().mkpath(getBakedModelsDirectory()) && bakedFile.open(QIODevice::WriteOnly)) {
+        bakedFile.write(baked);
+        bakedFile.commit();
+    }
+}
+
 void GeometryReader::run() {
     try {
         if (_data.isEmpty()) {
@@ -61,11 +130,19 @@ void GeometryReader::run() {
         urlValid &= _url.path().toLower().endsWith(".fbx") || _url.path().toLower().endsWith(".obj");
 
         if (urlValid) {
+            const bool grabLightmaps = true;
+            const float lightmapLevel = 1.0f;
+
+            // a model that was parsed from this file before needs no parsing
+            QString bakedPath = getBakedModelPath(_url, _data, _mapping, grabLightmaps, lightmapLevel);
+            FBXGeometry* fbxgeo = readBakedModel(bakedPath, _url.path());
+            if (fbxgeo) {
+                emit onSuccess(fbxgeo);
+                return;
+            }
+
             // Let's read the binaries from the network
-            FBXGeometry* fbxgeo = nullptr;
             if (_url.path().toLower().endsWith(".fbx")) {
-                const bool grabLightmaps = true;
-                const float lightmapLevel = 1.0f;
                 fbxgeo = readFBX(_data, _mapping, _url.path(), grabLightmaps, lightmapLevel);
             } else if (_url.path().toLower().endsWith(".obj")) {
                 fbxgeo = OBJReader().readOBJ(_data, _mapping, _url);
@@ -73,6 +150,23 @@ void GeometryReader::run() {
                 QString errorStr("unsupported format");
                 emit onError(NetworkGeometry::ModelParseError, errorStr);
             }
+
+            if (fbxgeo) {
+                bool generateLODs = ModelCache::isMeshLODsEnabled();
+                bool optimize = ModelCache::isMeshOptimizationEnabled();
+                if (generateLODs || optimize) {
+                    for (auto& mesh : fbxgeo->meshes) {
+                        if (generateLODs) {
+                            generateMeshLODs(mesh);
+                        }
+                        if (optimize) {
+                            optimizeMesh(mesh);
+                        }
+                        FBXReader::buildModelMesh(mesh, _url.path());
+                    }
+                }
+                writeBakedModel(bakedPath, *fbxgeo);
+            }
             emit onSuccess(fbxgeo);
         } else {
             throw QString("url is invalid");
@@ -141,6 +235,20 @@ bool NetworkGeometry::isLoadedWithTextures() const {
     return true;
 }
 
+void NetworkGeometry::setLoadPriority(const QPointer<QObject>& owner, float priority) {
+    if (_resource) {
+        _resource->setLoadPriority(owner, priority);
+    }
+    for (auto&& material : _materials) {
+        for (auto texture : { material->diffuseTexture, material->normalTexture,
+                              material->specularTexture, material->emissiveTexture }) {
+            if (texture) {
+                texture->setLoadPriority(owner, priority);
+            }
+        }
+    }
+}
+
 void NetworkGeometry::setTextureWithNameToURL(const QString& name, const QUrl& url) {
 
 
@@ -48,10 +48,23 @@ public:
     /// \param delayLoad if true, don't load the geometry immediately; wait until load is first requested
     QSharedPointer<NetworkGeometry> getGeometry(const QUrl& url, const QUrl& fallback = QUrl(), bool delayLoad = false);
 
+    /// Sets whether the triangles of models are reordered as they load, for the vertex cache of the GPU and for less
+    /// overdraw. The reordered models are what gets baked.
+    static void setMeshOptimizationEnabled(bool enabled) { _meshOptimizationEnabled = enabled; }
+    static bool isMeshOptimizationEnabled() { return _meshOptimizationEnabled; }
+
+    /// Sets whether models get coarser levels of detail made for their meshes as they load, drawn when they are far.
+    /// The levels are baked with the models.
+    static void setMeshLODsEnabled(bool enabled) { _meshLODsEnabled = enabled; }
+    static bool isMeshLODsEnabled() { return _meshLODsEnabled; }
+
 private:
     ModelCache();
     virtual ~ModelCache();
 
+    static bool _meshOptimizationEnabled;
+    static bool _meshLODsEnabled;
+
     QHash<QUrl, QWeakPointer<NetworkGeometry> > _networkGeometry;
 };
 
@@ -91,6 +104,9 @@ public:
     void setTextureWithNameToURL(const QString& name, const QUrl& url);
     QStringList getTextureNames() const;
 
+    /// Sets the load priority of the model and its textures for one owner, see Resource::setLoadPriority.
+    void setLoadPriority(const QPointer<QObject>& owner, float priority);
+
     enum Error {
         MissingFilenameInMapping = 0,
         MappingRequestError,
@@ -16,23 +16,59 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/random.hpp>
 
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
 #include <QNetworkReply>
 #include <QPainter>
 #include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QThreadPool>
 #include <qimagereader.h>
 #include <PathUtils.h>
 
 #include <gpu/Batch.h>
 
+#include "BakedFilePruner.h"
 #include "ModelNetworkingLogging.h"
+#include "TextureContainer.h"
+
+// textures decoded from images are kept here in containers, so that the next load of the same image skips the decoding
+static const qint64 MAX_BAKED_TEXTURES_SIZE = 1024LL * 1024 * 1024;
+static const QString BAKED_TEXTURE_EXTENSION = ".hftx";
+
+static QString getBakedTexturesDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/textures";
+}
 
 TextureCache::TextureCache() {
     const qint64 TEXTURE_DEFAULT_UNUSED_MAX_SIZE = DEFAULT_UNUSED_MAX_SIZE;
     setUnusedResourceCacheSize(TEXTURE_DEFAULT_UNUSED_MAX_SIZE);
+
+    // leave the other half of the cores to the global pool, which parses the models
+    _imageDecodePool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+
+    QThreadPool::globalInstance()->start(new BakedFilePruner(getBakedTexturesDirectory(), BAKED_TEXTURE_EXTENSION,
+                                                           MAX_BAKED_TEXTURES_SIZE));
+
+    // the materials fall back on these while recording batches on any thread, so they can't be made on first use
+    getWhiteTexture();
+    getGrayTexture();
+    getBlueTexture();
+    getBlackTexture();
 }
 
 TextureCache::~TextureCache() {
+    // the images waiting to be decoded are for textures about to go
+    _imageDecodePool.clear();
+    _imageDecodePool.waitForDone();
+}
+
+void TextureCache::startImageDecode(QRunnable* reader, float loadPriority) {
+    // the pool runs the readers of the textures in view first, the rest after in the order they came
+    const float MAX_DECODE_PRIORITY = 100.0f;
+    _imageDecodePool.start(reader, (int)(glm::clamp(loadPriority, 0.0f, 1.0f) * MAX_DECODE_PRIORITY));
 }
 
 // use fixed table of permutations. Could also make ordered list programmatically
@@ -237,18 +273,21 @@ public:
 private:
     static void listSupportedImageFormats();
 
+    // hands the texture over to the resource, if it is still around to take it
+    void finish(const QImage& image, gpu::Texture* theTexture, int originalWidth, int originalHeight);
+
     QWeakPointer<Resource> _texture;
     QUrl _url;
     QByteArray _content;
 };
 
 void NetworkTexture::downloadFinished(const QByteArray& data) {
-    // send the reader off to the thread pool
-    QThreadPool::globalInstance()->start(new ImageReader(_self, data, _url));
+    // send the reader off to the decode pool
+    DependencyManager::get<TextureCache>()->startImageDecode(new ImageReader(_self, data, _url), getLoadPriority());
 }
 
 void NetworkTexture::loadContent(const QByteArray& content) {
-    QThreadPool::globalInstance()->start(new ImageReader(_self, content, _url));
+    DependencyManager::get<TextureCache>()->startImageDecode(new ImageReader(_self, content, _url), getLoadPriority());
 }
 
 ImageReader::ImageReader(const QWeakPointer<Resource>& texture, const QByteArray& data,
@@ -267,10 +306,54 @@ void ImageReader::listSupportedImageFormats() {
     });
 }
 
+// the baked texture for an image depends on the image and how it is loaded, so both go in its name
+static QString getBakedTexturePath(const QByteArray& content, TextureType type) {
+    if (type == CUBE_TEXTURE || type == CUSTOM_TEXTURE) {
+        return QString();
+    }
+
+    QString name = QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex() + "-" + QString::number(type);
+    if (model::TextureUsage::isCompressionEnabled()) {
+        name += "c";
+    }
+    return getBakedTexturesDirectory() + "/" + name + BAKED_TEXTURE_EXTENSION;
+}
+
 void ImageReader::run() {
-    auto texture = _texture.toStrongRef();
-    if (!texture) {
-        qCWarning(modelnetworking) << "Could not get strong ref";
+    // the texture can go while its reader waits in the pool or decodes, there is no more work to do for it then
+    NetworkTexture::TextureLoaderFunc textureLoader;
+    QString bakedPath;
+    {
+        auto texture = _texture.toStrongRef();
+        if (!texture) {
+            return;
+        }
+        auto ntex = texture.dynamicCast<NetworkTexture>();
+        if (ntex) {
+            textureLoader = ntex->getTextureLoader();
+            if (!isTextureContainer(_content)) {
+                bakedPath = getBakedTexturePath(_content, ntex->getType());
+            }
+        }
+    }
+
+    // a texture that comes baked already, or that was baked from this image before, needs no decoding
+    gpu::Texture* theTexture = nullptr;
+    if (isTextureContainer(_content)) {
+        theTexture = readTextureContainer(_content);
+        if (!theTexture) {
+            qCDebug(modelnetworking) << "Could not read texture container" << _url;
+            return;
+        }
+    } else if (!bakedPath.isEmpty()) {
+        QFile bakedFile { bakedPath };
+        if (bakedFile.open(QIODevice::ReadOnly)) {
+            theTexture = readTextureContainer(bakedFile.readAll());
+        }
+    }
+
+    if (theTexture) {
+        finish(QImage(), theTexture, theTexture->getWidth(), theTexture->getHeight());
         return;
     }
 
@@ -296,10 +379,31 @@ void ImageReader::run() {
         return;
     }
 
-    gpu::Texture* theTexture = nullptr;
-    auto ntex = texture.dynamicCast<NetworkTexture>();
-    if (ntex) {
-        theTexture = ntex->getTextureLoader()(image, _url.toString().toStdString());
+    if (_texture.isNull()) {
+        return;
+    }
+
+    if (textureLoader) {
+        theTexture = textureLoader(image, _url.toString().toStdString());
+    }
+
+    if (theTexture && !bakedPath.isEmpty()) {
+        QByteArray baked = writeTextureContainer(*theTexture);
+        QSaveFile bakedFile { bakedPath };
+        if (!baked.isEmpty() && QDir().mkpath(getBakedTexturesDirectory()) && bakedFile.open(QIODevice::WriteOnly)) {
+            bakedFile.write(baked);
+            bakedFile.commit();
+        }
+    }
+
+    finish(image, theTexture, originalWidth, originalHeight);
+}
+
+void ImageReader::finish(const QImage& image, gpu::Texture* theTexture, int originalWidth, int originalHeight) {
+    auto texture = _texture.toStrongRef();
+    if (!texture) {
+        delete theTexture;
+        return;
     }
 
     QMetaObject::invokeMethod(texture.data(), "setImage", 
@@ -16,6 +16,7 @@
 
 #include <QImage>
 #include <QMap>
+#include <QThreadPool>
 #include <QColor>
 
 #include <DependencyManager.h>
@@ -67,6 +68,14 @@ public:
     typedef gpu::Texture* TextureLoader(const QImage& image, const std::string& srcImageName);
     
     typedef std::function<TextureLoader> TextureLoaderFunc;
+
+    /// Sets how many images can be decoded at once.
+    void setImageDecodeThreadCount(int count) { _imageDecodePool.setMaxThreadCount(count); }
+    int getImageDecodeThreadCount() const { return _imageDecodePool.maxThreadCount(); }
+
+    /// Decodes an image on the pool of the cache, ahead of those of lesser load priority.
+    void startImageDecode(QRunnable* reader, float loadPriority);
+
 protected:
 
     virtual QSharedPointer<Resource> createResource(const QUrl& url,
@@ -84,6 +93,8 @@ private:
     gpu::TexturePointer _blackTexture;
     gpu::TexturePointer _normalFittingTexture;
 
+    QThreadPool _imageDecodePool;
+
     QHash<QUrl, QWeakPointer<NetworkTexture> > _dilatableNetworkTextures;
 };
 
@@ -113,6 +124,7 @@ public:
     int getWidth() const { return _width; }
     int getHeight() const { return _height; }
     
+    TextureType getType() const { return _type; }
     TextureLoaderFunc getTextureLoader() const;
     
 protected:
@@ -0,0 +1,162 @@
+//
+//  TextureContainer.cpp
+//  libraries/model-networking/src/model-networking
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureContainer.h"
+
+#include <memory>
+
+#include <QtCore/QDataStream>
+#include <QtGui/QImage>
+
+#include <gpu/Texture.h>
+
+static const quint32 TEXTURE_CONTAINER_MAGIC = 0x48465458; // "HFTX"
+static const quint32 TEXTURE_CONTAINER_VERSION = 1;
+
+static void writeElement(QDataStream& stream, const gpu::Element& element) {
+    stream << (quint8)element.getSemantic() << (quint8)element.getDimension() << (quint8)element.getType();
+}
+
+static bool readElement(QDataStream& stream, gpu::Element& element) {
+    quint8 semantic, dimension, type;
+    stream >> semantic >> dimension >> type;
+    if (semantic >= gpu::NUM_SEMANTICS || dimension >= gpu::NUM_DIMENSIONS || type >= gpu::NUM_TYPES) {
+        return false;
+    }
+    element = gpu::Element((gpu::Dimension)dimension, (gpu::Type)type, (gpu::Semantic)semantic);
+    return true;
+}
+
+// the first mip as an image, which has its lines aligned to 32 bits the same way the image loaders left them
+static QImage getFirstMipImage(const gpu::Texture& texture, gpu::Element& mipFormat) {
+    if (!texture.isStoredMipFaceAvailable(0)) {
+        return QImage();
+    }
+
+    auto mip = texture.accessStoredMipFace(0);
+    mipFormat = mip->_format;
+    if (mipFormat.getType() != gpu::NUINT8) {
+        return QImage();
+    }
+
+    QImage::Format imageFormat;
+    int bytesPerPixel;
+    if (mipFormat.getDimension() == gpu::VEC3) {
+        imageFormat = QImage::Format_RGB888;
+        bytesPerPixel = 3;
+    } else if (mipFormat.getDimension() == gpu::VEC4 &&
+               (mipFormat.getSemantic() == gpu::BGRA || mipFormat.getSemantic() == gpu::SBGRA)) {
+        imageFormat = QImage::Format_ARGB32;
+        bytesPerPixel = 4;
+    } else {
+        return QImage();
+    }
+
+    const int LINE_ALIGNMENT = 4;
+    int width = texture.getWidth();
+    int height = texture.getHeight();
+    int bytesPerLine = (width * bytesPerPixel + LINE_ALIGNMENT - 1) / LINE_ALIGNMENT * LINE_ALIGNMENT;
+    if ((qint64)mip->_sysmem.getSize() < (qint64)bytesPerLine * height) {
+        return QImage();
+    }
+
+    return QImage(mip->_sysmem.readData(), width, height, bytesPerLine, imageFormat);
+}
+
+bool isTextureContainer(const QByteArray& data) {
+    QDataStream stream(data);
+    quint32 magic = 0;
+    stream >> magic;
+    return magic == TEXTURE_CONTAINER_MAGIC;
+}
+
+gpu::Texture* readTextureContainer(const QByteArray& data) {
+    QDataStream stream(data);
+
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic != TEXTURE_CONTAINER_MAGIC || version != TEXTURE_CONTAINER_VERSION) {
+        return nullptr;
+    }
+
+    quint16 width, height;
+    gpu::Element texelFormat;
+    quint8 filter, wrapMode;
+    quint16 numMips;
+    stream >> width >> height;
+    if (!readElement(stream, texelFormat)) {
+        return nullptr;
+    }
+    stream >> filter >> wrapMode >> numMips;
+    if (filter >= gpu::Sampler::NUM_FILTERS || wrapMode >= gpu::Sampler::NUM_WRAP_MODES ||
+            width == 0 || height == 0 || numMips == 0) {
+        return nullptr;
+    }
+
+    gpu::Sampler sampler((gpu::Sampler::Filter)filter, (gpu::Sampler::WrapMode)wrapMode);
+    std::unique_ptr<gpu::Texture> texture { gpu::Texture::create2D(texelFormat, width, height, sampler) };
+
+    for (quint16 level = 0; level < numMips; level++) {
+        gpu::Element mipFormat;
+        quint32 size;
+        if (!readElement(stream, mipFormat)) {
+            return nullptr;
+        }
+        stream >> size;
+
+        // the pixels are used where they lie in the container, the texture copies them
+        if (stream.status() != QDataStream::Ok || size > (quint32)(data.size() - stream.device()->pos())) {
+            return nullptr;
+        }
+        const gpu::Byte* bytes = reinterpret_cast<const gpu::Byte*>(data.constData() + stream.device()->pos());
+        if (!texture->assignStoredMip(level, mipFormat, size, bytes)) {
+            return nullptr;
+        }
+        stream.skipRawData(size);
+    }
+
+    return texture.release();
+}
+
+QByteArray writeTextureContainer(const gpu::Texture& texture) {
+    if (texture.getType() != gpu::Texture::TEX_2D || texture.getNumSlices() != 1) {
+        return QByteArray();
+    }
+
+    gpu::Element mipFormat;
+    QImage image = getFirstMipImage(texture, mipFormat);
+    if (image.isNull()) {
+        return QByteArray();
+    }
+
+    // a texture that was to have its mips made on the GPU gets them made here instead, by scaling the image down
+    quint16 numMips = texture.isAutogenerateMips() ? texture.evalNumMips() : 1;
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+
+    stream << TEXTURE_CONTAINER_MAGIC << TEXTURE_CONTAINER_VERSION;
+    stream << (quint16)texture.getWidth() << (quint16)texture.getHeight();
+    writeElement(stream, texture.getTexelFormat());
+    stream << (quint8)texture.getSampler().getFilter() << (quint8)texture.getSampler().getWrapModeU() << numMips;
+
+    for (quint16 level = 0; level < numMips; level++) {
+        QImage mipImage = image;
+        if (level > 0) {
+            mipImage = image.scaled(texture.evalMipWidth(level), texture.evalMipHeight(level),
+                                    Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(image.format());
+        }
+        writeElement(stream, mipFormat);
+        stream << (quint32)mipImage.byteCount();
+        stream.writeRawData(reinterpret_cast<const char*>(mipImage.constBits()), mipImage.byteCount());
+    }
+
+    return data;
+}
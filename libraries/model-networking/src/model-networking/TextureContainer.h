@@ -0,0 +1,32 @@
+//
+//  TextureContainer.h
+//  libraries/model-networking/src/model-networking
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureContainer_h
+#define hifi_TextureContainer_h
+
+#include <QtCore/QByteArray>
+
+namespace gpu {
+class Texture;
+}
+
+// A texture container holds a 2D texture the way the GPU takes it: its texel format, its sampler and the pixels of each
+// of its mips. Loading one needs no image decoding and no mip generation.
+
+bool isTextureContainer(const QByteArray& data);
+
+/// Returns nullptr if the data isn't a container that can be read, or doesn't hold a whole texture.
+gpu::Texture* readTextureContainer(const QByteArray& data);
+
+/// Puts the texture in a container, with the mips made from the first one if the texture was to have the GPU make them.
+/// Returns an empty array for a texture that can't be put in one: one that isn't 2D, or isn't held in 8 bit RGB or BGRA.
+QByteArray writeTextureContainer(const gpu::Texture& texture);
+
+#endif // hifi_TextureContainer_h
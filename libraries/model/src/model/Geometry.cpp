@@ -26,7 +26,9 @@ Mesh::Mesh(const Mesh& mesh) :
     _vertexBuffer(mesh._vertexBuffer),
     _attributeBuffers(mesh._attributeBuffers),
     _indexBuffer(mesh._indexBuffer),
-    _partBuffer(mesh._partBuffer) {
+    _partBuffer(mesh._partBuffer),
+    _lodParts(mesh._lodParts),
+    _lodErrors(mesh._lodErrors) {
 }
 
 Mesh::~Mesh() {
@@ -92,6 +94,12 @@ void Mesh::setPartBuffer(const BufferView& buffer) {
     _partBuffer = buffer;
 }
 
+void Mesh::setLODs(const std::vector<Part>& lodParts, const std::vector<float>& lodErrors) {
+    assert(lodParts.size() == lodErrors.size() * getNumParts());
+    _lodParts = lodParts;
+    _lodErrors = lodErrors;
+}
+
 Box Mesh::evalPartBound(int partNum) const {
     Box box;
     if (partNum < _partBuffer.getNum<Part>()) {
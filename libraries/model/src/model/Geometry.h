@@ -106,6 +106,13 @@ public:
     const BufferView& getPartBuffer() const { return _partBuffer; }
     size_t getNumParts() const { return _partBuffer.getNumElements(); }
 
+    // Coarser levels of detail of the parts, drawn from the same vertices with indices of their own. The parts of
+    // level lod come at (lod - 1) * getNumParts(), the error is how far the level is from the full mesh at most.
+    void setLODs(const std::vector<Part>& lodParts, const std::vector<float>& lodErrors);
+    int getNumLODs() const { return (int)_lodErrors.size(); }
+    const Part& getLODPart(int lod, int partNum) const { return _lodParts[(lod - 1) * getNumParts() + partNum]; }
+    float getLODError(int lod) const { return _lodErrors[lod - 1]; }
+
     // evaluate the bounding box of A part
     Box evalPartBound(int partNum) const;
     // evaluate the bounding boxes of the parts in the range [start, end[ and fill the bounds parameter
@@ -126,6 +133,9 @@ protected:
 
     BufferView _partBuffer;
 
+    std::vector<Part> _lodParts;
+    std::vector<float> _lodErrors;
+
     void evalVertexFormat();
     void evalVertexStream();
 
@@ -52,6 +52,28 @@ void TextureMap::setLightmapOffsetScale(float offset, float scale) {
 
 
 
+bool TextureUsage::_compressionEnabled = true;
+
+// the GPU keeps the texture block compressed when that is enabled, while the stored mip stays as the image's pixels
+static gpu::Element evalColorTexelFormat(const gpu::Element& format) {
+    if (!TextureUsage::isCompressionEnabled()) {
+        return format;
+    }
+
+    switch (format.getSemantic()) {
+        case gpu::RGB:
+            return gpu::Element(format.getDimension(), format.getType(), gpu::COMPRESSED_RGB);
+        case gpu::SRGB:
+            return gpu::Element(format.getDimension(), format.getType(), gpu::COMPRESSED_SRGB);
+        case gpu::RGBA:
+            return gpu::Element(format.getDimension(), format.getType(), gpu::COMPRESSED_RGBA);
+        case gpu::SRGBA:
+            return gpu::Element(format.getDimension(), format.getType(), gpu::COMPRESSED_SRGBA);
+        default:
+            return format;
+    }
+}
+
 gpu::Texture* TextureUsage::create2DTextureFromImage(const QImage& srcImage, const std::string& srcImageName) {
     QImage image = srcImage;
  
@@ -129,7 +151,7 @@ gpu::Texture* TextureUsage::create2DTextureFromImage(const QImage& srcImage, con
         }
         
 
-            theTexture = (gpu::Texture::create2D(formatGPU, image.width(), image.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
+            theTexture = (gpu::Texture::create2D(evalColorTexelFormat(formatGPU), image.width(), image.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
             theTexture->assignStoredMip(0, formatMip, image.byteCount(), image.constBits());
             theTexture->autoGenerateMips(-1);
     }
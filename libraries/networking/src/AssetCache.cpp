@@ -0,0 +1,195 @@
+//
+//  AssetCache.cpp
+//  libraries/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetCache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+
+#include "AssetUtils.h"
+#include "NetworkLogging.h"
+
+// the use of a file is recorded in its modification time, but only this often, to not write on every hit
+static const qint64 MSECS_BETWEEN_TOUCHES = 60 * 60 * 1000;
+
+// eviction takes the cache a bit below its maximum, so it doesn't happen again on the next insert
+static const float EVICTED_CACHE_FRACTION = 0.9f;
+
+static bool isHexHash(const QString& name) {
+    if (name.length() != (int)SHA256_HASH_HEX_LENGTH) {
+        return false;
+    }
+    for (QChar c : name) {
+        ushort code = c.unicode();
+        if (!(code >= '0' && code <= '9') && !(code >= 'a' && code <= 'f')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetCache::setCacheDirectory(const QString& path) {
+    QMutexLocker locker(&_mutex);
+    _directory = path;
+    _entries.clear();
+    _size = 0;
+
+    QDir directory(path);
+    if (!directory.mkpath(".")) {
+        qCWarning(asset_client) << "Could not create the asset cache at" << path;
+        _directory.clear();
+        return;
+    }
+
+    for (const QFileInfo& info : directory.entryInfoList(QDir::Files)) {
+        if (isHexHash(info.fileName())) {
+            _entries.insert(info.fileName(), { info.size(), info.lastModified().toMSecsSinceEpoch() });
+            _size += info.size();
+        }
+    }
+    evictIfNecessary();
+}
+
+QString AssetCache::getCacheDirectory() const {
+    QMutexLocker locker(&_mutex);
+    return _directory;
+}
+
+void AssetCache::setMaximumSize(qint64 maximumSize) {
+    QMutexLocker locker(&_mutex);
+    _maximumSize = maximumSize;
+    evictIfNecessary();
+}
+
+qint64 AssetCache::getSize() const {
+    QMutexLocker locker(&_mutex);
+    return _size;
+}
+
+QByteArray AssetCache::find(const QString& hash) {
+    QMutexLocker locker(&_mutex);
+    auto itr = _entries.find(hash);
+    if (itr == _entries.end()) {
+        return QByteArray();
+    }
+
+    QFile file(getPathForHash(hash));
+    QByteArray data;
+    if (file.open(QIODevice::ReadOnly)) {
+        data = file.readAll();
+        file.close();
+    }
+    if (data.size() != itr->size || hashData(data).toHex() != hash) {
+        // damaged, or taken out from under us, it will be downloaded again
+        qCWarning(asset_client) << "Dropping bad asset" << hash << "from the cache";
+        remove(hash);
+        return QByteArray();
+    }
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - itr->lastUsed > MSECS_BETWEEN_TOUCHES && data.size() > 0 && file.open(QIODevice::ReadWrite)) {
+        // writing a byte back moves the modification time up, which is how the next session knows it was used
+        file.write(data.constData(), 1);
+    }
+    itr->lastUsed = now;
+    return data;
+}
+
+void AssetCache::insert(const QString& hash, const QByteArray& data) {
+    QMutexLocker locker(&_mutex);
+    if (_directory.isEmpty() || _entries.contains(hash) || !isHexHash(hash)) {
+        return;
+    }
+
+    QSaveFile file(getPathForHash(hash));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qCWarning(asset_client) << "Could not save asset" << hash << "to the cache";
+        return;
+    }
+
+    _entries.insert(hash, { data.size(), QDateTime::currentMSecsSinceEpoch() });
+    _size += data.size();
+    evictIfNecessary();
+}
+
+QString AssetCache::findFile(const QString& hash) {
+    QMutexLocker locker(&_mutex);
+    if (_directory.isEmpty() || !isHexHash(hash)) {
+        return QString();
+    }
+
+    QString path = getPathForHash(hash);
+    QFileInfo info(path);
+    auto itr = _entries.find(hash);
+    if (!info.isFile()) {
+        if (itr != _entries.end()) {
+            remove(hash);
+        }
+        return QString();
+    }
+    if (itr == _entries.end()) {
+        itr = _entries.insert(hash, { info.size(), info.lastModified().toMSecsSinceEpoch() });
+        _size += info.size();
+    }
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - itr->lastUsed > MSECS_BETWEEN_TOUCHES) {
+        // the same byte written back, as in find
+        QFile file(path);
+        char first;
+        if (file.open(QIODevice::ReadWrite) && file.getChar(&first) && file.seek(0)) {
+            file.putChar(first);
+        }
+    }
+    itr->lastUsed = now;
+    evictIfNecessary();
+    return _entries.contains(hash) ? path : QString();
+}
+
+QString AssetCache::getPathForHash(const QString& hash) const {
+    return _directory + "/" + hash;
+}
+
+void AssetCache::remove(const QString& hash) {
+    auto itr = _entries.find(hash);
+    if (itr != _entries.end()) {
+        _size -= itr->size;
+        _entries.erase(itr);
+    }
+    QFile::remove(getPathForHash(hash));
+}
+
+void AssetCache::evictIfNecessary() {
+    if (_size <= _maximumSize) {
+        return;
+    }
+
+    std::vector<std::pair<qint64, QString>> byLastUse;
+    byLastUse.reserve(_entries.size());
+    for (auto itr = _entries.cbegin(); itr != _entries.cend(); ++itr) {
+        byLastUse.push_back({ itr->lastUsed, itr.key() });
+    }
+    std::sort(byLastUse.begin(), byLastUse.end());
+
+    qint64 targetSize = (qint64)(EVICTED_CACHE_FRACTION * _maximumSize);
+    for (const auto& entry : byLastUse) {
+        if (_size <= targetSize) {
+            break;
+        }
+        remove(entry.second);
+    }
+}
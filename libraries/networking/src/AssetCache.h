@@ -0,0 +1,59 @@
+//
+//  AssetCache.h
+//  libraries/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetCache_h
+#define hifi_AssetCache_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+static const qint64 DEFAULT_ASSET_CACHE_SIZE = 5LL * 1024 * 1024 * 1024; // 5GB
+
+/// A content addressed disk cache for assets from the asset server.
+/// ATP assets are named by the SHA-256 hash of their contents and never change, so each is kept once by its hash,
+/// whatever extension it was asked for with, and is good for as long as it is kept. When the cache grows past its
+/// maximum size the assets that were used least recently go first, across sessions as well.
+class AssetCache {
+public:
+    void setCacheDirectory(const QString& path);
+    QString getCacheDirectory() const;
+
+    void setMaximumSize(qint64 maximumSize);
+    qint64 getSize() const;
+
+    /// \return the asset with the given hex hash, or a null array if it isn't cached
+    QByteArray find(const QString& hash);
+    void insert(const QString& hash, const QByteArray& data);
+
+    /// \return the path of the file of the asset with the given hex hash, or an empty string if it isn't cached. The file
+    /// isn't checked against the hash, for those that map it in place and check it their own way. A file put there by
+    /// another process sharing the directory is taken in, so the processes of a host map the same file.
+    QString findFile(const QString& hash);
+
+private:
+    struct Entry {
+        qint64 size;
+        qint64 lastUsed; // msecs since epoch
+    };
+
+    QString getPathForHash(const QString& hash) const;
+    void remove(const QString& hash);
+    void evictIfNecessary();
+
+    mutable QMutex _mutex;
+    QString _directory;
+    QHash<QString, Entry> _entries;
+    qint64 _size { 0 };
+    qint64 _maximumSize { DEFAULT_ASSET_CACHE_SIZE };
+};
+
+#endif // hifi_AssetCache_h
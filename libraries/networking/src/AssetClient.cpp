@@ -64,6 +64,16 @@ void AssetClient::init() {
         qCDebug(asset_client) << "AssetClient disk cache setup at" << cachePath
                                 << "(size:" << MAXIMUM_CACHE_SIZE / BYTES_PER_GIGABYTES << "GB)";
     }
+
+    // assets from the asset server are kept by hash in a cache of their own
+    if (_cache.getCacheDirectory().isEmpty()) {
+        QString cachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+        cachePath = (!cachePath.isEmpty() ? cachePath : "interfaceCache") + "/atp";
+
+        _cache.setCacheDirectory(cachePath);
+        qCDebug(asset_client) << "AssetClient asset cache setup at" << cachePath
+                                << "(size:" << DEFAULT_ASSET_CACHE_SIZE / BYTES_PER_GIGABYTES << "GB)";
+    }
 }
 
 bool haveAssetServer() {
@@ -280,6 +290,7 @@ bool AssetClient::uploadAsset(const QByteArray& data, const QString& extension,
     
     if (assetServer) {
         auto packetList = NLPacketList::create(PacketType::AssetUpload, QByteArray(), true, true);
+        packetList->setPriority(udt::PacketList::Priority::Bulk);
 
         auto messageID = ++_currentID;
         packetList->writePrimitive(messageID);
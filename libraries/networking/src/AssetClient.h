@@ -18,6 +18,7 @@
 
 #include <DependencyManager.h>
 
+#include "AssetCache.h"
 #include "AssetUtils.h"
 #include "LimitedNodeList.h"
 #include "NLPacket.h"
@@ -63,6 +64,8 @@ private:
                   ReceivedAssetCallback callback, ProgressCallback progressCallback);
     bool uploadAsset(const QByteArray& data, const QString& extension, UploadResultCallback callback);
 
+    AssetCache& getCache() { return _cache; }
+
     struct GetAssetCallbacks {
         ReceivedAssetCallback completeCallback;
         ProgressCallback progressCallback;
@@ -72,6 +75,8 @@ private:
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetAssetCallbacks>> _pendingRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetInfoCallback>> _pendingInfoRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadResultCallback>> _pendingUploads;
+
+    AssetCache _cache;
     
     friend class AssetRequest;
     friend class AssetUpload;
@@ -20,6 +20,26 @@
 #include "NodeList.h"
 #include "ResourceCache.h"
 
+// the start of an asset is asked for along with its info, so one no bigger than this arrives in a single round trip
+static const DataOffset SPECULATIVE_RANGE_SIZE = 1024 * 1024;
+
+static AssetRequest::Error toRequestError(bool responseReceived, AssetServerError serverError) {
+    if (!responseReceived) {
+        return AssetRequest::NetworkError;
+    }
+
+    switch (serverError) {
+        case AssetServerError::NoError:
+            return AssetRequest::NoError;
+        case AssetServerError::AssetNotFound:
+            return AssetRequest::NotFound;
+        case AssetServerError::InvalidByteRange:
+            return AssetRequest::InvalidByteRange;
+        default:
+            return AssetRequest::UnknownError;
+    }
+}
+
 AssetRequest::AssetRequest(const QString& hash, const QString& extension) :
     QObject(),
     _hash(hash),
@@ -39,7 +59,7 @@ void AssetRequest::start() {
     }
     
     // Try to load from cache
-    _data = loadFromCache(getUrl());
+    _data = DependencyManager::get<AssetClient>()->getCache().find(_hash);
     if (!_data.isNull()) {
         _info.hash = _hash;
         _info.size = _data.size();
@@ -51,81 +71,138 @@ void AssetRequest::start() {
     }
     
     _state = WaitingForInfo;
-    
+
+    // a bigger asset has its first range on the way while the size comes back, and the rest is asked for with the size
+    requestRange(0, SPECULATIVE_RANGE_SIZE, true);
+
+    ++_numPendingRequests;
     auto assetClient = DependencyManager::get<AssetClient>();
-    assetClient->getAssetInfo(_hash, _extension, [this](bool responseReceived, AssetServerError serverError, AssetInfo info) {
+    bool sent = assetClient->getAssetInfo(_hash, _extension, [this](bool responseReceived, AssetServerError serverError,
+                                                                    AssetInfo info) {
+        --_numPendingRequests;
         _info = info;
-        
-        if (!responseReceived) {
-            _error = NetworkError;
-        } else if (serverError != AssetServerError::NoError) {
-            switch(serverError) {
-                case AssetServerError::AssetNotFound:
-                    _error = NotFound;
-                    break;
-                default:
-                    _error = UnknownError;
-                    break;
+
+        Error error = toRequestError(responseReceived, serverError);
+        if (error != NoError) {
+            qCWarning(asset_client) << "Got error retrieving asset info for" << _hash;
+            if (_error == NoError) {
+                _error = error;
             }
         }
 
         if (_error != NoError) {
-            qCWarning(asset_client) << "Got error retrieving asset info for" << _hash;
-            _state = Finished;
-            emit finished(this);
-            
+            finishIfDone();
             return;
         }
-        
+
         _state = WaitingForData;
         _data.resize(info.size);
-        
+
         qCDebug(asset_client) << "Got size of " << _hash << " : " << info.size << " bytes";
-        
-        int start = 0, end = _info.size;
-        
-        auto assetClient = DependencyManager::get<AssetClient>();
-        assetClient->getAsset(_hash, _extension, start, end, [this, start, end](bool responseReceived, AssetServerError serverError,
-                                                                                const QByteArray& data) {
-            if (!responseReceived) {
-                _error = NetworkError;
-            } else if (serverError != AssetServerError::NoError) {
-                switch (serverError) {
-                    case AssetServerError::AssetNotFound:
-                        _error = NotFound;
-                        break;
-                    case AssetServerError::InvalidByteRange:
-                        _error = InvalidByteRange;
-                        break;
-                    default:
-                        _error = UnknownError;
-                        break;
-                }
-            } else {
-                Q_ASSERT(data.size() == (end - start));
-                
-                // we need to check the hash of the received data to make sure it matches what we expect
-                if (hashData(data).toHex() == _hash) {
-                    memcpy(_data.data() + start, data.constData(), data.size());
-                    _totalReceived += data.size();
-                    emit progress(_totalReceived, _info.size);
-                    
-                    saveToCache(getUrl(), data);
-                } else {
-                    // hash doesn't match - we have an error
-                    _error = HashVerificationFailed;
-                }
-                
-            }
-            
-            if (_error != NoError) {
-                qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
-            }
-            
-            _state = Finished;
-            emit finished(this);
-        }, [this](qint64 totalReceived, qint64 total) {
-            emit progress(totalReceived, total);
-        });
+
+        if ((DataOffset)info.size > SPECULATIVE_RANGE_SIZE) {
+            requestRange(SPECULATIVE_RANGE_SIZE, info.size, false);
+        }
+
+        if (_hasSpeculativeReply) {
+            QByteArray data;
+            data.swap(_speculativeData);
+            _hasSpeculativeReply = false;
+            handleRange(0, SPECULATIVE_RANGE_SIZE, true, _speculativeError, data);
+        }
+
+        finishIfDone();
     });
+
+    if (!sent) {
+        --_numPendingRequests;
+        _error = NetworkError;
+        finishIfDone();
+    }
+}
+
+void AssetRequest::requestRange(DataOffset start, DataOffset end, bool isSpeculative) {
+    ++_numPendingRequests;
+    auto assetClient = DependencyManager::get<AssetClient>();
+    bool sent = assetClient->getAsset(_hash, _extension, start, end, [this, start, end, isSpeculative](bool responseReceived,
+                                      AssetServerError serverError, const QByteArray& data) {
+        --_numPendingRequests;
+        Error error = toRequestError(responseReceived, serverError);
+
+        if (_state == WaitingForInfo) {
+            // only the speculative range goes out before the info, keep it until we know how big the asset is
+            _speculativeData = data;
+            _speculativeError = error;
+            _hasSpeculativeReply = true;
+        } else {
+            handleRange(start, end, isSpeculative, error, data);
+        }
+
+        finishIfDone();
+    }, [this](qint64 totalReceived, qint64 total) {
+        if (_state == WaitingForData) {
+            emit progress(_totalReceived + totalReceived, _info.size);
+        }
+    });
+
+    if (!sent) {
+        --_numPendingRequests;
+        if (_error == NoError) {
+            _error = NetworkError;
+        }
+    }
+}
+
+void AssetRequest::handleRange(DataOffset start, DataOffset end, bool isSpeculative, Error error, const QByteArray& data) {
+    if (_error != NoError) {
+        return;
+    }
+
+    DataOffset size = _info.size;
+
+    if (error == InvalidByteRange && isSpeculative) {
+        // an older asset server turns down a range that runs past the end of the asset, so ask again for what is there
+        if (size > 0) {
+            requestRange(0, std::min(end, size), false);
+        }
+        return;
+    }
+
+    if (error != NoError) {
+        _error = error;
+        return;
+    }
+
+    end = std::min(end, size);
+    if (data.size() != end - start) {
+        _error = InvalidByteRange;
+        return;
+    }
+
+    memcpy(_data.data() + start, data.constData(), data.size());
+    _totalReceived += data.size();
+    emit progress(_totalReceived, _info.size);
+}
+
+void AssetRequest::finishIfDone() {
+    // wait for every reply, so that nothing calls back into this request once it is finished
+    if (_numPendingRequests > 0 || _state == Finished) {
+        return;
+    }
+
+    if (_error == NoError) {
+        // we need to check the hash of the received data to make sure it matches what we expect
+        if (hashData(_data).toHex() == _hash) {
+            DependencyManager::get<AssetClient>()->getCache().insert(_hash, _data);
+        } else {
+            _error = HashVerificationFailed;
+        }
+    }
+
+    if (_error != NoError) {
+        qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+    }
+
+    _state = Finished;
+    emit finished(this);
 }
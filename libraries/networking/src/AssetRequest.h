@@ -53,6 +53,10 @@ signals:
     void progress(qint64 totalReceived, qint64 total);
 
 private:
+    void requestRange(DataOffset start, DataOffset end, bool isSpeculative);
+    void handleRange(DataOffset start, DataOffset end, bool isSpeculative, Error error, const QByteArray& data);
+    void finishIfDone();
+
     State _state = NotStarted;
     Error _error = NoError;
     AssetInfo _info;
@@ -61,6 +65,11 @@ private:
     QString _extension;
     QByteArray _data;
     int _numPendingRequests { 0 };
+
+    // the first range is asked for with the info, and is kept here if it arrives before the info does
+    QByteArray _speculativeData;
+    Error _speculativeError { NoError };
+    bool _hasSpeculativeReply { false };
 };
 
 #endif
@@ -11,11 +11,10 @@
 
 #include "AssetUtils.h"
 
-#include <QtCore/QCryptographicHash>
-#include <QtNetwork/QAbstractNetworkCache>
+#include <algorithm>
 
-#include "NetworkAccessManager.h"
-#include "NetworkLogging.h"
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
 
 #include "ResourceManager.h"
 
@@ -31,39 +30,27 @@ QByteArray hashData(const QByteArray& data) {
     return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
 }
 
-QByteArray loadFromCache(const QUrl& url) {
-    if (auto cache = NetworkAccessManager::getInstance().cache()) {
-        if (auto ioDevice = cache->data(url)) {
-            qCDebug(asset_client) << url.toDisplayString() << "loaded from disk cache.";
-            return ioDevice->readAll();
-        } else {
-            qCDebug(asset_client) << url.toDisplayString() << "not in disk cache";
-        }
-    } else {
-        qCWarning(asset_client) << "No disk cache to load assets from.";
+QByteArray hashFile(QFile& file) {
+    QCryptographicHash hash { QCryptographicHash::Sha256 };
+
+    if (!file.isOpen() && !file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
     }
-    return QByteArray();
-}
 
-bool saveToCache(const QUrl& url, const QByteArray& file) {
-    if (auto cache = NetworkAccessManager::getInstance().cache()) {
-        if (!cache->metaData(url).isValid()) {
-            QNetworkCacheMetaData metaData;
-            metaData.setUrl(url);
-            metaData.setSaveToDisk(true);
-            metaData.setLastModified(QDateTime::currentDateTime());
-            metaData.setExpirationDate(QDateTime()); // Never expires
-            
-            if (auto ioDevice = cache->prepare(metaData)) {
-                ioDevice->write(file);
-                cache->insert(ioDevice);
-                qCDebug(asset_client) << url.toDisplayString() << "saved to disk cache";
-                return true;
-            }
-            qCWarning(asset_client) << "Could not save" << url.toDisplayString() << "to disk cache.";
+    qint64 size = file.size();
+    uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+
+    if (mapped) {
+        // addData takes an int length, so a file over 2GB goes in a block at a time
+        const qint64 BLOCK_SIZE = 64 * 1024 * 1024;
+        for (qint64 offset = 0; offset < size; offset += BLOCK_SIZE) {
+            hash.addData(reinterpret_cast<const char*>(mapped) + offset, (int)std::min(BLOCK_SIZE, size - offset));
         }
+        file.unmap(mapped);
     } else {
-        qCWarning(asset_client) << "No disk cache to save assets to.";
+        file.seek(0);
+        hash.addData(&file);
     }
-    return false;
+
+    return hash.result();
 }
@@ -17,6 +17,8 @@
 #include <QtCore/QByteArray>
 #include <QtCore/QUrl>
 
+class QFile;
+
 using MessageID = uint32_t;
 using DataOffset = int64_t;
 
@@ -36,7 +38,7 @@ QUrl getATPUrl(const QString& hash, const QString& extension = QString());
 
 QByteArray hashData(const QByteArray& data);
 
-QByteArray loadFromCache(const QUrl& url);
-bool saveToCache(const QUrl& url, const QByteArray& file);
+// hashes the file where it lies, mapped into memory when it can be, so that it is never read into one big buffer
+QByteArray hashFile(QFile& file);
 
 #endif
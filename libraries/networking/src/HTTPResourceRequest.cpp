@@ -38,6 +38,13 @@ void HTTPResourceRequest::doSend() {
         networkRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
     }
 
+    // requests to one host share a connection where the server can multiplex them, rather than each waiting for one
+    // of the few connections per host
+    networkRequest.setAttribute(QNetworkRequest::SpdyAllowedAttribute, true);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    networkRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
+
     _reply = NetworkAccessManager::getInstance().get(networkRequest);
     
     connect(_reply, &QNetworkReply::finished, this, &HTTPResourceRequest::onRequestFinished);
@@ -109,6 +109,11 @@ LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short
     using std::placeholders::_1;
     _nodeSocket.setPacketFilterOperator(std::bind(&LimitedNodeList::isPacketVerified, this, _1));
 
+    // lost audio can be rebuilt from parity when a receiver asks for it
+    _nodeSocket.setForwardErrorCorrectionFilter([](const udt::Packet& packet) {
+        return FEC_PROTECTED_PACKETS.contains(NLPacket::typeInHeader(packet));
+    });
+
     _packetStatTimer.start();
 
     if (_stunSockAddr.getAddress().isNull()) {
@@ -226,11 +231,9 @@ bool LimitedNodeList::packetSourceAndHashMatch(const udt::Packet& packet) {
         if (matchingNode) {
             if (!NON_VERIFIED_PACKETS.contains(headerType)) {
 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, matchingNode->getConnectionSecret());
-
-                // check if the md5 hash in the header matches the hash we would expect
-                if (packetHeaderHash != expectedHash) {
+                // check if the hash in the header matches the hash we would expect
+                if (!NLPacket::verificationHashMatches(packet, matchingNode->getConnectionSecret(),
+                                                       _packetVerificationMode)) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
@@ -276,7 +279,7 @@ void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& conn
     if (!connectionSecret.isNull()
         && !NON_SOURCED_PACKETS.contains(packet.getType())
         && !NON_VERIFIED_PACKETS.contains(packet.getType())) {
-        packet.writeVerificationHashGivenSecret(connectionSecret);
+        packet.writeVerificationHashGivenSecret(connectionSecret, _packetVerificationMode);
     }
 }
 
@@ -345,6 +348,7 @@ qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const Node& des
 
         // close the last packet in the list
         packetList.closeCurrentPacket();
+        Q_ASSERT_X(!packetList.isStreaming(), "LimitedNodeList::sendPacketList", "streamed lists go to the send queue");
 
         while (!packetList._packets.empty()) {
             bytesSent += sendPacket(packetList.takeFront<NLPacket>(), *activeSocket, connectionSecret);
@@ -365,6 +369,7 @@ qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const HifiSockA
 
     // close the last packet in the list
     packetList.closeCurrentPacket();
+    Q_ASSERT_X(!packetList.isStreaming(), "LimitedNodeList::sendPacketList", "streamed lists go to the send queue");
 
     while (!packetList._packets.empty()) {
         bytesSent += sendPacket(packetList.takeFront<NLPacket>(), sockAddr, connectionSecret);
@@ -383,6 +388,13 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
         fillPacketHeader(*nlPacket);
     }
 
+    if (packetList->isStreaming()) {
+        // the packets streamed later are made on the send queue's thread, where the stats aren't collected
+        packetList->setStreamedPacketWriter([this](udt::Packet& packet) {
+            fillPacketHeader(static_cast<NLPacket&>(packet));
+        });
+    }
+
     return _nodeSocket.writePacketList(std::move(packetList), sockAddr);
 }
 
@@ -398,6 +410,14 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
             fillPacketHeader(*nlPacket, destinationNode.getConnectionSecret());
         }
 
+        if (packetList->isStreaming()) {
+            // the packets streamed later are made on the send queue's thread, where the stats aren't collected
+            QUuid connectionSecret = destinationNode.getConnectionSecret();
+            packetList->setStreamedPacketWriter([this, connectionSecret](udt::Packet& packet) {
+                fillPacketHeader(static_cast<NLPacket&>(packet), connectionSecret);
+            });
+        }
+
         return _nodeSocket.writePacketList(std::move(packetList), *activeSocket);
     } else {
         qCDebug(networking) << "LimitedNodeList::sendPacketList called without active socket for node. Not sending.";
@@ -459,6 +479,8 @@ void LimitedNodeList::eraseAllNodes() {
                 killedNodes.insert(it->second);
                 it = _nodeHash.unsafe_erase(it);
             }
+
+            updateNodeSnapshot();
         }
     }
 
@@ -467,6 +489,18 @@ void LimitedNodeList::eraseAllNodes() {
     }
 }
 
+void LimitedNodeList::updateNodeSnapshot() {
+    // called with the node lock held for writing, readers keep whichever snapshot they already picked up
+    auto snapshot = std::make_shared<NodeSnapshot>();
+    snapshot->reserve(_nodeHash.size());
+
+    for (auto it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
+        snapshot->push_back(it->second);
+    }
+
+    std::atomic_store(&_nodeSnapshot, std::shared_ptr<const NodeSnapshot>(std::move(snapshot)));
+}
+
 void LimitedNodeList::reset() {
     eraseAllNodes();
 
@@ -486,6 +520,7 @@ bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
         {
             QWriteLocker writeLocker(&_nodeMutex);
             _nodeHash.unsafe_erase(it);
+            updateNodeSnapshot();
         }
 
         handleNodeKill(matchingNode);
@@ -539,7 +574,11 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 
         SharedNodePointer newNodePointer(newNode, &QObject::deleteLater);
 
-        _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
+        {
+            QWriteLocker writeLocker(&_nodeMutex);
+            _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
+            updateNodeSnapshot();
+        }
 
         qCDebug(networking) << "Added" << *newNode;
 
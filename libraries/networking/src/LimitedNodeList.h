@@ -13,10 +13,12 @@
 #define hifi_LimitedNodeList_h
 
 #include <assert.h>
+#include <atomic>
 #include <stdint.h>
 #include <iterator>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
@@ -65,6 +67,9 @@ using namespace tbb;
 typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
 typedef concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
 
+// every node at one point in time, what eachNode and friends iterate without taking the node lock
+typedef std::vector<SharedNodePointer> NodeSnapshot;
+
 typedef quint8 PingType_t;
 namespace PingType {
     const PingType_t Agnostic = 0;
@@ -109,8 +114,13 @@ public:
 
     bool getThisNodeCanRez() const { return _thisNodeCanRez; }
     void setThisNodeCanRez(bool canRez);
+
+    // how sourced packets to and from the other nodes in the domain are verified
+    NLPacket::VerificationMode getPacketVerificationMode() const { return _packetVerificationMode; }
+    void setPacketVerificationMode(NLPacket::VerificationMode mode) { _packetVerificationMode = mode; }
     
     quint16 getSocketLocalPort() const { return _nodeSocket.localPort(); }
+    udt::Socket& getNodeSocket() { return _nodeSocket; }
     QUdpSocket& getDTLSSocket();
 
     PacketReceiver& getPacketReceiver() { return *_packetReceiver; }
@@ -166,32 +176,36 @@ public:
 
     SharedNodePointer findNodeWithAddr(const HifiSockAddr& addr);
     
+    // the nodes as of the last time one was added or removed, picked up with a single atomic load so iterating
+    // them never waits on (or holds up) a node being added or killed
+    std::shared_ptr<const NodeSnapshot> getNodeSnapshot() const { return std::atomic_load(&_nodeSnapshot); }
+
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const auto& node : *snapshot) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const auto& node : *snapshot) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const auto& node : *snapshot) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -199,11 +213,11 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (const auto& node : *snapshot) {
+            if (predicate(node)) {
+                return node;
             }
         }
 
@@ -276,6 +290,7 @@ protected:
     QUuid _sessionUUID;
     NodeHash _nodeHash;
     QReadWriteLock _nodeMutex;
+    std::shared_ptr<const NodeSnapshot> _nodeSnapshot { std::make_shared<NodeSnapshot>() };
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -291,6 +306,7 @@ protected:
     QElapsedTimer _packetStatTimer;
     bool _thisNodeCanAdjustLocks;
     bool _thisNodeCanRez;
+    std::atomic<NLPacket::VerificationMode> _packetVerificationMode { NLPacket::VerificationMode::MD5 };
 
     QPointer<QTimer> _initialSTUNTimer;
 
@@ -311,7 +327,11 @@ protected:
         while (it != _nodeHash.end()) {
             functor(it);
         }
+
+        updateNodeSnapshot();
     }
+
+    void updateNodeSnapshot();
     
 private slots:
     void flagTimeForConnectionStep(ConnectionStep connectionStep, quint64 timestamp);
@@ -11,6 +11,8 @@
 
 #include "NLPacket.h"
 
+#include <SipHash.h>
+
 int NLPacket::localHeaderSize(PacketType type) {
     bool nonSourced = NON_SOURCED_PACKETS.contains(type);
     bool nonVerified = NON_VERIFIED_PACKETS.contains(type);
@@ -32,7 +34,7 @@ std::unique_ptr<NLPacket> NLPacket::create(PacketType type, qint64 size, bool is
     return packet;
 }
 
-std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(udt::PacketBuffer data, qint64 size,
                                                        const HifiSockAddr& senderSockAddr) {
     // Fail with null data
     Q_ASSERT(data);
@@ -87,7 +89,7 @@ NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
     _sourceID = other._sourceID;
 }
 
-NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+NLPacket::NLPacket(udt::PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     Packet(std::move(data), size, senderSockAddr)
 {    
     // sanity check before we decrease the payloadSize with the payloadCapacity
@@ -149,11 +151,39 @@ QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
     return QByteArray(packet.getData() + offset, NUM_BYTES_MD5_HASH);
 }
 
-QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret) {
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    
-    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+static int verifiedDataOffset(const udt::Packet& packet) {
+    return Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
         + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
+}
+
+static void sipHashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret,
+                                      uint8_t hash[SIPHASH_128_BYTES]) {
+    // the secret in its RFC 4122 byte order is the key, without going through a QByteArray
+    uint8_t key[SIPHASH_KEY_BYTES] = {
+        (uint8_t)(connectionSecret.data1 >> 24), (uint8_t)(connectionSecret.data1 >> 16),
+        (uint8_t)(connectionSecret.data1 >> 8), (uint8_t)connectionSecret.data1,
+        (uint8_t)(connectionSecret.data2 >> 8), (uint8_t)connectionSecret.data2,
+        (uint8_t)(connectionSecret.data3 >> 8), (uint8_t)connectionSecret.data3
+    };
+    memcpy(key + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+
+    int offset = verifiedDataOffset(packet);
+    sipHash128(key, packet.getData() + offset, packet.getDataSize() - offset, hash);
+}
+
+QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret,
+                                            VerificationMode mode) {
+    int offset = verifiedDataOffset(packet);
+
+    if (mode == VerificationMode::SipHash) {
+        static_assert(SIPHASH_128_BYTES == NUM_BYTES_MD5_HASH, "The MAC has to fill the hash in the header");
+
+        uint8_t hash[SIPHASH_128_BYTES];
+        sipHashForPacketAndSecret(packet, connectionSecret, hash);
+        return QByteArray(reinterpret_cast<const char*>(hash), SIPHASH_128_BYTES);
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
     
     // add the packet payload and the connection UUID
     hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
@@ -163,6 +193,20 @@ QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUu
     return hash.result();
 }
 
+bool NLPacket::verificationHashMatches(const udt::Packet& packet, const QUuid& connectionSecret, VerificationMode mode) {
+    int hashOffset = verifiedDataOffset(packet) - NUM_BYTES_MD5_HASH;
+
+    if (mode == VerificationMode::SipHash) {
+        // compare in place, this runs for every sourced packet we receive
+        uint8_t hash[SIPHASH_128_BYTES];
+        sipHashForPacketAndSecret(packet, connectionSecret, hash);
+        return memcmp(packet.getData() + hashOffset, hash, SIPHASH_128_BYTES) == 0;
+    }
+
+    QByteArray expectedHash = hashForPacketAndSecret(packet, connectionSecret, mode);
+    return memcmp(packet.getData() + hashOffset, expectedHash.constData(), NUM_BYTES_MD5_HASH) == 0;
+}
+
 void NLPacket::writeTypeAndVersion() {
     auto headerOffset = Packet::totalHeaderSize(isPartOfMessage());
     
@@ -207,12 +251,18 @@ void NLPacket::writeSourceID(const QUuid& sourceID) const {
     _sourceID = sourceID;
 }
 
-void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret) const {
+void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret, VerificationMode mode) const {
     Q_ASSERT(!NON_SOURCED_PACKETS.contains(_type) && !NON_VERIFIED_PACKETS.contains(_type));
     
     auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
                 + NUM_BYTES_RFC4122_UUID;
-    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
+
+    if (mode == VerificationMode::SipHash) {
+        sipHashForPacketAndSecret(*this, connectionSecret, reinterpret_cast<uint8_t*>(_packet.get() + offset));
+        return;
+    }
+
+    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret, mode);
     
     memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
 }
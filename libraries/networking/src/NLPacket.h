@@ -29,7 +29,7 @@ public:
     static std::unique_ptr<NLPacket> create(PacketType type, qint64 size = -1,
                                             bool isReliable = false, bool isPartOfMessage = false);
     
-    static std::unique_ptr<NLPacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+    static std::unique_ptr<NLPacket> fromReceivedPacket(udt::PacketBuffer data, qint64 size,
                                                         const HifiSockAddr& senderSockAddr);
     static std::unique_ptr<NLPacket> fromBase(std::unique_ptr<Packet> packet);
     
@@ -46,9 +46,19 @@ public:
     static PacketType typeInHeader(const udt::Packet& packet);
     static PacketVersion versionInHeader(const udt::Packet& packet);
     
+    // how the verification hash of a sourced packet is made out of the packet and the connection secret,
+    // the domain-server picks the one every node in the domain uses
+    enum class VerificationMode : quint8 {
+        MD5,
+        SipHash // a 128 bit SipHash-2-4 MAC keyed with the secret, several times cheaper than MD5
+    };
+
     static QUuid sourceIDInHeader(const udt::Packet& packet);
     static QByteArray verificationHashInHeader(const udt::Packet& packet);
-    static QByteArray hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret);
+    static QByteArray hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret,
+                                             VerificationMode mode = VerificationMode::MD5);
+    static bool verificationHashMatches(const udt::Packet& packet, const QUuid& connectionSecret,
+                                        VerificationMode mode = VerificationMode::MD5);
     
     PacketType getType() const { return _type; }
     void setType(PacketType type);
@@ -58,12 +68,13 @@ public:
     const QUuid& getSourceID() const { return _sourceID; }
     
     void writeSourceID(const QUuid& sourceID) const;
-    void writeVerificationHashGivenSecret(const QUuid& connectionSecret) const;
+    void writeVerificationHashGivenSecret(const QUuid& connectionSecret,
+                                          VerificationMode mode = VerificationMode::MD5) const;
 
 protected:
     
     NLPacket(PacketType type, qint64 size = -1, bool forceReliable = false, bool isPartOfMessage = false);
-    NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr);
+    NLPacket(udt::PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr);
     
     NLPacket(const NLPacket& other);
     NLPacket(NLPacket&& other);
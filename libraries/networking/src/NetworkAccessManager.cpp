@@ -9,11 +9,14 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QSet>
 #include <QThreadStorage>
 
 #include "NetworkAccessManager.h"
+#include "ResourceManager.h"
 
 QThreadStorage<QNetworkAccessManager*> networkAccessManagers;
+QThreadStorage<QSet<QString>> preconnectedHosts;
 
 QNetworkAccessManager& NetworkAccessManager::getInstance() {
     if (!networkAccessManagers.hasLocalData()) {
@@ -23,3 +26,29 @@ QNetworkAccessManager& NetworkAccessManager::getInstance() {
     
     return *networkAccessManagers.localData();
 }
+
+void NetworkAccessManager::preconnect(const QUrl& url) {
+    const int HTTP_PORT = 80;
+    const int HTTPS_PORT = 443;
+
+    QString scheme = url.scheme();
+    if ((scheme != URL_SCHEME_HTTP && scheme != URL_SCHEME_HTTPS) || url.host().isEmpty()) {
+        return;
+    }
+
+    // the manager keeps an idle connection open for a while, so the requests that follow skip the handshakes
+    QString hostKey = scheme + "://" + url.host() + ":" + QString::number(url.port());
+    QSet<QString>& hosts = preconnectedHosts.localData();
+    if (hosts.contains(hostKey)) {
+        return;
+    }
+    hosts.insert(hostKey);
+
+#ifndef QT_NO_SSL
+    if (scheme == URL_SCHEME_HTTPS) {
+        getInstance().connectToHostEncrypted(url.host(), url.port(HTTPS_PORT));
+        return;
+    }
+#endif
+    getInstance().connectToHost(url.host(), url.port(HTTP_PORT));
+}
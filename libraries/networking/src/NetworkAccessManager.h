@@ -12,6 +12,7 @@
 #ifndef hifi_NetworkAccessManager_h
 #define hifi_NetworkAccessManager_h
 
+#include <QtCore/QUrl>
 #include <QtNetwork/QNetworkAccessManager>
 
 /// Wrapper around QNetworkAccessManager to restrict at one instance by thread
@@ -19,6 +20,10 @@ class NetworkAccessManager : public QObject {
     Q_OBJECT
 public:
     static QNetworkAccessManager& getInstance();
+
+    /// Opens a connection to the URL's host ahead of the first request to it, on this thread's manager. Does nothing
+    /// for a host it has already been asked about, or for a URL that isn't http or https.
+    static void preconnect(const QUrl& url);
 };
 
 #endif // hifi_NetworkAccessManager_h
\ No newline at end of file
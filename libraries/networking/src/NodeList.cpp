@@ -95,6 +95,9 @@ NodeList::NodeList(char newOwnerType, unsigned short socketListenPort, unsigned
     connect(&_domainHandler, SIGNAL(connectedToDomain(QString)), &_keepAlivePingTimer, SLOT(start()));
     connect(&_domainHandler, &DomainHandler::disconnectedFromDomain, &_keepAlivePingTimer, &QTimer::stop);
 
+    // pick the congestion control the domain asks for once we have its settings
+    connect(&_domainHandler, &DomainHandler::settingsReceived, this, &NodeList::updateCongestionControl);
+
     // we definitely want STUN to update our public socket, so call the LNL to kick that off
     startSTUNPublicSocketUpdate();
 
@@ -519,6 +522,11 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     quint8 thisNodeCanRez;
     packetStream >> thisNodeCanRez;
     setThisNodeCanRez((bool) thisNodeCanRez);
+
+    // the domain decides how the packets we exchange with the other nodes are verified
+    quint8 packetVerificationMode;
+    packetStream >> packetVerificationMode;
+    setPacketVerificationMode((NLPacket::VerificationMode) packetVerificationMode);
     
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
@@ -655,6 +663,24 @@ void NodeList::stopKeepalivePingTimer() {
     }
 }
 
+void NodeList::updateCongestionControl(const QJsonObject& settingsObject) {
+    static const QString METAVERSE_GROUP_KEY = "metaverse";
+    static const QString CONGESTION_CONTROL_KEY = "congestion_control";
+    static const QString BBR_CONGESTION_CONTROL = "bbr";
+
+    QString congestionControl = settingsObject[METAVERSE_GROUP_KEY].toObject()[CONGESTION_CONTROL_KEY].toString();
+
+    // this applies to the connections made from here on, the ones already up keep the controller they started with
+    if (congestionControl == BBR_CONGESTION_CONTROL) {
+        qCDebug(networking) << "Using model-based (BBR) congestion control for new connections";
+        _nodeSocket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+            new udt::CongestionControlFactory<udt::BBRCC>()));
+    } else {
+        _nodeSocket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+            new udt::CongestionControlFactory<udt::DefaultCC>()));
+    }
+}
+
 void NodeList::sendKeepAlivePings() {
     eachMatchingNode([this](const SharedNodePointer& node)->bool {
         return _nodeTypesOfInterest.contains(node->getType());
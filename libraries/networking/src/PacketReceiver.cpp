@@ -12,13 +12,127 @@
 
 #include "PacketReceiver.h"
 
+#include <QMetaEnum>
 #include <QMutexLocker>
+#include <QThread>
+
+#include <shared/Trace.h>
 
 #include "DependencyManager.h"
 #include "NetworkLogging.h"
 #include "NodeList.h"
 #include "SharedUtil.h"
 
+// the names of the packet types are those moc keeps for the enum, looked up once for each type
+static const char* traceNameForPacketType(PacketType type) {
+    static std::atomic<const char*> names[256];
+    const char* name = names[(uint8_t)type].load(std::memory_order_relaxed);
+    if (!name) {
+        static const QMetaEnum metaEnum =
+            PacketTypeEnum::staticMetaObject.enumerator(PacketTypeEnum::staticMetaObject.indexOfEnumerator("Value"));
+        name = metaEnum.valueToKey((int)type);
+        if (!name) {
+            name = "Unknown";
+        }
+        names[(uint8_t)type].store(name, std::memory_order_relaxed);
+    }
+    return name;
+}
+
+static bool invokeListener(QObject* object, const QMetaMethod& metaMethod, Qt::ConnectionType connectionType,
+                           QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer sourceNode) {
+    // only the listeners run right here are traced, not those the packet is posted to
+    bool isTraced = trace::isActive() &&
+        (connectionType == Qt::DirectConnection || object->thread() == QThread::currentThread());
+    TRACE_SCOPE(isTraced ? traceNameForPacketType(receivedMessage->getType()) : nullptr);
+
+    if (!sourceNode) {
+        return metaMethod.invoke(object, connectionType, Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
+    }
+
+    static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
+    static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
+
+    if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
+        return metaMethod.invoke(object,
+                                 connectionType,
+                                 Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                 Q_ARG(SharedNodePointer, sourceNode));
+
+    } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
+        return metaMethod.invoke(object,
+                                 connectionType,
+                                 Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                 Q_ARG(QSharedPointer<Node>, sourceNode));
+
+    } else {
+        return metaMethod.invoke(object,
+                                 connectionType,
+                                 Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
+    }
+}
+
+struct PacketListenerQueue::Entry {
+    QSharedPointer<ReceivedMessage> message;
+    SharedNodePointer sourceNode;
+    QMetaMethod method;
+    Entry* next;
+};
+
+PacketListenerQueue::PacketListenerQueue(QObject* listener) :
+    _listener(listener)
+{
+
+}
+
+PacketListenerQueue::~PacketListenerQueue() {
+    Entry* entry = _head.exchange(nullptr);
+    while (entry) {
+        Entry* next = entry->next;
+        delete entry;
+        entry = next;
+    }
+}
+
+void PacketListenerQueue::push(QSharedPointer<ReceivedMessage> message, SharedNodePointer sourceNode,
+                               const QMetaMethod& method) {
+    Entry* entry = new Entry { message, sourceNode, method, _head.load(std::memory_order_relaxed) };
+    while (!_head.compare_exchange_weak(entry->next, entry, std::memory_order_release, std::memory_order_relaxed)) {
+        // entry->next now holds the head another producer just pushed, try again on top of it
+    }
+
+    // only the push that finds the queue empty signals, the drain that follows takes everything pushed until then
+    if (!entry->next) {
+        emit messagesQueued();
+    }
+}
+
+void PacketListenerQueue::drain() {
+    // take everything queued so far in one go, then put it back in the order it came in
+    Entry* entry = _head.exchange(nullptr, std::memory_order_acquire);
+
+    Entry* oldestFirst = nullptr;
+    while (entry) {
+        Entry* next = entry->next;
+        entry->next = oldestFirst;
+        oldestFirst = entry;
+        entry = next;
+    }
+
+    while (oldestFirst) {
+        Entry* next = oldestFirst->next;
+
+        if (_listener && !invokeListener(_listener, oldestFirst->method, Qt::DirectConnection,
+                                         oldestFirst->message, oldestFirst->sourceNode)) {
+            qCDebug(networking).nospace() << "Error delivering packet " << oldestFirst->message->getType()
+                << " to listener " << _listener.data() << "::" << qPrintable(oldestFirst->method.methodSignature());
+        }
+
+        delete oldestFirst;
+        oldestFirst = next;
+    }
+}
+
 PacketReceiver::PacketReceiver(QObject* parent) : QObject(parent) {
     qRegisterMetaType<QSharedPointer<NLPacket>>();
     qRegisterMetaType<QSharedPointer<NLPacketList>>();
@@ -178,6 +292,25 @@ void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object,
     _messageListenerMap[type] = { QPointer<QObject>(object), slot, deliverPending };
 }
 
+QSharedPointer<PacketListenerQueue> PacketReceiver::queueForListener(QObject* listener) {
+    // every type a listener is registered for shares one queue so its messages stay in the order they came in
+    auto& queue = _listenerQueues[listener];
+    if (!queue || !queue->getListener()) {
+        queue = QSharedPointer<PacketListenerQueue>::create(listener);
+
+        // the listener is the context of the connection, so the drain happens on whichever thread it lives on by the
+        // time the messages come in - and the drain keeps the queue alive even if it is unregistered in the meantime
+        QWeakPointer<PacketListenerQueue> weakQueue = queue;
+        connect(queue.data(), &PacketListenerQueue::messagesQueued, listener, [weakQueue] {
+            auto queue = weakQueue.toStrongRef();
+            if (queue) {
+                queue->drain();
+            }
+        });
+    }
+    return queue;
+}
+
 void PacketReceiver::unregisterListener(QObject* listener) {
     Q_ASSERT_X(listener, "PacketReceiver::unregisterListener", "No listener to unregister");
     
@@ -194,6 +327,8 @@ void PacketReceiver::unregisterListener(QObject* listener) {
                 ++it;
             }
         }
+
+        _listenerQueues.remove(listener);
     }
     
     QMutexLocker directConnectSetLocker(&_directConnectSetMutex);
@@ -210,11 +345,12 @@ void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
     
     // setup an NLPacket from the packet we were passed
     auto nlPacket = NLPacket::fromBase(std::move(packet));
-    auto receivedMessage = QSharedPointer<ReceivedMessage>::create(*nlPacket);
 
     _inPacketCount += 1;
     _inByteCount += nlPacket->size();
 
+    auto receivedMessage = QSharedPointer<ReceivedMessage>::create(std::move(nlPacket));
+
     handleVerifiedMessage(receivedMessage, true);
 }
 
@@ -230,14 +366,14 @@ void PacketReceiver::handleVerifiedMessagePacket(std::unique_ptr<udt::Packet> pa
 
     if (it == _pendingMessages.end()) {
         // Create message
-        message = QSharedPointer<ReceivedMessage>::create(*nlPacket);
+        message = QSharedPointer<ReceivedMessage>::create(std::move(nlPacket));
         if (!message->isComplete()) {
             _pendingMessages[key] = message;
         }
         handleVerifiedMessage(message, true);
     } else {
         message = it->second;
-        message->appendPacket(*nlPacket);
+        message->appendPacket(std::move(nlPacket));
 
         if (message->isComplete()) {
             _pendingMessages.erase(it);
@@ -296,46 +432,27 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
             if (matchingNode) {
                 emit dataReceived(matchingNode->getType(), receivedMessage->getSize());
                 matchingNode->recordBytesReceived(receivedMessage->getSize());
-
-                QMetaMethod metaMethod = listener.method;
-                
-                static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
-                static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
-                
-                // one final check on the QPointer before we go to invoke
-                if (listener.object) {
-                    if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
-                        success = metaMethod.invoke(listener.object,
-                                                    connectionType,
-                                                    Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                                    Q_ARG(SharedNodePointer, matchingNode));
-                        
-                    } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
-                        success = metaMethod.invoke(listener.object,
-                                                    connectionType,
-                                                    Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                                    Q_ARG(QSharedPointer<Node>, matchingNode));
-                        
-                    } else {
-                        success = metaMethod.invoke(listener.object,
-                                                    connectionType,
-                                                    Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
-                    }
-                } else {
-                    listenerIsDead = true;
-                }
             } else {
                 // qDebug() << "Got verified unsourced packet list: " << QString(nlPacketList->getMessage());
                 emit dataReceived(NodeType::Unassigned, receivedMessage->getSize());
-                
-                // one final check on the QPointer before we invoke
-                if (listener.object) {
-                    success = listener.method.invoke(listener.object,
-                                                     Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
+            }
+
+            // one final check on the QPointer before we go to invoke
+            if (listener.object) {
+                if (_shouldDeliverInBatches && connectionType != Qt::DirectConnection
+                    && listener.object->thread() != QThread::currentThread()) {
+                    // hand it to the listener's queue, its thread picks it up with everything else queued for it
+                    if (!it->queue) {
+                        it->queue = queueForListener(listener.object);
+                    }
+                    it->queue->push(receivedMessage, matchingNode, listener.method);
+                    success = true;
                 } else {
-                    listenerIsDead = true;
+                    success = invokeListener(listener.object, listener.method, connectionType,
+                                             receivedMessage, matchingNode);
                 }
-                
+            } else {
+                listenerIsDead = true;
             }
             
             if (!success) {
@@ -351,6 +468,16 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
             qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
                 << " has been destroyed. Removing from listener map.";
             it = _messageListenerMap.erase(it);
+
+            // drop its queue as well, along with any other queue whose listener is gone
+            auto queueIt = _listenerQueues.begin();
+            while (queueIt != _listenerQueues.end()) {
+                if (!queueIt.value()->getListener()) {
+                    queueIt = _listenerQueues.erase(queueIt);
+                } else {
+                    ++queueIt;
+                }
+            }
             
             // if it exists, remove the listener from _directlyConnectedObjects
             {
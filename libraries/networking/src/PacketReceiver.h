@@ -13,6 +13,7 @@
 #ifndef hifi_PacketReceiver_h
 #define hifi_PacketReceiver_h
 
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 
@@ -29,6 +30,7 @@
 #include "udt/PacketHeaders.h"
 
 class EntityEditPacketSender;
+class Node;
 class OctreePacketProcessor;
 
 namespace std {
@@ -40,6 +42,32 @@ namespace std {
     };
 }
 
+// The messages for one listener that lives on another thread, handed over without locking. Whenever the queue goes
+// from empty to not empty it signals the listener's thread once, which then handles everything queued so far.
+class PacketListenerQueue : public QObject {
+    Q_OBJECT
+public:
+    PacketListenerQueue(QObject* listener);
+    ~PacketListenerQueue();
+
+    // called from the network thread
+    void push(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> sourceNode, const QMetaMethod& method);
+
+    // called on the listener's thread
+    void drain();
+
+    QObject* getListener() const { return _listener.data(); }
+
+signals:
+    void messagesQueued();
+
+private:
+    struct Entry;
+
+    QPointer<QObject> _listener;
+    std::atomic<Entry*> _head { nullptr }; // most recently pushed first
+};
+
 class PacketReceiver : public QObject {
     Q_OBJECT
 public:
@@ -54,6 +82,10 @@ public:
     int getInByteCount() const { return _inByteCount; }
 
     void setShouldDropPackets(bool shouldDropPackets) { _shouldDropPackets = shouldDropPackets; }
+
+    // When enabled the messages for listeners on other threads are queued per listener and handled a batch at a time
+    // on the listener's thread, instead of Qt posting an event for every single one of them
+    void setShouldDeliverInBatches(bool shouldDeliverInBatches) { _shouldDeliverInBatches = shouldDeliverInBatches; }
     
     void resetCounters() { _inPacketCount = 0; _inByteCount = 0; }
 
@@ -76,8 +108,11 @@ private:
         QPointer<QObject> object;
         QMetaMethod method;
         bool deliverPending;
+        QSharedPointer<PacketListenerQueue> queue;
     };
 
+    QSharedPointer<PacketListenerQueue> queueForListener(QObject* listener);
+
     void handleVerifiedMessage(QSharedPointer<ReceivedMessage> message, bool justReceived);
 
     // these are brutal hacks for now - ideally GenericThread / ReceivedPacketProcessor
@@ -93,6 +128,8 @@ private:
     int _inPacketCount = 0;
     int _inByteCount = 0;
     bool _shouldDropPackets = false;
+    bool _shouldDeliverInBatches = false;
+    QHash<QObject*, QSharedPointer<PacketListenerQueue>> _listenerQueues;
     QMutex _directConnectSetMutex;
     QSet<QObject*> _directlyConnectedObjects;
 
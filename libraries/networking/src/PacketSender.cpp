@@ -57,7 +57,7 @@ void PacketSender::queuePacketForSending(const SharedNodePointer& destinationNod
     unlock();
 
     // Make sure to  wake our actual processing thread because we  now have packets for it to process.
-    _hasPackets.wakeAll();
+    wakeUp();
 }
 
 void PacketSender::setPacketsPerSecond(int packetsPerSecond) {
@@ -73,6 +73,12 @@ bool PacketSender::process() {
 }
 
 void PacketSender::terminating() {
+    wakeUp();
+}
+
+void PacketSender::wakeUp() {
+    // holding the wait mutex means the wake can't fall between threadedProcess() finding no packets and its wait
+    QMutexLocker locker(&_waitingOnPacketsMutex);
     _hasPackets.wakeAll();
 }
 
@@ -120,7 +126,12 @@ bool PacketSender::threadedProcess() {
     if (!hasSlept) {
         // wait till we have packets
         _waitingOnPacketsMutex.lock();
-        _hasPackets.wait(&_waitingOnPacketsMutex);
+        lock();
+        bool hasPackets = !_packets.empty();
+        unlock();
+        if (!hasPackets && isStillRunning()) {
+            _hasPackets.wait(&_waitingOnPacketsMutex);
+        }
         _waitingOnPacketsMutex.unlock();
     }
 
@@ -104,6 +104,7 @@ private:
 
     bool threadedProcess();
     bool nonThreadedProcess();
+    void wakeUp();
 
     quint64 _lastPPSCheck;
     int _packetsOverCheckInterval;
@@ -12,6 +12,8 @@
 
 #include "ReceivedMessage.h"
 
+#include <algorithm>
+
 #include "QSharedPointer"
 
 static int receivedMessageMetaTypeId = qRegisterMetaType<ReceivedMessage*>("ReceivedMessage*");
@@ -29,18 +31,24 @@ ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
       _senderSockAddr(packetList.getSenderSockAddr()),
       _isComplete(true)
 {
+    appendChunk(_data);
 }
 
-ReceivedMessage::ReceivedMessage(NLPacket& packet)
-    : _data(packet.readAll()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
-      _numPackets(1),
-      _sourceID(packet.getSourceID()),
-      _packetType(packet.getType()),
-      _packetVersion(packet.getVersion()),
-      _senderSockAddr(packet.getSenderSockAddr()),
-      _isComplete(packet.getPacketPosition() == NLPacket::ONLY)
+ReceivedMessage::ReceivedMessage(std::unique_ptr<NLPacket> packet)
+    : _numPackets(1),
+      _sourceID(packet->getSourceID()),
+      _packetType(packet->getType()),
+      _packetVersion(packet->getVersion()),
+      _senderSockAddr(packet->getSenderSockAddr()),
+      _isComplete(packet->getPacketPosition() == NLPacket::ONLY)
 {
+    auto payload = packet->readWithoutCopy(packet->bytesLeftToRead());
+
+    // the first packet stays put for the life of the message, so its head can be read from any thread
+    _headData = QByteArray::fromRawData(payload.constData(), std::min((int)payload.size(), HEAD_DATA_SIZE));
+
+    appendChunk(payload);
+    _packets.push_back(std::move(packet));
 }
 
 void ReceivedMessage::setFailed() {
@@ -49,7 +57,7 @@ void ReceivedMessage::setFailed() {
     emit completed();
 }
 
-void ReceivedMessage::appendPacket(NLPacket& packet) {
+void ReceivedMessage::appendPacket(std::unique_ptr<NLPacket> packet) {
     Q_ASSERT_X(!_isComplete, "ReceivedMessage::appendPacket", 
                "We should not be appending to a complete message");
 
@@ -58,25 +66,88 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
 
     ++_numPackets;
 
-    _data.append(packet.getPayload(), packet.getPayloadSize());
+    auto position = packet->getPacketPosition();
+
+    appendChunk(QByteArray::fromRawData(packet->getPayload(), packet->getPayloadSize()));
+    _packets.push_back(std::move(packet));
 
     if (_numPackets % EMIT_PROGRESS_EVERY_X_PACKETS == 0) {
         emit progress();
     }
 
-    if (packet.getPacketPosition() == NLPacket::PacketPosition::LAST) {
+    if (position == NLPacket::PacketPosition::LAST) {
         _isComplete = true;
         emit completed();
     }
 }
 
+QByteArray ReceivedMessage::getMessage() const {
+    makeContiguous();
+    return _data;
+}
+
+const char* ReceivedMessage::getRawMessage() const {
+    if (_chunks.size() > 1) {
+        makeContiguous();
+    }
+    return _chunks.empty() ? nullptr : _chunks.front().constData();
+}
+
+void ReceivedMessage::appendChunk(const QByteArray& chunk) {
+    _chunkPositions.push_back(_size);
+    _chunks.push_back(chunk);
+    _size += chunk.size();
+}
+
+int ReceivedMessage::findChunk(qint64 position) const {
+    if (_chunks.size() == 1) {
+        return 0;
+    }
+
+    // the last chunk starting at or before position
+    auto it = std::upper_bound(_chunkPositions.begin(), _chunkPositions.end(), position);
+    return std::max((int)(it - _chunkPositions.begin()) - 1, 0);
+}
+
+qint64 ReceivedMessage::copyData(char* data, qint64 position, qint64 size) const {
+    qint64 copied = 0;
+
+    for (int i = findChunk(position); copied < size && i < (int)_chunks.size(); ++i) {
+        qint64 offset = position + copied - _chunkPositions[i];
+        qint64 chunkBytes = std::min(size - copied, _chunks[i].size() - offset);
+
+        memcpy(data + copied, _chunks[i].constData() + offset, chunkBytes);
+        copied += chunkBytes;
+    }
+
+    return copied;
+}
+
+void ReceivedMessage::makeContiguous() const {
+    if (!_data.isNull() && _data.size() == _size) {
+        // nothing has been appended since the last time
+        return;
+    }
+
+    QByteArray data;
+    data.resize((int)_size);
+    copyData(data.data(), 0, _size);
+    _data = data;
+
+    // keep the packets around, data already read without copy may still point into them
+    _chunks.clear();
+    _chunkPositions.clear();
+    _chunks.push_back(_data);
+    _chunkPositions.push_back(0);
+}
+
 qint64 ReceivedMessage::peek(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
+    copyData(data, _position, size);
     return size;
 }
 
 qint64 ReceivedMessage::read(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
+    copyData(data, _position, size);
     _position += size;
     return size;
 }
@@ -88,12 +159,17 @@ qint64 ReceivedMessage::readHead(char* data, qint64 size) {
 }
 
 QByteArray ReceivedMessage::peek(qint64 size) {
-    return _data.mid(_position, size);
+    size = std::max(std::min(size, getBytesLeftToRead()), (qint64)0);
+
+    QByteArray data;
+    data.resize(size);
+    copyData(data.data(), _position, size);
+    return data;
 }
 
 QByteArray ReceivedMessage::read(qint64 size) {
-    auto data = _data.mid(_position, size);
-    _position += size;
+    auto data = peek(size);
+    _position += data.size();
     return data;
 }
 
@@ -108,7 +184,29 @@ QByteArray ReceivedMessage::readAll() {
 }
 
 QByteArray ReceivedMessage::readWithoutCopy(qint64 size) {
-    QByteArray data { QByteArray::fromRawData(_data.constData() + _position, size) };
+    int chunk = findChunk(_position);
+    if (_chunks.size() > 1 && _position + size > _chunkPositions[chunk] + _chunks[chunk].size()) {
+        // this read crosses packets
+        makeContiguous();
+        chunk = 0;
+    }
+
+    QByteArray data { QByteArray::fromRawData(_chunks[chunk].constData() + (_position - _chunkPositions[chunk]), size) };
+    _position += size;
+    return data;
+}
+
+QByteArray ReceivedMessage::readChunkWithoutCopy(qint64 size) {
+    size = std::min(size, getBytesLeftToRead());
+    if (size <= 0) {
+        return QByteArray();
+    }
+
+    int chunk = findChunk(_position);
+    qint64 offset = _position - _chunkPositions[chunk];
+    size = std::min(size, _chunks[chunk].size() - offset);
+
+    QByteArray data { QByteArray::fromRawData(_chunks[chunk].constData() + offset, size) };
     _position += size;
     return data;
 }
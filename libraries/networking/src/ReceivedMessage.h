@@ -16,24 +16,33 @@
 #include <QObject>
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 #include "NLPacketList.h"
 
+//
+// A message put together from one or more packets. The payloads of the packets it came in are kept as a chain of
+// chunks and read in place, it is only copied into one contiguous buffer if getMessage or getRawMessage need it
+// (or a read without copy spans more than one packet).
+// Until the message is complete only its head (see readHead) can be read from a thread other than the one
+// appending its packets.
+//
 class ReceivedMessage : public QObject {
     Q_OBJECT
 public:
     ReceivedMessage(const NLPacketList& packetList);
-    ReceivedMessage(NLPacket& packet);
+    ReceivedMessage(std::unique_ptr<NLPacket> packet);
 
-    QByteArray getMessage() const { return _data; }
-    const char* getRawMessage() const { return _data.constData(); }
+    QByteArray getMessage() const;
+    const char* getRawMessage() const;
 
     PacketType getType() const { return _packetType; }
     PacketVersion getVersion() const { return _packetVersion; }
 
     void setFailed();
 
-    void appendPacket(NLPacket& packet);
+    void appendPacket(std::unique_ptr<NLPacket> packet);
 
     bool failed() const { return _failed; }
     bool isComplete() const { return _isComplete; }
@@ -46,9 +55,9 @@ public:
     // Get the number of packets that were used to send this message
     qint64 getNumPackets() const { return _numPackets; }
 
-    qint64 getSize() const { return _data.size(); }
+    qint64 getSize() const { return _size; }
 
-    qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
+    qint64 getBytesLeftToRead() const { return _size -  _position; }
 
     void seek(qint64 position) { _position = position; }
 
@@ -70,6 +79,10 @@ public:
     // exceed that of the ReceivedMessage.
     QByteArray readWithoutCopy(qint64 size);
 
+    // Like readWithoutCopy, but never makes the message contiguous: returns the next bytes up to size that are stored
+    // together, which can be fewer than asked for. Reading a big message chunk by chunk never copies it.
+    QByteArray readChunkWithoutCopy(qint64 size);
+
     template<typename T> qint64 peekPrimitive(T* data);
     template<typename T> qint64 readPrimitive(T* data);
 
@@ -83,10 +96,18 @@ private slots:
     void onComplete();
 
 private:
-    QByteArray _data;
+    void appendChunk(const QByteArray& chunk);
+    int findChunk(qint64 position) const;
+    qint64 copyData(char* data, qint64 position, qint64 size) const;
+    void makeContiguous() const;
+
+    std::vector<std::unique_ptr<NLPacket>> _packets; // owns the payloads the chunks point into
+    mutable std::vector<QByteArray> _chunks;
+    mutable std::vector<qint64> _chunkPositions;
+    mutable QByteArray _data; // the whole message, once it had to be made contiguous
     QByteArray _headData;
 
-    std::atomic<qint64> _size { true };  
+    std::atomic<qint64> _size { 0 };
     std::atomic<qint64> _position { 0 };
     std::atomic<qint64> _numPackets { 0 };
 
@@ -21,6 +21,12 @@ ReceivedPacketProcessor::ReceivedPacketProcessor() {
 
 
 void ReceivedPacketProcessor::terminating() {
+    wakeUp();
+}
+
+void ReceivedPacketProcessor::wakeUp() {
+    // holding the wait mutex means the wake can't fall between process() finding no packets and starting its wait
+    QMutexLocker locker(&_waitingOnPacketsMutex);
     _hasPackets.wakeAll();
 }
 
@@ -32,7 +38,7 @@ void ReceivedPacketProcessor::queueReceivedPacket(QSharedPointer<ReceivedMessage
     unlock();
 
     // Make sure to wake our actual processing thread because we now have packets for it to process.
-    _hasPackets.wakeAll();
+    wakeUp();
 }
 
 bool ReceivedPacketProcessor::process() {
@@ -54,22 +60,27 @@ bool ReceivedPacketProcessor::process() {
         unlock();
     }
 
-    if (_packets.size() == 0) {
-        _waitingOnPacketsMutex.lock();
+    _waitingOnPacketsMutex.lock();
+    lock();
+    bool hasPackets = !_packets.empty();
+    unlock();
+    if (!hasPackets && isStillRunning()) {
         _hasPackets.wait(&_waitingOnPacketsMutex, getMaxWait());
-        _waitingOnPacketsMutex.unlock();
     }
+    _waitingOnPacketsMutex.unlock();
 
     preProcess();
-    if (!_packets.size()) {
-        return isStillRunning();
-    }
 
+    // everything that came in while the last batch was processed goes in this one
     lock();
     std::list<NodeSharedReceivedMessagePair> currentPackets;
     currentPackets.swap(_packets);
     unlock();
 
+    if (currentPackets.empty()) {
+        return isStillRunning();
+    }
+
     for(auto& packetPair : currentPackets) {
         processPacket(packetPair.second, packetPair.first);
         _lastWindowProcessedPackets++;
@@ -75,6 +75,9 @@ protected:
     /// Override to do work after the packets processing loop.  Default does nothing.
     virtual void postProcess() { }
 
+    /// Wakes the processing thread, which otherwise sleeps until there are packets or getMaxWait() passes.
+    void wakeUp();
+
 protected:
     std::list<NodeSharedReceivedMessagePair> _packets;
     QHash<QUuid, int> _nodePacketCounts;
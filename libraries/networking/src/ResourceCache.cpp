@@ -9,12 +9,14 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 
 #include <QThread>
 #include <QTimer>
 
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <assert.h>
 
@@ -40,18 +42,25 @@ void ResourceCache::refreshAll() {
     clearUnusedResource();
     
     // Refresh all remaining resources in use
-    foreach (auto resource, _resources) {
-        if (!resource.isNull()) {
-            resource.data()->refresh();
+    QList<QWeakPointer<Resource>> resources;
+    {
+        QReadLocker locker(&_resourcesLock);
+        resources = _resources.values();
+    }
+    foreach (auto resource, resources) {
+        QSharedPointer<Resource> strongResource = resource.toStrongRef();
+        if (!strongResource.isNull()) {
+            strongResource->refresh();
         }
     }
 }
 
 void ResourceCache::refresh(const QUrl& url) {
-    QSharedPointer<Resource> resource = _resources.value(url);
+    QSharedPointer<Resource> resource = getCachedResource(url);
     if (!resource.isNull()) {
         resource->refresh();
     } else {
+        QWriteLocker locker(&_resourcesLock);
         _resources.remove(url);
     }
 }
@@ -73,11 +82,22 @@ void ResourceCache::checkAsynchronousGets() {
     }
 }
 
+QSharedPointer<Resource> ResourceCache::getCachedResource(const QUrl& url) {
+    QSharedPointer<Resource> resource;
+    {
+        QReadLocker locker(&_resourcesLock);
+        resource = _resources.value(url);
+    }
+    if (!resource.isNull()) {
+        removeUnusedResource(resource);
+    }
+    return resource;
+}
+
 QSharedPointer<Resource> ResourceCache::getResource(const QUrl& url, const QUrl& fallback,
                                                     bool delayLoad, void* extra) {
-    QSharedPointer<Resource> resource = _resources.value(url);
+    QSharedPointer<Resource> resource = getCachedResource(url);
     if (!resource.isNull()) {
-        removeUnusedResource(resource);
         return resource;
     }
 
@@ -95,7 +115,10 @@ QSharedPointer<Resource> ResourceCache::getResource(const QUrl& url, const QUrl&
                               getResource(fallback, QUrl(), true) : QSharedPointer<Resource>(), delayLoad, extra);
     resource->setSelf(resource);
     resource->setCache(this);
-    _resources.insert(url, resource);
+    {
+        QWriteLocker locker(&_resourcesLock);
+        _resources.insert(url, resource);
+    }
     removeUnusedResource(resource);
     resource->ensureLoading();
 
@@ -103,24 +126,34 @@ QSharedPointer<Resource> ResourceCache::getResource(const QUrl& url, const QUrl&
 }
 
 void ResourceCache::setUnusedResourceCacheSize(qint64 unusedResourcesMaxSize) {
-    _unusedResourcesMaxSize = clamp(unusedResourcesMaxSize, MIN_UNUSED_MAX_SIZE, MAX_UNUSED_MAX_SIZE);
-    reserveUnusedResource(0);
+    QList<QSharedPointer<Resource>> evicted;
+    {
+        QMutexLocker locker(&_unusedResourcesLock);
+        _unusedResourcesMaxSize = clamp(unusedResourcesMaxSize, MIN_UNUSED_MAX_SIZE, MAX_UNUSED_MAX_SIZE);
+        evicted = takeUnusedResourcesToFit(0);
+    }
 }
 
 void ResourceCache::addUnusedResource(const QSharedPointer<Resource>& resource) {
-    if (resource->getBytesTotal() > _unusedResourcesMaxSize) {
-        // If it doesn't fit anyway, let's leave whatever is already in the cache.
-        resource->setCache(nullptr);
-        return;
+    QList<QSharedPointer<Resource>> evicted;
+    {
+        QMutexLocker locker(&_unusedResourcesLock);
+        if (resource->getBytesTotal() > _unusedResourcesMaxSize) {
+            // If it doesn't fit anyway, let's leave whatever is already in the cache.
+            resource->setCache(nullptr);
+            return;
+        }
+        evicted = takeUnusedResourcesToFit(resource->getBytesTotal());
+
+        resource->setLRUKey(++_lastLRUKey);
+        _unusedResources.insert(resource->getLRUKey(), resource);
+        _unusedResourcesSize += resource->getBytesTotal();
     }
-    reserveUnusedResource(resource->getBytesTotal());
-    
-    resource->setLRUKey(++_lastLRUKey);
-    _unusedResources.insert(resource->getLRUKey(), resource);
-    _unusedResourcesSize += resource->getBytesTotal();
 }
 
 void ResourceCache::removeUnusedResource(const QSharedPointer<Resource>& resource) {
+    // the caller holds a reference, so taking the resource out of the list doesn't release it under the lock
+    QMutexLocker locker(&_unusedResourcesLock);
     if (_unusedResources.contains(resource->getLRUKey())) {
         _unusedResources.remove(resource->getLRUKey());
         _unusedResourcesSize -= resource->getBytesTotal();
@@ -128,6 +161,17 @@ void ResourceCache::removeUnusedResource(const QSharedPointer<Resource>& resourc
 }
 
 void ResourceCache::reserveUnusedResource(qint64 resourceSize) {
+    QList<QSharedPointer<Resource>> evicted;
+    {
+        QMutexLocker locker(&_unusedResourcesLock);
+        evicted = takeUnusedResourcesToFit(resourceSize);
+    }
+}
+
+QList<QSharedPointer<Resource>> ResourceCache::takeUnusedResourcesToFit(qint64 resourceSize) {
+    // the evicted resources are handed back to be released once the lock is let go, since releasing one can release
+    // others that it references, which come back to the unused list
+    QList<QSharedPointer<Resource>> evicted;
     while (!_unusedResources.empty() &&
            _unusedResourcesSize + resourceSize > _unusedResourcesMaxSize) {
         // unload the oldest resource
@@ -135,33 +179,52 @@ void ResourceCache::reserveUnusedResource(qint64 resourceSize) {
         
         _unusedResourcesSize -= it.value()->getBytesTotal();
         it.value()->setCache(nullptr);
+        evicted.append(it.value());
         _unusedResources.erase(it);
     }
+    return evicted;
 }
 
 void ResourceCache::clearUnusedResource() {
     // the unused resources may themselves reference resources that will be added to the unused
     // list on destruction, so keep clearing until there are no references left
-    while (!_unusedResources.isEmpty()) {
-        foreach (const QSharedPointer<Resource>& resource, _unusedResources) {
+    forever {
+        QMap<int, QSharedPointer<Resource>> unusedResources;
+        {
+            QMutexLocker locker(&_unusedResourcesLock);
+            if (_unusedResources.isEmpty()) {
+                return;
+            }
+            unusedResources.swap(_unusedResources);
+            _unusedResourcesSize = 0;
+        }
+        foreach (const QSharedPointer<Resource>& resource, unusedResources) {
             resource->setCache(nullptr);
         }
-        _unusedResources.clear();
     }
 }
 
+// a download whose size isn't known yet is taken to be this big, and a bigger one counts for no more than this
+static const qint64 FULL_REQUEST_SIZE = BYTES_PER_MEGABYTES;
+
+// however small the downloads are, no more than this many times the request limit are in flight at once
+static const int MAX_REQUESTS_PER_SLOT = 4;
+
+static bool isRequestLimited(Resource* resource) {
+    // request limiting is disabled for ATP
+    return resource->getURL().scheme() != URL_SCHEME_ATP;
+}
+
 void ResourceCache::attemptRequest(Resource* resource) {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
 
-    // Disable request limiting for ATP
-    if (resource->getURL().scheme() != URL_SCHEME_ATP) {
-        if (_requestLimit <= 0) {
-            // wait until a slot becomes available
-            sharedItems->_pendingRequests.append(resource);
-            return;
-        }
-
-        --_requestLimit;
+    if (isRequestLimited(resource)) {
+        // wait until there is room, behind anything with a higher priority, with the connection to its host opening
+        // in the meantime
+        NetworkAccessManager::preconnect(ResourceManager::normalizeURL(resource->getURL()));
+        sharedItems->_pendingRequests.append(resource);
+        attemptHighestPriorityRequests();
+        return;
     }
 
     sharedItems->_loadingRequests.append(resource);
@@ -171,28 +234,53 @@ void ResourceCache::attemptRequest(Resource* resource) {
 void ResourceCache::requestCompleted(Resource* resource) {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
     sharedItems->_loadingRequests.removeOne(resource);
-    if (resource->getURL().scheme() != URL_SCHEME_ATP) {
-        ++_requestLimit;
-    }
-    
-    // look for the highest priority pending request
-    int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    for (int i = 0; i < sharedItems->_pendingRequests.size(); ) {
-        Resource* resource = sharedItems->_pendingRequests.at(i).data();
-        if (!resource) {
-            sharedItems->_pendingRequests.removeAt(i);
-            continue;
+
+    attemptHighestPriorityRequests();
+}
+
+void ResourceCache::attemptHighestPriorityRequests() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+
+    while (!sharedItems->_pendingRequests.isEmpty()) {
+        // the bytes still to come for what is loading, with each download counting for at most a full slot
+        int numLimitedRequests = 0;
+        qint64 bytesInFlight = 0;
+        foreach (Resource* loading, sharedItems->_loadingRequests) {
+            if (isRequestLimited(loading)) {
+                qint64 bytesLeft = loading->getBytesTotal() > 0 ?
+                    loading->getBytesTotal() - loading->getBytesReceived() : FULL_REQUEST_SIZE;
+                bytesInFlight += std::min(bytesLeft, FULL_REQUEST_SIZE);
+                numLimitedRequests++;
+            }
         }
-        float priority = resource->getLoadPriority();
-        if (priority >= highestPriority) {
-            highestPriority = priority;
-            highestIndex = i;
+        if (bytesInFlight >= _requestLimit * FULL_REQUEST_SIZE ||
+                numLimitedRequests >= _requestLimit * MAX_REQUESTS_PER_SLOT) {
+            return;
         }
-        i++;
-    }
-    if (highestIndex >= 0) {
-        attemptRequest(sharedItems->_pendingRequests.takeAt(highestIndex));
+
+        // look for the highest priority pending request, as it stands now
+        int highestIndex = -1;
+        float highestPriority = -FLT_MAX;
+        for (int i = 0; i < sharedItems->_pendingRequests.size(); ) {
+            Resource* resource = sharedItems->_pendingRequests.at(i).data();
+            if (!resource) {
+                sharedItems->_pendingRequests.removeAt(i);
+                continue;
+            }
+            float priority = resource->getLoadPriority();
+            if (priority >= highestPriority) {
+                highestPriority = priority;
+                highestIndex = i;
+            }
+            i++;
+        }
+        if (highestIndex < 0) {
+            return;
+        }
+
+        Resource* resource = sharedItems->_pendingRequests.takeAt(highestIndex).data();
+        sharedItems->_loadingRequests.append(resource);
+        resource->makeRequest();
     }
 }
 
@@ -229,6 +317,7 @@ void Resource::ensureLoading() {
 void Resource::setLoadPriority(const QPointer<QObject>& owner, float priority) {
     if (!(_failedToLoad || _loaded)) {
         _loadPriorities.insert(owner, priority);
+        _loadPrioritiesUpdated = usecTimestampNow();
     }
 }
 
@@ -240,6 +329,7 @@ void Resource::setLoadPriorities(const QHash<QPointer<QObject>, float>& prioriti
             it != priorities.constEnd(); it++) {
         _loadPriorities.insert(it.key(), it.value());
     }
+    _loadPrioritiesUpdated = usecTimestampNow();
 }
 
 void Resource::clearLoadPriority(const QPointer<QObject>& owner) {
@@ -250,6 +340,11 @@ void Resource::clearLoadPriority(const QPointer<QObject>& owner) {
 
 float Resource::getLoadPriority() {
     float highestPriority = -FLT_MAX;
+
+    const quint64 LOAD_PRIORITY_EXPIRY_USECS = USECS_PER_SECOND;
+    if (usecTimestampNow() - _loadPrioritiesUpdated > LOAD_PRIORITY_EXPIRY_USECS) {
+        return highestPriority;
+    }
     for (QHash<QPointer<QObject>, float>::iterator it = _loadPriorities.begin(); it != _loadPriorities.end(); ) {
         if (it.key().isNull()) {
             it = _loadPriorities.erase(it);
@@ -329,6 +424,7 @@ void Resource::finishedLoading(bool success) {
 }
 
 void Resource::reinsert() {
+    QWriteLocker locker(&_cache->_resourcesLock);
     _cache->_resources.insert(_url, _self);
 }
 
@@ -358,6 +454,11 @@ void Resource::makeRequest() {
 void Resource::handleDownloadProgress(uint64_t bytesReceived, uint64_t bytesTotal) {
     _bytesReceived = bytesReceived;
     _bytesTotal = bytesTotal;
+
+    // as the download nears its end it takes up less room in flight, which may let another one start
+    if (isRequestLimited(this)) {
+        ResourceCache::attemptHighestPriorityRequests();
+    }
 }
 
 void Resource::handleReplyFinished() {
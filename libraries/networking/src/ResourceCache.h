@@ -14,6 +14,7 @@
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
 #include <QtCore/QSharedPointer>
@@ -67,6 +68,8 @@ class ResourceCache : public QObject {
     Q_OBJECT
     
 public:
+    /// Sets how many downloads of unknown or large size can be in flight at once. Downloads that are known to be
+    /// small, or nearly done, take only a share of a slot, so that many of them can load alongside the big ones.
     static void setRequestLimit(int limit) { _requestLimit = limit; }
     static int getRequestLimit() { return _requestLimit; }
     
@@ -100,6 +103,9 @@ protected:
     virtual QSharedPointer<Resource> createResource(const QUrl& url,
         const QSharedPointer<Resource>& fallback, bool delayLoad, const void* extra) = 0;
     
+    /// Returns the resource for the URL if the cache has it, from any thread.
+    QSharedPointer<Resource> getCachedResource(const QUrl& url);
+
     void addUnusedResource(const QSharedPointer<Resource>& resource);
     void removeUnusedResource(const QSharedPointer<Resource>& resource);
     void reserveUnusedResource(qint64 resourceSize);
@@ -108,9 +114,16 @@ protected:
     Q_INVOKABLE static void attemptRequest(Resource* resource);
     static void requestCompleted(Resource* resource);
 
+    /// Starts the pending requests with the highest load priorities, for as long as there is room in flight.
+    static void attemptHighestPriorityRequests();
+
 private:
     friend class Resource;
 
+    QList<QSharedPointer<Resource>> takeUnusedResourcesToFit(qint64 resourceSize);
+
+    // the resources are looked up from any thread, but only made on the cache's own
+    QReadWriteLock _resourcesLock;
     QHash<QUrl, QWeakPointer<Resource>> _resources;
     int _lastLRUKey = 0;
     
@@ -120,6 +133,7 @@ private:
     QReadWriteLock _resourcesToBeGottenLock;
     QQueue<QUrl> _resourcesToBeGotten;
     
+    QMutex _unusedResourcesLock;
     qint64 _unusedResourcesMaxSize = DEFAULT_UNUSED_MAX_SIZE;
     qint64 _unusedResourcesSize = 0;
     QMap<int, QSharedPointer<Resource>> _unusedResources;
@@ -140,7 +154,8 @@ public:
     /// Makes sure that the resource has started loading.
     void ensureLoading();
 
-    /// Sets the load priority for one owner.
+    /// Sets the load priority for one owner. Priorities that aren't set again for a while are taken to be out of date
+    /// (the owner is out of view, say), and the resource then waits behind those whose priority is current.
     virtual void setLoadPriority(const QPointer<QObject>& owner, float priority);
     
     /// Sets a set of priorities at once.
@@ -207,6 +222,7 @@ protected:
     bool _failedToLoad = false;
     bool _loaded = false;
     QHash<QPointer<QObject>, float> _loadPriorities;
+    quint64 _loadPrioritiesUpdated = 0;
     QWeakPointer<Resource> _self;
     QPointer<ResourceCache> _cache;
     QByteArray _data;
@@ -11,6 +11,8 @@
 
 #include "CongestionControl.h"
 
+#include <algorithm>
+#include <iterator>
 #include <random>
 
 #include "Packet.h"
@@ -207,3 +209,163 @@ void DefaultCC::stopSlowStart() {
         _packetSendPeriod = _congestionWindowSize / (_rtt + synInterval());
     }
 }
+
+// the startup gain (2 / ln 2) is the smallest one that still doubles the delivery rate every round
+static const double BBR_STARTUP_GAIN = 2.885;
+static const double BBR_CONGESTION_WINDOW_GAIN = 2.0;
+
+// one probe above the bandwidth, one below it to drain what the probe queued, then six rounds at the bandwidth
+static const double BBR_PROBE_BANDWIDTH_GAINS[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int BBR_NUM_PROBE_BANDWIDTH_PHASES = sizeof(BBR_PROBE_BANDWIDTH_GAINS) / sizeof(BBR_PROBE_BANDWIDTH_GAINS[0]);
+
+// startup is over once the bandwidth hasn't grown by a quarter for three rounds
+static const double BBR_FULL_BANDWIDTH_GROWTH = 1.25;
+static const int BBR_FULL_BANDWIDTH_ROUNDS = 3;
+
+static const int BBR_MIN_CONGESTION_WINDOW = 4; // packets
+static const int BBR_MIN_RTT_EXPIRY_USECS = 10 * 1000 * 1000;
+static const int BBR_PROBE_RTT_USECS = 200 * 1000;
+
+BBRCC::BBRCC() :
+    _lastACK(_sendCurrSeqNum)
+{
+    _mss = udt::MAX_PACKET_SIZE_WITH_UDP_HEADER;
+    
+    _congestionWindowSize = 16.0;
+    _packetSendPeriod = 1.0;
+    
+    std::fill(std::begin(_roundMaxReceiveRates), std::end(_roundMaxReceiveRates), 0);
+}
+
+void BBRCC::onACK(SequenceNumber ackNum) {
+    // the receive rate and RTT only change with the full ACKs sent once per sync interval, no need to look more often
+    auto now = p_high_resolution_clock::now();
+    if (duration_cast<microseconds>(now - _lastUpdateTime).count() < synInterval()) {
+        return;
+    }
+    
+    _lastUpdateTime = now;
+    
+    updateModel(now);
+    
+    if (_bottleneckBandwidth == 0) {
+        // the receiver hasn't reported a rate yet - grow the window by the number of packets just ACKed, like slow start
+        _congestionWindowSize += seqlen(_lastACK, ackNum);
+        if (_maxCongestionWindowSize > 0) {
+            _congestionWindowSize = std::min(_congestionWindowSize, _maxCongestionWindowSize);
+        }
+        
+        _lastACK = ackNum;
+        return;
+    }
+    
+    _lastACK = ackNum;
+    
+    // pace at the bandwidth, scaled by whatever the current mode calls for
+    setPacketSendPeriod(USECS_PER_SECOND / (getPacingGain() * _bottleneckBandwidth));
+    
+    if (_mode == Mode::ProbeRTT) {
+        _congestionWindowSize = BBR_MIN_CONGESTION_WINDOW;
+    } else {
+        // the bandwidth-delay product, counting the packets that arrive between two full ACKs as part of the delay
+        double bandwidthDelayProduct = _bottleneckBandwidth * (_minRTT + synInterval()) / USECS_PER_SECOND;
+        _congestionWindowSize = std::max(BBR_CONGESTION_WINDOW_GAIN * bandwidthDelayProduct,
+                                         (double) BBR_MIN_CONGESTION_WINDOW);
+    }
+}
+
+void BBRCC::updateModel(p_high_resolution_clock::time_point now) {
+    // the min RTT can only go down here, the RTT probe below is what lets it go back up when the path changes
+    if (_rtt > 0) {
+        if (_minRTT == 0 || _rtt < _minRTT) {
+            _minRTT = _rtt;
+            _minRTTTime = now;
+        }
+        
+        if (_mode == Mode::ProbeRTT && (_probeRTTMin == 0 || _rtt < _probeRTTMin)) {
+            _probeRTTMin = _rtt;
+        }
+    }
+    
+    // the bottleneck bandwidth is the highest rate the receiver saw in the last rounds
+    _roundMaxReceiveRates[_currentRound] = std::max(_roundMaxReceiveRates[_currentRound], _receiveRate);
+    _bottleneckBandwidth = *std::max_element(std::begin(_roundMaxReceiveRates), std::end(_roundMaxReceiveRates));
+    
+    if (duration_cast<microseconds>(now - _roundStartTime).count() >= getRoundUsecs()) {
+        endRound(now);
+    }
+    
+    if (_mode != Mode::ProbeRTT) {
+        if (_minRTT > 0 && duration_cast<microseconds>(now - _minRTTTime).count() > BBR_MIN_RTT_EXPIRY_USECS) {
+            // the min RTT hasn't been seen in a while, drain the queue to measure it again
+            _probeRTTMin = 0;
+            enterMode(Mode::ProbeRTT, now);
+        }
+    } else if (duration_cast<microseconds>(now - _modeStartTime).count() >= std::max(BBR_PROBE_RTT_USECS, getRoundUsecs())) {
+        if (_probeRTTMin > 0) {
+            _minRTT = _probeRTTMin;
+        }
+        _minRTTTime = now;
+        
+        enterMode(hasFoundFullBandwidth() ? Mode::ProbeBandwidth : Mode::Startup, now);
+    }
+}
+
+void BBRCC::endRound(p_high_resolution_clock::time_point now) {
+    _roundStartTime = now;
+    
+    if (_mode == Mode::Startup) {
+        if (_bottleneckBandwidth >= _fullBandwidth * BBR_FULL_BANDWIDTH_GROWTH) {
+            _fullBandwidth = _bottleneckBandwidth;
+            _roundsWithoutGrowth = 0;
+        } else if (++_roundsWithoutGrowth >= BBR_FULL_BANDWIDTH_ROUNDS) {
+            enterMode(Mode::Drain, now);
+        }
+    } else if (_mode == Mode::Drain) {
+        enterMode(Mode::ProbeBandwidth, now);
+    } else if (_mode == Mode::ProbeBandwidth) {
+        _probeBandwidthPhase = (_probeBandwidthPhase + 1) % BBR_NUM_PROBE_BANDWIDTH_PHASES;
+    }
+    
+    // start collecting the max receive rate of the next round, dropping the oldest one
+    _currentRound = (_currentRound + 1) % NUM_BANDWIDTH_ROUNDS;
+    _roundMaxReceiveRates[_currentRound] = 0;
+}
+
+void BBRCC::enterMode(Mode mode, p_high_resolution_clock::time_point now) {
+    _mode = mode;
+    _modeStartTime = now;
+    
+    if (mode == Mode::ProbeBandwidth) {
+        // start in a random phase (but not the one that drains) so connections sharing a link don't probe in lockstep
+        std::random_device rd;
+        std::mt19937 generator(rd());
+        std::uniform_int_distribution<> distribution(0, BBR_NUM_PROBE_BANDWIDTH_PHASES - 2);
+        
+        _probeBandwidthPhase = distribution(generator);
+        if (_probeBandwidthPhase >= 1) {
+            ++_probeBandwidthPhase;
+        }
+    }
+}
+
+double BBRCC::getPacingGain() const {
+    switch (_mode) {
+        case Mode::Startup:
+            return BBR_STARTUP_GAIN;
+        case Mode::Drain:
+            return 1.0 / BBR_STARTUP_GAIN;
+        case Mode::ProbeBandwidth:
+            return BBR_PROBE_BANDWIDTH_GAINS[_probeBandwidthPhase];
+        default:
+            return 1.0;
+    }
+}
+
+int BBRCC::getRoundUsecs() const {
+    return std::max(_minRTT, synInterval());
+}
+
+bool BBRCC::hasFoundFullBandwidth() const {
+    return _roundsWithoutGrowth >= BBR_FULL_BANDWIDTH_ROUNDS;
+}
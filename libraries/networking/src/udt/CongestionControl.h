@@ -120,6 +120,55 @@ private:
     int _avgNAKNum { 0 }; // average number of NAKs per congestion
     int _decreaseCount { 0 }; // number of decreases in a congestion epoch
 };
+
+// A model-based controller in the spirit of BBR. Instead of backing off on every loss it keeps a model of the path -
+// its bottleneck bandwidth (the highest delivery rate the receiver reported over the last few rounds) and its
+// minimum RTT - paces packets at that bandwidth and keeps about twice the bandwidth-delay product in flight.
+// Random loss on a link that isn't congested then doesn't slow the transfer down.
+class BBRCC: public CongestionControl {
+public:
+    BBRCC();
+    
+public:
+    virtual void onACK(SequenceNumber ackNum);
+    virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) {}
+    
+private:
+    enum class Mode {
+        Startup, // doubling the rate every round until the bandwidth stops growing
+        Drain, // sending below the bandwidth for a round to empty the queue startup built up
+        ProbeBandwidth, // cycling slightly above and below the bandwidth to find out if more is available
+        ProbeRTT // sending almost nothing for a moment so the minimum RTT can be measured again
+    };
+    
+    static const int NUM_BANDWIDTH_ROUNDS = 10;
+    
+    void updateModel(p_high_resolution_clock::time_point now);
+    void enterMode(Mode mode, p_high_resolution_clock::time_point now);
+    void endRound(p_high_resolution_clock::time_point now);
+    double getPacingGain() const;
+    int getRoundUsecs() const;
+    bool hasFoundFullBandwidth() const;
+    
+    Mode _mode { Mode::Startup };
+    p_high_resolution_clock::time_point _lastUpdateTime = p_high_resolution_clock::now(); // last time the model changed
+    p_high_resolution_clock::time_point _roundStartTime = p_high_resolution_clock::now();
+    p_high_resolution_clock::time_point _modeStartTime = p_high_resolution_clock::now();
+    
+    int _roundMaxReceiveRates[NUM_BANDWIDTH_ROUNDS]; // highest receive rate in each of the last rounds, packets per second
+    int _currentRound { 0 };
+    int _bottleneckBandwidth { 0 }; // max of the rates above, packets per second
+    
+    int _fullBandwidth { 0 }; // bandwidth startup last saw growing
+    int _roundsWithoutGrowth { 0 };
+    int _probeBandwidthPhase { 0 };
+    
+    int _minRTT { 0 }; // microseconds
+    p_high_resolution_clock::time_point _minRTTTime = p_high_resolution_clock::now(); // when the min RTT was measured
+    int _probeRTTMin { 0 }; // lowest RTT seen during the current RTT probe, microseconds
+    
+    SequenceNumber _lastACK; // last ACKed seq num, used to grow the window until there is a bandwidth sample
+};
     
 }
 
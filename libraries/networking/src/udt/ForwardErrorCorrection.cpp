@@ -0,0 +1,204 @@
+//
+//  ForwardErrorCorrection.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ForwardErrorCorrection.h"
+
+#include <algorithm>
+
+using namespace udt;
+
+static const int PARITY_HEADER_BYTES = sizeof(uint8_t) + FECEncoder::MAX_GROUP_SIZE * sizeof(SequenceNumber::Type)
+    + sizeof(uint16_t);
+
+// how many protected packets a receiver keeps around to recover others from, a few groups worth
+static const int HISTORY_SIZE = 4 * FECEncoder::MAX_GROUP_SIZE;
+
+static void xorInto(char* destination, const char* source, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        destination[i] ^= source[i];
+    }
+}
+
+void FECEncoder::setGroupSize(int groupSize) {
+    groupSize = std::min(std::max(groupSize, 0), MAX_GROUP_SIZE);
+
+    if (groupSize != _groupSize) {
+        // start over, the receiver only rebuilds from complete groups anyway
+        _groupSize = groupSize;
+        _sequenceNumbers.clear();
+        _parity.clear();
+        _sizeParity = 0;
+    }
+}
+
+std::unique_ptr<ControlPacket> FECEncoder::addPacket(const Packet& packet) {
+    if (_groupSize == 0 || packet.getDataSize() > ControlPacket::maxPayloadSize() - PARITY_HEADER_BYTES) {
+        // not protecting anything, or this packet would make the parity packet too big to send
+        return nullptr;
+    }
+
+    auto size = (size_t)packet.getDataSize();
+    if (_parity.size() < size) {
+        _parity.resize(size, 0);
+    }
+
+    xorInto(_parity.data(), packet.getData(), size);
+    _sizeParity ^= (uint16_t)size;
+    _sequenceNumbers.push_back(packet.getSequenceNumber());
+
+    if ((int)_sequenceNumbers.size() < _groupSize) {
+        return nullptr;
+    }
+
+    auto parityPacket = ControlPacket::create(ControlPacket::FECParity,
+                                              sizeof(uint8_t) + _sequenceNumbers.size() * sizeof(SequenceNumber::Type)
+                                              + sizeof(uint16_t) + _parity.size());
+
+    parityPacket->writePrimitive((uint8_t)_sequenceNumbers.size());
+    for (auto& sequenceNumber : _sequenceNumbers) {
+        parityPacket->writePrimitive((SequenceNumber::Type)sequenceNumber);
+    }
+    parityPacket->writePrimitive(_sizeParity);
+    parityPacket->write(_parity.data(), _parity.size());
+
+    _sequenceNumbers.clear();
+    _parity.clear();
+    _sizeParity = 0;
+
+    return parityPacket;
+}
+
+FECDecoder::FECDecoder() :
+    _history(HISTORY_SIZE)
+{
+}
+
+bool FECDecoder::addPacket(const Packet& packet, bool isProtected, bool wasRecovered) {
+    auto sequenceNumber = packet.getSequenceNumber();
+
+    if (!wasRecovered) {
+        // count what should have arrived by now and what did, late packets fill in for what was counted lost
+        if (!_hasSequenceNumber) {
+            _hasSequenceNumber = true;
+            _lastSequenceNumber = sequenceNumber;
+            ++_numExpected;
+        } else if (sequenceNumber > _lastSequenceNumber) {
+            _numExpected += seqlen(_lastSequenceNumber, sequenceNumber) - 1;
+            _lastSequenceNumber = sequenceNumber;
+        }
+        ++_numReceived;
+    }
+
+    if (!isProtected || !_hasReceivedParity) {
+        return true;
+    }
+
+    if (find(sequenceNumber)) {
+        // we have this one already - when it was rebuilt from parity and then showed up late after all
+        return false;
+    }
+
+    store(sequenceNumber, packet.getData(), packet.getDataSize());
+    return true;
+}
+
+int FECDecoder::recover(ControlPacket& parity, PacketBuffer& buffer) {
+    _hasReceivedParity = true;
+
+    uint8_t groupSize = 0;
+    parity.readPrimitive(&groupSize);
+
+    if (groupSize == 0 || groupSize > FECEncoder::MAX_GROUP_SIZE) {
+        return 0;
+    }
+
+    SequenceNumber::Type sequenceNumbers[FECEncoder::MAX_GROUP_SIZE];
+    uint16_t sizeParity = 0;
+
+    if (parity.bytesLeftToRead() < (qint64)(groupSize * sizeof(SequenceNumber::Type) + sizeof(sizeParity))) {
+        return 0;
+    }
+
+    for (int i = 0; i < groupSize; ++i) {
+        parity.readPrimitive(&sequenceNumbers[i]);
+    }
+    parity.readPrimitive(&sizeParity);
+
+    // we can only rebuild a packet if it is the only one of the group we don't have
+    SequenceNumber missingSequenceNumber;
+    int numMissing = 0;
+
+    for (int i = 0; i < groupSize; ++i) {
+        SequenceNumber sequenceNumber { sequenceNumbers[i] };
+        if (!find(sequenceNumber)) {
+            missingSequenceNumber = sequenceNumber;
+            if (++numMissing > 1) {
+                return 0;
+            }
+        }
+    }
+
+    auto paritySize = parity.bytesLeftToRead();
+    if (numMissing == 0 || paritySize <= 0) {
+        return 0;
+    }
+
+    buffer = PacketBufferPool::allocate(paritySize);
+    memcpy(buffer.get(), parity.getPayload() + parity.pos(), paritySize);
+
+    for (int i = 0; i < groupSize; ++i) {
+        SequenceNumber sequenceNumber { sequenceNumbers[i] };
+        if (sequenceNumber != missingSequenceNumber) {
+            auto stored = find(sequenceNumber);
+            auto size = std::min((qint64)stored->data.size(), paritySize);
+            xorInto(buffer.get(), stored->data.data(), size);
+            sizeParity ^= (uint16_t)stored->data.size();
+        }
+    }
+
+    int size = sizeParity;
+    if (size == 0 || size > paritySize) {
+        // not a parity packet that matches what we have
+        buffer.reset();
+        return 0;
+    }
+
+    store(missingSequenceNumber, buffer.get(), size);
+    return size;
+}
+
+float FECDecoder::takeLossRate() {
+    float lossRate = -1.0f;
+    if (_numExpected > 0) {
+        lossRate = std::max(0.0f, 1.0f - (float)_numReceived / _numExpected);
+    }
+
+    _numExpected = 0;
+    _numReceived = 0;
+    return lossRate;
+}
+
+FECDecoder::StoredPacket* FECDecoder::find(SequenceNumber sequenceNumber) {
+    for (auto& stored : _history) {
+        if (stored.isValid && stored.sequenceNumber == sequenceNumber) {
+            return &stored;
+        }
+    }
+    return nullptr;
+}
+
+void FECDecoder::store(SequenceNumber sequenceNumber, const char* data, int size) {
+    auto& stored = _history[_nextSlot];
+    _nextSlot = (_nextSlot + 1) % _history.size();
+
+    stored.sequenceNumber = sequenceNumber;
+    stored.data.assign(data, data + size);
+    stored.isValid = true;
+}
@@ -0,0 +1,94 @@
+//
+//  ForwardErrorCorrection.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ForwardErrorCorrection_h
+#define hifi_ForwardErrorCorrection_h
+
+#include <memory>
+#include <vector>
+
+#include "ControlPacket.h"
+#include "Packet.h"
+#include "PacketBufferPool.h"
+#include "SequenceNumber.h"
+
+namespace udt {
+
+//
+// XOR parity for unreliable packets, so a receiver can rebuild one lost packet out of every group without waiting
+// for a retransmission that never comes.
+// The receiver measures how many of a sender's unreliable packets go missing and asks for parity (a FECRequest
+// with the group size to use) while the loss is high. The sender then follows every group of protected packets
+// with a FECParity packet that lists their sequence numbers and holds the XOR of their sizes and of their data.
+//
+
+// builds the parity for the packets sent to one destination
+class FECEncoder {
+public:
+    static const int MAX_GROUP_SIZE = 16;
+
+    int getGroupSize() const { return _groupSize; }
+    void setGroupSize(int groupSize);
+
+    // adds a protected packet that was just sent to the current group,
+    // returns the parity packet to send once the group is complete
+    std::unique_ptr<ControlPacket> addPacket(const Packet& packet);
+
+private:
+    int _groupSize { 0 };
+    std::vector<SequenceNumber> _sequenceNumbers;
+    std::vector<char> _parity; // as long as the longest packet of the group
+    uint16_t _sizeParity { 0 };
+};
+
+// remembers the recent protected packets from one sender and rebuilds the one a parity packet says is missing
+class FECDecoder {
+public:
+    FECDecoder();
+
+    // records an unreliable packet from this sender, for the loss rate and (if protected) for future recoveries
+    // returns false if it is a packet that was already recovered - it has been handled and should be dropped
+    bool addPacket(const Packet& packet, bool isProtected, bool wasRecovered);
+
+    // rebuilds the packet missing from the group the parity covers, if there is exactly one
+    // returns the size of the rebuilt packet in buffer, or 0 if nothing could be rebuilt
+    int recover(ControlPacket& parity, PacketBuffer& buffer);
+
+    // ratio of the unreliable packets from this sender lost since the last call, -1 if none were expected
+    float takeLossRate();
+
+    int getRequestedGroupSize() const { return _requestedGroupSize; }
+    void setRequestedGroupSize(int groupSize) { _requestedGroupSize = groupSize; }
+
+private:
+    struct StoredPacket {
+        SequenceNumber sequenceNumber;
+        std::vector<char> data;
+        bool isValid { false };
+    };
+
+    StoredPacket* find(SequenceNumber sequenceNumber);
+    void store(SequenceNumber sequenceNumber, const char* data, int size);
+
+    std::vector<StoredPacket> _history; // a ring of the last protected packets
+    size_t _nextSlot { 0 };
+    bool _hasReceivedParity { false }; // protected packets are only kept once the sender is sending parity
+
+    bool _hasSequenceNumber { false };
+    SequenceNumber _lastSequenceNumber;
+    int _numExpected { 0 };
+    int _numReceived { 0 };
+
+    int _requestedGroupSize { 0 };
+};
+
+}
+
+#endif // hifi_ForwardErrorCorrection_h
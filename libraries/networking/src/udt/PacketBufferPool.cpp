@@ -0,0 +1,145 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QThreadStorage>
+
+#include "Constants.h"
+
+using namespace udt;
+
+static const qint64 SIZE_CLASSES[] = { 128, 512, MAX_PACKET_SIZE };
+static const int NUM_SIZE_CLASSES = sizeof(SIZE_CLASSES) / sizeof(SIZE_CLASSES[0]);
+
+// a thread moves free buffers to and from the depot this many at a time, and caches up to twice that of each size
+static const size_t BUFFERS_PER_BATCH = 32;
+static const size_t MAX_CACHED_BUFFERS = 2 * BUFFERS_PER_BATCH;
+
+// the depot keeps at most this many free buffers of each size, anything past that goes back to the heap
+static const size_t MAX_DEPOT_BUFFERS = 4096;
+
+namespace {
+
+struct Depot {
+    QMutex mutex;
+    std::vector<char*> freeBuffers[NUM_SIZE_CLASSES];
+};
+
+// never destroyed, so the threads still running during shutdown can keep handing their buffers back
+Depot& depot = *new Depot;
+
+struct ThreadCache {
+    std::vector<char*> freeBuffers[NUM_SIZE_CLASSES];
+
+    ~ThreadCache() {
+        for (int i = 0; i < NUM_SIZE_CLASSES; ++i) {
+            giveToDepot(i, freeBuffers[i].size());
+        }
+    }
+
+    void takeFromDepot(int sizeClass) {
+        std::vector<char*>& cached = freeBuffers[sizeClass];
+
+        QMutexLocker locker(&depot.mutex);
+        std::vector<char*>& deposited = depot.freeBuffers[sizeClass];
+
+        size_t count = std::min(BUFFERS_PER_BATCH, deposited.size());
+        cached.insert(cached.end(), deposited.end() - count, deposited.end());
+        deposited.resize(deposited.size() - count);
+    }
+
+    void giveToDepot(int sizeClass, size_t count) {
+        std::vector<char*>& cached = freeBuffers[sizeClass];
+
+        {
+            QMutexLocker locker(&depot.mutex);
+            std::vector<char*>& deposited = depot.freeBuffers[sizeClass];
+
+            size_t numDeposited = std::min(count, MAX_DEPOT_BUFFERS - std::min(MAX_DEPOT_BUFFERS, deposited.size()));
+            deposited.insert(deposited.end(), cached.end() - numDeposited, cached.end());
+            cached.resize(cached.size() - numDeposited);
+            count -= numDeposited;
+        }
+
+        // the depot is full, these are freed
+        for (; count > 0; --count) {
+            delete[] cached.back();
+            cached.pop_back();
+        }
+    }
+};
+
+QThreadStorage<ThreadCache*> threadCaches;
+
+ThreadCache& threadCache() {
+    if (!threadCaches.hasLocalData()) {
+        threadCaches.setLocalData(new ThreadCache);
+    }
+    return *threadCaches.localData();
+}
+
+int sizeClassFor(qint64 size) {
+    for (int i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        if (size <= SIZE_CLASSES[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+}
+
+void PacketBufferDeleter::operator()(char* buffer) const {
+    if (_sizeClass < 0) {
+        delete[] buffer;
+    } else {
+        PacketBufferPool::release(buffer, _sizeClass);
+    }
+}
+
+PacketBuffer PacketBufferPool::allocate(qint64 size) {
+    int sizeClass = sizeClassFor(size);
+    if (sizeClass < 0) {
+        return PacketBuffer(new char[size]);
+    }
+
+    ThreadCache& cache = threadCache();
+    std::vector<char*>& cached = cache.freeBuffers[sizeClass];
+
+    if (cached.empty()) {
+        cache.takeFromDepot(sizeClass);
+    }
+
+    char* buffer = nullptr;
+    if (cached.empty()) {
+        buffer = new char[SIZE_CLASSES[sizeClass]];
+    } else {
+        buffer = cached.back();
+        cached.pop_back();
+    }
+
+    return PacketBuffer(buffer, PacketBufferDeleter(sizeClass));
+}
+
+void PacketBufferPool::release(char* buffer, int sizeClass) {
+    ThreadCache& cache = threadCache();
+    std::vector<char*>& cached = cache.freeBuffers[sizeClass];
+
+    cached.push_back(buffer);
+
+    if (cached.size() > MAX_CACHED_BUFFERS) {
+        cache.giveToDepot(sizeClass, BUFFERS_PER_BATCH);
+    }
+}
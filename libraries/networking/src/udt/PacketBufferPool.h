@@ -0,0 +1,55 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <memory>
+
+#include <QtCore/QtGlobal>
+
+namespace udt {
+
+// hands a buffer back to the pool it came from, buffers that didn't come from the pool are simply deleted
+class PacketBufferDeleter {
+public:
+    PacketBufferDeleter() {}
+    explicit PacketBufferDeleter(int sizeClass) : _sizeClass(sizeClass) {}
+
+    void operator()(char* buffer) const;
+
+private:
+    int _sizeClass { -1 };
+};
+
+using PacketBuffer = std::unique_ptr<char[], PacketBufferDeleter>;
+
+//
+// Recycles the memory packets are built and received in, so a server that is up for a long time sends and
+// receives without going back to the heap for every packet once it has warmed up.
+// Buffers come in a few size classes up to MAX_PACKET_SIZE. Every thread keeps its own cache of free buffers
+// and only goes to the shared depot, a batch at a time, when its cache runs dry or overflows - which is what
+// happens to the threads that only read packets off the socket or only handle them.
+//
+class PacketBufferPool {
+public:
+    // a buffer for at least size bytes, anything bigger than MAX_PACKET_SIZE comes straight from the heap
+    static PacketBuffer allocate(qint64 size);
+
+private:
+    friend class PacketBufferDeleter;
+    static void release(char* buffer, int sizeClass);
+};
+
+}
+
+#endif // hifi_PacketBufferPool_h
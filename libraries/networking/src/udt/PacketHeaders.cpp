@@ -36,15 +36,30 @@ const QSet<PacketType> NON_SOURCED_PACKETS = QSet<PacketType>()
 
 const QSet<PacketType> RELIABLE_PACKETS = QSet<PacketType>();
 
+// streams that are better off with a lost packet rebuilt late than not at all - the audio streams handle
+// late packet themselves, an avatar update that shows up after the next one would move the avatar back
+const QSet<PacketType> FEC_PROTECTED_PACKETS = QSet<PacketType>()
+    << PacketType::MixedAudio << PacketType::SilentAudioFrame
+    << PacketType::MicrophoneAudioNoEcho << PacketType::MicrophoneAudioWithEcho << PacketType::InjectAudio;
+
 PacketVersion versionForPacketType(PacketType packetType) {
     switch (packetType) {
         case PacketType::EntityAdd:
         case PacketType::EntityEdit:
         case PacketType::EntityData:
-            return VERSION_ATMOSPHERE_REMOVED;
+            return VERSION_ENTITIES_COMPACT_KINEMATICS;
         case PacketType::AvatarData:
+        case PacketType::ReplicatedBulkAvatarData:
+            return static_cast<PacketVersion>(AvatarMixerPacketVersion::SmallestThreeJointRotations);
         case PacketType::BulkAvatarData:
-            return static_cast<PacketVersion>(AvatarMixerPacketVersion::SoftAttachmentSupport);
+            return static_cast<PacketVersion>(AvatarMixerPacketVersion::BundledDatagrams);
+        case PacketType::AvatarIdentity:
+        case PacketType::AvatarBillboard:
+            return static_cast<PacketVersion>(AvatarMixerPacketVersion::BatchedIdentityAndBillboards);
+        case PacketType::MixedAudio:
+            return static_cast<PacketVersion>(AudioVersion::BundledDatagrams);
+        case PacketType::DomainList:
+            return static_cast<PacketVersion>(DomainListVersion::PacketVerificationMode);
         default:
             return 17;
     }
@@ -90,7 +90,11 @@ public:
         DomainServerRemovedNode,
         MessagesData,
         MessagesSubscribe,
-        MessagesUnsubscribe
+        MessagesUnsubscribe,
+        NegotiateAudioFormat,
+        SelectedAudioFormat,
+        AvatarQuery,
+        ReplicatedBulkAvatarData
     };
 };
 
@@ -103,6 +107,7 @@ typedef char PacketVersion;
 extern const QSet<PacketType> NON_VERIFIED_PACKETS;
 extern const QSet<PacketType> NON_SOURCED_PACKETS;
 extern const QSet<PacketType> RELIABLE_PACKETS;
+extern const QSet<PacketType> FEC_PROTECTED_PACKETS;
 
 PacketVersion versionForPacketType(PacketType packetType);
 
@@ -166,10 +171,25 @@ const PacketVersion VERSION_MODEL_ENTITIES_JOINTS_ON_WIRE = 53;
 const PacketVersion VERSION_ENTITITES_HAVE_QUERY_BOX = 54;
 const PacketVersion VERSION_ENTITITES_HAVE_COLLISION_MASK = 55;
 const PacketVersion VERSION_ATMOSPHERE_REMOVED = 56;
+const PacketVersion VERSION_ENTITIES_COMPACT_KINEMATICS = 57;
 
 enum class AvatarMixerPacketVersion : PacketVersion {
     TranslationSupport = 17,
-    SoftAttachmentSupport
+    SoftAttachmentSupport,
+    SmallestThreeJointRotations,
+    BatchedIdentityAndBillboards,
+    BundledDatagrams
+};
+
+enum class AudioVersion : PacketVersion {
+    RawAudioOnly = 17,
+    CodecNameInAudioPackets,
+    BundledDatagrams
+};
+
+enum class DomainListVersion : PacketVersion {
+    PrePacketVerificationMode = 17,
+    PacketVerificationMode
 };
 
 #endif // hifi_PacketHeaders_h
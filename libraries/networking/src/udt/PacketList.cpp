@@ -11,6 +11,9 @@
 
 #include "PacketList.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <QDebug>
 
 using namespace udt;
@@ -46,6 +49,7 @@ PacketList::PacketList(PacketList&& other) :
     _packets(std::move(other._packets)),
     _isReliable(other._isReliable),
     _isOrdered(other._isOrdered),
+    _priority(other._priority),
     _extendedHeader(std::move(other._extendedHeader))
 {
 }
@@ -121,6 +125,61 @@ void PacketList::closeCurrentPacket(bool shouldSendEmpty) {
     }
 }
 
+void PacketList::streamFrom(std::unique_ptr<QIODevice> device, qint64 size) {
+    Q_ASSERT_X(_isReliable && _isOrdered, "PacketList::streamFrom", "only reliable ordered messages can be streamed");
+    Q_ASSERT_X(!isStreaming(), "PacketList::streamFrom", "the list is already streaming");
+    Q_ASSERT(_segmentStartIndex == -1);
+    
+    _streamDevice = std::move(device);
+    _streamBytesLeft = size;
+    
+    // top up the packet being written now, so the streamed data doesn't start with a mostly empty packet
+    if (_currentPacket && isStreaming()) {
+        writeStreamedData(*_currentPacket, std::min(_streamBytesLeft, _currentPacket->bytesAvailableForWrite()));
+    }
+    if (!isStreaming()) {
+        _streamDevice.reset();
+    }
+}
+
+void PacketList::writeStreamedData(Packet& packet, qint64 size) {
+    char* destination = packet.getPayload() + packet.pos();
+    qint64 bytesRead = std::max(_streamDevice->read(destination, size), (qint64)0);
+    if (bytesRead < size) {
+        // the receiver was already told how big the message is, so fill in what couldn't be read
+        // rather than end it early
+        qDebug() << "PacketList::writeStreamedData could only read" << bytesRead << "of" << size << "bytes"
+            << "-" << _streamDevice->errorString();
+        memset(destination + bytesRead, 0, size - bytesRead);
+    }
+    packet.setPayloadSize(packet.pos() + size);
+    packet.seek(packet.pos() + size);
+    _streamBytesLeft -= size;
+}
+
+PacketList::PacketPointer PacketList::takeStreamedPacket() {
+    Q_ASSERT(isStreaming());
+    
+    auto packet = createPacketWithExtendedHeader();
+    writeStreamedData(*packet, std::min(_streamBytesLeft, packet->bytesAvailableForWrite()));
+    
+    Packet::PacketPosition position;
+    if (_nextPartNumber == 0) {
+        position = isStreaming() ? Packet::PacketPosition::FIRST : Packet::PacketPosition::ONLY;
+    } else {
+        position = isStreaming() ? Packet::PacketPosition::MIDDLE : Packet::PacketPosition::LAST;
+    }
+    packet->writeMessageNumber(_messageNumber, position, _nextPartNumber++);
+    
+    if (!isStreaming()) {
+        _streamDevice.reset();
+    }
+    if (_streamedPacketWriter) {
+        _streamedPacketWriter(*packet);
+    }
+    return packet;
+}
+
 QByteArray PacketList::getMessage() const {
     size_t sizeBytes = 0;
 
@@ -139,6 +198,17 @@ QByteArray PacketList::getMessage() const {
 }
 
 void PacketList::preparePackets(MessageNumber messageNumber) {
+    if (isStreaming()) {
+        // none of these can be the last, the streamed packets are numbered on from them as they are made
+        _messageNumber = messageNumber;
+        _nextPartNumber = 0;
+        for (auto& packet : _packets) {
+            auto position = _nextPartNumber == 0 ? Packet::PacketPosition::FIRST : Packet::PacketPosition::MIDDLE;
+            packet->writeMessageNumber(messageNumber, position, _nextPartNumber++);
+        }
+        return;
+    }
+    
     Q_ASSERT(_packets.size() > 0);
     
     if (_packets.size() == 1) {
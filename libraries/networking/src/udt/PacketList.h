@@ -12,6 +12,7 @@
 #ifndef hifi_PacketList_h
 #define hifi_PacketList_h
 
+#include <functional>
 #include <memory>
 
 #include <QtCore/QIODevice>
@@ -31,6 +32,15 @@ public:
     using MessageNumber = uint32_t;
     using PacketPointer = std::unique_ptr<Packet>;
     
+    // How the send queue shares a connection between the reliable lists it has queued, see PacketQueue.
+    // Latency sensitive messages should not wait behind a bulk transfer like an asset.
+    enum class Priority : uint8_t {
+        High,
+        Normal,
+        Bulk
+    };
+    static const int NUM_PRIORITIES = 3;
+    
     static std::unique_ptr<PacketList> create(PacketType packetType, QByteArray extendedHeader = QByteArray(),
                                               bool isReliable = false, bool isOrdered = false);
     static std::unique_ptr<PacketList> fromReceivedPackets(std::list<std::unique_ptr<Packet>>&& packets);
@@ -39,6 +49,9 @@ public:
     bool isReliable() const { return _isReliable; }
     bool isOrdered() const { return _isOrdered; }
     
+    Priority getPriority() const { return _priority; }
+    void setPriority(Priority priority) { _priority = priority; }
+    
     size_t getNumPackets() const { return _packets.size() + (_currentPacket ? 1 : 0); }
     size_t getDataSize() const;
     size_t getMessageSize() const;
@@ -52,6 +65,12 @@ public:
     HifiSockAddr getSenderSockAddr() const;
     
     void closeCurrentPacket(bool shouldSendEmpty = false);
+    
+    // Ends the message with `size` bytes read from `device`, which the send queue reads a packet at a time as the
+    // connection has room for them, so a big reliable message never has to be in memory all at once.
+    // Nothing more can be written to the list after this.
+    void streamFrom(std::unique_ptr<QIODevice> device, qint64 size);
+    bool isStreaming() const { return _streamBytesLeft > 0; }
 
     // QIODevice virtual functions
     virtual bool isSequential() const  { return false; }
@@ -85,6 +104,13 @@ private:
     // Takes the first packet of the list and returns it.
     template<typename T> std::unique_ptr<T> takeFront();
     
+    // Makes the next packet of a streamed message, and the last one once the device has been read to the end
+    PacketPointer takeStreamedPacket();
+    void writeStreamedData(Packet& packet, qint64 size);
+    
+    // Used by the sender to fill in the headers of streamed packets, the ones written up front it fills in itself
+    void setStreamedPacketWriter(std::function<void(Packet&)> writer) { _streamedPacketWriter = writer; }
+    
     // Creates a new packet, can be overriden to change return underlying type
     virtual std::unique_ptr<Packet> createPacket();
     std::unique_ptr<Packet> createPacketWithExtendedHeader();
@@ -92,12 +118,18 @@ private:
     Packet::MessageNumber _messageNumber;
     bool _isReliable = false;
     bool _isOrdered = false;
+    Priority _priority = Priority::Normal;
     
     std::unique_ptr<Packet> _currentPacket;
     
     int _segmentStartIndex = -1;
     
     QByteArray _extendedHeader;
+    
+    std::unique_ptr<QIODevice> _streamDevice;
+    qint64 _streamBytesLeft { 0 };
+    Packet::MessagePartNumber _nextPartNumber { 0 };
+    std::function<void(Packet&)> _streamedPacketWriter;
 };
 
 template <typename T> qint64 PacketList::readPrimitive(T* data) {
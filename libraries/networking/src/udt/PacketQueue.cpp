@@ -11,6 +11,8 @@
 
 #include "PacketQueue.h"
 
+#include <algorithm>
+
 #include "PacketList.h"
 
 using namespace udt;
@@ -21,52 +23,98 @@ MessageNumber PacketQueue::getNextMessageNumber() {
     return _currentMessageNumber;
 }
 
-bool PacketQueue::isEmpty() const {
-    LockGuard locker(_packetsLock);
-    // Only the main channel and it is empty
-    return (_channels.size() == 1) && _channels.front().empty();
+// packets a priority may send in a row while the others are waiting
+static const int PRIORITY_WEIGHTS[PacketList::NUM_PRIORITIES] = { 8, 4, 1 };
+
+PacketQueue::PacketQueue() {
+    // single packets go on the main channel, with normal priority
+    auto& normal = _priorities[(int)PacketList::Priority::Normal];
+    normal.channels.resize(1);
+    normal.hasMainChannel = true;
 }
 
-PacketQueue::PacketPointer PacketQueue::takePacket() {
-    LockGuard locker(_packetsLock);
-    if (isEmpty()) {
-        return PacketPointer();
+PacketQueue::PacketPointer PacketQueue::Channel::takePacket() {
+    if (!packets.empty()) {
+        auto packet = std::move(packets.front());
+        packets.pop_front();
+        return packet;
     }
     
-    // Find next non empty channel
-    if (_channels[nextIndex()].empty()) {
-        nextIndex();
+    // reads the next packet's worth from the stream's device
+    auto packet = stream->takeStreamedPacket();
+    if (!stream->isStreaming()) {
+        stream.reset();
     }
-    auto& channel = _channels[_currentIndex];
+    return packet;
+}
+
+bool PacketQueue::PriorityChannels::isEmpty() const {
+    return channels.empty() || (hasMainChannel && channels.size() == 1 && channels.front().empty());
+}
+
+PacketQueue::PacketPointer PacketQueue::PriorityChannels::takePacket() {
+    // Find next non empty channel, only the main channel can be empty
+    currentIndex = (currentIndex + 1) % channels.size();
+    if (channels[currentIndex].empty()) {
+        currentIndex = (currentIndex + 1) % channels.size();
+    }
+    auto& channel = channels[currentIndex];
     Q_ASSERT(!channel.empty());
     
     // Take front packet
-    auto packet = std::move(channel.front());
-    channel.pop_front();
+    auto packet = channel.takePacket();
     
     // Remove now empty channel (Don't remove the main channel)
-    if (channel.empty() && _currentIndex != 0) {
-        channel.swap(_channels.back());
-        _channels.pop_back();
-        --_currentIndex;
+    if (channel.empty() && !(hasMainChannel && currentIndex == 0)) {
+        std::swap(channel, channels.back());
+        channels.pop_back();
+        currentIndex = (currentIndex + channels.size() - 1) % std::max(channels.size(), (size_t)1);
     }
     
     return std::move(packet);
 }
 
-unsigned int PacketQueue::nextIndex() {
-    _currentIndex = (_currentIndex + 1) % _channels.size();
-    return _currentIndex;
+bool PacketQueue::isEmpty() const {
+    LockGuard locker(_packetsLock);
+    for (const auto& priority : _priorities) {
+        if (!priority.isEmpty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PacketQueue::PacketPointer PacketQueue::takePacket() {
+    LockGuard locker(_packetsLock);
+    if (isEmpty()) {
+        return PacketPointer();
+    }
+    
+    // move on to the next priority with packets once this one has had its turn (or has nothing left to send)
+    while (_priorities[_currentPriority].isEmpty() || _packetsTakenThisTurn >= PRIORITY_WEIGHTS[_currentPriority]) {
+        _currentPriority = (_currentPriority + 1) % PacketList::NUM_PRIORITIES;
+        _packetsTakenThisTurn = 0;
+    }
+    
+    ++_packetsTakenThisTurn;
+    return _priorities[_currentPriority].takePacket();
 }
 
 void PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
-    _channels.front().push_back(std::move(packet));
+    _priorities[(int)PacketList::Priority::Normal].channels.front().packets.push_back(std::move(packet));
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
     packetList->preparePackets(getNextMessageNumber());
     
+    auto priority = (int)packetList->getPriority();
+    Channel channel;
+    channel.packets = std::move(packetList->_packets);
+    if (packetList->isStreaming()) {
+        channel.stream = std::move(packetList);
+    }
+    
     LockGuard locker(_packetsLock);
-    _channels.push_back(std::move(packetList->_packets));
+    _priorities[priority].channels.push_back(std::move(channel));
 }
@@ -18,22 +18,42 @@
 #include <mutex>
 
 #include "Packet.h"
+#include "PacketList.h"
 
 namespace udt {
     
-class PacketList;
-    
 using MessageNumber = uint32_t;
     
+// Interleaves the single packets and packet lists a SendQueue has to send. Each list gets its own channel and the
+// channels of a priority are served round robin. The priorities themselves take turns with weighted round robin:
+// while they all have something to send, high gets HIGH_PRIORITY_WEIGHT packets for every packet bulk gets.
 class PacketQueue {
     using Mutex = std::recursive_mutex;
     using LockGuard = std::lock_guard<Mutex>;
     using PacketPointer = std::unique_ptr<Packet>;
     using PacketListPointer = std::unique_ptr<PacketList>;
-    using Channel = std::list<PacketPointer>;
+    
+    struct Channel {
+        std::list<PacketPointer> packets;
+        PacketListPointer stream; // a streamed list, which makes the rest of its packets as they are taken
+        
+        bool empty() const { return packets.empty() && !stream; }
+        PacketPointer takePacket();
+    };
     using Channels = std::vector<Channel>;
     
+    struct PriorityChannels {
+        Channels channels;
+        unsigned int currentIndex { 0 };
+        bool hasMainChannel { false }; // the main channel stays even when it is empty
+        
+        bool isEmpty() const;
+        PacketPointer takePacket();
+    };
+    
 public:
+    PacketQueue();
+    
     void queuePacket(PacketPointer packet);
     void queuePacketList(PacketListPointer packetList);
     
@@ -44,13 +64,13 @@ public:
     
 private:
     MessageNumber getNextMessageNumber();
-    unsigned int nextIndex();
     
     MessageNumber _currentMessageNumber { 0 };
     
     mutable Mutex _packetsLock; // Protects the packets to be sent.
-    Channels _channels = Channels(1); // One channel per packet list + Main channel
-    unsigned int _currentIndex { 0 };
+    PriorityChannels _priorities[PacketList::NUM_PRIORITIES]; // One channel per packet list, main channel is normal
+    int _currentPriority { 0 };
+    int _packetsTakenThisTurn { 0 }; // from the current priority
 };
 
 }
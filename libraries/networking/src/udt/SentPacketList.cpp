@@ -0,0 +1,85 @@
+//
+//  SentPacketList.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketList.h"
+
+#include <algorithm>
+
+#include "Packet.h"
+
+using namespace udt;
+
+static const size_t INITIAL_CAPACITY = 256;
+
+SentPacketList::~SentPacketList() {
+}
+
+void SentPacketList::insert(SequenceNumber seq, std::unique_ptr<Packet> packet) {
+    if (_length == 0) {
+        _firstSequenceNumber = seq;
+    }
+
+    int offset = seqoff(_firstSequenceNumber, seq);
+    Q_ASSERT_X(offset >= _length, "SentPacketList::insert()", "Inserting before the last packet in the list");
+    if (offset < _length) {
+        return;
+    }
+
+    while ((size_t)offset >= _ring.size()) {
+        grow();
+    }
+
+    _ring[(_front + offset) & (_ring.size() - 1)] = std::move(packet);
+    _length = offset + 1;
+}
+
+void SentPacketList::removeUpTo(SequenceNumber seq) {
+    if (_length == 0) {
+        return;
+    }
+
+    int count = std::min(seqoff(_firstSequenceNumber, seq) + 1, _length);
+    if (count <= 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        _ring[(_front + i) & (_ring.size() - 1)].reset();
+    }
+
+    _front = (_front + count) & (_ring.size() - 1);
+    _length -= count;
+    _firstSequenceNumber += count;
+}
+
+Packet* SentPacketList::find(SequenceNumber seq) const {
+    if (_length == 0) {
+        return nullptr;
+    }
+
+    int offset = seqoff(_firstSequenceNumber, seq);
+    if (offset < 0 || offset >= _length) {
+        return nullptr;
+    }
+
+    return _ring[(_front + offset) & (_ring.size() - 1)].get();
+}
+
+void SentPacketList::grow() {
+    std::vector<std::unique_ptr<Packet>> ring(std::max(INITIAL_CAPACITY, 2 * _ring.size()));
+
+    // unroll the packets so the oldest is at the front of the new ring
+    for (int i = 0; i < _length; ++i) {
+        ring[i] = std::move(_ring[(_front + i) & (_ring.size() - 1)]);
+    }
+
+    _ring.swap(ring);
+    _front = 0;
+}
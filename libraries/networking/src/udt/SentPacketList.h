@@ -0,0 +1,54 @@
+//
+//  SentPacketList.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SentPacketList_h
+#define hifi_SentPacketList_h
+
+#include <memory>
+#include <vector>
+
+#include "SequenceNumber.h"
+
+namespace udt {
+
+class Packet;
+
+// The packets a SendQueue has sent and not had ACKed yet, kept in a ring in sequence number order.
+// Sequence numbers are handed out one after the other, so a packet's slot is its offset from the oldest one:
+// lookups are a subtraction and ACKing a range just moves the front of the ring.
+class SentPacketList {
+public:
+    SentPacketList() {}
+    ~SentPacketList();
+
+    // must always add after the last packet inserted - the slots of any sequence numbers skipped stay empty
+    void insert(SequenceNumber seq, std::unique_ptr<Packet> packet);
+
+    // removes every packet up to and including seq
+    void removeUpTo(SequenceNumber seq);
+
+    // the packet sent with seq, or nullptr if it isn't in the list (anymore)
+    Packet* find(SequenceNumber seq) const;
+
+    int getLength() const { return _length; }
+    bool isEmpty() const { return _length == 0; }
+
+private:
+    void grow();
+
+    std::vector<std::unique_ptr<Packet>> _ring; // capacity is always a power of two
+    size_t _front { 0 }; // slot of the oldest packet
+    int _length { 0 };
+    SequenceNumber _firstSequenceNumber; // sequence number of the oldest packet
+};
+
+}
+
+#endif // hifi_SentPacketList_h
@@ -11,7 +11,17 @@
 
 #include "Socket.h"
 
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include <algorithm>
+#include <string.h>
+
 #include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
 
 #include <LogHandler.h>
 
@@ -25,9 +35,99 @@
 
 using namespace udt;
 
+#ifdef Q_OS_LINUX
+
+// the buffers and headers recvmmsg reads a batch of datagrams into, set up once and reused for every batch
+struct Socket::ReceiveBatch {
+    static const int MAX_DATAGRAMS = 32;
+
+    PacketBuffer buffers[MAX_DATAGRAMS];
+    iovec vectors[MAX_DATAGRAMS];
+    sockaddr_in addresses[MAX_DATAGRAMS];
+    mmsghdr messages[MAX_DATAGRAMS];
+
+    ReceiveBatch() {
+        for (int i = 0; i < MAX_DATAGRAMS; ++i) {
+            buffers[i] = PacketBufferPool::allocate(MAX_PACKET_SIZE);
+        }
+    }
+};
+
+#else
+
+struct Socket::ReceiveBatch {
+    static const int MAX_DATAGRAMS = 0;
+};
+
+#endif
+
+// the datagrams a thread queued while a BatchedSends was in scope, copied since the packets they came from
+// are usually gone by the time the batch goes out - one of these is kept for every thread that batches
+struct Socket::SendBatch {
+    static const int MAX_DATAGRAMS = 32;
+
+    Socket* socket { nullptr };
+    int depth { 0 };
+    int numDatagrams { 0 };
+
+    char buffers[MAX_DATAGRAMS][MAX_PACKET_SIZE];
+    int sizes[MAX_DATAGRAMS];
+    HifiSockAddr destinations[MAX_DATAGRAMS];
+    bool isBundle[MAX_DATAGRAMS];
+
+#ifdef Q_OS_LINUX
+    iovec vectors[MAX_DATAGRAMS];
+    sockaddr_in addresses[MAX_DATAGRAMS];
+    mmsghdr messages[MAX_DATAGRAMS];
+#endif
+};
+
+static QThreadStorage<Socket::SendBatch*> threadSendBatches;
+
+Socket::BatchedSends::BatchedSends(Socket& socket) :
+    _socket(socket)
+{
+    if (!threadSendBatches.hasLocalData()) {
+        threadSendBatches.setLocalData(new SendBatch);
+    }
+
+    SendBatch& batch = *threadSendBatches.localData();
+    if (batch.depth == 0) {
+        batch.socket = &_socket;
+    }
+
+    // a nested batch for the same socket just joins the outer one, one for another socket doesn't batch at all
+    if (batch.socket == &_socket) {
+        ++batch.depth;
+    }
+}
+
+Socket::BatchedSends::~BatchedSends() {
+    SendBatch& batch = *threadSendBatches.localData();
+    if (batch.socket == &_socket && --batch.depth == 0) {
+        _socket.flushSendBatch(batch);
+        batch.socket = nullptr;
+    }
+}
+
+
+// the loss of unreliable packets from a sender above which we ask it for parity, and for more parity
+static const float FEC_LOSS_THRESHOLD = 0.02f;
+static const float FEC_HIGH_LOSS_THRESHOLD = 0.10f;
+static const int FEC_GROUP_SIZE = 8;
+static const int FEC_HIGH_LOSS_GROUP_SIZE = 4;
+
+// receivers repeat their request every interval, a sender stops sending parity when it hasn't heard one for a while
+// a bundle is a Bundle control packet whose payload is the datagrams it carries, each after its size
+using BundledDatagramSize = uint16_t;
+
+static const int FEC_UPDATE_INTERVAL_MSECS = 1000;
+static const auto FEC_REQUEST_TIMEOUT = std::chrono::seconds(5);
+
 Socket::Socket(QObject* parent) :
     QObject(parent),
-    _synTimer(new QTimer(this))
+    _synTimer(new QTimer(this)),
+    _fecTimer(new QTimer(this))
 {
     connect(&_udpSocket, &QUdpSocket::readyRead, this, &Socket::readPendingDatagrams);
     
@@ -36,6 +136,16 @@ Socket::Socket(QObject* parent) :
     
     // start our timer for the synchronization time interval
     _synTimer->start(_synInterval);
+
+    connect(_fecTimer, &QTimer::timeout, this, &Socket::updateForwardErrorCorrection);
+    _fecTimer->start(FEC_UPDATE_INTERVAL_MSECS);
+
+#ifdef Q_OS_LINUX
+    _receiveBatch.reset(new ReceiveBatch);
+#endif
+}
+
+Socket::~Socket() {
 }
 
 void Socket::rebind() {
@@ -95,7 +205,21 @@ qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
     // write the correct sequence number to the Packet here
     packet.writeSequenceNumber(++_unreliableSequenceNumbers[sockAddr]);
     
-    return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+    auto bytesWritten = writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+
+    if (_hasParityStreams && _fecFilterOperator && _fecFilterOperator(packet)) {
+        QMutexLocker locker(&_parityStreamsLock);
+
+        auto it = _parityStreams.find(sockAddr);
+        if (it != _parityStreams.end()) {
+            // the receiver is losing packets, follow every group with the parity it can rebuild a lost one from
+            if (auto parity = it->second.encoder.addPacket(packet)) {
+                writeBasePacket(*parity, sockAddr);
+            }
+        }
+    }
+
+    return bytesWritten;
 }
 
 qint64 Socket::writePacket(std::unique_ptr<Packet> packet, const HifiSockAddr& sockAddr) {
@@ -153,12 +277,122 @@ void Socket::writeReliablePacketList(PacketList* packetList, const HifiSockAddr&
 }
 
 qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
-    return writeDatagram(QByteArray::fromRawData(data, size), sockAddr);
+    if (threadSendBatches.hasLocalData()) {
+        SendBatch& batch = *threadSendBatches.localData();
+
+        if (batch.socket == this && size <= MAX_PACKET_SIZE) {
+            if (_isBundlingEnabled && bundleDatagram(batch, data, size, sockAddr)) {
+                return size;
+            }
+
+            memcpy(batch.buffers[batch.numDatagrams], data, size);
+            batch.sizes[batch.numDatagrams] = (int)size;
+            batch.destinations[batch.numDatagrams] = sockAddr;
+            batch.isBundle[batch.numDatagrams] = false;
+
+            if (++batch.numDatagrams == SendBatch::MAX_DATAGRAMS) {
+                flushSendBatch(batch);
+            }
+
+            return size;
+        }
+    }
+
+    return writeDatagramNow(data, size, sockAddr);
 }
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+    return writeDatagram(datagram.constData(), datagram.size(), sockAddr);
+}
+
+bool Socket::bundleDatagram(SendBatch& batch, const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    // only the last one for the destination, so what it receives stays in the order it was sent
+    int index = batch.numDatagrams - 1;
+    while (index >= 0 && batch.destinations[index] != sockAddr) {
+        --index;
+    }
+
+    if (index < 0) {
+        return false;
+    }
+
+    char* buffer = batch.buffers[index];
+    int& bundleSize = batch.sizes[index];
+    const int BUNDLE_HEADER_SIZE = ControlPacket::localHeaderSize();
+
+    int sizeAfter = bundleSize + (int)sizeof(BundledDatagramSize) + (int)size;
+    if (!batch.isBundle[index]) {
+        sizeAfter += BUNDLE_HEADER_SIZE + (int)sizeof(BundledDatagramSize);
+    }
+    if (sizeAfter > MAX_PACKET_SIZE) {
+        return false;
+    }
+
+    if (!batch.isBundle[index]) {
+        // the datagram already queued becomes the first one of the bundle
+        BundledDatagramSize firstSize = bundleSize;
+        memmove(buffer + BUNDLE_HEADER_SIZE + sizeof(BundledDatagramSize), buffer, bundleSize);
+
+        ControlPacket::ControlBitAndType bitAndType = CONTROL_BIT_MASK
+            | (ControlPacket::ControlBitAndType(ControlPacket::Bundle) << (8 * sizeof(ControlPacket::Type)));
+        memcpy(buffer, &bitAndType, BUNDLE_HEADER_SIZE);
+        memcpy(buffer + BUNDLE_HEADER_SIZE, &firstSize, sizeof(BundledDatagramSize));
+
+        bundleSize += BUNDLE_HEADER_SIZE + sizeof(BundledDatagramSize);
+        batch.isBundle[index] = true;
+    }
+
+    BundledDatagramSize datagramSize = size;
+    memcpy(buffer + bundleSize, &datagramSize, sizeof(BundledDatagramSize));
+    memcpy(buffer + bundleSize + sizeof(BundledDatagramSize), data, size);
+    bundleSize = sizeAfter;
+
+    return true;
+}
+
+void Socket::flushSendBatch(SendBatch& batch) {
+    int numSent = 0;
+
+#ifdef Q_OS_LINUX
+    bool canSendAll = true;
+    for (int i = 0; i < batch.numDatagrams; ++i) {
+        // sendmmsg goes straight to the descriptor, so it only takes the IPv4 destinations the socket is bound for
+        if (batch.destinations[i].getAddress().protocol() != QAbstractSocket::IPv4Protocol) {
+            canSendAll = false;
+            break;
+        }
+
+        memset(&batch.addresses[i], 0, sizeof(sockaddr_in));
+        batch.addresses[i].sin_family = AF_INET;
+        batch.addresses[i].sin_addr.s_addr = htonl(batch.destinations[i].getAddress().toIPv4Address());
+        batch.addresses[i].sin_port = htons(batch.destinations[i].getPort());
+
+        batch.vectors[i].iov_base = batch.buffers[i];
+        batch.vectors[i].iov_len = batch.sizes[i];
+
+        memset(&batch.messages[i], 0, sizeof(mmsghdr));
+        batch.messages[i].msg_hdr.msg_iov = &batch.vectors[i];
+        batch.messages[i].msg_hdr.msg_iovlen = 1;
+        batch.messages[i].msg_hdr.msg_name = &batch.addresses[i];
+        batch.messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    if (canSendAll && batch.numDatagrams > 0) {
+        numSent = std::max(sendmmsg((int)_udpSocket.socketDescriptor(), batch.messages, batch.numDatagrams, 0), 0);
+    }
+#endif
+
+    // whatever didn't go out in one call (or everything, without sendmmsg) is sent one by one, which logs errors
+    for (int i = numSent; i < batch.numDatagrams; ++i) {
+        writeDatagramNow(batch.buffers[i], batch.sizes[i], batch.destinations[i]);
+    }
+
+    batch.numDatagrams = 0;
+}
+
+qint64 Socket::writeDatagramNow(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
     
-    qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
+    qint64 bytesWritten = _udpSocket.writeDatagram(data, size, sockAddr.getAddress(), sockAddr.getPort());
     
     if (bytesWritten < 0) {
         // when saturating a link this isn't an uncommon message - suppress it so it doesn't bomb the debug
@@ -202,9 +436,23 @@ void Socket::clearConnections() {
         qDebug() << "Clearing all remaining connections in Socket.";
         _connectionsHash.clear();
     }
+
+    _fecDecoders.clear();
+
+    QMutexLocker locker(&_parityStreamsLock);
+    _parityStreams.clear();
+    _hasParityStreams = false;
 }
 
 void Socket::cleanupConnection(HifiSockAddr sockAddr) {
+    _fecDecoders.erase(sockAddr);
+
+    {
+        QMutexLocker locker(&_parityStreamsLock);
+        _parityStreams.erase(sockAddr);
+        _hasParityStreams = !_parityStreams.empty();
+    }
+
     auto numErased = _connectionsHash.erase(sockAddr);
     
     if (numErased > 0) {
@@ -233,71 +481,250 @@ void Socket::readPendingDatagrams() {
         HifiSockAddr senderSockAddr;
         
         // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        auto buffer = PacketBufferPool::allocate(packetSizeWithHeader);
        
-        // pull the datagram
+        // pull the datagram - the first one always goes through the QUdpSocket, which doesn't tell us about
+        // new datagrams again until one has been read from it
         auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
                                                 senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
 
-        if (sizeRead <= 0) {
-            // we either didn't pull anything for this packet or there was an error reading (this seems to trigger
-            // on windows even if there's not a packet available)
+        // we either didn't pull anything for this packet or there was an error reading if nothing was read
+        // (this seems to trigger on windows even if there's not a packet available)
+        if (sizeRead > 0) {
+            processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        }
+
+        // then pull the rest a batch at a time, for as long as the batches come back full
+        if (_receiveBatch) {
+            while (readDatagramBatch() == ReceiveBatch::MAX_DATAGRAMS) {}
+        }
+    }
+}
+
+int Socket::readDatagramBatch() {
+#ifdef Q_OS_LINUX
+    ReceiveBatch& batch = *_receiveBatch;
+
+    for (int i = 0; i < ReceiveBatch::MAX_DATAGRAMS; ++i) {
+        batch.vectors[i].iov_base = batch.buffers[i].get();
+        batch.vectors[i].iov_len = MAX_PACKET_SIZE;
+
+        memset(&batch.messages[i], 0, sizeof(mmsghdr));
+        batch.messages[i].msg_hdr.msg_iov = &batch.vectors[i];
+        batch.messages[i].msg_hdr.msg_iovlen = 1;
+        batch.messages[i].msg_hdr.msg_name = &batch.addresses[i];
+        batch.messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    int numDatagrams = recvmmsg((int)_udpSocket.socketDescriptor(), batch.messages, ReceiveBatch::MAX_DATAGRAMS,
+                                MSG_DONTWAIT, nullptr);
+
+    if (numDatagrams < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            // this kernel can't do it, fall back to reading every datagram through the QUdpSocket
+            qCDebug(networking) << "Batched datagram reads are not available, errno" << errno;
+            _receiveBatch.reset();
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < numDatagrams; ++i) {
+        const msghdr& header = batch.messages[i].msg_hdr;
+        int packetSizeWithHeader = (int)batch.messages[i].msg_len;
+
+        if (packetSizeWithHeader <= 0 || (header.msg_flags & MSG_TRUNC)
+            || header.msg_namelen != sizeof(sockaddr_in)) {
             continue;
         }
+
+        HifiSockAddr senderSockAddr(reinterpret_cast<const sockaddr*>(&batch.addresses[i]));
+
+        // the packet takes the buffer it was read into, the batch gets a new one for next time
+        auto buffer = std::move(batch.buffers[i]);
+        batch.buffers[i] = PacketBufferPool::allocate(MAX_PACKET_SIZE);
+
+        processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+    }
+
+    return numDatagrams;
+#else
+    return 0;
+#endif
+}
+
+void Socket::processDatagram(PacketBuffer buffer, int packetSizeWithHeader,
+                             const HifiSockAddr& senderSockAddr, bool wasRecovered) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+    
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+            it->second(std::move(basePacket));
+        }
         
-        auto it = _unfilteredHandlers.find(senderSockAddr);
-        
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                it->second(std::move(basePacket));
-            }
-            
-            continue;
+        return;
+    }
+    
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+    
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+
+        // forward error correction is for unreliable packets, it is handled here and not by a connection
+        if (controlPacket->getType() == ControlPacket::FECParity) {
+            processParity(*controlPacket, senderSockAddr);
+            return;
+        } else if (controlPacket->getType() == ControlPacket::FECRequest) {
+            processForwardErrorCorrectionRequest(*controlPacket, senderSockAddr);
+            return;
+        } else if (controlPacket->getType() == ControlPacket::Bundle) {
+            processBundle(*controlPacket, senderSockAddr);
+            return;
         }
         
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        // move this control packet to the matching connection
+        auto& connection = findOrCreateConnection(senderSockAddr);
+        connection.processControl(move(controlPacket));
         
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            
-            // move this control packet to the matching connection
-            auto& connection = findOrCreateConnection(senderSockAddr);
-            connection.processControl(move(controlPacket));
-            
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto& connection = findOrCreateConnection(senderSockAddr);
-                    
-                    if (!connection.processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                  packet->getDataSize(),
-                                                                  packet->getPayloadSize())) {
-                        // the connection indicated that we should not continue processing this packet
-                        continue;
-                    }
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto& connection = findOrCreateConnection(senderSockAddr);
+                
+                if (!connection.processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                              packet->getDataSize(),
+                                                              packet->getPayloadSize())) {
+                    // the connection indicated that we should not continue processing this packet
+                    return;
                 }
-
-                if (packet->isPartOfMessage()) {
-                    auto& connection = findOrCreateConnection(senderSockAddr);
-                    connection.queueReceivedMessagePacket(std::move(packet));
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+            } else {
+                bool isProtected = _fecFilterOperator && _fecFilterOperator(*packet);
+                if (!_fecDecoders[senderSockAddr].addPacket(*packet, isProtected, wasRecovered)) {
+                    // we already rebuilt this one from parity
+                    return;
                 }
             }
+
+            if (packet->isPartOfMessage()) {
+                auto& connection = findOrCreateConnection(senderSockAddr);
+                connection.queueReceivedMessagePacket(std::move(packet));
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
+            }
         }
     }
 }
 
+void Socket::processForwardErrorCorrectionRequest(ControlPacket& request, const HifiSockAddr& senderSockAddr) {
+    uint8_t groupSize = 0;
+    request.readPrimitive(&groupSize);
+
+    QMutexLocker locker(&_parityStreamsLock);
+
+    if (groupSize == 0) {
+        _parityStreams.erase(senderSockAddr);
+    } else {
+        auto& stream = _parityStreams[senderSockAddr];
+        stream.encoder.setGroupSize(groupSize);
+        stream.lastRequestTime = p_high_resolution_clock::now();
+    }
+
+    _hasParityStreams = !_parityStreams.empty();
+}
+
+void Socket::processParity(ControlPacket& parity, const HifiSockAddr& senderSockAddr) {
+    PacketBuffer buffer;
+    int size = _fecDecoders[senderSockAddr].recover(parity, buffer);
+
+    if (size > 0) {
+        // handle the rebuilt packet as if it had just come in, it is still verified like any other
+        processDatagram(std::move(buffer), size, senderSockAddr, true);
+    }
+}
+
+void Socket::processBundle(ControlPacket& bundle, const HifiSockAddr& senderSockAddr) {
+    const char* data = bundle.getPayload();
+    qint64 bytesLeft = bundle.getPayloadSize();
+
+    while (bytesLeft >= (qint64)sizeof(BundledDatagramSize)) {
+        BundledDatagramSize size;
+        memcpy(&size, data, sizeof(BundledDatagramSize));
+        data += sizeof(BundledDatagramSize);
+        bytesLeft -= sizeof(BundledDatagramSize);
+
+        if (size < sizeof(ControlPacket::ControlBitAndType) || size > bytesLeft) {
+            qCDebug(networking) << "Dropping the rest of a malformed bundle from" << senderSockAddr;
+            return;
+        }
+
+        // each is handled as if it had come in on its own, with its own sequence number, verification and parity
+        auto buffer = PacketBufferPool::allocate(size);
+        memcpy(buffer.get(), data, size);
+        processDatagram(std::move(buffer), size, senderSockAddr);
+
+        data += size;
+        bytesLeft -= size;
+    }
+}
+
+void Socket::updateForwardErrorCorrection() {
+    // ask the senders we lose too many unreliable packets from for parity, and tell the others they can stop
+    for (auto it = _fecDecoders.begin(); it != _fecDecoders.end();) {
+        auto& decoder = it->second;
+        float lossRate = decoder.takeLossRate();
+        int requestedGroupSize = decoder.getRequestedGroupSize();
+
+        if (lossRate < 0.0f && requestedGroupSize == 0) {
+            // nothing heard from this sender in a while
+            it = _fecDecoders.erase(it);
+            continue;
+        }
+
+        int groupSize = 0;
+        if (lossRate >= FEC_HIGH_LOSS_THRESHOLD) {
+            groupSize = FEC_HIGH_LOSS_GROUP_SIZE;
+        } else if (lossRate >= FEC_LOSS_THRESHOLD) {
+            groupSize = FEC_GROUP_SIZE;
+        } else if (requestedGroupSize > 0 && (lossRate < 0.0f || lossRate >= FEC_LOSS_THRESHOLD / 2.0f)) {
+            // parity is already on, keep it on until the loss has clearly gone down
+            groupSize = requestedGroupSize;
+        }
+
+        if (groupSize > 0 || requestedGroupSize > 0) {
+            auto request = ControlPacket::create(ControlPacket::FECRequest, sizeof(uint8_t));
+            request->writePrimitive((uint8_t)groupSize);
+            writeBasePacket(*request, it->first);
+
+            decoder.setRequestedGroupSize(groupSize);
+        }
+
+        ++it;
+    }
+
+    // stop sending parity to the receivers that haven't asked for it in a while (their request to stop got lost)
+    QMutexLocker locker(&_parityStreamsLock);
+    auto now = p_high_resolution_clock::now();
+
+    for (auto it = _parityStreams.begin(); it != _parityStreams.end();) {
+        if (now - it->second.lastRequestTime > FEC_REQUEST_TIMEOUT) {
+            it = _parityStreams.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    _hasParityStreams = !_parityStreams.empty();
+}
+
 void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* receiver, const char* slot) {
     auto it = _connectionsHash.find(destinationAddr);
     if (it != _connectionsHash.end()) {
@@ -14,16 +14,22 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
 
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 #include <QtNetwork/QUdpSocket>
 
+#include <PortableHighResolutionClock.h>
+
 #include "../HifiSockAddr.h"
 #include "CongestionControl.h"
 #include "Connection.h"
+#include "ForwardErrorCorrection.h"
+#include "PacketBufferPool.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -48,7 +54,21 @@ class Socket : public QObject {
 public:
     using StatsVector = std::vector<std::pair<HifiSockAddr, ConnectionStats::Stats>>;
     
+    struct SendBatch;
+
+    /// While one of these is in scope on a thread, the datagrams that thread sends through the socket are queued and
+    /// go out together when the outermost one goes out of scope (or the queue fills up) - with a single sendmmsg call
+    /// where the OS has it. Meant for the tight send loops of the mixers.
+    class BatchedSends {
+    public:
+        BatchedSends(Socket& socket);
+        ~BatchedSends();
+    private:
+        Socket& _socket;
+    };
+
     Socket(QObject* object = 0);
+    ~Socket();
     
     quint16 localPort() const { return _udpSocket.localPort(); }
     
@@ -64,6 +84,14 @@ public:
     void rebind();
     
     void setPacketFilterOperator(PacketFilterOperator filterOperator) { _packetFilterOperator = filterOperator; }
+
+    // picks the unreliable packets parity is sent for when a receiver loses too many of them
+    void setForwardErrorCorrectionFilter(PacketFilterOperator filterOperator) { _fecFilterOperator = filterOperator; }
+
+    // lets the datagrams a BatchedSends queues for one destination go out packed in as few as they fit in, that the
+    // receiving socket unpacks - only for sockets that send to peers that know about bundles
+    void setBundlingEnabled(bool enabled) { _isBundlingEnabled = enabled; }
+
     void setPacketHandler(PacketHandler handler) { _packetHandler = handler; }
     void setMessageHandler(MessageHandler handler) { _messageHandler = handler; }
     void setMessageFailureHandler(MessageFailureHandler handler) { _messageFailureHandler = handler; }
@@ -85,10 +113,27 @@ public slots:
 private slots:
     void readPendingDatagrams();
     void rateControlSync();
+    void updateForwardErrorCorrection();
     
 private:
     void setSystemBufferSizes();
     Connection& findOrCreateConnection(const HifiSockAddr& sockAddr);
+
+    void processDatagram(PacketBuffer buffer, int packetSizeWithHeader, const HifiSockAddr& senderSockAddr,
+                         bool wasRecovered = false);
+    void processForwardErrorCorrectionRequest(ControlPacket& request, const HifiSockAddr& senderSockAddr);
+    void processParity(ControlPacket& parity, const HifiSockAddr& senderSockAddr);
+    void processBundle(ControlPacket& bundle, const HifiSockAddr& senderSockAddr);
+
+    qint64 writeDatagramNow(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+    void flushSendBatch(SendBatch& batch);
+
+    // appends the datagram to the last one queued for its destination if they fit together, returns false if not
+    bool bundleDatagram(SendBatch& batch, const char* data, qint64 size, const HifiSockAddr& sockAddr);
+
+    // reads up to a batch of datagrams straight from the socket descriptor with one call, where the OS supports it
+    // returns the number of datagrams read
+    int readDatagramBatch();
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
     ConnectionStats::Stats sampleStatsForConnection(const HifiSockAddr& destination);
@@ -101,6 +146,7 @@ private:
     
     QUdpSocket _udpSocket { this };
     PacketFilterOperator _packetFilterOperator;
+    PacketFilterOperator _fecFilterOperator;
     PacketHandler _packetHandler;
     MessageHandler _messageHandler;
     MessageFailureHandler _messageFailureHandler;
@@ -111,8 +157,26 @@ private:
     
     int _synInterval = 10; // 10ms
     QTimer* _synTimer;
+
+    // parity we send because the receiver asked for it, used from every thread that sends
+    struct ParityStream {
+        FECEncoder encoder;
+        p_high_resolution_clock::time_point lastRequestTime;
+    };
+    QMutex _parityStreamsLock;
+    std::unordered_map<HifiSockAddr, ParityStream> _parityStreams;
+    std::atomic<bool> _hasParityStreams { false };
+
+    std::atomic<bool> _isBundlingEnabled { false };
+
+    // what we need to recover the packets we receive, only used on the socket thread
+    std::unordered_map<HifiSockAddr, FECDecoder> _fecDecoders;
+    QTimer* _fecTimer;
     
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<DefaultCC>() };
+
+    struct ReceiveBatch;
+    std::unique_ptr<ReceiveBatch> _receiveBatch; // null when batched reads aren't available
     
     friend UDTTest;
 };
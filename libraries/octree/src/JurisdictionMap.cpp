@@ -19,6 +19,7 @@
 #include <udt/PacketHeaders.h>
 #include <OctalCode.h>
 
+#include "OctreeConstants.h"
 #include "OctreeLogging.h"
 #include "JurisdictionMap.h"
 
@@ -67,6 +68,46 @@ JurisdictionMap::~JurisdictionMap() {
     clear();
 }
 
+std::vector<JurisdictionMap> JurisdictionMap::split() const {
+    std::vector<JurisdictionMap> children;
+    for (int childIndex = 0; childIndex < NUMBER_OF_CHILDREN; childIndex++) {
+        unsigned char* childRoot = childOctalCode(_rootOctalCode, childIndex);
+
+        // the end nodes go with the child they're under, a child at or under an end node isn't ours at all
+        bool isWithin = true;
+        std::vector<unsigned char*> childEndNodes;
+        for (size_t i = 0; i < _endNodes.size(); i++) {
+            if (isAncestorOf(_endNodes[i], childRoot)) {
+                isWithin = false;
+                break;
+            }
+            if (isAncestorOf(childRoot, _endNodes[i])) {
+                childEndNodes.push_back(_endNodes[i]);
+            }
+        }
+
+        if (isWithin) {
+            JurisdictionMap child(_nodeType);
+            child.copyContents(childRoot, childEndNodes);
+            children.push_back(child);
+        }
+        delete[] childRoot;
+    }
+    return children;
+}
+
+QString JurisdictionMap::getRootHexString() const {
+    return octalCodeToHexString(_rootOctalCode);
+}
+
+QStringList JurisdictionMap::getEndNodeHexStrings() const {
+    QStringList endNodes;
+    for (size_t i = 0; i < _endNodes.size(); i++) {
+        endNodes << octalCodeToHexString(_endNodes[i]);
+    }
+    return endNodes;
+}
+
 void JurisdictionMap::clear() {
     if (_rootOctalCode) {
         delete[] _rootOctalCode;
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 #include <QtCore/QUuid>
 
 #include <shared/ReadWriteLockable.h>
@@ -56,6 +57,13 @@ public:
 
     void copyContents(unsigned char* rootCodeIn, const std::vector<unsigned char*>& endNodesIn);
 
+    /// The jurisdictions of the children of our root, less those wholly past an end node. Between them they cover
+    /// what this one does, for spreading a busy jurisdiction over more servers.
+    std::vector<JurisdictionMap> split() const;
+
+    QString getRootHexString() const;
+    QStringList getEndNodeHexStrings() const;
+
     int unpackFromPacket(ReceivedMessage& message);
     std::unique_ptr<NLPacket> packIntoPacket();
 
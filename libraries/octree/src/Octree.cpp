@@ -18,6 +18,7 @@
 #include <cmath>
 #include <fstream> // to load voxels from file
 
+#include <QBuffer>
 #include <QDataStream>
 #include <QDebug>
 #include <QEventLoop>
@@ -26,6 +27,7 @@
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QNetworkAccessManager>
+#include <QSaveFile>
 #include <QVector>
 #include <QFile>
 #include <QJsonDocument>
@@ -48,7 +50,7 @@
 #include "OctreeLogging.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz", "ents"};
 
 Octree::Octree(bool shouldReaverage) :
     _rootElement(NULL),
@@ -341,6 +343,7 @@ int Octree::readElementData(OctreeElementPointer destinationElement, const unsig
             // When it adds the child it automatically sets the detinationElement dirty.
             OctreeElementPointer childElementAt = destinationElement->addChildAtIndex(i);
 
+            args.elementCube = childElementAt->getAACube();
             int childElementDataRead = childElementAt->readElementDataFromBuffer(nodeData + bytesRead, bytesLeftToRead, args);
             childElementAt->setSourceUUID(args.sourceUUID);
 
@@ -416,6 +419,7 @@ int Octree::readElementData(OctreeElementPointer destinationElement, const unsig
     // if this is the root, and there is more data to read, allow it to read it's element data...
     if (destinationElement == _rootElement  && rootElementHasData() && bytesLeftToRead > 0) {
         // tell the element to read the subsequent data
+        args.elementCube = _rootElement->getAACube();
         int rootDataSize = _rootElement->readElementDataFromBuffer(nodeData + bytesRead, bytesLeftToRead, args);
         bytesRead += rootDataSize;
         bytesLeftToRead -= rootDataSize;
@@ -1633,6 +1637,10 @@ bool Octree::readFromFile(const char* fileName) {
         return readJSONFromGzippedFile(qFileName);
     }
 
+    if (qFileName.endsWith(".ents")) {
+        return readFromSnapshotFile(qFileName);
+    }
+
     QFile file(qFileName);
 
     if (!file.open(QIODevice::ReadOnly)) {
@@ -1675,6 +1683,29 @@ bool Octree::readJSONFromGzippedFile(QString qFileName) {
     return readJSONFromStream(-1, jsonStream);
 }
 
+bool Octree::readFromSnapshotFile(QString qFileName) {
+    QFile file(qFileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Cannot open snapshot file for reading: " << qFileName;
+        return false;
+    }
+
+    qCDebug(octree) << "Loading snapshot" << qFileName << "...";
+
+    // decoded straight out of the page cache, nothing is copied before it is turned into octree data
+    qint64 fileSize = file.size();
+    uchar* data = file.map(0, fileSize);
+    if (!data) {
+        qCritical() << "Cannot map snapshot file: " << qFileName << file.errorString();
+        return false;
+    }
+
+    bool success = readFromSnapshot(data, fileSize);
+
+    file.unmap(data);
+    return success;
+}
+
 bool Octree::readFromURL(const QString& urlString) {
     bool readOk = false;
 
@@ -1896,14 +1927,14 @@ void Octree::writeToFile(const char* fileName, OctreeElementPointer element, QSt
         writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "ents") {
+        writeToSnapshotFile(cFileName, element);
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
 }
 
 void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element, bool doGzip) {
-    QVariantMap entityDescription;
-
     qCDebug(octree, "Saving JSON SVO to file %s...", fileName);
 
     OctreeElementPointer top;
@@ -1913,36 +1944,78 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
         top = _rootElement;
     }
 
+    // the JSON goes out as it is made, so the file only replaces the one there once all of it is written
+    QSaveFile persistFile(fileName);
+    if (!persistFile.open(QIODevice::WriteOnly)) {
+        qCritical("Could not write to JSON description of entities.");
+        return;
+    }
+
+    bool success;
+    if (doGzip) {
+        GzipWriter gzipFile(&persistFile);
+        gzipFile.open(QIODevice::WriteOnly);
+        success = writeToJSON(gzipFile, top);
+        success = gzipFile.finish() && success;
+    } else {
+        success = writeToJSON(persistFile, top);
+    }
+
+    // a file that isn't committed is discarded, leaving the one that was there
+    if (!success) {
+        qCritical("Failed to write the JSON description of entities.");
+    } else if (!persistFile.commit()) {
+        qCritical("Could not write to JSON description of entities.");
+    }
+}
+
+bool Octree::writeToJSON(QIODevice& json, OctreeElementPointer element) {
+    QVariantMap entityDescription;
+
     // include the "bitstream" version
     PacketType expectedType = expectedDataPacketType();
     PacketVersion expectedVersion = versionForPacketType(expectedType);
     entityDescription["Version"] = (int) expectedVersion;
 
     // store the entity data
-    bool entityDescriptionSuccess = writeToMap(entityDescription, top, true, true);
+    bool entityDescriptionSuccess = writeToMap(entityDescription, element, true, true);
     if (!entityDescriptionSuccess) {
         qCritical("Failed to convert Entities to QVariantMap while saving to json.");
-        return;
+        return false;
     }
 
     // convert the QVariantMap to JSON
     QByteArray jsonData = QJsonDocument::fromVariant(entityDescription).toJson();
-    QByteArray jsonDataForFile;
+    return json.write(jsonData) == jsonData.size();
+}
 
-    if (doGzip) {
-        if (!gzip(jsonData, jsonDataForFile, -1)) {
-            qCritical("unable to gzip data while saving to json.");
-            return;
-        }
+void Octree::writeToSnapshotFile(const char* fileName, OctreeElementPointer element) {
+    qCDebug(octree, "Saving snapshot to file %s...", fileName);
+
+    OctreeElementPointer top;
+    if (element) {
+        top = element;
     } else {
-        jsonDataForFile = jsonData;
+        top = _rootElement;
+    }
+
+    QByteArray snapshotData;
+    QBuffer snapshotBuffer(&snapshotData);
+    snapshotBuffer.open(QIODevice::WriteOnly);
+
+    if (!writeToSnapshot(snapshotBuffer, top)) {
+        // rather than lose what can't be in a snapshot, save everything the slow way
+        QString jsonFileName = fileNameWithoutExtension(QString(fileName), PERSIST_EXTENSIONS) + ".json.gz";
+        qCritical() << "Failed to write a snapshot, saving to" << jsonFileName << "instead.";
+        writeToJSONFile(qPrintable(jsonFileName), top, true);
+        return;
     }
 
     QFile persistFile(fileName);
     if (persistFile.open(QIODevice::WriteOnly)) {
-        persistFile.write(jsonDataForFile);
+        persistFile.write(snapshotData);
     } else {
-        qCritical("Could not write to JSON description of entities.");
+        qCritical("Could not write to snapshot of the octree.");
     }
 }
 
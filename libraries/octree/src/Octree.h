@@ -18,6 +18,8 @@
 #include <QHash>
 #include <QObject>
 
+class QIODevice;
+
 #include <shared/ReadWriteLockable.h>
 #include <SimpleMovingAverage.h>
 
@@ -35,6 +37,16 @@ class OctreePacketData;
 class Shape;
 using OctreePointer = std::shared_ptr<Octree>;
 
+/// Inbound edits a tree has decoded without holding its lock, so they can all be applied under one write lock
+class OctreeEditBatch {
+public:
+    virtual ~OctreeEditBatch() {}
+
+    /// the number of edits that are left to apply
+    virtual int getNumEdits() const = 0;
+};
+using OctreeEditBatchPointer = std::unique_ptr<OctreeEditBatch>;
+
 extern QVector<QString> PERSIST_EXTENSIONS;
 
 /// derive from this class to use the Octree::recurseTreeWithOperator() method
@@ -82,6 +94,10 @@ public:
     JurisdictionMap* jurisdictionMap;
     OctreeElementExtraEncodeData* extraEncodeData;
 
+    // the data is only going to a viewer that will be sent it again when it changes, so it can be quantized,
+    // files and snapshots leave this off to keep full precision
+    bool allowLossyEncoding;
+
     // output hints from the encode process
     typedef enum {
         UNKNOWN,
@@ -125,6 +141,7 @@ public:
             stats(stats),
             jurisdictionMap(jurisdictionMap),
             extraEncodeData(extraEncodeData),
+            allowLossyEncoding(false),
             stopReason(UNKNOWN)
     {}
 
@@ -164,6 +181,13 @@ public:
     }
 
     std::function<void(const QUuid& dataID, quint64 itemLastEdited)> trackSend { [](const QUuid&, quint64){} };
+
+    // Asked before a data item that passed the view checks is encoded, with the time it last changed on the server and
+    // its distance from the viewer. A sender that coalesces updates per viewer returns false for an item the viewer
+    // already has, or for one it will send later because it was sent too recently for its distance.
+    std::function<bool(const QUuid& dataID, quint64 itemLastChanged, float distance)> shouldSendData {
+        [](const QUuid&, quint64, float){ return true; }
+    };
 };
 
 class ReadElementBufferToTreeArgs {
@@ -184,6 +208,7 @@ public:
     PacketVersion bitstreamVersion;
     int elementsPerPacket = 0;
     int entitiesPerPacket = 0;
+    AACube elementCube; // the cube of the element whose data is being read, some data is encoded relative to it
 
     ReadBitstreamToTreeParams(
         bool includeExistsBits = WANT_EXISTS_BITS,
@@ -220,6 +245,15 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+
+    // Batched edits, for trees that can decode their edit packets without the tree lock. An edit that a later one in
+    // the same batch fully overrides is dropped, and the rest are applied in the order they came in.
+    virtual OctreeEditBatchPointer createEditBatch() const { return OctreeEditBatchPointer(); }
+    /// decodes an edit into the batch without the tree lock, returns the bytes read like processEditPacketData()
+    virtual int decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& sourceNode, OctreeEditBatch& batch) { return 0; }
+    /// applies and empties the batch, callers must lock the tree for writing
+    virtual void processEditBatch(OctreeEditBatch& batch) { }
                     
     virtual bool recurseChildrenWithData() const { return true; }
     virtual bool rootElementHasData() const { return false; }
@@ -304,8 +338,12 @@ public:
     void writeToFile(const char* filename, OctreeElementPointer element = NULL, QString persistAsFileType = "svo");
     void writeToJSONFile(const char* filename, OctreeElementPointer element = NULL, bool doGzip = false);
     void writeToSVOFile(const char* filename, OctreeElementPointer element = NULL);
+    void writeToSnapshotFile(const char* filename, OctreeElementPointer element = NULL);
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) = 0;
+    /// the persist file's JSON document, this one converts all of the tree with writeToMap first, trees with a lot in
+    /// them can write theirs out a piece at a time instead
+    virtual bool writeToJSON(QIODevice& json, OctreeElementPointer element);
 
     // Octree importers
     bool readFromFile(const char* filename);
@@ -314,8 +352,22 @@ public:
     bool readSVOFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromGzippedFile(QString qFileName);
+    bool readFromSnapshotFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // Binary snapshot, the tree's data in its own encoding so it loads without going through JSON
+    virtual bool supportsSnapshot() const { return false; }
+    virtual bool writeToSnapshot(QIODevice& snapshot, OctreeElementPointer element) { return false; }
+    /// callers must lock the tree, data only needs to stay valid for the duration of the call
+    virtual bool readFromSnapshot(const unsigned char* data, qint64 size) { return false; }
+
+    // Edit journal, appended to by the persister between full saves so it only has to write what changed
+    virtual bool supportsJournal() const { return false; }
+    /// appends the changes made since the last call, as one batch
+    virtual bool writeToJournal(QIODevice& journal) { return false; }
+    /// replays the batches in a journal over what was read from the persist file, callers must lock the tree
+    virtual bool readFromJournal(QIODevice& journal) { return false; }
+
     unsigned long getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -85,6 +85,7 @@ void OctreeEditPacketSender::queuePacketToNode(const QUuid& nodeUUID, std::uniqu
             packet->seek(0);
 
             // pack sequence number
+            _sentPacketHistoriesLock.lock();
             quint16 sequence = _outgoingSequenceNumbers[nodeUUID]++;
             packet->writePrimitive(sequence);
 
@@ -109,6 +110,7 @@ void OctreeEditPacketSender::queuePacketToNode(const QUuid& nodeUUID, std::uniqu
 
             // add packet to history
             _sentPacketHistories[nodeUUID].packetSent(sequence, *packet);
+            _sentPacketHistoriesLock.unlock();
 
             queuePacketForSending(node, NLPacket::createCopy(*packet));
         }
@@ -342,6 +344,8 @@ bool OctreeEditPacketSender::process() {
 void OctreeEditPacketSender::processNackPacket(ReceivedMessage& message, SharedNodePointer sendingNode) {
     // parse sending node from packet, retrieve packet history for that node
 
+    QMutexLocker locker(&_sentPacketHistoriesLock);
+
     // if packet history doesn't exist for the sender node (somehow), bail
     if (_sentPacketHistories.count(sendingNode->getUUID()) == 0) {
         return;
@@ -363,9 +367,14 @@ void OctreeEditPacketSender::processNackPacket(ReceivedMessage& message, SharedN
 }
 
 void OctreeEditPacketSender::nodeKilled(SharedNodePointer node) {
-    // TODO: add locks
     QUuid nodeUUID = node->getUUID();
+
+    _packetsQueueLock.lock();
     _pendingEditPackets.erase(nodeUUID);
+    _packetsQueueLock.unlock();
+
+    _sentPacketHistoriesLock.lock();
     _outgoingSequenceNumbers.erase(nodeUUID);
     _sentPacketHistories.erase(nodeUUID);
+    _sentPacketHistoriesLock.unlock();
 }
@@ -34,6 +34,8 @@ AtomicUIntStat OctreeElement::_externalChildrenMemoryUsage { 0 };
 AtomicUIntStat OctreeElement::_voxelNodeCount { 0 };
 AtomicUIntStat OctreeElement::_voxelNodeLeafCount { 0 };
 
+std::atomic<quint64> OctreeElement::_changeSequence { 0 };
+
 void OctreeElement::resetPopulationStatistics() {
     _voxelNodeCount = 0;
     _voxelNodeLeafCount = 0;
@@ -111,6 +113,7 @@ OctreeElement::~OctreeElement() {
 
 void OctreeElement::markWithChangedTime() {
     _lastChanged = usecTimestampNow();
+    _changeSequence++;
 }
 
 // This method is called by Octree when the subtree below this node
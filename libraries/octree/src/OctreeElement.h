@@ -155,6 +155,10 @@ public:
     bool hasChangedSince(quint64 time) const { return (_lastChanged > time); }
     void markWithChangedTime();
     quint64 getLastChanged() const { return _lastChanged; }
+
+    /// goes up every time any element is marked as changed, so a reader that remembers it can tell nothing has
+    /// changed since without walking the tree
+    static quint64 getChangeSequence() { return _changeSequence; }
     void handleSubtreeChanged(OctreePointer myTree);
 
     // Used by VoxelSystem for rendering in/out of view and LOD
@@ -280,6 +284,8 @@ protected:
 
     static AtomicUIntStat _externalChildrenCount;
     static AtomicUIntStat _childrenCount[NUMBER_OF_CHILDREN + 1];
+
+    static std::atomic<quint64> _changeSequence;
 };
 
 #endif // hifi_OctreeElement_h
@@ -10,23 +10,57 @@
 //
 
 #include "OctreeElementBag.h"
+
+#include <algorithm>
+
 #include <OctalCode.h>
 
 void OctreeElementBag::deleteAll() {
-    _bagElements = Bag();
+    _bagElements.clear();
+}
+
+void OctreeElementBag::popExpired() {
+    while (!_bagElements.empty() && _bagElements.front().element.expired()) {
+        std::pop_heap(_bagElements.begin(), _bagElements.end());
+        _bagElements.pop_back();
+    }
 }
 
 bool OctreeElementBag::isEmpty() {
     // Pop all expired front elements
-    while (!_bagElements.empty() && _bagElements.front().expired()) {
-        _bagElements.pop();
-    }
+    popExpired();
     
     return _bagElements.empty();
 }
 
+void OctreeElementBag::prioritize(Entry& entry, const OctreeElement& element) const {
+    entry.inView = true;
+    entry.importance = 0.0f;
+
+    if (!_hasView) {
+        return; // first in, first out
+    }
+
+    float distance = element.distanceToCamera(_viewFrustum);
+    float boundaryDistance = boundaryDistanceForRenderLevel(element.getLevel() + _boundaryLevelAdjust,
+                                                            _octreeElementSizeScale);
+
+    entry.inView = distance < boundaryDistance && element.isInView(_viewFrustum);
+
+    // the cube covers about (scale / distance)^2 steradians, the ones we are inside of cover everything
+    float scale = element.getScale();
+    distance = std::max(distance, scale);
+    entry.importance = (scale * scale) / (distance * distance);
+}
+
 void OctreeElementBag::insert(OctreeElementPointer element) {
-    _bagElements.push(element);
+    Entry entry;
+    entry.sequence = _nextSequence++;
+    entry.element = element;
+    prioritize(entry, *element);
+
+    _bagElements.push_back(entry);
+    std::push_heap(_bagElements.begin(), _bagElements.end());
 }
 
 OctreeElementPointer OctreeElementBag::extract() {
@@ -34,8 +68,38 @@ OctreeElementPointer OctreeElementBag::extract() {
 
     // Find the first element still alive
     while (!result && !_bagElements.empty()) {
-        result = _bagElements.front().lock(); // Grab head's shared_ptr
-        _bagElements.pop();
+        result = _bagElements.front().element.lock(); // Grab head's shared_ptr
+        std::pop_heap(_bagElements.begin(), _bagElements.end());
+        _bagElements.pop_back();
     }
     return result;
 }
+
+void OctreeElementBag::setView(const ViewFrustum& viewFrustum, float octreeElementSizeScale, int boundaryLevelAdjust) {
+    _hasView = true;
+    _viewFrustum = viewFrustum;
+    _octreeElementSizeScale = octreeElementSizeScale;
+    _boundaryLevelAdjust = boundaryLevelAdjust;
+
+    // what is left from the last view is still sent, but in the order of the new one
+    auto end = std::remove_if(_bagElements.begin(), _bagElements.end(), [this](Entry& entry) {
+        OctreeElementPointer element = entry.element.lock();
+        if (!element) {
+            return true;
+        }
+        prioritize(entry, *element);
+        return false;
+    });
+    _bagElements.erase(end, _bagElements.end());
+    std::make_heap(_bagElements.begin(), _bagElements.end());
+}
+
+void OctreeElementBag::clearView() {
+    _hasView = false;
+
+    for (auto& entry : _bagElements) {
+        entry.inView = true;
+        entry.importance = 0.0f;
+    }
+    std::make_heap(_bagElements.begin(), _bagElements.end());
+}
@@ -16,13 +16,11 @@
 #ifndef hifi_OctreeElementBag_h
 #define hifi_OctreeElementBag_h
 
-#include <queue>
+#include <vector>
 
 #include "OctreeElement.h"
 
 class OctreeElementBag {
-    using Bag = std::queue<OctreeElementWeakPointer>;
-    
 public:
     void insert(OctreeElementPointer element); // put a element into the bag
     OctreeElementPointer extract(); // pull a element out of the bag (could come in any order)
@@ -30,8 +28,42 @@ public:
     
     void deleteAll();
 
+    /// Once a view is set, elements come out of the bag most important first - the elements in view before the ones
+    /// that aren't, and the ones that cover the most of the screen (roughly the solid angle of their cube) before the
+    /// smaller or farther ones. Elements beyond the LOD boundary for their level come out with the ones out of view.
+    /// The elements already in the bag are reordered for the new view. Without a view the bag is first in, first out.
+    void setView(const ViewFrustum& viewFrustum, float octreeElementSizeScale, int boundaryLevelAdjust);
+    void clearView();
+
 private:
-    Bag _bagElements;
+    struct Entry {
+        bool inView;
+        float importance;
+        quint64 sequence;
+        OctreeElementWeakPointer element;
+
+        // for a max-heap, most important first and the oldest first among equals
+        bool operator<(const Entry& other) const {
+            if (inView != other.inView) {
+                return !inView;
+            }
+            if (importance != other.importance) {
+                return importance < other.importance;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    void prioritize(Entry& entry, const OctreeElement& element) const;
+    void popExpired();
+
+    std::vector<Entry> _bagElements; // heap, the next element out is at the front
+    quint64 _nextSequence { 0 };
+
+    bool _hasView { false };
+    ViewFrustum _viewFrustum;
+    float _octreeElementSizeScale { DEFAULT_OCTREE_SIZE_SCALE };
+    int _boundaryLevelAdjust { 0 };
 };
 
 using OctreeElementExtraEncodeData = QMap<const OctreeElement*, void*>;
@@ -9,11 +9,19 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <NodeList.h>
+#include <NumericalConstants.h>
 
 #include "OctreeLogging.h"
 #include "OctreeHeadlessViewer.h"
 
+// The servers send what is in the keyhole, and in the frustum up to the far clip. The corners of the far plane are a bit
+// further out than the far clip, so what is kept reaches a little past the radius rather than being dropped to come again.
+const float INTEREST_KEEP_SCALE = 1.5f;
+const quint64 INTEREST_EVICTION_INTERVAL_USECS = USECS_PER_SECOND;
+
 OctreeHeadlessViewer::OctreeHeadlessViewer() : OctreeRenderer()
 {
     _viewFrustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO, DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
@@ -56,6 +64,19 @@ void OctreeHeadlessViewer::queryOctree() {
     _octreeQuery.setOctreeSizeScale(_voxelSizeScale);
     _octreeQuery.setBoundaryLevelAdjust(_boundaryLevelAdjust);
 
+    if (_interestRadius > 0.0f) {
+        // ask for everything around us within the radius, whichever way we face, and nothing further out
+        _octreeQuery.setKeyholeRadius(std::max(_viewFrustum.getKeyholeRadius(), _interestRadius));
+        _octreeQuery.setCameraFarClip(std::min(_viewFrustum.getFarClip(), _interestRadius));
+
+        quint64 now = usecTimestampNow();
+        bool evict = (now - _lastEviction) > INTEREST_EVICTION_INTERVAL_USECS;
+        if (evict) {
+            _lastEviction = now;
+        }
+        updateInterest(_viewFrustum.getPosition(), _interestRadius * INTEREST_KEEP_SCALE, evict);
+    }
+
     // Iterate all of the nodes, and get a count of how many voxel servers we have...
     int totalServers = 0;
     int inViewServers = 0;
@@ -53,6 +53,10 @@ public slots:
     void setBoundaryLevelAdjust(int boundaryLevelAdjust) { _boundaryLevelAdjust = boundaryLevelAdjust; }
     void setMaxPacketsPerSecond(int maxPacketsPerSecond) { _maxPacketsPerSecond = maxPacketsPerSecond; }
 
+    // Agents that only need the content around them set a radius to ask for, read in and keep only what is within it,
+    // 0 for everything in view
+    void setInterestRadius(float interestRadius) { _interestRadius = interestRadius; }
+
     // getters for camera attributes
     const glm::vec3& getPosition() const { return _viewFrustum.getPosition(); }
     const glm::quat& getOrientation() const { return _viewFrustum.getOrientation(); }
@@ -61,9 +65,15 @@ public slots:
     float getVoxelSizeScale() const { return _voxelSizeScale; }
     int getBoundaryLevelAdjust() const { return _boundaryLevelAdjust; }
     int getMaxPacketsPerSecond() const { return _maxPacketsPerSecond; }
+    float getInterestRadius() const { return _interestRadius; }
 
     unsigned getOctreeElementsCount() const { return _tree->getOctreeElementsCount(); }
 
+protected:
+    /// Called from queryOctree() while there's an interest radius, subclasses keep their tree to the sphere. The tree
+    /// is only asked to drop what is already outside of it when evict is true, which is at most once a second.
+    virtual void updateInterest(const glm::vec3& center, float radius, bool evict) { }
+
 private:
     ViewFrustum _viewFrustum;
     JurisdictionListener* _jurisdictionListener = nullptr;
@@ -72,6 +82,8 @@ private:
     float _voxelSizeScale { DEFAULT_OCTREE_SIZE_SCALE };
     int _boundaryLevelAdjust { 0 };
     int _maxPacketsPerSecond { DEFAULT_MAX_OCTREE_PPS };
+    float _interestRadius { 0.0f };
+    quint64 _lastEviction { 0 };
 };
 
 #endif // hifi_OctreeHeadlessViewer_h
@@ -9,8 +9,13 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <zlib.h>
+
+#include <QtCore/QThreadStorage>
+
 #include <GLMHelpers.h>
 #include <PerfStat.h>
+#include <UUID.h>
 
 #include "OctreeLogging.h"
 #include "OctreePacketData.h"
@@ -24,6 +29,61 @@ AtomicUIntStat OctreePacketData::_totalBytesOfValues { 0 };
 AtomicUIntStat OctreePacketData::_totalBytesOfPositions { 0 };
 AtomicUIntStat OctreePacketData::_totalBytesOfRawData { 0 };
 
+// Sections are small, so on their own they hardly compress - most of what they repeat is repeated across packets,
+// not within one. Deflate primed with these bytes can refer back to them from the first byte of every section.
+// The common strings of entity properties (urls, file types, user data keys) and the little endian encodings of
+// the most common float values, the most common ones last since deflate reaches the end of the dictionary cheapest.
+// Changing this changes the compressed form, the dictionary id in the zlib header keeps old peers from misreading.
+static const char COMPRESSION_DICTIONARY[] =
+    ".fst" ".svo" ".json" ".obj" ".mp3" ".ogg" ".jpg" ".png" ".wav" ".fbx" ".js"
+    "https://hifi-content.s3.amazonaws.com/" "https://hifi-public.s3.amazonaws.com/" "http://mpassets.highfidelity.com/"
+    "http://" "https://" "atp:/" "file:///"
+    "{\"ProceduralEntity\":{\"version\":2,\"shaderUrl\":\"" "\"uniforms\":{" "\"channels\":["
+    "{\"grabbableKey\":{\"wantsTrigger\":true,\"grabbable\":false}}"
+    "{\"grabbableKey\":{\"grabbable\":true}}" "{\"grabbableKey\":{\"grabbable\":false}}"
+    "\"textures\":{\"" "\"tex.picture\":\"" "\"file1\":\"" "\":\"" "\",\"" "\":{" "\":" ":true" ":false"
+    "\x00\x00\x00\x3f" "\x00\x00\x80\xbf" "\xcd\xcc\xcc\x3d" "\x00\x00\x80\x3f" "\x00\x00\x00\x00\x00\x00\x00\x00"
+    "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00";
+
+// the array also ends with a NULL, which isn't part of the dictionary
+static const uInt COMPRESSION_DICTIONARY_SIZE = sizeof(COMPRESSION_DICTIONARY) - 1;
+
+// less than the level 9 the qCompress form uses, small sections compress about as well and it costs much less
+static const int DICTIONARY_COMPRESSION_LEVEL = 6;
+static const int DICTIONARY_WINDOW_BITS = 15;
+static const int DICTIONARY_MEM_LEVEL = 8;
+
+namespace {
+
+// setting up a deflate stream allocates a few hundred kilobytes, so every thread that sends keeps one and resets it
+struct DeflateStream {
+    z_stream stream;
+    bool isValid { false };
+
+    DeflateStream() {
+        memset(&stream, 0, sizeof(stream));
+        isValid = deflateInit2(&stream, DICTIONARY_COMPRESSION_LEVEL, Z_DEFLATED, DICTIONARY_WINDOW_BITS,
+                               DICTIONARY_MEM_LEVEL, Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+
+    ~DeflateStream() {
+        if (isValid) {
+            deflateEnd(&stream);
+        }
+    }
+};
+
+QThreadStorage<DeflateStream*> deflateStreams;
+
+DeflateStream& deflateStream() {
+    if (!deflateStreams.hasLocalData()) {
+        deflateStreams.setLocalData(new DeflateStream);
+    }
+    return *deflateStreams.localData();
+}
+
+}
+
 struct aaCubeData {
     glm::vec3 corner;
     float scale;
@@ -39,6 +99,15 @@ void OctreePacketData::changeSettings(bool enableCompression, unsigned int targe
     reset();
 }
 
+void OctreePacketData::setUseCompressionDictionary(bool useCompressionDictionary) {
+    if (_useCompressionDictionary != useCompressionDictionary) {
+        _useCompressionDictionary = useCompressionDictionary;
+
+        // anything already finalized is in the other form
+        _dirty = _enableCompression && hasContent();
+    }
+}
+
 void OctreePacketData::reset() {
     _bytesInUse = 0;
     _bytesAvailable = _targetSize;
@@ -486,6 +555,31 @@ bool OctreePacketData::appendValue(bool value) {
 bool OctreePacketData::appendValue(const QString& string) {
     // TODO: make this a ByteCountCoded leading byte
     uint16_t length = string.size() + 1; // include NULL
+
+    // plain ascii, which urls, names and most scripts are, goes straight into the packet rather than through a copy
+    const QChar* characters = string.constData();
+    bool isAscii = true;
+    for (int i = 0; i < string.size() && isAscii; i++) {
+        isAscii = characters[i].unicode() < 0x80;
+    }
+    if (isAscii) {
+        if ((int)(sizeof(length) + length) > _bytesAvailable) {
+            return false;
+        }
+        appendValue(length);
+        unsigned char* buffer = &_uncompressed[_bytesInUse];
+        for (int i = 0; i < string.size(); i++) {
+            buffer[i] = (unsigned char)characters[i].unicode();
+        }
+        buffer[string.size()] = 0;
+        _bytesInUse += length;
+        _bytesAvailable -= length;
+        _dirty = true;
+        _bytesOfRawData += length;
+        _totalBytesOfRawData += length;
+        return true;
+    }
+
     bool success = appendValue(length);
     if (success) {
         success = appendRawData((const unsigned char*)qPrintable(string), length);
@@ -494,14 +588,15 @@ bool OctreePacketData::appendValue(const QString& string) {
 }
 
 bool OctreePacketData::appendValue(const QUuid& uuid) {
-    QByteArray bytes = uuid.toRfc4122();
     if (uuid.isNull()) {
         return appendValue((uint16_t)0); // zero length for null uuid
     } else {
-        uint16_t length = bytes.size();
+        unsigned char bytes[NUM_BYTES_RFC4122_UUID];
+        uuidToRfc4122(uuid, bytes);
+        uint16_t length = NUM_BYTES_RFC4122_UUID;
         bool success = appendValue(length);
         if (success) {
-            success = appendRawData((const unsigned char*)bytes.constData(), bytes.size());
+            success = appendRawData(bytes, length);
         }
         return success;
     }
@@ -566,6 +661,10 @@ bool OctreePacketData::compressContent() {
         return true;
     }
 
+    if (_useCompressionDictionary) {
+        return compressContentWithDictionary();
+    }
+
     _bytesInUseLastCheck = _bytesInUse;
 
     bool success = false;
@@ -588,13 +687,81 @@ bool OctreePacketData::compressContent() {
     return success;
 }
 
+bool OctreePacketData::compressContentWithDictionary() {
+    _bytesInUseLastCheck = _bytesInUse;
+
+    DeflateStream& deflater = deflateStream();
+    if (!deflater.isValid) {
+        return false;
+    }
+
+    z_stream& stream = deflater.stream;
+    if (deflateReset(&stream) != Z_OK ||
+        deflateSetDictionary(&stream, (const Bytef*)COMPRESSION_DICTIONARY, COMPRESSION_DICTIONARY_SIZE) != Z_OK) {
+        return false;
+    }
+
+    stream.next_in = &_uncompressed[0];
+    stream.avail_in = _bytesInUse;
+    stream.next_out = &_compressed[0];
+    stream.avail_out = MAX_OCTREE_PACKET_DATA_SIZE;
+
+    // if it doesn't all fit, the compressed form is too big to send anyway
+    bool success = false;
+    if (deflate(&stream, Z_FINISH) == Z_STREAM_END) {
+        _compressedBytes = (int)stream.total_out;
+        _dirty = false;
+        success = true;
+    }
+    return success;
+}
+
+void OctreePacketData::uncompressContentWithDictionary(const unsigned char* data, int length) {
+    if (length > (int)sizeof(_compressed)) {
+        return;
+    }
+
+    memcpy(&_compressed[0], data, length);
+    _compressedBytes = length;
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, DICTIONARY_WINDOW_BITS) != Z_OK) {
+        return;
+    }
+
+    stream.next_in = &_compressed[0];
+    stream.avail_in = length;
+    stream.next_out = &_uncompressed[0];
+    stream.avail_out = _bytesAvailable;
+
+    int result = inflate(&stream, Z_FINISH);
+    if (result == Z_NEED_DICT) {
+        // a section compressed with another dictionary fails here, its id doesn't match
+        result = inflateSetDictionary(&stream, (const Bytef*)COMPRESSION_DICTIONARY, COMPRESSION_DICTIONARY_SIZE);
+        if (result == Z_OK) {
+            result = inflate(&stream, Z_FINISH);
+        }
+    }
+
+    if (result == Z_STREAM_END) {
+        _bytesInUse = (int)stream.total_out;
+        _bytesAvailable -= _bytesInUse;
+    } else if (_debug) {
+        qCDebug(octree, "OctreePacketData::uncompressContentWithDictionary()... failed result = %d", result);
+    }
+
+    inflateEnd(&stream);
+}
 
 void OctreePacketData::loadFinalizedContent(const unsigned char* data, int length) {
     reset();
 
     if (data && length > 0) {
 
-        if (_enableCompression) {
+        if (_enableCompression && _useCompressionDictionary) {
+            uncompressContentWithDictionary(data, length);
+        } else if (_enableCompression) {
             QByteArray compressedData;
             for (int i = 0; i < length; i++) {
                 compressedData[i] = data[i];
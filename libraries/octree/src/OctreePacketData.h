@@ -59,6 +59,7 @@ const int REASONABLE_NUMBER_OF_PACKING_ATTEMPTS = 5;
 
 const int PACKET_IS_COLOR_BIT = 0;
 const int PACKET_IS_COMPRESSED_BIT = 1;
+const int PACKET_IS_DICTIONARY_COMPRESSED_BIT = 2; // the sections are deflated with the shared compression dictionary
 
 /// An opaque key used when starting, ending, and discarding encoding/packing levels of OctreePacketData
 class LevelDetails {
@@ -229,6 +230,11 @@ public:
     
     /// returns whether or not zlib compression enabled on finalization
     bool isCompressed() const { return _enableCompression; }
+
+    /// use the shared dictionary of common entity property encodings when compressing and uncompressing, this is a
+    /// different finalized form, so the reader has to be told which one the writer used
+    void setUseCompressionDictionary(bool useCompressionDictionary);
+    bool getUseCompressionDictionary() const { return _useCompressionDictionary; }
     
     /// returns the target uncompressed size
     unsigned int getTargetSize() const { return _targetSize; }
@@ -275,6 +281,7 @@ private:
 
     unsigned int _targetSize;
     bool _enableCompression;
+    bool _useCompressionDictionary { false };
     
     unsigned char _uncompressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
     int _bytesInUse;
@@ -284,6 +291,8 @@ private:
     int _subTreeBytesReserved; // the number of reserved bytes at start of a subtree
 
     bool compressContent();
+    bool compressContentWithDictionary();
+    void uncompressContentWithDictionary(const unsigned char* data, int length);
     
     unsigned char _compressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
     int _compressedBytes;
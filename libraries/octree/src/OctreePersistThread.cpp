@@ -18,6 +18,7 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -31,6 +32,12 @@
 
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
 
+// trees that keep a journal append their edits to it this often, it is as much as a crash can lose
+const int JOURNAL_INTERVAL_MSECS = 1000;
+
+// the journal is folded back into a full save once it gets to this fraction of the size of the persist file
+const float JOURNAL_COMPACTION_RATIO = 0.5f;
+
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, int persistInterval,
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
                                          QString persistAsFileType) :
@@ -40,6 +47,7 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _initialLoadComplete(false),
     _loadTimeUSecs(0),
     _lastCheck(0),
+    _lastJournalWrite(0),
     _wantBackup(wantBackup),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
@@ -57,6 +65,8 @@ QString OctreePersistThread::getPersistFileMimeType() const {
         return "application/json";
     } if (_persistAsFileType == "json.gz") {
         return "application/zip";
+    } if (_persistAsFileType == "ents") {
+        return "application/octet-stream";
     }
     return "";
 }
@@ -158,6 +168,9 @@ bool OctreePersistThread::process() {
             }
 
             persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+
+            // the edits made since the last full save are in the journal
+            replayJournal();
             _tree->pruneTree();
         });
 
@@ -189,6 +202,7 @@ bool OctreePersistThread::process() {
 
         // Since we just loaded the persistent file, we can consider ourselves as having "just checked" for persistance.
         _lastCheck = usecTimestampNow(); // we just loaded, no need to save again
+        _lastJournalWrite = _lastCheck;
         
         // This last persist time is not really used until the file is actually persisted. It is only
         // used in formatting the backup filename in cases of non-rolling backup names. However, we don't
@@ -212,7 +226,11 @@ bool OctreePersistThread::process() {
 
         if (sinceLastSave > intervalToCheck) {
             _lastCheck = now;
+            _lastJournalWrite = now;
             persist();
+        } else if (_tree->supportsJournal() && now - _lastJournalWrite > JOURNAL_INTERVAL_MSECS * MSECS_TO_USECS) {
+            _lastJournalWrite = now;
+            writeJournal();
         }
     }
     
@@ -233,7 +251,7 @@ bool OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
-    persist();
+    persist(true);
     qCDebug(octree) << "Persist thread done with about to finish...";
     _stopThread = true;
 }
@@ -247,9 +265,46 @@ QByteArray OctreePersistThread::getPersistFileContents() const {
     return fileContents;
 }
 
-void OctreePersistThread::persist() {
+void OctreePersistThread::writeJournal() {
+    QFile journal(getJournalFilename());
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCDebug(octree) << "Unable to open journal" << journal.fileName() << "to append edits to it";
+        return;
+    }
+
+    if (!_tree->writeToJournal(journal)) {
+        qCDebug(octree) << "Failed to append edits to journal" << journal.fileName();
+    }
+}
+
+void OctreePersistThread::replayJournal() {
+    QFile journal(getJournalFilename());
+    if (!_tree->supportsJournal() || !journal.exists()) {
+        return;
+    }
+
+    if (journal.open(QIODevice::ReadOnly)) {
+        qCDebug(octree) << "Replaying journal" << journal.fileName() << "over" << _filename;
+        _tree->readFromJournal(journal);
+    } else {
+        qCDebug(octree) << "Unable to open journal" << journal.fileName() << "- edits since the last save are lost";
+    }
+}
+
+void OctreePersistThread::persist(bool forceFullSave) {
     if (_tree->isDirty() && _initialLoadComplete) {
 
+        // a tree with a journal only has to append what changed, until the journal is big enough to fold back in
+        if (_tree->supportsJournal() && !forceFullSave) {
+            writeJournal();
+
+            qint64 journalSize = QFileInfo(getJournalFilename()).size();
+            if (journalSize < JOURNAL_COMPACTION_RATIO * QFileInfo(_filename).size()) {
+                return;
+            }
+            qCDebug(octree) << "journal has grown to" << journalSize << "bytes, doing a full save";
+        }
+
         _tree->withWriteLock([&] {
             qCDebug(octree) << "pruning Octree before saving...";
             _tree->pruneTree();
@@ -272,6 +327,11 @@ void OctreePersistThread::persist() {
             _tree->clearDirtyBit(); // tree is clean after saving
             qCDebug(octree) << "DONE saving Octree to file...";
 
+            // the full save has everything that was in the journal
+            if (_tree->supportsJournal()) {
+                QFile::remove(getJournalFilename());
+            }
+
             lockFile.close();
             qCDebug(octree) << "saving Octree lock file closed:" << lockFileName;
             remove(qPrintable(lockFileName));
@@ -53,8 +53,11 @@ protected:
     /// Implements generic processing behavior for this thread.
     virtual bool process();
 
-    void persist();
+    void persist(bool forceFullSave = false);
     void backup();
+    QString getJournalFilename() const { return _filename + ".journal"; }
+    void writeJournal();
+    void replayJournal();
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
     bool getMostRecentBackup(const QString& format, QString& mostRecentBackupFileName, QDateTime& mostRecentBackupTime);
@@ -71,6 +74,7 @@ private:
 
     time_t _lastPersistTime;
     quint64 _lastCheck;
+    quint64 _lastJournalWrite;
     bool _wantBackup;
     QVector<BackupRule> _backupRules;
 
@@ -49,6 +49,7 @@ int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
     setAtBit(bitItems, WANT_COLOR_AT_BIT);
     setAtBit(bitItems, WANT_DELTA_AT_BIT);
     setAtBit(bitItems, WANT_COMPRESSION);
+    setAtBit(bitItems, WANT_COMPRESSION_DICTIONARY);
 
     *destinationBuffer++ = bitItems;
 
@@ -93,7 +94,7 @@ int OctreeQuery::parseData(ReceivedMessage& message) {
 
     // NOTE: we used to use these bits to set feature request items if we need to extend the protocol with optional features
     // do it here with... wantFeature= oneAtBit(bitItems, WANT_FEATURE_BIT);
-    Q_UNUSED(bitItems);
+    _wantsCompressionDictionary = oneAtBit(bitItems, WANT_COMPRESSION_DICTIONARY);
 
     // desired Max Octree PPS
     memcpy(&_maxQueryPPS, sourceBuffer, sizeof(_maxQueryPPS));
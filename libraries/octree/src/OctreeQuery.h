@@ -37,7 +37,7 @@ typedef unsigned long long quint64;
 const int WANT_LOW_RES_MOVING_BIT = 0;
 const int WANT_COLOR_AT_BIT = 1;
 const int WANT_DELTA_AT_BIT = 2;
-const int UNUSED_BIT_3 = 3; // unused... available for new feature
+const int WANT_COMPRESSION_DICTIONARY = 3; // 4th bit, can read sections compressed with the shared dictionary
 const int WANT_COMPRESSION = 4; // 5th bit
 
 class OctreeQuery : public NodeData {
@@ -76,6 +76,7 @@ public:
     int getMaxQueryPacketsPerSecond() const { return _maxQueryPPS; }
     float getOctreeSizeScale() const { return _octreeElementSizeScale; }
     int getBoundaryLevelAdjust() const { return _boundaryLevelAdjust; }
+    bool getWantsCompressionDictionary() const { return _wantsCompressionDictionary; }
 
 public slots:
     void setMaxQueryPacketsPerSecond(int maxQueryPPS) { _maxQueryPPS = maxQueryPPS; }
@@ -97,6 +98,7 @@ protected:
     int _maxQueryPPS = DEFAULT_MAX_OCTREE_PPS;
     float _octreeElementSizeScale = DEFAULT_OCTREE_SIZE_SCALE; /// used for LOD calculations
     int _boundaryLevelAdjust = 0; /// used for LOD calculations
+    bool _wantsCompressionDictionary = false; /// old clients don't ask for it
 
 private:
     // privatize the copy constructor and assignment operator so they cannot be called
@@ -72,6 +72,7 @@ void OctreeRenderer::processDatagram(ReceivedMessage& message, SharedNodePointer
 
         bool packetIsColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
         bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
+        bool packetIsDictionaryCompressed = oneAtBit(flags, PACKET_IS_DICTIONARY_COMPRESSED_BIT);
         
         OCTREE_PACKET_SENT_TIME arrivedAt = usecTimestampNow();
         int clockSkew = sourceNode ? sourceNode->getClockSkewUsec() : 0;
@@ -125,6 +126,7 @@ void OctreeRenderer::processDatagram(ReceivedMessage& message, SharedNodePointer
                     startUncompress = usecTimestampNow();
 
                     OctreePacketData packetData(packetIsCompressed);
+                    packetData.setUseCompressionDictionary(packetIsDictionaryCompressed);
                     packetData.loadFinalizedContent(reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition()),
                         sectionLength);
                     if (extraDebugging) {
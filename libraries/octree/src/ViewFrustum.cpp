@@ -361,6 +361,12 @@ ViewFrustum::location ViewFrustum::boxInFrustum(const AABox& box) const {
     return regularResult;
 }
 
+void ViewFrustum::getPlanes(glm::vec4 planes[NUM_PLANES]) const {
+    for (int i = 0; i < NUM_PLANES; i++) {
+        planes[i] = glm::vec4(_planes[i].getNormal(), _planes[i].getDCoefficient());
+    }
+}
+
 bool testMatches(glm::quat lhs, glm::quat rhs, float epsilon = EPSILON) {
     return (fabs(lhs.x - rhs.x) <= epsilon && fabs(lhs.y - rhs.y) <= epsilon && fabs(lhs.z - rhs.z) <= epsilon
             && fabs(lhs.w - rhs.w) <= epsilon);
@@ -770,6 +776,14 @@ void ViewFrustum::evalViewTransform(Transform& view) const {
 
 float ViewFrustum::calculateRenderAccuracy(const AABox& bounds, float octreeSizeScale, int boundaryLevelAdjust) const {
     float distanceToCamera = glm::length(bounds.calcCenter() - getPosition());
+
+    // FIXME - for now, it's either visible or not visible. We want to adjust this to eventually return
+    // a floating point for objects that have small angular size to indicate that they may be rendered
+    // with lower preciscion
+    return (distanceToCamera <= calculateRenderDistance(bounds, octreeSizeScale, boundaryLevelAdjust)) ? 1.0f : 0.0f;
+}
+
+float ViewFrustum::calculateRenderDistance(const AABox& bounds, float octreeSizeScale, int boundaryLevelAdjust) const {
     float largestDimension = bounds.getLargestDimension();
 
     const float maxScale = (float)TREE_SCALE;
@@ -800,11 +814,7 @@ float ViewFrustum::calculateRenderAccuracy(const AABox& bounds, float octreeSize
     if (closestScale < largestDimension) {
         visibleDistanceAtClosestScale *= 2.0f;
     }
-
-    // FIXME - for now, it's either visible or not visible. We want to adjust this to eventually return
-    // a floating point for objects that have small angular size to indicate that they may be rendered
-    // with lower preciscion
-    return (distanceToCamera <= visibleDistanceAtClosestScale) ? 1.0f : 0.0f; 
+    return visibleDistanceAtClosestScale;
 }
 
 float boundaryDistanceForRenderLevel(unsigned int renderLevel, float voxelSizeScale) {
@@ -96,6 +96,10 @@ public:
     ViewFrustum::location cubeInFrustum(const AACube& cube) const;
     ViewFrustum::location boxInFrustum(const AABox& box) const;
 
+    // the six planes as (normal, d), the same the in-frustum tests use
+    static const int NUM_PLANES = 6;
+    void getPlanes(glm::vec4 planes[NUM_PLANES]) const;
+
     // some frustum comparisons
     bool matches(const ViewFrustum& compareTo, bool debug = false) const;
     bool matches(const ViewFrustum* compareTo, bool debug = false) const { return matches(*compareTo, debug); }
@@ -125,6 +129,10 @@ public:
     float calculateRenderAccuracy(const AABox& bounds, float octreeSizeScale = DEFAULT_OCTREE_SIZE_SCALE, 
                                   int boundaryLevelAdjust = 0) const;
 
+    /// the distance out to which things the size of the bounds are rendered at these settings
+    float calculateRenderDistance(const AABox& bounds, float octreeSizeScale = DEFAULT_OCTREE_SIZE_SCALE,
+                                  int boundaryLevelAdjust = 0) const;
+
 private:
     // Used for keyhole calculations
     ViewFrustum::location pointInKeyhole(const glm::vec3& point) const;
@@ -133,8 +133,24 @@ void CharacterController::preStep(btCollisionWorld* collisionWorld) {
     // trace a ray straight down to see if we're standing on the ground
     const btTransform& xform = _rigidBody->getWorldTransform();
 
+    // while the character stands still on something the probes below would find what they found last substep,
+    // so they are only repeated every so often in case that went away
+    const btScalar MAX_REST_DISPLACEMENT = 0.001f; // meters
+    const btScalar MAX_REST_SPEED = 0.01f; // meters per second
+    const int MAX_PROBES_SKIPPED_AT_REST = 15;
+    const btVector3& position = xform.getOrigin();
+    if (onGround() && _numProbesSkipped < MAX_PROBES_SKIPPED_AT_REST &&
+            position.distance2(_lastProbePosition) < MAX_REST_DISPLACEMENT * MAX_REST_DISPLACEMENT &&
+            _rigidBody->getLinearVelocity().length2() < MAX_REST_SPEED * MAX_REST_SPEED &&
+            _walkVelocity.length2() < MAX_REST_SPEED * MAX_REST_SPEED) {
+        ++_numProbesSkipped;
+        return;
+    }
+    _numProbesSkipped = 0;
+    _lastProbePosition = position;
+
     // rayStart is at center of bottom sphere
-    btVector3 rayStart = xform.getOrigin() - _halfHeight * _currentUp;
+    btVector3 rayStart = position - _halfHeight * _currentUp;
 
     // rayEnd is some short distance outside bottom sphere
     const btScalar FLOOR_PROXIMITY_THRESHOLD = 0.3f * _radius;
@@ -145,11 +161,15 @@ void CharacterController::preStep(btCollisionWorld* collisionWorld) {
     ClosestNotMe rayCallback(_rigidBody);
     rayCallback.m_closestHitFraction = 1.0f;
     collisionWorld->rayTest(rayStart, rayEnd, rayCallback);
+    bool floorIsNear = false;
     if (rayCallback.hasHit()) {
         _floorDistance = rayLength * rayCallback.m_closestHitFraction - _radius;
+        floorIsNear = _floorDistance < FLOOR_PROXIMITY_THRESHOLD;
     }
 
-    _hasSupport = checkForSupport(collisionWorld);
+    // checkForSupport() walks every contact manifold in the world, which only tells us more when there is no floor
+    // right under us, so we don't pay for it on every character every substep
+    _hasSupport = floorIsNear || checkForSupport(collisionWorld);
 }
 
 void CharacterController::playerStep(btCollisionWorld* dynaWorld, btScalar dt) {
@@ -107,6 +107,8 @@ protected:
 
     btScalar _floorDistance;
     bool _hasSupport;
+    btVector3 _lastProbePosition { 0.0f, 0.0f, 0.0f };
+    int _numProbesSkipped { 0 };
 
     btScalar _gravity;
 
@@ -0,0 +1,79 @@
+//
+//  ContactMap.cpp
+//  libraries/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ContactMap.h"
+
+#include <algorithm>
+
+// enough for a busy scene without growing during the first substeps that have contacts
+static const size_t MIN_BUCKETS = 1024;
+static const uint32_t EMPTY_BUCKET = 0xffffffff;
+
+ContactMap::ContactMap() {
+    _keys.reserve(MIN_BUCKETS / 2);
+    _contacts.reserve((int)(MIN_BUCKETS / 2));
+    _buckets.assign(MIN_BUCKETS, EMPTY_BUCKET);
+}
+
+size_t ContactMap::hash(const ContactKey& key) {
+    // the motion states' addresses are at least 8 aligned, so the low bits carry nothing until they are mixed
+    uint64_t a = (uint64_t)(uintptr_t)key._a;
+    uint64_t b = (uint64_t)(uintptr_t)key._b;
+    uint64_t mixed = (a ^ (b * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+    return (size_t)(mixed ^ (mixed >> 32));
+}
+
+ContactInfo& ContactMap::operator[](const ContactKey& key) {
+    size_t mask = _buckets.size() - 1;
+    size_t bucket = hash(key) & mask;
+    for (;;) {
+        uint32_t slot = _buckets[bucket];
+        if (slot == EMPTY_BUCKET) {
+            break;
+        }
+        if (_keys[slot] == key) {
+            return _contacts[slot];
+        }
+        bucket = (bucket + 1) & mask;
+    }
+
+    if ((_keys.size() + 1) * 2 > _buckets.size()) {
+        rehash(_buckets.size() * 2);
+        mask = _buckets.size() - 1;
+        bucket = hash(key) & mask;
+        while (_buckets[bucket] != EMPTY_BUCKET) {
+            bucket = (bucket + 1) & mask;
+        }
+    }
+
+    _buckets[bucket] = (uint32_t)_keys.size();
+    _keys.push_back(key);
+    _contacts.push_back(ContactInfo());
+    return _contacts[_contacts.size() - 1];
+}
+
+void ContactMap::clear() {
+    _keys.clear();
+    _contacts.resize(0);
+    std::fill(_buckets.begin(), _buckets.end(), EMPTY_BUCKET);
+}
+
+void ContactMap::rehash(size_t numBuckets) {
+    _buckets.assign(std::max(MIN_BUCKETS, numBuckets), EMPTY_BUCKET);
+
+    size_t mask = _buckets.size() - 1;
+    for (size_t slot = 0; slot < _keys.size(); slot++) {
+        size_t bucket = hash(_keys[slot]) & mask;
+        while (_buckets[bucket] != EMPTY_BUCKET) {
+            bucket = (bucket + 1) & mask;
+        }
+        _buckets[bucket] = (uint32_t)slot;
+    }
+}
@@ -0,0 +1,81 @@
+//
+//  ContactMap.h
+//  libraries/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ContactMap_h
+#define hifi_ContactMap_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include <LinearMath/btAlignedObjectArray.h>
+
+#include "ContactInfo.h"
+
+// simple class for keeping track of contacts
+class ContactKey {
+public:
+    ContactKey() = delete;
+    ContactKey(void* a, void* b) : _a(a), _b(b) {}
+    bool operator<(const ContactKey& other) const { return _a < other._a || (_a == other._a && _b < other._b); }
+    bool operator==(const ContactKey& other) const { return _a == other._a && _b == other._b; }
+    void* _a; // ObjectMotionState pointer
+    void* _b; // ObjectMotionState pointer
+};
+
+/// The contacts the engine is tracking, by the pair of motion states in them.
+/// Keys and contacts are kept in dense arrays and found through a flat open addressing table of indexes into them,
+/// so the update every substep doesn't allocate a node per new contact and the per-frame scan is a linear walk.
+/// Contacts that ended are taken out all at once by removeIf(), which compacts the arrays and rebuilds the table.
+class ContactMap {
+public:
+    ContactMap();
+
+    /// \return the contact for the key, a new default one if it wasn't there
+    ContactInfo& operator[](const ContactKey& key);
+
+    int size() const { return (int)_keys.size(); }
+    bool isEmpty() const { return _keys.empty(); }
+    void clear();
+
+    const ContactKey& getKey(int index) const { return _keys[index]; }
+    ContactInfo& getContact(int index) { return _contacts[index]; }
+
+    /// removes every contact the predicate is true for, which is given the key and the contact
+    template <typename Predicate>
+    void removeIf(Predicate predicate) {
+        int numKept = 0;
+        int numContacts = (int)_keys.size();
+        for (int i = 0; i < numContacts; ++i) {
+            if (!predicate(_keys[i], _contacts[i])) {
+                if (numKept != i) {
+                    _keys[numKept] = _keys[i];
+                    _contacts[numKept] = _contacts[i];
+                }
+                ++numKept;
+            }
+        }
+        if (numKept != numContacts) {
+            _keys.erase(_keys.begin() + numKept, _keys.end());
+            _contacts.resize(numKept);
+            rehash(_buckets.size());
+        }
+    }
+
+private:
+    static size_t hash(const ContactKey& key);
+    void rehash(size_t numBuckets);
+
+    std::vector<ContactKey> _keys;
+    btAlignedObjectArray<ContactInfo> _contacts; // btVector3 may need more alignment than std::allocator gives
+    std::vector<uint32_t> _buckets; // power of two sized and at most half full, indexes into the arrays or all ones
+};
+
+#endif // hifi_ContactMap_h
@@ -193,23 +193,24 @@ void EntityMotionState::setWorldTransform(const btTransform& worldTrans) {
 
     assert(entityTreeIsLocked());
     measureBodyAcceleration();
-    _entity->setPosition(bulletToGLM(worldTrans.getOrigin()) + ObjectMotionState::getWorldOffset());
-    _entity->setRotation(bulletToGLM(worldTrans.getRotation()));
+    bool success;
+    _entity->setPositionAndOrientation(bulletToGLM(worldTrans.getOrigin()) + ObjectMotionState::getWorldOffset(),
+                                       bulletToGLM(worldTrans.getRotation()), success);
     _entity->setVelocity(getBodyLinearVelocity());
     _entity->setAngularVelocity(getBodyAngularVelocity());
-    _entity->setLastSimulated(usecTimestampNow());
+    quint64 now = usecTimestampNow();
+    _entity->setLastSimulated(now);
 
     if (_entity->getSimulatorID().isNull()) {
         _loopsWithoutOwner++;
 
-        if (_loopsWithoutOwner > LOOPS_FOR_SIMULATION_ORPHAN && usecTimestampNow() > _nextOwnershipBid) {
+        if (_loopsWithoutOwner > LOOPS_FOR_SIMULATION_ORPHAN && now > _nextOwnershipBid) {
             //qDebug() << "Warning -- claiming something I saw moving." << getName();
             setOutgoingPriority(VOLUNTEER_SIMULATION_PRIORITY);
         }
     }
 
     #ifdef WANT_DEBUG
-        quint64 now = usecTimestampNow();
         qCDebug(physics) << "EntityMotionState::setWorldTransform()... changed entity:" << _entity->getEntityItemID();
         qCDebug(physics) << "       last edited:" << _entity->getLastEdited()
                          << formatUsecTime(now - _entity->getLastEdited()) << "ago";
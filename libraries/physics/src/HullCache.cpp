@@ -0,0 +1,105 @@
+//
+//  HullCache.cpp
+//  libraries/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HullCache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+#include "PhysicsLogging.h"
+
+// bump this when the reduction changes, so hulls reduced the old way are not used
+static const quint32 HULL_CACHE_VERSION = 1;
+
+// the memory cache is costed in points, a reduced hull has a few dozen
+static const int MAX_CACHED_HULL_POINTS = 64 * 1024;
+
+HullCache::HullCache() : _hulls(MAX_CACHED_HULL_POINTS) {
+}
+
+void HullCache::setCacheDirectory(const QString& path) {
+    QMutexLocker locker(&_mutex);
+    if (!path.isEmpty() && !QDir().mkpath(path)) {
+        qCWarning(physics) << "HullCache could not create" << path;
+        _directory.clear();
+        return;
+    }
+    _directory = path;
+}
+
+QByteArray HullCache::computeKey(const QVector<glm::vec3>& points) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(reinterpret_cast<const char*>(&HULL_CACHE_VERSION), sizeof(HULL_CACHE_VERSION));
+    hash.addData(reinterpret_cast<const char*>(points.constData()), points.size() * (int)sizeof(glm::vec3));
+    return hash.result();
+}
+
+QString HullCache::getPathForKey(const QByteArray& key) const {
+    return _directory + "/" + QString::fromLatin1(key.toHex()) + ".hull";
+}
+
+bool HullCache::find(const QByteArray& key, QVector<glm::vec3>& reducedPoints) {
+    QMutexLocker locker(&_mutex);
+    QVector<glm::vec3>* cached = _hulls.object(key);
+    if (cached) {
+        reducedPoints = *cached;
+        return true;
+    }
+    if (_directory.isEmpty()) {
+        return false;
+    }
+
+    QFile file(getPathForKey(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray data = file.readAll();
+
+    // the file is the number of points followed by their coordinates
+    quint32 numPoints = 0;
+    if (data.size() < (int)sizeof(numPoints)) {
+        return false;
+    }
+    memcpy(&numPoints, data.constData(), sizeof(numPoints));
+    if (numPoints == 0 || data.size() != (int)(sizeof(numPoints) + numPoints * sizeof(glm::vec3))) {
+        qCWarning(physics) << "HullCache ignoring damaged" << file.fileName();
+        return false;
+    }
+    reducedPoints.resize(numPoints);
+    memcpy(reducedPoints.data(), data.constData() + sizeof(numPoints), numPoints * sizeof(glm::vec3));
+
+    _hulls.insert(key, new QVector<glm::vec3>(reducedPoints), reducedPoints.size());
+    return true;
+}
+
+void HullCache::insert(const QByteArray& key, const QVector<glm::vec3>& reducedPoints) {
+    if (reducedPoints.isEmpty()) {
+        return;
+    }
+    QMutexLocker locker(&_mutex);
+    _hulls.insert(key, new QVector<glm::vec3>(reducedPoints), reducedPoints.size());
+    if (_directory.isEmpty()) {
+        return;
+    }
+
+    quint32 numPoints = (quint32)reducedPoints.size();
+    QByteArray data;
+    data.reserve((int)(sizeof(numPoints) + numPoints * sizeof(glm::vec3)));
+    data.append(reinterpret_cast<const char*>(&numPoints), sizeof(numPoints));
+    data.append(reinterpret_cast<const char*>(reducedPoints.constData()), (int)(numPoints * sizeof(glm::vec3)));
+
+    // written to a temporary and renamed, so a reader never sees half a hull
+    QSaveFile file(getPathForKey(key));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qCWarning(physics) << "HullCache could not write" << file.fileName();
+    }
+}
@@ -0,0 +1,45 @@
+//
+//  HullCache.h
+//  libraries/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HullCache_h
+#define hifi_HullCache_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+/// Keeps the reduced points of large convex hulls, keyed on a hash of the points they were reduced from.
+/// Recent hulls stay in memory and every hull is written to the cache directory, if one is set, so a model
+/// seen in an earlier session skips the reduction too.
+class HullCache {
+public:
+    HullCache();
+
+    void setCacheDirectory(const QString& path);
+
+    static QByteArray computeKey(const QVector<glm::vec3>& points);
+
+    /// \return true if reducedPoints were filled from the cache
+    bool find(const QByteArray& key, QVector<glm::vec3>& reducedPoints);
+    void insert(const QByteArray& key, const QVector<glm::vec3>& reducedPoints);
+
+private:
+    QString getPathForKey(const QByteArray& key) const;
+
+    QMutex _mutex;
+    QCache<QByteArray, QVector<glm::vec3>> _hulls;
+    QString _directory;
+};
+
+#endif // hifi_HullCache_h
@@ -11,6 +11,11 @@
 
 
 
+#include <glm/gtx/norm.hpp>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
 #include "PhysicsHelpers.h"
 #include "PhysicsLogging.h"
 #include "ShapeManager.h"
@@ -33,7 +38,7 @@ void PhysicalEntitySimulation::init(
     assert(physicsEngine);
     _physicsEngine = physicsEngine;
 
-    assert(packetSender);
+    // packetSender may be null when the simulation is authoritative and never sends edits
     _entityPacketSender = packetSender;
 }
 
@@ -60,6 +65,7 @@ void PhysicalEntitySimulation::removeEntityInternal(EntityItemPointer entity) {
     EntitySimulation::removeEntityInternal(entity);
     QMutexLocker lock(&_mutex);
     _entitiesToAddToPhysics.remove(entity);
+    _entitiesOutOfInterest.remove(entity);
 
     EntityMotionState* motionState = static_cast<EntityMotionState*>(entity->getPhysicsInfo());
     if (motionState) {
@@ -146,6 +152,7 @@ void PhysicalEntitySimulation::clearEntitiesInternal() {
     _entitiesToRemoveFromPhysics.clear();
     _entitiesToRelease.clear();
     _entitiesToAddToPhysics.clear();
+    _entitiesOutOfInterest.clear();
     _pendingChanges.clear();
     _outgoingChanges.clear();
 }
@@ -210,6 +217,13 @@ void PhysicalEntitySimulation::getObjectsToAddToPhysics(VectorOfMotionStates& re
             if (entity->isMoving()) {
                 _simpleKinematicEntities.insert(entity);
             }
+        } else if (isOutOfInterest(entity, _interestRadius)) {
+            // it waits outside until it comes near, moving without collisions if it moves
+            entityItr = _entitiesToAddToPhysics.erase(entityItr);
+            _entitiesOutOfInterest.insert(entity);
+            if (entity->isMoving()) {
+                _simpleKinematicEntities.insert(entity);
+            }
         } else if (entity->isReadyToComputeShape()) {
             ShapeInfo shapeInfo;
             entity->computeShapeInfo(shapeInfo);
@@ -247,6 +261,67 @@ void PhysicalEntitySimulation::getObjectsToChange(VectorOfMotionStates& result)
     _pendingChanges.clear();
 }
 
+bool PhysicalEntitySimulation::isOutOfInterest(const EntityItemPointer& entity, float radius) const {
+    if (_interestRadius <= 0.0f || entity->hasActions() || entity->getSimulatorID() == Physics::getSessionUUID()) {
+        // we never leave out what we simulate, or what actions hold on to
+        return false;
+    }
+    float reach = radius + entity->getRadius();
+    return glm::distance2(entity->getPosition(), _interestCenter) > reach * reach;
+}
+
+void PhysicalEntitySimulation::updateInterest(const glm::vec3& center) {
+    // entities don't travel far in a fraction of a second, so there is no need to look every frame
+    const quint64 INTEREST_UPDATE_PERIOD = USECS_PER_SECOND / 4;
+    // they go out a bit farther than they come back in, so those on the edge don't go in and out every update
+    const float INTEREST_HYSTERESIS = 1.2f;
+
+    QMutexLocker lock(&_mutex);
+    if (_interestRadius <= 0.0f && _entitiesOutOfInterest.isEmpty()) {
+        return;
+    }
+    quint64 now = usecTimestampNow();
+    if (now - _lastInterestUpdate < INTEREST_UPDATE_PERIOD) {
+        return;
+    }
+    _lastInterestUpdate = now;
+    _interestCenter = center;
+
+    SetOfEntities::iterator entityItr = _entitiesOutOfInterest.begin();
+    while (entityItr != _entitiesOutOfInterest.end()) {
+        EntityItemPointer entity = *entityItr;
+        if (entity->getPhysicsInfo()) {
+            // it was only just taken out and its motion state hasn't been deleted yet
+            ++entityItr;
+        } else if (entity->isDead() || !entity->shouldBePhysical() || !isOutOfInterest(entity, _interestRadius)) {
+            // back through the normal path, which sorts out the dead and the no longer physical
+            entityItr = _entitiesOutOfInterest.erase(entityItr);
+            _entitiesToAddToPhysics.insert(entity);
+            _simpleKinematicEntities.remove(entity);
+        } else {
+            ++entityItr;
+        }
+    }
+
+    if (_interestRadius <= 0.0f) {
+        return;
+    }
+    float outerRadius = INTEREST_HYSTERESIS * _interestRadius;
+    for (auto stateItr : _physicalObjects) {
+        EntityMotionState* motionState = static_cast<EntityMotionState*>(&(*stateItr));
+        EntityItemPointer entity = motionState->getEntity();
+        if (entity && !_entitiesToRemoveFromPhysics.contains(entity) && isOutOfInterest(entity, outerRadius)) {
+            _pendingChanges.remove(motionState);
+            _outgoingChanges.remove(motionState);
+            _entitiesToRemoveFromPhysics.insert(entity);
+            _entitiesOutOfInterest.insert(entity);
+            if (entity->isMoving()) {
+                _simpleKinematicEntities.insert(entity);
+            }
+        }
+    }
+}
+
 void PhysicalEntitySimulation::handleOutgoingChanges(const VectorOfMotionStates& motionStates, const QUuid& sessionID) {
     QMutexLocker lock(&_mutex);
     // walk the motionStates looking for those that correspond to entities
@@ -255,7 +330,10 @@ void PhysicalEntitySimulation::handleOutgoingChanges(const VectorOfMotionStates&
         if (state && state->getType() == MOTIONSTATE_TYPE_ENTITY) {
             EntityMotionState* entityState = static_cast<EntityMotionState*>(state);
             EntityItemPointer entity = entityState->getEntity();
-            assert(entity.get());
+            if (!entity) {
+                // the entity was deleted between the step and this harvest, its motion state goes on the next pull
+                continue;
+            }
             if (entityState->isCandidateForOwnership(sessionID)) {
                 _outgoingChanges.insert(entityState);
             }
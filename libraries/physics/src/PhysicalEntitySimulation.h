@@ -25,6 +25,9 @@
 
 typedef QSet<EntityMotionState*> SetOfEntityMotionStates;
 
+// physical entities farther than this from the center of interest are left out of the PhysicsEngine, 0 means none are
+const float DEFAULT_PHYSICS_INTEREST_RADIUS = 256.0f; // meters
+
 class PhysicalEntitySimulation :public EntitySimulation {
 public:
     PhysicalEntitySimulation();
@@ -54,6 +57,11 @@ public:
     void setObjectsToChange(const VectorOfMotionStates& objectsToChange);
     void getObjectsToChange(VectorOfMotionStates& result);
 
+    /// takes distant entities that someone else simulates out of physics and puts back the ones that came near
+    void updateInterest(const glm::vec3& center);
+    void setInterestRadius(float radius) { _interestRadius = radius; }
+    float getInterestRadius() const { return _interestRadius; }
+
     void handleOutgoingChanges(const VectorOfMotionStates& motionStates, const QUuid& sessionID);
     void handleCollisionEvents(const CollisionEvents& collisionEvents);
 
@@ -68,11 +76,18 @@ private:
     SetOfEntityMotionStates _outgoingChanges; // EntityMotionStates for which we need to send updates to entity-server
 
     SetOfMotionStates _physicalObjects; // MotionStates of entities in PhysicsEngine
+    SetOfEntities _entitiesOutOfInterest; // physical entities kept out of PhysicsEngine because they are far away
+
+    bool isOutOfInterest(const EntityItemPointer& entity, float radius) const;
 
     PhysicsEnginePointer _physicsEngine = nullptr;
     EntityEditPacketSender* _entityPacketSender = nullptr;
 
     uint32_t _lastStepSendPackets { 0 };
+
+    glm::vec3 _interestCenter;
+    float _interestRadius { 0.0f };
+    quint64 _lastInterestUpdate { 0 };
 };
 
 
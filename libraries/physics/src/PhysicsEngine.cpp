@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QtCore/QThread>
+
 #include <PhysicsCollisionGroups.h>
 
 #include "CharacterController.h"
@@ -43,6 +45,7 @@ void PhysicsEngine::init() {
         _broadphaseFilter = new btDbvtBroadphase();
         _constraintSolver = new btSequentialImpulseConstraintSolver;
         _dynamicsWorld = new ThreadSafeDynamicsWorld(_collisionDispatcher, _broadphaseFilter, _constraintSolver, _collisionConfig);
+        _dynamicsWorld->setNumSolverThreads(QThread::idealThreadCount());
 
         _ghostPairCallback = new btGhostPairCallback();
         _dynamicsWorld->getPairCache()->setInternalGhostPairCallback(_ghostPairCallback);
@@ -205,21 +208,15 @@ void PhysicsEngine::reinsertObject(ObjectMotionState* object) {
 }
 
 void PhysicsEngine::removeContacts(ObjectMotionState* motionState) {
-    // trigger events for new/existing/old contacts
-    ContactMap::iterator contactItr = _contactMap.begin();
-    while (contactItr != _contactMap.end()) {
-        if (contactItr->first._a == motionState || contactItr->first._b == motionState) {
-            ContactMap::iterator iterToDelete = contactItr;
-            ++contactItr;
-            _contactMap.erase(iterToDelete);
-        } else {
-            ++contactItr;
-        }
-    }
+    _contactMap.removeIf([motionState](const ContactKey& key, const ContactInfo& contact) {
+        return key._a == motionState || key._b == motionState;
+    });
 }
 
 void PhysicsEngine::stepSimulation() {
+#ifndef BT_NO_PROFILE
     CProfileManager::Reset();
+#endif
     BT_PROFILE("stepSimulation");
     // NOTE: the grand order of operations is:
     // (1) pull incoming changes
@@ -338,14 +335,13 @@ const CollisionEvents& PhysicsEngine::getCollisionEvents() {
     _collisionEvents.clear();
 
     // scan known contacts and trigger events
-    ContactMap::iterator contactItr = _contactMap.begin();
-
-    while (contactItr != _contactMap.end()) {
-        ContactInfo& contact = contactItr->second;
+    for (int i = 0; i < _contactMap.size(); ++i) {
+        const ContactKey& key = _contactMap.getKey(i);
+        ContactInfo& contact = _contactMap.getContact(i);
         ContactEventType type = contact.computeType(_numContactFrames);
         if(type != CONTACT_EVENT_TYPE_CONTINUE || _numSubsteps % CONTINUE_EVENT_FILTER_FREQUENCY == 0) {
-            ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(contactItr->first._a);
-            ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(contactItr->first._b);
+            ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(key._a);
+            ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(key._b);
             glm::vec3 velocityChange = (motionStateA ? motionStateA->getObjectLinearVelocityChange() : glm::vec3(0.0f)) +
                 (motionStateB ? motionStateB->getObjectLinearVelocityChange() : glm::vec3(0.0f));
 
@@ -367,15 +363,13 @@ const CollisionEvents& PhysicsEngine::getCollisionEvents() {
                 _collisionEvents.push_back(Collision(type, idB, QUuid(), position, penetration, velocityChange));
             }
         }
-
-        if (type == CONTACT_EVENT_TYPE_END) {
-            ContactMap::iterator iterToDelete = contactItr;
-            ++contactItr;
-            _contactMap.erase(iterToDelete);
-        } else {
-            ++contactItr;
-        }
     }
+
+    // contacts that weren't touched in the last substep have had their END event, take them all out in one pass
+    uint32_t thisStep = _numContactFrames;
+    _contactMap.removeIf([thisStep](const ContactKey& key, ContactInfo& contact) {
+        return contact.computeType(thisStep) == CONTACT_EVENT_TYPE_END;
+    });
     return _collisionEvents;
 }
 
@@ -389,7 +383,11 @@ const VectorOfMotionStates& PhysicsEngine::getOutgoingChanges() {
 void PhysicsEngine::dumpStatsIfNecessary() {
     if (_dumpNextStats) {
         _dumpNextStats = false;
+#ifndef BT_NO_PROFILE
         CProfileManager::dumpAll();
+#else
+        qCDebug(physics) << "Bullet was built without its profiler, which lets islands be solved on several threads";
+#endif
     }
 }
 
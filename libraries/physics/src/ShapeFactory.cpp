@@ -11,16 +11,71 @@
 
 #include <glm/gtx/norm.hpp>
 
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
+
 #include <SharedUtil.h> // for MILLIMETERS_PER_METER
 
 #include "ShapeFactory.h"
 #include "BulletUtil.h"
+#include "HullCache.h"
+
+// hulls with more points than this are reduced to the few dozen that btShapeHull finds matter to their shape
+static const int MAX_UNREDUCED_HULL_POINTS = 64;
+
+static HullCache* _hullCache = nullptr;
+
+void ShapeFactory::setHullCache(HullCache* cache) {
+    _hullCache = cache;
+}
 
+QVector<glm::vec3> ShapeFactory::reduceHullPoints(const QVector<glm::vec3>& points) {
+    btConvexHullShape fullHull;
+    // btShapeHull samples supporting vertices, which should be on the points and not out on the margin
+    fullHull.setMargin(0.0f);
+    for (int i = 0; i < points.size(); ++i) {
+        fullHull.addPoint(glmToBullet(points[i]), false);
+    }
+    fullHull.recalcLocalAabb();
 
+    QVector<glm::vec3> reducedPoints;
+    btShapeHull shapeHull(&fullHull);
+    if (shapeHull.buildHull(0.0f)) {
+        const btVector3* vertices = shapeHull.getVertexPointer();
+        int numVertices = shapeHull.numVertices();
+        reducedPoints.reserve(numVertices);
+        for (int i = 0; i < numVertices; ++i) {
+            reducedPoints.push_back(bulletToGLM(vertices[i]));
+        }
+    }
+    return reducedPoints;
+}
 
 btConvexHullShape* ShapeFactory::createConvexHull(const QVector<glm::vec3>& points) {
     assert(points.size() > 0);
 
+    if (points.size() > MAX_UNREDUCED_HULL_POINTS) {
+        QByteArray key;
+        QVector<glm::vec3> reducedPoints;
+        if (_hullCache) {
+            key = HullCache::computeKey(points);
+            if (_hullCache->find(key, reducedPoints)) {
+                return createHullFromPoints(reducedPoints);
+            }
+        }
+        reducedPoints = reduceHullPoints(points);
+        if (!reducedPoints.isEmpty()) {
+            if (_hullCache) {
+                _hullCache->insert(key, reducedPoints);
+            }
+            return createHullFromPoints(reducedPoints);
+        }
+    }
+    return createHullFromPoints(points);
+}
+
+btConvexHullShape* ShapeFactory::createHullFromPoints(const QVector<glm::vec3>& points) {
+    assert(points.size() > 0);
+
     btConvexHullShape* hull = new btConvexHullShape();
     glm::vec3 center = points[0];
     glm::vec3 maxCorner = center;
@@ -17,11 +17,18 @@
 
 #include <ShapeInfo.h>
 
+class HullCache;
+
 // translates between ShapeInfo and btShape
 
 namespace ShapeFactory {
     btConvexHullShape* createConvexHull(const QVector<glm::vec3>& points);
     btCollisionShape* createShapeFromInfo(const ShapeInfo& info);
+
+    // large hulls are reduced before they are built, the cache keeps the reductions between sessions
+    void setHullCache(HullCache* cache);
+    QVector<glm::vec3> reduceHullPoints(const QVector<glm::vec3>& points);
+    btConvexHullShape* createHullFromPoints(const QVector<glm::vec3>& points);
 };
 
 #endif // hifi_ShapeFactory_h
@@ -15,10 +15,25 @@
  * Copied and modified from btDiscreteDynamicsWorld.cpp by AndrewMeadows on 2014.11.12.
  * */
 
+#include <algorithm>
+#include <atomic>
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <BulletCollision/CollisionDispatch/btSimulationIslandManager.h>
 #include <LinearMath/btQuickprof.h>
 
 #include "ThreadSafeDynamicsWorld.h"
 
+// below this much work in independent islands, handing them to other threads costs more than solving them here
+static const int MIN_PARALLEL_SOLVER_COST = 64;
+
+static int getConstraintIslandId(const btTypedConstraint* constraint) {
+    const btCollisionObject& bodyA = constraint->getRigidBodyA();
+    const btCollisionObject& bodyB = constraint->getRigidBodyB();
+    return bodyA.getIslandTag() >= 0 ? bodyA.getIslandTag() : bodyB.getIslandTag();
+}
+
 ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btDispatcher* dispatcher,
         btBroadphaseInterface* pairCache,
@@ -87,46 +102,22 @@ int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep
     return subSteps;
 }
 
-// call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
-void ThreadSafeDynamicsWorld::synchronizeMotionState(btRigidBody* body) {
-    btAssert(body);
-    if (body->getMotionState() && !body->isStaticObject()) {
-        //we need to call the update at least once, even for sleeping objects
-        //otherwise the 'graphics' transform never updates properly
-        ///@todo: add 'dirty' flag
-        //if (body->getActivationState() != ISLAND_SLEEPING)
-        {
-            if (body->isKinematicObject()) {
-                ObjectMotionState* objectMotionState = static_cast<ObjectMotionState*>(body->getMotionState());
-                if (objectMotionState->hasInternalKinematicChanges()) {
-                    objectMotionState->clearInternalKinematicChanges();
-                    body->getMotionState()->setWorldTransform(body->getWorldTransform());
-                }
-                return;
-            }
-            btTransform interpolatedTransform;
-            btTransformUtil::integrateTransform(body->getInterpolationWorldTransform(),
-                body->getInterpolationLinearVelocity(),body->getInterpolationAngularVelocity(),
-                (m_latencyMotionStateInterpolation && m_fixedTimeStep) ? m_localTime - m_fixedTimeStep : m_localTime*body->getHitFraction(),
-                interpolatedTransform);
-            body->getMotionState()->setWorldTransform(interpolatedTransform);
-        }
+void ThreadSafeDynamicsWorld::collectBodyToSync(btRigidBody* body) {
+    if (body->getMotionState()) {
+        _bodiesToSync.push_back(body);
     }
 }
 
 void ThreadSafeDynamicsWorld::synchronizeMotionStates() {
-    _changedMotionStates.clear();
     BT_PROFILE("synchronizeMotionStates");
+    _changedMotionStates.clear();
+    _bodiesToSync.resize(0);
     if (m_synchronizeAllMotionStates) {
         //iterate  over all collision objects
         for (int i=0;i<m_collisionObjects.size();i++) {
-            btCollisionObject* colObj = m_collisionObjects[i];
-            btRigidBody* body = btRigidBody::upcast(colObj);
+            btRigidBody* body = btRigidBody::upcast(m_collisionObjects[i]);
             if (body) {
-                if (body->getMotionState()) {
-                    synchronizeMotionState(body);
-                    _changedMotionStates.push_back(static_cast<ObjectMotionState*>(body->getMotionState()));
-                }
+                collectBodyToSync(body);
             }
         }
     } else  {
@@ -134,12 +125,194 @@ void ThreadSafeDynamicsWorld::synchronizeMotionStates() {
         for (int i=0;i<m_nonStaticRigidBodies.size();i++) {
             btRigidBody* body = m_nonStaticRigidBodies[i];
             if (body->isActive()) {
-                if (body->getMotionState()) {
-                    synchronizeMotionState(body);
-                    _changedMotionStates.push_back(static_cast<ObjectMotionState*>(body->getMotionState()));
+                collectBodyToSync(body);
+            }
+        }
+    }
+
+    // Integrate the transforms of all the dynamic bodies in one tight pass over contiguous memory before calling
+    // any motion state, rather than interleaving the math with the entity updates body by body.
+    int numBodies = _bodiesToSync.size();
+    _syncTransforms.resize(numBodies);
+    bool useLatency = m_latencyMotionStateInterpolation && m_fixedTimeStep;
+    for (int i = 0; i < numBodies; i++) {
+        btRigidBody* body = _bodiesToSync[i];
+        if (!body->isStaticOrKinematicObject()) {
+            btTransformUtil::integrateTransform(body->getInterpolationWorldTransform(),
+                body->getInterpolationLinearVelocity(), body->getInterpolationAngularVelocity(),
+                useLatency ? m_localTime - m_fixedTimeStep : m_localTime * body->getHitFraction(),
+                _syncTransforms[i]);
+        }
+    }
+
+    //we need to call the update at least once, even for sleeping objects
+    //otherwise the 'graphics' transform never updates properly
+    for (int i = 0; i < numBodies; i++) {
+        btRigidBody* body = _bodiesToSync[i];
+        ObjectMotionState* objectMotionState = static_cast<ObjectMotionState*>(body->getMotionState());
+        if (body->isKinematicObject()) {
+            if (objectMotionState->hasInternalKinematicChanges()) {
+                objectMotionState->clearInternalKinematicChanges();
+                objectMotionState->setWorldTransform(body->getWorldTransform());
+            }
+        } else if (!body->isStaticObject()) {
+            objectMotionState->setWorldTransform(_syncTransforms[i]);
+        }
+        _changedMotionStates.push_back(objectMotionState);
+    }
+}
+
+
+void ThreadSafeDynamicsWorld::setNumSolverThreads(int numThreads) {
+#ifndef BT_NO_PROFILE
+    // Bullet's profiler keeps one global tree of samples, which solvers on several threads would corrupt
+    numThreads = 1;
+#endif
+    _numSolverThreads = std::max(numThreads, 1);
+
+    // the calling thread uses the world's own solver, each helper thread gets one of these
+    _islandSolvers.resize(_numSolverThreads - 1);
+    for (auto& solver : _islandSolvers) {
+        if (!solver) {
+            solver.reset(new btSequentialImpulseConstraintSolver());
+        }
+    }
+}
+
+void ThreadSafeDynamicsWorld::collectIslands() {
+    class IslandCollector : public btSimulationIslandManager::IslandCallback {
+    public:
+        IslandCollector(ThreadSafeDynamicsWorld& world) : _world(world) { }
+
+        virtual void processIsland(btCollisionObject** bodies, int numBodies,
+                                   btPersistentManifold** manifolds, int numManifolds, int islandId) override {
+            if ((int)_world._islands.size() <= _world._numIslands) {
+                _world._islands.emplace_back();
+            }
+            // the arrays are reused from step to step, resize(0) keeps their storage
+            SolverIsland& island = _world._islands[_world._numIslands++];
+            island.islandId = islandId;
+            island.touchesKinematic = false;
+            island.bodies.resize(0);
+            island.manifolds.resize(0);
+            island.constraints.resize(0);
+
+            // the island manager reuses its body array for the next island, so copy it out
+            for (int i = 0; i < numBodies; i++) {
+                island.bodies.push_back(bodies[i]);
+            }
+            for (int i = 0; i < numManifolds; i++) {
+                btPersistentManifold* manifold = manifolds[i];
+                island.manifolds.push_back(manifold);
+                if (manifold->getBody0()->isKinematicObject() || manifold->getBody1()->isKinematicObject()) {
+                    island.touchesKinematic = true;
                 }
             }
         }
+
+    private:
+        ThreadSafeDynamicsWorld& _world;
+    };
+
+    _numIslands = 0;
+    IslandCollector collector(*this);
+    m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(), getCollisionWorld(), &collector);
+
+    // islands arrive in order of their id, which is how constraints find theirs
+    auto islandsBegin = _islands.begin();
+    auto islandsEnd = _islands.begin() + _numIslands;
+    for (int i = 0; i < m_constraints.size(); i++) {
+        btTypedConstraint* constraint = m_constraints[i];
+        int islandId = getConstraintIslandId(constraint);
+        if (islandId < 0) {
+            continue;
+        }
+        auto islandItr = std::lower_bound(islandsBegin, islandsEnd, islandId, [](const SolverIsland& island, int id) {
+            return island.islandId < id;
+        });
+        if (islandItr != islandsEnd && islandItr->islandId == islandId) {
+            islandItr->constraints.push_back(constraint);
+            if (constraint->getRigidBodyA().isKinematicObject() || constraint->getRigidBodyB().isKinematicObject()) {
+                islandItr->touchesKinematic = true;
+            }
+        }
+    }
+}
+
+void ThreadSafeDynamicsWorld::solveIsland(btConstraintSolver* solver, SolverIsland& island,
+                                          const btContactSolverInfo& solverInfo, btIDebugDraw* debugDrawer) {
+    if (island.manifolds.size() + island.constraints.size() == 0) {
+        return;
     }
+    solver->solveGroup(island.bodies.size() ? &island.bodies[0] : nullptr, island.bodies.size(),
+                       island.manifolds.size() ? &island.manifolds[0] : nullptr, island.manifolds.size(),
+                       island.constraints.size() ? &island.constraints[0] : nullptr, island.constraints.size(),
+                       solverInfo, debugDrawer, getCollisionWorld()->getDispatcher());
 }
 
+void ThreadSafeDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo) {
+    if (_numSolverThreads <= 1 || !m_islandManager->getSplitIslands()) {
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+        return;
+    }
+    BT_PROFILE("solveConstraints");
+
+    m_constraintSolver->prepareSolve(getCollisionWorld()->getNumCollisionObjects(),
+                                     getCollisionWorld()->getDispatcher()->getNumManifolds());
+    collectIslands();
+
+    // An island that touches a kinematic object shares that object's solver body with every other island
+    // that touches it, so those are solved in sequence on this thread. The islands made only of dynamic
+    // bodies write nothing outside themselves and can go to any thread.
+    _sequentialIslands.clear();
+    _independentIslands.clear();
+    int independentCost = 0;
+    for (int i = 0; i < _numIslands; i++) {
+        SolverIsland& island = _islands[i];
+        if (island.touchesKinematic) {
+            _sequentialIslands.push_back(&island);
+        } else {
+            _independentIslands.push_back(&island);
+            independentCost += island.cost();
+        }
+    }
+    if (independentCost < MIN_PARALLEL_SOLVER_COST || _independentIslands.size() < 2) {
+        _sequentialIslands.insert(_sequentialIslands.end(), _independentIslands.begin(), _independentIslands.end());
+        _independentIslands.clear();
+    }
+
+    // biggest first, so the last islands taken are the small ones that even out the threads
+    std::sort(_independentIslands.begin(), _independentIslands.end(), [](const SolverIsland* a, const SolverIsland* b) {
+        return a->cost() > b->cost();
+    });
+
+    std::atomic<int> nextIsland { 0 };
+    int numIndependentIslands = (int)_independentIslands.size();
+    auto solveIndependentIslands = [&](btConstraintSolver* solver) {
+        int i;
+        while ((i = nextIsland++) < numIndependentIslands) {
+            solveIsland(solver, *_independentIslands[i], solverInfo, nullptr);
+        }
+    };
+
+    int numHelpers = std::min((int)_islandSolvers.size(), numIndependentIslands - 1);
+    std::vector<QFuture<void>> helpers;
+    for (int i = 0; i < numHelpers; i++) {
+        btConstraintSolver* solver = _islandSolvers[i].get();
+        helpers.push_back(QtConcurrent::run([&solveIndependentIslands, solver] {
+            solveIndependentIslands(solver);
+        }));
+    }
+
+    for (auto island : _sequentialIslands) {
+        solveIsland(m_constraintSolver, *island, solverInfo, getDebugDrawer());
+    }
+    solveIndependentIslands(m_constraintSolver);
+
+    // a helper the pool hasn't started yet is run right here, and finds nothing left to do
+    for (auto& helper : helpers) {
+        helper.waitForFinished();
+    }
+
+    m_constraintSolver->allSolved(solverInfo, m_debugDrawer);
+}
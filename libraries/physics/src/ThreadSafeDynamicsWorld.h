@@ -20,10 +20,13 @@
 
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 
 #include "ObjectMotionState.h"
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 using SubStepCallback = std::function<void()>;
 
@@ -49,11 +52,40 @@ public:
 
     VectorOfMotionStates& getChangedMotionStates() { return _changedMotionStates; }
 
+    // independent simulation islands are solved on up to this many threads of the global thread pool
+    void setNumSolverThreads(int numThreads);
+    int getNumSolverThreads() const { return _numSolverThreads; }
+
+protected:
+    virtual void solveConstraints(btContactSolverInfo& solverInfo) override;
+
 private:
-    // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
-    void synchronizeMotionState(btRigidBody* body);
+    void collectBodyToSync(btRigidBody* body);
+
+    struct SolverIsland {
+        btAlignedObjectArray<btCollisionObject*> bodies;
+        btAlignedObjectArray<btPersistentManifold*> manifolds;
+        btAlignedObjectArray<btTypedConstraint*> constraints;
+        int islandId;
+        bool touchesKinematic;
+        int cost() const { return bodies.size() + manifolds.size() + constraints.size(); }
+    };
+    using SolverIslands = std::vector<SolverIsland>;
+
+    void collectIslands();
+    void solveIsland(btConstraintSolver* solver, SolverIsland& island,
+                     const btContactSolverInfo& solverInfo, btIDebugDraw* debugDrawer);
 
     VectorOfMotionStates _changedMotionStates;
+    btAlignedObjectArray<btRigidBody*> _bodiesToSync;
+    btAlignedObjectArray<btTransform> _syncTransforms;
+
+    int _numSolverThreads { 1 };
+    std::vector<std::unique_ptr<btSequentialImpulseConstraintSolver>> _islandSolvers;
+    SolverIslands _islands;
+    int _numIslands { 0 };
+    std::vector<SolverIsland*> _sequentialIslands;
+    std::vector<SolverIsland*> _independentIslands;
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
@@ -12,10 +12,14 @@
 
 #include "impl/FileClip.h"
 #include "impl/BufferClip.h"
+#include "impl/FrameCoder.h"
+
+#include <algorithm>
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QBuffer>
+#include <QtCore/QFileInfo>
 #include <QtCore/QDebug>
 
 using namespace recording;
@@ -29,10 +33,27 @@ Clip::Pointer Clip::fromFile(const QString& filePath) {
 }
 
 void Clip::toFile(const QString& filePath, const Clip::ConstPointer& clip) {
+    // A clip already in a file, as recordings are, is copied as it is
+    if (auto fileClip = std::dynamic_pointer_cast<const FileClip>(clip)) {
+        QString fileName = fileClip->getName();
+        if (QFileInfo(fileName) == QFileInfo(filePath)) {
+            return;
+        }
+        QFile::remove(filePath);
+        if (QFile::copy(fileName, filePath)) {
+            return;
+        }
+    }
     FileClip::write(filePath, clip->duplicate());
 }
 
 QByteArray Clip::toBuffer(const Clip::ConstPointer& clip) {
+    if (auto fileClip = std::dynamic_pointer_cast<const FileClip>(clip)) {
+        QFile file(fileClip->getName());
+        if (file.open(QFile::ReadOnly)) {
+            return file.readAll();
+        }
+    }
     QBuffer buffer;
     if (buffer.open(QFile::Truncate | QFile::WriteOnly)) {
         clip->duplicate()->write(buffer);
@@ -54,7 +75,8 @@ float Clip::position() const {
 }
 
 // FIXME move to frame?
-bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
+bool Clip::writeFrame(QIODevice& output, const Frame& frame, bool compressed, ClipIndexEntry* entry, qint64 clipStart,
+                      FrameCoder* coder) {
     if (frame.type == Frame::TYPE_INVALID) {
         qWarning() << "Attempting to write invalid frame";
         return true;
@@ -70,7 +92,9 @@ bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
         return false;
     }
     QByteArray frameData = frame.data;
-    if (compressed) {
+    if (coder) {
+        frameData = coder->encode(frame);
+    } else if (compressed) {
         frameData = qCompress(frameData);
     }
 
@@ -80,6 +104,10 @@ bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
         return false;
     }
 
+    if (entry) {
+        *entry = { frame.timeOffset, frame.type, dataSize, (quint64)(output.pos() - clipStart) };
+    }
+
     if (dataSize != 0) {
         written = output.write(frameData);
         if (written != dataSize) {
@@ -91,8 +119,9 @@ bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
 
 const QString Clip::FRAME_TYPE_MAP = QStringLiteral("frameTypes");
 const QString Clip::FRAME_COMREPSSION_FLAG = QStringLiteral("compressed");
+const QString Clip::FORMAT_VERSION = QStringLiteral("version");
 
-bool Clip::write(QIODevice& output) {
+bool Clip::writeHeader(QIODevice& output) {
     auto frameTypes = Frame::getFrameTypes();
     QJsonObject frameTypeObj;
     for (const auto& frameTypeName : frameTypes.keys()) {
@@ -103,18 +132,45 @@ bool Clip::write(QIODevice& output) {
     rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
     // Always mark new files as compressed
     rootObject.insert(FRAME_COMREPSSION_FLAG, true);
+    rootObject.insert(FORMAT_VERSION, CURRENT_FORMAT_VERSION);
     QByteArray headerFrameData = QJsonDocument(rootObject).toBinaryData();
     // Never compress the header frame
-    if (!writeFrame(output, Frame({ Frame::TYPE_HEADER, 0, headerFrameData }), false)) {
+    return writeFrame(output, Frame({ Frame::TYPE_HEADER, 0, headerFrameData }), false);
+}
+
+bool Clip::writeIndex(QIODevice& output, const std::vector<ClipIndexEntry>& index, qint64 clipStart) {
+    // The index goes after the frames, so older builds play the file as before, dropping the frames of unknown types
+    ClipIndexFooter footer { (quint64)(output.pos() - clipStart), (quint64)index.size() };
+    for (size_t i = 0; i < index.size(); i += INDEX_ENTRIES_PER_FRAME) {
+        size_t count = std::min(INDEX_ENTRIES_PER_FRAME, index.size() - i);
+        QByteArray indexFrameData((const char*)&index[i], (int)(count * sizeof(ClipIndexEntry)));
+        if (!writeFrame(output, Frame({ Frame::TYPE_INDEX, 0, indexFrameData }), false)) {
+            return false;
+        }
+    }
+    QByteArray footerFrameData((const char*)&footer, sizeof(ClipIndexFooter));
+    return writeFrame(output, Frame({ Frame::TYPE_INDEX_FOOTER, 0, footerFrameData }), false);
+}
+
+bool Clip::write(QIODevice& output) {
+    qint64 clipStart = output.pos();
+    if (!writeHeader(output)) {
         return false;
     }
 
     seek(0);
 
+    FrameCoder coder;
+    std::vector<ClipIndexEntry> index;
+    index.reserve(frameCount());
     for (auto frame = nextFrame(); frame; frame = nextFrame()) {
-        if (!writeFrame(output, *frame)) {
+        ClipIndexEntry entry;
+        if (!writeFrame(output, *frame, true, &entry, clipStart, &coder)) {
             return false;
         }
+        if (frame->type != Frame::TYPE_INVALID) {
+            index.push_back(entry);
+        }
     }
-    return true;
+    return writeIndex(output, index, clipStart);
 }
@@ -13,6 +13,7 @@
 #include "Forward.h"
 
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QObject>
 
@@ -22,6 +23,9 @@ class QIODevice;
 
 namespace recording {
 
+struct ClipIndexEntry;
+class FrameCoder;
+
 class Clip {
 public:
     using Pointer = std::shared_ptr<Clip>;
@@ -49,6 +53,14 @@ public:
 
     bool write(QIODevice& output);
 
+    // The parts of a clip file, for the writers of clips: the header, each frame (its index entry given the place
+    // of its data relative to the start of the clip, its data coded by the coder of the clip in place of being just
+    // compressed) and the index once all the frames are written
+    static bool writeHeader(QIODevice& output);
+    static bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true,
+                           ClipIndexEntry* entry = nullptr, qint64 clipStart = 0, FrameCoder* coder = nullptr);
+    static bool writeIndex(QIODevice& output, const std::vector<ClipIndexEntry>& index, qint64 clipStart = 0);
+
     static Pointer fromFile(const QString& filePath);
     static void toFile(const QString& filePath, const ConstPointer& clip);
     static QByteArray toBuffer(const ConstPointer& clip);
@@ -56,6 +68,11 @@ public:
     
     static const QString FRAME_TYPE_MAP;
     static const QString FRAME_COMREPSSION_FLAG;
+    static const QString FORMAT_VERSION;
+
+    // the version of the files written, from 2 on they end with an index of their frames, and from 3 on their frames
+    // are coded by a FrameCoder
+    static const int CURRENT_FORMAT_VERSION = 3;
 
 protected:
     friend class WrapperClip;
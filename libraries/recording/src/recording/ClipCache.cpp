@@ -6,23 +6,80 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 #include "ClipCache.h"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QStandardPaths>
+
+#include <AssetUtils.h>
+#include <ResourceManager.h>
+
 #include "impl/PointerClip.h"
+#include "Logging.h"
 
 using namespace recording;
 NetworkClipLoader::NetworkClipLoader(const QUrl& url, bool delayLoad)
     : Resource(url, delayLoad), _clip(std::make_shared<NetworkClip>(url))
 {
-    
+    // An asset is named by the hash of its contents, so one already cached needs no download
+    if (url.scheme() == URL_SCHEME_ATP) {
+        auto parts = url.path().split(".", QString::SkipEmptyParts);
+        QString path = ClipCache::instance().getFileCache().findFile(parts.length() > 0 ? parts[0] : "");
+        if (!path.isEmpty() && _clip->initFromFile(path)) {
+            _startedLoading = _loaded = true;
+        }
+    }
 }
 
+NetworkClip::~NetworkClip() {
+    Locker lock(_mutex);
+    if (_file.isOpen()) {
+        _file.unmap(_data);
+        _file.close();
+    }
+    reset();
+}
 
 void NetworkClip::init(const QByteArray& clipData) {
+    auto& fileCache = ClipCache::instance().getFileCache();
+    QString hash = hashData(clipData).toHex();
+    QString path = fileCache.findFile(hash);
+    if (path.isEmpty() || QFileInfo(path).size() != clipData.size()) {
+        fileCache.insert(hash, clipData);
+        path = fileCache.findFile(hash);
+    }
+    if (!path.isEmpty() && initFromFile(path)) {
+        return;
+    }
+
     _clipData = clipData;
     PointerClip::init((uchar*)_clipData.data(), _clipData.size());
 }
 
+bool NetworkClip::initFromFile(const QString& path) {
+    Locker lock(_mutex);
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    auto size = _file.size();
+    auto mappedFile = _file.map(0, size, QFile::MapPrivateOption);
+    if (mappedFile) {
+        PointerClip::init(mappedFile, size);
+        if (frameCount() > 0) {
+            return true;
+        }
+        qCWarning(recordingLog) << "Invalid clip in the cache at " << path;
+        reset();
+        _file.unmap(mappedFile);
+    }
+    _file.close();
+    return false;
+}
+
 void NetworkClipLoader::downloadFinished(const QByteArray& data) {
     _clip->init(data);
+    // the clip is mapped from the cache, or keeps its own copy
+    _data = QByteArray();
 }
 
 ClipCache& ClipCache::instance() {
@@ -30,6 +87,11 @@ ClipCache& ClipCache::instance() {
     return _instance;
 }
 
+ClipCache::ClipCache() {
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+    _fileCache.setCacheDirectory((!cachePath.isEmpty() ? cachePath : "interfaceCache") + "/clips");
+}
+
 NetworkClipLoaderPointer ClipCache::getClipLoader(const QUrl& url) {
     return ResourceCache::getResource(url, QUrl(), false, nullptr).staticCast<NetworkClipLoader>();
 }
@@ -37,4 +99,3 @@ NetworkClipLoaderPointer ClipCache::getClipLoader(const QUrl& url) {
 QSharedPointer<Resource> ClipCache::createResource(const QUrl& url, const QSharedPointer<Resource>& fallback, bool delayLoad, const void* extra) {
     return QSharedPointer<Resource>(new NetworkClipLoader(url, delayLoad), &Resource::allReferencesCleared);
 }
-
@@ -9,6 +9,9 @@
 #ifndef hifi_Recording_ClipCache_h
 #define hifi_Recording_ClipCache_h
 
+#include <QtCore/QFile>
+
+#include <AssetCache.h>
 #include <ResourceCache.h>
 
 #include "Forward.h"
@@ -21,11 +24,16 @@ public:
     using Pointer = std::shared_ptr<NetworkClip>;
 
     NetworkClip(const QUrl& url) : _url(url) {}
+    virtual ~NetworkClip();
     virtual void init(const QByteArray& clipData);
     virtual QString getName() const override { return _url.toString(); }
 
+    // maps the clip from a file of the cache in place of keeping its data
+    bool initFromFile(const QString& path);
+
 private:
     QByteArray _clipData;
+    QFile _file;
     QUrl _url;
 };
 
@@ -42,14 +50,24 @@ private:
 
 using NetworkClipLoaderPointer = QSharedPointer<NetworkClipLoader>;
 
+// The clips are kept on disk by the hash of their contents, in a directory shared by the processes of the host, and are
+// mapped from there: the agents of a host playing the same clip share its pages, and a clip from the asset server that
+// is there already isn't downloaded again.
 class ClipCache : public ResourceCache {
 public:
     static ClipCache& instance();
 
     NetworkClipLoaderPointer getClipLoader(const QUrl& url);
 
+    AssetCache& getFileCache() { return _fileCache; }
+
 protected:
+    ClipCache();
+
+
     virtual QSharedPointer<Resource> createResource(const QUrl& url, const QSharedPointer<Resource>& fallback, bool delayLoad, const void* extra) override;
+
+    AssetCache _fileCache;
 };
 
 }
@@ -8,6 +8,8 @@
 
 #include "Deck.h"
  
+#include <algorithm>
+
 #include <QtCore/QThread>
 
 #include <NumericalConstants.h>
@@ -21,7 +23,29 @@
 using namespace recording;
 
 Deck::Deck(QObject* parent) 
-    : QObject(parent) {}
+    : QObject(parent) {
+    _timer.setSingleShot(true);
+    connect(&_timer, &QTimer::timeout, this, &Deck::processFrames);
+}
+
+static bool isLater(const std::pair<Frame::Time, ClipPointer>& a, const std::pair<Frame::Time, ClipPointer>& b) {
+    return a.first > b.first;
+}
+
+void Deck::scheduleClip(const ClipPointer& clip) {
+    auto nextFramePosition = clip->positionFrameTime();
+    if (nextFramePosition != Frame::INVALID_TIME) {
+        _schedule.emplace_back(nextFramePosition, clip);
+        std::push_heap(_schedule.begin(), _schedule.end(), isLater);
+    }
+}
+
+void Deck::scheduleClips() {
+    _schedule.clear();
+    for (const auto& clip : _clips) {
+        scheduleClip(clip);
+    }
+}
 
 void Deck::queueClip(ClipPointer clip, float timeOffset) {
     Locker lock(_mutex);
@@ -33,6 +57,7 @@ void Deck::queueClip(ClipPointer clip, float timeOffset) {
 
     // FIXME disabling multiple clips for now
     _clips.clear();
+    _schedule.clear();
 
     // if the time offset is not zero, wrap in an OffsetClip
     if (timeOffset != 0.0f) {
@@ -40,6 +65,7 @@ void Deck::queueClip(ClipPointer clip, float timeOffset) {
     }
 
     _clips.push_back(clip);
+    scheduleClips();
 
     _length = std::max(_length, clip->duration());
 }
@@ -62,19 +88,6 @@ void Deck::pause() {
     }
 }
 
-Clip::Pointer Deck::getNextClip() {
-    Clip::Pointer result;
-    auto soonestFramePosition = Frame::INVALID_TIME;
-    for (const auto& clip : _clips) {
-        auto nextFramePosition = clip->positionFrameTime();
-        if (nextFramePosition < soonestFramePosition) {
-            result = clip;
-            soonestFramePosition = nextFramePosition;
-        }
-    }
-    return result;
-}
-
 void Deck::seek(float position) {
     Locker lock(_mutex);
     _position = Frame::secondsToFrameTime(position);
@@ -86,9 +99,9 @@ void Deck::seek(float position) {
     for (auto& clip : _clips) {
         clip->seekFrameTime(_position);
     }
+    scheduleClips();
 
     if (!_pause) {
-        // FIXME what if the timer is already running?
         processFrames();
     }
 }
@@ -117,12 +130,12 @@ void Deck::processFrames() {
 
     auto startingPosition = Frame::frameTimeFromEpoch(_startEpoch);
     auto triggerPosition = startingPosition + MIN_FRAME_WAIT_INTERVAL;
-    Clip::Pointer nextClip;
     // FIXME add code to start dropping frames if we fall behind.
     // Alternatively, add code to cache frames here and then process only the last frame of a given type
     // ... the latter will work for Avatar, but not well for audio I suspect.
     bool overLimit = false;
-    for (nextClip = getNextClip(); nextClip; nextClip = getNextClip()) {
+    // Only the clips with frames due are touched, each put back in the schedule at the time of its next frame
+    while (!_schedule.empty()) {
         auto currentPosition = Frame::frameTimeFromEpoch(_startEpoch);
         if ((currentPosition - startingPosition) >= MAX_FRAME_PROCESSING_TIME) {
             qCWarning(recordingLog) << "Exceeded maximum frame processing time, breaking early";
@@ -136,15 +149,18 @@ void Deck::processFrames() {
         }
 
         // If the clip is too far in the future, just break out of the handling loop
-        Frame::Time framePosition = nextClip->positionFrameTime();
-        if (framePosition > triggerPosition) {
+        if (_schedule.front().first > triggerPosition) {
             break;
         }
         // Handle the frame and advance the clip
+        std::pop_heap(_schedule.begin(), _schedule.end(), isLater);
+        auto nextClip = _schedule.back().second;
+        _schedule.pop_back();
         Frame::handleFrame(nextClip->nextFrame());
+        scheduleClip(nextClip);
     }
 
-    if (!nextClip) {
+    if (_schedule.empty()) {
         qCDebug(recordingLog) << "No more frames available";
         // No more frames available, so handle the end of playback
         if (_loop) {
@@ -165,7 +181,7 @@ void Deck::processFrames() {
     _position = Frame::frameTimeFromEpoch(_startEpoch);
     int nextInterval = 1;
     if (!overLimit) {
-        auto nextFrameTime = nextClip->positionFrameTime();
+        auto nextFrameTime = _schedule.front().first;
         nextInterval = (int)Frame::frameTimeToMilliseconds(nextFrameTime - _position);
 #ifdef WANT_RECORDING_DEBUG
         qCDebug(recordingLog) << "Now " << _position;
@@ -175,28 +191,29 @@ void Deck::processFrames() {
 #ifdef WANT_RECORDING_DEBUG
     qCDebug(recordingLog) << "Setting timer for next processing " << nextInterval;
 #endif
-    _timer.singleShot(nextInterval, [this] {
-        processFrames();
-    });
+    _timer.start(nextInterval);
 }
 
 void Deck::removeClip(const ClipConstPointer& clip) {
     Locker lock(_mutex);
-    std::remove_if(_clips.begin(), _clips.end(), [&](const Clip::ConstPointer& testClip)->bool {
+    _clips.remove_if([&](const Clip::ConstPointer& testClip)->bool {
         return (clip == testClip);
     });
+    scheduleClips();
 }
 
 void Deck::removeClip(const QString& clipName) {
     Locker lock(_mutex);
-    std::remove_if(_clips.begin(), _clips.end(), [&](const Clip::ConstPointer& clip)->bool {
+    _clips.remove_if([&](const Clip::ConstPointer& clip)->bool {
         return (clip->getName() == clipName);
     });
+    scheduleClips();
 }
 
 void Deck::removeAllClips() {
     Locker lock(_mutex);
     _clips.clear();
+    _schedule.clear();
 }
 
 Deck::ClipList Deck::getClips(const QString& clipName) const {
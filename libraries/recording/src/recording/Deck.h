@@ -13,6 +13,7 @@
 #include <utility>
 #include <list>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -65,12 +66,17 @@ private:
     using Mutex = std::recursive_mutex;
     using Locker = std::unique_lock<Mutex>;
 
-    ClipPointer getNextClip();
+    // the clips with frames left to play, by the time of their next frame
+    using ScheduledClip = std::pair<Frame::Time, ClipPointer>;
+    void scheduleClips();
+    void scheduleClip(const ClipPointer& clip);
+
     void processFrames();
 
     mutable Mutex _mutex;
     QTimer _timer;
     ClipList _clips;
+    std::vector<ScheduledClip> _schedule; // a heap, the soonest first
     quint64 _startEpoch { 0 };
     Frame::Time _position { 0 };
     bool _pause { true };
@@ -25,6 +25,9 @@ struct FrameHeader {
     static const Time INVALID_TIME = UINT32_MAX;
     static const FrameType TYPE_INVALID = 0xFFFF;
     static const FrameType TYPE_HEADER = 0x0;
+    // the index of the frames at the end of a clip file and the footer pointing at it, never in a frame type map
+    static const FrameType TYPE_INDEX = 0xFFFE;
+    static const FrameType TYPE_INDEX_FOOTER = 0xFFFD;
 
     static Time secondsToFrameTime(float seconds);
     static float frameTimeToSeconds(Time frameTime);
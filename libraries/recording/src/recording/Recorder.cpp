@@ -8,19 +8,37 @@
 
 #include "Recorder.h"
 
+#include <QtCore/QDir>
+#include <QtCore/QUuid>
+
 #include <NumericalConstants.h>
 #include <SharedUtil.h>
 
 #include "impl/BufferClip.h"
+#include "impl/ClipWriter.h"
+#include "impl/FileClip.h"
 #include "Frame.h"
+#include "Logging.h"
 
 using namespace recording;
 
 Recorder::Recorder(QObject* parent) 
     : QObject(parent) {}
 
+Recorder::~Recorder() {
+    Locker lock(_mutex);
+    finishWriting();
+    _clip.reset();
+    if (!_fileName.isEmpty()) {
+        QFile::remove(_fileName);
+    }
+}
+
 float Recorder::position() {
     Locker lock(_mutex);
+    if (_writer) {
+        return Frame::frameTimeToSeconds(_lastFrameTime);
+    }
     if (_clip) {
         return _clip->duration();
     }
@@ -32,7 +50,22 @@ void Recorder::start() {
     if (!_recording) {
         _recording = true;
         // FIXME for now just record a new clip every time
-        _clip = std::make_shared<BufferClip>();
+        _clip.reset();
+        if (!_fileName.isEmpty()) {
+            // Fails while the last clip is still open elsewhere on some platforms, the file is then left behind
+            QFile::remove(_fileName);
+        }
+        _fileName = QDir::temp().filePath(QString("recording-%1.hfr").arg(QUuid::createUuid().toString().mid(1, 36)));
+        _writer = std::make_shared<ClipWriter>(_fileName);
+        if (_writer->isOpen()) {
+            _writer->initialize(true, QThread::LowPriority);
+        } else {
+            // Without a file to write to, the frames are kept in memory
+            _writer.reset();
+            _fileName.clear();
+            _clip = std::make_shared<BufferClip>();
+        }
+        _lastFrameTime = 0;
         _startEpoch = usecTimestampNow();
         _timer.start();
         emit recordingStateChanged();
@@ -44,6 +77,10 @@ void Recorder::stop() {
     if (_recording) {
         _recording = false;
         _elapsed = _timer.elapsed();
+        if (_writer) {
+            finishWriting();
+            _clip = std::make_shared<FileClip>(_fileName);
+        }
         emit recordingStateChanged();
     }
 }
@@ -55,12 +92,22 @@ bool Recorder::isRecording() {
 
 void Recorder::clear() {
     Locker lock(_mutex);
+    finishWriting();
     _clip.reset();
 }
 
+void Recorder::finishWriting() {
+    if (_writer) {
+        if (!_writer->finish()) {
+            qCWarning(recordingLog) << "The recording was not written whole to " << _fileName;
+        }
+        _writer.reset();
+    }
+}
+
 void Recorder::recordFrame(FrameType type, QByteArray frameData) {
     Locker lock(_mutex);
-    if (!_recording || !_clip) {
+    if (!_recording || !(_clip || _writer)) {
         return;
     }
 
@@ -68,7 +115,12 @@ void Recorder::recordFrame(FrameType type, QByteArray frameData) {
     frame->type = type;
     frame->data = frameData;
     frame->timeOffset = (usecTimestampNow() - _startEpoch) / USECS_PER_MSEC;
-    _clip->addFrame(frame);
+    if (_writer) {
+        _lastFrameTime = frame->timeOffset;
+        _writer->queueFrame(frame);
+    } else {
+        _clip->addFrame(frame);
+    }
 }
 
 ClipPointer Recorder::getClip() {
@@ -18,15 +18,19 @@
 #include <DependencyManager.h>
 
 #include "Forward.h"
+#include "Frame.h"
 
 namespace recording {
 
+class ClipWriter;
+
 // An interface for interacting with clips, creating them by recording or
 // playing them back.  Also serialization to and from files / network sources
 class Recorder : public QObject, public Dependency {
     Q_OBJECT
 public:
     Recorder(QObject* parent = nullptr);
+    virtual ~Recorder();
 
     float position();
 
@@ -43,7 +47,7 @@ public:
 
     void recordFrame(FrameType type, QByteArray frameData);
 
-    // Return the currently recorded content
+    // Return the currently recorded content, once the recording is stopped
     ClipPointer getClip();
 
 signals:
@@ -53,9 +57,15 @@ private:
     using Mutex = std::recursive_mutex;
     using Locker = std::unique_lock<Mutex>;
 
+    void finishWriting();
+
     Mutex _mutex;
     QElapsedTimer _timer;
     ClipPointer _clip;
+    // the frames go to a file on disk as they are recorded, the clip is that file once the recording is stopped
+    std::shared_ptr<ClipWriter> _writer;
+    QString _fileName;
+    Frame::Time _lastFrameTime { 0 };
     quint64 _elapsed { 0 };
     quint64 _startEpoch { 0 };
     bool _recording { false };
@@ -21,21 +21,22 @@ class ArrayClip : public Clip {
 public:
     virtual float duration() const override {
         Locker lock(_mutex);
-        if (_frames.empty()) {
+        size_t count = getFrameCount();
+        if (count == 0) {
             return 0;
         }
-        return Frame::frameTimeToSeconds((*_frames.rbegin()).timeOffset);
+        return Frame::frameTimeToSeconds(getFrameTime(count - 1));
     }
 
     virtual size_t frameCount() const override {
         Locker lock(_mutex);
-        return _frames.size();
+        return getFrameCount();
     }
 
     virtual Clip::Pointer duplicate() const override {
         auto result = newClip();
         Locker lock(_mutex);
-        for (size_t i = 0; i < _frames.size(); ++i) {
+        for (size_t i = 0, count = getFrameCount(); i < count; ++i) {
             result->addFrame(readFrame(i));
         }
         return result;
@@ -43,19 +44,26 @@ public:
 
     virtual void seekFrameTime(Frame::Time offset) override {
         Locker lock(_mutex);
-        auto itr = std::lower_bound(_frames.begin(), _frames.end(), offset,
-                [](const T& a, Frame::Time b)->bool {
-                return a.timeOffset < b;
+        // the first frame at or after the offset
+        size_t first = 0;
+        size_t count = getFrameCount();
+        while (count > 0) {
+            size_t step = count / 2;
+            if (getFrameTime(first + step) < offset) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
             }
-        );
-        _frameIndex = itr - _frames.begin();
+        }
+        _frameIndex = first;
     }
 
     virtual Frame::Time positionFrameTime() const override {
         Locker lock(_mutex);
         Frame::Time result = Frame::INVALID_TIME;
-        if (_frameIndex < _frames.size()) {
-            result = _frames[_frameIndex].timeOffset;
+        if (_frameIndex < getFrameCount()) {
+            result = getFrameTime(_frameIndex);
         }
         return result;
     }
@@ -63,7 +71,7 @@ public:
     virtual FrameConstPointer peekFrame() const override {
         Locker lock(_mutex);
         FrameConstPointer result;
-        if (_frameIndex < _frames.size()) {
+        if (_frameIndex < getFrameCount()) {
             result = readFrame(_frameIndex);
         }
         return result;
@@ -72,7 +80,7 @@ public:
     virtual FrameConstPointer nextFrame() override {
         Locker lock(_mutex);
         FrameConstPointer result;
-        if (_frameIndex < _frames.size()) {
+        if (_frameIndex < getFrameCount()) {
             result = readFrame(_frameIndex++);
         }
         return result;
@@ -80,7 +88,7 @@ public:
 
     virtual void skipFrame() override {
         Locker lock(_mutex);
-        if (_frameIndex < _frames.size()) {
+        if (_frameIndex < getFrameCount()) {
             ++_frameIndex;
         }
     }
@@ -90,6 +98,10 @@ protected:
         _frameIndex = 0;
     }
 
+    // the frames are read through these, so a clip can keep its frames elsewhere than in _frames
+    virtual size_t getFrameCount() const { return _frames.size(); }
+    virtual Frame::Time getFrameTime(size_t index) const { return _frames[index].timeOffset; }
+
     virtual FrameConstPointer readFrame(size_t index) const = 0;
     std::vector<T> _frames;
     mutable size_t _frameIndex { 0 };
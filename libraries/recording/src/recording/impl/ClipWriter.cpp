@@ -0,0 +1,106 @@
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ClipWriter.h"
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "../Frame.h"
+#include "../Logging.h"
+
+using namespace recording;
+
+// the most frames waiting to be written, several seconds of avatar and audio frames
+static const int MAX_QUEUED_FRAMES = 1024;
+
+static const quint64 INDEX_WRITE_INTERVAL = 10 * USECS_PER_SECOND;
+
+ClipWriter::ClipWriter(const QString& fileName) : _file(fileName) {
+    setObjectName("ClipWriter");
+    if (!_file.open(QFile::Truncate | QFile::WriteOnly) || !Clip::writeHeader(_file)) {
+        qCWarning(recordingLog) << "Unable to write clip file " << fileName;
+        _file.close();
+        return;
+    }
+    _framesEnd = _file.pos();
+    _lastIndexWrite = usecTimestampNow();
+}
+
+void ClipWriter::queueItemInternal(const FrameConstPointer& frame) {
+    if (_items.size() >= MAX_QUEUED_FRAMES) {
+        ++_droppedFrames;
+        return;
+    }
+    _items.push_back(frame);
+}
+
+bool ClipWriter::processQueueItems(const Queue& frames) {
+    if (_failed) {
+        return true;
+    }
+
+    // the frames go in place of the index written last
+    if (_file.pos() != _framesEnd) {
+        _file.resize(_framesEnd);
+        _file.seek(_framesEnd);
+    }
+    for (const auto& frame : frames) {
+        ClipIndexEntry entry;
+        if (!Clip::writeFrame(_file, *frame, true, &entry, 0, &_coder)) {
+            qCWarning(recordingLog) << "Unable to write to clip file " << _file.fileName();
+            _failed = true;
+            return true;
+        }
+        if (frame->type != Frame::TYPE_INVALID) {
+            _index.push_back(entry);
+        }
+    }
+    _framesEnd = _file.pos();
+
+    quint64 now = usecTimestampNow();
+    if (now - _lastIndexWrite > INDEX_WRITE_INTERVAL) {
+        _lastIndexWrite = now;
+        if (!writeIndex() || !_file.flush()) {
+            qCWarning(recordingLog) << "Unable to write to clip file " << _file.fileName();
+            _failed = true;
+        }
+    }
+    return true;
+}
+
+bool ClipWriter::writeIndex() {
+    if (_file.pos() != _framesEnd) {
+        _file.resize(_framesEnd);
+        _file.seek(_framesEnd);
+    }
+    return Clip::writeIndex(_file, _index);
+}
+
+bool ClipWriter::finish() {
+    terminate();
+    if (!_file.isOpen()) {
+        return false;
+    }
+
+    // the thread is stopped, the frames it didn't get to are written here
+    if (!_items.empty()) {
+        Queue frames;
+        frames.swap(_items);
+        processQueueItems(frames);
+    }
+    if (!_failed && !writeIndex()) {
+        qCWarning(recordingLog) << "Unable to write to clip file " << _file.fileName();
+        _failed = true;
+    }
+    _file.close();
+
+    if (_droppedFrames > 0) {
+        qCWarning(recordingLog) << "Dropped " << _droppedFrames << " frames the clip writer was too far behind to write";
+    }
+    return !_failed;
+}
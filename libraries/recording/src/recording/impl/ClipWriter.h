@@ -0,0 +1,58 @@
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_ClipWriter_h
+#define hifi_Recording_Impl_ClipWriter_h
+
+#include <vector>
+
+#include <QtCore/QFile>
+
+#include <GenericQueueThread.h>
+
+#include "FrameCoder.h"
+#include "PointerClip.h"
+
+namespace recording {
+
+// Writes a clip to a file as it is recorded, on a thread of its own, so the recording threads only queue their frames.
+// The writer compresses and appends the frames, and every so often writes the index after them so the file is a
+// whole clip should the recording never be finished; the frames that follow go in place of that index.
+class ClipWriter : public GenericQueueThread<FrameConstPointer> {
+public:
+    ClipWriter(const QString& fileName);
+
+    // false when the file couldn't be opened, the writer is then not to be started
+    bool isOpen() const { return _file.isOpen(); }
+
+    QString getFileName() const { return _file.fileName(); }
+
+    // queues a frame to write, dropping it when the writer is too far behind
+    void queueFrame(const FrameConstPointer& frame) { queueItem(frame); }
+
+    // stops the thread, writes the frames left and the index, and closes the file; false if any write failed
+    bool finish();
+
+protected:
+    virtual void queueItemInternal(const FrameConstPointer& frame) override;
+    virtual bool processQueueItems(const Queue& frames) override;
+
+    bool writeIndex();
+
+    QFile _file;
+    FrameCoder _coder;
+    std::vector<ClipIndexEntry> _index;
+    qint64 _framesEnd { 0 }; // where the index goes
+    quint64 _lastIndexWrite { 0 };
+    size_t _droppedFrames { 0 };
+    bool _failed { false };
+};
+
+}
+
+#endif
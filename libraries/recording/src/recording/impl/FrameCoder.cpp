@@ -0,0 +1,69 @@
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FrameCoder.h"
+
+#include <algorithm>
+
+using namespace recording;
+
+// the most deltas of a type in a row, so reading a frame out of order decodes this many frames at most
+static const int MAX_DELTAS = 60;
+
+// the bytes of the data the same as the previous data come out as zeroes, the bytes past its end as they are
+static void applyDelta(QByteArray& data, const QByteArray& previousData) {
+    int size = std::min(data.size(), previousData.size());
+    char* bytes = data.data();
+    const char* previousBytes = previousData.constData();
+    for (int i = 0; i < size; i++) {
+        bytes[i] ^= previousBytes[i];
+    }
+}
+
+QByteArray FrameCoder::encode(const Frame& frame) {
+    auto itr = _types.find(frame.type);
+    bool hasPrevious = (itr != _types.end());
+    if (!hasPrevious) {
+        itr = _types.insert(frame.type, TypeState());
+    }
+    TypeState& state = *itr;
+
+    QByteArray payload;
+    payload.reserve(frame.data.size() + 1);
+    payload.append((char)KEY);
+    payload.append(frame.data);
+    QByteArray result = qCompress(payload);
+
+    if (hasPrevious && state.framesSinceKey < MAX_DELTAS) {
+        QByteArray delta = frame.data;
+        applyDelta(delta, state.previousData);
+        delta.prepend((char)DELTA);
+        delta = qCompress(delta);
+        if (delta.size() < result.size()) {
+            result = delta;
+            state.framesSinceKey++;
+        } else {
+            state.framesSinceKey = 0;
+        }
+    } else {
+        state.framesSinceKey = 0;
+    }
+    state.previousData = frame.data;
+    return result;
+}
+
+FrameCoder::Coding FrameCoder::readCoding(const QByteArray& payload) {
+    return (payload.isEmpty() || payload[0] != (char)DELTA) ? KEY : DELTA;
+}
+
+QByteArray FrameCoder::decode(const QByteArray& payload, const QByteArray& previousData) {
+    QByteArray data = payload.mid(1);
+    if (readCoding(payload) == DELTA) {
+        applyDelta(data, previousData);
+    }
+    return data;
+}
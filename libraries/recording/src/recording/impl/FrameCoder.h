@@ -0,0 +1,50 @@
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_FrameCoder_h
+#define hifi_Recording_Impl_FrameCoder_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+
+#include "../Frame.h"
+
+namespace recording {
+
+// The frames of a clip file from version 3 on are each compressed after a byte telling how they are coded: whole (a
+// key frame), or as their difference with the frame of their type before.  The frames of a type are mostly the same
+// from one to the next (the avatar frames are the same JSON with some values changed), and their difference, with the
+// bytes left unchanged at zero, compresses several times smaller.  A key frame comes every so often, so a frame read
+// out of order is found from the few frames back to the key frame before it.
+class FrameCoder {
+public:
+    enum Coding : uint8_t {
+        KEY = 0,
+        DELTA = 1
+    };
+
+    // the data to write for the frame, coded against the frame of its type before where it comes out smaller
+    QByteArray encode(const Frame& frame);
+
+    // the coding of a frame from its payload, the data written by encode once uncompressed
+    static Coding readCoding(const QByteArray& payload);
+    // the data of a frame from its payload, and for a delta the data of the frame of its type before
+    static QByteArray decode(const QByteArray& payload, const QByteArray& previousData = QByteArray());
+
+protected:
+    class TypeState {
+    public:
+        QByteArray previousData;
+        int framesSinceKey { 0 };
+    };
+    QHash<FrameType, TypeState> _types;
+};
+
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include "../Frame.h"
 #include "../Logging.h"
 #include "BufferClip.h"
+#include "FrameCoder.h"
 
 
 using namespace recording;
@@ -45,33 +46,32 @@ FrameTranslationMap parseTranslationMap(const QJsonDocument& doc) {
 }
 
 
-PointerFrameHeaderList parseFrameHeaders(uchar* const start, const size_t& size) {
+// Reads the header of the frame at current, false if there is no whole frame there
+static bool parseFrameHeader(const uchar* start, const uchar* current, const uchar* end, PointerFrameHeader& header) {
+    if (end - current < PointerClip::MINIMUM_FRAME_SIZE) {
+        return false;
+    }
+    memcpy(&(header.type), current, sizeof(FrameType));
+    current += sizeof(FrameType);
+    memcpy(&(header.timeOffset), current, sizeof(Frame::Time));
+    current += sizeof(Frame::Time);
+    memcpy(&(header.size), current, sizeof(FrameSize));
+    current += sizeof(FrameSize);
+    header.fileOffset = current - start;
+    return end - current >= header.size;
+}
+
+PointerFrameHeaderList parseFrameHeaders(uchar* const start, const size_t& size, size_t offset) {
     PointerFrameHeaderList results;
-    auto current = start;
-    auto end = current + size;
+    auto current = start + offset;
+    auto end = start + size;
     // Read all the frame headers
-    // FIXME move to Frame::readHeader?
-    while (end - current >= PointerClip::MINIMUM_FRAME_SIZE) {
-        PointerFrameHeader header;
-        memcpy(&(header.type), current, sizeof(FrameType));
-        current += sizeof(FrameType);
-        memcpy(&(header.timeOffset), current, sizeof(Frame::Time));
-        current += sizeof(Frame::Time);
-        memcpy(&(header.size), current, sizeof(FrameSize));
-        current += sizeof(FrameSize);
-        header.fileOffset = current - start;
-        if (end - current < header.size) {
-            current = end;
-            break;
-        }
-        current += header.size;
+    PointerFrameHeader header;
+    while (parseFrameHeader(start, current, end, header)) {
+        current = start + header.fileOffset + header.size;
         results.push_back(header);
     }
     qDebug() << "Parsed source data into " << results.size() << " frames";
-//    int i = 0;
-//    for (const auto& frameHeader : results) {
-//        qDebug() << "Frame " << i++ << " time " << frameHeader.timeOffset << " Type " << frameHeader.type;
-//    }
     return results;
 }
 
@@ -80,6 +80,11 @@ void PointerClip::reset() {
     _data = nullptr;
     _size = 0;
     _header = QJsonDocument();
+    _translationMap.clear();
+    _index = nullptr;
+    _indexEntryCount = 0;
+    _deltaCoded = false;
+    _decodedFrames.clear();
 }
 
 void PointerClip::init(uchar* data, size_t size) {
@@ -88,24 +93,19 @@ void PointerClip::init(uchar* data, size_t size) {
     _data = data;
     _size = size;
 
-    auto parsedFrameHeaders = parseFrameHeaders(data, size);
-    // Verify that at least one frame exists and that the first frame is a header
-    if (0 == parsedFrameHeaders.size()) {
+    // Grab the file header, which must be the first frame
+    PointerFrameHeader fileHeaderFrameHeader;
+    if (!parseFrameHeader(data, data, data + size, fileHeaderFrameHeader)) {
         qWarning() << "No frames found, invalid file";
         reset();
         return;
     }
-
-    // Grab the file header
+    if (fileHeaderFrameHeader.type != Frame::TYPE_HEADER) {
+        qWarning() << "Missing header frame, invalid file";
+        reset();
+        return;
+    }
     {
-        auto fileHeaderFrameHeader = *parsedFrameHeaders.begin();
-        parsedFrameHeaders.pop_front();
-        if (fileHeaderFrameHeader.type != Frame::TYPE_HEADER) {
-            qWarning() << "Missing header frame, invalid file";
-            reset();
-            return;
-        }
-
         QByteArray fileHeaderData((char*)_data + fileHeaderFrameHeader.fileOffset, fileHeaderFrameHeader.size);
         _header = QJsonDocument::fromBinaryData(fileHeaderData);
     }
@@ -113,45 +113,168 @@ void PointerClip::init(uchar* data, size_t size) {
     // Check for compression
     {
         _compressed = _header.object()[FRAME_COMREPSSION_FLAG].toBool();
+        _deltaCoded = _header.object()[FORMAT_VERSION].toInt() >= 3;
     }
 
-    // Find the type enum translation map and fix up the frame headers
-    {
-        FrameTranslationMap translationMap = parseTranslationMap(_header);
-        if (translationMap.empty()) {
-            qWarning() << "Header missing frame type map, invalid file";
-            reset();
-            return;
+    // Find the type enum translation map
+    _translationMap = parseTranslationMap(_header);
+    if (_translationMap.empty()) {
+        qWarning() << "Header missing frame type map, invalid file";
+        reset();
+        return;
+    }
+
+    if (initIndex(fileHeaderFrameHeader)) {
+        return;
+    }
+
+    // Without an index, read every frame header and fix up their types
+    auto parsedFrameHeaders = parseFrameHeaders(data, size, fileHeaderFrameHeader.fileOffset + fileHeaderFrameHeader.size);
+    _frames.reserve(parsedFrameHeaders.size());
+    for (auto& frameHeader : parsedFrameHeaders) {
+        if (!_translationMap.contains(frameHeader.type)) {
+            continue;
         }
+        frameHeader.type = _translationMap[frameHeader.type];
+        _frames.push_back(frameHeader);
+    }
+}
 
-        // Update the loaded headers with the frame data
-        _frames.reserve(parsedFrameHeaders.size());
-        for (auto& frameHeader : parsedFrameHeaders) {
-            if (!translationMap.contains(frameHeader.type)) {
-                continue;
-            }
-            frameHeader.type = translationMap[frameHeader.type];
-            _frames.push_back(frameHeader);
+bool PointerClip::initIndex(const PointerFrameHeader& fileHeaderFrameHeader) {
+    if (_header.object()[FORMAT_VERSION].toInt() < 2 || _size < (size_t)INDEX_FOOTER_FRAME_SIZE) {
+        return false;
+    }
+
+    const uchar* end = _data + _size;
+    PointerFrameHeader footerFrameHeader;
+    if (!parseFrameHeader(_data, end - INDEX_FOOTER_FRAME_SIZE, end, footerFrameHeader) ||
+            footerFrameHeader.type != Frame::TYPE_INDEX_FOOTER || footerFrameHeader.size != sizeof(ClipIndexFooter)) {
+        qWarning() << "Missing index footer, reading every frame header";
+        return false;
+    }
+    ClipIndexFooter footer;
+    memcpy(&footer, _data + footerFrameHeader.fileOffset, sizeof(ClipIndexFooter));
+
+    // The index frames fill the file from the end of the frames to the footer
+    quint64 indexEnd = _size - INDEX_FOOTER_FRAME_SIZE;
+    quint64 framesEnd = fileHeaderFrameHeader.fileOffset + fileHeaderFrameHeader.size;
+    bool valid = footer.entryCount <= indexEnd / sizeof(ClipIndexEntry) && footer.indexOffset >= framesEnd;
+    if (valid) {
+        quint64 indexSize = (footer.entryCount / INDEX_ENTRIES_PER_FRAME) * INDEX_FRAME_SIZE;
+        quint64 remainder = footer.entryCount % INDEX_ENTRIES_PER_FRAME;
+        if (remainder != 0) {
+            indexSize += MINIMUM_FRAME_SIZE + remainder * sizeof(ClipIndexEntry);
         }
+        valid = footer.indexOffset + indexSize == indexEnd;
+    }
+    if (!valid) {
+        qWarning() << "Invalid index, reading every frame header";
+        return false;
     }
 
+    _index = _data + footer.indexOffset;
+    _indexEntryCount = footer.entryCount;
+    qDebug() << "Opened indexed source data of " << _indexEntryCount << " frames";
+    return true;
+}
+
+ClipIndexEntry PointerClip::getIndexEntry(size_t index) const {
+    const uchar* entryData = _index + (index / INDEX_ENTRIES_PER_FRAME) * INDEX_FRAME_SIZE + MINIMUM_FRAME_SIZE +
+        (index % INDEX_ENTRIES_PER_FRAME) * sizeof(ClipIndexEntry);
+    ClipIndexEntry entry;
+    memcpy(&entry, entryData, sizeof(ClipIndexEntry));
+    return entry;
+}
+
+size_t PointerClip::getFrameCount() const {
+    return _index ? _indexEntryCount : _frames.size();
+}
+
+Frame::Time PointerClip::getFrameTime(size_t index) const {
+    return _index ? getIndexEntry(index).timeOffset : _frames[index].timeOffset;
+}
+
+PointerFrameHeader PointerClip::getFrameHeader(size_t frameIndex) const {
+    if (!_index) {
+        return _frames[frameIndex];
+    }
+    PointerFrameHeader header;
+    auto entry = getIndexEntry(frameIndex);
+    // the frames of types this build doesn't know are still in the index, they are left unplayed
+    header.type = _translationMap.value(entry.type, Frame::TYPE_INVALID);
+    header.timeOffset = entry.timeOffset;
+    header.size = entry.size;
+    header.fileOffset = entry.fileOffset;
+    if (header.fileOffset + header.size > _size) {
+        header.size = 0;
+    }
+    return header;
+}
+
+QByteArray PointerClip::readPayload(const PointerFrameHeader& header) const {
+    QByteArray result;
+    if (header.size) {
+        result.insert(0, reinterpret_cast<char*>(_data)+header.fileOffset, header.size);
+        if (_compressed) {
+            result = qUncompress(result);
+        }
+    }
+    return result;
+}
+
+QByteArray PointerClip::readFrameData(size_t frameIndex, const PointerFrameHeader& header) const {
+    if (!_deltaCoded) {
+        return readPayload(header);
+    }
+    if (header.type == Frame::TYPE_INVALID) {
+        return QByteArray();
+    }
+
+    // Gather the payloads back to a key frame, or to the frame of the type decoded last
+    std::vector<QByteArray> payloads;
+    QByteArray data;
+    auto decoded = _decodedFrames.find(header.type);
+    size_t index = frameIndex;
+    PointerFrameHeader current = header;
+    while (true) {
+        if (decoded != _decodedFrames.end() && decoded->index == index) {
+            data = decoded->data;
+            break;
+        }
+        payloads.push_back(readPayload(current));
+        if (FrameCoder::readCoding(payloads.back()) == FrameCoder::KEY) {
+            break;
+        }
+        bool found = false;
+        while (!found && index > 0) {
+            current = getFrameHeader(--index);
+            found = (current.type == header.type);
+        }
+        if (!found) {
+            qWarning() << "Missing key frame, invalid file";
+            break;
+        }
+    }
+
+    for (auto itr = payloads.rbegin(); itr != payloads.rend(); ++itr) {
+        data = FrameCoder::decode(*itr, data);
+    }
+    _decodedFrames[header.type] = { frameIndex, data };
+    return data;
 }
 
 // Internal only function, needs no locking
 FrameConstPointer PointerClip::readFrame(size_t frameIndex) const {
     FramePointer result;
-    if (frameIndex < _frames.size()) {
-        result = std::make_shared<Frame>();
-        const auto& header = _frames[frameIndex];
-        result->type = header.type;
-        result->timeOffset = header.timeOffset;
-        if (header.size) {
-            result->data.insert(0, reinterpret_cast<char*>(_data)+header.fileOffset, header.size);
-            if (_compressed) {
-                result->data = qUncompress(result->data);
-            }
-        }
+    if (frameIndex >= getFrameCount()) {
+        return result;
     }
+
+    auto header = getFrameHeader(frameIndex);
+    result = std::make_shared<Frame>();
+    result->type = header.type;
+    result->timeOffset = header.timeOffset;
+    result->data = readFrameData(frameIndex, header);
     return result;
 }
 
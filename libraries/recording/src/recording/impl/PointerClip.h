@@ -15,6 +15,8 @@
 #include <mutex>
 
 #include <QtCore/QJsonDocument>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
 
 #include "../Frame.h"
 
@@ -29,6 +31,24 @@ struct PointerFrameHeader : public FrameHeader {
 
 using PointerFrameHeaderList = std::list<PointerFrameHeader>;
 
+// A clip file from version 2 on ends with an index of its frames, in uncompressed frames of type TYPE_INDEX holding
+// up to INDEX_ENTRIES_PER_FRAME entries each, and a last frame of type TYPE_INDEX_FOOTER holding the offset of the
+// first of them and the number of entries.  A clip is opened and seeked from the index in place, without reading
+// every frame header of the file.
+struct ClipIndexEntry {
+    Frame::Time timeOffset;
+    FrameType type; // as stored, before the translation to the current frame types
+    FrameSize size;
+    quint64 fileOffset; // of the data of the frame
+};
+
+struct ClipIndexFooter {
+    quint64 indexOffset;
+    quint64 entryCount;
+};
+
+static const size_t INDEX_ENTRIES_PER_FRAME = 4095;
+
 class PointerClip : public ArrayClip<PointerFrameHeader> {
 public:
     using Pointer = std::shared_ptr<PointerClip>;
@@ -44,13 +64,38 @@ public:
 
     // FIXME move to frame?
     static const qint64 MINIMUM_FRAME_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
+    static const qint64 INDEX_FRAME_SIZE = MINIMUM_FRAME_SIZE + INDEX_ENTRIES_PER_FRAME * sizeof(ClipIndexEntry);
+    static const qint64 INDEX_FOOTER_FRAME_SIZE = MINIMUM_FRAME_SIZE + sizeof(ClipIndexFooter);
 protected:
     void reset() override;
+    virtual size_t getFrameCount() const override;
+    virtual Frame::Time getFrameTime(size_t index) const override;
     virtual FrameConstPointer readFrame(size_t index) const override;
+
+    bool initIndex(const PointerFrameHeader& fileHeaderFrameHeader);
+    ClipIndexEntry getIndexEntry(size_t index) const;
+    PointerFrameHeader getFrameHeader(size_t frameIndex) const;
+
+    // the data of a frame as written, uncompressed, and the data of the frame once decoded from it
+    QByteArray readPayload(const PointerFrameHeader& header) const;
+    QByteArray readFrameData(size_t frameIndex, const PointerFrameHeader& header) const;
+
     QJsonDocument _header;
+    QMap<FrameType, FrameType> _translationMap;
+    const uchar* _index { nullptr }; // the first index frame when the file has one, the frames are then not in _frames
+    size_t _indexEntryCount { 0 };
     uchar* _data { nullptr };
     size_t _size { 0 };
     bool _compressed { true };
+    bool _deltaCoded { false };
+
+    // the frame of each type decoded last, the base of the delta of the next one when read in order
+    class DecodedFrame {
+    public:
+        size_t index;
+        QByteArray data;
+    };
+    mutable QHash<FrameType, DecodedFrame> _decodedFrames;
 };
 
 }
@@ -103,6 +103,9 @@ AmbientOcclusionEffect::AmbientOcclusionEffect() {
 
 void AmbientOcclusionEffect::configure(const Config& config) {
     DependencyManager::get<DeferredLightingEffect>()->setAmbientOcclusionEnabled(config.enabled);
+    if (!config.enabled) {
+        DependencyManager::get<FramebufferCache>()->releaseAmbientOcclusionBuffers();
+    }
 
     bool shouldUpdateGaussian = false;
 
@@ -343,8 +346,6 @@ void AmbientOcclusionEffect::run(const render::SceneContextPointer& sceneContext
     gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
         batch.enableStereo(false);
 
-        _gpuTimer.begin(batch);
-
         batch.setViewportTransform(args->_viewport);
         batch.setProjectionTransform(glm::mat4());
         batch.setViewTransform(Transform());
@@ -395,10 +396,5 @@ void AmbientOcclusionEffect::run(const render::SceneContextPointer& sceneContext
             batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, occlusionBlurredFBO->getRenderBuffer(0));
             batch.draw(gpu::TRIANGLE_STRIP, 4);
         }
-        
-        _gpuTimer.end(batch);
     });
-
-    // Update the timer
-    std::static_pointer_cast<Config>(renderContext->jobConfig)->gpuTime = _gpuTimer.getAverage();
 }
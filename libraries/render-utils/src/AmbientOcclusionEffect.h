@@ -30,7 +30,6 @@ class AmbientOcclusionEffectConfig : public render::Job::Config {
     Q_PROPERTY(int numSamples MEMBER numSamples WRITE setNumSamples)
     Q_PROPERTY(int resolutionLevel MEMBER resolutionLevel WRITE setResolutionLevel)
     Q_PROPERTY(int blurRadius MEMBER blurRadius WRITE setBlurRadius)
-    Q_PROPERTY(double gpuTime READ getGpuTime)
 public:
     AmbientOcclusionEffectConfig() : render::Job::Config(false) {}
 
@@ -46,7 +45,6 @@ public:
     void setNumSamples(int samples) { numSamples = std::max(1.0f, (float)samples); emit dirty(); }
     void setResolutionLevel(int level) { resolutionLevel = std::max(0, std::min(level, MAX_RESOLUTION_LEVEL)); emit dirty(); }
     void setBlurRadius(int radius) { blurRadius = std::max(0, std::min(MAX_BLUR_RADIUS, radius)); emit dirty(); }
-    double getGpuTime() { return gpuTime; }
 
     float radius{ 0.5f };
     float obscuranceLevel{ 0.5f }; // intensify or dim down the obscurance effect
@@ -59,7 +57,6 @@ public:
     int blurRadius{ 4 }; // 0 means no blurring
     bool ditheringEnabled{ true }; // randomize the distribution of rays per pixel, should always be true
     bool borderingEnabled{ true }; // avoid evaluating information from non existing pixels out of the frame, should always be true
-    double gpuTime{ 0.0 };
 
 signals:
     void dirty();
@@ -141,7 +138,6 @@ private:
     gpu::PipelinePointer _hBlurPipeline;
     gpu::PipelinePointer _vBlurPipeline;
 
-    gpu::RangeTimer _gpuTimer;
 };
 
 #endif // hifi_AmbientOcclusionEffect_h
@@ -110,10 +110,11 @@ void Antialiasing::run(const render::SceneContextPointer& sceneContext, const re
         QSize framebufferSize = framebufferCache->getFrameBufferSize();
         float fbWidth = framebufferSize.width();
         float fbHeight = framebufferSize.height();
-        // float sMin = args->_viewport.x / fbWidth;
-        // float sWidth = args->_viewport.z / fbWidth;
-        // float tMin = args->_viewport.y / fbHeight;
-        // float tHeight = args->_viewport.w / fbHeight;
+        // the frame only covers the viewport in the framebuffers when it's drawn at a render scale
+        float sMin = args->_viewport.x / fbWidth;
+        float sWidth = args->_viewport.z / fbWidth;
+        float tMin = args->_viewport.y / fbHeight;
+        float tHeight = args->_viewport.w / fbHeight;
 
         glm::mat4 projMat;
         Transform viewMat;
@@ -148,8 +149,8 @@ void Antialiasing::run(const render::SceneContextPointer& sceneContext, const re
         glm::vec4 color(0.0f, 0.0f, 0.0f, 1.0f);
         glm::vec2 bottomLeft(-1.0f, -1.0f);
         glm::vec2 topRight(1.0f, 1.0f);
-        glm::vec2 texCoordTopLeft(0.0f, 0.0f);
-        glm::vec2 texCoordBottomRight(1.0f, 1.0f);
+        glm::vec2 texCoordTopLeft(sMin, tMin);
+        glm::vec2 texCoordBottomRight(sMin + sWidth, tMin + tHeight);
         DependencyManager::get<GeometryCache>()->renderQuad(batch, bottomLeft, topRight, texCoordTopLeft, texCoordBottomRight, color);
 
         // Blend step
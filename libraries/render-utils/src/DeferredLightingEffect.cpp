@@ -24,8 +24,6 @@
 #include "FramebufferCache.h"
 
 #include "deferred_light_vert.h"
-#include "deferred_light_limited_vert.h"
-#include "deferred_light_spot_vert.h"
 
 #include "directional_light_frag.h"
 #include "directional_ambient_light_frag.h"
@@ -35,17 +33,15 @@
 #include "directional_ambient_light_shadow_frag.h"
 #include "directional_skybox_light_shadow_frag.h"
 
-#include "point_light_frag.h"
-#include "spot_light_frag.h"
+#include "clustered_light_frag.h"
 
 struct LightLocations {
     int radius;
     int ambientSphere;
     int lightBufferUnit;
-    int texcoordMat;
-    int coneParam;
     int deferredTransformBuffer;
     int shadowTransformBuffer;
+    int clusterDepth;
 };
 
 enum {
@@ -56,6 +52,9 @@ enum {
     DEFERRED_BUFFER_OBSCURANCE_UNIT = 4,
     SHADOW_MAP_UNIT = 5,
     SKYBOX_MAP_UNIT = 6,
+    CLUSTER_LIGHTS_MAP_UNIT = 7,
+    CLUSTERS_MAP_UNIT = 8,
+    CLUSTER_INDICES_MAP_UNIT = 9,
 };
 static void loadLightProgram(const char* vertSource, const char* fragSource, bool lightVolume, gpu::PipelinePointer& program, LightLocationsPtr& locations);
 
@@ -68,8 +67,7 @@ void DeferredLightingEffect::init() {
     _directionalAmbientSphereLightShadowLocations = std::make_shared<LightLocations>();
     _directionalSkyboxLightShadowLocations = std::make_shared<LightLocations>();
 
-    _pointLightLocations = std::make_shared<LightLocations>();
-    _spotLightLocations = std::make_shared<LightLocations>();
+    _clusteredLightLocations = std::make_shared<LightLocations>();
 
     loadLightProgram(deferred_light_vert, directional_light_frag, false, _directionalLight, _directionalLightLocations);
     loadLightProgram(deferred_light_vert, directional_ambient_light_frag, false, _directionalAmbientSphereLight, _directionalAmbientSphereLightLocations);
@@ -79,8 +77,7 @@ void DeferredLightingEffect::init() {
     loadLightProgram(deferred_light_vert, directional_ambient_light_shadow_frag, false, _directionalAmbientSphereLightShadow, _directionalAmbientSphereLightShadowLocations);
     loadLightProgram(deferred_light_vert, directional_skybox_light_shadow_frag, false, _directionalSkyboxLightShadow, _directionalSkyboxLightShadowLocations);
 
-    loadLightProgram(deferred_light_limited_vert, point_light_frag, true, _pointLight, _pointLightLocations);
-    loadLightProgram(deferred_light_spot_vert, spot_light_frag, true, _spotLight, _spotLightLocations);
+    loadLightProgram(deferred_light_vert, clustered_light_frag, true, _clusteredLight, _clusteredLightLocations);
 
     // Allocate a global light representing the Global Directional light casting shadow (the sun) and the ambient light
     _globalLights.push_back(0);
@@ -291,9 +288,6 @@ void DeferredLightingEffect::render(const render::RenderContextPointer& renderCo
             fetchTexcoordRects[0] = glm::vec4(sMin, tMin, sWidth, tHeight);
         }
 
-        auto eyePoint = viewFrustum->getPosition();
-        float nearRadius = glm::distance(eyePoint, viewFrustum->getNearTopLeft());
-
 
         for (int side = 0; side < numPasses; side++) {
             // Render in this side's viewport
@@ -379,113 +373,31 @@ void DeferredLightingEffect::render(const render::RenderContextPointer& renderCo
                 }
             }
 
-            auto texcoordMat = glm::mat4();
-          /*  texcoordMat[0] = glm::vec4(sWidth / 2.0f, 0.0f, 0.0f, sMin + sWidth / 2.0f);
-            texcoordMat[1] = glm::vec4(0.0f, tHeight / 2.0f, 0.0f, tMin + tHeight / 2.0f);
-           */ texcoordMat[0] = glm::vec4(fetchTexcoordRects[side].z / 2.0f, 0.0f, 0.0f, fetchTexcoordRects[side].x + fetchTexcoordRects[side].z / 2.0f);
-            texcoordMat[1] = glm::vec4(0.0f, fetchTexcoordRects[side].w / 2.0f, 0.0f, fetchTexcoordRects[side].y + fetchTexcoordRects[side].w / 2.0f);
-            texcoordMat[2] = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
-            texcoordMat[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-
-            // enlarge the scales slightly to account for tesselation
-            const float SCALE_EXPANSION = 0.05f;
-
-
-            batch.setProjectionTransform(projMats[side]);
-            batch.setViewTransform(viewTransforms[side]);
-
-            // Splat Point lights
-            if (!_pointLights.empty()) {
-                batch.setPipeline(_pointLight);
-
-                batch._glUniformMatrix4fv(_pointLightLocations->texcoordMat, 1, false, reinterpret_cast< const float* >(&texcoordMat));
-
+            // Then all the point and spot lights in one pass, each pixel going through the lights of its cluster
+            if (!_pointLights.empty() || !_spotLights.empty()) {
+                LightClusters::Lights lights;
+                lights.reserve(_pointLights.size() + _spotLights.size());
                 for (auto lightID : _pointLights) {
-                    auto& light = _allocatedLights[lightID];
-                    // IN DEBUG: light->setShowContour(true);
-                    batch.setUniformBuffer(_pointLightLocations->lightBufferUnit, light->getSchemaBuffer());
-
-                    float expandedRadius = light->getMaximumRadius() * (1.0f + SCALE_EXPANSION);
-                    // TODO: We shouldn;t have to do that test and use a different volume geometry for when inside the vlight volume,
-                    // we should be able to draw thre same geometry use DepthClamp but for unknown reason it's s not working...
-                    if (glm::distance(eyePoint, glm::vec3(light->getPosition())) < expandedRadius + nearRadius) {
-                        Transform model;
-                        model.setTranslation(glm::vec3(0.0f, 0.0f, -1.0f));
-                        batch.setModelTransform(model);
-                        batch.setViewTransform(Transform());
-                        batch.setProjectionTransform(glm::mat4());
-
-                        glm::vec4 color(1.0f, 1.0f, 1.0f, 1.0f);
-                        DependencyManager::get<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, texCoordTopLeft, texCoordBottomRight, color);
-                
-                        batch.setProjectionTransform(projMats[side]);
-                        batch.setViewTransform(viewTransforms[side]);
-                    } else {
-                        Transform model;
-                        model.setTranslation(glm::vec3(light->getPosition().x, light->getPosition().y, light->getPosition().z));
-                        batch.setModelTransform(model.postScale(expandedRadius));
-                        batch._glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
-                        geometryCache->renderSphere(batch);
-                    }
+                    lights.push_back(_allocatedLights[lightID]);
                 }
-            }
-    
-            // Splat spot lights
-            if (!_spotLights.empty()) {
-                batch.setPipeline(_spotLight);
-
-                batch._glUniformMatrix4fv(_spotLightLocations->texcoordMat, 1, false, reinterpret_cast< const float* >(&texcoordMat));
-
                 for (auto lightID : _spotLights) {
-                    auto light = _allocatedLights[lightID];
-                    // IN DEBUG: light->setShowContour(true);
-                    batch.setUniformBuffer(_spotLightLocations->lightBufferUnit, light->getSchemaBuffer());
-
-                    auto eyeLightPos = eyePoint - light->getPosition();
-                    auto eyeHalfPlaneDistance = glm::dot(eyeLightPos, light->getDirection());
-
-                    const float TANGENT_LENGTH_SCALE = 0.666f;
-                    glm::vec4 coneParam(light->getSpotAngleCosSin(), TANGENT_LENGTH_SCALE * tanf(0.5f * light->getSpotAngle()), 1.0f);
-
-                    float expandedRadius = light->getMaximumRadius() * (1.0f + SCALE_EXPANSION);
-                    // TODO: We shouldn;t have to do that test and use a different volume geometry for when inside the vlight volume,
-                    // we should be able to draw thre same geometry use DepthClamp but for unknown reason it's s not working...
-                    if ((eyeHalfPlaneDistance > -nearRadius) &&
-                        (glm::distance(eyePoint, glm::vec3(light->getPosition())) < expandedRadius + nearRadius)) {
-                        coneParam.w = 0.0f;
-                        batch._glUniform4fv(_spotLightLocations->coneParam, 1, reinterpret_cast< const float* >(&coneParam));
-
-                        Transform model;
-                        model.setTranslation(glm::vec3(0.0f, 0.0f, -1.0f));
-                        batch.setModelTransform(model);
-                        batch.setViewTransform(Transform());
-                        batch.setProjectionTransform(glm::mat4());
-                
-                        glm::vec4 color(1.0f, 1.0f, 1.0f, 1.0f);
-                        DependencyManager::get<GeometryCache>()->renderQuad(batch, topLeft, bottomRight, texCoordTopLeft, texCoordBottomRight, color);
-                
-                        batch.setProjectionTransform( projMats[side]);
-                        batch.setViewTransform(viewTransforms[side]);
-                    } else {
-                        coneParam.w = 1.0f;
-                        batch._glUniform4fv(_spotLightLocations->coneParam, 1, reinterpret_cast< const float* >(&coneParam));
-
-                        Transform model;
-                        model.setTranslation(light->getPosition());
-                        model.postRotate(light->getOrientation());
-                        model.postScale(glm::vec3(expandedRadius, expandedRadius, expandedRadius));
-
-                        batch.setModelTransform(model);
-                        auto mesh = getSpotLightMesh();
+                    lights.push_back(_allocatedLights[lightID]);
+                }
 
-                        batch.setIndexBuffer(mesh->getIndexBuffer());
-                        batch.setInputBuffer(0, mesh->getVertexBuffer());
-                        batch.setInputFormat(mesh->getVertexFormat());
+                auto& clusters = _lightClusters[side];
+                clusters.update(lights, projMats[side], glm::inverse(deferredTransforms[side].viewInverse),
+                    viewFrustum->getNearClip());
 
-                        auto& part = mesh->getPartBuffer().get<model::Mesh::Part>();
+                if (clusters.getNumIndices() > 0) {
+                    batch.setPipeline(_clusteredLight);
+                    batch.setResourceTexture(CLUSTER_LIGHTS_MAP_UNIT, clusters.getLightsMap());
+                    batch.setResourceTexture(CLUSTERS_MAP_UNIT, clusters.getClustersMap());
+                    batch.setResourceTexture(CLUSTER_INDICES_MAP_UNIT, clusters.getIndicesMap());
+                    batch._glUniform4fv(_clusteredLightLocations->clusterDepth, 1,
+                        reinterpret_cast< const float* >(&clusters.getDepthParams()));
 
-                        batch.drawIndexed(model::Mesh::topologyToPrimitive(part._topology), part._numIndices, part._startIndex);
-                    }
+                    glm::vec4 color(1.0f, 1.0f, 1.0f, 1.0f);
+                    geometryCache->renderQuad(batch, topLeft, bottomRight, texCoordTopLeft, texCoordBottomRight, color);
                 }
             }
         }
@@ -498,6 +410,9 @@ void DeferredLightingEffect::render(const render::RenderContextPointer& renderCo
         batch.setResourceTexture(DEFERRED_BUFFER_OBSCURANCE_UNIT, nullptr);
         batch.setResourceTexture(SHADOW_MAP_UNIT, nullptr);
         batch.setResourceTexture(SKYBOX_MAP_UNIT, nullptr);
+        batch.setResourceTexture(CLUSTER_LIGHTS_MAP_UNIT, nullptr);
+        batch.setResourceTexture(CLUSTERS_MAP_UNIT, nullptr);
+        batch.setResourceTexture(CLUSTER_INDICES_MAP_UNIT, nullptr);
 
         batch.setUniformBuffer(_directionalLightLocations->deferredTransformBuffer, nullptr);
     });
@@ -530,6 +445,9 @@ static void loadLightProgram(const char* vertSource, const char* fragSource, boo
     slotBindings.insert(gpu::Shader::Binding(std::string("obscuranceMap"), DEFERRED_BUFFER_OBSCURANCE_UNIT));
     slotBindings.insert(gpu::Shader::Binding(std::string("shadowMap"), SHADOW_MAP_UNIT));
     slotBindings.insert(gpu::Shader::Binding(std::string("skyboxMap"), SKYBOX_MAP_UNIT));
+    slotBindings.insert(gpu::Shader::Binding(std::string("clusterLightsMap"), CLUSTER_LIGHTS_MAP_UNIT));
+    slotBindings.insert(gpu::Shader::Binding(std::string("clustersMap"), CLUSTERS_MAP_UNIT));
+    slotBindings.insert(gpu::Shader::Binding(std::string("clusterIndicesMap"), CLUSTER_INDICES_MAP_UNIT));
 
     static const int LIGHT_GPU_SLOT = 3;
     static const int DEFERRED_TRANSFORM_BUFFER_SLOT = 2;
@@ -541,8 +459,7 @@ static void loadLightProgram(const char* vertSource, const char* fragSource, boo
     locations->radius = program->getUniforms().findLocation("radius");
     locations->ambientSphere = program->getUniforms().findLocation("ambientSphere.L00");
 
-    locations->texcoordMat = program->getUniforms().findLocation("texcoordMat");
-    locations->coneParam = program->getUniforms().findLocation("coneParam");
+    locations->clusterDepth = program->getUniforms().findLocation("clusterDepth");
 
     locations->lightBufferUnit = program->getBuffers().findLocation("lightBuffer");
     locations->deferredTransformBuffer = program->getBuffers().findLocation("deferredTransformBuffer");
@@ -593,98 +510,3 @@ void DeferredLightingEffect::setGlobalLight(const glm::vec3& direction, const gl
 void DeferredLightingEffect::setGlobalSkybox(const model::SkyboxPointer& skybox) {
     _skybox = skybox;
 }
-
-model::MeshPointer DeferredLightingEffect::getSpotLightMesh() {
-    if (!_spotLightMesh) {
-        _spotLightMesh = std::make_shared<model::Mesh>();
-
-        int slices = 32;
-        int rings = 3;
-        int vertices = 2 + rings * slices;
-        int originVertex = vertices - 2;
-        int capVertex = vertices - 1;
-        int verticesSize = vertices * 3 * sizeof(float);
-        int indices = 3 * slices * (1 + 1 + 2 * (rings -1));
-        int ringFloatOffset = slices * 3;
-
-
-        float* vertexData = new float[verticesSize];
-        float* vertexRing0 = vertexData;
-        float* vertexRing1 = vertexRing0 + ringFloatOffset;
-        float* vertexRing2 = vertexRing1 + ringFloatOffset;
-        
-        for (int i = 0; i < slices; i++) {
-            float theta = TWO_PI * i / slices;
-            auto cosin = glm::vec2(cosf(theta), sinf(theta));
-
-            *(vertexRing0++) = cosin.x;
-            *(vertexRing0++) = cosin.y;
-            *(vertexRing0++) = 0.0f;
-
-            *(vertexRing1++) = cosin.x;
-            *(vertexRing1++) = cosin.y;
-            *(vertexRing1++) = 0.33f;
-
-            *(vertexRing2++) = cosin.x;
-            *(vertexRing2++) = cosin.y;
-            *(vertexRing2++) = 0.66f;
-        }
-        
-        *(vertexRing2++) = 0.0f;
-        *(vertexRing2++) = 0.0f;
-        *(vertexRing2++) = -1.0f;
-        
-        *(vertexRing2++) = 0.0f;
-        *(vertexRing2++) = 0.0f;
-        *(vertexRing2++) = 1.0f;
-        
-        _spotLightMesh->setVertexBuffer(gpu::BufferView(new gpu::Buffer(verticesSize, (gpu::Byte*) vertexData), gpu::Element::VEC3F_XYZ));
-        delete[] vertexData;
-
-        gpu::uint16* indexData = new gpu::uint16[indices];
-        gpu::uint16* index = indexData;
-        for (int i = 0; i < slices; i++) {
-            *(index++) = originVertex;
-            
-            int s0 = i;
-            int s1 = ((i + 1) % slices);
-            *(index++) = s0;
-            *(index++) = s1;
-
-            int s2 = s0 + slices;
-            int s3 = s1 + slices;
-            *(index++) = s1;
-            *(index++) = s0;
-            *(index++) = s2;
-
-            *(index++) = s1;
-            *(index++) = s2;
-            *(index++) = s3;
-
-            int s4 = s2 + slices;
-            int s5 = s3 + slices;
-            *(index++) = s3;
-            *(index++) = s2;
-            *(index++) = s4;
-
-            *(index++) = s3;
-            *(index++) = s4;
-            *(index++) = s5;
-
-
-            *(index++) = s5;
-            *(index++) = s4;
-            *(index++) = capVertex;
-        }
-
-        _spotLightMesh->setIndexBuffer(gpu::BufferView(new gpu::Buffer(sizeof(unsigned short) * indices, (gpu::Byte*) indexData), gpu::Element::INDEX_UINT16));
-        delete[] indexData;
-
-        model::Mesh::Part part(0, indices, 0, model::Mesh::TRIANGLES);
-        //DEBUG: model::Mesh::Part part(0, indices, 0, model::Mesh::LINE_STRIP);
-        
-        _spotLightMesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(sizeof(part), (gpu::Byte*) &part), gpu::Element::PART_DRAWCALL));
-    }
-    return _spotLightMesh;
-}
-
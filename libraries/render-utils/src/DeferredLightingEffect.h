@@ -23,6 +23,7 @@
 
 #include "render/Context.h"
 
+#include "LightClusters.h"
 #include "LightStage.h"
 
 class RenderArgs;
@@ -65,9 +66,6 @@ private:
     bool _shadowMapEnabled{ false };
     bool _ambientOcclusionEnabled{ false };
 
-    model::MeshPointer _spotLightMesh;
-    model::MeshPointer getSpotLightMesh();
-
     gpu::PipelinePointer _directionalSkyboxLight;
     gpu::PipelinePointer _directionalAmbientSphereLight;
     gpu::PipelinePointer _directionalLight;
@@ -76,8 +74,7 @@ private:
     gpu::PipelinePointer _directionalAmbientSphereLightShadow;
     gpu::PipelinePointer _directionalLightShadow;
 
-    gpu::PipelinePointer _pointLight;
-    gpu::PipelinePointer _spotLight;
+    gpu::PipelinePointer _clusteredLight;
 
     LightLocationsPtr _directionalSkyboxLightLocations;
     LightLocationsPtr _directionalAmbientSphereLightLocations;
@@ -87,8 +84,7 @@ private:
     LightLocationsPtr _directionalAmbientSphereLightShadowLocations;
     LightLocationsPtr _directionalLightShadowLocations;
 
-    LightLocationsPtr _pointLightLocations;
-    LightLocationsPtr _spotLightLocations;
+    LightLocationsPtr _clusteredLightLocations;
 
     using Lights = std::vector<model::LightPointer>;
 
@@ -96,6 +92,7 @@ private:
     std::vector<int> _globalLights;
     std::vector<int> _pointLights;
     std::vector<int> _spotLights;
+    LightClusters _lightClusters[2];
 
     int _ambientLightMode = 0;
     model::SkyboxPointer _skybox;
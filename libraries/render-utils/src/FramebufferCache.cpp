@@ -11,6 +11,7 @@
 
 #include "FramebufferCache.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include <glm/glm.hpp>
@@ -54,6 +55,16 @@ void FramebufferCache::setFrameBufferSize(QSize frameBufferSize) {
     }
 }
 
+glm::ivec4 FramebufferCache::evalRenderViewport(const glm::ivec4& viewport) const {
+    if (_renderScale >= 1.0f) {
+        return viewport;
+    }
+    // the width stays even so that the two halves of a stereo frame stay the same
+    int width = std::max((int)(viewport.z * _renderScale) & ~1, 2);
+    int height = std::max((int)(viewport.w * _renderScale), 1);
+    return glm::ivec4((int)(viewport.x * _renderScale), (int)(viewport.y * _renderScale), width, height);
+}
+
 void FramebufferCache::createPrimaryFramebuffer() {
     _primaryFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
     _deferredFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
@@ -88,11 +99,6 @@ void FramebufferCache::createPrimaryFramebuffer() {
 
     _deferredFramebufferDepthColor->setDepthStencilBuffer(_primaryDepthTexture, depthFormat);
 
-
-    _selfieFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
-    auto tex = gpu::TexturePointer(gpu::Texture::create2D(colorFormat, width * 0.5, height * 0.5, defaultSampler));
-    _selfieFramebuffer->setRenderBuffer(0, tex);
-
     auto smoothSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR);
 
     // FIXME: Decide on the proper one, let s stick to R11G11B10 for now
@@ -102,17 +108,6 @@ void FramebufferCache::createPrimaryFramebuffer() {
     _lightingFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
     _lightingFramebuffer->setRenderBuffer(0, _lightingTexture);
     _lightingFramebuffer->setDepthStencilBuffer(_primaryDepthTexture, depthFormat);
-
-
-    // For AO:
-    auto pointMipSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_POINT);
-    _depthPyramidTexture = gpu::TexturePointer(gpu::Texture::create2D(gpu::Element(gpu::SCALAR, gpu::FLOAT, gpu::RGB), width, height, pointMipSampler));
-    _depthPyramidFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
-    _depthPyramidFramebuffer->setRenderBuffer(0, _depthPyramidTexture);
-    _depthPyramidFramebuffer->setDepthStencilBuffer(_primaryDepthTexture, depthFormat);
-    
-    
-    resizeAmbientOcclusionBuffers();
 }
 
 
@@ -122,22 +117,42 @@ void FramebufferCache::resizeAmbientOcclusionBuffers() {
     _occlusionBlurredFramebuffer.reset();
     _occlusionBlurredTexture.reset();
 
+    auto depthFormat = gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::DEPTH_STENCIL); // Depth24_Stencil8 texel format
+    auto primaryDepthTexture = getPrimaryDepthTexture();
+
+    // the pyramid is at full resolution whatever the level
+    if (!_depthPyramidFramebuffer) {
+        auto pointMipSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_POINT);
+        _depthPyramidTexture = gpu::TexturePointer(gpu::Texture::create2D(gpu::Element(gpu::SCALAR, gpu::FLOAT, gpu::RGB),
+            _frameBufferSize.width(), _frameBufferSize.height(), pointMipSampler));
+        _depthPyramidFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
+        _depthPyramidFramebuffer->setRenderBuffer(0, _depthPyramidTexture);
+        _depthPyramidFramebuffer->setDepthStencilBuffer(primaryDepthTexture, depthFormat);
+    }
 
     auto width = _frameBufferSize.width() >> _AOResolutionLevel;
     auto height = _frameBufferSize.height() >> _AOResolutionLevel;
     auto colorFormat = gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGB);
     auto defaultSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_LINEAR);
-    auto depthFormat = gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::DEPTH_STENCIL); // Depth24_Stencil8 texel format
 
     _occlusionTexture = gpu::TexturePointer(gpu::Texture::create2D(colorFormat, width, height, defaultSampler));
     _occlusionFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
     _occlusionFramebuffer->setRenderBuffer(0, _occlusionTexture);
-    _occlusionFramebuffer->setDepthStencilBuffer(_primaryDepthTexture, depthFormat);
+    _occlusionFramebuffer->setDepthStencilBuffer(primaryDepthTexture, depthFormat);
 
     _occlusionBlurredTexture = gpu::TexturePointer(gpu::Texture::create2D(colorFormat, width, height, defaultSampler));
     _occlusionBlurredFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
     _occlusionBlurredFramebuffer->setRenderBuffer(0, _occlusionBlurredTexture);
-    _occlusionBlurredFramebuffer->setDepthStencilBuffer(_primaryDepthTexture, depthFormat);
+    _occlusionBlurredFramebuffer->setDepthStencilBuffer(primaryDepthTexture, depthFormat);
+}
+
+void FramebufferCache::releaseAmbientOcclusionBuffers() {
+    _depthPyramidFramebuffer.reset();
+    _depthPyramidTexture.reset();
+    _occlusionFramebuffer.reset();
+    _occlusionTexture.reset();
+    _occlusionBlurredFramebuffer.reset();
+    _occlusionBlurredTexture.reset();
 }
 
 gpu::FramebufferPointer FramebufferCache::getPrimaryFramebuffer() {
@@ -227,21 +242,25 @@ void FramebufferCache::releaseFramebuffer(const gpu::FramebufferPointer& framebu
 
 gpu::FramebufferPointer FramebufferCache::getSelfieFramebuffer() {
     if (!_selfieFramebuffer) {
-        createPrimaryFramebuffer();
+        auto defaultSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT);
+        _selfieFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
+        auto tex = gpu::TexturePointer(gpu::Texture::create2D(gpu::Element::COLOR_RGBA_32,
+            _frameBufferSize.width() * 0.5, _frameBufferSize.height() * 0.5, defaultSampler));
+        _selfieFramebuffer->setRenderBuffer(0, tex);
     }
     return _selfieFramebuffer;
 }
 
 gpu::FramebufferPointer FramebufferCache::getDepthPyramidFramebuffer() {
     if (!_depthPyramidFramebuffer) {
-        createPrimaryFramebuffer();
+        resizeAmbientOcclusionBuffers();
     }
     return _depthPyramidFramebuffer;
 }
 
 gpu::TexturePointer FramebufferCache::getDepthPyramidTexture() {
     if (!_depthPyramidTexture) {
-        createPrimaryFramebuffer();
+        resizeAmbientOcclusionBuffers();
     }
     return _depthPyramidTexture;
 }
@@ -251,7 +270,9 @@ void FramebufferCache::setAmbientOcclusionResolutionLevel(int level) {
     level = std::max(0, std::min(level, MAX_AO_RESOLUTION_LEVEL));
     if (level != _AOResolutionLevel) {
         _AOResolutionLevel = level;
-        resizeAmbientOcclusionBuffers();
+        if (_occlusionFramebuffer) {
+            resizeAmbientOcclusionBuffers();
+        }
     }
 }
 
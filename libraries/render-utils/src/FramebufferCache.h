@@ -30,6 +30,14 @@ public:
     void setFrameBufferSize(QSize frameBufferSize);
     const QSize& getFrameBufferSize() const { return _frameBufferSize; } 
 
+    /// Sets the scale of each side of the viewports drawn in the framebuffer objects, they keep their size whatever
+    /// the scale and the frame is upsampled when it's blit
+    void setRenderScale(float scale) { _renderScale = scale; }
+    float getRenderScale() const { return _renderScale; }
+
+    /// Returns the part of a viewport drawn at the render scale
+    glm::ivec4 evalRenderViewport(const glm::ivec4& viewport) const;
+
     /// Returns a pointer to the primary framebuffer object.  This render target includes a depth component, and is
     /// used for scene rendering.
     gpu::FramebufferPointer getPrimaryFramebuffer();
@@ -47,7 +55,9 @@ public:
     gpu::FramebufferPointer getDepthPyramidFramebuffer();
     gpu::TexturePointer getDepthPyramidTexture();
 
+    // the buffers of the ambient occlusion are made on first use, and can be given back while it is off
     void setAmbientOcclusionResolutionLevel(int level);
+    void releaseAmbientOcclusionBuffers();
     gpu::FramebufferPointer getOcclusionFramebuffer();
     gpu::TexturePointer getOcclusionTexture();
     gpu::FramebufferPointer getOcclusionBlurredFramebuffer();
@@ -103,6 +113,7 @@ private:
     gpu::TexturePointer _occlusionBlurredTexture;
 
     QSize _frameBufferSize{ 100, 100 };
+    float _renderScale { 1.0f };
     int _AOResolutionLevel = 1; // AO perform at half res
 
     // Resize/reallocate the buffers used for AO
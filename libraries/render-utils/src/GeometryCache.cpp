@@ -504,11 +504,50 @@ GeometryCache::~GeometryCache() {
     #ifdef WANT_DEBUG
         qCDebug(renderutils) << "GeometryCache::~GeometryCache()... ";
         qCDebug(renderutils) << "    _registeredLine3DVBOs.size():" << _registeredLine3DVBOs.size();
-        qCDebug(renderutils) << "    _line3DVBOs.size():" << _line3DVBOs.size();
         qCDebug(renderutils) << "    BatchItemDetails... population:" << GeometryCache::BatchItemDetails::population;
     #endif //def WANT_DEBUG
 }
 
+static int toCompactColor(const glm::vec4& color) {
+    return ((int(color.x * 255.0f) & 0xFF)) |
+        ((int(color.y * 255.0f) & 0xFF) << 8) |
+        ((int(color.z * 255.0f) & 0xFF) << 16) |
+        ((int(color.w * 255.0f) & 0xFF) << 24);
+}
+
+// the most vertices written to the transient buffers before they are renewed, for applications that don't start frames
+static const int MAX_TRANSIENT_VERTICES = 1 << 16;
+
+void GeometryCache::beginFrame() {
+    // The batches of the frame before keep the buffers they drew from
+    _transientPositions.reset();
+    _transientColors.reset();
+    _transientVertices = 0;
+}
+
+void GeometryCache::renderTransient(gpu::Batch& batch, gpu::Primitive primitive, const glm::vec3* positions,
+                                    const int* colors, int count) {
+    if (!_transientFormat) {
+        _transientFormat = std::make_shared<gpu::Stream::Format>();
+        _transientFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ), 0);
+        _transientFormat->setAttribute(gpu::Stream::COLOR, 1, gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA));
+    }
+    if (!_transientPositions || _transientVertices + count > MAX_TRANSIENT_VERTICES) {
+        _transientPositions = std::make_shared<gpu::Buffer>();
+        _transientColors = std::make_shared<gpu::Buffer>();
+        _transientVertices = 0;
+    }
+
+    _transientPositions->append(count * sizeof(glm::vec3), (const gpu::Byte*)positions);
+    _transientColors->append(count * sizeof(int), (const gpu::Byte*)colors);
+
+    batch.setInputFormat(_transientFormat);
+    batch.setInputBuffer(0, _transientPositions, 0, _transientFormat->getChannels().at(0)._stride);
+    batch.setInputBuffer(1, _transientColors, 0, _transientFormat->getChannels().at(1)._stride);
+    batch.draw(primitive, count, _transientVertices);
+    _transientVertices += count;
+}
+
 void setupBatchInstance(gpu::Batch& batch, gpu::BufferPointer colorBuffer) {
     gpu::BufferView colorView(colorBuffer, COLOR_ELEMENT);
     batch.setInputBuffer(gpu::Stream::COLOR, colorView);
@@ -1052,12 +1091,22 @@ void GeometryCache::renderBevelCornersRect(gpu::Batch& batch, int x, int y, int
 }
 
 void GeometryCache::renderQuad(gpu::Batch& batch, const glm::vec2& minCorner, const glm::vec2& maxCorner, const glm::vec4& color, int id) {
-    bool registered = (id != UNKNOWN_ID);
+    if (id == UNKNOWN_ID) {
+        glm::vec3 positions[] = {
+            glm::vec3(minCorner.x, minCorner.y, 0.0f), glm::vec3(maxCorner.x, minCorner.y, 0.0f),
+            glm::vec3(minCorner.x, maxCorner.y, 0.0f), glm::vec3(maxCorner.x, maxCorner.y, 0.0f)
+        };
+        int compactColor = toCompactColor(color);
+        int colors[] = { compactColor, compactColor, compactColor, compactColor };
+        renderTransient(batch, gpu::TRIANGLE_STRIP, positions, colors, 4);
+        return;
+    }
+
     Vec4Pair key(glm::vec4(minCorner.x, minCorner.y, maxCorner.x, maxCorner.y), color);
-    BatchItemDetails& details = registered ? _registeredQuad2D[id] : _quad2D[key];
+    BatchItemDetails& details = _registeredQuad2D[id];
 
-    // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
-    if (registered && details.isCreated) {
+    // if we have buffers, then check to see if the geometry changed and rebuild if needed
+    if (details.isCreated) {
         Vec4Pair & lastKey = _lastRegisteredQuad2D[id];
         if (lastKey != key) {
             details.clear();
@@ -1214,12 +1263,22 @@ void GeometryCache::renderQuad(gpu::Batch& batch, const glm::vec2& minCorner, co
 }
 
 void GeometryCache::renderQuad(gpu::Batch& batch, const glm::vec3& minCorner, const glm::vec3& maxCorner, const glm::vec4& color, int id) {
-    bool registered = (id != UNKNOWN_ID);
+    if (id == UNKNOWN_ID) {
+        glm::vec3 positions[] = {
+            glm::vec3(minCorner.x, minCorner.y, minCorner.z), glm::vec3(maxCorner.x, minCorner.y, minCorner.z),
+            glm::vec3(minCorner.x, maxCorner.y, maxCorner.z), glm::vec3(maxCorner.x, maxCorner.y, maxCorner.z)
+        };
+        int compactColor = toCompactColor(color);
+        int colors[] = { compactColor, compactColor, compactColor, compactColor };
+        renderTransient(batch, gpu::TRIANGLE_STRIP, positions, colors, 4);
+        return;
+    }
+
     Vec3PairVec4 key(Vec3Pair(minCorner, maxCorner), color);
-    BatchItemDetails& details = registered ? _registeredQuad3D[id] : _quad3D[key];
+    BatchItemDetails& details = _registeredQuad3D[id];
 
-    // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
-    if (registered && details.isCreated) {
+    // if we have buffers, then check to see if the geometry changed and rebuild if needed
+    if (details.isCreated) {
         Vec3PairVec4& lastKey = _lastRegisteredQuad3D[id];
         if (lastKey != key) {
             details.clear();
@@ -1535,11 +1594,16 @@ void GeometryCache::BatchItemDetails::clear() {
 
 void GeometryCache::renderLine(gpu::Batch& batch, const glm::vec3& p1, const glm::vec3& p2, 
                                const glm::vec4& color1, const glm::vec4& color2, int id) {
-                               
-    bool registered = (id != UNKNOWN_ID);
+    if (id == UNKNOWN_ID) {
+        glm::vec3 positions[] = { p1, p2 };
+        int colors[] = { toCompactColor(color1), toCompactColor(color2) };
+        renderTransient(batch, gpu::LINES, positions, colors, 2);
+        return;
+    }
+
     Vec3Pair key(p1, p2);
 
-    BatchItemDetails& details = registered ? _registeredLine3DVBOs[id] : _line3DVBOs[key];
+    BatchItemDetails& details = _registeredLine3DVBOs[id];
 
     int compactColor1 = ((int(color1.x * 255.0f) & 0xFF)) |
                         ((int(color1.y * 255.0f) & 0xFF) << 8) |
@@ -1552,8 +1616,8 @@ void GeometryCache::renderLine(gpu::Batch& batch, const glm::vec3& p1, const glm
                         ((int(color2.w * 255.0f) & 0xFF) << 24);
 
 
-    // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
-    if (registered && details.isCreated) {
+    // if we have buffers, then check to see if the geometry changed and rebuild if needed
+    if (details.isCreated) {
         Vec3Pair& lastKey = _lastRegisteredLine3D[id];
         if (lastKey != key) {
             details.clear();
@@ -1603,11 +1667,7 @@ void GeometryCache::renderLine(gpu::Batch& batch, const glm::vec3& p1, const glm
         details.colorBuffer->append(sizeof(colors), (gpu::Byte*) colors);
 
         #ifdef WANT_DEBUG
-            if (id == UNKNOWN_ID) {
-                qCDebug(renderutils) << "new renderLine() 3D VBO made -- _line3DVBOs.size():" << _line3DVBOs.size();
-            } else {
-                qCDebug(renderutils) << "new registered renderLine() 3D VBO made -- _registeredLine3DVBOs.size():" << _registeredLine3DVBOs.size();
-            }
+            qCDebug(renderutils) << "new registered renderLine() 3D VBO made -- _registeredLine3DVBOs.size():" << _registeredLine3DVBOs.size();
         #endif
     }
 
@@ -1619,11 +1679,16 @@ void GeometryCache::renderLine(gpu::Batch& batch, const glm::vec3& p1, const glm
 
 void GeometryCache::renderLine(gpu::Batch& batch, const glm::vec2& p1, const glm::vec2& p2,                                
                                 const glm::vec4& color1, const glm::vec4& color2, int id) {
-                               
-    bool registered = (id != UNKNOWN_ID);
+    if (id == UNKNOWN_ID) {
+        glm::vec3 positions[] = { glm::vec3(p1, 0.0f), glm::vec3(p2, 0.0f) };
+        int colors[] = { toCompactColor(color1), toCompactColor(color2) };
+        renderTransient(batch, gpu::LINES, positions, colors, 2);
+        return;
+    }
+
     Vec2Pair key(p1, p2);
 
-    BatchItemDetails& details = registered ? _registeredLine2DVBOs[id] : _line2DVBOs[key];
+    BatchItemDetails& details = _registeredLine2DVBOs[id];
 
     int compactColor1 = ((int(color1.x * 255.0f) & 0xFF)) |
                         ((int(color1.y * 255.0f) & 0xFF) << 8) |
@@ -1636,8 +1701,8 @@ void GeometryCache::renderLine(gpu::Batch& batch, const glm::vec2& p1, const glm
                         ((int(color2.w * 255.0f) & 0xFF) << 24);
 
 
-    // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
-    if (registered && details.isCreated) {
+    // if we have buffers, then check to see if the geometry changed and rebuild if needed
+    if (details.isCreated) {
         Vec2Pair& lastKey = _lastRegisteredLine2D[id];
         if (lastKey != key) {
             details.clear();
@@ -1671,7 +1736,7 @@ void GeometryCache::renderLine(gpu::Batch& batch, const glm::vec2& p1, const glm
         details.streamFormat = streamFormat;
         details.stream = stream;
     
-        details.streamFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ), 0);
+        details.streamFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::XYZ), 0);
         details.streamFormat->setAttribute(gpu::Stream::COLOR, 1, gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA));
 
         details.stream->addBuffer(details.verticesBuffer, 0, details.streamFormat->getChannels().at(0)._stride);
@@ -1687,11 +1752,7 @@ void GeometryCache::renderLine(gpu::Batch& batch, const glm::vec2& p1, const glm
         details.colorBuffer->append(sizeof(colors), (gpu::Byte*) colors);
 
         #ifdef WANT_DEBUG
-            if (id == UNKNOWN_ID) {
-                qCDebug(renderutils) << "new renderLine() 2D VBO made -- _line3DVBOs.size():" << _line2DVBOs.size();
-            } else {
-                qCDebug(renderutils) << "new registered renderLine() 2D VBO made -- _registeredLine2DVBOs.size():" << _registeredLine2DVBOs.size();
-            }
+            qCDebug(renderutils) << "new registered renderLine() 2D VBO made -- _registeredLine2DVBOs.size():" << _registeredLine2DVBOs.size();
         #endif
     }
 
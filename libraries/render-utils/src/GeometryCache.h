@@ -263,6 +263,9 @@ public:
     /// Set a batch to the simple pipeline, returning the previous pipeline
     void useSimpleDrawPipeline(gpu::Batch& batch, bool noBlend = false);
 
+    /// Starts the quads and lines drawn without an id over in new buffers, those of the frame before being drawn
+    void beginFrame();
+
     struct ShapeData {
         size_t _indexOffset{ 0 };
         size_t _indexCount{ 0 };
@@ -291,6 +294,15 @@ private:
     virtual ~GeometryCache();
     void buildShapes();
 
+    // The quads and lines drawn without an id have their vertices appended to buffers shared by all of them, and
+    // renewed each frame, rather than buffers of their own kept in hashes of every corner and color ever drawn
+    void renderTransient(gpu::Batch& batch, gpu::Primitive primitive, const glm::vec3* positions, const int* colors,
+                         int count);
+    gpu::Stream::FormatPointer _transientFormat;
+    gpu::BufferPointer _transientPositions;
+    gpu::BufferPointer _transientColors;
+    int _transientVertices { 0 };
+
     typedef QPair<int, int> IntPair;
     typedef QPair<unsigned int, unsigned int> VerticesIndices;
 
@@ -331,11 +343,9 @@ private:
     QHash<int, BatchItemDetails> _registeredQuad2DTextures;
 
     QHash<int, Vec3PairVec4> _lastRegisteredQuad3D;
-    QHash<Vec3PairVec4, BatchItemDetails> _quad3D;
     QHash<int, BatchItemDetails> _registeredQuad3D;
 
     QHash<int, Vec4Pair> _lastRegisteredQuad2D;
-    QHash<Vec4Pair, BatchItemDetails> _quad2D;
     QHash<int, BatchItemDetails> _registeredQuad2D;
 
     QHash<int, Vec3Pair> _lastRegisteredBevelRects;
@@ -343,11 +353,9 @@ private:
     QHash<int, BatchItemDetails> _registeredBevelRects;
 
     QHash<int, Vec3Pair> _lastRegisteredLine3D;
-    QHash<Vec3Pair, BatchItemDetails> _line3DVBOs;
     QHash<int, BatchItemDetails> _registeredLine3DVBOs;
 
     QHash<int, Vec2Pair> _lastRegisteredLine2D;
-    QHash<Vec2Pair, BatchItemDetails> _line2DVBOs;
     QHash<int, BatchItemDetails> _registeredLine2DVBOs;
     
     QHash<int, BatchItemDetails> _registeredVertices;
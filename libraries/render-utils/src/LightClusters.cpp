@@ -0,0 +1,134 @@
+//
+//  LightClusters.cpp
+//  render-utils/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LightClusters.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+
+static const gpu::Element TEXEL_FORMAT { gpu::VEC4, gpu::FLOAT, gpu::RGBA };
+static const gpu::Element INDEX_FORMAT { gpu::SCALAR, gpu::FLOAT, gpu::RGBA };
+
+// The maps are only made again when they have to grow, the rows past the texels are padded with zeros
+template <typename T>
+static void uploadMap(gpu::TexturePointer& map, const gpu::Element& format, int width, std::vector<T>& texels) {
+    int height = std::max((int)((texels.size() + width - 1) / width), 1);
+    if (map && map->getWidth() == width && map->getHeight() >= height) {
+        height = map->getHeight();
+    } else {
+        map = gpu::TexturePointer(gpu::Texture::create2D(format, width, height,
+            gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT, gpu::Sampler::WRAP_CLAMP)));
+    }
+    texels.resize(width * height);
+    map->assignStoredMip(0, format, texels.size() * sizeof(T), (const gpu::Byte*)texels.data());
+}
+
+void LightClusters::update(const Lights& lights, const glm::mat4& projection, const glm::mat4& view, float nearDepth) {
+    _ranges.clear();
+    _lightTexels.clear();
+    _indices.clear();
+
+    // The slices grow with the depth, out to the furthest light
+    float farDepth = 2.0f * nearDepth;
+    for (const auto& light : lights) {
+        float depth = -(view * glm::vec4(light->getPosition(), 1.0f)).z;
+        farDepth = std::max(farDepth, depth + light->getMaximumRadius());
+    }
+    float sliceScale = NUM_SLICES / logf(farDepth / nearDepth);
+    _depthParams = glm::vec4(nearDepth, sliceScale, 0.0f, 0.0f);
+    auto evalSlice = [&](float depth) {
+        return depth <= nearDepth ? 0 : std::min((int)(logf(depth / nearDepth) * sliceScale), NUM_SLICES - 1);
+    };
+    auto evalTile = [](float ndc, int numTiles) {
+        return glm::clamp((int)floorf((ndc * 0.5f + 0.5f) * numTiles), 0, numTiles - 1);
+    };
+
+    // The clusters each light reaches, bound by the box around its sphere
+    for (const auto& light : lights) {
+        glm::vec3 center = glm::vec3(view * glm::vec4(light->getPosition(), 1.0f));
+        float radius = light->getMaximumRadius();
+        float minDepth = -center.z - radius;
+        float maxDepth = -center.z + radius;
+        if (maxDepth <= 0.0f) {
+            continue; // behind the eye
+        }
+
+        Range range;
+        range.light = (int)(_lightTexels.size() / LIGHT_TEXELS);
+        range.min = glm::ivec3(0, 0, evalSlice(minDepth));
+        range.max = glm::ivec3(NUM_TILES_X - 1, NUM_TILES_Y - 1, evalSlice(maxDepth));
+
+        // Past the near plane the box projects to a rectangle of tiles, closer than that it could cover any of them
+        if (minDepth > nearDepth) {
+            glm::vec2 minNDC(FLT_MAX);
+            glm::vec2 maxNDC(-FLT_MAX);
+            const int NUM_BOX_CORNERS = 8;
+            for (int i = 0; i < NUM_BOX_CORNERS; i++) {
+                glm::vec3 corner = center + radius * glm::vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f,
+                    (i & 4) ? 1.0f : -1.0f);
+                glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+                glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                minNDC = glm::min(minNDC, ndc);
+                maxNDC = glm::max(maxNDC, ndc);
+            }
+            if (maxNDC.x < -1.0f || maxNDC.y < -1.0f || minNDC.x > 1.0f || minNDC.y > 1.0f) {
+                continue; // out of the view
+            }
+            range.min.x = evalTile(minNDC.x, NUM_TILES_X);
+            range.min.y = evalTile(minNDC.y, NUM_TILES_Y);
+            range.max.x = evalTile(maxNDC.x, NUM_TILES_X);
+            range.max.y = evalTile(maxNDC.y, NUM_TILES_Y);
+        }
+        _ranges.push_back(range);
+
+        const auto& schema = light->getSchemaBuffer().get<model::Light::Schema>();
+        const glm::vec4* texels = reinterpret_cast<const glm::vec4*>(&schema);
+        _lightTexels.insert(_lightTexels.end(), texels, texels + LIGHT_TEXELS);
+    }
+
+    // Count the lights of each cluster, lay their indices out one cluster after the other, then fill them in
+    _clusterTexels.assign(NUM_CLUSTERS, glm::vec4(0.0f));
+    auto forEachCluster = [&](const Range& range, std::function<void(glm::vec4& cluster)> function) {
+        for (int z = range.min.z; z <= range.max.z; z++) {
+            for (int y = range.min.y; y <= range.max.y; y++) {
+                for (int x = range.min.x; x <= range.max.x; x++) {
+                    function(_clusterTexels[(z * NUM_TILES_Y + y) * NUM_TILES_X + x]);
+                }
+            }
+        }
+    };
+    for (const auto& range : _ranges) {
+        forEachCluster(range, [](glm::vec4& cluster) { cluster.y++; });
+    }
+    float offset = 0.0f;
+    for (auto& cluster : _clusterTexels) {
+        cluster.x = offset;
+        offset += cluster.y;
+        cluster.y = 0.0f;
+    }
+    _indices.resize((size_t)offset);
+    for (const auto& range : _ranges) {
+        forEachCluster(range, [&](glm::vec4& cluster) {
+            _indices[(size_t)(cluster.x + cluster.y)] = (float)range.light;
+            cluster.y++;
+        });
+    }
+
+    if (_indices.empty()) {
+        return;
+    }
+    uploadMap(_lightsMap, TEXEL_FORMAT, LIGHT_TEXELS, _lightTexels);
+    uploadMap(_clustersMap, TEXEL_FORMAT, NUM_TILES_X * NUM_TILES_Y, _clusterTexels);
+    size_t numIndices = _indices.size();
+    uploadMap(_indicesMap, INDEX_FORMAT, INDICES_MAP_WIDTH, _indices);
+    _indices.resize(numIndices);
+}
@@ -0,0 +1,68 @@
+//
+//  LightClusters.h
+//  render-utils/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_utils_LightClusters_h
+#define hifi_render_utils_LightClusters_h
+
+#include <vector>
+
+#include <gpu/Texture.h>
+
+#include "model/Light.h"
+
+// Bins the point and spot lights of a frame in the clusters of a view, the cells of a grid over the screen split in
+// slices of depth, so that the lighting pass of a pixel only goes through the lights that can reach its cluster.
+// The lights, the clusters (the offset and the count of their lights in the indices) and the indices are in float
+// textures to be fetched by clustered_light.slf
+class LightClusters {
+public:
+    // must be the same as in clustered_light.slf
+    static const int NUM_TILES_X = 16;
+    static const int NUM_TILES_Y = 8;
+    static const int NUM_SLICES = 16;
+    static const int NUM_CLUSTERS = NUM_TILES_X * NUM_TILES_Y * NUM_SLICES;
+    static const int INDICES_MAP_WIDTH = 1024;
+    static const int LIGHT_TEXELS = sizeof(model::Light::Schema) / sizeof(glm::vec4);
+
+    using Lights = std::vector<model::LightPointer>;
+
+    /// The view is given by its projection and its matrix from world to eye space, the slices go from nearDepth out to
+    /// the furthest light
+    void update(const Lights& lights, const glm::mat4& projection, const glm::mat4& view, float nearDepth);
+
+    int getNumIndices() const { return (int)_indices.size(); }
+
+    /// The near depth of the slices and the scale from the log of a depth to its slice
+    const glm::vec4& getDepthParams() const { return _depthParams; }
+
+    const gpu::TexturePointer& getLightsMap() const { return _lightsMap; }
+    const gpu::TexturePointer& getClustersMap() const { return _clustersMap; }
+    const gpu::TexturePointer& getIndicesMap() const { return _indicesMap; }
+
+protected:
+    class Range {
+    public:
+        int light;
+        glm::ivec3 min;
+        glm::ivec3 max;
+    };
+
+    std::vector<Range> _ranges;
+    std::vector<glm::vec4> _lightTexels;
+    std::vector<glm::vec4> _clusterTexels;
+    std::vector<float> _indices;
+    glm::vec4 _depthParams;
+
+    gpu::TexturePointer _lightsMap;
+    gpu::TexturePointer _clustersMap;
+    gpu::TexturePointer _indicesMap;
+};
+
+#endif // hifi_render_utils_LightClusters_h
@@ -13,9 +13,25 @@
 
 #include "LightStage.h"
 
-LightStage::Shadow::Shadow(model::LightPointer light) : _light{ light}, _frustum{ std::make_shared<ViewFrustum>() } {
-    framebuffer = gpu::FramebufferPointer(gpu::Framebuffer::createShadowmap(MAP_SIZE));
+// How the cascades are split, from evenly (0) to logarithmically (1) which keeps more texels for the closest ones
+static const float CASCADE_SPLIT_LAMBDA = 0.75f;
+
+// A cascade moves by steps of this fraction of its size, so that it stays the same while the view moves a bit
+static const float CASCADE_SNAP_FRACTION = 1.0f / 8.0f;
+
+// The size of a cascade only changes by steps of this much, so that it doesn't follow the rounding errors
+static const float CASCADE_RADIUS_STEP = 1.0f / 16.0f;
+
+// How far past the view, toward the light, the casters can be
+static const float SHADOW_CASTER_DISTANCE = 50.0f;
+
+LightStage::Shadow::Shadow(model::LightPointer light) : _light{ light} {
+    framebuffer = gpu::FramebufferPointer(gpu::Framebuffer::createShadowmap(MAP_SIZE * NUM_CASCADES, MAP_SIZE));
     map = framebuffer->getDepthStencilBuffer();
+    for (int i = 0; i < NUM_CASCADES; i++) {
+        _cascades[i].frustum = std::make_shared<ViewFrustum>();
+        _cascades[i].viewport = glm::ivec4(i * MAP_SIZE, 0, MAP_SIZE, MAP_SIZE);
+    }
     Schema schema;
     _schemaBuffer = std::make_shared<gpu::Buffer>(sizeof(Schema), (const gpu::Byte*) &schema);
 }
@@ -35,57 +51,75 @@ void LightStage::Shadow::setKeylightFrustum(ViewFrustum* viewFrustum, float near
         auto up = glm::normalize(glm::cross(side, direction));
         orientation = glm::quat_cast(glm::mat3(side, up, -direction));
     }
-    _frustum->setOrientation(orientation);
 
-    // Position the keylight frustum
-    _frustum->setPosition(viewFrustum->getPosition() - (nearDepth + farDepth)*direction);
+    viewFrustum->calculate();
 
-    const Transform view{ _frustum->getView()};
-    const Transform viewInverse{ view.getInverseMatrix() };
+    // The logarithmic split needs a near depth in front of the eye
+    float logNearDepth = glm::max(nearDepth, viewFrustum->getNearClip());
+    float cascadeNearDepth = nearDepth;
+    auto& schema = _schemaBuffer.edit<Schema>();
+    for (int i = 0; i < NUM_CASCADES; i++) {
+        float cascadeFarDepth = farDepth;
+        if (i < NUM_CASCADES - 1) {
+            float ratio = (float)(i + 1) / NUM_CASCADES;
+            float evenDepth = nearDepth + (farDepth - nearDepth) * ratio;
+            float logDepth = logNearDepth * powf(farDepth / logNearDepth, ratio);
+            cascadeFarDepth = glm::mix(evenDepth, logDepth, CASCADE_SPLIT_LAMBDA);
+        }
+
+        auto& cascade = _cascades[i];
+        setCascadeFrustum(cascade, orientation, viewFrustum, cascadeNearDepth, cascadeFarDepth);
+
+        const glm::mat4 biasMatrix(
+            0.5f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.5f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.5f, 0.0f,
+            0.5f, 0.5f, 0.5f, 1.0f);
+        schema.reprojections[i] = biasMatrix * cascade.frustum->getProjection() * glm::inverse(cascade.frustum->getView());
+        schema.cascadeEnds[i] = cascadeFarDepth;
+
+        cascadeNearDepth = cascadeFarDepth;
+    }
+}
 
-    viewFrustum->calculate();
+void LightStage::Shadow::setCascadeFrustum(Cascade& cascade, const glm::quat& orientation, ViewFrustum* viewFrustum,
+                                           float nearDepth, float farDepth) {
     auto nearCorners = viewFrustum->getCorners(nearDepth);
     auto farCorners = viewFrustum->getCorners(farDepth);
-
-    vec3 min{ viewInverse.transform(nearCorners.bottomLeft) };
-    vec3 max{ min };
-    // Expand keylight frustum  to fit view frustum
-    auto fitFrustum = [&min, &max, &viewInverse](const vec3& viewCorner) {
-        const auto corner = viewInverse.transform(viewCorner);
-
-        min.x = glm::min(min.x, corner.x);
-        min.y = glm::min(min.y, corner.y);
-        min.z = glm::min(min.z, corner.z);
-
-        max.x = glm::max(max.x, corner.x);
-        max.y = glm::max(max.y, corner.y);
-        max.z = glm::max(max.z, corner.z);
+    const vec3 corners[] = {
+        nearCorners.topLeft, nearCorners.topRight, nearCorners.bottomLeft, nearCorners.bottomRight,
+        farCorners.topLeft, farCorners.topRight, farCorners.bottomLeft, farCorners.bottomRight
     };
-    fitFrustum(nearCorners.bottomRight);
-    fitFrustum(nearCorners.topLeft);
-    fitFrustum(nearCorners.topRight);
-    fitFrustum(farCorners.bottomLeft);
-    fitFrustum(farCorners.bottomRight);
-    fitFrustum(farCorners.topLeft);
-    fitFrustum(farCorners.topRight);
 
-    glm::mat4 ortho = glm::ortho<float>(min.x, max.x, min.y, max.y, -max.z, -min.z);
-    _frustum->setProjection(ortho);
+    // Fit the cascade around the bounding sphere of the view slice, which doesn't change as the view turns
+    vec3 center { 0.0f };
+    for (const auto& corner : corners) {
+        center += corner;
+    }
+    center /= (float)(sizeof(corners) / sizeof(corners[0]));
+    float radius = 0.0f;
+    for (const auto& corner : corners) {
+        radius = glm::max(radius, glm::distance(corner, center));
+    }
+    radius = ceilf(radius / CASCADE_RADIUS_STEP) * CASCADE_RADIUS_STEP;
+
+    // Snap the center in the light plane to steps of whole texels, and make the cascade bigger by half a step
+    // to keep the sphere in it wherever it got snapped
+    float halfSize = radius / (1.0f - CASCADE_SNAP_FRACTION);
+    float snap = 2.0f * halfSize * CASCADE_SNAP_FRACTION;
+    vec3 lightCenter = glm::inverse(orientation) * center;
+    lightCenter = glm::floor(lightCenter / snap + 0.5f) * snap;
+    center = orientation * lightCenter;
+
+    const vec3 direction = orientation * vec3(0.0f, 0.0f, -1.0f);
+    float depth = 2.0f * halfSize + SHADOW_CASTER_DISTANCE;
+    cascade.frustum->setOrientation(orientation);
+    cascade.frustum->setPosition(center - (halfSize + SHADOW_CASTER_DISTANCE) * direction);
+    cascade.frustum->setProjection(glm::ortho<float>(-halfSize, halfSize, -halfSize, halfSize, 0.0f, depth));
 
     // Calculate the frustum's internal state
-    _frustum->calculate();
-
-    // Update the buffer
-    _schemaBuffer.edit<Schema>().projection = ortho;
-    _schemaBuffer.edit<Schema>().viewInverse = viewInverse.getMatrix();
-}
-
-const glm::mat4& LightStage::Shadow::getView() const {
-    return _frustum->getView();
-}
-
-const glm::mat4& LightStage::Shadow::getProjection() const {
-    return _frustum->getProjection();
+    cascade.frustum->calculate();
+    cascade.farDepth = farDepth;
 }
 
 const LightStage::LightPointer LightStage::addLight(model::LightPointer light) {
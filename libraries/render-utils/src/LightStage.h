@@ -12,6 +12,8 @@
 #ifndef hifi_render_utils_LightStage_h
 #define hifi_render_utils_LightStage_h
 
+#include <array>
+
 #include "gpu/Framebuffer.h"
 
 #include "model/Light.h"
@@ -26,14 +28,22 @@ public:
         using UniformBufferView = gpu::BufferView;
         static const int MAP_SIZE = 1024;
 
+        // The view is split in depth into cascades, each with its own MAP_SIZE square of the shadow map,
+        // from the closest one on the left to the furthest on the right
+        static const int NUM_CASCADES = 3;
+
+        class Cascade {
+        public:
+            std::shared_ptr<ViewFrustum> frustum;
+            glm::ivec4 viewport;
+            float farDepth { 0.0f };
+        };
+
         Shadow(model::LightPointer light);
 
         void setKeylightFrustum(ViewFrustum* viewFrustum, float nearDepth, float farDepth);
 
-        const std::shared_ptr<ViewFrustum> getFrustum() const { return _frustum; }
-
-        const glm::mat4& getView() const;
-        const glm::mat4& getProjection() const;
+        const Cascade& getCascade(int index) const { return _cascades[index]; }
 
         const UniformBufferView& getBuffer() const { return _schemaBuffer; }
 
@@ -41,15 +51,22 @@ public:
         gpu::TexturePointer map;
     protected:
         model::LightPointer _light;
-        std::shared_ptr<ViewFrustum> _frustum;
+        std::array<Cascade, NUM_CASCADES> _cascades;
+
+        void setCascadeFrustum(Cascade& cascade, const glm::quat& orientation, ViewFrustum* viewFrustum,
+                               float nearDepth, float farDepth);
 
         class Schema {
         public:
-            glm::mat4 projection;
-            glm::mat4 viewInverse;
+            // From world to the shadow map coordinates of each cascade, in [0, 1]
+            glm::mat4 reprojections[NUM_CASCADES];
+            // The eye depths at which the cascades end
+            glm::vec4 cascadeEnds;
 
             glm::float32 bias = 0.005f;
-            glm::float32 scale = 1 / MAP_SIZE;
+            glm::float32 scale = 1.0f / MAP_SIZE;
+            glm::float32 spare0;
+            glm::float32 spare1;
         };
         UniformBufferView _schemaBuffer = nullptr;
     };
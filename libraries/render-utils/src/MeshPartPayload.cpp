@@ -12,12 +12,18 @@
 #include "MeshPartPayload.h"
 
 #include <PerfStat.h>
+#include <ViewFrustum.h>
 
 #include "DeferredLightingEffect.h"
 #include "Model.h"
 
 using namespace render;
 
+// the levels of detail switch a little past a pixel of error either way, so that a part about as far as a switch
+// doesn't flicker between two of them
+static const float LOD_PIXEL_ERROR = 1.0f;
+static const float LOD_HYSTERESIS = 0.2f;
+
 namespace render {
 template <> const ItemKey payloadGetKey(const MeshPartPayload::Pointer& payload) {
     if (payload) {
@@ -54,6 +60,8 @@ MeshPartPayload::MeshPartPayload(model::MeshPointer mesh, int partIndex, model::
 
 void MeshPartPayload::updateMeshPart(model::MeshPointer drawMesh, int partIndex) {
     _drawMesh = drawMesh;
+    _partIndex = partIndex;
+    _lod = 0;
     if (_drawMesh) {
         auto vertexFormat = _drawMesh->getVertexFormat();
         _hasColorAttrib = vertexFormat->hasAttribute(gpu::Stream::COLOR);
@@ -79,6 +87,9 @@ ItemKey MeshPartPayload::getKey() const {
     ItemKey::Builder builder;
     builder.withTypeShape();
 
+    // the bound only moves with updateTransform
+    builder.withSpatiallyIndexed();
+
     if (_drawMaterial) {
         auto matKey = _drawMaterial->getKey();
         if (matKey.isTransparent() || matKey.isTransparentMap()) {
@@ -116,7 +127,8 @@ ShapeKey MeshPartPayload::getShapeKey() const {
 }
 
 void MeshPartPayload::drawCall(gpu::Batch& batch) const {
-    batch.drawIndexed(gpu::TRIANGLES, _drawPart._numIndices, _drawPart._startIndex);
+    const auto& part = getLODPart();
+    batch.drawIndexed(gpu::TRIANGLES, part._numIndices, part._startIndex);
 }
 
 void MeshPartPayload::bindMesh(gpu::Batch& batch) const {
@@ -219,6 +231,69 @@ void MeshPartPayload::bindTransform(gpu::Batch& batch, const ShapePipeline::Loca
     batch.setModelTransform(_drawTransform);
 }
 
+void MeshPartPayload::requestTextureMips(RenderArgs* args) const {
+    if (!_drawMaterial || !args->_viewFrustum || args->_renderMode == RenderArgs::SHADOW_RENDER_MODE) {
+        return;
+    }
+
+    // the pixels the part spans on screen, taking its textures to be mapped over it once
+    auto bound = getBound();
+    float radius = 0.5f * glm::length(bound.getDimensions());
+    float distance = std::max(glm::distance(args->_viewFrustum->getPosition(), bound.calcCenter()), radius);
+    float pixelsPerRadian = args->_viewport.w / glm::radians(args->_viewFrustum->getFieldOfView());
+    float pixels = std::max(2.0f * radius / distance * pixelsPerRadian, 1.0f);
+
+    for (auto& textureMap : _drawMaterial->getTextureMaps()) {
+        if (textureMap.second && textureMap.second->isDefined()) {
+            auto texture = textureMap.second->getTextureView()._texture;
+            if (texture && texture->isStreamable()) {
+                float texels = (float)std::max(texture->getWidth(), texture->getHeight());
+                float mip = glm::clamp(log2f(texels / pixels), 0.0f, (float)texture->maxMip());
+                texture->requestMip((uint16)mip);
+            }
+        }
+    }
+}
+
+void MeshPartPayload::updateLOD(RenderArgs* args) const {
+    int numLODs = _drawMesh ? _drawMesh->getNumLODs() : 0;
+    if (numLODs == 0 || !args->_viewFrustum) {
+        _lod = 0;
+        return;
+    }
+    if (args->_renderMode == RenderArgs::SHADOW_RENDER_MODE) {
+        // the shadow goes with the part as the view sees it
+        return;
+    }
+
+    // the errors are in the units of the mesh, the bounds tell how much the mesh is scaled in the world
+    auto bound = getBound();
+    float worldSize = glm::length(bound.getDimensions());
+    float localSize = glm::length(_localBound.getDimensions());
+    float scale = (localSize > 0.0f) ? worldSize / localSize : 1.0f;
+    float distance = std::max(glm::distance(args->_viewFrustum->getPosition(), bound.calcCenter()) - 0.5f * worldSize,
+                              args->_viewFrustum->getNearClip());
+    float pixelsPerUnit = args->_viewport.w / glm::radians(args->_viewFrustum->getFieldOfView()) / distance;
+    auto getPixelError = [&](int lod) {
+        return (lod == 0) ? 0.0f : _drawMesh->getLODError(lod) * scale * pixelsPerUnit;
+    };
+
+    int lod = std::min(_lod, numLODs);
+    while (lod > 0 && getPixelError(lod) > LOD_PIXEL_ERROR * (1.0f + LOD_HYSTERESIS)) {
+        lod--;
+    }
+    while (lod < numLODs && getPixelError(lod + 1) < LOD_PIXEL_ERROR * (1.0f - LOD_HYSTERESIS)) {
+        lod++;
+    }
+    _lod = lod;
+}
+
+const model::Mesh::Part& MeshPartPayload::getLODPart() const {
+    if (_lod == 0 || !_drawMesh || _lod > _drawMesh->getNumLODs()) {
+        return _drawPart;
+    }
+    return _drawMesh->getLODPart(_lod, _partIndex);
+}
 
 void MeshPartPayload::render(RenderArgs* args) const {
     PerformanceTimer perfTimer("MeshPartPayload::render");
@@ -238,13 +313,15 @@ void MeshPartPayload::render(RenderArgs* args) const {
 
     // apply material properties
     bindMaterial(batch, locations);
+    requestTextureMips(args);
+    updateLOD(args);
 
 
     // TODO: We should be able to do that just in the renderTransparentJob
     if (key.isTranslucent() && locations->lightBufferUnit >= 0) {
         PerformanceTimer perfTimer("DLE->setupTransparent()");
 
-        DependencyManager::get<DeferredLightingEffect>()->setupTransparent(args, locations->lightBufferUnit);
+        DependencyManager::borrow<DeferredLightingEffect>()->setupTransparent(args, locations->lightBufferUnit);
     }
     if (args) {
         args->_details._materialSwitches++;
@@ -258,7 +335,7 @@ void MeshPartPayload::render(RenderArgs* args) const {
 
     if (args) {
         const int INDICES_PER_TRIANGLE = 3;
-        args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
+        args->_details._trianglesRendered += getLODPart()._numIndices / INDICES_PER_TRIANGLE;
     }
 }
 
@@ -284,6 +361,10 @@ template <> const ShapeKey shapeGetShapeKey(const ModelMeshPartPayload::Pointer&
     return ShapeKey::Builder::invalid();
 }
 
+template <> void payloadPrepare(const ModelMeshPartPayload::Pointer& payload, RenderArgs* args) {
+    return payload->prepare(args);
+}
+
 template <> void payloadRender(const ModelMeshPartPayload::Pointer& payload, RenderArgs* args) {
     return payload->render(args);
 }
@@ -343,6 +424,12 @@ ItemKey ModelMeshPartPayload::getKey() const {
         }
     }
 
+    // the model's cluster matrices get updated in prepare, the rest of render only reads the model
+    builder.withThreadSafe();
+
+    // the bound follows the model, which updates the item when it moves, scales or gets a new offset
+    builder.withSpatiallyIndexed();
+
     return builder.build();
 }
 
@@ -447,11 +534,13 @@ void ModelMeshPartPayload::bindTransform(gpu::Batch& batch, const ShapePipeline:
     const Model::MeshState& state = _model->_meshStates.at(_meshIndex);
 
     Transform transform;
-    if (state.clusterBuffer) {
+    if (state.clusterBufferSize > 0 && _model->_clusterBuffer) {
         if (canCauterize && _model->getCauterizeBones()) {
-            batch.setUniformBuffer(ShapePipeline::Slot::SKINNING_GPU, state.cauterizedClusterBuffer);
+            batch.setUniformBuffer(ShapePipeline::Slot::SKINNING_GPU, _model->_cauterizedClusterBuffer,
+                                   state.clusterBufferOffset, state.clusterBufferSize);
         } else {
-            batch.setUniformBuffer(ShapePipeline::Slot::SKINNING_GPU, state.clusterBuffer);
+            batch.setUniformBuffer(ShapePipeline::Slot::SKINNING_GPU, _model->_clusterBuffer,
+                                   state.clusterBufferOffset, state.clusterBufferSize);
         }
     } else {
         if (canCauterize && _model->getCauterizeBones()) {
@@ -466,6 +555,36 @@ void ModelMeshPartPayload::bindTransform(gpu::Batch& batch, const ShapePipeline:
 }
 
 
+bool ModelMeshPartPayload::canBeInstanced(const ShapeKey& key, bool canCauterize) const {
+    // the skinned and blended parts have vertices of their own, the translucent ones have to draw in order
+    const Model::MeshState& state = _model->_meshStates.at(_meshIndex);
+    return !_isBlendShaped && !key.isTranslucent() && state.clusterBufferSize == 0 &&
+        !(canCauterize && _model->getCauterizeBones());
+}
+
+void ModelMeshPartPayload::renderInstance(gpu::Batch& batch, const ShapePipelinePointer& pipeline) const {
+    // the instances share the mesh, the part, the material and the pipeline, each has the transform it was set up with
+    const auto& part = getLODPart();
+    std::string name = "ModelMeshPart:" + std::to_string((uintptr_t)pipeline.get()) + ":" +
+        std::to_string((uintptr_t)_drawMesh.get()) + ":" + std::to_string((uintptr_t)_drawMaterial.get()) + ":" +
+        std::to_string(part._startIndex) + ":" + std::to_string(part._numIndices);
+
+    // the batch is rendered by the job recording it, while the payload is still in the scene
+    batch.setupNamedCalls(name, [this, pipeline, part](gpu::Batch& batch, gpu::Batch::NamedBatchData& data) {
+        pipeline->prepare(batch);
+        bindMesh(batch);
+        bindMaterial(batch, pipeline->locations);
+        batch.drawIndexedInstanced((gpu::uint32)data.count(), gpu::TRIANGLES, part._numIndices, part._startIndex);
+    });
+}
+
+void ModelMeshPartPayload::prepare(RenderArgs* args) const {
+    if (!_model->_readyWhenAdded || !_model->_isVisible || !getShapeKey().isValid()) {
+        return;
+    }
+    _model->updateClusterMatrices(_transform.getTranslation(), _transform.getRotation());
+}
+
 void ModelMeshPartPayload::render(RenderArgs* args) const {
     PerformanceTimer perfTimer("ModelMeshPartPayload::render");
 
@@ -499,7 +618,7 @@ void ModelMeshPartPayload::render(RenderArgs* args) const {
         transform.setTranslation(partBounds.calcCenter());
         transform.setScale(partBounds.getDimensions());
         batch.setModelTransform(transform);
-        DependencyManager::get<GeometryCache>()->renderWireCube(batch, 1.0f, cubeColor);
+        DependencyManager::borrow<GeometryCache>()->renderWireCube(batch, 1.0f, cubeColor);
     }
 #endif //def DEBUG_BOUNDING_PARTS
     
@@ -511,32 +630,39 @@ void ModelMeshPartPayload::render(RenderArgs* args) const {
     _model->updateClusterMatrices(_transform.getTranslation(), _transform.getRotation());
     bindTransform(batch, locations, canCauterize);
     
-    //Bind the index buffer and vertex buffer and Blend shapes if needed
-    bindMesh(batch);
-    
-    // apply material properties
-    bindMaterial(batch, locations);
-        
-        
-    // TODO: We should be able to do that just in the renderTransparentJob
-    if (key.isTranslucent() && locations->lightBufferUnit >= 0) {
-        PerformanceTimer perfTimer("DLE->setupTransparent()");
-            
-        DependencyManager::get<DeferredLightingEffect>()->setupTransparent(args, locations->lightBufferUnit);
-    }
-    if (args) {
-        args->_details._materialSwitches++;
-    }
-    
-    // Draw!
-    {
-        PerformanceTimer perfTimer("batch.drawIndexed()");
-        drawCall(batch);
+    requestTextureMips(args);
+    updateLOD(args);
+
+    if (canBeInstanced(key, canCauterize)) {
+        renderInstance(batch, args->_pipeline);
+
+    } else {
+        //Bind the index buffer and vertex buffer and Blend shapes if needed
+        bindMesh(batch);
+
+        // apply material properties
+        bindMaterial(batch, locations);
+
+        // TODO: We should be able to do that just in the renderTransparentJob
+        if (key.isTranslucent() && locations->lightBufferUnit >= 0) {
+            PerformanceTimer perfTimer("DLE->setupTransparent()");
+
+            DependencyManager::borrow<DeferredLightingEffect>()->setupTransparent(args, locations->lightBufferUnit);
+        }
+        if (args) {
+            args->_details._materialSwitches++;
+        }
+
+        // Draw!
+        {
+            PerformanceTimer perfTimer("batch.drawIndexed()");
+            drawCall(batch);
+        }
     }
     
     if (args) {
         const int INDICES_PER_TRIANGLE = 3;
-        args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
+        args->_details._trianglesRendered += getLODPart()._numIndices / INDICES_PER_TRIANGLE;
     }
 }
 
@@ -48,10 +48,18 @@ public:
     virtual void bindMaterial(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations) const;
     virtual void bindTransform(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations, bool canCauterize = true) const;
 
+    // asks the streamed textures of the material for the mips the part is seen at
+    void requestTextureMips(RenderArgs* args) const;
+
+    // picks the coarsest level of detail of the part that is less than a pixel off on screen
+    void updateLOD(RenderArgs* args) const;
+    const model::Mesh::Part& getLODPart() const;
+
     // Payload resource cached values
     model::MeshPointer _drawMesh;
     int _partIndex = 0;
     model::Mesh::Part _drawPart;
+    mutable int _lod = 0;
 
     model::MaterialPointer _drawMaterial;
     
@@ -86,10 +94,17 @@ public:
     render::ShapeKey getShapeKey() const override; // shape interface
     void render(RenderArgs* args) const override;
 
+    // updates what the parts of the model share, which render then only reads on whichever thread it runs
+    void prepare(RenderArgs* args) const;
+
     // ModelMeshPartPayload functions to perform render
     void bindMesh(gpu::Batch& batch) const override;
     void bindTransform(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations, bool canCauterize) const override;
 
+    // the opaque parts that aren't skinned or blended can draw as instances of the ones sharing their mesh and material
+    bool canBeInstanced(const render::ShapeKey& key, bool canCauterize) const;
+    void renderInstance(gpu::Batch& batch, const render::ShapePipelinePointer& pipeline) const;
+
     void initCache();
 
     Model* _model;
@@ -101,4 +116,12 @@ public:
     bool _isBlendShaped{ false };
 };
 
+namespace render {
+    template <> const ItemKey payloadGetKey(const ModelMeshPartPayload::Pointer& payload);
+    template <> const Item::Bound payloadGetBound(const ModelMeshPartPayload::Pointer& payload);
+    template <> const ShapeKey shapeGetShapeKey(const ModelMeshPartPayload::Pointer& payload);
+    template <> void payloadPrepare(const ModelMeshPartPayload::Pointer& payload, RenderArgs* args);
+    template <> void payloadRender(const ModelMeshPartPayload::Pointer& payload, RenderArgs* args);
+}
+
 #endif // hifi_MeshPartPayload_h
@@ -17,6 +17,7 @@
 #include <glm/gtx/norm.hpp>
 
 #include <GeometryUtil.h>
+#include <MatrixKernels.h>
 #include <PathUtils.h>
 #include <PerfStat.h>
 #include <ViewFrustum.h>
@@ -101,11 +102,13 @@ void Model::setScaleInternal(const glm::vec3& scale) {
             assert(false);
         }
         initJointTransforms();
+        enqueueLocationChange();
     }
 }
 
 void Model::setOffset(const glm::vec3& offset) {
     _offset = offset;
+    enqueueLocationChange();
 
     // if someone manually sets our offset, then we are no longer snapped to center
     _snapModelToRegistrationPoint = false;
@@ -944,6 +947,7 @@ void Model::snapToRegistrationPoint() {
     glm::vec3 offset = -modelMeshExtents.minimum - (dimensions * _registrationPoint);
     _offset = offset;
     _snappedToRegistrationPoint = true;
+    enqueueLocationChange();
 }
 
 void Model::simulate(float deltaTime, bool fullUpdate) {
@@ -996,50 +1000,42 @@ void Model::updateClusterMatrices(glm::vec3 modelPosition, glm::quat modelOrient
         glm::vec4(0.0f, 0.0f, 0.0f, 0.0f),
         glm::vec4(0.0f, 0.0f, 0.0f, 0.0f),
         glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
-    auto cauterizeMatrix = _rig->getJointTransform(geometry.neckJointIndex) * zeroScale;
 
+    // each joint goes to the world once, however many clusters of however many meshes it moves
     glm::mat4 modelToWorld = glm::mat4_cast(modelOrientation);
+    int numJoints = _rig->getJointStateCount();
+    _jointMatrices.resize(numJoints);
+    for (int i = 0; i < numJoints; i++) {
+        _jointMatrices[i] = _rig->getJointTransform(i);
+    }
+    MatrixKernels::multiply(modelToWorld, _jointMatrices.data(), _jointMatrices.data(), numJoints);
+    auto getJointMatrix = [&](int jointIndex) {
+        return (jointIndex >= 0 && jointIndex < numJoints) ? _jointMatrices[jointIndex] : modelToWorld;
+    };
+    auto cauterizeMatrix = getJointMatrix(geometry.neckJointIndex) * zeroScale;
+
     for (int i = 0; i < _meshStates.size(); i++) {
         MeshState& state = _meshStates[i];
         const FBXMesh& mesh = geometry.meshes.at(i);
 
         for (int j = 0; j < mesh.clusters.size(); j++) {
             const FBXCluster& cluster = mesh.clusters.at(j);
-            auto jointMatrix = _rig->getJointTransform(cluster.jointIndex);
-            state.clusterMatrices[j] = modelToWorld * jointMatrix * cluster.inverseBindMatrix;
+            glm::mat4 jointMatrix = getJointMatrix(cluster.jointIndex);
+            MatrixKernels::multiply(jointMatrix, &cluster.inverseBindMatrix, &state.clusterMatrices[j], 1);
 
             // as an optimization, don't build cautrizedClusterMatrices if the boneSet is empty.
             if (!_cauterizeBoneSet.empty()) {
                 if (_cauterizeBoneSet.find(cluster.jointIndex) != _cauterizeBoneSet.end()) {
                     jointMatrix = cauterizeMatrix;
                 }
-                state.cauterizedClusterMatrices[j] = modelToWorld * jointMatrix * cluster.inverseBindMatrix;
-            }
-        }
-
-        // Once computed the cluster matrices, update the buffer(s)
-        if (mesh.clusters.size() > 1) {
-            if (!state.clusterBuffer) {
-                state.clusterBuffer = std::make_shared<gpu::Buffer>(state.clusterMatrices.size() * sizeof(glm::mat4),
-                                                                    (const gpu::Byte*) state.clusterMatrices.constData());
-            } else {
-                state.clusterBuffer->setSubData(0, state.clusterMatrices.size() * sizeof(glm::mat4),
-                                                (const gpu::Byte*) state.clusterMatrices.constData());
-            }
-
-            if (!_cauterizeBoneSet.empty() && (state.cauterizedClusterMatrices.size() > 1)) {
-                if (!state.cauterizedClusterBuffer) {
-                    state.cauterizedClusterBuffer =
-                        std::make_shared<gpu::Buffer>(state.cauterizedClusterMatrices.size() * sizeof(glm::mat4),
-                                                      (const gpu::Byte*) state.cauterizedClusterMatrices.constData());
-                } else {
-                    state.cauterizedClusterBuffer->setSubData(0, state.cauterizedClusterMatrices.size() * sizeof(glm::mat4),
-                                                              (const gpu::Byte*) state.cauterizedClusterMatrices.constData());
-                }
+                MatrixKernels::multiply(jointMatrix, &cluster.inverseBindMatrix, &state.cauterizedClusterMatrices[j], 1);
             }
         }
     }
 
+    // Once computed the cluster matrices, update the buffer(s)
+    updateClusterBuffers();
+
     // post the blender if we're not currently waiting for one to finish
     if (geometry.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
         _blendedBlendshapeCoefficients = _blendshapeCoefficients;
@@ -1047,6 +1043,46 @@ void Model::updateClusterMatrices(glm::vec3 modelPosition, glm::quat modelOrient
     }
 }
 
+void Model::updateClusterBuffers() {
+    // each mesh's clusters start where a uniform buffer range can be bound, which is at most every 256 bytes
+    const size_t CLUSTER_BUFFER_ALIGNMENT = 256;
+    const int ROWS_PER_CLUSTER = 3;
+    size_t totalSize = 0;
+    for (auto& state : _meshStates) {
+        // a mesh with a single cluster is drawn with it as its transform instead
+        if (state.clusterMatrices.size() > 1) {
+            state.clusterBufferOffset = totalSize;
+            state.clusterBufferSize = state.clusterMatrices.size() * ROWS_PER_CLUSTER * sizeof(glm::vec4);
+            totalSize += (state.clusterBufferSize + CLUSTER_BUFFER_ALIGNMENT - 1) & ~(CLUSTER_BUFFER_ALIGNMENT - 1);
+        } else {
+            state.clusterBufferOffset = state.clusterBufferSize = 0;
+        }
+    }
+    if (totalSize == 0) {
+        return;
+    }
+    _clusterRows.resize(totalSize / sizeof(glm::vec4));
+
+    auto upload = [&](gpu::BufferPointer& buffer, bool cauterized) {
+        for (const auto& state : _meshStates) {
+            if (state.clusterBufferSize > 0) {
+                const auto& matrices = cauterized ? state.cauterizedClusterMatrices : state.clusterMatrices;
+                MatrixKernels::packAffineRows(matrices.constData(), &_clusterRows[state.clusterBufferOffset / sizeof(glm::vec4)],
+                                              matrices.size());
+            }
+        }
+        if (!buffer || buffer->getSize() != totalSize) {
+            buffer = std::make_shared<gpu::Buffer>(totalSize, (const gpu::Byte*) _clusterRows.data());
+        } else {
+            buffer->setSubData(0, totalSize, (const gpu::Byte*) _clusterRows.data());
+        }
+    };
+    upload(_clusterBuffer, false);
+    if (!_cauterizeBoneSet.empty()) {
+        upload(_cauterizedClusterBuffer, true);
+    }
+}
+
 void Model::inverseKinematics(int endIndex, glm::vec3 targetPosition, const glm::quat& targetRotation, float priority) {
     const FBXGeometry& geometry = _geometry->getFBXGeometry();
     const QVector<int>& freeLineage = geometry.joints.at(endIndex).freeLineage;
@@ -1109,6 +1145,8 @@ void Model::setGeometry(const QSharedPointer<NetworkGeometry>& newGeometry) {
 void Model::deleteGeometry() {
     _blendedVertexBuffers.clear();
     _meshStates.clear();
+    _clusterBuffer.reset();
+    _cauterizedClusterBuffer.reset();
     _rig->destroyAnimGraph();
     _blendedBlendshapeCoefficients.clear();
 }
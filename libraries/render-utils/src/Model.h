@@ -20,6 +20,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <vector>
 
 #include <AABox.h>
 #include <DependencyManager.h>
@@ -100,6 +101,9 @@ public:
     bool isLoaded() const { return _geometry && _geometry->isLoaded(); }
     bool isLoadedWithTextures() const { return _geometry && _geometry->isLoadedWithTextures(); }
 
+    /// Sets how soon the model and its textures should load next to other downloads, see Resource::setLoadPriority.
+    void setLoadPriority(float priority) { if (_geometry) { _geometry->setLoadPriority(this, priority); } }
+
     void setIsWireframe(bool isWireframe) { _isWireframe = isWireframe; }
     bool isWireframe() const { return _isWireframe; }
 
@@ -271,12 +275,21 @@ protected:
     public:
         QVector<glm::mat4> clusterMatrices;
         QVector<glm::mat4> cauterizedClusterMatrices;
-        gpu::BufferPointer clusterBuffer;
-        gpu::BufferPointer cauterizedClusterBuffer;
-
+        size_t clusterBufferOffset { 0 }; // where the mesh's clusters start in the cluster buffers, in bytes
+        size_t clusterBufferSize { 0 }; // zero if the mesh isn't skinned
     };
 
     QVector<MeshState> _meshStates;
+
+    // the clusters of all the skinned meshes go up in one buffer per frame, three rows of their affine matrices each
+    gpu::BufferPointer _clusterBuffer;
+    gpu::BufferPointer _cauterizedClusterBuffer;
+    std::vector<glm::vec4> _clusterRows;
+    std::vector<glm::mat4> _jointMatrices;
+
+    // packs the cluster matrices of the mesh states into the cluster buffers
+    void updateClusterBuffers();
+
     std::unordered_set<int> _cauterizeBoneSet;
     bool _cauterizeBones;
 
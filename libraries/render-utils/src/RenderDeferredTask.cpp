@@ -25,6 +25,7 @@
 
 #include "render/DrawTask.h"
 #include "render/DrawStatus.h"
+#include "render/OcclusionCulling.h"
 #include "AmbientOcclusionEffect.h"
 #include "AntialiasingEffect.h"
 #include "ToneMappingEffect.h"
@@ -75,10 +76,18 @@ RenderDeferredTask::RenderDeferredTask(CullFunctor cullFunctor) {
     ShapePlumberPointer shapePlumber = std::make_shared<ShapePlumber>();
     initDeferredPipelines(*shapePlumber);
     
+    // Scale the viewport the frame is drawn in to the GPU time of the frames before
+    addJob<RenderScale>("RenderScale", _renderScaleFrame);
+
     // CPU: Fetch the renderOpaques
     const auto fetchedOpaques = addJob<FetchItems>("FetchOpaque");
     const auto culledOpaques = addJob<CullItems<RenderDetails::OPAQUE_ITEM>>("CullOpaque", fetchedOpaques, cullFunctor);
-    const auto opaques = addJob<DepthSortItems>("DepthSortOpaque", culledOpaques);
+    const auto depthSortedOpaques = addJob<DepthSortItems>("DepthSortOpaque", culledOpaques);
+    const auto shapeSortedOpaques = addJob<ShapeSortItems>("ShapeSortOpaque", depthSortedOpaques);
+
+    // CPU: Leave out the opaques the queries of the frames before found hidden
+    auto occlusionState = std::make_shared<OcclusionState>();
+    const auto opaques = addJob<OcclusionCullItems>("OcclusionCullOpaque", shapeSortedOpaques, occlusionState);
 
     // CPU only, create the list of renderedTransparents items
     const auto fetchedTransparents = addJob<FetchItems>("FetchTransparent", FetchItems(
@@ -93,6 +102,9 @@ RenderDeferredTask::RenderDeferredTask(CullFunctor cullFunctor) {
     // Render opaque objects in DeferredBuffer
     addJob<DrawDeferred>("DrawOpaqueDeferred", opaques, shapePlumber);
 
+    // Query the occlusion of all the opaques in view against the depth of those drawn, for the frames to come
+    addJob<QueryOcclusion>("QueryOcclusionOpaque", shapeSortedOpaques, occlusionState);
+
     // Once opaque is all rendered create stencil background
     addJob<DrawStencilDeferred>("DrawOpaqueStencil");
 
@@ -128,11 +140,11 @@ RenderDeferredTask::RenderDeferredTask(CullFunctor cullFunctor) {
         addJob<DrawStatus>("DrawStatus", opaques, DrawStatus(statusIconMap));
     }
 
-    addJob<DrawOverlay3D>("DrawOverlay3D", shapePlumber);
+    addJob<DrawOverlay3D>("DrawOverlay3D", cullFunctor, shapePlumber);
 
     addJob<HitEffect>("HitEffect");
 
-    addJob<Blit>("Blit");
+    addJob<Blit>("Blit", _renderScaleFrame);
 }
 
 void RenderDeferredTask::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
@@ -148,8 +160,27 @@ void RenderDeferredTask::run(const SceneContextPointer& sceneContext, const Rend
         return;
     }
 
+    // The render scale shrinks the viewport for the jobs, the frame gets its full viewport back after them
+    RenderArgs* args = renderContext->args;
+    _renderScaleFrame->viewport = args->_viewport;
+
+    // the jobs take over the job config of the context while they run
+    auto config = renderContext->jobConfig;
+
+    double gpuTime = 0.0;
     for (auto job : _jobs) {
         job.run(sceneContext, renderContext);
+        gpuTime += std::static_pointer_cast<render::JobConfig>(job.getConfiguration())->gpuTime;
+    }
+
+    args->_viewport = _renderScaleFrame->viewport;
+    if (args->_renderMode == RenderArgs::DEFAULT_RENDER_MODE) {
+        _renderScaleFrame->gpuTime = gpuTime;
+
+        // the LOD manager keeps the frame times of the deferred jobs within those of its frame rate
+        if (config) {
+            config->gpuTime = gpuTime;
+        }
     }
 };
 
@@ -160,23 +191,18 @@ void DrawDeferred::run(const SceneContextPointer& sceneContext, const RenderCont
     auto config = std::static_pointer_cast<Config>(renderContext->jobConfig);
 
     RenderArgs* args = renderContext->args;
-    gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
-        batch.setViewportTransform(args->_viewport);
-        batch.setStateScissorRect(args->_viewport);
-        args->_batch = &batch;
+    config->numDrawn = (int)inItems.size();
 
-        config->numDrawn = (int)inItems.size();
-
-        glm::mat4 projMat;
-        Transform viewMat;
-        args->_viewFrustum->evalProjectionMatrix(projMat);
-        args->_viewFrustum->evalViewTransform(viewMat);
+    glm::mat4 projMat;
+    Transform viewMat;
+    args->_viewFrustum->evalProjectionMatrix(projMat);
+    args->_viewFrustum->evalViewTransform(viewMat);
 
+    renderShapesInParallel(sceneContext, renderContext, _shapePlumber, inItems, _maxDrawn, [&](gpu::Batch& batch) {
+        batch.setViewportTransform(args->_viewport);
+        batch.setStateScissorRect(args->_viewport);
         batch.setProjectionTransform(projMat);
         batch.setViewTransform(viewMat);
-
-        renderShapes(sceneContext, renderContext, _shapePlumber, inItems, _maxDrawn);
-        args->_batch = nullptr;
     });
 }
 
@@ -208,15 +234,24 @@ void DrawOverlay3D::run(const SceneContextPointer& sceneContext, const RenderCon
 
     auto config = std::static_pointer_cast<Config>(renderContext->jobConfig);
 
-    ItemIDsBounds inItems;
-    inItems.reserve(items.size());
+    ItemIDsBounds layeredItems;
+    layeredItems.reserve(items.size());
     for (auto id : items) {
         auto& item = scene->getItem(id);
         if (item.getKey().isVisible() && (item.getLayer() == 1)) {
-            inItems.emplace_back(id);
+            layeredItems.emplace_back(id, item.getBound());
         }
     }
-    config->numItems = (int)inItems.size();
+    config->numItems = (int)layeredItems.size();
+
+    // Leave out the overlays out of view like the other shapes, and draw the nearest first
+    ItemIDsBounds culledItems;
+    culledItems.reserve(layeredItems.size());
+    cullItems(renderContext, _cullFunctor, renderContext->args->_details.edit(RenderDetails::OTHER_ITEM),
+              layeredItems, culledItems);
+    ItemIDsBounds inItems;
+    inItems.reserve(culledItems.size());
+    depthSortItems(sceneContext, renderContext, true, culledItems, inItems);
     config->numDrawn = (int)inItems.size();
 
     if (!inItems.empty()) {
@@ -233,15 +268,14 @@ void DrawOverlay3D::run(const SceneContextPointer& sceneContext, const RenderCon
         }
 
         // Render the items
-        gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
-            args->_batch = &batch;
-            args->_whiteTexture = DependencyManager::get<TextureCache>()->getWhiteTexture();
+        args->_whiteTexture = DependencyManager::get<TextureCache>()->getWhiteTexture();
 
-            glm::mat4 projMat;
-            Transform viewMat;
-            args->_viewFrustum->evalProjectionMatrix(projMat);
-            args->_viewFrustum->evalViewTransform(viewMat);
+        glm::mat4 projMat;
+        Transform viewMat;
+        args->_viewFrustum->evalProjectionMatrix(projMat);
+        args->_viewFrustum->evalViewTransform(viewMat);
 
+        renderShapesInParallel(sceneContext, renderContext, _shapePlumber, inItems, _maxDrawn, [&](gpu::Batch& batch) {
             batch.setProjectionTransform(projMat);
             batch.setViewTransform(viewMat);
             batch.setViewportTransform(args->_viewport);
@@ -249,9 +283,7 @@ void DrawOverlay3D::run(const SceneContextPointer& sceneContext, const RenderCon
 
             batch.setPipeline(getOpaquePipeline());
             batch.setResourceTexture(0, args->_whiteTexture);
-            renderShapes(sceneContext, renderContext, _shapePlumber, inItems, _maxDrawn);
         });
-        args->_batch = nullptr;
         args->_whiteTexture.reset();
     }
 }
@@ -354,9 +386,11 @@ void Blit::run(const SceneContextPointer& sceneContext, const RenderContextPoint
         return;
     }
 
-    // Determine size from viewport
-    int width = renderArgs->_viewport.z;
-    int height = renderArgs->_viewport.w;
+    // Determine size from viewport, the frame is drawn in the viewport scaled down and upsampled to the full one
+    int srcWidth = renderArgs->_viewport.z;
+    int srcHeight = renderArgs->_viewport.w;
+    int width = _frame->viewport.z;
+    int height = _frame->viewport.w;
 
     // Blit primary to blit FBO
     auto framebufferCache = DependencyManager::get<FramebufferCache>();
@@ -368,33 +402,33 @@ void Blit::run(const SceneContextPointer& sceneContext, const RenderContextPoint
         if (renderArgs->_renderMode == RenderArgs::MIRROR_RENDER_MODE) {
             if (renderArgs->_context->isStereo()) {
                 gpu::Vec4i srcRectLeft;
-                srcRectLeft.z = width / 2;
-                srcRectLeft.w = height;
+                srcRectLeft.z = srcWidth / 2;
+                srcRectLeft.w = srcHeight;
 
                 gpu::Vec4i srcRectRight;
-                srcRectRight.x = width / 2;
-                srcRectRight.z = width;
-                srcRectRight.w = height;
+                srcRectRight.x = srcWidth / 2;
+                srcRectRight.z = srcWidth;
+                srcRectRight.w = srcHeight;
 
                 gpu::Vec4i destRectLeft;
-                destRectLeft.x = srcRectLeft.z;
-                destRectLeft.z = srcRectLeft.x;
-                destRectLeft.y = srcRectLeft.y;
-                destRectLeft.w = srcRectLeft.w;
+                destRectLeft.x = width / 2;
+                destRectLeft.z = 0;
+                destRectLeft.y = 0;
+                destRectLeft.w = height;
 
                 gpu::Vec4i destRectRight;
-                destRectRight.x = srcRectRight.z;
-                destRectRight.z = srcRectRight.x;
-                destRectRight.y = srcRectRight.y;
-                destRectRight.w = srcRectRight.w;
+                destRectRight.x = width;
+                destRectRight.z = width / 2;
+                destRectRight.y = 0;
+                destRectRight.w = height;
 
                 // Blit left to right and right to left in stereo
                 batch.blit(primaryFbo, srcRectRight, blitFbo, destRectLeft);
                 batch.blit(primaryFbo, srcRectLeft, blitFbo, destRectRight);
             } else {
                 gpu::Vec4i srcRect;
-                srcRect.z = width;
-                srcRect.w = height;
+                srcRect.z = srcWidth;
+                srcRect.w = srcHeight;
 
                 gpu::Vec4i destRect;
                 destRect.x = width;
@@ -405,11 +439,15 @@ void Blit::run(const SceneContextPointer& sceneContext, const RenderContextPoint
                 batch.blit(primaryFbo, srcRect, blitFbo, destRect);
             }
         } else {
-            gpu::Vec4i rect;
-            rect.z = width;
-            rect.w = height;
+            gpu::Vec4i srcRect;
+            srcRect.z = srcWidth;
+            srcRect.w = srcHeight;
+
+            gpu::Vec4i destRect;
+            destRect.z = width;
+            destRect.w = height;
 
-            batch.blit(primaryFbo, rect, blitFbo, rect);
+            batch.blit(primaryFbo, srcRect, blitFbo, destRect);
         }
     });
 }
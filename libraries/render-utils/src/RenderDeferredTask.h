@@ -16,6 +16,8 @@
 
 #include "render/DrawTask.h"
 
+#include "RenderScale.h"
+
 class SetupDeferred {
 public:
     void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext);
@@ -106,7 +108,8 @@ public:
     using Config = DrawOverlay3DConfig;
     using JobModel = render::Job::Model<DrawOverlay3D, Config>;
 
-    DrawOverlay3D(render::ShapePlumberPointer shapePlumber) : _shapePlumber{ shapePlumber } {}
+    DrawOverlay3D(render::CullFunctor cullFunctor, render::ShapePlumberPointer shapePlumber) :
+        _cullFunctor{ cullFunctor }, _shapePlumber{ shapePlumber } {}
 
     void configure(const Config& config) { _maxDrawn = config.maxDrawn; }
     void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext);
@@ -115,15 +118,22 @@ public:
 
 protected:
     static gpu::PipelinePointer _opaquePipeline; //lazy evaluation hence mutable
+    render::CullFunctor _cullFunctor;
     render::ShapePlumberPointer _shapePlumber;
     int _maxDrawn; // initialized by Config
 };
 
+// Blits the primary framebuffer, drawn at the render scale, to the full viewport of the frame
 class Blit {
 public:
+    Blit(RenderScaleFramePointer frame) : _frame{ frame } {}
+
     void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext);
 
     using JobModel = render::Job::Model<Blit>;
+
+protected:
+    RenderScaleFramePointer _frame;
 };
 
 class RenderDeferredTask : public render::Task {
@@ -133,6 +143,9 @@ public:
     void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext);
 
     using JobModel = Model<RenderDeferredTask>;
+
+protected:
+    RenderScaleFramePointer _renderScaleFrame { std::make_shared<RenderScaleFrame>() };
 };
 
 #endif // hifi_RenderDeferredTask_h
@@ -0,0 +1,55 @@
+//
+//  RenderScale.cpp
+//  render-utils/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RenderScale.h"
+
+#include <cmath>
+
+#include <RenderArgs.h>
+
+#include "FramebufferCache.h"
+
+// the share of the way to the scale fitting the budget covered each frame, down fast so no frame is dropped, and up
+// slowly so the scale doesn't swing back and forth around it
+static const float SCALE_DOWN_RATE = 0.5f;
+static const float SCALE_UP_RATE = 0.05f;
+
+void RenderScale::configure(const Config& config) {
+    _targetTime = (config.targetFrameRate > 0.0f) ? config.budget * 1000.0f / config.targetFrameRate : 0.0f;
+    _minScale = glm::clamp(config.minScale, 0.1f, 1.0f);
+    if (!config.enabled) {
+        _scale = 1.0f;
+        DependencyManager::get<FramebufferCache>()->setRenderScale(_scale);
+    }
+}
+
+void RenderScale::run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext) {
+    assert(renderContext->args);
+    RenderArgs* args = renderContext->args;
+
+    // The mirror is drawn in its own small viewport, and its time is not that of the frame
+    if (args->_renderMode != RenderArgs::DEFAULT_RENDER_MODE) {
+        return;
+    }
+
+    // The time of the jobs bound by the pixels goes with the square of the scale
+    if ((_targetTime > 0.0f) && (_frame->gpuTime > 0.0)) {
+        float fitScale = _scale * sqrtf(_targetTime / (float)_frame->gpuTime);
+        float rate = (fitScale < _scale) ? SCALE_DOWN_RATE : SCALE_UP_RATE;
+        _scale = glm::clamp(_scale + (fitScale - _scale) * rate, _minScale, 1.0f);
+    }
+
+    auto framebufferCache = DependencyManager::get<FramebufferCache>();
+    framebufferCache->setRenderScale(_scale);
+    args->_viewport = framebufferCache->evalRenderViewport(_frame->viewport);
+
+    auto config = std::static_pointer_cast<Config>(renderContext->jobConfig);
+    config->scale = _scale;
+}
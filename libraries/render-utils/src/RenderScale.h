@@ -0,0 +1,69 @@
+//
+//  RenderScale.h
+//  render-utils/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RenderScale_h
+#define hifi_RenderScale_h
+
+#include "render/DrawTask.h"
+
+// The frame the deferred task hands over from its first job to the blit: the viewport it was given, and the time the
+// GPU took on its jobs last time (a late average of their timer queries)
+class RenderScaleFrame {
+public:
+    glm::ivec4 viewport;
+    double gpuTime { 0.0 };
+};
+using RenderScaleFramePointer = std::shared_ptr<RenderScaleFrame>;
+
+class RenderScaleConfig : public render::Job::Config {
+    Q_OBJECT
+    Q_PROPERTY(bool enabled MEMBER enabled NOTIFY dirty)
+    Q_PROPERTY(float targetFrameRate MEMBER targetFrameRate NOTIFY dirty)
+    Q_PROPERTY(float budget MEMBER budget NOTIFY dirty)
+    Q_PROPERTY(float minScale MEMBER minScale NOTIFY dirty)
+    Q_PROPERTY(float scale READ getScale)
+public:
+    RenderScaleConfig() : render::Job::Config(false) {}
+
+    float getScale() const { return scale; }
+
+    // the frame rate of the display (0 for none), the share of its frame time left to the deferred jobs,
+    // and how far each side of the frame can shrink
+    float targetFrameRate { 90.0f };
+    float budget { 0.8f };
+    float minScale { 0.5f };
+
+    // the scale the last frame was drawn at
+    float scale { 1.0f };
+
+signals:
+    void dirty();
+};
+
+// Draws the frame in a part of the deferred framebuffers, scaled from frame to frame to keep the GPU time of the
+// deferred jobs within the frame time of the display; the blit brings the frame back to its full size
+class RenderScale {
+public:
+    using Config = RenderScaleConfig;
+    using JobModel = render::Job::Model<RenderScale, Config>;
+
+    RenderScale(RenderScaleFramePointer frame) : _frame{ frame } {}
+
+    void configure(const Config& config);
+    void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext);
+
+protected:
+    RenderScaleFramePointer _frame;
+    float _targetTime { 0.0f };
+    float _minScale { 0.5f };
+    float _scale { 1.0f };
+};
+
+#endif // hifi_RenderScale_h
@@ -9,7 +9,10 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <gpu/Context.h>
+#include <gpu/StandardShaderLib.h>
 
 #include <ViewFrustum.h>
 
@@ -24,9 +27,72 @@
 
 #include "model_shadow_frag.h"
 #include "skin_model_shadow_frag.h"
+#include "shadow_copy_frag.h"
 
 using namespace render;
 
+// The casters that haven't changed in a while are expected to stay as they are
+static const uint32_t STATIC_CASTER_FRAMES = 60;
+
+static bool isStaticCaster(const Scene& scene, ItemID id) {
+    // The other items can change their bounds or their look without going through the scene
+    const auto& key = scene.getItemKey(id);
+    return key.isSpatiallyIndexed() && key.isStatic() && !key.isDeformed() &&
+        scene.getFrame() - scene.getItemChangeFrame(id) >= STATIC_CASTER_FRAMES;
+}
+
+RenderShadowMap::RenderShadowMap(ShapePlumberPointer shapePlumber, ShadowCascadeIndexPointer cascadeIndex) :
+    _shapePlumber{ shapePlumber }, _cascadeIndex{ cascadeIndex } {
+}
+
+gpu::PipelinePointer RenderShadowMap::_copyPipeline;
+const gpu::PipelinePointer& RenderShadowMap::getCopyPipeline() {
+    if (!_copyPipeline) {
+        auto vs = gpu::StandardShaderLib::getDrawUnitQuadTexcoordVS();
+        auto ps = gpu::Shader::createPixel(std::string(shadow_copy_frag));
+        auto program = gpu::Shader::createProgram(vs, ps);
+
+        gpu::Shader::BindingSet slotBindings;
+        slotBindings.insert(gpu::Shader::Binding(std::string("depthMap"), 0));
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        auto state = std::make_shared<gpu::State>();
+        state->setDepthTest(true, true, gpu::ALWAYS);
+        state->setColorWriteMask(0);
+
+        _copyPipeline = gpu::Pipeline::create(program, state);
+    }
+    return _copyPipeline;
+}
+
+void RenderShadowMap::renderShapes(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext,
+                                   const render::ShapesIDsBounds& shapes) {
+    RenderArgs* args = renderContext->args;
+    auto& batch = *args->_batch;
+
+    auto shadowPipeline = _shapePlumber->pickPipeline(args, ShapeKey());
+    auto shadowSkinnedPipeline = _shapePlumber->pickPipeline(args, ShapeKey::Builder().withSkinned());
+    args->_pipeline = shadowPipeline;
+    batch.setPipeline(shadowPipeline->pipeline);
+
+    std::vector<ShapeKey> skinnedShapeKeys{};
+    for (auto items : shapes) {
+        if (items.first.isSkinned()) {
+            skinnedShapeKeys.push_back(items.first);
+        } else {
+            renderItems(sceneContext, renderContext, items.second);
+        }
+    }
+
+    args->_pipeline = shadowSkinnedPipeline;
+    batch.setPipeline(shadowSkinnedPipeline->pipeline);
+    for (const auto& key : skinnedShapeKeys) {
+        renderItems(sceneContext, renderContext, shapes.at(key));
+    }
+
+    args->_pipeline = nullptr;
+}
+
 void RenderShadowMap::run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext,
                           const render::ShapesIDsBounds& inShapes) {
     assert(renderContext->args);
@@ -36,50 +102,86 @@ void RenderShadowMap::run(const render::SceneContextPointer& sceneContext, const
     const auto globalLight = lightStage.lights[0];
     const auto& shadow = globalLight->shadow;
     const auto& fbo = shadow.framebuffer;
+    const auto& cascade = shadow.getCascade(*_cascadeIndex);
+    auto& cache = _staticCaches[*_cascadeIndex];
+    const auto& scene = sceneContext->_scene;
+
+    // Split the static casters from the others
+    ShapesIDsBounds staticShapes;
+    ShapesIDsBounds dynamicShapes;
+    ItemIDs staticItems;
+    for (const auto& items : inShapes) {
+        for (const auto& item : items.second) {
+            if (isStaticCaster(*scene, item.id)) {
+                staticShapes[items.first].push_back(item);
+                staticItems.push_back(item.id);
+            } else {
+                dynamicShapes[items.first].push_back(item);
+            }
+        }
+    }
+    std::sort(staticItems.begin(), staticItems.end());
+
+    // The cache holds while the cascade stays where it was and its static casters stay the same
+    const glm::mat4& view = cascade.frustum->getView();
+    const glm::mat4& projection = cascade.frustum->getProjection();
+    bool isCacheValid = cache.isValid && cache.view == view && cache.projection == projection &&
+        cache.items == staticItems &&
+        std::none_of(staticItems.begin(), staticItems.end(), [&](ItemID id) {
+            return scene->getItemChangeFrame(id) > cache.frame;
+        });
 
     RenderArgs* args = renderContext->args;
     gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
         args->_batch = &batch;
 
-        glm::ivec4 viewport{0, 0, fbo->getWidth(), fbo->getHeight()};
-        batch.setViewportTransform(viewport);
-        batch.setStateScissorRect(viewport);
+        batch.setProjectionTransform(projection);
+        batch.setViewTransform(view);
 
-        batch.setFramebuffer(fbo);
-        batch.clearFramebuffer(
-            gpu::Framebuffer::BUFFER_COLOR0 | gpu::Framebuffer::BUFFER_DEPTH,
-            vec4(vec3(1.0, 1.0, 1.0), 1.0), 1.0, 0, true);
-
-        batch.setProjectionTransform(shadow.getProjection());
-        batch.setViewTransform(shadow.getView());
-
-        auto shadowPipeline = _shapePlumber->pickPipeline(args, ShapeKey());
-        auto shadowSkinnedPipeline = _shapePlumber->pickPipeline(args, ShapeKey::Builder().withSkinned());
-        args->_pipeline = shadowPipeline;
-        batch.setPipeline(shadowPipeline->pipeline);
-
-        std::vector<ShapeKey> skinnedShapeKeys{};
-        for (auto items : inShapes) {
-            if (items.first.isSkinned()) {
-                skinnedShapeKeys.push_back(items.first);
-            } else {
-                renderItems(sceneContext, renderContext, items.second);
+        if (!isCacheValid) {
+            if (!cache.framebuffer) {
+                auto depthFormat = gpu::Element(gpu::SCALAR, gpu::FLOAT, gpu::DEPTH);
+                auto depthTexture = gpu::TexturePointer(gpu::Texture::create2D(depthFormat,
+                    LightStage::Shadow::MAP_SIZE, LightStage::Shadow::MAP_SIZE));
+                cache.framebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create());
+                cache.framebuffer->setDepthStencilBuffer(depthTexture, depthFormat);
             }
-        }
 
-        args->_pipeline = shadowSkinnedPipeline;
-        batch.setPipeline(shadowSkinnedPipeline->pipeline);
-        for (const auto& key : skinnedShapeKeys) {
-            renderItems(sceneContext, renderContext, inShapes.at(key));
+            glm::ivec4 viewport{0, 0, cache.framebuffer->getWidth(), cache.framebuffer->getHeight()};
+            batch.setViewportTransform(viewport);
+            batch.setStateScissorRect(viewport);
+
+            batch.setFramebuffer(cache.framebuffer);
+            batch.clearDepthFramebuffer(1.0f, true);
+
+            renderShapes(sceneContext, renderContext, staticShapes);
+
+            cache.view = view;
+            cache.projection = projection;
+            cache.items = std::move(staticItems);
+            cache.frame = scene->getFrame();
+            cache.isValid = true;
         }
 
-        args->_pipeline = nullptr;
+        batch.setViewportTransform(cascade.viewport);
+        batch.setStateScissorRect(cascade.viewport);
+        batch.setFramebuffer(fbo);
+
+        // The copy of the static casters covers the whole cascade, the others are drawn on top
+        batch.setPipeline(getCopyPipeline());
+        batch.setResourceTexture(0, cache.framebuffer->getDepthStencilBuffer());
+        batch.draw(gpu::TRIANGLE_STRIP, 4);
+        batch.setResourceTexture(0, nullptr);
+
+        renderShapes(sceneContext, renderContext, dynamicShapes);
+
         args->_batch = nullptr;
     });
 }
 
 // The shadow task *must* use this base ctor to initialize with its own Config, see Task.h
-RenderShadowTask::RenderShadowTask(CullFunctor cullFunctor) : Task(std::make_shared<Config>()) {
+RenderShadowTask::RenderShadowTask(CullFunctor cullFunctor) :
+    Task(std::make_shared<Config>()), _cascadeIndex{ std::make_shared<int>(0) } {
     cullFunctor = cullFunctor ? cullFunctor : [](const RenderArgs*, const AABox&){ return true; };
 
     // Prepare the ShapePipeline
@@ -116,8 +218,8 @@ RenderShadowTask::RenderShadowTask(CullFunctor cullFunctor) : Task(std::make_sha
     // CPU: Sort front to back
     const auto shadowShapes = addJob<DepthSortShapes>("DepthSortShadowMap", sortedShapes);
 
-    // GPU: Render to shadow map
-    addJob<RenderShadowMap>("RenderShadowMap", shadowShapes, shapePlumber);
+    // GPU: Render to the cascade of the shadow map
+    addJob<RenderShadowMap>("RenderShadowMap", shadowShapes, shapePlumber, _cascadeIndex);
 }
 
 void RenderShadowTask::configure(const Config& configuration) {
@@ -153,13 +255,17 @@ void RenderShadowTask::run(const SceneContextPointer& sceneContext, const render
     globalLight->shadow.setKeylightFrustum(viewFrustum, nearDepth, nearClip + SHADOW_FAR_DEPTH);
 
     // Set the keylight render args
-    args->_viewFrustum = globalLight->shadow.getFrustum().get();
     args->_renderMode = RenderArgs::SHADOW_RENDER_MODE;
 
     // TODO: Allow runtime manipulation of culling ShouldRenderFunctor
 
-    for (auto job : _jobs) {
-        job.run(sceneContext, renderContext);
+    // Each cascade fetches, culls and renders its own casters
+    for (int i = 0; i < LightStage::Shadow::NUM_CASCADES; i++) {
+        *_cascadeIndex = i;
+        args->_viewFrustum = globalLight->shadow.getCascade(i).frustum.get();
+        for (auto job : _jobs) {
+            job.run(sceneContext, renderContext);
+        }
     }
 
     // Reset the render args
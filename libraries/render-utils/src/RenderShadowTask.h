@@ -17,18 +17,43 @@
 
 #include <render/DrawTask.h>
 
+#include "LightStage.h"
+
 class ViewFrustum;
 
+// The index of the cascade the shadow jobs are running for, set by the RenderShadowTask
+using ShadowCascadeIndexPointer = std::shared_ptr<int>;
+
 class RenderShadowMap {
 public:
     using JobModel = render::Job::ModelI<RenderShadowMap, render::ShapesIDsBounds>;
 
-    RenderShadowMap(render::ShapePlumberPointer shapePlumber) : _shapePlumber{ shapePlumber } {}
+    RenderShadowMap(render::ShapePlumberPointer shapePlumber, ShadowCascadeIndexPointer cascadeIndex);
     void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext,
              const render::ShapesIDsBounds& inShapes);
 
 protected:
+    // The depth of the static casters of a cascade, drawn again only when they or the cascade change,
+    // and copied in the shadow map before the other casters are drawn on top
+    class StaticCache {
+    public:
+        gpu::FramebufferPointer framebuffer;
+        glm::mat4 view;
+        glm::mat4 projection;
+        render::ItemIDs items;
+        uint32_t frame { 0 };
+        bool isValid { false };
+    };
+
     render::ShapePlumberPointer _shapePlumber;
+    ShadowCascadeIndexPointer _cascadeIndex;
+    std::array<StaticCache, LightStage::Shadow::NUM_CASCADES> _staticCaches;
+
+    static gpu::PipelinePointer _copyPipeline;
+    static const gpu::PipelinePointer& getCopyPipeline();
+
+    void renderShapes(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext,
+                      const render::ShapesIDsBounds& shapes);
 };
 
 class RenderShadowTaskConfig : public render::Task::Config {
@@ -50,6 +75,9 @@ public:
 
     void configure(const Config& configuration);
     void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext);
+
+protected:
+    ShadowCascadeIndexPointer _cascadeIndex;
 };
 
 #endif // hifi_RenderShadowTask_h
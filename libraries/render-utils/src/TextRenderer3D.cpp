@@ -77,7 +77,7 @@ void TextRenderer3D::draw(gpu::Batch& batch, float x, float y, const QString& st
     if (_font) {
         // Cache color so that the pointer stays valid.
         _color = color;
-        _font->drawString(batch, x, y, str, &_color, _effectType, bounds);
+        _font->drawString(batch, _drawInfo, x, y, str, &_color, _effectType, bounds);
     }
 }
 
@@ -20,10 +20,10 @@
 namespace gpu {
 class Batch;
 }
-class Font;
 
 #include "text/EffectType.h"
 #include "text/FontFamilies.h"
+#include "text/Font.h"
 
 // TextRenderer3D is actually a fairly thin wrapper around a Font class
 // defined in the cpp file.
@@ -56,6 +56,7 @@ private:
     glm::vec4 _color;
 
     Font* _font;
+    Font::DrawInfo _drawInfo;
 };
 
 
@@ -20,6 +20,8 @@ struct TextureVertex {
 
 static const int NUMBER_OF_INDICES_PER_QUAD = 6; // 1 quad = 2 triangles
 static const int VERTICES_PER_QUAD = 4; // 1 quad = 4 vertices
+// the most glyphs drawn of a string, their vertices indexed by 16 bits
+static const unsigned int MAX_QUADS_PER_STRING = 65536 / VERTICES_PER_QUAD;
 
 struct QuadBuilder {
     TextureVertex vertices[VERTICES_PER_QUAD];
@@ -250,14 +252,13 @@ void Font::setupGPU() {
     }
 }
 
-void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2& bounds) {
-    _verticesBuffer = std::make_shared<gpu::Buffer>();
-    _numVertices = 0;
-    _indicesBuffer = std::make_shared<gpu::Buffer>();
-    _numIndices = 0;
+void Font::rebuildVertices(DrawInfo& drawInfo, float x, float y, const QString& str, const glm::vec2& bounds) {
+    drawInfo.verticesBuffer = std::make_shared<gpu::Buffer>();
+    drawInfo.numQuads = 0;
 
-    _lastStringRendered = str;
-    _lastBounds = bounds;
+    drawInfo.string = str;
+    drawInfo.origin = glm::vec2(x, y);
+    drawInfo.bounds = bounds;
 
     // Top left of text
     glm::vec2 advance = glm::vec2(x, y);
@@ -290,40 +291,14 @@ void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2
         // Draw the token
         if (!isNewLine) {
             for (auto c : token) {
+                if (drawInfo.numQuads == MAX_QUADS_PER_STRING) {
+                    return;
+                }
                 auto glyph = _glyphs[c];
-                quint16 verticesOffset = _numVertices;
 
                 QuadBuilder qd(glyph, advance - glm::vec2(0.0f, _ascent));
-                _verticesBuffer->append(sizeof(QuadBuilder), (const gpu::Byte*)&qd);
-                _numVertices += 4;
-                
-                // Sam's recommended triangle slices
-                // Triangle tri1 = { v0, v1, v3 };
-                // Triangle tri2 = { v1, v2, v3 };
-                // NOTE: Random guy on the internet's recommended triangle slices
-                // Triangle tri1 = { v0, v1, v2 };
-                // Triangle tri2 = { v2, v3, v0 };
-
-                // The problem here being that the 4 vertices are { ll, lr, ul, ur }, a Z pattern
-                // Additionally, you want to ensure that the shared side vertices are used sequentially
-                // to improve cache locality
-                //
-                //  2 -- 3
-                //  |    |
-                //  |    |
-                //  0 -- 1
-                //
-                //  { 0, 1, 2 } -> { 2, 1, 3 }
-                quint16 indices[NUMBER_OF_INDICES_PER_QUAD];
-                indices[0] = verticesOffset + 0;
-                indices[1] = verticesOffset + 1;
-                indices[2] = verticesOffset + 2;
-                indices[3] = verticesOffset + 2;
-                indices[4] = verticesOffset + 1;
-                indices[5] = verticesOffset + 3;
-                _indicesBuffer->append(sizeof(indices), (const gpu::Byte*)indices);
-                _numIndices += NUMBER_OF_INDICES_PER_QUAD;
-                
+                drawInfo.verticesBuffer->append(sizeof(QuadBuilder), (const gpu::Byte*)&qd);
+                ++drawInfo.numQuads;
 
                 // Advance by glyph size
                 advance.x += glyph.d;
@@ -335,15 +310,54 @@ void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2
     }
 }
 
-void Font::drawString(gpu::Batch& batch, float x, float y, const QString& str, const glm::vec4* color,
-                      EffectType effectType, const glm::vec2& bounds) {
+void Font::growIndices(unsigned int numQuads) {
+    if (!_indicesBuffer) {
+        _indicesBuffer = std::make_shared<gpu::Buffer>();
+    }
+    for (; _numIndexedQuads < numQuads; ++_numIndexedQuads) {
+        quint16 verticesOffset = _numIndexedQuads * VERTICES_PER_QUAD;
+
+        // Sam's recommended triangle slices
+        // Triangle tri1 = { v0, v1, v3 };
+        // Triangle tri2 = { v1, v2, v3 };
+        // NOTE: Random guy on the internet's recommended triangle slices
+        // Triangle tri1 = { v0, v1, v2 };
+        // Triangle tri2 = { v2, v3, v0 };
+
+        // The problem here being that the 4 vertices are { ll, lr, ul, ur }, a Z pattern
+        // Additionally, you want to ensure that the shared side vertices are used sequentially
+        // to improve cache locality
+        //
+        //  2 -- 3
+        //  |    |
+        //  |    |
+        //  0 -- 1
+        //
+        //  { 0, 1, 2 } -> { 2, 1, 3 }
+        quint16 indices[NUMBER_OF_INDICES_PER_QUAD];
+        indices[0] = verticesOffset + 0;
+        indices[1] = verticesOffset + 1;
+        indices[2] = verticesOffset + 2;
+        indices[3] = verticesOffset + 2;
+        indices[4] = verticesOffset + 1;
+        indices[5] = verticesOffset + 3;
+        _indicesBuffer->append(sizeof(indices), (const gpu::Byte*)indices);
+    }
+}
+
+void Font::drawString(gpu::Batch& batch, DrawInfo& drawInfo, float x, float y, const QString& str,
+                      const glm::vec4* color, EffectType effectType, const glm::vec2& bounds) {
     if (str == "") {
         return;
     }
 
-    if (str != _lastStringRendered || bounds != _lastBounds) {
-        rebuildVertices(x, y, str, bounds);
+    if (str != drawInfo.string || bounds != drawInfo.bounds || glm::vec2(x, y) != drawInfo.origin) {
+        rebuildVertices(drawInfo, x, y, str, bounds);
+    }
+    if (drawInfo.numQuads == 0) {
+        return;
     }
+    growIndices(drawInfo.numQuads);
 
     setupGPU();
 
@@ -353,7 +367,7 @@ void Font::drawString(gpu::Batch& batch, float x, float y, const QString& str, c
     batch._glUniform4fv(_colorLoc, 1, (const float*)color);
 
     batch.setInputFormat(_format);
-    batch.setInputBuffer(0, _verticesBuffer, 0, _format->getChannels().at(0)._stride);
+    batch.setInputBuffer(0, drawInfo.verticesBuffer, 0, _format->getChannels().at(0)._stride);
     batch.setIndexBuffer(gpu::UINT16, _indicesBuffer, 0);
-    batch.drawIndexed(gpu::TRIANGLES, _numIndices, 0);
+    batch.drawIndexed(gpu::TRIANGLES, drawInfo.numQuads * NUMBER_OF_INDICES_PER_QUAD, 0);
 }
@@ -19,13 +19,24 @@ class Font {
 public:
     Font();
 
+    // The vertices of a string drawn, kept by what draws it.  A font is shared by all the text drawn in its family, the
+    // vertices of each string are only rebuilt when the string, its position or its bounds change.
+    class DrawInfo {
+    public:
+        gpu::BufferPointer verticesBuffer;
+        unsigned int numQuads { 0 };
+        QString string;
+        glm::vec2 origin;
+        glm::vec2 bounds;
+    };
+
     void read(QIODevice& path);
 
     glm::vec2 computeExtent(const QString& str) const;
     float getFontSize() const { return _fontSize; }
 
     // Render string to batch
-    void drawString(gpu::Batch& batch, float x, float y, const QString& str,
+    void drawString(gpu::Batch& batch, DrawInfo& drawInfo, float x, float y, const QString& str,
         const glm::vec4* color, EffectType effectType,
         const glm::vec2& bound);
 
@@ -38,7 +49,9 @@ private:
     glm::vec2 computeTokenExtent(const QString& str) const;
 
     const Glyph& getGlyph(const QChar& c) const;
-    void rebuildVertices(float x, float y, const QString& str, const glm::vec2& bounds);
+    void rebuildVertices(DrawInfo& drawInfo, float x, float y, const QString& str, const glm::vec2& bounds);
+    // makes the indices of the quads, the same for all strings, go up to this many quads
+    void growIndices(unsigned int numQuads);
 
     void setupGPU();
 
@@ -63,19 +76,12 @@ private:
     gpu::PipelinePointer _pipeline;
     gpu::TexturePointer _texture;
     gpu::Stream::FormatPointer _format;
-    gpu::BufferPointer _verticesBuffer;
     gpu::BufferPointer _indicesBuffer;
-    gpu::BufferStreamPointer _stream;
-    unsigned int _numVertices = 0;
-    unsigned int _numIndices = 0;
+    unsigned int _numIndexedQuads = 0;
 
     int _fontLoc = -1;
     int _outlineLoc = -1;
     int _colorLoc = -1;
-
-    // last string render characteristics
-    QString _lastStringRendered;
-    glm::vec2 _lastBounds;
 };
 
 #endif
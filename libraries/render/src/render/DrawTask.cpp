@@ -13,13 +13,32 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <memory>
 
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QThread>
+
+#include <CullingKernels.h>
 #include <PerfStat.h>
 #include <ViewFrustum.h>
 #include <gpu/Context.h>
 
 using namespace render;
 
+// the boxes are tested in chunks on worker threads once there are enough of them
+static const int CULL_CHUNK_SIZE = 4096;
+
+// the keyhole only sees the boxes it contains, so those that are not near the eye can't be in it
+static bool isNearKeyhole(const AABox& box, const ViewFrustum& frustum) {
+    float radius = frustum.getKeyholeRadius();
+    if (radius < 0.0f) {
+        return false;
+    }
+    const glm::vec3& eye = frustum.getPosition();
+    glm::vec3 closest = glm::clamp(eye, box.getCorner(), box.getCorner() + box.getScale());
+    return glm::distance(closest, eye) <= radius;
+}
+
 void render::cullItems(const RenderContextPointer& renderContext, const CullFunctor& cullFunctor, RenderDetails::Item& details,
                        const ItemIDsBounds& inItems, ItemIDsBounds& outItems) {
     assert(renderContext->args);
@@ -29,9 +48,32 @@ void render::cullItems(const RenderContextPointer& renderContext, const CullFunc
     ViewFrustum* frustum = args->_viewFrustum;
 
     details._considered += inItems.size();
-    
+
+    // Test all the bounds against the planes of the frustum at once
+    int numItems = (int)inItems.size();
+    std::vector<AABox> bounds(numItems);
+    for (int i = 0; i < numItems; i++) {
+        bounds[i] = inItems[i].bounds;
+    }
+    std::unique_ptr<bool[]> isOutside(new bool[numItems]);
+    glm::vec4 planes[ViewFrustum::NUM_PLANES];
+    frustum->getPlanes(planes);
+    if (numItems > CULL_CHUNK_SIZE) {
+        QVector<int> chunks;
+        for (int begin = 0; begin < numItems; begin += CULL_CHUNK_SIZE) {
+            chunks.append(begin);
+        }
+        QtConcurrent::blockingMap(chunks, [&](int begin) {
+            CullingKernels::findBoxesOutside(planes, ViewFrustum::NUM_PLANES, bounds.data() + begin,
+                                             isOutside.get() + begin, std::min(CULL_CHUNK_SIZE, numItems - begin));
+        });
+    } else {
+        CullingKernels::findBoxesOutside(planes, ViewFrustum::NUM_PLANES, bounds.data(), isOutside.get(), numItems);
+    }
+
     // Culling / LOD
-    for (auto item : inItems) {
+    for (int i = 0; i < numItems; i++) {
+        const auto& item = inItems[i];
         if (item.bounds.isNull()) {
             outItems.emplace_back(item); // One more Item to render
             continue;
@@ -39,18 +81,12 @@ void render::cullItems(const RenderContextPointer& renderContext, const CullFunc
 
         // TODO: some entity types (like lights) might want to be rendered even
         // when they are outside of the view frustum...
-        bool outOfView;
-        {
-            PerformanceTimer perfTimer("boxInFrustum");
+        bool outOfView = isOutside[i];
+        if (outOfView && isNearKeyhole(item.bounds, *frustum)) {
             outOfView = frustum->boxInFrustum(item.bounds) == ViewFrustum::OUTSIDE;
         }
         if (!outOfView) {
-            bool bigEnoughToRender;
-            {
-                PerformanceTimer perfTimer("shouldRender");
-                bigEnoughToRender = cullFunctor(args, item.bounds);
-            }
-            if (bigEnoughToRender) {
+            if (cullFunctor(args, item.bounds)) {
                 outItems.emplace_back(item); // One more Item to render
             } else {
                 details._tooSmall++;
@@ -135,16 +171,26 @@ void render::renderItems(const SceneContextPointer& sceneContext, const RenderCo
     }
 }
 
+// args->_pipeline is the pipeline last prepared on the batch, null at the start of a batch or after an item that set
+// up its own, so that a run of items of the same pipeline only prepares it once
 void renderShape(RenderArgs* args, const ShapePlumberPointer& shapeContext, const Item& item) {
     assert(item.getKey().isShape());
     const auto& key = item.getShapeKey();
     if (key.isValid() && !key.hasOwnPipeline()) {
-        args->_pipeline = shapeContext->pickPipeline(args, key);
-        if (args->_pipeline) {
-            item.render(args);
+        const auto& pipeline = shapeContext->lookupPipeline(key);
+        if (!pipeline) {
+            qDebug() << "Couldn't find a pipeline from ShapeKey ?" << key;
+            args->_pipeline = nullptr;
+            return;
+        }
+        if (pipeline != args->_pipeline) {
+            pipeline->prepare(*args->_batch);
+            args->_pipeline = pipeline;
         }
+        item.render(args);
     } else if (key.hasOwnPipeline()) {
         item.render(args);
+        args->_pipeline = nullptr;
     } else {
         qDebug() << "Item could not be rendered: invalid key ?" << key;
     }
@@ -159,24 +205,126 @@ void render::renderShapes(const SceneContextPointer& sceneContext, const RenderC
     if (maxDrawnItems != -1) {
         numItemsToDraw = glm::min(numItemsToDraw, maxDrawnItems);
     }
+    args->_pipeline = nullptr;
     for (auto i = 0; i < numItemsToDraw; ++i) {
         auto& item = scene->getItem(inItems[i].id);
         renderShape(args, shapeContext, item);
     }
 }
 
+// below this, a run records faster than a worker thread gets to it
+static const int MIN_ITEMS_PER_RUN = 64;
+
+namespace {
+    class ShapeRun {
+    public:
+        int begin;
+        int end;
+        bool isThreadSafe;
+        gpu::Batch batch;
+        RenderArgs args;
+    };
+}
+
+void render::renderShapesInParallel(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext,
+                                    const ShapePlumberPointer& shapeContext, const ItemIDsBounds& inItems,
+                                    int maxDrawnItems, const BatchSetup& setupBatch) {
+    auto& scene = sceneContext->_scene;
+    RenderArgs* args = renderContext->args;
+
+    int numItemsToDraw = (int)inItems.size();
+    if (maxDrawnItems != -1) {
+        numItemsToDraw = glm::min(numItemsToDraw, maxDrawnItems);
+    }
+    int numRuns = std::min(QThread::idealThreadCount(), numItemsToDraw / MIN_ITEMS_PER_RUN);
+    if (numRuns <= 1) {
+        gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+            args->_batch = &batch;
+            setupBatch(batch);
+            renderShapes(sceneContext, renderContext, shapeContext, inItems, maxDrawnItems);
+        });
+        args->_batch = nullptr;
+        return;
+    }
+
+    // whatever the items share gets updated here, so that rendering them only reads it
+    for (int i = 0; i < numItemsToDraw; ++i) {
+        scene->getItem(inItems[i].id).prepare(args);
+    }
+
+    std::vector<std::unique_ptr<ShapeRun>> runs;
+    QList<ShapeRun*> threadSafeRuns;
+    for (int i = 0; i < numRuns; ++i) {
+        auto run = std::unique_ptr<ShapeRun>(new ShapeRun());
+        run->begin = numItemsToDraw * i / numRuns;
+        run->end = numItemsToDraw * (i + 1) / numRuns;
+        run->isThreadSafe = true;
+        for (int j = run->begin; j < run->end && run->isThreadSafe; ++j) {
+            run->isThreadSafe = scene->getItem(inItems[j].id).getKey().isThreadSafe();
+        }
+        run->args = *args;
+        run->args._details = RenderDetails();
+        run->args._batch = &run->batch;
+        if (run->isThreadSafe) {
+            threadSafeRuns.append(run.get());
+        }
+        runs.push_back(std::move(run));
+    }
+
+    auto record = [&](ShapeRun* run) {
+        setupBatch(run->batch);
+        run->args._pipeline = nullptr;
+        for (int i = run->begin; i < run->end; ++i) {
+            renderShape(&run->args, shapeContext, scene->getItem(inItems[i].id));
+        }
+    };
+    auto recording = QtConcurrent::map(threadSafeRuns, record);
+    for (auto& run : runs) {
+        if (!run->isThreadSafe) {
+            record(run.get());
+        }
+    }
+    recording.waitForFinished();
+
+    for (auto& run : runs) {
+        args->_context->render(run->batch);
+        args->_details._materialSwitches += run->args._details._materialSwitches;
+        args->_details._trianglesRendered += run->args._details._trianglesRendered;
+    }
+    args->_batch = nullptr;
+}
+
 void FetchItems::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, ItemIDsBounds& outItems) {
     auto& scene = sceneContext->_scene;
 
     outItems.clear();
 
-    const auto& bucket = scene->getMasterBucket();
-    const auto& items = bucket.find(_filter);
-    if (items != bucket.end()) {
-        outItems.reserve(items->second.size());
-        for (auto& id : items->second) {
-            auto& item = scene->getItem(id);
-            outItems.emplace_back(ItemIDAndBounds(id, item.getBound()));
+    const ViewFrustum* frustum = renderContext->args ? renderContext->args->_viewFrustum : nullptr;
+    if (!frustum) {
+        const auto& bucket = scene->getMasterBucket();
+        const auto& items = bucket.find(_filter);
+        if (items != bucket.end()) {
+            outItems.reserve(items->second.size());
+            for (auto& id : items->second) {
+                outItems.emplace_back(ItemIDAndBounds(id, scene->getItemBound(id)));
+            }
+        }
+    } else {
+        // the indexed items come from the cells of the tree in view, the others are all fetched
+        _selectedIDs.clear();
+        scene->getSpatialTree().selectItems(*frustum, _selectedIDs);
+        const auto& bucket = scene->getUnindexedBucket();
+        const auto& items = bucket.find(_filter);
+        outItems.reserve(_selectedIDs.size() + (items != bucket.end() ? items->second.size() : 0));
+        for (auto id : _selectedIDs) {
+            if (_filter.test(scene->getItemKey(id))) {
+                outItems.emplace_back(ItemIDAndBounds(id, scene->getItemBound(id)));
+            }
+        }
+        if (items != bucket.end()) {
+            for (auto& id : items->second) {
+                outItems.emplace_back(ItemIDAndBounds(id, scene->getItemBound(id)));
+            }
         }
     }
 
@@ -187,6 +335,25 @@ void DepthSortItems::run(const SceneContextPointer& sceneContext, const RenderCo
     depthSortItems(sceneContext, renderContext, _frontToBack, inItems, outItems);
 }
 
+void ShapeSortItems::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outItems) {
+    auto& scene = sceneContext->_scene;
+
+    std::vector<std::pair<unsigned long, size_t>> keys;
+    keys.reserve(inItems.size());
+    for (size_t i = 0; i < inItems.size(); i++) {
+        keys.emplace_back(scene->getItem(inItems[i].id).getShapeKey()._flags.to_ulong(), i);
+    }
+    std::stable_sort(keys.begin(), keys.end(), [](const std::pair<unsigned long, size_t>& first, const std::pair<unsigned long, size_t>& second) {
+        return first.first < second.first;
+    });
+
+    outItems.clear();
+    outItems.reserve(inItems.size());
+    for (const auto& key : keys) {
+        outItems.push_back(inItems[key.second]);
+    }
+}
+
 void DrawLight::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
     assert(renderContext->args);
     assert(renderContext->args->_viewFrustum);
@@ -27,6 +27,14 @@ void depthSortItems(const SceneContextPointer& sceneContext, const RenderContext
 void renderItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems);
 void renderShapes(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemIDsBounds& inItems, int maxDrawnItems = -1);
 
+// Records the shapes like renderShapes, split in runs that each get a batch of their own, starting with setupBatch.
+// The runs whose items are all thread safe record on worker threads, once every item was prepared on this thread,
+// and the batches then render in the order of the items.
+using BatchSetup = std::function<void(gpu::Batch&)>;
+void renderShapesInParallel(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext,
+                            const ShapePlumberPointer& shapeContext, const ItemIDsBounds& inItems, int maxDrawnItems,
+                            const BatchSetup& setupBatch);
+
 class FetchItemsConfig : public Job::Config {
     Q_OBJECT
     Q_PROPERTY(int numItems READ getNumItems)
@@ -36,6 +44,8 @@ public:
     int numItems{ 0 };
 };
 
+// Fetches the items of the filter. With a view frustum in the args, the spatially indexed items are only fetched from the
+// cells of the spatial tree that the frustum sees, the culling that follows tests them one by one.
 class FetchItems {
 public:
     using Config = FetchItemsConfig;
@@ -48,6 +58,9 @@ public:
 
     void configure(const Config& config) {}
     void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, ItemIDsBounds& outItems);
+
+protected:
+    ItemSpatialTree::IDs _selectedIDs;
 };
 
 template<RenderDetails::Type T>
@@ -78,6 +91,13 @@ public:
     using JobModel = Job::ModelIO<DepthSortItems, ItemIDsBounds, ItemIDsBounds>;
 };
 
+// Groups the items by shape key so that each pipeline gets set once, keeping the order of the items within a group
+class ShapeSortItems {
+public:
+    void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outItems);
+    using JobModel = Job::ModelIO<ShapeSortItems, ItemIDsBounds, ItemIDsBounds>;
+};
+
 class DrawLight {
 public:
     DrawLight(CullFunctor cullFunctor) : _cullFunctor{ cullFunctor } {}
@@ -0,0 +1,154 @@
+//
+//  OcclusionCulling.cpp
+//  render/src/render
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OcclusionCulling.h"
+
+#include <assert.h>
+
+#include <ViewFrustum.h>
+#include <RenderArgs.h>
+
+#include <gpu/Context.h>
+
+#include "drawItemOcclusion_vert.h"
+#include "drawItemBounds_frag.h"
+
+using namespace render;
+
+// the items that weren't in the list for this many frames are forgotten
+static const uint32_t MAX_UNQUERIED_FRAMES = 60;
+
+// the bound of an item around the eye can't be drawn in front of it, so it is taken as in view
+static bool isAroundEye(const AABox& bounds, const ViewFrustum& frustum) {
+    glm::vec3 margin(frustum.getNearClip());
+    glm::vec3 eye = frustum.getPosition();
+    return glm::all(glm::greaterThanEqual(eye, bounds.getCorner() - margin)) &&
+        glm::all(glm::lessThanEqual(eye, bounds.getCorner() + bounds.getScale() + margin));
+}
+
+bool OcclusionState::isOccluded(ItemID id) const {
+    auto entry = _entries.find(id);
+    return entry != _entries.end() && entry->second.isOccluded;
+}
+
+void OcclusionCullItems::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext,
+                             const ItemIDsBounds& inItems, ItemIDsBounds& outItems) {
+    assert(renderContext->args);
+    assert(renderContext->args->_viewFrustum);
+    RenderArgs* args = renderContext->args;
+    auto config = std::static_pointer_cast<Config>(renderContext->jobConfig);
+
+    outItems.clear();
+    if (!_cull) {
+        outItems = inItems;
+        config->numOccluded = 0;
+        return;
+    }
+
+    outItems.reserve(inItems.size());
+    for (auto& item : inItems) {
+        if (!item.bounds.isNull() && _state->isOccluded(item.id) && !isAroundEye(item.bounds, *args->_viewFrustum)) {
+            continue;
+        }
+        outItems.emplace_back(item);
+    }
+    config->numOccluded = (int)(inItems.size() - outItems.size());
+}
+
+const gpu::PipelinePointer QueryOcclusion::getQueryPipeline() {
+    if (!_queryPipeline) {
+        auto vs = gpu::Shader::createVertex(std::string(drawItemOcclusion_vert));
+        auto ps = gpu::Shader::createPixel(std::string(drawItemBounds_frag));
+        gpu::ShaderPointer program = gpu::Shader::createProgram(vs, ps);
+
+        gpu::Shader::BindingSet slotBindings;
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        _boundPosLoc = program->getUniforms().findLocation("inBoundPos");
+        _boundDimLoc = program->getUniforms().findLocation("inBoundDim");
+
+        auto state = std::make_shared<gpu::State>();
+
+        // Only test the depth, the bounds draw nothing
+        state->setDepthTest(true, false, gpu::LESS_EQUAL);
+        state->setCullMode(gpu::State::CULL_NONE);
+        state->setColorWriteMask(false, false, false, false);
+
+        _queryPipeline = gpu::Pipeline::create(program, state);
+    }
+    return _queryPipeline;
+}
+
+void QueryOcclusion::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext,
+                         const ItemIDsBounds& inItems) {
+    assert(renderContext->args);
+    assert(renderContext->args->_viewFrustum);
+    RenderArgs* args = renderContext->args;
+    uint32_t frame = ++_state->_frame;
+
+    gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+        glm::mat4 projMat;
+        Transform viewMat;
+        args->_viewFrustum->evalProjectionMatrix(projMat);
+        args->_viewFrustum->evalViewTransform(viewMat);
+        batch.setViewportTransform(args->_viewport);
+
+        batch.setProjectionTransform(projMat);
+        batch.setViewTransform(viewMat);
+        batch.setModelTransform(Transform());
+
+        batch.setPipeline(getQueryPipeline());
+
+        const unsigned int VEC3_ADRESS_OFFSET = 3;
+
+        for (auto& item : inItems) {
+            if (item.bounds.isNull() || item.bounds.isInvalid()) {
+                continue;
+            }
+
+            auto& entry = _state->_entries[item.id];
+            entry.lastQueriedFrame = frame;
+            if (!entry.query) {
+                // entries keep their address in the map, and the handler runs when the batch renders
+                auto entryPointer = &entry;
+                entry.query = std::make_shared<gpu::Query>([entryPointer](const gpu::Query& query) {
+                    entryPointer->isOccluded = (query.getResult() == 0);
+                    entryPointer->isPending = false;
+                }, gpu::Query::ANY_SAMPLES_PASSED);
+            }
+
+            // the result of the query of a frame before comes back once the gpu got to it, without waiting on it
+            if (entry.isPending) {
+                batch.getQuery(entry.query);
+                continue;
+            }
+
+            if (isAroundEye(item.bounds, *args->_viewFrustum)) {
+                entry.isOccluded = false;
+                continue;
+            }
+
+            batch.beginQuery(entry.query);
+            batch._glUniform3fv(_boundPosLoc, 1, (const float*) &item.bounds);
+            batch._glUniform3fv(_boundDimLoc, 1, ((const float*) &item.bounds) + VEC3_ADRESS_OFFSET);
+            batch.draw(gpu::TRIANGLES, 36, 0);
+            batch.endQuery(entry.query);
+            entry.isPending = true;
+        }
+    });
+
+    for (auto entry = _state->_entries.begin(); entry != _state->_entries.end();) {
+        if (frame - entry->second.lastQueriedFrame > MAX_UNQUERIED_FRAMES) {
+            entry = _state->_entries.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+}
@@ -0,0 +1,91 @@
+//
+//  OcclusionCulling.h
+//  render/src/render
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_OcclusionCulling_h
+#define hifi_render_OcclusionCulling_h
+
+#include <unordered_map>
+
+#include <gpu/Query.h>
+
+#include "DrawTask.h"
+
+namespace render {
+
+// The occlusion of the items as their latest queries that came back found it. QueryOcclusion draws the bound of each
+// item after the opaque pass; an item whose bound had no sample pass the depth test is then left out by
+// OcclusionCullItems, until a later query finds it in view again.
+class OcclusionState {
+public:
+    class Entry {
+    public:
+        gpu::QueryPointer query;
+        bool isPending { false };
+        bool isOccluded { false };
+        uint32_t lastQueriedFrame { 0 };
+    };
+
+    std::unordered_map<ItemID, Entry> _entries;
+    uint32_t _frame { 0 };
+
+    bool isOccluded(ItemID id) const;
+};
+using OcclusionStatePointer = std::shared_ptr<OcclusionState>;
+
+class OcclusionCullItemsConfig : public Job::Config {
+    Q_OBJECT
+    Q_PROPERTY(int numOccluded READ getNumOccluded)
+    Q_PROPERTY(bool cull MEMBER cull NOTIFY dirty)
+public:
+    int getNumOccluded() { return numOccluded; }
+
+    int numOccluded{ 0 };
+    bool cull{ true };
+signals:
+    void dirty();
+};
+
+class OcclusionCullItems {
+public:
+    using Config = OcclusionCullItemsConfig;
+    using JobModel = Job::ModelIO<OcclusionCullItems, ItemIDsBounds, ItemIDsBounds, Config>;
+
+    OcclusionCullItems(const OcclusionStatePointer& state) : _state(state) {}
+
+    void configure(const Config& config) { _cull = config.cull; }
+    void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outItems);
+
+protected:
+    OcclusionStatePointer _state;
+    bool _cull; // initialized by Config
+};
+
+// Runs once the opaque items are in the depth buffer, with all the items the occlusion culling was given
+class QueryOcclusion {
+public:
+    using JobModel = Job::ModelI<QueryOcclusion, ItemIDsBounds>;
+
+    QueryOcclusion(const OcclusionStatePointer& state) : _state(state) {}
+
+    void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems);
+
+    const gpu::PipelinePointer getQueryPipeline();
+
+protected:
+    OcclusionStatePointer _state;
+
+    int _boundPosLoc = -1;
+    int _boundDimLoc = -1;
+    gpu::PipelinePointer _queryPipeline;
+};
+
+}
+
+#endif // hifi_render_OcclusionCulling_h
@@ -10,11 +10,42 @@
 //
 #include "Scene.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
 #include <numeric>
 #include "gpu/Batch.h"
 
 using namespace render;
 
+void ItemIDSet::flush() {
+    if (_changes.empty()) {
+        return;
+    }
+    ItemIDs inserted;
+    ItemIDs erased;
+    for (auto& change : _changes) {
+        (change.second ? inserted : erased).push_back(change.first);
+    }
+    _changes.clear();
+    std::sort(inserted.begin(), inserted.end());
+    std::sort(erased.begin(), erased.end());
+
+    // one pass over the set drops the erased ids, then the inserted ones merge in
+    if (!erased.empty()) {
+        auto end = std::remove_if(_ids.begin(), _ids.end(), [&](ItemID id) {
+            return std::binary_search(erased.begin(), erased.end(), id);
+        });
+        _ids.erase(end, _ids.end());
+    }
+    if (!inserted.empty()) {
+        ItemIDs merged;
+        merged.reserve(_ids.size() + inserted.size());
+        std::set_union(_ids.begin(), _ids.end(), inserted.begin(), inserted.end(), std::back_inserter(merged));
+        _ids.swap(merged);
+    }
+}
+
 void ItemBucketMap::insert(const ItemID& id, const ItemKey& key) {
     // Insert the itemID in every bucket where it filters true
     for (auto& bucket : (*this)) {
@@ -47,6 +78,12 @@ void ItemBucketMap::reset(const ItemID& id, const ItemKey& oldKey, const ItemKey
     }
 }
 
+void ItemBucketMap::flush() {
+    for (auto& bucket : (*this)) {
+        bucket.second.flush();
+    }
+}
+
 void ItemBucketMap::allocateStandardOpaqueTranparentBuckets() {
     (*this)[ItemFilter::Builder::opaqueShape().withoutLayered()];
     (*this)[ItemFilter::Builder::transparentShape().withoutLayered()];
@@ -136,9 +173,19 @@ void PendingChanges::merge(PendingChanges& changes) {
     _updateFunctors.insert(_updateFunctors.end(), changes._updateFunctors.begin(), changes._updateFunctors.end());
 }
 
+const float Scene::DEFAULT_CHANGES_TIME_BUDGET = 2.0f;
+
 Scene::Scene() {
     _items.push_back(Item()); // add the itemID #0 to nothing
+    _itemKeys.push_back(ItemKey());
+    _itemBounds.push_back(Item::Bound());
+    _itemChangeFrames.push_back(0);
     _masterBucketMap.allocateStandardOpaqueTranparentBuckets();
+    _unindexedBucketMap.allocateStandardOpaqueTranparentBuckets();
+}
+
+Scene::~Scene() {
+    takeEnqueuedChanges();
 }
 
 ItemID Scene::allocateID() {
@@ -148,43 +195,71 @@ ItemID Scene::allocateID() {
 
 /// Enqueue change batch to the scene
 void Scene::enqueuePendingChanges(const PendingChanges& pendingChanges) {
-    _changeQueueMutex.lock();
-    _changeQueue.push(pendingChanges);
-    _changeQueueMutex.unlock();
+    auto node = new PendingChangesNode(pendingChanges);
+    node->next = _enqueuedChanges.load();
+    while (!_enqueuedChanges.compare_exchange_weak(node->next, node)) {
+    }
 }
 
-void consolidateChangeQueue(PendingChangesQueue& queue, PendingChanges& singleBatch) {
-    while (!queue.empty()) {
-        auto pendingChanges = queue.front();
-        singleBatch.merge(pendingChanges);
-        queue.pop();
-    };
+void Scene::takeEnqueuedChanges() {
+    // the list is the latest first, it gets turned around to queue the changes in the order they came
+    PendingChangesNode* latest = _enqueuedChanges.exchange(nullptr);
+    PendingChangesNode* earliest = nullptr;
+    while (latest) {
+        auto next = latest->next;
+        latest->next = earliest;
+        earliest = latest;
+        latest = next;
+    }
+    while (earliest) {
+        auto next = earliest->next;
+        _changeQueue.push(std::move(earliest->changes));
+        delete earliest;
+        earliest = next;
+    }
 }
- 
+
 void Scene::processPendingChangesQueue() {
     PROFILE_RANGE(__FUNCTION__);
-    _changeQueueMutex.lock();
-    PendingChanges consolidatedPendingChanges;
-    consolidateChangeQueue(_changeQueue, consolidatedPendingChanges);
-    _changeQueueMutex.unlock();
-    
+    _frame++;
+    takeEnqueuedChanges();
+    if (_changeQueue.empty()) {
+        return;
+    }
+
     _itemsMutex.lock();
         // Here we should be able to check the value of last ItemID allocated 
         // and allocate new items accordingly
         ItemID maxID = _IDAllocator.load();
         if (maxID > _items.size()) {
             _items.resize(maxID + 100); // allocate the maxId and more
+            _itemKeys.resize(_items.size());
+            _itemBounds.resize(_items.size());
+            _itemChangeFrames.resize(_items.size());
         }
+
         // Now we know for sure that we have enough items in the array to
         // capture anything coming from the pendingChanges
-        resetItems(consolidatedPendingChanges._resetItems, consolidatedPendingChanges._resetPayloads);
-        updateItems(consolidatedPendingChanges._updatedItems, consolidatedPendingChanges._updateFunctors);
-        removeItems(consolidatedPendingChanges._removedItems);
+        auto start = std::chrono::high_resolution_clock::now();
+        do {
+            applyChanges(_changeQueue.front());
+            _changeQueue.pop();
+        } while (!_changeQueue.empty() && std::chrono::duration<float, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count() < _changesTimeBudget);
+
+        _masterBucketMap.flush();
+        _unindexedBucketMap.flush();
 
      // ready to go back to rendering activities
     _itemsMutex.unlock();
 }
 
+void Scene::applyChanges(PendingChanges& changes) {
+    resetItems(changes._resetItems, changes._resetPayloads);
+    updateItems(changes._updatedItems, changes._updateFunctors);
+    removeItems(changes._removedItems);
+}
+
 void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
     auto resetID = ids.begin();
     auto resetPayload = payloads.begin();
@@ -194,6 +269,12 @@ void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
         item.resetPayload(*resetPayload);
 
         _masterBucketMap.reset((*resetID), oldKey, item.getKey());
+        _itemKeys[(*resetID)] = item.getKey();
+        _itemChangeFrames[(*resetID)] = _frame;
+        if (item.getKey().isSpatiallyIndexed()) {
+            _itemBounds[(*resetID)] = item.getBound();
+        }
+        updateSpatialIndex((*resetID), oldKey);
     }
 
 }
@@ -201,7 +282,14 @@ void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
 void Scene::removeItems(const ItemIDs& ids) {
     for (auto removedID :ids) {
         _masterBucketMap.erase(removedID, _items[removedID].getKey());
+        if (_spatialTree.contains(removedID)) {
+            _spatialTree.erase(removedID);
+        } else {
+            _unindexedBucketMap.erase(removedID, _items[removedID].getKey());
+        }
         _items[removedID].kill();
+        _itemKeys[removedID] = ItemKey();
+        _itemChangeFrames[removedID] = _frame;
     }
 }
 
@@ -209,6 +297,33 @@ void Scene::updateItems(const ItemIDs& ids, UpdateFunctors& functors) {
     auto updateID = ids.begin();
     auto updateFunctor = functors.begin();
     for (;updateID != ids.end(); updateID++, updateFunctor++) {
-        _items[(*updateID)].update((*updateFunctor));
+        auto& item = _items[(*updateID)];
+        if (!item._payload) {
+            continue; // removed, or its reset is still to come
+        }
+        item.update((*updateFunctor));
+        _itemChangeFrames[(*updateID)] = _frame;
+        if (_itemKeys[(*updateID)].isSpatiallyIndexed()) {
+            _itemBounds[(*updateID)] = item.getBound();
+            _spatialTree.update((*updateID), _itemBounds[(*updateID)]);
+        }
+    }
+}
+
+void Scene::updateSpatialIndex(ItemID id, const ItemKey& oldKey) {
+    const auto& item = _items[id];
+    auto newKey = item.getKey();
+    if (_spatialTree.contains(id)) {
+        if (newKey.isSpatiallyIndexed()) {
+            _spatialTree.update(id, _itemBounds[id]);
+        } else {
+            _spatialTree.erase(id);
+            _unindexedBucketMap.insert(id, newKey);
+        }
+    } else if (newKey.isSpatiallyIndexed()) {
+        _unindexedBucketMap.erase(id, oldKey);
+        _spatialTree.update(id, _itemBounds[id]);
+    } else {
+        _unindexedBucketMap.reset(id, oldKey, newKey);
     }
 }
@@ -18,7 +18,7 @@
 #include <memory>
 #include <mutex>
 #include <queue>
-#include <set>
+#include <unordered_map>
 #include <vector>
 
 #include <AABox.h>
@@ -26,6 +26,7 @@
 
 #include "model/Material.h"
 #include "ShapePipeline.h"
+#include "SpatialTree.h"
 
 namespace render {
 
@@ -45,6 +46,8 @@ public:
         SHADOW_CASTER,    // Item cast shadows
         PICKABLE,         // Item can be picked/selected
         LAYERED,          // Item belongs to one of the layers different from the default layer
+        THREAD_SAFE,      // Item can be rendered on a worker thread, once it was prepared on the render thread
+        SPATIALLY_INDEXED, // Bound only changes through PendingChanges, so the item can be culled in the spatial tree
 
         NUM_FLAGS,      // Not a valid flag
     };
@@ -74,6 +77,8 @@ public:
         Builder& withShadowCaster() { _flags.set(SHADOW_CASTER); return (*this); }
         Builder& withPickable() { _flags.set(PICKABLE); return (*this); }
         Builder& withLayered() { _flags.set(LAYERED); return (*this); }
+        Builder& withThreadSafe() { _flags.set(THREAD_SAFE); return (*this); }
+        Builder& withSpatiallyIndexed() { _flags.set(SPATIALLY_INDEXED); return (*this); }
 
         // Convenient standard keys that we will keep on using all over the place
         static Builder opaqueShape() { return Builder().withTypeShape(); }
@@ -106,6 +111,10 @@ public:
     bool isPickable() const { return _flags[PICKABLE]; }
 
     bool isLayered() const { return _flags[LAYERED]; }
+
+    bool isThreadSafe() const { return _flags[THREAD_SAFE]; }
+
+    bool isSpatiallyIndexed() const { return _flags[SPATIALLY_INDEXED]; }
 };
 
 inline QDebug operator<<(QDebug debug, const ItemKey& itemKey) {
@@ -266,6 +275,7 @@ public:
         virtual const Bound getBound() const = 0;
         virtual int getLayer() const = 0;
 
+        virtual void prepare(RenderArgs* args) = 0;
         virtual void render(RenderArgs* args) = 0;
 
         virtual const ShapeKey getShapeKey() const = 0;
@@ -304,6 +314,9 @@ public:
     // Get the layer where the item belongs. 0 by default meaning NOT LAYERED
     int getLayer() const { return _payload->getLayer(); }
 
+    // Prepare call for the item, on the render thread before it renders on any other
+    void prepare(RenderArgs* args) const { _payload->prepare(args); }
+
     // Render call for the item
     void render(RenderArgs* args) const { _payload->render(args); }
 
@@ -347,6 +360,7 @@ inline QDebug operator<<(QDebug debug, const Item& item) {
 template <class T> const ItemKey payloadGetKey(const std::shared_ptr<T>& payloadData) { return ItemKey(); }
 template <class T> const Item::Bound payloadGetBound(const std::shared_ptr<T>& payloadData) { return Item::Bound(); }
 template <class T> int payloadGetLayer(const std::shared_ptr<T>& payloadData) { return 0; }
+template <class T> void payloadPrepare(const std::shared_ptr<T>& payloadData, RenderArgs* args) { }
 template <class T> void payloadRender(const std::shared_ptr<T>& payloadData, RenderArgs* args) { }
     
 // Shape type interface
@@ -368,6 +382,7 @@ public:
     virtual int getLayer() const { return payloadGetLayer<T>(_data); }
 
 
+    virtual void prepare(RenderArgs* args) { payloadPrepare<T>(_data, args); }
     virtual void render(RenderArgs* args) { payloadRender<T>(_data, args); } 
 
     // Shape Type interface
@@ -421,7 +436,26 @@ typedef std::vector< PayloadPointer > Payloads;
 // A few typedefs for standard containers of ItemIDs 
 typedef Item::ID ItemID;
 typedef std::vector<ItemID> ItemIDs;
-typedef std::set<ItemID> ItemIDSet;
+
+// A set of ItemIDs kept as one sorted vector. Inserts and erases wait in the set until flush merges them all at once,
+// so the set only reads as changed once the scene flushed its changes.
+class ItemIDSet {
+public:
+    using const_iterator = ItemIDs::const_iterator;
+
+    void insert(ItemID id) { _changes[id] = true; }
+    void erase(ItemID id) { _changes[id] = false; }
+    void flush();
+
+    const_iterator begin() const { return _ids.begin(); }
+    const_iterator end() const { return _ids.end(); }
+    size_t size() const { return _ids.size(); }
+    bool empty() const { return _ids.empty(); }
+
+protected:
+    ItemIDs _ids;
+    std::unordered_map<ItemID, bool> _changes; // whether each changed item ends up in the set
+};
 
 class ItemIDAndBounds {
 public:
@@ -449,6 +483,9 @@ public:
     void erase(const ItemID& id, const ItemKey& key);
     void reset(const ItemID& id, const ItemKey& oldKey, const ItemKey& newKey);
 
+    // merges the changes into all the buckets
+    void flush();
+
     // standard builders allocating the main buckets
     void allocateStandardOpaqueTranparentBuckets();
     
@@ -459,7 +496,6 @@ class Engine;
 class PendingChanges {
 public:
     PendingChanges() {}
-    ~PendingChanges() {}
 
     void resetItem(ItemID id, const PayloadPointer& payload);
     void removeItem(ItemID id);
@@ -482,47 +518,92 @@ protected:
 };
 typedef std::queue<PendingChanges> PendingChangesQueue;
 
+// A PendingChanges waiting to be taken by the scene, in a list that any thread pushes on without locking
+class PendingChangesNode {
+public:
+    PendingChangesNode(const PendingChanges& changes) : changes(changes) {}
+
+    PendingChanges changes;
+    PendingChangesNode* next { nullptr };
+};
+
 
 // Scene is a container for Items
 // Items are introduced, modified or erased in the scene through PendingChanges
-// Once per Frame, the PendingChanges are all flushed
+// Once per Frame, the PendingChanges are flushed in the order they came, as many as fit in the time budget
 // During the flush the standard buckets are updated
 // Items are notified accordingly on any update message happening
 class Scene {
 public:
     Scene();
-    ~Scene() {}
+    ~Scene();
 
     /// This call is thread safe, can be called from anywhere to allocate a new ID
     ItemID allocateID();
 
     /// Enqueue change batch to the scene
+    /// This call is thread safe and doesn't lock, can be called from anywhere
     void enqueuePendingChanges(const PendingChanges& pendingChanges);
 
+    /// How long processPendingChangesQueue can take, in msecs; the changes left over wait for the next frame
+    /// The first PendingChanges in the queue always goes through
+    static const float DEFAULT_CHANGES_TIME_BUDGET;
+    void setChangesTimeBudget(float msecs) { _changesTimeBudget = msecs; }
+    float getChangesTimeBudget() const { return _changesTimeBudget; }
+    size_t getNumQueuedChanges() const { return _changeQueue.size(); }
+
     /// Access the main bucketmap of items
     const ItemBucketMap& getMasterBucket() const { return _masterBucketMap; }
 
+    /// The spatially indexed items are in the spatial tree, and all the others in the unindexed bucketmap
+    const ItemSpatialTree& getSpatialTree() const { return _spatialTree; }
+    const ItemBucketMap& getUnindexedBucket() const { return _unindexedBucketMap; }
+
     /// Access a particular item form its ID
     /// WARNING, There is No check on the validity of the ID, so this could return a bad Item
     const Item& getItem(const ItemID& id) const { return _items[id]; }
 
     size_t getNumItems() const { return _items.size(); }
 
+    /// The keys and bounds of the items side by side, for the jobs going through many of them
+    /// The bounds of the spatially indexed items only change with the pending changes, so theirs are cached
+    const ItemKey& getItemKey(const ItemID& id) const { return _itemKeys[id]; }
+    const Item::Bound getItemBound(const ItemID& id) const {
+        return _itemKeys[id].isSpatiallyIndexed() ? _itemBounds[id] : _items[id].getBound();
+    }
+
+    /// The frames are counted by processPendingChangesQueue, and each item keeps the frame it was last reset, updated
+    /// or removed in, so that the jobs can tell the items that haven't changed in a while
+    uint32_t getFrame() const { return _frame; }
+    uint32_t getItemChangeFrame(const ItemID& id) const { return _itemChangeFrames[id]; }
+
 
     void processPendingChangesQueue();
 
 protected:
     // Thread safe elements that can be accessed from anywhere
     std::atomic<unsigned int> _IDAllocator{ 1 }; // first valid itemID will be One
-    std::mutex _changeQueueMutex;
+    std::atomic<PendingChangesNode*> _enqueuedChanges{ nullptr }; // the latest first
+
+    // The changes taken from the enqueued ones and not applied yet, only touched while processing them
     PendingChangesQueue _changeQueue;
+    float _changesTimeBudget { DEFAULT_CHANGES_TIME_BUDGET };
 
     // The actual database
     // database of items is protected for editing by a mutex
     std::mutex _itemsMutex;
     Item::Vector _items;
+    std::vector<ItemKey> _itemKeys;
+    std::vector<Item::Bound> _itemBounds;
+    std::vector<uint32_t> _itemChangeFrames;
+    uint32_t _frame { 0 };
     ItemBucketMap _masterBucketMap;
+    ItemSpatialTree _spatialTree;
+    ItemBucketMap _unindexedBucketMap;
 
+    void takeEnqueuedChanges();
+    void applyChanges(PendingChanges& changes);
+    void updateSpatialIndex(ItemID id, const ItemKey& oldKey);
     void resetItems(const ItemIDs& ids, Payloads& payloads);
     void removeItems(const ItemIDs& ids);
     void updateItems(const ItemIDs& ids, UpdateFunctors& functors);
@@ -13,7 +13,7 @@
 
 #include "ShapePipeline.h"
 
-#include <PerfStat.h>
+#include <shared/Trace.h>
 
 using namespace render;
 
@@ -34,6 +34,15 @@ void ShapePlumber::addPipelineHelper(const Filter& filter, ShapeKey key, int bit
     } else {
         // Add the brand new pipeline and cache its location in the lib
         _pipelineMap.insert(PipelineMap::value_type(key, pipeline));
+
+        if (_pipelineTable.empty()) {
+            _pipelineTable.resize(1 << ShapeKey::FlagBit::NUM_FLAGS);
+        }
+        PipelinePointer& tablePipeline = _pipelineTable[key._flags.to_ulong()];
+        if (!tablePipeline) {
+            // as the map keeps the first pipeline added for a key
+            tablePipeline = pipeline;
+        }
     }
 }
 
@@ -74,29 +83,38 @@ void ShapePlumber::addPipeline(const Filter& filter, const gpu::ShaderPointer& p
     addPipelineHelper(filter, key, 0, shapePipeline);
 }
 
+void ShapePipeline::prepare(gpu::Batch& batch) const {
+    // Run the pipeline's BatchSetter on the passed in batch
+    if (batchSetter) {
+        batchSetter(*this, batch);
+    }
+
+    // Setup the one pipeline (to rule them all)
+    batch.setPipeline(pipeline);
+}
+
 const ShapePipelinePointer ShapePlumber::pickPipeline(RenderArgs* args, const Key& key) const {
     assert(!_pipelineMap.empty());
     assert(args);
     assert(args->_batch);
 
-    PerformanceTimer perfTimer("ShapePlumber::pickPipeline");
+    TRACE_SCOPE("ShapePlumber::pickPipeline");
 
-    const auto& pipelineIterator = _pipelineMap.find(key);
-    if (pipelineIterator == _pipelineMap.end()) {
+    const PipelinePointer& shapePipeline = lookupPipeline(key);
+    if (!shapePipeline) {
         qDebug() << "Couldn't find a pipeline from ShapeKey ?" << key;
         return PipelinePointer(nullptr);
     }
 
-    PipelinePointer shapePipeline(pipelineIterator->second);
-    auto& batch = args->_batch;
-
-    // Run the pipeline's BatchSetter on the passed in batch
-    if (shapePipeline->batchSetter) {
-        shapePipeline->batchSetter(*shapePipeline, *batch);
-    }
-
-    // Setup the one pipeline (to rule them all)
-    batch->setPipeline(shapePipeline->pipeline);
+    shapePipeline->prepare(*args->_batch);
 
     return shapePipeline;
 }
+
+const ShapePipelinePointer& ShapePlumber::lookupPipeline(const Key& key) const {
+    static const PipelinePointer NO_PIPELINE;
+    if (_pipelineTable.empty()) {
+        return NO_PIPELINE;
+    }
+    return _pipelineTable[key._flags.to_ulong()];
+}
@@ -212,6 +212,9 @@ public:
     gpu::PipelinePointer pipeline;
     std::shared_ptr<Locations> locations;
 
+    // runs the batch setter and sets the pipeline on the batch
+    void prepare(gpu::Batch& batch) const;
+
 protected:
     friend class ShapePlumber;
 
@@ -238,9 +241,15 @@ public:
 
     const PipelinePointer pickPipeline(RenderArgs* args, const Key& key) const;
 
+    /// the pipeline of the key, without preparing it on a batch, null if there is none
+    const PipelinePointer& lookupPipeline(const Key& key) const;
+
 protected:
     void addPipelineHelper(const Filter& filter, Key key, int bit, const PipelinePointer& pipeline);
     PipelineMap _pipelineMap;
+
+    // the pipelines again, indexed by the bits of their keys, so that a pick per item doesn't hash
+    std::vector<PipelinePointer> _pipelineTable;
 };
 using ShapePlumberPointer = std::shared_ptr<ShapePlumber>;
 
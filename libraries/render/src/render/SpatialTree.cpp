@@ -0,0 +1,174 @@
+//
+//  SpatialTree.cpp
+//  render/src/render
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatialTree.h"
+
+#include <algorithm>
+
+#include <ViewFrustum.h>
+
+using namespace render;
+
+const float ItemSpatialTree::ROOT_SCALE = 32768.0f;
+const int ItemSpatialTree::MAX_DEPTH = 12;
+
+// a key is the depth of the cell then its coordinates at that depth, the root is 0
+static const int COORD_BITS = 20;
+static const uint64_t COORD_MASK = (1ULL << COORD_BITS) - 1;
+static const uint64_t ROOT_KEY = 0;
+
+static uint64_t makeKey(int depth, const glm::ivec3& coords) {
+    return ((uint64_t)depth << (3 * COORD_BITS)) | ((uint64_t)coords.x << (2 * COORD_BITS)) |
+        ((uint64_t)coords.y << COORD_BITS) | (uint64_t)coords.z;
+}
+
+static int getDepth(uint64_t key) {
+    return (int)(key >> (3 * COORD_BITS));
+}
+
+static glm::ivec3 getCoords(uint64_t key) {
+    return glm::ivec3((key >> (2 * COORD_BITS)) & COORD_MASK, (key >> COORD_BITS) & COORD_MASK, key & COORD_MASK);
+}
+
+static uint64_t getParentKey(uint64_t key) {
+    return makeKey(getDepth(key) - 1, getCoords(key) >> 1);
+}
+
+static uint8_t getBitInParent(uint64_t key) {
+    glm::ivec3 coords = getCoords(key) & 1;
+    return (uint8_t)(1 << (coords.x | (coords.y << 1) | (coords.z << 2)));
+}
+
+static uint64_t getChildKey(uint64_t key, int child) {
+    glm::ivec3 coords = getCoords(key) * 2 + glm::ivec3(child & 1, (child >> 1) & 1, (child >> 2) & 1);
+    return makeKey(getDepth(key) + 1, coords);
+}
+
+ItemSpatialTree::CellKey ItemSpatialTree::evalCellKey(const AABox& bound) {
+    if (bound.isInvalid() || bound.isNull()) {
+        return ROOT_KEY;
+    }
+    glm::vec3 unit = bound.calcCenter() / ROOT_SCALE + 0.5f;
+    if (glm::any(glm::lessThan(unit, glm::vec3(0.0f))) || glm::any(glm::greaterThanEqual(unit, glm::vec3(1.0f)))) {
+        return ROOT_KEY;
+    }
+
+    // a cell holds the items up to its own size, as long as their center is in it
+    float size = bound.getLargestDimension();
+    float cellScale = ROOT_SCALE;
+    int depth = 0;
+    while (depth < MAX_DEPTH && size <= cellScale * 0.5f) {
+        cellScale *= 0.5f;
+        depth++;
+    }
+    int numCells = 1 << depth;
+    glm::ivec3 coords = glm::clamp(glm::ivec3(unit * (float)numCells), glm::ivec3(0), glm::ivec3(numCells - 1));
+    return makeKey(depth, coords);
+}
+
+AABox ItemSpatialTree::evalLooseBound(CellKey key) {
+    float cellScale = ROOT_SCALE / (float)(1 << getDepth(key));
+    glm::vec3 corner = glm::vec3(getCoords(key)) * cellScale - 0.5f * ROOT_SCALE;
+    return AABox(corner - 0.5f * cellScale, 2.0f * cellScale);
+}
+
+void ItemSpatialTree::update(ID id, const AABox& bound) {
+    CellKey key = evalCellKey(bound);
+    auto location = _locations.find(id);
+    if (location != _locations.end()) {
+        if (location->second == key) {
+            return;
+        }
+        eraseFromCell(id, location->second);
+        location->second = key;
+    } else {
+        _locations[id] = key;
+    }
+    insertInCell(id, key);
+}
+
+void ItemSpatialTree::erase(ID id) {
+    auto location = _locations.find(id);
+    if (location != _locations.end()) {
+        eraseFromCell(id, location->second);
+        _locations.erase(location);
+    }
+}
+
+void ItemSpatialTree::insertInCell(ID id, CellKey key) {
+    _cells[key].items.push_back(id);
+
+    // link the cell up to the root, the cells on the way might be new
+    while (key != ROOT_KEY) {
+        uint8_t bit = getBitInParent(key);
+        key = getParentKey(key);
+        auto& parent = _cells[key];
+        if (parent.children & bit) {
+            break;
+        }
+        parent.children |= bit;
+    }
+}
+
+void ItemSpatialTree::eraseFromCell(ID id, CellKey key) {
+    auto cell = _cells.find(key);
+    if (cell == _cells.end()) {
+        return;
+    }
+    auto& items = cell->second.items;
+    auto item = std::find(items.begin(), items.end(), id);
+    if (item != items.end()) {
+        *item = items.back();
+        items.pop_back();
+    }
+
+    // drop the cells left with nothing below them, but keep the root
+    while (key != ROOT_KEY && cell->second.items.empty() && cell->second.children == 0) {
+        uint8_t bit = getBitInParent(key);
+        _cells.erase(cell);
+        key = getParentKey(key);
+        cell = _cells.find(key);
+        if (cell == _cells.end()) {
+            break;
+        }
+        cell->second.children &= ~bit;
+    }
+}
+
+void ItemSpatialTree::selectItems(const ViewFrustum& frustum, IDs& outItems) const {
+    // the root holds the items that fit nowhere else, they are always selected
+    selectCellItems(ROOT_KEY, false, frustum, outItems);
+}
+
+void ItemSpatialTree::selectCellItems(CellKey key, bool isInside, const ViewFrustum& frustum, IDs& outItems) const {
+    auto cell = _cells.find(key);
+    if (cell == _cells.end()) {
+        return;
+    }
+    outItems.insert(outItems.end(), cell->second.items.begin(), cell->second.items.end());
+
+    const int NUM_CHILDREN = 8;
+    for (int child = 0; child < NUM_CHILDREN; child++) {
+        if (!(cell->second.children & (1 << child))) {
+            continue;
+        }
+        CellKey childKey = getChildKey(key, child);
+        bool isChildInside = isInside;
+        if (!isInside) {
+            // once a cell is all in view, so are the ones below it
+            auto location = frustum.boxInFrustum(evalLooseBound(childKey));
+            if (location == ViewFrustum::OUTSIDE) {
+                continue;
+            }
+            isChildInside = (location == ViewFrustum::INSIDE);
+        }
+        selectCellItems(childKey, isChildInside, frustum, outItems);
+    }
+}
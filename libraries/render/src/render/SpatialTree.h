@@ -0,0 +1,68 @@
+//
+//  SpatialTree.h
+//  render/src/render
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_SpatialTree_h
+#define hifi_render_SpatialTree_h
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <AABox.h>
+
+class ViewFrustum;
+
+namespace render {
+
+// A loose octree of the items by their bound. An item goes in the deepest cell at least as big as its bound, picked by the
+// center of the bound, and the cells reach out by half their size on each side so that they hold all of their items.
+// Items too big or too far out for the tree stay in the root cell, with those that have no bound.
+class ItemSpatialTree {
+public:
+    using ID = uint32_t;
+    using IDs = std::vector<ID>;
+
+    static const float ROOT_SCALE; // in meters, centered on the origin
+    static const int MAX_DEPTH;
+
+    // Inserts the item or moves it to the cell of its new bound
+    void update(ID id, const AABox& bound);
+    void erase(ID id);
+
+    bool contains(ID id) const { return _locations.find(id) != _locations.end(); }
+    size_t getNumItems() const { return _locations.size(); }
+    size_t getNumCells() const { return _cells.size(); }
+
+    // Appends the items of all the cells that the frustum doesn't see as outside
+    void selectItems(const ViewFrustum& frustum, IDs& outItems) const;
+
+protected:
+    using CellKey = uint64_t;
+
+    class Cell {
+    public:
+        IDs items;
+        uint8_t children { 0 }; // a bit for each child cell holding items
+    };
+
+    std::unordered_map<CellKey, Cell> _cells;
+    std::unordered_map<ID, CellKey> _locations;
+
+    static CellKey evalCellKey(const AABox& bound);
+    static AABox evalLooseBound(CellKey key);
+
+    void insertInCell(ID id, CellKey key);
+    void eraseFromCell(ID id, CellKey key);
+    void selectCellItems(CellKey key, bool isInside, const ViewFrustum& frustum, IDs& outItems) const;
+};
+
+}
+
+#endif // hifi_render_SpatialTree_h
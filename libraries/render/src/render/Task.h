@@ -12,12 +12,17 @@
 #ifndef hifi_render_Task_h
 #define hifi_render_Task_h
 
+#include <chrono>
+
 #include <qscriptengine.h> // QObject
 
 #include "Context.h"
 
 #include "gpu/Batch.h"
+#include "gpu/Context.h"
+#include "gpu/Query.h"
 #include <PerfStat.h>
+#include <shared/Trace.h>
 
 namespace render {
 
@@ -57,14 +62,22 @@ class JobNoIO {};
 // A default Config is always on; to create an enableable Config, use the ctor JobConfig(bool enabled)
 class JobConfig : public QObject {
     Q_OBJECT
+    Q_PROPERTY(double cpuTime READ getCpuTime)
+    Q_PROPERTY(double gpuTime READ getGpuTime)
 public:
     JobConfig() = default;
     JobConfig(bool enabled) : alwaysEnabled{ false }, enabled{ enabled } {}
 
     bool isEnabled() { return alwaysEnabled || enabled; }
 
+    // in milliseconds, the cpu time of the last run and a late average of the gpu time (tasks leave that to their jobs)
+    double getCpuTime() const { return cpuTime; }
+    double getGpuTime() const { return gpuTime; }
+
     bool alwaysEnabled{ true };
     bool enabled{ true };
+    double cpuTime{ 0.0 };
+    double gpuTime{ 0.0 };
 };
 
 class TaskConfig : public JobConfig {
@@ -135,6 +148,8 @@ public:
 
         virtual void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) = 0;
 
+        virtual bool isTask() const { return false; }
+
     protected:
         QConfigPointer _config;
     };
@@ -173,7 +188,7 @@ public:
     template <class T, class O, class C = Config> using ModelO = Model<T, C, None, O>;
     template <class T, class I, class O, class C = Config> using ModelIO = Model<T, C, I, O>;
 
-    Job(std::string name, ConceptPointer concept) : _concept(concept), _name(name) {}
+    Job(std::string name, ConceptPointer concept) : _concept(concept), _name(name), _traceName(trace::intern(name)) {}
 
     const Varying getInput() const { return _concept->getInput(); }
     const Varying getOutput() const { return _concept->getOutput(); }
@@ -189,13 +204,45 @@ public:
     void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
         PerformanceTimer perfTimer(_name.c_str());
         PROFILE_RANGE(_name.c_str());
+        TRACE_SCOPE(_traceName);
 
+        auto config = std::static_pointer_cast<JobConfig>(_concept->getConfiguration());
+        if (!config->isEnabled()) {
+            return;
+        }
+
+        // the timer queries of a task would be around those of its jobs, and they don't nest
+        std::shared_ptr<gpu::Context> gpuContext;
+        if (!_concept->isTask() && renderContext->args) {
+            gpuContext = renderContext->args->_context;
+        }
+        if (gpuContext) {
+            gpu::doInBatch(gpuContext, [&](gpu::Batch& batch) {
+                batch.enableStereo(false);
+                _gpuTimer->begin(batch);
+            });
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
         _concept->run(sceneContext, renderContext);
+        config->cpuTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        if (gpuContext) {
+            gpu::doInBatch(gpuContext, [&](gpu::Batch& batch) {
+                batch.enableStereo(false);
+                _gpuTimer->end(batch);
+            });
+            config->gpuTime = _gpuTimer->getAverage();
+        }
     }
 
     protected:
     ConceptPointer _concept;
     std::string _name = "";
+    const char* _traceName; // the name outlives the job, the trace is read later
+
+    // shared, the queries hold on to it and the jobs get copied as they are added
+    std::shared_ptr<gpu::RangeTimer> _gpuTimer { std::make_shared<gpu::RangeTimer>() };
 };
 
 // A task is a specialized job to run a collection of other jobs
@@ -227,6 +274,8 @@ public:
             applyConfiguration();
         }
 
+        bool isTask() const override { return true; }
+
         void applyConfiguration() {
             jobConfigure(_data, *std::static_pointer_cast<C>(_config));
         }
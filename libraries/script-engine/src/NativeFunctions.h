@@ -0,0 +1,54 @@
+//
+//  NativeFunctions.h
+//  libraries/script-engine/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NativeFunctions_h
+#define hifi_NativeFunctions_h
+
+#include <QtScript/QScriptContext>
+#include <QtScript/QScriptEngine>
+#include <QtScript/QScriptValue>
+
+// A call of a slot of a scripting object goes through the meta-object of the object, matching the overloads of the slot
+// against the arguments and converting them to variants and back.  The small functions called the most can instead
+// be native functions put in place of their slots, which take their arguments straight from the script values.  A
+// native function only takes the arguments it expects, and hands others to the slot it replaced.
+
+// replaces the slot of the object by the native function, keeping the slot as the data of the function
+inline void registerNativeFunction(QScriptEngine* engine, QScriptValue object, const QString& name,
+                                   QScriptEngine::FunctionSignature function, int numArguments) {
+    QScriptValue slot = object.property(name);
+    if (!slot.isFunction()) {
+        return;
+    }
+    QScriptValue native = engine->newFunction(function, numArguments);
+    native.setData(slot);
+    object.setProperty(name, native);
+}
+
+// calls the slot a native function replaced with the arguments of its call
+inline QScriptValue callSlot(QScriptContext* context) {
+    return context->callee().data().call(context->thisObject(), context->argumentsObject());
+}
+
+// true if the call has the number of arguments and they are all objects, or numbers where the mask has a bit set
+inline bool hasArguments(QScriptContext* context, int numArguments, int numberMask = 0) {
+    if (context->argumentCount() != numArguments) {
+        return false;
+    }
+    for (int i = 0; i < numArguments; i++) {
+        QScriptValue argument = context->argument(i);
+        if (!((numberMask & (1 << i)) ? argument.isNumber() : argument.isObject())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // hifi_NativeFunctions_h
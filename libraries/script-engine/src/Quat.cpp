@@ -15,6 +15,9 @@
 
 #include <OctreeConstants.h>
 #include <GLMHelpers.h>
+#include <RegisteredMetaTypes.h>
+
+#include "NativeFunctions.h"
 #include "ScriptEngineLogging.h"
 #include "Quat.h"
 
@@ -121,3 +124,94 @@ bool Quat::equal(const glm::quat& q1, const glm::quat& q2) {
     return q1 == q2;
 }
 
+
+static glm::quat quatArgument(QScriptContext* context, int index) {
+    glm::quat q;
+    quatFromScriptValue(context->argument(index), q);
+    return q;
+}
+
+static QScriptValue nativeMultiply(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 2)) {
+        return callSlot(context);
+    }
+    return quatToScriptValue(engine, quatArgument(context, 0) * quatArgument(context, 1));
+}
+
+static QScriptValue nativeNormalize(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 1)) {
+        return callSlot(context);
+    }
+    return quatToScriptValue(engine, glm::normalize(quatArgument(context, 0)));
+}
+
+static QScriptValue nativeConjugate(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 1)) {
+        return callSlot(context);
+    }
+    return quatToScriptValue(engine, glm::conjugate(quatArgument(context, 0)));
+}
+
+static QScriptValue nativeInverse(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 1)) {
+        return callSlot(context);
+    }
+    return quatToScriptValue(engine, glm::inverse(quatArgument(context, 0)));
+}
+
+static QScriptValue nativeGetFront(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 1)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, quatArgument(context, 0) * Vectors::FRONT);
+}
+
+static QScriptValue nativeGetRight(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 1)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, quatArgument(context, 0) * Vectors::RIGHT);
+}
+
+static QScriptValue nativeGetUp(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 1)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, quatArgument(context, 0) * Vectors::UP);
+}
+
+static QScriptValue nativeMix(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 3, 0x4)) {
+        return callSlot(context);
+    }
+    return quatToScriptValue(engine, safeMix(quatArgument(context, 0), quatArgument(context, 1),
+        (float)context->argument(2).toNumber()));
+}
+
+static QScriptValue nativeSlerp(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 3, 0x4)) {
+        return callSlot(context);
+    }
+    return quatToScriptValue(engine, glm::slerp(quatArgument(context, 0), quatArgument(context, 1),
+        (float)context->argument(2).toNumber()));
+}
+
+static QScriptValue nativeDot(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 2)) {
+        return callSlot(context);
+    }
+    return QScriptValue(glm::dot(quatArgument(context, 0), quatArgument(context, 1)));
+}
+
+void Quat::registerNativeFunctions(QScriptEngine* engine, QScriptValue object) {
+    registerNativeFunction(engine, object, "multiply", nativeMultiply, 2);
+    registerNativeFunction(engine, object, "normalize", nativeNormalize, 1);
+    registerNativeFunction(engine, object, "conjugate", nativeConjugate, 1);
+    registerNativeFunction(engine, object, "inverse", nativeInverse, 1);
+    registerNativeFunction(engine, object, "getFront", nativeGetFront, 1);
+    registerNativeFunction(engine, object, "getRight", nativeGetRight, 1);
+    registerNativeFunction(engine, object, "getUp", nativeGetUp, 1);
+    registerNativeFunction(engine, object, "mix", nativeMix, 3);
+    registerNativeFunction(engine, object, "slerp", nativeSlerp, 3);
+    registerNativeFunction(engine, object, "dot", nativeDot, 2);
+}
@@ -18,11 +18,16 @@
 
 #include <QObject>
 #include <QString>
+#include <QtScript/QScriptValue>
 
 /// Scriptable interface a Quaternion helper class object. Used exclusively in the JavaScript API
 class Quat : public QObject {
     Q_OBJECT
 
+public:
+    /// puts native functions in place of the slots called the most, in the script object of the library
+    static void registerNativeFunctions(QScriptEngine* engine, QScriptValue object);
+
 public slots:
     glm::quat multiply(const glm::quat& q1, const glm::quat& q2);
     glm::quat normalize(const glm::quat& q);
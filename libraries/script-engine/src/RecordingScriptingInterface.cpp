@@ -163,7 +163,9 @@ void RecordingScriptingInterface::startRecording() {
 void RecordingScriptingInterface::stopRecording() {
     _recorder->stop();
     _lastClip = _recorder->getClip();
-    _lastClip->seek(0);
+    if (_lastClip) {
+        _lastClip->seek(0);
+    }
 }
 
 void RecordingScriptingInterface::saveRecording(const QString& filename) {
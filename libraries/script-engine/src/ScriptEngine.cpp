@@ -55,6 +55,12 @@ std::atomic<bool> ScriptEngine::_stoppingAllScripts { false };
 
 static const QString SCRIPT_EXCEPTION_FORMAT = "[UncaughtException] %1 in %2:%3";
 
+// the share of the way to the load of each frame the smoothed script load covers
+static const float SCRIPT_LOAD_RATE = 0.1f;
+
+// the most frames a script over its frame time budget gets its updates skipped for in a row
+static const quint64 MAX_THROTTLED_FRAMES = 60;
+
 Q_DECLARE_METATYPE(QScriptEngine::FunctionSignature)
 static int functionSignatureMetaID = qRegisterMetaType<QScriptEngine::FunctionSignature>();
 
@@ -127,6 +133,38 @@ static bool hadUncaughtExceptions(QScriptEngine& engine, const QString& fileName
     return false;
 }
 
+// Entities.getEntityPositions(ids): the x, y and z of the world position of each entity in a Float32Array, without an
+// object for each position, the three NaN (which the array reads as undefined) for the entities that aren't known
+static QScriptValue getEntityPositions(QScriptContext* context, QScriptEngine* engine) {
+    QVector<QUuid> entityIDs = qVectorQUuidFromScriptValue(context->argument(0));
+    QVector<glm::vec3> positions = DependencyManager::get<EntityScriptingInterface>()->getEntityPositions(entityIDs);
+
+    QScriptValue array = engine->globalObject().property(FLOAT_32_ARRAY_CLASS_NAME).construct(
+        QScriptValueList() << positions.size() * 3);
+    quint32 length = 0;
+    char* elements = Float32ArrayClass::getElements(array, length);
+    if (elements) {
+        for (int i = 0; i < positions.size(); i++) {
+            Float32ArrayClass::setElement(elements, i * 3, positions[i].x);
+            Float32ArrayClass::setElement(elements, i * 3 + 1, positions[i].y);
+            Float32ArrayClass::setElement(elements, i * 3 + 2, positions[i].z);
+        }
+    }
+    return array;
+}
+
+ScriptEngine::ScriptTimer::ScriptTimer(ScriptEngine& engine) : _engine(engine) {
+    if (_engine._scriptTimerDepth++ == 0) {
+        _start = usecTimestampNow();
+    }
+}
+
+ScriptEngine::ScriptTimer::~ScriptTimer() {
+    if (--_engine._scriptTimerDepth == 0) {
+        _engine._scriptTime += usecTimestampNow() - _start;
+    }
+}
+
 ScriptEngine::ScriptEngine(const QString& scriptContents, const QString& fileNameString, bool wantSignals) :
     _scriptContents(scriptContents),
     _timerFunctionMap(),
@@ -149,32 +187,16 @@ ScriptEngine::~ScriptEngine() {
 
 void ScriptEngine::disconnectNonEssentialSignals() {
     disconnect();
-    connect(this, &ScriptEngine::doneRunning, thread(), &QThread::quit);
 }
 
 void ScriptEngine::runInThread() {
     _isThreaded = true;
-    QThread* workerThread = new QThread(); // thread is not owned, so we need to manage the delete
-    QString scriptEngineName = QString("Script Thread:") + getFilename();
-    workerThread->setObjectName(scriptEngineName);
-
-    // NOTE: If you connect any essential signals for proper shutdown or cleanup of
-    // the script engine, make sure to add code to "reconnect" them to the
-    // disconnectNonEssentialSignals() method
-
-    // when the worker thread is started, call our engine's run..
-    connect(workerThread, &QThread::started, this, &ScriptEngine::run);
-
-    // tell the thread to stop when the script engine is done
-    connect(this, &ScriptEngine::doneRunning, workerThread, &QThread::quit);
 
-    // when the thread is finished, add thread to the deleteLater queue
-    connect(workerThread, &QThread::finished, workerThread, &QThread::deleteLater);
-
-    moveToThread(workerThread);
-
-    // Starts an event loop, and emits workerThread->started()
-    workerThread->start();
+    // The engine shares one of the script threads with other engines, and runs from the thread's event loop in turns
+    // with them rather than from a loop of its own.  It gives the thread back when it is done running.
+    QThread* scriptThread = DependencyManager::get<ScriptEngines>()->acquireScriptThread();
+    moveToThread(scriptThread);
+    QTimer::singleShot(0, this, &ScriptEngine::run);
 }
 
 void ScriptEngine::waitTillDoneRunning() {
@@ -185,7 +207,7 @@ void ScriptEngine::waitTillDoneRunning() {
         // we want the application thread to continue to process events, because the scripts will likely need to
         // marshall messages across to the main thread. For example if they access Settings or Meny in any of their
         // shutdown code.
-        while (thread()->isRunning()) {
+        while (_isRunning) {
             // process events for the main application thread, allowing invokeMethod calls to pass between threads
             QCoreApplication::processEvents();
         }
@@ -280,6 +302,8 @@ void ScriptEngine::init() {
     qScriptRegisterMetaType(this, RayToEntityIntersectionResultToScriptValue, RayToEntityIntersectionResultFromScriptValue);
     qScriptRegisterSequenceMetaType<QVector<QUuid>>(this);
     qScriptRegisterSequenceMetaType<QVector<EntityItemID>>(this);
+    qScriptRegisterSequenceMetaType<QVector<RayToEntityIntersectionResult>>(this);
+    qScriptRegisterSequenceMetaType<QVector<QVector<QUuid>>>(this);
 
     qScriptRegisterSequenceMetaType<QVector<glm::vec2> >(this);
     qScriptRegisterSequenceMetaType<QVector<glm::quat> >(this);
@@ -308,8 +332,11 @@ void ScriptEngine::init() {
     registerGlobalObject("Script", this);
     registerGlobalObject("Audio", &AudioScriptingInterface::getInstance());
     registerGlobalObject("Entities", entityScriptingInterface.data());
+    globalObject().property("Entities").setProperty("getEntityPositions", newFunction(getEntityPositions, 1));
     registerGlobalObject("Quat", &_quatLibrary);
     registerGlobalObject("Vec3", &_vec3Library);
+    Quat::registerNativeFunctions(this, globalObject().property("Quat"));
+    Vec3::registerNativeFunctions(this, globalObject().property("Vec3"));
     registerGlobalObject("Uuid", &_uuidLibrary);
     registerGlobalObject("AnimationCache", DependencyManager::get<AnimationCache>().data());
     registerGlobalObject("Messages", DependencyManager::get<MessagesClient>().data());
@@ -588,6 +615,10 @@ QScriptValue ScriptEngine::evaluate(const QString& sourceCode, const QString& fi
         return QScriptValue();
     }
 
+    return evaluateProgram(program);
+}
+
+QScriptValue ScriptEngine::evaluateProgram(const QScriptProgram& program) {
     ++_evaluatesPending;
     const auto result = QScriptEngine::evaluate(program);
     --_evaluatesPending;
@@ -601,6 +632,9 @@ QScriptValue ScriptEngine::evaluate(const QString& sourceCode, const QString& fi
 
 void ScriptEngine::run() {
     if (_stoppingAllScripts) {
+        if (_isThreaded) {
+            DependencyManager::get<ScriptEngines>()->releaseScriptThread(thread());
+        }
         return; // bail early - avoid setting state in init(), as evaluate() will bail too
     }
 
@@ -615,16 +649,32 @@ void ScriptEngine::run() {
 
     QScriptValue result = evaluate(_scriptContents, _fileNameString);
 
+    _lastUpdate = usecTimestampNow();
+
+    if (_isThreaded) {
+        // the frames come from a timer of the script thread, until one finds the script finished
+        QTimer* frameTimer = new QTimer(this);
+        frameTimer->setTimerType(Qt::PreciseTimer);
+        frameTimer->setInterval((int)(SCRIPT_DATA_CALLBACK_USECS / USECS_PER_MSEC));
+        connect(frameTimer, &QTimer::timeout, this, [this, frameTimer] {
+            if (!_isFinished) {
+                runFrame();
+            }
+            if (_isFinished) {
+                frameTimer->stop();
+                frameTimer->deleteLater();
+                finishRunning();
+            }
+        });
+        frameTimer->start();
+        return;
+    }
+
     QElapsedTimer startTime;
     startTime.start();
 
     int thisFrame = 0;
 
-    auto nodeList = DependencyManager::get<NodeList>();
-    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
-
-    qint64 lastUpdate = usecTimestampNow();
-
     while (!_isFinished) {
         int usecToSleep = (thisFrame++ * SCRIPT_DATA_CALLBACK_USECS) - startTime.nsecsElapsed() / 1000; // nsec to usec
         if (usecToSleep > 0) {
@@ -641,34 +691,71 @@ void ScriptEngine::run() {
             break;
         }
 
-        if (!_isFinished && entityScriptingInterface->getEntityPacketSender()->serversExist()) {
-            // release the queue of edit entity messages.
-            entityScriptingInterface->getEntityPacketSender()->releaseQueuedMessages();
+        runFrame();
+    }
 
-            // since we're in non-threaded mode, call process so that the packets are sent
-            if (!entityScriptingInterface->getEntityPacketSender()->isThreaded()) {
-                entityScriptingInterface->getEntityPacketSender()->process();
-            }
-        }
+    finishRunning();
+}
 
-        qint64 now = usecTimestampNow();
-        float deltaTime = (float) (now - lastUpdate) / (float) USECS_PER_SECOND;
+void ScriptEngine::runFrame() {
+    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
 
-        if (!_isFinished) {
-            if (_wantSignals) {
-                emit update(deltaTime);
-            }
+    // apply the edits queued over the last frame, ahead of the release of their messages
+    entityScriptingInterface->flushEditBatch();
+
+    if (!_isFinished && entityScriptingInterface->getEntityPacketSender()->serversExist()) {
+        // release the queue of edit entity messages.
+        entityScriptingInterface->getEntityPacketSender()->releaseQueuedMessages();
+
+        // since we're in non-threaded mode, call process so that the packets are sent
+        if (!entityScriptingInterface->getEntityPacketSender()->isThreaded()) {
+            entityScriptingInterface->getEntityPacketSender()->process();
         }
-        lastUpdate = now;
+    }
 
-        // Debug and clear exceptions
-        hadUncaughtExceptions(*this, _fileNameString);
+    qint64 now = usecTimestampNow();
+
+    // the script time since the last frame is that of the last update with the timers and the events since, and what
+    // goes over the budget has to be paid back in skipped updates
+    quint64 scriptTime = _scriptTime;
+    quint64 frameScriptTime = scriptTime - _lastFrameScriptTime;
+    _lastFrameScriptTime = scriptTime;
+    if (_lastFrameTime > 0 && (quint64)now > _lastFrameTime) {
+        float frameLoad = (float)frameScriptTime / (float)((quint64)now - _lastFrameTime);
+        _scriptLoad = _scriptLoad + (frameLoad - _scriptLoad) * SCRIPT_LOAD_RATE;
+    }
+    _lastFrameTime = now;
+
+    quint64 budget = _frameTimeBudget;
+    if (budget > 0) {
+        _frameTimeDebt = std::min(_frameTimeDebt + frameScriptTime, budget * MAX_THROTTLED_FRAMES);
+        _frameTimeDebt -= std::min(_frameTimeDebt, budget);
+    } else {
+        _frameTimeDebt = 0;
     }
 
+    // a skipped update leaves the time of the last, so that the next one covers the frames skipped
+    if (!_isFinished && _frameTimeDebt == 0) {
+        float deltaTime = (float) (now - _lastUpdate) / (float) USECS_PER_SECOND;
+        if (_wantSignals) {
+            ScriptTimer timer(*this);
+            emit update(deltaTime);
+        }
+        _lastUpdate = now;
+    }
+
+    // Debug and clear exceptions
+    hadUncaughtExceptions(*this, _fileNameString);
+}
+
+void ScriptEngine::finishRunning() {
+    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
+
     stopAllTimers(); // make sure all our timers are stopped if the script is ending
     if (_wantSignals) {
         emit scriptEnding();
     }
+    entityScriptingInterface->flushEditBatch();
 
     if (entityScriptingInterface->getEntityPacketSender()->serversExist()) {
         // release the queue of edit entity messages.
@@ -690,6 +777,10 @@ void ScriptEngine::run() {
         emit finished(_fileNameString, this);
     }
 
+    if (_isThreaded) {
+        DependencyManager::get<ScriptEngines>()->releaseScriptThread(thread());
+    }
+
     _isRunning = false;
     if (_wantSignals) {
         emit runningStateChanged();
@@ -738,6 +829,7 @@ void ScriptEngine::callAnimationStateHandler(QScriptValue callback, AnimVariantM
     QScriptValue javascriptParameters = parameters.animVariantMapToScriptValue(this, names, useNames);
     QScriptValueList callingArguments;
     callingArguments << javascriptParameters;
+    ScriptTimer timer(*this);
     QScriptValue result = callback.call(QScriptValue(), callingArguments);
     resultHandler(result);
 }
@@ -754,6 +846,7 @@ void ScriptEngine::timerFired() {
 
     // call the associated JS function, if it exists
     if (timerFunction.isValid()) {
+        ScriptTimer timer(*this);
         timerFunction.call();
     }
 }
@@ -943,6 +1036,7 @@ void ScriptEngine::forwardHandlerCall(const EntityItemID& entityID, const QStrin
     }
     QScriptValueList handlersForEvent = handlersOnEntity[eventName];
     if (!handlersForEvent.isEmpty()) {
+        ScriptTimer timer(*this);
         for (int i = 0; i < handlersForEvent.count(); ++i) {
             handlersForEvent[i].call(QScriptValue(), eventHanderArgs);
         }
@@ -1013,36 +1107,44 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
 
     auto scriptCache = DependencyManager::get<ScriptCache>();
     bool isFileUrl = isURL && scriptOrURL.startsWith("file://");
-    auto fileName = QString("(EntityID:%1, %2)").arg(entityID.toString(), isURL ? scriptOrURL : "EmbededEntityScript");
 
-    QScriptProgram program(contents, fileName);
-    if (!hasCorrectSyntax(program)) {
-        if (!isFileUrl) {
-            scriptCache->addScriptToBadScriptList(scriptOrURL);
+    // the program is shared by all the entities running the script, so its name is that of the script alone
+    auto programIter = _entityScriptPrograms.find(contents);
+    if (programIter == _entityScriptPrograms.end()) {
+        auto fileName = QString("(EntityScript, %1)").arg(isURL ? scriptOrURL : "EmbededEntityScript");
+        QScriptProgram program(contents, fileName);
+        if (!hasCorrectSyntax(program)) {
+            if (!isFileUrl) {
+                scriptCache->addScriptToBadScriptList(scriptOrURL);
+            }
+            return; // done processing script
         }
-        return; // done processing script
-    }
 
-    if (isURL) {
-        setParentURL(scriptOrURL);
-    }
+        if (isURL) {
+            setParentURL(scriptOrURL);
+        }
 
-    QScriptEngine sandbox;
-    QScriptValue testConstructor = sandbox.evaluate(program);
-    if (hadUncaughtExceptions(sandbox, program.fileName())) {
-        return;
-    }
+        QScriptEngine sandbox;
+        QScriptValue testConstructor = sandbox.evaluate(program);
+        if (isURL) {
+            setParentURL("");
+        }
+        if (hadUncaughtExceptions(sandbox, program.fileName())) {
+            return;
+        }
 
-    if (!testConstructor.isFunction()) {
-        qCDebug(scriptengine) << "ScriptEngine::loadEntityScript() entity:" << entityID << "\n"
-            "    NOT CONSTRUCTOR\n"
-            "    SCRIPT:" << scriptOrURL;
+        if (!testConstructor.isFunction()) {
+            qCDebug(scriptengine) << "ScriptEngine::loadEntityScript() entity:" << entityID << "\n"
+                "    NOT CONSTRUCTOR\n"
+                "    SCRIPT:" << scriptOrURL;
 
-        if (!isFileUrl) {
-            scriptCache->addScriptToBadScriptList(scriptOrURL);
-        }
+            if (!isFileUrl) {
+                scriptCache->addScriptToBadScriptList(scriptOrURL);
+            }
 
-        return; // done processing script
+            return; // done processing script
+        }
+        programIter = _entityScriptPrograms.insert(contents, program);
     }
 
     int64_t lastModified = 0;
@@ -1051,7 +1153,10 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
         lastModified = (quint64)QFileInfo(file).lastModified().toMSecsSinceEpoch();
     }
 
-    QScriptValue entityScriptConstructor = evaluate(contents, fileName);
+    if (isURL) {
+        setParentURL(scriptOrURL);
+    }
+    QScriptValue entityScriptConstructor = evaluateProgram(programIter.value());
     QScriptValue entityScriptObject = entityScriptConstructor.construct();
     EntityScriptDetails newDetails = { scriptOrURL, entityScriptObject, lastModified };
     _entityScripts[entityID] = newDetails;
@@ -1101,6 +1206,7 @@ void ScriptEngine::unloadAllEntityScripts() {
         callEntityScriptMethod(entityID, "unload");
     }
     _entityScripts.clear();
+    _entityScriptPrograms.clear();
 }
 
 void ScriptEngine::refreshFileScript(const EntityItemID& entityID) {
@@ -1163,6 +1269,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             QScriptValueList args;
             args << entityID.toScriptValue(this);
             args << qScriptValueFromSequence(this, params);
+            ScriptTimer timer(*this);
             entityScript.property(methodName).call(entityScript, args);
         }
 
@@ -1195,6 +1302,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             QScriptValueList args;
             args << entityID.toScriptValue(this);
             args << event.toScriptValue(this);
+            ScriptTimer timer(*this);
             entityScript.property(methodName).call(entityScript, args);
         }
     }
@@ -1229,6 +1337,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             args << entityID.toScriptValue(this);
             args << otherID.toScriptValue(this);
             args << collisionToScriptValue(this, collision);
+            ScriptTimer timer(*this);
             entityScript.property(methodName).call(entityScript, args);
         }
     }
@@ -60,7 +60,7 @@ public:
 
     ~ScriptEngine();
 
-    /// run the script in a dedicated thread. This will have the side effect of evalulating
+    /// run the script in one of the script threads, shared with other engines. This will have the side effect of evalulating
     /// the current script contents and calling run(). Callers will likely want to register the script with external
     /// services before calling this.
     void runInThread();
@@ -144,6 +144,16 @@ public:
     // NOTE - this is used by the TypedArray implemetation. we need to review this for thread safety
     ArrayBufferClass* getArrayBufferClass() { return _arrayBufferClass; }
 
+    // The time the engine spends running the script, from its update, its timers and its event handlers, in usecs
+    // since it started, and as a share of the time between its frames (smoothed over a few frames)
+    quint64 getScriptTime() const { return _scriptTime; }
+    float getScriptLoad() const { return _scriptLoad; }
+
+    // The time the script can take each frame, in usecs, or 0 for no budget.  Once the frames take more, the engine
+    // skips the updates of the script until the frames are back within it.
+    void setFrameTimeBudget(quint64 budget) { _frameTimeBudget = budget; }
+    quint64 getFrameTimeBudget() const { return _frameTimeBudget; }
+
 public slots:
     void callAnimationStateHandler(QScriptValue callback, AnimVariantMap parameters, QStringList names, bool useNames, AnimVariantResultHandler resultHandler);
 
@@ -173,9 +183,35 @@ protected:
     QSet<QUrl> _includedURLs;
     bool _wantSignals { true };
     QHash<EntityItemID, EntityScriptDetails> _entityScripts;
+
+    // the entity scripts already checked and compiled by this engine, by their source, so that the entities sharing a
+    // script compile it once
+    QHash<QString, QScriptProgram> _entityScriptPrograms;
     bool _isThreaded { false };
+    qint64 _lastUpdate { 0 };
+
+    // adds the time from its creation to its end to the script time of the engine, unless in another timed call already
+    class ScriptTimer {
+    public:
+        ScriptTimer(ScriptEngine& engine);
+        ~ScriptTimer();
+    private:
+        ScriptEngine& _engine;
+        quint64 _start { 0 };
+    };
+
+    std::atomic<quint64> _scriptTime { 0 };
+    std::atomic<float> _scriptLoad { 0.0f };
+    std::atomic<quint64> _frameTimeBudget { 0 };
+    int _scriptTimerDepth { 0 };
+    quint64 _lastFrameScriptTime { 0 };
+    quint64 _lastFrameTime { 0 };
+    quint64 _frameTimeDebt { 0 };
 
     void init();
+    QScriptValue evaluateProgram(const QScriptProgram& program);
+    void runFrame();
+    void finishRunning();
     QString getFilename() const;
     void waitTillDoneRunning();
     bool evaluatePending() const { return _evaluatesPending > 0; }
@@ -8,9 +8,12 @@
 
 #include "ScriptEngines.h"
 
+#include <algorithm>
+
 #include <QtCore/QStandardPaths>
 #include <QtCore/QCoreApplication>
 
+#include <NumericalConstants.h>
 #include <SettingHandle.h>
 #include <UserActivityLogger.h>
 
@@ -128,11 +131,53 @@ void ScriptEngines::shutdownScripting() {
             i.remove();
         }
     }
+
+    // the engines are done, the threads delete the ones left to them as they finish
+    stopScriptThreads();
+
     _stoppingAllScripts = false;
     _allScriptsMutex.unlock();
     qCDebug(scriptengine) << "DONE Stopping all scripts....";
 }
 
+QThread* ScriptEngines::acquireScriptThread() {
+    QMutexLocker lock(&_scriptThreadsMutex);
+    if (_scriptThreads.empty()) {
+        const int MAX_SCRIPT_THREADS = 4;
+        int numThreads = std::max(1, std::min(QThread::idealThreadCount() / 2, MAX_SCRIPT_THREADS));
+        for (int i = 0; i < numThreads; i++) {
+            QThread* thread = new QThread();
+            thread->setObjectName(QString("Script Thread %1").arg(i));
+            thread->start();
+            _scriptThreads.push_back({ thread, 0 });
+        }
+    }
+    auto host = std::min_element(_scriptThreads.begin(), _scriptThreads.end(),
+        [](const std::pair<QThread*, int>& a, const std::pair<QThread*, int>& b) { return a.second < b.second; });
+    host->second++;
+    return host->first;
+}
+
+void ScriptEngines::releaseScriptThread(QThread* thread) {
+    QMutexLocker lock(&_scriptThreadsMutex);
+    for (auto& host : _scriptThreads) {
+        if (host.first == thread) {
+            host.second--;
+            break;
+        }
+    }
+}
+
+void ScriptEngines::stopScriptThreads() {
+    QMutexLocker lock(&_scriptThreadsMutex);
+    for (auto& host : _scriptThreads) {
+        host.first->quit();
+        host.first->wait();
+        delete host.first;
+    }
+    _scriptThreads.clear();
+}
+
 QVariantList getPublicChildNodes(TreeNodeFolder* parent) {
     QVariantList result;
     QList<TreeNodeBase*> treeNodes = getScriptsModel().getFolderNodes(parent);
@@ -204,6 +249,33 @@ QVariantList ScriptEngines::getRunning() {
     return result;
 }
 
+QVariantList ScriptEngines::getScriptTimes() {
+    QVariantList result;
+    QMutexLocker locker(&_allScriptsMutex);
+    foreach(ScriptEngine* engine, _allKnownScriptEngines) {
+        if (!engine->isRunning()) {
+            continue;
+        }
+        QVariantMap resultNode;
+        resultNode.insert("name", engine->getFilename());
+        resultNode.insert("url", engine->_fileNameString);
+        resultNode.insert("time", (double)engine->getScriptTime() / (double)USECS_PER_MSEC);
+        resultNode.insert("load", engine->getScriptLoad());
+        resultNode.insert("budget", (double)engine->getFrameTimeBudget() / (double)USECS_PER_MSEC);
+        result.append(resultNode);
+    }
+    return result;
+}
+
+bool ScriptEngines::setScriptFrameTimeBudget(const QString& scriptHash, float msecs) {
+    ScriptEngine* engine = getScriptEngine(scriptHash);
+    if (!engine) {
+        return false;
+    }
+    engine->setFrameTimeBudget((quint64)(std::max(msecs, 0.0f) * USECS_PER_MSEC));
+    return true;
+}
+
 
 static const QString SETTINGS_KEY = "Settings";
 static const QString DEFAULT_SCRIPTS_JS_URL = "http://s3.amazonaws.com/hifi-public/scripts/defaultScripts.js";
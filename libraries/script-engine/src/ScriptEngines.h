@@ -12,10 +12,12 @@
 #include <functional>
 #include <atomic>
 #include <memory>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QtCore/QMutex>
 #include <QtCore/QReadWriteLock>
+#include <QtCore/QThread>
 
 #include <SettingHandle.h>
 #include <DependencyManager.h>
@@ -62,9 +64,22 @@ public:
     Q_INVOKABLE QVariantList getPublic();
     Q_INVOKABLE QVariantList getLocal();
 
+    // The time each running engine spends in its script: its name, its total time in msecs, the share of its frames it
+    // takes, and its frame time budget in msecs
+    Q_INVOKABLE QVariantList getScriptTimes();
+
+    // Sets how many msecs a frame of the script loaded from the path can take before its updates are skipped, 0 for no
+    // budget
+    Q_INVOKABLE bool setScriptFrameTimeBudget(const QString& scriptHash, float msecs);
+
     // Called at shutdown time
     void shutdownScripting();
 
+    // The engines running in threads share a few script threads, each thread running the engines it hosts in turns
+    // from its event loop. An engine takes the thread hosting the fewest engines, and gives it back when done.
+    QThread* acquireScriptThread();
+    void releaseScriptThread(QThread* thread);
+
 signals: 
     void scriptCountChanged();
     void scriptsReloading();
@@ -82,6 +97,7 @@ protected:
     void onScriptEngineLoaded(const QString& scriptFilename);
     void onScriptEngineError(const QString& scriptFilename);
     void launchScriptEngine(ScriptEngine* engine);
+    void stopScriptThreads();
 
 
     Setting::Handle<bool> _firstRun { "firstRun", true };
@@ -94,6 +110,10 @@ protected:
     mutable Setting::Handle<QString> _scriptsLocationHandle;
     ScriptsModel _scriptsModel;
     ScriptsModelFilter _scriptsModelFilter;
+
+    // each script thread with the number of engines it hosts
+    QMutex _scriptThreadsMutex;
+    std::vector<std::pair<QThread*, int>> _scriptThreads;
 };
 
 #endif // hifi_ScriptEngine_h
@@ -9,8 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cstring>
+
 #include <glm/glm.hpp>
 
+#include <QtCore/QtEndian>
+
 #include "ScriptEngine.h"
 #include "TypedArrayPrototype.h"
 
@@ -381,6 +385,32 @@ void Float32ArrayClass::setProperty(QScriptValue& object, const QScriptString& n
     }
 }
 
+char* Float32ArrayClass::getElements(const QScriptValue& array, quint32& length) {
+    Float32ArrayClass* cls = dynamic_cast<Float32ArrayClass*>(array.scriptClass());
+    if (!cls) {
+        return nullptr;
+    }
+    QByteArray* ba = qscriptvalue_cast<QByteArray*>(array.data().property(cls->_bufferName).data());
+    if (!ba) {
+        return nullptr;
+    }
+    length = array.data().property(cls->_lengthName).toUInt32();
+    return ba->data() + array.data().property(cls->_byteOffsetName).toUInt32();
+}
+
+float Float32ArrayClass::getElement(const char* elements, quint32 index) {
+    quint32 bits = qFromBigEndian<quint32>((const uchar*)(elements + index * sizeof(float)));
+    float value;
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+void Float32ArrayClass::setElement(char* elements, quint32 index, float value) {
+    quint32 bits;
+    memcpy(&bits, &value, sizeof(float));
+    qToBigEndian<quint32>(bits, (uchar*)(elements + index * sizeof(float)));
+}
+
 Float64ArrayClass::Float64ArrayClass(ScriptEngine* scriptEngine) : TypedArray(scriptEngine, FLOAT_64_ARRAY_CLASS_NAME) {
     setBytesPerElement(sizeof(double));
 }
@@ -134,6 +134,12 @@ public:
     
     QScriptValue property(const QScriptValue& object, const QScriptString& name, uint id);
     void setProperty(QScriptValue& object, const QScriptString& name, uint id, const QScriptValue& value);
+
+    // The elements of a Float32Array straight in the memory of its buffer, for the native functions working on many of
+    // them at once.  The elements are big endian in the buffer, as the array streams them in and out.
+    static char* getElements(const QScriptValue& array, quint32& length);
+    static float getElement(const char* elements, quint32 index);
+    static void setElement(char* elements, quint32 index, float value);
 };
 
 class Float64ArrayClass : public TypedArray {
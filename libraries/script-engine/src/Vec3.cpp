@@ -14,9 +14,12 @@
 #include <QDebug>
 
 #include <GLMHelpers.h>
+#include <RegisteredMetaTypes.h>
 
+#include "NativeFunctions.h"
 #include "ScriptEngineLogging.h"
 #include "NumericalConstants.h"
+#include "TypedArrays.h"
 #include "Vec3.h"
 
 
@@ -82,3 +85,133 @@ glm::vec3 Vec3::fromPolar(float elevation, float azimuth) {
     glm::vec3 v = glm::vec3(elevation, azimuth, 1.0f);
     return fromPolar(v);
 }
+
+static glm::vec3 vec3Argument(QScriptContext* context, int index) {
+    glm::vec3 v;
+    vec3FromScriptValue(context->argument(index), v);
+    return v;
+}
+
+static glm::quat quatArgument(QScriptContext* context, int index) {
+    glm::quat q;
+    quatFromScriptValue(context->argument(index), q);
+    return q;
+}
+
+static QScriptValue nativeSum(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 2)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, vec3Argument(context, 0) + vec3Argument(context, 1));
+}
+
+static QScriptValue nativeSubtract(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 2)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, vec3Argument(context, 0) - vec3Argument(context, 1));
+}
+
+static QScriptValue nativeMultiply(QScriptContext* context, QScriptEngine* engine) {
+    if (hasArguments(context, 2, 0x2)) {
+        return vec3toScriptValue(engine, vec3Argument(context, 0) * (float)context->argument(1).toNumber());
+    }
+    if (hasArguments(context, 2, 0x1)) {
+        return vec3toScriptValue(engine, vec3Argument(context, 1) * (float)context->argument(0).toNumber());
+    }
+    return callSlot(context);
+}
+
+static QScriptValue nativeMultiplyVbyV(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 2)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, vec3Argument(context, 0) * vec3Argument(context, 1));
+}
+
+static QScriptValue nativeMultiplyQbyV(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 2)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, quatArgument(context, 0) * vec3Argument(context, 1));
+}
+
+static QScriptValue nativeDot(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 2)) {
+        return callSlot(context);
+    }
+    return QScriptValue(glm::dot(vec3Argument(context, 0), vec3Argument(context, 1)));
+}
+
+static QScriptValue nativeCross(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 2)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, glm::cross(vec3Argument(context, 0), vec3Argument(context, 1)));
+}
+
+static QScriptValue nativeLength(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 1)) {
+        return callSlot(context);
+    }
+    return QScriptValue(glm::length(vec3Argument(context, 0)));
+}
+
+static QScriptValue nativeDistance(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 2)) {
+        return callSlot(context);
+    }
+    return QScriptValue(glm::distance(vec3Argument(context, 0), vec3Argument(context, 1)));
+}
+
+static QScriptValue nativeNormalize(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 1)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, glm::normalize(vec3Argument(context, 0)));
+}
+
+static QScriptValue nativeMix(QScriptContext* context, QScriptEngine* engine) {
+    if (!hasArguments(context, 3, 0x4)) {
+        return callSlot(context);
+    }
+    return vec3toScriptValue(engine, glm::mix(vec3Argument(context, 0), vec3Argument(context, 1),
+        (float)context->argument(2).toNumber()));
+}
+
+// transforms in place the points of a Float32Array of their x, y and z, by a rotation and then a translation
+static QScriptValue nativeTransformPoints(QScriptContext* context, QScriptEngine* engine) {
+    quint32 length = 0;
+    char* points = Float32ArrayClass::getElements(context->argument(0), length);
+    if (!points || !hasArguments(context, 3)) {
+        return context->throwError(QScriptContext::TypeError,
+            "Vec3.transformPoints takes a Float32Array of points, a rotation and a translation");
+    }
+    glm::quat rotation = quatArgument(context, 1);
+    glm::vec3 translation = vec3Argument(context, 2);
+    for (quint32 i = 0; i + 2 < length; i += 3) {
+        glm::vec3 point(Float32ArrayClass::getElement(points, i), Float32ArrayClass::getElement(points, i + 1),
+            Float32ArrayClass::getElement(points, i + 2));
+        point = rotation * point + translation;
+        Float32ArrayClass::setElement(points, i, point.x);
+        Float32ArrayClass::setElement(points, i + 1, point.y);
+        Float32ArrayClass::setElement(points, i + 2, point.z);
+    }
+    return context->argument(0);
+}
+
+void Vec3::registerNativeFunctions(QScriptEngine* engine, QScriptValue object) {
+    registerNativeFunction(engine, object, "sum", nativeSum, 2);
+    registerNativeFunction(engine, object, "subtract", nativeSubtract, 2);
+    registerNativeFunction(engine, object, "multiply", nativeMultiply, 2);
+    registerNativeFunction(engine, object, "multiplyVbyV", nativeMultiplyVbyV, 2);
+    registerNativeFunction(engine, object, "multiplyQbyV", nativeMultiplyQbyV, 2);
+    registerNativeFunction(engine, object, "dot", nativeDot, 2);
+    registerNativeFunction(engine, object, "cross", nativeCross, 2);
+    registerNativeFunction(engine, object, "length", nativeLength, 1);
+    registerNativeFunction(engine, object, "distance", nativeDistance, 2);
+    registerNativeFunction(engine, object, "normalize", nativeNormalize, 1);
+    registerNativeFunction(engine, object, "mix", nativeMix, 3);
+
+    object.setProperty("transformPoints", engine->newFunction(nativeTransformPoints, 3));
+}
@@ -17,6 +17,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtScript/QScriptValue>
 
 #include "GLMHelpers.h"
 
@@ -43,6 +44,10 @@ class Vec3 : public QObject {
     Q_PROPERTY(glm::vec3 UP READ UP CONSTANT)
     Q_PROPERTY(glm::vec3 FRONT READ FRONT CONSTANT)
 
+public:
+    /// puts native functions in place of the slots called the most, in the script object of the library
+    static void registerNativeFunctions(QScriptEngine* engine, QScriptValue object);
+
 public slots:
     glm::vec3 reflect(const glm::vec3& v1, const glm::vec3& v2) { return glm::reflect(v1, v2); }
     glm::vec3 cross(const glm::vec3& v1, const glm::vec3& v2) { return glm::cross(v1, v2); }
@@ -0,0 +1,103 @@
+//
+//  CPUDetect.h
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CPUDetect_h
+#define hifi_CPUDetect_h
+
+//
+// Lightweight runtime checks for the instruction set extensions we have hand-written kernels for.
+// Code built for a newer instruction set lives in its own translation unit and is only called once
+// the matching check here has passed.
+//
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define ARCH_X86
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define ARCH_NEON
+#endif
+
+#ifdef ARCH_X86
+
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+
+static inline void cpuidex(int info[4], int function, int subfunction) {
+    __cpuidex(info, function, subfunction);
+}
+
+static inline uint64_t xgetbv(int xcr) {
+    return _xgetbv(xcr);
+}
+
+#else
+#include <cpuid.h>
+
+static inline void cpuidex(int info[4], int function, int subfunction) {
+    __cpuid_count(function, subfunction, info[0], info[1], info[2], info[3]);
+}
+
+static inline uint64_t xgetbv(int xcr) {
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+    return ((uint64_t)edx << 32) | eax;
+}
+
+#endif // _MSC_VER
+
+static inline bool cpuSupportsSSE2() {
+    int info[4];
+    cpuidex(info, 1, 0);
+    return ((info[3] >> 26) & 0x1) != 0;
+}
+
+static inline bool cpuSupportsAVX2() {
+    int info[4];
+
+    cpuidex(info, 0, 0);
+    int maxFunction = info[0];
+    if (maxFunction < 7) {
+        return false;
+    }
+
+    // the CPU has to support AVX and the OS has to use XSAVE for the AVX registers to be usable at all
+    cpuidex(info, 1, 0);
+    bool osUsesXSAVE = ((info[2] >> 27) & 0x1) != 0;
+    bool cpuSupportsAVX = ((info[2] >> 28) & 0x1) != 0;
+    if (!osUsesXSAVE || !cpuSupportsAVX) {
+        return false;
+    }
+
+    // the OS has to save and restore both the XMM and YMM state
+    const uint64_t XMM_AND_YMM_STATE = 0x6;
+    if ((xgetbv(0) & XMM_AND_YMM_STATE) != XMM_AND_YMM_STATE) {
+        return false;
+    }
+
+    cpuidex(info, 7, 0);
+    return ((info[1] >> 5) & 0x1) != 0;
+}
+
+#else
+
+static inline bool cpuSupportsSSE2() {
+    return false;
+}
+
+static inline bool cpuSupportsAVX2() {
+    return false;
+}
+
+#endif // ARCH_X86
+
+#endif // hifi_CPUDetect_h
@@ -0,0 +1,134 @@
+//
+//  CullingKernels.cpp
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CPUDetect.h"
+
+#include <cmath>
+
+#include "AABox.h"
+#include "CullingKernels.h"
+
+// a box is outside a plane when its corner furthest along the normal is behind it: the distance of its center plus
+// its half extents along the absolute normal
+void CullingKernels::findBoxesOutsideScalar(const glm::vec4* planes, int numPlanes, const AABox* boxes, bool* isOutside,
+                                            int count) {
+    for (int i = 0; i < count; i++) {
+        glm::vec3 halfScale = 0.5f * boxes[i].getScale();
+        glm::vec3 center = boxes[i].getCorner() + halfScale;
+        bool outside = false;
+        for (int p = 0; p < numPlanes && !outside; p++) {
+            glm::vec3 normal(planes[p]);
+            outside = glm::dot(normal, center) + planes[p].w + glm::dot(glm::abs(normal), halfScale) < 0.0f;
+        }
+        isOutside[i] = outside;
+    }
+}
+
+static const int BOXES_PER_PASS = 4;
+
+#if defined(ARCH_X86)
+
+#include <emmintrin.h>
+
+// one component of four boxes, a box per lane
+static inline __m128 loadCorners(const AABox* b, int k) {
+    return _mm_setr_ps(b[0].getCorner()[k], b[1].getCorner()[k], b[2].getCorner()[k], b[3].getCorner()[k]);
+}
+
+static inline __m128 loadScales(const AABox* b, int k) {
+    return _mm_setr_ps(b[0].getScale()[k], b[1].getScale()[k], b[2].getScale()[k], b[3].getScale()[k]);
+}
+
+void CullingKernels::findBoxesOutside(const glm::vec4* planes, int numPlanes, const AABox* boxes, bool* isOutside,
+                                      int count) {
+    const __m128 HALF = _mm_set1_ps(0.5f);
+    const __m128 ZERO = _mm_setzero_ps();
+    const int ALL_OUTSIDE = (1 << BOXES_PER_PASS) - 1;
+
+    int i = 0;
+    for (; i + BOXES_PER_PASS <= count; i += BOXES_PER_PASS) {
+        const AABox* b = &boxes[i];
+        __m128 halfX = _mm_mul_ps(HALF, loadScales(b, 0));
+        __m128 halfY = _mm_mul_ps(HALF, loadScales(b, 1));
+        __m128 halfZ = _mm_mul_ps(HALF, loadScales(b, 2));
+        __m128 centerX = _mm_add_ps(halfX, loadCorners(b, 0));
+        __m128 centerY = _mm_add_ps(halfY, loadCorners(b, 1));
+        __m128 centerZ = _mm_add_ps(halfZ, loadCorners(b, 2));
+
+        int outside = 0;
+        for (int p = 0; p < numPlanes && outside != ALL_OUTSIDE; p++) {
+            const glm::vec4& plane = planes[p];
+            __m128 distance = _mm_set1_ps(plane.w);
+            distance = _mm_add_ps(distance, _mm_mul_ps(centerX, _mm_set1_ps(plane.x)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(centerY, _mm_set1_ps(plane.y)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(centerZ, _mm_set1_ps(plane.z)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(halfX, _mm_set1_ps(fabsf(plane.x))));
+            distance = _mm_add_ps(distance, _mm_mul_ps(halfY, _mm_set1_ps(fabsf(plane.y))));
+            distance = _mm_add_ps(distance, _mm_mul_ps(halfZ, _mm_set1_ps(fabsf(plane.z))));
+            outside |= _mm_movemask_ps(_mm_cmplt_ps(distance, ZERO));
+        }
+        for (int j = 0; j < BOXES_PER_PASS; j++) {
+            isOutside[i + j] = (outside & (1 << j)) != 0;
+        }
+    }
+    findBoxesOutsideScalar(planes, numPlanes, boxes + i, isOutside + i, count - i);
+}
+
+#elif defined(ARCH_NEON)
+
+#include <arm_neon.h>
+
+void CullingKernels::findBoxesOutside(const glm::vec4* planes, int numPlanes, const AABox* boxes, bool* isOutside,
+                                      int count) {
+    int i = 0;
+    for (; i + BOXES_PER_PASS <= count; i += BOXES_PER_PASS) {
+        // one box per lane
+        float corners[3][BOXES_PER_PASS];
+        float scales[3][BOXES_PER_PASS];
+        for (int j = 0; j < BOXES_PER_PASS; j++) {
+            for (int k = 0; k < 3; k++) {
+                corners[k][j] = boxes[i + j].getCorner()[k];
+                scales[k][j] = boxes[i + j].getScale()[k];
+            }
+        }
+        float32x4_t half[3];
+        float32x4_t center[3];
+        for (int k = 0; k < 3; k++) {
+            half[k] = vmulq_n_f32(vld1q_f32(scales[k]), 0.5f);
+            center[k] = vaddq_f32(vld1q_f32(corners[k]), half[k]);
+        }
+
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (int p = 0; p < numPlanes; p++) {
+            const glm::vec4& plane = planes[p];
+            float32x4_t distance = vdupq_n_f32(plane.w);
+            for (int k = 0; k < 3; k++) {
+                distance = vmlaq_n_f32(distance, center[k], plane[k]);
+                distance = vmlaq_n_f32(distance, half[k], fabsf(plane[k]));
+            }
+            outside = vorrq_u32(outside, vcltq_f32(distance, vdupq_n_f32(0.0f)));
+        }
+        uint32_t lanes[BOXES_PER_PASS];
+        vst1q_u32(lanes, outside);
+        for (int j = 0; j < BOXES_PER_PASS; j++) {
+            isOutside[i + j] = lanes[j] != 0;
+        }
+    }
+    findBoxesOutsideScalar(planes, numPlanes, boxes + i, isOutside + i, count - i);
+}
+
+#else
+
+void CullingKernels::findBoxesOutside(const glm::vec4* planes, int numPlanes, const AABox* boxes, bool* isOutside,
+                                      int count) {
+    findBoxesOutsideScalar(planes, numPlanes, boxes, isOutside, count);
+}
+
+#endif
@@ -0,0 +1,32 @@
+//
+//  CullingKernels.h
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CullingKernels_h
+#define hifi_CullingKernels_h
+
+#include <glm/glm.hpp>
+
+class AABox;
+
+//
+// Kernels testing many boxes against the planes of a view at once, four boxes at a time.
+// They are SSE2 on x86 and NEON on ARM, with a portable fallback, like the MatrixKernels.
+//
+namespace CullingKernels {
+
+    // isOutside[i] = whether boxes[i] is all on the negative side of one of the planes.
+    // A plane is (normal, d), with dot(normal, point) + d the distance of a point to it.
+    void findBoxesOutside(const glm::vec4* planes, int numPlanes, const AABox* boxes, bool* isOutside, int count);
+
+    // portable version, also used to check the vectorized kernel
+    void findBoxesOutsideScalar(const glm::vec4* planes, int numPlanes, const AABox* boxes, bool* isOutside, int count);
+}
+
+#endif // hifi_CullingKernels_h
@@ -41,6 +41,7 @@ protected:
 
 // usage:
 //     auto instance = DependencyManager::get<T>();
+//     auto pointer = DependencyManager::borrow<T>();
 //     auto instance = DependencyManager::set<T>(Args... args);
 //     DependencyManager::destroy<T>();
 //     DependencyManager::registerInheritance<Base, Derived>();
@@ -48,6 +49,11 @@ class DependencyManager {
 public:
     template<typename T>
     static QSharedPointer<T> get();
+
+    /// The instance without taking a reference on it, for per item and per frame code: only for dependencies that
+    /// outlive the caller's use of the pointer, as a destroy<T>() or set<T>() elsewhere meanwhile would free it.
+    template<typename T>
+    static T* borrow();
     
     template<typename T, typename ...Args>
     static QSharedPointer<T> set(Args&&... args);
@@ -66,6 +72,9 @@ private:
 
     template<typename T>
     size_t getHashCode();
+
+    template<typename T>
+    static QWeakPointer<T>& cachedInstance();
     
     QSharedPointer<Dependency>& safeGet(size_t hashCode);
     
@@ -75,6 +84,17 @@ private:
 
 template <typename T>
 QSharedPointer<T> DependencyManager::get() {
+    return cachedInstance<T>().toStrongRef();
+}
+
+template <typename T>
+T* DependencyManager::borrow() {
+    return cachedInstance<T>().data();
+}
+
+// the hashes are only looked up until the type's instance is set, then a check of the weak pointer finds it
+template <typename T>
+QWeakPointer<T>& DependencyManager::cachedInstance() {
     static size_t hashCode = manager().getHashCode<T>();
     static QWeakPointer<T> instance;
     
@@ -86,7 +106,7 @@ QSharedPointer<T> DependencyManager::get() {
         }
     }
     
-    return instance.toStrongRef();
+    return instance;
 }
 
 template <typename T, typename ...Args>
@@ -135,6 +135,76 @@ int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatO
     return sizeof(quatParts);
 }
 
+// no component but the largest of a unit quat can be larger than 1/sqrt(2)
+static const float SMALLEST_THREE_MAX_COMPONENT = 0.70710678f;
+
+int smallestThreeQuatPackedSize(int bitsPerComponent) {
+    const int INDEX_BITS = 2;
+    return (INDEX_BITS + 3 * bitsPerComponent + BITS_IN_BYTE - 1) / BITS_IN_BYTE;
+}
+
+int packOrientationQuatToSmallestThree(unsigned char* buffer, const glm::quat& quatInput, int bitsPerComponent) {
+    glm::quat quatNormalized = glm::normalize(quatInput);
+    float components[4] = { quatNormalized.x, quatNormalized.y, quatNormalized.z, quatNormalized.w };
+
+    int largestIndex = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(components[i]) > fabsf(components[largestIndex])) {
+            largestIndex = i;
+        }
+    }
+    // q and -q are the same rotation, so flip the quat to make the largest component positive
+    float sign = (components[largestIndex] < 0.0f) ? -1.0f : 1.0f;
+
+    const uint64_t MAX_COMPONENT_VALUE = (1ULL << bitsPerComponent) - 1;
+    const float COMPONENT_CONVERSION_RATIO = MAX_COMPONENT_VALUE / (2.0f * SMALLEST_THREE_MAX_COMPONENT);
+
+    uint64_t packed = largestIndex;
+    int shift = 2;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float component = glm::clamp(sign * components[i], -SMALLEST_THREE_MAX_COMPONENT, SMALLEST_THREE_MAX_COMPONENT);
+            uint64_t value = (uint64_t)((component + SMALLEST_THREE_MAX_COMPONENT) * COMPONENT_CONVERSION_RATIO + 0.5f);
+            packed |= std::min(value, MAX_COMPONENT_VALUE) << shift;
+            shift += bitsPerComponent;
+        }
+    }
+
+    int numBytes = smallestThreeQuatPackedSize(bitsPerComponent);
+    for (int i = 0; i < numBytes; i++) {
+        buffer[i] = (unsigned char)(packed >> (i * BITS_IN_BYTE));
+    }
+    return numBytes;
+}
+
+int unpackOrientationQuatFromSmallestThree(const unsigned char* buffer, glm::quat& quatOutput, int bitsPerComponent) {
+    int numBytes = smallestThreeQuatPackedSize(bitsPerComponent);
+    uint64_t packed = 0;
+    for (int i = 0; i < numBytes; i++) {
+        packed |= (uint64_t)buffer[i] << (i * BITS_IN_BYTE);
+    }
+
+    const uint64_t MAX_COMPONENT_VALUE = (1ULL << bitsPerComponent) - 1;
+    const float COMPONENT_CONVERSION_RATIO = (2.0f * SMALLEST_THREE_MAX_COMPONENT) / MAX_COMPONENT_VALUE;
+
+    int largestIndex = (int)(packed & 0x3);
+    int shift = 2;
+    float components[4];
+    float sumOfSquares = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            uint64_t value = (packed >> shift) & MAX_COMPONENT_VALUE;
+            components[i] = value * COMPONENT_CONVERSION_RATIO - SMALLEST_THREE_MAX_COMPONENT;
+            sumOfSquares += components[i] * components[i];
+            shift += bitsPerComponent;
+        }
+    }
+    components[largestIndex] = sqrtf(std::max(0.0f, 1.0f - sumOfSquares));
+
+    quatOutput = glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+    return numBytes;
+}
+
 //  Safe version of glm::eulerAngles; uses the factorization method described in David Eberly's
 //  http://www.geometrictools.com/Documentation/EulerAngles.pdf (via Clyde,
 // https://github.com/threerings/clyde/blob/master/src/main/java/com/threerings/math/Quaternion.java)
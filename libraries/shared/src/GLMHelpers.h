@@ -97,6 +97,15 @@ int unpackFloatAngleFromTwoByte(const uint16_t* byteAnglePointer, float* destina
 int packOrientationQuatToBytes(unsigned char* buffer, const glm::quat& quatInput);
 int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatOutput);
 
+// Orientation Quats can also be packed as the index of their largest component followed by the three smaller ones,
+// which are known to be between -1/sqrt(2) and 1/sqrt(2), at bitsPerComponent bits each.
+// The largest component is rebuilt from the unit length, and each quat takes a whole number of bytes.
+const int MIN_SMALLEST_THREE_QUAT_BITS = 4;
+const int MAX_SMALLEST_THREE_QUAT_BITS = 20;
+int smallestThreeQuatPackedSize(int bitsPerComponent);
+int packOrientationQuatToSmallestThree(unsigned char* buffer, const glm::quat& quatInput, int bitsPerComponent);
+int unpackOrientationQuatFromSmallestThree(const unsigned char* buffer, glm::quat& quatOutput, int bitsPerComponent);
+
 // Ratios need the be highly accurate when less than 10, but not very accurate above 10, and they
 // are never greater than 1000 to 1, this allows us to encode each component in 16bits
 int packFloatRatioToTwoByte(unsigned char* buffer, float ratio);
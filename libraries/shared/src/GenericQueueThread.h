@@ -10,10 +10,12 @@
 #ifndef hifi_GenericQueueThread_h
 #define hifi_GenericQueueThread_h
 
+#include <climits>
 #include <stdint.h>
 
 #include <QQueue>
 #include <QMutex>
+#include <QMutexLocker>
 #include <QWaitCondition>
 
 #include "GenericThread.h"
@@ -32,7 +34,7 @@ public:
         lock();
         queueItemInternal(t);
         unlock();
-        _hasItems.wakeAll();
+        wakeUp();
     }
 
 protected:
@@ -40,25 +42,42 @@ protected:
         _items.push_back(t);
     }
 
-    virtual uint32_t getMaxWait() {
-        return MSECS_PER_SECOND;
+    /// Determines the timeout of the wait when there are no items to process. Default value means no timeout, the
+    /// thread sleeps until an item is queued or it is terminated.
+    virtual unsigned long getMaxWait() const {
+        return ULONG_MAX;
+    }
+
+    /// Wakes the processing thread. The wait mutex is held to signal, so that a wake between process() finding
+    /// the queue empty and starting its wait isn't lost.
+    void wakeUp() {
+        QMutexLocker locker(&_hasItemsMutex);
+        _hasItems.wakeAll();
+    }
+
+    virtual void terminating() override {
+        wakeUp();
     }
 
     virtual bool process() {
-        if (!_items.size()) {
-            _hasItemsMutex.lock();
+        _hasItemsMutex.lock();
+        lock();
+        bool isEmpty = _items.empty();
+        unlock();
+        if (isEmpty && isStillRunning()) {
             _hasItems.wait(&_hasItemsMutex, getMaxWait());
-            _hasItemsMutex.unlock();
-        }
-
-        if (!_items.size()) {
-            return isStillRunning();
         }
+        _hasItemsMutex.unlock();
 
+        // everything queued while the last batch was processed goes in this one
         Queue processItems;
         lock();
         processItems.swap(_items);
         unlock();
+
+        if (processItems.empty()) {
+            return isStillRunning();
+        }
         return processQueueItems(processItems);
     }
 
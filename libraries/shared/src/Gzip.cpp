@@ -10,12 +10,27 @@
 //
 
 #include <zlib.h>
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QtEndian>
+#include <QtCore/QVector>
+
 #include "Gzip.h"
 
 const int GZIP_WINDOWS_BIT = 31;
 const int GZIP_CHUNK_SIZE = 4096;
 const int DEFAULT_MEM_LEVEL = 8;
 
+// Big sources are compressed pigz style: split in blocks that are deflated on the thread pool, each primed with the
+// end of the block before it so hardly any compression is lost, and joined back into one ordinary gzip stream.
+const int PARALLEL_GZIP_BLOCK_SIZE = 256 * 1024;
+const int DEFLATE_DICTIONARY_SIZE = 32 * 1024;
+const int DEFLATE_SYNC_FLUSH_BYTES = 5;
+const char GZIP_HEADER[] = { '\x1f', '\x8b', Z_DEFLATED, 0, 0, 0, 0, 0, 0, '\x03' }; // no name, no mtime, unix
+
+// a GzipWriter gathers this many blocks before it deflates them together
+const int GZIP_WRITER_BLOCKS = 4;
+
 bool gunzip(QByteArray source, QByteArray &destination) {
     destination.clear();
     if (source.length() == 0) {
@@ -86,12 +101,109 @@ bool gunzip(QByteArray source, QByteArray &destination) {
     return status == Z_STREAM_END;
 }
 
+struct DeflatedBlock {
+    QByteArray data;
+    uLong crc { 0 };
+    bool success { false };
+};
+
+// a raw deflate of one block, the last one finishes the stream and the others end on a byte boundary
+static DeflatedBlock deflateBlock(const QByteArray& source, int blockStart, int blockSize, bool isLastBlock,
+                                  int compressionLevel) {
+    DeflatedBlock block;
+
+    const Bytef* blockData = (const Bytef*)source.constData() + blockStart;
+
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+
+    if (deflateInit2(&strm, compressionLevel, Z_DEFLATED, -MAX_WBITS, DEFAULT_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return block;
+    }
+
+    if (blockStart > 0) {
+        int dictionarySize = qMin(DEFLATE_DICTIONARY_SIZE, blockStart);
+        deflateSetDictionary(&strm, blockData - dictionarySize, dictionarySize);
+    }
+
+    block.data.resize(deflateBound(&strm, blockSize) + DEFLATE_SYNC_FLUSH_BYTES);
+    strm.next_in = (Bytef*)blockData;
+    strm.avail_in = blockSize;
+    strm.next_out = (Bytef*)block.data.data();
+    strm.avail_out = block.data.length();
+
+    int status;
+    for (;;) {
+        status = deflate(&strm, isLastBlock ? Z_FINISH : Z_SYNC_FLUSH);
+        if (status == Z_STREAM_ERROR || status == Z_STREAM_END || strm.avail_out != 0) {
+            break;
+        }
+
+        int used = block.data.length();
+        block.data.resize(used * 2);
+        strm.next_out = (Bytef*)block.data.data() + used;
+        strm.avail_out = block.data.length() - used;
+    }
+
+    block.data.resize(block.data.length() - strm.avail_out);
+    // flushing again once everything is out is "no progress possible", which is fine
+    block.success = isLastBlock ? status == Z_STREAM_END
+        : (status == Z_OK || status == Z_BUF_ERROR) && strm.avail_in == 0;
+    block.crc = crc32(crc32(0L, Z_NULL, 0), blockData, blockSize);
+
+    deflateEnd(&strm);
+    return block;
+}
+
+static bool parallelGzip(const QByteArray& source, QByteArray& destination, int compressionLevel) {
+    QVector<QFuture<DeflatedBlock>> blocks;
+    for (int blockStart = 0; blockStart < source.length(); blockStart += PARALLEL_GZIP_BLOCK_SIZE) {
+        int blockSize = qMin(PARALLEL_GZIP_BLOCK_SIZE, source.length() - blockStart);
+        bool isLastBlock = blockStart + blockSize == source.length();
+        blocks << QtConcurrent::run([&source, blockStart, blockSize, isLastBlock, compressionLevel] {
+            return deflateBlock(source, blockStart, blockSize, isLastBlock, compressionLevel);
+        });
+    }
+
+    destination.append(GZIP_HEADER, sizeof(GZIP_HEADER));
+
+    bool success = true;
+    uLong crc = crc32(0L, Z_NULL, 0);
+    for (int i = 0; i < blocks.size(); i++) {
+        // wait for all of them, even after a failure, they reference source
+        DeflatedBlock block = blocks[i].result();
+        success = success && block.success;
+        if (success) {
+            int blockSize = qMin(PARALLEL_GZIP_BLOCK_SIZE, source.length() - i * PARALLEL_GZIP_BLOCK_SIZE);
+            crc = crc32_combine(crc, block.crc, blockSize);
+            destination.append(block.data);
+        }
+    }
+
+    if (!success) {
+        destination.clear();
+        return false;
+    }
+
+    char trailer[2 * sizeof(quint32)];
+    qToLittleEndian<quint32>((quint32)crc, (uchar*)trailer);
+    qToLittleEndian<quint32>((quint32)source.length(), (uchar*)trailer + sizeof(quint32));
+    destination.append(trailer, sizeof(trailer));
+    return true;
+}
+
 bool gzip(QByteArray source, QByteArray &destination, int compressionLevel) {
     destination.clear();
     if (source.length() == 0) {
         return true;
     }
 
+    if (source.length() > 2 * PARALLEL_GZIP_BLOCK_SIZE) {
+        return parallelGzip(source, destination, qMax(Z_DEFAULT_COMPRESSION, qMin(9, compressionLevel)));
+    }
+
     int flushOrFinish = 0;
     z_stream strm;
     strm.zalloc = Z_NULL;
@@ -151,3 +263,89 @@ bool gzip(QByteArray source, QByteArray &destination, int compressionLevel) {
     deflateEnd(&strm);
     return status == Z_STREAM_END;
 }
+
+GzipWriter::GzipWriter(QIODevice* destination, int compressionLevel) :
+    _destination(destination),
+    _compressionLevel(qMax(Z_DEFAULT_COMPRESSION, qMin(9, compressionLevel))),
+    _crc(crc32(0L, Z_NULL, 0))
+{
+}
+
+qint64 GzipWriter::writeData(const char* data, qint64 size) {
+    if (_isFinished || !_success) {
+        return -1;
+    }
+
+    _pending.append(data, size);
+    _uncompressedSize += (quint32)size;
+
+    if (_pending.length() - _dictionarySize >= GZIP_WRITER_BLOCKS * PARALLEL_GZIP_BLOCK_SIZE) {
+        _success = deflatePending(false);
+        if (!_success) {
+            return -1;
+        }
+    }
+    return size;
+}
+
+bool GzipWriter::deflatePending(bool finishStream) {
+    if (!_wroteHeader) {
+        _wroteHeader = true;
+        if (_destination->write(GZIP_HEADER, sizeof(GZIP_HEADER)) != sizeof(GZIP_HEADER)) {
+            return false;
+        }
+    }
+
+    // the first block is primed with what was kept of the last ones, and even an empty end finishes the stream
+    QVector<QFuture<DeflatedBlock>> blocks;
+    QVector<int> blockSizes;
+    int blockStart = _dictionarySize;
+    do {
+        int blockSize = qMin(PARALLEL_GZIP_BLOCK_SIZE, _pending.length() - blockStart);
+        bool isLastBlock = finishStream && blockStart + blockSize == _pending.length();
+        blocks << QtConcurrent::run([this, blockStart, blockSize, isLastBlock] {
+            return deflateBlock(_pending, blockStart, blockSize, isLastBlock, _compressionLevel);
+        });
+        blockSizes << blockSize;
+        blockStart += blockSize;
+    } while (blockStart < _pending.length());
+
+    bool success = true;
+    for (int i = 0; i < blocks.size(); i++) {
+        // wait for all of them, even after a failure, they reference _pending
+        DeflatedBlock block = blocks[i].result();
+        success = success && block.success;
+        if (success) {
+            _crc = crc32_combine(_crc, block.crc, blockSizes[i]);
+            success = _destination->write(block.data) == block.data.length();
+        }
+    }
+
+    int dictionarySize = qMin(DEFLATE_DICTIONARY_SIZE, _pending.length());
+    _pending = _pending.right(dictionarySize);
+    _dictionarySize = dictionarySize;
+    return success;
+}
+
+bool GzipWriter::finish() {
+    if (_isFinished) {
+        return _success;
+    }
+    _isFinished = true;
+
+    _success = _success && deflatePending(true);
+    if (_success) {
+        char trailer[2 * sizeof(quint32)];
+        qToLittleEndian<quint32>((quint32)_crc, (uchar*)trailer);
+        qToLittleEndian<quint32>(_uncompressedSize, (uchar*)trailer + sizeof(quint32));
+        _success = _destination->write(trailer, sizeof(trailer)) == sizeof(trailer);
+    }
+
+    _pending.clear();
+    return _success;
+}
+
+void GzipWriter::close() {
+    finish();
+    QIODevice::close();
+}
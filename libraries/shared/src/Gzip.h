@@ -12,16 +12,52 @@
 #ifndef GZIP_H
 #define GZIP_H
 
-#include <QByteArray>
+#include <QtCore/QByteArray>
+#include <QtCore/QIODevice>
 
 // The compression level must be Z_DEFAULT_COMPRESSION (-1), or between 0 and
 // 9: 1 gives best speed, 9 gives best compression, 0 gives no
 // compression at all (the input data is simply copied a block at a
 // time).  Z_DEFAULT_COMPRESSION requests a default compromise between
 // speed and compression (currently equivalent to level 6).
+// Sources bigger than a few hundred KB are compressed on the thread pool, into a single gzip stream all the same.
 
 bool gzip(QByteArray source, QByteArray &destination, int compressionLevel = -1); // -1 is Z_DEFAULT_COMPRESSION
 
 bool gunzip(QByteArray source, QByteArray &destination);
 
+/// Gzips what is written to it into another device as it comes, so that a big document can be written out without
+/// ever being all in memory. What has been written is compressed a few blocks at a time on the thread pool, the way
+/// gzip() does the big sources, and finish() ends the stream.
+class GzipWriter : public QIODevice {
+public:
+    GzipWriter(QIODevice* destination, int compressionLevel = -1);
+
+    /// deflates what is left and writes the end of the stream, returns false if any of it couldn't be written
+    bool finish();
+
+    virtual bool isSequential() const override { return true; }
+    virtual void close() override;
+
+protected:
+    virtual qint64 readData(char* data, qint64 maxSize) override { return -1; }
+    virtual qint64 writeData(const char* data, qint64 size) override;
+
+private:
+    bool deflatePending(bool finishStream);
+
+    QIODevice* _destination;
+    int _compressionLevel;
+
+    // the end of what was deflated last, that primes the next blocks, and then what is still to deflate
+    QByteArray _pending;
+    int _dictionarySize { 0 };
+
+    unsigned long _crc;
+    quint32 _uncompressedSize { 0 };
+    bool _wroteHeader { false };
+    bool _isFinished { false };
+    bool _success { true };
+};
+
 #endif
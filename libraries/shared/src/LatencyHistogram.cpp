@@ -0,0 +1,91 @@
+//
+//  LatencyHistogram.cpp
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+// the values below NUM_SUB_BUCKETS get a bucket each, the others share the bucket of their highest bits
+int LatencyHistogram::bucketForValue(quint64 value) {
+    if (value < (quint64)NUM_SUB_BUCKETS) {
+        return (int)value;
+    }
+
+    int highestBit = 0;
+    for (quint64 remaining = value >> 1; remaining; remaining >>= 1) {
+        ++highestBit;
+    }
+
+    int shift = highestBit - SUB_BUCKET_BITS;
+    int subBucket = (int)((value >> shift) & (NUM_SUB_BUCKETS - 1));
+    return (shift + 1) * NUM_SUB_BUCKETS + subBucket;
+}
+
+quint64 LatencyHistogram::largestValueOfBucket(int bucket) {
+    if (bucket < NUM_SUB_BUCKETS) {
+        return (quint64)bucket;
+    }
+
+    int shift = bucket / NUM_SUB_BUCKETS - 1;
+    quint64 smallestValue = (quint64)(NUM_SUB_BUCKETS + bucket % NUM_SUB_BUCKETS) << shift;
+    return smallestValue + (((quint64)1 << shift) - 1);
+}
+
+void LatencyHistogram::record(quint64 value) {
+    ++_buckets[bucketForValue(value)];
+    ++_count;
+    _sum += value;
+    _max = std::max(_max, value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        _buckets[bucket] += other._buckets[bucket];
+    }
+    _count += other._count;
+    _sum += other._sum;
+    _max = std::max(_max, other._max);
+}
+
+void LatencyHistogram::reset() {
+    _buckets.fill(0);
+    _count = 0;
+    _sum = 0;
+    _max = 0;
+}
+
+quint64 LatencyHistogram::getPercentile(float percentile) const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    quint64 rank = std::max((quint64)1, (quint64)std::ceil(percentile * _count));
+    quint64 counted = 0;
+    for (int bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        counted += _buckets[bucket];
+        if (counted >= rank) {
+            return std::min(largestValueOfBucket(bucket), _max);
+        }
+    }
+    return _max;
+}
+
+QJsonObject LatencyHistogram::toJson() const {
+    QJsonObject json;
+    json["count"] = (double)_count;
+    json["mean"] = getMean();
+    json["max"] = (double)_max;
+    json["p50"] = (double)getPercentile(0.5f);
+    json["p90"] = (double)getPercentile(0.9f);
+    json["p99"] = (double)getPercentile(0.99f);
+    json["p999"] = (double)getPercentile(0.999f);
+    return json;
+}
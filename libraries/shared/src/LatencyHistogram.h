@@ -0,0 +1,52 @@
+//
+//  LatencyHistogram.h
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LatencyHistogram_h
+#define hifi_LatencyHistogram_h
+
+#include <array>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QtGlobal>
+
+/// Counts values (times in usecs, sizes in bytes) in buckets an eighth of a power of two wide, so the percentiles it
+/// gives are within 12.5% of the values recorded without keeping any of them.  Recording is a few integer operations,
+/// and the histograms of separate threads can be merged for the stats.
+class LatencyHistogram {
+public:
+    void record(quint64 value);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    quint64 getCount() const { return _count; }
+    quint64 getMax() const { return _max; }
+    double getMean() const { return _count > 0 ? (double)_sum / _count : 0.0; }
+
+    /// the largest value of the bucket the percentile (0 to 1) of the values falls into, at most the largest value
+    quint64 getPercentile(float percentile) const;
+
+    /// the count, mean, max and the 50th, 90th, 99th and 99.9th percentiles
+    QJsonObject toJson() const;
+
+    static int bucketForValue(quint64 value);
+    static quint64 largestValueOfBucket(int bucket);
+
+private:
+    static const int SUB_BUCKET_BITS = 3;
+    static const int NUM_SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * NUM_SUB_BUCKETS;
+
+    std::array<quint64, NUM_BUCKETS> _buckets {};
+    quint64 _count { 0 };
+    quint64 _sum { 0 };
+    quint64 _max { 0 };
+};
+
+#endif // hifi_LatencyHistogram_h
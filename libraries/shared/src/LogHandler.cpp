@@ -10,6 +10,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cassert>
+#include <cstdint>
+
 #include <qcoreapplication.h>
 
 #include <QDateTime>
@@ -21,6 +24,75 @@
 
 #include "LogHandler.h"
 
+// the messages waiting for the writer thread past which new ones are dropped, and how long it sleeps at most when
+// there are none, in case the wake of a message queued as it went to sleep was missed
+const int LOG_QUEUE_CAPACITY = 8192;
+const unsigned long MAX_WRITER_WAIT_MSECS = 100;
+
+struct QueuedLogMessage {
+    LogMsgType type;
+    const char* categoryName;
+    QString message;
+    qint64 msecsSinceEpoch;
+    size_t threadID;
+};
+
+// A bounded queue of many producers and one consumer at a time, that neither waits on a lock. Each slot carries
+// the position it is next ready for, which the producers claim with a compare and swap.
+class LogHandler::LogQueue {
+public:
+    LogQueue(int capacity) : _mask(capacity - 1), _slots(new Slot[capacity]) {
+        assert((capacity & _mask) == 0);
+        for (int i = 0; i < capacity; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// false when the queue is full
+    bool push(QueuedLogMessage&& message) {
+        size_t position = _pushPosition.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = _slots[position & _mask];
+            intptr_t difference = (intptr_t)slot.sequence.load(std::memory_order_acquire) - (intptr_t)position;
+            if (difference == 0) {
+                if (_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.message = std::move(message);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = _pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// false when the queue is empty, or its next message is still being written
+    bool pop(QueuedLogMessage& message) {
+        size_t position = _popPosition.load(std::memory_order_relaxed);
+        Slot& slot = _slots[position & _mask];
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+        _popPosition.store(position + 1, std::memory_order_relaxed);
+        message = std::move(slot.message);
+        slot.sequence.store(position + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        QueuedLogMessage message;
+    };
+
+    const size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    std::atomic<size_t> _pushPosition { 0 };
+    std::atomic<size_t> _popPosition { 0 };
+};
+
 LogHandler& LogHandler::getInstance() {
     static LogHandler staticInstance;
     return staticInstance;
@@ -28,7 +100,8 @@ LogHandler& LogHandler::getInstance() {
 
 LogHandler::LogHandler() :
     _shouldOutputProcessID(false),
-    _shouldOutputThreadID(false)
+    _shouldOutputThreadID(false),
+    _queue(new LogQueue(LOG_QUEUE_CAPACITY))
 {
     // setup our timer to flush the verbose logs every 5 seconds
     QTimer* logFlushTimer = new QTimer(this);
@@ -40,6 +113,18 @@ LogHandler::LogHandler() :
     printf("%s\n", qPrintable(timezoneString));
 }
 
+LogHandler::~LogHandler() {
+    if (_writer.joinable()) {
+        _isStopping = true;
+        {
+            QMutexLocker locker(&_writerWaitMutex);
+            _hasQueuedMessages.wakeAll();
+        }
+        _writer.join();
+    }
+    flushQueuedMessages();
+}
+
 const char* stringForLogType(LogMsgType msgType) {
     switch (msgType) {
         case LogInfo:
@@ -81,6 +166,10 @@ void LogHandler::flushRepeatedMessages() {
 }
 
 QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
+    return printMessage(type, message, QDateTime::currentMSecsSinceEpoch(), (size_t)QThread::currentThreadId());
+}
+
+QString LogHandler::printMessage(LogMsgType type, const QString& message, qint64 msecsSinceEpoch, size_t threadID) {
 
     if (message.isEmpty()) {
         return QString();
@@ -132,7 +221,7 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
     // log prefix is in the following format
     // [TIMESTAMP] [DEBUG] [PID] [TID] [TARGET] logged string
 
-    QString prefixString = QString("[%1]").arg(QDateTime::currentDateTime().toString(DATE_STRING_FORMAT));
+    QString prefixString = QString("[%1]").arg(QDateTime::fromMSecsSinceEpoch(msecsSinceEpoch).toString(DATE_STRING_FORMAT));
 
     prefixString.append(QString(" [%1]").arg(stringForLogType(type)));
 
@@ -141,7 +230,6 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
     }
 
     if (_shouldOutputThreadID) {
-        size_t threadID = (size_t)QThread::currentThreadId();
         prefixString.append(QString(" [%1]").arg(threadID));
     }
 
@@ -154,8 +242,101 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
     return logMessage;
 }
 
+void LogHandler::queueMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
+    if (type == LogFatal) {
+        // the process aborts once we return
+        flushQueuedMessages();
+        printMessage(type, context, message);
+        fflush(stdout);
+        return;
+    }
+
+    std::call_once(_writerStarted, [this] {
+        _writer = std::thread([this] { writeQueuedMessages(); });
+    });
+
+    if (!_queue->push({ type, context.category, message, QDateTime::currentMSecsSinceEpoch(),
+                        (size_t)QThread::currentThreadId() })) {
+        _droppedMessages++;
+        return;
+    }
+
+    if (_isWriterWaiting.load(std::memory_order_acquire)) {
+        _hasQueuedMessages.wakeOne();
+    }
+}
+
+void LogHandler::flushQueuedMessages() {
+    QMutexLocker locker(&_writerMutex);
+
+    QueuedLogMessage queued;
+    bool hasPrinted = false;
+    while (_queue->pop(queued)) {
+        if (!isRateLimited(queued.categoryName, queued.msecsSinceEpoch)) {
+            printMessage(queued.type, queued.message, queued.msecsSinceEpoch, queued.threadID);
+            hasPrinted = true;
+        }
+        queued.message.clear();
+    }
+
+    int droppedMessages = _droppedMessages.exchange(0);
+    if (droppedMessages > 0) {
+        QMessageLogContext emptyContext;
+        printMessage(LogSuppressed, emptyContext, QString("%1 log entries dropped, the log queue was full").arg(droppedMessages));
+        hasPrinted = true;
+    }
+
+    if (hasPrinted) {
+        fflush(stdout);
+    }
+}
+
+void LogHandler::writeQueuedMessages() {
+    while (!_isStopping) {
+        flushQueuedMessages();
+
+        QMutexLocker locker(&_writerWaitMutex);
+        _isWriterWaiting.store(true, std::memory_order_release);
+        if (!_isStopping) {
+            _hasQueuedMessages.wait(&_writerWaitMutex, MAX_WRITER_WAIT_MSECS);
+        }
+        _isWriterWaiting.store(false, std::memory_order_release);
+    }
+}
+
+bool LogHandler::isRateLimited(const char* categoryName, qint64 msecsSinceEpoch) {
+    QMutexLocker locker(&_categoryRatesLock);
+    if (_categoryRates.isEmpty() || !categoryName) {
+        return false;
+    }
+
+    auto rate = _categoryRates.find(QString::fromLatin1(categoryName));
+    if (rate == _categoryRates.end()) {
+        return false;
+    }
+
+    const qint64 MSECS_PER_RATE_WINDOW = 1000;
+    if (msecsSinceEpoch - rate->secondStart >= MSECS_PER_RATE_WINDOW) {
+        if (rate->suppressed > 0) {
+            QMessageLogContext emptyContext;
+            printMessage(LogSuppressed, emptyContext, QString("%1 log entries of category %2 over its limit of %3 a second")
+                .arg(rate->suppressed).arg(rate.key()).arg(rate->messagesPerSecond));
+        }
+        rate->secondStart = msecsSinceEpoch;
+        rate->messages = 0;
+        rate->suppressed = 0;
+    }
+
+    if (rate->messages >= rate->messagesPerSecond) {
+        rate->suppressed++;
+        return true;
+    }
+    rate->messages++;
+    return false;
+}
+
 void LogHandler::verboseMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message) {
-    getInstance().printMessage((LogMsgType) type, context, message);
+    getInstance().queueMessage((LogMsgType) type, context, message);
 }
 
 const QString& LogHandler::addRepeatedMessageRegex(const QString& regexString) {
@@ -167,3 +348,8 @@ const QString& LogHandler::addOnlyOnceMessageRegex(const QString& regexString) {
     QMutexLocker locker(&_onlyOnceMessageLock);
     return *_onlyOnceMessageRegexes.insert(regexString);
 }
+
+void LogHandler::setCategoryRateLimit(const QString& categoryName, int messagesPerSecond) {
+    QMutexLocker locker(&_categoryRatesLock);
+    _categoryRates[categoryName].messagesPerSecond = messagesPerSecond;
+}
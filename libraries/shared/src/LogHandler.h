@@ -13,11 +13,17 @@
 #ifndef hifi_LogHandler_h
 #define hifi_LogHandler_h
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include <QHash>
 #include <QObject>
 #include <QSet>
 #include <QString>
 #include <QMutex>
+#include <QWaitCondition>
 
 const int VERBOSE_LOG_INTERVAL_SECONDS = 5;
 
@@ -45,17 +51,42 @@ public:
 
     QString printMessage(LogMsgType type, const QMessageLogContext& context, const QString &message);
 
+    /// queues the message for the log writer thread, which formats, filters and prints it, so that the caller waits on
+    /// neither, nor on a lock. Fatal messages are printed, with those queued before them, before this returns.
+    void queueMessage(LogMsgType type, const QMessageLogContext& context, const QString& message);
+
+    /// prints what is queued for the log writer thread
+    void flushQueuedMessages();
+
     /// a qtMessageHandler that can be hooked up to a target that links to Qt
     /// prints various process, message type, and time information
     static void verboseMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString &message);
 
     const QString& addRepeatedMessageRegex(const QString& regexString);
     const QString& addOnlyOnceMessageRegex(const QString& regexString);
+
+    /// the queued messages of the category past this many in a second are counted rather than printed
+    void setCategoryRateLimit(const QString& categoryName, int messagesPerSecond);
+
 private:
+    class LogQueue;
+    struct CategoryRate {
+        int messagesPerSecond { 0 };
+        qint64 secondStart { 0 };
+        int messages { 0 };
+        int suppressed { 0 };
+    };
+
     LogHandler();
+    ~LogHandler();
+
+    QString printMessage(LogMsgType type, const QString& message, qint64 msecsSinceEpoch, size_t threadID);
 
     void flushRepeatedMessages();
 
+    void writeQueuedMessages();
+    bool isRateLimited(const char* categoryName, qint64 msecsSinceEpoch);
+
     QString _targetName;
     bool _shouldOutputProcessID;
     bool _shouldOutputThreadID;
@@ -67,6 +98,19 @@ private:
     QSet<QString> _onlyOnceMessageRegexes;
     QHash<QString, int> _onlyOnceMessageCountHash;
     QMutex _onlyOnceMessageLock;
+
+    std::unique_ptr<LogQueue> _queue;
+    std::atomic<int> _droppedMessages { 0 };
+    std::once_flag _writerStarted;
+    std::thread _writer;
+    std::atomic<bool> _isWriterWaiting { false };
+    std::atomic<bool> _isStopping { false };
+    QMutex _writerMutex; // the queue has one consumer at a time, the writer thread or a flush
+    QMutex _writerWaitMutex;
+    QWaitCondition _hasQueuedMessages;
+
+    QHash<QString, CategoryRate> _categoryRates;
+    QMutex _categoryRatesLock;
 };
 
 #endif // hifi_LogHandler_h
@@ -0,0 +1,135 @@
+//
+//  MatrixKernels.cpp
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CPUDetect.h"
+
+#include "MatrixKernels.h"
+
+void MatrixKernels::multiplyScalar(const glm::mat4* left, const glm::mat4* right, glm::mat4* result, int count) {
+    for (int i = 0; i < count; i++) {
+        result[i] = left[i] * right[i];
+    }
+}
+
+void MatrixKernels::packAffineRowsScalar(const glm::mat4* matrices, glm::vec4* rows, int count) {
+    for (int i = 0; i < count; i++) {
+        const glm::mat4& m = matrices[i];
+        for (int r = 0; r < 3; r++) {
+            rows[3 * i + r] = glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+        }
+    }
+}
+
+#if defined(ARCH_X86)
+
+#include <emmintrin.h>
+
+// the matrices are column major: each column of the product is the left matrix applied to a column of the right one
+static inline void multiplySSE2(const float* left, const float* right, float* result) {
+    __m128 l0 = _mm_loadu_ps(&left[0]);
+    __m128 l1 = _mm_loadu_ps(&left[4]);
+    __m128 l2 = _mm_loadu_ps(&left[8]);
+    __m128 l3 = _mm_loadu_ps(&left[12]);
+
+    for (int j = 0; j < 4; j++) {
+        __m128 r = _mm_loadu_ps(&right[4 * j]);
+        __m128 column = _mm_mul_ps(l0, _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 0)));
+        column = _mm_add_ps(column, _mm_mul_ps(l1, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1))));
+        column = _mm_add_ps(column, _mm_mul_ps(l2, _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 2, 2))));
+        column = _mm_add_ps(column, _mm_mul_ps(l3, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3))));
+        _mm_storeu_ps(&result[4 * j], column);
+    }
+}
+
+void MatrixKernels::multiply(const glm::mat4* left, const glm::mat4* right, glm::mat4* result, int count) {
+    for (int i = 0; i < count; i++) {
+        multiplySSE2(&left[i][0][0], &right[i][0][0], &result[i][0][0]);
+    }
+}
+
+void MatrixKernels::multiply(const glm::mat4& left, const glm::mat4* right, glm::mat4* result, int count) {
+    for (int i = 0; i < count; i++) {
+        multiplySSE2(&left[0][0], &right[i][0][0], &result[i][0][0]);
+    }
+}
+
+void MatrixKernels::packAffineRows(const glm::mat4* matrices, glm::vec4* rows, int count) {
+    for (int i = 0; i < count; i++) {
+        const float* m = &matrices[i][0][0];
+        __m128 c0 = _mm_loadu_ps(&m[0]);
+        __m128 c1 = _mm_loadu_ps(&m[4]);
+        __m128 c2 = _mm_loadu_ps(&m[8]);
+        __m128 c3 = _mm_loadu_ps(&m[12]);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(&rows[3 * i + 0][0], c0);
+        _mm_storeu_ps(&rows[3 * i + 1][0], c1);
+        _mm_storeu_ps(&rows[3 * i + 2][0], c2);
+    }
+}
+
+#elif defined(ARCH_NEON)
+
+#include <arm_neon.h>
+
+static inline void multiplyNEON(const float* left, const float* right, float* result) {
+    float32x4_t l0 = vld1q_f32(&left[0]);
+    float32x4_t l1 = vld1q_f32(&left[4]);
+    float32x4_t l2 = vld1q_f32(&left[8]);
+    float32x4_t l3 = vld1q_f32(&left[12]);
+
+    for (int j = 0; j < 4; j++) {
+        const float* r = &right[4 * j];
+        float32x4_t column = vmulq_n_f32(l0, r[0]);
+        column = vmlaq_n_f32(column, l1, r[1]);
+        column = vmlaq_n_f32(column, l2, r[2]);
+        column = vmlaq_n_f32(column, l3, r[3]);
+        vst1q_f32(&result[4 * j], column);
+    }
+}
+
+void MatrixKernels::multiply(const glm::mat4* left, const glm::mat4* right, glm::mat4* result, int count) {
+    for (int i = 0; i < count; i++) {
+        multiplyNEON(&left[i][0][0], &right[i][0][0], &result[i][0][0]);
+    }
+}
+
+void MatrixKernels::multiply(const glm::mat4& left, const glm::mat4* right, glm::mat4* result, int count) {
+    for (int i = 0; i < count; i++) {
+        multiplyNEON(&left[0][0], &right[i][0][0], &result[i][0][0]);
+    }
+}
+
+void MatrixKernels::packAffineRows(const glm::mat4* matrices, glm::vec4* rows, int count) {
+    for (int i = 0; i < count; i++) {
+        // deinterleaving the four columns leaves their rows in the registers
+        float32x4x4_t columns = vld4q_f32(&matrices[i][0][0]);
+        vst1q_f32(&rows[3 * i + 0][0], columns.val[0]);
+        vst1q_f32(&rows[3 * i + 1][0], columns.val[1]);
+        vst1q_f32(&rows[3 * i + 2][0], columns.val[2]);
+    }
+}
+
+#else
+
+void MatrixKernels::multiply(const glm::mat4* left, const glm::mat4* right, glm::mat4* result, int count) {
+    multiplyScalar(left, right, result, count);
+}
+
+void MatrixKernels::multiply(const glm::mat4& left, const glm::mat4* right, glm::mat4* result, int count) {
+    for (int i = 0; i < count; i++) {
+        result[i] = left * right[i];
+    }
+}
+
+void MatrixKernels::packAffineRows(const glm::mat4* matrices, glm::vec4* rows, int count) {
+    packAffineRowsScalar(matrices, rows, count);
+}
+
+#endif
@@ -0,0 +1,36 @@
+//
+//  MatrixKernels.h
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MatrixKernels_h
+#define hifi_MatrixKernels_h
+
+#include <glm/glm.hpp>
+
+//
+// Kernels for the matrix work done per joint and per cluster every frame.
+// They are SSE2 on x86 (which every x86 CPU we run on has) and NEON on ARM, with a portable fallback.
+//
+namespace MatrixKernels {
+
+    // result[i] = left[i] * right[i], the same as glm
+    void multiply(const glm::mat4* left, const glm::mat4* right, glm::mat4* result, int count);
+
+    // result[i] = left * right[i]; result can be right, to multiply in place
+    void multiply(const glm::mat4& left, const glm::mat4* right, glm::mat4* result, int count);
+
+    // rows[3 * i + r] = row r of matrices[i]; the matrices are affine, so the last row is left out
+    void packAffineRows(const glm::mat4* matrices, glm::vec4* rows, int count);
+
+    // portable versions, also used to check the vectorized kernels
+    void multiplyScalar(const glm::mat4* left, const glm::mat4* right, glm::mat4* result, int count);
+    void packAffineRowsScalar(const glm::mat4* matrices, glm::vec4* rows, int count);
+}
+
+#endif // hifi_MatrixKernels_h
@@ -264,6 +264,23 @@ unsigned char* chopOctalCode(const unsigned char* originalOctalCode, int chopLev
     return newCode;
 }
 
+unsigned char* parentOctalCode(const unsigned char* childOctalCode) {
+    int codeLength = numberOfThreeBitSectionsInCode(childOctalCode);
+    unsigned char* newCode = NULL;
+    if (codeLength > 0) {
+        int newLength = codeLength - 1;
+        size_t newBytes = bytesRequiredForCodeLength(newLength);
+        newCode = new unsigned char[newBytes];
+        memset(newCode, 0, newBytes);
+        *newCode = newLength; // set the length byte
+
+        for (int section = 0; section < newLength; section++) {
+            setOctalCodeSectionValue(newCode, section, getOctalCodeSectionValue(childOctalCode, section));
+        }
+    }
+    return newCode;
+}
+
 bool isAncestorOf(const unsigned char* possibleAncestor, const unsigned char* possibleDescendent, int descendentsChild) {
     if (!possibleAncestor || !possibleDescendent) {
         return false;
@@ -37,6 +37,9 @@ int numberOfThreeBitSectionsInCode(const unsigned char* octalCode, int maxBytes
 
 unsigned char* chopOctalCode(const unsigned char* originalOctalCode, int chopLevels);
 
+/// the code of the parent of the node, NULL for the root
+unsigned char* parentOctalCode(const unsigned char* childOctalCode);
+
 const int CHECK_NODE_ONLY = -1;
 bool isAncestorOf(const unsigned char* possibleAncestor, const unsigned char* possibleDescendent, 
         int descendentsChild = CHECK_NODE_ONLY);
@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstring>
 
 #include <QBitArray>
 #include <QByteArray>
@@ -53,6 +54,11 @@ public:
     void setHasProperty(Enum flag, bool value = true);
     bool getHasProperty(Enum flag) const;
     QByteArray encode();
+
+    // encodes into the buffer without allocating, returns the bytes written or 0 if getEncodedSize() doesn't fit
+    int encode(unsigned char* buffer, int bufferSize);
+    int getEncodedSize() const;
+
     size_t decode(const uint8_t* data, size_t length);
     size_t decode(const QByteArray& fromEncoded);
 
@@ -158,27 +164,36 @@ template<typename Enum> inline bool PropertyFlags<Enum>::getHasProperty(Enum fla
 
 const int BITS_PER_BYTE = 8;
 
-template<typename Enum> inline QByteArray PropertyFlags<Enum>::encode() {
-    QByteArray output;
-    
+template<typename Enum> inline int PropertyFlags<Enum>::getEncodedSize() const {
     if (_maxFlag < _minFlag) {
-        output.fill(0, 1);
-        return output; // no flags... nothing to encode
+        return 1; // no flags... a single empty byte
     }
+    return (_maxFlag / (BITS_PER_BYTE - 1)) + 1;
+}
+
+template<typename Enum> inline QByteArray PropertyFlags<Enum>::encode() {
+    QByteArray output(getEncodedSize(), 0);
+    encode((unsigned char*)output.data(), output.size());
+    return output;
+}
 
-    // we should size the array to the correct size.
-    int lengthInBytes = (_maxFlag / (BITS_PER_BYTE - 1)) + 1;
+template<typename Enum> inline int PropertyFlags<Enum>::encode(unsigned char* buffer, int bufferSize) {
+    int lengthInBytes = getEncodedSize();
+    if (lengthInBytes > bufferSize) {
+        return 0;
+    }
+    memset(buffer, 0, lengthInBytes);
 
-    output.fill(0, lengthInBytes);
+    if (_maxFlag < _minFlag) {
+        return lengthInBytes; // no flags... nothing to encode
+    }
 
     // next pack the number of header bits in, the first N-1 to be set to 1, the last to be set to 0
     for(int i = 0; i < lengthInBytes; i++) {
         int outputIndex = i;
         int bitValue = (i < (lengthInBytes - 1)  ? 1 : 0);
-        char original = output.at(outputIndex / BITS_PER_BYTE);
         int shiftBy = BITS_PER_BYTE - ((outputIndex % BITS_PER_BYTE) + 1);
-        char thisBit = ( bitValue << shiftBy);
-        output[i / BITS_PER_BYTE] = (original | thisBit);
+        buffer[outputIndex / BITS_PER_BYTE] |= (unsigned char)(bitValue << shiftBy);
     }
 
     // finally pack the the actual bits from the bit array
@@ -186,14 +201,12 @@ template<typename Enum> inline QByteArray PropertyFlags<Enum>::encode() {
         int flagIndex = i - lengthInBytes;
         int outputIndex = i;
         int bitValue = ( _flags[flagIndex]  ? 1 : 0);
-        char original = output.at(outputIndex / BITS_PER_BYTE);
         int shiftBy = BITS_PER_BYTE - ((outputIndex % BITS_PER_BYTE) + 1);
-        char thisBit = ( bitValue << shiftBy);
-        output[i / BITS_PER_BYTE] = (original | thisBit);
+        buffer[outputIndex / BITS_PER_BYTE] |= (unsigned char)(bitValue << shiftBy);
     }
     
     _encodedLength = lengthInBytes;
-    return output;
+    return lengthInBytes;
 }
 
 template<typename Enum> 
@@ -279,10 +292,8 @@ template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operato
 }
 
 template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator|=(Enum flag) {
-    PropertyFlags other(flag); 
-    _flags |= other._flags; 
-    _maxFlag = std::max(_maxFlag, other._maxFlag); 
-    _minFlag = std::min(_minFlag, other._minFlag); 
+    // the same as or-ing in PropertyFlags(flag), without building its bits to do it
+    setHasProperty(flag, true);
     return *this; 
 }
 
@@ -0,0 +1,87 @@
+//
+//  SipHash.cpp
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t readLittleEndian64(const uint8_t* bytes) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+static inline void writeLittleEndian64(uint64_t value, uint8_t* bytes) {
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+struct SipState {
+    uint64_t v0, v1, v2, v3;
+
+    void round() {
+        v0 += v1; v1 = rotateLeft(v1, 13); v1 ^= v0; v0 = rotateLeft(v0, 32);
+        v2 += v3; v3 = rotateLeft(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotateLeft(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotateLeft(v1, 17); v1 ^= v2; v2 = rotateLeft(v2, 32);
+    }
+
+    void compress(uint64_t m) {
+        v3 ^= m;
+        round();
+        round();
+        v0 ^= m;
+    }
+
+    uint64_t finalize(uint8_t marker) {
+        v2 ^= marker;
+        round();
+        round();
+        round();
+        round();
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+};
+
+void sipHash128(const uint8_t key[SIPHASH_KEY_BYTES], const char* data, size_t size, uint8_t output[SIPHASH_128_BYTES]) {
+    uint64_t k0 = readLittleEndian64(key);
+    uint64_t k1 = readLittleEndian64(key + 8);
+
+    SipState state {
+        k0 ^ 0x736f6d6570736575ULL,
+        k1 ^ 0x646f72616e646f6dULL ^ 0xee,
+        k0 ^ 0x6c7967656e657261ULL,
+        k1 ^ 0x7465646279746573ULL
+    };
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* end = bytes + (size & ~(size_t)7);
+
+    for (; bytes != end; bytes += 8) {
+        state.compress(readLittleEndian64(bytes));
+    }
+
+    // the last block holds the remaining bytes and the length of the input in its top byte
+    uint64_t last = (uint64_t)size << 56;
+    for (size_t i = 0; i < (size & 7); ++i) {
+        last |= (uint64_t)bytes[i] << (8 * i);
+    }
+    state.compress(last);
+
+    writeLittleEndian64(state.finalize(0xee), output);
+
+    state.v1 ^= 0xdd;
+    writeLittleEndian64(state.finalize(0), output + 8);
+}
@@ -0,0 +1,23 @@
+//
+//  SipHash.h
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+const int SIPHASH_KEY_BYTES = 16;
+const int SIPHASH_128_BYTES = 16;
+
+// SipHash-2-4 with a 128 bit output, a keyed MAC that is a lot cheaper than a cryptographic hash on short inputs
+void sipHash128(const uint8_t key[SIPHASH_KEY_BYTES], const char* data, size_t size, uint8_t output[SIPHASH_128_BYTES]);
+
+#endif // hifi_SipHash_h
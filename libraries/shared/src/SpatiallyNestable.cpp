@@ -52,6 +52,7 @@ void SpatiallyNestable::setParentID(const QUuid& parentID) {
         if (_parentID != parentID) {
             _parentID = parentID;
             _parentKnowsMe = false;
+            _transformGeneration++;
         }
     });
 }
@@ -138,6 +139,7 @@ void SpatiallyNestable::forgetChild(SpatiallyNestablePointer newChild) const {
 
 void SpatiallyNestable::setParentJointIndex(quint16 parentJointIndex) {
     _parentJointIndex = parentJointIndex;
+    _transformGeneration++;
 }
 
 glm::vec3 SpatiallyNestable::worldToLocal(const glm::vec3& position,
@@ -322,6 +324,7 @@ void SpatiallyNestable::setPosition(const glm::vec3& position, bool& success) {
     Transform parentTransform = getParentTransform(success);
     Transform myWorldTransform;
     _transformLock.withWriteLock([&] {
+        _transformGeneration++;
         Transform::mult(myWorldTransform, parentTransform, _transform);
         myWorldTransform.setTranslation(position);
         Transform::inverseMult(_transform, parentTransform, myWorldTransform);
@@ -372,6 +375,7 @@ void SpatiallyNestable::setOrientation(const glm::quat& orientation, bool& succe
     Transform parentTransform = getParentTransform(success);
     Transform myWorldTransform;
     _transformLock.withWriteLock([&] {
+        _transformGeneration++;
         Transform::mult(myWorldTransform, parentTransform, _transform);
         myWorldTransform.setRotation(orientation);
         Transform::inverseMult(_transform, parentTransform, myWorldTransform);
@@ -391,12 +395,63 @@ void SpatiallyNestable::setOrientation(const glm::quat& orientation) {
     #endif
 }
 
-const Transform SpatiallyNestable::getTransform(bool& success) const {
-    // return a world-space transform for this object's location
+void SpatiallyNestable::setPositionAndOrientation(const glm::vec3& position, const glm::quat& orientation, bool& success) {
+    // guard against introducing NaN into the transform
+    if (isNaN(position) || isNaN(orientation)) {
+        success = false;
+        return;
+    }
+
     Transform parentTransform = getParentTransform(success);
+    Transform myWorldTransform;
+    _transformLock.withWriteLock([&] {
+        _transformGeneration++;
+        Transform::mult(myWorldTransform, parentTransform, _transform);
+        myWorldTransform.setTranslation(position);
+        myWorldTransform.setRotation(orientation);
+        Transform::inverseMult(_transform, parentTransform, myWorldTransform);
+    });
+    if (success) {
+        locationChanged();
+    }
+}
+
+const Transform SpatiallyNestable::getTransform(bool& success) const {
+    // return a world-space transform for this object's location.  It's kept from the last time it was found until
+    // this or an ancestor moves, which bumps _transformGeneration, so a read usually doesn't go up the parent chain.
+    quint32 generation = _transformGeneration;
+
+    // joints move without telling their children, so what the parent's is now has to match what it was
+    SpatiallyNestablePointer parent = _parent.lock();
+    Transform parentJointTransform;
+    if (parent) {
+        parentJointTransform = parent->getAbsoluteJointTransformInObjectFrame(_parentJointIndex);
+    }
+
     Transform result;
+    bool isCached = false;
     _transformLock.withReadLock([&] {
+        if (_worldTransformValid && _worldTransformGeneration == generation && _worldTransformHasParent == (bool)parent
+                && (!parent || _worldTransformParentJoint == parentJointTransform)) {
+            result = _worldTransform;
+            isCached = true;
+        }
+    });
+    if (isCached) {
+        success = true;
+        return result;
+    }
+
+    Transform parentTransform = getParentTransform(success);
+    _transformLock.withWriteLock([&] {
         Transform::mult(result, parentTransform, _transform);
+        if (success) {
+            _worldTransform = result;
+            _worldTransformGeneration = generation;
+            _worldTransformValid = true;
+            _worldTransformHasParent = (bool)parent;
+            _worldTransformParentJoint = parentJointTransform;
+        }
     });
     return result;
 }
@@ -425,6 +480,7 @@ void SpatiallyNestable::setTransform(const Transform& transform, bool& success)
     }
     Transform parentTransform = getParentTransform(success);
     _transformLock.withWriteLock([&] {
+        _transformGeneration++;
         Transform::inverseMult(_transform, parentTransform, transform);
     });
     if (success) {
@@ -454,6 +510,7 @@ void SpatiallyNestable::setScale(const glm::vec3& scale) {
     }
     // TODO: scale
     _transformLock.withWriteLock([&] {
+        _transformGeneration++;
         _transform.setScale(scale);
     });
     dimensionsChanged();
@@ -474,6 +531,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
         return;
     }
     _transformLock.withWriteLock([&] {
+        _transformGeneration++;
         _transform = transform;
     });
     locationChanged();
@@ -494,6 +552,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position) {
         return;
     }
     _transformLock.withWriteLock([&] {
+        _transformGeneration++;
         _transform.setTranslation(position);
     });
     locationChanged();
@@ -514,6 +573,7 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
         return;
     }
     _transformLock.withWriteLock([&] {
+        _transformGeneration++;
         _transform.setRotation(orientation);
     });
     locationChanged();
@@ -536,6 +596,7 @@ void SpatiallyNestable::setLocalScale(const glm::vec3& scale) {
     }
     // TODO: scale
     _transformLock.withWriteLock([&] {
+        _transformGeneration++;
         _transform.setScale(scale);
     });
     dimensionsChanged();
@@ -569,6 +630,14 @@ SpatiallyNestablePointer SpatiallyNestable::getThisPointer() const {
     return thisPointer;
 }
 
+bool SpatiallyNestable::hasChildren() const {
+    bool result = false;
+    _childrenLock.withReadLock([&] {
+        result = !_children.isEmpty();
+    });
+    return result;
+}
+
 void SpatiallyNestable::forEachChild(std::function<void(SpatiallyNestablePointer)> actor) {
     foreach(SpatiallyNestablePointer child, getChildren()) {
         actor(child);
@@ -591,6 +660,8 @@ void SpatiallyNestable::forEachDescendant(std::function<void(SpatiallyNestablePo
 }
 
 void SpatiallyNestable::locationChanged() {
+    // whatever world transforms this and the children kept are out of date
+    _transformGeneration++;
     forEachChild([&](SpatiallyNestablePointer object) {
         object->locationChanged();
     });
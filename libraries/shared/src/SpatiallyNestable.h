@@ -12,6 +12,8 @@
 #ifndef hifi_SpatiallyNestable_h
 #define hifi_SpatiallyNestable_h
 
+#include <atomic>
+
 #include <QUuid>
 
 #include "Transform.h"
@@ -68,6 +70,9 @@ public:
     virtual void setOrientation(const glm::quat& orientation, bool& success);
     virtual void setOrientation(const glm::quat& orientation);
 
+    // sets both with one look at the parent and one change notification, for those that always move both at once
+    virtual void setPositionAndOrientation(const glm::vec3& position, const glm::quat& orientation, bool& success);
+
     virtual AACube getMaximumAACube(bool& success) const;
     virtual bool computePuffedQueryAACube();
 
@@ -112,6 +117,7 @@ public:
     void markAncestorMissing(bool value) { _missingAncestor = value; }
     bool getAncestorMissing() { return _missingAncestor; }
 
+    bool hasChildren() const;
     void forEachChild(std::function<void(SpatiallyNestablePointer)> actor);
     void forEachDescendant(std::function<void(SpatiallyNestablePointer)> actor);
 
@@ -147,6 +153,15 @@ private:
     mutable ReadWriteLockable _transformLock;
     mutable ReadWriteLockable _idLock;
     Transform _transform; // this is to be combined with parent's world-transform to produce this' world-transform.
+
+    // the last world-transform, good while _transformGeneration is what it was found at.  Changes to _transform, the
+    // parent and locationChanged(), which goes down to the children when something moves, each bump the generation.
+    std::atomic<quint32> _transformGeneration { 0 };
+    mutable Transform _worldTransform;
+    mutable quint32 _worldTransformGeneration { 0 };
+    mutable bool _worldTransformValid { false };
+    mutable bool _worldTransformHasParent { false };
+    mutable Transform _worldTransformParentJoint;
     mutable bool _parentKnowsMe { false };
     bool _isDead { false };
 };
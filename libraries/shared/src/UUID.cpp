@@ -11,7 +11,16 @@
 
 #include "UUID.h"
 
+#include <QtCore/QtEndian>
+
 QString uuidStringWithoutCurlyBraces(const QUuid& uuid) {
     QString uuidStringNoBraces = uuid.toString().mid(1, uuid.toString().length() - 2);
     return uuidStringNoBraces;
 }
+
+void uuidToRfc4122(const QUuid& uuid, unsigned char* bytes) {
+    qToBigEndian<quint32>(uuid.data1, bytes);
+    qToBigEndian<quint16>(uuid.data2, bytes + 4);
+    qToBigEndian<quint16>(uuid.data3, bytes + 6);
+    memcpy(bytes + 8, uuid.data4, sizeof(uuid.data4));
+}
@@ -18,4 +18,7 @@ const int NUM_BYTES_RFC4122_UUID = 16;
 
 QString uuidStringWithoutCurlyBraces(const QUuid& uuid);
 
+// writes the same NUM_BYTES_RFC4122_UUID bytes as QUuid::toRfc4122(), without allocating a QByteArray for them
+void uuidToRfc4122(const QUuid& uuid, unsigned char* bytes);
+
 #endif // hifi_UUID_h
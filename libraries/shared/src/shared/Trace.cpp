@@ -0,0 +1,196 @@
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <QtCore/QFile>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+
+namespace trace {
+
+std::atomic<bool> _isActive { false };
+
+namespace {
+
+// the fields are atomic so that the exporting thread can read them while the owning thread writes the next ones
+struct Event {
+    std::atomic<const char*> name;
+    std::atomic<Clock::rep> begin;
+    std::atomic<Clock::rep> end;
+};
+
+class ThreadBuffer {
+public:
+    ThreadBuffer(int id, const QString& name) : id(id), name(name), events(new Event[EVENTS_PER_THREAD]) {}
+
+    const int id;
+    const QString name;
+    std::unique_ptr<Event[]> events;
+    std::atomic<quint64> written { 0 }; // only the owning thread adds to it
+    std::atomic<quint64> clearedAt { 0 };
+};
+using ThreadBufferPointer = std::shared_ptr<ThreadBuffer>;
+
+const Clock::time_point START_TIME = Clock::now();
+
+std::mutex buffersMutex;
+std::vector<ThreadBufferPointer> buffers; // kept after their threads are gone, until the process ends
+
+std::mutex namesMutex;
+std::set<std::string> names;
+
+QThreadStorage<ThreadBufferPointer> threadBuffers;
+
+ThreadBuffer& threadBuffer() {
+    if (!threadBuffers.hasLocalData()) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        QString threadName = QThread::currentThread()->objectName();
+        auto buffer = std::make_shared<ThreadBuffer>((int)buffers.size() + 1, threadName);
+        buffers.push_back(buffer);
+        threadBuffers.setLocalData(buffer);
+    }
+    return *threadBuffers.localData();
+}
+
+void appendEscaped(QByteArray& json, const char* string) {
+    for (const char* c = string; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            json.append('\\');
+            json.append(*c);
+        } else if ((unsigned char)*c < 0x20) {
+            json.append(' ');
+        } else {
+            json.append(*c);
+        }
+    }
+}
+
+double toUsecs(Clock::rep time) {
+    return std::chrono::duration<double, std::micro>(Clock::duration(time) - START_TIME.time_since_epoch()).count();
+}
+
+std::string traceFilePath;
+
+void writeTraceFileAtExit() {
+    writeChromeTrace(QString::fromStdString(traceFilePath));
+}
+
+// tracing from startup is asked for through the environment, since it has to be on before anything has run
+struct StartupTrace {
+    StartupTrace() {
+        const char* path = std::getenv("HIFI_TRACE_FILE");
+        if (path && *path) {
+            traceFilePath = path;
+            _isActive.store(true);
+            std::atexit(writeTraceFileAtExit);
+        }
+    }
+} startupTrace;
+
+}
+
+void setActive(bool active) {
+    _isActive.store(active);
+}
+
+const char* intern(const std::string& name) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    return names.insert(name).first->c_str();
+}
+
+void record(const char* name, Clock::time_point begin, Clock::time_point end) {
+    ThreadBuffer& buffer = threadBuffer();
+    quint64 index = buffer.written.load(std::memory_order_relaxed);
+    Event& event = buffer.events[index % (quint64)EVENTS_PER_THREAD];
+    event.name.store(name, std::memory_order_relaxed);
+    event.begin.store(begin.time_since_epoch().count(), std::memory_order_relaxed);
+    event.end.store(end.time_since_epoch().count(), std::memory_order_relaxed);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+QByteArray toChromeTrace() {
+    std::vector<ThreadBufferPointer> allBuffers;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        allBuffers = buffers;
+    }
+
+    struct CopiedEvent {
+        const char* name;
+        Clock::rep begin;
+        Clock::rep end;
+    };
+
+    QByteArray json = "{\"traceEvents\":[\n";
+    bool isFirst = true;
+    for (const auto& buffer : allBuffers) {
+        QByteArray threadName = buffer->name.isEmpty() ? QByteArray("Thread ") + QByteArray::number(buffer->id)
+                                                       : buffer->name.toUtf8();
+        json.append(isFirst ? "" : ",\n");
+        json.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+        json.append(QByteArray::number(buffer->id));
+        json.append(",\"args\":{\"name\":\"");
+        appendEscaped(json, threadName.constData());
+        json.append("\"}}");
+        isFirst = false;
+
+        const quint64 capacity = EVENTS_PER_THREAD;
+        quint64 written = buffer->written.load(std::memory_order_acquire);
+        quint64 first = std::max(buffer->clearedAt.load(), written > capacity ? written - capacity : 0);
+        std::vector<CopiedEvent> copied;
+        copied.reserve(written - first);
+        for (quint64 index = first; index < written; ++index) {
+            const Event& event = buffer->events[index % capacity];
+            copied.push_back({ event.name.load(std::memory_order_relaxed), event.begin.load(std::memory_order_relaxed),
+                               event.end.load(std::memory_order_relaxed) });
+        }
+
+        // the thread kept on recording while its events were copied, those it may have written over are dropped
+        quint64 writtenAfter = buffer->written.load(std::memory_order_acquire);
+        quint64 firstIntact = writtenAfter >= capacity ? writtenAfter - capacity + 1 : 0;
+
+        for (quint64 index = std::max(first, firstIntact); index < written; ++index) {
+            const CopiedEvent& event = copied[index - first];
+            json.append(",\n{\"name\":\"");
+            appendEscaped(json, event.name);
+            json.append("\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+            json.append(QByteArray::number(buffer->id));
+            json.append(",\"ts\":");
+            json.append(QByteArray::number(toUsecs(event.begin), 'f', 3));
+            json.append(",\"dur\":");
+            json.append(QByteArray::number(toUsecs(event.end) - toUsecs(event.begin), 'f', 3));
+            json.append("}");
+        }
+    }
+    json.append("\n]}\n");
+    return json;
+}
+
+bool writeChromeTrace(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(toChromeTrace()) != -1;
+}
+
+void clear() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (const auto& buffer : buffers) {
+        buffer->clearedAt.store(buffer->written.load());
+    }
+}
+
+}
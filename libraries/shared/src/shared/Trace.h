@@ -0,0 +1,73 @@
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Shared_Trace_h
+#define hifi_Shared_Trace_h
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+// A tracer cheap enough to leave in hot code: each thread records the scopes it runs into a ring buffer of its own,
+// without locks or allocations, and the names are string literals (or interned strings) that are only read when the
+// trace is exported.  The recent scopes of all the threads are written out in the Chrome trace event format, which
+// chrome://tracing and most trace viewers open.
+//
+// Tracing is off until setActive(true), or from startup when the HIFI_TRACE_FILE environment variable names the file
+// to write the trace to when the process exits.
+namespace trace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // the scopes each thread keeps, the oldest are overwritten
+    const int EVENTS_PER_THREAD = 1 << 14;
+
+    extern std::atomic<bool> _isActive;
+
+    inline bool isActive() { return _isActive.load(std::memory_order_relaxed); }
+    void setActive(bool active);
+
+    // a name that lives as long as the process, for the names that aren't literals
+    const char* intern(const std::string& name);
+
+    // records a finished scope into the buffer of this thread
+    void record(const char* name, Clock::time_point begin, Clock::time_point end);
+
+    // the scopes recorded by all of the threads, as a Chrome trace
+    QByteArray toChromeTrace();
+    bool writeChromeTrace(const QString& path);
+
+    // forgets the scopes recorded so far
+    void clear();
+
+    class Scope {
+    public:
+        Scope(const char* name) : _name(isActive() ? name : nullptr) {
+            if (_name) {
+                _begin = Clock::now();
+            }
+        }
+        ~Scope() {
+            if (_name) {
+                record(_name, _begin, Clock::now());
+            }
+        }
+
+    private:
+        const char* _name;
+        Clock::time_point _begin;
+    };
+
+}
+
+#define TRACE_SCOPE(name) trace::Scope traceScopeThis(name);
+
+#endif // hifi_Shared_Trace_h
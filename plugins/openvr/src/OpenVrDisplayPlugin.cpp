@@ -156,13 +156,19 @@ void OpenVrDisplayPlugin::internalPresent() {
     // Flip y-axis since GL UV coords are backwards.
     static vr::VRTextureBounds_t leftBounds{ 0, 0, 0.5f, 1 };
     static vr::VRTextureBounds_t rightBounds{ 0.5f, 0, 1, 1 };
-    vr::Texture_t texture{ (void*)_currentSceneTexture, vr::API_OpenGL, vr::ColorSpace_Auto };
-    {
-        Lock lock(_mutex);
-        _compositor->Submit(vr::Eye_Left, &texture, &leftBounds);
-        _compositor->Submit(vr::Eye_Right, &texture, &rightBounds);
+    // The compositor takes a texture submitted to have been rendered with the poses it last gave, and reprojects it
+    // to the poses the eyes have when it is displayed.  A frame the main thread was too late to render is left out:
+    // submitting the one before again would get it reprojected from the wrong poses, making the view swim with the
+    // head, while the compositor reprojects what it was last given the right way on its own.
+    if (_newSceneTexture) {
+        vr::Texture_t texture{ (void*)_currentSceneTexture, vr::API_OpenGL, vr::ColorSpace_Auto };
+        {
+            Lock lock(_mutex);
+            _compositor->Submit(vr::Eye_Left, &texture, &leftBounds);
+            _compositor->Submit(vr::Eye_Right, &texture, &rightBounds);
+        }
+        glFinish();
     }
-    glFinish();
     {
         Lock lock(_mutex);
         _compositor->WaitGetPoses(_trackedDevicePose, vr::k_unMaxTrackedDeviceCount, nullptr, 0);
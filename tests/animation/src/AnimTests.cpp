@@ -15,6 +15,7 @@
 #include <AnimVariant.h>
 #include <AnimExpression.h>
 #include <AnimUtil.h>
+#include <AnimCurves.h>
 
 #include <../QTestExtensions.h>
 
@@ -395,6 +396,78 @@ void AnimTests::testAnimPose() {
     }
 }
 
+void AnimTests::testBlend() {
+    const int NUM_POSES = 23;
+    auto randomFloat = []() { return 2.0f * qrand() / RAND_MAX - 1.0f; };
+    auto randomPose = [&]() {
+        glm::vec3 axis = glm::normalize(glm::vec3(randomFloat(), randomFloat(), randomFloat()) + glm::vec3(0.0f, 0.0f, 2.0f));
+        return AnimPose(glm::vec3(1.5f) + glm::vec3(randomFloat(), randomFloat(), randomFloat()),
+            glm::angleAxis(4.0f * randomFloat(), axis), glm::vec3(randomFloat(), randomFloat(), randomFloat()));
+    };
+
+    AnimPoseVec a(NUM_POSES), b(NUM_POSES);
+    for (int i = 0; i < NUM_POSES; i++) {
+        a[i] = randomPose();
+        b[i] = randomPose();
+    }
+    // the rotations of the other hemisphere go the shorter way round
+    b[0].rot = -a[0].rot;
+
+    for (float alpha : { 0.0f, 0.3f, 1.0f }) {
+        AnimPoseVec result(NUM_POSES), expected(NUM_POSES);
+        ::blend(NUM_POSES, &a[0], &b[0], alpha, &result[0]);
+        ::blendScalar(NUM_POSES, &a[0], &b[0], alpha, &expected[0]);
+        for (int i = 0; i < NUM_POSES; i++) {
+            QCOMPARE_WITH_ABS_ERROR((glm::mat4)result[i], (glm::mat4)expected[i], EPSILON);
+        }
+
+        // in place
+        result = a;
+        ::blend(NUM_POSES, &result[0], &b[0], alpha, &result[0]);
+        for (int i = 0; i < NUM_POSES; i++) {
+            QCOMPARE_WITH_ABS_ERROR((glm::mat4)result[i], (glm::mat4)expected[i], EPSILON);
+        }
+    }
+}
+
+void AnimTests::testCurves() {
+    const int NUM_FRAMES = 100;
+    const int NUM_JOINTS = 3;
+    FBXGeometry geometry;
+    geometry.joints.resize(NUM_JOINTS);
+    geometry.animationFrames.resize(NUM_FRAMES);
+    auto rotationAt = [](int frame) { return glm::angleAxis(0.03f * frame, glm::normalize(glm::vec3(0.2f, 1.0f, 0.0f))); };
+    auto translationAt = [](int frame) { return glm::vec3(10.0f * sinf(0.1f * frame), 0.02f * frame, 5.0f); };
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        FBXAnimationFrame& fbxFrame = geometry.animationFrames[frame];
+
+        // a joint at rest, then one turning and moving, then one with its rotation on the other side every other frame
+        fbxFrame.rotations << glm::quat() << rotationAt(frame) << ((frame % 2) ? -rotationAt(frame) : rotationAt(frame));
+        fbxFrame.translations << glm::vec3(1.0f, 2.0f, 3.0f) << translationAt(frame) << glm::vec3();
+    }
+
+    AnimCurves curves(geometry);
+    QCOMPARE(curves.getNumFrames(), NUM_FRAMES);
+    QCOMPARE(curves.getNumJoints(), NUM_JOINTS);
+
+    // the curves at rest only keep their ends, and the turns at a steady rate drop most of their frames
+    QVERIFY(curves.getNumKeys() < NUM_FRAMES * NUM_JOINTS);
+
+    const float ROTATION_ERROR = 0.00001f; // of the dot products
+    const float TRANSLATION_ERROR = 0.025f;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        QCOMPARE_WITH_ABS_ERROR(curves.getRotation(0, frame), glm::quat(), ROTATION_ERROR);
+        QCOMPARE_WITH_ABS_ERROR(curves.getTranslation(0, frame), glm::vec3(1.0f, 2.0f, 3.0f), TRANSLATION_ERROR);
+        QCOMPARE_WITH_ABS_ERROR(curves.getRotation(1, frame), rotationAt(frame), ROTATION_ERROR);
+        QCOMPARE_WITH_ABS_ERROR(curves.getTranslation(1, frame), translationAt(frame), TRANSLATION_ERROR);
+        QCOMPARE_WITH_ABS_ERROR(curves.getRotation(2, frame), rotationAt(frame), ROTATION_ERROR);
+    }
+
+    // past the ends the curves hold their first and last keys
+    QCOMPARE_WITH_ABS_ERROR(curves.getRotation(1, NUM_FRAMES + 10), rotationAt(NUM_FRAMES - 1), ROTATION_ERROR);
+    QCOMPARE_WITH_ABS_ERROR(curves.getTranslation(1, -1), translationAt(0), TRANSLATION_ERROR);
+}
+
 void AnimTests::testExpressionTokenizer() {
     QString str = "(10 +  x) >= 20.1 && (y != !z)";
     AnimExpression e("x");
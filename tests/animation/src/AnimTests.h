@@ -27,6 +27,8 @@ private slots:
     void testVariant();
     void testAccumulateTime();
     void testAnimPose();
+    void testBlend();
+    void testCurves();
     void testExpressionTokenizer();
     void testExpressionParser();
     void testExpressionEvaluator();
@@ -0,0 +1,107 @@
+//
+//  ADPCMCodecTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ADPCMCodecTests.h"
+
+#include <math.h>
+
+#include <ADPCMCodec.h>
+#include <AudioConstants.h>
+
+QTEST_MAIN(ADPCMCodecTests)
+
+const int NUM_TEST_FRAMES = 100;
+
+// two tones per channel, loud enough to exercise the larger steps
+static QByteArray makeFrame(int frameIndex) {
+    QByteArray frame(AudioConstants::NETWORK_FRAME_BYTES_STEREO, 0);
+    int16_t* samples = reinterpret_cast<int16_t*>(frame.data());
+
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+        int t = frameIndex * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL + i;
+        samples[2 * i + 0] = (int16_t)(8000.0f * sinf(t * 0.05f) + 3000.0f * sinf(t * 0.31f));
+        samples[2 * i + 1] = (int16_t)(12000.0f * sinf(t * 0.013f));
+    }
+    return frame;
+}
+
+static float signalToNoiseRatio(const QByteArray& original, const QByteArray& decoded) {
+    const int16_t* originalSamples = reinterpret_cast<const int16_t*>(original.constData());
+    const int16_t* decodedSamples = reinterpret_cast<const int16_t*>(decoded.constData());
+
+    double signal = 0.0;
+    double noise = 0.0;
+    for (int i = 0; i < original.size() / (int)sizeof(int16_t); i++) {
+        double error = originalSamples[i] - decodedSamples[i];
+        signal += (double)originalSamples[i] * originalSamples[i];
+        noise += error * error;
+    }
+    return (float)(10.0 * log10(signal / std::max(noise, 1.0)));
+}
+
+void ADPCMCodecTests::codecIsRegistered() {
+    QVERIFY(AudioCodecs::getCodecNames().contains(ADPCMCodec::NAME));
+    QVERIFY(AudioCodecs::getCodec(ADPCMCodec::NAME) != nullptr);
+    QVERIFY(AudioCodecs::getCodec("no-such-codec") == nullptr);
+}
+
+void ADPCMCodecTests::encodedFrameSize() {
+    ADPCMCodec codec;
+    auto encoder = codec.createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+
+    QByteArray encoded;
+    encoder->encode(makeFrame(0), encoded);
+
+    QCOMPARE(encoded.size(), ADPCMCodec::getEncodedSize(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+                                                         AudioConstants::STEREO));
+    QVERIFY(encoded.size() * 3 < AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+}
+
+void ADPCMCodecTests::roundTripQuality() {
+    ADPCMCodec codec;
+    auto encoder = codec.createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    auto decoder = codec.createDecoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+
+    const float MIN_SNR_DB = 30.0f;
+
+    for (int i = 0; i < NUM_TEST_FRAMES; i++) {
+        QByteArray frame = makeFrame(i);
+        QByteArray encoded, decoded;
+        encoder->encode(frame, encoded);
+        decoder->decode(encoded, decoded);
+
+        QCOMPARE(decoded.size(), frame.size());
+
+        // the first frame starts from a zero predictor, so give the encoder a moment to catch up
+        if (i > 0) {
+            QVERIFY(signalToNoiseRatio(frame, decoded) > MIN_SNR_DB);
+        }
+    }
+}
+
+void ADPCMCodecTests::survivesLostFrames() {
+    ADPCMCodec codec;
+    auto encoder = codec.createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    auto decoder = codec.createDecoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    auto lossyDecoder = codec.createDecoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+
+    for (int i = 0; i < NUM_TEST_FRAMES; i++) {
+        QByteArray encoded, decoded;
+        encoder->encode(makeFrame(i), encoded);
+        decoder->decode(encoded, decoded);
+
+        // every other frame never arrives at the lossy decoder, the ones that do must decode exactly the same
+        if (i % 2 == 0) {
+            QByteArray lossyDecoded;
+            lossyDecoder->decode(encoded, lossyDecoded);
+            QCOMPARE(lossyDecoded, decoded);
+        }
+    }
+}
@@ -0,0 +1,25 @@
+//
+//  ADPCMCodecTests.h
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ADPCMCodecTests_h
+#define hifi_ADPCMCodecTests_h
+
+#include <QtTest/QtTest>
+
+class ADPCMCodecTests : public QObject {
+    Q_OBJECT
+private slots:
+    void codecIsRegistered();
+    void encodedFrameSize();
+    void roundTripQuality();
+    void survivesLostFrames();
+};
+
+#endif // hifi_ADPCMCodecTests_h
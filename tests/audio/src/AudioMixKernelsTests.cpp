@@ -0,0 +1,232 @@
+//
+//  AudioMixKernelsTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixKernelsTests.h"
+
+#include <AudioConstants.h>
+#include <AudioMixKernels.h>
+
+QTEST_MAIN(AudioMixKernelsTests)
+
+// odd sizes so that every kernel also runs its scalar tail
+const int NUM_TEST_FRAMES = 487;
+const int NUM_TEST_RUNS = 100;
+
+// the mixer adds every audible stream onto each listener's mix bus, so benchmark a crowded frame
+const int NUM_BENCHMARK_STREAMS = 100;
+const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+const float INT16_TO_FLOAT = 1.0f / 32768.0f;
+
+static void fillRandom(int16_t* samples, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = (int16_t)(qrand() - (RAND_MAX / 2));
+    }
+}
+
+static void fillRandom(float* samples, int numSamples, float range) {
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = range * (2.0f * qrand() / RAND_MAX - 1.0f);
+    }
+}
+
+static float randomGain() {
+    return INT16_TO_FLOAT * (qrand() % 3000) / 1000.0f - 0.5f;
+}
+
+static bool fuzzyEqual(const float* a, const float* b, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        if (fabsf(a[i] - b[i]) > 1.0e-6f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AudioMixKernelsTests::initTestCase() {
+    qDebug() << "Mix kernels:" << AudioMixKernels::getKernelName();
+}
+
+void AudioMixKernelsTests::accumulateMonoMatchesScalar() {
+    int16_t input[NUM_TEST_FRAMES];
+    float mix[NUM_TEST_FRAMES];
+    float expected[NUM_TEST_FRAMES];
+
+    for (int run = 0; run < NUM_TEST_RUNS; run++) {
+        int numFrames = 1 + qrand() % NUM_TEST_FRAMES;
+        float gain = randomGain();
+
+        fillRandom(input, NUM_TEST_FRAMES);
+        fillRandom(mix, NUM_TEST_FRAMES, 1.0f);
+        memcpy(expected, mix, sizeof(mix));
+
+        AudioMixKernels::accumulateMono(mix, input, gain, numFrames);
+        AudioMixKernels::accumulateMonoScalar(expected, input, gain, numFrames);
+
+        QVERIFY(fuzzyEqual(mix, expected, NUM_TEST_FRAMES));
+    }
+}
+
+void AudioMixKernelsTests::accumulateStereoMatchesScalar() {
+    int16_t input[2 * NUM_TEST_FRAMES];
+    float left[NUM_TEST_FRAMES], right[NUM_TEST_FRAMES];
+    float expectedLeft[NUM_TEST_FRAMES], expectedRight[NUM_TEST_FRAMES];
+
+    for (int run = 0; run < NUM_TEST_RUNS; run++) {
+        int numFrames = 1 + qrand() % NUM_TEST_FRAMES;
+        float gain = randomGain();
+
+        fillRandom(input, 2 * NUM_TEST_FRAMES);
+        fillRandom(left, NUM_TEST_FRAMES, 1.0f);
+        fillRandom(right, NUM_TEST_FRAMES, 1.0f);
+        memcpy(expectedLeft, left, sizeof(left));
+        memcpy(expectedRight, right, sizeof(right));
+
+        AudioMixKernels::accumulateStereo(left, right, input, gain, numFrames);
+        AudioMixKernels::accumulateStereoScalar(expectedLeft, expectedRight, input, gain, numFrames);
+
+        QVERIFY(fuzzyEqual(left, expectedLeft, NUM_TEST_FRAMES));
+        QVERIFY(fuzzyEqual(right, expectedRight, NUM_TEST_FRAMES));
+    }
+}
+
+void AudioMixKernelsTests::accumulateMatchesScalar() {
+    float input[NUM_TEST_FRAMES];
+    float mix[NUM_TEST_FRAMES];
+    float expected[NUM_TEST_FRAMES];
+
+    for (int run = 0; run < NUM_TEST_RUNS; run++) {
+        int numFrames = 1 + qrand() % NUM_TEST_FRAMES;
+
+        fillRandom(input, NUM_TEST_FRAMES, 1.0f);
+        fillRandom(mix, NUM_TEST_FRAMES, 1.0f);
+        memcpy(expected, mix, sizeof(mix));
+
+        AudioMixKernels::accumulate(mix, input, numFrames);
+        AudioMixKernels::accumulateScalar(expected, input, numFrames);
+
+        QVERIFY(fuzzyEqual(mix, expected, NUM_TEST_FRAMES));
+    }
+}
+
+void AudioMixKernelsTests::accumulateWithGainMatchesScalar() {
+    float input[NUM_TEST_FRAMES];
+    float mix[NUM_TEST_FRAMES];
+    float expected[NUM_TEST_FRAMES];
+
+    for (int run = 0; run < NUM_TEST_RUNS; run++) {
+        int numFrames = 1 + qrand() % NUM_TEST_FRAMES;
+        float gain = (qrand() % 3000) / 1000.0f - 0.5f;
+
+        fillRandom(input, NUM_TEST_FRAMES, 1.0f);
+        fillRandom(mix, NUM_TEST_FRAMES, 1.0f);
+        memcpy(expected, mix, sizeof(mix));
+
+        AudioMixKernels::accumulateWithGain(mix, input, gain, numFrames);
+        AudioMixKernels::accumulateWithGainScalar(expected, input, gain, numFrames);
+
+        QVERIFY(fuzzyEqual(mix, expected, NUM_TEST_FRAMES));
+    }
+}
+
+void AudioMixKernelsTests::convertToInt16MatchesScalar() {
+    float left[NUM_TEST_FRAMES], right[NUM_TEST_FRAMES];
+    int16_t output[2 * NUM_TEST_FRAMES];
+    int16_t expected[2 * NUM_TEST_FRAMES];
+
+    for (int run = 0; run < NUM_TEST_RUNS; run++) {
+        int numFrames = 1 + qrand() % NUM_TEST_FRAMES;
+
+        // go past full scale so that the saturation is exercised too
+        fillRandom(left, NUM_TEST_FRAMES, 2.0f);
+        fillRandom(right, NUM_TEST_FRAMES, 2.0f);
+        memset(output, 0, sizeof(output));
+        memset(expected, 0, sizeof(expected));
+
+        AudioMixKernels::convertToInt16(left, right, output, numFrames);
+        AudioMixKernels::convertToInt16Scalar(left, right, expected, numFrames);
+
+        // rounding of exact halves may differ between instruction sets
+        for (int i = 0; i < 2 * NUM_TEST_FRAMES; i++) {
+            QVERIFY(abs(output[i] - expected[i]) <= 1);
+        }
+    }
+}
+
+void AudioMixKernelsTests::convertToInt16Saturates() {
+    const int NUM_SATURATION_FRAMES = 9;
+    float left[NUM_SATURATION_FRAMES] = { 0.0f, 0.5f, -0.5f, 1.0f, -1.0f, 4.0f, -4.0f, 1000.0f, -1000.0f };
+    float right[NUM_SATURATION_FRAMES] = { 0.0f, -0.5f, 0.5f, -1.0f, 1.0f, -4.0f, 4.0f, -1000.0f, 1000.0f };
+    int16_t expected[2 * NUM_SATURATION_FRAMES] = {
+        0, 0, 16384, -16384, -16384, 16384, 32767, -32768, -32768, 32767,
+        32767, -32768, -32768, 32767, 32767, -32768, -32768, 32767
+    };
+    int16_t output[2 * NUM_SATURATION_FRAMES];
+
+    AudioMixKernels::convertToInt16(left, right, output, NUM_SATURATION_FRAMES);
+
+    for (int i = 0; i < 2 * NUM_SATURATION_FRAMES; i++) {
+        QCOMPARE(output[i], expected[i]);
+    }
+}
+
+void AudioMixKernelsTests::benchmarkAccumulateMonoScalar() {
+    int16_t input[NUM_FRAMES];
+    float left[NUM_FRAMES] = {};
+    float right[NUM_FRAMES] = {};
+    fillRandom(input, NUM_FRAMES);
+
+    QBENCHMARK {
+        for (int i = 0; i < NUM_BENCHMARK_STREAMS; i++) {
+            AudioMixKernels::accumulateMonoScalar(left, input, 0.1f * INT16_TO_FLOAT, NUM_FRAMES);
+            AudioMixKernels::accumulateMonoScalar(right, input, 0.05f * INT16_TO_FLOAT, NUM_FRAMES);
+        }
+    }
+}
+
+void AudioMixKernelsTests::benchmarkAccumulateMono() {
+    int16_t input[NUM_FRAMES];
+    float left[NUM_FRAMES] = {};
+    float right[NUM_FRAMES] = {};
+    fillRandom(input, NUM_FRAMES);
+
+    QBENCHMARK {
+        for (int i = 0; i < NUM_BENCHMARK_STREAMS; i++) {
+            AudioMixKernels::accumulateMono(left, input, 0.1f * INT16_TO_FLOAT, NUM_FRAMES);
+            AudioMixKernels::accumulateMono(right, input, 0.05f * INT16_TO_FLOAT, NUM_FRAMES);
+        }
+    }
+}
+
+void AudioMixKernelsTests::benchmarkAccumulateStereoScalar() {
+    int16_t input[2 * NUM_FRAMES];
+    float left[NUM_FRAMES] = {};
+    float right[NUM_FRAMES] = {};
+    fillRandom(input, 2 * NUM_FRAMES);
+
+    QBENCHMARK {
+        for (int i = 0; i < NUM_BENCHMARK_STREAMS; i++) {
+            AudioMixKernels::accumulateStereoScalar(left, right, input, 0.1f * INT16_TO_FLOAT, NUM_FRAMES);
+        }
+    }
+}
+
+void AudioMixKernelsTests::benchmarkAccumulateStereo() {
+    int16_t input[2 * NUM_FRAMES];
+    float left[NUM_FRAMES] = {};
+    float right[NUM_FRAMES] = {};
+    fillRandom(input, 2 * NUM_FRAMES);
+
+    QBENCHMARK {
+        for (int i = 0; i < NUM_BENCHMARK_STREAMS; i++) {
+            AudioMixKernels::accumulateStereo(left, right, input, 0.1f * INT16_TO_FLOAT, NUM_FRAMES);
+        }
+    }
+}
@@ -0,0 +1,34 @@
+//
+//  AudioMixKernelsTests.h
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernelsTests_h
+#define hifi_AudioMixKernelsTests_h
+
+#include <QtTest/QtTest>
+
+class AudioMixKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void accumulateMonoMatchesScalar();
+    void accumulateStereoMatchesScalar();
+    void accumulateMatchesScalar();
+    void accumulateWithGainMatchesScalar();
+    void convertToInt16MatchesScalar();
+    void convertToInt16Saturates();
+
+    void benchmarkAccumulateMonoScalar();
+    void benchmarkAccumulateMono();
+    void benchmarkAccumulateStereoScalar();
+    void benchmarkAccumulateStereo();
+};
+
+#endif // hifi_AudioMixKernelsTests_h
@@ -0,0 +1,270 @@
+//
+//  AudioMixerLoadTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerLoadTests.h"
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+
+#include <glm/gtx/vector_angle.hpp>
+
+#include <AudioBuffer.h>
+#include <AudioConstants.h>
+#include <AudioFilterBank.h>
+#include <AudioMixKernels.h>
+#include <AudioSpatialization.h>
+#include <LatencyHistogram.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AudioMixerLoadTests)
+
+// The audio-mixer mixes every listener from the sources audible to it once per network frame.  This mixes the same way,
+// a mono microphone per source placed, attenuated, phase panned and penumbra filtered for each listener, so that the
+// frame time of a crowd can be measured without a domain and a room of clients.
+//
+// The rows cover a few crowds, and the HIFI_MIXER_LOAD_SOURCES, HIFI_MIXER_LOAD_LISTENERS, HIFI_MIXER_LOAD_SPREAD
+// (the side in meters of the square they stand in) and HIFI_MIXER_LOAD_LOUDNESS (0 to 1) environment variables add a
+// row of their own.
+
+const int NUM_FRAME_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+const int MAX_DELAY_SAMPLES = AudioSpatialization::SAMPLE_PHASE_DELAY_AT_90;
+
+// each source loops over this many frames of noise
+const int NUM_SOURCE_FRAMES = 8;
+
+const int NUM_WARMUP_FRAMES = 20;
+const int NUM_MEASURED_FRAMES = 500;
+
+// the defaults of the audio-mixer
+const float MIN_AUDIBILITY_THRESHOLD = 0.00001f / 2.0f;
+const float INT16_TO_MIX_BUS_SCALE = 1.0f / 32768.0f;
+
+struct LoadSource {
+    glm::vec3 position;
+    glm::quat orientation;
+
+    // the frames this source loops over, each is preceded by the samples the delayed channel needs
+    std::vector<int16_t> samples;
+    float loudness { 0.0f };
+
+    const int16_t* getFrame(int frame) const {
+        return &samples[MAX_DELAY_SAMPLES + (frame % NUM_SOURCE_FRAMES) * NUM_FRAME_SAMPLES];
+    }
+};
+
+struct LoadListener {
+    glm::vec3 position;
+    glm::quat orientation;
+};
+
+struct LoadScene {
+    std::vector<LoadSource> sources;
+    std::vector<LoadListener> listeners;
+
+    // the penumbra filter of every listener and source pair, as the mixer keeps them
+    std::unique_ptr<AudioFilterHSF1s[]> penumbraFilters;
+
+    AudioBufferFloat32 preMix { 2, (uint32_t)NUM_FRAME_SAMPLES };
+    AudioBufferFloat32 mix { 2, (uint32_t)NUM_FRAME_SAMPLES };
+    int16_t mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+};
+
+static glm::vec3 randomPosition(float spread) {
+    return glm::vec3(spread * ((float)qrand() / RAND_MAX - 0.5f), 0.0f, spread * ((float)qrand() / RAND_MAX - 0.5f));
+}
+
+static glm::quat randomOrientation() {
+    return glm::angleAxis(TWO_PI * qrand() / RAND_MAX, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+static void buildScene(LoadScene& scene, int numSources, int numListeners, float spread, float loudness) {
+    // the same crowd every run
+    qsrand(1);
+
+    scene.sources.resize(numSources);
+    for (auto& source : scene.sources) {
+        source.position = randomPosition(spread);
+        source.orientation = randomOrientation();
+
+        // uniform noise averages half of its peak
+        source.samples.resize(MAX_DELAY_SAMPLES + NUM_SOURCE_FRAMES * NUM_FRAME_SAMPLES);
+        const int peak = (int)(2.0f * loudness * AudioConstants::MAX_SAMPLE_VALUE);
+        for (auto& sample : source.samples) {
+            sample = peak > 0 ? (int16_t)glm::clamp(qrand() % (2 * peak + 1) - peak,
+                                                    (int)AudioConstants::MIN_SAMPLE_VALUE,
+                                                    (int)AudioConstants::MAX_SAMPLE_VALUE) : 0;
+        }
+        source.loudness = loudness;
+    }
+
+    scene.listeners.resize(numListeners);
+    for (auto& listener : scene.listeners) {
+        listener.position = randomPosition(spread);
+        listener.orientation = randomOrientation();
+    }
+
+    scene.penumbraFilters.reset(new AudioFilterHSF1s[numSources * numListeners]);
+    for (int i = 0; i < numSources * numListeners; i++) {
+        scene.penumbraFilters[i].initialize(AudioConstants::SAMPLE_RATE, NUM_FRAME_SAMPLES);
+    }
+}
+
+// mixes one source for one listener like AudioMixer::addStreamToMixForListeningNodeWithStream, returns 1 if it was mixed
+static int addSourceToMix(LoadScene& scene, const LoadSource& source, const LoadListener& listener,
+                          AudioFilterHSF1s& penumbraFilter, int frame) {
+    if (source.loudness == 0.0f) {
+        return 0;
+    }
+
+    glm::vec3 relativePosition = source.position - listener.position;
+    float distance = std::max(glm::length(relativePosition), EPSILON);
+    if (source.loudness / distance <= MIN_AUDIBILITY_THRESHOLD) {
+        return 0;
+    }
+
+    // quieter as the source turns away from the listener
+    glm::vec3 rotatedListenerPosition = glm::inverse(source.orientation) * relativePosition;
+    float angleOfDelivery = glm::angle(glm::vec3(0.0f, 0.0f, -1.0f), glm::normalize(rotatedListenerPosition));
+    const float MAX_OFF_AXIS_ATTENUATION = 0.2f;
+    const float OFF_AXIS_ATTENUATION_FORMULA_STEP = (1 - MAX_OFF_AXIS_ATTENUATION) / 2.0f;
+    float attenuation = MAX_OFF_AXIS_ATTENUATION + OFF_AXIS_ATTENUATION_FORMULA_STEP * (angleOfDelivery / PI_OVER_TWO);
+    attenuation *= AudioSpatialization::computeDistanceAttenuation(distance);
+
+    float bearing = AudioSpatialization::computeBearing(relativePosition, listener.orientation);
+    int numSamplesDelay;
+    float weakChannelAmplitudeRatio;
+    AudioSpatialization::computePhasePanning(bearing, distance, numSamplesDelay, weakChannelAmplitudeRatio);
+
+    float penumbraFilterGains[2];
+    AudioSpatialization::computePenumbraFilterGains(bearing, distance, penumbraFilterGains[0], penumbraFilterGains[1]);
+
+    int delayedChannel = bearing > 0.0f ? 1 : 0;
+    int normalChannel = 1 - delayedChannel;
+
+    scene.preMix.zeroFrames();
+    float32_t** preMix = scene.preMix.getFrameData();
+    const int16_t* frameSamples = source.getFrame(frame);
+    AudioMixKernels::accumulateMono(preMix[normalChannel], frameSamples,
+                                    attenuation * INT16_TO_MIX_BUS_SCALE, NUM_FRAME_SAMPLES);
+    AudioMixKernels::accumulateMono(preMix[delayedChannel], frameSamples - numSamplesDelay,
+                                    attenuation * weakChannelAmplitudeRatio * INT16_TO_MIX_BUS_SCALE, NUM_FRAME_SAMPLES);
+
+    for (int channel = 0; channel < 2; channel++) {
+        penumbraFilter.setParameters(0, channel, AudioConstants::SAMPLE_RATE,
+                                     AudioSpatialization::PENUMBRA_FILTER_FREQUENCY_HZ, penumbraFilterGains[channel],
+                                     AudioSpatialization::PENUMBRA_FILTER_SLOPE);
+    }
+    penumbraFilter.render(scene.preMix);
+
+    float32_t** mix = scene.mix.getFrameData();
+    AudioMixKernels::accumulate(mix[0], preMix[0], NUM_FRAME_SAMPLES);
+    AudioMixKernels::accumulate(mix[1], preMix[1], NUM_FRAME_SAMPLES);
+    return 1;
+}
+
+// mixes every listener once, returns the number of sources mixed
+static int mixFrame(LoadScene& scene, int frame) {
+    int numMixes = 0;
+    const int numSources = (int)scene.sources.size();
+
+    for (int l = 0; l < (int)scene.listeners.size(); l++) {
+        scene.mix.zeroFrames();
+        for (int s = 0; s < numSources; s++) {
+            numMixes += addSourceToMix(scene, scene.sources[s], scene.listeners[l],
+                                       scene.penumbraFilters[l * numSources + s], frame);
+        }
+
+        float32_t** mix = scene.mix.getFrameData();
+        AudioMixKernels::convertToInt16(mix[0], mix[1], scene.mixSamples, NUM_FRAME_SAMPLES);
+    }
+    return numMixes;
+}
+
+void AudioMixerLoadTests::mixFrames_data() {
+    QTest::addColumn<int>("numSources");
+    QTest::addColumn<int>("numListeners");
+    QTest::addColumn<float>("spread");
+    QTest::addColumn<float>("loudness");
+
+    // whether one core has to mix this crowd within a network frame, for the crowds small enough to hold CI to it
+    QTest::addColumn<bool>("mustFitInFrame");
+
+    QTest::newRow("small room") << 10 << 10 << 10.0f << 0.1f << true;
+    QTest::newRow("crowd") << 50 << 50 << 20.0f << 0.1f << false;
+    QTest::newRow("big crowd") << 100 << 100 << 30.0f << 0.1f << false;
+    QTest::newRow("spread out") << 100 << 100 << 1000.0f << 0.01f << false;
+    QTest::newRow("silent") << 100 << 100 << 30.0f << 0.0f << true;
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (environment.contains("HIFI_MIXER_LOAD_SOURCES") || environment.contains("HIFI_MIXER_LOAD_LISTENERS")) {
+        QTest::newRow("environment")
+            << environment.value("HIFI_MIXER_LOAD_SOURCES", "100").toInt()
+            << environment.value("HIFI_MIXER_LOAD_LISTENERS", "100").toInt()
+            << environment.value("HIFI_MIXER_LOAD_SPREAD", "30").toFloat()
+            << environment.value("HIFI_MIXER_LOAD_LOUDNESS", "0.1").toFloat()
+            << false;
+    }
+}
+
+void AudioMixerLoadTests::mixFrames() {
+    QFETCH(int, numSources);
+    QFETCH(int, numListeners);
+    QFETCH(float, spread);
+    QFETCH(float, loudness);
+    QFETCH(bool, mustFitInFrame);
+
+    LoadScene scene;
+    buildScene(scene, numSources, numListeners, spread, loudness);
+
+    for (int frame = 0; frame < NUM_WARMUP_FRAMES; frame++) {
+        mixFrame(scene, frame);
+    }
+
+    LatencyHistogram frameTimes;
+    qint64 totalMixes = 0;
+    QElapsedTimer timer;
+    for (int frame = 0; frame < NUM_MEASURED_FRAMES; frame++) {
+        timer.start();
+        totalMixes += mixFrame(scene, frame);
+        frameTimes.record(timer.nsecsElapsed() / NSECS_PER_USEC);
+    }
+
+    // the listeners one core could mix within a network frame, going by the slowest frames
+    quint64 p99 = std::max(frameTimes.getPercentile(0.99f), (quint64)1);
+    float listenersPerCore = (float)numListeners * AudioConstants::NETWORK_FRAME_USECS / p99;
+
+    qDebug() << QTest::currentDataTag() << "-" << numSources << "sources," << numListeners << "listeners,"
+        << (float)totalMixes / NUM_MEASURED_FRAMES << "mixes per frame";
+    qDebug() << "    frame usecs p50" << frameTimes.getPercentile(0.5f) << "p90" << frameTimes.getPercentile(0.9f)
+        << "p99" << p99 << "max" << frameTimes.getMax();
+    qDebug() << "    listeners per core" << listenersPerCore;
+
+    if (loudness > 0.0f) {
+        QVERIFY(totalMixes > 0);
+    } else {
+        QCOMPARE(totalMixes, (qint64)0);
+    }
+
+    if (mustFitInFrame) {
+        QVERIFY(p99 < (quint64)AudioConstants::NETWORK_FRAME_USECS);
+    }
+}
+
+void AudioMixerLoadTests::benchmarkMixFrame() {
+    LoadScene scene;
+    buildScene(scene, 100, 100, 30.0f, 0.1f);
+
+    int frame = 0;
+    QBENCHMARK {
+        mixFrame(scene, frame++);
+    }
+}
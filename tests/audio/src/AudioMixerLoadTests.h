@@ -0,0 +1,25 @@
+//
+//  AudioMixerLoadTests.h
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerLoadTests_h
+#define hifi_AudioMixerLoadTests_h
+
+#include <QtTest/QtTest>
+
+class AudioMixerLoadTests : public QObject {
+    Q_OBJECT
+private slots:
+    void mixFrames_data();
+    void mixFrames();
+
+    void benchmarkMixFrame();
+};
+
+#endif // hifi_AudioMixerLoadTests_h
@@ -11,6 +11,8 @@
 
 #include "AudioRingBufferTests.h"
 
+#include <thread>
+
 #include "SharedUtil.h"
 
 // Adds an implicit cast to make sure that actual and expected are of the same type.
@@ -125,3 +127,46 @@ void AudioRingBufferTests::runAllTests() {
         assertBufferSize(ringBuffer, 0);
     }
 }
+
+void AudioRingBufferTests::readerAndWriterThreads() {
+    const int FRAME_SAMPLES = 64;
+    const int NUM_FRAMES = 20000;
+
+    AudioRingBuffer ringBuffer(FRAME_SAMPLES, false, 10);
+
+    // the writer never overfills the buffer, so the reader has to see every sample in order
+    std::thread writer([&] {
+        int16_t frame[FRAME_SAMPLES];
+        for (int f = 0; f < NUM_FRAMES; f++) {
+            for (int i = 0; i < FRAME_SAMPLES; i++) {
+                frame[i] = (int16_t)(f * FRAME_SAMPLES + i);
+            }
+            while (ringBuffer.getSampleCapacity() - ringBuffer.samplesAvailable() < FRAME_SAMPLES) {
+                std::this_thread::yield();
+            }
+            ringBuffer.writeSamples(frame, FRAME_SAMPLES);
+        }
+    });
+
+    int16_t readData[FRAME_SAMPLES * 3];
+    int samplesRead = 0;
+    int badSamples = 0;
+    while (samplesRead < NUM_FRAMES * FRAME_SAMPLES) {
+        // read odd sizes so reads straddle frames and the end of the buffer
+        int numRead = ringBuffer.readSamples(readData, FRAME_SAMPLES + 13);
+        for (int i = 0; i < numRead; i++) {
+            if (readData[i] != (int16_t)(samplesRead + i)) {
+                badSamples++;
+            }
+        }
+        samplesRead += numRead;
+        if (numRead == 0) {
+            std::this_thread::yield();
+        }
+    }
+    writer.join();
+
+    QCOMPARE(badSamples, 0);
+    QCOMPARE(ringBuffer.samplesAvailable(), 0);
+    QCOMPARE(ringBuffer.getOverflowCount(), 0);
+}
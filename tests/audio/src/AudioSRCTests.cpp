@@ -0,0 +1,138 @@
+//
+//  AudioSRCTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSRCTests.h"
+
+#include <AudioSRC.h>
+#include <CPUDetect.h>
+
+QTEST_MAIN(AudioSRCTests)
+
+const int NUM_INPUT_FRAMES = 480;       // 10ms at 48kHz, as delivered by a typical audio device
+const int NUM_QUALITY_BLOCKS = 50;
+const int NUM_BENCHMARK_BLOCKS = 100;
+
+const double TEST_FREQUENCY_HZ = 1000.0;
+const double TEST_AMPLITUDE = 16384.0;
+
+// the prototype filter is specified at -125dB stopband, so anything well short of that is a kernel bug
+const float MIN_SINE_SNR_DB = 60.0f;
+
+// a device clock that is slightly off its nominal rate needs more phases than a rational filter can hold
+const int IRRATIONAL_OUTPUT_RATE = 48001;
+
+static void generateSine(int16_t* samples, int numFrames, int numChannels, int sampleRate, int64_t& time) {
+    for (int i = 0; i < numFrames; i++) {
+        int16_t sample = (int16_t)lrint(TEST_AMPLITUDE * sin(2.0 * M_PI * TEST_FREQUENCY_HZ * (time + i) / sampleRate));
+        for (int c = 0; c < numChannels; c++) {
+            samples[numChannels * i + c] = sample;
+        }
+    }
+    time += numFrames;
+}
+
+// fit a sine at the test frequency to each output channel, and return the worst signal to residual ratio
+static float measureSineSNR(int inputRate, int outputRate, int numChannels) {
+    AudioSRC src(inputRate, outputRate, numChannels);
+
+    QVector<int16_t> input(numChannels * NUM_INPUT_FRAMES);
+    QVector<int16_t> output(numChannels * src.getMaxOutput(NUM_INPUT_FRAMES));
+    QVector<QVector<float>> rendered(numChannels);
+
+    int64_t time = 0;
+    for (int block = 0; block < NUM_QUALITY_BLOCKS; block++) {
+        generateSine(input.data(), NUM_INPUT_FRAMES, numChannels, inputRate, time);
+
+        int outputFrames = src.render(input.data(), output.data(), NUM_INPUT_FRAMES);
+        for (int i = 0; i < outputFrames; i++) {
+            for (int c = 0; c < numChannels; c++) {
+                rendered[c].push_back(output[numChannels * i + c]);
+            }
+        }
+    }
+
+    // skip the filter startup
+    const int start = outputRate / 10;
+
+    float worst = std::numeric_limits<float>::max();
+    for (int c = 0; c < numChannels; c++) {
+        const QVector<float>& y = rendered[c];
+        int numFrames = y.size() - start;
+
+        double a = 0.0, b = 0.0;
+        for (int i = 0; i < numFrames; i++) {
+            double w = 2.0 * M_PI * TEST_FREQUENCY_HZ * (start + i) / outputRate;
+            a += y[start + i] * sin(w);
+            b += y[start + i] * cos(w);
+        }
+        a *= 2.0 / numFrames;
+        b *= 2.0 / numFrames;
+
+        double signal = 0.0, noise = 0.0;
+        for (int i = 0; i < numFrames; i++) {
+            double w = 2.0 * M_PI * TEST_FREQUENCY_HZ * (start + i) / outputRate;
+            double fit = a * sin(w) + b * cos(w);
+            signal += fit * fit;
+            noise += (y[start + i] - fit) * (y[start + i] - fit);
+        }
+        worst = std::min(worst, (float)(10.0 * log10(signal / noise)));
+    }
+    return worst;
+}
+
+static void benchmarkRender(int inputRate, int outputRate, int numChannels) {
+    AudioSRC src(inputRate, outputRate, numChannels);
+
+    QVector<int16_t> input(numChannels * NUM_INPUT_FRAMES);
+    QVector<int16_t> output(numChannels * src.getMaxOutput(NUM_INPUT_FRAMES));
+
+    int64_t time = 0;
+    generateSine(input.data(), NUM_INPUT_FRAMES, numChannels, inputRate, time);
+
+    QBENCHMARK {
+        for (int block = 0; block < NUM_BENCHMARK_BLOCKS; block++) {
+            src.render(input.data(), output.data(), NUM_INPUT_FRAMES);
+        }
+    }
+}
+
+void AudioSRCTests::initTestCase() {
+    qDebug() << "AVX2 resampler kernels:" << cpuSupportsAVX2();
+}
+
+void AudioSRCTests::rationalMonoQuality() {
+    QVERIFY(measureSineSNR(48000, 24000, 1) > MIN_SINE_SNR_DB);
+    QVERIFY(measureSineSNR(24000, 48000, 1) > MIN_SINE_SNR_DB);
+}
+
+void AudioSRCTests::rationalStereoQuality() {
+    QVERIFY(measureSineSNR(48000, 24000, 2) > MIN_SINE_SNR_DB);
+    QVERIFY(measureSineSNR(24000, 48000, 2) > MIN_SINE_SNR_DB);
+}
+
+void AudioSRCTests::irrationalMonoQuality() {
+    QVERIFY(measureSineSNR(44100, IRRATIONAL_OUTPUT_RATE, 1) > MIN_SINE_SNR_DB);
+}
+
+void AudioSRCTests::irrationalStereoQuality() {
+    QVERIFY(measureSineSNR(44100, IRRATIONAL_OUTPUT_RATE, 2) > MIN_SINE_SNR_DB);
+}
+
+void AudioSRCTests::benchmarkRationalMono() {
+    benchmarkRender(48000, 24000, 1);
+}
+
+void AudioSRCTests::benchmarkRationalStereo() {
+    benchmarkRender(48000, 24000, 2);
+}
+
+void AudioSRCTests::benchmarkIrrationalStereo() {
+    benchmarkRender(44100, IRRATIONAL_OUTPUT_RATE, 2);
+}
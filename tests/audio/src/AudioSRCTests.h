@@ -0,0 +1,31 @@
+//
+//  AudioSRCTests.h
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSRCTests_h
+#define hifi_AudioSRCTests_h
+
+#include <QtTest/QtTest>
+
+class AudioSRCTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void rationalMonoQuality();
+    void rationalStereoQuality();
+    void irrationalMonoQuality();
+    void irrationalStereoQuality();
+
+    void benchmarkRationalMono();
+    void benchmarkRationalStereo();
+    void benchmarkIrrationalStereo();
+};
+
+#endif // hifi_AudioSRCTests_h
@@ -0,0 +1,80 @@
+//
+//  AudioSpatializationTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSpatializationTests.h"
+
+#include <AudioSpatialization.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AudioSpatializationTests)
+
+using namespace AudioSpatialization;
+
+void AudioSpatializationTests::distanceAttenuation() {
+    // no attenuation up close, then the same amount less for each doubling of the distance
+    QCOMPARE(computeDistanceAttenuation(0.5f, 0.2f), 1.0f);
+    QCOMPARE(computeDistanceAttenuation(ATTENUATION_BEGINS_AT_DISTANCE, 0.2f), 1.0f);
+    QVERIFY(qFuzzyCompare(computeDistanceAttenuation(2.0f * ATTENUATION_BEGINS_AT_DISTANCE, 0.2f), 0.8f));
+    QVERIFY(qFuzzyCompare(computeDistanceAttenuation(4.0f * ATTENUATION_BEGINS_AT_DISTANCE, 0.2f), 0.6f));
+
+    // and never below silence
+    QCOMPARE(computeDistanceAttenuation(1000.0f, 0.2f), 0.0f);
+}
+
+void AudioSpatializationTests::bearing() {
+    glm::quat facingForward;
+
+    QCOMPARE(computeBearing(glm::vec3(0.0f, 0.0f, -2.0f), facingForward), 0.0f);
+    QVERIFY(qFuzzyCompare(computeBearing(glm::vec3(-2.0f, 0.0f, 0.0f), facingForward), PI_OVER_TWO));
+    QVERIFY(qFuzzyCompare(computeBearing(glm::vec3(2.0f, 0.0f, 0.0f), facingForward), -PI_OVER_TWO));
+
+    // a source straight above doesn't have a bearing
+    QCOMPARE(computeBearing(glm::vec3(0.0f, 2.0f, 0.0f), facingForward), 0.0f);
+
+    // turning to the left brings a source on the left in front
+    glm::quat facingLeft = glm::angleAxis(PI_OVER_TWO, glm::vec3(0.0f, 1.0f, 0.0f));
+    QVERIFY(fabsf(computeBearing(glm::vec3(-2.0f, 0.0f, 0.0f), facingLeft)) < 1.0e-3f);
+}
+
+void AudioSpatializationTests::phasePanning() {
+    int numSamplesDelay;
+    float weakChannelAmplitudeRatio;
+
+    computePhasePanning(0.0f, 1.0f, numSamplesDelay, weakChannelAmplitudeRatio);
+    QCOMPARE(numSamplesDelay, 0);
+    QCOMPARE(weakChannelAmplitudeRatio, 1.0f);
+
+    computePhasePanning(PI_OVER_TWO, 1.0f, numSamplesDelay, weakChannelAmplitudeRatio);
+    QCOMPARE(numSamplesDelay, SAMPLE_PHASE_DELAY_AT_90);
+    QVERIFY(qFuzzyCompare(weakChannelAmplitudeRatio, 0.5f));
+
+    // less of it inside the head
+    computePhasePanning(PI_OVER_TWO, RADIUS_OF_HEAD / 2.0f, numSamplesDelay, weakChannelAmplitudeRatio);
+    QCOMPARE(numSamplesDelay, SAMPLE_PHASE_DELAY_AT_90 / 2);
+    QVERIFY(qFuzzyCompare(weakChannelAmplitudeRatio, 0.75f));
+}
+
+void AudioSpatializationTests::penumbraFilterGains() {
+    float gainL, gainR;
+
+    // flat in front, duller behind
+    computePenumbraFilterGains(0.0f, 1.0f, gainL, gainR);
+    QCOMPARE(gainL, 1.0f);
+    QCOMPARE(gainR, 1.0f);
+
+    computePenumbraFilterGains(0.99f * PI, 1.0f, gainL, gainR);
+    QVERIFY(gainL < 0.8f);
+    QVERIFY(gainR < 0.8f);
+
+    // the ear away from a source on the left is duller
+    computePenumbraFilterGains(PI_OVER_TWO, 1.0f, gainL, gainR);
+    QCOMPARE(gainL, 1.0f);
+    QVERIFY(gainR < 1.0f);
+}
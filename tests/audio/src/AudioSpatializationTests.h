@@ -0,0 +1,25 @@
+//
+//  AudioSpatializationTests.h
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSpatializationTests_h
+#define hifi_AudioSpatializationTests_h
+
+#include <QtTest/QtTest>
+
+class AudioSpatializationTests : public QObject {
+    Q_OBJECT
+private slots:
+    void distanceAttenuation();
+    void bearing();
+    void phasePanning();
+    void penumbraFilterGains();
+};
+
+#endif // hifi_AudioSpatializationTests_h
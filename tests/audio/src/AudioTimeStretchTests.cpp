@@ -0,0 +1,102 @@
+//
+//  AudioTimeStretchTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioTimeStretchTests.h"
+
+#include <AudioConstants.h>
+#include <AudioTimeStretch.h>
+
+QTEST_MAIN(AudioTimeStretchTests)
+
+const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+const int NUM_CHANNELS = AudioConstants::STEREO;
+const int OUTPUT_SAMPLES = (NUM_FRAMES + AudioTimeStretch::MAX_LAG_FRAMES) * NUM_CHANNELS;
+
+const double TEST_AMPLITUDE = 10000.0;
+
+// test pitches inside the searched lag range
+const double TEST_FREQUENCIES_HZ[] = { 160.0, 220.0, 400.0 };
+
+static void generateSine(int16_t* samples, int numFrames, double frequency) {
+    for (int i = 0; i < numFrames; i++) {
+        int16_t sample = (int16_t)lrint(TEST_AMPLITUDE * sin(2.0 * M_PI * frequency * i / AudioConstants::SAMPLE_RATE));
+        for (int c = 0; c < NUM_CHANNELS; c++) {
+            samples[NUM_CHANNELS * i + c] = sample;
+        }
+    }
+}
+
+// the largest jump between neighbouring frames of the first channel
+static int maxStep(const int16_t* samples, int numFrames) {
+    int step = 0;
+    for (int i = 1; i < numFrames; i++) {
+        step = std::max(step, abs(samples[NUM_CHANNELS * i] - samples[NUM_CHANNELS * (i - 1)]));
+    }
+    return step;
+}
+
+void AudioTimeStretchTests::compressShortensByOneLag() {
+    int16_t input[NUM_FRAMES * NUM_CHANNELS];
+    int16_t output[OUTPUT_SAMPLES];
+    generateSine(input, NUM_FRAMES, TEST_FREQUENCIES_HZ[0]);
+
+    int outputFrames = AudioTimeStretch::compress(input, output, NUM_FRAMES, NUM_CHANNELS);
+    int lag = NUM_FRAMES - outputFrames;
+    QVERIFY(lag >= AudioTimeStretch::MIN_LAG_FRAMES && lag <= AudioTimeStretch::MAX_LAG_FRAMES);
+
+    // the block still starts and ends on the same samples
+    QCOMPARE(output[0], input[0]);
+    QCOMPARE(output[NUM_CHANNELS * (outputFrames - 1)], input[NUM_CHANNELS * (NUM_FRAMES - 1)]);
+}
+
+void AudioTimeStretchTests::expandLengthensByOneLag() {
+    int16_t input[NUM_FRAMES * NUM_CHANNELS];
+    int16_t output[OUTPUT_SAMPLES];
+    generateSine(input, NUM_FRAMES, TEST_FREQUENCIES_HZ[0]);
+
+    int outputFrames = AudioTimeStretch::expand(input, output, NUM_FRAMES, NUM_CHANNELS);
+    int lag = outputFrames - NUM_FRAMES;
+    QVERIFY(lag >= AudioTimeStretch::MIN_LAG_FRAMES && lag <= AudioTimeStretch::MAX_LAG_FRAMES);
+
+    QCOMPARE(output[0], input[0]);
+    QCOMPARE(output[NUM_CHANNELS * (outputFrames - 1)], input[NUM_CHANNELS * (NUM_FRAMES - 1)]);
+}
+
+void AudioTimeStretchTests::shortBlocksAreCopied() {
+    const int SHORT_FRAMES = AudioTimeStretch::MIN_BLOCK_FRAMES - 1;
+    int16_t input[NUM_FRAMES * NUM_CHANNELS];
+    int16_t output[OUTPUT_SAMPLES];
+    generateSine(input, NUM_FRAMES, TEST_FREQUENCIES_HZ[1]);
+
+    QCOMPARE(AudioTimeStretch::compress(input, output, SHORT_FRAMES, NUM_CHANNELS), SHORT_FRAMES);
+    QVERIFY(memcmp(input, output, SHORT_FRAMES * NUM_CHANNELS * sizeof(int16_t)) == 0);
+
+    QCOMPARE(AudioTimeStretch::expand(input, output, SHORT_FRAMES, NUM_CHANNELS), SHORT_FRAMES);
+    QVERIFY(memcmp(input, output, SHORT_FRAMES * NUM_CHANNELS * sizeof(int16_t)) == 0);
+}
+
+void AudioTimeStretchTests::spliceIsContinuous() {
+    int16_t input[NUM_FRAMES * NUM_CHANNELS];
+    int16_t output[OUTPUT_SAMPLES];
+
+    for (double frequency : TEST_FREQUENCIES_HZ) {
+        generateSine(input, NUM_FRAMES, frequency);
+
+        // a splice at a matching lag never steps further than the sine itself does, give or take the crossfade
+        const float STEP_TOLERANCE = 1.1f;
+        int allowedStep = STEP_TOLERANCE * maxStep(input, NUM_FRAMES);
+
+        int outputFrames = AudioTimeStretch::compress(input, output, NUM_FRAMES, NUM_CHANNELS);
+        QVERIFY(maxStep(output, outputFrames) <= allowedStep);
+
+        outputFrames = AudioTimeStretch::expand(input, output, NUM_FRAMES, NUM_CHANNELS);
+        QVERIFY(maxStep(output, outputFrames) <= allowedStep);
+    }
+}
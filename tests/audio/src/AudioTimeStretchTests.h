@@ -0,0 +1,25 @@
+//
+//  AudioTimeStretchTests.h
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioTimeStretchTests_h
+#define hifi_AudioTimeStretchTests_h
+
+#include <QtTest/QtTest>
+
+class AudioTimeStretchTests : public QObject {
+    Q_OBJECT
+private slots:
+    void compressShortensByOneLag();
+    void expandLengthensByOneLag();
+    void shortBlocksAreCopied();
+    void spliceIsContinuous();
+};
+
+#endif // hifi_AudioTimeStretchTests_h
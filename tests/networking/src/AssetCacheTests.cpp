@@ -0,0 +1,123 @@
+//
+//  AssetCacheTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetCacheTests.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+
+#include <AssetCache.h>
+#include <AssetUtils.h>
+
+QTEST_MAIN(AssetCacheTests)
+
+static QByteArray createAsset(char fill, int size) {
+    return QByteArray(size, fill);
+}
+
+static QString hashOf(const QByteArray& data) {
+    return hashData(data).toHex();
+}
+
+void AssetCacheTests::findTest() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    QByteArray asset = createAsset('a', 1000);
+    QString hash = hashOf(asset);
+
+    {
+        AssetCache cache;
+        cache.setCacheDirectory(directory.path());
+        QVERIFY(cache.find(hash).isNull());
+
+        cache.insert(hash, asset);
+        QCOMPARE(cache.find(hash), asset);
+        QCOMPARE(cache.getSize(), (qint64)asset.size());
+    }
+
+    AssetCache cache;
+    cache.setCacheDirectory(directory.path());
+    QCOMPARE(cache.getSize(), (qint64)asset.size());
+    QCOMPARE(cache.find(hash), asset);
+}
+
+void AssetCacheTests::evictTest() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    const int ASSET_SIZE = 1000;
+    QByteArray first = createAsset('a', ASSET_SIZE);
+    QByteArray second = createAsset('b', ASSET_SIZE);
+    QByteArray third = createAsset('c', ASSET_SIZE);
+
+    AssetCache cache;
+    cache.setCacheDirectory(directory.path());
+    cache.setMaximumSize(2 * ASSET_SIZE);
+
+    cache.insert(hashOf(first), first);
+    QTest::qWait(10);
+    cache.insert(hashOf(second), second);
+    QTest::qWait(10);
+
+    // using the first makes the second the least recently used
+    QCOMPARE(cache.find(hashOf(first)), first);
+    QTest::qWait(10);
+    cache.insert(hashOf(third), third);
+
+    QVERIFY(cache.getSize() <= 2 * ASSET_SIZE);
+    QCOMPARE(cache.find(hashOf(first)), first);
+    QVERIFY(cache.find(hashOf(second)).isNull());
+    QCOMPARE(cache.find(hashOf(third)), third);
+}
+
+void AssetCacheTests::damagedFileTest() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    QByteArray asset = createAsset('a', 1000);
+    QString hash = hashOf(asset);
+
+    AssetCache cache;
+    cache.setCacheDirectory(directory.path());
+    cache.insert(hash, asset);
+
+    {
+        QFile file(directory.path() + "/" + hash);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        file.write("x", 1);
+    }
+
+    QVERIFY(cache.find(hash).isNull());
+    QCOMPARE(cache.getSize(), (qint64)0);
+    QVERIFY(!QFile::exists(directory.path() + "/" + hash));
+}
+
+void AssetCacheTests::findFileTest() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    QByteArray asset = createAsset('a', 1000);
+    QString hash = hashOf(asset);
+
+    AssetCache cache;
+    cache.setCacheDirectory(directory.path());
+    AssetCache otherCache;
+    otherCache.setCacheDirectory(directory.path());
+    QVERIFY(cache.findFile(hash).isEmpty());
+
+    cache.insert(hash, asset);
+    QString path = cache.findFile(hash);
+    QCOMPARE(path, directory.path() + "/" + hash);
+
+    QCOMPARE(otherCache.findFile(hash), path);
+    QCOMPARE(otherCache.getSize(), (qint64)asset.size());
+    QCOMPARE(otherCache.find(hash), asset);
+}
@@ -0,0 +1,34 @@
+//
+//  AssetCacheTests.h
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetCacheTests_h
+#define hifi_AssetCacheTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class AssetCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that an inserted asset is found again, also by a cache opened later on the same directory
+    void findTest();
+
+    // Test that the least recently used assets are evicted once the cache is over its size
+    void evictTest();
+
+    // Test that a file that doesn't match its hash is dropped instead of returned
+    void damagedFileTest();
+
+    // Test that the file of an asset is found, also when another cache on the same directory put it there
+    void findFileTest();
+};
+
+#endif // hifi_AssetCacheTests_h
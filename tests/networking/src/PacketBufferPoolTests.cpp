@@ -0,0 +1,66 @@
+//
+//  PacketBufferPoolTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPoolTests.h"
+
+#include <thread>
+#include <vector>
+
+#include <udt/Constants.h>
+#include <udt/PacketBufferPool.h>
+
+QTEST_MAIN(PacketBufferPoolTests)
+
+using namespace udt;
+
+void PacketBufferPoolTests::reuseTest() {
+    char* released = nullptr;
+    {
+        auto buffer = PacketBufferPool::allocate(MAX_PACKET_SIZE);
+        QVERIFY(buffer);
+        released = buffer.get();
+    }
+
+    // the same thread gets the buffer it just released back for any size of the same class
+    auto buffer = PacketBufferPool::allocate(MAX_PACKET_SIZE - 1);
+    QCOMPARE(buffer.get(), released);
+}
+
+void PacketBufferPoolTests::oversizedTest() {
+    const int OVERSIZED = 4 * MAX_PACKET_SIZE;
+
+    auto buffer = PacketBufferPool::allocate(OVERSIZED);
+    QVERIFY(buffer);
+
+    memset(buffer.get(), 0xff, OVERSIZED);
+    QCOMPARE(buffer[OVERSIZED - 1], (char)0xff);
+}
+
+void PacketBufferPoolTests::crossThreadTest() {
+    const int NUM_BUFFERS = 1000;
+
+    std::vector<PacketBuffer> buffers;
+    for (int i = 0; i < NUM_BUFFERS; ++i) {
+        buffers.push_back(PacketBufferPool::allocate(i % MAX_PACKET_SIZE));
+        buffers.back()[0] = (char)i;
+    }
+
+    // release them all on another thread, they go through its cache into the shared depot
+    std::thread releasingThread([&] {
+        buffers.clear();
+    });
+    releasingThread.join();
+
+    // and can be handed out again here
+    for (int i = 0; i < NUM_BUFFERS; ++i) {
+        buffers.push_back(PacketBufferPool::allocate(MAX_PACKET_SIZE));
+    }
+    QCOMPARE((int)buffers.size(), NUM_BUFFERS);
+}
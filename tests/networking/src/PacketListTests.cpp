@@ -0,0 +1,92 @@
+//
+//  PacketListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketListTests.h"
+
+#include <QtCore/QBuffer>
+
+#include <udt/PacketList.h>
+#include <udt/PacketQueue.h>
+
+QTEST_MAIN(PacketListTests)
+
+static std::unique_ptr<QIODevice> createDevice(const QByteArray& data) {
+    std::unique_ptr<QBuffer> buffer { new QBuffer() };
+    buffer->setData(data);
+    buffer->open(QIODevice::ReadOnly);
+    return std::move(buffer);
+}
+
+static QByteArray createData(int size) {
+    QByteArray data;
+    data.reserve(size);
+    for (int i = 0; i < size; i++) {
+        data.append((char)(i % 251));
+    }
+    return data;
+}
+
+void PacketListTests::streamTest() {
+    const QByteArray HEADER = "header";
+    const QByteArray DATA = createData(100000);
+
+    auto packetList = udt::PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+    packetList->write(HEADER);
+    packetList->streamFrom(createDevice(DATA), DATA.size());
+    QVERIFY(packetList->isStreaming());
+
+    // only the packet with the header was made up front
+    QCOMPARE(packetList->getNumPackets(), (size_t)1);
+    packetList->closeCurrentPacket();
+
+    udt::PacketQueue queue;
+    queue.queuePacketList(std::move(packetList));
+
+    QByteArray message;
+    udt::Packet::MessagePartNumber expectedPartNumber = 0;
+    while (!queue.isEmpty()) {
+        auto packet = queue.takePacket();
+        QVERIFY(packet);
+        QCOMPARE(packet->getMessagePartNumber(), expectedPartNumber);
+        message.append(packet->getPayload(), packet->getPayloadSize());
+
+        if (expectedPartNumber == 0) {
+            QCOMPARE(packet->getPacketPosition(), udt::Packet::PacketPosition::FIRST);
+        } else if (queue.isEmpty()) {
+            QCOMPARE(packet->getPacketPosition(), udt::Packet::PacketPosition::LAST);
+        } else {
+            QCOMPARE(packet->getPacketPosition(), udt::Packet::PacketPosition::MIDDLE);
+        }
+        ++expectedPartNumber;
+    }
+
+    QVERIFY(expectedPartNumber > 2);
+    QCOMPARE(message, HEADER + DATA);
+}
+
+void PacketListTests::shortStreamTest() {
+    const QByteArray HEADER = "header";
+    const QByteArray DATA = createData(100);
+
+    auto packetList = udt::PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+    packetList->write(HEADER);
+    packetList->streamFrom(createDevice(DATA), DATA.size());
+    QVERIFY(!packetList->isStreaming());
+    packetList->closeCurrentPacket();
+
+    udt::PacketQueue queue;
+    queue.queuePacketList(std::move(packetList));
+
+    auto packet = queue.takePacket();
+    QVERIFY(packet);
+    QCOMPARE(packet->getPacketPosition(), udt::Packet::PacketPosition::ONLY);
+    QCOMPARE(QByteArray(packet->getPayload(), (int)packet->getPayloadSize()), HEADER + DATA);
+    QVERIFY(queue.isEmpty());
+}
@@ -0,0 +1,28 @@
+//
+//  PacketListTests.h
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketListTests_h
+#define hifi_PacketListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketListTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a streamed list reads its device a packet at a time and numbers all of them as one message
+    void streamTest();
+
+    // Test that a stream that fits in the packet being written leaves an ordinary list
+    void shortStreamTest();
+};
+
+#endif // hifi_PacketListTests_h
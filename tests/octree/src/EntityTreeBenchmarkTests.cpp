@@ -0,0 +1,309 @@
+//
+//  EntityTreeBenchmarkTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeBenchmarkTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <AACube.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <NumericalConstants.h>
+#include <Octree.h>
+#include <OctreeConstants.h>
+#include <OctreeElementBag.h>
+#include <OctreePacketData.h>
+#include <ViewFrustum.h>
+
+QTEST_MAIN(EntityTreeBenchmarkTests)
+
+// Times what sizes an entity server: encoding the scene for its viewers, persisting it, and the queries the scripts
+// and the physics make of it.  The scenes are generated, a mix of the common entity types spread evenly, gathered in
+// clusters like the builds of a domain, or strung along a line like a road.
+//
+// The QBENCHMARK results are machine readable with the usual QtTest output options, eg -csv or -xml, and
+// -o results.csv,csv to write them to a file.
+
+enum class Distribution {
+    Uniform,
+    Clustered,
+    Line
+};
+
+// the scenes sit in this cube about the origin
+const float SCENE_SIZE = 1000.0f;
+
+const int NUM_CLUSTERS = 20;
+const float CLUSTER_RADIUS = 15.0f;
+
+const int NUM_VIEWERS = 4;
+const int NUM_QUERIES = 100;
+const float FIND_RADIUS = 10.0f;
+
+Q_DECLARE_METATYPE(Distribution)
+
+static float randomUnit() {
+    return (float)qrand() / RAND_MAX;
+}
+
+static glm::vec3 randomInCube(float size) {
+    return size * glm::vec3(randomUnit() - 0.5f, randomUnit() - 0.5f, randomUnit() - 0.5f);
+}
+
+static glm::vec3 randomPosition(Distribution distribution, const QVector<glm::vec3>& clusterCenters) {
+    switch (distribution) {
+        case Distribution::Clustered:
+            return clusterCenters[qrand() % clusterCenters.size()] + randomInCube(2.0f * CLUSTER_RADIUS);
+        case Distribution::Line:
+            return glm::vec3(SCENE_SIZE * (randomUnit() - 0.5f), 0.0f, 0.0f) + randomInCube(4.0f);
+        default:
+            return randomInCube(SCENE_SIZE);
+    }
+}
+
+static EntityTreePointer generateScene(int numEntities, Distribution distribution) {
+    // the same scene every run
+    qsrand(1);
+
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->setIsServer(true);
+
+    QVector<glm::vec3> clusterCenters;
+    for (int i = 0; i < NUM_CLUSTERS; i++) {
+        clusterCenters.append(randomInCube(SCENE_SIZE - 2.0f * CLUSTER_RADIUS));
+    }
+
+    // mostly primitives and models, with some lights and text
+    const EntityTypes::EntityType TYPES[] = {
+        EntityTypes::Box, EntityTypes::Box, EntityTypes::Sphere, EntityTypes::Sphere,
+        EntityTypes::Model, EntityTypes::Model, EntityTypes::Model, EntityTypes::Light, EntityTypes::Text
+    };
+    const int NUM_TYPES = sizeof(TYPES) / sizeof(TYPES[0]);
+
+    for (int i = 0; i < numEntities; i++) {
+        EntityItemProperties properties;
+        properties.setType(TYPES[qrand() % NUM_TYPES]);
+        properties.setPosition(randomPosition(distribution, clusterCenters));
+        properties.setRotation(glm::angleAxis(TWO_PI * randomUnit(), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+        // mostly small things, some large ones
+        float size = randomUnit() < 0.9f ? 0.2f + 2.0f * randomUnit() : 5.0f + 20.0f * randomUnit();
+        properties.setDimensions(size * glm::vec3(0.5f + randomUnit(), 0.5f + randomUnit(), 0.5f + randomUnit()));
+
+        switch (properties.getType()) {
+            case EntityTypes::Model:
+                properties.setModelURL(QString("http://models.example.com/model%1.fbx").arg(qrand() % 50));
+                break;
+            case EntityTypes::Text:
+                properties.setText(QString("sign %1").arg(i));
+                break;
+            default:
+                break;
+        }
+
+        tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+    }
+    return tree;
+}
+
+static int countEntities(const EntityTreePointer& tree) {
+    QVector<EntityItemPointer> entities;
+    tree->findEntities(AACube(glm::vec3(-(float)HALF_TREE_SCALE), (float)TREE_SCALE), entities);
+    return entities.size();
+}
+
+static ViewFrustum makeViewer(int viewer) {
+    ViewFrustum viewFrustum;
+    viewFrustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                               DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
+
+    // spread around the scene, each looking in towards its middle
+    float angle = TWO_PI * viewer / NUM_VIEWERS;
+    viewFrustum.setPosition(0.4f * SCENE_SIZE * glm::vec3(cosf(angle), 0.0f, sinf(angle)));
+    viewFrustum.setOrientation(glm::angleAxis(PI_OVER_TWO - angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+    viewFrustum.calculate();
+    return viewFrustum;
+}
+
+// the bytes of the full scene for one viewer, encoded packet by packet the way the send threads do
+static int encodeSceneForViewer(const EntityTreePointer& tree, const ViewFrustum& viewFrustum) {
+    OctreeElementBag bag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    OctreePacketData packetData(true);
+    int totalBytes = 0;
+
+    bag.insert(tree->getRoot());
+    tree->withReadLock([&] {
+        while (OctreeElementPointer subTree = bag.extract()) {
+            EncodeBitstreamParams params(INT_MAX, &viewFrustum, WANT_EXISTS_BITS, DONT_CHOP);
+            params.extraEncodeData = &extraEncodeData;
+
+            int bytesWritten = tree->encodeTreeBitstream(subTree, &packetData, bag, params);
+            if (bytesWritten == 0 && params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
+                if (!packetData.hasContent()) {
+                    // won't fit in an empty packet either
+                    continue;
+                }
+                totalBytes += packetData.getFinalizedSize();
+                packetData.reset();
+                bag.insert(subTree);
+            }
+        }
+    });
+    totalBytes += packetData.getFinalizedSize();
+
+    tree->releaseSceneEncodeData(&extraEncodeData);
+    return totalBytes;
+}
+
+static void addSceneRows() {
+    QTest::addColumn<int>("numEntities");
+    QTest::addColumn<Distribution>("distribution");
+
+    QTest::newRow("1000 uniform") << 1000 << Distribution::Uniform;
+    QTest::newRow("10000 uniform") << 10000 << Distribution::Uniform;
+    QTest::newRow("10000 clustered") << 10000 << Distribution::Clustered;
+    QTest::newRow("10000 line") << 10000 << Distribution::Line;
+}
+
+void EntityTreeBenchmarkTests::generatedSceneRoundTrips() {
+    const int NUM_ENTITIES = 500;
+    auto tree = generateScene(NUM_ENTITIES, Distribution::Clustered);
+    QCOMPARE(countEntities(tree), NUM_ENTITIES);
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QByteArray path = directory.filePath("models.json").toLocal8Bit();
+    tree->writeToJSONFile(path.constData());
+
+    auto readTree = std::make_shared<EntityTree>();
+    readTree->createRootElement();
+    readTree->setIsServer(true);
+    QVERIFY(readTree->readFromFile(path.constData()));
+    QCOMPARE(countEntities(readTree), NUM_ENTITIES);
+
+    QVERIFY(encodeSceneForViewer(tree, makeViewer(0)) > 0);
+}
+
+void EntityTreeBenchmarkTests::benchmarkEncodeForViewers_data() {
+    addSceneRows();
+}
+
+void EntityTreeBenchmarkTests::benchmarkEncodeForViewers() {
+    QFETCH(int, numEntities);
+    QFETCH(Distribution, distribution);
+    auto tree = generateScene(numEntities, distribution);
+
+    QVector<ViewFrustum> viewers;
+    for (int i = 0; i < NUM_VIEWERS; i++) {
+        viewers.append(makeViewer(i));
+    }
+
+    int totalBytes = 0;
+    QBENCHMARK {
+        totalBytes = 0;
+        for (const auto& viewer : viewers) {
+            totalBytes += encodeSceneForViewer(tree, viewer);
+        }
+    }
+    qDebug() << "bytes per viewer" << totalBytes / NUM_VIEWERS;
+}
+
+void EntityTreeBenchmarkTests::benchmarkPersistRoundTrip_data() {
+    addSceneRows();
+}
+
+void EntityTreeBenchmarkTests::benchmarkPersistRoundTrip() {
+    QFETCH(int, numEntities);
+    QFETCH(Distribution, distribution);
+    auto tree = generateScene(numEntities, distribution);
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QByteArray path = directory.filePath("models.json.gz").toLocal8Bit();
+
+    QBENCHMARK {
+        tree->writeToJSONFile(path.constData(), nullptr, true);
+
+        auto readTree = std::make_shared<EntityTree>();
+        readTree->createRootElement();
+        readTree->setIsServer(true);
+        readTree->readFromFile(path.constData());
+    }
+    qDebug() << "persisted bytes" << QFileInfo(QString::fromLocal8Bit(path)).size();
+}
+
+void EntityTreeBenchmarkTests::benchmarkFindRayIntersection_data() {
+    addSceneRows();
+}
+
+void EntityTreeBenchmarkTests::benchmarkFindRayIntersection() {
+    QFETCH(int, numEntities);
+    QFETCH(Distribution, distribution);
+    auto tree = generateScene(numEntities, distribution);
+
+    // from the viewers towards random points of the scene
+    QVector<glm::vec3> origins;
+    QVector<glm::vec3> directions;
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        glm::vec3 origin = makeViewer(i % NUM_VIEWERS).getPosition();
+        origins.append(origin);
+        directions.append(glm::normalize(randomInCube(SCENE_SIZE) - origin));
+    }
+
+    int numHits = 0;
+    QBENCHMARK {
+        numHits = 0;
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            OctreeElementPointer element;
+            float distance;
+            BoxFace face;
+            glm::vec3 surfaceNormal;
+            if (tree->findRayIntersection(origins[i], directions[i], element, distance, face, surfaceNormal,
+                                          QVector<EntityItemID>(), QVector<EntityItemID>(), nullptr, Octree::Lock)) {
+                numHits++;
+            }
+        }
+    }
+    qDebug() << "hits per" << NUM_QUERIES << "rays" << numHits;
+}
+
+void EntityTreeBenchmarkTests::benchmarkFindEntities_data() {
+    addSceneRows();
+}
+
+void EntityTreeBenchmarkTests::benchmarkFindEntities() {
+    QFETCH(int, numEntities);
+    QFETCH(Distribution, distribution);
+    auto tree = generateScene(numEntities, distribution);
+
+    // about the entities themselves, the way the scripts look around an avatar
+    QVector<EntityItemPointer> entities;
+    tree->findEntities(AACube(glm::vec3(-(float)HALF_TREE_SCALE), (float)TREE_SCALE), entities);
+    QVector<glm::vec3> centers;
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        centers.append(entities[qrand() % entities.size()]->getPosition());
+    }
+
+    int numFound = 0;
+    QBENCHMARK {
+        numFound = 0;
+        for (const auto& center : centers) {
+            QVector<EntityItemPointer> found;
+            tree->findEntities(center, FIND_RADIUS, found);
+            numFound += found.size();
+        }
+    }
+    qDebug() << "found per query" << (float)numFound / NUM_QUERIES;
+}
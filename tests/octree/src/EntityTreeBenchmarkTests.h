@@ -0,0 +1,31 @@
+//
+//  EntityTreeBenchmarkTests.h
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeBenchmarkTests_h
+#define hifi_EntityTreeBenchmarkTests_h
+
+#include <QtTest/QtTest>
+
+class EntityTreeBenchmarkTests : public QObject {
+    Q_OBJECT
+private slots:
+    void generatedSceneRoundTrips();
+
+    void benchmarkEncodeForViewers_data();
+    void benchmarkEncodeForViewers();
+    void benchmarkPersistRoundTrip_data();
+    void benchmarkPersistRoundTrip();
+    void benchmarkFindRayIntersection_data();
+    void benchmarkFindRayIntersection();
+    void benchmarkFindEntities_data();
+    void benchmarkFindEntities();
+};
+
+#endif // hifi_EntityTreeBenchmarkTests_h
@@ -18,10 +18,14 @@
 #include <EntityItem.h>
 #include <EntityTree.h>
 #include <EntityTreeElement.h>
+#include <JurisdictionMap.h>
+#include <OctalCode.h>
 #include <Octree.h>
 #include <OctreeConstants.h>
+#include <OctreePacketData.h>
 #include <PropertyFlags.h>
 #include <SharedUtil.h>
+#include <UUID.h>
 
 #include "OctreeTests.h"
 
@@ -796,3 +800,76 @@ void OctreeTests::modelItemTests() {
 #endif 
 }
 
+// the encodings into a caller's buffer that the entity send path uses must be the bytes of the QByteArray ones
+void OctreeTests::bufferEncodingTests() {
+    const quint64 VALUES[] = { 0, 1, 127, 128, 259, 0xffffffff, 0x123456789abcULL, UINT64_MAX };
+    for (quint64 value : VALUES) {
+        ByteCountCoded<quint64> coder = value;
+        unsigned char buffer[ByteCountCoded<quint64>::MAX_ENCODED_BYTES];
+        int length = coder.encode(buffer);
+        QCOMPARE(QByteArray((const char*)buffer, length), coder.encode());
+        QCOMPARE((quint64)ByteCountCoded<quint64>(coder.encode()), value);
+    }
+
+    EntityPropertyFlags flags;
+    unsigned char flagsBuffer[PROP_AFTER_LAST_ITEM / (BITS_PER_BYTE - 1) + 1];
+    QCOMPARE(QByteArray((const char*)flagsBuffer, flags.encode(flagsBuffer, sizeof(flagsBuffer))), flags.encode());
+    flags |= PROP_POSITION;
+    flags |= PROP_SCRIPT;
+    flags += PROP_LAST_ITEM;
+    QVERIFY(flags.getHasProperty(PROP_SCRIPT));
+    QCOMPARE(QByteArray((const char*)flagsBuffer, flags.encode(flagsBuffer, sizeof(flagsBuffer))), flags.encode());
+    QCOMPARE(flags.encode(flagsBuffer, 1), 0);
+
+    QUuid id = QUuid::createUuid();
+    unsigned char idBuffer[NUM_BYTES_RFC4122_UUID];
+    uuidToRfc4122(id, idBuffer);
+    QCOMPARE(QByteArray((const char*)idBuffer, NUM_BYTES_RFC4122_UUID), id.toRfc4122());
+
+    // written straight into the packet, or through the local 8 bit copy for the rest
+    OctreePacketData packetData(false);
+    const QString STRING = "http://example.com/model.fbx";
+    QVERIFY(packetData.appendValue(STRING));
+    QVERIFY(packetData.appendValue(id));
+    QString readString;
+    int bytesRead = OctreePacketData::unpackDataFromBytes(packetData.getUncompressedData(), readString);
+    QCOMPARE(readString, STRING);
+    QUuid readID;
+    OctreePacketData::unpackDataFromBytes(packetData.getUncompressedData(bytesRead), readID);
+    QCOMPARE(readID, id);
+}
+
+// the children a busy jurisdiction splits into cover it all, and only it
+void OctreeTests::jurisdictionSplitTests() {
+    unsigned char* root = hexStringToOctalCode("00");
+    unsigned char* pastEnd = childOctalCode(root, 3);
+    unsigned char* childWithEnd = childOctalCode(root, 5);
+    unsigned char* innerEnd = childOctalCode(childWithEnd, 1);
+
+    JurisdictionMap jurisdiction;
+    jurisdiction.copyContents(root, { pastEnd, innerEnd });
+    std::vector<JurisdictionMap> children = jurisdiction.split();
+    QCOMPARE((int)children.size(), NUMBER_OF_CHILDREN - 1);
+
+    for (const auto& child : children) {
+        unsigned char* childRoot = child.getRootOctalCode();
+        QCOMPARE(numberOfThreeBitSectionsInCode(childRoot), 1);
+        QVERIFY(compareOctalCodes(childRoot, pastEnd) != EXACT_MATCH);
+
+        unsigned char* parent = parentOctalCode(childRoot);
+        QCOMPARE(compareOctalCodes(parent, root), EXACT_MATCH);
+        delete[] parent;
+
+        bool isChildWithEnd = compareOctalCodes(childRoot, childWithEnd) == EXACT_MATCH;
+        QCOMPARE(child.getEndNodeCount(), isChildWithEnd ? 1 : 0);
+        if (isChildWithEnd) {
+            QCOMPARE(child.getEndNodeHexStrings(), QStringList(octalCodeToHexString(innerEnd)));
+        }
+    }
+    QVERIFY(!parentOctalCode(root));
+
+    delete[] root;
+    delete[] pastEnd;
+    delete[] childWithEnd;
+    delete[] innerEnd;
+}
@@ -25,6 +25,9 @@ private slots:
     // This test is fine
     void modelItemTests();
 
+    void bufferEncodingTests();
+    void jurisdictionSplitTests();
+
     // TODO: Break these into separate test functions
 };
 
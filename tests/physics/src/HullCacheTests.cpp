@@ -0,0 +1,110 @@
+//
+//  HullCacheTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QDir>
+#include <QtCore/QTemporaryDir>
+
+#include <HullCache.h>
+#include <ShapeFactory.h>
+
+#include "HullCacheTests.h"
+
+QTEST_MAIN(HullCacheTests)
+
+// points on a sphere, plus points inside it that can never be on its hull
+static QVector<glm::vec3> makeSpherePoints(int numSurfacePoints) {
+    QVector<glm::vec3> points;
+    const float GOLDEN_ANGLE = 2.39996f;
+    for (int i = 0; i < numSurfacePoints; ++i) {
+        float y = 1.0f - 2.0f * ((float)i + 0.5f) / (float)numSurfacePoints;
+        float radius = sqrtf(1.0f - y * y);
+        float theta = GOLDEN_ANGLE * (float)i;
+        points.push_back(glm::vec3(radius * cosf(theta), y, radius * sinf(theta)));
+        points.push_back(0.5f * points.back());
+    }
+    return points;
+}
+
+void HullCacheTests::reduceLargeHull() {
+    QVector<glm::vec3> points = makeSpherePoints(1000);
+    QVector<glm::vec3> reducedPoints = ShapeFactory::reduceHullPoints(points);
+
+    QVERIFY(reducedPoints.size() > 0);
+    QVERIFY(reducedPoints.size() < points.size() / 10);
+
+    // the reduced hull stays on the original
+    for (auto& point : reducedPoints) {
+        QVERIFY(glm::length(point) < 1.0f + 1.0e-3f);
+    }
+}
+
+void HullCacheTests::findInMemory() {
+    HullCache cache;
+    QVector<glm::vec3> points = makeSpherePoints(100);
+    QVector<glm::vec3> reducedPoints = ShapeFactory::reduceHullPoints(points);
+    QByteArray key = HullCache::computeKey(points);
+
+    QVector<glm::vec3> found;
+    QCOMPARE(cache.find(key, found), false);
+
+    cache.insert(key, reducedPoints);
+    QCOMPARE(cache.find(key, found), true);
+    QCOMPARE(found, reducedPoints);
+
+    // a different hull has a different key
+    QVERIFY(HullCache::computeKey(makeSpherePoints(101)) != key);
+}
+
+void HullCacheTests::findOnDisk() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    QVector<glm::vec3> points = makeSpherePoints(100);
+    QVector<glm::vec3> reducedPoints = ShapeFactory::reduceHullPoints(points);
+    QByteArray key = HullCache::computeKey(points);
+    {
+        HullCache cache;
+        cache.setCacheDirectory(directory.path());
+        cache.insert(key, reducedPoints);
+    }
+
+    // a new cache, as in the next session, reads it back
+    HullCache cache;
+    cache.setCacheDirectory(directory.path());
+    QVector<glm::vec3> found;
+    QCOMPARE(cache.find(key, found), true);
+    QCOMPARE(found, reducedPoints);
+}
+
+void HullCacheTests::ignoreDamagedFile() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    QVector<glm::vec3> points = makeSpherePoints(100);
+    QByteArray key = HullCache::computeKey(points);
+    {
+        HullCache cache;
+        cache.setCacheDirectory(directory.path());
+        cache.insert(key, ShapeFactory::reduceHullPoints(points));
+    }
+
+    // cut the file short
+    QStringList files = QDir(directory.path()).entryList(QDir::Files);
+    QCOMPARE(files.size(), 1);
+    QFile file(directory.path() + "/" + files[0]);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 1));
+    file.close();
+
+    HullCache cache;
+    cache.setCacheDirectory(directory.path());
+    QVector<glm::vec3> found;
+    QCOMPARE(cache.find(key, found), false);
+}
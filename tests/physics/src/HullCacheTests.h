@@ -0,0 +1,26 @@
+//
+//  HullCacheTests.h
+//  tests/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HullCacheTests_h
+#define hifi_HullCacheTests_h
+
+#include <QtTest/QtTest>
+
+class HullCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void reduceLargeHull();
+    void findInMemory();
+    void findOnDisk();
+    void ignoreDamagedFile();
+};
+
+#endif // hifi_HullCacheTests_h
@@ -0,0 +1,257 @@
+//
+//  main.cpp
+//  tests/render-perf/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cfloat>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QGuiApplication>
+
+#include <gl/OffscreenGLCanvas.h>
+#include <gpu/Batch.h>
+#include <gpu/Context.h>
+#include <gpu/Framebuffer.h>
+#include <gpu/GLBackend.h>
+
+#include <render/DrawTask.h>
+#include <render/Scene.h>
+
+#include <DependencyManager.h>
+#include <DeferredLightingEffect.h>
+#include <GeometryCache.h>
+#include <LatencyHistogram.h>
+#include <NumericalConstants.h>
+#include <RenderArgs.h>
+#include <ViewFrustum.h>
+
+// Times the CPU side of the render engine on an offscreen context, so that it runs the same on any machine with a GL
+// driver and without a window: the scene taking its pending changes, culling and depth sorting the items, recording
+// a batch that draws them and the GL backend playing that batch.  Each prints the usecs per frame as CSV lines,
+// stage,items,mean,p50,p90,p99,max, for before and after comparisons.
+//
+//     render-perf-test --items 10000,100000 --frames 200
+
+// the items are spread in this cube about the camera
+const float SCENE_SIZE = 500.0f;
+
+// the share of the items each churn frame updates, and the share it removes and adds back
+const float UPDATED_PER_FRAME = 0.1f;
+const float RESET_PER_FRAME = 0.01f;
+
+const int FRAMEBUFFER_SIZE = 512;
+
+class BenchItem {
+public:
+    AABox bound;
+};
+using BenchItemPointer = std::shared_ptr<BenchItem>;
+using BenchPayload = render::Payload<BenchItem>;
+
+namespace render {
+    template <> const ItemKey payloadGetKey(const BenchItemPointer& item) {
+        return ItemKey::Builder::opaqueShape().withSpatiallyIndexed();
+    }
+    template <> const Item::Bound payloadGetBound(const BenchItemPointer& item) {
+        return item->bound;
+    }
+}
+
+static float randomUnit() {
+    return (float)qrand() / RAND_MAX;
+}
+
+static AABox randomBound() {
+    glm::vec3 corner = SCENE_SIZE * glm::vec3(randomUnit() - 0.5f, randomUnit() - 0.5f, randomUnit() - 0.5f);
+    return AABox(corner, 0.2f + 3.0f * randomUnit());
+}
+
+static void report(const char* stage, int numItems, const LatencyHistogram& frameTimes) {
+    std::cout << stage << "," << numItems << "," << frameTimes.getMean() << "," << frameTimes.getPercentile(0.5f) << ","
+        << frameTimes.getPercentile(0.9f) << "," << frameTimes.getPercentile(0.99f) << "," << frameTimes.getMax()
+        << std::endl;
+}
+
+static quint64 usecsElapsed(const QElapsedTimer& timer) {
+    return timer.nsecsElapsed() / NSECS_PER_USEC;
+}
+
+static void runBenchmarks(const gpu::ContextPointer& context, const gpu::FramebufferPointer& framebuffer,
+                          int numItems, int numFrames) {
+    qsrand(1);
+
+    auto scene = std::make_shared<render::Scene>();
+    scene->setChangesTimeBudget(FLT_MAX);
+    auto sceneContext = std::make_shared<render::SceneContext>();
+    sceneContext->_scene = scene;
+
+    std::vector<render::ItemID> ids(numItems);
+    std::vector<BenchItemPointer> items(numItems);
+    {
+        render::PendingChanges pendingChanges;
+        for (int i = 0; i < numItems; i++) {
+            ids[i] = scene->allocateID();
+            items[i] = std::make_shared<BenchItem>();
+            items[i]->bound = randomBound();
+            pendingChanges.resetItem(ids[i], std::make_shared<BenchPayload>(items[i]));
+        }
+        scene->enqueuePendingChanges(pendingChanges);
+        scene->processPendingChangesQueue();
+    }
+
+    ViewFrustum viewFrustum;
+    viewFrustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), 1.0f,
+                                               DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
+    viewFrustum.setPosition(glm::vec3(0.0f));
+    viewFrustum.setOrientation(glm::quat());
+    viewFrustum.calculate();
+
+    RenderArgs args(context, nullptr, &viewFrustum);
+    auto renderContext = std::make_shared<render::RenderContext>();
+    renderContext->args = &args;
+
+    QElapsedTimer timer;
+
+    // the moving items update each frame, and some come and go
+    LatencyHistogram churnTimes;
+    const int numUpdated = std::max((int)(UPDATED_PER_FRAME * numItems), 1);
+    const int numReset = std::max((int)(RESET_PER_FRAME * numItems), 1);
+    for (int frame = 0; frame < numFrames; frame++) {
+        timer.start();
+        render::PendingChanges pendingChanges;
+        for (int i = 0; i < numUpdated; i++) {
+            pendingChanges.updateItem<BenchItem>(ids[qrand() % numItems], [](BenchItem& item) {
+                item.bound.setBox(item.bound.getCorner() + glm::vec3(0.01f), item.bound.getScale());
+            });
+        }
+        for (int i = 0; i < numReset; i++) {
+            int index = qrand() % numItems;
+            pendingChanges.removeItem(ids[index]);
+            ids[index] = scene->allocateID();
+            pendingChanges.resetItem(ids[index], std::make_shared<BenchPayload>(items[index]));
+        }
+        scene->enqueuePendingChanges(pendingChanges);
+        scene->processPendingChangesQueue();
+        churnTimes.record(usecsElapsed(timer));
+    }
+    report("scene_churn", numItems, churnTimes);
+
+    render::ItemIDsBounds allItems;
+    allItems.reserve(numItems);
+    for (auto id : ids) {
+        allItems.emplace_back(id, scene->getItemBound(id));
+    }
+
+    LatencyHistogram cullTimes;
+    LatencyHistogram sortTimes;
+    render::ItemIDsBounds culledItems;
+    render::ItemIDsBounds sortedItems;
+    render::CullFunctor cullFunctor = [](const RenderArgs* args, const AABox& bounds) { return true; };
+    for (int frame = 0; frame < numFrames; frame++) {
+        // turning a little each frame, as a moving camera would
+        viewFrustum.setOrientation(glm::angleAxis(TWO_PI * frame / numFrames, glm::vec3(0.0f, 1.0f, 0.0f)));
+        viewFrustum.calculate();
+
+        RenderDetails::Item details;
+        culledItems.clear();
+        timer.start();
+        render::cullItems(renderContext, cullFunctor, details, allItems, culledItems);
+        cullTimes.record(usecsElapsed(timer));
+
+        timer.start();
+        render::depthSortItems(sceneContext, renderContext, true, culledItems, sortedItems);
+        sortTimes.record(usecsElapsed(timer));
+    }
+    report("cull_items", numItems, cullTimes);
+    report("depth_sort_items", (int)culledItems.size(), sortTimes);
+
+    // a draw of each item in view, the way the shapes record them
+    auto geometryCache = DependencyManager::get<GeometryCache>();
+    LatencyHistogram recordTimes;
+    LatencyHistogram playTimes;
+    for (int frame = 0; frame < numFrames; frame++) {
+        gpu::Batch batch;
+        timer.start();
+        batch.setFramebuffer(framebuffer);
+        batch.clearFramebuffer(gpu::Framebuffer::BUFFER_COLORS | gpu::Framebuffer::BUFFER_DEPTH,
+                               glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), 1.0f, 0);
+        batch.setViewportTransform(glm::ivec4(0, 0, FRAMEBUFFER_SIZE, FRAMEBUFFER_SIZE));
+        batch.setProjectionTransform(viewFrustum.getProjection());
+        Transform viewTransform;
+        viewFrustum.evalViewTransform(viewTransform);
+        batch.setViewTransform(viewTransform);
+        geometryCache->bindSimpleProgram(batch);
+        for (const auto& item : sortedItems) {
+            Transform transform;
+            transform.setTranslation(item.bounds.calcCenter());
+            transform.setScale(item.bounds.getScale());
+            batch.setModelTransform(transform);
+            geometryCache->renderCube(batch);
+        }
+        recordTimes.record(usecsElapsed(timer));
+
+        // the transfer and the draw pass of the backend, up to when the GPU has the commands
+        timer.start();
+        context->render(batch);
+        glFlush();
+        playTimes.record(usecsElapsed(timer));
+    }
+    glFinish();
+    report("batch_record", (int)sortedItems.size(), recordTimes);
+    report("backend_render", (int)sortedItems.size(), playTimes);
+}
+
+int main(int argc, char** argv) {
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times the CPU side of the render engine on an offscreen context");
+    parser.addHelpOption();
+    const QCommandLineOption itemsOption("items", "comma separated numbers of items", "counts", "10000,30000,100000");
+    const QCommandLineOption framesOption("frames", "frames timed at each number of items", "frames", "200");
+    parser.addOption(itemsOption);
+    parser.addOption(framesOption);
+    parser.process(app);
+
+    OffscreenGLCanvas canvas;
+    canvas.create();
+    if (!canvas.makeCurrent()) {
+        qWarning() << "Unable to make an offscreen GL context current";
+        return -1;
+    }
+
+    gpu::Context::init<gpu::GLBackend>();
+    auto context = std::make_shared<gpu::Context>();
+    DependencyManager::set<GeometryCache>();
+    DependencyManager::set<DeferredLightingEffect>();
+
+    auto colorFormat = gpu::Element::COLOR_RGBA_32;
+    auto depthFormat = gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::DEPTH_STENCIL);
+    auto framebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create(colorFormat, depthFormat,
+                                                                        FRAMEBUFFER_SIZE, FRAMEBUFFER_SIZE));
+
+    int numFrames = std::max(parser.value(framesOption).toInt(), 1);
+    std::cout << "stage,items,mean_usecs,p50_usecs,p90_usecs,p99_usecs,max_usecs" << std::endl;
+    for (const auto& count : parser.value(itemsOption).split(',', QString::SkipEmptyParts)) {
+        int numItems = count.toInt();
+        if (numItems > 0) {
+            runBenchmarks(context, framebuffer, numItems, numFrames);
+        }
+    }
+
+    DependencyManager::destroy<DeferredLightingEffect>();
+    DependencyManager::destroy<GeometryCache>();
+    return 0;
+}
@@ -42,6 +42,7 @@
 
 #include "point_light_frag.h"
 #include "spot_light_frag.h"
+#include "clustered_light_frag.h"
 
 #include "standardTransformPNTC_vert.h"
 #include "standardDrawTexture_frag.h"
@@ -172,6 +173,7 @@ void QTestWindow::draw() {
         testShaderBuild(deferred_light_vert, directional_skybox_light_frag);
         testShaderBuild(deferred_light_limited_vert, point_light_frag);
         testShaderBuild(deferred_light_limited_vert, spot_light_frag);
+        testShaderBuild(deferred_light_vert, clustered_light_frag);
         testShaderBuild(standardTransformPNTC_vert, standardDrawTexture_frag);
         testShaderBuild(standardTransformPNTC_vert, DrawTextureOpaque_frag);
         
@@ -0,0 +1,79 @@
+//
+//  CullingKernelsTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CullingKernelsTests.h"
+
+#include <AABox.h>
+#include <CullingKernels.h>
+
+QTEST_MAIN(CullingKernelsTests)
+
+const int NUM_TEST_BOXES = 37;
+const int NUM_CUBE_PLANES = 6;
+
+static float randomFloat() {
+    return 2.0f * qrand() / RAND_MAX - 1.0f;
+}
+
+// the planes of the cube from -1 to 1, facing in
+static void makeCubePlanes(glm::vec4 planes[NUM_CUBE_PLANES]) {
+    for (int axis = 0; axis < 3; axis++) {
+        glm::vec3 normal(0.0f);
+        normal[axis] = 1.0f;
+        planes[2 * axis] = glm::vec4(normal, 1.0f);
+        planes[2 * axis + 1] = glm::vec4(-normal, 1.0f);
+    }
+}
+
+void CullingKernelsTests::findBoxesOutsideMatchesScalar() {
+    glm::vec4 planes[NUM_CUBE_PLANES];
+    for (auto& plane : planes) {
+        glm::vec3 direction = glm::vec3(randomFloat(), randomFloat(), randomFloat()) + glm::vec3(0.0f, 0.0f, 0.1f);
+        glm::vec3 normal = glm::normalize(direction);
+        plane = glm::vec4(normal, 2.0f * randomFloat());
+    }
+
+    std::vector<AABox> boxes(NUM_TEST_BOXES);
+    for (auto& box : boxes) {
+        glm::vec3 corner = 3.0f * glm::vec3(randomFloat(), randomFloat(), randomFloat());
+        glm::vec3 scale = glm::abs(glm::vec3(randomFloat(), randomFloat(), randomFloat()));
+        box.setBox(corner, scale);
+    }
+
+    bool isOutside[NUM_TEST_BOXES];
+    bool expected[NUM_TEST_BOXES];
+    CullingKernels::findBoxesOutside(planes, NUM_CUBE_PLANES, boxes.data(), isOutside, NUM_TEST_BOXES);
+    CullingKernels::findBoxesOutsideScalar(planes, NUM_CUBE_PLANES, boxes.data(), expected, NUM_TEST_BOXES);
+    for (int i = 0; i < NUM_TEST_BOXES; i++) {
+        QCOMPARE(isOutside[i], expected[i]);
+    }
+}
+
+void CullingKernelsTests::findBoxesOutsideOfCube() {
+    glm::vec4 planes[NUM_CUBE_PLANES];
+    makeCubePlanes(planes);
+
+    // five boxes, so that one goes through the tail of the vectorized kernel
+    const int NUM_BOXES = 5;
+    AABox boxes[NUM_BOXES] = {
+        AABox(glm::vec3(-0.5f), 1.0f), // inside
+        AABox(glm::vec3(0.5f), 1.0f), // across a corner
+        AABox(glm::vec3(2.0f, 0.0f, 0.0f), 1.0f), // past x
+        AABox(glm::vec3(0.0f, -3.0f, 0.0f), 1.5f), // below y
+        AABox(glm::vec3(-5.0f, -5.0f, -5.0f), 10.0f) // around it all
+    };
+    const bool EXPECTED[NUM_BOXES] = { false, false, true, true, false };
+
+    bool isOutside[NUM_BOXES];
+    CullingKernels::findBoxesOutside(planes, NUM_CUBE_PLANES, boxes, isOutside, NUM_BOXES);
+    for (int i = 0; i < NUM_BOXES; i++) {
+        QCOMPARE(isOutside[i], EXPECTED[i]);
+    }
+}
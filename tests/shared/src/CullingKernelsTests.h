@@ -0,0 +1,23 @@
+//
+//  CullingKernelsTests.h
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CullingKernelsTests_h
+#define hifi_CullingKernelsTests_h
+
+#include <QtTest/QtTest>
+
+class CullingKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void findBoxesOutsideMatchesScalar();
+    void findBoxesOutsideOfCube();
+};
+
+#endif // hifi_CullingKernelsTests_h
@@ -0,0 +1,60 @@
+//
+//  DependencyManagerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DependencyManagerTests.h"
+
+#include <DependencyManager.h>
+
+QTEST_MAIN(DependencyManagerTests)
+
+class TestDependency : public Dependency {
+    SINGLETON_DEPENDENCY
+public:
+    TestDependency(int value = 0) : value(value) {}
+    int value;
+};
+
+class TestBase : public Dependency {
+    SINGLETON_DEPENDENCY
+public:
+    virtual int getValue() const { return 1; }
+};
+
+class TestDerived : public TestBase {
+    SINGLETON_DEPENDENCY
+public:
+    virtual int getValue() const override { return 2; }
+};
+
+void DependencyManagerTests::borrowFollowsSetAndDestroy() {
+    auto first = DependencyManager::set<TestDependency>(1);
+    QCOMPARE(DependencyManager::borrow<TestDependency>(), first.data());
+    QCOMPARE(DependencyManager::get<TestDependency>(), first);
+    first.clear();
+    QCOMPARE(DependencyManager::borrow<TestDependency>()->value, 1);
+
+    // a new instance replaces the one cached
+    DependencyManager::set<TestDependency>(2);
+    QCOMPARE(DependencyManager::borrow<TestDependency>()->value, 2);
+    QCOMPARE(DependencyManager::get<TestDependency>()->value, 2);
+
+    DependencyManager::destroy<TestDependency>();
+    QVERIFY(!DependencyManager::borrow<TestDependency>());
+    QVERIFY(DependencyManager::get<TestDependency>().isNull());
+}
+
+void DependencyManagerTests::borrowFindsDerived() {
+    DependencyManager::registerInheritance<TestBase, TestDerived>();
+    DependencyManager::set<TestDerived>();
+    QCOMPARE(DependencyManager::borrow<TestBase>()->getValue(), 2);
+    QCOMPARE(DependencyManager::borrow<TestBase>(), DependencyManager::borrow<TestDerived>());
+    DependencyManager::destroy<TestDerived>();
+    QVERIFY(!DependencyManager::borrow<TestBase>());
+}
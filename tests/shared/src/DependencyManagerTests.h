@@ -0,0 +1,24 @@
+//
+//  DependencyManagerTests.h
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DependencyManagerTests_h
+#define hifi_DependencyManagerTests_h
+
+#include <QtTest/QtTest>
+
+class DependencyManagerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void borrowFollowsSetAndDestroy();
+    void borrowFindsDerived();
+};
+
+#endif // hifi_DependencyManagerTests_h
@@ -55,3 +55,43 @@ void GLMHelpersTests::testEulerDecomposition() {
 }
 
 
+
+void GLMHelpersTests::testSmallestThreeQuatPacking() {
+    const glm::quat ROT_X_90 = glm::angleAxis(PI / 2.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+    const glm::quat ROT_Y_180 = glm::angleAxis(PI, glm::vec3(0.0f, 1.0, 0.0f));
+    const glm::quat ROT_Z_30 = glm::angleAxis(PI / 6.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+
+    std::vector<glm::quat> quatVec = {
+        glm::quat(),
+        -glm::quat(),
+        ROT_X_90,
+        ROT_Y_180,
+        ROT_Z_30,
+        ROT_X_90 * ROT_Y_180 * ROT_Z_30,
+        ROT_Y_180 * ROT_Z_30 * ROT_X_90,
+        -(ROT_Z_30 * ROT_X_90 * ROT_Y_180),
+        glm::normalize(glm::quat(0.5f, -0.5f, 0.5f, -0.5f))
+    };
+
+    for (int bits = MIN_SMALLEST_THREE_QUAT_BITS + 4; bits <= MAX_SMALLEST_THREE_QUAT_BITS; bits += 4) {
+        // the three smaller components are within a step of the quantizer, the largest is rebuilt from them
+        const float EPSILON = 4.0f / (1 << bits) + 0.00001f;
+
+        for (auto& q : quatVec) {
+            unsigned char buffer[8];
+            int bytesPacked = packOrientationQuatToSmallestThree(buffer, q, bits);
+            QCOMPARE(bytesPacked, smallestThreeQuatPackedSize(bits));
+
+            glm::quat r;
+            int bytesUnpacked = unpackOrientationQuatFromSmallestThree(buffer, r, bits);
+            QCOMPARE(bytesUnpacked, bytesPacked);
+
+            // the sign of the whole quat isn't sent
+            if (glm::dot(q, r) < 0.0f) {
+                r = -r;
+            }
+
+            QCOMPARE_WITH_ABS_ERROR(q, r, EPSILON);
+        }
+    }
+}
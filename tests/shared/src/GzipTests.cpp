@@ -0,0 +1,79 @@
+//
+//  GzipTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "GzipTests.h"
+
+#include <QtCore/QBuffer>
+
+#include <Gzip.h>
+
+QTEST_MAIN(GzipTests)
+
+// compressible, but not so much that the blocks come out trivially small
+static QByteArray makeText(int size) {
+    QByteArray text;
+    text.reserve(size);
+    qsrand(1);
+    while (text.size() < size) {
+        text += QByteArray::number(qrand() % 1000) + (qrand() % 8 == 0 ? "\n" : " ");
+    }
+    return text.left(size);
+}
+
+static QByteArray gzipWithWriter(const QByteArray& source, int writeSize) {
+    QByteArray compressed;
+    QBuffer buffer(&compressed);
+    buffer.open(QIODevice::WriteOnly);
+
+    GzipWriter writer(&buffer);
+    writer.open(QIODevice::WriteOnly);
+    for (int i = 0; i < source.size(); i += writeSize) {
+        writer.write(source.mid(i, writeSize));
+    }
+    if (!writer.finish()) {
+        return QByteArray();
+    }
+    return compressed;
+}
+
+void GzipTests::writerRoundTrips_data() {
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("writeSize");
+
+    QTest::newRow("empty") << 0 << 1;
+    QTest::newRow("small") << 1000 << 100;
+    QTest::newRow("one flush") << 1500 * 1024 << 64 * 1024;
+    QTest::newRow("several flushes, uneven writes") << 5 * 1024 * 1024 + 123 << 77777;
+}
+
+void GzipTests::writerRoundTrips() {
+    QFETCH(int, size);
+    QFETCH(int, writeSize);
+
+    QByteArray source = makeText(size);
+    QByteArray compressed = gzipWithWriter(source, writeSize);
+    QVERIFY(!compressed.isEmpty());
+
+    QByteArray uncompressed;
+    QVERIFY(gunzip(compressed, uncompressed));
+    QCOMPARE(uncompressed.size(), source.size());
+    QVERIFY(uncompressed == source);
+}
+
+void GzipTests::writerMatchesGzip() {
+    // written out in pieces it compresses about as well as all at once
+    QByteArray source = makeText(3 * 1024 * 1024);
+
+    QByteArray compressed;
+    QVERIFY(gzip(source, compressed));
+    QByteArray written = gzipWithWriter(source, 1000);
+
+    QVERIFY(written.size() < compressed.size() * 1.05);
+}
@@ -0,0 +1,25 @@
+//
+//  GzipTests.h
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_GzipTests_h
+#define hifi_GzipTests_h
+
+#include <QtTest/QtTest>
+
+class GzipTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void writerRoundTrips_data();
+    void writerRoundTrips();
+    void writerMatchesGzip();
+};
+
+#endif // hifi_GzipTests_h
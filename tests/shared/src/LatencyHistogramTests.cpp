@@ -0,0 +1,74 @@
+//
+//  LatencyHistogramTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LatencyHistogramTests.h"
+
+#include <LatencyHistogram.h>
+
+QTEST_MAIN(LatencyHistogramTests)
+
+void LatencyHistogramTests::bucketsCoverTheirValues() {
+    QList<quint64> values { 0, 1, 7, 8, 9, 15, 16, 100, 1000, 12345, 1000000, (quint64)1 << 40, ~(quint64)0 };
+    for (quint64 value : values) {
+        int bucket = LatencyHistogram::bucketForValue(value);
+        quint64 largest = LatencyHistogram::largestValueOfBucket(bucket);
+        QVERIFY(largest >= value);
+
+        // the bucket is at most an eighth of its values wide
+        QVERIFY(largest - value <= value / 8);
+
+        // and the bucket before it ends below the value
+        if (bucket > 0) {
+            QVERIFY(LatencyHistogram::largestValueOfBucket(bucket - 1) < value);
+        }
+    }
+}
+
+void LatencyHistogramTests::percentiles() {
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.getPercentile(0.5f), (quint64)0);
+
+    for (quint64 value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+
+    QCOMPARE(histogram.getCount(), (quint64)1000);
+    QCOMPARE(histogram.getMax(), (quint64)1000);
+    QCOMPARE(histogram.getMean(), 500.5);
+
+    quint64 median = histogram.getPercentile(0.5f);
+    QVERIFY(median >= 500 && median <= 500 + 500 / 8);
+
+    quint64 p99 = histogram.getPercentile(0.99f);
+    QVERIFY(p99 >= 990 && p99 <= 1000);
+    QCOMPARE(histogram.getPercentile(1.0f), (quint64)1000);
+}
+
+void LatencyHistogramTests::mergeAndReset() {
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (int i = 0; i < 90; ++i) {
+        fast.record(10);
+    }
+    for (int i = 0; i < 10; ++i) {
+        slow.record(10000);
+    }
+
+    fast.merge(slow);
+    QCOMPARE(fast.getCount(), (quint64)100);
+    QCOMPARE(fast.getPercentile(0.9f), (quint64)10);
+    QVERIFY(fast.getPercentile(0.95f) >= 10000);
+    QCOMPARE(fast.getMax(), (quint64)10000);
+
+    fast.reset();
+    QCOMPARE(fast.getCount(), (quint64)0);
+    QCOMPARE(fast.getMax(), (quint64)0);
+    QCOMPARE(fast.getPercentile(0.99f), (quint64)0);
+}
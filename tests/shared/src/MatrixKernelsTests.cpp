@@ -0,0 +1,95 @@
+//
+//  MatrixKernelsTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MatrixKernelsTests.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <MatrixKernels.h>
+
+QTEST_MAIN(MatrixKernelsTests)
+
+const int NUM_TEST_MATRICES = 37;
+const float EPSILON = 1.0e-5f;
+
+static float randomFloat() {
+    return 2.0f * qrand() / RAND_MAX - 1.0f;
+}
+
+static glm::mat4 randomAffineMatrix() {
+    glm::vec3 axis = glm::normalize(glm::vec3(randomFloat(), randomFloat(), randomFloat()) + glm::vec3(0.0f, 0.0f, 2.0f));
+    return glm::translate(glm::vec3(randomFloat(), randomFloat(), randomFloat())) *
+        glm::rotate(3.0f * randomFloat(), axis) *
+        glm::scale(glm::vec3(1.5f) + glm::vec3(randomFloat(), randomFloat(), randomFloat()));
+}
+
+static bool fuzzyEqual(const glm::mat4& a, const glm::mat4& b) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (fabsf(a[i][j] - b[i][j]) > EPSILON) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void MatrixKernelsTests::multiplyMatchesScalar() {
+    std::vector<glm::mat4> left(NUM_TEST_MATRICES), right(NUM_TEST_MATRICES);
+    for (int i = 0; i < NUM_TEST_MATRICES; i++) {
+        left[i] = randomAffineMatrix();
+        right[i] = randomAffineMatrix();
+    }
+
+    std::vector<glm::mat4> result(NUM_TEST_MATRICES), expected(NUM_TEST_MATRICES);
+    MatrixKernels::multiply(left.data(), right.data(), result.data(), NUM_TEST_MATRICES);
+    MatrixKernels::multiplyScalar(left.data(), right.data(), expected.data(), NUM_TEST_MATRICES);
+    for (int i = 0; i < NUM_TEST_MATRICES; i++) {
+        QVERIFY(fuzzyEqual(result[i], expected[i]));
+    }
+
+    MatrixKernels::multiply(left[0], right.data(), result.data(), NUM_TEST_MATRICES);
+    for (int i = 0; i < NUM_TEST_MATRICES; i++) {
+        QVERIFY(fuzzyEqual(result[i], left[0] * right[i]));
+    }
+}
+
+void MatrixKernelsTests::multiplyInPlace() {
+    // the model multiplies its joints into the world where they are
+    glm::mat4 left = randomAffineMatrix();
+    std::vector<glm::mat4> matrices(NUM_TEST_MATRICES), expected(NUM_TEST_MATRICES);
+    for (int i = 0; i < NUM_TEST_MATRICES; i++) {
+        matrices[i] = randomAffineMatrix();
+        expected[i] = left * matrices[i];
+    }
+    MatrixKernels::multiply(left, matrices.data(), matrices.data(), NUM_TEST_MATRICES);
+    for (int i = 0; i < NUM_TEST_MATRICES; i++) {
+        QVERIFY(fuzzyEqual(matrices[i], expected[i]));
+    }
+}
+
+void MatrixKernelsTests::packAffineRowsMatchesScalar() {
+    std::vector<glm::mat4> matrices(NUM_TEST_MATRICES);
+    for (auto& matrix : matrices) {
+        matrix = randomAffineMatrix();
+    }
+
+    std::vector<glm::vec4> rows(3 * NUM_TEST_MATRICES), expected(3 * NUM_TEST_MATRICES);
+    MatrixKernels::packAffineRows(matrices.data(), rows.data(), NUM_TEST_MATRICES);
+    MatrixKernels::packAffineRowsScalar(matrices.data(), expected.data(), NUM_TEST_MATRICES);
+    QCOMPARE(memcmp(rows.data(), expected.data(), rows.size() * sizeof(glm::vec4)), 0);
+
+    // the rows put any point where the matrix does
+    glm::vec4 point(randomFloat(), randomFloat(), randomFloat(), 1.0f);
+    glm::vec4 moved = matrices[0] * point;
+    QVERIFY(fabsf(glm::dot(rows[0], point) - moved.x) < EPSILON);
+    QVERIFY(fabsf(glm::dot(rows[1], point) - moved.y) < EPSILON);
+    QVERIFY(fabsf(glm::dot(rows[2], point) - moved.z) < EPSILON);
+}
@@ -0,0 +1,24 @@
+//
+//  MatrixKernelsTests.h
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MatrixKernelsTests_h
+#define hifi_MatrixKernelsTests_h
+
+#include <QtTest/QtTest>
+
+class MatrixKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void multiplyMatchesScalar();
+    void multiplyInPlace();
+    void packAffineRowsMatchesScalar();
+};
+
+#endif // hifi_MatrixKernelsTests_h
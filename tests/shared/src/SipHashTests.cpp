@@ -0,0 +1,49 @@
+//
+//  SipHashTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHashTests.h"
+
+#include <SipHash.h>
+
+QTEST_MAIN(SipHashTests)
+
+static QByteArray hashOf(const uint8_t key[SIPHASH_KEY_BYTES], const QByteArray& message) {
+    uint8_t output[SIPHASH_128_BYTES];
+    sipHash128(key, message.constData(), message.size(), output);
+    return QByteArray(reinterpret_cast<const char*>(output), SIPHASH_128_BYTES);
+}
+
+void SipHashTests::referenceVectors() {
+    // the vectors from the SipHash reference implementation: key 00 01 .. 0f, message 00 01 .. (length - 1)
+    uint8_t key[SIPHASH_KEY_BYTES];
+    for (int i = 0; i < SIPHASH_KEY_BYTES; ++i) {
+        key[i] = i;
+    }
+
+    QByteArray message;
+    for (int i = 0; i < 16; ++i) {
+        message.append((char)i);
+    }
+
+    QCOMPARE(hashOf(key, message.left(0)).toHex(), QByteArray("a3817f04ba25a8e66df67214c7550293"));
+    QCOMPARE(hashOf(key, message.left(1)).toHex(), QByteArray("da87c1d86b99af44347659119b22fc45"));
+    QCOMPARE(hashOf(key, message.left(8)).toHex(), QByteArray("3b62a9ba6258f5610f83e264f31497b4"));
+    QCOMPARE(hashOf(key, message.left(15)).toHex(), QByteArray("5493e99933b0a8117e08ec0f97cfc3d9"));
+}
+
+void SipHashTests::keyChangesHash() {
+    uint8_t key[SIPHASH_KEY_BYTES] = {};
+    QByteArray message("a packet payload");
+
+    auto hash = hashOf(key, message);
+    key[SIPHASH_KEY_BYTES - 1] = 1;
+
+    QVERIFY(hashOf(key, message) != hash);
+}
@@ -0,0 +1,24 @@
+//
+//  SipHashTests.h
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHashTests_h
+#define hifi_SipHashTests_h
+
+#include <QtTest/QtTest>
+
+class SipHashTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void referenceVectors();
+    void keyChangesHash();
+};
+
+#endif // hifi_SipHashTests_h
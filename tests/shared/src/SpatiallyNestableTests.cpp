@@ -0,0 +1,130 @@
+//
+//  SpatiallyNestableTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatiallyNestableTests.h"
+
+#include <DependencyManager.h>
+#include <NumericalConstants.h>
+#include <SpatialParentFinder.h>
+#include <SpatiallyNestable.h>
+
+QTEST_MAIN(SpatiallyNestableTests)
+
+const float EPSILON = 0.001f;
+
+class TestNestable : public SpatiallyNestable {
+public:
+    TestNestable() : SpatiallyNestable(NestableType::Entity, QUuid::createUuid()) { }
+
+    virtual glm::quat getAbsoluteJointRotationInObjectFrame(int index) const override { return jointRotation; }
+    virtual glm::vec3 getAbsoluteJointTranslationInObjectFrame(int index) const override { return jointTranslation; }
+    virtual bool setAbsoluteJointRotationInObjectFrame(int index, const glm::quat& rotation) override { return false; }
+    virtual bool setAbsoluteJointTranslationInObjectFrame(int index, const glm::vec3& translation) override {
+        return false;
+    }
+
+    // like an animation, moved without a locationChanged()
+    glm::vec3 jointTranslation;
+    glm::quat jointRotation;
+};
+using TestNestablePointer = std::shared_ptr<TestNestable>;
+
+class TestParentFinder : public SpatialParentFinder {
+public:
+    virtual SpatiallyNestableWeakPointer find(QUuid parentID, bool& success) const override {
+        success = true;
+        return nestables.value(parentID);
+    }
+
+    QHash<QUuid, SpatiallyNestableWeakPointer> nestables;
+};
+
+static TestNestablePointer makeNestable() {
+    auto nestable = std::make_shared<TestNestable>();
+    DependencyManager::get<TestParentFinder>()->nestables[nestable->getID()] = nestable;
+    return nestable;
+}
+
+static bool matches(const glm::vec3& a, const glm::vec3& b) {
+    return glm::distance(a, b) < EPSILON;
+}
+
+void SpatiallyNestableTests::initTestCase() {
+    DependencyManager::set<TestParentFinder>();
+    DependencyManager::registerInheritance<SpatialParentFinder, TestParentFinder>();
+}
+
+void SpatiallyNestableTests::cleanupTestCase() {
+    DependencyManager::destroy<TestParentFinder>();
+}
+
+void SpatiallyNestableTests::childFollowsMovingAncestors() {
+    auto grandparent = makeNestable();
+    auto parent = makeNestable();
+    auto child = makeNestable();
+    parent->setParentID(grandparent->getID());
+    child->setParentID(parent->getID());
+
+    parent->setLocalPosition(glm::vec3(0.0f, 1.0f, 0.0f));
+    child->setLocalPosition(glm::vec3(0.0f, 0.0f, 1.0f));
+
+    bool success;
+    QVERIFY(matches(child->getPosition(success), glm::vec3(0.0f, 1.0f, 1.0f)));
+    QVERIFY(success);
+
+    // read again from what was kept, then after each ancestor moves
+    QVERIFY(matches(child->getPosition(success), glm::vec3(0.0f, 1.0f, 1.0f)));
+    grandparent->setPosition(glm::vec3(10.0f, 0.0f, 0.0f));
+    QVERIFY(matches(child->getPosition(success), glm::vec3(10.0f, 1.0f, 1.0f)));
+    grandparent->setOrientation(glm::angleAxis(PI_OVER_TWO, glm::vec3(0.0f, 1.0f, 0.0f)));
+    QVERIFY(matches(child->getPosition(success), glm::vec3(11.0f, 1.0f, 0.0f)));
+    parent->setLocalPosition(glm::vec3(0.0f, 2.0f, 0.0f));
+    QVERIFY(matches(child->getPosition(success), glm::vec3(11.0f, 2.0f, 0.0f)));
+
+    // and after moves of its own
+    child->setLocalPosition(glm::vec3(0.0f));
+    QVERIFY(matches(child->getPosition(success), glm::vec3(10.0f, 2.0f, 0.0f)));
+    child->setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    QVERIFY(matches(child->getPosition(success), glm::vec3(1.0f, 2.0f, 3.0f)));
+}
+
+void SpatiallyNestableTests::childFollowsMovingJoint() {
+    auto parent = makeNestable();
+    auto child = makeNestable();
+    child->setParentID(parent->getID());
+    child->setParentJointIndex(1);
+    child->setLocalPosition(glm::vec3(0.0f, 0.0f, 1.0f));
+
+    bool success;
+    QVERIFY(matches(child->getPosition(success), glm::vec3(0.0f, 0.0f, 1.0f)));
+
+    parent->jointTranslation = glm::vec3(0.0f, 3.0f, 0.0f);
+    QVERIFY(matches(child->getPosition(success), glm::vec3(0.0f, 3.0f, 1.0f)));
+    parent->jointRotation = glm::angleAxis(PI_OVER_TWO, glm::vec3(0.0f, 1.0f, 0.0f));
+    QVERIFY(matches(child->getPosition(success), glm::vec3(1.0f, 3.0f, 0.0f)));
+}
+
+void SpatiallyNestableTests::childFollowsReparenting() {
+    auto first = makeNestable();
+    auto second = makeNestable();
+    auto child = makeNestable();
+    first->setPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+    second->setPosition(glm::vec3(0.0f, 5.0f, 0.0f));
+
+    child->setParentID(first->getID());
+    bool success;
+    QVERIFY(matches(child->getPosition(success), glm::vec3(1.0f, 0.0f, 0.0f)));
+
+    child->setParentID(second->getID());
+    QVERIFY(matches(child->getPosition(success), glm::vec3(0.0f, 5.0f, 0.0f)));
+
+    child->setParentID(QUuid());
+    QVERIFY(matches(child->getPosition(success), glm::vec3(0.0f)));
+}
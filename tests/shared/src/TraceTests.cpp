@@ -0,0 +1,88 @@
+//
+//  TraceTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TraceTests.h"
+
+#include <thread>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <shared/Trace.h>
+
+QTEST_MAIN(TraceTests)
+
+static QJsonArray completeEvents(const QString& name) {
+    QJsonArray events;
+    QJsonParseError error;
+    auto json = QJsonDocument::fromJson(trace::toChromeTrace(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "the trace is not valid JSON:" << error.errorString();
+        return events;
+    }
+    for (const auto& value : json.object()["traceEvents"].toArray()) {
+        auto event = value.toObject();
+        if (event["ph"].toString() == "X" && event["name"].toString() == name) {
+            events.append(event);
+        }
+    }
+    return events;
+}
+
+void TraceTests::init() {
+    trace::clear();
+    trace::setActive(true);
+}
+
+void TraceTests::inactiveRecordsNothing() {
+    trace::setActive(false);
+    {
+        TRACE_SCOPE("inactive");
+    }
+    QCOMPARE(completeEvents("inactive").size(), 0);
+}
+
+void TraceTests::scopesOfEachThread() {
+    {
+        trace::Scope outerScope("outer");
+        trace::Scope innerScope(trace::intern(std::string("in") + "ner"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    std::thread thread([] {
+        TRACE_SCOPE("outer");
+    });
+    thread.join();
+
+    auto outers = completeEvents("outer");
+    QCOMPARE(outers.size(), 2);
+    QVERIFY(outers[0].toObject()["tid"].toInt() != outers[1].toObject()["tid"].toInt());
+
+    auto inners = completeEvents("inner");
+    QCOMPARE(inners.size(), 1);
+    auto inner = inners[0].toObject();
+    auto outer = outers[0].toObject()["tid"] == inner["tid"] ? outers[0].toObject() : outers[1].toObject();
+    QVERIFY(inner["dur"].toDouble() >= 2000.0);
+
+    // the inner scope is within the outer one
+    QVERIFY(inner["ts"].toDouble() >= outer["ts"].toDouble());
+    QVERIFY(inner["ts"].toDouble() + inner["dur"].toDouble() <= outer["ts"].toDouble() + outer["dur"].toDouble());
+}
+
+void TraceTests::keepsTheLatestEvents() {
+    const int EXTRA_EVENTS = 10;
+    for (int i = 0; i < trace::EVENTS_PER_THREAD + EXTRA_EVENTS; ++i) {
+        TRACE_SCOPE(i < EXTRA_EVENTS ? "overwritten" : "kept");
+    }
+    QCOMPARE(completeEvents("overwritten").size(), 0);
+
+    // the oldest event left could be being written over while it is read, so it is dropped
+    QCOMPARE(completeEvents("kept").size(), trace::EVENTS_PER_THREAD - 1);
+}
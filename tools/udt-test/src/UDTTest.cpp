@@ -12,12 +12,16 @@
 #include "UDTTest.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QTimer>
 
+#include <udt/CongestionControl.h>
 #include <udt/Constants.h>
 #include <udt/Packet.h>
 #include <udt/PacketList.h>
 
 #include <LogHandler.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 const QCommandLineOption PORT_OPTION { "p", "listening port for socket (defaults to random)", "port", 0 };
 const QCommandLineOption TARGET_OPTION {
@@ -55,6 +59,15 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption LOOPBACK {
+    "loopback", "send to a receiving socket in this process, which also measures goodput and latency (default is off)"
+};
+const QCommandLineOption CONGESTION_CONTROL {
+    "cc", "congestion control for sending, default or bbr (default is default)", "name"
+};
+const QCommandLineOption DURATION {
+    "duration", "seconds to run before printing a summary and quitting (default is to run until stopped)", "seconds"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (P/s)", "Est. Max (P/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -78,10 +91,32 @@ UDTTest::UDTTest(int& argc, char** argv) :
     // randomize the seed for packet size randomization
     srand(time(NULL));
     
+    if (_argumentParser.isSet(CONGESTION_CONTROL)) {
+        QString congestionControl = _argumentParser.value(CONGESTION_CONTROL);
+        if (congestionControl == "bbr") {
+            _socket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+                new udt::CongestionControlFactory<udt::BBRCC>()));
+        } else if (congestionControl != "default") {
+            qCritical() << "Unknown congestion control" << congestionControl << "- use default or bbr.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+        qDebug() << "Sending with" << congestionControl << "congestion control";
+    }
+
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
     
-    if (_argumentParser.isSet(TARGET_OPTION)) {
+    if (_argumentParser.isSet(LOOPBACK)) {
+        if (_argumentParser.isSet(TARGET_OPTION)) {
+            qCritical() << "Cannot set a target AND send over the loopback.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+
+        _loopbackReceiver.reset(new udt::Socket(this));
+        _loopbackReceiver->bind(QHostAddress::LocalHost);
+        _target = HifiSockAddr(QHostAddress::LocalHost, _loopbackReceiver->localPort());
+        qDebug() << "Packets will be sent over the loopback to" << _target;
+    } else if (_argumentParser.isSet(TARGET_OPTION)) {
         // parse the IP and port combination for this target
         QString hostnamePortString = _argumentParser.value(TARGET_OPTION);
         
@@ -168,44 +203,32 @@ UDTTest::UDTTest(int& argc, char** argv) :
         messageSeed = _argumentParser.value(MESSAGE_SEED).toInt();
     }
     
-    // seed the generator with a value that the receiver will also use when verifying the ordered message
+    // seed the generators with a value that the receiver will also use when verifying the ordered message
     _generator.seed(messageSeed);
+    _receiveGenerator.seed(messageSeed);
     
-    if (!_target.isNull()) {
-        sendInitialPackets();
-    } else {
+    if (_loopbackReceiver) {
+        setupReceiver(*_loopbackReceiver);
+    } else if (_target.isNull()) {
         // this is a receiver - in case there are ordered packets (messages) being sent to us make sure that we handle them
         // so that they can be verified
-        _socket.setMessageHandler(
-            [this](std::unique_ptr<udt::Packet> packet) {
-                auto messageNumber = packet->getMessageNumber();
-                auto it = _pendingMessages.find(messageNumber);
-
-                if (it == _pendingMessages.end()) {
-                    auto message = std::unique_ptr<Message>(new Message { messageNumber, packet->readAll() });
-                    message->data.reserve(_messageSize);
-                    if (packet->getPacketPosition() == udt::Packet::ONLY) {
-                        handleMessage(std::move(message));
-                    } else {
-                        _pendingMessages[messageNumber] = std::move(message);
-                    }
-                } else {
-                    auto& message = it->second;
-                    message->data.append(packet->readAll());
+        setupReceiver(_socket);
+    }
 
-                    if (packet->getPacketPosition() == udt::Packet::LAST) {
-                        handleMessage(std::move(message));
-                        _pendingMessages.erase(it);
-                    }
-                }
+    _runTimer.start();
+    _runStartCPU = std::clock();
 
+    if (!_target.isNull()) {
+        sendInitialPackets();
+    }
+    
+    if (_argumentParser.isSet(DURATION)) {
+        int durationMsecs = (int)(_argumentParser.value(DURATION).toDouble() * MSECS_PER_SECOND);
+        QTimer::singleShot(durationMsecs, this, [this] {
+            printSummary();
+            quit();
         });
     }
-    _socket.setMessageFailureHandler(
-        [this](HifiSockAddr from, udt::Packet::MessageNumber messageNumber) {
-            _pendingMessages.erase(messageNumber);
-        }
-    );
     
     // the sender reports stats every 100 milliseconds, unless passed a custom value
     
@@ -220,7 +243,9 @@ UDTTest::UDTTest(int& argc, char** argv) :
 
 void UDTTest::parseArguments() {
     // use a QCommandLineParser to setup command line arguments and give helpful output
-    _argumentParser.setApplicationDescription("High Fidelity UDT Protocol Test Client");
+    _argumentParser.setApplicationDescription("High Fidelity UDT Protocol Test Client\n\n"
+        "Loss and delay can be added to the path with netem, for the loopback for example:\n"
+        "    tc qdisc add dev lo root netem delay 25ms loss 1%");
     _argumentParser.addHelpOption();
     
     const QCommandLineOption helpOption = _argumentParser.addHelpOption();
@@ -228,7 +253,7 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, LOOPBACK, CONGESTION_CONTROL, DURATION
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -243,6 +268,54 @@ void UDTTest::parseArguments() {
     }
 }
 
+void UDTTest::setupReceiver(udt::Socket& socket) {
+    socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        _receivedBytes += packet->getPayloadSize();
+        ++_receivedPackets;
+
+        // in loopback mode the sender put the time it queued this packet at the start of it
+        quint64 sentTime;
+        if (_loopbackReceiver && packet->getPayloadSize() >= (qint64)sizeof(sentTime)) {
+            memcpy(&sentTime, packet->getPayload(), sizeof(sentTime));
+            _latencies.record(usecTimestampNow() - sentTime);
+        }
+    });
+
+    socket.setMessageHandler(
+        [this](std::unique_ptr<udt::Packet> packet) {
+            _receivedBytes += packet->getPayloadSize();
+            ++_receivedPackets;
+
+            auto messageNumber = packet->getMessageNumber();
+            auto it = _pendingMessages.find(messageNumber);
+
+            if (it == _pendingMessages.end()) {
+                auto message = std::unique_ptr<Message>(new Message { messageNumber, packet->readAll() });
+                message->data.reserve(_messageSize);
+                if (packet->getPacketPosition() == udt::Packet::ONLY) {
+                    handleMessage(std::move(message));
+                } else {
+                    _pendingMessages[messageNumber] = std::move(message);
+                }
+            } else {
+                auto& message = it->second;
+                message->data.append(packet->readAll());
+
+                if (packet->getPacketPosition() == udt::Packet::LAST) {
+                    handleMessage(std::move(message));
+                    _pendingMessages.erase(it);
+                }
+            }
+
+    });
+
+    socket.setMessageFailureHandler(
+        [this](HifiSockAddr from, udt::Packet::MessageNumber messageNumber) {
+            _pendingMessages.erase(messageNumber);
+        }
+    );
+}
+
 void UDTTest::sendInitialPackets() {
     static const int NUM_INITIAL_PACKETS = 500;
     
@@ -313,6 +386,11 @@ void UDTTest::sendPacket() {
             
             _totalQueuedBytes += (int)packetList->getDataSize();
             _totalQueuedPackets += (int)packetList->getNumPackets();
+
+            if (_loopbackReceiver) {
+                // the ordered messages arrive in the order they were sent
+                _messageSendTimes.push_back(usecTimestampNow());
+            }
             
             _socket.writePacketList(std::move(packetList), _target);
         }
@@ -320,6 +398,12 @@ void UDTTest::sendPacket() {
     } else {
         auto newPacket = udt::Packet::create(packetPayloadSize, _sendReliable);
         newPacket->setPayloadSize(packetPayloadSize);
+
+        if (_loopbackReceiver && packetPayloadSize >= (int)sizeof(quint64)) {
+            // so the receiver can tell how long it took to get there
+            quint64 now = usecTimestampNow();
+            memcpy(newPacket->getPayload(), &now, sizeof(now));
+        }
         
         _totalQueuedBytes += newPacket->getDataSize();
         
@@ -345,7 +429,7 @@ void UDTTest::handleMessage(std::unique_ptr<Message> message) {
    
     for (int i = 0; i < messageSize; i += packetSize) {
         // generate the random 64-bit unsigned integer that should lead this packet
-        uint64_t randomInt = _distribution(_generator);
+        uint64_t randomInt = _distribution(_receiveGenerator);
         
         messageData.replace(i, sizeof(randomInt), reinterpret_cast<char*>(&randomInt), sizeof(randomInt));
     }
@@ -359,6 +443,40 @@ void UDTTest::handleMessage(std::unique_ptr<Message> message) {
         qCritical() << "UDTTest::handleMessage" << "received message did not match expected message"
             << "(from seeded random number generation).";
     }
+
+    if (!_messageSendTimes.empty()) {
+        _latencies.record(usecTimestampNow() - _messageSendTimes.front());
+        _messageSendTimes.pop_front();
+    }
+}
+
+void UDTTest::printSummary() {
+    static const double MEGABITS_PER_BYTE = 8.0 / 1000000.0;
+
+    double seconds = _runTimer.elapsed() / (double)MSECS_PER_SECOND;
+    double cpuUsecs = (double)(std::clock() - _runStartCPU) * USECS_PER_SECOND / CLOCKS_PER_SEC;
+
+    qDebug() << "Summary of" << seconds << "seconds";
+
+    if (!_target.isNull()) {
+        qDebug() << "    queued" << _totalQueuedPackets << "packets," << _totalQueuedBytes * MEGABITS_PER_BYTE / seconds
+            << "Mb/s";
+    }
+
+    bool isReceiving = _loopbackReceiver || _target.isNull();
+    if (isReceiving) {
+        qDebug() << "    received" << _receivedPackets << "packets, goodput" << _receivedBytes * MEGABITS_PER_BYTE / seconds
+            << "Mb/s";
+    }
+
+    // the CPU of both ends in loopback mode
+    int packets = isReceiving ? _receivedPackets : _totalQueuedPackets;
+    qDebug() << "    CPU" << cpuUsecs / std::max(packets, 1) << "usecs per packet";
+
+    if (_latencies.getCount() > 0) {
+        qDebug() << "    latency usecs p50" << _latencies.getPercentile(0.5f) << "p90" << _latencies.getPercentile(0.9f)
+            << "p99" << _latencies.getPercentile(0.99f) << "max" << _latencies.getMax();
+    }
 }
 
 void UDTTest::sampleStats() {
@@ -15,14 +15,18 @@
 #define hifi_UDTTest_h
 
 
+#include <ctime>
+#include <deque>
 #include <random>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
 
 #include <udt/Constants.h>
 #include <udt/Socket.h>
 
+#include <LatencyHistogram.h>
 #include <ReceivedMessage.h>
 
 struct Message {
@@ -38,9 +42,11 @@ public:
 public slots:
     void refillPacket() { sendPacket(); } // adds a new packet to the queue when we are told one is sent
     void sampleStats();
+    void printSummary();
     
 private:
     void parseArguments();
+    void setupReceiver(udt::Socket& socket); // verifies the messages and counts what arrives on this socket
     void handleMessage(std::unique_ptr<Message> message);
     
     void sendInitialPackets(); // fills the queue with packets to start
@@ -50,6 +56,9 @@ private:
     udt::Socket _socket;
     
     HifiSockAddr _target; // the target for sent packets
+
+    // in loopback mode the packets go to this socket, so both ends are timed on the same clock
+    std::unique_ptr<udt::Socket> _loopbackReceiver;
     
     int _minPacketSize { udt::MAX_PACKET_SIZE };
     int _maxPacketSize { udt::MAX_PACKET_SIZE };
@@ -65,12 +74,21 @@ private:
     
     std::random_device _randomDevice;
     std::mt19937 _generator { _randomDevice() }; // random number generator for ordered data testing
+    std::mt19937 _receiveGenerator; // the same sequence, for the receiver to verify ordered data with
     std::uniform_int_distribution<uint64_t> _distribution { 1, UINT64_MAX }; // producer of random integer values
     
     int _totalQueuedPackets { 0 }; // keeps track of the number of packets we have already queued
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+
+    // for the summary printed at the end of a timed run
+    QElapsedTimer _runTimer;
+    std::clock_t _runStartCPU { 0 };
+    qint64 _receivedBytes { 0 }; // payload bytes handed to us by the receiving socket
+    int _receivedPackets { 0 };
+    std::deque<quint64> _messageSendTimes; // when each ordered message still on its way was queued, in loopback mode
+    LatencyHistogram _latencies; // usecs from queueing a packet or message to receiving it, in loopback mode
 };
 
 #endif // hifi_UDTTest_h